@@ -34,6 +34,10 @@
  */
 
 #include <gstaravis.h>
+#include <gstaravisconvert.h>
+#include <gstaravisbufferpool.h>
+#include <gstaravismeta.h>
+#include <arvgcprivate.h>
 #include <arvgvspprivate.h>
 #include <time.h>
 #include <string.h>
@@ -43,6 +47,7 @@
 
 #define GST_ARAVIS_DEFAULT_N_BUFFERS		50
 #define GST_ARAVIS_BUFFER_TIMEOUT_DEFAULT	2000000
+#define GST_ARAVIS_SYNC_TOLERANCE_DEFAULT	1000000
 
 GST_DEBUG_CATEGORY_STATIC (aravis_debug);
 #define GST_CAT_DEFAULT aravis_debug
@@ -65,7 +70,12 @@ enum
   PROP_AUTO_PACKET_SIZE,
   PROP_PACKET_RESEND,
   PROP_FEATURES,
-  PROP_NUM_ARV_BUFFERS
+  PROP_NUM_ARV_BUFFERS,
+  PROP_LEAKY,
+  PROP_FORWARD_INCOMPLETE,
+  PROP_SYNC_GROUP,
+  PROP_SYNC_GROUP_SIZE,
+  PROP_SYNC_TOLERANCE
 };
 
 #define GST_TYPE_ARV_AUTO (gst_arv_auto_get_type())
@@ -95,11 +105,48 @@ static GstStaticPadTemplate aravis_src_template = GST_STATIC_PAD_TEMPLATE ("src"
 									   GST_PAD_ALWAYS,
 									   GST_STATIC_CAPS ("ANY"));
 
+/* Compressed streams, selected by the ImageCompressionMode feature, are passed through to downstream */
+
+static const struct {
+	const char *compression_mode;
+	const char *media_type;
+	const char *caps_string;
+} gst_aravis_compressed_formats[] = {
+	{ "JPEG",	"image/jpeg",	"image/jpeg" },
+	{ "H264",	"video/x-h264",	"video/x-h264, stream-format=(string)byte-stream, alignment=(string)au" }
+};
+
+static const char *
+gst_aravis_compression_mode_from_media_type (const char *media_type)
+{
+	unsigned int i;
+
+	for (i = 0; i < G_N_ELEMENTS (gst_aravis_compressed_formats); i++)
+		if (g_strcmp0 (gst_aravis_compressed_formats[i].media_type, media_type) == 0)
+			return gst_aravis_compressed_formats[i].compression_mode;
+
+	return NULL;
+}
+
+static const char *
+gst_aravis_compression_mode_to_caps_string (const char *compression_mode)
+{
+	unsigned int i;
+
+	for (i = 0; i < G_N_ELEMENTS (gst_aravis_compressed_formats); i++)
+		if (g_strcmp0 (gst_aravis_compressed_formats[i].compression_mode, compression_mode) == 0)
+			return gst_aravis_compressed_formats[i].caps_string;
+
+	return NULL;
+}
+
 static GstCaps *
 gst_aravis_get_all_camera_caps (GstAravis *gst_aravis, GError **error)
 {
 	GError *local_error = NULL;
 	GstCaps *caps;
+	const char **compression_modes = NULL;
+	guint n_compression_modes = 0;
 	gint64 *pixel_formats = NULL;
 	double min_frame_rate, max_frame_rate;
 	int min_height, min_width;
@@ -136,11 +183,18 @@ gst_aravis_get_all_camera_caps (GstAravis *gst_aravis, GError **error)
 		return NULL;
 	}
 
+	if (arv_camera_is_feature_available (gst_aravis->camera, "ImageCompressionMode", NULL))
+		compression_modes = arv_camera_dup_available_enumerations_as_strings (gst_aravis->camera,
+										      "ImageCompressionMode",
+										      &n_compression_modes, NULL);
+
 	caps = gst_caps_new_empty ();
-	for (i = 0; i < n_pixel_formats; i++) {
+	for (i = 0; i < n_pixel_formats + n_compression_modes; i++) {
 		const char *caps_string;
 
-		caps_string = arv_pixel_format_to_gst_caps_string (pixel_formats[i]);
+		caps_string = i < n_pixel_formats ?
+			arv_pixel_format_to_gst_caps_string (pixel_formats[i]) :
+			gst_aravis_compression_mode_to_caps_string (compression_modes[i - n_pixel_formats]);
 
 		if (caps_string != NULL) {
 			GstStructure *structure;
@@ -161,17 +215,80 @@ gst_aravis_get_all_camera_caps (GstAravis *gst_aravis, GError **error)
 	}
 
 	g_free (pixel_formats);
+	g_free (compression_modes);
 
 	return caps;
 }
 
+/* The caps table is only rebuilt when a camera feature changed since it was built. The feature changes and
+ * invalidations are tracked by the generation counter of the GenICam document. Must be called with the object
+ * lock held. */
+
+static void
+gst_aravis_update_all_caps (GstAravis *gst_aravis, GError **error)
+{
+	GError *local_error = NULL;
+	GstCaps *caps;
+	guint generation;
+
+	if (!ARV_IS_CAMERA (gst_aravis->camera))
+		return;
+
+	generation = arv_gc_get_generation (arv_device_get_genicam (arv_camera_get_device (gst_aravis->camera)));
+	if (gst_aravis->all_caps != NULL && generation == gst_aravis->all_caps_generation)
+		return;
+
+	caps = gst_aravis_get_all_camera_caps (gst_aravis, &local_error);
+	if (local_error != NULL) {
+		g_propagate_error (error, local_error);
+		return;
+	}
+
+	if (gst_aravis->all_caps != NULL)
+		gst_caps_unref (gst_aravis->all_caps);
+	gst_aravis->all_caps = caps;
+	gst_aravis->all_caps_generation = generation;
+}
+
+/* Checks whether the fixed caps only differ from the current ones by their frame rate */
+
+static gboolean
+gst_aravis_is_frame_rate_change (GstCaps *current_caps, GstCaps *caps)
+{
+	GstStructure *current_structure;
+	GstStructure *structure;
+	gboolean is_subset;
+
+	if (current_caps == NULL)
+		return FALSE;
+
+	current_structure = gst_structure_copy (gst_caps_get_structure (current_caps, 0));
+	structure = gst_structure_copy (gst_caps_get_structure (caps, 0));
+	gst_structure_remove_field (current_structure, "framerate");
+	gst_structure_remove_field (structure, "framerate");
+
+	is_subset = gst_structure_is_subset (structure, current_structure);
+
+	gst_structure_free (current_structure);
+	gst_structure_free (structure);
+
+	return is_subset;
+}
+
 static GstCaps *
 gst_aravis_get_caps (GstBaseSrc * src, GstCaps * filter)
 {
 	GstAravis* gst_aravis = GST_ARAVIS(src);
+	GError *error = NULL;
 	GstCaps *caps;
 
 	GST_OBJECT_LOCK (gst_aravis);
+	if (gst_aravis->all_caps != NULL)
+		gst_aravis_update_all_caps (gst_aravis, &error);
+	if (error != NULL) {
+		GST_WARNING_OBJECT (gst_aravis, "Failed to update the caps: %s", error->message);
+		g_clear_error (&error);
+	}
 	if (gst_aravis->all_caps != NULL)
 		caps = gst_caps_copy (gst_aravis->all_caps);
 	else
@@ -195,10 +312,13 @@ gst_aravis_set_caps (GstBaseSrc *src, GstCaps *caps)
 	const GValue *frame_rate = NULL;
 	const char *caps_string;
 	const char *format_string;
+	const char *compression_mode;
 	unsigned int i;
 	ArvStream *orig_stream = NULL;
 	GstCaps *orig_fixed_caps = NULL;
+	gint orig_payload;
 	gboolean result = FALSE;
+	gboolean is_frame_rate_change;
 	gboolean is_frame_rate_available;
 	gboolean is_gain_available;
 	gboolean is_gain_auto_available;
@@ -210,6 +330,8 @@ gst_aravis_set_caps (GstBaseSrc *src, GstCaps *caps)
 	structure = gst_caps_get_structure (caps, 0);
 
 	GST_OBJECT_LOCK (gst_aravis);
+
+	gst_aravis->is_video_info_valid = gst_video_info_from_caps (&gst_aravis->video_info, caps);
 	arv_camera_get_region (gst_aravis->camera, NULL, NULL, &width, &height, &error);
 	if (error)
 		goto errored;
@@ -228,34 +350,56 @@ gst_aravis_set_caps (GstBaseSrc *src, GstCaps *caps)
 		frame_rate = gst_structure_get_value (structure, "framerate");
 	format_string = gst_structure_get_string (structure, "format");
 
-	pixel_format = arv_pixel_format_from_gst_caps (gst_structure_get_name (structure), format_string, bpp, depth);
+	compression_mode = gst_aravis_compression_mode_from_media_type (gst_structure_get_name (structure));
+	if (compression_mode == NULL) {
+		pixel_format = arv_pixel_format_from_gst_caps (gst_structure_get_name (structure), format_string,
+							       bpp, depth);
 
-	if (!pixel_format) {
-		GST_ERROR_OBJECT (src, "did not find matching pixel_format");
-		goto failed;
-	}
+		if (!pixel_format) {
+			GST_ERROR_OBJECT (src, "did not find matching pixel_format");
+			goto failed;
+		}
+	} else
+		pixel_format = 0;
+
+	is_frame_rate_change = gst_aravis->stream != NULL &&
+		gst_aravis_is_frame_rate_change (gst_aravis->fixed_caps, caps);
+
+	GST_DEBUG_OBJECT (gst_aravis, "%s", is_frame_rate_change ? "Frame rate change" : "Full reconfiguration");
 
 	arv_camera_stop_acquisition (gst_aravis->camera, &error);
 
 	orig_stream = g_steal_pointer (&gst_aravis->stream);
-
-	if (!error) arv_camera_set_pixel_format (gst_aravis->camera, pixel_format, &error);
-	if (!error) arv_camera_set_binning (gst_aravis->camera, gst_aravis->h_binning, gst_aravis->v_binning, &error);
-	if (!error) arv_camera_set_region (gst_aravis->camera, gst_aravis->offset_x, gst_aravis->offset_y, width, height, &error);
-
-	if (!error && arv_camera_is_gv_device (gst_aravis->camera)) {
-		if (gst_aravis->packet_delay >= 0) {
-			gint64 delay = 0;
-			arv_camera_gv_set_packet_delay (gst_aravis->camera, gst_aravis->packet_delay, &error);
-			if (!error) delay = arv_camera_gv_get_packet_delay (gst_aravis->camera, &error);
-			if (!error && delay != gst_aravis->packet_delay)
-				GST_WARNING_OBJECT (gst_aravis, "Packet delay is %" G_GINT64_FORMAT " ns instead of %" G_GINT64_FORMAT,
-					delay, gst_aravis->packet_delay);
+	orig_payload = gst_aravis->payload;
+
+	gst_aravis->is_compressed = compression_mode != NULL;
+	/* Format, region and transport settings are kept on frame rate changes */
+	if (!is_frame_rate_change) {
+		if (compression_mode != NULL) {
+			GST_DEBUG_OBJECT (gst_aravis, "Compression mode = %s", compression_mode);
+			if (!error) arv_camera_set_string (gst_aravis->camera, "ImageCompressionMode", compression_mode, &error);
+		} else {
+			if (!error && arv_camera_is_feature_available (gst_aravis->camera, "ImageCompressionMode", NULL))
+				arv_camera_set_string (gst_aravis->camera, "ImageCompressionMode", "Off", &error);
+			if (!error) arv_camera_set_pixel_format (gst_aravis->camera, pixel_format, &error);
+		}
+		if (!error) arv_camera_set_binning (gst_aravis->camera, gst_aravis->h_binning, gst_aravis->v_binning, &error);
+		if (!error) arv_camera_set_region (gst_aravis->camera, gst_aravis->offset_x, gst_aravis->offset_y, width, height, &error);
+
+		if (!error && arv_camera_is_gv_device (gst_aravis->camera)) {
+			if (gst_aravis->packet_delay >= 0) {
+				gint64 delay = 0;
+				arv_camera_gv_set_packet_delay (gst_aravis->camera, gst_aravis->packet_delay, &error);
+				if (!error) delay = arv_camera_gv_get_packet_delay (gst_aravis->camera, &error);
+				if (!error && delay != gst_aravis->packet_delay)
+					GST_WARNING_OBJECT (gst_aravis, "Packet delay is %" G_GINT64_FORMAT " ns instead of %" G_GINT64_FORMAT,
+						delay, gst_aravis->packet_delay);
+			}
+			if (!error && gst_aravis->packet_size > 0)
+				arv_camera_gv_set_packet_size (gst_aravis->camera, gst_aravis->packet_size, &error);
+			if (!error && gst_aravis->auto_packet_size)
+				arv_camera_gv_auto_packet_size (gst_aravis->camera, &error);
 		}
-		if (!error && gst_aravis->packet_size > 0)
-			arv_camera_gv_set_packet_size (gst_aravis->camera, gst_aravis->packet_size, &error);
-		if (!error && gst_aravis->auto_packet_size)
-			arv_camera_gv_auto_packet_size (gst_aravis->camera, &error);
 	}
 
 	if (!error && frame_rate != NULL) {
@@ -281,6 +425,13 @@ gst_aravis_set_caps (GstBaseSrc *src, GstCaps *caps)
 		GST_DEBUG_OBJECT (gst_aravis, "Actual frame rate = %g Hz",
 				  arv_camera_get_frame_rate (gst_aravis->camera, NULL));
 
+	/* Gain and exposure properties are applied as soon as they are set, they are only written again on full
+	 * reconfigurations */
+	if (is_frame_rate_change) {
+		is_gain_auto_available = is_gain_available = FALSE;
+		is_exposure_auto_available = is_exposure_time_available = FALSE;
+	}
+
 	if (is_gain_auto_available && !error && gst_aravis->gain_auto_set) {
 		arv_camera_set_gain_auto (gst_aravis->camera, gst_aravis->gain_auto, &error);
 		GST_DEBUG_OBJECT (gst_aravis, "Auto Gain = %s", arv_auto_to_string(gst_aravis->gain_auto));
@@ -311,7 +462,9 @@ gst_aravis_set_caps (GstBaseSrc *src, GstCaps *caps)
 
 	orig_fixed_caps = g_steal_pointer (&gst_aravis->fixed_caps);
 
-	caps_string = arv_pixel_format_to_gst_caps_string (pixel_format);
+	caps_string = compression_mode != NULL ?
+		gst_aravis_compression_mode_to_caps_string (compression_mode) :
+		arv_pixel_format_to_gst_caps_string (pixel_format);
 	if (caps_string != NULL) {
 		GstStructure *structure;
 		GstCaps *caps;
@@ -332,10 +485,34 @@ gst_aravis_set_caps (GstBaseSrc *src, GstCaps *caps)
 	} else
 		gst_aravis->fixed_caps = NULL;
 
-	if (!error) arv_device_set_features_from_string (arv_camera_get_device (gst_aravis->camera), gst_aravis->features, &error);
+	if (!error && !is_frame_rate_change)
+		arv_device_set_features_from_string (arv_camera_get_device (gst_aravis->camera),
+						     gst_aravis->features, &error);
 
 	if (!error) gst_aravis->payload = arv_camera_get_payload (gst_aravis->camera, &error);
-	if (!error) gst_aravis->stream = arv_camera_create_stream (gst_aravis->camera, NULL, NULL, &error);
+
+	/* The GigE Vision streams keep the packet size they were created with, which may have been renegotiated */
+	if (!error && orig_stream != NULL && gst_aravis->payload == orig_payload &&
+	    (is_frame_rate_change || !arv_camera_is_gv_device (gst_aravis->camera))) {
+		ArvBuffer *arv_buffer;
+
+		/* The stream and its buffers are reused. The frames of the previous configuration still in the output
+		 * queue are given back to the stream. */
+		GST_DEBUG_OBJECT (gst_aravis, "Reuse stream, payload = %d", gst_aravis->payload);
+
+		gst_aravis->stream = g_steal_pointer (&orig_stream);
+		while ((arv_buffer = arv_stream_try_pop_buffer (gst_aravis->stream)) != NULL)
+			arv_stream_push_buffer (gst_aravis->stream, arv_buffer);
+	} else if (!error) {
+		gst_aravis->stream = arv_camera_create_stream (gst_aravis->camera, NULL, NULL, &error);
+		if (!error) {
+			for (i = 0; i < gst_aravis->num_arv_buffers; i++)
+				arv_stream_push_buffer (gst_aravis->stream,
+							arv_buffer_new_allocate_full (gst_aravis->payload,
+										      ARV_BUFFER_ALLOCATION_FLAGS_SHAREABLE,
+										      0));
+		}
+	}
 	if (error)
 		goto errored;
 
@@ -346,9 +523,8 @@ gst_aravis_set_caps (GstBaseSrc *src, GstCaps *caps)
 			g_object_set (gst_aravis->stream, "packet-resend", ARV_GV_STREAM_PACKET_RESEND_NEVER, NULL);
 	}
 
-	for (i = 0; i < gst_aravis->num_arv_buffers; i++)
-		arv_stream_push_buffer (gst_aravis->stream,
-					arv_buffer_new (gst_aravis->payload, NULL));
+	/* Leaky mode: older frames not pulled yet are given back to the stream as soon as a new one is done */
+	g_object_set (gst_aravis->stream, "mailbox", gst_aravis->leaky, NULL);
 
 	GST_LOG_OBJECT (gst_aravis, "Start acquisition");
 	arv_camera_start_acquisition (gst_aravis->camera, &error);
@@ -439,7 +615,10 @@ gst_aravis_start (GstBaseSrc *src)
 	if (gst_aravis->camera == NULL)
 		result = gst_aravis_init_camera (gst_aravis, &error);
 
-	if (result) gst_aravis->all_caps = gst_aravis_get_all_camera_caps (gst_aravis, &error);
+	if (result) gst_aravis_update_all_caps (gst_aravis, &error);
+	if (result && gst_aravis->sync_group_name != NULL && gst_aravis->sync_group == NULL)
+		gst_aravis->sync_group = gst_aravis_sync_group_join (gst_aravis->sync_group_name,
+								     gst_aravis->sync_group_size, gst_aravis);
 	GST_OBJECT_UNLOCK (gst_aravis);
 
 	if (error) gst_aravis_init_error (gst_aravis, error);
@@ -454,16 +633,25 @@ gst_aravis_stop( GstBaseSrc * src )
 	GError *error = NULL;
 	GstAravis* gst_aravis = GST_ARAVIS(src);
 	ArvStream *stream;
+	GstBufferPool *pool;
+	GstAravisSyncGroup *sync_group;
 	GstCaps *all_caps;
 
 	GST_OBJECT_LOCK (gst_aravis);
 	arv_camera_stop_acquisition (gst_aravis->camera, &error);
 	stream = g_steal_pointer (&gst_aravis->stream);
+	pool = g_steal_pointer (&gst_aravis->pool);
+	sync_group = g_steal_pointer (&gst_aravis->sync_group);
 	all_caps = g_steal_pointer (&gst_aravis->all_caps);
 	GST_OBJECT_UNLOCK (gst_aravis);
 
+	if (sync_group != NULL)
+		gst_aravis_sync_group_leave (sync_group, gst_aravis);
+
 	if (stream != NULL)
 		g_object_unref (stream);
+	if (pool != NULL)
+		gst_object_unref (pool);
 	if (all_caps != NULL)
 		gst_caps_unref (all_caps);
 
@@ -499,38 +687,117 @@ gst_aravis_get_times (GstBaseSrc * basesrc, GstBuffer * buffer,
 	}
 }
 
+/* The stream buffers are handed downstream through our own pool, whatever downstream proposes */
+
+static gboolean
+gst_aravis_decide_allocation (GstBaseSrc *src, GstQuery *query)
+{
+	GstAravis *gst_aravis = GST_ARAVIS (src);
+	GstBufferPool *pool;
+	GstBufferPool *orig_pool;
+	GstStructure *config;
+	gboolean use_video_meta;
+	gint payload;
+	gint num_arv_buffers;
+
+	use_video_meta = gst_query_find_allocation_meta (query, GST_VIDEO_META_API_TYPE, NULL);
+
+	GST_OBJECT_LOCK (gst_aravis);
+	gst_aravis->use_video_meta = use_video_meta;
+	if (gst_aravis->stream == NULL) {
+		GST_OBJECT_UNLOCK (gst_aravis);
+		return FALSE;
+	}
+	pool = gst_aravis_buffer_pool_new (gst_aravis->stream, gst_aravis->buffer_timeout_us,
+					   gst_aravis->forward_incomplete);
+	orig_pool = g_steal_pointer (&gst_aravis->pool);
+	gst_aravis->pool = gst_object_ref (pool);
+	payload = gst_aravis->payload;
+	num_arv_buffers = gst_aravis->num_arv_buffers;
+	GST_OBJECT_UNLOCK (gst_aravis);
+
+	if (orig_pool != NULL)
+		gst_object_unref (orig_pool);
+
+	GST_DEBUG_OBJECT (gst_aravis, "Video meta %s by downstream", use_video_meta ? "supported" : "not supported");
+
+	if (gst_query_get_n_allocation_pools (query) > 0)
+		gst_query_set_nth_allocation_pool (query, 0, pool, payload, 0, num_arv_buffers);
+	else
+		gst_query_add_allocation_pool (query, pool, payload, 0, num_arv_buffers);
+
+	if (!GST_BASE_SRC_CLASS (gst_aravis_parent_class)->decide_allocation (src, query)) {
+		gst_object_unref (pool);
+		return FALSE;
+	}
+
+	if (use_video_meta) {
+		config = gst_buffer_pool_get_config (pool);
+		gst_buffer_pool_config_add_option (config, GST_BUFFER_POOL_OPTION_VIDEO_META);
+		gst_buffer_pool_set_config (pool, config);
+	}
+
+	gst_object_unref (pool);
+
+	return TRUE;
+}
+
 static GstFlowReturn
 gst_aravis_create (GstPushSrc * push_src, GstBuffer ** buffer)
 {
 	GstAravis *gst_aravis;
 	int arv_row_stride;
 	int width, height;
-	char *buffer_data;
-	size_t buffer_size;
 	guint64 timestamp_ns;
 	gboolean base_src_does_timestamp;
-	ArvBuffer *arv_buffer = NULL;
+	GstBuffer *pool_buffer = NULL;
+	ArvBuffer *arv_buffer;
+	gboolean is_incomplete;
 
 	gst_aravis = GST_ARAVIS (push_src);
 	base_src_does_timestamp = gst_base_src_get_do_timestamp(GST_BASE_SRC(push_src));
 
 	GST_OBJECT_LOCK (gst_aravis);
 
-	do {
-		if (arv_buffer) arv_stream_push_buffer (gst_aravis->stream, arv_buffer);
-		arv_buffer = arv_stream_timeout_pop_buffer (gst_aravis->stream, gst_aravis->buffer_timeout_us);
-	} while (arv_buffer != NULL && arv_buffer_get_status (arv_buffer) != ARV_BUFFER_STATUS_SUCCESS);
+	for (;;) {
+		if (gst_aravis->pool == NULL ||
+		    gst_buffer_pool_acquire_buffer (gst_aravis->pool, &pool_buffer, NULL) != GST_FLOW_OK)
+			goto error;
+
+		arv_buffer = gst_aravis_buffer_pool_get_arv_buffer (pool_buffer);
+		timestamp_ns = arv_buffer_get_timestamp (arv_buffer);
+
+		if (gst_aravis->sync_group == NULL)
+			break;
+
+		/* Host timestamps are comparable between devices, the frames of a set share the same timestamp */
+		if (gst_aravis_sync_group_submit (gst_aravis->sync_group, gst_aravis,
+						  arv_buffer_get_host_timestamp (arv_buffer),
+						  gst_aravis->sync_tolerance_ns, gst_aravis->buffer_timeout_us,
+						  &timestamp_ns) == GST_ARAVIS_SYNC_RESULT_ACCEPTED)
+			break;
 
-	if (arv_buffer == NULL)
-		goto error;
+		GST_LOG_OBJECT (gst_aravis, "Frame %" G_GUINT64_FORMAT " dropped, not part of a complete set",
+				arv_buffer_get_frame_id (arv_buffer));
+		gst_buffer_unref (pool_buffer);
+		pool_buffer = NULL;
+	}
 
-	buffer_data = (char *) arv_buffer_get_data (arv_buffer, &buffer_size);
-	arv_buffer_get_image_region (arv_buffer, NULL, NULL, &width, &height);
-	arv_row_stride = width * ARV_PIXEL_FORMAT_BIT_PER_PIXEL (arv_buffer_get_image_pixel_format (arv_buffer)) / 8;
-	timestamp_ns = arv_buffer_get_timestamp (arv_buffer);
+	is_incomplete = arv_buffer_get_status (arv_buffer) != ARV_BUFFER_STATUS_SUCCESS;
 
-	/* Gstreamer requires row stride to be a multiple of 4 */
-	if ((arv_row_stride & 0x3) != 0) {
+	if (!gst_aravis->is_compressed) {
+		arv_buffer_get_image_region (arv_buffer, NULL, NULL, &width, &height);
+		arv_row_stride = width * ARV_PIXEL_FORMAT_BIT_PER_PIXEL (arv_buffer_get_image_pixel_format (arv_buffer)) / 8;
+	} else
+		arv_row_stride = 0;
+
+	/* Gstreamer default row stride is a multiple of 4. If downstream doesn't understand video meta, the
+	 * image has to be copied with padded rows. Compressed frames have no rows. */
+	if ((arv_row_stride & 0x3) != 0 &&
+	    !(gst_aravis->use_video_meta &&
+	      gst_aravis->is_video_info_valid &&
+	      GST_VIDEO_INFO_N_PLANES (&gst_aravis->video_info) == 1)) {
+		GstMapInfo map;
 		int gst_row_stride;
 		size_t size;
 		char *data;
@@ -541,18 +808,36 @@ gst_aravis_create (GstPushSrc * push_src, GstBuffer ** buffer)
 		size = height * gst_row_stride;
 		data = g_malloc (size);
 
+		if (!gst_buffer_map (pool_buffer, &map, GST_MAP_READ)) {
+			g_free (data);
+			gst_buffer_unref (pool_buffer);
+			goto error;
+		}
+
 		for (i = 0; i < height; i++)
-			memcpy (data + i * gst_row_stride, buffer_data + i * arv_row_stride, arv_row_stride);
+			memcpy (data + i * gst_row_stride, map.data + i * arv_row_stride, arv_row_stride);
+
+		gst_buffer_unmap (pool_buffer, &map);
 
 		*buffer = gst_buffer_new_wrapped (data, size);
+		gst_buffer_add_aravis_meta (*buffer, arv_buffer);
+
+		/* Gives the ArvBuffer back to the stream */
+		gst_buffer_unref (pool_buffer);
 	} else {
-		// FIXME Should arv_stream_push_buffer when the GstBuffer is destroyed
-		*buffer = gst_buffer_new_wrapped_full (0, buffer_data, buffer_size, 0, buffer_size, NULL, NULL);
+		/* Zero copy, the ArvBuffer is given back to the stream once downstream is done with the data */
+		*buffer = pool_buffer;
+		gst_buffer_add_aravis_meta (*buffer, arv_buffer);
 	}
 
+	if (is_incomplete)
+		GST_BUFFER_FLAG_SET (*buffer, GST_BUFFER_FLAG_CORRUPTED);
+
 	if (!base_src_does_timestamp) {
 		if (gst_aravis->timestamp_offset == 0) {
-			gst_aravis->timestamp_offset = timestamp_ns;
+			gst_aravis->timestamp_offset = gst_aravis->sync_group != NULL ?
+				gst_aravis_sync_group_get_timestamp_offset (gst_aravis->sync_group, timestamp_ns) :
+				timestamp_ns;
 			gst_aravis->last_timestamp = timestamp_ns;
 		}
 
@@ -562,7 +847,6 @@ gst_aravis_create (GstPushSrc * push_src, GstBuffer ** buffer)
 		gst_aravis->last_timestamp = timestamp_ns;
 	}
 
-	arv_stream_push_buffer (gst_aravis->stream, arv_buffer);
 	GST_OBJECT_UNLOCK (gst_aravis);
 
 	return GST_FLOW_OK;
@@ -636,15 +920,26 @@ gst_aravis_init (GstAravis *gst_aravis)
 	gst_aravis->auto_packet_size = FALSE;
         gst_aravis->packet_resend = TRUE;
 	gst_aravis->num_arv_buffers = GST_ARAVIS_DEFAULT_N_BUFFERS;
+	gst_aravis->leaky = FALSE;
+	gst_aravis->forward_incomplete = FALSE;
+	gst_aravis->sync_group_name = NULL;
+	gst_aravis->sync_group_size = 0;
+	gst_aravis->sync_tolerance_ns = GST_ARAVIS_SYNC_TOLERANCE_DEFAULT;
+	gst_aravis->sync_group = NULL;
 	gst_aravis->payload = 0;
 
 	gst_aravis->buffer_timeout_us = GST_ARAVIS_BUFFER_TIMEOUT_DEFAULT;
 
 	gst_aravis->camera = NULL;
 	gst_aravis->stream = NULL;
+	gst_aravis->pool = NULL;
 
 	gst_aravis->all_caps = NULL;
 	gst_aravis->fixed_caps = NULL;
+
+	gst_aravis->is_video_info_valid = FALSE;
+	gst_aravis->is_compressed = FALSE;
+	gst_aravis->use_video_meta = FALSE;
 }
 
 static void
@@ -653,22 +948,27 @@ gst_aravis_finalize (GObject * object)
 	GstAravis *gst_aravis = GST_ARAVIS (object);
 	ArvCamera *camera;
 	ArvStream *stream;
+	GstBufferPool *pool;
 	GstCaps *all_caps;
 	GstCaps *fixed_caps;
 
 	GST_OBJECT_LOCK (gst_aravis);
 	camera = g_steal_pointer (&gst_aravis->camera);
 	stream = g_steal_pointer (&gst_aravis->stream);
+	pool = g_steal_pointer (&gst_aravis->pool);
 	all_caps = g_steal_pointer (&gst_aravis->all_caps);
 	fixed_caps = g_steal_pointer (&gst_aravis->fixed_caps);
 	g_clear_pointer (&gst_aravis->camera_name, g_free);
 	g_clear_pointer (&gst_aravis->features, g_free);
+	g_clear_pointer (&gst_aravis->sync_group_name, g_free);
 	GST_OBJECT_UNLOCK (gst_aravis);
 
 	if (camera != NULL)
 		g_object_unref (camera);
 	if (stream != NULL)
 		g_object_unref (stream);
+	if (pool != NULL)
+		gst_object_unref (pool);
 	if (all_caps != NULL)
 		gst_caps_unref (all_caps);
 	if (fixed_caps != NULL)
@@ -768,6 +1068,26 @@ gst_aravis_set_property (GObject * object, guint prop_id,
 		case PROP_NUM_ARV_BUFFERS:
 			gst_aravis->num_arv_buffers = g_value_get_int (value);
 			break;
+		case PROP_LEAKY:
+			gst_aravis->leaky = g_value_get_boolean (value);
+			if (gst_aravis->stream != NULL)
+				g_object_set (gst_aravis->stream, "mailbox", gst_aravis->leaky, NULL);
+			break;
+		case PROP_FORWARD_INCOMPLETE:
+			gst_aravis->forward_incomplete = g_value_get_boolean (value);
+			break;
+		case PROP_SYNC_GROUP:
+			GST_OBJECT_LOCK (gst_aravis);
+			g_free (gst_aravis->sync_group_name);
+			gst_aravis->sync_group_name = g_value_dup_string (value);
+			GST_OBJECT_UNLOCK (gst_aravis);
+			break;
+		case PROP_SYNC_GROUP_SIZE:
+			gst_aravis->sync_group_size = g_value_get_uint (value);
+			break;
+		case PROP_SYNC_TOLERANCE:
+			gst_aravis->sync_tolerance_ns = g_value_get_uint64 (value);
+			break;
 		default:
 			G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
 			break;
@@ -855,6 +1175,23 @@ gst_aravis_get_property (GObject * object, guint prop_id, GValue * value,
 		case PROP_NUM_ARV_BUFFERS:
 			g_value_set_int (value, gst_aravis->num_arv_buffers);
 			break;
+		case PROP_LEAKY:
+			g_value_set_boolean (value, gst_aravis->leaky);
+			break;
+		case PROP_FORWARD_INCOMPLETE:
+			g_value_set_boolean (value, gst_aravis->forward_incomplete);
+			break;
+		case PROP_SYNC_GROUP:
+			GST_OBJECT_LOCK (gst_aravis);
+			g_value_set_string (value, gst_aravis->sync_group_name);
+			GST_OBJECT_UNLOCK (gst_aravis);
+			break;
+		case PROP_SYNC_GROUP_SIZE:
+			g_value_set_uint (value, gst_aravis->sync_group_size);
+			break;
+		case PROP_SYNC_TOLERANCE:
+			g_value_set_uint64 (value, gst_aravis->sync_tolerance_ns);
+			break;
 		default:
 			G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
 			break;
@@ -1002,6 +1339,46 @@ gst_aravis_class_init (GstAravisClass * klass)
 				   "Number of video buffers to allocate for video frames",
 				   1, G_MAXINT, GST_ARAVIS_DEFAULT_N_BUFFERS,
 				   G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+	g_object_class_install_property
+		(gobject_class,
+		 PROP_LEAKY,
+		 g_param_spec_boolean ("leaky",
+				       "Leaky",
+				       "Drop older frames not pushed yet, for the lowest latency",
+				       FALSE,
+				       G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+	g_object_class_install_property
+		(gobject_class,
+		 PROP_FORWARD_INCOMPLETE,
+		 g_param_spec_boolean ("forward-incomplete",
+				       "Forward incomplete frames",
+				       "Push frames with missing packets, flagged as corrupted, instead of dropping them",
+				       FALSE,
+				       G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+	g_object_class_install_property
+		(gobject_class,
+		 PROP_SYNC_GROUP,
+		 g_param_spec_string ("sync-group",
+				      "Synchronization group",
+				      "Name of the group of sources whose frames are aligned in complete, time stamped alike, sets",
+				      NULL,
+				      G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+	g_object_class_install_property
+		(gobject_class,
+		 PROP_SYNC_GROUP_SIZE,
+		 g_param_spec_uint ("sync-group-size",
+				    "Synchronization group size",
+				    "Number of sources of a complete set (0 = sources started so far)",
+				    0, G_MAXUINT, 0,
+				    G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+	g_object_class_install_property
+		(gobject_class,
+		 PROP_SYNC_TOLERANCE,
+		 g_param_spec_uint64 ("sync-tolerance",
+				      "Synchronization tolerance",
+				      "Maximum timestamp difference between the frames of a set (in ns)",
+				      0, G_MAXUINT64, GST_ARAVIS_SYNC_TOLERANCE_DEFAULT,
+				      G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 
         GST_DEBUG_CATEGORY_INIT (aravis_debug, "aravissrc", 0, "Aravis interface");
 
@@ -1018,6 +1395,7 @@ gst_aravis_class_init (GstAravisClass * klass)
 	gstbasesrc_class->fixate = GST_DEBUG_FUNCPTR (gst_aravis_fixate_caps);
 	gstbasesrc_class->start = GST_DEBUG_FUNCPTR (gst_aravis_start);
 	gstbasesrc_class->stop = GST_DEBUG_FUNCPTR (gst_aravis_stop);
+	gstbasesrc_class->decide_allocation = GST_DEBUG_FUNCPTR (gst_aravis_decide_allocation);
 
 	gstbasesrc_class->get_times = GST_DEBUG_FUNCPTR (gst_aravis_get_times);
 
@@ -1027,7 +1405,8 @@ gst_aravis_class_init (GstAravisClass * klass)
 static gboolean
 plugin_init (GstPlugin * plugin)
 {
-        return gst_element_register (plugin, "aravissrc", GST_RANK_NONE, GST_TYPE_ARAVIS);
+        return gst_element_register (plugin, "aravissrc", GST_RANK_NONE, GST_TYPE_ARAVIS) &&
+		gst_element_register (plugin, "aravisconvert", GST_RANK_NONE, GST_TYPE_ARAVIS_CONVERT);
 }
 
 #define PACKAGE "aravis"
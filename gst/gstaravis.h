@@ -25,6 +25,8 @@
 
 #include <gst/gst.h>
 #include <gst/base/gstpushsrc.h>
+#include <gst/video/video.h>
+#include <gstaravissyncgroup.h>
 #include <arv.h>
 
 G_BEGIN_DECLS
@@ -56,6 +58,16 @@ struct _GstAravis {
 	gint h_binning;
 	gint v_binning;
 	gint num_arv_buffers;
+	/* Only the latest frame is kept in the stream output queue */
+	gboolean leaky;
+	/* Frames with missing packets are pushed, flagged as corrupted */
+	gboolean forward_incomplete;
+
+	/* Frame set alignment with the other sources of the same group */
+	char *sync_group_name;
+	guint sync_group_size;
+	guint64 sync_tolerance_ns;
+	GstAravisSyncGroup *sync_group;
 
 	/* GigEVision parameters */
 	int packet_size;
@@ -69,10 +81,22 @@ struct _GstAravis {
 
 	ArvCamera *camera;
 	ArvStream *stream;
+	/* Pool wrapping the stream buffers, set at allocation negotiation */
+	GstBufferPool *pool;
 
 	GstCaps *all_caps;
+	/* Generation of the camera features when all_caps was built, see gst_aravis_update_all_caps() */
+	guint all_caps_generation;
 	GstCaps *fixed_caps;
 
+	/* Negotiated video layout, valid for video/x-raw caps only */
+	GstVideoInfo video_info;
+	gboolean is_video_info_valid;
+	/* image/jpeg or video/x-h264 caps, the frames are passed through with their received size */
+	gboolean is_compressed;
+	/* Downstream accepts GstVideoMeta, row strides don't need to be padded */
+	gboolean use_video_meta;
+
 	guint64 timestamp_offset;
 	guint64 last_timestamp;
 
@@ -0,0 +1,346 @@
+/*
+ * Copyright © 2010-2019 Emmanuel Pacaud <emmanuel@gnome.org>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+/* Buffer pool handing out the stream buffers without copy. The ArvBuffer stays out of the stream as long as a
+ * GstMemory wrapping its data is alive. When the stream buffers are backed by a memory file and the udmabuf
+ * driver is available, the data is exported as dma-buf, which lets hardware encoders or GPU uploaders downstream
+ * import it without copy either. */
+
+#include <gstaravisbufferpool.h>
+#include <gst/allocators/gstdmabuf.h>
+#include <string.h>
+#include <errno.h>
+
+#ifdef GST_ARAVIS_HAS_UDMABUF
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/udmabuf.h>
+#endif
+
+GST_DEBUG_CATEGORY_STATIC (aravis_buffer_pool_debug);
+#define GST_CAT_DEFAULT aravis_buffer_pool_debug
+
+G_DEFINE_TYPE (GstAravisBufferPool, gst_aravis_buffer_pool, GST_TYPE_BUFFER_POOL);
+
+typedef struct {
+	ArvStream *stream;
+	ArvBuffer *buffer;
+} GstAravisBufferRelease;
+
+static GQuark
+gst_aravis_buffer_release_quark (void)
+{
+	return g_quark_from_static_string ("gst-aravis-buffer-release");
+}
+
+static GQuark
+gst_aravis_dmabuf_quark (void)
+{
+	return g_quark_from_static_string ("gst-aravis-dmabuf");
+}
+
+/* Called when the GstMemory wrapping the ArvBuffer data is freed, which may be well after the GstBuffer
+ * destruction if downstream elements shared the memory. */
+
+static void
+gst_aravis_buffer_release (gpointer user_data)
+{
+	GstAravisBufferRelease *release = user_data;
+
+	arv_stream_push_buffer (release->stream, release->buffer);
+	g_object_unref (release->stream);
+	g_free (release);
+}
+
+#ifdef GST_ARAVIS_HAS_UDMABUF
+
+static void
+gst_aravis_dmabuf_close (gpointer data)
+{
+	close (GPOINTER_TO_INT (data) - 1);
+}
+
+/* The dma-buf is created once per stream buffer, and kept alongside it */
+
+static int
+gst_aravis_buffer_pool_get_dmabuf (GstAravisBufferPool *pool, ArvBuffer *arv_buffer, size_t size)
+{
+	struct udmabuf_create create;
+	gpointer data;
+	int fd;
+
+	data = g_object_get_qdata (G_OBJECT (arv_buffer), gst_aravis_dmabuf_quark ());
+	if (data != NULL)
+		return GPOINTER_TO_INT (data) - 1;
+
+	fd = arv_buffer_get_fd (arv_buffer);
+	if (fd < 0)
+		return -1;
+
+	memset (&create, 0, sizeof (create));
+	create.memfd = fd;
+	create.flags = UDMABUF_FLAGS_CLOEXEC;
+	create.offset = 0;
+	create.size = (size + sysconf (_SC_PAGESIZE) - 1) & ~((size_t) sysconf (_SC_PAGESIZE) - 1);
+
+	fd = ioctl (pool->udmabuf_fd, UDMABUF_CREATE, &create);
+	if (fd < 0) {
+		GST_DEBUG_OBJECT (pool, "Failed to create dma-buf: %s", g_strerror (errno));
+		return -1;
+	}
+
+	g_object_set_qdata_full (G_OBJECT (arv_buffer), gst_aravis_dmabuf_quark (),
+				 GINT_TO_POINTER (fd + 1), gst_aravis_dmabuf_close);
+
+	return fd;
+}
+
+#endif
+
+static GstMemory *
+gst_aravis_buffer_pool_wrap (GstAravisBufferPool *pool, ArvBuffer *arv_buffer)
+{
+	GstAravisBufferRelease *release;
+	GstMemory *memory = NULL;
+	const void *data;
+	size_t received_size;
+	size_t size;
+
+	data = arv_buffer_get_data (arv_buffer, &size);
+	received_size = arv_buffer_get_received_size (arv_buffer);
+
+#ifdef GST_ARAVIS_HAS_UDMABUF
+	if (pool->udmabuf_fd >= 0) {
+		int fd;
+
+		fd = gst_aravis_buffer_pool_get_dmabuf (pool, arv_buffer, size);
+		if (fd >= 0)
+			fd = dup (fd);
+		if (fd >= 0)
+			memory = gst_dmabuf_allocator_alloc (pool->dmabuf_allocator, fd, size);
+	}
+#endif
+
+	if (memory == NULL)
+		memory = gst_memory_new_wrapped (GST_MEMORY_FLAG_READONLY, (gpointer) data, size, 0, size, NULL, NULL);
+
+	/* Compressed frames only fill the beginning of the buffer */
+	if (received_size < size)
+		gst_memory_resize (memory, 0, received_size);
+
+	release = g_new (GstAravisBufferRelease, 1);
+	release->stream = g_object_ref (pool->stream);
+	release->buffer = arv_buffer;
+
+	gst_mini_object_set_qdata (GST_MINI_OBJECT (memory), gst_aravis_buffer_release_quark (),
+				   release, gst_aravis_buffer_release);
+
+	return memory;
+}
+
+/* Frames with missing packets still have valid image informations and partially filled data */
+
+static gboolean
+gst_aravis_buffer_pool_is_buffer_usable (GstAravisBufferPool *pool, ArvBuffer *arv_buffer)
+{
+	switch (arv_buffer_get_status (arv_buffer)) {
+		case ARV_BUFFER_STATUS_SUCCESS:
+			return TRUE;
+		case ARV_BUFFER_STATUS_MISSING_PACKETS:
+		case ARV_BUFFER_STATUS_TIMEOUT:
+			return pool->forward_incomplete &&
+				(arv_buffer_get_payload_type (arv_buffer) == ARV_BUFFER_PAYLOAD_TYPE_IMAGE ||
+				 arv_buffer_get_payload_type (arv_buffer) == ARV_BUFFER_PAYLOAD_TYPE_IMAGE_EXTENDED_CHUNK);
+		default:
+			return FALSE;
+	}
+}
+
+static GstFlowReturn
+gst_aravis_buffer_pool_acquire_buffer (GstBufferPool *bpool, GstBuffer **buffer,
+				       GstBufferPoolAcquireParams *params)
+{
+	GstAravisBufferPool *pool = GST_ARAVIS_BUFFER_POOL (bpool);
+	ArvBuffer *arv_buffer = NULL;
+
+	do {
+		if (arv_buffer) arv_stream_push_buffer (pool->stream, arv_buffer);
+		arv_buffer = arv_stream_timeout_pop_buffer (pool->stream, pool->timeout_us);
+	} while (arv_buffer != NULL && !gst_aravis_buffer_pool_is_buffer_usable (pool, arv_buffer));
+
+	if (arv_buffer == NULL)
+		return GST_FLOW_ERROR;
+
+	*buffer = gst_buffer_new ();
+	gst_buffer_append_memory (*buffer, gst_aravis_buffer_pool_wrap (pool, arv_buffer));
+
+	if (pool->add_video_meta && pool->is_video_info_valid &&
+	    GST_VIDEO_INFO_N_PLANES (&pool->video_info) == 1) {
+		gsize offset[GST_VIDEO_MAX_PLANES] = {0};
+		gint stride[GST_VIDEO_MAX_PLANES] = {0};
+		int width, height;
+
+		arv_buffer_get_image_region (arv_buffer, NULL, NULL, &width, &height);
+		stride[0] = width * ARV_PIXEL_FORMAT_BIT_PER_PIXEL (arv_buffer_get_image_pixel_format (arv_buffer)) / 8;
+
+		gst_buffer_add_video_meta_full (*buffer, GST_VIDEO_FRAME_FLAG_NONE,
+						GST_VIDEO_INFO_FORMAT (&pool->video_info),
+						width, height, 1, offset, stride);
+	}
+
+	return GST_FLOW_OK;
+}
+
+/* Buffers are not reused, their lifetime is handled by the memory */
+
+static void
+gst_aravis_buffer_pool_release_buffer (GstBufferPool *bpool, GstBuffer *buffer)
+{
+	gst_buffer_unref (buffer);
+}
+
+static gboolean
+gst_aravis_buffer_pool_start (GstBufferPool *bpool)
+{
+	GstAravisBufferPool *pool = GST_ARAVIS_BUFFER_POOL (bpool);
+
+#ifdef GST_ARAVIS_HAS_UDMABUF
+	if (pool->udmabuf_fd < 0)
+		pool->udmabuf_fd = open ("/dev/udmabuf", O_RDWR | O_CLOEXEC);
+	GST_DEBUG_OBJECT (pool, "dma-buf export %s", pool->udmabuf_fd >= 0 ? "enabled" : "disabled");
+#endif
+
+	/* The stream owns the buffers, nothing to preallocate */
+	return TRUE;
+}
+
+static const gchar **
+gst_aravis_buffer_pool_get_options (GstBufferPool *bpool)
+{
+	static const gchar *options[] = { GST_BUFFER_POOL_OPTION_VIDEO_META, NULL };
+
+	return options;
+}
+
+static gboolean
+gst_aravis_buffer_pool_set_config (GstBufferPool *bpool, GstStructure *config)
+{
+	GstAravisBufferPool *pool = GST_ARAVIS_BUFFER_POOL (bpool);
+	GstCaps *caps = NULL;
+
+	if (!gst_buffer_pool_config_get_params (config, &caps, NULL, NULL, NULL))
+		return FALSE;
+
+	pool->is_video_info_valid = caps != NULL && gst_video_info_from_caps (&pool->video_info, caps);
+	pool->add_video_meta = gst_buffer_pool_config_has_option (config, GST_BUFFER_POOL_OPTION_VIDEO_META);
+
+	return GST_BUFFER_POOL_CLASS (gst_aravis_buffer_pool_parent_class)->set_config (bpool, config);
+}
+
+/**
+ * gst_aravis_buffer_pool_new:
+ * @stream: the stream the buffers are popped from
+ * @timeout_us: buffer pop timeout, in µs
+ * @forward_incomplete: hand out frames with missing packets
+ *
+ * Returns: a new buffer pool
+ */
+
+GstBufferPool *
+gst_aravis_buffer_pool_new (ArvStream *stream, guint64 timeout_us, gboolean forward_incomplete)
+{
+	GstAravisBufferPool *pool;
+
+	g_return_val_if_fail (ARV_IS_STREAM (stream), NULL);
+
+	pool = g_object_new (GST_TYPE_ARAVIS_BUFFER_POOL, NULL);
+	pool->stream = g_object_ref (stream);
+	pool->timeout_us = timeout_us;
+	pool->forward_incomplete = forward_incomplete;
+
+	return GST_BUFFER_POOL (pool);
+}
+
+
+/**
+ * gst_aravis_buffer_pool_get_arv_buffer:
+ * @buffer: a buffer acquired from a #GstAravisBufferPool
+ *
+ * Returns: (transfer none): the stream buffer holding the data of @buffer, or %NULL
+ */
+
+ArvBuffer *
+gst_aravis_buffer_pool_get_arv_buffer (GstBuffer *buffer)
+{
+	GstAravisBufferRelease *release;
+
+	if (gst_buffer_n_memory (buffer) < 1)
+		return NULL;
+
+	release = gst_mini_object_get_qdata (GST_MINI_OBJECT (gst_buffer_peek_memory (buffer, 0)),
+					     gst_aravis_buffer_release_quark ());
+
+	return release != NULL ? release->buffer : NULL;
+}
+
+static void
+gst_aravis_buffer_pool_init (GstAravisBufferPool *pool)
+{
+	pool->stream = NULL;
+	pool->timeout_us = 0;
+	pool->forward_incomplete = FALSE;
+	pool->is_video_info_valid = FALSE;
+	pool->add_video_meta = FALSE;
+	pool->udmabuf_fd = -1;
+	pool->dmabuf_allocator = gst_dmabuf_allocator_new ();
+}
+
+static void
+gst_aravis_buffer_pool_finalize (GObject *object)
+{
+	GstAravisBufferPool *pool = GST_ARAVIS_BUFFER_POOL (object);
+
+#ifdef GST_ARAVIS_HAS_UDMABUF
+	if (pool->udmabuf_fd >= 0)
+		close (pool->udmabuf_fd);
+#endif
+	gst_object_unref (pool->dmabuf_allocator);
+	g_clear_object (&pool->stream);
+
+	G_OBJECT_CLASS (gst_aravis_buffer_pool_parent_class)->finalize (object);
+}
+
+static void
+gst_aravis_buffer_pool_class_init (GstAravisBufferPoolClass *klass)
+{
+	GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+	GstBufferPoolClass *pool_class = GST_BUFFER_POOL_CLASS (klass);
+
+	GST_DEBUG_CATEGORY_INIT (aravis_buffer_pool_debug, "aravisbufferpool", 0, "Aravis buffer pool");
+
+	gobject_class->finalize = gst_aravis_buffer_pool_finalize;
+
+	pool_class->get_options = GST_DEBUG_FUNCPTR (gst_aravis_buffer_pool_get_options);
+	pool_class->set_config = GST_DEBUG_FUNCPTR (gst_aravis_buffer_pool_set_config);
+	pool_class->start = GST_DEBUG_FUNCPTR (gst_aravis_buffer_pool_start);
+	pool_class->acquire_buffer = GST_DEBUG_FUNCPTR (gst_aravis_buffer_pool_acquire_buffer);
+	pool_class->release_buffer = GST_DEBUG_FUNCPTR (gst_aravis_buffer_pool_release_buffer);
+}
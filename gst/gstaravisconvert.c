@@ -0,0 +1,409 @@
+/*
+ * Copyright © 2010-2019 Emmanuel Pacaud <emmanuel@gnome.org>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/**
+ * SECTION:element-aravisconvert
+ *
+ * Bayer demosaicing and colour conversion using the Aravis vision library
+ *
+ * <refsect2>
+ * <title>Example launch line</title>
+ * |[
+ * gst-launch -v aravissrc ! video/x-bayer,format=rggb ! aravisconvert method=edge-aware ! autovideosink
+ * ]|
+ * </refsect2>
+ */
+
+#include <gstaravisconvert.h>
+#include <string.h>
+
+/* TODO: Add l10n */
+#define _(x) (x)
+
+#define GST_ARAVIS_CONVERT_METHOD_DEFAULT		GST_ARAVIS_CONVERT_METHOD_BILINEAR
+#define GST_ARAVIS_CONVERT_MULTI_THREADED_DEFAULT	TRUE
+
+#define GST_ARAVIS_CONVERT_BAYER_CAPS	"video/x-bayer, format = (string) { bggr, gbrg, grbg, rggb }, " \
+					"width = (int) [ 4, MAX ], height = (int) [ 4, MAX ], " \
+					"framerate = (fraction) [ 0/1, MAX ]"
+#define GST_ARAVIS_CONVERT_RAW_FORMATS	"{ RGB, BGR, RGBA, BGRA, UYVY, YUY2 }"
+
+GST_DEBUG_CATEGORY_STATIC (aravis_convert_debug);
+#define GST_CAT_DEFAULT aravis_convert_debug
+
+enum
+{
+  PROP_0,
+  PROP_METHOD,
+  PROP_MULTI_THREADED
+};
+
+static const struct {
+	const char *name;
+	const char *format;
+	ArvPixelFormat pixel_format;
+} gst_aravis_convert_formats[] = {
+	{"video/x-bayer",	"bggr",		ARV_PIXEL_FORMAT_BAYER_BG_8},
+	{"video/x-bayer",	"gbrg",		ARV_PIXEL_FORMAT_BAYER_GB_8},
+	{"video/x-bayer",	"grbg",		ARV_PIXEL_FORMAT_BAYER_GR_8},
+	{"video/x-bayer",	"rggb",		ARV_PIXEL_FORMAT_BAYER_RG_8},
+	{"video/x-raw",		"RGB",		ARV_PIXEL_FORMAT_RGB_8_PACKED},
+	{"video/x-raw",		"BGR",		ARV_PIXEL_FORMAT_BGR_8_PACKED},
+	{"video/x-raw",		"RGBA",		ARV_PIXEL_FORMAT_RGBA_8_PACKED},
+	{"video/x-raw",		"BGRA",		ARV_PIXEL_FORMAT_BGRA_8_PACKED},
+	{"video/x-raw",		"UYVY",		ARV_PIXEL_FORMAT_YUV_422_PACKED},
+	{"video/x-raw",		"YUY2",		ARV_PIXEL_FORMAT_YUV_422_YUYV_PACKED}
+};
+
+#define GST_TYPE_ARAVIS_CONVERT_METHOD (gst_aravis_convert_method_get_type())
+static GType
+gst_aravis_convert_method_get_type (void)
+{
+	static GType method_type = 0;
+
+	static const GEnumValue methods[] = {
+		{GST_ARAVIS_CONVERT_METHOD_BILINEAR, "Bilinear interpolation", "bilinear"},
+		{GST_ARAVIS_CONVERT_METHOD_EDGE_AWARE, "Edge aware interpolation", "edge-aware"},
+		{0, NULL, NULL},
+	};
+
+	if (!method_type)
+	{
+		method_type = g_enum_register_static("GstAravisConvertMethod", methods);
+	}
+	return method_type;
+}
+
+G_DEFINE_TYPE (GstAravisConvert, gst_aravis_convert, GST_TYPE_BASE_TRANSFORM);
+
+static GstStaticPadTemplate aravis_convert_sink_template = GST_STATIC_PAD_TEMPLATE ("sink",
+										    GST_PAD_SINK,
+										    GST_PAD_ALWAYS,
+										    GST_STATIC_CAPS (GST_ARAVIS_CONVERT_BAYER_CAPS "; "
+												     GST_VIDEO_CAPS_MAKE (GST_ARAVIS_CONVERT_RAW_FORMATS)));
+
+static GstStaticPadTemplate aravis_convert_src_template = GST_STATIC_PAD_TEMPLATE ("src",
+										   GST_PAD_SRC,
+										   GST_PAD_ALWAYS,
+										   GST_STATIC_CAPS (GST_VIDEO_CAPS_MAKE (GST_ARAVIS_CONVERT_RAW_FORMATS)));
+
+/* Reads the pixel format and the image layout of fixed caps. Bayer rows are padded to a multiple of 4 bytes, as
+ * in the other GStreamer bayer elements. */
+
+static gboolean
+gst_aravis_convert_parse_caps (GstCaps *caps, ArvPixelFormat *pixel_format, gint *width, gint *height,
+			       size_t *stride, size_t *size)
+{
+	GstStructure *structure;
+	const char *name;
+	const char *format;
+	unsigned int i;
+
+	structure = gst_caps_get_structure (caps, 0);
+	name = gst_structure_get_name (structure);
+	format = gst_structure_get_string (structure, "format");
+
+	if (format == NULL ||
+	    !gst_structure_get_int (structure, "width", width) ||
+	    !gst_structure_get_int (structure, "height", height))
+		return FALSE;
+
+	*pixel_format = 0;
+	for (i = 0; i < G_N_ELEMENTS (gst_aravis_convert_formats); i++)
+		if (g_strcmp0 (name, gst_aravis_convert_formats[i].name) == 0 &&
+		    g_strcmp0 (format, gst_aravis_convert_formats[i].format) == 0)
+			*pixel_format = gst_aravis_convert_formats[i].pixel_format;
+
+	if (*pixel_format == 0)
+		return FALSE;
+
+	if (g_strcmp0 (name, "video/x-bayer") == 0) {
+		*stride = GST_ROUND_UP_4 (*width);
+		*size = *stride * *height;
+	} else {
+		GstVideoInfo info;
+
+		if (!gst_video_info_from_caps (&info, caps))
+			return FALSE;
+
+		*stride = GST_VIDEO_INFO_PLANE_STRIDE (&info, 0);
+		*size = GST_VIDEO_INFO_SIZE (&info);
+	}
+
+	return TRUE;
+}
+
+static GstCaps *
+gst_aravis_convert_transform_caps (GstBaseTransform *trans, GstPadDirection direction, GstCaps *caps,
+				   GstCaps *filter)
+{
+	GstCaps *result;
+	GstCaps *template_caps;
+	GstCaps *intersection;
+	unsigned int i;
+
+	/* Any supported format may be converted to any other, keep the size and the frame rate */
+	result = gst_caps_new_empty ();
+	for (i = 0; i < gst_caps_get_size (caps); i++) {
+		GstStructure *structure = gst_structure_copy (gst_caps_get_structure (caps, i));
+
+		gst_structure_remove_fields (structure, "format", "colorimetry", "chroma-site", NULL);
+		gst_structure_set_name (structure, "video/x-raw");
+		gst_caps_append_structure (result, gst_structure_copy (structure));
+		if (direction == GST_PAD_SRC) {
+			gst_structure_set_name (structure, "video/x-bayer");
+			gst_caps_append_structure (result, structure);
+		} else
+			gst_structure_free (structure);
+	}
+
+	template_caps = gst_pad_get_pad_template_caps (direction == GST_PAD_SRC ?
+						       GST_BASE_TRANSFORM_SINK_PAD (trans) :
+						       GST_BASE_TRANSFORM_SRC_PAD (trans));
+	intersection = gst_caps_intersect (result, template_caps);
+	gst_caps_unref (template_caps);
+	gst_caps_unref (result);
+	result = gst_caps_simplify (intersection);
+
+	if (filter != NULL) {
+		intersection = gst_caps_intersect_full (filter, result, GST_CAPS_INTERSECT_FIRST);
+
+		gst_caps_unref (result);
+		result = intersection;
+	}
+
+	GST_DEBUG_OBJECT (trans, "Transformed %" GST_PTR_FORMAT " into %" GST_PTR_FORMAT, caps, result);
+
+	return result;
+}
+
+static gboolean
+gst_aravis_convert_get_unit_size (GstBaseTransform *trans, GstCaps *caps, gsize *size)
+{
+	ArvPixelFormat pixel_format;
+	gint width, height;
+	size_t stride;
+	size_t image_size;
+
+	if (!gst_aravis_convert_parse_caps (caps, &pixel_format, &width, &height, &stride, &image_size))
+		return FALSE;
+
+	*size = image_size;
+
+	return TRUE;
+}
+
+static gboolean
+gst_aravis_convert_set_caps (GstBaseTransform *trans, GstCaps *incaps, GstCaps *outcaps)
+{
+	GstAravisConvert *convert = GST_ARAVIS_CONVERT (trans);
+	ArvPixelFormat out_pixel_format;
+	gint out_width, out_height;
+	size_t in_size, out_size;
+
+	if (!gst_aravis_convert_parse_caps (incaps, &convert->in_pixel_format, &convert->width, &convert->height,
+					    &convert->in_stride, &in_size) ||
+	    !gst_aravis_convert_parse_caps (outcaps, &out_pixel_format, &out_width, &out_height,
+					    &convert->out_stride, &out_size)) {
+		GST_ERROR_OBJECT (trans, "Unsupported caps %" GST_PTR_FORMAT " -> %" GST_PTR_FORMAT, incaps, outcaps);
+		return FALSE;
+	}
+
+	if (out_width != convert->width || out_height != convert->height) {
+		GST_ERROR_OBJECT (trans, "Image size can't be changed (%dx%d -> %dx%d)",
+				  convert->width, convert->height, out_width, out_height);
+		return FALSE;
+	}
+
+	convert->out_pixel_format = out_pixel_format;
+	convert->in_row_size = ((size_t) convert->width * ARV_PIXEL_FORMAT_BIT_PER_PIXEL (convert->in_pixel_format) + 7) / 8;
+
+	/* ArvBuffer images have no row padding */
+	if (convert->in_stride != convert->in_row_size) {
+		convert->staging_size = convert->in_row_size * convert->height;
+		convert->staging = g_realloc (convert->staging, convert->staging_size);
+	}
+
+	gst_base_transform_set_passthrough (trans, convert->in_pixel_format == convert->out_pixel_format);
+
+	GST_DEBUG_OBJECT (trans, "Converting 0x%08x to 0x%08x, %dx%d", convert->in_pixel_format,
+			  convert->out_pixel_format, convert->width, convert->height);
+
+	return TRUE;
+}
+
+static GstFlowReturn
+gst_aravis_convert_transform (GstBaseTransform *trans, GstBuffer *inbuf, GstBuffer *outbuf)
+{
+	GstAravisConvert *convert = GST_ARAVIS_CONVERT (trans);
+	GstMapInfo in_map, out_map;
+	ArvBuffer *buffer;
+	ArvBufferConvertFlags flags = ARV_BUFFER_CONVERT_FLAGS_NONE;
+	GError *error = NULL;
+	void *data;
+	gboolean success;
+	gint i;
+
+	if (!gst_buffer_map (inbuf, &in_map, GST_MAP_READ))
+		return GST_FLOW_ERROR;
+	if (!gst_buffer_map (outbuf, &out_map, GST_MAP_WRITE)) {
+		gst_buffer_unmap (inbuf, &in_map);
+		return GST_FLOW_ERROR;
+	}
+
+	data = in_map.data;
+	if (convert->in_stride != convert->in_row_size) {
+		for (i = 0; i < convert->height; i++)
+			memcpy (convert->staging + i * convert->in_row_size, in_map.data + i * convert->in_stride,
+				convert->in_row_size);
+		data = convert->staging;
+	}
+
+	GST_OBJECT_LOCK (convert);
+	if (convert->method == GST_ARAVIS_CONVERT_METHOD_EDGE_AWARE)
+		flags |= ARV_BUFFER_CONVERT_FLAGS_EDGE_AWARE;
+	if (convert->multi_threaded)
+		flags |= ARV_BUFFER_CONVERT_FLAGS_MULTI_THREADED;
+	GST_OBJECT_UNLOCK (convert);
+
+	buffer = arv_buffer_new_image (convert->in_pixel_format, convert->width, convert->height,
+				       convert->in_row_size * convert->height, data);
+	success = arv_buffer_convert_full (buffer, convert->out_pixel_format, out_map.data, convert->out_stride,
+					   flags, &error);
+	g_object_unref (buffer);
+
+	gst_buffer_unmap (outbuf, &out_map);
+	gst_buffer_unmap (inbuf, &in_map);
+
+	if (!success) {
+		GST_ELEMENT_ERROR (convert, STREAM, FORMAT, (_("Conversion failed")),
+				   ("%s", error != NULL ? error->message : "Unknown error"));
+		g_clear_error (&error);
+		return GST_FLOW_ERROR;
+	}
+
+	return GST_FLOW_OK;
+}
+
+static void
+gst_aravis_convert_init (GstAravisConvert *convert)
+{
+	convert->method = GST_ARAVIS_CONVERT_METHOD_DEFAULT;
+	convert->multi_threaded = GST_ARAVIS_CONVERT_MULTI_THREADED_DEFAULT;
+	convert->staging = NULL;
+	convert->staging_size = 0;
+}
+
+static void
+gst_aravis_convert_finalize (GObject * object)
+{
+	GstAravisConvert *convert = GST_ARAVIS_CONVERT (object);
+
+	g_clear_pointer (&convert->staging, g_free);
+
+	G_OBJECT_CLASS (gst_aravis_convert_parent_class)->finalize (object);
+}
+
+static void
+gst_aravis_convert_set_property (GObject * object, guint prop_id,
+				 const GValue * value, GParamSpec * pspec)
+{
+	GstAravisConvert *convert = GST_ARAVIS_CONVERT (object);
+
+	switch (prop_id) {
+		case PROP_METHOD:
+			GST_OBJECT_LOCK (convert);
+			convert->method = g_value_get_enum (value);
+			GST_OBJECT_UNLOCK (convert);
+			break;
+		case PROP_MULTI_THREADED:
+			GST_OBJECT_LOCK (convert);
+			convert->multi_threaded = g_value_get_boolean (value);
+			GST_OBJECT_UNLOCK (convert);
+			break;
+		default:
+			G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+			break;
+	}
+}
+
+static void
+gst_aravis_convert_get_property (GObject * object, guint prop_id, GValue * value,
+				 GParamSpec * pspec)
+{
+	GstAravisConvert *convert = GST_ARAVIS_CONVERT (object);
+
+	switch (prop_id) {
+		case PROP_METHOD:
+			g_value_set_enum (value, convert->method);
+			break;
+		case PROP_MULTI_THREADED:
+			g_value_set_boolean (value, convert->multi_threaded);
+			break;
+		default:
+			G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+			break;
+	}
+}
+
+static void
+gst_aravis_convert_class_init (GstAravisConvertClass * klass)
+{
+	GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+	GstElementClass *element_class = GST_ELEMENT_CLASS (klass);
+	GstBaseTransformClass *gstbasetransform_class = GST_BASE_TRANSFORM_CLASS (klass);
+
+	gobject_class->finalize = GST_DEBUG_FUNCPTR (gst_aravis_convert_finalize);
+	gobject_class->set_property = GST_DEBUG_FUNCPTR (gst_aravis_convert_set_property);
+	gobject_class->get_property = GST_DEBUG_FUNCPTR (gst_aravis_convert_get_property);
+
+	g_object_class_install_property
+		(gobject_class,
+		 PROP_METHOD,
+		 g_param_spec_enum ("method",
+				    "Demosaicing method",
+				    "Interpolation used for the Bayer images",
+				    GST_TYPE_ARAVIS_CONVERT_METHOD, GST_ARAVIS_CONVERT_METHOD_DEFAULT,
+				    G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+	g_object_class_install_property
+		(gobject_class,
+		 PROP_MULTI_THREADED,
+		 g_param_spec_boolean ("multi-threaded",
+				       "Multi-threaded",
+				       "Split the conversion of each image across a pool of worker threads",
+				       GST_ARAVIS_CONVERT_MULTI_THREADED_DEFAULT,
+				       G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+        GST_DEBUG_CATEGORY_INIT (aravis_convert_debug, "aravisconvert", 0, "Aravis converter");
+
+	gst_element_class_set_details_simple (element_class,
+					      "Aravis Video Converter",
+					      "Filter/Converter/Video",
+					      "Aravis based bayer demosaicing and colour conversion",
+					      "Emmanuel Pacaud <emmanuel@gnome.org>");
+	gst_element_class_add_pad_template (element_class,
+					    gst_static_pad_template_get (&aravis_convert_sink_template));
+	gst_element_class_add_pad_template (element_class,
+					    gst_static_pad_template_get (&aravis_convert_src_template));
+
+	gstbasetransform_class->transform_caps = GST_DEBUG_FUNCPTR (gst_aravis_convert_transform_caps);
+	gstbasetransform_class->get_unit_size = GST_DEBUG_FUNCPTR (gst_aravis_convert_get_unit_size);
+	gstbasetransform_class->set_caps = GST_DEBUG_FUNCPTR (gst_aravis_convert_set_caps);
+	gstbasetransform_class->transform = GST_DEBUG_FUNCPTR (gst_aravis_convert_transform);
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright © 2010-2019 Emmanuel Pacaud <emmanuel@gnome.org>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef ARV_GST_CONVERT_H
+#define ARV_GST_CONVERT_H
+
+#include <gst/gst.h>
+#include <gst/base/gstbasetransform.h>
+#include <gst/video/video.h>
+#include <arv.h>
+
+G_BEGIN_DECLS
+
+#define GST_TYPE_ARAVIS_CONVERT 		(gst_aravis_convert_get_type())
+#define GST_ARAVIS_CONVERT(obj)			(G_TYPE_CHECK_INSTANCE_CAST((obj),GST_TYPE_ARAVIS_CONVERT,GstAravisConvert))
+#define GST_ARAVIS_CONVERT_CLASS(klass) 	(G_TYPE_CHECK_CLASS_CAST((klass),GST_TYPE_ARAVIS_CONVERT,GstAravisConvert))
+#define GST_IS_ARAVIS_CONVERT(obj) 		(G_TYPE_CHECK_INSTANCE_TYPE((obj),GST_TYPE_ARAVIS_CONVERT))
+#define GST_IS_ARAVIS_CONVERT_CLASS(obj)	(G_TYPE_CHECK_CLASS_TYPE((klass),GST_TYPE_ARAVIS_CONVERT))
+
+typedef enum {
+	GST_ARAVIS_CONVERT_METHOD_BILINEAR,
+	GST_ARAVIS_CONVERT_METHOD_EDGE_AWARE
+} GstAravisConvertMethod;
+
+typedef struct _GstAravisConvert GstAravisConvert;
+typedef struct _GstAravisConvertClass GstAravisConvertClass;
+
+struct _GstAravisConvert {
+	GstBaseTransform element;
+
+	GstAravisConvertMethod method;
+	gboolean multi_threaded;
+
+	/* Negotiated layouts */
+	ArvPixelFormat in_pixel_format;
+	ArvPixelFormat out_pixel_format;
+	gint width;
+	gint height;
+	size_t in_stride;
+	size_t in_row_size;
+	size_t out_stride;
+
+	/* Copy of the input image without row padding */
+	guint8 *staging;
+	size_t staging_size;
+};
+
+struct _GstAravisConvertClass {
+	GstBaseTransformClass parent_class;
+};
+
+GType gst_aravis_convert_get_type (void);
+
+G_END_DECLS
+
+#endif
@@ -0,0 +1,209 @@
+/*
+ * Copyright © 2010-2019 Emmanuel Pacaud <emmanuel@gnome.org>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+/* Per frame metadata attached by aravissrc, for downstream elements that need the device frame id, timestamp or
+ * chunk data without going back to the ArvBuffer, which is given back to the stream independently of the
+ * GstBuffer metadata lifetime. */
+
+#include <gstaravismeta.h>
+
+GType
+gst_aravis_meta_api_get_type (void)
+{
+	static GType type = 0;
+	static const gchar *tags[] = { NULL };
+
+	if (g_once_init_enter (&type)) {
+		GType _type = gst_meta_api_type_register ("GstAravisMetaAPI", tags);
+		g_once_init_leave (&type, _type);
+	}
+
+	return type;
+}
+
+static void
+gst_aravis_meta_clear_chunk (gpointer data)
+{
+	GstAravisMetaChunk *chunk = data;
+
+	g_bytes_unref (chunk->data);
+}
+
+static gboolean
+gst_aravis_meta_init (GstMeta *meta, gpointer params, GstBuffer *buffer)
+{
+	GstAravisMeta *aravis_meta = (GstAravisMeta *) meta;
+
+	aravis_meta->frame_id = 0;
+	aravis_meta->timestamp_ns = 0;
+	aravis_meta->system_timestamp_ns = 0;
+	aravis_meta->status = ARV_BUFFER_STATUS_UNKNOWN;
+	aravis_meta->chunks = g_array_new (FALSE, FALSE, sizeof (GstAravisMetaChunk));
+	g_array_set_clear_func (aravis_meta->chunks, gst_aravis_meta_clear_chunk);
+	aravis_meta->missing_ranges = g_array_new (FALSE, FALSE, sizeof (ArvBufferMissingRange));
+
+	return TRUE;
+}
+
+static void
+gst_aravis_meta_free (GstMeta *meta, GstBuffer *buffer)
+{
+	GstAravisMeta *aravis_meta = (GstAravisMeta *) meta;
+
+	g_array_unref (aravis_meta->chunks);
+	g_array_unref (aravis_meta->missing_ranges);
+}
+
+static gboolean
+gst_aravis_meta_transform (GstBuffer *dest, GstMeta *meta, GstBuffer *buffer, GQuark type, gpointer data)
+{
+	GstAravisMeta *aravis_meta = (GstAravisMeta *) meta;
+	GstAravisMeta *dest_meta;
+	guint i;
+
+	/* The frame description is still valid for any copy or transformation of the buffer */
+	dest_meta = (GstAravisMeta *) gst_buffer_add_meta (dest, GST_ARAVIS_META_INFO, NULL);
+	if (dest_meta == NULL)
+		return FALSE;
+
+	dest_meta->frame_id = aravis_meta->frame_id;
+	dest_meta->timestamp_ns = aravis_meta->timestamp_ns;
+	dest_meta->system_timestamp_ns = aravis_meta->system_timestamp_ns;
+	dest_meta->status = aravis_meta->status;
+
+	for (i = 0; i < aravis_meta->chunks->len; i++) {
+		GstAravisMetaChunk chunk = g_array_index (aravis_meta->chunks, GstAravisMetaChunk, i);
+
+		g_bytes_ref (chunk.data);
+		g_array_append_val (dest_meta->chunks, chunk);
+	}
+
+	g_array_append_vals (dest_meta->missing_ranges, aravis_meta->missing_ranges->data,
+			     aravis_meta->missing_ranges->len);
+
+	return TRUE;
+}
+
+const GstMetaInfo *
+gst_aravis_meta_get_info (void)
+{
+	static const GstMetaInfo *meta_info = NULL;
+
+	if (g_once_init_enter ((GstMetaInfo **) &meta_info)) {
+		const GstMetaInfo *info = gst_meta_register (GST_ARAVIS_META_API_TYPE, "GstAravisMeta",
+							     sizeof (GstAravisMeta),
+							     gst_aravis_meta_init,
+							     gst_aravis_meta_free,
+							     gst_aravis_meta_transform);
+		g_once_init_leave ((GstMetaInfo **) &meta_info, (GstMetaInfo *) info);
+	}
+
+	return meta_info;
+}
+
+/**
+ * gst_buffer_add_aravis_meta:
+ * @buffer: a #GstBuffer
+ * @arv_buffer: the stream buffer @buffer was filled from
+ *
+ * Attaches the description of @arv_buffer to @buffer. The chunk data is copied, as @arv_buffer may be reused by
+ * the stream before @buffer is freed.
+ *
+ * Returns: (transfer none): the new #GstAravisMeta
+ */
+
+GstAravisMeta *
+gst_buffer_add_aravis_meta (GstBuffer *buffer, ArvBuffer *arv_buffer)
+{
+	GstAravisMeta *meta;
+	const ArvBufferMissingRange *missing_ranges;
+	guint n_missing_ranges;
+	guint n_chunks;
+	guint i;
+
+	g_return_val_if_fail (GST_IS_BUFFER (buffer), NULL);
+	g_return_val_if_fail (ARV_IS_BUFFER (arv_buffer), NULL);
+
+	meta = (GstAravisMeta *) gst_buffer_add_meta (buffer, GST_ARAVIS_META_INFO, NULL);
+
+	meta->frame_id = arv_buffer_get_frame_id (arv_buffer);
+	meta->timestamp_ns = arv_buffer_get_timestamp (arv_buffer);
+	meta->system_timestamp_ns = arv_buffer_get_system_timestamp (arv_buffer);
+	meta->status = arv_buffer_get_status (arv_buffer);
+
+	/* The chunk trailer of an incomplete frame can't be trusted */
+	n_chunks = meta->status == ARV_BUFFER_STATUS_SUCCESS ? arv_buffer_get_n_chunks (arv_buffer) : 0;
+	for (i = 0; i < n_chunks; i++) {
+		GstAravisMetaChunk chunk;
+		const void *data;
+		size_t size;
+
+		data = arv_buffer_get_nth_chunk_data (arv_buffer, i, &chunk.id, &size);
+		if (data == NULL)
+			continue;
+
+		chunk.data = g_bytes_new (data, size);
+		g_array_append_val (meta->chunks, chunk);
+	}
+
+	missing_ranges = arv_buffer_get_missing_ranges (arv_buffer, &n_missing_ranges);
+	if (missing_ranges != NULL)
+		g_array_append_vals (meta->missing_ranges, missing_ranges, n_missing_ranges);
+
+	return meta;
+}
+
+/**
+ * gst_buffer_get_aravis_meta:
+ * @buffer: a #GstBuffer
+ *
+ * Returns: (transfer none): the #GstAravisMeta of @buffer, or %NULL
+ */
+
+GstAravisMeta *
+gst_buffer_get_aravis_meta (GstBuffer *buffer)
+{
+	return (GstAravisMeta *) gst_buffer_get_meta (buffer, GST_ARAVIS_META_API_TYPE);
+}
+
+/**
+ * gst_aravis_meta_get_chunk_data:
+ * @meta: a #GstAravisMeta
+ * @chunk_id: chunk id
+ *
+ * Returns: (transfer none): the chunk data, or %NULL if the frame has no such chunk
+ */
+
+GBytes *
+gst_aravis_meta_get_chunk_data (GstAravisMeta *meta, guint64 chunk_id)
+{
+	guint i;
+
+	g_return_val_if_fail (meta != NULL, NULL);
+
+	for (i = 0; i < meta->chunks->len; i++) {
+		GstAravisMetaChunk *chunk = &g_array_index (meta->chunks, GstAravisMetaChunk, i);
+
+		if (chunk->id == chunk_id)
+			return chunk->data;
+	}
+
+	return NULL;
+}
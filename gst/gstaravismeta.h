@@ -0,0 +1,75 @@
+/*
+ * Copyright © 2010-2019 Emmanuel Pacaud <emmanuel@gnome.org>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef ARV_GST_META_H
+#define ARV_GST_META_H
+
+#include <gst/gst.h>
+#include <arv.h>
+
+G_BEGIN_DECLS
+
+#define GST_ARAVIS_META_API_TYPE	(gst_aravis_meta_api_get_type())
+#define GST_ARAVIS_META_INFO		(gst_aravis_meta_get_info())
+
+typedef struct _GstAravisMeta GstAravisMeta;
+
+/**
+ * GstAravisMeta:
+ * @meta: parent #GstMeta
+ * @frame_id: frame id, as sent by the device
+ * @timestamp_ns: device timestamp, in ns
+ * @system_timestamp_ns: host time of the frame reception, in ns
+ * @status: acquisition status, frames different from %ARV_BUFFER_STATUS_SUCCESS are only forwarded when
+ * the forward-incomplete property of aravissrc is set
+ * @chunks: (element-type GstAravisMetaChunk): copy of the chunk data of the frame
+ * @missing_ranges: (element-type ArvBufferMissingRange): parts of an incomplete frame never received, see
+ * arv_buffer_get_missing_ranges(). The offsets are the ones of the stream buffer, which differ from the
+ * offsets in the GstBuffer when its rows were padded, while the rows stay valid.
+ */
+
+struct _GstAravisMeta {
+	GstMeta meta;
+
+	guint64 frame_id;
+	guint64 timestamp_ns;
+	guint64 system_timestamp_ns;
+	ArvBufferStatus status;
+
+	GArray *chunks;
+	GArray *missing_ranges;
+};
+
+typedef struct {
+	guint64 id;
+	GBytes *data;
+} GstAravisMetaChunk;
+
+GType 			gst_aravis_meta_api_get_type 	(void);
+const GstMetaInfo *	gst_aravis_meta_get_info 	(void);
+
+GstAravisMeta *		gst_buffer_add_aravis_meta	(GstBuffer *buffer, ArvBuffer *arv_buffer);
+GstAravisMeta *		gst_buffer_get_aravis_meta	(GstBuffer *buffer);
+
+GBytes *		gst_aravis_meta_get_chunk_data	(GstAravisMeta *meta, guint64 chunk_id);
+
+G_END_DECLS
+
+#endif
@@ -0,0 +1,275 @@
+/*
+ * Copyright © 2010-2019 Emmanuel Pacaud <emmanuel@gnome.org>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+/* Frame set alignment between aravissrc elements of the same sync group. Each element submits the host timestamp of
+ * its current frame, which is comparable between devices as the stream clock model maps the device clocks, PTP
+ * disciplined or not, to the host monotonic clock. A frame set is complete when every member has a frame within
+ * the tolerance of the newest one. Frames older than that are dropped, and so are the frames of a set that is not
+ * completed before the timeout. All the frames of a set are given the same timestamp, the one of the newest frame,
+ * and the timestamps are rebased on an offset common to the group. Until the expected number of members have joined,
+ * every frame is dropped. */
+
+#include <gstaravissyncgroup.h>
+
+typedef struct {
+	gpointer owner;
+
+	guint64 timestamp_ns;
+	gboolean has_frame;
+
+	/* Set by the member completing the set */
+	gboolean accepted;
+	guint64 set_timestamp_ns;
+} GstAravisSyncMember;
+
+struct _GstAravisSyncGroup {
+	char *name;
+	int ref_count;
+
+	GMutex mutex;
+	GCond cond;
+
+	GList *members;
+	/* Number of members a set needs, 0 for the current member count */
+	guint n_expected_members;
+
+	guint64 timestamp_offset;
+};
+
+static GMutex registry_mutex;
+static GHashTable *registry = NULL;
+
+GstAravisSyncGroup *
+gst_aravis_sync_group_join (const char *name, guint n_expected_members, gpointer member)
+{
+	GstAravisSyncGroup *group;
+	GstAravisSyncMember *sync_member;
+
+	g_return_val_if_fail (name != NULL, NULL);
+
+	g_mutex_lock (&registry_mutex);
+
+	if (registry == NULL)
+		registry = g_hash_table_new (g_str_hash, g_str_equal);
+
+	group = g_hash_table_lookup (registry, name);
+	if (group == NULL) {
+		group = g_new0 (GstAravisSyncGroup, 1);
+		group->name = g_strdup (name);
+		g_mutex_init (&group->mutex);
+		g_cond_init (&group->cond);
+		g_hash_table_insert (registry, group->name, group);
+	}
+	group->ref_count++;
+	group->n_expected_members = MAX (group->n_expected_members, n_expected_members);
+
+	g_mutex_unlock (&registry_mutex);
+
+	sync_member = g_new0 (GstAravisSyncMember, 1);
+	sync_member->owner = member;
+
+	g_mutex_lock (&group->mutex);
+	group->members = g_list_prepend (group->members, sync_member);
+	g_mutex_unlock (&group->mutex);
+
+	return group;
+}
+
+void
+gst_aravis_sync_group_leave (GstAravisSyncGroup *group, gpointer member)
+{
+	GList *iter;
+	gboolean is_last;
+
+	g_return_if_fail (group != NULL);
+
+	g_mutex_lock (&group->mutex);
+	for (iter = group->members; iter != NULL; iter = iter->next) {
+		GstAravisSyncMember *sync_member = iter->data;
+
+		if (sync_member->owner == member) {
+			group->members = g_list_delete_link (group->members, iter);
+			g_free (sync_member);
+			break;
+		}
+	}
+	/* The waiting members may now form a complete set */
+	g_cond_broadcast (&group->cond);
+	g_mutex_unlock (&group->mutex);
+
+	g_mutex_lock (&registry_mutex);
+	is_last = --group->ref_count == 0;
+	if (is_last)
+		g_hash_table_remove (registry, group->name);
+	g_mutex_unlock (&registry_mutex);
+
+	if (is_last) {
+		g_list_free_full (group->members, g_free);
+		g_mutex_clear (&group->mutex);
+		g_cond_clear (&group->cond);
+		g_free (group->name);
+		g_free (group);
+	}
+}
+
+static GstAravisSyncMember *
+_find_member (GstAravisSyncGroup *group, gpointer member)
+{
+	GList *iter;
+
+	for (iter = group->members; iter != NULL; iter = iter->next) {
+		GstAravisSyncMember *sync_member = iter->data;
+
+		if (sync_member->owner == member)
+			return sync_member;
+	}
+
+	return NULL;
+}
+
+/* Accepts the pending frames if they form a complete set. Must be called with the group mutex locked. */
+
+static void
+_try_complete_set (GstAravisSyncGroup *group, guint64 tolerance_ns)
+{
+	GList *iter;
+	guint64 min_timestamp_ns = G_MAXUINT64;
+	guint64 max_timestamp_ns = 0;
+
+	if (g_list_length (group->members) < group->n_expected_members)
+		return;
+
+	for (iter = group->members; iter != NULL; iter = iter->next) {
+		GstAravisSyncMember *sync_member = iter->data;
+
+		if (!sync_member->has_frame)
+			return;
+
+		min_timestamp_ns = MIN (min_timestamp_ns, sync_member->timestamp_ns);
+		max_timestamp_ns = MAX (max_timestamp_ns, sync_member->timestamp_ns);
+	}
+
+	if (min_timestamp_ns + tolerance_ns < max_timestamp_ns)
+		return;
+
+	for (iter = group->members; iter != NULL; iter = iter->next) {
+		GstAravisSyncMember *sync_member = iter->data;
+
+		sync_member->has_frame = FALSE;
+		sync_member->accepted = TRUE;
+		sync_member->set_timestamp_ns = max_timestamp_ns;
+	}
+}
+
+static guint64
+_get_newest_timestamp (GstAravisSyncGroup *group)
+{
+	GList *iter;
+	guint64 max_timestamp_ns = 0;
+
+	for (iter = group->members; iter != NULL; iter = iter->next) {
+		GstAravisSyncMember *sync_member = iter->data;
+
+		if (sync_member->has_frame)
+			max_timestamp_ns = MAX (max_timestamp_ns, sync_member->timestamp_ns);
+	}
+
+	return max_timestamp_ns;
+}
+
+/* Blocks until the frame of @member is part of a complete set, or has to be dropped */
+
+GstAravisSyncResult
+gst_aravis_sync_group_submit (GstAravisSyncGroup *group, gpointer member,
+			      guint64 timestamp_ns, guint64 tolerance_ns,
+			      guint64 timeout_us, guint64 *set_timestamp_ns)
+{
+	GstAravisSyncMember *sync_member;
+	GstAravisSyncResult result = GST_ARAVIS_SYNC_RESULT_DROPPED;
+	gint64 end_time;
+
+	g_return_val_if_fail (group != NULL, GST_ARAVIS_SYNC_RESULT_DROPPED);
+
+	if (set_timestamp_ns != NULL)
+		*set_timestamp_ns = timestamp_ns;
+
+	end_time = g_get_monotonic_time () + timeout_us;
+
+	g_mutex_lock (&group->mutex);
+
+	sync_member = _find_member (group, member);
+	if (sync_member == NULL) {
+		g_mutex_unlock (&group->mutex);
+		return GST_ARAVIS_SYNC_RESULT_ACCEPTED;
+	}
+
+	sync_member->timestamp_ns = timestamp_ns;
+	sync_member->has_frame = TRUE;
+	sync_member->accepted = FALSE;
+
+	g_cond_broadcast (&group->cond);
+
+	for (;;) {
+		if (!sync_member->accepted)
+			_try_complete_set (group, tolerance_ns);
+
+		if (sync_member->accepted) {
+			sync_member->accepted = FALSE;
+			if (set_timestamp_ns != NULL)
+				*set_timestamp_ns = sync_member->set_timestamp_ns;
+			result = GST_ARAVIS_SYNC_RESULT_ACCEPTED;
+			break;
+		}
+
+		/* A newer frame from another member, this one will never be part of a set */
+		if (timestamp_ns + tolerance_ns < _get_newest_timestamp (group))
+			break;
+
+		if (!g_cond_wait_until (&group->cond, &group->mutex, end_time) &&
+		    !sync_member->accepted)
+			break;
+	}
+
+	if (result == GST_ARAVIS_SYNC_RESULT_DROPPED)
+		sync_member->has_frame = FALSE;
+
+	g_cond_broadcast (&group->cond);
+	g_mutex_unlock (&group->mutex);
+
+	return result;
+}
+
+/* The first set defines the timestamp origin of the whole group */
+
+guint64
+gst_aravis_sync_group_get_timestamp_offset (GstAravisSyncGroup *group, guint64 timestamp_ns)
+{
+	guint64 offset;
+
+	g_return_val_if_fail (group != NULL, 0);
+
+	g_mutex_lock (&group->mutex);
+	if (group->timestamp_offset == 0)
+		group->timestamp_offset = timestamp_ns;
+	offset = group->timestamp_offset;
+	g_mutex_unlock (&group->mutex);
+
+	return offset;
+}
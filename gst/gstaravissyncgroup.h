@@ -0,0 +1,47 @@
+/*
+ * Copyright © 2010-2019 Emmanuel Pacaud <emmanuel@gnome.org>
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef ARV_GST_SYNC_GROUP_H
+#define ARV_GST_SYNC_GROUP_H
+
+#include <gst/gst.h>
+
+G_BEGIN_DECLS
+
+typedef struct _GstAravisSyncGroup GstAravisSyncGroup;
+
+typedef enum {
+	GST_ARAVIS_SYNC_RESULT_ACCEPTED,
+	GST_ARAVIS_SYNC_RESULT_DROPPED
+} GstAravisSyncResult;
+
+GstAravisSyncGroup *	gst_aravis_sync_group_join			(const char *name, guint n_expected_members,
+									 gpointer member);
+void			gst_aravis_sync_group_leave			(GstAravisSyncGroup *group, gpointer member);
+
+GstAravisSyncResult	gst_aravis_sync_group_submit			(GstAravisSyncGroup *group, gpointer member,
+									 guint64 timestamp_ns, guint64 tolerance_ns,
+									 guint64 timeout_us, guint64 *set_timestamp_ns);
+guint64			gst_aravis_sync_group_get_timestamp_offset	(GstAravisSyncGroup *group,
+									 guint64 timestamp_ns);
+
+G_END_DECLS
+
+#endif
@@ -1,18 +1,749 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2019 Emmanuel Pacaud
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * Author: Emmanuel Pacaud <emmanuel@gnome.org>
+ */
+
+/* In-kernel GVSP receiver.
+ *
+ * The stream packets are intercepted by a netfilter hook, before any socket lookup, and their data is copied from the
+ * socket buffer straight into the user mapped frame buffers. User space is only involved once per frame, and for the
+ * resend requests. This is the kernel counterpart of the packet processing of ArvGvStream, see
+ * src/arvgvstream.c. Only the initial network namespace is handled. */
+
 #include <linux/module.h>
+#include <linux/kernel.h>
+#include <linux/miscdevice.h>
+#include <linux/fs.h>
+#include <linux/mm.h>
+#include <linux/vmalloc.h>
+#include <linux/slab.h>
+#include <linux/bitmap.h>
+#include <linux/poll.h>
+#include <linux/wait.h>
+#include <linux/mutex.h>
+#include <linux/spinlock.h>
+#include <linux/rculist.h>
+#include <linux/uaccess.h>
+#include <linux/timekeeping.h>
+#include <linux/skbuff.h>
+#include <linux/ip.h>
+#include <linux/udp.h>
+#include <linux/netfilter.h>
+#include <linux/netfilter_ipv4.h>
+#include <net/ip.h>
+#include <net/net_namespace.h>
+
+#include "aravis-module.h"
 
 MODULE_LICENSE("GPL");
 MODULE_AUTHOR("Emmanuel Pacaud <emmanuel@gnome.org>");
+MODULE_DESCRIPTION("In-kernel GigE Vision stream receiver");
+
+/* GVSP wire format, see src/arvgvspprivate.h */
+
+#define ARV_GVSP_PACKET_TYPE_RESEND			0x0100
+#define ARV_GVSP_PACKET_TYPE_ERROR_MASK			0x8000
+
+#define ARV_GVSP_PACKET_INFOS_EXTENDED_ID_MODE_MASK	0x80000000
+#define ARV_GVSP_PACKET_INFOS_CONTENT_TYPE_MASK		0x7f000000
+#define ARV_GVSP_PACKET_INFOS_CONTENT_TYPE_POS		24
+#define ARV_GVSP_PACKET_ID_MASK				0x00ffffff
+
+#define ARV_GVSP_CONTENT_TYPE_DATA_LEADER		0x01
+#define ARV_GVSP_CONTENT_TYPE_DATA_TRAILER		0x02
+#define ARV_GVSP_CONTENT_TYPE_DATA_BLOCK		0x03
+#define ARV_GVSP_CONTENT_TYPE_ALL_IN			0x04
+#define ARV_GVSP_CONTENT_TYPE_MULTIPART			0x05
+
+#define ARV_GVSP_PAYLOAD_TYPE_IMAGE			0x0001
+#define ARV_GVSP_PAYLOAD_TYPE_IMAGE_EXTENDED_CHUNK	0x4001
+
+/* IP + UDP headers, as accounted in the packet size of the SCPS register */
+#define ARV_GVSP_PACKET_IP_UDP_OVERHEAD			(20 + 8)
+
+struct arv_gvsp_header {
+	__be16 frame_id;
+	__be32 packet_infos;
+} __packed;
+
+struct arv_gvsp_extended_header {
+	__be16 flags;
+	__be32 packet_infos;
+	__be64 frame_id;
+	__be32 packet_id;
+} __packed;
+
+struct arv_gvsp_packet {
+	__be16 packet_type;
+	union {
+		struct arv_gvsp_header standard;
+		struct arv_gvsp_extended_header extended;
+	};
+} __packed;
+
+struct arv_gvsp_data_leader {
+	__be16 flags;
+	__be16 payload_type;
+	__be32 timestamp_high;
+	__be32 timestamp_low;
+	__be32 pixel_format;
+	__be32 width;
+	__be32 height;
+	__be32 x_offset;
+	__be32 y_offset;
+} __packed;
+
+struct arv_gvsp_multipart {
+	__u8 part_id;
+	__u8 zone_info;
+	__be16 offset_high;
+	__be32 offset_low;
+} __packed;
+
+/* Number of frames reassembled at the same time, waiting for resent packets */
+#define ARV_MODULE_N_FRAMES_MAX		4
+
+struct arv_module_frame {
+	bool is_active;
+	bool is_size_mismatch;
+	u64 frame_id;
+	u64 start_index;
+	u32 buffer_index;
+	/* Next expected packet id, for the detection of the missing packets */
+	u32 next_packet_id;
+	/* Packet id of the trailer, 0 until received */
+	u32 trailer_packet_id;
+	u32 n_received_packets;
+	u32 received_size;
+	/* Leader informations */
+	struct arv_module_event event;
+	/* One bit per received packet id */
+	unsigned long *packets;
+};
+
+struct arv_module_stream {
+	struct list_head link;
+
+	/* Serializes the configuration */
+	struct mutex mutex;
+	/* Protects the reassembly state, taken from softirq context */
+	spinlock_t lock;
+	wait_queue_head_t wait;
+
+	bool is_created;
+	struct arv_module_stream_config config;
+	u32 n_packets_max;
+
+	void *memory;
+	struct arv_module_ring *ring;
+	/* Kernel copy of the ring head, user space having write access to the mapping */
+	u32 ring_head;
+
+	/* Buffers queued by user space, in queue order */
+	u32 free_buffers[ARV_MODULE_N_BUFFERS_MAX];
+	u32 free_first;
+	u32 n_free_buffers;
+	bool is_owned_by_kernel[ARV_MODULE_N_BUFFERS_MAX];
+
+	struct arv_module_frame frames[ARV_MODULE_N_FRAMES_MAX];
+	u64 n_started_frames;
+	u64 last_frame_id;
+	bool has_last_frame_id;
+};
 
-int
-init_module(void)
+static LIST_HEAD (arv_module_streams);
+static DEFINE_SPINLOCK (arv_module_streams_lock);
+
+/* Reassembly, called with stream->lock held */
+
+static bool
+_post_event (struct arv_module_stream *stream, const struct arv_module_event *event)
 {
-	printk (KERN_ALERT "aravis: loaded\n");
+	struct arv_module_ring *ring = stream->ring;
+
+	if (stream->ring_head - READ_ONCE (ring->tail) >= ARV_MODULE_N_EVENTS) {
+		ring->n_dropped_events++;
+		return false;
+	}
+
+	ring->events[stream->ring_head % ARV_MODULE_N_EVENTS] = *event;
+	stream->ring_head++;
+	smp_store_release (&ring->head, stream->ring_head);
+
+	wake_up_interruptible (&stream->wait);
+
+	return true;
+}
+
+static void
+_queue_buffer (struct arv_module_stream *stream, u32 index)
+{
+	stream->free_buffers[(stream->free_first + stream->n_free_buffers) % ARV_MODULE_N_BUFFERS_MAX] = index;
+	stream->n_free_buffers++;
+	stream->is_owned_by_kernel[index] = true;
+}
+
+static void
+_complete_frame (struct arv_module_stream *stream, struct arv_module_frame *frame, u32 status)
+{
+	struct arv_module_event *event = &frame->event;
+	u32 n_packets;
+
+	n_packets = frame->trailer_packet_id != 0 ? frame->trailer_packet_id + 1 : frame->next_packet_id;
+
+	event->type = ARV_MODULE_EVENT_TYPE_FRAME_COMPLETED;
+	event->status = frame->is_size_mismatch ? ARV_MODULE_FRAME_STATUS_SIZE_MISMATCH : status;
+	event->frame_id = frame->frame_id;
+	event->buffer_index = frame->buffer_index;
+	event->received_size = frame->received_size;
+	event->n_packets = n_packets;
+	event->n_missing_packets = n_packets > frame->n_received_packets ? n_packets - frame->n_received_packets : 0;
+	event->system_timestamp_ns = ktime_get_real_ns ();
+
+	stream->is_owned_by_kernel[frame->buffer_index] = false;
+
+	/* A buffer which can't be given back is reused for the next frames */
+	if (!_post_event (stream, event))
+		_queue_buffer (stream, frame->buffer_index);
+
+	bitmap_zero (frame->packets, stream->n_packets_max);
+	frame->is_active = false;
+}
+
+static bool
+_is_newer_frame (u64 frame_id, u64 last_frame_id, bool extended_ids)
+{
+	if (extended_ids)
+		return (s64) (frame_id - last_frame_id) > 0;
+
+	return (s16) (u16) (frame_id - last_frame_id) > 0;
+}
+
+static struct arv_module_frame *
+_find_frame (struct arv_module_stream *stream, u64 frame_id, bool extended_ids)
+{
+	struct arv_module_frame *frame = NULL;
+	unsigned int i;
+
+	for (i = 0; i < ARV_MODULE_N_FRAMES_MAX; i++)
+		if (stream->frames[i].is_active && stream->frames[i].frame_id == frame_id)
+			return &stream->frames[i];
+
+	/* Late packet of a completed or dropped frame */
+	if (stream->has_last_frame_id && !_is_newer_frame (frame_id, stream->last_frame_id, extended_ids))
+		return NULL;
+
+	stream->last_frame_id = frame_id;
+	stream->has_last_frame_id = true;
+
+	for (i = 0; i < ARV_MODULE_N_FRAMES_MAX; i++) {
+		if (!stream->frames[i].is_active) {
+			frame = &stream->frames[i];
+			break;
+		}
+		if (frame == NULL || stream->frames[i].start_index < frame->start_index)
+			frame = &stream->frames[i];
+	}
+
+	/* Give up on the oldest frame */
+	if (frame->is_active)
+		_complete_frame (stream, frame, ARV_MODULE_FRAME_STATUS_MISSING_PACKETS);
+
+	if (stream->n_free_buffers == 0) {
+		stream->ring->n_underruns++;
+		return NULL;
+	}
+
+	frame->buffer_index = stream->free_buffers[stream->free_first];
+	stream->free_first = (stream->free_first + 1) % ARV_MODULE_N_BUFFERS_MAX;
+	stream->n_free_buffers--;
+
+	frame->is_active = true;
+	frame->is_size_mismatch = false;
+	frame->frame_id = frame_id;
+	frame->start_index = stream->n_started_frames++;
+	frame->next_packet_id = 0;
+	frame->trailer_packet_id = 0;
+	frame->n_received_packets = 0;
+	frame->received_size = 0;
+	memset (&frame->event, 0, sizeof (frame->event));
+
+	return frame;
+}
+
+static void
+_process_leader (struct arv_module_frame *frame, const struct sk_buff *skb, unsigned int offset, unsigned int size)
+{
+	struct arv_gvsp_data_leader leader;
+	u32 payload_type;
+
+	memset (&leader, 0, sizeof (leader));
+	if (skb_copy_bits (skb, offset, &leader, min_t (unsigned int, size, sizeof (leader))) < 0)
+		return;
+
+	payload_type = ntohs (leader.payload_type);
+
+	frame->event.payload_type = payload_type;
+	frame->event.timestamp = ((u64) ntohl (leader.timestamp_high) << 32) | ntohl (leader.timestamp_low);
+
+	if (payload_type == ARV_GVSP_PAYLOAD_TYPE_IMAGE ||
+	    payload_type == ARV_GVSP_PAYLOAD_TYPE_IMAGE_EXTENDED_CHUNK) {
+		frame->event.pixel_format = ntohl (leader.pixel_format);
+		frame->event.width = ntohl (leader.width);
+		frame->event.height = ntohl (leader.height);
+		frame->event.x_offset = ntohl (leader.x_offset);
+		frame->event.y_offset = ntohl (leader.y_offset);
+	}
+}
+
+static void
+_process_data (struct arv_module_stream *stream, struct arv_module_frame *frame,
+	       const struct sk_buff *skb, unsigned int offset, unsigned int size, u64 block_offset)
+{
+	if (block_offset + size > stream->config.buffer_size) {
+		frame->is_size_mismatch = true;
+		return;
+	}
+
+	if (skb_copy_bits (skb, offset,
+			   (u8 *) stream->memory + stream->config.buffers_offset +
+			   (u64) frame->buffer_index * stream->config.buffer_stride + block_offset,
+			   size) < 0)
+		return;
+
+	frame->received_size += size;
+}
+
+/* @offset and @size delimit the UDP payload */
+
+static void
+_process_packet (struct arv_module_stream *stream, const struct sk_buff *skb, unsigned int offset, unsigned int size)
+{
+	struct arv_gvsp_packet packet;
+	struct arv_module_frame *frame;
+	unsigned int header_size;
+	unsigned int content_type;
+	u16 packet_type;
+	u32 packet_infos;
+	u32 packet_id;
+	u64 frame_id;
+	bool extended_ids;
+
+	stream->ring->n_packets++;
+
+	memset (&packet, 0, sizeof (packet));
+	if (size < sizeof (packet.packet_type) + sizeof (packet.standard) ||
+	    skb_copy_bits (skb, offset, &packet, min_t (unsigned int, size, sizeof (packet))) < 0)
+		goto ignore;
+
+	packet_type = ntohs (packet.packet_type);
+	packet_infos = ntohl (packet.standard.packet_infos);
+	extended_ids = (packet_infos & ARV_GVSP_PACKET_INFOS_EXTENDED_ID_MODE_MASK) != 0;
+
+	if (extended_ids) {
+		header_size = sizeof (packet.packet_type) + sizeof (packet.extended);
+		if (size < header_size)
+			goto ignore;
+		frame_id = be64_to_cpu (packet.extended.frame_id);
+		packet_id = ntohl (packet.extended.packet_id);
+	} else {
+		header_size = sizeof (packet.packet_type) + sizeof (packet.standard);
+		frame_id = ntohs (packet.standard.frame_id);
+		packet_id = packet_infos & ARV_GVSP_PACKET_ID_MASK;
+	}
+
+	content_type = (packet_infos & ARV_GVSP_PACKET_INFOS_CONTENT_TYPE_MASK) >>
+		ARV_GVSP_PACKET_INFOS_CONTENT_TYPE_POS;
+
+	/* Errors, like the negative answers to resend requests, are left to the user space timeouts */
+	if ((packet_type & ARV_GVSP_PACKET_TYPE_ERROR_MASK) != 0)
+		goto ignore;
+
+	if (packet_type == ARV_GVSP_PACKET_TYPE_RESEND)
+		stream->ring->n_resent_packets++;
+
+	frame = _find_frame (stream, frame_id, extended_ids);
+	if (frame == NULL)
+		goto ignore;
+
+	if (packet_id >= stream->n_packets_max) {
+		frame->is_size_mismatch = true;
+		goto ignore;
+	}
+
+	if (test_and_set_bit (packet_id, frame->packets))
+		return;
+
+	frame->n_received_packets++;
+
+	if (packet_id > frame->next_packet_id && packet_type != ARV_GVSP_PACKET_TYPE_RESEND) {
+		struct arv_module_event event;
+
+		memset (&event, 0, sizeof (event));
+		event.type = ARV_MODULE_EVENT_TYPE_PACKETS_MISSING;
+		event.frame_id = frame_id;
+		event.first_packet_id = frame->next_packet_id;
+		event.last_packet_id = packet_id - 1;
+		_post_event (stream, &event);
+	}
+	if (packet_id >= frame->next_packet_id)
+		frame->next_packet_id = packet_id + 1;
+
+	switch (content_type) {
+		case ARV_GVSP_CONTENT_TYPE_DATA_LEADER:
+			_process_leader (frame, skb, offset + header_size, size - header_size);
+			break;
+		case ARV_GVSP_CONTENT_TYPE_DATA_BLOCK:
+			if (packet_id > 0)
+				_process_data (stream, frame, skb, offset + header_size, size - header_size,
+					       (u64) (packet_id - 1) *
+					       (stream->config.packet_size - ARV_GVSP_PACKET_IP_UDP_OVERHEAD - header_size));
+			break;
+		case ARV_GVSP_CONTENT_TYPE_MULTIPART:
+			{
+				struct arv_gvsp_multipart multipart;
+
+				if (size < header_size + sizeof (multipart) ||
+				    skb_copy_bits (skb, offset + header_size, &multipart, sizeof (multipart)) < 0)
+					break;
+
+				_process_data (stream, frame, skb,
+					       offset + header_size + sizeof (multipart),
+					       size - header_size - sizeof (multipart),
+					       ((u64) ntohs (multipart.offset_high) << 32) | ntohl (multipart.offset_low));
+			}
+			break;
+		case ARV_GVSP_CONTENT_TYPE_DATA_TRAILER:
+			frame->trailer_packet_id = packet_id;
+			break;
+		default:
+			/* All-in packets are only used for small payloads, better received in user space */
+			frame->is_size_mismatch = true;
+			break;
+	}
+
+	if (frame->trailer_packet_id != 0 && frame->n_received_packets == frame->trailer_packet_id + 1)
+		_complete_frame (stream, frame, ARV_MODULE_FRAME_STATUS_SUCCESS);
+
+	return;
+
+ignore:
+	stream->ring->n_ignored_packets++;
+}
+
+static unsigned int
+arv_module_hook (void *priv, struct sk_buff *skb, const struct nf_hook_state *state)
+{
+	struct arv_module_stream *stream;
+	const struct iphdr *iph;
+	const struct udphdr *udph;
+	unsigned int udp_offset;
+	unsigned int udp_size;
+	bool is_consumed = false;
+
+	iph = ip_hdr (skb);
+	if (iph->protocol != IPPROTO_UDP || ip_is_fragment (iph))
+		return NF_ACCEPT;
+
+	udp_offset = skb_network_offset (skb) + ip_hdrlen (skb);
+	if (!pskb_may_pull (skb, udp_offset + sizeof (struct udphdr)))
+		return NF_ACCEPT;
+
+	iph = ip_hdr (skb);
+	udph = (const struct udphdr *) (skb->data + udp_offset);
+
+	udp_size = ntohs (udph->len);
+	if (udp_size < sizeof (struct udphdr) || udp_offset + udp_size > skb->len)
+		return NF_ACCEPT;
+
+	rcu_read_lock ();
+
+	list_for_each_entry_rcu (stream, &arv_module_streams, link) {
+		if (udph->dest != stream->config.destination_port ||
+		    (stream->config.source_port != 0 && udph->source != stream->config.source_port) ||
+		    (stream->config.source_address != 0 && iph->saddr != stream->config.source_address))
+			continue;
+
+		spin_lock (&stream->lock);
+		_process_packet (stream, skb, udp_offset + sizeof (struct udphdr), udp_size - sizeof (struct udphdr));
+		spin_unlock (&stream->lock);
+
+		is_consumed = true;
+		break;
+	}
+
+	rcu_read_unlock ();
+
+	if (!is_consumed)
+		return NF_ACCEPT;
+
+	consume_skb (skb);
+
+	return NF_STOLEN;
+}
+
+static struct nf_hook_ops arv_module_hook_ops = {
+	.hook =		arv_module_hook,
+	.pf =		NFPROTO_IPV4,
+	.hooknum =	NF_INET_PRE_ROUTING,
+	.priority =	NF_IP_PRI_FIRST,
+};
+
+/* Character device */
+
+static int
+arv_module_create_stream (struct arv_module_stream *stream, struct arv_module_stream_config __user *user_config)
+{
+	struct arv_module_stream_config config;
+	unsigned int i;
+	void *memory;
+	int result = 0;
+
+	if (copy_from_user (&config, user_config, sizeof (config)))
+		return -EFAULT;
+
+	if (config.destination_port == 0 ||
+	    config.n_buffers == 0 || config.n_buffers > ARV_MODULE_N_BUFFERS_MAX ||
+	    config.buffer_size == 0 || config.buffer_size > ARV_MODULE_BUFFER_SIZE_MAX ||
+	    config.packet_size <= ARV_GVSP_PACKET_IP_UDP_OVERHEAD + sizeof (struct arv_gvsp_packet) ||
+	    config.packet_size > 65535)
+		return -EINVAL;
+
+	config.ring_size = PAGE_ALIGN (sizeof (struct arv_module_ring));
+	config.buffer_stride = PAGE_ALIGN (config.buffer_size);
+	config.buffers_offset = config.ring_size;
+	config.mmap_size = config.buffers_offset + (u64) config.n_buffers * config.buffer_stride;
+
+	mutex_lock (&stream->mutex);
+
+	if (stream->is_created) {
+		result = -EBUSY;
+		goto out;
+	}
+
+	memory = vmalloc_user (config.mmap_size);
+	if (memory == NULL) {
+		result = -ENOMEM;
+		goto out;
+	}
+
+	/* Smallest data block size, with the extended header */
+	stream->n_packets_max = DIV_ROUND_UP (config.buffer_size,
+					      config.packet_size - ARV_GVSP_PACKET_IP_UDP_OVERHEAD -
+					      sizeof (struct arv_gvsp_packet)) + 2;
+
+	for (i = 0; i < ARV_MODULE_N_FRAMES_MAX; i++) {
+		stream->frames[i].packets = bitmap_zalloc (stream->n_packets_max, GFP_KERNEL);
+		if (stream->frames[i].packets == NULL) {
+			while (i-- > 0)
+				bitmap_free (stream->frames[i].packets);
+			vfree (memory);
+			result = -ENOMEM;
+			goto out;
+		}
+	}
+
+	stream->config = config;
+	stream->memory = memory;
+	stream->ring = memory;
+	stream->ring->n_events = ARV_MODULE_N_EVENTS;
+	stream->is_created = true;
+
+	spin_lock (&arv_module_streams_lock);
+	list_add_tail_rcu (&stream->link, &arv_module_streams);
+	spin_unlock (&arv_module_streams_lock);
+
+	if (copy_to_user (user_config, &config, sizeof (config)))
+		result = -EFAULT;
+
+	printk (KERN_INFO "aravis: stream created on port %u, %u buffers of %u bytes\n",
+		ntohs (config.destination_port), config.n_buffers, config.buffer_size);
+
+out:
+	mutex_unlock (&stream->mutex);
+
+	return result;
+}
+
+static long
+arv_module_ioctl (struct file *file, unsigned int command, unsigned long argument)
+{
+	struct arv_module_stream *stream = file->private_data;
+	unsigned int i;
+	long result = 0;
+	u32 index;
+
+	switch (command) {
+		case ARV_MODULE_IOC_CREATE_STREAM:
+			return arv_module_create_stream (stream, (struct arv_module_stream_config __user *) argument);
+		case ARV_MODULE_IOC_QUEUE_BUFFER:
+			if (get_user (index, (u32 __user *) argument))
+				return -EFAULT;
+
+			mutex_lock (&stream->mutex);
+			if (!stream->is_created || index >= stream->config.n_buffers) {
+				result = -EINVAL;
+			} else {
+				spin_lock_bh (&stream->lock);
+				if (stream->is_owned_by_kernel[index])
+					result = -EBUSY;
+				else
+					_queue_buffer (stream, index);
+				spin_unlock_bh (&stream->lock);
+			}
+			mutex_unlock (&stream->mutex);
+
+			return result;
+		case ARV_MODULE_IOC_FLUSH_FRAMES:
+			mutex_lock (&stream->mutex);
+			if (!stream->is_created) {
+				result = -EINVAL;
+			} else {
+				spin_lock_bh (&stream->lock);
+				for (i = 0; i < ARV_MODULE_N_FRAMES_MAX; i++)
+					if (stream->frames[i].is_active)
+						_complete_frame (stream, &stream->frames[i],
+								 ARV_MODULE_FRAME_STATUS_MISSING_PACKETS);
+				spin_unlock_bh (&stream->lock);
+			}
+			mutex_unlock (&stream->mutex);
+
+			return result;
+		default:
+			return -ENOTTY;
+	}
+}
+
+static int
+arv_module_mmap (struct file *file, struct vm_area_struct *vma)
+{
+	struct arv_module_stream *stream = file->private_data;
+	int result;
+
+	mutex_lock (&stream->mutex);
+	result = stream->is_created ? remap_vmalloc_range (vma, stream->memory, vma->vm_pgoff) : -EINVAL;
+	mutex_unlock (&stream->mutex);
+
+	return result;
+}
+
+static __poll_t
+arv_module_poll (struct file *file, poll_table *wait)
+{
+	struct arv_module_stream *stream = file->private_data;
+	__poll_t mask = 0;
+
+	poll_wait (file, &stream->wait, wait);
+
+	spin_lock_bh (&stream->lock);
+	if (stream->is_created && stream->ring_head != READ_ONCE (stream->ring->tail))
+		mask = EPOLLIN | EPOLLRDNORM;
+	spin_unlock_bh (&stream->lock);
+
+	return mask;
+}
+
+static int
+arv_module_open (struct inode *inode, struct file *file)
+{
+	struct arv_module_stream *stream;
+
+	stream = kzalloc (sizeof (*stream), GFP_KERNEL);
+	if (stream == NULL)
+		return -ENOMEM;
+
+	mutex_init (&stream->mutex);
+	spin_lock_init (&stream->lock);
+	init_waitqueue_head (&stream->wait);
+	INIT_LIST_HEAD (&stream->link);
+
+	file->private_data = stream;
 
 	return 0;
 }
 
-void
-cleanup_module(void)
+static int
+arv_module_release (struct inode *inode, struct file *file)
 {
-	printk (KERN_ALERT "aravis: unloaded\n");
+	struct arv_module_stream *stream = file->private_data;
+	unsigned int i;
+
+	if (stream->is_created) {
+		spin_lock (&arv_module_streams_lock);
+		list_del_rcu (&stream->link);
+		spin_unlock (&arv_module_streams_lock);
+
+		/* Wait for the hook to leave the stream */
+		synchronize_rcu ();
+
+		for (i = 0; i < ARV_MODULE_N_FRAMES_MAX; i++)
+			bitmap_free (stream->frames[i].packets);
+		vfree (stream->memory);
+	}
+
+	mutex_destroy (&stream->mutex);
+	kfree (stream);
+
+	return 0;
 }
+
+static const struct file_operations arv_module_fops = {
+	.owner =		THIS_MODULE,
+	.open =			arv_module_open,
+	.release =		arv_module_release,
+	.unlocked_ioctl =	arv_module_ioctl,
+	.compat_ioctl =		compat_ptr_ioctl,
+	.mmap =			arv_module_mmap,
+	.poll =			arv_module_poll,
+	.llseek =		noop_llseek,
+};
+
+static struct miscdevice arv_module_device = {
+	.minor =	MISC_DYNAMIC_MINOR,
+	.name =		ARV_MODULE_DEVICE_NAME,
+	.fops =		&arv_module_fops,
+};
+
+static int __init
+arv_module_init (void)
+{
+	int result;
+
+	result = misc_register (&arv_module_device);
+	if (result != 0)
+		return result;
+
+	result = nf_register_net_hook (&init_net, &arv_module_hook_ops);
+	if (result != 0) {
+		misc_deregister (&arv_module_device);
+		return result;
+	}
+
+	printk (KERN_INFO "aravis: loaded\n");
+
+	return 0;
+}
+
+static void __exit
+arv_module_exit (void)
+{
+	nf_unregister_net_hook (&init_net, &arv_module_hook_ops);
+	misc_deregister (&arv_module_device);
+
+	printk (KERN_INFO "aravis: unloaded\n");
+}
+
+module_init (arv_module_init);
+module_exit (arv_module_exit);
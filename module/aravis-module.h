@@ -0,0 +1,129 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2019 Emmanuel Pacaud
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * Author: Emmanuel Pacaud <emmanuel@gnome.org>
+ */
+
+/* Interface between the aravis kernel module and user space.
+ *
+ * Each open file of /dev/aravis is a GVSP receiver. Once configured with ARV_MODULE_IOC_CREATE_STREAM, the stream
+ * packets matching the configured UDP tuple are consumed in the kernel and reassembled directly into the buffers
+ * of the file mapping, which user space maps with mmap at offset 0:
+ *
+ *   [ struct arv_module_ring ][ padding ][ buffer 0 ][ buffer 1 ] ... [ buffer n_buffers - 1 ]
+ *   0                          ring_size  buffers_offset + i * buffer_stride
+ *
+ * The buffers are handed to the kernel with ARV_MODULE_IOC_QUEUE_BUFFER, and given back through the event ring,
+ * along with the leader informations of the frame. Missing packets are also signalled through the ring, in order
+ * for user space to send the resend requests on the control channel. The resent packets are reassembled by the
+ * kernel into the frame, which is only completed once all its packets were received, or once user space gives up
+ * with ARV_MODULE_IOC_FLUSH_FRAMES. */
+
+#ifndef ARAVIS_MODULE_H
+#define ARAVIS_MODULE_H
+
+#include <linux/types.h>
+#include <linux/ioctl.h>
+
+#define ARV_MODULE_DEVICE_NAME			"aravis"
+
+#define ARV_MODULE_N_BUFFERS_MAX		256
+#define ARV_MODULE_BUFFER_SIZE_MAX		(256 * 1024 * 1024)
+/* Number of entries of the event ring, a power of 2 */
+#define ARV_MODULE_N_EVENTS			1024
+
+struct arv_module_stream_config {
+	/* In: stream tuple, in network byte order. A null source address or port matches any sender. */
+	__u32 source_address;
+	__u16 source_port;
+	__u16 destination_port;
+
+	/* In: GVSP packet size, as written to the SCPS register, including the IP and UDP headers */
+	__u32 packet_size;
+	/* In: TRUE if the device uses the 64 bit block and 32 bit packet ids of GigE Vision 2.0 */
+	__u32 extended_ids;
+	__u32 n_buffers;
+	__u32 buffer_size;
+
+	/* Out: mapping layout */
+	__u32 ring_size;
+	__u32 buffer_stride;
+	__u64 buffers_offset;
+	__u64 mmap_size;
+};
+
+enum arv_module_event_type {
+	ARV_MODULE_EVENT_TYPE_FRAME_COMPLETED = 1,
+	ARV_MODULE_EVENT_TYPE_PACKETS_MISSING = 2
+};
+
+enum arv_module_frame_status {
+	ARV_MODULE_FRAME_STATUS_SUCCESS = 0,
+	ARV_MODULE_FRAME_STATUS_MISSING_PACKETS = 1,
+	ARV_MODULE_FRAME_STATUS_SIZE_MISMATCH = 2,
+	ARV_MODULE_FRAME_STATUS_ABORTED = 3
+};
+
+struct arv_module_event {
+	__u32 type;
+	__u32 status;
+	__u64 frame_id;
+
+	/* ARV_MODULE_EVENT_TYPE_PACKETS_MISSING: range of missing packets, inclusive */
+	__u32 first_packet_id;
+	__u32 last_packet_id;
+
+	/* ARV_MODULE_EVENT_TYPE_FRAME_COMPLETED */
+	__u32 buffer_index;
+	__u32 received_size;
+	__u32 n_packets;
+	__u32 n_missing_packets;
+	__u64 timestamp;
+	__u64 system_timestamp_ns;
+
+	/* Leader informations */
+	__u32 payload_type;
+	__u32 pixel_format;
+	__u32 width;
+	__u32 height;
+	__u32 x_offset;
+	__u32 y_offset;
+};
+
+struct arv_module_ring {
+	/* Written by the kernel, read by user space */
+	__u32 head;
+	/* Written by user space after consuming events, read by the kernel */
+	__u32 tail;
+	__u32 n_events;
+	__u32 reserved;
+
+	/* Statistics, written by the kernel */
+	__u64 n_packets;
+	__u64 n_ignored_packets;
+	__u64 n_resent_packets;
+	__u64 n_underruns;
+	__u64 n_dropped_events;
+
+	struct arv_module_event events[ARV_MODULE_N_EVENTS];
+};
+
+#define ARV_MODULE_IOC_MAGIC			'a'
+
+#define ARV_MODULE_IOC_CREATE_STREAM		_IOWR (ARV_MODULE_IOC_MAGIC, 1, struct arv_module_stream_config)
+#define ARV_MODULE_IOC_QUEUE_BUFFER		_IOW (ARV_MODULE_IOC_MAGIC, 2, __u32)
+/* Completes all the frames being reassembled, typically on a user space timeout */
+#define ARV_MODULE_IOC_FLUSH_FRAMES		_IO (ARV_MODULE_IOC_MAGIC, 3)
+
+#endif
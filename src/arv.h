@@ -28,6 +28,7 @@
 #include <arvtypes.h>
 
 #include <arvbuffer.h>
+#include <arvbufferallocator.h>
 #include <arvcamera.h>
 #include <arvchunkparser.h>
 #include <arvdebug.h>
@@ -55,6 +56,9 @@
 
 #include <arvfeatures.h>
 
+#include <arvframerecorder.h>
+#include <arvstreamgroup.h>
+
 #include <arvgc.h>
 #include <arvgcboolean.h>
 #include <arvgccategory.h>
@@ -94,13 +98,19 @@
 
 #include <arvgvdevice.h>
 #include <arvgvfakecamera.h>
+#include <arvgvfakecamerafarm.h>
 #include <arvgvinterface.h>
+#include <arvgvspsender.h>
 #include <arvgvstream.h>
 
 #include <arvinterface.h>
+#include <arvmetricsexporter.h>
 #include <arvmisc.h>
 #include <arvrealtime.h>
+#include <arvregistersnapshot.h>
 #include <arvstream.h>
+#include <arvstreampublisher.h>
+#include <arvstreamsubscriber.h>
 #include <arvstr.h>
 #include <arvsystem.h>
 
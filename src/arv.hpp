@@ -0,0 +1,467 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2019 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel@gnome.org>
+ */
+
+/*
+ * Header only C++17 wrapper of the camera, stream and buffer API.
+ *
+ * The wrapper types are move-only owners of the underlying GObject references. Buffers popped from a stream are
+ * pushed back to it when they go out of scope, and frame data is accessed through spans over the buffer memory, so
+ * acquisition loops neither copy nor allocate. GError failures are thrown as arv::Error.
+ *
+ *	arv::Camera camera ("Fake_1");
+ *	arv::Stream stream = camera.create_stream ();
+ *
+ *	stream.allocate_buffers (10, camera.payload ());
+ *	camera.start_acquisition ();
+ *
+ *	for (arv::Buffer &buffer : stream.frames (std::chrono::seconds (1))) {
+ *		arv::ImageView<std::uint8_t> image = buffer.image<std::uint8_t> ();
+ *		...
+ *	}
+ */
+
+#ifndef ARV_HPP
+#define ARV_HPP
+
+#include <arv.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+#if defined (__has_include)
+#if __has_include (<version>)
+#include <version>
+#endif
+#endif
+
+#if defined (__cpp_lib_span)
+#include <span>
+#endif
+
+namespace arv {
+
+#if defined (__cpp_lib_span)
+
+template <typename T> using span = std::span<T>;
+
+#else
+
+/* Minimal std::span replacement for C++17 */
+
+template <typename T>
+class span {
+public:
+	constexpr span () noexcept = default;
+	constexpr span (T *data, std::size_t size) noexcept : m_data (data), m_size (size) {}
+
+	constexpr T *data () const noexcept { return m_data; }
+	constexpr std::size_t size () const noexcept { return m_size; }
+	constexpr std::size_t size_bytes () const noexcept { return m_size * sizeof (T); }
+	constexpr bool empty () const noexcept { return m_size == 0; }
+
+	constexpr T *begin () const noexcept { return m_data; }
+	constexpr T *end () const noexcept { return m_data + m_size; }
+
+	constexpr T &operator[] (std::size_t index) const noexcept { return m_data[index]; }
+
+private:
+	T *m_data = nullptr;
+	std::size_t m_size = 0;
+};
+
+#endif
+
+class Error : public std::runtime_error {
+public:
+	/* Takes ownership of error */
+	explicit Error (GError *error) :
+		std::runtime_error (error->message), m_domain (error->domain), m_code (error->code)
+	{
+		g_error_free (error);
+	}
+
+	GQuark domain () const noexcept { return m_domain; }
+	int code () const noexcept { return m_code; }
+
+private:
+	GQuark m_domain;
+	int m_code;
+};
+
+namespace detail {
+
+inline void
+check (GError *error)
+{
+	if (error != nullptr)
+		throw Error (error);
+}
+
+}
+
+/* Image rows of n_channels interleaved channels of type T, see arv_buffer_get_image_layout() */
+
+template <typename T>
+class ImageView {
+public:
+	ImageView () noexcept = default;
+	ImageView (const void *data, unsigned width, unsigned height, unsigned n_channels, std::size_t stride) noexcept :
+		m_data (static_cast<const std::byte *> (data)),
+		m_width (width), m_height (height), m_n_channels (n_channels), m_stride (stride) {}
+
+	explicit operator bool () const noexcept { return m_data != nullptr; }
+
+	unsigned width () const noexcept { return m_width; }
+	unsigned height () const noexcept { return m_height; }
+	unsigned n_channels () const noexcept { return m_n_channels; }
+	std::size_t stride () const noexcept { return m_stride; }
+
+	span<const T> row (unsigned y) const noexcept
+	{
+		return span<const T> (reinterpret_cast<const T *> (m_data + y * m_stride),
+				      std::size_t (m_width) * m_n_channels);
+	}
+
+	const T &at (unsigned x, unsigned y, unsigned channel = 0) const noexcept
+	{
+		return row (y)[std::size_t (x) * m_n_channels + channel];
+	}
+
+private:
+	const std::byte *m_data = nullptr;
+	unsigned m_width = 0;
+	unsigned m_height = 0;
+	unsigned m_n_channels = 0;
+	std::size_t m_stride = 0;
+};
+
+class Buffer {
+public:
+	Buffer () noexcept = default;
+
+	/* Takes ownership of buffer, which is pushed back to stream on destruction, if not null */
+	Buffer (ArvBuffer *buffer, ArvStream *stream) noexcept :
+		m_buffer (buffer), m_stream (stream != nullptr ? ARV_STREAM (g_object_ref (stream)) : nullptr) {}
+
+	Buffer (const Buffer &) = delete;
+	Buffer &operator= (const Buffer &) = delete;
+
+	Buffer (Buffer &&other) noexcept :
+		m_buffer (std::exchange (other.m_buffer, nullptr)), m_stream (std::exchange (other.m_stream, nullptr)) {}
+
+	Buffer &operator= (Buffer &&other) noexcept
+	{
+		if (this != &other) {
+			reset ();
+			m_buffer = std::exchange (other.m_buffer, nullptr);
+			m_stream = std::exchange (other.m_stream, nullptr);
+		}
+		return *this;
+	}
+
+	~Buffer () { reset (); }
+
+	static Buffer allocate (std::size_t size) { return Buffer (arv_buffer_new_allocate (size), nullptr); }
+
+	/* Returns the buffer to its stream, or releases it */
+	void reset () noexcept
+	{
+		if (m_buffer != nullptr) {
+			if (m_stream != nullptr)
+				arv_stream_push_buffer (m_stream, m_buffer);
+			else
+				g_object_unref (m_buffer);
+			m_buffer = nullptr;
+		}
+		if (m_stream != nullptr) {
+			g_object_unref (m_stream);
+			m_stream = nullptr;
+		}
+	}
+
+	/* Gives up the ownership of the buffer, which is not pushed back to its stream */
+	ArvBuffer *release () noexcept
+	{
+		if (m_stream != nullptr) {
+			g_object_unref (m_stream);
+			m_stream = nullptr;
+		}
+		return std::exchange (m_buffer, nullptr);
+	}
+
+	ArvBuffer *get () const noexcept { return m_buffer; }
+	explicit operator bool () const noexcept { return m_buffer != nullptr; }
+
+	ArvBufferStatus status () const noexcept { return arv_buffer_get_status (m_buffer); }
+	bool is_complete () const noexcept { return status () == ARV_BUFFER_STATUS_SUCCESS; }
+	ArvBufferPayloadType payload_type () const noexcept { return arv_buffer_get_payload_type (m_buffer); }
+	std::uint64_t frame_id () const noexcept { return arv_buffer_get_frame_id (m_buffer); }
+	std::uint64_t timestamp_ns () const noexcept { return arv_buffer_get_timestamp (m_buffer); }
+	std::uint64_t system_timestamp_ns () const noexcept { return arv_buffer_get_system_timestamp (m_buffer); }
+
+	span<const std::byte> data () const noexcept
+	{
+		size_t size;
+		const void *data = arv_buffer_get_data (m_buffer, &size);
+
+		return span<const std::byte> (static_cast<const std::byte *> (data), size);
+	}
+
+	int width () const noexcept { return arv_buffer_get_image_width (m_buffer); }
+	int height () const noexcept { return arv_buffer_get_image_height (m_buffer); }
+	ArvPixelFormat pixel_format () const noexcept { return arv_buffer_get_image_pixel_format (m_buffer); }
+
+	/* Empty view if the pixel format channels are not of type T */
+	template <typename T>
+	ImageView<T> image () const noexcept
+	{
+		guint n_channels;
+		guint bytes_per_channel;
+		size_t stride;
+
+		if (!arv_buffer_get_image_layout (m_buffer, &n_channels, &bytes_per_channel, &stride) ||
+		    bytes_per_channel != sizeof (T))
+			return ImageView<T> ();
+
+		return ImageView<T> (arv_buffer_get_data (m_buffer, nullptr), width (), height (), n_channels, stride);
+	}
+
+private:
+	ArvBuffer *m_buffer = nullptr;
+	ArvStream *m_stream = nullptr;
+};
+
+class Stream;
+
+/* Pops the stream buffers until a timeout, the previous buffer is pushed back on increment */
+
+class FrameIterator {
+public:
+	using iterator_category = std::input_iterator_tag;
+	using value_type = Buffer;
+	using difference_type = std::ptrdiff_t;
+	using pointer = Buffer *;
+	using reference = Buffer &;
+
+	FrameIterator () noexcept = default;
+	inline FrameIterator (Stream *stream, std::chrono::microseconds timeout) noexcept;
+
+	FrameIterator (const FrameIterator &) = delete;
+	FrameIterator &operator= (const FrameIterator &) = delete;
+	FrameIterator (FrameIterator &&) noexcept = default;
+	FrameIterator &operator= (FrameIterator &&) noexcept = default;
+
+	Buffer &operator* () noexcept { return m_buffer; }
+	Buffer *operator-> () noexcept { return &m_buffer; }
+
+	inline FrameIterator &operator++ () noexcept;
+
+	bool operator== (const FrameIterator &other) const noexcept { return is_end () == other.is_end (); }
+	bool operator!= (const FrameIterator &other) const noexcept { return !(*this == other); }
+
+private:
+	bool is_end () const noexcept { return m_stream == nullptr; }
+
+	Stream *m_stream = nullptr;
+	std::chrono::microseconds m_timeout {0};
+	Buffer m_buffer;
+};
+
+class FrameRange {
+public:
+	FrameRange (Stream *stream, std::chrono::microseconds timeout) noexcept : m_stream (stream), m_timeout (timeout) {}
+
+	FrameIterator begin () const noexcept { return FrameIterator (m_stream, m_timeout); }
+	FrameIterator end () const noexcept { return FrameIterator (); }
+
+private:
+	Stream *m_stream;
+	std::chrono::microseconds m_timeout;
+};
+
+class Stream {
+public:
+	Stream () noexcept = default;
+
+	/* Takes ownership of stream */
+	explicit Stream (ArvStream *stream) noexcept : m_stream (stream) {}
+
+	Stream (const Stream &) = delete;
+	Stream &operator= (const Stream &) = delete;
+
+	Stream (Stream &&other) noexcept : m_stream (std::exchange (other.m_stream, nullptr)) {}
+
+	Stream &operator= (Stream &&other) noexcept
+	{
+		if (this != &other) {
+			if (m_stream != nullptr)
+				g_object_unref (m_stream);
+			m_stream = std::exchange (other.m_stream, nullptr);
+		}
+		return *this;
+	}
+
+	~Stream ()
+	{
+		if (m_stream != nullptr)
+			g_object_unref (m_stream);
+	}
+
+	ArvStream *get () const noexcept { return m_stream; }
+	explicit operator bool () const noexcept { return m_stream != nullptr; }
+
+	void allocate_buffers (unsigned n_buffers, std::size_t size)
+	{
+		for (unsigned i = 0; i < n_buffers; i++)
+			arv_stream_push_buffer (m_stream, arv_buffer_new_allocate (size));
+	}
+
+	void push (Buffer &&buffer) noexcept
+	{
+		ArvBuffer *arv_buffer = buffer.release ();
+
+		if (arv_buffer != nullptr)
+			arv_stream_push_buffer (m_stream, arv_buffer);
+	}
+
+	/* Empty buffer on timeout */
+	Buffer pop (std::chrono::microseconds timeout) noexcept
+	{
+		ArvBuffer *buffer = arv_stream_timeout_pop_buffer (m_stream, timeout.count ());
+
+		return buffer != nullptr ? Buffer (buffer, m_stream) : Buffer ();
+	}
+
+	Buffer try_pop () noexcept
+	{
+		ArvBuffer *buffer = arv_stream_try_pop_buffer (m_stream);
+
+		return buffer != nullptr ? Buffer (buffer, m_stream) : Buffer ();
+	}
+
+	FrameRange frames (std::chrono::microseconds timeout) noexcept { return FrameRange (this, timeout); }
+
+private:
+	ArvStream *m_stream = nullptr;
+};
+
+inline
+FrameIterator::FrameIterator (Stream *stream, std::chrono::microseconds timeout) noexcept :
+	m_stream (stream), m_timeout (timeout)
+{
+	++*this;
+}
+
+inline FrameIterator &
+FrameIterator::operator++ () noexcept
+{
+	m_buffer.reset ();
+	m_buffer = m_stream->pop (m_timeout);
+	if (!m_buffer)
+		m_stream = nullptr;
+
+	return *this;
+}
+
+class Camera {
+public:
+	/* First available camera if name is null */
+	explicit Camera (const char *name = nullptr)
+	{
+		GError *error = nullptr;
+
+		m_camera = arv_camera_new (name, &error);
+		detail::check (error);
+	}
+
+	Camera (const Camera &) = delete;
+	Camera &operator= (const Camera &) = delete;
+
+	Camera (Camera &&other) noexcept : m_camera (std::exchange (other.m_camera, nullptr)) {}
+
+	Camera &operator= (Camera &&other) noexcept
+	{
+		if (this != &other) {
+			if (m_camera != nullptr)
+				g_object_unref (m_camera);
+			m_camera = std::exchange (other.m_camera, nullptr);
+		}
+		return *this;
+	}
+
+	~Camera ()
+	{
+		if (m_camera != nullptr)
+			g_object_unref (m_camera);
+	}
+
+	ArvCamera *get () const noexcept { return m_camera; }
+
+	Stream create_stream ()
+	{
+		GError *error = nullptr;
+		ArvStream *stream = arv_camera_create_stream (m_camera, nullptr, nullptr, &error);
+
+		detail::check (error);
+
+		return Stream (stream);
+	}
+
+	std::size_t payload () const
+	{
+		GError *error = nullptr;
+		guint payload = arv_camera_get_payload (m_camera, &error);
+
+		detail::check (error);
+
+		return payload;
+	}
+
+	void set_pixel_format (ArvPixelFormat pixel_format) { call (arv_camera_set_pixel_format, pixel_format); }
+	void set_frame_rate (double frame_rate) { call (arv_camera_set_frame_rate, frame_rate); }
+	void set_exposure_time (double exposure_time_us) { call (arv_camera_set_exposure_time, exposure_time_us); }
+	void set_region (int x, int y, int width, int height) { call (arv_camera_set_region, x, y, width, height); }
+	void set_acquisition_mode (ArvAcquisitionMode mode) { call (arv_camera_set_acquisition_mode, mode); }
+
+	void start_acquisition () { call (arv_camera_start_acquisition); }
+	void stop_acquisition () { call (arv_camera_stop_acquisition); }
+
+private:
+	template <typename Func, typename... Args>
+	void call (Func func, Args... args)
+	{
+		GError *error = nullptr;
+
+		func (m_camera, args..., &error);
+		detail::check (error);
+	}
+
+	ArvCamera *m_camera = nullptr;
+};
+
+}
+
+#endif
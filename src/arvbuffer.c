@@ -32,7 +32,27 @@
  * format and time stamp.
  */
 
+#define _GNU_SOURCE
+
 #include <arvbufferprivate.h>
+#include <arvbufferallocatorprivate.h>
+#include <arvrealtimeprivate.h>
+#include <arvchecksumprivate.h>
+#include <arvdebugprivate.h>
+
+#ifndef G_OS_WIN32
+#include <sys/mman.h>
+#include <unistd.h>
+#include <fcntl.h>
+#endif
+
+#define ARV_BUFFER_HUGE_PAGE_SIZE	(2 << 20)
+
+GQuark
+arv_buffer_error_quark (void)
+{
+	return g_quark_from_static_string ("arv-buffer-error-quark");
+}
 
 gboolean
 arv_buffer_payload_type_has_chunks (ArvBufferPayloadType payload_type)
@@ -51,6 +71,16 @@ arv_buffer_payload_type_has_aoi (ArvBufferPayloadType payload_type)
 		payload_type == ARV_BUFFER_PAYLOAD_TYPE_IMAGE_EXTENDED_CHUNK);
 }
 
+/* Compressed payloads, whose size changes from frame to frame and is only bounded by the buffer size */
+
+gboolean
+arv_buffer_payload_type_is_variable_size (ArvBufferPayloadType payload_type)
+{
+	return (payload_type == ARV_BUFFER_PAYLOAD_TYPE_JPEG ||
+		payload_type == ARV_BUFFER_PAYLOAD_TYPE_JPEG2000 ||
+		payload_type == ARV_BUFFER_PAYLOAD_TYPE_H264);
+}
+
 /**
  * arv_buffer_new_full:
  * @size: payload size
@@ -78,6 +108,8 @@ arv_buffer_new_full (size_t size, void *preallocated, void *user_data, GDestroyN
 
 	buffer = g_object_new (ARV_TYPE_BUFFER, NULL);
 	buffer->priv->size = size;
+	buffer->priv->received_size = size;
+	buffer->priv->capacity = size;
 	buffer->priv->user_data = user_data;
 	buffer->priv->user_data_destroy_func = user_data_destroy_func;
 	buffer->priv->chunk_endianness = G_BIG_ENDIAN;
@@ -115,6 +147,39 @@ arv_buffer_new (size_t size, void *preallocated)
 	return arv_buffer_new_full (size, preallocated, NULL, NULL);
 }
 
+/**
+ * arv_buffer_new_image:
+ * @pixel_format: image pixel format
+ * @width: image width
+ * @height: image height
+ * @size: payload size
+ * @preallocated: (transfer none) (nullable): preallocated memory buffer
+ *
+ * Creates a new buffer holding a complete image, for example for wrapping image data coming from another source
+ * before calling arv_buffer_convert() on it. Data space is handled as in arv_buffer_new().
+ *
+ * Returns: a new #ArvBuffer object
+ *
+ * Since: 0.8.11
+ */
+
+ArvBuffer *
+arv_buffer_new_image (ArvPixelFormat pixel_format, gint width, gint height, size_t size, void *preallocated)
+{
+	ArvBuffer *buffer;
+
+	g_return_val_if_fail (width >= 0 && height >= 0, NULL);
+
+	buffer = arv_buffer_new_full (size, preallocated, NULL, NULL);
+	buffer->priv->payload_type = ARV_BUFFER_PAYLOAD_TYPE_IMAGE;
+	buffer->priv->status = ARV_BUFFER_STATUS_SUCCESS;
+	buffer->priv->pixel_format = pixel_format;
+	buffer->priv->width = width;
+	buffer->priv->height = height;
+
+	return buffer;
+}
+
 /**
  * arv_buffer_new_allocate:
  * @size: payload size
@@ -134,6 +199,220 @@ arv_buffer_new_allocate (size_t size)
 	return arv_buffer_new_full (size, NULL, NULL, NULL);
 }
 
+/**
+ * arv_buffer_new_allocate_numa:
+ * @size: payload size
+ * @numa_node: NUMA node for the data memory, or -1
+ *
+ * Creates a new buffer for the storage of the video stream images, like
+ * arv_buffer_new_allocate(), the data memory being preferably allocated on
+ * the given NUMA node. This node should be the one of the network interface
+ * or USB controller, and of the stream thread (see #ArvStream:numa-node).
+ *
+ * Returns: a new #ArvBuffer object
+ *
+ * Since: 0.8.11
+ */
+
+ArvBuffer *
+arv_buffer_new_allocate_numa (size_t size, int numa_node)
+{
+#ifndef G_OS_WIN32
+	ArvBuffer *buffer;
+	void *data;
+
+	if (numa_node < 0 || size == 0)
+		return arv_buffer_new_allocate (size);
+
+	data = mmap (NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (data == MAP_FAILED) {
+		arv_warning_misc ("[Buffer::new_allocate_numa] Failed to map %" G_GSIZE_FORMAT " bytes", size);
+		return arv_buffer_new_allocate (size);
+	}
+
+	/* Pages are not populated yet, they will be allocated on the node on first access */
+	arv_numa_bind_memory (data, size, numa_node);
+
+	buffer = arv_buffer_new_full (size, data, NULL, NULL);
+	buffer->priv->is_preallocated = FALSE;
+	buffer->priv->is_mapped = TRUE;
+	buffer->priv->mapped_data = data;
+	buffer->priv->mapped_size = size;
+
+	return buffer;
+#else
+	return arv_buffer_new_allocate (size);
+#endif
+}
+
+/**
+ * arv_buffer_new_allocate_full:
+ * @size: payload size
+ * @flags: allocation flags
+ * @alignment: alignment of the data start, in bytes, a power of two, or 0 for the default
+ *
+ * Creates a new buffer for the storage of the video stream images, like arv_buffer_new_allocate(), with more
+ * control on the data memory. The data is at least page aligned if any flag or an alignment is given. Huge pages
+ * reduce the TLB misses when accessing large images, and locked memory can be registered for DMA (for example
+ * with CUDA or RDMA) without an additional copy.
+ *
+ * If huge pages can't be used, the allocation falls back to normal pages. If the memory can't be locked, because
+ * of the RLIMIT_MEMLOCK limit for example, a warning is emitted and the buffer is returned anyway. Flags are ignored
+ * on Windows.
+ *
+ * A shareable buffer data starts at the beginning of a memory file whose size can't shrink, as required for its
+ * import as a dma-buf with udmabuf. Huge pages and alignments larger than the page size are not used for these
+ * buffers, and the allocation falls back to anonymous memory if memory files are not available.
+ *
+ * Returns: a new #ArvBuffer object
+ *
+ * Since: 0.8.11
+ */
+
+ArvBuffer *
+arv_buffer_new_allocate_full (size_t size, ArvBufferAllocationFlags flags, size_t alignment)
+{
+#ifndef G_OS_WIN32
+	ArvBuffer *buffer;
+	unsigned char *mapped_data = MAP_FAILED;
+	unsigned char *data;
+	size_t mapped_size = 0;
+	size_t page_size;
+
+	g_return_val_if_fail ((alignment & (alignment - 1)) == 0, NULL);
+
+	if ((flags == ARV_BUFFER_ALLOCATION_FLAGS_NONE && alignment == 0) || size == 0)
+		return arv_buffer_new_allocate (size);
+
+	page_size = sysconf (_SC_PAGESIZE);
+
+#ifdef MFD_ALLOW_SEALING
+	if ((flags & ARV_BUFFER_ALLOCATION_FLAGS_SHAREABLE) != 0) {
+		int fd;
+
+		mapped_size = (size + page_size - 1) & ~(page_size - 1);
+
+		fd = memfd_create ("arv-buffer", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+		if (fd >= 0 &&
+		    ftruncate (fd, mapped_size) == 0 &&
+		    fcntl (fd, F_ADD_SEALS, F_SEAL_SHRINK) == 0)
+			mapped_data = mmap (NULL, mapped_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+		if (mapped_data != MAP_FAILED) {
+			if ((flags & ARV_BUFFER_ALLOCATION_FLAGS_LOCKED) != 0 &&
+			    mlock (mapped_data, size) != 0)
+				arv_warning_misc ("[Buffer::new_allocate_full] Failed to lock %" G_GSIZE_FORMAT
+						  " bytes in memory", size);
+
+			buffer = arv_buffer_new_full (size, mapped_data, NULL, NULL);
+			buffer->priv->capacity = mapped_size;
+			buffer->priv->is_preallocated = FALSE;
+			buffer->priv->is_mapped = TRUE;
+			buffer->priv->mapped_data = mapped_data;
+			buffer->priv->mapped_size = mapped_size;
+			buffer->priv->fd = fd;
+
+			return buffer;
+		}
+
+		arv_info_misc ("[Buffer::new_allocate_full] Memory file allocation failed, "
+			       "fall back to anonymous memory");
+		if (fd >= 0)
+			close (fd);
+	}
+#endif
+
+#ifdef MAP_HUGETLB
+	if ((flags & ARV_BUFFER_ALLOCATION_FLAGS_HUGE_PAGES) != 0) {
+		size_t huge_alignment = MAX (alignment, ARV_BUFFER_HUGE_PAGE_SIZE);
+
+		mapped_size = ((size + ARV_BUFFER_HUGE_PAGE_SIZE - 1) & ~((size_t) ARV_BUFFER_HUGE_PAGE_SIZE - 1)) +
+			huge_alignment - ARV_BUFFER_HUGE_PAGE_SIZE;
+		mapped_data = mmap (NULL, mapped_size, PROT_READ | PROT_WRITE,
+				    MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+		if (mapped_data != MAP_FAILED)
+			alignment = huge_alignment;
+		else
+			arv_info_misc ("[Buffer::new_allocate_full] No hugetlb page available, "
+				       "fall back to transparent huge pages");
+	}
+#endif
+
+	if (mapped_data == MAP_FAILED) {
+		if ((flags & ARV_BUFFER_ALLOCATION_FLAGS_HUGE_PAGES) != 0)
+			alignment = MAX (alignment, ARV_BUFFER_HUGE_PAGE_SIZE);
+		alignment = MAX (alignment, page_size);
+
+		mapped_size = ((size + page_size - 1) & ~(page_size - 1)) + alignment - page_size;
+		mapped_data = mmap (NULL, mapped_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (mapped_data == MAP_FAILED) {
+			arv_warning_misc ("[Buffer::new_allocate_full] Failed to map %" G_GSIZE_FORMAT " bytes",
+					  mapped_size);
+			return arv_buffer_new_allocate (size);
+		}
+	}
+
+	data = (unsigned char *) (((guintptr) mapped_data + alignment - 1) & ~((guintptr) alignment - 1));
+
+#ifdef MADV_HUGEPAGE
+	if ((flags & ARV_BUFFER_ALLOCATION_FLAGS_HUGE_PAGES) != 0)
+		madvise (data, size, MADV_HUGEPAGE);
+#endif
+
+	if ((flags & ARV_BUFFER_ALLOCATION_FLAGS_LOCKED) != 0 &&
+	    mlock (data, size) != 0)
+		arv_warning_misc ("[Buffer::new_allocate_full] Failed to lock %" G_GSIZE_FORMAT " bytes in memory",
+				  size);
+
+	buffer = arv_buffer_new_full (size, data, NULL, NULL);
+	/* Mapping padding after the data, only the requested size is locked or advised */
+	buffer->priv->capacity = mapped_size - (data - mapped_data);
+	buffer->priv->is_preallocated = FALSE;
+	buffer->priv->is_mapped = TRUE;
+	buffer->priv->mapped_data = mapped_data;
+	buffer->priv->mapped_size = mapped_size;
+
+	return buffer;
+#else
+	return arv_buffer_new_allocate (size);
+#endif
+}
+
+/**
+ * arv_buffer_new_from_allocator:
+ * @allocator: a #ArvBufferAllocator
+ * @size: payload size
+ *
+ * Creates a new buffer for the storage of the video stream images, whose data is allocated by @allocator, and
+ * released by it when the buffer is destroyed. The buffer keeps a reference on @allocator.
+ *
+ * Returns: (transfer full) (nullable): a new #ArvBuffer object, or %NULL if the allocation failed
+ *
+ * Since: 0.8.11
+ */
+
+ArvBuffer *
+arv_buffer_new_from_allocator (ArvBufferAllocator *allocator, size_t size)
+{
+	ArvBuffer *buffer;
+	void *device_data;
+	void *data;
+
+	g_return_val_if_fail (ARV_IS_BUFFER_ALLOCATOR (allocator), NULL);
+
+	data = arv_buffer_allocator_alloc (allocator, MAX (size, 1), &device_data);
+	if (data == NULL)
+		return NULL;
+
+	buffer = arv_buffer_new_full (size, data, NULL, NULL);
+	buffer->priv->capacity = MAX (size, 1);
+	buffer->priv->is_preallocated = FALSE;
+	buffer->priv->allocator = g_object_ref (allocator);
+	buffer->priv->device_data = device_data;
+
+	return buffer;
+}
+
 /**
  * arv_buffer_get_data:
  * @buffer: a #ArvBuffer
@@ -143,102 +422,641 @@ arv_buffer_new_allocate (size_t size)
  *
  * Returns: (array length=size) (element-type guint8): a pointer to the buffer data.
  *
- * Since: 0.4.0
- **/
+ * Since: 0.4.0
+ **/
+
+const void *
+arv_buffer_get_data (ArvBuffer *buffer, size_t *size)
+{
+	g_return_val_if_fail (ARV_IS_BUFFER (buffer), NULL);
+
+	if (size != NULL)
+		*size = buffer->priv->size;
+
+	return buffer->priv->data;
+}
+
+static void
+_data_bytes_free (gpointer data)
+{
+	g_object_unref (data);
+}
+
+/**
+ * arv_buffer_get_data_bytes:
+ * @buffer: a #ArvBuffer
+ *
+ * Wraps the buffer data in a #GBytes, without copy. The #GBytes holds a reference on @buffer, which keeps the data
+ * valid as long as it is alive. It is meant for bindings and other #GBytes consumers, for accessing full frames
+ * without the copy implied by arv_buffer_get_data() array marshalling. The data must not be used after @buffer is
+ * pushed back to a stream.
+ *
+ * Returns: (transfer full): a new #GBytes referencing the buffer data.
+ *
+ * Since: 0.8.11
+ */
+
+GBytes *
+arv_buffer_get_data_bytes (ArvBuffer *buffer)
+{
+	g_return_val_if_fail (ARV_IS_BUFFER (buffer), NULL);
+
+	return g_bytes_new_with_free_func (buffer->priv->data, buffer->priv->size,
+					   _data_bytes_free, g_object_ref (buffer));
+}
+
+/**
+ * arv_buffer_get_received_size:
+ * @buffer: a #ArvBuffer
+ *
+ * Gets the size of the data actually received in the buffer. The compressed payloads, JPEG, JPEG 2000 or H.264, have
+ * a size changing from frame to frame, which is only bounded by the buffer size returned by arv_buffer_get_data().
+ * The buffers of such streams may be allocated smaller than the worst case payload size, the frames which don't fit
+ * are delivered with a %ARV_BUFFER_STATUS_SIZE_MISMATCH status. For the other payloads, the received size is the
+ * buffer size.
+ *
+ * Returns: the received data size, in bytes.
+ *
+ * Since: 0.8.11
+ */
+
+size_t
+arv_buffer_get_received_size (ArvBuffer *buffer)
+{
+	g_return_val_if_fail (ARV_IS_BUFFER (buffer), 0);
+
+	return MIN (buffer->priv->received_size, buffer->priv->size);
+}
+
+/**
+ * arv_buffer_get_capacity:
+ * @buffer: a #ArvBuffer
+ *
+ * Gets the size of the memory available for the buffer data, which may be larger than the payload size returned by
+ * arv_buffer_get_data(), for example after a size reduction by arv_buffer_set_size() or because of the page
+ * rounding of mapped allocations.
+ *
+ * Returns: the buffer data capacity, in bytes.
+ *
+ * Since: 0.8.11
+ */
+
+size_t
+arv_buffer_get_capacity (ArvBuffer *buffer)
+{
+	g_return_val_if_fail (ARV_IS_BUFFER (buffer), 0);
+
+	return buffer->priv->capacity;
+}
+
+/**
+ * arv_buffer_set_size:
+ * @buffer: a #ArvBuffer
+ * @size: new payload size
+ *
+ * Changes the payload size of @buffer, for its reuse after a region or pixel format change instead of its
+ * replacement by a new buffer. The data memory is kept if @size fits in the buffer capacity. Otherwise it is
+ * reallocated if it was allocated by the buffer from the heap, without preserving its content, and the capacity grows
+ * to @size. The memory of preallocated and mapped buffers can't change, @size must fit in their capacity.
+ *
+ * This function must not be called while the buffer is queued in a stream, or while its data is referenced, by a
+ * #GBytes returned by arv_buffer_get_data_bytes() for example.
+ *
+ * Returns: %TRUE on success, %FALSE if @size exceeds the capacity of a buffer whose memory can't be reallocated.
+ *
+ * Since: 0.8.11
+ */
+
+gboolean
+arv_buffer_set_size (ArvBuffer *buffer, size_t size)
+{
+	g_return_val_if_fail (ARV_IS_BUFFER (buffer), FALSE);
+
+	if (size > buffer->priv->capacity) {
+		if (buffer->priv->is_preallocated || buffer->priv->is_mapped)
+			return FALSE;
+
+		if (buffer->priv->allocator != NULL) {
+			void *data;
+
+			data = arv_buffer_allocator_alloc (buffer->priv->allocator, size, &buffer->priv->device_data);
+			if (data == NULL)
+				return FALSE;
+
+			arv_buffer_allocator_free (buffer->priv->allocator, buffer->priv->data, buffer->priv->capacity);
+			buffer->priv->data = data;
+		} else {
+			g_free (buffer->priv->data);
+			buffer->priv->data = g_malloc (size);
+		}
+		buffer->priv->capacity = size;
+	}
+
+	buffer->priv->size = size;
+	buffer->priv->received_size = size;
+	buffer->priv->has_chunk_index = FALSE;
+	buffer->priv->status = ARV_BUFFER_STATUS_CLEARED;
+
+	return TRUE;
+}
+
+/**
+ * arv_buffer_get_fd:
+ * @buffer: a #ArvBuffer
+ *
+ * Gets the descriptor of the memory file holding the data of a buffer allocated with the
+ * %ARV_BUFFER_ALLOCATION_FLAGS_SHAREABLE flag. The data starts at offset 0. The descriptor is owned by the buffer
+ * and is closed on its destruction.
+ *
+ * Returns: a file descriptor, or -1 if the buffer data is not shareable.
+ *
+ * Since: 0.8.11
+ **/
+
+int
+arv_buffer_get_fd (ArvBuffer *buffer)
+{
+	g_return_val_if_fail (ARV_IS_BUFFER (buffer), -1);
+
+	return buffer->priv->fd;
+}
+
+/**
+ * arv_buffer_get_device_data:
+ * @buffer: a #ArvBuffer
+ *
+ * Gets the address of the data of a buffer created with arv_buffer_new_from_allocator(), for the device its memory
+ * is registered to, for example the CUDA device pointer of mapped host memory.
+ *
+ * Returns: (transfer none) (nullable): the device address of the data, or %NULL if it is not accessible by a
+ * device.
+ *
+ * Since: 0.8.11
+ **/
+
+void *
+arv_buffer_get_device_data (ArvBuffer *buffer)
+{
+	g_return_val_if_fail (ARV_IS_BUFFER (buffer), NULL);
+
+	return buffer->priv->device_data;
+}
+
+typedef struct ARAVIS_PACKED_STRUCTURE {
+	guint32 id;
+	guint32 size;
+} ArvChunkInfos;
+
+/**
+ * arv_buffer_has_chunks:
+ * @buffer: a #ArvBuffer
+ *
+ * Returns: %TRUE if @buffer has a payload type that contains chunk data.
+ *
+ * Since: 0.8.0
+ */
+
+gboolean
+arv_buffer_has_chunks (ArvBuffer *buffer)
+{
+	return ARV_IS_BUFFER (buffer) &&
+		buffer->priv->status == ARV_BUFFER_STATUS_SUCCESS &&
+		arv_buffer_payload_type_has_chunks (buffer->priv->payload_type);
+}
+
+/* Also called by the stream threads at buffer completion, while the chunk trailer is still in the cache */
+
+void
+arv_buffer_build_chunk_index (ArvBuffer *buffer)
+{
+	ArvChunkInfos *infos;
+	unsigned char *data;
+	ptrdiff_t offset;
+
+	buffer->priv->n_chunks = 0;
+
+	data = buffer->priv->data;
+	offset = buffer->priv->size - sizeof (ArvChunkInfos);
+	while (offset > 0) {
+		ArvBufferChunk *chunk;
+
+		if (buffer->priv->n_chunks >= buffer->priv->n_allocated_chunks) {
+			buffer->priv->n_allocated_chunks = MAX (8, 2 * buffer->priv->n_allocated_chunks);
+			buffer->priv->chunks = g_renew (ArvBufferChunk, buffer->priv->chunks,
+							buffer->priv->n_allocated_chunks);
+		}
+
+		infos = (ArvChunkInfos *) &data[offset];
+		chunk = &buffer->priv->chunks[buffer->priv->n_chunks++];
+
+		if (buffer->priv->chunk_endianness == G_BIG_ENDIAN) {
+			chunk->id = GUINT32_FROM_BE (infos->id);
+			chunk->size = GUINT32_FROM_BE (infos->size);
+		} else {
+			chunk->id = GUINT32_FROM_LE (infos->id);
+			chunk->size = GUINT32_FROM_LE (infos->size);
+		}
+
+		chunk->data_offset = offset - chunk->size;
+
+		if (chunk->size > 0)
+			offset = offset - chunk->size - sizeof (ArvChunkInfos);
+		else
+			offset = 0;
+	};
+
+	buffer->priv->has_chunk_index = TRUE;
+}
+
+/**
+ * arv_buffer_get_chunk_data:
+ * @buffer: a #ArvBuffer
+ * @chunk_id: chunk id
+ * @size: (allow-none): location to store chunk data size, or %NULL
+ *
+ * Chunk data accessor.
+ *
+ * Returns: (array length=size) (element-type guint8): a pointer to the chunk data.
+ *
+ * Since: 0.4.0
+ **/
+
+const void *
+arv_buffer_get_chunk_data (ArvBuffer *buffer, guint64 chunk_id, size_t *size)
+{
+	guint i;
+
+	if (size != NULL)
+		*size = 0;
+
+	g_return_val_if_fail (arv_buffer_has_chunks (buffer), NULL);
+	g_return_val_if_fail (buffer->priv->data != NULL, NULL);
+
+	if (!buffer->priv->has_chunk_index)
+		arv_buffer_build_chunk_index (buffer);
+
+	for (i = 0; i < buffer->priv->n_chunks; i++) {
+		ArvBufferChunk *chunk = &buffer->priv->chunks[i];
+
+		if (chunk->id == chunk_id) {
+			if (chunk->data_offset >= 0) {
+				if (size != NULL)
+					*size = chunk->size;
+				return &buffer->priv->data[chunk->data_offset];
+			} else
+				return NULL;
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * arv_buffer_get_n_chunks:
+ * @buffer: a #ArvBuffer
+ *
+ * Returns: the number of chunks in @buffer, 0 if its payload type doesn't contain chunk data.
+ *
+ * Since: 0.8.11
+ */
+
+guint
+arv_buffer_get_n_chunks (ArvBuffer *buffer)
+{
+	g_return_val_if_fail (ARV_IS_BUFFER (buffer), 0);
+
+	if (!arv_buffer_has_chunks (buffer) || buffer->priv->data == NULL)
+		return 0;
+
+	if (!buffer->priv->has_chunk_index)
+		arv_buffer_build_chunk_index (buffer);
+
+	return buffer->priv->n_chunks;
+}
+
+/**
+ * arv_buffer_get_nth_chunk_data:
+ * @buffer: a #ArvBuffer
+ * @index: chunk index, between 0 and arv_buffer_get_n_chunks() - 1
+ * @chunk_id: (out) (optional): chunk id
+ * @size: (out) (optional): chunk data size
+ *
+ * Gets the data of a chunk by its position in the buffer, for iterating over the chunks without knowing their ids
+ * in advance.
+ *
+ * Returns: (transfer none): a pointer to the chunk data, or %NULL if it doesn't fit in the buffer.
+ *
+ * Since: 0.8.11
+ */
+
+const void *
+arv_buffer_get_nth_chunk_data (ArvBuffer *buffer, guint index, guint64 *chunk_id, size_t *size)
+{
+	ArvBufferChunk *chunk;
+
+	if (chunk_id != NULL)
+		*chunk_id = 0;
+	if (size != NULL)
+		*size = 0;
+
+	g_return_val_if_fail (index < arv_buffer_get_n_chunks (buffer), NULL);
+
+	chunk = &buffer->priv->chunks[index];
+
+	if (chunk_id != NULL)
+		*chunk_id = chunk->id;
+
+	if (chunk->data_offset < 0)
+		return NULL;
+
+	if (size != NULL)
+		*size = chunk->size;
+
+	return &buffer->priv->data[chunk->data_offset];
+}
+
+/**
+ * arv_buffer_get_chunk_values:
+ * @buffer: a #ArvBuffer
+ * @n_values: (out) (optional): number of chunk values
+ *
+ * Gets the chunk values decoded by the stream thread when @buffer was completed, if a chunk plan was set using
+ * arv_stream_set_chunk_plan(). They are in the order of the chunk features of the plan, and are only available for
+ * successfully received buffers.
+ *
+ * Returns: (transfer none) (array length=n_values) (nullable): the chunk values, %NULL if none were decoded.
+ *
+ * Since: 0.8.11
+ */
+
+const ArvChunkValue *
+arv_buffer_get_chunk_values (ArvBuffer *buffer, guint *n_values)
+{
+	if (n_values != NULL)
+		*n_values = 0;
+
+	g_return_val_if_fail (ARV_IS_BUFFER (buffer), NULL);
+
+	if (buffer->priv->n_chunk_values == 0)
+		return NULL;
+
+	if (n_values != NULL)
+		*n_values = buffer->priv->n_chunk_values;
+
+	return buffer->priv->chunk_values;
+}
+
+/* Returns the chunk value array, with storage for n_values, reallocated only if it grows */
+
+ArvChunkValue *
+arv_buffer_set_n_chunk_values (ArvBuffer *buffer, guint n_values)
+{
+	if (buffer->priv->n_allocated_chunk_values < n_values) {
+		g_free (buffer->priv->chunk_values);
+		buffer->priv->chunk_values = g_new0 (ArvChunkValue, n_values);
+		buffer->priv->n_allocated_chunk_values = n_values;
+	}
+
+	buffer->priv->n_chunk_values = n_values;
+
+	return buffer->priv->chunk_values;
+}
+
+/* Above this count, the last range grows up to the end of the new missing data */
+#define ARV_BUFFER_N_MISSING_RANGES_MAX		64
+
+/**
+ * arv_buffer_get_missing_ranges:
+ * @buffer: a #ArvBuffer
+ * @n_ranges: (out) (optional): number of missing ranges
+ *
+ * Gets the parts of the data of an incomplete frame whose packets were never received, in increasing offset order,
+ * for the applications able to use a slightly degraded image instead of dropping it. All the other bytes of the
+ * payload were received. The ranges are available for the buffers of the #ARV_BUFFER_STATUS_MISSING_PACKETS and
+ * #ARV_BUFFER_STATUS_TIMEOUT status filled by a GigEVision stream, except for the multipart, the unpacked and the
+ * cropped payloads. Frames with too many holes get a conservative last range, which may include received data.
+ *
+ * Returns: (transfer none) (array length=n_ranges) (nullable): the missing ranges, %NULL if the buffer is complete or
+ * if the missing data is unknown.
+ *
+ * Since: 0.8.11
+ */
+
+const ArvBufferMissingRange *
+arv_buffer_get_missing_ranges (ArvBuffer *buffer, guint *n_ranges)
+{
+	if (n_ranges != NULL)
+		*n_ranges = 0;
+
+	g_return_val_if_fail (ARV_IS_BUFFER (buffer), NULL);
+
+	if (buffer->priv->status == ARV_BUFFER_STATUS_SUCCESS ||
+	    buffer->priv->n_missing_ranges == 0)
+		return NULL;
+
+	if (n_ranges != NULL)
+		*n_ranges = buffer->priv->n_missing_ranges;
+
+	return buffer->priv->missing_ranges;
+}
+
+void
+arv_buffer_clear_missing_ranges (ArvBuffer *buffer)
+{
+	buffer->priv->n_missing_ranges = 0;
+}
+
+static void
+_set_missing_rows (ArvBuffer *buffer, ArvBufferMissingRange *range)
+{
+	size_t row_size = 0;
+	size_t last_row;
+
+	range->first_row = 0;
+	range->n_rows = 0;
+
+	if (arv_buffer_payload_type_has_aoi (buffer->priv->payload_type) && buffer->priv->height > 0)
+		row_size = (size_t) buffer->priv->width * ARV_PIXEL_FORMAT_BIT_PER_PIXEL (buffer->priv->pixel_format) / 8;
+	if (row_size == 0 || range->size == 0)
+		return;
+
+	range->first_row = MIN (range->offset / row_size, (size_t) buffer->priv->height);
+	last_row = MIN ((range->offset + range->size - 1) / row_size + 1, (size_t) buffer->priv->height);
+	range->n_rows = last_row - range->first_row;
+}
+
+/* Ranges are appended in increasing offset order, the adjacent ones being merged */
+
+void
+arv_buffer_append_missing_range (ArvBuffer *buffer, size_t offset, size_t size)
+{
+	ArvBufferMissingRange *range;
+
+	if (size == 0)
+		return;
+
+	if (buffer->priv->missing_ranges == NULL)
+		buffer->priv->missing_ranges = g_new0 (ArvBufferMissingRange, ARV_BUFFER_N_MISSING_RANGES_MAX);
+
+	range = buffer->priv->n_missing_ranges > 0 ?
+		&buffer->priv->missing_ranges[buffer->priv->n_missing_ranges - 1] : NULL;
+
+	if (range != NULL &&
+	    (range->offset + range->size >= offset ||
+	     buffer->priv->n_missing_ranges == ARV_BUFFER_N_MISSING_RANGES_MAX)) {
+		range->size = MAX (range->offset + range->size, offset + size) - range->offset;
+	} else {
+		range = &buffer->priv->missing_ranges[buffer->priv->n_missing_ranges++];
+		range->offset = offset;
+		range->size = size;
+	}
+
+	_set_missing_rows (buffer, range);
+}
+
+void
+arv_buffer_set_n_parts (ArvBuffer *buffer, guint n_parts)
+{
+	if (buffer->priv->n_allocated_parts < n_parts) {
+		g_free (buffer->priv->parts);
+		buffer->priv->parts = g_new0 (ArvBufferPart, n_parts);
+		buffer->priv->n_allocated_parts = n_parts;
+	}
+
+	buffer->priv->n_parts = n_parts;
+}
+
+static gboolean
+_is_multipart (ArvBuffer *buffer)
+{
+	return buffer->priv->payload_type == ARV_BUFFER_PAYLOAD_TYPE_MULTIPART;
+}
+
+/**
+ * arv_buffer_get_n_parts:
+ * @buffer: a #ArvBuffer
+ *
+ * Gets the number of parts of a multipart payload. The part data are stored contiguously in the buffer data, in
+ * the order of their description in the payload leader. Image payloads are seen as a single part.
+ *
+ * Returns: the number of parts in @buffer, 0 if its payload is neither a multipart nor an image payload.
+ *
+ * Since: 0.8.11
+ */
+
+guint
+arv_buffer_get_n_parts (ArvBuffer *buffer)
+{
+	g_return_val_if_fail (ARV_IS_BUFFER (buffer), 0);
+
+	if (_is_multipart (buffer))
+		return buffer->priv->n_parts;
+
+	return arv_buffer_payload_type_has_aoi (buffer->priv->payload_type) ? 1 : 0;
+}
+
+/**
+ * arv_buffer_get_part_data:
+ * @buffer: a #ArvBuffer
+ * @part_id: part index, between 0 and arv_buffer_get_n_parts() - 1
+ * @size: (out) (optional): part data size
+ *
+ * Returns: (transfer none): a pointer to the part data.
+ *
+ * Since: 0.8.11
+ */
 
 const void *
-arv_buffer_get_data (ArvBuffer *buffer, size_t *size)
+arv_buffer_get_part_data (ArvBuffer *buffer, guint part_id, size_t *size)
 {
-	g_return_val_if_fail (ARV_IS_BUFFER (buffer), NULL);
+	if (size != NULL)
+		*size = 0;
+
+	g_return_val_if_fail (part_id < arv_buffer_get_n_parts (buffer), NULL);
+
+	if (!_is_multipart (buffer))
+		return arv_buffer_get_data (buffer, size);
 
 	if (size != NULL)
-		*size = buffer->priv->size;
+		*size = buffer->priv->parts[part_id].size;
 
-	return buffer->priv->data;
+	return buffer->priv->data + buffer->priv->parts[part_id].data_offset;
 }
 
-typedef struct ARAVIS_PACKED_STRUCTURE {
-	guint32 id;
-	guint32 size;
-} ArvChunkInfos;
-
 /**
- * arv_buffer_has_chunks:
+ * arv_buffer_get_part_data_type:
  * @buffer: a #ArvBuffer
+ * @part_id: part index, between 0 and arv_buffer_get_n_parts() - 1
  *
- * Returns: %TRUE if @buffer has a payload type that contains chunk data.
+ * Returns: the type of the part data.
  *
- * Since: 0.8.0
+ * Since: 0.8.11
  */
 
-gboolean
-arv_buffer_has_chunks (ArvBuffer *buffer)
+ArvBufferPartDataType
+arv_buffer_get_part_data_type (ArvBuffer *buffer, guint part_id)
 {
-	return ARV_IS_BUFFER (buffer) &&
-		buffer->priv->status == ARV_BUFFER_STATUS_SUCCESS &&
-		arv_buffer_payload_type_has_chunks (buffer->priv->payload_type);
+	g_return_val_if_fail (part_id < arv_buffer_get_n_parts (buffer), ARV_BUFFER_PART_DATA_TYPE_UNKNOWN);
+
+	if (!_is_multipart (buffer))
+		return ARV_BUFFER_PART_DATA_TYPE_2D_IMAGE;
+
+	return buffer->priv->parts[part_id].data_type;
 }
 
 /**
- * arv_buffer_get_chunk_data:
+ * arv_buffer_get_part_pixel_format:
  * @buffer: a #ArvBuffer
- * @chunk_id: chunk id
- * @size: (allow-none): location to store chunk data size, or %NULL
- *
- * Chunk data accessor.
+ * @part_id: part index, between 0 and arv_buffer_get_n_parts() - 1
  *
- * Returns: (array length=size) (element-type guint8): a pointer to the chunk data.
+ * Returns: the pixel format of the part data.
  *
- * Since: 0.4.0
- **/
+ * Since: 0.8.11
+ */
 
-const void *
-arv_buffer_get_chunk_data (ArvBuffer *buffer, guint64 chunk_id, size_t *size)
+ArvPixelFormat
+arv_buffer_get_part_pixel_format (ArvBuffer *buffer, guint part_id)
 {
-	ArvChunkInfos *infos;
-	unsigned char *data;
-	ptrdiff_t offset;
-
-	if (size != NULL)
-		*size = 0;
+	g_return_val_if_fail (part_id < arv_buffer_get_n_parts (buffer), 0);
 
-	g_return_val_if_fail (arv_buffer_has_chunks (buffer), NULL);
-	g_return_val_if_fail (buffer->priv->data != NULL, NULL);
-
-	data = buffer->priv->data;
-	offset = buffer->priv->size - sizeof (ArvChunkInfos);
-	while (offset > 0) {
-		guint32 id;
-		guint32 chunk_size;
+	if (!_is_multipart (buffer))
+		return buffer->priv->pixel_format;
 
-		infos = (ArvChunkInfos *) &data[offset];
+	return buffer->priv->parts[part_id].pixel_format;
+}
 
-		if (buffer->priv->chunk_endianness == G_BIG_ENDIAN) {
-			id = GUINT32_FROM_BE (infos->id);
-			chunk_size = GUINT32_FROM_BE (infos->size);
-		} else {
-			id = GUINT32_FROM_LE (infos->id);
-			chunk_size = GUINT32_FROM_LE (infos->size);
-		}
+/**
+ * arv_buffer_get_part_region:
+ * @buffer: a #ArvBuffer
+ * @part_id: part index, between 0 and arv_buffer_get_n_parts() - 1
+ * @x: (out) (optional): part x offset placeholder
+ * @y: (out) (optional): part y offset placeholder
+ * @width: (out) (optional): part width placholder
+ * @height: (out) (optional): part height placeholder
+ *
+ * Gets the region of an image part.
+ *
+ * Since: 0.8.11
+ */
 
-		if (id == chunk_id) {
-			ptrdiff_t data_offset;
+void
+arv_buffer_get_part_region (ArvBuffer *buffer, guint part_id, gint *x, gint *y, gint *width, gint *height)
+{
+	g_return_if_fail (part_id < arv_buffer_get_n_parts (buffer));
 
-			data_offset = offset - chunk_size;
-			if (data_offset >= 0) {
-				if (size != NULL)
-					*size = chunk_size;
-				return &data[data_offset];
-			} else
-		       		return NULL;
-		}
-		if (chunk_size > 0)
-			offset = offset - chunk_size - sizeof (ArvChunkInfos);
-		else
-			offset = 0;
-	};
+	if (!_is_multipart (buffer)) {
+		arv_buffer_get_image_region (buffer, x, y, width, height);
+		return;
+	}
 
-	return NULL;
+	if (x != NULL)
+		*x = buffer->priv->parts[part_id].x_offset;
+	if (y != NULL)
+		*y = buffer->priv->parts[part_id].y_offset;
+	if (width != NULL)
+		*width = buffer->priv->parts[part_id].width;
+	if (height != NULL)
+		*height = buffer->priv->parts[part_id].height;
 }
 
 /**
@@ -378,6 +1196,71 @@ arv_buffer_set_system_timestamp (ArvBuffer *buffer, guint64 timestamp_ns)
 	buffer->priv->system_timestamp_ns = timestamp_ns;
 }
 
+/**
+ * arv_buffer_get_host_timestamp:
+ * @buffer: a #ArvBuffer
+ *
+ * Gets the buffer timestamp converted to the host monotonic time base, the one of g_get_monotonic_time(), expressed
+ * in nanoseconds. For GigEVision devices, the device clock is mapped to the host clock by a per stream model which
+ * compensates its offset and drift, so the host timestamps of buffers coming from different devices can be directly
+ * compared. For other devices, it is the host monotonic time of the frame reception.
+ *
+ * Returns: buffer host timestamp, in nanoseconds.
+ *
+ * Since: 0.8.11
+ */
+
+guint64
+arv_buffer_get_host_timestamp (ArvBuffer *buffer)
+{
+	g_return_val_if_fail (ARV_IS_BUFFER (buffer), 0);
+
+	return buffer->priv->host_timestamp_ns;
+}
+
+/**
+ * arv_buffer_get_leader_hardware_timestamp:
+ * @buffer: a #ArvBuffer
+ *
+ * Gets the time at which the network interface received the first packet of the frame, expressed in nanoseconds, in
+ * the time base of the network interface hardware clock. This clock is usually synchronized to the system real time
+ * clock by a PTP daemon, which makes it comparable to g_get_real_time(). Only available for GigEVision streams
+ * created with %ARV_GV_STREAM_OPTION_HARDWARE_TIMESTAMPS_ENABLED, on network interfaces with hardware receive
+ * timestamp support.
+ *
+ * Returns: leader packet hardware timestamp, in nanoseconds, 0 if not available.
+ *
+ * Since: 0.8.11
+ */
+
+guint64
+arv_buffer_get_leader_hardware_timestamp (ArvBuffer *buffer)
+{
+	g_return_val_if_fail (ARV_IS_BUFFER (buffer), 0);
+
+	return buffer->priv->leader_hardware_timestamp_ns;
+}
+
+/**
+ * arv_buffer_get_trailer_hardware_timestamp:
+ * @buffer: a #ArvBuffer
+ *
+ * Gets the time at which the network interface received the last packet of the frame. See
+ * arv_buffer_get_leader_hardware_timestamp().
+ *
+ * Returns: trailer packet hardware timestamp, in nanoseconds, 0 if not available.
+ *
+ * Since: 0.8.11
+ */
+
+guint64
+arv_buffer_get_trailer_hardware_timestamp (ArvBuffer *buffer)
+{
+	g_return_val_if_fail (ARV_IS_BUFFER (buffer), 0);
+
+	return buffer->priv->trailer_hardware_timestamp_ns;
+}
+
 
 /**
  * arv_buffer_get_frame_id:
@@ -416,6 +1299,256 @@ arv_buffer_set_frame_id (ArvBuffer *buffer, guint64 frame_id)
 	buffer->priv->frame_id = frame_id;
 }
 
+/**
+ * arv_buffer_start_fill:
+ * @buffer: a #ArvBuffer, popped by arv_stream_pop_input_buffer()
+ * @size: (out) (optional): the payload size of @buffer
+ *
+ * Prepares @buffer for a new frame, from the receive thread of a stream backend. The status is set to
+ * %ARV_BUFFER_STATUS_FILLING, and the received size, the frame id, the timestamps, the chunk index, the parts, the
+ * checksum and the missing ranges of the previous frame are cleared. The chunk endianness is kept, as it is a
+ * property of the transport.
+ *
+ * The backend then writes the payload and sets the frame properties, before delivering @buffer using
+ * arv_stream_push_output_buffer():
+ *
+ * - the status, using arv_buffer_set_status(), which is mandatory;
+ * - the payload type, using arv_buffer_set_payload_type(), and for the image payloads, the region and the pixel
+ *   format, using arv_buffer_set_image_region() and arv_buffer_set_image_pixel_format();
+ * - the received size, using arv_buffer_set_received_size();
+ * - the frame id and the device timestamp, using arv_buffer_set_frame_id() and arv_buffer_set_timestamp();
+ * - optionally, the system timestamp, using arv_buffer_set_system_timestamp(). The system and host timestamps left
+ *   to 0 are set by arv_stream_push_output_buffer() to the current real and monotonic time;
+ * - optionally, the chunk endianness, using arv_buffer_set_chunk_endianness(), big endian by default.
+ *
+ * Returns: (transfer none): the writable data of @buffer, of @size bytes.
+ *
+ * Since: 0.8.11
+ */
+
+void *
+arv_buffer_start_fill (ArvBuffer *buffer, size_t *size)
+{
+	g_return_val_if_fail (ARV_IS_BUFFER (buffer), NULL);
+
+	buffer->priv->status = ARV_BUFFER_STATUS_FILLING;
+	buffer->priv->received_size = 0;
+	buffer->priv->frame_id = 0;
+	buffer->priv->timestamp_ns = 0;
+	buffer->priv->system_timestamp_ns = 0;
+	buffer->priv->host_timestamp_ns = 0;
+	buffer->priv->leader_hardware_timestamp_ns = 0;
+	buffer->priv->trailer_hardware_timestamp_ns = 0;
+	buffer->priv->ready_offset = 0;
+	buffer->priv->ready_size = 0;
+	buffer->priv->has_chunk_index = FALSE;
+	buffer->priv->n_chunk_values = 0;
+	buffer->priv->n_parts = 0;
+	buffer->priv->has_checksum = FALSE;
+	arv_buffer_clear_missing_ranges (buffer);
+
+	if (size != NULL)
+		*size = buffer->priv->size;
+
+	return buffer->priv->data;
+}
+
+/**
+ * arv_buffer_set_status:
+ * @buffer: a #ArvBuffer
+ * @status: the acquisition status
+ *
+ * Sets the acquisition status of a buffer filled by a stream backend, before its delivery.
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_buffer_set_status (ArvBuffer *buffer, ArvBufferStatus status)
+{
+	g_return_if_fail (ARV_IS_BUFFER (buffer));
+
+	buffer->priv->status = status;
+}
+
+/**
+ * arv_buffer_set_payload_type:
+ * @buffer: a #ArvBuffer
+ * @payload_type: the payload type
+ *
+ * Sets the payload type of a buffer filled by a stream backend.
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_buffer_set_payload_type (ArvBuffer *buffer, ArvBufferPayloadType payload_type)
+{
+	g_return_if_fail (ARV_IS_BUFFER (buffer));
+
+	buffer->priv->payload_type = payload_type;
+}
+
+/**
+ * arv_buffer_set_received_size:
+ * @buffer: a #ArvBuffer
+ * @received_size: the number of received bytes, at most the payload size
+ *
+ * Sets the size of the data written by a stream backend, which may be smaller than the payload size for the
+ * variable size payloads.
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_buffer_set_received_size (ArvBuffer *buffer, size_t received_size)
+{
+	g_return_if_fail (ARV_IS_BUFFER (buffer));
+	g_return_if_fail (received_size <= buffer->priv->size);
+
+	buffer->priv->received_size = received_size;
+}
+
+/**
+ * arv_buffer_set_image_region:
+ * @buffer: a #ArvBuffer
+ * @x: image x offset
+ * @y: image y offset
+ * @width: image width
+ * @height: image height
+ *
+ * Sets the image region of a buffer filled by a stream backend.
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_buffer_set_image_region (ArvBuffer *buffer, gint x, gint y, gint width, gint height)
+{
+	g_return_if_fail (ARV_IS_BUFFER (buffer));
+	g_return_if_fail (x >= 0 && y >= 0 && width >= 0 && height >= 0);
+
+	buffer->priv->x_offset = x;
+	buffer->priv->y_offset = y;
+	buffer->priv->width = width;
+	buffer->priv->height = height;
+}
+
+/**
+ * arv_buffer_set_image_pixel_format:
+ * @buffer: a #ArvBuffer
+ * @pixel_format: image pixel format
+ *
+ * Sets the image pixel format of a buffer filled by a stream backend.
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_buffer_set_image_pixel_format (ArvBuffer *buffer, ArvPixelFormat pixel_format)
+{
+	g_return_if_fail (ARV_IS_BUFFER (buffer));
+
+	buffer->priv->pixel_format = pixel_format;
+}
+
+/**
+ * arv_buffer_set_chunk_endianness:
+ * @buffer: a #ArvBuffer
+ * @endianness: %G_BIG_ENDIAN or %G_LITTLE_ENDIAN
+ *
+ * Sets the byte order of the chunk trailers of a buffer filled by a stream backend. It is big endian by default, as
+ * for GigE Vision, while USB3 Vision uses little endian.
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_buffer_set_chunk_endianness (ArvBuffer *buffer, guint endianness)
+{
+	g_return_if_fail (ARV_IS_BUFFER (buffer));
+	g_return_if_fail (endianness == G_BIG_ENDIAN || endianness == G_LITTLE_ENDIAN);
+
+	buffer->priv->chunk_endianness = endianness;
+	buffer->priv->has_chunk_index = FALSE;
+}
+
+/**
+ * arv_buffer_get_ready_region:
+ * @buffer: a #ArvBuffer
+ * @offset: (out) (optional): offset of the region in the buffer data
+ * @size: (out) (optional): size of the region
+ *
+ * Gets the last region of a buffer being filled reported by a %ARV_STREAM_CALLBACK_TYPE_REGION_READY stream callback.
+ * It is only meaningful from the stream callback. The data before the region end are filled and will not change
+ * until the buffer is done.
+ *
+ * Returns: (transfer none): a pointer to the region data.
+ *
+ * Since: 0.8.11
+ */
+
+const void *
+arv_buffer_get_ready_region (ArvBuffer *buffer, size_t *offset, size_t *size)
+{
+	g_return_val_if_fail (ARV_IS_BUFFER (buffer), NULL);
+
+	if (offset != NULL)
+		*offset = buffer->priv->ready_offset;
+	if (size != NULL)
+		*size = buffer->priv->ready_size;
+
+	return buffer->priv->data + buffer->priv->ready_offset;
+}
+
+/**
+ * arv_buffer_get_checksum:
+ * @buffer: a #ArvBuffer
+ * @crc32c: (out) (optional): location of the checksum
+ *
+ * Gets the CRC32C (Castagnoli polynomial, as used by iSCSI and ext4) of the received data, the
+ * arv_buffer_get_received_size() first bytes of the buffer data, computed by the stream thread during the frame
+ * reassembly when #ArvStream:checksum is set. The checksum of a stored buffer can be verified later using
+ * arv_buffer_compute_checksum().
+ *
+ * Returns: %TRUE if the checksum is available, which is only the case for the successfully received buffers.
+ *
+ * Since: 0.8.11
+ */
+
+gboolean
+arv_buffer_get_checksum (ArvBuffer *buffer, guint32 *crc32c)
+{
+	g_return_val_if_fail (ARV_IS_BUFFER (buffer), FALSE);
+
+	if (!buffer->priv->has_checksum || buffer->priv->status != ARV_BUFFER_STATUS_SUCCESS)
+		return FALSE;
+
+	if (crc32c != NULL)
+		*crc32c = buffer->priv->checksum;
+
+	return TRUE;
+}
+
+/**
+ * arv_buffer_compute_checksum:
+ * @buffer: a #ArvBuffer
+ *
+ * Computes the CRC32C of the received data of @buffer, the value returned by arv_buffer_get_checksum().
+ *
+ * Returns: the checksum of the arv_buffer_get_received_size() first bytes of the buffer data.
+ *
+ * Since: 0.8.11
+ */
+
+guint32
+arv_buffer_compute_checksum (ArvBuffer *buffer)
+{
+	g_return_val_if_fail (ARV_IS_BUFFER (buffer), 0);
+
+	return arv_crc32c (0, buffer->priv->data, MIN (buffer->priv->received_size, buffer->priv->size));
+}
+
 /**
  * arv_buffer_get_image_region:
  * @buffer: a #ArvBuffer
@@ -545,13 +1678,98 @@ arv_buffer_get_image_pixel_format (ArvBuffer *buffer)
 	return buffer->priv->pixel_format;
 }
 
+/**
+ * arv_buffer_get_image_layout:
+ * @buffer: a #ArvBuffer
+ * @n_channels: (out) (optional): number of interleaved channels per pixel
+ * @bytes_per_channel: (out) (optional): size of a channel, in bytes
+ * @stride: (out) (optional): size of an image row, in bytes
+ *
+ * Describes the image memory layout as an array of arv_buffer_get_image_height() rows of
+ * arv_buffer_get_image_width() pixels, of @n_channels unsigned integers of @bytes_per_channel bytes, in the device
+ * byte order, starting at the beginning of the buffer data. With arv_buffer_get_data_bytes(), this allows array
+ * libraries to wrap the image without copy. Packed and planar pixel formats have no such layout.
+ *
+ * Returns: %TRUE if the image pixel format can be described as an array of channels.
+ *
+ * Since: 0.8.11
+ */
+
+gboolean
+arv_buffer_get_image_layout (ArvBuffer *buffer, guint *n_channels, guint *bytes_per_channel, size_t *stride)
+{
+	ArvPixelFormat pixel_format;
+	guint bits_per_pixel;
+	guint channels;
+	guint channel_size;
+
+	if (n_channels != NULL)
+		*n_channels = 0;
+	if (bytes_per_channel != NULL)
+		*bytes_per_channel = 0;
+	if (stride != NULL)
+		*stride = 0;
+
+	g_return_val_if_fail (ARV_IS_BUFFER (buffer), FALSE);
+
+	if (!arv_buffer_payload_type_has_aoi (buffer->priv->payload_type))
+		return FALSE;
+
+	pixel_format = buffer->priv->pixel_format;
+	bits_per_pixel = ARV_PIXEL_FORMAT_BIT_PER_PIXEL (pixel_format);
+
+	if (pixel_format == ARV_PIXEL_FORMAT_RGB_8_PLANAR ||
+	    pixel_format == ARV_PIXEL_FORMAT_RGB_10_PLANAR ||
+	    pixel_format == ARV_PIXEL_FORMAT_RGB_12_PLANAR ||
+	    pixel_format == ARV_PIXEL_FORMAT_RGB_16_PLANAR)
+		return FALSE;
+
+	/* Monochrome and bayer formats have a single channel, unpacked channels are stored on 8 or 16 bits */
+	switch ((pixel_format >> 24) & 0x7f) {
+		case 0x01:
+			if (bits_per_pixel != 8 && bits_per_pixel != 16 && bits_per_pixel != 32)
+				return FALSE;
+			channels = 1;
+			channel_size = bits_per_pixel / 8;
+			break;
+		case 0x02:
+			switch (bits_per_pixel) {
+				case 16: channels = 2; channel_size = 1; break;
+				case 24: channels = 3; channel_size = 1; break;
+				case 32: channels = 4; channel_size = 1; break;
+				case 48: channels = 3; channel_size = 2; break;
+				case 64: channels = 4; channel_size = 2; break;
+				default:
+					return FALSE;
+			}
+			break;
+		default:
+			return FALSE;
+	}
+
+	if (n_channels != NULL)
+		*n_channels = channels;
+	if (bytes_per_channel != NULL)
+		*bytes_per_channel = channel_size;
+	if (stride != NULL)
+		*stride = (size_t) buffer->priv->width * channels * channel_size;
+
+	return TRUE;
+}
+
 G_DEFINE_TYPE_WITH_CODE (ArvBuffer, arv_buffer, G_TYPE_OBJECT, G_ADD_PRIVATE (ArvBuffer))
 
+/* The per frame fields stay in the first ARV_BUFFER_HOT_SIZE bytes, see ArvBufferPrivate */
+
+G_STATIC_ASSERT (offsetof (ArvBufferPrivate, size) <= ARV_BUFFER_HOT_SIZE / 2);
+G_STATIC_ASSERT (offsetof (ArvBufferPrivate, leader_hardware_timestamp_ns) <= ARV_BUFFER_HOT_SIZE);
+
 static void
 arv_buffer_init (ArvBuffer *buffer)
 {
 	buffer->priv = arv_buffer_get_instance_private (buffer);
 	buffer->priv->status = ARV_BUFFER_STATUS_CLEARED;
+	buffer->priv->fd = -1;
 }
 
 static void
@@ -560,14 +1778,31 @@ arv_buffer_finalize (GObject *object)
 	ArvBuffer *buffer = ARV_BUFFER (object);
 
 	if (!buffer->priv->is_preallocated) {
-		g_free (buffer->priv->data);
+		if (buffer->priv->allocator != NULL) {
+			arv_buffer_allocator_free (buffer->priv->allocator, buffer->priv->data, buffer->priv->capacity);
+			g_clear_object (&buffer->priv->allocator);
+		} else
+#ifndef G_OS_WIN32
+		if (buffer->priv->is_mapped) {
+			munmap (buffer->priv->mapped_data, buffer->priv->mapped_size);
+			if (buffer->priv->fd >= 0)
+				close (buffer->priv->fd);
+		} else
+#endif
+			g_free (buffer->priv->data);
 		buffer->priv->data = NULL;
 		buffer->priv->size = 0;
+		buffer->priv->capacity = 0;
 	}
 
 	if (buffer->priv->user_data && buffer->priv->user_data_destroy_func)
 		buffer->priv->user_data_destroy_func (buffer->priv->user_data);
 
+	g_free (buffer->priv->chunks);
+	g_free (buffer->priv->chunk_values);
+	g_free (buffer->priv->parts);
+	g_free (buffer->priv->missing_ranges);
+
 	G_OBJECT_CLASS (arv_buffer_parent_class)->finalize (object);
 }
 
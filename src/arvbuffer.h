@@ -68,6 +68,7 @@ typedef enum {
  * @ARV_BUFFER_PAYLOAD_TYPE_JPEG2000: JPEG2000 data
  * @ARV_BUFFER_PAYLOAD_TYPE_H264: h264 data
  * @ARV_BUFFER_PAYLOAD_TYPE_MULTIZONE_IMAGE: multizone image
+ * @ARV_BUFFER_PAYLOAD_TYPE_MULTIPART: multipart data, see arv_buffer_get_n_parts() (Since: 0.8.11)
  * @ARV_BUFFER_PAYLOAD_TYPE_IMAGE_EXTENDED_CHUNK: image and chunk data
 */
 
@@ -82,16 +83,173 @@ typedef enum {
 	ARV_BUFFER_PAYLOAD_TYPE_JPEG2000 = 		0x0007,
 	ARV_BUFFER_PAYLOAD_TYPE_H264 = 			0x0008,
 	ARV_BUFFER_PAYLOAD_TYPE_MULTIZONE_IMAGE = 	0x0009,
+	ARV_BUFFER_PAYLOAD_TYPE_MULTIPART = 		0x000a,
 	ARV_BUFFER_PAYLOAD_TYPE_IMAGE_EXTENDED_CHUNK = 	0x4001
 } ArvBufferPayloadType;
 
+/**
+ * ArvBufferPartDataType:
+ * @ARV_BUFFER_PART_DATA_TYPE_UNKNOWN: unknown data type
+ * @ARV_BUFFER_PART_DATA_TYPE_2D_IMAGE: 2D image
+ * @ARV_BUFFER_PART_DATA_TYPE_2D_PLANE_BIPLANAR: plane of a 2D biplanar image
+ * @ARV_BUFFER_PART_DATA_TYPE_2D_PLANE_TRIPLANAR: plane of a 2D triplanar image
+ * @ARV_BUFFER_PART_DATA_TYPE_2D_PLANE_QUADPLANAR: plane of a 2D quadplanar image
+ * @ARV_BUFFER_PART_DATA_TYPE_3D_IMAGE: 3D image
+ * @ARV_BUFFER_PART_DATA_TYPE_3D_PLANE_BIPLANAR: plane of a 3D biplanar image
+ * @ARV_BUFFER_PART_DATA_TYPE_3D_PLANE_TRIPLANAR: plane of a 3D triplanar image
+ * @ARV_BUFFER_PART_DATA_TYPE_3D_PLANE_QUADPLANAR: plane of a 3D quadplanar image
+ * @ARV_BUFFER_PART_DATA_TYPE_CONFIDENCE_MAP: confidence map
+ * @ARV_BUFFER_PART_DATA_TYPE_CHUNK_DATA: chunk data
+ * @ARV_BUFFER_PART_DATA_TYPE_JPEG: JPEG data
+ * @ARV_BUFFER_PART_DATA_TYPE_JPEG2000: JPEG2000 data
+ *
+ * Since: 0.8.11
+ */
+
+typedef enum {
+	ARV_BUFFER_PART_DATA_TYPE_UNKNOWN =		-1,
+	ARV_BUFFER_PART_DATA_TYPE_2D_IMAGE =		0x0001,
+	ARV_BUFFER_PART_DATA_TYPE_2D_PLANE_BIPLANAR =	0x0002,
+	ARV_BUFFER_PART_DATA_TYPE_2D_PLANE_TRIPLANAR =	0x0003,
+	ARV_BUFFER_PART_DATA_TYPE_2D_PLANE_QUADPLANAR =	0x0004,
+	ARV_BUFFER_PART_DATA_TYPE_3D_IMAGE =		0x0005,
+	ARV_BUFFER_PART_DATA_TYPE_3D_PLANE_BIPLANAR =	0x0006,
+	ARV_BUFFER_PART_DATA_TYPE_3D_PLANE_TRIPLANAR =	0x0007,
+	ARV_BUFFER_PART_DATA_TYPE_3D_PLANE_QUADPLANAR =	0x0008,
+	ARV_BUFFER_PART_DATA_TYPE_CONFIDENCE_MAP =	0x0009,
+	ARV_BUFFER_PART_DATA_TYPE_CHUNK_DATA =		0x000a,
+	ARV_BUFFER_PART_DATA_TYPE_JPEG =		0x000b,
+	ARV_BUFFER_PART_DATA_TYPE_JPEG2000 =		0x000c
+} ArvBufferPartDataType;
+
+/**
+ * ArvBufferAllocationFlags:
+ * @ARV_BUFFER_ALLOCATION_FLAGS_NONE: default allocation
+ * @ARV_BUFFER_ALLOCATION_FLAGS_HUGE_PAGES: use 2 MiB huge pages, from the hugetlb pool if available, or from
+ * transparent huge pages otherwise
+ * @ARV_BUFFER_ALLOCATION_FLAGS_LOCKED: lock the data in memory, it is never swapped out
+ * @ARV_BUFFER_ALLOCATION_FLAGS_SHAREABLE: allocate the data in a sealed memory file, whose descriptor is returned
+ * by arv_buffer_get_fd(), for a zero copy export to other processes or to devices (Linux only)
+ *
+ * Since: 0.8.11
+ */
+
+typedef enum {
+	ARV_BUFFER_ALLOCATION_FLAGS_NONE = 		0,
+	ARV_BUFFER_ALLOCATION_FLAGS_HUGE_PAGES = 	1,
+	ARV_BUFFER_ALLOCATION_FLAGS_LOCKED = 		2,
+	ARV_BUFFER_ALLOCATION_FLAGS_SHAREABLE = 	4
+} ArvBufferAllocationFlags;
+
+#define ARV_BUFFER_ERROR arv_buffer_error_quark()
+
+GQuark 			arv_buffer_error_quark 		(void);
+
+/**
+ * ArvBufferError:
+ * @ARV_BUFFER_ERROR_INVALID_PAYLOAD: the buffer doesn't contain a complete image
+ * @ARV_BUFFER_ERROR_UNSUPPORTED_CONVERSION: the requested pixel format conversion is not supported
+ * @ARV_BUFFER_ERROR_INVALID_STRIDE: the destination stride is too small or misaligned
+ * @ARV_BUFFER_ERROR_ALLOCATOR_NOT_AVAILABLE: the requested allocator backend is not available
+ * @ARV_BUFFER_ERROR_INVALID_REGION: the requested region is outside of the image
+ *
+ * Since: 0.8.11
+ */
+
+typedef enum {
+	ARV_BUFFER_ERROR_INVALID_PAYLOAD,
+	ARV_BUFFER_ERROR_UNSUPPORTED_CONVERSION,
+	ARV_BUFFER_ERROR_INVALID_STRIDE,
+	ARV_BUFFER_ERROR_ALLOCATOR_NOT_AVAILABLE,
+	ARV_BUFFER_ERROR_INVALID_REGION
+} ArvBufferError;
+
+/**
+ * ArvBufferConvertFlags:
+ * @ARV_BUFFER_CONVERT_FLAGS_NONE: bilinear demosaicing, in the calling thread
+ * @ARV_BUFFER_CONVERT_FLAGS_EDGE_AWARE: interpolate the green channel of Bayer images along the edges
+ * @ARV_BUFFER_CONVERT_FLAGS_MULTI_THREADED: split the colour conversions of large images across worker threads
+ *
+ * Since: 0.8.11
+ */
+
+typedef enum {
+	ARV_BUFFER_CONVERT_FLAGS_NONE =			0,
+	ARV_BUFFER_CONVERT_FLAGS_EDGE_AWARE =		1 << 0,
+	ARV_BUFFER_CONVERT_FLAGS_MULTI_THREADED =	1 << 1
+} ArvBufferConvertFlags;
+
+/**
+ * ArvChunkValue:
+ * @v_int64: value of integer and boolean chunks, truncated value of float chunks
+ * @v_double: value of float chunks, converted value of integer and boolean chunks
+ * @is_valid: %TRUE if the chunk was found in the buffer
+ *
+ * Chunk value filled by arv_chunk_plan_apply(), or attached to the stream buffers by the chunk plan of the stream,
+ * see arv_stream_set_chunk_plan().
+ *
+ * Since: 0.8.11
+ */
+
+typedef struct {
+	gint64 v_int64;
+	double v_double;
+	gboolean is_valid;
+} ArvChunkValue;
+
+/**
+ * ArvBufferMissingRange:
+ * @offset: offset of the first missing byte in the buffer data
+ * @size: number of missing bytes
+ * @first_row: first image row containing missing bytes
+ * @n_rows: number of image rows containing missing bytes, 0 if the range is outside of the image or if the buffer
+ * has no image
+ *
+ * Part of a frame whose packets were never received, see arv_buffer_get_missing_ranges().
+ *
+ * Since: 0.8.11
+ */
+
+typedef struct {
+	size_t offset;
+	size_t size;
+	guint first_row;
+	guint n_rows;
+} ArvBufferMissingRange;
+
+/**
+ * ArvImageStatistics:
+ * @n_samples: number of sampled pixels
+ * @depth: pixel depth, in bits
+ * @mean: mean of the sampled values, normalized to [0, 1]
+ * @saturation_ratio: ratio of the sampled pixels at the maximum value
+ * @histogram: histogram of the 8 most significant bits of the sampled values
+ *
+ * Statistics of an image region, filled by arv_buffer_compute_statistics().
+ *
+ * Since: 0.8.11
+ */
+
+typedef struct {
+	guint64 n_samples;
+	guint depth;
+	double mean;
+	double saturation_ratio;
+	guint64 histogram[256];
+} ArvImageStatistics;
+
 #define ARV_TYPE_BUFFER             (arv_buffer_get_type ())
 G_DECLARE_FINAL_TYPE (ArvBuffer, arv_buffer, ARV, BUFFER, GObject)
 
 typedef void (*ArvFrameCallback)	(ArvBuffer *buffer);
 
 ArvBuffer *		arv_buffer_new_allocate		(size_t size);
+ArvBuffer *		arv_buffer_new_allocate_numa	(size_t size, int numa_node);
+ArvBuffer *		arv_buffer_new_allocate_full	(size_t size, ArvBufferAllocationFlags flags, size_t alignment);
+ArvBuffer *		arv_buffer_new_from_allocator	(ArvBufferAllocator *allocator, size_t size);
 ArvBuffer *		arv_buffer_new 			(size_t size, void *preallocated);
+ArvBuffer *		arv_buffer_new_image		(ArvPixelFormat pixel_format, gint width, gint height,
+							 size_t size, void *preallocated);
 ArvBuffer * 		arv_buffer_new_full		(size_t size, void *preallocated,
 						 	void *user_data, GDestroyNotify user_data_destroy_func);
 
@@ -104,9 +262,29 @@ guint64			arv_buffer_get_timestamp	(ArvBuffer *buffer);
 void			arv_buffer_set_timestamp	(ArvBuffer *buffer, guint64 timestamp_ns);
 guint64			arv_buffer_get_system_timestamp	(ArvBuffer *buffer);
 void			arv_buffer_set_system_timestamp	(ArvBuffer *buffer, guint64 timestamp_ns);
+guint64			arv_buffer_get_host_timestamp	(ArvBuffer *buffer);
+guint64			arv_buffer_get_leader_hardware_timestamp	(ArvBuffer *buffer);
+guint64			arv_buffer_get_trailer_hardware_timestamp	(ArvBuffer *buffer);
 void			arv_buffer_set_frame_id		(ArvBuffer *buffer, guint64 frame_id);
 guint64 		arv_buffer_get_frame_id 	(ArvBuffer *buffer);
+
+void *			arv_buffer_start_fill		(ArvBuffer *buffer, size_t *size);
+void			arv_buffer_set_status		(ArvBuffer *buffer, ArvBufferStatus status);
+void			arv_buffer_set_payload_type	(ArvBuffer *buffer, ArvBufferPayloadType payload_type);
+void			arv_buffer_set_received_size	(ArvBuffer *buffer, size_t received_size);
+void			arv_buffer_set_image_region	(ArvBuffer *buffer, gint x, gint y, gint width, gint height);
+void			arv_buffer_set_image_pixel_format	(ArvBuffer *buffer, ArvPixelFormat pixel_format);
+void			arv_buffer_set_chunk_endianness	(ArvBuffer *buffer, guint endianness);
 const void *		arv_buffer_get_data		(ArvBuffer *buffer, size_t *size);
+GBytes *		arv_buffer_get_data_bytes	(ArvBuffer *buffer);
+size_t			arv_buffer_get_received_size	(ArvBuffer *buffer);
+size_t			arv_buffer_get_capacity		(ArvBuffer *buffer);
+gboolean		arv_buffer_set_size		(ArvBuffer *buffer, size_t size);
+int			arv_buffer_get_fd		(ArvBuffer *buffer);
+void *			arv_buffer_get_device_data	(ArvBuffer *buffer);
+const void *		arv_buffer_get_ready_region	(ArvBuffer *buffer, size_t *offset, size_t *size);
+gboolean		arv_buffer_get_checksum		(ArvBuffer *buffer, guint32 *crc32c);
+guint32			arv_buffer_compute_checksum	(ArvBuffer *buffer);
 
 void			arv_buffer_get_image_region		(ArvBuffer *buffer, gint *x, gint *y, gint *width, gint *height);
 gint			arv_buffer_get_image_width		(ArvBuffer *buffer);
@@ -114,9 +292,37 @@ gint			arv_buffer_get_image_height		(ArvBuffer *buffer);
 gint			arv_buffer_get_image_x			(ArvBuffer *buffer);
 gint			arv_buffer_get_image_y			(ArvBuffer *buffer);
 ArvPixelFormat		arv_buffer_get_image_pixel_format	(ArvBuffer *buffer);
+gboolean		arv_buffer_get_image_layout		(ArvBuffer *buffer, guint *n_channels,
+								 guint *bytes_per_channel, size_t *stride);
 
 gboolean		arv_buffer_has_chunks		(ArvBuffer *buffer);
 const void *		arv_buffer_get_chunk_data	(ArvBuffer *buffer, guint64 chunk_id, size_t *size);
+guint			arv_buffer_get_n_chunks		(ArvBuffer *buffer);
+const void *		arv_buffer_get_nth_chunk_data	(ArvBuffer *buffer, guint index, guint64 *chunk_id, size_t *size);
+const ArvChunkValue *	arv_buffer_get_chunk_values	(ArvBuffer *buffer, guint *n_values);
+const ArvBufferMissingRange *	arv_buffer_get_missing_ranges	(ArvBuffer *buffer, guint *n_ranges);
+
+guint			arv_buffer_get_n_parts			(ArvBuffer *buffer);
+const void *		arv_buffer_get_part_data		(ArvBuffer *buffer, guint part_id, size_t *size);
+ArvBufferPartDataType	arv_buffer_get_part_data_type		(ArvBuffer *buffer, guint part_id);
+ArvPixelFormat		arv_buffer_get_part_pixel_format	(ArvBuffer *buffer, guint part_id);
+void			arv_buffer_get_part_region		(ArvBuffer *buffer, guint part_id,
+								 gint *x, gint *y, gint *width, gint *height);
+
+gboolean		arv_buffer_convert		(ArvBuffer *buffer, ArvPixelFormat pixel_format,
+							 void *data, size_t stride, GError **error);
+gboolean		arv_buffer_convert_full		(ArvBuffer *buffer, ArvPixelFormat pixel_format,
+							 void *data, size_t stride, ArvBufferConvertFlags flags,
+							 GError **error);
+
+gboolean		arv_buffer_compute_histogram	(ArvBuffer *buffer, gint x, gint y, gint width, gint height,
+							 guint subsampling, guint64 *histogram, guint n_bins,
+							 GError **error);
+gboolean		arv_buffer_compute_statistics	(ArvBuffer *buffer, gint x, gint y, gint width, gint height,
+							 guint subsampling, ArvImageStatistics *statistics,
+							 GError **error);
+double			arv_image_statistics_get_percentile	(const ArvImageStatistics *statistics,
+								 double percentile);
 
 G_END_DECLS
 
@@ -0,0 +1,280 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2019 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel@gnome.org>
+ */
+
+
+/**
+ * SECTION: arvbufferallocator
+ * @short_description: Custom buffer data allocation
+ *
+ * #ArvBufferAllocator provides the data memory of the buffers created with arv_buffer_new_from_allocator(), or
+ * allocated by a stream buffer pool (see #ArvStream:pool-allocator). This allows the stream threads to write
+ * the frames directly into memory registered for DMA by another device, instead of copying them again from the
+ * heap into staging buffers.
+ *
+ * The allocators are either built from a table of functions, or use one of the built-in backends. When aravis is
+ * compiled with CUDA support (see %ARAVIS_HAS_CUDA), arv_buffer_allocator_new_cuda() returns an allocator of
+ * page-locked host memory, which can be uploaded asynchronously, or read in place by the kernels when it is mapped
+ * in the device address space, which avoids any copy on integrated GPUs. The device address of a buffer data is
+ * returned by arv_buffer_get_device_data().
+ *
+ * |[<!-- language="C" -->
+ * allocator = arv_buffer_allocator_new_cuda (ARV_BUFFER_ALLOCATOR_CUDA_MEMORY_MAPPED, 0, &error);
+ * for (i = 0; i < n_buffers; i++)
+ * 	arv_stream_push_buffer (stream, arv_buffer_new_from_allocator (allocator, payload));
+ * ...
+ * buffer = arv_stream_pop_buffer (stream);
+ * process_kernel<<<grid, block, 0, cuda_stream>>> (arv_buffer_get_device_data (buffer), ...);
+ * ]|
+ */
+
+#include <arvbufferallocatorprivate.h>
+#include <arvbuffer.h>
+#include <arvdebugprivate.h>
+#include <arvfeatures.h>
+
+#if ARAVIS_HAS_CUDA
+#include <cuda_runtime_api.h>
+#endif
+
+struct _ArvBufferAllocator {
+	GObject object;
+
+	ArvBufferAllocatorFuncs funcs;
+	void *user_data;
+	GDestroyNotify destroy;
+
+	gsize n_allocated_bytes;
+};
+
+struct _ArvBufferAllocatorClass {
+	GObjectClass parent_class;
+};
+
+G_DEFINE_TYPE (ArvBufferAllocator, arv_buffer_allocator, G_TYPE_OBJECT)
+
+/**
+ * arv_buffer_allocator_new:
+ * @funcs: allocation functions, copied
+ * @user_data: data passed to the functions
+ * @destroy: (nullable): destroy notification of @user_data
+ *
+ * Creates an allocator of buffer data using custom functions. @user_data is destroyed once the allocator and all
+ * the buffers using it are finalized.
+ *
+ * Returns: (transfer full): a new #ArvBufferAllocator
+ *
+ * Since: 0.8.11
+ */
+
+ArvBufferAllocator *
+arv_buffer_allocator_new (const ArvBufferAllocatorFuncs *funcs, void *user_data, GDestroyNotify destroy)
+{
+	ArvBufferAllocator *allocator;
+
+	g_return_val_if_fail (funcs != NULL, NULL);
+	g_return_val_if_fail (funcs->alloc != NULL && funcs->free != NULL, NULL);
+
+	allocator = g_object_new (ARV_TYPE_BUFFER_ALLOCATOR, NULL);
+	allocator->funcs = *funcs;
+	allocator->user_data = user_data;
+	allocator->destroy = destroy;
+
+	return allocator;
+}
+
+#if ARAVIS_HAS_CUDA
+
+typedef struct {
+	ArvBufferAllocatorCudaMemory memory;
+	int device;
+} ArvCudaAllocator;
+
+static void *
+_cuda_alloc (size_t size, void *user_data)
+{
+	ArvCudaAllocator *cuda = user_data;
+	unsigned int flags = cudaHostAllocPortable;
+	cudaError_t status;
+	void *data = NULL;
+
+	if (cuda->memory == ARV_BUFFER_ALLOCATOR_CUDA_MEMORY_MAPPED)
+		flags |= cudaHostAllocMapped;
+
+	/* The allocations are made on the current device of the calling thread */
+	status = cudaSetDevice (cuda->device);
+	if (status == cudaSuccess)
+		status = cudaHostAlloc (&data, size, flags);
+	if (status != cudaSuccess) {
+		arv_warning_misc ("[BufferAllocator::cuda_alloc] Failed to allocate %" G_GSIZE_FORMAT " bytes (%s)",
+				  size, cudaGetErrorString (status));
+		return NULL;
+	}
+
+	return data;
+}
+
+static void
+_cuda_free (void *data, size_t size, void *user_data)
+{
+	cudaError_t status;
+
+	status = cudaFreeHost (data);
+	if (status != cudaSuccess)
+		arv_warning_misc ("[BufferAllocator::cuda_free] Failed to free %" G_GSIZE_FORMAT " bytes (%s)",
+				  size, cudaGetErrorString (status));
+}
+
+static void *
+_cuda_map (void *data, size_t size, void *user_data)
+{
+	ArvCudaAllocator *cuda = user_data;
+	void *device_data = NULL;
+
+	if (cuda->memory != ARV_BUFFER_ALLOCATOR_CUDA_MEMORY_MAPPED)
+		return NULL;
+
+	if (cudaHostGetDevicePointer (&device_data, data, 0) != cudaSuccess)
+		return NULL;
+
+	return device_data;
+}
+
+static const ArvBufferAllocatorFuncs arv_cuda_allocator_funcs = {
+	_cuda_alloc,
+	_cuda_free,
+	_cuda_map
+};
+
+#endif
+
+/**
+ * arv_buffer_allocator_new_cuda:
+ * @memory: kind of page-locked memory
+ * @device: index of the CUDA device
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Creates an allocator of page-locked host memory usable by all the CUDA contexts. The mapped memory is also
+ * accessible from @device, at the address returned by arv_buffer_get_device_data().
+ *
+ * Returns: (transfer full) (nullable): a new #ArvBufferAllocator, or %NULL if the CUDA runtime is not available or
+ * @device does not exist.
+ *
+ * Since: 0.8.11
+ */
+
+ArvBufferAllocator *
+arv_buffer_allocator_new_cuda (ArvBufferAllocatorCudaMemory memory, int device, GError **error)
+{
+#if ARAVIS_HAS_CUDA
+	ArvCudaAllocator *cuda;
+	cudaError_t status;
+	int n_devices = 0;
+
+	g_return_val_if_fail (memory <= ARV_BUFFER_ALLOCATOR_CUDA_MEMORY_MAPPED, NULL);
+
+	status = cudaGetDeviceCount (&n_devices);
+	if (status != cudaSuccess || device < 0 || device >= n_devices) {
+		g_set_error (error, ARV_BUFFER_ERROR, ARV_BUFFER_ERROR_ALLOCATOR_NOT_AVAILABLE,
+			     "CUDA device %d not found (%s)", device,
+			     status != cudaSuccess ? cudaGetErrorString (status) : "invalid index");
+		return NULL;
+	}
+
+	cuda = g_new0 (ArvCudaAllocator, 1);
+	cuda->memory = memory;
+	cuda->device = device;
+
+	return arv_buffer_allocator_new (&arv_cuda_allocator_funcs, cuda, g_free);
+#else
+	g_set_error (error, ARV_BUFFER_ERROR, ARV_BUFFER_ERROR_ALLOCATOR_NOT_AVAILABLE,
+		     "Aravis is compiled without CUDA support");
+	return NULL;
+#endif
+}
+
+/**
+ * arv_buffer_allocator_get_n_allocated_bytes:
+ * @allocator: a #ArvBufferAllocator
+ *
+ * Returns: the size of the buffer data currently allocated by @allocator.
+ *
+ * Since: 0.8.11
+ */
+
+guint64
+arv_buffer_allocator_get_n_allocated_bytes (ArvBufferAllocator *allocator)
+{
+	g_return_val_if_fail (ARV_IS_BUFFER_ALLOCATOR (allocator), 0);
+
+	return (gsize) g_atomic_pointer_add (&allocator->n_allocated_bytes, 0);
+}
+
+void *
+arv_buffer_allocator_alloc (ArvBufferAllocator *allocator, size_t size, void **device_data)
+{
+	void *data;
+
+	*device_data = NULL;
+
+	data = allocator->funcs.alloc (size, allocator->user_data);
+	if (data == NULL)
+		return NULL;
+
+	if (allocator->funcs.map != NULL)
+		*device_data = allocator->funcs.map (data, size, allocator->user_data);
+
+	g_atomic_pointer_add (&allocator->n_allocated_bytes, size);
+
+	return data;
+}
+
+void
+arv_buffer_allocator_free (ArvBufferAllocator *allocator, void *data, size_t size)
+{
+	allocator->funcs.free (data, size, allocator->user_data);
+
+	g_atomic_pointer_add (&allocator->n_allocated_bytes, -(gssize) size);
+}
+
+static void
+arv_buffer_allocator_init (ArvBufferAllocator *allocator)
+{
+}
+
+static void
+arv_buffer_allocator_finalize (GObject *object)
+{
+	ArvBufferAllocator *allocator = ARV_BUFFER_ALLOCATOR (object);
+
+	if (allocator->destroy != NULL)
+		allocator->destroy (allocator->user_data);
+
+	G_OBJECT_CLASS (arv_buffer_allocator_parent_class)->finalize (object);
+}
+
+static void
+arv_buffer_allocator_class_init (ArvBufferAllocatorClass *this_class)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS (this_class);
+
+	object_class->finalize = arv_buffer_allocator_finalize;
+}
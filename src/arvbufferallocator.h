@@ -0,0 +1,79 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2019 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel@gnome.org>
+ */
+
+#ifndef ARV_BUFFER_ALLOCATOR_H
+#define ARV_BUFFER_ALLOCATOR_H
+
+#if !defined (ARV_H_INSIDE) && !defined (ARAVIS_COMPILATION)
+#error "Only <arv.h> can be included directly."
+#endif
+
+#include <arvtypes.h>
+
+G_BEGIN_DECLS
+
+/**
+ * ArvBufferAllocatorFuncs:
+ * @alloc: allocates @size bytes of buffer data, returns %NULL on failure
+ * @free: releases data returned by @alloc, of the same @size
+ * @map: (nullable): returns the address of the data for the device the memory is registered to, for example the
+ * CUDA device pointer of a mapped host allocation, or %NULL if the data is not accessible by a device
+ *
+ * Table of the functions of a custom buffer allocator, called with the user data given to
+ * arv_buffer_allocator_new(). They may be called from any thread.
+ *
+ * Since: 0.8.11
+ */
+
+typedef struct {
+	void *		(*alloc)	(size_t size, void *user_data);
+	void		(*free)		(void *data, size_t size, void *user_data);
+	void *		(*map)		(void *data, size_t size, void *user_data);
+} ArvBufferAllocatorFuncs;
+
+/**
+ * ArvBufferAllocatorCudaMemory:
+ * @ARV_BUFFER_ALLOCATOR_CUDA_MEMORY_PINNED: page-locked host memory, for asynchronous uploads at the full bus speed
+ * @ARV_BUFFER_ALLOCATOR_CUDA_MEMORY_MAPPED: page-locked host memory mapped in the device address space, read in
+ * place by the kernels, without any upload on integrated GPUs
+ *
+ * Since: 0.8.11
+ */
+
+typedef enum {
+	ARV_BUFFER_ALLOCATOR_CUDA_MEMORY_PINNED,
+	ARV_BUFFER_ALLOCATOR_CUDA_MEMORY_MAPPED
+} ArvBufferAllocatorCudaMemory;
+
+#define ARV_TYPE_BUFFER_ALLOCATOR             (arv_buffer_allocator_get_type ())
+G_DECLARE_FINAL_TYPE (ArvBufferAllocator, arv_buffer_allocator, ARV, BUFFER_ALLOCATOR, GObject)
+
+ArvBufferAllocator *	arv_buffer_allocator_new		(const ArvBufferAllocatorFuncs *funcs, void *user_data,
+								 GDestroyNotify destroy);
+ArvBufferAllocator *	arv_buffer_allocator_new_cuda		(ArvBufferAllocatorCudaMemory memory, int device,
+								 GError **error);
+
+guint64			arv_buffer_allocator_get_n_allocated_bytes	(ArvBufferAllocator *allocator);
+
+G_END_DECLS
+
+#endif
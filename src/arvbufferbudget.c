@@ -0,0 +1,231 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2019 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel@gnome.org>
+ */
+
+/*< private >
+ * SECTION: arvbufferbudget
+ * @short_description: Process wide memory budget of the stream buffers
+ *
+ * The buffer budget accounts for the bytes of the buffers owned by all the streams of the process, from their push
+ * in the input queue, or their allocation by the buffer pool, until they are popped from the output queue by the
+ * application. When a maximum is set by arv_set_stream_memory_budget(), it is apportioned across the streams in
+ * proportion of their payload throughput, that is their payload size times their measured frame rate, and a
+ * buffer pool can only grow while its stream stays within its share.
+ */
+
+#include <arvbufferbudgetprivate.h>
+
+static struct {
+	GMutex mutex;
+	GList *clients;
+	guint n_clients;
+
+	guint64 max_bytes;
+	gint policy;
+
+	guint64 owned_bytes;
+	guint64 high_water_mark_bytes;
+	/* Events of the unregistered streams */
+	guint64 n_events[ARV_BUFFER_BUDGET_N_EVENTS];
+} budget;
+
+ArvBufferBudgetClient *
+arv_buffer_budget_register (void)
+{
+	ArvBufferBudgetClient *client;
+
+	client = g_new0 (ArvBufferBudgetClient, 1);
+
+	g_mutex_lock (&budget.mutex);
+	budget.clients = g_list_prepend (budget.clients, client);
+	budget.n_clients++;
+	g_mutex_unlock (&budget.mutex);
+
+	return client;
+}
+
+void
+arv_buffer_budget_unregister (ArvBufferBudgetClient *client)
+{
+	guint i;
+
+	if (client == NULL)
+		return;
+
+	g_mutex_lock (&budget.mutex);
+	budget.clients = g_list_remove (budget.clients, client);
+	budget.n_clients--;
+	for (i = 0; i < ARV_BUFFER_BUDGET_N_EVENTS; i++)
+		budget.n_events[i] += __atomic_load_n (&client->n_events[i], __ATOMIC_RELAXED);
+	g_mutex_unlock (&budget.mutex);
+
+	/* The buffers still in the queues are destroyed with the stream */
+	__atomic_fetch_sub (&budget.owned_bytes, __atomic_load_n (&client->owned_bytes, __ATOMIC_RELAXED),
+			    __ATOMIC_RELAXED);
+
+	g_free (client);
+}
+
+/* Called by the stream thread, a zero frame period meaning the frame rate is not measured yet. The weight is a plain
+ * store, only read for the apportionment. */
+
+void
+arv_buffer_budget_set_rate (ArvBufferBudgetClient *client, size_t payload_size, double frame_period_us)
+{
+	double frame_rate;
+
+	g_return_if_fail (client != NULL);
+
+	frame_rate = frame_period_us > 0.0 ? 1e6 / frame_period_us : ARV_BUFFER_BUDGET_DEFAULT_FRAME_RATE;
+
+	client->weight = (double) payload_size * frame_rate;
+}
+
+void
+arv_buffer_budget_acquire (ArvBufferBudgetClient *client, size_t n_bytes)
+{
+	guint64 owned_bytes;
+	guint64 high_water_mark_bytes;
+
+	g_return_if_fail (client != NULL);
+
+	__atomic_fetch_add (&client->owned_bytes, n_bytes, __ATOMIC_RELAXED);
+	owned_bytes = __atomic_add_fetch (&budget.owned_bytes, n_bytes, __ATOMIC_RELAXED);
+
+	high_water_mark_bytes = __atomic_load_n (&budget.high_water_mark_bytes, __ATOMIC_RELAXED);
+	while (owned_bytes > high_water_mark_bytes &&
+	       !__atomic_compare_exchange_n (&budget.high_water_mark_bytes, &high_water_mark_bytes, owned_bytes,
+					     TRUE, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+}
+
+void
+arv_buffer_budget_release (ArvBufferBudgetClient *client, size_t n_bytes)
+{
+	g_return_if_fail (client != NULL);
+
+	__atomic_fetch_sub (&client->owned_bytes, n_bytes, __ATOMIC_RELAXED);
+	__atomic_fetch_sub (&budget.owned_bytes, n_bytes, __ATOMIC_RELAXED);
+}
+
+/* Returns TRUE if @client may allocate @n_bytes more, within both its share and the total budget. A refusal is
+ * counted, the caller applying the budget policy. */
+
+gboolean
+arv_buffer_budget_allows (ArvBufferBudgetClient *client, size_t n_bytes)
+{
+	GList *iter;
+	double weight_sum = 0.0;
+	double weight;
+	guint64 share_bytes;
+	gboolean allowed;
+
+	g_return_val_if_fail (client != NULL, FALSE);
+
+	g_mutex_lock (&budget.mutex);
+
+	if (budget.max_bytes == 0) {
+		g_mutex_unlock (&budget.mutex);
+		return TRUE;
+	}
+
+	for (iter = budget.clients; iter != NULL; iter = iter->next) {
+		ArvBufferBudgetClient *other = iter->data;
+
+		weight_sum += other->weight;
+	}
+
+	/* Evenly split while no payload size is known */
+	weight = client->weight;
+	if (weight_sum > 0.0)
+		share_bytes = (guint64) ((double) budget.max_bytes * (weight / weight_sum));
+	else
+		share_bytes = budget.max_bytes / MAX (budget.n_clients, 1);
+
+	__atomic_store_n (&client->share_bytes, share_bytes, __ATOMIC_RELAXED);
+
+	allowed = __atomic_load_n (&client->owned_bytes, __ATOMIC_RELAXED) + n_bytes <= share_bytes &&
+		__atomic_load_n (&budget.owned_bytes, __ATOMIC_RELAXED) + n_bytes <= budget.max_bytes;
+
+	g_mutex_unlock (&budget.mutex);
+
+	if (!allowed)
+		arv_buffer_budget_count (client, ARV_BUFFER_BUDGET_EVENT_REFUSAL);
+
+	return allowed;
+}
+
+void
+arv_buffer_budget_count (ArvBufferBudgetClient *client, ArvBufferBudgetEvent event)
+{
+	g_return_if_fail (client != NULL);
+	g_return_if_fail (event < ARV_BUFFER_BUDGET_N_EVENTS);
+
+	__atomic_fetch_add (&client->n_events[event], 1, __ATOMIC_RELAXED);
+}
+
+void
+arv_buffer_budget_configure (guint64 max_bytes, ArvStreamBudgetPolicy policy)
+{
+	g_mutex_lock (&budget.mutex);
+	budget.max_bytes = max_bytes;
+	g_atomic_int_set (&budget.policy, policy);
+	g_mutex_unlock (&budget.mutex);
+}
+
+ArvStreamBudgetPolicy
+arv_buffer_budget_get_policy (void)
+{
+	return g_atomic_int_get (&budget.policy);
+}
+
+void
+arv_buffer_budget_get_statistics (ArvStreamBudgetStatistics *statistics)
+{
+	guint64 n_events[ARV_BUFFER_BUDGET_N_EVENTS];
+	GList *iter;
+	guint i;
+
+	g_return_if_fail (statistics != NULL);
+
+	g_mutex_lock (&budget.mutex);
+
+	for (i = 0; i < ARV_BUFFER_BUDGET_N_EVENTS; i++)
+		n_events[i] = budget.n_events[i];
+
+	for (iter = budget.clients; iter != NULL; iter = iter->next) {
+		ArvBufferBudgetClient *client = iter->data;
+
+		for (i = 0; i < ARV_BUFFER_BUDGET_N_EVENTS; i++)
+			n_events[i] += __atomic_load_n (&client->n_events[i], __ATOMIC_RELAXED);
+	}
+
+	statistics->max_bytes = budget.max_bytes;
+	statistics->n_streams = budget.n_clients;
+
+	g_mutex_unlock (&budget.mutex);
+
+	statistics->owned_bytes = __atomic_load_n (&budget.owned_bytes, __ATOMIC_RELAXED);
+	statistics->high_water_mark_bytes = __atomic_load_n (&budget.high_water_mark_bytes, __ATOMIC_RELAXED);
+	statistics->n_refused_allocations = n_events[ARV_BUFFER_BUDGET_EVENT_REFUSAL];
+	statistics->n_drops = n_events[ARV_BUFFER_BUDGET_EVENT_DROP];
+	statistics->n_recycles = n_events[ARV_BUFFER_BUDGET_EVENT_RECYCLE];
+	statistics->n_blocks = n_events[ARV_BUFFER_BUDGET_EVENT_BLOCK];
+}
@@ -0,0 +1,76 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2019 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel@gnome.org>
+ */
+
+#ifndef ARV_BUFFER_BUDGET_PRIVATE_H
+#define ARV_BUFFER_BUDGET_PRIVATE_H
+
+#if !defined (ARV_H_INSIDE) && !defined (ARAVIS_COMPILATION)
+#error "Only <arv.h> can be included directly."
+#endif
+
+#include <arvstream.h>
+
+G_BEGIN_DECLS
+
+/* Frame rate assumed for the apportionment until the frame interval of a stream is measured */
+#define ARV_BUFFER_BUDGET_DEFAULT_FRAME_RATE	30.0
+
+/* Longest wait of the stream thread for a buffer with ARV_STREAM_BUDGET_POLICY_BLOCK */
+#define ARV_BUFFER_BUDGET_BLOCK_TIMEOUT_US	100000
+
+typedef enum {
+	ARV_BUFFER_BUDGET_EVENT_REFUSAL,
+	ARV_BUFFER_BUDGET_EVENT_DROP,
+	ARV_BUFFER_BUDGET_EVENT_RECYCLE,
+	ARV_BUFFER_BUDGET_EVENT_BLOCK,
+	ARV_BUFFER_BUDGET_N_EVENTS
+} ArvBufferBudgetEvent;
+
+/* Per stream accounting, the counters being updated atomically and read with plain loads by
+ * arv_stream_declare_info() */
+
+typedef struct {
+	guint64 owned_bytes;
+	guint64 share_bytes;
+	guint64 n_events[ARV_BUFFER_BUDGET_N_EVENTS];
+	/* Payload throughput, in bytes per second, weighting the share of the stream */
+	double weight;
+} ArvBufferBudgetClient;
+
+ArvBufferBudgetClient *	arv_buffer_budget_register	(void);
+void			arv_buffer_budget_unregister	(ArvBufferBudgetClient *client);
+
+void			arv_buffer_budget_set_rate	(ArvBufferBudgetClient *client, size_t payload_size,
+							 double frame_period_us);
+
+void			arv_buffer_budget_acquire	(ArvBufferBudgetClient *client, size_t n_bytes);
+void			arv_buffer_budget_release	(ArvBufferBudgetClient *client, size_t n_bytes);
+gboolean		arv_buffer_budget_allows	(ArvBufferBudgetClient *client, size_t n_bytes);
+void			arv_buffer_budget_count		(ArvBufferBudgetClient *client, ArvBufferBudgetEvent event);
+
+void			arv_buffer_budget_configure	(guint64 max_bytes, ArvStreamBudgetPolicy policy);
+ArvStreamBudgetPolicy	arv_buffer_budget_get_policy	(void);
+void			arv_buffer_budget_get_statistics	(ArvStreamBudgetStatistics *statistics);
+
+G_END_DECLS
+
+#endif
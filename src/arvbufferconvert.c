@@ -0,0 +1,1530 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2019 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel@gnome.org>
+ */
+
+/*
+ * Conversion of packed pixel formats to byte aligned ones.
+ *
+ * Packed formats are unpacked to 16 bit values using the same descriptor for all the instruction sets: 8 pixels
+ * are gathered into 16 bit lanes by a byte shuffle, multiplied by a per lane factor, then recombined from three
+ * shifted and masked copies. The scalar path handles the row heads and tails, and the whole row when no SIMD
+ * instruction set is available.
+ */
+
+#include <arvbufferconvertprivate.h>
+#include <arvbufferprivate.h>
+#include <arvdebugprivate.h>
+#include <string.h>
+#include <math.h>
+
+#if defined (__GNUC__) && (defined (__x86_64__) || defined (__i386__))
+#define ARV_CONVERT_HAS_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined (__aarch64__)
+#define ARV_CONVERT_HAS_NEON 1
+#include <arm_neon.h>
+#endif
+
+typedef enum {
+	ARV_PIXEL_PACKING_U8,
+	ARV_PIXEL_PACKING_U16,
+	/* GigE Vision Packed formats, 2 pixels in 3 bytes, lsbs in the middle byte */
+	ARV_PIXEL_PACKING_10_PACKED,
+	ARV_PIXEL_PACKING_12_PACKED,
+	/* PFNC p formats, lsb first bit stream */
+	ARV_PIXEL_PACKING_10P,
+	ARV_PIXEL_PACKING_12P
+} ArvPixelPacking;
+
+typedef enum {
+	ARV_PIXEL_FAMILY_MONO,
+	ARV_PIXEL_FAMILY_BAYER_GR,
+	ARV_PIXEL_FAMILY_BAYER_RG,
+	ARV_PIXEL_FAMILY_BAYER_GB,
+	ARV_PIXEL_FAMILY_BAYER_BG
+} ArvPixelFamily;
+
+typedef struct {
+	ArvPixelFormat pixel_format;
+	ArvPixelFamily family;
+	ArvPixelPacking packing;
+	guint depth;
+} ArvPixelFormatInfos;
+
+static const ArvPixelFormatInfos arv_pixel_format_infos[] = {
+	{ARV_PIXEL_FORMAT_MONO_8,		ARV_PIXEL_FAMILY_MONO,		ARV_PIXEL_PACKING_U8,		8},
+	{ARV_PIXEL_FORMAT_MONO_10,		ARV_PIXEL_FAMILY_MONO,		ARV_PIXEL_PACKING_U16,		10},
+	{ARV_PIXEL_FORMAT_MONO_10_PACKED,	ARV_PIXEL_FAMILY_MONO,		ARV_PIXEL_PACKING_10_PACKED,	10},
+	{ARV_PIXEL_FORMAT_MONO_10P,		ARV_PIXEL_FAMILY_MONO,		ARV_PIXEL_PACKING_10P,		10},
+	{ARV_PIXEL_FORMAT_MONO_12,		ARV_PIXEL_FAMILY_MONO,		ARV_PIXEL_PACKING_U16,		12},
+	{ARV_PIXEL_FORMAT_MONO_12_PACKED,	ARV_PIXEL_FAMILY_MONO,		ARV_PIXEL_PACKING_12_PACKED,	12},
+	{ARV_PIXEL_FORMAT_MONO_12P,		ARV_PIXEL_FAMILY_MONO,		ARV_PIXEL_PACKING_12P,		12},
+	{ARV_PIXEL_FORMAT_MONO_14,		ARV_PIXEL_FAMILY_MONO,		ARV_PIXEL_PACKING_U16,		14},
+	{ARV_PIXEL_FORMAT_MONO_16,		ARV_PIXEL_FAMILY_MONO,		ARV_PIXEL_PACKING_U16,		16},
+
+	{ARV_PIXEL_FORMAT_BAYER_GR_8,		ARV_PIXEL_FAMILY_BAYER_GR,	ARV_PIXEL_PACKING_U8,		8},
+	{ARV_PIXEL_FORMAT_BAYER_GR_10,		ARV_PIXEL_FAMILY_BAYER_GR,	ARV_PIXEL_PACKING_U16,		10},
+	{ARV_PIXEL_FORMAT_BAYER_GR_10_PACKED,	ARV_PIXEL_FAMILY_BAYER_GR,	ARV_PIXEL_PACKING_10_PACKED,	10},
+	{ARV_PIXEL_FORMAT_BAYER_GR_10P,		ARV_PIXEL_FAMILY_BAYER_GR,	ARV_PIXEL_PACKING_10P,		10},
+	{ARV_PIXEL_FORMAT_BAYER_GR_12,		ARV_PIXEL_FAMILY_BAYER_GR,	ARV_PIXEL_PACKING_U16,		12},
+	{ARV_PIXEL_FORMAT_BAYER_GR_12_PACKED,	ARV_PIXEL_FAMILY_BAYER_GR,	ARV_PIXEL_PACKING_12_PACKED,	12},
+	{ARV_PIXEL_FORMAT_BAYER_GR_12P,		ARV_PIXEL_FAMILY_BAYER_GR,	ARV_PIXEL_PACKING_12P,		12},
+	{ARV_PIXEL_FORMAT_BAYER_GR_16,		ARV_PIXEL_FAMILY_BAYER_GR,	ARV_PIXEL_PACKING_U16,		16},
+
+	{ARV_PIXEL_FORMAT_BAYER_RG_8,		ARV_PIXEL_FAMILY_BAYER_RG,	ARV_PIXEL_PACKING_U8,		8},
+	{ARV_PIXEL_FORMAT_BAYER_RG_10,		ARV_PIXEL_FAMILY_BAYER_RG,	ARV_PIXEL_PACKING_U16,		10},
+	{ARV_PIXEL_FORMAT_BAYER_RG_10_PACKED,	ARV_PIXEL_FAMILY_BAYER_RG,	ARV_PIXEL_PACKING_10_PACKED,	10},
+	{ARV_PIXEL_FORMAT_BAYER_RG_10P,		ARV_PIXEL_FAMILY_BAYER_RG,	ARV_PIXEL_PACKING_10P,		10},
+	{ARV_PIXEL_FORMAT_BAYER_RG_12,		ARV_PIXEL_FAMILY_BAYER_RG,	ARV_PIXEL_PACKING_U16,		12},
+	{ARV_PIXEL_FORMAT_BAYER_RG_12_PACKED,	ARV_PIXEL_FAMILY_BAYER_RG,	ARV_PIXEL_PACKING_12_PACKED,	12},
+	{ARV_PIXEL_FORMAT_BAYER_RG_12P,		ARV_PIXEL_FAMILY_BAYER_RG,	ARV_PIXEL_PACKING_12P,		12},
+	{ARV_PIXEL_FORMAT_BAYER_RG_16,		ARV_PIXEL_FAMILY_BAYER_RG,	ARV_PIXEL_PACKING_U16,		16},
+
+	{ARV_PIXEL_FORMAT_BAYER_GB_8,		ARV_PIXEL_FAMILY_BAYER_GB,	ARV_PIXEL_PACKING_U8,		8},
+	{ARV_PIXEL_FORMAT_BAYER_GB_10,		ARV_PIXEL_FAMILY_BAYER_GB,	ARV_PIXEL_PACKING_U16,		10},
+	{ARV_PIXEL_FORMAT_BAYER_GB_10_PACKED,	ARV_PIXEL_FAMILY_BAYER_GB,	ARV_PIXEL_PACKING_10_PACKED,	10},
+	{ARV_PIXEL_FORMAT_BAYER_GB_10P,		ARV_PIXEL_FAMILY_BAYER_GB,	ARV_PIXEL_PACKING_10P,		10},
+	{ARV_PIXEL_FORMAT_BAYER_GB_12,		ARV_PIXEL_FAMILY_BAYER_GB,	ARV_PIXEL_PACKING_U16,		12},
+	{ARV_PIXEL_FORMAT_BAYER_GB_12_PACKED,	ARV_PIXEL_FAMILY_BAYER_GB,	ARV_PIXEL_PACKING_12_PACKED,	12},
+	{ARV_PIXEL_FORMAT_BAYER_GB_12P,		ARV_PIXEL_FAMILY_BAYER_GB,	ARV_PIXEL_PACKING_12P,		12},
+	{ARV_PIXEL_FORMAT_BAYER_GB_16,		ARV_PIXEL_FAMILY_BAYER_GB,	ARV_PIXEL_PACKING_U16,		16},
+
+	{ARV_PIXEL_FORMAT_BAYER_BG_8,		ARV_PIXEL_FAMILY_BAYER_BG,	ARV_PIXEL_PACKING_U8,		8},
+	{ARV_PIXEL_FORMAT_BAYER_BG_10,		ARV_PIXEL_FAMILY_BAYER_BG,	ARV_PIXEL_PACKING_U16,		10},
+	{ARV_PIXEL_FORMAT_BAYER_BG_10_PACKED,	ARV_PIXEL_FAMILY_BAYER_BG,	ARV_PIXEL_PACKING_10_PACKED,	10},
+	{ARV_PIXEL_FORMAT_BAYER_BG_10P,		ARV_PIXEL_FAMILY_BAYER_BG,	ARV_PIXEL_PACKING_10P,		10},
+	{ARV_PIXEL_FORMAT_BAYER_BG_12,		ARV_PIXEL_FAMILY_BAYER_BG,	ARV_PIXEL_PACKING_U16,		12},
+	{ARV_PIXEL_FORMAT_BAYER_BG_12_PACKED,	ARV_PIXEL_FAMILY_BAYER_BG,	ARV_PIXEL_PACKING_12_PACKED,	12},
+	{ARV_PIXEL_FORMAT_BAYER_BG_12P,		ARV_PIXEL_FAMILY_BAYER_BG,	ARV_PIXEL_PACKING_12P,		12},
+	{ARV_PIXEL_FORMAT_BAYER_BG_16,		ARV_PIXEL_FAMILY_BAYER_BG,	ARV_PIXEL_PACKING_U16,		16}
+};
+
+/* Unpacking of 8 pixels, lanes are ((shuffle (src) * mul) & mask_0) | ((... >> 4) & mask_4) | ((... >> 6) & mask_6) */
+
+typedef struct {
+	guint group_pixels;
+	guint group_bytes;
+	guint8 shuffle[16];
+	guint16 mul[8];
+	guint16 mask_0[8];
+	guint16 mask_4[8];
+	guint16 mask_6[8];
+} ArvPixelUnpack;
+
+static const ArvPixelUnpack arv_unpack_10_packed = {
+	2, 3,
+	{1, 0, 1, 2, 4, 3, 4, 5, 7, 6, 7, 8, 10, 9, 10, 11},
+	{1, 1, 1, 1, 1, 1, 1, 1},
+	{0x0003, 0x0000, 0x0003, 0x0000, 0x0003, 0x0000, 0x0003, 0x0000},
+	{0x0000, 0x0003, 0x0000, 0x0003, 0x0000, 0x0003, 0x0000, 0x0003},
+	{0x03fc, 0x03fc, 0x03fc, 0x03fc, 0x03fc, 0x03fc, 0x03fc, 0x03fc}
+};
+
+static const ArvPixelUnpack arv_unpack_12_packed = {
+	2, 3,
+	{1, 0, 1, 2, 4, 3, 4, 5, 7, 6, 7, 8, 10, 9, 10, 11},
+	{1, 1, 1, 1, 1, 1, 1, 1},
+	{0x000f, 0x0000, 0x000f, 0x0000, 0x000f, 0x0000, 0x000f, 0x0000},
+	{0x0ff0, 0x0fff, 0x0ff0, 0x0fff, 0x0ff0, 0x0fff, 0x0ff0, 0x0fff},
+	{0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000}
+};
+
+static const ArvPixelUnpack arv_unpack_10p = {
+	4, 5,
+	{0, 1, 1, 2, 2, 3, 3, 4, 5, 6, 6, 7, 7, 8, 8, 9},
+	{64, 16, 4, 1, 64, 16, 4, 1},
+	{0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000},
+	{0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000},
+	{0x03ff, 0x03ff, 0x03ff, 0x03ff, 0x03ff, 0x03ff, 0x03ff, 0x03ff}
+};
+
+static const ArvPixelUnpack arv_unpack_12p = {
+	2, 3,
+	{0, 1, 1, 2, 3, 4, 4, 5, 6, 7, 7, 8, 9, 10, 10, 11},
+	{1, 1, 1, 1, 1, 1, 1, 1},
+	{0x0fff, 0x0000, 0x0fff, 0x0000, 0x0fff, 0x0000, 0x0fff, 0x0000},
+	{0x0000, 0x0fff, 0x0000, 0x0fff, 0x0000, 0x0fff, 0x0000, 0x0fff},
+	{0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000}
+};
+
+static guint16
+_unpack_pixel (ArvPixelPacking packing, const guint8 *src, guint64 index)
+{
+	const guint8 *group;
+	guint j;
+
+	switch (packing) {
+		case ARV_PIXEL_PACKING_10_PACKED:
+			group = src + 3 * (index >> 1);
+			if ((index & 1) == 0)
+				return (group[0] << 2) | (group[1] & 0x03);
+			return (group[2] << 2) | ((group[1] >> 4) & 0x03);
+		case ARV_PIXEL_PACKING_12_PACKED:
+			group = src + 3 * (index >> 1);
+			if ((index & 1) == 0)
+				return (group[0] << 4) | (group[1] & 0x0f);
+			return (group[2] << 4) | (group[1] >> 4);
+		case ARV_PIXEL_PACKING_10P:
+			group = src + 5 * (index >> 2);
+			j = index & 3;
+			return ((group[j] | (group[j + 1] << 8)) >> (2 * j)) & 0x03ff;
+		case ARV_PIXEL_PACKING_12P:
+			group = src + 3 * (index >> 1);
+			if ((index & 1) == 0)
+				return group[0] | ((group[1] & 0x0f) << 8);
+			return (group[1] >> 4) | (group[2] << 4);
+		case ARV_PIXEL_PACKING_U16:
+			return src[2 * index] | (src[2 * index + 1] << 8);
+		case ARV_PIXEL_PACKING_U8:
+			return src[index];
+	}
+
+	return 0;
+}
+
+/* SIMD kernels, they process as many pixels as they can without reading past the n_pixels packed pixels and
+ * return the number of processed pixels */
+
+typedef guint (*ArvUnpackKernel) (const guint8 *src, guint16 *dst, guint n_pixels, guint bit_per_pixel,
+				  const ArvPixelUnpack *unpack, guint shift);
+typedef guint (*ArvShiftKernel) (const guint16 *src, guint8 *dst, guint n_pixels, guint shift);
+
+static guint
+_unpack_scalar (const guint8 *src, guint16 *dst, guint n_pixels, guint bit_per_pixel,
+		const ArvPixelUnpack *unpack, guint shift)
+{
+	return 0;
+}
+
+static guint
+_shift_to_8_scalar (const guint16 *src, guint8 *dst, guint n_pixels, guint shift)
+{
+	return 0;
+}
+
+#ifdef ARV_CONVERT_HAS_X86
+
+__attribute__ ((target ("sse4.1"))) static guint
+_unpack_sse4_1 (const guint8 *src, guint16 *dst, guint n_pixels, guint bit_per_pixel,
+		const ArvPixelUnpack *unpack, guint shift)
+{
+	__m128i shuffle = _mm_loadu_si128 ((const __m128i *) unpack->shuffle);
+	__m128i mul = _mm_loadu_si128 ((const __m128i *) unpack->mul);
+	__m128i mask_0 = _mm_loadu_si128 ((const __m128i *) unpack->mask_0);
+	__m128i mask_4 = _mm_loadu_si128 ((const __m128i *) unpack->mask_4);
+	__m128i mask_6 = _mm_loadu_si128 ((const __m128i *) unpack->mask_6);
+	__m128i count = _mm_cvtsi32_si128 (shift);
+	guint i;
+
+	/* Each iteration loads 16 bytes and consumes bit_per_pixel bytes */
+	for (i = 0; i + 8 <= n_pixels && (n_pixels - i) * bit_per_pixel >= 128; i += 8) {
+		__m128i v;
+
+		v = _mm_shuffle_epi8 (_mm_loadu_si128 ((const __m128i *) (src + i * bit_per_pixel / 8)), shuffle);
+		v = _mm_mullo_epi16 (v, mul);
+		v = _mm_or_si128 (_mm_or_si128 (_mm_and_si128 (v, mask_0),
+						_mm_and_si128 (_mm_srli_epi16 (v, 4), mask_4)),
+				  _mm_and_si128 (_mm_srli_epi16 (v, 6), mask_6));
+		_mm_storeu_si128 ((__m128i *) (dst + i), _mm_sll_epi16 (v, count));
+	}
+
+	return i;
+}
+
+__attribute__ ((target ("sse4.1"))) static guint
+_shift_to_8_sse4_1 (const guint16 *src, guint8 *dst, guint n_pixels, guint shift)
+{
+	__m128i count = _mm_cvtsi32_si128 (shift);
+	guint i;
+
+	for (i = 0; i + 16 <= n_pixels; i += 16) {
+		__m128i a = _mm_srl_epi16 (_mm_loadu_si128 ((const __m128i *) (src + i)), count);
+		__m128i b = _mm_srl_epi16 (_mm_loadu_si128 ((const __m128i *) (src + i + 8)), count);
+
+		_mm_storeu_si128 ((__m128i *) (dst + i), _mm_packus_epi16 (a, b));
+	}
+
+	return i;
+}
+
+__attribute__ ((target ("avx2"))) static guint
+_unpack_avx2 (const guint8 *src, guint16 *dst, guint n_pixels, guint bit_per_pixel,
+	      const ArvPixelUnpack *unpack, guint shift)
+{
+	__m256i shuffle = _mm256_broadcastsi128_si256 (_mm_loadu_si128 ((const __m128i *) unpack->shuffle));
+	__m256i mul = _mm256_broadcastsi128_si256 (_mm_loadu_si128 ((const __m128i *) unpack->mul));
+	__m256i mask_0 = _mm256_broadcastsi128_si256 (_mm_loadu_si128 ((const __m128i *) unpack->mask_0));
+	__m256i mask_4 = _mm256_broadcastsi128_si256 (_mm_loadu_si128 ((const __m128i *) unpack->mask_4));
+	__m256i mask_6 = _mm256_broadcastsi128_si256 (_mm_loadu_si128 ((const __m128i *) unpack->mask_6));
+	__m128i count = _mm_cvtsi32_si128 (shift);
+	guint i;
+
+	/* The byte shuffle works within 128 bit lanes, the upper lane is loaded with the next 8 pixels */
+	for (i = 0; i + 16 <= n_pixels && (n_pixels - i) * bit_per_pixel >= 8 * (bit_per_pixel + 16); i += 16) {
+		const guint8 *s = src + i * bit_per_pixel / 8;
+		__m256i v;
+
+		v = _mm256_inserti128_si256 (_mm256_castsi128_si256 (_mm_loadu_si128 ((const __m128i *) s)),
+					     _mm_loadu_si128 ((const __m128i *) (s + bit_per_pixel)), 1);
+		v = _mm256_shuffle_epi8 (v, shuffle);
+		v = _mm256_mullo_epi16 (v, mul);
+		v = _mm256_or_si256 (_mm256_or_si256 (_mm256_and_si256 (v, mask_0),
+						      _mm256_and_si256 (_mm256_srli_epi16 (v, 4), mask_4)),
+				     _mm256_and_si256 (_mm256_srli_epi16 (v, 6), mask_6));
+		_mm256_storeu_si256 ((__m256i *) (dst + i), _mm256_sll_epi16 (v, count));
+	}
+
+	return i + _unpack_sse4_1 (src + i * bit_per_pixel / 8, dst + i, n_pixels - i, bit_per_pixel, unpack, shift);
+}
+
+__attribute__ ((target ("avx2"))) static guint
+_shift_to_8_avx2 (const guint16 *src, guint8 *dst, guint n_pixels, guint shift)
+{
+	__m128i count = _mm_cvtsi32_si128 (shift);
+	guint i;
+
+	for (i = 0; i + 32 <= n_pixels; i += 32) {
+		__m256i a = _mm256_srl_epi16 (_mm256_loadu_si256 ((const __m256i *) (src + i)), count);
+		__m256i b = _mm256_srl_epi16 (_mm256_loadu_si256 ((const __m256i *) (src + i + 16)), count);
+
+		/* packus interleaves the 128 bit lanes of its operands */
+		_mm256_storeu_si256 ((__m256i *) (dst + i),
+				     _mm256_permute4x64_epi64 (_mm256_packus_epi16 (a, b), 0xd8));
+	}
+
+	return i + _shift_to_8_sse4_1 (src + i, dst + i, n_pixels - i, shift);
+}
+
+#endif
+
+#ifdef ARV_CONVERT_HAS_NEON
+
+static guint
+_unpack_neon (const guint8 *src, guint16 *dst, guint n_pixels, guint bit_per_pixel,
+	      const ArvPixelUnpack *unpack, guint shift)
+{
+	uint8x16_t shuffle = vld1q_u8 (unpack->shuffle);
+	uint16x8_t mul = vld1q_u16 (unpack->mul);
+	uint16x8_t mask_0 = vld1q_u16 (unpack->mask_0);
+	uint16x8_t mask_4 = vld1q_u16 (unpack->mask_4);
+	uint16x8_t mask_6 = vld1q_u16 (unpack->mask_6);
+	int16x8_t count = vdupq_n_s16 (shift);
+	guint i;
+
+	for (i = 0; i + 8 <= n_pixels && (n_pixels - i) * bit_per_pixel >= 128; i += 8) {
+		uint16x8_t v;
+
+		v = vreinterpretq_u16_u8 (vqtbl1q_u8 (vld1q_u8 (src + i * bit_per_pixel / 8), shuffle));
+		v = vmulq_u16 (v, mul);
+		v = vorrq_u16 (vorrq_u16 (vandq_u16 (v, mask_0),
+					  vandq_u16 (vshrq_n_u16 (v, 4), mask_4)),
+			       vandq_u16 (vshrq_n_u16 (v, 6), mask_6));
+		vst1q_u16 (dst + i, vshlq_u16 (v, count));
+	}
+
+	return i;
+}
+
+static guint
+_shift_to_8_neon (const guint16 *src, guint8 *dst, guint n_pixels, guint shift)
+{
+	int16x8_t count = vdupq_n_s16 (-(int) shift);
+	guint i;
+
+	for (i = 0; i + 16 <= n_pixels; i += 16) {
+		uint16x8_t a = vshlq_u16 (vld1q_u16 (src + i), count);
+		uint16x8_t b = vshlq_u16 (vld1q_u16 (src + i + 8), count);
+
+		vst1q_u8 (dst + i, vcombine_u8 (vqmovn_u16 (a), vqmovn_u16 (b)));
+	}
+
+	return i;
+}
+
+#endif
+
+static gint arv_convert_simd = -1;
+
+gboolean
+arv_convert_is_simd_supported (ArvConvertSimd simd)
+{
+	switch (simd) {
+		case ARV_CONVERT_SIMD_NONE:
+			return TRUE;
+#ifdef ARV_CONVERT_HAS_X86
+		case ARV_CONVERT_SIMD_SSE4_1:
+			return __builtin_cpu_supports ("ssse3") && __builtin_cpu_supports ("sse4.1");
+		case ARV_CONVERT_SIMD_AVX2:
+			return __builtin_cpu_supports ("avx2");
+#endif
+#ifdef ARV_CONVERT_HAS_NEON
+		case ARV_CONVERT_SIMD_NEON:
+			return TRUE;
+#endif
+		default:
+			return FALSE;
+	}
+}
+
+/* Selects the best instruction set on first use */
+
+ArvConvertSimd
+arv_convert_get_simd (void)
+{
+	gint simd = g_atomic_int_get (&arv_convert_simd);
+
+	if (simd < 0) {
+		if (arv_convert_is_simd_supported (ARV_CONVERT_SIMD_AVX2))
+			simd = ARV_CONVERT_SIMD_AVX2;
+		else if (arv_convert_is_simd_supported (ARV_CONVERT_SIMD_SSE4_1))
+			simd = ARV_CONVERT_SIMD_SSE4_1;
+		else if (arv_convert_is_simd_supported (ARV_CONVERT_SIMD_NEON))
+			simd = ARV_CONVERT_SIMD_NEON;
+		else
+			simd = ARV_CONVERT_SIMD_NONE;
+
+		arv_info_misc ("[Convert::get_simd] Using instruction set %d", simd);
+
+		g_atomic_int_set (&arv_convert_simd, simd);
+	}
+
+	return simd;
+}
+
+/* Forces the instruction set, used for comparing the SIMD kernels with the scalar path */
+
+gboolean
+arv_convert_set_simd (ArvConvertSimd simd)
+{
+	if (!arv_convert_is_simd_supported (simd))
+		return FALSE;
+
+	g_atomic_int_set (&arv_convert_simd, simd);
+
+	return TRUE;
+}
+
+static void
+_get_kernels (ArvUnpackKernel *unpack_kernel, ArvShiftKernel *shift_kernel)
+{
+	switch (arv_convert_get_simd ()) {
+#ifdef ARV_CONVERT_HAS_X86
+		case ARV_CONVERT_SIMD_AVX2:
+			*unpack_kernel = _unpack_avx2;
+			*shift_kernel = _shift_to_8_avx2;
+			return;
+		case ARV_CONVERT_SIMD_SSE4_1:
+			*unpack_kernel = _unpack_sse4_1;
+			*shift_kernel = _shift_to_8_sse4_1;
+			return;
+#endif
+#ifdef ARV_CONVERT_HAS_NEON
+		case ARV_CONVERT_SIMD_NEON:
+			*unpack_kernel = _unpack_neon;
+			*shift_kernel = _shift_to_8_neon;
+			return;
+#endif
+		default:
+			*unpack_kernel = _unpack_scalar;
+			*shift_kernel = _shift_to_8_scalar;
+			return;
+	}
+}
+
+static const ArvPixelFormatInfos *
+_get_pixel_format_infos (ArvPixelFormat pixel_format)
+{
+	guint i;
+
+	for (i = 0; i < G_N_ELEMENTS (arv_pixel_format_infos); i++)
+		if (arv_pixel_format_infos[i].pixel_format == pixel_format)
+			return &arv_pixel_format_infos[i];
+
+	return NULL;
+}
+
+static const ArvPixelUnpack *
+_get_pixel_unpack (ArvPixelPacking packing)
+{
+	switch (packing) {
+		case ARV_PIXEL_PACKING_10_PACKED:
+			return &arv_unpack_10_packed;
+		case ARV_PIXEL_PACKING_12_PACKED:
+			return &arv_unpack_12_packed;
+		case ARV_PIXEL_PACKING_10P:
+			return &arv_unpack_10p;
+		case ARV_PIXEL_PACKING_12P:
+			return &arv_unpack_12p;
+		default:
+			return NULL;
+	}
+}
+
+/* Unpacks the pixels [first, first + n_pixels[ of the packed stream starting at src */
+
+static void
+_unpack_row (const ArvPixelFormatInfos *infos, ArvUnpackKernel kernel, const guint8 *src, guint64 first,
+	     guint n_pixels, guint16 *dst, guint shift)
+{
+	const ArvPixelUnpack *unpack = _get_pixel_unpack (infos->packing);
+	guint bit_per_pixel = ARV_PIXEL_FORMAT_BIT_PER_PIXEL (infos->pixel_format);
+	guint i = 0;
+
+	if (unpack != NULL) {
+		/* Rows of the p formats are not aligned on a group boundary if the width is not a multiple
+		 * of the group size */
+		for (; i < n_pixels && (first + i) % unpack->group_pixels != 0; i++)
+			dst[i] = _unpack_pixel (infos->packing, src, first + i) << shift;
+
+		i += kernel (src + (first + i) / unpack->group_pixels * unpack->group_bytes, dst + i,
+			     n_pixels - i, bit_per_pixel, unpack, shift);
+	}
+
+	for (; i < n_pixels; i++)
+		dst[i] = _unpack_pixel (infos->packing, src, first + i) << shift;
+}
+
+/* Only packed to 16 bit unpacked conversions are supported, as the output of a group doesn't depend on its
+ * neighbours */
+
+gboolean
+arv_convert_unpacker_init (ArvConvertUnpacker *unpacker, ArvPixelFormat source, ArvPixelFormat target)
+{
+	const ArvPixelFormatInfos *source_infos;
+	const ArvPixelFormatInfos *target_infos;
+	const ArvPixelUnpack *unpack;
+	ArvShiftKernel shift_kernel;
+	ArvUnpackKernel unpack_kernel;
+
+	g_return_val_if_fail (unpacker != NULL, FALSE);
+
+	memset (unpacker, 0, sizeof (ArvConvertUnpacker));
+
+	source_infos = _get_pixel_format_infos (source);
+	target_infos = _get_pixel_format_infos (target);
+
+	if (source_infos == NULL || target_infos == NULL ||
+	    source_infos->family != target_infos->family ||
+	    target_infos->packing != ARV_PIXEL_PACKING_U16 ||
+	    target_infos->depth < source_infos->depth)
+		return FALSE;
+
+	unpack = _get_pixel_unpack (source_infos->packing);
+	if (unpack == NULL)
+		return FALSE;
+
+	_get_kernels (&unpack_kernel, &shift_kernel);
+
+	unpacker->source = source;
+	unpacker->target = target;
+	unpacker->group_pixels = unpack->group_pixels;
+	unpacker->group_bytes = unpack->group_bytes;
+	unpacker->infos = source_infos;
+	unpacker->unpack = unpack;
+	unpacker->kernel = (void (*) (void)) unpack_kernel;
+	unpacker->shift = target_infos->depth - source_infos->depth;
+
+	return TRUE;
+}
+
+/* src points to the first byte of a group */
+
+void
+arv_convert_unpacker_unpack (const ArvConvertUnpacker *unpacker, const guint8 *src, guint n_groups, guint16 *dst)
+{
+	const ArvPixelFormatInfos *infos = unpacker->infos;
+	ArvUnpackKernel kernel = (ArvUnpackKernel) unpacker->kernel;
+	guint n_pixels = n_groups * unpacker->group_pixels;
+	guint i;
+
+	for (i = kernel (src, dst, n_pixels, ARV_PIXEL_FORMAT_BIT_PER_PIXEL (infos->pixel_format),
+			 unpacker->unpack, unpacker->shift);
+	     i < n_pixels; i++)
+		dst[i] = _unpack_pixel (infos->packing, src, i) << unpacker->shift;
+}
+
+static void
+_shift_row_to_8 (ArvShiftKernel kernel, const guint16 *src, guint8 *dst, guint n_pixels, guint shift)
+{
+	guint i;
+
+	for (i = kernel (src, dst, n_pixels, shift); i < n_pixels; i++)
+		dst[i] = MIN (src[i] >> shift, 0xff);
+}
+
+/* Colour conversions. Each row is decoded to 16 bit R, G and B planes, demosaiced from a ring of 5 unpacked Bayer
+ * rows, replicated from a mono row or read from a colour format, then encoded to the destination layout. The row
+ * loops are branchless and written for the compiler auto vectorizer, x86-64 builds also get an AVX2 clone selected at
+ * load time. */
+
+#if defined (__GNUC__) && !defined (__clang__) && defined (__x86_64__) && defined (__linux__)
+#define ARV_CONVERT_TARGET_CLONES __attribute__ ((target_clones ("avx2", "default")))
+#else
+#define ARV_CONVERT_TARGET_CLONES
+#endif
+
+#define ARV_CONVERT_N_RING_ROWS		5
+#define ARV_CONVERT_ROW_PADDING		2
+#define ARV_CONVERT_MIN_BAND_ROWS	64
+
+typedef struct {
+	ArvPixelFormat pixel_format;
+	gboolean is_yuv;
+	/* Bytes per pixel, or per pixel pair for the YUV formats */
+	guint n_bytes;
+	/* Byte offsets, G_MAXUINT for no alpha. For YUV formats, r and b are the first and second luma offsets, g and a
+	 * the U and V offsets */
+	guint r, g, b, a;
+} ArvColorFormatInfos;
+
+static const ArvColorFormatInfos arv_color_format_infos[] = {
+	{ARV_PIXEL_FORMAT_RGB_8_PACKED,		FALSE,	3,	0, 1, 2, G_MAXUINT},
+	{ARV_PIXEL_FORMAT_BGR_8_PACKED,		FALSE,	3,	2, 1, 0, G_MAXUINT},
+	{ARV_PIXEL_FORMAT_RGBA_8_PACKED,	FALSE,	4,	0, 1, 2, 3},
+	{ARV_PIXEL_FORMAT_BGRA_8_PACKED,	FALSE,	4,	2, 1, 0, 3},
+	{ARV_PIXEL_FORMAT_YUV_422_PACKED,	TRUE,	4,	1, 0, 3, 2},
+	{ARV_PIXEL_FORMAT_YUV_422_YUYV_PACKED,	TRUE,	4,	0, 1, 2, 3}
+};
+
+/* Colour of the even rows, and column of this colour, per Bayer family */
+
+static const struct {
+	gboolean is_red;
+	guint column;
+} arv_bayer_patterns[] = {
+	[ARV_PIXEL_FAMILY_BAYER_GR] = {TRUE, 1},
+	[ARV_PIXEL_FAMILY_BAYER_RG] = {TRUE, 0},
+	[ARV_PIXEL_FAMILY_BAYER_GB] = {FALSE, 1},
+	[ARV_PIXEL_FAMILY_BAYER_BG] = {FALSE, 0}
+};
+
+typedef struct {
+	const ArvPixelFormatInfos *bayer;
+	const ArvColorFormatInfos *source;
+	const ArvColorFormatInfos *target;
+	ArvUnpackKernel unpack_kernel;
+	const guint8 *src;
+	guint8 *dst;
+	size_t stride;
+	guint width;
+	guint height;
+	ArvBufferConvertFlags flags;
+
+	GMutex mutex;
+	GCond cond;
+	guint n_pending_bands;
+} ArvColorJob;
+
+typedef struct {
+	ArvColorJob *job;
+	guint first_row;
+	guint end_row;
+} ArvColorBand;
+
+static const ArvColorFormatInfos *
+_get_color_format_infos (ArvPixelFormat pixel_format)
+{
+	guint i;
+
+	for (i = 0; i < G_N_ELEMENTS (arv_color_format_infos); i++)
+		if (arv_color_format_infos[i].pixel_format == pixel_format)
+			return &arv_color_format_infos[i];
+
+	return NULL;
+}
+
+/* Unpacks a Bayer row, mirrored at the borders without changing the colour parity */
+
+static void
+_load_bayer_row (ArvColorJob *job, guint row, guint16 *dst)
+{
+	const guint8 *src = job->src;
+	guint width = job->width;
+	guint i;
+
+	switch (job->bayer->packing) {
+		case ARV_PIXEL_PACKING_U8:
+			for (i = 0; i < width; i++)
+				dst[i] = src[(size_t) row * width + i];
+			break;
+		case ARV_PIXEL_PACKING_U16:
+			memcpy (dst, src + (size_t) row * width * 2, width * 2);
+			break;
+		default:
+			_unpack_row (job->bayer, job->unpack_kernel, src, (guint64) row * width, width, dst, 0);
+			break;
+	}
+
+	dst[-1] = dst[1];
+	dst[-2] = dst[2];
+	dst[width] = dst[width - 2];
+	dst[width + 1] = dst[width - 3];
+}
+
+static guint
+_mirror_row (gint row, guint height)
+{
+	if (row < 0)
+		return -row;
+	if (row >= (gint) height)
+		return 2 * (height - 1) - row;
+	return row;
+}
+
+ARV_CONVERT_TARGET_CLONES static void
+_demosaic_row_bilinear (const guint16 *up, const guint16 *row, const guint16 *down, guint width, guint column,
+			guint16 *c_plane, guint16 *g_plane, guint16 *d_plane)
+{
+	gint x;
+
+	for (x = 0; x < (gint) width; x++) {
+		gint p = row[x];
+		gint h = (row[x - 1] + row[x + 1] + 1) >> 1;
+		gint v = (up[x] + down[x] + 1) >> 1;
+		gint cross = (row[x - 1] + row[x + 1] + up[x] + down[x] + 2) >> 2;
+		gint diag = (up[x - 1] + up[x + 1] + down[x - 1] + down[x + 1] + 2) >> 2;
+		gboolean is_c = (guint) (x & 1) == column;
+
+		c_plane[x] = is_c ? p : h;
+		g_plane[x] = is_c ? cross : p;
+		d_plane[x] = is_c ? diag : v;
+	}
+}
+
+/* Green at the red and blue sites is interpolated along the direction of the smallest gradient, with a laplacian
+ * correction from the centre colour */
+
+ARV_CONVERT_TARGET_CLONES static void
+_demosaic_row_edge_aware (const guint16 *up_2, const guint16 *up, const guint16 *row, const guint16 *down,
+			  const guint16 *down_2, guint width, guint column, gint max_value,
+			  guint16 *c_plane, guint16 *g_plane, guint16 *d_plane)
+{
+	gint x;
+
+	for (x = 0; x < (gint) width; x++) {
+		gint p = row[x];
+		gint h = (row[x - 1] + row[x + 1] + 1) >> 1;
+		gint v = (up[x] + down[x] + 1) >> 1;
+		gint diag = (up[x - 1] + up[x + 1] + down[x - 1] + down[x + 1] + 2) >> 2;
+		gint laplacian_h = 2 * p - row[x - 2] - row[x + 2];
+		gint laplacian_v = 2 * p - up_2[x] - down_2[x];
+		gint gradient_h = ABS (row[x - 1] - row[x + 1]) + ABS (laplacian_h);
+		gint gradient_v = ABS (up[x] - down[x]) + ABS (laplacian_v);
+		gint green_h = h + laplacian_h / 4;
+		gint green_v = v + laplacian_v / 4;
+		gint green;
+		gboolean is_c = (guint) (x & 1) == column;
+
+		green = gradient_h < gradient_v ? green_h :
+			(gradient_v < gradient_h ? green_v : (green_h + green_v + 1) >> 1);
+		green = CLAMP (green, 0, max_value);
+
+		c_plane[x] = is_c ? p : h;
+		g_plane[x] = is_c ? green : p;
+		d_plane[x] = is_c ? diag : v;
+	}
+}
+
+static void
+_decode_color_row (const ArvColorFormatInfos *infos, const guint8 *src, guint width,
+		   guint16 *r_plane, guint16 *g_plane, guint16 *b_plane)
+{
+	guint x;
+
+	if (!infos->is_yuv) {
+		for (x = 0; x < width; x++) {
+			r_plane[x] = src[x * infos->n_bytes + infos->r];
+			g_plane[x] = src[x * infos->n_bytes + infos->g];
+			b_plane[x] = src[x * infos->n_bytes + infos->b];
+		}
+		return;
+	}
+
+	/* BT.601, limited range */
+	for (x = 0; x < width; x++) {
+		const guint8 *pair = src + (x / 2) * infos->n_bytes;
+		gint c = 298 * (pair[(x & 1) != 0 ? infos->b : infos->r] - 16);
+		gint d = pair[infos->g] - 128;
+		gint e = pair[infos->a] - 128;
+
+		r_plane[x] = CLAMP ((c + 409 * e + 128) >> 8, 0, 255);
+		g_plane[x] = CLAMP ((c - 100 * d - 208 * e + 128) >> 8, 0, 255);
+		b_plane[x] = CLAMP ((c + 516 * d + 128) >> 8, 0, 255);
+	}
+}
+
+ARV_CONVERT_TARGET_CLONES static void
+_encode_color_row (const ArvColorFormatInfos *infos, const guint16 *r_plane, const guint16 *g_plane,
+		   const guint16 *b_plane, guint shift, guint width, guint8 *dst)
+{
+	guint x;
+
+	if (!infos->is_yuv) {
+		for (x = 0; x < width; x++) {
+			dst[x * infos->n_bytes + infos->r] = MIN (r_plane[x] >> shift, 0xff);
+			dst[x * infos->n_bytes + infos->g] = MIN (g_plane[x] >> shift, 0xff);
+			dst[x * infos->n_bytes + infos->b] = MIN (b_plane[x] >> shift, 0xff);
+			if (infos->a != G_MAXUINT)
+				dst[x * infos->n_bytes + infos->a] = 0xff;
+		}
+		return;
+	}
+
+	/* BT.601, limited range, chroma averaged over the pixel pair */
+	for (x = 0; x + 1 < width; x += 2) {
+		guint8 *pair = dst + (x / 2) * infos->n_bytes;
+		gint r0 = MIN (r_plane[x] >> shift, 0xff), r1 = MIN (r_plane[x + 1] >> shift, 0xff);
+		gint g0 = MIN (g_plane[x] >> shift, 0xff), g1 = MIN (g_plane[x + 1] >> shift, 0xff);
+		gint b0 = MIN (b_plane[x] >> shift, 0xff), b1 = MIN (b_plane[x + 1] >> shift, 0xff);
+		gint r = r0 + r1, g = g0 + g1, b = b0 + b1;
+
+		pair[infos->r] = ((66 * r0 + 129 * g0 + 25 * b0 + 128) >> 8) + 16;
+		pair[infos->b] = ((66 * r1 + 129 * g1 + 25 * b1 + 128) >> 8) + 16;
+		pair[infos->g] = ((-38 * r - 74 * g + 112 * b + 256) >> 9) + 128;
+		pair[infos->a] = ((112 * r - 94 * g - 18 * b + 256) >> 9) + 128;
+	}
+}
+
+static void
+_convert_color_band (ArvColorJob *job, guint first_row, guint end_row)
+{
+	guint width = job->width;
+	guint16 *planes;
+	guint16 *ring = NULL;
+	gint loaded[ARV_CONVERT_N_RING_ROWS];
+	guint shift = 0;
+	guint y, i;
+
+	planes = g_new (guint16, 3 * width);
+
+	if (job->bayer != NULL) {
+		ring = g_new (guint16, ARV_CONVERT_N_RING_ROWS * (width + 2 * ARV_CONVERT_ROW_PADDING));
+		for (i = 0; i < ARV_CONVERT_N_RING_ROWS; i++)
+			loaded[i] = -1;
+		shift = job->bayer->depth - 8;
+	}
+
+	for (y = first_row; y < end_row; y++) {
+		guint16 *r_plane = planes;
+		guint16 *g_plane = planes + width;
+		guint16 *b_plane = planes + 2 * width;
+
+		if (job->bayer != NULL && job->bayer->family == ARV_PIXEL_FAMILY_MONO) {
+			guint16 *data = ring + ARV_CONVERT_ROW_PADDING;
+
+			_load_bayer_row (job, y, data);
+			memcpy (r_plane, data, width * sizeof (guint16));
+			memcpy (g_plane, data, width * sizeof (guint16));
+			memcpy (b_plane, data, width * sizeof (guint16));
+		} else if (job->bayer != NULL) {
+			const guint16 *rows[ARV_CONVERT_N_RING_ROWS];
+			gboolean is_red;
+			guint column;
+
+			/* Any 5 consecutive rows use distinct ring slots */
+			for (i = 0; i < ARV_CONVERT_N_RING_ROWS; i++) {
+				guint row = _mirror_row ((gint) y + (gint) i - 2, job->height);
+				guint slot = row % ARV_CONVERT_N_RING_ROWS;
+				guint16 *data = ring + slot * (width + 2 * ARV_CONVERT_ROW_PADDING) +
+					ARV_CONVERT_ROW_PADDING;
+
+				if (loaded[slot] != (gint) row) {
+					_load_bayer_row (job, row, data);
+					loaded[slot] = row;
+				}
+				rows[i] = data;
+			}
+
+			is_red = arv_bayer_patterns[job->bayer->family].is_red;
+			column = arv_bayer_patterns[job->bayer->family].column;
+			if ((y & 1) != 0) {
+				is_red = !is_red;
+				column = 1 - column;
+			}
+
+			if ((job->flags & ARV_BUFFER_CONVERT_FLAGS_EDGE_AWARE) != 0)
+				_demosaic_row_edge_aware (rows[0], rows[1], rows[2], rows[3], rows[4], width, column,
+							  (1 << job->bayer->depth) - 1,
+							  is_red ? r_plane : b_plane, g_plane, is_red ? b_plane : r_plane);
+			else
+				_demosaic_row_bilinear (rows[1], rows[2], rows[3], width, column,
+							is_red ? r_plane : b_plane, g_plane, is_red ? b_plane : r_plane);
+		} else {
+			_decode_color_row (job->source,
+					   job->src + (size_t) y * width * job->source->n_bytes /
+					   (job->source->is_yuv ? 2 : 1),
+					   width, r_plane, g_plane, b_plane);
+		}
+
+		_encode_color_row (job->target, r_plane, g_plane, b_plane, shift, width, job->dst + y * job->stride);
+	}
+
+	g_free (ring);
+	g_free (planes);
+}
+
+static void
+_convert_color_band_func (gpointer data, gpointer user_data)
+{
+	ArvColorBand *band = data;
+	ArvColorJob *job = band->job;
+
+	_convert_color_band (job, band->first_row, band->end_row);
+
+	g_mutex_lock (&job->mutex);
+	job->n_pending_bands--;
+	g_cond_signal (&job->cond);
+	g_mutex_unlock (&job->mutex);
+}
+
+static GThreadPool *
+_get_color_thread_pool (void)
+{
+	static gsize pool_init = 0;
+	static GThreadPool *pool = NULL;
+
+	if (g_once_init_enter (&pool_init)) {
+		pool = g_thread_pool_new (_convert_color_band_func, NULL, g_get_num_processors (), FALSE, NULL);
+		g_once_init_leave (&pool_init, 1);
+	}
+
+	return pool;
+}
+
+/* The first band is converted by the calling thread */
+
+static void
+_convert_color (ArvColorJob *job)
+{
+	ArvColorBand *bands;
+	GThreadPool *pool;
+	guint n_bands = 1;
+	guint i;
+
+	if ((job->flags & ARV_BUFFER_CONVERT_FLAGS_MULTI_THREADED) != 0)
+		n_bands = CLAMP (job->height / ARV_CONVERT_MIN_BAND_ROWS, 1, g_get_num_processors ());
+
+	if (n_bands == 1) {
+		_convert_color_band (job, 0, job->height);
+		return;
+	}
+
+	pool = _get_color_thread_pool ();
+	bands = g_new (ArvColorBand, n_bands);
+
+	g_mutex_init (&job->mutex);
+	g_cond_init (&job->cond);
+	job->n_pending_bands = n_bands - 1;
+
+	for (i = 0; i < n_bands; i++) {
+		bands[i].job = job;
+		bands[i].first_row = (guint64) job->height * i / n_bands;
+		bands[i].end_row = (guint64) job->height * (i + 1) / n_bands;
+		if (i > 0)
+			g_thread_pool_push (pool, &bands[i], NULL);
+	}
+
+	_convert_color_band (job, bands[0].first_row, bands[0].end_row);
+
+	g_mutex_lock (&job->mutex);
+	while (job->n_pending_bands > 0)
+		g_cond_wait (&job->cond, &job->mutex);
+	g_mutex_unlock (&job->mutex);
+
+	g_mutex_clear (&job->mutex);
+	g_cond_clear (&job->cond);
+	g_free (bands);
+}
+
+static gboolean
+_convert_buffer_color (ArvBuffer *buffer, const ArvColorFormatInfos *target, void *data, size_t stride,
+		       ArvBufferConvertFlags flags, GError **error)
+{
+	ArvColorJob job = {0};
+	ArvShiftKernel shift_kernel;
+	guint64 source_size;
+
+	job.bayer = _get_pixel_format_infos (buffer->priv->pixel_format);
+	job.source = _get_color_format_infos (buffer->priv->pixel_format);
+	job.target = target;
+	job.src = buffer->priv->data;
+	job.dst = data;
+	job.width = buffer->priv->width;
+	job.height = buffer->priv->height;
+	job.flags = flags;
+
+	if (job.bayer == NULL && job.source == NULL) {
+		g_set_error (error, ARV_BUFFER_ERROR, ARV_BUFFER_ERROR_UNSUPPORTED_CONVERSION,
+			     "Conversion from pixel format 0x%08x to 0x%08x is not supported",
+			     buffer->priv->pixel_format, target->pixel_format);
+		return FALSE;
+	}
+
+	if ((job.bayer != NULL && job.bayer->family != ARV_PIXEL_FAMILY_MONO && (job.width < 4 || job.height < 4)) ||
+	    ((target->is_yuv || (job.source != NULL && job.source->is_yuv)) && (job.width & 1) != 0)) {
+		g_set_error (error, ARV_BUFFER_ERROR, ARV_BUFFER_ERROR_UNSUPPORTED_CONVERSION,
+			     "Conversion of a %ux%u image from pixel format 0x%08x to 0x%08x is not supported",
+			     job.width, job.height, buffer->priv->pixel_format, target->pixel_format);
+		return FALSE;
+	}
+
+	job.stride = stride != 0 ? stride : (size_t) job.width * target->n_bytes / (target->is_yuv ? 2 : 1);
+	if (job.stride < (size_t) job.width * target->n_bytes / (target->is_yuv ? 2 : 1)) {
+		g_set_error (error, ARV_BUFFER_ERROR, ARV_BUFFER_ERROR_INVALID_STRIDE,
+			     "Invalid stride %" G_GSIZE_FORMAT " for %u pixel wide rows", stride, job.width);
+		return FALSE;
+	}
+
+	if (job.bayer != NULL)
+		source_size = ((guint64) job.width * job.height *
+			       ARV_PIXEL_FORMAT_BIT_PER_PIXEL (job.bayer->pixel_format) + 7) / 8;
+	else
+		source_size = (guint64) job.width * job.height * job.source->n_bytes / (job.source->is_yuv ? 2 : 1);
+
+	if (source_size > buffer->priv->size) {
+		g_set_error (error, ARV_BUFFER_ERROR, ARV_BUFFER_ERROR_INVALID_PAYLOAD,
+			     "Buffer is too small for a %ux%u image", job.width, job.height);
+		return FALSE;
+	}
+
+	_get_kernels (&job.unpack_kernel, &shift_kernel);
+
+	_convert_color (&job);
+
+	return TRUE;
+}
+
+/**
+ * arv_buffer_convert:
+ * @buffer: a #ArvBuffer
+ * @pixel_format: destination pixel format
+ * @data: (array) (element-type guint8): destination image data, of at least image height x @stride bytes
+ * @stride: size of a destination row, in bytes, or 0 for tightly packed rows
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Converts the image contained in @buffer to @pixel_format. Supported conversions unpack the Mono and Bayer
+ * 10 and 12 bit packed formats (GigE Vision Packed and PFNC p formats) to the unpacked format of the same
+ * depth, to 16 bit with the most significant bits aligned, or to 8 bit by dropping the least significant bits.
+ * 10, 12, 14 and 16 bit unpacked formats can also be converted to 8 or 16 bit. Rows of the packed formats are
+ * read as a continuous bit stream, without padding. A @stride larger than the row size allows to write rows
+ * aligned for further processing.
+ *
+ * Mono and Bayer images can also be converted to the RGB, BGR, RGBA, BGRA and YUV 4:2:2 formats, with a bilinear
+ * demosaicing of the Bayer images, as well as the 8 bit colour formats between themselves. See
+ * arv_buffer_convert_full() for the edge aware demosaicing and the multi-threaded conversion.
+ *
+ * The conversion uses SSE4.1, AVX2 or NEON instructions when available on the running CPU.
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 0.8.11
+ */
+
+gboolean
+arv_buffer_convert (ArvBuffer *buffer, ArvPixelFormat pixel_format, void *data, size_t stride, GError **error)
+{
+	return arv_buffer_convert_full (buffer, pixel_format, data, stride, ARV_BUFFER_CONVERT_FLAGS_NONE, error);
+}
+
+/**
+ * arv_buffer_convert_full:
+ * @buffer: a #ArvBuffer
+ * @pixel_format: destination pixel format
+ * @data: (array) (element-type guint8): destination image data, of at least image height x @stride bytes
+ * @stride: size of a destination row, in bytes, or 0 for tightly packed rows
+ * @flags: conversion flags
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Converts the image contained in @buffer to @pixel_format, as arv_buffer_convert(). @flags select the edge aware
+ * demosaicing of the Bayer images, and the split of the colour conversions across a pool of worker threads.
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 0.8.11
+ */
+
+gboolean
+arv_buffer_convert_full (ArvBuffer *buffer, ArvPixelFormat pixel_format, void *data, size_t stride,
+			 ArvBufferConvertFlags flags, GError **error)
+{
+	const ArvColorFormatInfos *color_target;
+	const ArvPixelFormatInfos *source;
+	const ArvPixelFormatInfos *target;
+	ArvUnpackKernel unpack_kernel;
+	ArvShiftKernel shift_kernel;
+	guint16 *row = NULL;
+	const guint8 *src;
+	size_t row_size;
+	guint width, height;
+	guint y;
+
+	g_return_val_if_fail (ARV_IS_BUFFER (buffer), FALSE);
+	g_return_val_if_fail (data != NULL, FALSE);
+
+	if (!arv_buffer_payload_type_has_aoi (buffer->priv->payload_type) ||
+	    buffer->priv->status != ARV_BUFFER_STATUS_SUCCESS) {
+		g_set_error (error, ARV_BUFFER_ERROR, ARV_BUFFER_ERROR_INVALID_PAYLOAD,
+			     "Buffer doesn't contain a complete image");
+		return FALSE;
+	}
+
+	color_target = _get_color_format_infos (pixel_format);
+	if (color_target != NULL)
+		return _convert_buffer_color (buffer, color_target, data, stride, flags, error);
+
+	source = _get_pixel_format_infos (buffer->priv->pixel_format);
+	target = _get_pixel_format_infos (pixel_format);
+
+	if (source == NULL || target == NULL ||
+	    source->family != target->family ||
+	    (target->packing != ARV_PIXEL_PACKING_U8 && target->packing != ARV_PIXEL_PACKING_U16) ||
+	    (target->packing == ARV_PIXEL_PACKING_U16 && target->depth < source->depth) ||
+	    (source->packing == ARV_PIXEL_PACKING_U8 && target->packing != ARV_PIXEL_PACKING_U8)) {
+		g_set_error (error, ARV_BUFFER_ERROR, ARV_BUFFER_ERROR_UNSUPPORTED_CONVERSION,
+			     "Conversion from pixel format 0x%08x to 0x%08x is not supported",
+			     buffer->priv->pixel_format, pixel_format);
+		return FALSE;
+	}
+
+	width = buffer->priv->width;
+	height = buffer->priv->height;
+	row_size = (size_t) width * (target->packing == ARV_PIXEL_PACKING_U8 ? 1 : 2);
+
+	if (stride == 0)
+		stride = row_size;
+
+	if (stride < row_size || (target->packing == ARV_PIXEL_PACKING_U16 && (stride & 1) != 0)) {
+		g_set_error (error, ARV_BUFFER_ERROR, ARV_BUFFER_ERROR_INVALID_STRIDE,
+			     "Invalid stride %" G_GSIZE_FORMAT " for %u pixel wide rows", stride, width);
+		return FALSE;
+	}
+
+	if (((guint64) width * height * ARV_PIXEL_FORMAT_BIT_PER_PIXEL (source->pixel_format) + 7) / 8 >
+	    buffer->priv->size) {
+		g_set_error (error, ARV_BUFFER_ERROR, ARV_BUFFER_ERROR_INVALID_PAYLOAD,
+			     "Buffer is too small for a %ux%u image", width, height);
+		return FALSE;
+	}
+
+	src = buffer->priv->data;
+
+	_get_kernels (&unpack_kernel, &shift_kernel);
+
+	if (target->packing == ARV_PIXEL_PACKING_U8 && source->packing != ARV_PIXEL_PACKING_U8 &&
+	    source->packing != ARV_PIXEL_PACKING_U16)
+		row = g_new (guint16, width);
+
+	for (y = 0; y < height; y++) {
+		guint8 *dst = (guint8 *) data + y * stride;
+		guint64 first = (guint64) y * width;
+
+		if (source->packing == ARV_PIXEL_PACKING_U8) {
+			memcpy (dst, src + first, width);
+		} else if (target->packing == ARV_PIXEL_PACKING_U8) {
+			if (source->packing == ARV_PIXEL_PACKING_U16) {
+				_shift_row_to_8 (shift_kernel, (const guint16 *) src + first, dst, width,
+						 source->depth - 8);
+			} else {
+				_unpack_row (source, unpack_kernel, src, first, width, row, 0);
+				_shift_row_to_8 (shift_kernel, row, dst, width, source->depth - 8);
+			}
+		} else if (source->packing == ARV_PIXEL_PACKING_U16) {
+			guint16 *dst16 = (guint16 *) dst;
+			const guint16 *src16 = (const guint16 *) src + first;
+			guint shift = target->depth - source->depth;
+			guint i;
+
+			for (i = 0; i < width; i++)
+				dst16[i] = GUINT16_FROM_LE (src16[i]) << shift;
+		} else {
+			_unpack_row (source, unpack_kernel, src, first, width, (guint16 *) dst,
+				     target->depth - source->depth);
+		}
+	}
+
+	g_free (row);
+
+	return TRUE;
+}
+
+/* Image statistics. Every subsampling-th pixel of every subsampling-th row of the region is sampled. The unpacked
+ * formats are read in place, the packed rows are unpacked by the SIMD kernels when the pixels are densely sampled,
+ * and one pixel at a time otherwise. The gather and accumulation loops are written for the compiler auto vectorizer.
+ * The histogram is accumulated into interleaved sub-histograms, which breaks the dependency between the consecutive
+ * increments of a same bin. */
+
+#define ARV_STATISTICS_N_SUB_HISTOGRAMS		4
+#define ARV_STATISTICS_UNPACK_SUBSAMPLING_MAX	4
+
+typedef struct {
+	const ArvPixelFormatInfos *infos;
+	ArvUnpackKernel unpack_kernel;
+	const guint8 *src;
+	guint image_width;
+	guint x, y, width, height;
+	guint subsampling;
+
+	/* Sampled values of the current row, and unpacked region row for the packed formats */
+	guint16 *samples;
+	guint16 *row;
+	guint n_samples;
+} ArvImageSampler;
+
+static gboolean
+_image_sampler_init (ArvImageSampler *sampler, ArvBuffer *buffer, gint x, gint y, gint width, gint height,
+		     guint subsampling, GError **error)
+{
+	ArvShiftKernel shift_kernel;
+
+	memset (sampler, 0, sizeof (ArvImageSampler));
+
+	if (!arv_buffer_payload_type_has_aoi (buffer->priv->payload_type) ||
+	    buffer->priv->status != ARV_BUFFER_STATUS_SUCCESS) {
+		g_set_error (error, ARV_BUFFER_ERROR, ARV_BUFFER_ERROR_INVALID_PAYLOAD,
+			     "Buffer doesn't contain a complete image");
+		return FALSE;
+	}
+
+	sampler->infos = _get_pixel_format_infos (buffer->priv->pixel_format);
+	if (sampler->infos == NULL) {
+		g_set_error (error, ARV_BUFFER_ERROR, ARV_BUFFER_ERROR_UNSUPPORTED_CONVERSION,
+			     "Statistics of pixel format 0x%08x are not supported", buffer->priv->pixel_format);
+		return FALSE;
+	}
+
+	if (x < 0 || y < 0 || (guint) x >= buffer->priv->width || (guint) y >= buffer->priv->height ||
+	    (width > 0 && (guint64) x + width > buffer->priv->width) ||
+	    (height > 0 && (guint64) y + height > buffer->priv->height)) {
+		g_set_error (error, ARV_BUFFER_ERROR, ARV_BUFFER_ERROR_INVALID_REGION,
+			     "Region %d,%d %dx%d is outside of the %ux%u image", x, y, width, height,
+			     buffer->priv->width, buffer->priv->height);
+		return FALSE;
+	}
+
+	if (((guint64) buffer->priv->width * buffer->priv->height *
+	     ARV_PIXEL_FORMAT_BIT_PER_PIXEL (sampler->infos->pixel_format) + 7) / 8 > buffer->priv->size) {
+		g_set_error (error, ARV_BUFFER_ERROR, ARV_BUFFER_ERROR_INVALID_PAYLOAD,
+			     "Buffer is too small for a %ux%u image", buffer->priv->width, buffer->priv->height);
+		return FALSE;
+	}
+
+	sampler->src = buffer->priv->data;
+	sampler->image_width = buffer->priv->width;
+	sampler->x = x;
+	sampler->y = y;
+	sampler->width = width > 0 ? (guint) width : buffer->priv->width - x;
+	sampler->height = height > 0 ? (guint) height : buffer->priv->height - y;
+	sampler->subsampling = MAX (subsampling, 1);
+	sampler->n_samples = (sampler->width + sampler->subsampling - 1) / sampler->subsampling;
+	sampler->samples = g_new (guint16, sampler->n_samples);
+
+	if (sampler->infos->packing != ARV_PIXEL_PACKING_U8 && sampler->infos->packing != ARV_PIXEL_PACKING_U16 &&
+	    sampler->subsampling <= ARV_STATISTICS_UNPACK_SUBSAMPLING_MAX) {
+		_get_kernels (&sampler->unpack_kernel, &shift_kernel);
+		sampler->row = g_new (guint16, sampler->width);
+	}
+
+	return TRUE;
+}
+
+static void
+_image_sampler_clear (ArvImageSampler *sampler)
+{
+	g_clear_pointer (&sampler->samples, g_free);
+	g_clear_pointer (&sampler->row, g_free);
+}
+
+ARV_CONVERT_TARGET_CLONES static void
+_gather_u8 (const guint8 *src, guint step, guint n_samples, guint16 *samples)
+{
+	guint i;
+
+	for (i = 0; i < n_samples; i++)
+		samples[i] = src[i * step];
+}
+
+ARV_CONVERT_TARGET_CLONES static void
+_gather_u16 (const guint8 *src, guint step, guint n_samples, guint16 *samples)
+{
+	guint i;
+
+	for (i = 0; i < n_samples; i++)
+		samples[i] = src[2 * i * step] | (src[2 * i * step + 1] << 8);
+}
+
+/* Returns the sampled values of the row-th sampled row of the region */
+
+static const guint16 *
+_image_sampler_get_row (ArvImageSampler *sampler, guint row)
+{
+	guint64 first = (guint64) (sampler->y + row * sampler->subsampling) * sampler->image_width + sampler->x;
+	guint i;
+
+	switch (sampler->infos->packing) {
+		case ARV_PIXEL_PACKING_U8:
+			_gather_u8 (sampler->src + first, sampler->subsampling, sampler->n_samples, sampler->samples);
+			return sampler->samples;
+		case ARV_PIXEL_PACKING_U16:
+			_gather_u16 (sampler->src + 2 * first, sampler->subsampling, sampler->n_samples,
+				     sampler->samples);
+			return sampler->samples;
+		default:
+			break;
+	}
+
+	if (sampler->row == NULL) {
+		for (i = 0; i < sampler->n_samples; i++)
+			sampler->samples[i] = _unpack_pixel (sampler->infos->packing, sampler->src,
+							     first + (guint64) i * sampler->subsampling);
+		return sampler->samples;
+	}
+
+	_unpack_row (sampler->infos, sampler->unpack_kernel, sampler->src, first, sampler->width, sampler->row, 0);
+
+	if (sampler->subsampling == 1)
+		return sampler->row;
+
+	for (i = 0; i < sampler->n_samples; i++)
+		sampler->samples[i] = sampler->row[i * sampler->subsampling];
+
+	return sampler->samples;
+}
+
+static guint
+_image_sampler_get_n_rows (const ArvImageSampler *sampler)
+{
+	return (sampler->height + sampler->subsampling - 1) / sampler->subsampling;
+}
+
+/* Accumulates the values into n_bins wide sub-histograms, bin = value >> shift */
+
+ARV_CONVERT_TARGET_CLONES static void
+_accumulate_histogram (const guint16 *values, guint n_values, guint shift, guint n_bins, guint64 *sub_histograms)
+{
+	guint i;
+
+	for (i = 0; i + ARV_STATISTICS_N_SUB_HISTOGRAMS <= n_values; i += ARV_STATISTICS_N_SUB_HISTOGRAMS) {
+		sub_histograms[values[i] >> shift]++;
+		sub_histograms[n_bins + (values[i + 1] >> shift)]++;
+		sub_histograms[2 * n_bins + (values[i + 2] >> shift)]++;
+		sub_histograms[3 * n_bins + (values[i + 3] >> shift)]++;
+	}
+
+	for (; i < n_values; i++)
+		sub_histograms[values[i] >> shift]++;
+}
+
+ARV_CONVERT_TARGET_CLONES static void
+_accumulate_sum (const guint16 *values, guint n_values, guint max_value, guint64 *sum, guint64 *n_saturated)
+{
+	guint32 row_sum = 0;
+	guint32 row_n_saturated = 0;
+	guint i;
+
+	/* A row of 65536 16 bit values doesn't overflow 32 bit accumulators */
+	for (i = 0; i < n_values; i++) {
+		row_sum += values[i];
+		row_n_saturated += values[i] == max_value;
+	}
+
+	*sum += row_sum;
+	*n_saturated += row_n_saturated;
+}
+
+/* Computes a histogram of 2^log2_n_bins bins of the region, and optionally the sum of the values and the number
+ * of saturated ones */
+
+static gboolean
+_compute_histogram (ArvBuffer *buffer, gint x, gint y, gint width, gint height, guint subsampling,
+		    guint log2_n_bins, guint64 *histogram, guint64 *n_samples, guint *depth,
+		    guint64 *sum, guint64 *n_saturated, GError **error)
+{
+	ArvImageSampler sampler;
+	guint64 *sub_histograms;
+	guint n_bins;
+	guint n_rows;
+	guint shift;
+	guint i, j;
+
+	if (!_image_sampler_init (&sampler, buffer, x, y, width, height, subsampling, error))
+		return FALSE;
+
+	log2_n_bins = MIN (log2_n_bins, sampler.infos->depth);
+	n_bins = 1 << log2_n_bins;
+	shift = sampler.infos->depth - log2_n_bins;
+	sub_histograms = g_new0 (guint64, ARV_STATISTICS_N_SUB_HISTOGRAMS * n_bins);
+
+	n_rows = _image_sampler_get_n_rows (&sampler);
+	for (i = 0; i < n_rows; i++) {
+		const guint16 *values = _image_sampler_get_row (&sampler, i);
+		guint n_values = sampler.n_samples;
+
+		_accumulate_histogram (values, n_values, shift, n_bins, sub_histograms);
+
+		if (sum != NULL) {
+			/* Rows wider than 65536 pixels are accumulated by chunks */
+			for (j = 0; j < n_values; j += 65536)
+				_accumulate_sum (values + j, MIN (n_values - j, 65536), (1 << sampler.infos->depth) - 1,
+						 sum, n_saturated);
+		}
+	}
+
+	for (i = 0; i < n_bins; i++) {
+		histogram[i] = 0;
+		for (j = 0; j < ARV_STATISTICS_N_SUB_HISTOGRAMS; j++)
+			histogram[i] += sub_histograms[j * n_bins + i];
+	}
+
+	*n_samples = (guint64) n_rows * sampler.n_samples;
+	*depth = sampler.infos->depth;
+
+	g_free (sub_histograms);
+	_image_sampler_clear (&sampler);
+
+	return TRUE;
+}
+
+/**
+ * arv_buffer_compute_histogram:
+ * @buffer: a #ArvBuffer
+ * @x: horizontal offset of the region, in the image
+ * @y: vertical offset of the region, in the image
+ * @width: region width, or 0 for the rest of the image width
+ * @height: region height, or 0 for the rest of the image height
+ * @subsampling: the region is sampled every @subsampling pixels horizontally and vertically, 1 for all the pixels
+ * @histogram: (array length=n_bins) (out caller-allocates): histogram to fill
+ * @n_bins: number of histogram bins, a power of 2
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Computes the histogram of the pixel values in a region of the image held by @buffer. A pixel of value v and depth d
+ * is counted in the bin v * @n_bins / 2^d. If @n_bins is larger than 2^d, only the first 2^d bins are used, and the
+ * other ones are cleared. The Mono and Bayer 8 to 16 bit formats are supported, including the packed ones. The
+ * Bayer images are sampled without distinction of the colour channels.
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 0.8.11
+ */
+
+gboolean
+arv_buffer_compute_histogram (ArvBuffer *buffer, gint x, gint y, gint width, gint height, guint subsampling,
+			      guint64 *histogram, guint n_bins, GError **error)
+{
+	guint64 n_samples;
+	guint depth;
+	guint log2_n_bins;
+
+	g_return_val_if_fail (ARV_IS_BUFFER (buffer), FALSE);
+	g_return_val_if_fail (histogram != NULL, FALSE);
+	g_return_val_if_fail (n_bins > 0 && (n_bins & (n_bins - 1)) == 0, FALSE);
+
+	memset (histogram, 0, n_bins * sizeof (guint64));
+
+	log2_n_bins = g_bit_nth_lsf (n_bins, -1);
+
+	return _compute_histogram (buffer, x, y, width, height, subsampling, log2_n_bins, histogram, &n_samples,
+				   &depth, NULL, NULL, error);
+}
+
+/**
+ * arv_buffer_compute_statistics:
+ * @buffer: a #ArvBuffer
+ * @x: horizontal offset of the region, in the image
+ * @y: vertical offset of the region, in the image
+ * @width: region width, or 0 for the rest of the image width
+ * @height: region height, or 0 for the rest of the image height
+ * @subsampling: the region is sampled every @subsampling pixels horizontally and vertically, 1 for all the pixels
+ * @statistics: (out caller-allocates): statistics to fill
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Computes the mean, the saturation ratio and a 256 bin histogram of a region of the image held by @buffer, for
+ * host side auto exposure or image quality monitoring, in a single pass. The histogram bins hold the 8 most
+ * significant bits of the values, the percentiles given by arv_image_statistics_get_percentile() have a 1/256
+ * resolution.
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 0.8.11
+ */
+
+gboolean
+arv_buffer_compute_statistics (ArvBuffer *buffer, gint x, gint y, gint width, gint height, guint subsampling,
+			       ArvImageStatistics *statistics, GError **error)
+{
+	guint64 sum = 0;
+	guint64 n_saturated = 0;
+	guint64 n_samples;
+	guint depth;
+
+	g_return_val_if_fail (ARV_IS_BUFFER (buffer), FALSE);
+	g_return_val_if_fail (statistics != NULL, FALSE);
+
+	memset (statistics, 0, sizeof (ArvImageStatistics));
+
+	if (!_compute_histogram (buffer, x, y, width, height, subsampling, 8, statistics->histogram, &n_samples,
+				 &depth, &sum, &n_saturated, error))
+		return FALSE;
+
+	statistics->n_samples = n_samples;
+	statistics->depth = depth;
+	if (n_samples > 0) {
+		statistics->mean = (double) sum / (double) n_samples / (double) ((1 << depth) - 1);
+		statistics->saturation_ratio = (double) n_saturated / (double) n_samples;
+	}
+
+	return TRUE;
+}
+
+/**
+ * arv_image_statistics_get_percentile:
+ * @statistics: image statistics, filled by arv_buffer_compute_statistics()
+ * @percentile: percentile, between 0 and 100
+ *
+ * Returns: the value under which @percentile percent of the sampled pixels are, normalized to [0, 1], with a 1/256
+ * resolution.
+ *
+ * Since: 0.8.11
+ */
+
+double
+arv_image_statistics_get_percentile (const ArvImageStatistics *statistics, double percentile)
+{
+	guint64 threshold;
+	guint64 count = 0;
+	guint i;
+
+	g_return_val_if_fail (statistics != NULL, 0.0);
+
+	if (statistics->n_samples == 0)
+		return 0.0;
+
+	threshold = ceil (CLAMP (percentile, 0.0, 100.0) * statistics->n_samples / 100.0);
+
+	for (i = 0; i < 256; i++) {
+		count += statistics->histogram[i];
+		if (count >= threshold && count > 0)
+			return (i + 1) / 256.0;
+	}
+
+	return 1.0;
+}
@@ -0,0 +1,70 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2019 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel@gnome.org>
+ */
+
+#ifndef ARV_BUFFER_CONVERT_PRIVATE_H
+#define ARV_BUFFER_CONVERT_PRIVATE_H
+
+#if !defined (ARV_H_INSIDE) && !defined (ARAVIS_COMPILATION)
+#error "Only <arv.h> can be included directly."
+#endif
+
+#include <arvtypes.h>
+
+G_BEGIN_DECLS
+
+/* Instruction set used by the pixel format conversion kernels */
+
+typedef enum {
+	ARV_CONVERT_SIMD_NONE,
+	ARV_CONVERT_SIMD_SSE4_1,
+	ARV_CONVERT_SIMD_AVX2,
+	ARV_CONVERT_SIMD_NEON
+} ArvConvertSimd;
+
+ArvConvertSimd		arv_convert_get_simd		(void);
+gboolean		arv_convert_set_simd		(ArvConvertSimd simd);
+gboolean		arv_convert_is_simd_supported	(ArvConvertSimd simd);
+
+/* Unpacking of packed pixel groups to 16 bit values, used for the conversion during the frame reassembly */
+
+typedef struct {
+	ArvPixelFormat source;
+	ArvPixelFormat target;
+	/* A group is the smallest run of pixels starting on a byte boundary */
+	guint group_pixels;
+	guint group_bytes;
+
+	/*< private >*/
+	const void *infos;
+	const void *unpack;
+	void (*kernel) (void);
+	guint shift;
+} ArvConvertUnpacker;
+
+gboolean		arv_convert_unpacker_init	(ArvConvertUnpacker *unpacker,
+							 ArvPixelFormat source, ArvPixelFormat target);
+void			arv_convert_unpacker_unpack	(const ArvConvertUnpacker *unpacker,
+							 const guint8 *src, guint n_groups, guint16 *dst);
+
+G_END_DECLS
+
+#endif
@@ -29,33 +29,114 @@
 
 #include <arvbuffer.h>
 #include <arvgvspprivate.h>
+#include <arvbufferqueueprivate.h>
 
 G_BEGIN_DECLS
 
+/* Chunk index entry, data_offset is negative if the chunk data doesn't fit in the buffer */
+
 typedef struct {
-	size_t size;
-	gboolean is_preallocated;
-	unsigned char *data;
+	guint32 id;
+	guint32 size;
+	ptrdiff_t data_offset;
+} ArvBufferChunk;
 
-	void *user_data;
-	GDestroyNotify user_data_destroy_func;
+/* Multipart payload part, the parts are stored contiguously in the leader order */
 
-	ArvBufferStatus status;
+typedef struct {
+	size_t data_offset;
+	size_t size;
+	ArvBufferPartDataType data_type;
+	ArvPixelFormat pixel_format;
+	guint32 x_offset;
+	guint32 y_offset;
+	guint32 width;
+	guint32 height;
+} ArvBufferPart;
 
-	ArvBufferPayloadType payload_type;
+/* The fields written or read for each frame by the stream threads come first, the ones used by the stream queues
+ * and the reassembly in the first ARV_BUFFER_HOT_SIZE / 2 bytes, the other per frame ones in the next. The instance
+ * private data of a GType is only aligned as a malloc allocation, not on a cache line, so that these first
+ * ARV_BUFFER_HOT_SIZE bytes span two cache lines at best, three otherwise. The allocation details, the chunk and part
+ * tables and the user data are rarely used, and follow. */
 
-	guint32 chunk_endianness;
+#define ARV_BUFFER_HOT_SIZE	128
 
+typedef struct {
+	/* Link used by the lock-free stream queues */
+	ArvBufferQueueNode queue_node;
+	unsigned char *data;
+	/* Size of the received data, smaller than size for the variable size payloads */
+	size_t received_size;
 	guint64 frame_id;
 	guint64 timestamp_ns;
 	guint64 system_timestamp_ns;
+	ArvBufferStatus status;
+	ArvBufferPayloadType payload_type;
 
+	/* Logical payload size, at most the allocated capacity */
+	size_t size;
+	/* Device timestamp converted to the host monotonic time base */
+	guint64 host_timestamp_ns;
+	/* Monotonic time of the push to the output queue */
+	gint64 output_time_us;
 	guint32 x_offset;
 	guint32 y_offset;
 	guint32 width;
 	guint32 height;
-
 	ArvPixelFormat pixel_format;
+	/* CRC32C of the received data, computed by the stream thread, see ArvStream:checksum */
+	gboolean has_checksum;
+	guint32 checksum;
+	/* Allocated by a stream buffer pool */
+	gboolean is_pool_buffer;
+	/* Accounted in the memory budget of the stream owning it */
+	gboolean is_budgeted;
+
+	/* Network interface receive times of the leader and trailer packets, 0 if not available */
+	guint64 leader_hardware_timestamp_ns;
+	guint64 trailer_hardware_timestamp_ns;
+
+	/* Last region reported by the ready region stream callback */
+	size_t ready_offset;
+	size_t ready_size;
+
+	/* Data never received, set with the status of the incomplete frames */
+	ArvBufferMissingRange *missing_ranges;
+	guint n_missing_ranges;
+
+	guint32 chunk_endianness;
+
+	/* Chunk index, built on the first chunk access and invalidated when the buffer is filled again */
+	gboolean has_chunk_index;
+	ArvBufferChunk *chunks;
+	guint n_chunks;
+	guint n_allocated_chunks;
+
+	/* Chunk values decoded by the stream chunk plan at buffer completion */
+	ArvChunkValue *chunk_values;
+	guint n_chunk_values;
+	guint n_allocated_chunk_values;
+
+	/* Multipart payload parts */
+	ArvBufferPart *parts;
+	guint n_parts;
+	guint n_allocated_parts;
+
+	size_t capacity;
+	gboolean is_preallocated;
+	gboolean is_mapped;
+	/* Mapping containing the data, which may start after the mapping start for alignment */
+	void *mapped_data;
+	size_t mapped_size;
+	/* Memory file backing the mapping, -1 for anonymous memory */
+	int fd;
+	/* Data owner, and the address of the data for its device */
+	ArvBufferAllocator *allocator;
+	void *device_data;
+
+	void *user_data;
+	GDestroyNotify user_data_destroy_func;
 } ArvBufferPrivate;
 
 struct _ArvBuffer {
@@ -70,6 +151,12 @@ struct _ArvBufferClass {
 
 gboolean	arv_buffer_payload_type_has_chunks 	(ArvBufferPayloadType payload_type);
 gboolean	arv_buffer_payload_type_has_aoi 	(ArvBufferPayloadType payload_type);
+gboolean	arv_buffer_payload_type_is_variable_size	(ArvBufferPayloadType payload_type);
+void		arv_buffer_set_n_parts			(ArvBuffer *buffer, guint n_parts);
+ArvChunkValue *	arv_buffer_set_n_chunk_values		(ArvBuffer *buffer, guint n_values);
+void		arv_buffer_build_chunk_index		(ArvBuffer *buffer);
+void		arv_buffer_clear_missing_ranges		(ArvBuffer *buffer);
+void		arv_buffer_append_missing_range		(ArvBuffer *buffer, size_t offset, size_t size);
 
 G_END_DECLS
 
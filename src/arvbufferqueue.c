@@ -0,0 +1,255 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2019 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel@gnome.org>
+ */
+
+/*< private >
+ * SECTION: arvbufferqueue
+ * @short_description: Lock-free buffer queue
+ *
+ * An intrusive, unbounded, lock-free queue of #ArvBuffer, with a single consumer. The queue links are embedded in the
+ * buffers, so push and pop never allocate. Pushing is wait-free for a single producer and lock-free for several of
+ * them. The consumer only sleeps, on a futex on Linux, when the queue is empty, and producers only issue a wakeup
+ * when the consumer is actually waiting.
+ *
+ * The algorithm is Dmitry Vyukov's intrusive MPSC node-based queue.
+ */
+
+#include <arvbufferqueueprivate.h>
+#include <arvbufferprivate.h>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <limits.h>
+#include <time.h>
+#endif
+
+struct _ArvBufferQueue {
+	/* Last pushed node, producer side */
+	ArvBufferQueueNode *head;
+	/* Next node to pop, consumer side */
+	ArvBufferQueueNode *tail;
+	ArvBufferQueueNode stub;
+
+	gint length;
+
+	/* Incremented at each push, used as the futex word */
+	gint sequence;
+	gint n_waiters;
+
+#ifndef __linux__
+	GMutex mutex;
+	GCond cond;
+#endif
+};
+
+static void
+_push_node (ArvBufferQueue *queue, ArvBufferQueueNode *node)
+{
+	ArvBufferQueueNode *previous;
+
+	g_atomic_pointer_set (&node->next, NULL);
+
+	do {
+		previous = g_atomic_pointer_get (&queue->head);
+	} while (!g_atomic_pointer_compare_and_exchange (&queue->head, previous, node));
+
+	g_atomic_pointer_set (&previous->next, node);
+}
+
+static void
+_wait (ArvBufferQueue *queue, gint sequence, gint64 timeout_us)
+{
+#ifdef __linux__
+	struct timespec timeout;
+
+	if (timeout_us >= 0) {
+		timeout.tv_sec = timeout_us / 1000000;
+		timeout.tv_nsec = (timeout_us % 1000000) * 1000;
+	}
+
+	syscall (SYS_futex, &queue->sequence, FUTEX_WAIT_PRIVATE, sequence,
+		 timeout_us >= 0 ? &timeout : NULL, NULL, 0);
+#else
+	g_mutex_lock (&queue->mutex);
+	if (g_atomic_int_get (&queue->sequence) == sequence) {
+		if (timeout_us >= 0)
+			g_cond_wait_until (&queue->cond, &queue->mutex, g_get_monotonic_time () + timeout_us);
+		else
+			g_cond_wait (&queue->cond, &queue->mutex);
+	}
+	g_mutex_unlock (&queue->mutex);
+#endif
+}
+
+static void
+_wake (ArvBufferQueue *queue)
+{
+	g_atomic_int_inc (&queue->sequence);
+
+	if (G_LIKELY (g_atomic_int_get (&queue->n_waiters) == 0))
+		return;
+
+#ifdef __linux__
+	syscall (SYS_futex, &queue->sequence, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+#else
+	g_mutex_lock (&queue->mutex);
+	g_cond_broadcast (&queue->cond);
+	g_mutex_unlock (&queue->mutex);
+#endif
+}
+
+ArvBufferQueue *
+arv_buffer_queue_new (void)
+{
+	ArvBufferQueue *queue;
+
+	queue = g_new0 (ArvBufferQueue, 1);
+	queue->head = &queue->stub;
+	queue->tail = &queue->stub;
+
+#ifndef __linux__
+	g_mutex_init (&queue->mutex);
+	g_cond_init (&queue->cond);
+#endif
+
+	return queue;
+}
+
+/* The queue must be empty */
+
+void
+arv_buffer_queue_free (ArvBufferQueue *queue)
+{
+	if (queue == NULL)
+		return;
+
+#ifndef __linux__
+	g_mutex_clear (&queue->mutex);
+	g_cond_clear (&queue->cond);
+#endif
+
+	g_free (queue);
+}
+
+void
+arv_buffer_queue_push (ArvBufferQueue *queue, ArvBuffer *buffer)
+{
+	buffer->priv->queue_node.buffer = buffer;
+
+	_push_node (queue, &buffer->priv->queue_node);
+
+	g_atomic_int_inc (&queue->length);
+
+	_wake (queue);
+}
+
+/* Only one thread at a time may pop buffers */
+
+ArvBuffer *
+arv_buffer_queue_try_pop (ArvBufferQueue *queue)
+{
+	ArvBufferQueueNode *tail = queue->tail;
+	ArvBufferQueueNode *next = g_atomic_pointer_get (&tail->next);
+
+	if (tail == &queue->stub) {
+		if (next == NULL)
+			return NULL;
+		queue->tail = next;
+		tail = next;
+		next = g_atomic_pointer_get (&next->next);
+	}
+
+	if (next == NULL) {
+		/* A producer is between the head exchange and the link of the previous node, the queue looks empty
+		 * until it is done */
+		if (tail != g_atomic_pointer_get (&queue->head))
+			return NULL;
+
+		_push_node (queue, &queue->stub);
+
+		next = g_atomic_pointer_get (&tail->next);
+		if (next == NULL)
+			return NULL;
+	}
+
+	queue->tail = next;
+	g_atomic_int_add (&queue->length, -1);
+
+	return tail->buffer;
+}
+
+static ArvBuffer *
+_pop (ArvBufferQueue *queue, gint64 end_time_us)
+{
+	ArvBuffer *buffer;
+
+	for (;;) {
+		gint sequence;
+
+		buffer = arv_buffer_queue_try_pop (queue);
+		if (buffer != NULL)
+			return buffer;
+
+		sequence = g_atomic_int_get (&queue->sequence);
+		g_atomic_int_inc (&queue->n_waiters);
+
+		/* Check again, a push may have happened before the waiter registration */
+		buffer = arv_buffer_queue_try_pop (queue);
+		if (buffer == NULL) {
+			if (end_time_us < 0)
+				_wait (queue, sequence, -1);
+			else {
+				gint64 time_us = g_get_monotonic_time ();
+
+				if (time_us < end_time_us)
+					_wait (queue, sequence, end_time_us - time_us);
+			}
+		}
+
+		g_atomic_int_add (&queue->n_waiters, -1);
+
+		if (buffer != NULL)
+			return buffer;
+
+		if (end_time_us >= 0 && g_get_monotonic_time () >= end_time_us)
+			return arv_buffer_queue_try_pop (queue);
+	}
+}
+
+ArvBuffer *
+arv_buffer_queue_pop (ArvBufferQueue *queue)
+{
+	return _pop (queue, -1);
+}
+
+ArvBuffer *
+arv_buffer_queue_timeout_pop (ArvBufferQueue *queue, guint64 timeout_us)
+{
+	return _pop (queue, g_get_monotonic_time () + MIN (timeout_us, G_MAXINT64 / 2));
+}
+
+gint
+arv_buffer_queue_length (ArvBufferQueue *queue)
+{
+	return MAX (g_atomic_int_get (&queue->length), 0);
+}
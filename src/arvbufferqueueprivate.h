@@ -0,0 +1,56 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2019 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel@gnome.org>
+ */
+
+#ifndef ARV_BUFFER_QUEUE_PRIVATE_H
+#define ARV_BUFFER_QUEUE_PRIVATE_H
+
+#if !defined (ARV_H_INSIDE) && !defined (ARAVIS_COMPILATION)
+#error "Only <arv.h> can be included directly."
+#endif
+
+#include <arvbuffer.h>
+
+G_BEGIN_DECLS
+
+/* Queue link, embedded in the buffer private data. A buffer can only be in one queue at a time. */
+
+typedef struct _ArvBufferQueueNode ArvBufferQueueNode;
+
+struct _ArvBufferQueueNode {
+	ArvBufferQueueNode *next;
+	ArvBuffer *buffer;
+};
+
+typedef struct _ArvBufferQueue ArvBufferQueue;
+
+ArvBufferQueue *	arv_buffer_queue_new 		(void);
+void			arv_buffer_queue_free 		(ArvBufferQueue *queue);
+
+void			arv_buffer_queue_push		(ArvBufferQueue *queue, ArvBuffer *buffer);
+ArvBuffer *		arv_buffer_queue_pop		(ArvBufferQueue *queue);
+ArvBuffer *		arv_buffer_queue_try_pop	(ArvBufferQueue *queue);
+ArvBuffer *		arv_buffer_queue_timeout_pop	(ArvBufferQueue *queue, guint64 timeout_us);
+gint			arv_buffer_queue_length		(ArvBufferQueue *queue);
+
+G_END_DECLS
+
+#endif
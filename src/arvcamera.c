@@ -53,11 +53,13 @@
 #include <arvbuffer.h>
 #include <arvgc.h>
 #include <arvgvdevice.h>
+#include <arvdeviceprivate.h>
 #if ARAVIS_HAS_USB
 #include <arvuvdevice.h>
 #endif
 #include <arvenums.h>
 #include <arvstr.h>
+#include <math.h>
 
 static void arv_camera_get_integer_bounds_as_gint (ArvCamera *camera, const char *feature, gint *min, gint *max, GError **error);
 static void arv_camera_get_integer_bounds_as_guint (ArvCamera *camera, const char *feature, guint *min, guint *max, GError **error);
@@ -118,6 +120,24 @@ typedef struct {
 	gboolean has_acquisition_frame_rate_auto;
 	gboolean has_acquisition_frame_rate_enabled;
 
+	/* Nodes of the per frame controls, resolved with the vendor quirks at construction. NULL if not available,
+	 * or if the vendor requires more than a single feature access. */
+	ArvGcNode *exposure_time_node;
+	ArvGcNode *gain_node;
+	ArvGcNode *frame_rate_node;
+
+	/* Stream and buffers kept between burst acquisitions */
+	ArvStream *burst_stream;
+	size_t burst_payload;
+
+	/* Host side auto exposure, retrieved bounds of the controls when enabled */
+	double host_ae_target;
+	double host_ae_exposure_min;
+	double host_ae_exposure_max;
+	double host_ae_gain_min;
+	double host_ae_gain_max;
+	gboolean host_ae_use_gain;
+
 	GError *init_error;
 } ArvCameraPrivate;
 
@@ -134,6 +154,36 @@ enum
 	PROP_CAMERA_DEVICE
 };
 
+/* Direct value access to the float or integer nodes resolved at construction */
+
+static ArvGcNode *
+_resolve_control_node (ArvCameraPrivate *priv, const char *feature, GType node_type)
+{
+	ArvGcNode *node;
+
+	node = arv_device_get_feature (priv->device, feature);
+
+	return G_TYPE_CHECK_INSTANCE_TYPE (node, node_type) ? node : NULL;
+}
+
+static void
+_set_control_node_value (ArvGcNode *node, double value, GError **error)
+{
+	if (ARV_IS_GC_FLOAT (node))
+		arv_gc_float_set_value (ARV_GC_FLOAT (node), value, error);
+	else
+		arv_gc_integer_set_value (ARV_GC_INTEGER (node), value, error);
+}
+
+static double
+_get_control_node_value (ArvGcNode *node, GError **error)
+{
+	if (ARV_IS_GC_FLOAT (node))
+		return arv_gc_float_get_value (ARV_GC_FLOAT (node), error);
+
+	return arv_gc_integer_get_value (ARV_GC_INTEGER (node), error);
+}
+
 /**
  * arv_camera_create_stream:
  * @camera: a #ArvCamera
@@ -822,6 +872,191 @@ arv_camera_acquisition (ArvCamera *camera, guint64 timeout, GError **error)
 	return buffer;
 }
 
+/* Creates the burst stream on the first use, or after a payload size change, and fills its input queue with
+ * n_buffers buffers. */
+
+static gboolean
+_prepare_burst_stream (ArvCamera *camera, guint n_buffers, GError **error)
+{
+	ArvCameraPrivate *priv = arv_camera_get_instance_private (camera);
+	GError *local_error = NULL;
+	ArvBuffer *buffer;
+	gint n_input_buffers;
+	gint payload;
+
+	payload = arv_camera_get_payload (camera, &local_error);
+	if (local_error != NULL) {
+		g_propagate_error (error, local_error);
+		return FALSE;
+	}
+
+	if (priv->burst_stream != NULL && priv->burst_payload != (size_t) payload)
+		g_clear_object (&priv->burst_stream);
+
+	if (priv->burst_stream == NULL) {
+		priv->burst_stream = arv_camera_create_stream (camera, NULL, NULL, &local_error);
+		if (local_error != NULL) {
+			g_clear_object (&priv->burst_stream);
+			g_propagate_error (error, local_error);
+			return FALSE;
+		}
+		priv->burst_payload = payload;
+	}
+
+	/* Frames acquired after the end of the previous burst */
+	while ((buffer = arv_stream_try_pop_buffer (priv->burst_stream)) != NULL)
+		arv_stream_push_buffer (priv->burst_stream, buffer);
+
+	arv_stream_get_n_buffers (priv->burst_stream, &n_input_buffers, NULL);
+	for (; n_input_buffers < (gint) n_buffers; n_input_buffers++)
+		arv_stream_push_buffer (priv->burst_stream, arv_buffer_new (payload, NULL));
+
+	return TRUE;
+}
+
+static ArvBuffer *
+_pop_burst_buffer (ArvStream *stream, guint64 timeout)
+{
+	if (timeout > 0)
+		return arv_stream_timeout_pop_buffer (stream, timeout);
+
+	return arv_stream_pop_buffer (stream);
+}
+
+/**
+ * arv_camera_acquire_burst:
+ * @camera: a #ArvCamera
+ * @n_frames: number of frames
+ * @settings: (array length=n_frames) (allow-none): per frame settings, %NULL to keep the current ones
+ * @timeout: per frame timeout in µs. Zero means no timeout.
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Acquires a burst of @n_frames images. Unlike arv_camera_acquisition(), the stream and its buffers are created once
+ * and kept by @camera for the following bursts, which avoids their setup cost for each frame.
+ *
+ * Without @settings, the camera is configured in MultiFrame mode when it has an AcquisitionFrameCount feature, and in
+ * continuous mode otherwise. With @settings, for exposure bracketing for example, the camera is left configured for
+ * software triggers, and each frame is triggered after the batched write of its settings, so that they apply to
+ * this frame. This requires a TriggerSoftware feature.
+ *
+ * The returned buffers may have a failed status, the caller should check it. They can be given back for the next
+ * bursts using arv_camera_release_burst().
+ *
+ * Returns: (transfer full) (element-type ArvBuffer): the acquired buffers, in acquisition order, %NULL on error.
+ *
+ * Since: 0.8.11
+ */
+
+GPtrArray *
+arv_camera_acquire_burst (ArvCamera *camera, guint n_frames, const ArvCameraFrameSettings *settings,
+			  guint64 timeout, GError **error)
+{
+	ArvCameraPrivate *priv = arv_camera_get_instance_private (camera);
+	GError *local_error = NULL;
+	GPtrArray *buffers;
+	ArvBuffer *buffer;
+	guint i;
+
+	g_return_val_if_fail (ARV_IS_CAMERA (camera), NULL);
+	g_return_val_if_fail (n_frames > 0, NULL);
+
+	if (settings != NULL &&
+	    !ARV_IS_GC_COMMAND (arv_device_get_feature (priv->device, "TriggerSoftware"))) {
+		g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_FEATURE_NOT_FOUND,
+			     "Per frame burst settings require a 'TriggerSoftware' feature");
+		return NULL;
+	}
+
+	if (!_prepare_burst_stream (camera, n_frames, error))
+		return NULL;
+
+	buffers = g_ptr_array_new_full (n_frames, g_object_unref);
+
+	if (settings != NULL) {
+		arv_camera_set_trigger (camera, "Software", &local_error);
+		if (local_error == NULL)
+			arv_camera_set_acquisition_mode (camera, ARV_ACQUISITION_MODE_CONTINUOUS, &local_error);
+	} else if (ARV_IS_GC_INTEGER (arv_device_get_feature (priv->device, "AcquisitionFrameCount"))) {
+		arv_camera_set_acquisition_mode (camera, ARV_ACQUISITION_MODE_MULTI_FRAME, &local_error);
+		if (local_error == NULL)
+			arv_camera_set_frame_count (camera, n_frames, &local_error);
+	} else
+		arv_camera_set_acquisition_mode (camera, ARV_ACQUISITION_MODE_CONTINUOUS, &local_error);
+
+	if (local_error == NULL)
+		arv_camera_start_acquisition (camera, &local_error);
+
+	for (i = 0; i < n_frames && local_error == NULL; i++) {
+		if (settings != NULL) {
+			arv_camera_begin_batch (camera);
+			arv_camera_set_exposure_time (camera, settings[i].exposure_time_us, &local_error);
+			if (local_error == NULL)
+				arv_camera_set_gain (camera, settings[i].gain, &local_error);
+			if (local_error == NULL)
+				arv_camera_commit_batch (camera, &local_error);
+			else
+				arv_camera_commit_batch (camera, NULL);
+			if (local_error == NULL)
+				arv_camera_software_trigger (camera, &local_error);
+			if (local_error != NULL)
+				break;
+		}
+
+		buffer = _pop_burst_buffer (priv->burst_stream, timeout);
+		if (buffer == NULL) {
+			g_set_error (&local_error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_TIMEOUT,
+				     "Timeout while waiting for frame %u of the burst", i);
+			break;
+		}
+
+		g_ptr_array_add (buffers, buffer);
+	}
+
+	arv_camera_stop_acquisition (camera, local_error == NULL ? &local_error : NULL);
+
+	if (local_error != NULL) {
+		arv_camera_release_burst (camera, buffers);
+		g_propagate_error (error, local_error);
+		return NULL;
+	}
+
+	return buffers;
+}
+
+/**
+ * arv_camera_release_burst:
+ * @camera: a #ArvCamera
+ * @buffers: (transfer full) (element-type ArvBuffer): buffers returned by arv_camera_acquire_burst()
+ *
+ * Gives the buffers of a burst back to @camera, for their reuse by the next bursts, and frees @buffers.
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_camera_release_burst (ArvCamera *camera, GPtrArray *buffers)
+{
+	ArvCameraPrivate *priv = arv_camera_get_instance_private (camera);
+	guint i;
+
+	g_return_if_fail (ARV_IS_CAMERA (camera));
+
+	if (buffers == NULL)
+		return;
+
+	for (i = 0; i < buffers->len; i++) {
+		ArvBuffer *buffer = g_ptr_array_index (buffers, i);
+		size_t size = 0;
+
+		/* Buffers of a previous payload size are freed */
+		arv_buffer_get_data (buffer, &size);
+		if (priv->burst_stream != NULL && size == priv->burst_payload)
+			arv_stream_push_buffer (priv->burst_stream, g_object_ref (buffer));
+	}
+
+	g_ptr_array_unref (buffers);
+}
+
 /*
  * arv_camera_set_acquisition_mode:
  * @camera: a #ArvCamera
@@ -932,6 +1167,20 @@ arv_camera_get_frame_count_bounds (ArvCamera *camera, gint64 *min, gint64 *max,
 	arv_camera_get_integer_bounds (camera, "AcquisitionFrameCount", min, max, error);
 }
 
+static void
+_set_frame_rate_value (ArvCamera *camera, double frame_rate, GError **error)
+{
+	ArvCameraPrivate *priv = arv_camera_get_instance_private (camera);
+
+	if (priv->frame_rate_node != NULL)
+		_set_control_node_value (priv->frame_rate_node, frame_rate, error);
+	else
+		arv_camera_set_float (camera,
+				      priv->vendor == ARV_CAMERA_VENDOR_PROSILICA || !priv->has_acquisition_frame_rate ?
+				      "AcquisitionFrameRateAbs" :
+				      "AcquisitionFrameRate", frame_rate, error);
+}
+
 /**
  * arv_camera_set_frame_rate:
  * @camera: a #ArvCamera
@@ -992,17 +1241,14 @@ arv_camera_set_frame_rate (ArvCamera *camera, double frame_rate, GError **error)
 			if (local_error == NULL)
 				arv_camera_set_boolean (camera, "AcquisitionFrameRateEnable", TRUE, &local_error);
 			if (local_error == NULL)
-				arv_camera_set_float (camera,
-						      priv->has_acquisition_frame_rate ?
-						      "AcquisitionFrameRate":
-						      "AcquisitionFrameRateAbs", frame_rate, &local_error);
+				_set_frame_rate_value (camera, frame_rate, &local_error);
 			break;
 		case ARV_CAMERA_VENDOR_PROSILICA:
 			arv_camera_set_string (camera, "TriggerSelector", "FrameStart", &local_error);
 			if (local_error == NULL)
 				arv_camera_set_string (camera, "TriggerMode", "Off", &local_error);
 			if (local_error == NULL)
-				arv_camera_set_float (camera, "AcquisitionFrameRateAbs", frame_rate, &local_error);
+				_set_frame_rate_value (camera, frame_rate, &local_error);
 			break;
 		case ARV_CAMERA_VENDOR_TIS:
 			arv_camera_set_string (camera, "TriggerSelector", "FrameStart", &local_error);
@@ -1057,10 +1303,7 @@ arv_camera_set_frame_rate (ArvCamera *camera, double frame_rate, GError **error)
 			if (local_error == NULL)
 				arv_camera_set_string (camera, "TriggerMode", "Off", &local_error);
 			if (local_error == NULL)
-				arv_camera_set_float (camera,
-						      priv->has_acquisition_frame_rate ?
-						      "AcquisitionFrameRate":
-						      "AcquisitionFrameRateAbs", frame_rate, &local_error);
+				_set_frame_rate_value (camera, frame_rate, &local_error);
 			if (local_error == NULL) {
 				if (arv_camera_is_feature_available (camera, "AcquisitionFrameRateEnable", &local_error)) {
 					if (local_error == NULL)
@@ -1092,6 +1335,9 @@ arv_camera_get_frame_rate (ArvCamera *camera, GError **error)
 
 	g_return_val_if_fail (ARV_IS_CAMERA (camera), 0);
 
+	if (priv->frame_rate_node != NULL)
+		return _get_control_node_value (priv->frame_rate_node, error);
+
 	switch (priv->vendor) {
 		case ARV_CAMERA_VENDOR_PROSILICA:
 			return arv_camera_get_float (camera, "AcquisitionFrameRateAbs", error);
@@ -1402,6 +1648,13 @@ arv_camera_set_exposure_time (ArvCamera *camera, double exposure_time_us, GError
 	if (exposure_time_us <= 0)
 		return;
 
+	if (priv->exposure_time_node != NULL &&
+	    priv->series != ARV_CAMERA_SERIES_BASLER_SCOUT &&
+	    priv->series != ARV_CAMERA_SERIES_MATRIX_VISION) {
+		_set_control_node_value (priv->exposure_time_node, exposure_time_us, error);
+		return;
+	}
+
 	switch (priv->series) {
 		case ARV_CAMERA_SERIES_BASLER_SCOUT:
 			arv_camera_set_float (camera, "ExposureTimeBaseAbs", exposure_time_us, &local_error);
@@ -1449,6 +1702,9 @@ arv_camera_get_exposure_time (ArvCamera *camera, GError **error)
 
 	g_return_val_if_fail (ARV_IS_CAMERA (camera), 0.0);
 
+	if (priv->exposure_time_node != NULL)
+		return _get_control_node_value (priv->exposure_time_node, error);
+
 	switch (priv->series) {
 		case ARV_CAMERA_SERIES_XIMEA:
 			return arv_camera_get_integer (camera,"ExposureTime", error);
@@ -1586,6 +1842,11 @@ arv_camera_set_gain (ArvCamera *camera, double gain, GError **error)
 	if (gain < 0)
 		return;
 
+	if (priv->gain_node != NULL) {
+		_set_control_node_value (priv->gain_node, gain, error);
+		return;
+	}
+
 	if (priv->has_gain)
 		arv_camera_set_float (camera, "Gain", gain, error);
 	else {
@@ -1613,6 +1874,9 @@ arv_camera_get_gain (ArvCamera *camera, GError **error)
 
 	g_return_val_if_fail (ARV_IS_CAMERA (camera), 0.0);
 
+	if (priv->gain_node != NULL)
+		return _get_control_node_value (priv->gain_node, error);
+
 	if (priv->has_gain)
 		return arv_camera_get_float (camera, "Gain", error);
 	else if (priv->gain_raw_as_float)
@@ -1838,6 +2102,164 @@ arv_camera_is_gain_available (ArvCamera *camera, GError **error)
 	return arv_camera_is_feature_available (camera, "GainRaw", error);
 }
 
+/* Number of sampled pixels per frame, which keeps the statistics well under 0.2 ms */
+#define ARV_CAMERA_HOST_AE_N_SAMPLES		16384
+/* Exposure ratio under which the controls are not written */
+#define ARV_CAMERA_HOST_AE_DEAD_BAND		0.02
+/* Maximum exposure ratio of a single step */
+#define ARV_CAMERA_HOST_AE_MAX_STEP		4.0
+#define ARV_CAMERA_HOST_AE_SATURATION_MAX	0.01
+
+/**
+ * arv_camera_set_host_auto_exposure:
+ * @camera: a #ArvCamera
+ * @target: target mean pixel value, normalized to ]0, 1[, or 0 to disable
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Enables a host side auto exposure controller, for the cameras without ExposureAuto feature. The controller is
+ * run for each frame passed to arv_camera_update_host_auto_exposure(). It adjusts the exposure time first, then the
+ * gain once the exposure time reaches its bounds. The gain is only used if the camera has a Gain feature, which is
+ * assumed to be in dB as specified by the SFNC. The bounds of the controls are retrieved by this function.
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_camera_set_host_auto_exposure (ArvCamera *camera, double target, GError **error)
+{
+	ArvCameraPrivate *priv = arv_camera_get_instance_private (camera);
+	GError *local_error = NULL;
+
+	g_return_if_fail (ARV_IS_CAMERA (camera));
+	g_return_if_fail (target >= 0.0 && target < 1.0);
+
+	priv->host_ae_target = 0.0;
+
+	if (target <= 0.0)
+		return;
+
+	arv_camera_get_exposure_time_bounds (camera, &priv->host_ae_exposure_min, &priv->host_ae_exposure_max,
+					     &local_error);
+	if (local_error != NULL) {
+		g_propagate_error (error, local_error);
+		return;
+	}
+
+	priv->host_ae_use_gain = priv->has_gain && arv_camera_is_gain_available (camera, NULL);
+	if (priv->host_ae_use_gain) {
+		arv_camera_get_gain_bounds (camera, &priv->host_ae_gain_min, &priv->host_ae_gain_max, &local_error);
+		if (local_error != NULL) {
+			g_propagate_error (error, local_error);
+			return;
+		}
+	}
+
+	priv->host_ae_target = target;
+}
+
+/**
+ * arv_camera_get_host_auto_exposure:
+ * @camera: a #ArvCamera
+ *
+ * Returns: the target mean pixel value of the host side auto exposure, 0 if disabled.
+ *
+ * Since: 0.8.11
+ */
+
+double
+arv_camera_get_host_auto_exposure (ArvCamera *camera)
+{
+	ArvCameraPrivate *priv = arv_camera_get_instance_private (camera);
+
+	g_return_val_if_fail (ARV_IS_CAMERA (camera), 0.0);
+
+	return priv->host_ae_target;
+}
+
+/**
+ * arv_camera_update_host_auto_exposure:
+ * @camera: a #ArvCamera
+ * @buffer: a #ArvBuffer, acquired from @camera
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Runs one step of the host side auto exposure controller, see arv_camera_set_host_auto_exposure(). The mean of
+ * the image held by @buffer is measured on a subsampled grid, and the exposure is scaled by the square root of the
+ * ratio between the target and the measured mean, which damps the oscillations due to the latency between the
+ * control writes and the first frame using them. The exposure is also reduced if more than 1% of the pixels are
+ * saturated. Incomplete buffers are ignored.
+ *
+ * This function must be called from a single thread, usually the one consuming the buffers.
+ *
+ * Returns: %TRUE if the controls were changed.
+ *
+ * Since: 0.8.11
+ */
+
+gboolean
+arv_camera_update_host_auto_exposure (ArvCamera *camera, ArvBuffer *buffer, GError **error)
+{
+	ArvCameraPrivate *priv = arv_camera_get_instance_private (camera);
+	ArvImageStatistics statistics;
+	GError *local_error = NULL;
+	double exposure, new_exposure;
+	double gain_db = 0.0, new_gain_db = 0.0;
+	double total, ratio;
+	double gain_linear_min;
+	guint64 n_pixels;
+	guint subsampling;
+
+	g_return_val_if_fail (ARV_IS_CAMERA (camera), FALSE);
+	g_return_val_if_fail (ARV_IS_BUFFER (buffer), FALSE);
+
+	if (priv->host_ae_target <= 0.0 || arv_buffer_get_status (buffer) != ARV_BUFFER_STATUS_SUCCESS)
+		return FALSE;
+
+	n_pixels = (guint64) MAX (arv_buffer_get_image_width (buffer), 0) * MAX (arv_buffer_get_image_height (buffer), 0);
+	subsampling = MAX (1, (guint) sqrt ((double) n_pixels / ARV_CAMERA_HOST_AE_N_SAMPLES));
+
+	if (!arv_buffer_compute_statistics (buffer, 0, 0, 0, 0, subsampling, &statistics, error) ||
+	    statistics.n_samples == 0)
+		return FALSE;
+
+	ratio = sqrt (priv->host_ae_target / MAX (statistics.mean, 1.0 / 256.0));
+	if (statistics.saturation_ratio > ARV_CAMERA_HOST_AE_SATURATION_MAX)
+		ratio = MIN (ratio, 0.5);
+	ratio = CLAMP (ratio, 1.0 / ARV_CAMERA_HOST_AE_MAX_STEP, ARV_CAMERA_HOST_AE_MAX_STEP);
+
+	if (fabs (ratio - 1.0) < ARV_CAMERA_HOST_AE_DEAD_BAND)
+		return FALSE;
+
+	exposure = arv_camera_get_exposure_time (camera, &local_error);
+	if (local_error == NULL && priv->host_ae_use_gain)
+		gain_db = arv_camera_get_gain (camera, &local_error);
+	if (local_error != NULL) {
+		g_propagate_error (error, local_error);
+		return FALSE;
+	}
+
+	/* The exposure time is used up to its bounds before the gain */
+	total = exposure * (priv->host_ae_use_gain ? pow (10.0, gain_db / 20.0) : 1.0) * ratio;
+	gain_linear_min = priv->host_ae_use_gain ? pow (10.0, priv->host_ae_gain_min / 20.0) : 1.0;
+	new_exposure = CLAMP (total / gain_linear_min, priv->host_ae_exposure_min, priv->host_ae_exposure_max);
+	if (priv->host_ae_use_gain)
+		new_gain_db = CLAMP (20.0 * log10 (total / new_exposure), priv->host_ae_gain_min,
+				     priv->host_ae_gain_max);
+
+	if (fabs (new_exposure - exposure) <= ARV_CAMERA_HOST_AE_DEAD_BAND * exposure &&
+	    (!priv->host_ae_use_gain || fabs (new_gain_db - gain_db) < 0.1))
+		return FALSE;
+
+	arv_camera_set_exposure_time (camera, new_exposure, &local_error);
+	if (local_error == NULL && priv->host_ae_use_gain)
+		arv_camera_set_gain (camera, new_gain_db, &local_error);
+	if (local_error != NULL) {
+		g_propagate_error (error, local_error);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
 /**
  * arv_camera_is_gain_auto_available:
  * @camera: a #ArvCamera
@@ -1906,6 +2328,47 @@ arv_camera_execute_command (ArvCamera *camera, const char *feature, GError **err
 	arv_device_execute_command (priv->device, feature, error);
 }
 
+/**
+ * arv_camera_begin_batch:
+ * @camera: a #ArvCamera
+ *
+ * Starts queuing the register writes, until arv_camera_commit_batch() is called. The feature setters can then be used
+ * as usual, and the whole configuration is sent to the device at once. See arv_device_begin_batch().
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_camera_begin_batch (ArvCamera *camera)
+{
+	ArvCameraPrivate *priv = arv_camera_get_instance_private (camera);
+
+	g_return_if_fail (ARV_IS_CAMERA (camera));
+
+	arv_device_begin_batch (priv->device);
+}
+
+/**
+ * arv_camera_commit_batch:
+ * @camera: a #ArvCamera
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Sends the register writes queued since arv_camera_begin_batch(). On error, the message gives the index and the
+ * address of the failed write.
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_camera_commit_batch (ArvCamera *camera, GError **error)
+{
+	ArvCameraPrivate *priv = arv_camera_get_instance_private (camera);
+
+	g_return_if_fail (ARV_IS_CAMERA (camera));
+
+	arv_device_commit_batch (priv->device, NULL, error);
+}
+
 /**
  * arv_camera_set_boolean:
  * @camera: a #ArvCamera
@@ -2253,44 +2716,485 @@ arv_camera_get_float_bounds (ArvCamera *camera, const char *feature, double *min
 }
 
 /**
- * arv_camera_dup_available_enumerations:
+ * arv_camera_execute_command_async:
  * @camera: a #ArvCamera
  * @feature: feature name
- * @n_values: placeholder for the number of returned values
- * @error: a #GError placeholder, %NULL to ignore
+ * @cancellable: (nullable): a #GCancellable
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the command is executed
+ * @user_data: (closure): the data to pass to @callback
  *
- * Get all the available values of @feature, as 64 bit integers.
- *
- * Returns: (array length=n_values) (transfer container): a newly created array of integers, which must freed after use using g_free, or
- * NULL on error.
+ * Asynchronous version of arv_camera_execute_command(). See arv_device_execute_command_async().
  *
- * Since: 0.8.0
+ * Since: 0.8.11
  */
 
-gint64 *
-arv_camera_dup_available_enumerations (ArvCamera *camera, const char *feature, guint *n_values, GError **error)
+void
+arv_camera_execute_command_async (ArvCamera *camera, const char *feature,
+				  GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
 {
 	ArvCameraPrivate *priv = arv_camera_get_instance_private (camera);
 
-	if (n_values != NULL)
-		*n_values = 0;
-
-	g_return_val_if_fail (ARV_IS_CAMERA (camera), NULL);
+	g_return_if_fail (ARV_IS_CAMERA (camera));
 
-	return arv_device_dup_available_enumeration_feature_values (priv->device, feature, n_values, error);
+	arv_device_feature_request_async (priv->device, camera, arv_camera_execute_command_async,
+					  ARV_DEVICE_FEATURE_REQUEST_EXECUTE_COMMAND, feature, NULL,
+					  cancellable, callback, user_data);
 }
 
 /**
- * arv_camera_dup_available_enumerations_as_strings:
+ * arv_camera_execute_command_finish:
  * @camera: a #ArvCamera
- * @feature: feature name
- * @n_values: placeholder for the number of returned values
+ * @result: a #GAsyncResult
  * @error: a #GError placeholder, %NULL to ignore
  *
- * Get all the available values of @feature, as strings.
+ * Finishes an operation started with arv_camera_execute_command_async().
  *
- * Returns: (array length=n_values) (transfer container): a newly created array of const strings, which must freed after use using g_free,
- * or %NULL on error.
+ * Returns: %TRUE on success.
+ *
+ * Since: 0.8.11
+ */
+
+gboolean
+arv_camera_execute_command_finish (ArvCamera *camera, GAsyncResult *result, GError **error)
+{
+	return arv_device_feature_request_finish (result, camera, arv_camera_execute_command_async, NULL, error);
+}
+
+/**
+ * arv_camera_set_boolean_async:
+ * @camera: a #ArvCamera
+ * @feature: feature name
+ * @value: new feature value
+ * @cancellable: (nullable): a #GCancellable
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the value is set
+ * @user_data: (closure): the data to pass to @callback
+ *
+ * Asynchronous version of arv_camera_set_boolean(). See arv_device_execute_command_async().
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_camera_set_boolean_async (ArvCamera *camera, const char *feature, gboolean value,
+			      GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+	ArvCameraPrivate *priv = arv_camera_get_instance_private (camera);
+	ArvDeviceFeatureValue request_value = {0};
+
+	g_return_if_fail (ARV_IS_CAMERA (camera));
+
+	request_value.v_int64 = value;
+
+	arv_device_feature_request_async (priv->device, camera, arv_camera_set_boolean_async,
+					  ARV_DEVICE_FEATURE_REQUEST_SET_BOOLEAN, feature, &request_value,
+					  cancellable, callback, user_data);
+}
+
+/**
+ * arv_camera_set_boolean_finish:
+ * @camera: a #ArvCamera
+ * @result: a #GAsyncResult
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Finishes an operation started with arv_camera_set_boolean_async().
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 0.8.11
+ */
+
+gboolean
+arv_camera_set_boolean_finish (ArvCamera *camera, GAsyncResult *result, GError **error)
+{
+	return arv_device_feature_request_finish (result, camera, arv_camera_set_boolean_async, NULL, error);
+}
+
+/**
+ * arv_camera_get_boolean_async:
+ * @camera: a #ArvCamera
+ * @feature: feature name
+ * @cancellable: (nullable): a #GCancellable
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the value is read
+ * @user_data: (closure): the data to pass to @callback
+ *
+ * Asynchronous version of arv_camera_get_boolean(). See arv_device_execute_command_async().
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_camera_get_boolean_async (ArvCamera *camera, const char *feature,
+			      GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+	ArvCameraPrivate *priv = arv_camera_get_instance_private (camera);
+
+	g_return_if_fail (ARV_IS_CAMERA (camera));
+
+	arv_device_feature_request_async (priv->device, camera, arv_camera_get_boolean_async,
+					  ARV_DEVICE_FEATURE_REQUEST_GET_BOOLEAN, feature, NULL,
+					  cancellable, callback, user_data);
+}
+
+/**
+ * arv_camera_get_boolean_finish:
+ * @camera: a #ArvCamera
+ * @result: a #GAsyncResult
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Finishes an operation started with arv_camera_get_boolean_async().
+ *
+ * Returns: the feature value, %FALSE on error.
+ *
+ * Since: 0.8.11
+ */
+
+gboolean
+arv_camera_get_boolean_finish (ArvCamera *camera, GAsyncResult *result, GError **error)
+{
+	ArvDeviceFeatureValue value = {0};
+
+	if (!arv_device_feature_request_finish (result, camera, arv_camera_get_boolean_async, &value, error))
+		return FALSE;
+
+	return value.v_int64 != 0;
+}
+
+/**
+ * arv_camera_set_string_async:
+ * @camera: a #ArvCamera
+ * @feature: feature name
+ * @value: new feature value
+ * @cancellable: (nullable): a #GCancellable
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the value is set
+ * @user_data: (closure): the data to pass to @callback
+ *
+ * Asynchronous version of arv_camera_set_string(). See arv_device_execute_command_async().
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_camera_set_string_async (ArvCamera *camera, const char *feature, const char *value,
+			     GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+	ArvCameraPrivate *priv = arv_camera_get_instance_private (camera);
+	ArvDeviceFeatureValue request_value = {0};
+
+	g_return_if_fail (ARV_IS_CAMERA (camera));
+
+	request_value.v_string = (char *) value;
+
+	arv_device_feature_request_async (priv->device, camera, arv_camera_set_string_async,
+					  ARV_DEVICE_FEATURE_REQUEST_SET_STRING, feature, &request_value,
+					  cancellable, callback, user_data);
+}
+
+/**
+ * arv_camera_set_string_finish:
+ * @camera: a #ArvCamera
+ * @result: a #GAsyncResult
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Finishes an operation started with arv_camera_set_string_async().
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 0.8.11
+ */
+
+gboolean
+arv_camera_set_string_finish (ArvCamera *camera, GAsyncResult *result, GError **error)
+{
+	return arv_device_feature_request_finish (result, camera, arv_camera_set_string_async, NULL, error);
+}
+
+/**
+ * arv_camera_get_string_async:
+ * @camera: a #ArvCamera
+ * @feature: feature name
+ * @cancellable: (nullable): a #GCancellable
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the value is read
+ * @user_data: (closure): the data to pass to @callback
+ *
+ * Asynchronous version of arv_camera_get_string(). See arv_device_execute_command_async().
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_camera_get_string_async (ArvCamera *camera, const char *feature,
+			     GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+	ArvCameraPrivate *priv = arv_camera_get_instance_private (camera);
+
+	g_return_if_fail (ARV_IS_CAMERA (camera));
+
+	arv_device_feature_request_async (priv->device, camera, arv_camera_get_string_async,
+					  ARV_DEVICE_FEATURE_REQUEST_GET_STRING, feature, NULL,
+					  cancellable, callback, user_data);
+}
+
+/**
+ * arv_camera_get_string_finish:
+ * @camera: a #ArvCamera
+ * @result: a #GAsyncResult
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Finishes an operation started with arv_camera_get_string_async().
+ *
+ * Returns: (transfer full): a copy of the feature value, %NULL on error.
+ *
+ * Since: 0.8.11
+ */
+
+char *
+arv_camera_get_string_finish (ArvCamera *camera, GAsyncResult *result, GError **error)
+{
+	ArvDeviceFeatureValue value = {0};
+
+	if (!arv_device_feature_request_finish (result, camera, arv_camera_get_string_async, &value, error))
+		return NULL;
+
+	return value.v_string;
+}
+
+/**
+ * arv_camera_set_integer_async:
+ * @camera: a #ArvCamera
+ * @feature: feature name
+ * @value: new feature value
+ * @cancellable: (nullable): a #GCancellable
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the value is set
+ * @user_data: (closure): the data to pass to @callback
+ *
+ * Asynchronous version of arv_camera_set_integer(). See arv_device_execute_command_async().
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_camera_set_integer_async (ArvCamera *camera, const char *feature, gint64 value,
+			      GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+	ArvCameraPrivate *priv = arv_camera_get_instance_private (camera);
+	ArvDeviceFeatureValue request_value = {0};
+
+	g_return_if_fail (ARV_IS_CAMERA (camera));
+
+	request_value.v_int64 = value;
+
+	arv_device_feature_request_async (priv->device, camera, arv_camera_set_integer_async,
+					  ARV_DEVICE_FEATURE_REQUEST_SET_INTEGER, feature, &request_value,
+					  cancellable, callback, user_data);
+}
+
+/**
+ * arv_camera_set_integer_finish:
+ * @camera: a #ArvCamera
+ * @result: a #GAsyncResult
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Finishes an operation started with arv_camera_set_integer_async().
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 0.8.11
+ */
+
+gboolean
+arv_camera_set_integer_finish (ArvCamera *camera, GAsyncResult *result, GError **error)
+{
+	return arv_device_feature_request_finish (result, camera, arv_camera_set_integer_async, NULL, error);
+}
+
+/**
+ * arv_camera_get_integer_async:
+ * @camera: a #ArvCamera
+ * @feature: feature name
+ * @cancellable: (nullable): a #GCancellable
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the value is read
+ * @user_data: (closure): the data to pass to @callback
+ *
+ * Asynchronous version of arv_camera_get_integer(). See arv_device_execute_command_async().
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_camera_get_integer_async (ArvCamera *camera, const char *feature,
+			      GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+	ArvCameraPrivate *priv = arv_camera_get_instance_private (camera);
+
+	g_return_if_fail (ARV_IS_CAMERA (camera));
+
+	arv_device_feature_request_async (priv->device, camera, arv_camera_get_integer_async,
+					  ARV_DEVICE_FEATURE_REQUEST_GET_INTEGER, feature, NULL,
+					  cancellable, callback, user_data);
+}
+
+/**
+ * arv_camera_get_integer_finish:
+ * @camera: a #ArvCamera
+ * @result: a #GAsyncResult
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Finishes an operation started with arv_camera_get_integer_async().
+ *
+ * Returns: the feature value, 0 on error.
+ *
+ * Since: 0.8.11
+ */
+
+gint64
+arv_camera_get_integer_finish (ArvCamera *camera, GAsyncResult *result, GError **error)
+{
+	ArvDeviceFeatureValue value = {0};
+
+	if (!arv_device_feature_request_finish (result, camera, arv_camera_get_integer_async, &value, error))
+		return 0;
+
+	return value.v_int64;
+}
+
+/**
+ * arv_camera_set_float_async:
+ * @camera: a #ArvCamera
+ * @feature: feature name
+ * @value: new feature value
+ * @cancellable: (nullable): a #GCancellable
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the value is set
+ * @user_data: (closure): the data to pass to @callback
+ *
+ * Asynchronous version of arv_camera_set_float(). See arv_device_execute_command_async().
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_camera_set_float_async (ArvCamera *camera, const char *feature, double value,
+			    GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+	ArvCameraPrivate *priv = arv_camera_get_instance_private (camera);
+	ArvDeviceFeatureValue request_value = {0};
+
+	g_return_if_fail (ARV_IS_CAMERA (camera));
+
+	request_value.v_double = value;
+
+	arv_device_feature_request_async (priv->device, camera, arv_camera_set_float_async,
+					  ARV_DEVICE_FEATURE_REQUEST_SET_FLOAT, feature, &request_value,
+					  cancellable, callback, user_data);
+}
+
+/**
+ * arv_camera_set_float_finish:
+ * @camera: a #ArvCamera
+ * @result: a #GAsyncResult
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Finishes an operation started with arv_camera_set_float_async().
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 0.8.11
+ */
+
+gboolean
+arv_camera_set_float_finish (ArvCamera *camera, GAsyncResult *result, GError **error)
+{
+	return arv_device_feature_request_finish (result, camera, arv_camera_set_float_async, NULL, error);
+}
+
+/**
+ * arv_camera_get_float_async:
+ * @camera: a #ArvCamera
+ * @feature: feature name
+ * @cancellable: (nullable): a #GCancellable
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the value is read
+ * @user_data: (closure): the data to pass to @callback
+ *
+ * Asynchronous version of arv_camera_get_float(). See arv_device_execute_command_async().
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_camera_get_float_async (ArvCamera *camera, const char *feature,
+			    GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+	ArvCameraPrivate *priv = arv_camera_get_instance_private (camera);
+
+	g_return_if_fail (ARV_IS_CAMERA (camera));
+
+	arv_device_feature_request_async (priv->device, camera, arv_camera_get_float_async,
+					  ARV_DEVICE_FEATURE_REQUEST_GET_FLOAT, feature, NULL,
+					  cancellable, callback, user_data);
+}
+
+/**
+ * arv_camera_get_float_finish:
+ * @camera: a #ArvCamera
+ * @result: a #GAsyncResult
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Finishes an operation started with arv_camera_get_float_async().
+ *
+ * Returns: the feature value, 0.0 on error.
+ *
+ * Since: 0.8.11
+ */
+
+double
+arv_camera_get_float_finish (ArvCamera *camera, GAsyncResult *result, GError **error)
+{
+	ArvDeviceFeatureValue value = {0};
+
+	if (!arv_device_feature_request_finish (result, camera, arv_camera_get_float_async, &value, error))
+		return 0.0;
+
+	return value.v_double;
+}
+
+/**
+ * arv_camera_dup_available_enumerations:
+ * @camera: a #ArvCamera
+ * @feature: feature name
+ * @n_values: placeholder for the number of returned values
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Get all the available values of @feature, as 64 bit integers.
+ *
+ * Returns: (array length=n_values) (transfer container): a newly created array of integers, which must freed after use using g_free, or
+ * NULL on error.
+ *
+ * Since: 0.8.0
+ */
+
+gint64 *
+arv_camera_dup_available_enumerations (ArvCamera *camera, const char *feature, guint *n_values, GError **error)
+{
+	ArvCameraPrivate *priv = arv_camera_get_instance_private (camera);
+
+	if (n_values != NULL)
+		*n_values = 0;
+
+	g_return_val_if_fail (ARV_IS_CAMERA (camera), NULL);
+
+	return arv_device_dup_available_enumeration_feature_values (priv->device, feature, n_values, error);
+}
+
+/**
+ * arv_camera_dup_available_enumerations_as_strings:
+ * @camera: a #ArvCamera
+ * @feature: feature name
+ * @n_values: placeholder for the number of returned values
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Get all the available values of @feature, as strings.
+ *
+ * Returns: (array length=n_values) (transfer container): a newly created array of const strings, which must freed after use using g_free,
+ * or %NULL on error.
  *
  * Since: 0.8.0
  */
@@ -2478,6 +3382,33 @@ arv_camera_gv_select_stream_channel (ArvCamera *camera, gint channel_id, GError
 	arv_camera_set_integer (camera, "GevStreamChannelSelector", channel_id, error);
 }
 
+/**
+ * arv_camera_gv_create_channel_stream:
+ * @camera: a #ArvCamera
+ * @channel_id: id of the stream channel
+ * @callback: (scope call) (allow-none): a frame processing callback
+ * @user_data: (closure) (allow-none): user data for @callback
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Creates a new #ArvStream receiving the stream channel @channel_id, see arv_gv_device_create_channel_stream().
+ *
+ * Returns: (transfer full): a new #ArvStream, to be freed after use with g_object_unref().
+ *
+ * Since: 0.8.11
+ */
+
+ArvStream *
+arv_camera_gv_create_channel_stream (ArvCamera *camera, guint channel_id,
+				     ArvStreamCallback callback, gpointer user_data, GError **error)
+{
+	ArvCameraPrivate *priv = arv_camera_get_instance_private (camera);
+
+	g_return_val_if_fail (arv_camera_is_gv_device (camera), NULL);
+
+	return arv_gv_device_create_channel_stream (ARV_GV_DEVICE (priv->device), channel_id,
+						    callback, user_data, error);
+}
+
 /**
  * arv_camera_gv_get_current_stream_channel:
  * @camera: a #ArvCamera
@@ -2796,6 +3727,30 @@ arv_camera_uv_set_bandwidth (ArvCamera *camera, guint bandwidth, GError **error)
 		g_propagate_error (error, local_error);
 }
 
+/**
+ * arv_camera_uv_set_usb_mode:
+ * @camera: a #ArvCamera
+ * @usb_mode: a #ArvUvUsbMode option
+ *
+ * Sets the USB transfer mode. It must be set before the call to arv_camera_create_stream().
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_camera_uv_set_usb_mode (ArvCamera *camera, ArvUvUsbMode usb_mode)
+{
+#if ARAVIS_HAS_USB
+	ArvCameraPrivate *priv = arv_camera_get_instance_private (camera);
+#endif
+
+	g_return_if_fail (arv_camera_is_uv_device (camera));
+
+#if ARAVIS_HAS_USB
+	arv_uv_device_set_usb_mode (ARV_UV_DEVICE (priv->device), usb_mode);
+#endif
+}
+
 /**
  * arv_camera_uv_get_bandwidth:
  * @camera: a #ArvCamera
@@ -3111,6 +4066,7 @@ arv_camera_finalize (GObject *object)
 	ArvCameraPrivate *priv = arv_camera_get_instance_private (ARV_CAMERA (object));
 
 	g_clear_pointer (&priv->name, g_free);
+	g_clear_object (&priv->burst_stream);
 	g_clear_object (&priv->device);
 	g_clear_error (&priv->init_error);
 
@@ -3203,6 +4159,42 @@ arv_camera_constructed (GObject *object)
 											  "AcquisitionFrameRateAuto"));
 	priv->has_acquisition_frame_rate_enabled = ARV_IS_GC_BOOLEAN (arv_device_get_feature (priv->device,
 											      "AcquisitionFrameRateEnabled"));
+
+	switch (series) {
+		case ARV_CAMERA_SERIES_XIMEA:
+			priv->exposure_time_node = _resolve_control_node (priv, "ExposureTime", ARV_TYPE_GC_INTEGER);
+			break;
+		case ARV_CAMERA_SERIES_RICOH:
+			priv->exposure_time_node = _resolve_control_node (priv, "ExposureTimeRaw", ARV_TYPE_GC_INTEGER);
+			break;
+		default:
+			priv->exposure_time_node = _resolve_control_node (priv,
+									  priv->has_exposure_time ?
+									  "ExposureTime" : "ExposureTimeAbs",
+									  ARV_TYPE_GC_FLOAT);
+			break;
+	}
+
+	if (priv->has_gain)
+		priv->gain_node = _resolve_control_node (priv, "Gain", ARV_TYPE_GC_FLOAT);
+	else
+		priv->gain_node = _resolve_control_node (priv, "GainRaw",
+							 priv->gain_raw_as_float ? ARV_TYPE_GC_FLOAT : ARV_TYPE_GC_INTEGER);
+
+	switch (vendor) {
+		case ARV_CAMERA_VENDOR_TIS:
+			priv->frame_rate_node = NULL;
+			break;
+		case ARV_CAMERA_VENDOR_PROSILICA:
+			priv->frame_rate_node = _resolve_control_node (priv, "AcquisitionFrameRateAbs", ARV_TYPE_GC_FLOAT);
+			break;
+		default:
+			priv->frame_rate_node = _resolve_control_node (priv,
+								       priv->has_acquisition_frame_rate ?
+								       "AcquisitionFrameRate" : "AcquisitionFrameRateAbs",
+								       ARV_TYPE_GC_FLOAT);
+			break;
+	}
 }
 
 static void
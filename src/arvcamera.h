@@ -92,6 +92,26 @@ void		arv_camera_abort_acquisition		(ArvCamera *camera, GError **error);
 
 ArvBuffer *	arv_camera_acquisition			(ArvCamera *camera, guint64 timeout, GError **error);
 
+/**
+ * ArvCameraFrameSettings:
+ * @exposure_time_us: exposure time of the frame, in µs, negative to keep the current one
+ * @gain: gain of the frame, negative to keep the current one
+ *
+ * Per frame settings of a burst acquisition, see arv_camera_acquire_burst().
+ *
+ * Since: 0.8.11
+ */
+
+typedef struct {
+	double exposure_time_us;
+	double gain;
+} ArvCameraFrameSettings;
+
+GPtrArray *	arv_camera_acquire_burst		(ArvCamera *camera, guint n_frames,
+							 const ArvCameraFrameSettings *settings,
+							 guint64 timeout, GError **error);
+void		arv_camera_release_burst		(ArvCamera *camera, GPtrArray *buffers);
+
 void			arv_camera_set_acquisition_mode (ArvCamera *camera, ArvAcquisitionMode value, GError **error);
 ArvAcquisitionMode 	arv_camera_get_acquisition_mode (ArvCamera *camera, GError **error);
 
@@ -134,6 +154,12 @@ void		arv_camera_get_gain_bounds		(ArvCamera *camera, double *min, double *max,
 void		arv_camera_set_gain_auto		(ArvCamera *camera, ArvAuto auto_mode, GError **error);
 ArvAuto		arv_camera_get_gain_auto		(ArvCamera *camera, GError **error);
 
+/* Host side auto exposure */
+
+void		arv_camera_set_host_auto_exposure	(ArvCamera *camera, double target, GError **error);
+double		arv_camera_get_host_auto_exposure	(ArvCamera *camera);
+gboolean	arv_camera_update_host_auto_exposure	(ArvCamera *camera, ArvBuffer *buffer, GError **error);
+
 /* Transport layer control */
 
 guint		arv_camera_get_payload			(ArvCamera *camera, GError **error);
@@ -142,6 +168,9 @@ guint		arv_camera_get_payload			(ArvCamera *camera, GError **error);
 
 void 		arv_camera_execute_command 		(ArvCamera *camera, const char *feature, GError **error);
 
+void		arv_camera_begin_batch			(ArvCamera *camera);
+void		arv_camera_commit_batch			(ArvCamera *camera, GError **error);
+
 void		arv_camera_set_boolean			(ArvCamera *camera, const char *feature, gboolean value, GError **error);
 gboolean	arv_camera_get_boolean			(ArvCamera *camera, const char *feature, GError **error);
 void		arv_camera_get_boolean_gi		(ArvCamera *camera, const char *feature, gboolean *value, GError **error);
@@ -158,6 +187,47 @@ void		arv_camera_set_float			(ArvCamera *camera, const char *feature, double val
 double		arv_camera_get_float			(ArvCamera *camera, const char *feature, GError **error);
 void 		arv_camera_get_float_bounds 		(ArvCamera *camera, const char *feature, double *min, double *max, GError **error);
 
+void		arv_camera_execute_command_async	(ArvCamera *camera, const char *feature,
+							 GCancellable *cancellable, GAsyncReadyCallback callback,
+							 gpointer user_data);
+gboolean	arv_camera_execute_command_finish	(ArvCamera *camera, GAsyncResult *result, GError **error);
+
+void		arv_camera_set_boolean_async		(ArvCamera *camera, const char *feature, gboolean value,
+							 GCancellable *cancellable, GAsyncReadyCallback callback,
+							 gpointer user_data);
+gboolean	arv_camera_set_boolean_finish		(ArvCamera *camera, GAsyncResult *result, GError **error);
+void		arv_camera_get_boolean_async		(ArvCamera *camera, const char *feature,
+							 GCancellable *cancellable, GAsyncReadyCallback callback,
+							 gpointer user_data);
+gboolean	arv_camera_get_boolean_finish		(ArvCamera *camera, GAsyncResult *result, GError **error);
+
+void		arv_camera_set_string_async		(ArvCamera *camera, const char *feature, const char *value,
+							 GCancellable *cancellable, GAsyncReadyCallback callback,
+							 gpointer user_data);
+gboolean	arv_camera_set_string_finish		(ArvCamera *camera, GAsyncResult *result, GError **error);
+void		arv_camera_get_string_async		(ArvCamera *camera, const char *feature,
+							 GCancellable *cancellable, GAsyncReadyCallback callback,
+							 gpointer user_data);
+char *		arv_camera_get_string_finish		(ArvCamera *camera, GAsyncResult *result, GError **error);
+
+void		arv_camera_set_integer_async		(ArvCamera *camera, const char *feature, gint64 value,
+							 GCancellable *cancellable, GAsyncReadyCallback callback,
+							 gpointer user_data);
+gboolean	arv_camera_set_integer_finish		(ArvCamera *camera, GAsyncResult *result, GError **error);
+void		arv_camera_get_integer_async		(ArvCamera *camera, const char *feature,
+							 GCancellable *cancellable, GAsyncReadyCallback callback,
+							 gpointer user_data);
+gint64		arv_camera_get_integer_finish		(ArvCamera *camera, GAsyncResult *result, GError **error);
+
+void		arv_camera_set_float_async		(ArvCamera *camera, const char *feature, double value,
+							 GCancellable *cancellable, GAsyncReadyCallback callback,
+							 gpointer user_data);
+gboolean	arv_camera_set_float_finish		(ArvCamera *camera, GAsyncResult *result, GError **error);
+void		arv_camera_get_float_async		(ArvCamera *camera, const char *feature,
+							 GCancellable *cancellable, GAsyncReadyCallback callback,
+							 gpointer user_data);
+double		arv_camera_get_float_finish		(ArvCamera *camera, GAsyncResult *result, GError **error);
+
 gint64 *	arv_camera_dup_available_enumerations			(ArvCamera *camera, const char *feature, guint *n_values,
 									 GError **error);
 const char **	arv_camera_dup_available_enumerations_as_strings	(ArvCamera *camera, const char *feature, guint *n_values,
@@ -179,6 +249,8 @@ gboolean	arv_camera_is_gv_device			(ArvCamera *camera);
 gint		arv_camera_gv_get_n_stream_channels	(ArvCamera *camera, GError **error);
 void		arv_camera_gv_select_stream_channel	(ArvCamera *camera, gint channel_id, GError **error);
 int 		arv_camera_gv_get_current_stream_channel(ArvCamera *camera, GError **error);
+ArvStream *	arv_camera_gv_create_channel_stream	(ArvCamera *camera, guint channel_id,
+							 ArvStreamCallback callback, void *user_data, GError **error);
 
 void		arv_camera_gv_set_packet_delay		(ArvCamera *camera, gint64 delay_ns, GError **error);
 gint64 		arv_camera_gv_get_packet_delay 		(ArvCamera *camera, GError **error);
@@ -197,6 +269,7 @@ gboolean        arv_camera_uv_is_bandwidth_control_available 	(ArvCamera *camera
 void            arv_camera_uv_set_bandwidth             	(ArvCamera *camera, guint bandwidth, GError **error);
 guint           arv_camera_uv_get_bandwidth             	(ArvCamera *camera, GError **error);
 void            arv_camera_uv_get_bandwidth_bounds      	(ArvCamera *camera, guint *min, guint *max, GError **error);
+void		arv_camera_uv_set_usb_mode			(ArvCamera *camera, ArvUvUsbMode usb_mode);
 
 /* Chunk data */
 
@@ -1,13 +1,23 @@
+/* For RUSAGE_THREAD */
+#define _GNU_SOURCE
+
 #include <arvdebugprivate.h>
+#include <arvmiscprivate.h>
+#include <arvstreamprivate.h>
+#include <arvbufferprivate.h>
 #include <arv.h>
 #include <stdlib.h>
 #include <signal.h>
 #include <stdio.h>
+#ifndef G_OS_WIN32
+#include <sys/resource.h>
+#endif
 
 static char *arv_option_camera_name = NULL;
 static char *arv_option_debug_domains = NULL;
 static char *arv_option_trigger = NULL;
 static double arv_option_software_trigger = -1;
+static gboolean arv_option_trigger_latency = FALSE;
 static double arv_option_frequency = -1.0;
 static int arv_option_width = -1;
 static int arv_option_height = -1;
@@ -16,6 +26,7 @@ static int arv_option_vertical_binning = -1;
 static double arv_option_exposure_time_us = -1;
 static int arv_option_gain = -1;
 static gboolean arv_option_auto_socket_buffer = FALSE;
+static gboolean arv_option_adaptive_socket_buffer = FALSE;
 static char *arv_option_packet_size_adjustment = NULL;
 static gboolean arv_option_no_packet_resend = FALSE;
 static double arv_option_packet_request_ratio = -1.0;
@@ -26,9 +37,30 @@ static int arv_option_gv_packet_delay = -1;
 static int arv_option_gv_packet_size = -1;
 static gboolean arv_option_realtime = FALSE;
 static gboolean arv_option_high_priority = FALSE;
+static int arv_option_cpu_affinity = -1;
+static int arv_option_numa_node = -1;
+static double arv_option_realtime_deadline = 0.0;
+static int arv_option_cpu = -1;
 static gboolean arv_option_no_packet_socket = FALSE;
+static gboolean arv_option_batch_receive = FALSE;
+static gboolean arv_option_zero_copy = FALSE;
+static gboolean arv_option_shared_receiver = FALSE;
+static gboolean arv_option_xdp = FALSE;
+static gboolean arv_option_hardware_timestamps = FALSE;
+static gboolean arv_option_low_latency = FALSE;
+static gboolean arv_option_io_uring = FALSE;
+static gboolean arv_option_prefetch = FALSE;
+static gboolean arv_option_non_temporal_copy = FALSE;
 static char *arv_option_chunks = NULL;
 static int arv_option_bandwidth_limit = -1;
+static gboolean arv_option_usb_async = FALSE;
+static int arv_option_metrics_port = -1;
+static gboolean arv_option_frame_cost = FALSE;
+static char *arv_option_record_filename = NULL;
+static char *arv_option_replay_filename = NULL;
+static char *arv_option_event_ring_filename = NULL;
+static int arv_option_event_ring_failures = 1;
+static char *arv_option_frame_log_filename = NULL;
 static char *arv_option_register_cache = NULL;
 static char *arv_option_range_check = NULL;
 
@@ -55,6 +87,11 @@ static const GOptionEntry arv_option_entries[] =
 		&arv_option_software_trigger,		"Emit software trigger",
 		NULL
 	},
+	{
+		"trigger-latency",			'\0', 0, G_OPTION_ARG_NONE,
+		&arv_option_trigger_latency,		"Report the software trigger to buffer latency, with --software-trigger",
+		NULL
+	},
 	{
 		"width", 				'w', 0, G_OPTION_ARG_INT,
 		&arv_option_width,			"Width",
@@ -90,10 +127,15 @@ static const GOptionEntry arv_option_entries[] =
 		&arv_option_auto_socket_buffer,		"Auto socket buffer size",
 		NULL
 	},
+	{
+		"adaptive-socket-buffer",		'\0', 0, G_OPTION_ARG_NONE,
+		&arv_option_adaptive_socket_buffer,	"Grow the socket buffer on packet losses",
+		NULL
+	},
 	{
 		"packet-size-adjustment",		'j', 0, G_OPTION_ARG_STRING,
 		&arv_option_packet_size_adjustment,	"Packet size adjustment",
-		"{never|always|once|on-failure|on-failure-once}"
+		"{never|always|once|on-failure|on-failure-once|cached}"
 	},
 	{
 		"no-packet-resend",			'r', 0, G_OPTION_ARG_NONE,
@@ -146,11 +188,78 @@ static const GOptionEntry arv_option_entries[] =
 		&arv_option_high_priority,		"Make stream thread high priority",
 		NULL
 	},
+	{
+		"cpu-affinity",				'\0', 0, G_OPTION_ARG_INT,
+		&arv_option_cpu_affinity,		"Pin stream thread to a CPU",
+		"<cpu_index>"
+	},
+	{
+		"numa-node",				'\0', 0, G_OPTION_ARG_INT,
+		&arv_option_numa_node,			"Stream thread and buffer NUMA node",
+		"<node_index>"
+	},
+	{
+		"realtime-deadline",			'\0', 0, G_OPTION_ARG_DOUBLE,
+		&arv_option_realtime_deadline,
+		"Use SCHED_DEADLINE for the stream thread, with the given fraction of the frame period as runtime, "
+		"and lock memory",
+		"<runtime_ratio>"
+	},
+	{
+		"cpu",					'\0', 0, G_OPTION_ARG_INT,
+		&arv_option_cpu,			"Pin all the stream, heartbeat and event threads to a CPU",
+		"<cpu_index>"
+	},
 	{
 		"no-packet-socket",			'\0', 0, G_OPTION_ARG_NONE,
 		&arv_option_no_packet_socket,		"Disable use of packet socket",
 		NULL
 	},
+	{
+		"batch-receive",			'\0', 0, G_OPTION_ARG_NONE,
+		&arv_option_batch_receive,		"Receive several packets per system call",
+		NULL
+	},
+	{
+		"zero-copy",				'\0', 0, G_OPTION_ARG_NONE,
+		&arv_option_zero_copy,			"Receive data directly into buffers",
+		NULL
+	},
+	{
+		"shared-receiver",			'\0', 0, G_OPTION_ARG_NONE,
+		&arv_option_shared_receiver,		"Receive packets from the shared receiver threads",
+		NULL
+	},
+	{
+		"xdp",					'\0', 0, G_OPTION_ARG_NONE,
+		&arv_option_xdp,			"Receive packets from an AF_XDP socket",
+		NULL
+	},
+	{
+		"hardware-timestamps",			'\0', 0, G_OPTION_ARG_NONE,
+		&arv_option_hardware_timestamps,	"Measure the latency from the network interface hardware timestamps",
+		NULL
+	},
+	{
+		"low-latency",				'\0', 0, G_OPTION_ARG_NONE,
+		&arv_option_low_latency,		"Busy poll the socket (best with --cpu-affinity)",
+		NULL
+	},
+	{
+		"io-uring",				'\0', 0, G_OPTION_ARG_NONE,
+		&arv_option_io_uring,			"Receive packets with io_uring multishot receives",
+		NULL
+	},
+	{
+		"prefetch",				'\0', 0, G_OPTION_ARG_NONE,
+		&arv_option_prefetch,			"Prefetch the next buffer when a frame is half received",
+		NULL
+	},
+	{
+		"non-temporal-copy",			'\0', 0, G_OPTION_ARG_NONE,
+		&arv_option_non_temporal_copy,		"Copy the payload with non-temporal stores",
+		NULL
+	},
 	{
 		"register-cache",			'\0', 0, G_OPTION_ARG_STRING,
 		&arv_option_register_cache,		"Register cache policy",
@@ -166,6 +275,47 @@ static const GOptionEntry arv_option_entries[] =
 		&arv_option_bandwidth_limit,		"Desired USB3 Vision device bandwidth limit",
 		NULL
 	},
+	{
+		"usb-async",				'\0', 0, G_OPTION_ARG_NONE,
+		&arv_option_usb_async,			"Use asynchronous USB3 Vision bulk transfers",
+		NULL
+	},
+	{
+		"metrics-port",				'\0', 0, G_OPTION_ARG_INT,
+		&arv_option_metrics_port,		"Serve OpenMetrics statistics over HTTP",
+		"<port>"
+	},
+	{
+		"frame-cost",				'\0', 0, G_OPTION_ARG_NONE,
+		&arv_option_frame_cost,			"Report the per frame cost of the stream thread",
+		NULL
+	},
+	{
+		"record",				'\0', 0, G_OPTION_ARG_FILENAME,
+		&arv_option_record_filename,		"Record the raw GigE Vision stream packets",
+		"<filename>"
+	},
+	{
+		"replay",				'\0', 0, G_OPTION_ARG_FILENAME,
+		&arv_option_replay_filename,		"Replay recorded GigE Vision stream packets at their original pace",
+		"<filename>"
+	},
+	{
+		"event-ring",				'\0', 0, G_OPTION_ARG_FILENAME,
+		&arv_option_event_ring_filename,	"Save the stream thread event ring, for arv-tool events",
+		"<filename>"
+	},
+	{
+		"event-ring-failures",			'\0', 0, G_OPTION_ARG_INT,
+		&arv_option_event_ring_failures,	"Number of failed frames before the event ring save, 0 for the end of "
+		"the acquisition",
+		"<n_failures>"
+	},
+	{
+		"frame-log",				'\0', 0, G_OPTION_ARG_FILENAME,
+		&arv_option_frame_log_filename,		"Log the metadata of every frame, for arv-tool frames",
+		"<filename>"
+	},
 	{
 		"debug", 				'd', 0, G_OPTION_ARG_STRING,
 		&arv_option_debug_domains, 		NULL,
@@ -182,10 +332,62 @@ typedef struct {
 	int error_count;
 	size_t transferred;
 
+	/* Time from the hardware reception of the trailer to the buffer processing */
+	gint64 latency_sum_ns;
+	int latency_count;
+
 	ArvChunkParser *chunk_parser;
 	char **chunks;
+
+	/* Per frame cost of the stream thread, accumulated from the stream callback */
+	ArvStream *stream;
+	GMutex cost_mutex;
+	ArvStatistic *cost_statistic;
+	gint64 thread_cpu_time_us;
+	gint64 thread_n_context_switches;
+	gint64 cost_cpu_time_us;
+	gint64 cost_n_context_switches;
+	guint cost_count;
+	guint64 n_copied_bytes;
+	guint64 n_zero_copy_bytes;
+	guint64 n_received_packets;
+	guint64 n_resent_packets;
+
+	/* Software trigger to buffer latency. The triggers are matched to the buffers by frame id, the first buffer
+	 * being the answer to the first trigger. */
+	ArvCamera *camera;
+	GMutex trigger_mutex;
+	GArray *triggers;
+	ArvStatistic *trigger_statistic;
+	guint64 first_frame_id;
+	gboolean has_first_frame_id;
+	gint64 monotonic_offset_us;
 } ApplicationData;
 
+typedef struct {
+	gint64 start_us;
+	gint64 end_us;
+} ApplicationTrigger;
+
+typedef enum {
+	TRIGGER_LATENCY_TOTAL,
+	TRIGGER_LATENCY_COMMAND,
+	TRIGGER_LATENCY_EXPOSURE,
+	TRIGGER_LATENCY_READOUT,
+	TRIGGER_LATENCY_WIRE,
+	TRIGGER_LATENCY_DWELL,
+	TRIGGER_LATENCY_N_PHASES
+} TriggerLatencyPhase;
+
+static const char *trigger_latency_phase_names[TRIGGER_LATENCY_N_PHASES] = {
+	"Total (trigger call to buffer pop)",
+	"Trigger command round trip",
+	"Exposure (trigger ack to device timestamp)",
+	"Readout (device timestamp to first packet)",
+	"Wire assembly (first packet to frame completion)",
+	"Output queue dwell"
+};
+
 static gboolean cancel = FALSE;
 
 static void
@@ -194,6 +396,74 @@ set_cancel (int signal)
 	cancel = TRUE;
 }
 
+/* All the times are in the host monotonic time base. The device timestamp is mapped to it by the stream clock model
+ * for GigE Vision devices, and is the frame reception time for the other ones. */
+
+static void
+account_trigger_latency (ApplicationData *data, ArvBuffer *buffer, gint64 pop_time_us)
+{
+	ApplicationTrigger trigger;
+	guint64 frame_id = arv_buffer_get_frame_id (buffer);
+	gint64 device_time_us;
+	gint64 leader_time_us;
+	gint64 output_time_us;
+	guint64 index;
+
+	g_mutex_lock (&data->trigger_mutex);
+
+	if (!data->has_first_frame_id) {
+		data->first_frame_id = frame_id;
+		data->has_first_frame_id = TRUE;
+	}
+
+	index = frame_id - data->first_frame_id;
+	if (frame_id < data->first_frame_id || index >= data->triggers->len) {
+		g_mutex_unlock (&data->trigger_mutex);
+		return;
+	}
+
+	trigger = g_array_index (data->triggers, ApplicationTrigger, index);
+
+	g_mutex_unlock (&data->trigger_mutex);
+
+	device_time_us = arv_buffer_get_host_timestamp (buffer) / 1000;
+	leader_time_us = arv_buffer_get_system_timestamp (buffer) / 1000 + data->monotonic_offset_us;
+	output_time_us = buffer->priv->output_time_us;
+
+	arv_statistic_fill (data->trigger_statistic, TRIGGER_LATENCY_TOTAL, pop_time_us - trigger.start_us, frame_id);
+	arv_statistic_fill (data->trigger_statistic, TRIGGER_LATENCY_COMMAND, trigger.end_us - trigger.start_us,
+			    frame_id);
+	arv_statistic_fill (data->trigger_statistic, TRIGGER_LATENCY_EXPOSURE, device_time_us - trigger.end_us,
+			    frame_id);
+	arv_statistic_fill (data->trigger_statistic, TRIGGER_LATENCY_READOUT, leader_time_us - device_time_us,
+			    frame_id);
+	arv_statistic_fill (data->trigger_statistic, TRIGGER_LATENCY_WIRE, output_time_us - leader_time_us,
+			    frame_id);
+	arv_statistic_fill (data->trigger_statistic, TRIGGER_LATENCY_DWELL, pop_time_us - output_time_us, frame_id);
+}
+
+static void
+print_trigger_latency (ApplicationData *data)
+{
+	guint i;
+
+	printf ("Software trigger latency (µs):\n");
+	printf ("%-50s %8s %8s %8s %8s %8s\n", "", "Count", "p50", "p90", "p99", "Max");
+
+	for (i = 0; i < TRIGGER_LATENCY_N_PHASES; i++) {
+		if (arv_statistic_get_n_values (data->trigger_statistic, i) == 0)
+			continue;
+
+		printf ("%-50s %8" G_GUINT64_FORMAT " %8d %8d %8d %8d\n",
+			trigger_latency_phase_names[i],
+			arv_statistic_get_n_values (data->trigger_statistic, i),
+			arv_statistic_get_percentile (data->trigger_statistic, i, 50.0),
+			arv_statistic_get_percentile (data->trigger_statistic, i, 90.0),
+			arv_statistic_get_percentile (data->trigger_statistic, i, 99.0),
+			arv_statistic_get_max (data->trigger_statistic, i));
+	}
+}
+
 static void
 new_buffer_cb (ArvStream *stream, ApplicationData *data)
 {
@@ -203,9 +473,20 @@ new_buffer_cb (ArvStream *stream, ApplicationData *data)
 	if (buffer != NULL) {
 		if (arv_buffer_get_status (buffer) == ARV_BUFFER_STATUS_SUCCESS) {
 			size_t size = 0;
+			guint64 trailer_timestamp_ns;
+
 			data->buffer_count++;
 			arv_buffer_get_data (buffer, &size);
 			data->transferred += size;
+
+			if (data->trigger_statistic != NULL)
+				account_trigger_latency (data, buffer, g_get_monotonic_time ());
+
+			trailer_timestamp_ns = arv_buffer_get_trailer_hardware_timestamp (buffer);
+			if (trailer_timestamp_ns != 0) {
+				data->latency_sum_ns += g_get_real_time () * 1000LL - (gint64) trailer_timestamp_ns;
+				data->latency_count++;
+			}
 		} else {
 			data->error_count++;
 		}
@@ -239,9 +520,30 @@ new_buffer_cb (ArvStream *stream, ApplicationData *data)
 	}
 }
 
+static gboolean
+get_thread_usage (gint64 *cpu_time_us, gint64 *n_context_switches)
+{
+#ifdef RUSAGE_THREAD
+	struct rusage usage;
+
+	if (getrusage (RUSAGE_THREAD, &usage) != 0)
+		return FALSE;
+
+	*cpu_time_us = (gint64) (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000 +
+		usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+	*n_context_switches = usage.ru_nvcsw + usage.ru_nivcsw;
+
+	return TRUE;
+#else
+	return FALSE;
+#endif
+}
+
 static void
 stream_cb (void *user_data, ArvStreamCallbackType type, ArvBuffer *buffer)
 {
+	ApplicationData *data = user_data;
+
 	if (type == ARV_STREAM_CALLBACK_TYPE_INIT) {
 		if (arv_option_realtime) {
 			if (!arv_make_thread_realtime (10))
@@ -250,6 +552,115 @@ stream_cb (void *user_data, ArvStreamCallbackType type, ArvBuffer *buffer)
 			if (!arv_make_thread_high_priority (-10))
 				printf ("Failed to make stream thread high priority\n");
 		}
+
+		if (data->cost_statistic != NULL &&
+		    !get_thread_usage (&data->thread_cpu_time_us, &data->thread_n_context_switches))
+			printf ("Stream thread cost accounting is not available on this platform\n");
+	} else if (type == ARV_STREAM_CALLBACK_TYPE_BUFFER_DONE && data->cost_statistic != NULL) {
+		gint64 cpu_time_us;
+		gint64 n_context_switches;
+
+		/* The stream thread usage since the previous frame is accounted to this one */
+		if (get_thread_usage (&cpu_time_us, &n_context_switches)) {
+			gint64 frame_cpu_time_us = cpu_time_us - data->thread_cpu_time_us;
+			gint64 frame_n_context_switches = n_context_switches - data->thread_n_context_switches;
+
+			g_mutex_lock (&data->cost_mutex);
+			data->cost_cpu_time_us += frame_cpu_time_us;
+			data->cost_n_context_switches += frame_n_context_switches;
+			data->cost_count++;
+			arv_statistic_fill (data->cost_statistic, 0, frame_cpu_time_us,
+					    arv_buffer_get_frame_id (buffer));
+			arv_statistic_fill (data->cost_statistic, 1, frame_n_context_switches,
+					    arv_buffer_get_frame_id (buffer));
+			g_mutex_unlock (&data->cost_mutex);
+
+			data->thread_cpu_time_us = cpu_time_us;
+			data->thread_n_context_switches = n_context_switches;
+		}
+	}
+}
+
+static void
+print_frame_cost (ApplicationData *data)
+{
+	const ArvStatistic *dwell_statistic = NULL;
+	guint64 n_copied_bytes, n_zero_copy_bytes, n_received_packets, n_resent_packets;
+	guint dwell_histogram = 0;
+	guint cost_count;
+	gint64 cpu_time_us, n_context_switches;
+	guint i;
+
+	g_mutex_lock (&data->cost_mutex);
+	cost_count = data->cost_count;
+	cpu_time_us = data->cost_cpu_time_us;
+	n_context_switches = data->cost_n_context_switches;
+	data->cost_count = 0;
+	data->cost_cpu_time_us = 0;
+	data->cost_n_context_switches = 0;
+	g_mutex_unlock (&data->cost_mutex);
+
+	n_copied_bytes = arv_stream_get_info_uint64_by_name (data->stream, "n_copied_bytes");
+	n_zero_copy_bytes = arv_stream_get_info_uint64_by_name (data->stream, "n_zero_copy_bytes");
+	n_received_packets = arv_stream_get_info_uint64_by_name (data->stream, "n_received_packets");
+	n_resent_packets = arv_stream_get_info_uint64_by_name (data->stream, "n_resent_packets");
+
+	for (i = 0; i < arv_stream_get_n_statistics (data->stream); i++) {
+		const char *name;
+		const ArvStatistic *statistic;
+		guint histogram;
+
+		statistic = arv_stream_get_statistic (data->stream, i, &name, &histogram);
+		if (g_strcmp0 (name, "output_queue_dwell_time_us") == 0) {
+			dwell_statistic = statistic;
+			dwell_histogram = histogram;
+		}
+	}
+
+	if (cost_count > 0) {
+		printf ("    per frame: %7.1f µs cpu - %5.1f context switches - %9.0f copied bytes"
+			" - %9.0f zero copy bytes",
+			(double) cpu_time_us / cost_count,
+			(double) n_context_switches / cost_count,
+			(double) (n_copied_bytes - data->n_copied_bytes) / cost_count,
+			(double) (n_zero_copy_bytes - data->n_zero_copy_bytes) / cost_count);
+		if (n_received_packets > data->n_received_packets)
+			printf (" - %5.2f%% resent",
+				100.0 * (double) (n_resent_packets - data->n_resent_packets) /
+				(double) (n_received_packets - data->n_received_packets));
+		if (dwell_statistic != NULL && arv_statistic_get_n_values (dwell_statistic, dwell_histogram) > 0)
+			printf (" - %d µs dwell (p50)", arv_statistic_get_percentile (dwell_statistic, dwell_histogram, 50.0));
+		printf ("\n");
+	}
+
+	data->n_copied_bytes = n_copied_bytes;
+	data->n_zero_copy_bytes = n_zero_copy_bytes;
+	data->n_received_packets = n_received_packets;
+	data->n_resent_packets = n_resent_packets;
+}
+
+static void
+print_frame_cost_histograms (ApplicationData *data)
+{
+	char *string;
+	guint i;
+
+	g_mutex_lock (&data->cost_mutex);
+	string = arv_statistic_to_string (data->cost_statistic);
+	g_mutex_unlock (&data->cost_mutex);
+	printf ("%s", string);
+	g_free (string);
+
+	for (i = 0; i < arv_stream_get_n_statistics (data->stream); i++) {
+		const char *name;
+		const ArvStatistic *statistic;
+
+		statistic = arv_stream_get_statistic (data->stream, i, &name, NULL);
+		if (g_strcmp0 (name, "output_queue_dwell_time_us") == 0) {
+			string = arv_statistic_to_string (statistic);
+			printf ("%s", string);
+			g_free (string);
+		}
 	}
 }
 
@@ -262,13 +673,19 @@ periodic_task_cb (void *abstract_data)
 		data->buffer_count,
 		data->buffer_count > 1 ? "s/s" : "/s ",
 		(double) data->transferred / 1e6);
+	if (data->latency_count > 0)
+		printf (" - %7.1f µs latency", (double) data->latency_sum_ns / (1000.0 * data->latency_count));
 	if (data->error_count > 0)
 		printf (" - %d error%s\n", data->error_count, data->error_count > 1 ? "s" : "");
 	else
 		printf ("\n");
+	if (data->stream != NULL && data->cost_statistic != NULL)
+		print_frame_cost (data);
 	data->buffer_count = 0;
 	data->error_count = 0;
 	data->transferred = 0;
+	data->latency_sum_ns = 0;
+	data->latency_count = 0;
 
 	if (cancel) {
 		g_main_loop_quit (data->main_loop);
@@ -288,6 +705,23 @@ emit_software_trigger (void *abstract_data)
 	return TRUE;
 }
 
+static gboolean
+emit_timed_software_trigger (void *abstract_data)
+{
+	ApplicationData *data = abstract_data;
+	ApplicationTrigger trigger;
+
+	trigger.start_us = g_get_monotonic_time ();
+	arv_camera_software_trigger (data->camera, NULL);
+	trigger.end_us = g_get_monotonic_time ();
+
+	g_mutex_lock (&data->trigger_mutex);
+	g_array_append_val (data->triggers, trigger);
+	g_mutex_unlock (&data->trigger_mutex);
+
+	return TRUE;
+}
+
 static void
 control_lost_cb (ArvGvDevice *gv_device)
 {
@@ -302,6 +736,7 @@ main (int argc, char **argv)
 	ApplicationData data;
 	ArvCamera *camera;
 	ArvStream *stream;
+	ArvMetricsExporter *exporter = NULL;
 	ArvRegisterCachePolicy register_cache_policy;
 	ArvRangeCheckPolicy range_check_policy;
 	ArvGvPacketSizeAdjustment adjustment;
@@ -312,8 +747,27 @@ main (int argc, char **argv)
 	data.buffer_count = 0;
 	data.error_count = 0;
 	data.transferred = 0;
+	data.latency_sum_ns = 0;
+	data.latency_count = 0;
 	data.chunks = NULL;
 	data.chunk_parser = NULL;
+	data.stream = NULL;
+	data.cost_statistic = NULL;
+	data.cost_cpu_time_us = 0;
+	data.cost_n_context_switches = 0;
+	data.cost_count = 0;
+	data.n_copied_bytes = 0;
+	data.n_zero_copy_bytes = 0;
+	data.n_received_packets = 0;
+	data.n_resent_packets = 0;
+	g_mutex_init (&data.cost_mutex);
+	data.camera = NULL;
+	data.triggers = NULL;
+	data.trigger_statistic = NULL;
+	data.first_frame_id = 0;
+	data.has_first_frame_id = FALSE;
+	data.monotonic_offset_us = 0;
+	g_mutex_init (&data.trigger_mutex);
 
 	context = g_option_context_new (NULL);
 	g_option_context_add_main_entries (context, arv_option_entries, NULL);
@@ -365,6 +819,8 @@ main (int argc, char **argv)
 		adjustment = ARV_GV_PACKET_SIZE_ADJUSTMENT_ON_FAILURE;
 	else if (g_strcmp0 (arv_option_packet_size_adjustment, "on-failure-once") == 0)
 		adjustment = ARV_GV_PACKET_SIZE_ADJUSTMENT_ON_FAILURE_ONCE;
+	else if (g_strcmp0 (arv_option_packet_size_adjustment, "cached") == 0)
+		adjustment = ARV_GV_PACKET_SIZE_ADJUSTMENT_CACHED;
 	else {
 		printf ("Invalid GigEVision packet size adjustment\n");
 		return EXIT_FAILURE;
@@ -387,6 +843,26 @@ main (int argc, char **argv)
 	else
 		g_print ("Looking for camera '%s'\n", arv_option_camera_name);
 
+	/* Before the device opening, which starts the heartbeat and event threads */
+	if (arv_option_cpu >= 0) {
+		guint *isolated_cpus;
+		guint n_isolated_cpus;
+		gboolean is_isolated = FALSE;
+		guint j;
+
+		isolated_cpus = arv_get_isolated_cpus (&n_isolated_cpus);
+		for (j = 0; j < n_isolated_cpus; j++)
+			if (isolated_cpus[j] == (guint) arv_option_cpu)
+				is_isolated = TRUE;
+		g_free (isolated_cpus);
+
+		if (!is_isolated)
+			printf ("CPU %d is not isolated from the general scheduler (see isolcpus kernel parameter)\n",
+				arv_option_cpu);
+
+		arv_set_internal_thread_affinity (ARV_INTERNAL_THREAD_ALL, arv_option_cpu);
+	}
+
 	camera = arv_camera_new (arv_option_camera_name, &error);
 	if (camera != NULL) {
 		const char *vendor_name;
@@ -442,14 +918,47 @@ main (int argc, char **argv)
 			if (error == NULL) arv_camera_uv_set_bandwidth (camera, arv_option_bandwidth_limit, &error);
 		}
 
+		if (arv_camera_is_uv_device (camera))
+			arv_camera_uv_set_usb_mode (camera, arv_option_usb_async ?
+						    ARV_UV_USB_MODE_ASYNC :
+						    ARV_UV_USB_MODE_SYNC);
+
 		if (arv_camera_is_gv_device (camera)) {
 			if (error == NULL) arv_camera_gv_select_stream_channel (camera, arv_option_gv_stream_channel, &error);
 			if (error == NULL) arv_camera_gv_set_packet_delay (camera, arv_option_gv_packet_delay, &error);
 			if (error == NULL) arv_camera_gv_set_packet_size (camera, arv_option_gv_packet_size, &error);
 
-			arv_camera_gv_set_stream_options (camera, arv_option_no_packet_socket ?
-							  ARV_GV_STREAM_OPTION_PACKET_SOCKET_DISABLED :
-							  ARV_GV_STREAM_OPTION_NONE);
+			arv_camera_gv_set_stream_options (camera,
+							  (arv_option_no_packet_socket ?
+							   ARV_GV_STREAM_OPTION_PACKET_SOCKET_DISABLED :
+							   ARV_GV_STREAM_OPTION_NONE) |
+							  (arv_option_batch_receive ?
+							   ARV_GV_STREAM_OPTION_BATCH_RECEIVE_ENABLED :
+							   ARV_GV_STREAM_OPTION_NONE) |
+							  (arv_option_zero_copy ?
+							   ARV_GV_STREAM_OPTION_ZERO_COPY_ENABLED :
+							   ARV_GV_STREAM_OPTION_NONE) |
+							  (arv_option_shared_receiver ?
+							   ARV_GV_STREAM_OPTION_SHARED_RECEIVER_ENABLED :
+							   ARV_GV_STREAM_OPTION_NONE) |
+							  (arv_option_xdp ?
+							   ARV_GV_STREAM_OPTION_XDP_ENABLED :
+							   ARV_GV_STREAM_OPTION_NONE) |
+							  (arv_option_hardware_timestamps ?
+							   ARV_GV_STREAM_OPTION_HARDWARE_TIMESTAMPS_ENABLED :
+							   ARV_GV_STREAM_OPTION_NONE) |
+							  (arv_option_low_latency ?
+							   ARV_GV_STREAM_OPTION_LOW_LATENCY_ENABLED :
+							   ARV_GV_STREAM_OPTION_NONE) |
+							  (arv_option_io_uring ?
+							   ARV_GV_STREAM_OPTION_IO_URING_ENABLED :
+							   ARV_GV_STREAM_OPTION_NONE) |
+							  (arv_option_prefetch ?
+							   ARV_GV_STREAM_OPTION_PREFETCH_ENABLED :
+							   ARV_GV_STREAM_OPTION_NONE) |
+							  (arv_option_non_temporal_copy ?
+							   ARV_GV_STREAM_OPTION_NON_TEMPORAL_COPY_ENABLED :
+							   ARV_GV_STREAM_OPTION_NONE));
 			if (arv_option_packet_size_adjustment != NULL)
 				arv_camera_gv_set_packet_size_adjustment (camera, adjustment);
 		}
@@ -526,7 +1035,31 @@ main (int argc, char **argv)
 		}
 
 		if (success) {
-		    stream = arv_camera_create_stream (camera, stream_cb, NULL, &error);
+		    if (arv_option_frame_cost) {
+			    data.cost_statistic = arv_statistic_new (2, 100, 10, 0);
+			    arv_statistic_set_name (data.cost_statistic, 0, "Stream thread cpu time per frame (µs)");
+			    arv_statistic_set_name (data.cost_statistic, 1, "Stream thread context switches per frame");
+		    }
+
+		    if (arv_option_realtime_deadline > 0.0) {
+			    double frame_rate;
+
+			    frame_rate = arv_option_frequency > 0.0 ?
+				    arv_option_frequency :
+				    arv_camera_get_frame_rate (camera, NULL);
+
+			    if (frame_rate > 0.0) {
+				    gint64 period_us = 1000000.0 / frame_rate;
+
+				    arv_set_internal_thread_deadline (ARV_INTERNAL_THREAD_STREAM,
+								      MAX (1, MIN (1.0, arv_option_realtime_deadline) *
+									   period_us),
+								      period_us);
+			    } else
+				    printf ("Unknown frame rate, SCHED_DEADLINE not used\n");
+		    }
+
+		    stream = arv_camera_create_stream (camera, stream_cb, &data, &error);
 
 		    if (ARV_IS_STREAM (stream)) {
 			    if (ARV_IS_GV_STREAM (stream)) {
@@ -535,6 +1068,10 @@ main (int argc, char **argv)
 							  "socket-buffer", ARV_GV_STREAM_SOCKET_BUFFER_AUTO,
 							  "socket-buffer-size", 0,
 							  NULL);
+				    if (arv_option_adaptive_socket_buffer)
+					    g_object_set (stream,
+							  "socket-buffer", ARV_GV_STREAM_SOCKET_BUFFER_ADAPTIVE,
+							  NULL);
 				    if (arv_option_no_packet_resend)
 					    g_object_set (stream,
 							  "packet-resend", ARV_GV_STREAM_PACKET_RESEND_NEVER,
@@ -548,10 +1085,41 @@ main (int argc, char **argv)
 						  "packet-timeout", (unsigned) arv_option_packet_timeout * 1000,
 						  "frame-retention", (unsigned) arv_option_frame_retention * 1000,
 						  NULL);
+
+				    /* Applied when the stream thread starts */
+				    if (arv_option_record_filename != NULL || arv_option_replay_filename != NULL) {
+					    g_object_set (stream,
+							  "record-filename", arv_option_record_filename,
+							  "replay-filename", arv_option_replay_filename,
+							  "replay-realtime", TRUE,
+							  NULL);
+					    arv_stream_stop_thread (stream, FALSE);
+					    arv_stream_start_thread (stream);
+				    }
+			    }
+
+			    g_object_set (stream,
+					  "cpu-affinity", arv_option_cpu_affinity,
+					  "numa-node", arv_option_numa_node,
+					  "event-ring-filename", arv_option_event_ring_filename,
+					  "event-ring-failures", (guint) MAX (arv_option_event_ring_failures, 0),
+					  NULL);
+
+			    if (arv_option_frame_log_filename != NULL) {
+				    GError *log_error = NULL;
+
+				    if (!arv_stream_open_frame_log (stream, arv_option_frame_log_filename, 0, &log_error)) {
+					    printf ("Failed to open the frame log: %s\n", log_error->message);
+					    g_clear_error (&log_error);
+				    }
 			    }
 
 			    for (i = 0; i < 50; i++)
-				    arv_stream_push_buffer (stream, arv_buffer_new (payload, NULL));
+				    arv_stream_push_buffer (stream, arv_buffer_new_allocate_numa (payload,
+												  arv_option_numa_node));
+
+			    if (arv_option_realtime_deadline > 0.0 && !arv_lock_memory ())
+				    printf ("Failed to lock memory\n");
 
 			    arv_camera_set_acquisition_mode (camera, ARV_ACQUISITION_MODE_CONTINUOUS, NULL);
 
@@ -563,10 +1131,25 @@ main (int argc, char **argv)
 
 			    if (arv_option_software_trigger > 0.0) {
 				    arv_camera_set_trigger (camera, "Software", NULL);
-				    software_trigger_source = g_timeout_add ((double) (0.5 + 1000.0 /
-										       arv_option_software_trigger),
-									     emit_software_trigger, camera);
-			    }
+				    if (arv_option_trigger_latency) {
+					    data.camera = camera;
+					    data.triggers = g_array_new (FALSE, FALSE, sizeof (ApplicationTrigger));
+					    data.trigger_statistic = arv_statistic_new (TRIGGER_LATENCY_N_PHASES,
+											2200, 50, -10000);
+					    for (i = 0; i < TRIGGER_LATENCY_N_PHASES; i++)
+						    arv_statistic_set_name (data.trigger_statistic, i,
+									    trigger_latency_phase_names[i]);
+					    /* Maps the real time of the leader reception to the monotonic time */
+					    data.monotonic_offset_us = g_get_monotonic_time () - g_get_real_time ();
+					    software_trigger_source =
+						    g_timeout_add ((double) (0.5 + 1000.0 / arv_option_software_trigger),
+								   emit_timed_software_trigger, &data);
+				    } else
+					    software_trigger_source =
+						    g_timeout_add ((double) (0.5 + 1000.0 / arv_option_software_trigger),
+								   emit_software_trigger, camera);
+			    } else if (arv_option_trigger_latency)
+				    printf ("--trigger-latency requires --software-trigger\n");
 
 			    arv_camera_start_acquisition (camera, NULL);
 
@@ -576,8 +1159,24 @@ main (int argc, char **argv)
 			    g_signal_connect (arv_camera_get_device (camera), "control-lost",
 					      G_CALLBACK (control_lost_cb), NULL);
 
+			    data.stream = stream;
+
 			    g_timeout_add (1000, periodic_task_cb, &data);
 
+			    if (arv_option_metrics_port >= 0) {
+				    exporter = arv_metrics_exporter_new (arv_option_metrics_port, &error);
+				    if (exporter != NULL) {
+					    arv_metrics_exporter_add_device (exporter, "camera",
+									     arv_camera_get_device (camera));
+					    arv_metrics_exporter_add_stream (exporter, "camera", stream);
+					    printf ("Metrics available at http://localhost:%d/metrics\n",
+						    arv_metrics_exporter_get_port (exporter));
+				    } else {
+					    printf ("Can't start metrics exporter: %s\n", error->message);
+					    g_clear_error (&error);
+				    }
+			    }
+
 			    data.main_loop = g_main_loop_new (NULL, FALSE);
 
 			    old_sigint_handler = signal (SIGINT, set_cancel);
@@ -591,6 +1190,8 @@ main (int argc, char **argv)
 
 			    g_main_loop_unref (data.main_loop);
 
+			    g_clear_object (&exporter);
+
 			    arv_stream_get_statistics (stream, &n_completed_buffers, &n_failures, &n_underruns);
 
 			    g_print ("Completed buffers = %" G_GUINT64_FORMAT "\n", n_completed_buffers);
@@ -599,8 +1200,24 @@ main (int argc, char **argv)
 
 			    arv_camera_stop_acquisition (camera, NULL);
 
+			    if (arv_option_event_ring_filename != NULL && arv_option_event_ring_failures <= 0) {
+				    GError *ring_error = NULL;
+
+				    if (!arv_stream_dump_event_ring (stream, arv_option_event_ring_filename, &ring_error)) {
+					    printf ("Failed to save the event ring: %s\n", ring_error->message);
+					    g_clear_error (&ring_error);
+				    }
+			    }
+
+			    if (data.cost_statistic != NULL)
+				    print_frame_cost_histograms (&data);
+
+			    if (data.trigger_statistic != NULL)
+				    print_trigger_latency (&data);
+
 			    arv_stream_set_emit_signals (stream, FALSE);
 
+			    data.stream = NULL;
 			    g_object_unref (stream);
 		    } else {
 			    printf ("Can't create stream thread%s%s\n",
@@ -623,6 +1240,12 @@ main (int argc, char **argv)
 		g_strfreev (data.chunks);
 
 	g_clear_object (&data.chunk_parser);
+	g_clear_pointer (&data.cost_statistic, arv_statistic_free);
+	g_mutex_clear (&data.cost_mutex);
+	g_clear_pointer (&data.trigger_statistic, arv_statistic_free);
+	if (data.triggers != NULL)
+		g_array_unref (data.triggers);
+	g_mutex_clear (&data.trigger_mutex);
 
 	return 0;
 }
@@ -0,0 +1,287 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2019 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel@gnome.org>
+ */
+
+/*
+ * CRC32C, computed with the crc32 instruction of SSE 4.2 or of the ARMv8 CRC extension, and with a table otherwise.
+ * The CRCs of separately computed blocks can be combined, which lets the stream threads checksum the data blocks in
+ * their arrival order. The combination follows the zlib one, with the Castagnoli polynomial.
+ */
+
+#include <arvchecksumprivate.h>
+#include <arvdebugprivate.h>
+#include <string.h>
+
+#if defined (__GNUC__) && defined (__x86_64__)
+#define ARV_CHECKSUM_HAS_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined (__GNUC__) && defined (__aarch64__)
+#define ARV_CHECKSUM_HAS_ARM_CRC 1
+#include <arm_acle.h>
+#if defined (__linux__)
+#include <sys/auxv.h>
+#endif
+#endif
+
+/* Reversed Castagnoli polynomial */
+#define ARV_CRC32C_POLYNOMIAL	0x82f63b78
+
+static guint32 crc32c_table[256];
+/* x^(2^n) modulo the polynomial */
+static guint32 crc32c_x2n_table[32];
+
+/* Product of two polynomials modulo the CRC polynomial, x^0 being represented by the bit 31 */
+
+static guint32
+_multiply_modulo (guint32 a, guint32 b)
+{
+	guint32 m = 1U << 31;
+	guint32 p = 0;
+
+	for (;;) {
+		if (a & m) {
+			p ^= b;
+			if ((a & (m - 1)) == 0)
+				break;
+		}
+		m >>= 1;
+		b = (b & 1) ? (b >> 1) ^ ARV_CRC32C_POLYNOMIAL : b >> 1;
+	}
+
+	return p;
+}
+
+static void
+_init_tables (void)
+{
+	static gsize initialized = 0;
+
+	if (g_once_init_enter (&initialized)) {
+		guint32 p;
+		unsigned int i, j;
+
+		for (i = 0; i < 256; i++) {
+			guint32 crc = i;
+
+			for (j = 0; j < 8; j++)
+				crc = (crc & 1) ? (crc >> 1) ^ ARV_CRC32C_POLYNOMIAL : crc >> 1;
+
+			crc32c_table[i] = crc;
+		}
+
+		/* x^1 */
+		p = 1U << 30;
+		crc32c_x2n_table[0] = p;
+		for (i = 1; i < 32; i++) {
+			p = _multiply_modulo (p, p);
+			crc32c_x2n_table[i] = p;
+		}
+
+		g_once_init_leave (&initialized, 1);
+	}
+}
+
+/* Kernels working on the unconditioned CRC */
+
+static guint32
+_crc32c_table (guint32 crc, const guint8 *data, size_t size)
+{
+	for (; size > 0; size--, data++)
+		crc = crc32c_table[(crc ^ *data) & 0xff] ^ (crc >> 8);
+
+	return crc;
+}
+
+#ifdef ARV_CHECKSUM_HAS_X86
+
+__attribute__ ((target ("sse4.2"))) static guint32
+_crc32c_sse42 (guint32 crc, const guint8 *data, size_t size)
+{
+	guint64 crc64;
+
+	for (; size > 0 && ((guintptr) data & 7) != 0; size--, data++)
+		crc = _mm_crc32_u8 (crc, *data);
+
+	crc64 = crc;
+	for (; size >= 32; size -= 32, data += 32) {
+		crc64 = _mm_crc32_u64 (crc64, *(const guint64 *) data);
+		crc64 = _mm_crc32_u64 (crc64, *(const guint64 *) (data + 8));
+		crc64 = _mm_crc32_u64 (crc64, *(const guint64 *) (data + 16));
+		crc64 = _mm_crc32_u64 (crc64, *(const guint64 *) (data + 24));
+	}
+	for (; size >= 8; size -= 8, data += 8)
+		crc64 = _mm_crc32_u64 (crc64, *(const guint64 *) data);
+	crc = (guint32) crc64;
+
+	for (; size > 0; size--, data++)
+		crc = _mm_crc32_u8 (crc, *data);
+
+	return crc;
+}
+
+#endif
+
+#ifdef ARV_CHECKSUM_HAS_ARM_CRC
+
+__attribute__ ((target ("+crc"))) static guint32
+_crc32c_arm (guint32 crc, const guint8 *data, size_t size)
+{
+	for (; size > 0 && ((guintptr) data & 7) != 0; size--, data++)
+		crc = __crc32cb (crc, *data);
+
+	for (; size >= 32; size -= 32, data += 32) {
+		crc = __crc32cd (crc, *(const guint64 *) data);
+		crc = __crc32cd (crc, *(const guint64 *) (data + 8));
+		crc = __crc32cd (crc, *(const guint64 *) (data + 16));
+		crc = __crc32cd (crc, *(const guint64 *) (data + 24));
+	}
+	for (; size >= 8; size -= 8, data += 8)
+		crc = __crc32cd (crc, *(const guint64 *) data);
+
+	for (; size > 0; size--, data++)
+		crc = __crc32cb (crc, *data);
+
+	return crc;
+}
+
+#endif
+
+static gint arv_checksum_simd = -1;
+
+gboolean
+arv_checksum_is_simd_supported (ArvChecksumSimd simd)
+{
+	switch (simd) {
+		case ARV_CHECKSUM_SIMD_NONE:
+			return TRUE;
+#ifdef ARV_CHECKSUM_HAS_X86
+		case ARV_CHECKSUM_SIMD_SSE42:
+			return __builtin_cpu_supports ("sse4.2");
+#endif
+#ifdef ARV_CHECKSUM_HAS_ARM_CRC
+		case ARV_CHECKSUM_SIMD_ARM_CRC:
+#if defined (__linux__)
+			return (getauxval (AT_HWCAP) & HWCAP_CRC32) != 0;
+#else
+			return TRUE;
+#endif
+#endif
+		default:
+			return FALSE;
+	}
+}
+
+/* Selects the crc32 instruction on first use, when available */
+
+ArvChecksumSimd
+arv_checksum_get_simd (void)
+{
+	gint simd = g_atomic_int_get (&arv_checksum_simd);
+
+	if (simd < 0) {
+		if (arv_checksum_is_simd_supported (ARV_CHECKSUM_SIMD_SSE42))
+			simd = ARV_CHECKSUM_SIMD_SSE42;
+		else if (arv_checksum_is_simd_supported (ARV_CHECKSUM_SIMD_ARM_CRC))
+			simd = ARV_CHECKSUM_SIMD_ARM_CRC;
+		else
+			simd = ARV_CHECKSUM_SIMD_NONE;
+
+		arv_info_misc ("[Checksum::get_simd] Using instruction set %d", simd);
+
+		g_atomic_int_set (&arv_checksum_simd, simd);
+	}
+
+	return simd;
+}
+
+/* Forces the instruction set, used for comparing the kernels */
+
+gboolean
+arv_checksum_set_simd (ArvChecksumSimd simd)
+{
+	if (!arv_checksum_is_simd_supported (simd))
+		return FALSE;
+
+	g_atomic_int_set (&arv_checksum_simd, simd);
+
+	return TRUE;
+}
+
+/* Returns the CRC32C of @data appended to a block of CRC @crc, 0 for the first block */
+
+guint32
+arv_crc32c (guint32 crc, const void *data, size_t size)
+{
+	crc = ~crc;
+
+	switch (arv_checksum_get_simd ()) {
+#ifdef ARV_CHECKSUM_HAS_X86
+		case ARV_CHECKSUM_SIMD_SSE42:
+			crc = _crc32c_sse42 (crc, data, size);
+			break;
+#endif
+#ifdef ARV_CHECKSUM_HAS_ARM_CRC
+		case ARV_CHECKSUM_SIMD_ARM_CRC:
+			crc = _crc32c_arm (crc, data, size);
+			break;
+#endif
+		default:
+			_init_tables ();
+			crc = _crc32c_table (crc, data, size);
+			break;
+	}
+
+	return ~crc;
+}
+
+/* Returns x^(8 * size2) modulo the polynomial, the operator shifting a CRC over size2 null bytes */
+
+guint32
+arv_crc32c_combine_gen (size_t size2)
+{
+	guint32 p = 1U << 31;
+	unsigned int k = 3;
+
+	_init_tables ();
+
+	for (; size2 > 0; size2 >>= 1, k++) {
+		if (size2 & 1)
+			p = _multiply_modulo (crc32c_x2n_table[k & 31], p);
+	}
+
+	return p;
+}
+
+guint32
+arv_crc32c_combine_op (guint32 crc1, guint32 crc2, guint32 op)
+{
+	return _multiply_modulo (op, crc1) ^ crc2;
+}
+
+/* Returns the CRC of the concatenation of two blocks, from their CRCs and the size of the second one */
+
+guint32
+arv_crc32c_combine (guint32 crc1, guint32 crc2, size_t size2)
+{
+	return arv_crc32c_combine_op (crc1, crc2, arv_crc32c_combine_gen (size2));
+}
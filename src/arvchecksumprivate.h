@@ -0,0 +1,58 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2019 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel@gnome.org>
+ */
+
+#ifndef ARV_CHECKSUM_PRIVATE_H
+#define ARV_CHECKSUM_PRIVATE_H
+
+#if !defined (ARV_H_INSIDE) && !defined (ARAVIS_COMPILATION)
+#error "Only <arv.h> can be included directly."
+#endif
+
+#include <arvtypes.h>
+
+G_BEGIN_DECLS
+
+/* CRC32C (Castagnoli) of the received payloads. The values are conditioned like the zlib crc32 ones: an empty
+ * block has a null CRC, which is also the initial value for an incremental computation. */
+
+typedef enum {
+	ARV_CHECKSUM_SIMD_NONE,
+	ARV_CHECKSUM_SIMD_SSE42,
+	ARV_CHECKSUM_SIMD_ARM_CRC
+} ArvChecksumSimd;
+
+ArvChecksumSimd	arv_checksum_get_simd		(void);
+gboolean	arv_checksum_set_simd		(ArvChecksumSimd simd);
+gboolean	arv_checksum_is_simd_supported	(ArvChecksumSimd simd);
+
+guint32		arv_crc32c			(guint32 crc, const void *data, size_t size);
+
+/* Combination of the CRCs of two consecutive blocks, for the blocks received out of order. The operator of a given
+ * second block size is computed once by arv_crc32c_combine_gen(), and applied by arv_crc32c_combine_op(). */
+
+guint32		arv_crc32c_combine		(guint32 crc1, guint32 crc2, size_t size2);
+guint32		arv_crc32c_combine_gen		(size_t size2);
+guint32		arv_crc32c_combine_op		(guint32 crc1, guint32 crc2, guint32 op);
+
+G_END_DECLS
+
+#endif
@@ -43,6 +43,14 @@
  * </xi:include>
  * </programlisting>
  * </example>
+ *
+ * When the same chunks are read from each frame, arv_chunk_parser_compile_plan() resolves the chunk features once
+ * into a #ArvChunkPlan. Chunk features directly implemented by an integer or float register on a chunk port are then
+ * decoded straight from the chunk data by arv_chunk_plan_apply(), without going through the Genicam node tree.
+ *
+ * The buffer passed to the chunk parser functions is only bound to the calling thread for the duration of the call,
+ * which allows several threads to extract the chunk data of different buffers with the same parser or plan. The
+ * string returned by arv_chunk_parser_get_string_value() is however only valid until the next read of the same chunk.
  */
 
 #include <arvchunkparserprivate.h>
@@ -51,7 +59,18 @@
 #include <arvgcfloat.h>
 #include <arvgcstring.h>
 #include <arvgcboolean.h>
+#include <arvgcregister.h>
+#include <arvgcport.h>
+#include <arvgcintregnode.h>
+#include <arvgcmaskedintregnode.h>
+#include <arvgcfloatregnode.h>
+#include <arvgcpropertynode.h>
+#include <arvgcregisternodeprivate.h>
+#include <arvgcprivate.h>
+#include <arvdomnode.h>
+#include <arvmiscprivate.h>
 #include <arvdebugprivate.h>
+#include <string.h>
 
 enum {
 	ARV_CHUNK_PARSER_PROPERTY_0,
@@ -81,6 +100,24 @@ struct _ArvChunkParserClass {
 
 G_DEFINE_TYPE_WITH_CODE (ArvChunkParser, arv_chunk_parser, G_TYPE_OBJECT, G_ADD_PRIVATE (ArvChunkParser))
 
+/* The chunk buffer is bound to a feature access of the calling thread instead of being set on the shared genicam
+ * document, which allows concurrent parsing of different buffers. */
+
+static ArvBuffer *
+_bind_buffer (ArvGc *genicam, ArvBuffer *buffer)
+{
+	arv_gc_access_begin (genicam, FALSE);
+
+	return arv_gc_access_bind_buffer (genicam, buffer);
+}
+
+static void
+_unbind_buffer (ArvGc *genicam, ArvBuffer *previous)
+{
+	arv_gc_access_bind_buffer (genicam, previous);
+	arv_gc_access_end (genicam);
+}
+
 /**
  * arv_chunk_parser_get_boolean_value:
  * @parser: a #ArvChunkParser
@@ -95,13 +132,14 @@ gboolean
 arv_chunk_parser_get_boolean_value (ArvChunkParser *parser, ArvBuffer *buffer, const char *chunk, GError **error)
 {
 	ArvGcNode *node;
+	ArvBuffer *previous;
 	gboolean value = FALSE;
 
 	g_return_val_if_fail (ARV_IS_CHUNK_PARSER (parser), 0.0);
 	g_return_val_if_fail (ARV_IS_BUFFER (buffer), 0.0);
 
 	node = arv_gc_get_node (parser->priv->genicam, chunk);
-	arv_gc_set_buffer (parser->priv->genicam, buffer);
+	previous = _bind_buffer (parser->priv->genicam, buffer);
 
 	if (ARV_IS_GC_BOOLEAN (node)) {
 		GError *local_error = NULL;
@@ -117,6 +155,8 @@ arv_chunk_parser_get_boolean_value (ArvChunkParser *parser, ArvBuffer *buffer, c
 			     "Node '%s' is not a boolean", chunk);
 	}
 
+	_unbind_buffer (parser->priv->genicam, previous);
+
 	return value;
 }
 
@@ -134,13 +174,14 @@ const char *
 arv_chunk_parser_get_string_value (ArvChunkParser *parser, ArvBuffer *buffer, const char *chunk, GError **error)
 {
 	ArvGcNode *node;
+	ArvBuffer *previous;
 	const char *string = NULL;
 
 	g_return_val_if_fail (ARV_IS_CHUNK_PARSER (parser), NULL);
 	g_return_val_if_fail (ARV_IS_BUFFER (buffer), NULL);
 
 	node = arv_gc_get_node (parser->priv->genicam, chunk);
-	arv_gc_set_buffer (parser->priv->genicam, buffer);
+	previous = _bind_buffer (parser->priv->genicam, buffer);
 
 	if (ARV_IS_GC_STRING (node)) {
 		GError *local_error = NULL;
@@ -156,6 +197,8 @@ arv_chunk_parser_get_string_value (ArvChunkParser *parser, ArvBuffer *buffer, co
 			     "Node '%s' is not a string", chunk);
 	}
 
+	_unbind_buffer (parser->priv->genicam, previous);
+
 	return string;
 }
 
@@ -173,13 +216,14 @@ gint64
 arv_chunk_parser_get_integer_value (ArvChunkParser *parser, ArvBuffer *buffer, const char *chunk, GError **error)
 {
 	ArvGcNode *node;
+	ArvBuffer *previous;
 	gint64 value = 0;
 
 	g_return_val_if_fail (ARV_IS_CHUNK_PARSER (parser), 0.0);
 	g_return_val_if_fail (ARV_IS_BUFFER (buffer), 0.0);
 
 	node = arv_gc_get_node (parser->priv->genicam, chunk);
-	arv_gc_set_buffer (parser->priv->genicam, buffer);
+	previous = _bind_buffer (parser->priv->genicam, buffer);
 
 	if (ARV_IS_GC_INTEGER (node)) {
 		GError *local_error = NULL;
@@ -195,6 +239,8 @@ arv_chunk_parser_get_integer_value (ArvChunkParser *parser, ArvBuffer *buffer, c
 			     "Node '%s' is not an integer", chunk);
 	}
 
+	_unbind_buffer (parser->priv->genicam, previous);
+
 	return value;
 }
 
@@ -212,13 +258,14 @@ double
 arv_chunk_parser_get_float_value (ArvChunkParser *parser, ArvBuffer *buffer, const char *chunk, GError **error)
 {
 	ArvGcNode *node;
+	ArvBuffer *previous;
 	double value = 0.0;
 
 	g_return_val_if_fail (ARV_IS_CHUNK_PARSER (parser), 0.0);
 	g_return_val_if_fail (ARV_IS_BUFFER (buffer), 0.0);
 
 	node = arv_gc_get_node (parser->priv->genicam, chunk);
-	arv_gc_set_buffer (parser->priv->genicam, buffer);
+	previous = _bind_buffer (parser->priv->genicam, buffer);
 
 	if (ARV_IS_GC_FLOAT (node)) {
 		GError *local_error = NULL;
@@ -234,9 +281,357 @@ arv_chunk_parser_get_float_value (ArvChunkParser *parser, ArvBuffer *buffer, con
 			     "Node '%s' is not a float", chunk);
 	}
 
+	_unbind_buffer (parser->priv->genicam, previous);
+
 	return value;
 }
 
+typedef enum {
+	ARV_CHUNK_PLAN_ENTRY_TYPE_INTEGER,
+	ARV_CHUNK_PLAN_ENTRY_TYPE_FLOAT,
+	ARV_CHUNK_PLAN_ENTRY_TYPE_BOOLEAN,
+	ARV_CHUNK_PLAN_ENTRY_TYPE_DIRECT_INTEGER,
+	ARV_CHUNK_PLAN_ENTRY_TYPE_DIRECT_FLOAT
+} ArvChunkPlanEntryType;
+
+typedef struct {
+	ArvChunkPlanEntryType type;
+	ArvGcNode *node;
+
+	/* Direct access only */
+	guint32 chunk_id;
+	gint64 address;
+	gint64 length;
+	guint endianness;
+	ArvGcSignedness signedness;
+	gboolean is_masked;
+	guint lsb;
+	guint msb;
+} ArvChunkPlanEntry;
+
+struct _ArvChunkPlan {
+	GObject	object;
+
+	ArvChunkParser *parser;
+
+	ArvChunkPlanEntry *entries;
+	guint n_entries;
+};
+
+struct _ArvChunkPlanClass {
+	GObjectClass parent_class;
+};
+
+G_DEFINE_TYPE (ArvChunkPlan, arv_chunk_plan, G_TYPE_OBJECT)
+
+static ArvGcPropertyNode *
+_find_property_node (ArvGcNode *node, ArvGcPropertyNodeType type)
+{
+	ArvDomNode *iter;
+
+	for (iter = arv_dom_node_get_first_child (ARV_DOM_NODE (node));
+	     iter != NULL;
+	     iter = arv_dom_node_get_next_sibling (iter)) {
+		if (ARV_IS_GC_PROPERTY_NODE (iter) &&
+		    arv_gc_property_node_get_node_type (ARV_GC_PROPERTY_NODE (iter)) == type)
+			return ARV_GC_PROPERTY_NODE (iter);
+	}
+
+	return NULL;
+}
+
+/* Fills the direct access part of the entry if the node is a register on a chunk port, with a static address */
+
+static gboolean
+_compile_direct_entry (ArvChunkPlanEntry *entry)
+{
+	ArvGcPropertyNode *property_node;
+	ArvGcNode *port;
+	const char *chunk_id;
+	GError *local_error = NULL;
+
+	if (!ARV_IS_GC_INT_REG_NODE (entry->node) &&
+	    !ARV_IS_GC_MASKED_INT_REG_NODE (entry->node) &&
+	    !ARV_IS_GC_FLOAT_REG_NODE (entry->node))
+		return FALSE;
+
+	property_node = _find_property_node (entry->node, ARV_GC_PROPERTY_NODE_TYPE_P_PORT);
+	if (property_node == NULL)
+		return FALSE;
+
+	port = arv_gc_property_node_get_linked_node (property_node);
+	if (!ARV_IS_GC_PORT (port))
+		return FALSE;
+
+	property_node = _find_property_node (port, ARV_GC_PROPERTY_NODE_TYPE_CHUNK_ID);
+	if (property_node == NULL)
+		return FALSE;
+
+	chunk_id = arv_gc_property_node_get_string (property_node, &local_error);
+	if (local_error == NULL)
+		entry->address = arv_gc_register_get_address (ARV_GC_REGISTER (entry->node), &local_error);
+	if (local_error == NULL)
+		entry->length = arv_gc_register_get_length (ARV_GC_REGISTER (entry->node), &local_error);
+	if (local_error != NULL) {
+		g_clear_error (&local_error);
+		return FALSE;
+	}
+
+	entry->chunk_id = g_ascii_strtoll (chunk_id, NULL, 16);
+	entry->endianness = arv_gc_property_node_get_endianness
+		(_find_property_node (entry->node, ARV_GC_PROPERTY_NODE_TYPE_ENDIANNESS), G_LITTLE_ENDIAN);
+
+	if (ARV_IS_GC_FLOAT_REG_NODE (entry->node)) {
+		if (entry->length != 4 && entry->length != 8)
+			return FALSE;
+
+		entry->type = ARV_CHUNK_PLAN_ENTRY_TYPE_DIRECT_FLOAT;
+
+		return TRUE;
+	}
+
+	if (entry->length < 1 || entry->length > 8)
+		return FALSE;
+
+	entry->signedness = arv_gc_property_node_get_sign
+		(_find_property_node (entry->node, ARV_GC_PROPERTY_NODE_TYPE_SIGN), ARV_GC_SIGNEDNESS_UNSIGNED);
+	entry->is_masked = ARV_IS_GC_MASKED_INT_REG_NODE (entry->node);
+	if (entry->is_masked) {
+		property_node = _find_property_node (entry->node, ARV_GC_PROPERTY_NODE_TYPE_BIT);
+		if (property_node != NULL) {
+			entry->lsb = arv_gc_property_node_get_lsb (property_node, 0);
+			entry->msb = entry->lsb;
+		} else {
+			entry->lsb = arv_gc_property_node_get_lsb
+				(_find_property_node (entry->node, ARV_GC_PROPERTY_NODE_TYPE_LSB), 0);
+			entry->msb = arv_gc_property_node_get_msb
+				(_find_property_node (entry->node, ARV_GC_PROPERTY_NODE_TYPE_MSB), 31);
+		}
+	}
+
+	entry->type = ARV_CHUNK_PLAN_ENTRY_TYPE_DIRECT_INTEGER;
+
+	return TRUE;
+}
+
+/**
+ * arv_chunk_parser_compile_plan:
+ * @parser: a #ArvChunkParser
+ * @chunks: (array zero-terminated=1): a %NULL terminated list of chunk feature names
+ * @error: a #GError placeholder
+ *
+ * Resolves a set of chunk features once, for their repeated extraction from the stream buffers using
+ * arv_chunk_plan_apply(). Integer, float and boolean chunk features are supported. The chunk layout is assumed to be
+ * static, the plan must be compiled again if a feature modifying the chunk addresses is changed.
+ *
+ * Returns: (transfer full): a new #ArvChunkPlan, %NULL on error
+ *
+ * Since: 0.8.11
+ */
+
+ArvChunkPlan *
+arv_chunk_parser_compile_plan (ArvChunkParser *parser, const char **chunks, GError **error)
+{
+	ArvChunkPlan *plan;
+	guint n_chunks;
+	guint i;
+
+	g_return_val_if_fail (ARV_IS_CHUNK_PARSER (parser), NULL);
+	g_return_val_if_fail (chunks != NULL, NULL);
+
+	n_chunks = g_strv_length ((char **) chunks);
+
+	plan = g_object_new (ARV_TYPE_CHUNK_PLAN, NULL);
+	plan->parser = g_object_ref (parser);
+	plan->entries = g_new0 (ArvChunkPlanEntry, n_chunks);
+	plan->n_entries = n_chunks;
+
+	for (i = 0; i < n_chunks; i++) {
+		ArvChunkPlanEntry *entry = &plan->entries[i];
+
+		entry->node = arv_gc_get_node (parser->priv->genicam, chunks[i]);
+
+		if (ARV_IS_GC_BOOLEAN (entry->node)) {
+			entry->type = ARV_CHUNK_PLAN_ENTRY_TYPE_BOOLEAN;
+		} else if (ARV_IS_GC_INTEGER (entry->node) || ARV_IS_GC_FLOAT (entry->node)) {
+			if (!_compile_direct_entry (entry))
+				entry->type = ARV_IS_GC_INTEGER (entry->node) ?
+					ARV_CHUNK_PLAN_ENTRY_TYPE_INTEGER :
+					ARV_CHUNK_PLAN_ENTRY_TYPE_FLOAT;
+		} else {
+			g_set_error (error, ARV_CHUNK_PARSER_ERROR, ARV_CHUNK_PARSER_ERROR_INVALID_FEATURE_TYPE,
+				     "Node '%s' is not an integer, a float or a boolean", chunks[i]);
+			g_object_unref (plan);
+			return NULL;
+		}
+
+		arv_debug_chunk ("[ChunkParser::compile_plan] %s: %s", chunks[i],
+				 entry->type == ARV_CHUNK_PLAN_ENTRY_TYPE_DIRECT_INTEGER ||
+				 entry->type == ARV_CHUNK_PLAN_ENTRY_TYPE_DIRECT_FLOAT ?
+				 "direct access" : "genicam access");
+	}
+
+	return plan;
+}
+
+/**
+ * arv_chunk_plan_get_n_chunks:
+ * @plan: a #ArvChunkPlan
+ *
+ * Returns: the number of chunk values filled by arv_chunk_plan_apply().
+ *
+ * Since: 0.8.11
+ */
+
+guint
+arv_chunk_plan_get_n_chunks (ArvChunkPlan *plan)
+{
+	g_return_val_if_fail (ARV_IS_CHUNK_PLAN (plan), 0);
+
+	return plan->n_entries;
+}
+
+/**
+ * arv_chunk_plan_apply:
+ * @plan: a #ArvChunkPlan
+ * @buffer: a #ArvBuffer with a #ARV_BUFFER_PAYLOAD_TYPE_CHUNK_DATA payload
+ * @values: (array) (out caller-allocates): an array of arv_chunk_plan_get_n_chunks() values to fill, in the order of the
+ * compiled chunk features
+ * @error: a #GError placeholder
+ *
+ * Extracts all the chunk values of @plan from @buffer in one pass. All the values are filled, even if one of the
+ * chunks is not found, in which case its is_valid field is set to %FALSE and the error of the first missing chunk is
+ * returned.
+ *
+ * Returns: %TRUE if all the chunk values were extracted.
+ *
+ * Since: 0.8.11
+ */
+
+gboolean
+arv_chunk_plan_apply (ArvChunkPlan *plan, ArvBuffer *buffer, ArvChunkValue *values, GError **error)
+{
+	ArvBuffer *previous = NULL;
+	gboolean uses_genicam = FALSE;
+	gboolean success = TRUE;
+	guint i;
+
+	g_return_val_if_fail (ARV_IS_CHUNK_PLAN (plan), FALSE);
+	g_return_val_if_fail (ARV_IS_BUFFER (buffer), FALSE);
+	g_return_val_if_fail (values != NULL, FALSE);
+
+	for (i = 0; i < plan->n_entries; i++) {
+		ArvChunkPlanEntry *entry = &plan->entries[i];
+		GError *local_error = NULL;
+		const unsigned char *chunk_data = NULL;
+		size_t chunk_data_size = 0;
+
+		values[i].v_int64 = 0;
+		values[i].v_double = 0.0;
+		values[i].is_valid = FALSE;
+
+		if (entry->type == ARV_CHUNK_PLAN_ENTRY_TYPE_DIRECT_INTEGER ||
+		    entry->type == ARV_CHUNK_PLAN_ENTRY_TYPE_DIRECT_FLOAT) {
+			chunk_data = arv_buffer_has_chunks (buffer) ?
+				arv_buffer_get_chunk_data (buffer, entry->chunk_id, &chunk_data_size) : NULL;
+			if (chunk_data == NULL || chunk_data_size < entry->address)
+				g_set_error (&local_error, ARV_CHUNK_PARSER_ERROR, ARV_CHUNK_PARSER_ERROR_CHUNK_NOT_FOUND,
+					     "[ChunkPlan::apply] Chunk 0x%08x not found", entry->chunk_id);
+		} else if (!uses_genicam) {
+			previous = _bind_buffer (plan->parser->priv->genicam, buffer);
+			uses_genicam = TRUE;
+		}
+
+		if (local_error == NULL) {
+			switch (entry->type) {
+				case ARV_CHUNK_PLAN_ENTRY_TYPE_DIRECT_INTEGER:
+				case ARV_CHUNK_PLAN_ENTRY_TYPE_DIRECT_FLOAT:
+					{
+						guint8 data[8] = {0};
+
+						memcpy (data, chunk_data + entry->address,
+							MIN (chunk_data_size - entry->address, entry->length));
+
+						if (entry->type == ARV_CHUNK_PLAN_ENTRY_TYPE_DIRECT_INTEGER) {
+							values[i].v_int64 = arv_gc_register_node_decode_integer_value
+								(data, entry->length, entry->lsb, entry->msb,
+								 entry->signedness, entry->endianness,
+								 entry->is_masked);
+							values[i].v_double = values[i].v_int64;
+						} else if (entry->length == 4) {
+							float v_float;
+
+							arv_copy_memory_with_endianness (&v_float, sizeof (v_float), G_BYTE_ORDER,
+											data, 4, entry->endianness);
+							values[i].v_double = v_float;
+							values[i].v_int64 = v_float;
+						} else {
+							arv_copy_memory_with_endianness (&values[i].v_double, sizeof (double),
+											G_BYTE_ORDER,
+											data, 8, entry->endianness);
+							values[i].v_int64 = values[i].v_double;
+						}
+					}
+					break;
+				case ARV_CHUNK_PLAN_ENTRY_TYPE_INTEGER:
+					values[i].v_int64 = arv_gc_integer_get_value (ARV_GC_INTEGER (entry->node),
+										      &local_error);
+					values[i].v_double = values[i].v_int64;
+					break;
+				case ARV_CHUNK_PLAN_ENTRY_TYPE_FLOAT:
+					values[i].v_double = arv_gc_float_get_value (ARV_GC_FLOAT (entry->node),
+										     &local_error);
+					values[i].v_int64 = values[i].v_double;
+					break;
+				case ARV_CHUNK_PLAN_ENTRY_TYPE_BOOLEAN:
+					values[i].v_int64 = arv_gc_boolean_get_value (ARV_GC_BOOLEAN (entry->node),
+										      &local_error) ? 1 : 0;
+					values[i].v_double = values[i].v_int64;
+					break;
+			}
+		}
+
+		if (local_error != NULL) {
+			arv_warning_chunk ("%s", local_error->message);
+			if (success)
+				g_propagate_error (error, local_error);
+			else
+				g_error_free (local_error);
+			success = FALSE;
+		} else
+			values[i].is_valid = TRUE;
+	}
+
+	if (uses_genicam)
+		_unbind_buffer (plan->parser->priv->genicam, previous);
+
+	return success;
+}
+
+static void
+arv_chunk_plan_init (ArvChunkPlan *plan)
+{
+}
+
+static void
+arv_chunk_plan_finalize (GObject *object)
+{
+	ArvChunkPlan *plan = ARV_CHUNK_PLAN (object);
+
+	g_clear_object (&plan->parser);
+	g_clear_pointer (&plan->entries, g_free);
+
+	G_OBJECT_CLASS (arv_chunk_plan_parent_class)->finalize (object);
+}
+
+static void
+arv_chunk_plan_class_init (ArvChunkPlanClass *plan_class)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS (plan_class);
+
+	object_class->finalize = arv_chunk_plan_finalize;
+}
+
 /**
  * arv_chunk_parser_new:
  * @xml: XML genicam data
@@ -52,6 +52,9 @@ typedef enum {
 #define ARV_TYPE_CHUNK_PARSER             (arv_chunk_parser_get_type ())
 G_DECLARE_FINAL_TYPE (ArvChunkParser, arv_chunk_parser, ARV, CHUNK_PARSER, GObject)
 
+#define ARV_TYPE_CHUNK_PLAN             (arv_chunk_plan_get_type ())
+G_DECLARE_FINAL_TYPE (ArvChunkPlan, arv_chunk_plan, ARV, CHUNK_PLAN, GObject)
+
 ArvChunkParser *	arv_chunk_parser_new 			(const char *xml, gsize size);
 gboolean		arv_chunk_parser_get_boolean_value	(ArvChunkParser *parser, ArvBuffer *buffer,
 								 const char *chunk, GError **error);
@@ -62,6 +65,12 @@ gint64			arv_chunk_parser_get_integer_value	(ArvChunkParser *parser, ArvBuffer *
 double			arv_chunk_parser_get_float_value	(ArvChunkParser *parser, ArvBuffer *buffer,
 								 const char *chunk, GError **error);
 
+ArvChunkPlan *		arv_chunk_parser_compile_plan		(ArvChunkParser *parser, const char **chunks,
+								 GError **error);
+guint			arv_chunk_plan_get_n_chunks		(ArvChunkPlan *plan);
+gboolean		arv_chunk_plan_apply			(ArvChunkPlan *plan, ArvBuffer *buffer,
+								 ArvChunkValue *values, GError **error);
+
 G_END_DECLS
 
 #endif
@@ -0,0 +1,242 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2019 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel@gnome.org>
+ */
+
+/*< private >
+ * SECTION: arvclockmodel
+ * @short_description: Device to host clock mapping
+ *
+ * Device timestamps and host times are two unrelated clocks, running at slightly different rates. #ArvClockModel fits
+ * a linear mapping between them, from pairs of device timestamps and host reception times.
+ *
+ * The reception time is the sum of the transmission time and of a positive, randomly distributed delay, so the sample
+ * with the smallest delay is the closest to the actual relation between the clocks. Only this sample is retained for
+ * each %ARV_CLOCK_MODEL_INTERVAL_NS interval of device time. The drift is estimated by a least squares fit over a
+ * sliding window of these interval minima, and the offset is taken from their lower envelope.
+ *
+ * A sample too far from the prediction, or going back in time, means the device clock jumped, for example after a
+ * timestamp reset or a PTP resynchronization, and restarts the fit.
+ */
+
+#include <arvclockmodelprivate.h>
+#include <math.h>
+
+typedef struct {
+	guint64 device_time_ns;
+	guint64 host_time_ns;
+} ArvClockSample;
+
+struct _ArvClockModel {
+	/* Smallest delay sample of each interval, the last one being the current interval */
+	ArvClockSample *samples;
+	guint n_samples_max;
+	guint n_samples;
+	guint first_sample;
+	guint64 interval_start_ns;
+
+	/* host = origin_host + (device - origin_device) * (1 + drift) + offset */
+	guint64 origin_device_ns;
+	guint64 origin_host_ns;
+	double drift;
+	double offset_ns;
+
+	guint n_resets;
+};
+
+ArvClockModel *
+arv_clock_model_new (guint n_samples)
+{
+	ArvClockModel *model;
+
+	g_return_val_if_fail (n_samples >= ARV_CLOCK_MODEL_N_SAMPLES_MIN, NULL);
+
+	model = g_new0 (ArvClockModel, 1);
+	model->samples = g_new0 (ArvClockSample, n_samples);
+	model->n_samples_max = n_samples;
+
+	return model;
+}
+
+void
+arv_clock_model_free (ArvClockModel *model)
+{
+	if (model == NULL)
+		return;
+
+	g_free (model->samples);
+	g_free (model);
+}
+
+void
+arv_clock_model_reset (ArvClockModel *model)
+{
+	g_return_if_fail (model != NULL);
+
+	model->n_samples = 0;
+	model->first_sample = 0;
+	model->drift = 0.0;
+	model->offset_ns = 0.0;
+}
+
+static ArvClockSample *
+_get_sample (ArvClockModel *model, guint i)
+{
+	return &model->samples[(model->first_sample + i) % model->n_samples_max];
+}
+
+/* Host time elapsed since the origin, in excess of the device time, which grows with the drift and the delay */
+
+static double
+_get_excess_ns (ArvClockModel *model, ArvClockSample *sample, double *x)
+{
+	*x = (double) (gint64) (sample->device_time_ns - model->origin_device_ns);
+
+	return (double) (gint64) (sample->host_time_ns - model->origin_host_ns) - *x;
+}
+
+static void
+_fit (ArvClockModel *model)
+{
+	double sum_x = 0.0, sum_y = 0.0, sum_xx = 0.0, sum_xy = 0.0;
+	double min_residual = G_MAXDOUBLE;
+	double x, y;
+	guint i;
+
+	model->origin_device_ns = _get_sample (model, 0)->device_time_ns;
+	model->origin_host_ns = _get_sample (model, 0)->host_time_ns;
+
+	if (model->n_samples >= ARV_CLOCK_MODEL_N_SAMPLES_MIN) {
+		double n = model->n_samples;
+		double variance;
+
+		for (i = 0; i < model->n_samples; i++) {
+			y = _get_excess_ns (model, _get_sample (model, i), &x);
+
+			sum_x += x;
+			sum_y += y;
+			sum_xx += x * x;
+			sum_xy += x * y;
+		}
+
+		variance = n * sum_xx - sum_x * sum_x;
+		model->drift = variance > 0.0 ? (n * sum_xy - sum_x * sum_y) / variance : 0.0;
+	} else
+		model->drift = 0.0;
+
+	for (i = 0; i < model->n_samples; i++) {
+		y = _get_excess_ns (model, _get_sample (model, i), &x);
+
+		min_residual = MIN (min_residual, y - model->drift * x);
+	}
+
+	model->offset_ns = min_residual;
+}
+
+guint64
+arv_clock_model_convert (ArvClockModel *model, guint64 device_time_ns)
+{
+	double x;
+
+	g_return_val_if_fail (model != NULL, 0);
+
+	if (model->n_samples == 0)
+		return 0;
+
+	x = (double) (gint64) (device_time_ns - model->origin_device_ns);
+
+	return model->origin_host_ns + (gint64) llround (x * (1.0 + model->drift) + model->offset_ns);
+}
+
+/*
+ * Adds a (device timestamp, host reception time) pair to the model, and returns @device_time_ns converted to the host
+ * time base.
+ */
+
+guint64
+arv_clock_model_add_sample (ArvClockModel *model, guint64 device_time_ns, guint64 host_time_ns)
+{
+	ArvClockSample *sample;
+
+	g_return_val_if_fail (model != NULL, host_time_ns);
+
+	if (model->n_samples > 0) {
+		gint64 error_ns;
+
+		error_ns = (gint64) (host_time_ns - arv_clock_model_convert (model, device_time_ns));
+
+		if (device_time_ns < _get_sample (model, model->n_samples - 1)->device_time_ns ||
+		    error_ns > ARV_CLOCK_MODEL_JUMP_THRESHOLD_NS ||
+		    error_ns < -ARV_CLOCK_MODEL_JUMP_THRESHOLD_NS) {
+			arv_clock_model_reset (model);
+			model->n_resets++;
+		}
+	}
+
+	if (model->n_samples == 0 ||
+	    device_time_ns - model->interval_start_ns >= ARV_CLOCK_MODEL_INTERVAL_NS) {
+		/* New interval, the oldest one is dropped when the window is full */
+		if (model->n_samples < model->n_samples_max)
+			model->n_samples++;
+		else
+			model->first_sample = (model->first_sample + 1) % model->n_samples_max;
+
+		model->interval_start_ns = device_time_ns;
+		sample = _get_sample (model, model->n_samples - 1);
+	} else {
+		sample = _get_sample (model, model->n_samples - 1);
+
+		/* Keep the sample with the smallest delay of the current interval */
+		if ((gint64) (host_time_ns - sample->host_time_ns) >=
+		    (gint64) (device_time_ns - sample->device_time_ns))
+			return arv_clock_model_convert (model, device_time_ns);
+	}
+
+	sample->device_time_ns = device_time_ns;
+	sample->host_time_ns = host_time_ns;
+
+	_fit (model);
+
+	return arv_clock_model_convert (model, device_time_ns);
+}
+
+gboolean
+arv_clock_model_is_valid (ArvClockModel *model)
+{
+	g_return_val_if_fail (model != NULL, FALSE);
+
+	return model->n_samples >= ARV_CLOCK_MODEL_N_SAMPLES_MIN;
+}
+
+double
+arv_clock_model_get_drift_ppm (ArvClockModel *model)
+{
+	g_return_val_if_fail (model != NULL, 0.0);
+
+	return model->drift * 1e6;
+}
+
+guint
+arv_clock_model_get_n_resets (ArvClockModel *model)
+{
+	g_return_val_if_fail (model != NULL, 0);
+
+	return model->n_resets;
+}
@@ -0,0 +1,62 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2019 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel@gnome.org>
+ */
+
+#ifndef ARV_CLOCK_MODEL_PRIVATE_H
+#define ARV_CLOCK_MODEL_PRIVATE_H
+
+#if !defined (ARV_H_INSIDE) && !defined (ARAVIS_COMPILATION)
+#error "Only <arv.h> can be included directly."
+#endif
+
+#include <arvtypes.h>
+
+G_BEGIN_DECLS
+
+/* Duration of the intervals over which the sample with the smallest delay is retained */
+#define ARV_CLOCK_MODEL_INTERVAL_NS		1000000000LL
+
+/* Number of intervals of the fitting window, longer for PTP disciplined device clocks, which are more stable */
+#define ARV_CLOCK_MODEL_N_SAMPLES_DEFAULT	64
+#define ARV_CLOCK_MODEL_N_SAMPLES_PTP		512
+
+/* Minimal number of intervals before the drift is estimated */
+#define ARV_CLOCK_MODEL_N_SAMPLES_MIN		2
+
+/* Prediction error above which the device clock is considered as having jumped */
+#define ARV_CLOCK_MODEL_JUMP_THRESHOLD_NS	100000000LL
+
+typedef struct _ArvClockModel ArvClockModel;
+
+ArvClockModel *		arv_clock_model_new		(guint n_samples);
+void			arv_clock_model_free		(ArvClockModel *model);
+
+void			arv_clock_model_reset		(ArvClockModel *model);
+guint64			arv_clock_model_add_sample	(ArvClockModel *model, guint64 device_time_ns, guint64 host_time_ns);
+guint64			arv_clock_model_convert		(ArvClockModel *model, guint64 device_time_ns);
+
+gboolean		arv_clock_model_is_valid	(ArvClockModel *model);
+double			arv_clock_model_get_drift_ppm	(ArvClockModel *model);
+guint			arv_clock_model_get_n_resets	(ArvClockModel *model);
+
+G_END_DECLS
+
+#endif
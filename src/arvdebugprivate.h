@@ -24,6 +24,7 @@
 #define ARV_DEBUG_PRIVATE_H
 
 #include <arvdebug.h>
+#include <arvfeatures.h>
 
 G_BEGIN_DECLS
 
@@ -61,59 +62,80 @@ typedef enum {
 
 extern ArvDebugCategoryInfos arv_debug_category_infos[];
 
-#define arv_warning_dom(...)		arv_warning (ARV_DEBUG_CATEGORY_DOM, __VA_ARGS__)
-#define arv_info_dom(...)	 	arv_info (ARV_DEBUG_CATEGORY_DOM, __VA_ARGS__)
-#define arv_debug_dom(...)		arv_debug (ARV_DEBUG_CATEGORY_DOM, __VA_ARGS__)
+/* The files of the stream data path define ARV_DEBUG_HOT_PATH before including this header. Unless aravis is built
+ * with the stream-thread-debug option, their output below the info level is compiled out. */
 
-#define arv_warning_interface(...)	arv_warning (ARV_DEBUG_CATEGORY_INTERFACE, __VA_ARGS__)
-#define arv_info_interface(...) 	arv_info (ARV_DEBUG_CATEGORY_INTERFACE, __VA_ARGS__)
-#define arv_debug_interface(...)	arv_debug (ARV_DEBUG_CATEGORY_INTERFACE, __VA_ARGS__)
+#if defined (ARV_DEBUG_HOT_PATH) && !ARAVIS_HAS_STREAM_THREAD_DEBUG
+#define ARV_DEBUG_LEVEL_MAX		ARV_DEBUG_LEVEL_INFO
+#else
+#define ARV_DEBUG_LEVEL_MAX		ARV_DEBUG_LEVEL_TRACE
+#endif
+
+/* Checked before the evaluation of the output arguments, a disabled output only costs a load and a compare */
+
+#define arv_debug_is_enabled(debug_category,debug_level)				\
+	((int) (debug_level) <= (int) ARV_DEBUG_LEVEL_MAX &&				\
+	 G_UNLIKELY ((int) (debug_level) <= (int) arv_debug_category_infos[(debug_category)].level))
+
+#define ARV_DEBUG_OUTPUT(func,debug_category,debug_level,...)				\
+	G_STMT_START {									\
+		if (arv_debug_is_enabled (debug_category, debug_level))			\
+			func (debug_category, __VA_ARGS__);				\
+	} G_STMT_END
+
+#define arv_warning_dom(...)		ARV_DEBUG_OUTPUT (arv_warning, ARV_DEBUG_CATEGORY_DOM, ARV_DEBUG_LEVEL_WARNING, __VA_ARGS__)
+#define arv_info_dom(...)	 	ARV_DEBUG_OUTPUT (arv_info, ARV_DEBUG_CATEGORY_DOM, ARV_DEBUG_LEVEL_INFO, __VA_ARGS__)
+#define arv_debug_dom(...)		ARV_DEBUG_OUTPUT (arv_debug, ARV_DEBUG_CATEGORY_DOM, ARV_DEBUG_LEVEL_DEBUG, __VA_ARGS__)
+
+#define arv_warning_interface(...)	ARV_DEBUG_OUTPUT (arv_warning, ARV_DEBUG_CATEGORY_INTERFACE, ARV_DEBUG_LEVEL_WARNING, __VA_ARGS__)
+#define arv_info_interface(...) 	ARV_DEBUG_OUTPUT (arv_info, ARV_DEBUG_CATEGORY_INTERFACE, ARV_DEBUG_LEVEL_INFO, __VA_ARGS__)
+#define arv_debug_interface(...)	ARV_DEBUG_OUTPUT (arv_debug, ARV_DEBUG_CATEGORY_INTERFACE, ARV_DEBUG_LEVEL_DEBUG, __VA_ARGS__)
 
-#define arv_warning_device(...)		arv_warning (ARV_DEBUG_CATEGORY_DEVICE, __VA_ARGS__)
-#define arv_info_device(...) 		arv_info (ARV_DEBUG_CATEGORY_DEVICE, __VA_ARGS__)
-#define arv_debug_device(...)		arv_debug (ARV_DEBUG_CATEGORY_DEVICE, __VA_ARGS__)
+#define arv_warning_device(...)		ARV_DEBUG_OUTPUT (arv_warning, ARV_DEBUG_CATEGORY_DEVICE, ARV_DEBUG_LEVEL_WARNING, __VA_ARGS__)
+#define arv_info_device(...) 		ARV_DEBUG_OUTPUT (arv_info, ARV_DEBUG_CATEGORY_DEVICE, ARV_DEBUG_LEVEL_INFO, __VA_ARGS__)
+#define arv_debug_device(...)		ARV_DEBUG_OUTPUT (arv_debug, ARV_DEBUG_CATEGORY_DEVICE, ARV_DEBUG_LEVEL_DEBUG, __VA_ARGS__)
 
-#define arv_warning_chunk(...)		arv_warning (ARV_DEBUG_CATEGORY_CHUNK, __VA_ARGS__)
-#define arv_info_chunk(...) 		arv_info (ARV_DEBUG_CATEGORY_CHUNK, __VA_ARGS__)
-#define arv_debug_chunk(...)		arv_debug (ARV_DEBUG_CATEGORY_CHUNK, __VA_ARGS__)
+#define arv_warning_chunk(...)		ARV_DEBUG_OUTPUT (arv_warning, ARV_DEBUG_CATEGORY_CHUNK, ARV_DEBUG_LEVEL_WARNING, __VA_ARGS__)
+#define arv_info_chunk(...) 		ARV_DEBUG_OUTPUT (arv_info, ARV_DEBUG_CATEGORY_CHUNK, ARV_DEBUG_LEVEL_INFO, __VA_ARGS__)
+#define arv_debug_chunk(...)		ARV_DEBUG_OUTPUT (arv_debug, ARV_DEBUG_CATEGORY_CHUNK, ARV_DEBUG_LEVEL_DEBUG, __VA_ARGS__)
 
-#define arv_warning_stream(...)		arv_warning (ARV_DEBUG_CATEGORY_STREAM, __VA_ARGS__)
-#define arv_info_stream(...) 		arv_info (ARV_DEBUG_CATEGORY_STREAM, __VA_ARGS__)
-#define arv_debug_stream(...)		arv_debug (ARV_DEBUG_CATEGORY_STREAM, __VA_ARGS__)
+#define arv_warning_stream(...)		ARV_DEBUG_OUTPUT (arv_warning, ARV_DEBUG_CATEGORY_STREAM, ARV_DEBUG_LEVEL_WARNING, __VA_ARGS__)
+#define arv_info_stream(...) 		ARV_DEBUG_OUTPUT (arv_info, ARV_DEBUG_CATEGORY_STREAM, ARV_DEBUG_LEVEL_INFO, __VA_ARGS__)
+#define arv_debug_stream(...)		ARV_DEBUG_OUTPUT (arv_debug, ARV_DEBUG_CATEGORY_STREAM, ARV_DEBUG_LEVEL_DEBUG, __VA_ARGS__)
 
-#define arv_warning_stream_thread(...)	arv_warning (ARV_DEBUG_CATEGORY_STREAM_THREAD, __VA_ARGS__)
-#define arv_info_stream_thread(...) 	arv_info (ARV_DEBUG_CATEGORY_STREAM_THREAD, __VA_ARGS__)
-#define arv_debug_stream_thread(...)	arv_debug (ARV_DEBUG_CATEGORY_STREAM_THREAD, __VA_ARGS__)
+#define arv_warning_stream_thread(...)	ARV_DEBUG_OUTPUT (arv_warning, ARV_DEBUG_CATEGORY_STREAM_THREAD, ARV_DEBUG_LEVEL_WARNING, __VA_ARGS__)
+#define arv_info_stream_thread(...) 	ARV_DEBUG_OUTPUT (arv_info, ARV_DEBUG_CATEGORY_STREAM_THREAD, ARV_DEBUG_LEVEL_INFO, __VA_ARGS__)
+#define arv_debug_stream_thread(...)	ARV_DEBUG_OUTPUT (arv_debug, ARV_DEBUG_CATEGORY_STREAM_THREAD, ARV_DEBUG_LEVEL_DEBUG, __VA_ARGS__)
 
-#define arv_warning_cp(...)		arv_warning (ARV_DEBUG_CATEGORY_CP, __VA_ARGS__)
-#define arv_info_cp(...) 		arv_info (ARV_DEBUG_CATEGORY_CP, __VA_ARGS__)
-#define arv_debug_cp(...)		arv_debug (ARV_DEBUG_CATEGORY_CP, __VA_ARGS__)
-#define arv_trace_cp(...)		arv_trace (ARV_DEBUG_CATEGORY_CP, __VA_ARGS__)
+#define arv_warning_cp(...)		ARV_DEBUG_OUTPUT (arv_warning, ARV_DEBUG_CATEGORY_CP, ARV_DEBUG_LEVEL_WARNING, __VA_ARGS__)
+#define arv_info_cp(...) 		ARV_DEBUG_OUTPUT (arv_info, ARV_DEBUG_CATEGORY_CP, ARV_DEBUG_LEVEL_INFO, __VA_ARGS__)
+#define arv_debug_cp(...)		ARV_DEBUG_OUTPUT (arv_debug, ARV_DEBUG_CATEGORY_CP, ARV_DEBUG_LEVEL_DEBUG, __VA_ARGS__)
+#define arv_trace_cp(...)		ARV_DEBUG_OUTPUT (arv_trace, ARV_DEBUG_CATEGORY_CP, ARV_DEBUG_LEVEL_TRACE, __VA_ARGS__)
 
-#define arv_warning_sp(...)		arv_warning (ARV_DEBUG_CATEGORY_SP, __VA_ARGS__)
-#define arv_info_sp(...) 		arv_info (ARV_DEBUG_CATEGORY_SP, __VA_ARGS__)
-#define arv_debug_sp(...)		arv_debug (ARV_DEBUG_CATEGORY_SP, __VA_ARGS__)
-#define arv_trace_sp(...)		arv_trace (ARV_DEBUG_CATEGORY_SP, __VA_ARGS__)
+#define arv_warning_sp(...)		ARV_DEBUG_OUTPUT (arv_warning, ARV_DEBUG_CATEGORY_SP, ARV_DEBUG_LEVEL_WARNING, __VA_ARGS__)
+#define arv_info_sp(...) 		ARV_DEBUG_OUTPUT (arv_info, ARV_DEBUG_CATEGORY_SP, ARV_DEBUG_LEVEL_INFO, __VA_ARGS__)
+#define arv_debug_sp(...)		ARV_DEBUG_OUTPUT (arv_debug, ARV_DEBUG_CATEGORY_SP, ARV_DEBUG_LEVEL_DEBUG, __VA_ARGS__)
+#define arv_trace_sp(...)		ARV_DEBUG_OUTPUT (arv_trace, ARV_DEBUG_CATEGORY_SP, ARV_DEBUG_LEVEL_TRACE, __VA_ARGS__)
 
-#define arv_warning_genicam(...)	arv_warning (ARV_DEBUG_CATEGORY_GENICAM, __VA_ARGS__)
-#define arv_info_genicam(...) 		arv_info (ARV_DEBUG_CATEGORY_GENICAM, __VA_ARGS__)
-#define arv_debug_genicam(...)		arv_debug (ARV_DEBUG_CATEGORY_GENICAM, __VA_ARGS__)
+#define arv_warning_genicam(...)	ARV_DEBUG_OUTPUT (arv_warning, ARV_DEBUG_CATEGORY_GENICAM, ARV_DEBUG_LEVEL_WARNING, __VA_ARGS__)
+#define arv_info_genicam(...) 		ARV_DEBUG_OUTPUT (arv_info, ARV_DEBUG_CATEGORY_GENICAM, ARV_DEBUG_LEVEL_INFO, __VA_ARGS__)
+#define arv_debug_genicam(...)		ARV_DEBUG_OUTPUT (arv_debug, ARV_DEBUG_CATEGORY_GENICAM, ARV_DEBUG_LEVEL_DEBUG, __VA_ARGS__)
 
-#define arv_warning_policies(...)	arv_warning (ARV_DEBUG_CATEGORY_POLICIES, __VA_ARGS__)
-#define arv_info_policies(...) 		arv_info (ARV_DEBUG_CATEGORY_POLICIES, __VA_ARGS__)
-#define arv_debug_policies(...)		arv_debug (ARV_DEBUG_CATEGORY_POLICIES, __VA_ARGS__)
+#define arv_warning_policies(...)	ARV_DEBUG_OUTPUT (arv_warning, ARV_DEBUG_CATEGORY_POLICIES, ARV_DEBUG_LEVEL_WARNING, __VA_ARGS__)
+#define arv_info_policies(...) 		ARV_DEBUG_OUTPUT (arv_info, ARV_DEBUG_CATEGORY_POLICIES, ARV_DEBUG_LEVEL_INFO, __VA_ARGS__)
+#define arv_debug_policies(...)		ARV_DEBUG_OUTPUT (arv_debug, ARV_DEBUG_CATEGORY_POLICIES, ARV_DEBUG_LEVEL_DEBUG, __VA_ARGS__)
 
-#define arv_warning_evaluator(...)	arv_warning (ARV_DEBUG_CATEGORY_EVALUATOR, __VA_ARGS__)
-#define arv_info_evaluator(...) 	arv_info (ARV_DEBUG_CATEGORY_EVALUATOR, __VA_ARGS__)
-#define arv_debug_evaluator(...)	arv_debug (ARV_DEBUG_CATEGORY_EVALUATOR, __VA_ARGS__)
+#define arv_warning_evaluator(...)	ARV_DEBUG_OUTPUT (arv_warning, ARV_DEBUG_CATEGORY_EVALUATOR, ARV_DEBUG_LEVEL_WARNING, __VA_ARGS__)
+#define arv_info_evaluator(...) 	ARV_DEBUG_OUTPUT (arv_info, ARV_DEBUG_CATEGORY_EVALUATOR, ARV_DEBUG_LEVEL_INFO, __VA_ARGS__)
+#define arv_debug_evaluator(...)	ARV_DEBUG_OUTPUT (arv_debug, ARV_DEBUG_CATEGORY_EVALUATOR, ARV_DEBUG_LEVEL_DEBUG, __VA_ARGS__)
 
-#define arv_warning_misc(...)		arv_warning (ARV_DEBUG_CATEGORY_MISC, __VA_ARGS__)
-#define arv_info_misc(...) 		arv_info (ARV_DEBUG_CATEGORY_MISC, __VA_ARGS__)
-#define arv_debug_misc(...)		arv_debug (ARV_DEBUG_CATEGORY_MISC, __VA_ARGS__)
+#define arv_warning_misc(...)		ARV_DEBUG_OUTPUT (arv_warning, ARV_DEBUG_CATEGORY_MISC, ARV_DEBUG_LEVEL_WARNING, __VA_ARGS__)
+#define arv_info_misc(...) 		ARV_DEBUG_OUTPUT (arv_info, ARV_DEBUG_CATEGORY_MISC, ARV_DEBUG_LEVEL_INFO, __VA_ARGS__)
+#define arv_debug_misc(...)		ARV_DEBUG_OUTPUT (arv_debug, ARV_DEBUG_CATEGORY_MISC, ARV_DEBUG_LEVEL_DEBUG, __VA_ARGS__)
 
-#define arv_warning_viewer(...)		arv_warning (ARV_DEBUG_CATEGORY_VIEWER, __VA_ARGS__)
-#define arv_info_viewer(...)	 	arv_info (ARV_DEBUG_CATEGORY_VIEWER, __VA_ARGS__)
-#define arv_debug_viewer(...)		arv_debug (ARV_DEBUG_CATEGORY_VIEWER, __VA_ARGS__)
+#define arv_warning_viewer(...)		ARV_DEBUG_OUTPUT (arv_warning, ARV_DEBUG_CATEGORY_VIEWER, ARV_DEBUG_LEVEL_WARNING, __VA_ARGS__)
+#define arv_info_viewer(...)	 	ARV_DEBUG_OUTPUT (arv_info, ARV_DEBUG_CATEGORY_VIEWER, ARV_DEBUG_LEVEL_INFO, __VA_ARGS__)
+#define arv_debug_viewer(...)		ARV_DEBUG_OUTPUT (arv_debug, ARV_DEBUG_CATEGORY_VIEWER, ARV_DEBUG_LEVEL_DEBUG, __VA_ARGS__)
 
 gboolean	arv_debug_check			(ArvDebugCategory category, ArvDebugLevel level);
 
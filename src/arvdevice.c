@@ -38,24 +38,83 @@
 #include <arvgcboolean.h>
 #include <arvgcenumeration.h>
 #include <arvgcstring.h>
+#include <arvgcprivate.h>
+#include <arvgcregisternodeprivate.h>
+#include <arvgvdevice.h>
 #include <arvstream.h>
-#include <arvdebug.h>
+#include <arvstreamprivate.h>
+#include <arvdebugprivate.h>
+#include <arvrealtimeprivate.h>
+#include <string.h>
+
+/* Configuration blob: a header followed by the entries, in write order. All the fields are little endian. */
+
+#define ARV_DEVICE_CONFIGURATION_MAGIC		0x46434241	/* "ABCF" */
+#define ARV_DEVICE_CONFIGURATION_VERSION	1
+
+#define ARV_DEVICE_CONFIGURATION_FLAG_REGISTER	0x1
+#define ARV_DEVICE_CONFIGURATION_FLAG_SELECTOR	0x2
+
+typedef struct {
+	guint32 magic;
+	guint32 version;
+	guint32 n_entries;
+} ArvDeviceConfigurationHeader;
+
+typedef struct {
+	guint64 address;
+	guint32 size;
+	guint32 flags;
+} ArvDeviceConfigurationEntry;
 
 enum {
 	ARV_DEVICE_SIGNAL_CONTROL_LOST,
+	ARV_DEVICE_SIGNAL_FEATURE_POLLED,
 	ARV_DEVICE_SIGNAL_LAST
 } ArvDeviceSignals;
 
 static guint arv_device_signals[ARV_DEVICE_SIGNAL_LAST] = {0};
 
+enum {
+	ARV_DEVICE_PROPERTY_0,
+	ARV_DEVICE_PROPERTY_AUXILIARY_CPUS,
+	ARV_DEVICE_PROPERTY_AUXILIARY_NICE_LEVEL
+} ArvDeviceProperties;
+
 GQuark
 arv_device_error_quark (void)
 {
 	return g_quark_from_static_string ("arv-device-error-quark");
 }
 
+typedef struct _ArvDeviceFeatureWorker ArvDeviceFeatureWorker;
+
 typedef struct {
 	GError *init_error;
+
+	/* Asynchronous feature access and feature polling */
+	GMutex feature_mutex;
+	GThread *feature_thread;
+	ArvDeviceFeatureWorker *feature_worker;
+
+	/* Last value of each register written through the GenICam tree, per selector context, in write order,
+	 * replayed after a reconnection, see arv_device_journal_write() */
+	GMutex journal_mutex;
+	GQueue journal;
+	GHashTable *journal_index;
+	GHashTable *journal_selectors;
+	GHashTable *journal_contexts;
+	guint journal_context;
+
+	/* Placement of the threads outside of the acquisition path: heartbeat, event and feature threads */
+	GMutex auxiliary_mutex;
+	char *auxiliary_cpus;
+	int auxiliary_nice_level;
+	gint auxiliary_generation;
+
+	/* Streams of the device, without reference, prepared before each acquisition start */
+	GMutex stream_mutex;
+	GSList *streams;
 } ArvDevicePrivate;
 
 static void arv_device_initable_iface_init (GInitableIface *iface);
@@ -87,6 +146,51 @@ arv_device_create_stream (ArvDevice *device, ArvStreamCallback callback, void *u
 	return ARV_DEVICE_GET_CLASS (device)->create_stream (device, callback, user_data, error);
 }
 
+/* A stream registers itself when it is bound to the device, and unregisters itself before its release. The device
+ * doesn't hold a reference on its streams, the streams holding one on their device. */
+
+void
+arv_device_add_stream (ArvDevice *device, ArvStream *stream)
+{
+	ArvDevicePrivate *priv = arv_device_get_instance_private (device);
+
+	g_return_if_fail (ARV_IS_DEVICE (device));
+	g_return_if_fail (ARV_IS_STREAM (stream));
+
+	g_mutex_lock (&priv->stream_mutex);
+	priv->streams = g_slist_prepend (priv->streams, stream);
+	g_mutex_unlock (&priv->stream_mutex);
+}
+
+void
+arv_device_remove_stream (ArvDevice *device, ArvStream *stream)
+{
+	ArvDevicePrivate *priv = arv_device_get_instance_private (device);
+
+	g_return_if_fail (ARV_IS_DEVICE (device));
+
+	g_mutex_lock (&priv->stream_mutex);
+	priv->streams = g_slist_remove (priv->streams, stream);
+	g_mutex_unlock (&priv->stream_mutex);
+}
+
+/* Called before the execution of AcquisitionStart, which follows the changes of the payload size */
+
+void
+arv_device_prepare_streams (ArvDevice *device)
+{
+	ArvDevicePrivate *priv = arv_device_get_instance_private (device);
+	GSList *iter;
+
+	g_return_if_fail (ARV_IS_DEVICE (device));
+
+	/* The lock is held during the preparation, a stream being released waits for its end */
+	g_mutex_lock (&priv->stream_mutex);
+	for (iter = priv->streams; iter != NULL; iter = iter->next)
+		arv_stream_prepare_acquisition (iter->data);
+	g_mutex_unlock (&priv->stream_mutex);
+}
+
 /**
  * arv_device_read_memory:
  * @device: a #ArvDevice
@@ -187,664 +291,2655 @@ arv_device_write_register (ArvDevice *device, guint64 address, guint32 value, GE
 }
 
 /**
- * arv_device_get_genicam:
+ * arv_device_read_registers:
  * @device: a #ArvDevice
+ * @n_registers: number of registers
+ * @addresses: (array length=n_registers): register addresses
+ * @values: (out caller-allocates) (array length=n_registers): a placeholder for the read values
+ * @error: (out) (allow-none): a #GError placeholder
  *
- * Retrieves the genicam interface of the given device.
+ * Reads the values of several device registers. On GigE Vision devices, the registers are read using as few commands
+ * as possible, which saves a round trip per register. Other devices read the registers one by one.
  *
- * Return value: (transfer none): the genicam interface.
+ * Return value: (skip): TRUE on success. On error, all the values are set to 0.
  *
- * Since: 0.2.0
- */
+ * Since: 0.8.11
+ **/
 
-ArvGc *
-arv_device_get_genicam (ArvDevice *device)
+gboolean
+arv_device_read_registers (ArvDevice *device, guint n_registers, const guint64 *addresses, guint32 *values,
+			   GError **error)
 {
-	g_return_val_if_fail (ARV_IS_DEVICE (device), NULL);
+	guint i;
 
-	return ARV_DEVICE_GET_CLASS (device)->get_genicam (device);
+	g_return_val_if_fail (ARV_IS_DEVICE (device), FALSE);
+	g_return_val_if_fail (addresses != NULL || n_registers == 0, FALSE);
+	g_return_val_if_fail (values != NULL || n_registers == 0, FALSE);
+	g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+
+	if (n_registers == 0)
+		return TRUE;
+
+	if (ARV_DEVICE_GET_CLASS (device)->read_registers != NULL)
+		return ARV_DEVICE_GET_CLASS (device)->read_registers (device, n_registers, addresses, values, error);
+
+	for (i = 0; i < n_registers; i++) {
+		if (!ARV_DEVICE_GET_CLASS (device)->read_register (device, addresses[i], &values[i], error)) {
+			memset (values, 0, n_registers * sizeof (guint32));
+			return FALSE;
+		}
+	}
+
+	return TRUE;
 }
 
 /**
- * arv_device_get_genicam_xml:
+ * arv_device_write_registers:
  * @device: a #ArvDevice
- * @size: (out) (allow-none): placeholder for the returned data size (bytes)
+ * @n_registers: number of registers
+ * @addresses: (array length=n_registers): register addresses
+ * @values: (array length=n_registers): values to write
+ * @n_written: (out) (optional): number of registers successfully written
+ * @error: (out) (allow-none): a #GError placeholder
  *
- * Gets the Genicam XML data stored in the device memory.
+ * Writes several device registers, in order. On GigE Vision devices, the registers are written using as few commands
+ * as possible. The writes stop at the first failure, in which case @n_written is the index of the failed write.
  *
- * Returns: (transfer none): a pointer to the Genicam XML data, owned by the device.
+ * Return value: (skip): TRUE on success.
  *
- * Since: 0.2.0
+ * Since: 0.8.11
  **/
 
-const char *
-arv_device_get_genicam_xml (ArvDevice *device, size_t *size)
+gboolean
+arv_device_write_registers (ArvDevice *device, guint n_registers, const guint64 *addresses, const guint32 *values,
+			    guint *n_written, GError **error)
 {
-	g_return_val_if_fail (ARV_IS_DEVICE (device), NULL);
-	g_return_val_if_fail (size != NULL, NULL);
+	guint i;
 
-	if (ARV_DEVICE_GET_CLASS (device)->get_genicam_xml != NULL)
-		return ARV_DEVICE_GET_CLASS (device)->get_genicam_xml (device, size);
+	if (n_written != NULL)
+		*n_written = 0;
 
-	*size = 0;
+	g_return_val_if_fail (ARV_IS_DEVICE (device), FALSE);
+	g_return_val_if_fail (addresses != NULL || n_registers == 0, FALSE);
+	g_return_val_if_fail (values != NULL || n_registers == 0, FALSE);
+	g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
 
-	return NULL;
+	if (n_registers == 0)
+		return TRUE;
+
+	if (ARV_DEVICE_GET_CLASS (device)->write_registers != NULL)
+		return ARV_DEVICE_GET_CLASS (device)->write_registers (device, n_registers, addresses, values,
+								       n_written, error);
+
+	for (i = 0; i < n_registers; i++) {
+		if (!ARV_DEVICE_GET_CLASS (device)->write_register (device, addresses[i], values[i], error))
+			return FALSE;
+		if (n_written != NULL)
+			*n_written = i + 1;
+	}
+
+	return TRUE;
 }
 
 /**
- * arv_device_create_chunk_parser:
+ * arv_device_begin_batch:
  * @device: a #ArvDevice
  *
- * Create a #ArvChunkParser object, to be used for chunk data extraction from #ArvBuffer.
+ * Starts a register write batch. Until arv_device_commit_batch() is called, the register writes, including the ones
+ * of the feature setters, are queued instead of being sent to the device, and the register reads return the queued
+ * values. The whole batch is then sent at once, which on GigE Vision devices takes one WRITEREG command per 64
+ * registers, instead of one round trip per register. This allows for example to switch a full camera configuration
+ * in the gap between two frames.
  *
- * Returns: (transfer full): a new #ArvChunkParser object, NULL on error.
+ * Writes which can not be queued, like large memory writes, are sent immediately, after the writes already queued.
+ * Devices without batch support write the registers immediately.
  *
- * Since: 0.4.0
- **/
+ * Since: 0.8.11
+ */
 
-ArvChunkParser *
-arv_device_create_chunk_parser (ArvDevice *device)
+void
+arv_device_begin_batch (ArvDevice *device)
 {
-	const char *xml = NULL;
-	gsize size = 0;
-
-	g_return_val_if_fail (ARV_IS_DEVICE (device), NULL);
-
-	xml = arv_device_get_genicam_xml (device, &size);
+	g_return_if_fail (ARV_IS_DEVICE (device));
 
-	return arv_chunk_parser_new (xml, size);
+	if (ARV_DEVICE_GET_CLASS (device)->begin_batch != NULL)
+		ARV_DEVICE_GET_CLASS (device)->begin_batch (device);
 }
 
 /**
- * arv_device_get_feature:
+ * arv_device_commit_batch:
  * @device: a #ArvDevice
- * @feature: feature name
+ * @n_written: (out) (optional): number of queued writes successfully sent
+ * @error: (out) (allow-none): a #GError placeholder
  *
- * Return value: (transfer none): the genicam node corresponding to the feature name, NULL if not found.
+ * Sends the register writes queued since arv_device_begin_batch(), in order, and ends the batch. The writes stop at
+ * the first failure, in which case @n_written is the index of the failed write, and the error message gives its
+ * address. The remaining writes are dropped.
  *
- * Since: 0.2.0
+ * Return value: (skip): TRUE on success.
+ *
+ * Since: 0.8.11
  */
 
-ArvGcNode *
-arv_device_get_feature (ArvDevice *device, const char *feature)
+gboolean
+arv_device_commit_batch (ArvDevice *device, guint *n_written, GError **error)
 {
-	ArvGc *genicam;
+	if (n_written != NULL)
+		*n_written = 0;
 
-	genicam = arv_device_get_genicam (device);
-	g_return_val_if_fail (ARV_IS_GC (genicam), NULL);
+	g_return_val_if_fail (ARV_IS_DEVICE (device), FALSE);
+	g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
 
-	return arv_gc_get_node (genicam, feature);
+	if (ARV_DEVICE_GET_CLASS (device)->commit_batch != NULL)
+		return ARV_DEVICE_GET_CLASS (device)->commit_batch (device, n_written, error);
+
+	return TRUE;
 }
 
 /**
- * arv_device_is_feature_available:
+ * arv_device_reconnect:
  * @device: a #ArvDevice
- * @feature: feature name
- * @error: a #GError placeholder, %NULL to ignore
+ * @timeout_ms: maximum time to wait for the device, in milliseconds
+ * @error: (out) (allow-none): a #GError placeholder
  *
- * Return: %TRUE if feature is available, %FALSE if not or on error.
+ * Reconnects to the device after a loss of the link, for example after a reboot of the camera, without destroying the
+ * device object and its streams. The same device is waited for at most @timeout_ms, the control of the device is
+ * taken again, and the registers written through the GenICam features since the device creation are written again
+ * in the same order, a value being replayed for each state of the selectors it was written with. The GenICam data are not downloaded again, and the streams of the device are bound to the
+ * device again, keeping their buffers. Commands like AcquisitionStart are not replayed, the acquisition must be
+ * started again by the application.
  *
- * Since: 0.8.0
+ * Return value: (skip): TRUE on success.
+ *
+ * Since: 0.8.11
  */
 
 gboolean
-arv_device_is_feature_available (ArvDevice *device, const char *feature, GError **error)
+arv_device_reconnect (ArvDevice *device, guint timeout_ms, GError **error)
 {
-	ArvGcNode* node;
-
 	g_return_val_if_fail (ARV_IS_DEVICE (device), FALSE);
-	g_return_val_if_fail (feature != NULL, FALSE);
+	g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
 
-	node = arv_device_get_feature (device, feature);
-	return ARV_IS_GC_FEATURE_NODE (node) && arv_gc_feature_node_is_available (ARV_GC_FEATURE_NODE (node), error);
+	if (ARV_DEVICE_GET_CLASS (device)->reconnect == NULL) {
+		g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_PROTOCOL_ERROR,
+			     "Reconnection is not supported by %s", G_OBJECT_TYPE_NAME (device));
+		return FALSE;
+	}
+
+	return ARV_DEVICE_GET_CLASS (device)->reconnect (device, timeout_ms, error);
 }
 
-static void *
-_get_feature (ArvDevice *device, GType node_type, const char *feature, GError **error)
+/* The journal index is keyed on the register address and the selector context of the entries */
+
+static guint
+_journal_entry_hash (gconstpointer key)
 {
-	void *node;
+	const ArvDeviceJournalEntry *entry = key;
 
-	g_return_val_if_fail (ARV_IS_DEVICE (device), NULL);
-	g_return_val_if_fail (feature != NULL, NULL);
+	return g_int64_hash (&entry->address) ^ (entry->context * 0x9e3779b1);
+}
 
-	node = arv_device_get_feature (device, feature);
+static gboolean
+_journal_entry_equal (gconstpointer a, gconstpointer b)
+{
+	const ArvDeviceJournalEntry *entry_a = a;
+	const ArvDeviceJournalEntry *entry_b = b;
 
-	if (node == NULL) {
-		g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_FEATURE_NOT_FOUND,
-			     "node '%s' not found", feature);
-		return NULL;
+	return entry_a->address == entry_b->address && entry_a->context == entry_b->context;
+}
+
+static gboolean
+_journal_is_same_selector (const ArvDeviceJournalEntry *entry_a, const ArvDeviceJournalEntry *entry_b)
+{
+	return entry_a->is_selector && entry_b->is_selector && entry_a->address == entry_b->address;
+}
+
+static gint
+_journal_compare_addresses (gconstpointer a, gconstpointer b)
+{
+	guint64 address_a = *((const guint64 *) a);
+	guint64 address_b = *((const guint64 *) b);
+
+	return address_a < address_b ? -1 : (address_a > address_b ? 1 : 0);
+}
+
+/* Removes an entry. A selector write immediately followed by another write of the same selector doesn't change the
+ * meaning of any register, the first one is removed too. Called with the journal lock held. */
+
+static void
+_journal_delete_link (ArvDevicePrivate *priv, GList *link)
+{
+	ArvDeviceJournalEntry *entry = link->data;
+	GList *previous = link->prev;
+	GList *next = link->next;
+
+	if (!entry->is_selector)
+		g_hash_table_remove (priv->journal_index, entry);
+	g_queue_delete_link (&priv->journal, link);
+	g_free (entry);
+
+	if (previous != NULL && next != NULL && _journal_is_same_selector (previous->data, next->data)) {
+		g_free (previous->data);
+		g_queue_delete_link (&priv->journal, previous);
 	}
+}
 
-	if (!(G_TYPE_CHECK_INSTANCE_TYPE ((node), node_type))) {
-		g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_WRONG_FEATURE,
-			     "node '%s' [%s]  is not a %s", feature, G_OBJECT_TYPE_NAME (node), g_type_name (node_type));
-		return NULL;
+/* Updates the selector context after a selector write. The current values of all the selector registers, ordered by
+ * address, are interned as a context identifier. Called with the journal lock held. */
+
+static void
+_journal_update_context (ArvDevicePrivate *priv, const ArvDeviceJournalEntry *selector)
+{
+	GByteArray *array;
+	GBytes *state;
+	GList *addresses;
+	GList *iter;
+	gpointer context;
+
+	g_hash_table_replace (priv->journal_selectors,
+			      g_memdup (&selector->address, sizeof (selector->address)),
+			      g_bytes_new (selector->data, selector->size));
+
+	array = g_byte_array_new ();
+	addresses = g_list_sort (g_hash_table_get_keys (priv->journal_selectors), _journal_compare_addresses);
+	for (iter = addresses; iter != NULL; iter = iter->next) {
+		GBytes *value = g_hash_table_lookup (priv->journal_selectors, iter->data);
+		const guint8 *data;
+		gsize size;
+		guint32 size32;
+
+		data = g_bytes_get_data (value, &size);
+		size32 = size;
+		g_byte_array_append (array, iter->data, sizeof (guint64));
+		g_byte_array_append (array, (const guint8 *) &size32, sizeof (size32));
+		g_byte_array_append (array, data, size);
 	}
+	g_list_free (addresses);
+	state = g_byte_array_free_to_bytes (array);
 
-	return node;
+	context = g_hash_table_lookup (priv->journal_contexts, state);
+	if (context == NULL) {
+		context = GUINT_TO_POINTER (g_hash_table_size (priv->journal_contexts) + 1);
+		g_hash_table_insert (priv->journal_contexts, state, context);
+	} else
+		g_bytes_unref (state);
+
+	priv->journal_context = GPOINTER_TO_UINT (context);
 }
 
-/**
- * arv_device_execute_command:
- * @device: a #ArvDevice
- * @feature: feature name
- * @error: a #GError placeholder
- *
- * Execute a genicam command.
- *
- * Since: 0.8.0
- */
+/* Records a register write done through the GenICam tree. On many devices, a selector, like GainSelector, picks what a
+ * shared value register means, and the register alone does not identify a setting. The writes are hence merged per
+ * register and per selector context, the values of all the selector registers at the time of the write: only the last
+ * write of a register in a given context is kept, at the position of this last write. The selector writes are kept in
+ * order, except the ones immediately overwritten, which ensures that each value is replayed after the selector writes
+ * it depends on. */
 
 void
-arv_device_execute_command (ArvDevice *device, const char *feature, GError **error)
+arv_device_journal_write (ArvDevice *device, guint64 address, guint32 size, const void *data,
+			  gboolean is_register, gboolean is_selector)
 {
-	ArvGcNode *node;
+	ArvDevicePrivate *priv = arv_device_get_instance_private (device);
+	ArvDeviceJournalEntry *entry;
+	GList *link;
 
-	node = _get_feature (device, ARV_TYPE_GC_COMMAND, feature, error);
-	if (node != NULL)
-		arv_gc_command_execute (ARV_GC_COMMAND (node), error);
+	g_return_if_fail (ARV_IS_DEVICE (device));
+	g_return_if_fail (data != NULL || size == 0);
+
+	entry = g_malloc (sizeof (ArvDeviceJournalEntry) + size);
+	entry->address = address;
+	entry->size = size;
+	entry->is_register = is_register;
+	entry->is_selector = is_selector;
+	entry->context = 0;
+	memcpy (entry->data, data, size);
+
+	g_mutex_lock (&priv->journal_mutex);
+
+	if (is_selector) {
+		link = priv->journal.tail;
+		if (link != NULL && _journal_is_same_selector (link->data, entry))
+			_journal_delete_link (priv, link);
+
+		g_queue_push_tail (&priv->journal, entry);
+		_journal_update_context (priv, entry);
+	} else {
+		entry->context = priv->journal_context;
+
+		link = g_hash_table_lookup (priv->journal_index, entry);
+		if (link != NULL)
+			_journal_delete_link (priv, link);
+
+		g_queue_push_tail (&priv->journal, entry);
+		g_hash_table_insert (priv->journal_index, entry, priv->journal.tail);
+	}
+
+	g_mutex_unlock (&priv->journal_mutex);
 }
 
-/**
- * arv_device_set_boolean_feature_value:
- * @device: a #ArvDevice
- * @feature: feature name
- * @value: feature value
- * @error: a #GError placeholder
- *
- * Set the value of a boolean feature.
- *
- * Since: 0.8.0
- */
+/* Removes the writes of a register, in all the selector contexts */
 
 void
-arv_device_set_boolean_feature_value (ArvDevice *device, const char *feature, gboolean value, GError **error)
+arv_device_journal_forget (ArvDevice *device, guint64 address)
 {
-	ArvGcNode *node;
+	ArvDevicePrivate *priv = arv_device_get_instance_private (device);
+	GList *iter;
+	GList *next;
 
-	node = _get_feature (device, ARV_TYPE_GC_BOOLEAN, feature, error);
-	if (node != NULL)
-		arv_gc_boolean_set_value (ARV_GC_BOOLEAN (node), value, error);
+	g_return_if_fail (ARV_IS_DEVICE (device));
+
+	g_mutex_lock (&priv->journal_mutex);
+
+	for (iter = priv->journal.head; iter != NULL; iter = next) {
+		ArvDeviceJournalEntry *entry = iter->data;
+
+		next = iter->next;
+		if (!entry->is_selector && entry->address == address)
+			_journal_delete_link (priv, iter);
+	}
+
+	g_mutex_unlock (&priv->journal_mutex);
 }
 
-/**
- * arv_device_get_boolean_feature_value:
- * @device: a #ArvDevice
- * @feature: feature name
- * @error: a #GError placeholder
- *
- * Returns: the feature value, %FALSE on error.
- *
- * Since: 0.8.0
- */
+/* Writes again the journal registers, in order. The writes are done on a copy of the journal, without the lock held,
+ * and a failed write does not stop the replay. */
 
-gboolean
-arv_device_get_boolean_feature_value (ArvDevice *device, const char *feature, GError **error)
+void
+arv_device_journal_replay (ArvDevice *device)
 {
-	ArvGcNode *node;
+	ArvDevicePrivate *priv = arv_device_get_instance_private (device);
+	GPtrArray *entries;
+	GList *iter;
+	guint n_failures = 0;
+	guint i;
 
-	node = _get_feature (device, ARV_TYPE_GC_BOOLEAN, feature, error);
-	if (node != NULL)
-		return arv_gc_boolean_get_value (ARV_GC_BOOLEAN (node), error);
+	g_return_if_fail (ARV_IS_DEVICE (device));
 
-	return FALSE;
+	entries = g_ptr_array_new_with_free_func (g_free);
+
+	g_mutex_lock (&priv->journal_mutex);
+	for (iter = priv->journal.head; iter != NULL; iter = iter->next) {
+		ArvDeviceJournalEntry *entry = iter->data;
+
+		g_ptr_array_add (entries, g_memdup (entry, sizeof (ArvDeviceJournalEntry) + entry->size));
+	}
+	g_mutex_unlock (&priv->journal_mutex);
+
+	arv_gc_invalidate_registers (arv_device_get_genicam (device));
+
+	for (i = 0; i < entries->len; i++) {
+		ArvDeviceJournalEntry *entry = g_ptr_array_index (entries, i);
+		GError *error = NULL;
+
+		if (entry->is_register) {
+			guint32 value;
+
+			memcpy (&value, entry->data, sizeof (value));
+			arv_device_write_register (device, entry->address, value, &error);
+		} else
+			arv_device_write_memory (device, entry->address, entry->size, entry->data, &error);
+
+		if (error != NULL) {
+			arv_info_device ("[Device::journal_replay] Failed to write 0x%08" G_GINT64_MODIFIER "x: %s",
+					 entry->address, error->message);
+			g_clear_error (&error);
+			n_failures++;
+		}
+	}
+
+	arv_info_device ("[Device::journal_replay] %u register write%s replayed, %u failure%s",
+			 entries->len, entries->len > 1 ? "s" : "", n_failures, n_failures > 1 ? "s" : "");
+
+	g_ptr_array_unref (entries);
 }
 
 /**
- * arv_device_get_boolean_feature_value_gi: (rename-to arv_device_get_boolean_feature_value)
+ * arv_device_export_configuration:
  * @device: a #ArvDevice
- * @feature: feature name
- * @value: (out): feature value
- * @error: a #GError placeholder
  *
- * Get the feature value, or %FALSE on error.
+ * Captures the values of the registers written through the features since the device creation, in a compact binary
+ * form. The writes are kept in order, with only the last value of each register for a given state of the selectors,
+ * like GainSelector, which pick what a shared value register means. The command registers are omitted. The result can be applied later to the same camera model using arv_device_import_configuration(), without
+ * going through the feature nodes.
  *
- * Since: 0.8.0
+ * Returns: (transfer full): the configuration data.
+ *
+ * Since: 0.8.11
  */
 
-void
-arv_device_get_boolean_feature_value_gi	(ArvDevice *device, const char *feature, gboolean *value, GError **error)
+GBytes *
+arv_device_export_configuration (ArvDevice *device)
+{
+	ArvDevicePrivate *priv = arv_device_get_instance_private (device);
+	ArvDeviceConfigurationHeader header;
+	GByteArray *array;
+	GList *iter;
+
+	g_return_val_if_fail (ARV_IS_DEVICE (device), NULL);
+
+	array = g_byte_array_new ();
+
+	g_mutex_lock (&priv->journal_mutex);
+
+	header.magic = GUINT32_TO_LE (ARV_DEVICE_CONFIGURATION_MAGIC);
+	header.version = GUINT32_TO_LE (ARV_DEVICE_CONFIGURATION_VERSION);
+	header.n_entries = GUINT32_TO_LE (g_queue_get_length (&priv->journal));
+	g_byte_array_append (array, (guint8 *) &header, sizeof (header));
+
+	for (iter = priv->journal.head; iter != NULL; iter = iter->next) {
+		ArvDeviceJournalEntry *journal_entry = iter->data;
+		ArvDeviceConfigurationEntry entry;
+
+		entry.address = GUINT64_TO_LE (journal_entry->address);
+		entry.size = GUINT32_TO_LE (journal_entry->size);
+		entry.flags = GUINT32_TO_LE ((journal_entry->is_register ? ARV_DEVICE_CONFIGURATION_FLAG_REGISTER : 0) |
+					     (journal_entry->is_selector ? ARV_DEVICE_CONFIGURATION_FLAG_SELECTOR : 0));
+		g_byte_array_append (array, (guint8 *) &entry, sizeof (entry));
+
+		if (journal_entry->is_register) {
+			guint32 value;
+
+			memcpy (&value, journal_entry->data, sizeof (value));
+			value = GUINT32_TO_LE (value);
+			g_byte_array_append (array, (guint8 *) &value, sizeof (value));
+		} else
+			g_byte_array_append (array, journal_entry->data, journal_entry->size);
+	}
+
+	g_mutex_unlock (&priv->journal_mutex);
+
+	return g_byte_array_free_to_bytes (array);
+}
+
+/**
+ * arv_device_import_configuration:
+ * @device: a #ArvDevice
+ * @configuration: configuration data returned by arv_device_export_configuration()
+ * @error: (out) (allow-none): a #GError placeholder
+ *
+ * Writes back a configuration captured by arv_device_export_configuration(), in the original write order, which
+ * respects the dependencies between the features: a value shared by the entries of a selector is written once per
+ * selector entry, each after the selector write it depends on. The writes are
+ * batched, see arv_device_begin_batch(). The values are not checked against the feature ranges, and the writes stop at
+ * the first failure.
+ *
+ * Return value: (skip): TRUE on success.
+ *
+ * Since: 0.8.11
+ */
+
+gboolean
+arv_device_import_configuration (ArvDevice *device, GBytes *configuration, GError **error)
+{
+	ArvDeviceConfigurationHeader header;
+	GError *local_error = NULL;
+	const guint8 *data;
+	gsize size;
+	gsize offset;
+	guint n_entries;
+	guint i;
+
+	g_return_val_if_fail (ARV_IS_DEVICE (device), FALSE);
+	g_return_val_if_fail (configuration != NULL, FALSE);
+	g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+
+	data = g_bytes_get_data (configuration, &size);
+
+	if (size < sizeof (header)) {
+		g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_INVALID_PARAMETER,
+			     "Configuration data too short");
+		return FALSE;
+	}
+
+	memcpy (&header, data, sizeof (header));
+	if (GUINT32_FROM_LE (header.magic) != ARV_DEVICE_CONFIGURATION_MAGIC ||
+	    GUINT32_FROM_LE (header.version) != ARV_DEVICE_CONFIGURATION_VERSION) {
+		g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_INVALID_PARAMETER,
+			     "Invalid configuration data header");
+		return FALSE;
+	}
+	n_entries = GUINT32_FROM_LE (header.n_entries);
+
+	/* Check the whole data before writing anything */
+	for (i = 0, offset = sizeof (header); i < n_entries; i++) {
+		ArvDeviceConfigurationEntry entry;
+
+		if (size - offset < sizeof (entry))
+			break;
+		memcpy (&entry, data + offset, sizeof (entry));
+		offset += sizeof (entry);
+
+		if (size - offset < GUINT32_FROM_LE (entry.size) ||
+		    ((GUINT32_FROM_LE (entry.flags) & ARV_DEVICE_CONFIGURATION_FLAG_REGISTER) != 0 &&
+		     GUINT32_FROM_LE (entry.size) != sizeof (guint32)))
+			break;
+		offset += GUINT32_FROM_LE (entry.size);
+	}
+
+	if (i < n_entries || offset != size) {
+		g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_INVALID_PARAMETER,
+			     "Corrupted configuration data");
+		return FALSE;
+	}
+
+	arv_device_begin_batch (device);
+
+	for (i = 0, offset = sizeof (header); i < n_entries && local_error == NULL; i++) {
+		ArvDeviceConfigurationEntry entry;
+		guint64 address;
+		guint32 entry_size;
+		guint32 flags;
+		gboolean is_selector;
+
+		memcpy (&entry, data + offset, sizeof (entry));
+		offset += sizeof (entry);
+		address = GUINT64_FROM_LE (entry.address);
+		entry_size = GUINT32_FROM_LE (entry.size);
+		flags = GUINT32_FROM_LE (entry.flags);
+		is_selector = (flags & ARV_DEVICE_CONFIGURATION_FLAG_SELECTOR) != 0;
+
+		if ((flags & ARV_DEVICE_CONFIGURATION_FLAG_REGISTER) != 0) {
+			guint32 value;
+
+			memcpy (&value, data + offset, sizeof (value));
+			value = GUINT32_FROM_LE (value);
+			if (arv_device_write_register (device, address, value, &local_error))
+				arv_device_journal_write (device, address, sizeof (value), &value, TRUE, is_selector);
+		} else {
+			if (arv_device_write_memory (device, address, entry_size, (void *) (data + offset), &local_error))
+				arv_device_journal_write (device, address, entry_size, data + offset, FALSE, is_selector);
+		}
+
+		offset += entry_size;
+	}
+
+	/* Sends what was queued before a failure too, which also ends the batch */
+	if (local_error == NULL)
+		arv_device_commit_batch (device, NULL, &local_error);
+	else
+		arv_device_commit_batch (device, NULL, NULL);
+
+	arv_gc_invalidate_registers (arv_device_get_genicam (device));
+
+	if (local_error != NULL) {
+		g_propagate_error (error, local_error);
+		return FALSE;
+	}
+
+	arv_info_device ("[Device::import_configuration] %u register write%s", n_entries, n_entries > 1 ? "s" : "");
+
+	return TRUE;
+}
+
+/**
+ * arv_device_get_genicam:
+ * @device: a #ArvDevice
+ *
+ * Retrieves the genicam interface of the given device.
+ *
+ * Return value: (transfer none): the genicam interface.
+ *
+ * Since: 0.2.0
+ */
+
+ArvGc *
+arv_device_get_genicam (ArvDevice *device)
+{
+	g_return_val_if_fail (ARV_IS_DEVICE (device), NULL);
+
+	return ARV_DEVICE_GET_CLASS (device)->get_genicam (device);
+}
+
+/**
+ * arv_device_get_genicam_xml:
+ * @device: a #ArvDevice
+ * @size: (out) (allow-none): placeholder for the returned data size (bytes)
+ *
+ * Gets the Genicam XML data stored in the device memory.
+ *
+ * Returns: (transfer none): a pointer to the Genicam XML data, owned by the device.
+ *
+ * Since: 0.2.0
+ **/
+
+const char *
+arv_device_get_genicam_xml (ArvDevice *device, size_t *size)
+{
+	g_return_val_if_fail (ARV_IS_DEVICE (device), NULL);
+	g_return_val_if_fail (size != NULL, NULL);
+
+	if (ARV_DEVICE_GET_CLASS (device)->get_genicam_xml != NULL)
+		return ARV_DEVICE_GET_CLASS (device)->get_genicam_xml (device, size);
+
+	*size = 0;
+
+	return NULL;
+}
+
+/**
+ * arv_device_create_chunk_parser:
+ * @device: a #ArvDevice
+ *
+ * Create a #ArvChunkParser object, to be used for chunk data extraction from #ArvBuffer.
+ *
+ * Returns: (transfer full): a new #ArvChunkParser object, NULL on error.
+ *
+ * Since: 0.4.0
+ **/
+
+ArvChunkParser *
+arv_device_create_chunk_parser (ArvDevice *device)
+{
+	const char *xml = NULL;
+	gsize size = 0;
+
+	g_return_val_if_fail (ARV_IS_DEVICE (device), NULL);
+
+	xml = arv_device_get_genicam_xml (device, &size);
+
+	return arv_chunk_parser_new (xml, size);
+}
+
+/**
+ * arv_device_get_feature:
+ * @device: a #ArvDevice
+ * @feature: feature name
+ *
+ * The returned node is a stable handle on the feature, valid for the lifetime of @device. See arv_gc_get_node().
+ *
+ * Return value: (transfer none): the genicam node corresponding to the feature name, NULL if not found.
+ *
+ * Since: 0.2.0
+ */
+
+ArvGcNode *
+arv_device_get_feature (ArvDevice *device, const char *feature)
+{
+	ArvGc *genicam;
+
+	genicam = arv_device_get_genicam (device);
+	g_return_val_if_fail (ARV_IS_GC (genicam), NULL);
+
+	return arv_gc_get_node (genicam, feature);
+}
+
+/**
+ * arv_device_is_feature_available:
+ * @device: a #ArvDevice
+ * @feature: feature name
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Return: %TRUE if feature is available, %FALSE if not or on error.
+ *
+ * Since: 0.8.0
+ */
+
+gboolean
+arv_device_is_feature_available (ArvDevice *device, const char *feature, GError **error)
+{
+	ArvGcNode* node;
+
+	g_return_val_if_fail (ARV_IS_DEVICE (device), FALSE);
+	g_return_val_if_fail (feature != NULL, FALSE);
+
+	node = arv_device_get_feature (device, feature);
+	return ARV_IS_GC_FEATURE_NODE (node) && arv_gc_feature_node_is_available (ARV_GC_FEATURE_NODE (node), error);
+}
+
+static void *
+_get_feature (ArvDevice *device, GType node_type, const char *feature, GError **error)
+{
+	void *node;
+
+	g_return_val_if_fail (ARV_IS_DEVICE (device), NULL);
+	g_return_val_if_fail (feature != NULL, NULL);
+
+	node = arv_device_get_feature (device, feature);
+
+	if (node == NULL) {
+		g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_FEATURE_NOT_FOUND,
+			     "node '%s' not found", feature);
+		return NULL;
+	}
+
+	if (!(G_TYPE_CHECK_INSTANCE_TYPE ((node), node_type))) {
+		g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_WRONG_FEATURE,
+			     "node '%s' [%s]  is not a %s", feature, G_OBJECT_TYPE_NAME (node), g_type_name (node_type));
+		return NULL;
+	}
+
+	return node;
+}
+
+/**
+ * arv_device_execute_command:
+ * @device: a #ArvDevice
+ * @feature: feature name
+ * @error: a #GError placeholder
+ *
+ * Execute a genicam command.
+ *
+ * Since: 0.8.0
+ */
+
+void
+arv_device_execute_command (ArvDevice *device, const char *feature, GError **error)
+{
+	ArvGcNode *node;
+
+	node = _get_feature (device, ARV_TYPE_GC_COMMAND, feature, error);
+	if (node != NULL)
+		arv_gc_command_execute (ARV_GC_COMMAND (node), error);
+}
+
+/**
+ * arv_device_set_boolean_feature_value:
+ * @device: a #ArvDevice
+ * @feature: feature name
+ * @value: feature value
+ * @error: a #GError placeholder
+ *
+ * Set the value of a boolean feature.
+ *
+ * Since: 0.8.0
+ */
+
+void
+arv_device_set_boolean_feature_value (ArvDevice *device, const char *feature, gboolean value, GError **error)
+{
+	ArvGcNode *node;
+
+	node = _get_feature (device, ARV_TYPE_GC_BOOLEAN, feature, error);
+	if (node != NULL)
+		arv_gc_boolean_set_value (ARV_GC_BOOLEAN (node), value, error);
+}
+
+/**
+ * arv_device_get_boolean_feature_value:
+ * @device: a #ArvDevice
+ * @feature: feature name
+ * @error: a #GError placeholder
+ *
+ * Returns: the feature value, %FALSE on error.
+ *
+ * Since: 0.8.0
+ */
+
+gboolean
+arv_device_get_boolean_feature_value (ArvDevice *device, const char *feature, GError **error)
+{
+	ArvGcNode *node;
+
+	node = _get_feature (device, ARV_TYPE_GC_BOOLEAN, feature, error);
+	if (node != NULL)
+		return arv_gc_boolean_get_value (ARV_GC_BOOLEAN (node), error);
+
+	return FALSE;
+}
+
+/**
+ * arv_device_get_boolean_feature_value_gi: (rename-to arv_device_get_boolean_feature_value)
+ * @device: a #ArvDevice
+ * @feature: feature name
+ * @value: (out): feature value
+ * @error: a #GError placeholder
+ *
+ * Get the feature value, or %FALSE on error.
+ *
+ * Since: 0.8.0
+ */
+
+void
+arv_device_get_boolean_feature_value_gi	(ArvDevice *device, const char *feature, gboolean *value, GError **error)
 {
 	g_return_if_fail (value != NULL);
 
-	*value = arv_device_get_boolean_feature_value (device, feature, error);
+	*value = arv_device_get_boolean_feature_value (device, feature, error);
+}
+
+/**
+ * arv_device_set_string_feature_value:
+ * @device: a #ArvDevice
+ * @feature: feature name
+ * @value: new feature value
+ * @error: a #GError placeholder
+ *
+ * Set the string feature value.
+ *
+ * Since: 0.8.0
+ */
+
+void
+arv_device_set_string_feature_value (ArvDevice *device, const char *feature, const char *value, GError **error)
+{
+	ArvGcNode *node;
+
+	node = _get_feature (device, ARV_TYPE_GC_STRING, feature, error);
+	if (node != NULL)
+		arv_gc_string_set_value (ARV_GC_STRING (node), value, error);
+}
+
+/**
+ * arv_device_get_string_feature_value:
+ * @device: a #ArvDevice
+ * @feature: feature name
+ * @error: a #GError placeholder
+ *
+ * Returns: the string feature value, %NULL on error.
+ *
+ * Since: 0.8.0
+ */
+
+const char *
+arv_device_get_string_feature_value (ArvDevice *device, const char *feature, GError  **error)
+{
+	ArvGcNode *node;
+
+	node = _get_feature (device, ARV_TYPE_GC_STRING, feature, error);
+	if (node != NULL)
+		return arv_gc_string_get_value (ARV_GC_STRING (node), error);
+
+	return NULL;
+}
+
+/**
+ * arv_device_set_integer_feature_value:
+ * @device: a #ArvDevice
+ * @feature: feature name
+ * @value: new feature value
+ * @error: a #GError placeholder
+ *
+ * Set the integer feature value.
+ *
+ * Since: 0.8.0
+ */
+
+void
+arv_device_set_integer_feature_value (ArvDevice *device, const char *feature, gint64 value, GError **error)
+{
+	ArvGcNode *node;
+
+	node = _get_feature (device, ARV_TYPE_GC_INTEGER, feature, error);
+	if (node != NULL)
+		arv_gc_integer_set_value (ARV_GC_INTEGER (node), value, error);
+}
+
+/**
+ * arv_device_get_integer_feature_value:
+ * @device: a #ArvDevice
+ * @feature: feature name
+ * @error: a #GError placeholder
+ *
+ * Returns: the integer feature value, 0 on error.
+ *
+ * Since: 0.8.0
+ */
+
+gint64
+arv_device_get_integer_feature_value (ArvDevice *device, const char *feature, GError **error)
+{
+	ArvGcNode *node;
+
+	node = _get_feature (device, ARV_TYPE_GC_INTEGER, feature, error);
+	if (node != NULL)
+		return arv_gc_integer_get_value (ARV_GC_INTEGER (node), error);
+
+	return 0;
+}
+
+/**
+ * arv_device_get_integer_feature_values:
+ * @device: a #ArvDevice
+ * @n_features: number of features
+ * @features: (array length=n_features): feature names
+ * @values: (out caller-allocates) (array length=n_features): a placeholder for the feature values
+ * @error: a #GError placeholder
+ *
+ * Reads the values of several integer features. The features directly mapped to a 4 byte register, like IntReg
+ * nodes, are read together beforehand using arv_device_read_registers(), which makes polling a large set of status
+ * registers much faster than successive calls to arv_device_get_integer_feature_value().
+ *
+ * Returns: %TRUE on success. On error, the values of the features not read yet are set to 0.
+ *
+ * Since: 0.8.11
+ */
+
+gboolean
+arv_device_get_integer_feature_values (ArvDevice *device, guint n_features, const char **features, gint64 *values,
+				       GError **error)
+{
+	ArvGcRegisterNode **register_nodes;
+	GError *local_error = NULL;
+	guint n_register_nodes = 0;
+	guint i;
+
+	g_return_val_if_fail (ARV_IS_DEVICE (device), FALSE);
+	g_return_val_if_fail (features != NULL || n_features == 0, FALSE);
+	g_return_val_if_fail (values != NULL || n_features == 0, FALSE);
+
+	register_nodes = g_new (ArvGcRegisterNode *, n_features);
+	for (i = 0; i < n_features; i++) {
+		ArvGcNode *node = arv_device_get_feature (device, features[i]);
+
+		if (ARV_IS_GC_REGISTER_NODE (node) && ARV_IS_GC_INTEGER (node))
+			register_nodes[n_register_nodes++] = ARV_GC_REGISTER_NODE (node);
+	}
+
+	arv_gc_register_node_prefetch (register_nodes, n_register_nodes);
+
+	g_free (register_nodes);
+
+	for (i = 0; i < n_features; i++) {
+		if (local_error == NULL)
+			values[i] = arv_device_get_integer_feature_value (device, features[i], &local_error);
+		else
+			values[i] = 0;
+	}
+
+	if (local_error != NULL) {
+		g_propagate_error (error, local_error);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+/**
+ * arv_device_set_integer_feature_values:
+ * @device: a #ArvDevice
+ * @n_features: number of features
+ * @features: (array length=n_features): feature names
+ * @values: (array length=n_features): the new feature values
+ * @error: a #GError placeholder
+ *
+ * Writes the values of several integer features, in order. The MaskedIntReg and StructEntry features which are bit
+ * fields of the same register, like the trigger or IO line settings of many cameras, are merged into a single
+ * register write, preceded by at most one register read, at the position of the first of them. Successive calls to
+ * arv_device_set_integer_feature_value() take one read-modify-write round trip per field. All the features are
+ * checked against their range before anything is written, and the writes stop at the first failure.
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 0.8.11
+ */
+
+gboolean
+arv_device_set_integer_feature_values (ArvDevice *device, guint n_features, const char **features,
+				       const gint64 *values, GError **error)
+{
+	guint i;
+
+	g_return_val_if_fail (ARV_IS_DEVICE (device), FALSE);
+	g_return_val_if_fail (features != NULL || n_features == 0, FALSE);
+	g_return_val_if_fail (values != NULL || n_features == 0, FALSE);
+
+	for (i = 0; i < n_features; i++)
+		if (_get_feature (device, ARV_TYPE_GC_INTEGER, features[i], error) == NULL)
+			return FALSE;
+
+	return arv_gc_set_integer_values (arv_device_get_genicam (device), n_features, features, values, error);
+}
+
+static gboolean _read_polled_feature (ArvGcNode *node, GValue *value, GError **error);
+
+/**
+ * arv_device_read_feature_for_selectors:
+ * @device: a #ArvDevice
+ * @feature: feature name
+ * @selector: name of a selector of @feature
+ * @selector_values: (array length=n_selector_values): the selector values
+ * @n_selector_values: number of selector values
+ * @values: (array length=n_selector_values): zero filled #GValue placeholders for the feature values
+ * @error: a #GError placeholder
+ *
+ * Reads @feature for each of the @selector values, like a loop setting @selector and reading @feature would do.
+ * When the addresses of the selected values can be computed from the genicam description, that is for the Integer,
+ * Float and Enumeration features indexed by @selector, their registers are read directly, using a single device
+ * access when they are contiguous, and @selector is not changed. Other features are read in the loop, and @selector
+ * is restored to its original value afterwards.
+ *
+ * The values hold a #G_TYPE_INT64 for integer features, a #G_TYPE_DOUBLE for float features, a #G_TYPE_BOOLEAN
+ * for boolean features, and a #G_TYPE_STRING for enumeration and string features. They must be unset by the caller
+ * using g_value_unset(). On error, all the values are left uninitialized.
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 0.8.11
+ */
+
+gboolean
+arv_device_read_feature_for_selectors (ArvDevice *device, const char *feature, const char *selector,
+				       const gint64 *selector_values, guint n_selector_values,
+				       GValue *values, GError **error)
+{
+	ArvGcNode *feature_node;
+	ArvGcNode *selector_node;
+	GError *local_error = NULL;
+	gint64 selector_value;
+	guint n_read = 0;
+	guint i;
+
+	g_return_val_if_fail (ARV_IS_DEVICE (device), FALSE);
+	g_return_val_if_fail (selector_values != NULL || n_selector_values == 0, FALSE);
+	g_return_val_if_fail (values != NULL || n_selector_values == 0, FALSE);
+	g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+
+	feature_node = _get_feature (device, ARV_TYPE_GC_FEATURE_NODE, feature, error);
+	if (feature_node == NULL)
+		return FALSE;
+	selector_node = _get_feature (device, ARV_TYPE_GC_INTEGER, selector, error);
+	if (selector_node == NULL)
+		return FALSE;
+
+	if (arv_gc_read_feature_for_selector (arv_device_get_genicam (device), ARV_GC_FEATURE_NODE (feature_node),
+					      ARV_GC_FEATURE_NODE (selector_node), selector_values, n_selector_values,
+					      values, &local_error))
+		return TRUE;
+
+	if (local_error != NULL) {
+		g_propagate_error (error, local_error);
+		return FALSE;
+	}
+
+	arv_debug_device ("[Device::read_feature_for_selectors] Sweep '%s' over '%s'", feature, selector);
+
+	selector_value = arv_gc_integer_get_value (ARV_GC_INTEGER (selector_node), &local_error);
+
+	if (local_error == NULL && n_selector_values > 0) {
+		GError *restore_error = NULL;
+
+		for (n_read = 0; n_read < n_selector_values; n_read++) {
+			arv_gc_integer_set_value (ARV_GC_INTEGER (selector_node), selector_values[n_read],
+						  &local_error);
+			if (local_error != NULL ||
+			    !_read_polled_feature (feature_node, &values[n_read], &local_error))
+				break;
+		}
+
+		arv_gc_integer_set_value (ARV_GC_INTEGER (selector_node), selector_value, &restore_error);
+		if (restore_error != NULL && local_error == NULL)
+			local_error = restore_error;
+		else
+			g_clear_error (&restore_error);
+	}
+
+	if (local_error != NULL) {
+		for (i = 0; i < n_read; i++)
+			g_value_unset (&values[i]);
+
+		g_propagate_error (error, local_error);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+/**
+ * arv_device_set_integer_feature_for_selectors:
+ * @device: a #ArvDevice
+ * @feature: feature name
+ * @selector: name of a selector of @feature
+ * @selector_values: (array length=n_selector_values): the selector values
+ * @n_selector_values: number of selector values
+ * @values: (array length=n_selector_values): the feature values
+ * @error: a #GError placeholder
+ *
+ * Writes an integer feature for each of the @selector values, like a loop setting @selector and @feature would do.
+ * This is intended for the upload of tables, like the LUTs accessed through the LUTIndex and LUTValue features. When
+ * @feature is an IntReg register with a pIndex linked to @selector, or an Integer feature linked to such a register,
+ * the register addresses are computed for each selector value, the values of contiguous registers are written
+ * together using large memory writes, and @selector is not changed. Other features are written in the loop, and
+ * @selector is restored to its original value afterwards.
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 0.8.11
+ */
+
+gboolean
+arv_device_set_integer_feature_for_selectors (ArvDevice *device, const char *feature, const char *selector,
+					      const gint64 *selector_values, guint n_selector_values,
+					      const gint64 *values, GError **error)
+{
+	ArvGcNode *feature_node;
+	ArvGcNode *selector_node;
+	GError *local_error = NULL;
+	gint64 selector_value;
+	guint i;
+
+	g_return_val_if_fail (ARV_IS_DEVICE (device), FALSE);
+	g_return_val_if_fail (selector_values != NULL || n_selector_values == 0, FALSE);
+	g_return_val_if_fail (values != NULL || n_selector_values == 0, FALSE);
+	g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+
+	feature_node = _get_feature (device, ARV_TYPE_GC_INTEGER, feature, error);
+	if (feature_node == NULL)
+		return FALSE;
+	selector_node = _get_feature (device, ARV_TYPE_GC_INTEGER, selector, error);
+	if (selector_node == NULL)
+		return FALSE;
+
+	if (arv_gc_write_integer_feature_for_selector (arv_device_get_genicam (device),
+						       ARV_GC_FEATURE_NODE (feature_node),
+						       ARV_GC_FEATURE_NODE (selector_node),
+						       selector_values, n_selector_values, values, &local_error))
+		return TRUE;
+
+	if (local_error != NULL) {
+		g_propagate_error (error, local_error);
+		return FALSE;
+	}
+
+	arv_debug_device ("[Device::set_integer_feature_for_selectors] Sweep '%s' over '%s'", feature, selector);
+
+	selector_value = arv_gc_integer_get_value (ARV_GC_INTEGER (selector_node), &local_error);
+
+	if (local_error == NULL && n_selector_values > 0) {
+		GError *restore_error = NULL;
+
+		for (i = 0; i < n_selector_values && local_error == NULL; i++) {
+			arv_gc_integer_set_value (ARV_GC_INTEGER (selector_node), selector_values[i], &local_error);
+			if (local_error == NULL)
+				arv_gc_integer_set_value (ARV_GC_INTEGER (feature_node), values[i], &local_error);
+		}
+
+		arv_gc_integer_set_value (ARV_GC_INTEGER (selector_node), selector_value, &restore_error);
+		if (restore_error != NULL && local_error == NULL)
+			local_error = restore_error;
+		else
+			g_clear_error (&restore_error);
+	}
+
+	if (local_error != NULL) {
+		g_propagate_error (error, local_error);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+/**
+ * arv_device_get_integer_feature_bounds:
+ * @device: a #ArvDevice
+ * @feature: feature name
+ * @min: (out): minimum feature value
+ * @max: (out): maximum feature value
+ * @error: a #GError placeholder
+ *
+ * Retrieves feature bounds.
+ *
+ * Since: 0.8.0
+ */
+
+void
+arv_device_get_integer_feature_bounds (ArvDevice *device, const char *feature, gint64 *min, gint64 *max, GError **error)
+{
+	ArvGcNode *node;
+
+	if (min != NULL)
+		*min = G_MININT64;
+	if (max != NULL)
+		*max = G_MAXINT64;
+
+	node = _get_feature (device, ARV_TYPE_GC_INTEGER, feature, error);
+	if (node != NULL) {
+		GError *local_error = NULL;
+
+		if (min != NULL) {
+			gint64 minimum;
+
+			minimum = arv_gc_integer_get_min (ARV_GC_INTEGER (node), &local_error);
+
+			if (local_error != NULL) {
+				g_propagate_error (error, local_error);
+				return;
+			}
+
+			*min = minimum;
+		}
+
+		if (max != NULL) {
+			gint64 maximum;
+
+			maximum = arv_gc_integer_get_max (ARV_GC_INTEGER (node), &local_error);
+
+			if (local_error != NULL) {
+				g_propagate_error (error, local_error);
+				return;
+			}
+
+			*max = maximum;
+		}
+	}
+}
+
+/**
+ * arv_device_get_integer_feature_increment:
+ * @device: a #ArvDevice
+ * @feature: feature name
+ * @error: a #GError placeholder
+ *
+ * Not all integer features have evenly distributed allowed values, which means the returned increment may not reflect the allowed value
+ * set.
+ *
+ * Returns: feature value increment, or 1 on error.
+ *
+ * Since: 0.8.0
+ */
+
+gint64
+arv_device_get_integer_feature_increment (ArvDevice *device, const char *feature, GError **error)
+{
+	ArvGcNode *node;
+
+	node = _get_feature (device, ARV_TYPE_GC_INTEGER, feature, error);
+	if (node != NULL) {
+		GError *local_error = NULL;
+		gint64 increment;
+
+		increment = arv_gc_integer_get_inc (ARV_GC_INTEGER (node), &local_error);
+
+			if (local_error != NULL) {
+				g_propagate_error (error, local_error);
+				return 1;
+			}
+
+			return increment;
+	}
+
+	return 1;
+}
+
+/**
+ * arv_device_set_float_feature_value:
+ * @device: a #ArvDevice
+ * @feature: feature name
+ * @value: new feature value
+ * @error: a #GError placeholder
+ *
+ * Set the float feature value.
+ *
+ * Since: 0.8.0
+ */
+
+void
+arv_device_set_float_feature_value (ArvDevice *device, const char *feature, double value, GError **error)
+{
+	ArvGcNode *node;
+
+	node = _get_feature (device, ARV_TYPE_GC_FLOAT, feature, error);
+	if (node != NULL)
+		arv_gc_float_set_value (ARV_GC_FLOAT (node), value, error);
+}
+
+/**
+ * arv_device_get_float_feature_value:
+ * @device: a #ArvDevice
+ * @feature: feature name
+ * @error: a #GError placeholder
+ *
+ * Returns: the float feature value, 0.0 on error.
+ *
+ * Since: 0.8.0
+ */
+
+double
+arv_device_get_float_feature_value (ArvDevice *device, const char *feature, GError **error)
+{
+	ArvGcNode *node;
+
+	node = _get_feature (device, ARV_TYPE_GC_FLOAT, feature, error);
+	if (node != NULL)
+		return  arv_gc_float_get_value (ARV_GC_FLOAT (node), error);
+
+	return 0.0;
+}
+
+/**
+ * arv_device_get_float_feature_bounds:
+ * @device: a #ArvDevice
+ * @feature: feature name
+ * @min: (out): minimum feature value
+ * @max: (out): maximum feature value
+ * @error: a #GError placeholder
+ *
+ * Retrieves feature bounds.
+ *
+ * Since: 0.8.0
+ */
+
+void
+arv_device_get_float_feature_bounds (ArvDevice *device, const char *feature, double *min, double *max, GError **error)
+{
+	ArvGcNode *node;
+
+	if (min != NULL)
+		*min = -G_MAXDOUBLE;
+	if (max != NULL)
+		*max = G_MAXDOUBLE;
+
+	node = _get_feature (device, ARV_TYPE_GC_FLOAT, feature, error);
+	if (node != NULL) {
+		GError *local_error = NULL;
+
+		if (min != NULL) {
+			double minimum;
+
+			minimum = arv_gc_float_get_min (ARV_GC_FLOAT (node), &local_error);
+
+			if (local_error != NULL) {
+				g_propagate_error (error, local_error);
+				return;
+			}
+
+			*min = minimum;
+		}
+
+		if (max != NULL) {
+			double maximum;
+
+			maximum = arv_gc_float_get_max (ARV_GC_FLOAT (node), &local_error);
+
+			if (local_error != NULL) {
+				g_propagate_error (error, local_error);
+				return;
+			}
+
+			*max = maximum;
+		}
+	}
+}
+
+/**
+ * arv_device_dup_available_enumeration_feature_values:
+ * @device: an #ArvDevice
+ * @feature: feature name
+ * @n_values: placeholder for the number of returned values
+ * @error: a #GError placeholder
+ *
+ * Get all the available values of @feature, as integers.
+ *
+ * Returns: (array length=n_values) (transfer container): a newly created array of 64 bit integers, which must freed after use using g_free,
+ * or NULL on error.
+ *
+ * Since: 0.8.0
+ */
+
+gint64 *
+arv_device_dup_available_enumeration_feature_values (ArvDevice *device, const char *feature, guint *n_values, GError **error)
+{
+	ArvGcNode *node;
+
+	if (n_values != NULL)
+		*n_values = 0;
+
+	node = _get_feature (device, ARV_TYPE_GC_ENUMERATION, feature, error);
+	if (node != NULL)
+		return arv_gc_enumeration_dup_available_int_values (ARV_GC_ENUMERATION (node), n_values, error);
+
+	return NULL;
+}
+
+/**
+ * arv_device_dup_available_enumeration_feature_values_as_strings:
+ * @device: an #ArvDevice
+ * @feature: feature name
+ * @n_values: placeholder for the number of returned values
+ * @error: a #GError placeholder
+ *
+ * Get all the available values of @feature, as strings.
+ *
+ * Returns: (array length=n_values) (transfer container): a newly created array of const strings, which must freed after use using g_free,
+ * or NULL on error.
+ *
+ * Since: 0.8.0
+ */
+
+const char **
+arv_device_dup_available_enumeration_feature_values_as_strings (ArvDevice *device, const char *feature, guint *n_values, GError **error)
+{
+	ArvGcNode *node;
+
+	if (n_values != NULL)
+		*n_values = 0;
+
+	node = _get_feature (device, ARV_TYPE_GC_ENUMERATION, feature, error);
+	if (node != NULL)
+		return arv_gc_enumeration_dup_available_string_values (ARV_GC_ENUMERATION (node), n_values, error);
+
+	return NULL;
+}
+
+/**
+ * arv_device_dup_available_enumeration_feature_values_as_display_names:
+ * @device: an #ArvDevice
+ * @feature: feature name
+ * @n_values: placeholder for the number of returned values
+ * @error: a #GError placeholder
+ *
+ * Get display names of all the available entries of @feature.
+ *
+ * Returns: (array length=n_values) (transfer container): a newly created array of const strings, to be freed after use using g_free, or
+ * %NULL on error.
+ *
+ * Since: 0.8.0
+ */
+
+const char **
+arv_device_dup_available_enumeration_feature_values_as_display_names (ArvDevice *device, const char *feature, guint *n_values, GError **error)
+{
+	ArvGcNode *node;
+
+	if (n_values != NULL)
+		*n_values = 0;
+
+	node = _get_feature (device, ARV_TYPE_GC_ENUMERATION, feature, error);
+	if (node != NULL)
+		return arv_gc_enumeration_dup_available_display_names (ARV_GC_ENUMERATION (node), n_values, error);
+
+	return NULL;
+}
+
+/**
+ * arv_device_set_features_from_string:
+ * @device: a #ArvDevice
+ * @string: a space separated list of features assignments
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Set features from a string containing a list of space separated feature assignments or command names. For example:
+ *
+ * |[<!-- language="C" -->
+ * arv_device_set_features_from_string (device, "Width=256 Height=256 PixelFormat='Mono8' TriggerStart", &error);
+ * ]|
+ *
+ * Since: 0.8.0
+ */
+
+gboolean
+arv_device_set_features_from_string (ArvDevice *device, const char *string, GError **error)
+{
+	GMatchInfo *match_info = NULL;
+	GError *local_error = NULL;
+	GRegex *regex;
+
+	g_return_val_if_fail (ARV_IS_DEVICE (device), FALSE);
+
+	if (string == NULL)
+		return TRUE;
+
+	regex = g_regex_new ("((?<Key>[^\\s\"'\\=]+)|\"(?<Key>[^\"]*)\"|'(?<Key>[^']*)')"
+			     "(?:\\=((?<Value>[^\\s\"']+)|\"(?<Value>[^\"]*)\"|'(?<Value>[^']*)'))?",
+			     G_REGEX_DUPNAMES, 0, NULL);
+
+	if (g_regex_match (regex, string, 0, &match_info)) {
+		while (g_match_info_matches (match_info) && local_error == NULL) {
+			ArvGcNode *feature;
+			char *key = g_match_info_fetch_named (match_info, "Key");
+			char *value = g_match_info_fetch_named (match_info, "Value");
+
+			feature = arv_device_get_feature (device, key);
+			if (ARV_IS_GC_FEATURE_NODE (feature)) {
+				if (value != NULL)
+					arv_gc_feature_node_set_value_from_string (ARV_GC_FEATURE_NODE (feature), value, &local_error);
+				else
+					arv_device_execute_command (device, key, &local_error);
+			} else
+				g_set_error (&local_error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_FEATURE_NOT_FOUND,
+					     "node '%s' not found", key);
+
+			g_free (key);
+			g_free (value);
+
+			g_match_info_next (match_info, NULL);
+		}
+		g_match_info_unref (match_info);
+	}
+
+	g_regex_unref (regex);
+
+	if (local_error != NULL) {
+		g_propagate_error (error, local_error);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+/* Asynchronous feature access and feature polling
+ *
+ * The requests are queued to a worker thread owned by the device, created on demand, which executes the writes and
+ * the commands in order. The registers of consecutive reads, whatever the feature type, are prefetched together using
+ * arv_gc_prefetch_features(), then the reads are run concurrently from a thread pool, as the Genicam tree allows
+ * concurrent readers, with up to one thread per slot of the GigE Vision command window, which keeps as many commands
+ * in flight. Between the requests, the worker thread also reads the polled features which are due, also using a
+ * single prefetch for all of them.
+ *
+ * The worker state is shared between the device and the thread, as the last device reference may be released by
+ * the thread itself. */
+
+typedef struct {
+	char *name;
+	gint64 interval_us;
+	gint64 next_time_us;
+	gint64 timestamp_us;
+	/* Unset until the first successful read */
+	GValue value;
+} ArvDevicePolledFeature;
+
+static void
+arv_device_polled_feature_free (ArvDevicePolledFeature *polled_feature)
+{
+	if (G_IS_VALUE (&polled_feature->value))
+		g_value_unset (&polled_feature->value);
+	g_free (polled_feature->name);
+	g_free (polled_feature);
+}
+
+struct _ArvDeviceFeatureWorker {
+	gint ref_count;
+
+	GAsyncQueue *queue;
+
+	GMutex mutex;
+	/* Cleared when the device is disposed */
+	ArvDevice *device;
+	GHashTable *polled_features;
+
+	/* Concurrent reads, only used by the worker thread, see _run_feature_reads() */
+	GThreadPool *read_pool;
+	GMutex read_mutex;
+	GCond read_cond;
+	guint n_pending_reads;
+};
+
+static ArvDeviceFeatureWorker *
+arv_device_feature_worker_new (ArvDevice *device)
+{
+	ArvDeviceFeatureWorker *worker;
+
+	worker = g_new0 (ArvDeviceFeatureWorker, 1);
+	worker->ref_count = 1;
+	worker->queue = g_async_queue_new ();
+	g_mutex_init (&worker->mutex);
+	g_mutex_init (&worker->read_mutex);
+	g_cond_init (&worker->read_cond);
+	worker->device = device;
+	worker->polled_features = g_hash_table_new_full (g_str_hash, g_str_equal, NULL,
+							 (GDestroyNotify) arv_device_polled_feature_free);
+
+	return worker;
+}
+
+static ArvDeviceFeatureWorker *
+arv_device_feature_worker_ref (ArvDeviceFeatureWorker *worker)
+{
+	g_atomic_int_inc (&worker->ref_count);
+
+	return worker;
+}
+
+static void
+arv_device_feature_worker_unref (ArvDeviceFeatureWorker *worker)
+{
+	if (!g_atomic_int_dec_and_test (&worker->ref_count))
+		return;
+
+	g_hash_table_unref (worker->polled_features);
+	g_cond_clear (&worker->read_cond);
+	g_mutex_clear (&worker->read_mutex);
+	g_mutex_clear (&worker->mutex);
+	g_async_queue_unref (worker->queue);
+	g_free (worker);
+}
+
+typedef struct {
+	ArvDevice *device;
+	ArvDeviceFeatureRequestType type;
+	char *feature;
+	ArvDeviceFeatureValue value;
+} ArvDeviceFeatureRequest;
+
+static void
+arv_device_feature_request_free (ArvDeviceFeatureRequest *request)
+{
+	g_free (request->feature);
+	g_free (request->value.v_string);
+	g_free (request);
+}
+
+/* Queued to stop the worker thread */
+static char arv_device_feature_thread_stop;
+/* Queued to wake up the worker thread when the polled feature list changes */
+static char arv_device_feature_thread_wakeup;
+
+static void
+_run_feature_request (GTask *task)
+{
+	ArvDeviceFeatureRequest *request = g_task_get_task_data (task);
+	ArvDevice *device = request->device;
+	GError *error = NULL;
+
+	if (g_task_return_error_if_cancelled (task))
+		return;
+
+	switch (request->type) {
+		case ARV_DEVICE_FEATURE_REQUEST_EXECUTE_COMMAND:
+			arv_device_execute_command (device, request->feature, &error);
+			break;
+		case ARV_DEVICE_FEATURE_REQUEST_SET_BOOLEAN:
+			arv_device_set_boolean_feature_value (device, request->feature, request->value.v_int64, &error);
+			break;
+		case ARV_DEVICE_FEATURE_REQUEST_GET_BOOLEAN:
+			request->value.v_int64 = arv_device_get_boolean_feature_value (device, request->feature, &error);
+			break;
+		case ARV_DEVICE_FEATURE_REQUEST_SET_STRING:
+			arv_device_set_string_feature_value (device, request->feature, request->value.v_string, &error);
+			break;
+		case ARV_DEVICE_FEATURE_REQUEST_GET_STRING:
+			request->value.v_string = g_strdup (arv_device_get_string_feature_value (device, request->feature,
+												 &error));
+			break;
+		case ARV_DEVICE_FEATURE_REQUEST_SET_INTEGER:
+			arv_device_set_integer_feature_value (device, request->feature, request->value.v_int64, &error);
+			break;
+		case ARV_DEVICE_FEATURE_REQUEST_GET_INTEGER:
+			request->value.v_int64 = arv_device_get_integer_feature_value (device, request->feature, &error);
+			break;
+		case ARV_DEVICE_FEATURE_REQUEST_SET_FLOAT:
+			arv_device_set_float_feature_value (device, request->feature, request->value.v_double, &error);
+			break;
+		case ARV_DEVICE_FEATURE_REQUEST_GET_FLOAT:
+			request->value.v_double = arv_device_get_float_feature_value (device, request->feature, &error);
+			break;
+	}
+
+	if (error != NULL)
+		g_task_return_error (task, error);
+	else
+		g_task_return_boolean (task, TRUE);
+}
+
+static gboolean
+_is_feature_read (gpointer data)
+{
+	ArvDeviceFeatureRequest *request;
+
+	if (data == &arv_device_feature_thread_stop ||
+	    data == &arv_device_feature_thread_wakeup)
+		return FALSE;
+
+	request = g_task_get_task_data (data);
+
+	switch (request->type) {
+		case ARV_DEVICE_FEATURE_REQUEST_GET_BOOLEAN:
+		case ARV_DEVICE_FEATURE_REQUEST_GET_STRING:
+		case ARV_DEVICE_FEATURE_REQUEST_GET_INTEGER:
+		case ARV_DEVICE_FEATURE_REQUEST_GET_FLOAT:
+			return TRUE;
+		default:
+			return FALSE;
+	}
+}
+
+/* Number of commands the device can process at the same time. USB3 Vision allows a single outstanding request. */
+
+static guint
+_get_command_window (ArvDevice *device)
+{
+	if (ARV_IS_GV_DEVICE (device))
+		return arv_gv_device_get_command_window (ARV_GV_DEVICE (device));
+
+	return 1;
+}
+
+static void
+_run_pooled_read (gpointer data, gpointer user_data)
+{
+	ArvDeviceFeatureWorker *worker = user_data;
+
+	_run_feature_request (data);
+	g_object_unref (data);
+
+	g_mutex_lock (&worker->read_mutex);
+	worker->n_pending_reads--;
+	if (worker->n_pending_reads == 0)
+		g_cond_signal (&worker->read_cond);
+	g_mutex_unlock (&worker->read_mutex);
+}
+
+/* Runs consecutive reads. The 4 byte registers they are linked to are read in a single batch, and the remaining
+ * device accesses, like the string registers, are issued concurrently, filling the command window. */
+
+static void
+_run_feature_reads (ArvDeviceFeatureWorker *worker, GPtrArray *tasks)
+{
+	ArvDeviceFeatureRequest *request = g_task_get_task_data (g_ptr_array_index (tasks, 0));
+	ArvDevice *device = request->device;
+	ArvGcFeatureNode **features;
+	guint n_features = 0;
+	guint n_commands;
+	guint i;
+
+	features = g_new (ArvGcFeatureNode *, tasks->len);
+	for (i = 0; i < tasks->len; i++) {
+		ArvGcNode *node;
+
+		request = g_task_get_task_data (g_ptr_array_index (tasks, i));
+		node = arv_device_get_feature (device, request->feature);
+		if (ARV_IS_GC_FEATURE_NODE (node))
+			features[n_features++] = ARV_GC_FEATURE_NODE (node);
+	}
+
+	arv_gc_prefetch_features (arv_device_get_genicam (device), features, n_features);
+
+	g_free (features);
+
+	n_commands = _get_command_window (device);
+
+	if (n_commands < 2 || tasks->len < 2) {
+		for (i = 0; i < tasks->len; i++) {
+			_run_feature_request (g_ptr_array_index (tasks, i));
+			g_object_unref (g_ptr_array_index (tasks, i));
+		}
+		return;
+	}
+
+	if (worker->read_pool == NULL)
+		worker->read_pool = g_thread_pool_new (_run_pooled_read, worker, n_commands, TRUE, NULL);
+	else
+		g_thread_pool_set_max_threads (worker->read_pool, n_commands, NULL);
+
+	g_mutex_lock (&worker->read_mutex);
+	worker->n_pending_reads = tasks->len;
+	g_mutex_unlock (&worker->read_mutex);
+
+	for (i = 0; i < tasks->len; i++)
+		g_thread_pool_push (worker->read_pool, g_ptr_array_index (tasks, i), NULL);
+
+	g_mutex_lock (&worker->read_mutex);
+	while (worker->n_pending_reads > 0)
+		g_cond_wait (&worker->read_cond, &worker->read_mutex);
+	g_mutex_unlock (&worker->read_mutex);
+}
+
+static gboolean
+_is_pollable (ArvGcNode *node)
+{
+	return ARV_IS_GC_ENUMERATION (node) ||
+		ARV_IS_GC_BOOLEAN (node) ||
+		ARV_IS_GC_INTEGER (node) ||
+		ARV_IS_GC_FLOAT (node) ||
+		ARV_IS_GC_STRING (node);
+}
+
+static gboolean
+_read_polled_feature (ArvGcNode *node, GValue *value, GError **error)
+{
+	GError *local_error = NULL;
+
+	if (ARV_IS_GC_ENUMERATION (node)) {
+		g_value_init (value, G_TYPE_STRING);
+		g_value_set_string (value, arv_gc_enumeration_get_string_value (ARV_GC_ENUMERATION (node),
+										&local_error));
+	} else if (ARV_IS_GC_BOOLEAN (node)) {
+		g_value_init (value, G_TYPE_BOOLEAN);
+		g_value_set_boolean (value, arv_gc_boolean_get_value (ARV_GC_BOOLEAN (node), &local_error));
+	} else if (ARV_IS_GC_INTEGER (node)) {
+		g_value_init (value, G_TYPE_INT64);
+		g_value_set_int64 (value, arv_gc_integer_get_value (ARV_GC_INTEGER (node), &local_error));
+	} else if (ARV_IS_GC_FLOAT (node)) {
+		g_value_init (value, G_TYPE_DOUBLE);
+		g_value_set_double (value, arv_gc_float_get_value (ARV_GC_FLOAT (node), &local_error));
+	} else {
+		g_value_init (value, G_TYPE_STRING);
+		g_value_set_string (value, arv_gc_string_get_value (ARV_GC_STRING (node), &local_error));
+	}
+
+	if (local_error != NULL) {
+		g_value_unset (value);
+		g_propagate_error (error, local_error);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+static void
+_read_polled_features (ArvDeviceFeatureWorker *worker, ArvDevice *device, GPtrArray *features)
+{
+	ArvGc *genicam = arv_device_get_genicam (device);
+	ArvGcRegisterNode **register_nodes;
+	guint n_register_nodes = 0;
+	guint i;
+
+	register_nodes = g_new (ArvGcRegisterNode *, features->len);
+	for (i = 0; i < features->len; i++) {
+		ArvGcRegisterNode *register_node = arv_gc_get_feature_register (genicam,
+										g_ptr_array_index (features, i));
+
+		if (register_node != NULL)
+			register_nodes[n_register_nodes++] = register_node;
+	}
+
+	arv_gc_register_node_prefetch (register_nodes, n_register_nodes);
+
+	g_free (register_nodes);
+
+	for (i = 0; i < features->len; i++) {
+		const char *feature = g_ptr_array_index (features, i);
+		ArvDevicePolledFeature *polled_feature;
+		GValue value = G_VALUE_INIT;
+		GError *error = NULL;
+
+		if (!_read_polled_feature (arv_device_get_feature (device, feature), &value, &error)) {
+			arv_debug_device ("[Device::poll] Failed to read '%s': %s", feature, error->message);
+			g_clear_error (&error);
+			continue;
+		}
+
+		g_mutex_lock (&worker->mutex);
+		polled_feature = g_hash_table_lookup (worker->polled_features, feature);
+		if (polled_feature != NULL) {
+			if (G_IS_VALUE (&polled_feature->value))
+				g_value_unset (&polled_feature->value);
+			g_value_init (&polled_feature->value, G_VALUE_TYPE (&value));
+			g_value_copy (&value, &polled_feature->value);
+			polled_feature->timestamp_us = g_get_monotonic_time ();
+		}
+		g_mutex_unlock (&worker->mutex);
+
+		g_value_unset (&value);
+
+		if (polled_feature != NULL)
+			g_signal_emit (device, arv_device_signals[ARV_DEVICE_SIGNAL_FEATURE_POLLED],
+				       g_quark_from_string (feature), feature);
+	}
+}
+
+static gboolean
+_has_resend_pressure (ArvDevice *device)
+{
+	ArvDeviceClass *device_class = ARV_DEVICE_GET_CLASS (device);
+
+	return device_class->has_resend_pressure != NULL && device_class->has_resend_pressure (device);
+}
+
+/* Reads the due polled features, and returns the delay until the next one, or -1 if there is none */
+
+static gint64
+_poll_features (ArvDeviceFeatureWorker *worker)
+{
+	ArvDevicePolledFeature *polled_feature;
+	ArvDevice *device;
+	GHashTableIter iter;
+	GPtrArray *features;
+	gint64 next_time_us = G_MAXINT64;
+	gint64 time_us;
+
+	g_mutex_lock (&worker->mutex);
+
+	device = worker->device;
+	if (device == NULL || g_hash_table_size (worker->polled_features) == 0) {
+		g_mutex_unlock (&worker->mutex);
+		return -1;
+	}
+
+	features = g_ptr_array_new_with_free_func (g_free);
+	time_us = g_get_monotonic_time ();
+
+	g_hash_table_iter_init (&iter, worker->polled_features);
+	while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &polled_feature)) {
+		if (polled_feature->next_time_us <= time_us) {
+			g_ptr_array_add (features, g_strdup (polled_feature->name));
+			polled_feature->next_time_us += polled_feature->interval_us;
+			if (polled_feature->next_time_us <= time_us)
+				polled_feature->next_time_us = time_us + polled_feature->interval_us;
+		}
+	}
+
+	g_mutex_unlock (&worker->mutex);
+
+	/* The device can't be disposed while the worker thread is running, as its disposal waits for the thread */
+
+	if (features->len > 0) {
+		if (_has_resend_pressure (device))
+			arv_debug_device ("[Device::poll] Skip %u features because of resend pressure",
+					  features->len);
+		else
+			_read_polled_features (worker, device, features);
+	}
+
+	g_ptr_array_unref (features);
+
+	g_mutex_lock (&worker->mutex);
+
+	g_hash_table_iter_init (&iter, worker->polled_features);
+	while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &polled_feature))
+		next_time_us = MIN (next_time_us, polled_feature->next_time_us);
+
+	g_mutex_unlock (&worker->mutex);
+
+	if (next_time_us == G_MAXINT64)
+		return -1;
+
+	return MAX (0, next_time_us - g_get_monotonic_time ());
+}
+
+static gpointer
+_feature_thread (gpointer data)
+{
+	ArvDeviceFeatureWorker *worker = data;
+	gpointer next = NULL;
+	gint auxiliary_generation = 0;
+
+	for (;;) {
+		gpointer task;
+		gint64 timeout_us;
+
+		g_mutex_lock (&worker->mutex);
+		if (worker->device != NULL)
+			arv_device_update_auxiliary_thread_placement (worker->device, &auxiliary_generation);
+		g_mutex_unlock (&worker->mutex);
+
+		timeout_us = _poll_features (worker);
+
+		if (next != NULL)
+			task = next;
+		else if (timeout_us < 0)
+			task = g_async_queue_pop (worker->queue);
+		else
+			task = g_async_queue_timeout_pop (worker->queue, timeout_us);
+		next = NULL;
+
+		if (task == NULL || task == &arv_device_feature_thread_wakeup)
+			continue;
+
+		if (task == &arv_device_feature_thread_stop)
+			break;
+
+		if (_is_feature_read (task)) {
+			GPtrArray *tasks = g_ptr_array_new ();
+
+			g_ptr_array_add (tasks, task);
+			while ((next = g_async_queue_try_pop (worker->queue)) != NULL && _is_feature_read (next)) {
+				g_ptr_array_add (tasks, next);
+				next = NULL;
+			}
+
+			_run_feature_reads (worker, tasks);
+			g_ptr_array_unref (tasks);
+		} else {
+			_run_feature_request (task);
+			g_object_unref (task);
+		}
+	}
+
+	if (worker->read_pool != NULL)
+		g_thread_pool_free (worker->read_pool, FALSE, TRUE);
+	worker->read_pool = NULL;
+
+	arv_device_feature_worker_unref (worker);
+
+	return NULL;
+}
+
+static ArvDeviceFeatureWorker *
+_get_feature_worker (ArvDevice *device)
+{
+	ArvDevicePrivate *priv = arv_device_get_instance_private (device);
+
+	g_mutex_lock (&priv->feature_mutex);
+	if (priv->feature_worker == NULL) {
+		priv->feature_worker = arv_device_feature_worker_new (device);
+		priv->feature_thread = g_thread_new ("arv_device_features", _feature_thread,
+						     arv_device_feature_worker_ref (priv->feature_worker));
+	}
+	g_mutex_unlock (&priv->feature_mutex);
+
+	return priv->feature_worker;
+}
+
+void
+arv_device_feature_request_async (ArvDevice *device, gpointer source_object, gpointer source_tag,
+				  ArvDeviceFeatureRequestType type, const char *feature,
+				  const ArvDeviceFeatureValue *value,
+				  GCancellable *cancellable, GAsyncReadyCallback callback, gpointer user_data)
+{
+	ArvDeviceFeatureRequest *request;
+	GTask *task;
+
+	g_return_if_fail (ARV_IS_DEVICE (device));
+	g_return_if_fail (feature != NULL);
+
+	request = g_new0 (ArvDeviceFeatureRequest, 1);
+	request->device = device;
+	request->type = type;
+	request->feature = g_strdup (feature);
+	if (value != NULL) {
+		request->value.v_int64 = value->v_int64;
+		request->value.v_double = value->v_double;
+		request->value.v_string = g_strdup (value->v_string);
+	}
+
+	task = g_task_new (source_object, cancellable, callback, user_data);
+	g_task_set_source_tag (task, source_tag);
+	g_task_set_task_data (task, request, (GDestroyNotify) arv_device_feature_request_free);
+
+	g_async_queue_push (_get_feature_worker (device)->queue, task);
+}
+
+gboolean
+arv_device_feature_request_finish (GAsyncResult *result, gpointer source_object, gpointer source_tag,
+				   ArvDeviceFeatureValue *value, GError **error)
+{
+	ArvDeviceFeatureRequest *request;
+
+	g_return_val_if_fail (g_task_is_valid (result, source_object), FALSE);
+	g_return_val_if_fail (g_task_get_source_tag (G_TASK (result)) == source_tag, FALSE);
+
+	if (!g_task_propagate_boolean (G_TASK (result), error))
+		return FALSE;
+
+	request = g_task_get_task_data (G_TASK (result));
+
+	if (value != NULL) {
+		value->v_int64 = request->value.v_int64;
+		value->v_double = request->value.v_double;
+		value->v_string = g_steal_pointer (&request->value.v_string);
+	}
+
+	return TRUE;
 }
 
 /**
- * arv_device_set_string_feature_value:
+ * arv_device_execute_command_async:
  * @device: a #ArvDevice
  * @feature: feature name
- * @value: new feature value
- * @error: a #GError placeholder
- *
- * Set the string feature value.
- *
- * Since: 0.8.0
+ * @cancellable: (nullable): a #GCancellable
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the command is executed
+ * @user_data: (closure): the data to pass to @callback
+ *
+ * Asynchronous version of arv_device_execute_command(). The asynchronous feature accesses of a device are queued,
+ * and executed from a worker thread. The commands and the writes are executed in order. The consecutive reads are
+ * executed concurrently, the linked 4 byte registers being read in a single batch, and the other device accesses
+ * keeping up to the GigE Vision command window in flight, see arv_gv_device_set_command_window(). As for the
+ * synchronous accesses, the Genicam tree serializes the writes with the accesses of the other threads, which may
+ * hence be mixed with the asynchronous ones.
+ *
+ * Since: 0.8.11
  */
 
 void
-arv_device_set_string_feature_value (ArvDevice *device, const char *feature, const char *value, GError **error)
+arv_device_execute_command_async (ArvDevice *device, const char *feature, GCancellable *cancellable,
+				  GAsyncReadyCallback callback, gpointer user_data)
 {
-	ArvGcNode *node;
+	arv_device_feature_request_async (device, device, arv_device_execute_command_async,
+					  ARV_DEVICE_FEATURE_REQUEST_EXECUTE_COMMAND, feature, NULL,
+					  cancellable, callback, user_data);
+}
 
-	node = _get_feature (device, ARV_TYPE_GC_STRING, feature, error);
-	if (node != NULL)
-		arv_gc_string_set_value (ARV_GC_STRING (node), value, error);
+/**
+ * arv_device_execute_command_finish:
+ * @device: a #ArvDevice
+ * @result: a #GAsyncResult
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Finishes an operation started with arv_device_execute_command_async().
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 0.8.11
+ */
+
+gboolean
+arv_device_execute_command_finish (ArvDevice *device, GAsyncResult *result, GError **error)
+{
+	return arv_device_feature_request_finish (result, device, arv_device_execute_command_async, NULL, error);
 }
 
 /**
- * arv_device_get_string_feature_value:
+ * arv_device_set_boolean_feature_value_async:
  * @device: a #ArvDevice
  * @feature: feature name
- * @error: a #GError placeholder
+ * @value: feature value
+ * @cancellable: (nullable): a #GCancellable
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the value is set
+ * @user_data: (closure): the data to pass to @callback
  *
- * Returns: the string feature value, %NULL on error.
+ * Asynchronous version of arv_device_set_boolean_feature_value(). See arv_device_execute_command_async().
  *
- * Since: 0.8.0
+ * Since: 0.8.11
  */
 
-const char *
-arv_device_get_string_feature_value (ArvDevice *device, const char *feature, GError  **error)
+void
+arv_device_set_boolean_feature_value_async (ArvDevice *device, const char *feature, gboolean value,
+					    GCancellable *cancellable, GAsyncReadyCallback callback,
+					    gpointer user_data)
 {
-	ArvGcNode *node;
+	ArvDeviceFeatureValue request_value = {0};
 
-	node = _get_feature (device, ARV_TYPE_GC_STRING, feature, error);
-	if (node != NULL)
-		return arv_gc_string_get_value (ARV_GC_STRING (node), error);
+	request_value.v_int64 = value;
 
-	return NULL;
+	arv_device_feature_request_async (device, device, arv_device_set_boolean_feature_value_async,
+					  ARV_DEVICE_FEATURE_REQUEST_SET_BOOLEAN, feature, &request_value,
+					  cancellable, callback, user_data);
 }
 
 /**
- * arv_device_set_integer_feature_value:
+ * arv_device_set_boolean_feature_value_finish:
+ * @device: a #ArvDevice
+ * @result: a #GAsyncResult
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Finishes an operation started with arv_device_set_boolean_feature_value_async().
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 0.8.11
+ */
+
+gboolean
+arv_device_set_boolean_feature_value_finish (ArvDevice *device, GAsyncResult *result, GError **error)
+{
+	return arv_device_feature_request_finish (result, device, arv_device_set_boolean_feature_value_async,
+						  NULL, error);
+}
+
+/**
+ * arv_device_get_boolean_feature_value_async:
  * @device: a #ArvDevice
  * @feature: feature name
- * @value: new feature value
- * @error: a #GError placeholder
+ * @cancellable: (nullable): a #GCancellable
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the value is read
+ * @user_data: (closure): the data to pass to @callback
  *
- * Set the integer feature value.
+ * Asynchronous version of arv_device_get_boolean_feature_value(). See arv_device_execute_command_async().
  *
- * Since: 0.8.0
+ * Since: 0.8.11
  */
 
 void
-arv_device_set_integer_feature_value (ArvDevice *device, const char *feature, gint64 value, GError **error)
+arv_device_get_boolean_feature_value_async (ArvDevice *device, const char *feature,
+					    GCancellable *cancellable, GAsyncReadyCallback callback,
+					    gpointer user_data)
 {
-	ArvGcNode *node;
-
-	node = _get_feature (device, ARV_TYPE_GC_INTEGER, feature, error);
-	if (node != NULL)
-		arv_gc_integer_set_value (ARV_GC_INTEGER (node), value, error);
+	arv_device_feature_request_async (device, device, arv_device_get_boolean_feature_value_async,
+					  ARV_DEVICE_FEATURE_REQUEST_GET_BOOLEAN, feature, NULL,
+					  cancellable, callback, user_data);
 }
 
 /**
- * arv_device_get_integer_feature_value:
+ * arv_device_get_boolean_feature_value_finish:
  * @device: a #ArvDevice
- * @feature: feature name
- * @error: a #GError placeholder
+ * @result: a #GAsyncResult
+ * @error: a #GError placeholder, %NULL to ignore
  *
- * Returns: the integer feature value, 0 on error.
+ * Finishes an operation started with arv_device_get_boolean_feature_value_async().
  *
- * Since: 0.8.0
+ * Returns: the feature value, %FALSE on error.
+ *
+ * Since: 0.8.11
  */
 
-gint64
-arv_device_get_integer_feature_value (ArvDevice *device, const char *feature, GError **error)
+gboolean
+arv_device_get_boolean_feature_value_finish (ArvDevice *device, GAsyncResult *result, GError **error)
 {
-	ArvGcNode *node;
+	ArvDeviceFeatureValue value = {0};
 
-	node = _get_feature (device, ARV_TYPE_GC_INTEGER, feature, error);
-	if (node != NULL)
-		return arv_gc_integer_get_value (ARV_GC_INTEGER (node), error);
+	if (!arv_device_feature_request_finish (result, device, arv_device_get_boolean_feature_value_async,
+						&value, error))
+		return FALSE;
 
-	return 0;
+	return value.v_int64 != 0;
 }
 
 /**
- * arv_device_get_integer_feature_bounds:
+ * arv_device_set_string_feature_value_async:
  * @device: a #ArvDevice
  * @feature: feature name
- * @min: (out): minimum feature value
- * @max: (out): maximum feature value
- * @error: a #GError placeholder
+ * @value: feature value
+ * @cancellable: (nullable): a #GCancellable
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the value is set
+ * @user_data: (closure): the data to pass to @callback
  *
- * Retrieves feature bounds.
+ * Asynchronous version of arv_device_set_string_feature_value(). See arv_device_execute_command_async().
  *
- * Since: 0.8.0
+ * Since: 0.8.11
  */
 
 void
-arv_device_get_integer_feature_bounds (ArvDevice *device, const char *feature, gint64 *min, gint64 *max, GError **error)
+arv_device_set_string_feature_value_async (ArvDevice *device, const char *feature, const char *value,
+					   GCancellable *cancellable, GAsyncReadyCallback callback,
+					   gpointer user_data)
 {
-	ArvGcNode *node;
+	ArvDeviceFeatureValue request_value = {0};
 
-	if (min != NULL)
-		*min = G_MININT64;
-	if (max != NULL)
-		*max = G_MAXINT64;
+	request_value.v_string = (char *) value;
 
-	node = _get_feature (device, ARV_TYPE_GC_INTEGER, feature, error);
-	if (node != NULL) {
-		GError *local_error = NULL;
+	arv_device_feature_request_async (device, device, arv_device_set_string_feature_value_async,
+					  ARV_DEVICE_FEATURE_REQUEST_SET_STRING, feature, &request_value,
+					  cancellable, callback, user_data);
+}
 
-		if (min != NULL) {
-			gint64 minimum;
+/**
+ * arv_device_set_string_feature_value_finish:
+ * @device: a #ArvDevice
+ * @result: a #GAsyncResult
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Finishes an operation started with arv_device_set_string_feature_value_async().
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 0.8.11
+ */
 
-			minimum = arv_gc_integer_get_min (ARV_GC_INTEGER (node), &local_error);
+gboolean
+arv_device_set_string_feature_value_finish (ArvDevice *device, GAsyncResult *result, GError **error)
+{
+	return arv_device_feature_request_finish (result, device, arv_device_set_string_feature_value_async,
+						  NULL, error);
+}
 
-			if (local_error != NULL) {
-				g_propagate_error (error, local_error);
-				return;
-			}
+/**
+ * arv_device_get_string_feature_value_async:
+ * @device: a #ArvDevice
+ * @feature: feature name
+ * @cancellable: (nullable): a #GCancellable
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the value is read
+ * @user_data: (closure): the data to pass to @callback
+ *
+ * Asynchronous version of arv_device_get_string_feature_value(). See arv_device_execute_command_async().
+ *
+ * Since: 0.8.11
+ */
 
-			*min = minimum;
-		}
+void
+arv_device_get_string_feature_value_async (ArvDevice *device, const char *feature,
+					   GCancellable *cancellable, GAsyncReadyCallback callback,
+					   gpointer user_data)
+{
+	arv_device_feature_request_async (device, device, arv_device_get_string_feature_value_async,
+					  ARV_DEVICE_FEATURE_REQUEST_GET_STRING, feature, NULL,
+					  cancellable, callback, user_data);
+}
 
-		if (max != NULL) {
-			gint64 maximum;
+/**
+ * arv_device_get_string_feature_value_finish:
+ * @device: a #ArvDevice
+ * @result: a #GAsyncResult
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Finishes an operation started with arv_device_get_string_feature_value_async().
+ *
+ * Returns: (transfer full): a copy of the feature value, %NULL on error.
+ *
+ * Since: 0.8.11
+ */
 
-			maximum = arv_gc_integer_get_max (ARV_GC_INTEGER (node), &local_error);
+char *
+arv_device_get_string_feature_value_finish (ArvDevice *device, GAsyncResult *result, GError **error)
+{
+	ArvDeviceFeatureValue value = {0};
 
-			if (local_error != NULL) {
-				g_propagate_error (error, local_error);
-				return;
-			}
+	if (!arv_device_feature_request_finish (result, device, arv_device_get_string_feature_value_async,
+						&value, error))
+		return NULL;
 
-			*max = maximum;
-		}
-	}
+	return value.v_string;
 }
 
 /**
- * arv_device_get_integer_feature_increment:
+ * arv_device_set_integer_feature_value_async:
  * @device: a #ArvDevice
  * @feature: feature name
- * @error: a #GError placeholder
- *
- * Not all integer features have evenly distributed allowed values, which means the returned increment may not reflect the allowed value
- * set.
+ * @value: feature value
+ * @cancellable: (nullable): a #GCancellable
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the value is set
+ * @user_data: (closure): the data to pass to @callback
  *
- * Returns: feature value increment, or 1 on error.
+ * Asynchronous version of arv_device_set_integer_feature_value(). See arv_device_execute_command_async().
  *
- * Since: 0.8.0
+ * Since: 0.8.11
  */
 
-gint64
-arv_device_get_integer_feature_increment (ArvDevice *device, const char *feature, GError **error)
+void
+arv_device_set_integer_feature_value_async (ArvDevice *device, const char *feature, gint64 value,
+					    GCancellable *cancellable, GAsyncReadyCallback callback,
+					    gpointer user_data)
 {
-	ArvGcNode *node;
-
-	node = _get_feature (device, ARV_TYPE_GC_INTEGER, feature, error);
-	if (node != NULL) {
-		GError *local_error = NULL;
-		gint64 increment;
+	ArvDeviceFeatureValue request_value = {0};
 
-		increment = arv_gc_integer_get_inc (ARV_GC_INTEGER (node), &local_error);
+	request_value.v_int64 = value;
 
-			if (local_error != NULL) {
-				g_propagate_error (error, local_error);
-				return 1;
-			}
+	arv_device_feature_request_async (device, device, arv_device_set_integer_feature_value_async,
+					  ARV_DEVICE_FEATURE_REQUEST_SET_INTEGER, feature, &request_value,
+					  cancellable, callback, user_data);
+}
 
-			return increment;
-	}
+/**
+ * arv_device_set_integer_feature_value_finish:
+ * @device: a #ArvDevice
+ * @result: a #GAsyncResult
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Finishes an operation started with arv_device_set_integer_feature_value_async().
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 0.8.11
+ */
 
-	return 1;
+gboolean
+arv_device_set_integer_feature_value_finish (ArvDevice *device, GAsyncResult *result, GError **error)
+{
+	return arv_device_feature_request_finish (result, device, arv_device_set_integer_feature_value_async,
+						  NULL, error);
 }
 
 /**
- * arv_device_set_float_feature_value:
+ * arv_device_get_integer_feature_value_async:
  * @device: a #ArvDevice
  * @feature: feature name
- * @value: new feature value
- * @error: a #GError placeholder
+ * @cancellable: (nullable): a #GCancellable
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the value is read
+ * @user_data: (closure): the data to pass to @callback
  *
- * Set the float feature value.
+ * Asynchronous version of arv_device_get_integer_feature_value(). See arv_device_execute_command_async(). The
+ * reads queued together are served by batched register reads, as with arv_device_get_integer_feature_values().
  *
- * Since: 0.8.0
+ * Since: 0.8.11
  */
 
 void
-arv_device_set_float_feature_value (ArvDevice *device, const char *feature, double value, GError **error)
+arv_device_get_integer_feature_value_async (ArvDevice *device, const char *feature,
+					    GCancellable *cancellable, GAsyncReadyCallback callback,
+					    gpointer user_data)
 {
-	ArvGcNode *node;
+	arv_device_feature_request_async (device, device, arv_device_get_integer_feature_value_async,
+					  ARV_DEVICE_FEATURE_REQUEST_GET_INTEGER, feature, NULL,
+					  cancellable, callback, user_data);
+}
 
-	node = _get_feature (device, ARV_TYPE_GC_FLOAT, feature, error);
-	if (node != NULL)
-		arv_gc_float_set_value (ARV_GC_FLOAT (node), value, error);
+/**
+ * arv_device_get_integer_feature_value_finish:
+ * @device: a #ArvDevice
+ * @result: a #GAsyncResult
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Finishes an operation started with arv_device_get_integer_feature_value_async().
+ *
+ * Returns: the feature value, 0 on error.
+ *
+ * Since: 0.8.11
+ */
+
+gint64
+arv_device_get_integer_feature_value_finish (ArvDevice *device, GAsyncResult *result, GError **error)
+{
+	ArvDeviceFeatureValue value = {0};
+
+	if (!arv_device_feature_request_finish (result, device, arv_device_get_integer_feature_value_async,
+						&value, error))
+		return 0;
+
+	return value.v_int64;
 }
 
 /**
- * arv_device_get_float_feature_value:
+ * arv_device_set_float_feature_value_async:
  * @device: a #ArvDevice
  * @feature: feature name
- * @error: a #GError placeholder
+ * @value: feature value
+ * @cancellable: (nullable): a #GCancellable
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the value is set
+ * @user_data: (closure): the data to pass to @callback
  *
- * Returns: the float feature value, 0.0 on error.
+ * Asynchronous version of arv_device_set_float_feature_value(). See arv_device_execute_command_async().
  *
- * Since: 0.8.0
+ * Since: 0.8.11
  */
 
-double
-arv_device_get_float_feature_value (ArvDevice *device, const char *feature, GError **error)
+void
+arv_device_set_float_feature_value_async (ArvDevice *device, const char *feature, double value,
+					  GCancellable *cancellable, GAsyncReadyCallback callback,
+					  gpointer user_data)
 {
-	ArvGcNode *node;
+	ArvDeviceFeatureValue request_value = {0};
 
-	node = _get_feature (device, ARV_TYPE_GC_FLOAT, feature, error);
-	if (node != NULL)
-		return  arv_gc_float_get_value (ARV_GC_FLOAT (node), error);
+	request_value.v_double = value;
+
+	arv_device_feature_request_async (device, device, arv_device_set_float_feature_value_async,
+					  ARV_DEVICE_FEATURE_REQUEST_SET_FLOAT, feature, &request_value,
+					  cancellable, callback, user_data);
+}
+
+/**
+ * arv_device_set_float_feature_value_finish:
+ * @device: a #ArvDevice
+ * @result: a #GAsyncResult
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Finishes an operation started with arv_device_set_float_feature_value_async().
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 0.8.11
+ */
 
-	return 0.0;
+gboolean
+arv_device_set_float_feature_value_finish (ArvDevice *device, GAsyncResult *result, GError **error)
+{
+	return arv_device_feature_request_finish (result, device, arv_device_set_float_feature_value_async,
+						  NULL, error);
 }
 
 /**
- * arv_device_get_float_feature_bounds:
+ * arv_device_get_float_feature_value_async:
  * @device: a #ArvDevice
  * @feature: feature name
- * @min: (out): minimum feature value
- * @max: (out): maximum feature value
- * @error: a #GError placeholder
+ * @cancellable: (nullable): a #GCancellable
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the value is read
+ * @user_data: (closure): the data to pass to @callback
  *
- * Retrieves feature bounds.
+ * Asynchronous version of arv_device_get_float_feature_value(). See arv_device_execute_command_async().
  *
- * Since: 0.8.0
+ * Since: 0.8.11
  */
 
 void
-arv_device_get_float_feature_bounds (ArvDevice *device, const char *feature, double *min, double *max, GError **error)
+arv_device_get_float_feature_value_async (ArvDevice *device, const char *feature,
+					  GCancellable *cancellable, GAsyncReadyCallback callback,
+					  gpointer user_data)
 {
-	ArvGcNode *node;
-
-	if (min != NULL)
-		*min = -G_MAXDOUBLE;
-	if (max != NULL)
-		*max = G_MAXDOUBLE;
-
-	node = _get_feature (device, ARV_TYPE_GC_FLOAT, feature, error);
-	if (node != NULL) {
-		GError *local_error = NULL;
-
-		if (min != NULL) {
-			double minimum;
-
-			minimum = arv_gc_float_get_min (ARV_GC_FLOAT (node), &local_error);
-
-			if (local_error != NULL) {
-				g_propagate_error (error, local_error);
-				return;
-			}
-
-			*min = minimum;
-		}
-
-		if (max != NULL) {
-			double maximum;
-
-			maximum = arv_gc_float_get_max (ARV_GC_FLOAT (node), &local_error);
-
-			if (local_error != NULL) {
-				g_propagate_error (error, local_error);
-				return;
-			}
-
-			*max = maximum;
-		}
-	}
+	arv_device_feature_request_async (device, device, arv_device_get_float_feature_value_async,
+					  ARV_DEVICE_FEATURE_REQUEST_GET_FLOAT, feature, NULL,
+					  cancellable, callback, user_data);
 }
 
 /**
- * arv_device_dup_available_enumeration_feature_values:
- * @device: an #ArvDevice
- * @feature: feature name
- * @n_values: placeholder for the number of returned values
- * @error: a #GError placeholder
+ * arv_device_get_float_feature_value_finish:
+ * @device: a #ArvDevice
+ * @result: a #GAsyncResult
+ * @error: a #GError placeholder, %NULL to ignore
  *
- * Get all the available values of @feature, as integers.
+ * Finishes an operation started with arv_device_get_float_feature_value_async().
  *
- * Returns: (array length=n_values) (transfer container): a newly created array of 64 bit integers, which must freed after use using g_free,
- * or NULL on error.
+ * Returns: the feature value, 0.0 on error.
  *
- * Since: 0.8.0
+ * Since: 0.8.11
  */
 
-gint64 *
-arv_device_dup_available_enumeration_feature_values (ArvDevice *device, const char *feature, guint *n_values, GError **error)
+double
+arv_device_get_float_feature_value_finish (ArvDevice *device, GAsyncResult *result, GError **error)
 {
-	ArvGcNode *node;
-
-	if (n_values != NULL)
-		*n_values = 0;
+	ArvDeviceFeatureValue value = {0};
 
-	node = _get_feature (device, ARV_TYPE_GC_ENUMERATION, feature, error);
-	if (node != NULL)
-		return arv_gc_enumeration_dup_available_int_values (ARV_GC_ENUMERATION (node), n_values, error);
+	if (!arv_device_feature_request_finish (result, device, arv_device_get_float_feature_value_async,
+						&value, error))
+		return 0.0;
 
-	return NULL;
+	return value.v_double;
 }
 
 /**
- * arv_device_dup_available_enumeration_feature_values_as_strings:
- * @device: an #ArvDevice
+ * arv_device_add_polled_feature:
+ * @device: a #ArvDevice
  * @feature: feature name
- * @n_values: placeholder for the number of returned values
- * @error: a #GError placeholder
+ * @interval_ms: polling interval in ms, or 0 to use the PollingTime of the feature register
+ * @error: a #GError placeholder, %NULL to ignore
  *
- * Get all the available values of @feature, as strings.
+ * Adds @feature to the list of features periodically read by the device worker thread. The polled features which
+ * are due at the same time are read using batched register reads. Each new value is stored, for retrieval with
+ * arv_device_get_polled_feature_value(), and announced by the #ArvDevice::feature-polled signal. The polls are
+ * skipped while the device reports a stream packet resend pressure, in order to leave the link bandwidth to the
+ * stream.
  *
- * Returns: (array length=n_values) (transfer container): a newly created array of const strings, which must freed after use using g_free,
- * or NULL on error.
+ * Features already polled are rescheduled with the new interval. Only boolean, enumeration, integer, float and
+ * string features can be polled. As for the asynchronous accessors, the features must not be accessed
+ * synchronously from other threads while they are polled.
  *
- * Since: 0.8.0
+ * Returns: %TRUE on success.
+ *
+ * Since: 0.8.11
  */
 
-const char **
-arv_device_dup_available_enumeration_feature_values_as_strings (ArvDevice *device, const char *feature, guint *n_values, GError **error)
+gboolean
+arv_device_add_polled_feature (ArvDevice *device, const char *feature, guint interval_ms, GError **error)
 {
+	ArvDeviceFeatureWorker *worker;
+	ArvDevicePolledFeature *polled_feature;
 	ArvGcNode *node;
 
-	if (n_values != NULL)
-		*n_values = 0;
+	g_return_val_if_fail (ARV_IS_DEVICE (device), FALSE);
+	g_return_val_if_fail (feature != NULL, FALSE);
 
-	node = _get_feature (device, ARV_TYPE_GC_ENUMERATION, feature, error);
-	if (node != NULL)
-		return arv_gc_enumeration_dup_available_string_values (ARV_GC_ENUMERATION (node), n_values, error);
+	node = arv_device_get_feature (device, feature);
+	if (node == NULL) {
+		g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_FEATURE_NOT_FOUND,
+			     "node '%s' not found", feature);
+		return FALSE;
+	}
 
-	return NULL;
+	if (!_is_pollable (node)) {
+		g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_WRONG_FEATURE,
+			     "node '%s' [%s] can't be polled", feature, G_OBJECT_TYPE_NAME (node));
+		return FALSE;
+	}
+
+	if (interval_ms == 0) {
+		ArvGcRegisterNode *register_node;
+
+		register_node = arv_gc_get_feature_register (arv_device_get_genicam (device), feature);
+		if (register_node != NULL)
+			interval_ms = (guint) MIN (arv_gc_register_node_get_polling_time (register_node), G_MAXUINT);
+
+		if (interval_ms == 0) {
+			g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_INVALID_PARAMETER,
+				     "no polling time defined for node '%s'", feature);
+			return FALSE;
+		}
+	}
+
+	worker = _get_feature_worker (device);
+
+	g_mutex_lock (&worker->mutex);
+
+	polled_feature = g_hash_table_lookup (worker->polled_features, feature);
+	if (polled_feature == NULL) {
+		polled_feature = g_new0 (ArvDevicePolledFeature, 1);
+		polled_feature->name = g_strdup (feature);
+		g_hash_table_replace (worker->polled_features, polled_feature->name, polled_feature);
+	}
+	polled_feature->interval_us = (gint64) interval_ms * 1000;
+	polled_feature->next_time_us = g_get_monotonic_time ();
+
+	g_mutex_unlock (&worker->mutex);
+
+	g_async_queue_push (worker->queue, &arv_device_feature_thread_wakeup);
+
+	return TRUE;
 }
 
 /**
- * arv_device_dup_available_enumeration_feature_values_as_display_names:
- * @device: an #ArvDevice
+ * arv_device_remove_polled_feature:
+ * @device: a #ArvDevice
  * @feature: feature name
- * @n_values: placeholder for the number of returned values
- * @error: a #GError placeholder
- *
- * Get display names of all the available entries of @feature.
  *
- * Returns: (array length=n_values) (transfer container): a newly created array of const strings, to be freed after use using g_free, or
- * %NULL on error.
+ * Stops the polling of @feature, started with arv_device_add_polled_feature().
  *
- * Since: 0.8.0
+ * Since: 0.8.11
  */
 
-const char **
-arv_device_dup_available_enumeration_feature_values_as_display_names (ArvDevice *device, const char *feature, guint *n_values, GError **error)
+void
+arv_device_remove_polled_feature (ArvDevice *device, const char *feature)
 {
-	ArvGcNode *node;
+	ArvDevicePrivate *priv = arv_device_get_instance_private (device);
+	ArvDeviceFeatureWorker *worker;
 
-	if (n_values != NULL)
-		*n_values = 0;
+	g_return_if_fail (ARV_IS_DEVICE (device));
+	g_return_if_fail (feature != NULL);
 
-	node = _get_feature (device, ARV_TYPE_GC_ENUMERATION, feature, error);
-	if (node != NULL)
-		return arv_gc_enumeration_dup_available_display_names (ARV_GC_ENUMERATION (node), n_values, error);
+	g_mutex_lock (&priv->feature_mutex);
+	worker = priv->feature_worker;
+	g_mutex_unlock (&priv->feature_mutex);
 
-	return NULL;
+	if (worker == NULL)
+		return;
+
+	g_mutex_lock (&worker->mutex);
+	g_hash_table_remove (worker->polled_features, feature);
+	g_mutex_unlock (&worker->mutex);
 }
 
 /**
- * arv_device_set_features_from_string:
+ * arv_device_get_polled_feature_value:
  * @device: a #ArvDevice
- * @string: a space separated list of features assignments
- * @error: a #GError placeholder, %NULL to ignore
+ * @feature: feature name
+ * @value: (out caller-allocates): an uninitialized #GValue
+ * @timestamp_us: (out) (optional): monotonic time of the read, in µs
  *
- * Set features from a string containing a list of space separated feature assignments or command names. For example:
+ * Retrieves the last value of a feature polled by the device worker thread. @value is initialized with the type
+ * of the feature value, %G_TYPE_BOOLEAN, %G_TYPE_INT64, %G_TYPE_DOUBLE, or %G_TYPE_STRING for the enumeration and
+ * string features, and must be released using g_value_unset(). This function doesn't access the device.
  *
- * |[<!-- language="C" -->
- * arv_device_set_features_from_string (device, "Width=256 Height=256 PixelFormat='Mono8' TriggerStart", &error);
- * ]|
+ * Returns: %TRUE if a value was read since the feature was added to the polled features.
  *
- * Since: 0.8.0
+ * Since: 0.8.11
  */
 
 gboolean
-arv_device_set_features_from_string (ArvDevice *device, const char *string, GError **error)
+arv_device_get_polled_feature_value (ArvDevice *device, const char *feature, GValue *value, gint64 *timestamp_us)
 {
-	GMatchInfo *match_info = NULL;
-	GError *local_error = NULL;
-	GRegex *regex;
+	ArvDevicePrivate *priv = arv_device_get_instance_private (device);
+	ArvDeviceFeatureWorker *worker;
+	ArvDevicePolledFeature *polled_feature;
+	gboolean found = FALSE;
 
 	g_return_val_if_fail (ARV_IS_DEVICE (device), FALSE);
+	g_return_val_if_fail (feature != NULL, FALSE);
+	g_return_val_if_fail (value != NULL, FALSE);
 
-	if (string == NULL)
-		return TRUE;
-
-	regex = g_regex_new ("((?<Key>[^\\s\"'\\=]+)|\"(?<Key>[^\"]*)\"|'(?<Key>[^']*)')"
-			     "(?:\\=((?<Value>[^\\s\"']+)|\"(?<Value>[^\"]*)\"|'(?<Value>[^']*)'))?",
-			     G_REGEX_DUPNAMES, 0, NULL);
-
-	if (g_regex_match (regex, string, 0, &match_info)) {
-		while (g_match_info_matches (match_info) && local_error == NULL) {
-			ArvGcNode *feature;
-			char *key = g_match_info_fetch_named (match_info, "Key");
-			char *value = g_match_info_fetch_named (match_info, "Value");
+	g_mutex_lock (&priv->feature_mutex);
+	worker = priv->feature_worker;
+	g_mutex_unlock (&priv->feature_mutex);
 
-			feature = arv_device_get_feature (device, key);
-			if (ARV_IS_GC_FEATURE_NODE (feature)) {
-				if (value != NULL)
-					arv_gc_feature_node_set_value_from_string (ARV_GC_FEATURE_NODE (feature), value, &local_error);
-				else
-					arv_device_execute_command (device, key, &local_error);
-			} else
-				g_set_error (&local_error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_FEATURE_NOT_FOUND,
-					     "node '%s' not found", key);
+	if (worker == NULL)
+		return FALSE;
 
-			g_free (key);
-			g_free (value);
+	g_mutex_lock (&worker->mutex);
 
-			g_match_info_next (match_info, NULL);
-		}
-		g_match_info_unref (match_info);
+	polled_feature = g_hash_table_lookup (worker->polled_features, feature);
+	if (polled_feature != NULL && G_IS_VALUE (&polled_feature->value)) {
+		g_value_init (value, G_VALUE_TYPE (&polled_feature->value));
+		g_value_copy (&polled_feature->value, value);
+		if (timestamp_us != NULL)
+			*timestamp_us = polled_feature->timestamp_us;
+		found = TRUE;
 	}
 
-	g_regex_unref (regex);
-
-	if (local_error != NULL) {
-		g_propagate_error (error, local_error);
-		return FALSE;
-	}
+	g_mutex_unlock (&worker->mutex);
 
-	return TRUE;
+	return found;
 }
 
 /**
@@ -917,9 +3012,142 @@ void arv_device_take_init_error (ArvDevice *device, GError *error)
 	priv->init_error = error;
 }
 
+/* Called by the auxiliary threads, when they start and in their loop. @generation is the placement version last applied
+ * by the calling thread, initially 0. */
+
+void
+arv_device_update_auxiliary_thread_placement (ArvDevice *device, gint *generation)
+{
+	ArvDevicePrivate *priv = arv_device_get_instance_private (device);
+	char *cpus;
+	int nice_level;
+	gint current;
+
+	current = g_atomic_int_get (&priv->auxiliary_generation);
+	if (G_LIKELY (current == *generation))
+		return;
+
+	*generation = current;
+
+	g_mutex_lock (&priv->auxiliary_mutex);
+	cpus = g_strdup (priv->auxiliary_cpus);
+	nice_level = priv->auxiliary_nice_level;
+	g_mutex_unlock (&priv->auxiliary_mutex);
+
+	if (!arv_make_thread_auxiliary (cpus, nice_level))
+		arv_warning_device ("[Device::update_auxiliary_thread_placement] Failed to place auxiliary thread"
+				    " (cpus '%s', nice level %d)", cpus != NULL ? cpus : "", nice_level);
+
+	g_free (cpus);
+}
+
+static void
+_auxiliary_placement_changed (ArvDevice *device)
+{
+	ArvDevicePrivate *priv = arv_device_get_instance_private (device);
+
+	g_atomic_int_inc (&priv->auxiliary_generation);
+
+	/* The feature thread may wait indefinitely for a task */
+	g_mutex_lock (&priv->feature_mutex);
+	if (priv->feature_worker != NULL)
+		g_async_queue_push (priv->feature_worker->queue, &arv_device_feature_thread_wakeup);
+	g_mutex_unlock (&priv->feature_mutex);
+}
+
+static void
+arv_device_set_property (GObject *object, guint prop_id, const GValue *value, GParamSpec *pspec)
+{
+	ArvDevice *device = ARV_DEVICE (object);
+	ArvDevicePrivate *priv = arv_device_get_instance_private (device);
+
+	switch (prop_id) {
+		case ARV_DEVICE_PROPERTY_AUXILIARY_CPUS:
+			g_mutex_lock (&priv->auxiliary_mutex);
+			g_free (priv->auxiliary_cpus);
+			priv->auxiliary_cpus = g_value_dup_string (value);
+			g_mutex_unlock (&priv->auxiliary_mutex);
+			_auxiliary_placement_changed (device);
+			break;
+		case ARV_DEVICE_PROPERTY_AUXILIARY_NICE_LEVEL:
+			g_mutex_lock (&priv->auxiliary_mutex);
+			priv->auxiliary_nice_level = g_value_get_int (value);
+			g_mutex_unlock (&priv->auxiliary_mutex);
+			_auxiliary_placement_changed (device);
+			break;
+		default:
+			G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+			break;
+	}
+}
+
+static void
+arv_device_get_property (GObject *object, guint prop_id, GValue *value, GParamSpec *pspec)
+{
+	ArvDevicePrivate *priv = arv_device_get_instance_private (ARV_DEVICE (object));
+
+	switch (prop_id) {
+		case ARV_DEVICE_PROPERTY_AUXILIARY_CPUS:
+			g_mutex_lock (&priv->auxiliary_mutex);
+			g_value_set_string (value, priv->auxiliary_cpus);
+			g_mutex_unlock (&priv->auxiliary_mutex);
+			break;
+		case ARV_DEVICE_PROPERTY_AUXILIARY_NICE_LEVEL:
+			g_mutex_lock (&priv->auxiliary_mutex);
+			g_value_set_int (value, priv->auxiliary_nice_level);
+			g_mutex_unlock (&priv->auxiliary_mutex);
+			break;
+		default:
+			G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+			break;
+	}
+}
+
 static void
 arv_device_init (ArvDevice *device)
 {
+	ArvDevicePrivate *priv = arv_device_get_instance_private (device);
+
+	g_mutex_init (&priv->feature_mutex);
+	g_mutex_init (&priv->auxiliary_mutex);
+	g_mutex_init (&priv->stream_mutex);
+
+	g_mutex_init (&priv->journal_mutex);
+	g_queue_init (&priv->journal);
+	priv->journal_index = g_hash_table_new (_journal_entry_hash, _journal_entry_equal);
+	priv->journal_selectors = g_hash_table_new_full (g_int64_hash, g_int64_equal,
+							 g_free, (GDestroyNotify) g_bytes_unref);
+	priv->journal_contexts = g_hash_table_new_full (g_bytes_hash, g_bytes_equal,
+							(GDestroyNotify) g_bytes_unref, NULL);
+}
+
+/* The worker thread is stopped before the subclasses release their resources in their finalize method */
+
+static void
+arv_device_dispose (GObject *object)
+{
+	ArvDevicePrivate *priv = arv_device_get_instance_private (ARV_DEVICE (object));
+
+	if (priv->feature_worker != NULL) {
+		g_mutex_lock (&priv->feature_worker->mutex);
+		priv->feature_worker->device = NULL;
+		g_hash_table_remove_all (priv->feature_worker->polled_features);
+		g_mutex_unlock (&priv->feature_worker->mutex);
+
+		/* The pending tasks hold a reference to the device, there is no more request in the queue */
+		g_async_queue_push (priv->feature_worker->queue, &arv_device_feature_thread_stop);
+
+		/* The last reference may be released by the worker thread itself */
+		if (g_thread_self () == priv->feature_thread)
+			g_thread_unref (priv->feature_thread);
+		else
+			g_thread_join (priv->feature_thread);
+		priv->feature_thread = NULL;
+
+		g_clear_pointer (&priv->feature_worker, arv_device_feature_worker_unref);
+	}
+
+	G_OBJECT_CLASS (arv_device_parent_class)->dispose (object);
 }
 
 static void
@@ -927,8 +3155,22 @@ arv_device_finalize (GObject *object)
 {
 	ArvDevicePrivate *priv = arv_device_get_instance_private (ARV_DEVICE (object));
 
+	g_mutex_clear (&priv->feature_mutex);
 	g_clear_error (&priv->init_error);
 
+	g_hash_table_unref (priv->journal_index);
+	g_hash_table_unref (priv->journal_selectors);
+	g_hash_table_unref (priv->journal_contexts);
+	g_queue_foreach (&priv->journal, (GFunc) g_free, NULL);
+	g_queue_clear (&priv->journal);
+	g_mutex_clear (&priv->journal_mutex);
+
+	g_clear_pointer (&priv->auxiliary_cpus, g_free);
+	g_mutex_clear (&priv->auxiliary_mutex);
+
+	g_slist_free (priv->streams);
+	g_mutex_clear (&priv->stream_mutex);
+
 	G_OBJECT_CLASS (arv_device_parent_class)->finalize (object);
 }
 
@@ -937,7 +3179,10 @@ arv_device_class_init (ArvDeviceClass *device_class)
 {
 	GObjectClass *object_class = G_OBJECT_CLASS (device_class);
 
+	object_class->dispose = arv_device_dispose;
 	object_class->finalize = arv_device_finalize;
+	object_class->set_property = arv_device_set_property;
+	object_class->get_property = arv_device_get_property;
 
 	/**
 	 * ArvDevice::control-lost:
@@ -958,6 +3203,67 @@ arv_device_class_init (ArvDeviceClass *device_class)
 			      G_STRUCT_OFFSET (ArvDeviceClass, control_lost),
 			      NULL, NULL,
 			      g_cclosure_marshal_VOID__VOID, G_TYPE_NONE, 0, G_TYPE_NONE);
+
+	/**
+	 * ArvDevice::feature-polled:
+	 * @device: a #ArvDevice
+	 * @feature: the polled feature name
+	 *
+	 * Signal that a new value of a feature registered with arv_device_add_polled_feature() is available. It
+	 * can be retrieved using arv_device_get_polled_feature_value(). The feature name can be used as the
+	 * signal detail, for example "feature-polled::DeviceTemperature".
+	 *
+	 * This signal is emited from the device worker thread, so please take care to shared data access from the
+	 * callback.
+	 *
+	 * Since: 0.8.11
+	 */
+
+	arv_device_signals[ARV_DEVICE_SIGNAL_FEATURE_POLLED] =
+		g_signal_new ("feature-polled",
+			      G_TYPE_FROM_CLASS (device_class),
+			      G_SIGNAL_RUN_LAST | G_SIGNAL_DETAILED,
+			      G_STRUCT_OFFSET (ArvDeviceClass, feature_polled),
+			      NULL, NULL,
+			      g_cclosure_marshal_VOID__STRING, G_TYPE_NONE, 1, G_TYPE_STRING);
+
+	/**
+	 * ArvDevice:auxiliary-cpus:
+	 *
+	 * CPUs the auxiliary threads of the device run on, in the kernel cpulist format, for example "0-1,4". The
+	 * auxiliary threads are the ones outside of the acquisition path: the GigE Vision heartbeat thread, the event
+	 * threads and the feature thread. Keeping them away from the CPUs of the stream threads avoids the preemption
+	 * and the cache pollution of the capture cores. %NULL leaves their affinity unchanged.
+	 *
+	 * Since: 0.8.11
+	 */
+
+	g_object_class_install_property
+		(object_class,
+		 ARV_DEVICE_PROPERTY_AUXILIARY_CPUS,
+		 g_param_spec_string ("auxiliary-cpus",
+				      "Auxiliary CPUs",
+				      "CPU list of the auxiliary threads",
+				      NULL,
+				      G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	/**
+	 * ArvDevice:auxiliary-nice-level:
+	 *
+	 * Nice level of the auxiliary threads of the device, see #ArvDevice:auxiliary-cpus. A positive value lowers
+	 * their priority below the one of the stream threads.
+	 *
+	 * Since: 0.8.11
+	 */
+
+	g_object_class_install_property
+		(object_class,
+		 ARV_DEVICE_PROPERTY_AUXILIARY_NICE_LEVEL,
+		 g_param_spec_int ("auxiliary-nice-level",
+				   "Auxiliary nice level",
+				   "Nice level of the auxiliary threads",
+				   -20, 19, 0,
+				   G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 }
 
 static gboolean
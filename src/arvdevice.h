@@ -30,6 +30,7 @@
 #include <arvtypes.h>
 #include <arvstream.h>
 #include <arvchunkparser.h>
+#include <gio/gio.h>
 
 G_BEGIN_DECLS
 
@@ -86,6 +87,23 @@ struct _ArvDeviceClass {
 
 	/* signals */
 	void		(*control_lost)		(ArvDevice *device);
+
+	gboolean	(*read_registers)	(ArvDevice *device, guint n_registers, const guint64 *addresses,
+						 guint32 *values, GError **error);
+	gboolean	(*write_registers)	(ArvDevice *device, guint n_registers, const guint64 *addresses,
+						 const guint32 *values, guint *n_written, GError **error);
+	void		(*begin_batch)		(ArvDevice *device);
+	gboolean	(*commit_batch)		(ArvDevice *device, guint *n_written, GError **error);
+
+	gboolean	(*has_resend_pressure)	(ArvDevice *device);
+
+	gboolean	(*reconnect)		(ArvDevice *device, guint timeout_ms, GError **error);
+
+	/* signals */
+	void		(*feature_polled)	(ArvDevice *device, const char *feature);
+
+	/*< private >*/
+	gpointer padding[8];
 };
 
 ArvStream *	arv_device_create_stream	(ArvDevice *device, ArvStreamCallback callback, void *user_data, GError **error);
@@ -94,6 +112,18 @@ gboolean	arv_device_read_memory 		(ArvDevice *device, guint64 address, guint32 s
 gboolean	arv_device_write_memory	 	(ArvDevice *device, guint64 address, guint32 size, void *buffer, GError **error);
 gboolean 	arv_device_read_register	(ArvDevice *device, guint64 address, guint32 *value, GError **error);
 gboolean	arv_device_write_register 	(ArvDevice *device, guint64 address, guint32 value, GError **error);
+gboolean	arv_device_read_registers	(ArvDevice *device, guint n_registers, const guint64 *addresses,
+						 guint32 *values, GError **error);
+gboolean	arv_device_write_registers	(ArvDevice *device, guint n_registers, const guint64 *addresses,
+						 const guint32 *values, guint *n_written, GError **error);
+
+void		arv_device_begin_batch		(ArvDevice *device);
+gboolean	arv_device_commit_batch		(ArvDevice *device, guint *n_written, GError **error);
+
+gboolean	arv_device_reconnect		(ArvDevice *device, guint timeout_ms, GError **error);
+
+GBytes *	arv_device_export_configuration	(ArvDevice *device);
+gboolean	arv_device_import_configuration	(ArvDevice *device, GBytes *configuration, GError **error);
 
 const char * 	arv_device_get_genicam_xml 		(ArvDevice *device, size_t *size);
 ArvGc *		arv_device_get_genicam			(ArvDevice *device);
@@ -114,6 +144,18 @@ const char *	arv_device_get_string_feature_value	(ArvDevice *device, const char
 
 void		arv_device_set_integer_feature_value	(ArvDevice *device, const char *feature, gint64 value, GError **error);
 gint64		arv_device_get_integer_feature_value	(ArvDevice *device, const char *feature, GError **error);
+gboolean	arv_device_get_integer_feature_values	(ArvDevice *device, guint n_features, const char **features,
+							 gint64 *values, GError **error);
+gboolean	arv_device_set_integer_feature_values	(ArvDevice *device, guint n_features, const char **features,
+							 const gint64 *values, GError **error);
+gboolean	arv_device_read_feature_for_selectors	(ArvDevice *device, const char *feature, const char *selector,
+							 const gint64 *selector_values, guint n_selector_values,
+							 GValue *values, GError **error);
+gboolean	arv_device_set_integer_feature_for_selectors	(ArvDevice *device, const char *feature,
+								 const char *selector,
+								 const gint64 *selector_values,
+								 guint n_selector_values,
+								 const gint64 *values, GError **error);
 void 		arv_device_get_integer_feature_bounds 	(ArvDevice *device, const char *feature, gint64 *min, gint64 *max, GError **error);
 gint64		arv_device_get_integer_feature_increment(ArvDevice *device, const char *feature, GError **error);
 
@@ -131,6 +173,53 @@ const char **	arv_device_dup_available_enumeration_feature_values_as_display_nam
 
 gboolean 	arv_device_set_features_from_string 	(ArvDevice *device, const char *string, GError **error);
 
+void		arv_device_execute_command_async		(ArvDevice *device, const char *feature,
+								 GCancellable *cancellable, GAsyncReadyCallback callback,
+								 gpointer user_data);
+gboolean	arv_device_execute_command_finish		(ArvDevice *device, GAsyncResult *result, GError **error);
+
+void		arv_device_set_boolean_feature_value_async	(ArvDevice *device, const char *feature, gboolean value,
+								 GCancellable *cancellable, GAsyncReadyCallback callback,
+								 gpointer user_data);
+gboolean	arv_device_set_boolean_feature_value_finish	(ArvDevice *device, GAsyncResult *result, GError **error);
+void		arv_device_get_boolean_feature_value_async	(ArvDevice *device, const char *feature,
+								 GCancellable *cancellable, GAsyncReadyCallback callback,
+								 gpointer user_data);
+gboolean	arv_device_get_boolean_feature_value_finish	(ArvDevice *device, GAsyncResult *result, GError **error);
+
+void		arv_device_set_string_feature_value_async	(ArvDevice *device, const char *feature, const char *value,
+								 GCancellable *cancellable, GAsyncReadyCallback callback,
+								 gpointer user_data);
+gboolean	arv_device_set_string_feature_value_finish	(ArvDevice *device, GAsyncResult *result, GError **error);
+void		arv_device_get_string_feature_value_async	(ArvDevice *device, const char *feature,
+								 GCancellable *cancellable, GAsyncReadyCallback callback,
+								 gpointer user_data);
+char *		arv_device_get_string_feature_value_finish	(ArvDevice *device, GAsyncResult *result, GError **error);
+
+void		arv_device_set_integer_feature_value_async	(ArvDevice *device, const char *feature, gint64 value,
+								 GCancellable *cancellable, GAsyncReadyCallback callback,
+								 gpointer user_data);
+gboolean	arv_device_set_integer_feature_value_finish	(ArvDevice *device, GAsyncResult *result, GError **error);
+void		arv_device_get_integer_feature_value_async	(ArvDevice *device, const char *feature,
+								 GCancellable *cancellable, GAsyncReadyCallback callback,
+								 gpointer user_data);
+gint64		arv_device_get_integer_feature_value_finish	(ArvDevice *device, GAsyncResult *result, GError **error);
+
+void		arv_device_set_float_feature_value_async	(ArvDevice *device, const char *feature, double value,
+								 GCancellable *cancellable, GAsyncReadyCallback callback,
+								 gpointer user_data);
+gboolean	arv_device_set_float_feature_value_finish	(ArvDevice *device, GAsyncResult *result, GError **error);
+void		arv_device_get_float_feature_value_async	(ArvDevice *device, const char *feature,
+								 GCancellable *cancellable, GAsyncReadyCallback callback,
+								 gpointer user_data);
+double		arv_device_get_float_feature_value_finish	(ArvDevice *device, GAsyncResult *result, GError **error);
+
+gboolean	arv_device_add_polled_feature			(ArvDevice *device, const char *feature, guint interval_ms,
+								 GError **error);
+void		arv_device_remove_polled_feature		(ArvDevice *device, const char *feature);
+gboolean	arv_device_get_polled_feature_value		(ArvDevice *device, const char *feature, GValue *value,
+								 gint64 *timestamp_us);
+
 void		arv_device_set_register_cache_policy	(ArvDevice *device, ArvRegisterCachePolicy policy);
 void		arv_device_set_range_check_policy	(ArvDevice *device, ArvRangeCheckPolicy policy);
 
@@ -34,6 +34,57 @@ G_BEGIN_DECLS
 void 		arv_device_emit_control_lost_signal 	(ArvDevice *device);
 void		arv_device_take_init_error		(ArvDevice *device, GError *error);
 
+void		arv_device_update_auxiliary_thread_placement	(ArvDevice *device, gint *generation);
+
+void		arv_device_add_stream			(ArvDevice *device, ArvStream *stream);
+void		arv_device_remove_stream		(ArvDevice *device, ArvStream *stream);
+void		arv_device_prepare_streams		(ArvDevice *device);
+
+/* Register write done through the GenICam tree. @is_register is TRUE for a write through arv_device_write_register(),
+ * @data holding the register value in host order. @is_selector is TRUE for the write of a selector feature, which
+ * changes the meaning of the registers written after it. */
+typedef struct {
+	guint64 address;
+	guint32 size;
+	gboolean is_register;
+	gboolean is_selector;
+	/* Values of the selector registers at the time of the write, as an identifier, 0 before any selector write */
+	guint context;
+	guint8 data[];
+} ArvDeviceJournalEntry;
+
+void		arv_device_journal_write		(ArvDevice *device, guint64 address, guint32 size,
+							 const void *data, gboolean is_register, gboolean is_selector);
+void		arv_device_journal_forget		(ArvDevice *device, guint64 address);
+void		arv_device_journal_replay		(ArvDevice *device);
+
+typedef enum {
+	ARV_DEVICE_FEATURE_REQUEST_EXECUTE_COMMAND,
+	ARV_DEVICE_FEATURE_REQUEST_SET_BOOLEAN,
+	ARV_DEVICE_FEATURE_REQUEST_GET_BOOLEAN,
+	ARV_DEVICE_FEATURE_REQUEST_SET_STRING,
+	ARV_DEVICE_FEATURE_REQUEST_GET_STRING,
+	ARV_DEVICE_FEATURE_REQUEST_SET_INTEGER,
+	ARV_DEVICE_FEATURE_REQUEST_GET_INTEGER,
+	ARV_DEVICE_FEATURE_REQUEST_SET_FLOAT,
+	ARV_DEVICE_FEATURE_REQUEST_GET_FLOAT
+} ArvDeviceFeatureRequestType;
+
+/* Value of a feature request, the boolean values are stored in v_int64 */
+typedef struct {
+	gint64 v_int64;
+	double v_double;
+	char *v_string;
+} ArvDeviceFeatureValue;
+
+void		arv_device_feature_request_async	(ArvDevice *device, gpointer source_object, gpointer source_tag,
+							 ArvDeviceFeatureRequestType type, const char *feature,
+							 const ArvDeviceFeatureValue *value,
+							 GCancellable *cancellable, GAsyncReadyCallback callback,
+							 gpointer user_data);
+gboolean	arv_device_feature_request_finish	(GAsyncResult *result, gpointer source_object, gpointer source_tag,
+							 ArvDeviceFeatureValue *value, GError **error);
+
 G_END_DECLS
 
 #endif
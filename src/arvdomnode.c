@@ -40,10 +40,51 @@ typedef struct {
 	ArvDomNode	*parent_node;
 	ArvDomNode	*first_child;
 	ArvDomNode	*last_child;
+
+	guint		n_children;
+	/* Children in order, built on the first indexed access and kept up to date by the appends */
+	GPtrArray	*child_index;
 } ArvDomNodePrivate;
 
 G_DEFINE_ABSTRACT_TYPE_WITH_PRIVATE (ArvDomNode, arv_dom_node, G_TYPE_OBJECT)
 
+/* Serializes the index builds of concurrent readers */
+static GMutex arv_dom_node_child_index_mutex;
+
+static GPtrArray *
+_get_child_index (ArvDomNode *self)
+{
+	ArvDomNodePrivate *priv = arv_dom_node_get_instance_private (self);
+	GPtrArray *child_index;
+	ArvDomNode *iter;
+
+	child_index = g_atomic_pointer_get (&priv->child_index);
+	if (G_LIKELY (child_index != NULL))
+		return child_index;
+
+	g_mutex_lock (&arv_dom_node_child_index_mutex);
+
+	child_index = priv->child_index;
+	if (child_index == NULL) {
+		child_index = g_ptr_array_sized_new (priv->n_children);
+		for (iter = priv->first_child; iter != NULL; iter = arv_dom_node_get_next_sibling (iter))
+			g_ptr_array_add (child_index, iter);
+		g_atomic_pointer_set (&priv->child_index, child_index);
+	}
+
+	g_mutex_unlock (&arv_dom_node_child_index_mutex);
+
+	return child_index;
+}
+
+/* The index is rebuilt on the next indexed access after an insertion or a removal */
+
+static void
+_drop_child_index (ArvDomNodePrivate *priv)
+{
+	g_clear_pointer (&priv->child_index, g_ptr_array_unref);
+}
+
 /* ArvDomNode implementation */
 
 /**
@@ -191,6 +232,53 @@ arv_dom_node_get_last_child (ArvDomNode* self)
 	return priv->last_child;
 }
 
+/**
+ * arv_dom_node_get_n_children:
+ * @self: a #ArvDomNode
+ *
+ * Returns: the number of children of @self.
+ *
+ * Since: 0.8.11
+ */
+
+guint
+arv_dom_node_get_n_children (ArvDomNode *self)
+{
+	ArvDomNodePrivate *priv = arv_dom_node_get_instance_private (self);
+
+	g_return_val_if_fail (ARV_IS_DOM_NODE (self), 0);
+
+	return priv->n_children;
+}
+
+/**
+ * arv_dom_node_get_nth_child:
+ * @self: a #ArvDomNode
+ * @index: child index
+ *
+ * Gets a child by its index, in constant time, except for the first call after a child insertion or removal.
+ *
+ * Returns: (transfer none): the child at @index, %NULL if out of range.
+ *
+ * Since: 0.8.11
+ */
+
+ArvDomNode *
+arv_dom_node_get_nth_child (ArvDomNode *self, guint index)
+{
+	ArvDomNodePrivate *priv = arv_dom_node_get_instance_private (self);
+	GPtrArray *child_index;
+
+	g_return_val_if_fail (ARV_IS_DOM_NODE (self), NULL);
+
+	if (index >= priv->n_children)
+		return NULL;
+
+	child_index = _get_child_index (self);
+
+	return index < child_index->len ? g_ptr_array_index (child_index, index) : NULL;
+}
+
 /**
  * arv_dom_node_get_previous_sibling:
  * @self: a #ArvDomNode
@@ -282,7 +370,7 @@ arv_dom_node_insert_before (ArvDomNode* self, ArvDomNode* new_child, ArvDomNode*
 	ArvDomNodeClass *node_class;
 
 	if (ref_child == NULL)
-		arv_dom_node_append_child (self, new_child);
+		return arv_dom_node_append_child (self, new_child);
 
 	g_return_val_if_fail (ARV_IS_DOM_NODE (new_child), NULL);
 
@@ -331,6 +419,9 @@ arv_dom_node_insert_before (ArvDomNode* self, ArvDomNode* new_child, ArvDomNode*
 
 	ref_child_priv->previous_sibling = new_child;
 
+	priv->n_children++;
+	_drop_child_index (priv);
+
 	node_class = ARV_DOM_NODE_GET_CLASS (self);
 
 	if (node_class->post_new_child)
@@ -436,7 +527,6 @@ arv_dom_node_remove_child (ArvDomNode* self, ArvDomNode* old_child)
 {
 	ArvDomNodePrivate *priv = arv_dom_node_get_instance_private (self);
 	ArvDomNodePrivate *old_child_priv = arv_dom_node_get_instance_private (old_child);
-	ArvDomNode *node;
 	ArvDomNodeClass *node_class;
 
 	g_return_val_if_fail (ARV_IS_DOM_NODE (self), NULL);
@@ -446,11 +536,7 @@ arv_dom_node_remove_child (ArvDomNode* self, ArvDomNode* old_child)
 
 	g_return_val_if_fail (ARV_IS_DOM_NODE (old_child), NULL);
 
-	for (node = priv->first_child;
-	     node != NULL && node != old_child;
-	     node = arv_dom_node_get_next_sibling (node));
-
-	if (node == NULL)
+	if (old_child_priv->parent_node != self)
 		return NULL;
 
 	node_class = ARV_DOM_NODE_GET_CLASS (self);
@@ -478,6 +564,9 @@ arv_dom_node_remove_child (ArvDomNode* self, ArvDomNode* old_child)
 	old_child_priv->next_sibling = NULL;
 	old_child_priv->previous_sibling = NULL;
 
+	priv->n_children--;
+	_drop_child_index (priv);
+
 	arv_dom_node_changed (self);
 
 	return old_child;
@@ -536,6 +625,10 @@ arv_dom_node_append_child (ArvDomNode* self, ArvDomNode* new_child)
 	new_child_priv->previous_sibling = priv->last_child;
 	priv->last_child = new_child;
 
+	priv->n_children++;
+	if (priv->child_index != NULL)
+		g_ptr_array_add (priv->child_index, new_child);
+
 	node_class = ARV_DOM_NODE_GET_CLASS (self);
 
 	if (node_class->post_new_child)
@@ -608,6 +701,8 @@ arv_dom_node_finalize (GObject *object)
 		child = next_child;
 	}
 
+	_drop_child_index (priv);
+
 	G_OBJECT_CLASS (arv_dom_node_parent_class)->finalize (object);
 }
 
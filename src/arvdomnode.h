@@ -81,6 +81,8 @@ ArvDomNode * 		arv_dom_node_get_parent_node 		(ArvDomNode* self);
 ArvDomNodeList *	arv_dom_node_get_child_nodes 		(ArvDomNode* self);
 ArvDomNode * 		arv_dom_node_get_first_child 		(ArvDomNode* self);
 ArvDomNode * 		arv_dom_node_get_last_child 		(ArvDomNode* self);
+guint			arv_dom_node_get_n_children		(ArvDomNode* self);
+ArvDomNode *		arv_dom_node_get_nth_child		(ArvDomNode* self, guint index);
 ArvDomNode * 		arv_dom_node_get_previous_sibling 	(ArvDomNode* self);
 ArvDomNode * 		arv_dom_node_get_next_sibling 		(ArvDomNode* self);
 #if 0
@@ -56,38 +56,22 @@ static ArvDomNode *
 arv_dom_node_child_list_get_item (ArvDomNodeList *list, unsigned int index)
 {
 	ArvDomNodeChildList *child_list = ARV_DOM_NODE_CHILD_LIST (list);
-	ArvDomNode *iter;
-	unsigned int i = 0;
 
 	if (child_list->parent_node == NULL)
 		return NULL;
 
-	for (iter = arv_dom_node_get_first_child (arv_dom_node_get_parent_node (ARV_DOM_NODE (child_list)));
-	     iter != NULL; iter = arv_dom_node_get_next_sibling (iter)) {
-		if (i == index)
-			return iter;
-		i++;
-	}
-
-	return NULL;
+	return arv_dom_node_get_nth_child (child_list->parent_node, index);
 }
 
 static unsigned int
 arv_dom_node_child_list_get_length (ArvDomNodeList *list)
 {
 	ArvDomNodeChildList *child_list = ARV_DOM_NODE_CHILD_LIST (list);
-	ArvDomNode *iter;
-	unsigned int length = 0;
 
 	if (child_list->parent_node == NULL)
 		return 0;
 
-	for (iter = arv_dom_node_get_first_child (arv_dom_node_get_parent_node (ARV_DOM_NODE (child_list)));
-	     iter != NULL;
-	     iter = arv_dom_node_get_next_sibling (iter))
-		length++;
-
-	return length;
+	return arv_dom_node_get_n_children (child_list->parent_node);
 }
 
 ArvDomNodeList *
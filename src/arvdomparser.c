@@ -45,6 +45,10 @@ typedef struct {
 
 	int error_depth;
 
+	/* Text of the current element, appended as a single text node */
+	GString *text;
+	gboolean has_element_child;
+
 	GHashTable *entities;
 } ArvDomSaxParserState;
 
@@ -70,6 +74,8 @@ arv_dom_parser_start_document (void *user_data)
 	state->is_error = FALSE;
 	state->error_depth = 0;
 	state->entities = g_hash_table_new_full (g_str_hash, g_str_equal, NULL, _free_entity);
+	state->text = g_string_new (NULL);
+	state->has_element_child = FALSE;
 }
 
 static void
@@ -78,6 +84,38 @@ arv_dom_parser_end_document (void *user_data)
 	ArvDomSaxParserState *state = user_data;
 
 	g_hash_table_unref (state->entities);
+	g_string_free (state->text, TRUE);
+	state->text = NULL;
+}
+
+static gboolean
+_is_blank (const char *text)
+{
+	for (; *text != '\0'; text++)
+		if (!g_ascii_isspace (*text))
+			return FALSE;
+
+	return TRUE;
+}
+
+/* Consecutive character data are merged, and blank text between elements is dropped, instead of creating text nodes
+ * the GenICam nodes reject anyway. Same rules as the GenICam snapshot builder. */
+
+static void
+_flush_text (ArvDomSaxParserState *state, gboolean drop_blank)
+{
+	ArvDomNode *node;
+
+	if (state->text == NULL || state->text->len == 0)
+		return;
+
+	if (!(drop_blank && _is_blank (state->text->str))) {
+		node = ARV_DOM_NODE (arv_dom_document_create_text_node (ARV_DOM_DOCUMENT (state->document),
+									 state->text->str));
+		arv_dom_node_append_child (state->current_node, node);
+	}
+
+	g_string_truncate (state->text, 0);
 }
 
 static void
@@ -94,6 +132,8 @@ arv_dom_parser_start_element(void *user_data,
 		return;
 	}
 
+	_flush_text (state, TRUE);
+
 	if (state->document == NULL) {
 		state->document = arv_dom_implementation_create_document (NULL, (char *) name);
 		state->current_node = ARV_DOM_NODE (state->document);
@@ -113,6 +153,7 @@ arv_dom_parser_start_element(void *user_data,
 		state->current_node = node;
 		state->is_error = FALSE;
 		state->error_depth = 0;
+		state->has_element_child = FALSE;
 	} else {
 		state->is_error = TRUE;
 		state->error_depth = 1;
@@ -132,10 +173,14 @@ arv_dom_parser_end_element (void *user_data,
 		}
 
 		state->is_error = FALSE;
+		state->has_element_child = TRUE;
 		return;
 	}
 
+	_flush_text (state, state->has_element_child);
+
 	state->current_node = arv_dom_node_get_parent_node (state->current_node);
+	state->has_element_child = TRUE;
 }
 
 static void
@@ -143,17 +188,8 @@ arv_dom_parser_characters (void *user_data, const xmlChar *ch, int len)
 {
 	ArvDomSaxParserState *state = user_data;
 
-	if (!state->is_error) {
-		ArvDomNode *node;
-		char *text;
-
-		text = g_strndup ((char *) ch, len);
-		node = ARV_DOM_NODE (arv_dom_document_create_text_node (ARV_DOM_DOCUMENT (state->document), text));
-
-		arv_dom_node_append_child (state->current_node, node);
-
-		g_free (text);
-	}
+	if (!state->is_error && state->text != NULL)
+		g_string_append_len (state->text, (const char *) ch, len);
 }
 
 #if 1
@@ -221,7 +257,7 @@ static ArvDomDocument *
 _parse_memory (ArvDomDocument *document, ArvDomNode *node,
 	       const void *buffer, int size, GError **error)
 {
-	static ArvDomSaxParserState state;
+	ArvDomSaxParserState state = {0};
 
 	state.document = document;
 	if (node != NULL)
@@ -233,7 +269,8 @@ _parse_memory (ArvDomDocument *document, ArvDomNode *node,
 		size = strlen (buffer);
 
 	if (xmlSAXUserParseMemory (&sax_handler, &state, buffer, size) < 0) {
-		if (state.document !=  NULL)
+		/* When appending, the document belongs to the caller */
+		if (state.document !=  NULL && document == NULL)
 			g_object_unref (state.document);
 		state.document = NULL;
 
@@ -87,6 +87,21 @@ typedef enum {
 const char * 		arv_exposure_mode_to_string 		(ArvExposureMode value);
 ArvExposureMode 	arv_exposure_mode_from_string		(const char *string);
 
+/**
+ * ArvUvUsbMode:
+ * @ARV_UV_USB_MODE_SYNC: one synchronous bulk transfer at a time
+ * @ARV_UV_USB_MODE_ASYNC: several asynchronous bulk transfers in flight, directly to the buffer data
+ * @ARV_UV_USB_MODE_DEFAULT: default mode
+ *
+ * Since: 0.8.11
+ */
+
+typedef enum {
+	ARV_UV_USB_MODE_SYNC,
+	ARV_UV_USB_MODE_ASYNC,
+	ARV_UV_USB_MODE_DEFAULT = ARV_UV_USB_MODE_SYNC
+} ArvUvUsbMode;
+
 /**
  * ArvPixelFormat:
  *
@@ -112,9 +127,11 @@ typedef guint32 ArvPixelFormat;
 
 #define	ARV_PIXEL_FORMAT_MONO_10		((ArvPixelFormat) 0x01100003u)
 #define ARV_PIXEL_FORMAT_MONO_10_PACKED		((ArvPixelFormat) 0x010c0004u)
+#define ARV_PIXEL_FORMAT_MONO_10P		((ArvPixelFormat) 0x010a0046u)
 
 #define ARV_PIXEL_FORMAT_MONO_12		((ArvPixelFormat) 0x01100005u)
 #define ARV_PIXEL_FORMAT_MONO_12_PACKED		((ArvPixelFormat) 0x010c0006u)
+#define ARV_PIXEL_FORMAT_MONO_12P		((ArvPixelFormat) 0x010c0047u)
 
 #define ARV_PIXEL_FORMAT_MONO_14		((ArvPixelFormat) 0x01100025u)
 
@@ -31,6 +31,7 @@
 #include <arvstr.h>
 #include <math.h>
 #include <stdlib.h>
+#include <string.h>
 
 #define ARV_EVALUATOR_STACK_SIZE	128
 
@@ -52,11 +53,29 @@ typedef enum {
 	ARV_EVALUATOR_STATUS_FORBIDDEN_RECUSRION
 } ArvEvaluatorStatus;
 
+typedef struct _ArvEvaluatorToken ArvEvaluatorToken;
+typedef struct _ArvEvaluatorNode ArvEvaluatorNode;
+
+typedef struct {
+	ArvEvaluatorToken *tokens;
+	guint n_tokens;
+	/* Number of interpreted evaluations, and compiled version once hot, see compile_program() */
+	guint n_evaluations;
+	ArvEvaluatorNode *nodes;
+	const ArvEvaluatorNode *root;
+} ArvEvaluatorProgram;
+
 typedef struct {
 	char *expression;
-	GSList *rpn_stack;
+	/* Parsed expression, owns the variable names */
+	ArvEvaluatorProgram rpn;
+	/* Optimized versions of the parsed expression for each evaluation mode, built on first use */
+	ArvEvaluatorProgram *int64_program;
+	ArvEvaluatorProgram *double_program;
 	ArvEvaluatorStatus parsing_status;
-	GHashTable *variables;
+	/* Variable values are stored in slots, the name to slot mapping never changes once created */
+	GHashTable *variable_slots;
+	GArray *variable_values;
 	GHashTable *sub_expressions;
 	GHashTable *constants;
 } ArvEvaluatorPrivate;
@@ -206,15 +225,17 @@ static ArvEvaluatorTokenInfos arv_evaluator_token_infos[] = {
 	{"var",		200,	FALSE,	0, 0}, /* VARIABLE */
 };
 
-typedef struct {
+struct _ArvEvaluatorToken {
 	ArvEvaluatorTokenId	token_id;
 	gint32 parenthesis_level;
+	/* Slot of the variable value, resolved after parsing */
+	gint slot;
 	union {
 		double		v_double;
 		gint64		v_int64;
 		char * 		name;
 	} data;
-} ArvEvaluatorToken;
+};
 
 typedef struct {
 	gint32 parenthesis_level;
@@ -269,7 +290,7 @@ arv_evaluator_token_free (ArvEvaluatorToken *token)
 }
 
 static void
-arv_evaluator_token_debug (ArvEvaluatorToken *token, GHashTable *variables)
+arv_evaluator_token_debug (const ArvEvaluatorToken *token, GArray *variable_values)
 {
 	ArvValue *value;
 
@@ -277,10 +298,10 @@ arv_evaluator_token_debug (ArvEvaluatorToken *token, GHashTable *variables)
 
 	switch (token->token_id) {
 		case ARV_EVALUATOR_TOKEN_VARIABLE:
-			value = g_hash_table_lookup (variables, token->data.name);
+			value = &g_array_index (variable_values, ArvValue, token->slot);
 			arv_debug_evaluator ("(var) %s = %g%s", token->data.name,
-					   value != NULL ? arv_value_get_double (value) : 0,
-					   value != NULL ? "" : " not found");
+					   value->type != G_TYPE_INVALID ? arv_value_get_double (value) : 0,
+					   value->type != G_TYPE_INVALID ? "" : " not found");
 			break;
 		case ARV_EVALUATOR_TOKEN_CONSTANT_INT64:
 			arv_debug_evaluator ("(int64) %" G_GINT64_FORMAT, token->data.v_int64);
@@ -294,7 +315,7 @@ arv_evaluator_token_debug (ArvEvaluatorToken *token, GHashTable *variables)
 }
 
 static gboolean
-arv_evaluator_token_is_variable (ArvEvaluatorToken *token)
+arv_evaluator_token_is_variable (const ArvEvaluatorToken *token)
 {
 	return (token != NULL &&
 		token->token_id == ARV_EVALUATOR_TOKEN_VARIABLE);
@@ -308,7 +329,7 @@ arv_evaluator_token_is_operand (ArvEvaluatorToken *token)
 }
 
 static gboolean
-arv_evaluator_token_is_operator (ArvEvaluatorToken *token)
+arv_evaluator_token_is_operator (const ArvEvaluatorToken *token)
 {
 	return (token != NULL &&
 		token->token_id > ARV_EVALUATOR_TOKEN_UNKNOWN &&
@@ -546,24 +567,20 @@ get_arguments_count(ArvEvaluatorValuesStackItem * stack, int current_index)
 }
 
 static ArvEvaluatorStatus
-evaluate (GSList *token_stack, GHashTable *variables, gint64 *v_int64, double *v_double)
+evaluate (const ArvEvaluatorToken *tokens, guint n_tokens, GArray *variable_values, gboolean integer_mode,
+	  ArvValue *result)
 {
-	ArvEvaluatorToken *token;
+	const ArvEvaluatorToken *token;
 	ArvEvaluatorStatus status;
-	GSList *iter;
 	ArvEvaluatorValuesStackItem stack[ARV_EVALUATOR_STACK_SIZE];
 	ArvValue *value;
 	int index = -1;
-	gboolean integer_mode;
-
-	g_assert (v_int64 != NULL || v_double != NULL);
+	guint i;
 
-	integer_mode = v_int64 != NULL;
-
-	for (iter = token_stack; iter != NULL; iter = iter->next) {
+	for (i = 0; i < n_tokens; i++) {
 		int actual_arguments_count;
 
-		token = iter->data;
+		token = &tokens[i];
 
 		if (index < (arv_evaluator_token_infos[token->token_id].n_args - 1)) {
 			status = ARV_EVALUATOR_STATUS_MISSING_ARGUMENTS;
@@ -580,7 +597,7 @@ evaluate (GSList *token_stack, GHashTable *variables, gint64 *v_int64, double *v
 			goto CLEANUP;
 		}
 
-		arv_evaluator_token_debug (token, variables);
+		arv_evaluator_token_debug (token, variable_values);
 
 		actual_arguments_count = arv_evaluator_token_infos[token->token_id].n_args;
 
@@ -928,8 +945,8 @@ evaluate (GSList *token_stack, GHashTable *variables, gint64 *v_int64, double *v
 				stack[index+1].parenthesis_level = token->parenthesis_level;
 				break;
 			case ARV_EVALUATOR_TOKEN_VARIABLE:
-				value = g_hash_table_lookup (variables, token->data.name);
-				if (value != NULL) {
+				value = &g_array_index (variable_values, ArvValue, token->slot);
+				if (value->type != G_TYPE_INVALID) {
 					arv_value_copy (&stack[index+1].value, value);
 					stack[index+1].parenthesis_level = token->parenthesis_level;
 				} else {
@@ -961,24 +978,11 @@ evaluate (GSList *token_stack, GHashTable *variables, gint64 *v_int64, double *v
 		goto CLEANUP;
 	}
 
-	if (v_double != NULL)
-		*v_double = arv_value_get_double (&stack[0].value);
-
-	if (v_int64 != NULL)
-		*v_int64 = arv_value_get_int64 (&stack[0].value);
-
-	if (arv_value_holds_int64 (&stack[0].value))
-		arv_debug_evaluator ("[Evaluator::evaluate] Result = (int64) %" G_GINT64_FORMAT, arv_value_get_int64 (&stack[0].value));
-	else
-		arv_debug_evaluator ("[Evaluator::evaluate] Result = (double) %g", arv_value_get_double (&stack[0].value));
+	arv_value_copy (result, &stack[0].value);
 
 	return ARV_EVALUATOR_STATUS_SUCCESS;
 CLEANUP:
-	if (v_double != NULL)
-		*v_double = 0.0;
-
-	if (v_int64 != NULL)
-		*v_int64 = 0.0;
+	arv_value_set_int64 (result, 0);
 
 	return status;
 }
@@ -1122,15 +1126,44 @@ CLEANUP:
 	return status;
 }
 
+static gint
+_get_variable_slot (ArvEvaluator *evaluator, const char *name)
+{
+	gpointer slot;
+	ArvValue value = {0};
+
+	if (g_hash_table_lookup_extended (evaluator->priv->variable_slots, name, NULL, &slot))
+		return GPOINTER_TO_INT (slot);
+
+	/* New slots hold an undefined value until a variable is assigned */
+	g_array_append_val (evaluator->priv->variable_values, value);
+	g_hash_table_insert (evaluator->priv->variable_slots, g_strdup (name),
+			     GINT_TO_POINTER (evaluator->priv->variable_values->len - 1));
+
+	return evaluator->priv->variable_values->len - 1;
+}
+
 static void
-free_rpn_stack (ArvEvaluator *evaluator)
+free_programs (ArvEvaluator *evaluator)
 {
-	GSList *iter;
+	guint i;
 
-	for (iter = evaluator->priv->rpn_stack; iter != NULL; iter = iter->next)
-		arv_evaluator_token_free (iter->data);
-	g_slist_free (evaluator->priv->rpn_stack);
-	evaluator->priv->rpn_stack = NULL;
+	if (evaluator->priv->int64_program != NULL) {
+		g_free (evaluator->priv->int64_program->tokens);
+		g_free (evaluator->priv->int64_program->nodes);
+		g_clear_pointer (&evaluator->priv->int64_program, g_free);
+	}
+	if (evaluator->priv->double_program != NULL) {
+		g_free (evaluator->priv->double_program->tokens);
+		g_free (evaluator->priv->double_program->nodes);
+		g_clear_pointer (&evaluator->priv->double_program, g_free);
+	}
+
+	for (i = 0; i < evaluator->priv->rpn.n_tokens; i++)
+		if (arv_evaluator_token_is_variable (&evaluator->priv->rpn.tokens[i]))
+			g_free (evaluator->priv->rpn.tokens[i].data.name);
+	g_clear_pointer (&evaluator->priv->rpn.tokens, g_free);
+	evaluator->priv->rpn.n_tokens = 0;
 }
 
 static ArvEvaluatorStatus
@@ -1140,6 +1173,7 @@ parse_expression (ArvEvaluator *evaluator)
 	ArvEvaluatorStatus status;
 	GSList *iter;
 	int count;
+	guint i;
 
 	state.count  =0;
 	state.previous_token_was_operand = FALSE;
@@ -1149,7 +1183,7 @@ parse_expression (ArvEvaluator *evaluator)
 	state.garbage_stack = NULL;
 	state.in_sub_expression = FALSE;
 
-	free_rpn_stack (evaluator);
+	free_programs (evaluator);
 
 	arv_debug_evaluator ("[Evaluator::parse_expression] %s", evaluator->priv->expression);
 
@@ -1169,16 +1203,29 @@ parse_expression (ArvEvaluator *evaluator)
 		state.operator_stack = g_slist_delete_link (state.operator_stack, state.operator_stack);
 	}
 
-	evaluator->priv->rpn_stack = g_slist_reverse (state.token_stack);
+	/* Store the RPN tokens in a contiguous array, and bind the variables to their value slot, evaluation doesn't
+	 * need any name lookup */
+	state.token_stack = g_slist_reverse (state.token_stack);
+	evaluator->priv->rpn.n_tokens = g_slist_length (state.token_stack);
+	evaluator->priv->rpn.tokens = g_new (ArvEvaluatorToken, evaluator->priv->rpn.n_tokens);
+	for (iter = state.token_stack, i = 0; iter != NULL; iter = iter->next, i++) {
+		ArvEvaluatorToken *token = &evaluator->priv->rpn.tokens[i];
+
+		*token = *((ArvEvaluatorToken *) iter->data);
+		if (arv_evaluator_token_is_variable (token))
+			token->slot = _get_variable_slot (evaluator, token->data.name);
+		g_free (iter->data);
+	}
+	g_slist_free (state.token_stack);
 
 	for (iter = state.garbage_stack, count = 0; iter != NULL; iter = iter->next, count++)
 		arv_evaluator_token_free (iter->data);
 	g_slist_free (state.garbage_stack);
 
 	arv_debug_evaluator ("[Evaluator::parse_expression] %d items in garbage list", count);
-	arv_debug_evaluator ("[Evaluator::parse_expression] %d items in token list", g_slist_length (evaluator->priv->rpn_stack));
+	arv_debug_evaluator ("[Evaluator::parse_expression] %d items in token list", evaluator->priv->rpn.n_tokens);
 
-	return evaluator->priv->rpn_stack == NULL ? ARV_EVALUATOR_STATUS_EMPTY_EXPRESSION : ARV_EVALUATOR_STATUS_SUCCESS;
+	return evaluator->priv->rpn.n_tokens == 0 ? ARV_EVALUATOR_STATUS_EMPTY_EXPRESSION : ARV_EVALUATOR_STATUS_SUCCESS;
 
 CLEANUP:
 	for (iter = state.garbage_stack; iter != NULL; iter = iter->next)
@@ -1194,6 +1241,464 @@ CLEANUP:
 	return status;
 }
 
+/* Constant folding. The RPN stack effect of each token is simulated, and each operator whose operands are all
+ * constants is evaluated at compile time, and replaced with its result. Folding depends on the evaluation mode, as
+ * integer and floating point evaluations of the same operation differ. Operations failing at compile time, like
+ * divisions by zero, are kept as is, for the error to be reported at evaluation. */
+
+static ArvEvaluatorProgram *
+build_program (ArvEvaluator *evaluator, gboolean integer_mode)
+{
+	ArvEvaluatorProgram *program;
+	ArvEvaluatorProgram *rpn = &evaluator->priv->rpn;
+	struct {
+		guint start;
+		gboolean is_constant;
+	} stack[ARV_EVALUATOR_STACK_SIZE];
+	int index = -1;
+	guint i;
+
+	program = g_new0 (ArvEvaluatorProgram, 1);
+	program->tokens = g_new (ArvEvaluatorToken, rpn->n_tokens);
+
+	for (i = 0; i < rpn->n_tokens; i++) {
+		const ArvEvaluatorToken *token = &rpn->tokens[i];
+		int n_args = arv_evaluator_token_infos[token->token_id].n_args;
+
+		/* The number of operands of ROUND depends on the parenthesis levels at evaluation, and malformed
+		 * expressions must fail at evaluation, just copy the tokens */
+		if (token->token_id == ARV_EVALUATOR_TOKEN_FUNCTION_ROUND ||
+		    (arv_evaluator_token_is_operator (token) && (n_args < 1 || index < n_args - 1)) ||
+		    index >= ARV_EVALUATOR_STACK_SIZE - 1) {
+			memcpy (program->tokens, rpn->tokens, sizeof (ArvEvaluatorToken) * rpn->n_tokens);
+			program->n_tokens = rpn->n_tokens;
+
+			return program;
+		}
+
+		program->tokens[program->n_tokens] = *token;
+
+		if (!arv_evaluator_token_is_operator (token)) {
+			index++;
+			stack[index].start = program->n_tokens;
+			stack[index].is_constant = !arv_evaluator_token_is_variable (token);
+		} else {
+			gboolean is_constant = TRUE;
+			guint start;
+			int j;
+
+			for (j = 0; j < n_args; j++)
+				is_constant = is_constant && stack[index - j].is_constant;
+
+			index = index - n_args + 1;
+			start = stack[index].start;
+			stack[index].is_constant = FALSE;
+
+			if (is_constant) {
+				ArvValue value;
+
+				if (evaluate (&program->tokens[start], program->n_tokens - start + 1, evaluator->priv->variable_values,
+					      integer_mode, &value) == ARV_EVALUATOR_STATUS_SUCCESS) {
+					ArvEvaluatorToken *constant = &program->tokens[start];
+
+					constant->parenthesis_level = token->parenthesis_level;
+					constant->slot = 0;
+					if (arv_value_holds_int64 (&value)) {
+						constant->token_id = ARV_EVALUATOR_TOKEN_CONSTANT_INT64;
+						constant->data.v_int64 = arv_value_get_int64 (&value);
+					} else {
+						constant->token_id = ARV_EVALUATOR_TOKEN_CONSTANT_DOUBLE;
+						constant->data.v_double = arv_value_get_double (&value);
+					}
+
+					program->n_tokens = start;
+					stack[index].is_constant = TRUE;
+				}
+			}
+		}
+
+		program->n_tokens++;
+	}
+
+	arv_debug_evaluator ("[Evaluator::build_program] %d tokens folded to %d in %s mode",
+			     rpn->n_tokens, program->n_tokens, integer_mode ? "integer" : "double");
+
+	return program;
+}
+
+/* Compilation of the hot programs. Once a program has been interpreted ARV_EVALUATOR_COMPILE_THRESHOLD times, it
+ * is compiled into a tree of nodes. Each node evaluates its operands, then applies its operation through a function
+ * specialized for the token and the evaluation mode, without the token dispatch of evaluate(). The node functions
+ * follow the semantics of the corresponding cases of evaluate(). Programs using a token without node function, like
+ * ROUND, or malformed programs, keep being interpreted. */
+
+#define ARV_EVALUATOR_COMPILE_THRESHOLD		8
+
+typedef ArvEvaluatorStatus (*ArvEvaluatorNodeFunc) (const ArvEvaluatorNode *node, const ArvValue *variables,
+						    ArvValue *value);
+
+struct _ArvEvaluatorNode {
+	ArvEvaluatorNodeFunc func;
+	const ArvEvaluatorNode *args[3];
+	union {
+		ArvValue constant;
+		gint slot;
+		double (*math) (double);
+	} data;
+};
+
+/* Inlined versions of the ArvValue accessors */
+
+static inline gint64
+_get_int64 (const ArvValue *value)
+{
+	return value->type == G_TYPE_INT64 ? value->data.v_int64 : (gint64) value->data.v_double;
+}
+
+static inline double
+_get_double (const ArvValue *value)
+{
+	return value->type == G_TYPE_INT64 ? (double) value->data.v_int64 : value->data.v_double;
+}
+
+static inline void
+_set_int64 (ArvValue *value, gint64 v_int64)
+{
+	value->type = G_TYPE_INT64;
+	value->data.v_int64 = v_int64;
+}
+
+static inline void
+_set_double (ArvValue *value, double v_double)
+{
+	value->type = G_TYPE_DOUBLE;
+	value->data.v_double = v_double;
+}
+
+#define ARV_EVALUATOR_NODE_EVALUATE_ARGS(n_args)						\
+	ArvValue args[n_args];									\
+	ArvEvaluatorStatus status;								\
+	int i;											\
+												\
+	for (i = 0; i < (n_args); i++) {							\
+		status = node->args[i]->func (node->args[i], variables, &args[i]);		\
+		if (status != ARV_EVALUATOR_STATUS_SUCCESS)					\
+			return status;								\
+	}
+
+/* Integer operations, in both modes */
+
+#define ARV_EVALUATOR_INT64_NODE(name,op)							\
+static ArvEvaluatorStatus									\
+_node_##name (const ArvEvaluatorNode *node, const ArvValue *variables, ArvValue *value)	\
+{												\
+	ARV_EVALUATOR_NODE_EVALUATE_ARGS (2);							\
+	_set_int64 (value, _get_int64 (&args[0]) op _get_int64 (&args[1]));			\
+	return ARV_EVALUATOR_STATUS_SUCCESS;							\
+}
+
+/* Operations on integers in integer mode, or if both operands are integers, on floating point values otherwise */
+
+#define ARV_EVALUATOR_ARITHMETIC_NODES(name,op,double_setter)					\
+static ArvEvaluatorStatus									\
+_node_##name##_int64 (const ArvEvaluatorNode *node, const ArvValue *variables, ArvValue *value)	\
+{												\
+	ARV_EVALUATOR_NODE_EVALUATE_ARGS (2);							\
+	_set_int64 (value, _get_int64 (&args[0]) op _get_int64 (&args[1]));			\
+	return ARV_EVALUATOR_STATUS_SUCCESS;							\
+}												\
+												\
+static ArvEvaluatorStatus									\
+_node_##name##_double (const ArvEvaluatorNode *node, const ArvValue *variables, ArvValue *value)	\
+{												\
+	ARV_EVALUATOR_NODE_EVALUATE_ARGS (2);							\
+	if (args[0].type == G_TYPE_INT64 && args[1].type == G_TYPE_INT64)			\
+		_set_int64 (value, args[0].data.v_int64 op args[1].data.v_int64);		\
+	else											\
+		double_setter (value, _get_double (&args[0]) op _get_double (&args[1]));	\
+	return ARV_EVALUATOR_STATUS_SUCCESS;							\
+}
+
+ARV_EVALUATOR_INT64_NODE (logical_and, &&)
+ARV_EVALUATOR_INT64_NODE (logical_or, ||)
+ARV_EVALUATOR_INT64_NODE (bitwise_and, &)
+ARV_EVALUATOR_INT64_NODE (bitwise_or, |)
+ARV_EVALUATOR_INT64_NODE (bitwise_xor, ^)
+ARV_EVALUATOR_INT64_NODE (shift_right, >>)
+ARV_EVALUATOR_INT64_NODE (shift_left, <<)
+
+ARV_EVALUATOR_ARITHMETIC_NODES (equal, ==, _set_int64)
+ARV_EVALUATOR_ARITHMETIC_NODES (not_equal, !=, _set_int64)
+ARV_EVALUATOR_ARITHMETIC_NODES (less_or_equal, <=, _set_int64)
+ARV_EVALUATOR_ARITHMETIC_NODES (greater_or_equal, >=, _set_int64)
+ARV_EVALUATOR_ARITHMETIC_NODES (less, <, _set_int64)
+ARV_EVALUATOR_ARITHMETIC_NODES (greater, >, _set_int64)
+ARV_EVALUATOR_ARITHMETIC_NODES (substraction, -, _set_double)
+ARV_EVALUATOR_ARITHMETIC_NODES (addition, +, _set_double)
+ARV_EVALUATOR_ARITHMETIC_NODES (multiplication, *, _set_double)
+
+static ArvEvaluatorStatus
+_node_remainder (const ArvEvaluatorNode *node, const ArvValue *variables, ArvValue *value)
+{
+	ARV_EVALUATOR_NODE_EVALUATE_ARGS (2);
+
+	if (_get_int64 (&args[1]) == 0)
+		return ARV_EVALUATOR_STATUS_DIVISION_BY_ZERO;
+
+	_set_int64 (value, _get_int64 (&args[0]) % _get_int64 (&args[1]));
+
+	return ARV_EVALUATOR_STATUS_SUCCESS;
+}
+
+static ArvEvaluatorStatus
+_node_division_int64 (const ArvEvaluatorNode *node, const ArvValue *variables, ArvValue *value)
+{
+	ARV_EVALUATOR_NODE_EVALUATE_ARGS (2);
+
+	if (_get_int64 (&args[1]) == 0)
+		return ARV_EVALUATOR_STATUS_DIVISION_BY_ZERO;
+
+	_set_int64 (value, _get_int64 (&args[0]) / _get_int64 (&args[1]));
+
+	return ARV_EVALUATOR_STATUS_SUCCESS;
+}
+
+static ArvEvaluatorStatus
+_node_division_double (const ArvEvaluatorNode *node, const ArvValue *variables, ArvValue *value)
+{
+	ARV_EVALUATOR_NODE_EVALUATE_ARGS (2);
+
+	if (_get_double (&args[1]) == 0.0)
+		return ARV_EVALUATOR_STATUS_DIVISION_BY_ZERO;
+
+	_set_double (value, _get_double (&args[0]) / _get_double (&args[1]));
+
+	return ARV_EVALUATOR_STATUS_SUCCESS;
+}
+
+static ArvEvaluatorStatus
+_node_power_int64 (const ArvEvaluatorNode *node, const ArvValue *variables, ArvValue *value)
+{
+	ARV_EVALUATOR_NODE_EVALUATE_ARGS (2);
+
+	_set_int64 (value, pow (_get_int64 (&args[0]), _get_int64 (&args[1])));
+
+	return ARV_EVALUATOR_STATUS_SUCCESS;
+}
+
+static ArvEvaluatorStatus
+_node_power_double (const ArvEvaluatorNode *node, const ArvValue *variables, ArvValue *value)
+{
+	ARV_EVALUATOR_NODE_EVALUATE_ARGS (2);
+
+	_set_double (value, pow (_get_double (&args[0]), _get_double (&args[1])));
+
+	return ARV_EVALUATOR_STATUS_SUCCESS;
+}
+
+static ArvEvaluatorStatus
+_node_minus_int64 (const ArvEvaluatorNode *node, const ArvValue *variables, ArvValue *value)
+{
+	ARV_EVALUATOR_NODE_EVALUATE_ARGS (1);
+
+	_set_int64 (value, -_get_int64 (&args[0]));
+
+	return ARV_EVALUATOR_STATUS_SUCCESS;
+}
+
+static ArvEvaluatorStatus
+_node_minus_double (const ArvEvaluatorNode *node, const ArvValue *variables, ArvValue *value)
+{
+	ARV_EVALUATOR_NODE_EVALUATE_ARGS (1);
+
+	if (args[0].type == G_TYPE_INT64)
+		_set_int64 (value, -args[0].data.v_int64);
+	else
+		_set_double (value, -_get_double (&args[0]));
+
+	return ARV_EVALUATOR_STATUS_SUCCESS;
+}
+
+static ArvEvaluatorStatus
+_node_bitwise_not (const ArvEvaluatorNode *node, const ArvValue *variables, ArvValue *value)
+{
+	ARV_EVALUATOR_NODE_EVALUATE_ARGS (1);
+
+	_set_int64 (value, ~_get_int64 (&args[0]));
+
+	return ARV_EVALUATOR_STATUS_SUCCESS;
+}
+
+static ArvEvaluatorStatus
+_node_abs (const ArvEvaluatorNode *node, const ArvValue *variables, ArvValue *value)
+{
+	ARV_EVALUATOR_NODE_EVALUATE_ARGS (1);
+
+	if (args[0].type == G_TYPE_DOUBLE)
+		_set_double (value, fabs (args[0].data.v_double));
+	else
+		_set_int64 (value, llabs (_get_int64 (&args[0])));
+
+	return ARV_EVALUATOR_STATUS_SUCCESS;
+}
+
+static ArvEvaluatorStatus
+_node_math (const ArvEvaluatorNode *node, const ArvValue *variables, ArvValue *value)
+{
+	ARV_EVALUATOR_NODE_EVALUATE_ARGS (1);
+
+	_set_double (value, node->data.math (_get_double (&args[0])));
+
+	return ARV_EVALUATOR_STATUS_SUCCESS;
+}
+
+/* Both branches are evaluated, as in evaluate() */
+
+static ArvEvaluatorStatus
+_node_ternary (const ArvEvaluatorNode *node, const ArvValue *variables, ArvValue *value)
+{
+	ARV_EVALUATOR_NODE_EVALUATE_ARGS (3);
+
+	*value = _get_int64 (&args[0]) != 0 ? args[1] : args[2];
+
+	return ARV_EVALUATOR_STATUS_SUCCESS;
+}
+
+static ArvEvaluatorStatus
+_node_constant (const ArvEvaluatorNode *node, const ArvValue *variables, ArvValue *value)
+{
+	*value = node->data.constant;
+
+	return ARV_EVALUATOR_STATUS_SUCCESS;
+}
+
+static ArvEvaluatorStatus
+_node_variable (const ArvEvaluatorNode *node, const ArvValue *variables, ArvValue *value)
+{
+	if (variables[node->data.slot].type == G_TYPE_INVALID)
+		return ARV_EVALUATOR_STATUS_UNKNOWN_VARIABLE;
+
+	*value = variables[node->data.slot];
+
+	return ARV_EVALUATOR_STATUS_SUCCESS;
+}
+
+#define ARV_EVALUATOR_MODE_FUNC(name) (integer_mode ? _node_##name##_int64 : _node_##name##_double)
+
+/* Returns the node function of @token, or %NULL if the token has none. The node data are also set. */
+
+static ArvEvaluatorNodeFunc
+_get_node_func (const ArvEvaluatorToken *token, gboolean integer_mode, ArvEvaluatorNode *node)
+{
+	switch (token->token_id) {
+		case ARV_EVALUATOR_TOKEN_LOGICAL_AND:		return _node_logical_and;
+		case ARV_EVALUATOR_TOKEN_LOGICAL_OR:		return _node_logical_or;
+		case ARV_EVALUATOR_TOKEN_BITWISE_AND:		return _node_bitwise_and;
+		case ARV_EVALUATOR_TOKEN_BITWISE_OR:		return _node_bitwise_or;
+		case ARV_EVALUATOR_TOKEN_BITWISE_XOR:		return _node_bitwise_xor;
+		case ARV_EVALUATOR_TOKEN_BITWISE_NOT:		return _node_bitwise_not;
+		case ARV_EVALUATOR_TOKEN_SHIFT_RIGHT:		return _node_shift_right;
+		case ARV_EVALUATOR_TOKEN_SHIFT_LEFT:		return _node_shift_left;
+		case ARV_EVALUATOR_TOKEN_EQUAL:			return ARV_EVALUATOR_MODE_FUNC (equal);
+		case ARV_EVALUATOR_TOKEN_NOT_EQUAL:		return ARV_EVALUATOR_MODE_FUNC (not_equal);
+		case ARV_EVALUATOR_TOKEN_LESS_OR_EQUAL:		return ARV_EVALUATOR_MODE_FUNC (less_or_equal);
+		case ARV_EVALUATOR_TOKEN_GREATER_OR_EQUAL:	return ARV_EVALUATOR_MODE_FUNC (greater_or_equal);
+		case ARV_EVALUATOR_TOKEN_LESS:			return ARV_EVALUATOR_MODE_FUNC (less);
+		case ARV_EVALUATOR_TOKEN_GREATER:		return ARV_EVALUATOR_MODE_FUNC (greater);
+		case ARV_EVALUATOR_TOKEN_SUBSTRACTION:		return ARV_EVALUATOR_MODE_FUNC (substraction);
+		case ARV_EVALUATOR_TOKEN_ADDITION:		return ARV_EVALUATOR_MODE_FUNC (addition);
+		case ARV_EVALUATOR_TOKEN_MULTIPLICATION:	return ARV_EVALUATOR_MODE_FUNC (multiplication);
+		case ARV_EVALUATOR_TOKEN_DIVISION:		return ARV_EVALUATOR_MODE_FUNC (division);
+		case ARV_EVALUATOR_TOKEN_POWER:			return ARV_EVALUATOR_MODE_FUNC (power);
+		case ARV_EVALUATOR_TOKEN_MINUS:			return ARV_EVALUATOR_MODE_FUNC (minus);
+		case ARV_EVALUATOR_TOKEN_FUNCTION_NEG:		return ARV_EVALUATOR_MODE_FUNC (minus);
+		case ARV_EVALUATOR_TOKEN_REMAINDER:		return _node_remainder;
+		case ARV_EVALUATOR_TOKEN_FUNCTION_ABS:		return _node_abs;
+		case ARV_EVALUATOR_TOKEN_TERNARY_QUESTION_MARK:	return _node_ternary;
+		case ARV_EVALUATOR_TOKEN_FUNCTION_SIN:		node->data.math = sin; return _node_math;
+		case ARV_EVALUATOR_TOKEN_FUNCTION_COS:		node->data.math = cos; return _node_math;
+		case ARV_EVALUATOR_TOKEN_FUNCTION_ATAN:		node->data.math = atan; return _node_math;
+		case ARV_EVALUATOR_TOKEN_FUNCTION_TAN:		node->data.math = tan; return _node_math;
+		case ARV_EVALUATOR_TOKEN_FUNCTION_EXP:		node->data.math = exp; return _node_math;
+		case ARV_EVALUATOR_TOKEN_FUNCTION_LN:		node->data.math = log; return _node_math;
+		case ARV_EVALUATOR_TOKEN_FUNCTION_LG:		node->data.math = log10; return _node_math;
+		case ARV_EVALUATOR_TOKEN_FUNCTION_SQRT:		node->data.math = sqrt; return _node_math;
+		case ARV_EVALUATOR_TOKEN_FUNCTION_TRUNC:	node->data.math = trunc; return _node_math;
+		case ARV_EVALUATOR_TOKEN_FUNCTION_FLOOR:	node->data.math = floor; return _node_math;
+		case ARV_EVALUATOR_TOKEN_FUNCTION_CEIL:		node->data.math = ceil; return _node_math;
+		case ARV_EVALUATOR_TOKEN_FUNCTION_ASIN:		node->data.math = asin; return _node_math;
+		case ARV_EVALUATOR_TOKEN_FUNCTION_ACOS:		node->data.math = acos; return _node_math;
+		case ARV_EVALUATOR_TOKEN_CONSTANT_INT64:
+			_set_int64 (&node->data.constant, token->data.v_int64);
+			return _node_constant;
+		case ARV_EVALUATOR_TOKEN_CONSTANT_DOUBLE:
+			if (integer_mode)
+				_set_int64 (&node->data.constant, token->data.v_double);
+			else
+				_set_double (&node->data.constant, token->data.v_double);
+			return _node_constant;
+		case ARV_EVALUATOR_TOKEN_VARIABLE:
+			node->data.slot = token->slot;
+			return _node_variable;
+		default:
+			return NULL;
+	}
+}
+
+static void
+compile_program (ArvEvaluatorProgram *program, gboolean integer_mode)
+{
+	const ArvEvaluatorNode *stack[ARV_EVALUATOR_STACK_SIZE];
+	int index = -1;
+	guint i;
+
+	program->nodes = g_new0 (ArvEvaluatorNode, program->n_tokens);
+
+	for (i = 0; i < program->n_tokens; i++) {
+		const ArvEvaluatorToken *token = &program->tokens[i];
+		const ArvEvaluatorTokenInfos *infos = &arv_evaluator_token_infos[token->token_id];
+		ArvEvaluatorNode *node = &program->nodes[i];
+		int j;
+
+		if ((infos->double_only && integer_mode) ||
+		    index < infos->n_args - 1 ||
+		    index >= ARV_EVALUATOR_STACK_SIZE - 1)
+			goto FAILED;
+
+		/* No-ops, the operand stays on the stack */
+		if (token->token_id == ARV_EVALUATOR_TOKEN_PLUS ||
+		    token->token_id == ARV_EVALUATOR_TOKEN_TERNARY_COLON)
+			continue;
+
+		node->func = _get_node_func (token, integer_mode, node);
+		if (node->func == NULL)
+			goto FAILED;
+
+		for (j = 0; j < infos->n_args; j++)
+			node->args[j] = stack[index - infos->n_args + 1 + j];
+
+		index = index - infos->n_args + 1;
+		stack[index] = node;
+	}
+
+	if (index != 0)
+		goto FAILED;
+
+	program->root = stack[0];
+
+	arv_debug_evaluator ("[Evaluator::compile_program] %d tokens compiled in %s mode",
+			     program->n_tokens, integer_mode ? "integer" : "double");
+
+	return;
+
+FAILED:
+	arv_debug_evaluator ("[Evaluator::compile_program] Not compiled, '%s' token",
+			     arv_evaluator_token_infos[program->tokens[i < program->n_tokens ?
+								       i : 0].token_id].tag);
+
+	g_clear_pointer (&program->nodes, g_free);
+}
+
 static void
 arv_evaluator_set_error (GError **error, ArvEvaluatorStatus status)
 {
@@ -1209,69 +1714,89 @@ arv_evaluator_set_error (GError **error, ArvEvaluatorStatus status)
 								  G_N_ELEMENTS (arv_evaluator_status_strings)-1)]);
 }
 
-double
-arv_evaluator_evaluate_as_double (ArvEvaluator *evaluator, GError **error)
+static ArvEvaluatorStatus
+evaluate_expression (ArvEvaluator *evaluator, gboolean integer_mode, ArvValue *value)
 {
+	ArvEvaluatorProgram **program;
 	ArvEvaluatorStatus status;
-	double value;
-
-	g_return_val_if_fail (ARV_IS_EVALUATOR (evaluator), 0.0);
-
-	arv_debug_evaluator ("[Evaluator::evaluate_as_double] Expression = '%s'",
-			   evaluator->priv->expression);
 
 	if (evaluator->priv->parsing_status == ARV_EVALUATOR_STATUS_NOT_PARSED) {
 		evaluator->priv->parsing_status = parse_expression (evaluator);
-		arv_debug_evaluator ("[Evaluator::evaluate_as_double] Parsing status = %d",
+		arv_debug_evaluator ("[Evaluator::evaluate] Parsing status = %d",
 				   evaluator->priv->parsing_status);
 	}
 
-	if (evaluator->priv->parsing_status != ARV_EVALUATOR_STATUS_SUCCESS) {
-		arv_evaluator_set_error (error, evaluator->priv->parsing_status);
-		return 0.0;
+	if (evaluator->priv->parsing_status != ARV_EVALUATOR_STATUS_SUCCESS)
+		return evaluator->priv->parsing_status;
+
+	program = integer_mode ? &evaluator->priv->int64_program : &evaluator->priv->double_program;
+	if (*program == NULL)
+		*program = build_program (evaluator, integer_mode);
+
+	if ((*program)->root != NULL) {
+		status = (*program)->root->func ((*program)->root,
+						 (const ArvValue *) evaluator->priv->variable_values->data, value);
+		if (status != ARV_EVALUATOR_STATUS_SUCCESS)
+			arv_value_set_int64 (value, 0);
+	} else {
+		status = evaluate ((*program)->tokens, (*program)->n_tokens, evaluator->priv->variable_values,
+				   integer_mode, value);
+
+		if (++(*program)->n_evaluations == ARV_EVALUATOR_COMPILE_THRESHOLD)
+			compile_program (*program, integer_mode);
 	}
 
-	status = evaluate (evaluator->priv->rpn_stack, evaluator->priv->variables, NULL, &value);
+	if (status == ARV_EVALUATOR_STATUS_SUCCESS) {
+		if (arv_value_holds_int64 (value))
+			arv_debug_evaluator ("[Evaluator::evaluate] Result = (int64) %" G_GINT64_FORMAT,
+					     arv_value_get_int64 (value));
+		else
+			arv_debug_evaluator ("[Evaluator::evaluate] Result = (double) %g", arv_value_get_double (value));
+	}
+
+	return status;
+}
+
+double
+arv_evaluator_evaluate_as_double (ArvEvaluator *evaluator, GError **error)
+{
+	ArvEvaluatorStatus status;
+	ArvValue value;
+
+	g_return_val_if_fail (ARV_IS_EVALUATOR (evaluator), 0.0);
+
+	arv_debug_evaluator ("[Evaluator::evaluate_as_double] Expression = '%s'",
+			   evaluator->priv->expression);
+
+	status = evaluate_expression (evaluator, FALSE, &value);
 
 	if (status != ARV_EVALUATOR_STATUS_SUCCESS) {
 		arv_evaluator_set_error (error, status);
 		return 0.0;
 	}
 
-	return value;
+	return arv_value_get_double (&value);
 }
 
 gint64
 arv_evaluator_evaluate_as_int64 (ArvEvaluator *evaluator, GError **error)
 {
 	ArvEvaluatorStatus status;
-	gint64 value;
+	ArvValue value;
 
 	g_return_val_if_fail (ARV_IS_EVALUATOR (evaluator), 0.0);
 
 	arv_debug_evaluator ("[Evaluator::evaluate_as_int64] Expression = '%s'",
 			   evaluator->priv->expression);
 
-	if (evaluator->priv->parsing_status == ARV_EVALUATOR_STATUS_NOT_PARSED) {
-		evaluator->priv->parsing_status = parse_expression (evaluator);
-		arv_debug_evaluator ("[Evaluator::evaluate_as_int64] Parsing status = %d",
-				   evaluator->priv->parsing_status);
-	}
-
-	if (evaluator->priv->parsing_status != ARV_EVALUATOR_STATUS_SUCCESS) {
-		arv_evaluator_set_error (error, evaluator->priv->parsing_status);
-		return 0.0;
-	}
-
-	status = evaluate (evaluator->priv->rpn_stack, evaluator->priv->variables, &value, NULL);
+	status = evaluate_expression (evaluator, TRUE, &value);
 
 	if (status != ARV_EVALUATOR_STATUS_SUCCESS) {
-
 		arv_evaluator_set_error (error, status);
 		return 0.0;
 	}
 
-	return value;
+	return arv_value_get_int64 (&value);
 }
 
 void
@@ -1415,43 +1940,101 @@ arv_evaluator_get_constant (ArvEvaluator *evaluator, const char *name)
 	return g_hash_table_lookup (evaluator->priv->constants, name);
 }
 
+/**
+ * arv_evaluator_get_variable_slot:
+ * @evaluator: a #ArvEvaluator
+ * @name: variable name
+ *
+ * Retrieves the slot holding the value of the variable @name, creating it if needed. The slot stays valid for the
+ * life time of @evaluator, even when the expression changes, and allows to set the variable value without any name
+ * lookup.
+ *
+ * Returns: the variable slot, -1 on error.
+ *
+ * Since: 0.8.11
+ */
+
+gint
+arv_evaluator_get_variable_slot (ArvEvaluator *evaluator, const char *name)
+{
+	g_return_val_if_fail (ARV_IS_EVALUATOR (evaluator), -1);
+	g_return_val_if_fail (name != NULL, -1);
+
+	return _get_variable_slot (evaluator, name);
+}
+
+/**
+ * arv_evaluator_set_double_variable_by_slot:
+ * @evaluator: a #ArvEvaluator
+ * @slot: a variable slot, as returned by arv_evaluator_get_variable_slot()
+ * @v_double: new variable value
+ *
+ * Assigns a floating point value to the variable stored in @slot.
+ *
+ * Since: 0.8.11
+ */
+
 void
-arv_evaluator_set_double_variable (ArvEvaluator *evaluator, const char *name, double v_double)
+arv_evaluator_set_double_variable_by_slot (ArvEvaluator *evaluator, gint slot, double v_double)
 {
-	ArvValue *old_value;
+	ArvValue *value;
 
 	g_return_if_fail (ARV_IS_EVALUATOR (evaluator));
-	g_return_if_fail (name != NULL);
+	g_return_if_fail (slot >= 0 && slot < evaluator->priv->variable_values->len);
 
-	old_value = g_hash_table_lookup (evaluator->priv->variables, name);
-	if (old_value != NULL && (arv_value_get_double (old_value) == v_double))
+	value = &g_array_index (evaluator->priv->variable_values, ArvValue, slot);
+	if (value->type != G_TYPE_INVALID && (arv_value_get_double (value) == v_double))
 		return;
 
-	g_hash_table_insert (evaluator->priv->variables,
-			     g_strdup (name),
-			     arv_value_new_double (v_double));
+	arv_value_set_double (value, v_double);
 
-	arv_debug_evaluator ("[Evaluator::set_double_variable] %s = %g",
-			   name, v_double);
+	arv_debug_evaluator ("[Evaluator::set_double_variable] [%d] = %g", slot, v_double);
 }
 
+/**
+ * arv_evaluator_set_int64_variable_by_slot:
+ * @evaluator: a #ArvEvaluator
+ * @slot: a variable slot, as returned by arv_evaluator_get_variable_slot()
+ * @v_int64: new variable value
+ *
+ * Assigns an integer value to the variable stored in @slot.
+ *
+ * Since: 0.8.11
+ */
+
 void
-arv_evaluator_set_int64_variable (ArvEvaluator *evaluator, const char *name, gint64 v_int64)
+arv_evaluator_set_int64_variable_by_slot (ArvEvaluator *evaluator, gint slot, gint64 v_int64)
 {
-	ArvValue *old_value;
+	ArvValue *value;
 
 	g_return_if_fail (ARV_IS_EVALUATOR (evaluator));
-	g_return_if_fail (name != NULL);
+	g_return_if_fail (slot >= 0 && slot < evaluator->priv->variable_values->len);
 
-	old_value = g_hash_table_lookup (evaluator->priv->variables, name);
-	if (old_value != NULL && (arv_value_get_int64 (old_value) == v_int64))
+	value = &g_array_index (evaluator->priv->variable_values, ArvValue, slot);
+	if (value->type != G_TYPE_INVALID && (arv_value_get_int64 (value) == v_int64))
 		return;
 
-	g_hash_table_insert (evaluator->priv->variables,
-			     g_strdup (name),
-			     arv_value_new_int64 (v_int64));
+	arv_value_set_int64 (value, v_int64);
+
+	arv_debug_evaluator ("[Evaluator::set_int64_variable] [%d] = %" G_GINT64_FORMAT, slot, v_int64);
+}
+
+void
+arv_evaluator_set_double_variable (ArvEvaluator *evaluator, const char *name, double v_double)
+{
+	g_return_if_fail (ARV_IS_EVALUATOR (evaluator));
+	g_return_if_fail (name != NULL);
+
+	arv_evaluator_set_double_variable_by_slot (evaluator, _get_variable_slot (evaluator, name), v_double);
+}
+
+void
+arv_evaluator_set_int64_variable (ArvEvaluator *evaluator, const char *name, gint64 v_int64)
+{
+	g_return_if_fail (ARV_IS_EVALUATOR (evaluator));
+	g_return_if_fail (name != NULL);
 
-	arv_debug_evaluator ("[Evaluator::set_int64_variable] %s = %" G_GINT64_FORMAT, name, v_int64);
+	arv_evaluator_set_int64_variable_by_slot (evaluator, _get_variable_slot (evaluator, name), v_int64);
 }
 
 /**
@@ -1481,8 +2064,8 @@ arv_evaluator_init (ArvEvaluator *evaluator)
 	evaluator->priv = arv_evaluator_get_instance_private (evaluator);
 
 	evaluator->priv->expression = NULL;
-	evaluator->priv->rpn_stack = NULL;
-	evaluator->priv->variables = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) arv_value_free);
+	evaluator->priv->variable_slots = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+	evaluator->priv->variable_values = g_array_new (FALSE, TRUE, sizeof (ArvValue));
 	evaluator->priv->sub_expressions = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
 	evaluator->priv->constants = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
 
@@ -1496,10 +2079,11 @@ arv_evaluator_finalize (GObject *object)
 	ArvEvaluator *evaluator = ARV_EVALUATOR (object);
 
 	arv_evaluator_set_expression (evaluator, NULL);
-	g_hash_table_unref (evaluator->priv->variables);
+	g_hash_table_unref (evaluator->priv->variable_slots);
+	g_array_unref (evaluator->priv->variable_values);
 	g_hash_table_unref (evaluator->priv->sub_expressions);
 	g_hash_table_unref (evaluator->priv->constants);
-	free_rpn_stack (evaluator);
+	free_programs (evaluator);
 
 	G_OBJECT_CLASS (arv_evaluator_parent_class)->finalize (object);
 }
@@ -46,6 +46,10 @@ gint64		arv_evaluator_evaluate_as_int64		(ArvEvaluator *evaluator, GError **erro
 void		arv_evaluator_set_double_variable	(ArvEvaluator *evaluator, const char *name, double v_double);
 void		arv_evaluator_set_int64_variable	(ArvEvaluator *evaluator, const char *name, gint64 v_int64);
 
+gint		arv_evaluator_get_variable_slot			(ArvEvaluator *evaluator, const char *name);
+void		arv_evaluator_set_double_variable_by_slot	(ArvEvaluator *evaluator, gint slot, double v_double);
+void		arv_evaluator_set_int64_variable_by_slot	(ArvEvaluator *evaluator, gint slot, gint64 v_int64);
+
 G_END_DECLS
 
 #endif
@@ -0,0 +1,289 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2019 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel@gnome.org>
+ */
+
+/*< private >
+ * SECTION: arveventring
+ * @short_description: Lock-free binary event ring of the stream threads
+ *
+ * #ArvEventRing keeps the latest events of the stream reassembly (leaders, closed frames, resend requests, late or
+ * duplicated packets...) as fixed size binary records, for a post-mortem analysis of acquisition issues. Recording an
+ * event costs a few stores and an atomic increment, without any lock, formatting or system call, so unlike the
+ * stream-thread debug output, it doesn't change the timing of the acquisition.
+ *
+ * Each record carries a sequence number, written last, which lets the readers skip the records being overwritten
+ * during a snapshot. The snapshots are saved as a small header followed by the records, in host byte order, and
+ * decoded offline, for example by the events command of arv-tool.
+ */
+
+#include <arveventringprivate.h>
+#include <arvbuffer.h>
+#include <arvenumtypes.h>
+#include <arvenumtypesprivate.h>
+#include <gio/gio.h>
+#include <string.h>
+
+#define ARV_EVENT_RING_MAGIC		"ARVEVT01"
+
+typedef struct {
+	char magic[8];
+	guint32 record_size;
+	guint32 n_records;
+} ArvEventRingHeader;
+
+struct _ArvEventRing {
+	ArvEventRecord *records;
+	guint n_records;
+
+	/* Index of the next record, incremented by the producers */
+	guint index;
+};
+
+ArvEventRing *
+arv_event_ring_new (guint n_records)
+{
+	ArvEventRing *ring;
+	guint size = 1;
+
+	/* Power of two, for a cheap index wrap */
+	while (size < n_records && size < (1U << 24))
+		size <<= 1;
+
+	ring = g_new0 (ArvEventRing, 1);
+	ring->records = g_new0 (ArvEventRecord, size);
+	ring->n_records = size;
+
+	return ring;
+}
+
+void
+arv_event_ring_free (ArvEventRing *ring)
+{
+	if (ring == NULL)
+		return;
+
+	g_free (ring->records);
+	g_free (ring);
+}
+
+void
+arv_event_ring_record (ArvEventRing *ring, ArvEventRingEvent event, guint64 frame_id, guint32 packet_id, guint32 value)
+{
+	ArvEventRecord *record;
+	guint index;
+
+	if (ring == NULL)
+		return;
+
+	index = (guint) g_atomic_int_add ((gint *) &ring->index, 1);
+	record = &ring->records[index & (ring->n_records - 1)];
+
+	g_atomic_int_set ((gint *) &record->sequence, 0);
+
+	record->event = event;
+	record->time_us = g_get_monotonic_time ();
+	record->frame_id = frame_id;
+	record->packet_id = packet_id;
+	record->value = value;
+
+	g_atomic_int_set ((gint *) &record->sequence, index + 1);
+}
+
+/* Snapshot of the ring content, from the oldest to the latest record. Records being written are skipped. */
+
+ArvEventRecord *
+arv_event_ring_get_records (ArvEventRing *ring, guint *n_records)
+{
+	ArvEventRecord *records;
+	guint first, last;
+	guint index;
+	guint n = 0;
+
+	g_return_val_if_fail (ring != NULL, NULL);
+	g_return_val_if_fail (n_records != NULL, NULL);
+
+	last = (guint) g_atomic_int_get ((gint *) &ring->index);
+	first = last > ring->n_records ? last - ring->n_records : 0;
+
+	records = g_new (ArvEventRecord, last - first + 1);
+
+	for (index = first; index != last; index++) {
+		ArvEventRecord *record = &ring->records[index & (ring->n_records - 1)];
+		guint32 sequence;
+
+		sequence = (guint32) g_atomic_int_get ((gint *) &record->sequence);
+		if (sequence != index + 1)
+			continue;
+
+		records[n] = *record;
+
+		/* Overwritten during the copy */
+		if ((guint32) g_atomic_int_get ((gint *) &record->sequence) != sequence)
+			continue;
+
+		records[n].sequence = sequence;
+		n++;
+	}
+
+	*n_records = n;
+
+	return records;
+}
+
+gboolean
+arv_event_ring_save (ArvEventRing *ring, const char *filename, GError **error)
+{
+	ArvEventRingHeader header;
+	ArvEventRecord *records;
+	GByteArray *data;
+	guint n_records;
+	gboolean success;
+
+	g_return_val_if_fail (ring != NULL, FALSE);
+	g_return_val_if_fail (filename != NULL, FALSE);
+
+	records = arv_event_ring_get_records (ring, &n_records);
+
+	memset (&header, 0, sizeof (header));
+	memcpy (header.magic, ARV_EVENT_RING_MAGIC, sizeof (header.magic));
+	header.record_size = sizeof (ArvEventRecord);
+	header.n_records = n_records;
+
+	data = g_byte_array_sized_new (sizeof (header) + n_records * sizeof (ArvEventRecord));
+	g_byte_array_append (data, (guint8 *) &header, sizeof (header));
+	g_byte_array_append (data, (guint8 *) records, n_records * sizeof (ArvEventRecord));
+	g_free (records);
+
+	success = g_file_set_contents (filename, (char *) data->data, data->len, error);
+
+	g_byte_array_unref (data);
+
+	return success;
+}
+
+ArvEventRecord *
+arv_event_ring_load (const char *filename, guint *n_records, GError **error)
+{
+	const ArvEventRingHeader *header;
+	ArvEventRecord *records;
+	char *contents;
+	gsize size;
+
+	g_return_val_if_fail (filename != NULL, NULL);
+	g_return_val_if_fail (n_records != NULL, NULL);
+
+	*n_records = 0;
+
+	if (!g_file_get_contents (filename, &contents, &size, error))
+		return NULL;
+
+	header = (const ArvEventRingHeader *) contents;
+	if (size < sizeof (ArvEventRingHeader) ||
+	    memcmp (header->magic, ARV_EVENT_RING_MAGIC, sizeof (header->magic)) != 0 ||
+	    header->record_size != sizeof (ArvEventRecord) ||
+	    (size - sizeof (ArvEventRingHeader)) / sizeof (ArvEventRecord) < header->n_records) {
+		g_set_error (error, G_IO_ERROR, G_IO_ERROR_FAILED, "Invalid event ring dump '%s'", filename);
+		g_free (contents);
+		return NULL;
+	}
+
+	*n_records = header->n_records;
+	records = g_new (ArvEventRecord, MAX (header->n_records, 1));
+	memcpy (records, contents + sizeof (ArvEventRingHeader), header->n_records * sizeof (ArvEventRecord));
+
+	g_free (contents);
+
+	return records;
+}
+
+static const char *
+_enum_to_string (GType type, guint enum_value)
+{
+	GEnumClass *enum_class;
+	GEnumValue *value;
+	const char *retval = NULL;
+
+	enum_class = g_type_class_ref (type);
+
+	value = g_enum_get_value (enum_class, enum_value);
+	if (value)
+		retval = value->value_nick;
+
+	g_type_class_unref (enum_class);
+
+	return retval;
+}
+
+const char *
+arv_event_ring_event_to_string (ArvEventRingEvent event)
+{
+	const char *string;
+
+	string = _enum_to_string (ARV_TYPE_EVENT_RING_EVENT, event);
+
+	return string != NULL ? string : "unknown";
+}
+
+/* One line per record, with the time relative to the first record */
+
+char *
+arv_event_ring_records_to_string (const ArvEventRecord *records, guint n_records)
+{
+	GString *string;
+	guint i;
+
+	string = g_string_new ("");
+
+	for (i = 0; i < n_records; i++) {
+		const ArvEventRecord *record = &records[i];
+
+		g_string_append_printf (string, "%10u %12" G_GINT64_FORMAT " µs %-18s frame %-10" G_GUINT64_FORMAT
+					" packet %-6u",
+					record->sequence, (gint64) (record->time_us - records[0].time_us),
+					arv_event_ring_event_to_string (record->event),
+					record->frame_id, record->packet_id);
+
+		switch (record->event) {
+			case ARV_EVENT_RING_EVENT_FRAME_CLOSED:
+				{
+					const char *status;
+
+					status = _enum_to_string (ARV_TYPE_BUFFER_STATUS, record->value);
+					g_string_append_printf (string, " %s", status != NULL ? status : "unknown");
+				}
+				break;
+			case ARV_EVENT_RING_EVENT_MISSED_FRAMES:
+			case ARV_EVENT_RING_EVENT_RESEND_REQUEST:
+				g_string_append_printf (string, " count %u", record->value);
+				break;
+			case ARV_EVENT_RING_EVENT_ERROR_PACKET:
+			case ARV_EVENT_RING_EVENT_TRANSFER_ERROR:
+				g_string_append_printf (string, " status %u", record->value);
+				break;
+			default:
+				break;
+		}
+
+		g_string_append_c (string, '\n');
+	}
+
+	return g_string_free (string, FALSE);
+}
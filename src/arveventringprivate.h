@@ -0,0 +1,84 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2019 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel@gnome.org>
+ */
+
+#ifndef ARV_EVENT_RING_PRIVATE_H
+#define ARV_EVENT_RING_PRIVATE_H
+
+#if !defined (ARV_H_INSIDE) && !defined (ARAVIS_COMPILATION)
+#error "Only <arv.h> can be included directly."
+#endif
+
+#include <arvtypes.h>
+
+G_BEGIN_DECLS
+
+/* Number of records kept by the event ring of a stream */
+#define ARV_EVENT_RING_N_RECORDS_DEFAULT	4096
+
+typedef enum {
+	ARV_EVENT_RING_EVENT_NONE,
+	ARV_EVENT_RING_EVENT_LEADER,
+	ARV_EVENT_RING_EVENT_FRAME_CLOSED,
+	ARV_EVENT_RING_EVENT_FRAME_FLUSHED,
+	ARV_EVENT_RING_EVENT_MISSED_FRAMES,
+	ARV_EVENT_RING_EVENT_LATE_FRAME,
+	ARV_EVENT_RING_EVENT_LATE_PACKET,
+	ARV_EVENT_RING_EVENT_RESEND_REQUEST,
+	ARV_EVENT_RING_EVENT_RESENT_PACKET,
+	ARV_EVENT_RING_EVENT_DUPLICATED_PACKET,
+	ARV_EVENT_RING_EVENT_ERROR_PACKET,
+	ARV_EVENT_RING_EVENT_UNDERRUN,
+	ARV_EVENT_RING_EVENT_MISSING_TRAILER,
+	ARV_EVENT_RING_EVENT_TRANSFER_ERROR,
+	ARV_EVENT_RING_EVENT_N_ELEMENTS
+} ArvEventRingEvent;
+
+/* Fixed size record, in host byte order in the dump files. The sequence is the record index plus one, and is 0 while
+ * the record is being written. */
+
+typedef struct {
+	guint32 sequence;
+	guint16 event;
+	guint16 reserved;
+	guint64 time_us;
+	guint64 frame_id;
+	guint32 packet_id;
+	guint32 value;
+} ArvEventRecord;
+
+typedef struct _ArvEventRing ArvEventRing;
+
+ArvEventRing *	arv_event_ring_new		(guint n_records);
+void		arv_event_ring_free		(ArvEventRing *ring);
+
+void		arv_event_ring_record		(ArvEventRing *ring, ArvEventRingEvent event,
+						 guint64 frame_id, guint32 packet_id, guint32 value);
+ArvEventRecord *arv_event_ring_get_records	(ArvEventRing *ring, guint *n_records);
+gboolean	arv_event_ring_save		(ArvEventRing *ring, const char *filename, GError **error);
+
+ArvEventRecord *arv_event_ring_load		(const char *filename, guint *n_records, GError **error);
+const char *	arv_event_ring_event_to_string	(ArvEventRingEvent event);
+char *		arv_event_ring_records_to_string	(const ArvEventRecord *records, guint n_records);
+
+G_END_DECLS
+
+#endif
@@ -36,7 +36,7 @@
 #include <arvgcregisternode.h>
 #include <arvgvcpprivate.h>
 #include <arvbufferprivate.h>
-#include <arvdebug.h>
+#include <arvdebugprivate.h>
 #include <arvmisc.h>
 #include <string.h>
 #include <math.h>
@@ -77,6 +77,17 @@ typedef struct {
 
 	ArvFakeCameraFillPattern fill_pattern_callback;
 	void *fill_pattern_data;
+
+	ArvFakeCameraFillMode fill_mode;
+
+	/* Frames rendered for the template fill mode, valid for the image settings below */
+	ArvBuffer *templates[ARV_FAKE_CAMERA_N_TEMPLATES];
+	guint32 template_width;
+	guint32 template_height;
+	guint32 template_exposure_time_us;
+	guint32 template_gain;
+	guint32 template_pixel_format;
+	size_t template_payload;
 } ArvFakeCameraPrivate;
 
 struct _ArvFakeCamera {
@@ -93,10 +104,30 @@ G_DEFINE_TYPE_WITH_CODE (ArvFakeCamera, arv_fake_camera, G_TYPE_OBJECT, G_ADD_PR
 
 /* ArvFakeCamera implementation */
 
+/* Returns the offset of the storage of the user output value register, for the output picked by the user output
+ * selector register, or 0 if the access doesn't cover the value register. */
+
+static guint32
+_get_user_output_value_address (ArvFakeCamera *camera, guint32 address, guint32 size)
+{
+	guint32 selector;
+
+	if (address > ARV_FAKE_CAMERA_REGISTER_USER_OUTPUT_VALUE ||
+	    address + size < ARV_FAKE_CAMERA_REGISTER_USER_OUTPUT_VALUE + sizeof (guint32))
+		return 0;
+
+	selector = GUINT32_FROM_BE (*((guint32 *) (((char *) camera->priv->memory) +
+						  ARV_FAKE_CAMERA_REGISTER_USER_OUTPUT_SELECTOR)));
+
+	return ARV_FAKE_CAMERA_REGISTER_USER_OUTPUT_VALUES +
+		sizeof (guint32) * MIN (selector, ARV_FAKE_CAMERA_N_USER_OUTPUTS - 1);
+}
+
 gboolean
 arv_fake_camera_read_memory (ArvFakeCamera *camera, guint32 address, guint32 size, void *buffer)
 {
 	guint32 read_size;
+	guint32 value_address;
 
 	g_return_val_if_fail (ARV_IS_FAKE_CAMERA (camera), FALSE);
 	g_return_val_if_fail (buffer != NULL, FALSE);
@@ -107,6 +138,11 @@ arv_fake_camera_read_memory (ArvFakeCamera *camera, guint32 address, guint32 siz
 
 		memcpy (buffer, ((char *) camera->priv->memory) + address, read_size);
 
+		value_address = _get_user_output_value_address (camera, address, read_size);
+		if (value_address != 0)
+			memcpy (((char *) buffer) + ARV_FAKE_CAMERA_REGISTER_USER_OUTPUT_VALUE - address,
+				((char *) camera->priv->memory) + value_address, sizeof (guint32));
+
 		if (read_size == size)
 			return TRUE;
 
@@ -128,6 +164,9 @@ arv_fake_camera_read_memory (ArvFakeCamera *camera, guint32 address, guint32 siz
 gboolean
 arv_fake_camera_write_memory (ArvFakeCamera *camera, guint32 address, guint32 size, const void *buffer)
 {
+	guint32 value_address;
+	guint32 value = 0;
+
 	g_return_val_if_fail (ARV_IS_FAKE_CAMERA (camera), FALSE);
 	g_return_val_if_fail (address + size < ARV_FAKE_CAMERA_MEMORY_SIZE + camera->priv->genicam_xml_size, FALSE);
 	g_return_val_if_fail (buffer != NULL, FALSE);
@@ -137,8 +176,19 @@ arv_fake_camera_write_memory (ArvFakeCamera *camera, guint32 address, guint32 si
 	if (address + size > ARV_FAKE_CAMERA_MEMORY_SIZE)
 		return FALSE;
 
+	/* The user output value goes to the storage of the selected output, the raw register keeps its value */
+	value_address = _get_user_output_value_address (camera, address, size);
+	if (value_address != 0)
+		value = *((guint32 *) (((char *) camera->priv->memory) + ARV_FAKE_CAMERA_REGISTER_USER_OUTPUT_VALUE));
+
 	memcpy (((char *) camera->priv->memory) + address, buffer, size);
 
+	if (value_address != 0) {
+		memcpy (((char *) camera->priv->memory) + value_address,
+			((const char *) buffer) + ARV_FAKE_CAMERA_REGISTER_USER_OUTPUT_VALUE - address, sizeof (guint32));
+		*((guint32 *) (((char *) camera->priv->memory) + ARV_FAKE_CAMERA_REGISTER_USER_OUTPUT_VALUE)) = value;
+	}
+
 	return TRUE;
 }
 
@@ -559,6 +609,32 @@ arv_fake_camera_diagonal_ramp (ArvBuffer *buffer, void *fill_pattern_data,
 			}
 			break;
 
+		case ARV_PIXEL_FORMAT_MONO_12P:
+			if ((height * width) % 2 == 0 && 3 * height * width / 2 <= buffer->priv->size) {
+				guint32 i;
+
+				for (i = 0; i < height * width; i += 2) {
+					unsigned char *pixel = &buffer->priv->data [3 * i / 2];
+					guint16 values[2];
+					unsigned int j;
+
+					for (j = 0; j < 2; j++) {
+						x = (i + j) % width;
+						y = (i + j) / width;
+
+						pixel_value = (16 * x + 16 * buffer->priv->frame_id + 16 * y) % 4095;
+						pixel_value *= scale;
+
+						values[j] = CLAMP (pixel_value, 0, 4095);
+					}
+
+					pixel[0] = values[0] & 0xff;
+					pixel[1] = (values[0] >> 8) | ((values[1] & 0x0f) << 4);
+					pixel[2] = values[1] >> 4;
+				}
+			}
+			break;
+
 		case ARV_PIXEL_FORMAT_BAYER_BG_8:
 			if (height * width <= buffer->priv->size) {
 				for (y = 0; y < height; y++) {
@@ -705,6 +781,67 @@ arv_fake_camera_diagonal_ramp (ArvBuffer *buffer, void *fill_pattern_data,
 	}
 }
 
+static void
+_clear_templates (ArvFakeCamera *camera)
+{
+	unsigned int i;
+
+	for (i = 0; i < ARV_FAKE_CAMERA_N_TEMPLATES; i++)
+		g_clear_object (&camera->priv->templates[i]);
+}
+
+/* Copies into @buffer one of the template frames, which are rendered again if the image settings changed. Must be
+ * called with fill_pattern_mutex locked. */
+
+static void
+_fill_from_template (ArvFakeCamera *camera, ArvBuffer *buffer, size_t payload,
+		     guint32 exposure_time_us, guint32 gain, guint32 pixel_format)
+{
+	ArvBuffer *template;
+	unsigned int i;
+
+	if (camera->priv->templates[0] == NULL ||
+	    camera->priv->template_width != buffer->priv->width ||
+	    camera->priv->template_height != buffer->priv->height ||
+	    camera->priv->template_exposure_time_us != exposure_time_us ||
+	    camera->priv->template_gain != gain ||
+	    camera->priv->template_pixel_format != pixel_format ||
+	    camera->priv->template_payload != payload) {
+		arv_debug_misc ("[FakeCamera::fill_from_template] Render %d templates of %ux%u",
+				ARV_FAKE_CAMERA_N_TEMPLATES, buffer->priv->width, buffer->priv->height);
+
+		_clear_templates (camera);
+
+		for (i = 0; i < ARV_FAKE_CAMERA_N_TEMPLATES; i++) {
+			template = arv_buffer_new (payload, NULL);
+
+			template->priv->payload_type = buffer->priv->payload_type;
+			template->priv->width = buffer->priv->width;
+			template->priv->height = buffer->priv->height;
+			template->priv->x_offset = buffer->priv->x_offset;
+			template->priv->y_offset = buffer->priv->y_offset;
+			template->priv->pixel_format = buffer->priv->pixel_format;
+			template->priv->frame_id = i;
+
+			camera->priv->fill_pattern_callback (template, camera->priv->fill_pattern_data,
+							     exposure_time_us, gain, pixel_format);
+
+			camera->priv->templates[i] = template;
+		}
+
+		camera->priv->template_width = buffer->priv->width;
+		camera->priv->template_height = buffer->priv->height;
+		camera->priv->template_exposure_time_us = exposure_time_us;
+		camera->priv->template_gain = gain;
+		camera->priv->template_pixel_format = pixel_format;
+		camera->priv->template_payload = payload;
+	}
+
+	template = camera->priv->templates[buffer->priv->frame_id % ARV_FAKE_CAMERA_N_TEMPLATES];
+
+	memcpy (buffer->priv->data, template->priv->data, payload);
+}
+
 /**
  * arv_fake_camera_set_fill_pattern:
  * @camera: a #ArvFakeCamera
@@ -731,9 +868,56 @@ arv_fake_camera_set_fill_pattern (ArvFakeCamera *camera,
 		camera->priv->fill_pattern_data = NULL;
 	}
 
+	_clear_templates (camera);
+
 	g_mutex_unlock (&camera->priv->fill_pattern_mutex);
 }
 
+/**
+ * arv_fake_camera_set_fill_mode:
+ * @camera: a #ArvFakeCamera
+ * @fill_mode: a #ArvFakeCameraFillMode
+ *
+ * Sets how the buffers are filled. By default, the fill pattern is computed for each frame, which limits the
+ * throughput of the fake camera. In template mode, %ARV_FAKE_CAMERA_N_TEMPLATES frames are rendered once by the
+ * fill pattern for each image setting, and copied in turn into the buffers. Only the frame id and the timestamps
+ * change between frames with the same content. The constant mode doesn't touch the image data, for the measure of
+ * the transport throughput.
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_fake_camera_set_fill_mode (ArvFakeCamera *camera, ArvFakeCameraFillMode fill_mode)
+{
+	g_return_if_fail (ARV_IS_FAKE_CAMERA (camera));
+
+	g_mutex_lock (&camera->priv->fill_pattern_mutex);
+
+	camera->priv->fill_mode = fill_mode;
+
+	_clear_templates (camera);
+
+	g_mutex_unlock (&camera->priv->fill_pattern_mutex);
+}
+
+/**
+ * arv_fake_camera_get_fill_mode:
+ * @camera: a #ArvFakeCamera
+ *
+ * Returns: the current #ArvFakeCameraFillMode.
+ *
+ * Since: 0.8.11
+ */
+
+ArvFakeCameraFillMode
+arv_fake_camera_get_fill_mode (ArvFakeCamera *camera)
+{
+	g_return_val_if_fail (ARV_IS_FAKE_CAMERA (camera), ARV_FAKE_CAMERA_FILL_MODE_PATTERN);
+
+	return camera->priv->fill_mode;
+}
+
 /**
  * arv_fake_camera_fill_buffer:
  * @camera: a #ArvFakeCamera
@@ -772,6 +956,8 @@ arv_fake_camera_fill_buffer (ArvFakeCamera *camera, ArvBuffer *buffer, guint32 *
 
 	buffer->priv->payload_type = ARV_BUFFER_PAYLOAD_TYPE_IMAGE;
 	buffer->priv->chunk_endianness = G_BIG_ENDIAN;
+	buffer->priv->has_chunk_index = FALSE;
+	buffer->priv->has_checksum = FALSE;
 	buffer->priv->width = width;
 	buffer->priv->height = height;
         buffer->priv->x_offset = _get_register (camera, ARV_FAKE_CAMERA_REGISTER_X_OFFSET);
@@ -779,6 +965,7 @@ arv_fake_camera_fill_buffer (ArvFakeCamera *camera, ArvBuffer *buffer, guint32 *
 	buffer->priv->status = ARV_BUFFER_STATUS_SUCCESS;
 	buffer->priv->timestamp_ns = g_get_real_time () * 1000;
 	buffer->priv->system_timestamp_ns = buffer->priv->timestamp_ns;
+	buffer->priv->host_timestamp_ns = g_get_monotonic_time () * 1000;
 	buffer->priv->frame_id = camera->priv->frame_id;
 	buffer->priv->pixel_format = _get_register (camera, ARV_FAKE_CAMERA_REGISTER_PIXEL_FORMAT);
 
@@ -787,8 +974,17 @@ arv_fake_camera_fill_buffer (ArvFakeCamera *camera, ArvBuffer *buffer, guint32 *
 	arv_fake_camera_read_register (camera, ARV_FAKE_CAMERA_REGISTER_EXPOSURE_TIME_US, &exposure_time_us);
 	arv_fake_camera_read_register (camera, ARV_FAKE_CAMERA_REGISTER_GAIN_RAW, &gain);
 	arv_fake_camera_read_register (camera, ARV_FAKE_CAMERA_REGISTER_PIXEL_FORMAT, &pixel_format);
-	camera->priv->fill_pattern_callback (buffer, camera->priv->fill_pattern_data,
-					     exposure_time_us, gain, pixel_format);
+	switch (camera->priv->fill_mode) {
+		case ARV_FAKE_CAMERA_FILL_MODE_TEMPLATE:
+			_fill_from_template (camera, buffer, payload, exposure_time_us, gain, pixel_format);
+			break;
+		case ARV_FAKE_CAMERA_FILL_MODE_CONSTANT:
+			break;
+		default:
+			camera->priv->fill_pattern_callback (buffer, camera->priv->fill_pattern_data,
+							     exposure_time_us, gain, pixel_format);
+			break;
+	}
 
 	g_mutex_unlock (&camera->priv->fill_pattern_mutex);
 
@@ -1038,6 +1234,7 @@ arv_fake_camera_finalize (GObject *object)
 {
 	ArvFakeCamera *fake_camera = ARV_FAKE_CAMERA (object);
 
+	_clear_templates (fake_camera);
 	g_mutex_clear (&fake_camera->priv->fill_pattern_mutex);
 	g_clear_pointer (&fake_camera->priv->memory, g_free);
 	g_clear_pointer (&fake_camera->priv->genicam_xml, g_free);
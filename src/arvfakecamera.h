@@ -84,6 +84,19 @@ void arv_set_fake_camera_genicam_filename (const char *filename);
 #define ARV_FAKE_CAMERA_REGISTER_GAIN_RAW		0x110
 #define ARV_FAKE_CAMERA_REGISTER_GAIN_MODE		0x114
 
+/* LUT control */
+
+#define ARV_FAKE_CAMERA_REGISTER_LUT_VALUE		0x1000
+#define ARV_FAKE_CAMERA_LUT_SIZE			256
+
+/* Digital IO control. The user output value register is shared by the user outputs, selected by the user output
+ * selector register, the values being stored from ARV_FAKE_CAMERA_REGISTER_USER_OUTPUT_VALUES. */
+
+#define ARV_FAKE_CAMERA_REGISTER_USER_OUTPUT_SELECTOR	0x400
+#define ARV_FAKE_CAMERA_REGISTER_USER_OUTPUT_VALUE	0x404
+#define ARV_FAKE_CAMERA_REGISTER_USER_OUTPUT_VALUES	0x410
+#define ARV_FAKE_CAMERA_N_USER_OUTPUTS			3
+
 #define ARV_TYPE_FAKE_CAMERA             (arv_fake_camera_get_type ())
 G_DECLARE_FINAL_TYPE (ArvFakeCamera, arv_fake_camera, ARV, FAKE_CAMERA, GObject)
 
@@ -91,6 +104,23 @@ typedef void (*ArvFakeCameraFillPattern) (ArvBuffer *buffer, void *fill_pattern_
 					  guint32 exposure_time_us, guint32 gain,
 					  ArvPixelFormat pixel_format);
 
+/**
+ * ArvFakeCameraFillMode:
+ * @ARV_FAKE_CAMERA_FILL_MODE_PATTERN: the fill pattern is computed for each frame
+ * @ARV_FAKE_CAMERA_FILL_MODE_TEMPLATE: a set of frames is computed once, and copied in turn into the buffers
+ * @ARV_FAKE_CAMERA_FILL_MODE_CONSTANT: the buffer data are left untouched
+ *
+ * Since: 0.8.11
+ */
+
+typedef enum {
+	ARV_FAKE_CAMERA_FILL_MODE_PATTERN,
+	ARV_FAKE_CAMERA_FILL_MODE_TEMPLATE,
+	ARV_FAKE_CAMERA_FILL_MODE_CONSTANT
+} ArvFakeCameraFillMode;
+
+#define ARV_FAKE_CAMERA_N_TEMPLATES			16
+
 ArvFakeCamera * arv_fake_camera_new 		(const char *serial_number);
 ArvFakeCamera * arv_fake_camera_new_full 	(const char *serial_number, const char *genicam_filename);
 gboolean	arv_fake_camera_read_memory 	(ArvFakeCamera *camera, guint32 address, guint32 size, void *buffer);
@@ -116,6 +146,8 @@ guint32		arv_fake_camera_get_heartbeat_timeout		(ArvFakeCamera *camera);
 void		arv_fake_camera_set_fill_pattern	(ArvFakeCamera *camera,
 							 ArvFakeCameraFillPattern fill_pattern_callback,
 							 void *fill_pattern_data);
+void		arv_fake_camera_set_fill_mode		(ArvFakeCamera *camera, ArvFakeCameraFillMode fill_mode);
+ArvFakeCameraFillMode	arv_fake_camera_get_fill_mode	(ArvFakeCamera *camera);
 void 		arv_fake_camera_set_trigger_frequency 	(ArvFakeCamera *camera, double frequency);
 
 const char *	arv_fake_camera_get_genicam_xml 	(ArvFakeCamera *camera, size_t *size);
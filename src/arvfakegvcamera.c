@@ -37,18 +37,60 @@ static char *arv_option_interface_name = NULL;
 static char *arv_option_serial_number = NULL;
 static char *arv_option_genicam_file = NULL;
 static double arv_option_gvsp_lost_ratio = 0.0;
+static int arv_option_gvsp_lost_burst_length = 1;
+static int arv_option_gvsp_reorder_window = 0;
+static double arv_option_gvsp_duplicate_ratio = 0.0;
+static double arv_option_gvsp_error_ratio = 0.0;
+static int arv_option_gvsp_trailer_delay = 0;
+static int arv_option_gvsp_seed = 0;
+static int arv_option_frame_history = 4;
+static char *arv_option_address = NULL;
+static int arv_option_n_cameras = 1;
+static int arv_option_n_farm_threads = 0;
+static char *arv_option_fill_mode = NULL;
+static gboolean arv_option_traffic_generator = FALSE;
+static gboolean arv_option_udp_gso = FALSE;
+static int arv_option_n_stream_channels = 1;
 static char *arv_option_debug_domains = NULL;
 
 static const GOptionEntry arv_option_entries[] =
 {
 	{ "interface",		'i', 0, G_OPTION_ARG_STRING,
 		&arv_option_interface_name,	"Listening interface name", "interface_id"},
+	{ "address",            'a', 0, G_OPTION_ARG_STRING,
+		&arv_option_address,		"Camera address, or first camera address of a farm", "address"},
+	{ "n-cameras",          'n', 0, G_OPTION_ARG_INT,
+		&arv_option_n_cameras,		"Number of cameras", "n_cameras"},
+	{ "farm-threads",       0, 0, G_OPTION_ARG_INT,
+		&arv_option_n_farm_threads,	"Number of threads servicing the cameras of a farm", "n_threads"},
 	{ "serial",             's', 0, G_OPTION_ARG_STRING,
 	        &arv_option_serial_number, 	"Fake camera serial number", "serial_nbr"},
 	{ "genicam",            'g', 0, G_OPTION_ARG_STRING,
 	        &arv_option_genicam_file, 	"XML Genicam file to use", "genicam_filename"},
 	{ "gvsp-lost-ratio",    'r', 0, G_OPTION_ARG_DOUBLE,
 	        &arv_option_gvsp_lost_ratio,	"GVSP lost packet ratio", "packet_per_thousand"},
+	{ "gvsp-lost-burst",    0, 0, G_OPTION_ARG_INT,
+	        &arv_option_gvsp_lost_burst_length,	"Number of consecutive lost GVSP packets", "n_packets"},
+	{ "gvsp-reorder-window", 0, 0, G_OPTION_ARG_INT,
+	        &arv_option_gvsp_reorder_window,	"GVSP packet reordering window", "n_packets"},
+	{ "gvsp-duplicate-ratio", 0, 0, G_OPTION_ARG_DOUBLE,
+	        &arv_option_gvsp_duplicate_ratio,	"GVSP duplicated packet ratio", "packet_per_thousand"},
+	{ "gvsp-error-ratio",   0, 0, G_OPTION_ARG_DOUBLE,
+	        &arv_option_gvsp_error_ratio,	"GVSP error packet ratio", "packet_per_thousand"},
+	{ "gvsp-trailer-delay", 0, 0, G_OPTION_ARG_INT,
+	        &arv_option_gvsp_trailer_delay,	"GVSP trailer delay", "µs"},
+	{ "gvsp-seed",          0, 0, G_OPTION_ARG_INT,
+	        &arv_option_gvsp_seed,		"Seed of the GVSP impairments", "seed"},
+	{ "frame-history",      0, 0, G_OPTION_ARG_INT,
+	        &arv_option_frame_history,	"Number of frames retained for packet resend", "n_frames"},
+	{ "fill-mode",          'f', 0, G_OPTION_ARG_STRING,
+	        &arv_option_fill_mode,		"Image fill mode", "{pattern|template|constant}"},
+	{ "traffic-generator",  't', 0, G_OPTION_ARG_NONE,
+	        &arv_option_traffic_generator,	"High rate traffic generator mode", NULL},
+	{ "udp-gso",            0, 0, G_OPTION_ARG_NONE,
+	        &arv_option_udp_gso,		"Use UDP generic segmentation offload in generator mode", NULL},
+	{ "stream-channels",    0, 0, G_OPTION_ARG_INT,
+	        &arv_option_n_stream_channels,	"Number of stream channels", "n_channels"},
 	{
 		"debug", 			'd', 0, G_OPTION_ARG_STRING,
 		&arv_option_debug_domains, 	NULL,
@@ -66,14 +108,45 @@ description_content[] =
 "Examples:\n"
 "\n"
 "arv-fake-gv-camera-" ARAVIS_API_VERSION " -i eth0\n"
-"arv-fake-gv-camera-" ARAVIS_API_VERSION " -s GV02 -d all\n";
+"arv-fake-gv-camera-" ARAVIS_API_VERSION " -s GV02 -d all\n"
+"arv-fake-gv-camera-" ARAVIS_API_VERSION " -i eth0 -f template\n"
+"arv-fake-gv-camera-" ARAVIS_API_VERSION " -i eth0 -f constant -t --udp-gso\n"
+"arv-fake-gv-camera-" ARAVIS_API_VERSION " -i eth0 -r 10 --gvsp-lost-burst 4 --gvsp-reorder-window 8 --gvsp-seed 42\n"
+"arv-fake-gv-camera-" ARAVIS_API_VERSION " -i lo -a 127.0.1.1 -n 32 --farm-threads 4\n"
+"\n"
+"The cameras of a farm use consecutive addresses, and serial numbers made of the\n"
+"GVF prefix followed by the camera index. Their frame history and impairment\n"
+"seed are the default ones.\n";
+
+static void
+_configure_camera (ArvGvFakeCamera *gv_camera, ArvFakeCameraFillMode fill_mode)
+{
+	g_object_set (gv_camera,
+		      "gvsp-lost-ratio", CLAMP (arv_option_gvsp_lost_ratio / 1000.0, 0.0, 1.0),
+		      "gvsp-lost-burst-length", (guint) CLAMP (arv_option_gvsp_lost_burst_length, 1, G_MAXUINT16),
+		      "gvsp-reorder-window", (guint) CLAMP (arv_option_gvsp_reorder_window, 0,
+								      ARV_GV_FAKE_CAMERA_REORDER_WINDOW_MAX),
+		      "gvsp-duplicate-ratio", CLAMP (arv_option_gvsp_duplicate_ratio / 1000.0, 0.0, 1.0),
+		      "gvsp-error-ratio", CLAMP (arv_option_gvsp_error_ratio / 1000.0, 0.0, 1.0),
+		      "gvsp-trailer-delay", (guint) CLAMP (arv_option_gvsp_trailer_delay, 0, G_USEC_PER_SEC),
+		      "traffic-generator", arv_option_traffic_generator,
+		      "udp-gso", arv_option_udp_gso,
+		      "n-stream-channels", CLAMP (arv_option_n_stream_channels, 1, ARV_GV_FAKE_CAMERA_N_STREAM_CHANNELS_MAX),
+		      NULL);
+
+	if (arv_gv_fake_camera_is_running (gv_camera))
+		arv_fake_camera_set_fill_mode (arv_gv_fake_camera_get_fake_camera (gv_camera), fill_mode);
+}
 
 int
 main (int argc, char **argv)
 {
-	ArvGvFakeCamera *gv_camera;
+	ArvGvFakeCamera *gv_camera = NULL;
+	ArvGvFakeCameraFarm *farm = NULL;
+	ArvFakeCameraFillMode fill_mode = ARV_FAKE_CAMERA_FILL_MODE_PATTERN;
 	GOptionContext *context;
 	GError *error = NULL;
+	gboolean is_running;
 
 	context = g_option_context_new (NULL);
 	g_option_context_set_summary (context, "Fake GigEVision camera.");
@@ -97,19 +170,54 @@ main (int argc, char **argv)
 		return EXIT_FAILURE;
 	}
 
-	gv_camera = arv_gv_fake_camera_new_full (arv_option_interface_name, arv_option_serial_number, arv_option_genicam_file);
+	if (arv_option_fill_mode != NULL) {
+		if (g_strcmp0 (arv_option_fill_mode, "template") == 0)
+			fill_mode = ARV_FAKE_CAMERA_FILL_MODE_TEMPLATE;
+		else if (g_strcmp0 (arv_option_fill_mode, "constant") == 0)
+			fill_mode = ARV_FAKE_CAMERA_FILL_MODE_CONSTANT;
+		else if (g_strcmp0 (arv_option_fill_mode, "pattern") != 0) {
+			printf ("Invalid fill mode '%s'\n", arv_option_fill_mode);
+			return EXIT_FAILURE;
+		}
+	}
 
-	g_object_set (gv_camera, "gvsp-lost-ratio", arv_option_gvsp_lost_ratio / 1000.0, NULL);
+	if (arv_option_n_cameras > 1) {
+		guint i;
+
+		farm = arv_gv_fake_camera_farm_new (arv_option_interface_name, arv_option_address,
+						    MIN (arv_option_n_cameras, ARV_GV_FAKE_CAMERA_FARM_N_CAMERAS_MAX),
+						    MAX (arv_option_n_farm_threads, 0));
+		is_running = arv_gv_fake_camera_farm_is_running (farm);
+
+		for (i = 0; i < arv_gv_fake_camera_farm_get_n_cameras (farm); i++)
+			_configure_camera (arv_gv_fake_camera_farm_get_camera (farm, i), fill_mode);
+	} else {
+		gv_camera = g_object_new (ARV_TYPE_GV_FAKE_CAMERA,
+					  "interface-name", arv_option_interface_name != NULL ?
+					  arv_option_interface_name : ARV_GV_FAKE_CAMERA_DEFAULT_INTERFACE,
+					  "serial-number", arv_option_serial_number != NULL ?
+					  arv_option_serial_number : ARV_GV_FAKE_CAMERA_DEFAULT_SERIAL_NUMBER,
+					  "genicam-filename", arv_option_genicam_file,
+					  "address", arv_option_address,
+					  "gvsp-seed", (guint) arv_option_gvsp_seed,
+					  "frame-history", (guint) CLAMP (arv_option_frame_history, 0,
+									  ARV_GV_FAKE_CAMERA_FRAME_HISTORY_MAX),
+					  NULL);
+		is_running = arv_gv_fake_camera_is_running (gv_camera);
+
+		_configure_camera (gv_camera, fill_mode);
+	}
 
 	signal (SIGINT, set_cancel);
 
-	if (arv_gv_fake_camera_is_running (gv_camera))
+	if (is_running)
 		while (!cancel)
 			g_usleep (1000000);
 	else
 		printf ("Failed to start camera\n");
 
-	g_object_unref (gv_camera);
+	g_clear_object (&gv_camera);
+	g_clear_object (&farm);
 
 	return EXIT_SUCCESS;
 }
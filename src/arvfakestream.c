@@ -71,6 +71,7 @@ static void *
 arv_fake_stream_thread (void *data)
 {
 	ArvFakeStreamThreadData *thread_data = data;
+	ArvFrameLog *frame_log;
 	ArvBuffer *buffer;
 
 	arv_debug_stream_thread ("[FakeStream::thread] Start");
@@ -80,6 +81,8 @@ arv_fake_stream_thread (void *data)
 
 	while (!g_atomic_int_get (&thread_data->cancel)) {
 		arv_fake_camera_wait_for_next_frame (thread_data->fake_camera);
+		if (arv_stream_is_paused (thread_data->stream))
+			continue;
 		buffer = arv_stream_pop_input_buffer (thread_data->stream);
 		if (buffer != NULL) {
 			if (thread_data->callback != NULL)
@@ -87,10 +90,20 @@ arv_fake_stream_thread (void *data)
 						       NULL);
 
 			arv_fake_camera_fill_buffer (thread_data->fake_camera, buffer, NULL);
-			if (buffer->priv->status == ARV_BUFFER_STATUS_SUCCESS)
+			if (buffer->priv->status == ARV_BUFFER_STATUS_SUCCESS) {
+				if (arv_stream_is_checksum_enabled (thread_data->stream)) {
+					/* Just written by the fake camera, still in the cache */
+					buffer->priv->checksum = arv_buffer_compute_checksum (buffer);
+					buffer->priv->has_checksum = TRUE;
+				}
 				thread_data->n_completed_buffers++;
-			else
+			} else
 				thread_data->n_failures++;
+
+			frame_log = arv_stream_get_frame_log (thread_data->stream);
+			if (frame_log != NULL)
+				arv_frame_log_append (frame_log, buffer, 0, 0, 0);
+
 			arv_stream_push_output_buffer (thread_data->stream, buffer);
 
 			if (thread_data->callback != NULL)
@@ -190,6 +203,10 @@ arv_fake_stream_constructed (GObject *object)
 	thread_data->n_failures = 0;
 	thread_data->n_underruns = 0;
 
+	arv_stream_declare_info (stream, "n_completed_buffers", G_TYPE_UINT, &thread_data->n_completed_buffers);
+	arv_stream_declare_info (stream, "n_failures", G_TYPE_UINT, &thread_data->n_failures);
+	arv_stream_declare_info (stream, "n_underruns", G_TYPE_UINT, &thread_data->n_underruns);
+
 	priv->thread_data = thread_data;
 
 	arv_fake_stream_start_thread (ARV_STREAM (fake_stream));
@@ -0,0 +1,308 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2019 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel@gnome.org>
+ */
+
+/*< private >
+ * SECTION: arvframelog
+ * @short_description: Per frame binary metadata log
+ *
+ * #ArvFrameLog appends a fixed size record per completed frame, with its identifier, device and host timestamps,
+ * status and packet resend counts, to a preallocated, memory mapped file. The records are written by the stream
+ * thread at frame completion, which costs a single cache line store per frame, without any formatting or system
+ * call. Once the file is full, the following frames are only counted. The file is truncated to its used size when
+ * the log is closed.
+ *
+ * The file starts with a 64 bytes header, followed by the #ArvFrameLogRecord records. All values are in host byte
+ * order. The logs are decoded offline, for example by the frames command of arv-tool.
+ */
+
+#include <arvframelogprivate.h>
+#include <arvbufferprivate.h>
+#include <arvdebugprivate.h>
+#include <arvenumtypes.h>
+#include <gio/gio.h>
+#include <string.h>
+#include <errno.h>
+
+#ifndef G_OS_WIN32
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#define ARV_FRAME_LOG_MAGIC		"ARVFLG01"
+#define ARV_FRAME_LOG_HEADER_SIZE	64
+
+typedef struct {
+	char magic[8];
+	guint32 record_size;
+	guint32 reserved;
+	guint64 n_max_records;
+	/* Number of records written, updated after each record */
+	guint64 n_records;
+	/* Number of frames completed once the file was full */
+	guint64 n_dropped;
+} ArvFrameLogHeader;
+
+G_STATIC_ASSERT (sizeof (ArvFrameLogHeader) <= ARV_FRAME_LOG_HEADER_SIZE);
+G_STATIC_ASSERT (sizeof (ArvFrameLogRecord) == 64);
+
+struct _ArvFrameLog {
+	int fd;
+	guint8 *data;
+	size_t size;
+	ArvFrameLogHeader *header;
+	ArvFrameLogRecord *records;
+};
+
+ArvFrameLog *
+arv_frame_log_new (const char *filename, guint n_records, GError **error)
+{
+#ifndef G_OS_WIN32
+	ArvFrameLog *log;
+	void *data = MAP_FAILED;
+	size_t size;
+	int status;
+	int fd;
+
+	g_return_val_if_fail (filename != NULL, NULL);
+
+	n_records = MAX (n_records, 1);
+	size = ARV_FRAME_LOG_HEADER_SIZE + (size_t) n_records * sizeof (ArvFrameLogRecord);
+
+	fd = open (filename, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0) {
+		int errsv = errno;
+
+		g_set_error (error, G_IO_ERROR, g_io_error_from_errno (errsv),
+			     "Can't create frame log '%s': %s", filename, g_strerror (errsv));
+		return NULL;
+	}
+
+	/* The blocks are allocated upfront, the stream thread never waits for the file system */
+	status = posix_fallocate (fd, 0, size);
+	if (status == 0) {
+		data = mmap (NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		if (data == MAP_FAILED)
+			status = errno;
+	}
+	if (status != 0) {
+		int errsv = status;
+
+		g_set_error (error, G_IO_ERROR, g_io_error_from_errno (errsv),
+			     "Can't map frame log '%s': %s", filename, g_strerror (errsv));
+		close (fd);
+		return NULL;
+	}
+
+	log = g_new0 (ArvFrameLog, 1);
+	log->fd = fd;
+	log->data = data;
+	log->size = size;
+	log->header = data;
+	log->records = (ArvFrameLogRecord *) (log->data + ARV_FRAME_LOG_HEADER_SIZE);
+
+	memcpy (log->header->magic, ARV_FRAME_LOG_MAGIC, sizeof (log->header->magic));
+	log->header->record_size = sizeof (ArvFrameLogRecord);
+	log->header->n_max_records = n_records;
+
+	arv_info_misc ("[FrameLog::new] Log frames to '%s' (%u records)", filename, n_records);
+
+	return log;
+#else
+	g_set_error (error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED, "Frame logs are not supported on this platform");
+
+	return NULL;
+#endif
+}
+
+void
+arv_frame_log_free (ArvFrameLog *log)
+{
+	if (log == NULL)
+		return;
+
+#ifndef G_OS_WIN32
+	{
+		guint64 n_records = log->header->n_records;
+
+		arv_info_misc ("[FrameLog::free] %" G_GUINT64_FORMAT " logged frames, %" G_GUINT64_FORMAT " dropped",
+			       n_records, log->header->n_dropped);
+
+		munmap (log->data, log->size);
+		if (ftruncate (log->fd, ARV_FRAME_LOG_HEADER_SIZE + n_records * sizeof (ArvFrameLogRecord)) != 0)
+			arv_warning_misc ("[FrameLog::free] Failed to truncate the frame log: %s", g_strerror (errno));
+		close (log->fd);
+	}
+#endif
+
+	g_free (log);
+}
+
+/**
+ * arv_frame_log_append:
+ * @log: a #ArvFrameLog
+ * @buffer: a completed buffer
+ * @n_missing_packets: number of packets missing from the frame
+ * @n_resent_packets: number of packets received after a resend request
+ * @n_requested_packets: number of packets requested again
+ *
+ * Appends the record of a completed frame. Must only be called from one thread at a time.
+ */
+
+void
+arv_frame_log_append (ArvFrameLog *log, ArvBuffer *buffer,
+		      guint n_missing_packets, guint n_resent_packets, guint n_requested_packets)
+{
+	ArvFrameLogHeader *header;
+	ArvFrameLogRecord *record;
+	guint64 index;
+
+	g_return_if_fail (log != NULL);
+	g_return_if_fail (ARV_IS_BUFFER (buffer));
+
+	header = log->header;
+	index = header->n_records;
+
+	if (G_UNLIKELY (index >= header->n_max_records)) {
+		if (header->n_dropped++ == 0)
+			arv_warning_misc ("[FrameLog::append] Frame log full after %" G_GUINT64_FORMAT " records", index);
+		return;
+	}
+
+	record = &log->records[index];
+	record->frame_id = buffer->priv->frame_id;
+	record->timestamp_ns = buffer->priv->timestamp_ns;
+	record->system_timestamp_ns = buffer->priv->system_timestamp_ns;
+	record->received_size = buffer->priv->received_size;
+	record->status = buffer->priv->status;
+	record->payload_type = buffer->priv->payload_type;
+	record->n_missing_packets = n_missing_packets;
+	record->n_resent_packets = n_resent_packets;
+	record->n_requested_packets = n_requested_packets;
+	memset (record->reserved, 0, sizeof (record->reserved));
+
+	/* The counter is updated once the record is complete */
+	header->n_records = index + 1;
+}
+
+guint64
+arv_frame_log_get_n_records (ArvFrameLog *log)
+{
+	g_return_val_if_fail (log != NULL, 0);
+
+	return log->header->n_records;
+}
+
+guint64
+arv_frame_log_get_n_dropped (ArvFrameLog *log)
+{
+	g_return_val_if_fail (log != NULL, 0);
+
+	return log->header->n_dropped;
+}
+
+ArvFrameLogRecord *
+arv_frame_log_load (const char *filename, guint *n_records, guint64 *n_dropped, GError **error)
+{
+	const ArvFrameLogHeader *header;
+	ArvFrameLogRecord *records;
+	GMappedFile *file;
+	gsize size;
+
+	g_return_val_if_fail (filename != NULL, NULL);
+	g_return_val_if_fail (n_records != NULL, NULL);
+
+	*n_records = 0;
+
+	file = g_mapped_file_new (filename, FALSE, error);
+	if (file == NULL)
+		return NULL;
+
+	size = g_mapped_file_get_length (file);
+	header = (const ArvFrameLogHeader *) g_mapped_file_get_contents (file);
+
+	if (size < ARV_FRAME_LOG_HEADER_SIZE ||
+	    memcmp (header->magic, ARV_FRAME_LOG_MAGIC, sizeof (header->magic)) != 0 ||
+	    header->record_size != sizeof (ArvFrameLogRecord) ||
+	    header->n_records > G_MAXUINT ||
+	    (size - ARV_FRAME_LOG_HEADER_SIZE) / sizeof (ArvFrameLogRecord) < header->n_records) {
+		g_set_error (error, G_IO_ERROR, G_IO_ERROR_FAILED, "Invalid frame log '%s'", filename);
+		g_mapped_file_unref (file);
+		return NULL;
+	}
+
+	*n_records = header->n_records;
+	if (n_dropped != NULL)
+		*n_dropped = header->n_dropped;
+
+	records = g_new (ArvFrameLogRecord, MAX (header->n_records, 1));
+	memcpy (records, (const guint8 *) header + ARV_FRAME_LOG_HEADER_SIZE,
+		header->n_records * sizeof (ArvFrameLogRecord));
+
+	g_mapped_file_unref (file);
+
+	return records;
+}
+
+static const char *
+_status_to_string (guint32 status)
+{
+	GEnumClass *enum_class;
+	GEnumValue *value;
+	const char *retval = NULL;
+
+	enum_class = g_type_class_ref (ARV_TYPE_BUFFER_STATUS);
+
+	value = g_enum_get_value (enum_class, status);
+	if (value)
+		retval = value->value_nick;
+
+	g_type_class_unref (enum_class);
+
+	return retval != NULL ? retval : "unknown";
+}
+
+/* One line per record, with the host time relative to the first record */
+
+char *
+arv_frame_log_records_to_string (const ArvFrameLogRecord *records, guint n_records)
+{
+	GString *string;
+	guint i;
+
+	string = g_string_new ("");
+
+	for (i = 0; i < n_records; i++) {
+		const ArvFrameLogRecord *record = &records[i];
+
+		g_string_append_printf (string, "frame %-10" G_GUINT64_FORMAT " %14.6f s timestamp %-20" G_GUINT64_FORMAT
+					" %-16s size %-10" G_GUINT64_FORMAT " missing %-6u resent %-6u requested %u\n",
+					record->frame_id,
+					(gint64) (record->system_timestamp_ns - records[0].system_timestamp_ns) / 1e9,
+					record->timestamp_ns, _status_to_string (record->status),
+					record->received_size,
+					record->n_missing_packets, record->n_resent_packets,
+					record->n_requested_packets);
+	}
+
+	return g_string_free (string, FALSE);
+}
@@ -0,0 +1,69 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2019 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel@gnome.org>
+ */
+
+#ifndef ARV_FRAME_LOG_PRIVATE_H
+#define ARV_FRAME_LOG_PRIVATE_H
+
+#if !defined (ARV_H_INSIDE) && !defined (ARAVIS_COMPILATION)
+#error "Only <arv.h> can be included directly."
+#endif
+
+#include <arvbuffer.h>
+
+G_BEGIN_DECLS
+
+/* Default number of records preallocated in a frame log file, 64 MB */
+#define ARV_FRAME_LOG_N_RECORDS_DEFAULT		(1 << 20)
+
+/* One cache line per frame, in host byte order in the log files */
+
+typedef struct {
+	guint64 frame_id;
+	guint64 timestamp_ns;
+	guint64 system_timestamp_ns;
+	guint64 received_size;
+	guint32 status;
+	guint32 payload_type;
+	guint32 n_missing_packets;
+	guint32 n_resent_packets;
+	guint32 n_requested_packets;
+	guint32 reserved[3];
+} ArvFrameLogRecord;
+
+typedef struct _ArvFrameLog ArvFrameLog;
+
+ArvFrameLog *		arv_frame_log_new		(const char *filename, guint n_records, GError **error);
+void			arv_frame_log_free		(ArvFrameLog *log);
+
+void			arv_frame_log_append		(ArvFrameLog *log, ArvBuffer *buffer,
+							 guint n_missing_packets, guint n_resent_packets,
+							 guint n_requested_packets);
+guint64			arv_frame_log_get_n_records	(ArvFrameLog *log);
+guint64			arv_frame_log_get_n_dropped	(ArvFrameLog *log);
+
+ArvFrameLogRecord *	arv_frame_log_load		(const char *filename, guint *n_records, guint64 *n_dropped,
+							 GError **error);
+char *			arv_frame_log_records_to_string	(const ArvFrameLogRecord *records, guint n_records);
+
+G_END_DECLS
+
+#endif
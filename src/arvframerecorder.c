@@ -0,0 +1,636 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2019 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel@gnome.org>
+ */
+
+/**
+ * SECTION: arvframerecorder
+ * @short_description: Frame to disk recorder
+ *
+ * #ArvFrameRecorder is a consumer of a stream, which writes every successfully received buffer to a container file,
+ * and gives the buffer back to the stream as soon as its write is complete. The writes are done by a dedicated
+ * thread, using direct I/O, bypassing the page cache, and io_uring if aravis is compiled with its support (see
+ * %ARAVIS_HAS_IO_URING), which keeps several writes in flight. The other buffers are given back immediately.
+ *
+ * The container is preallocated, and starts with a header block. Each frame is stored at a 4096 byte aligned offset,
+ * followed by an index, written when the recorder is stopped, with the frame id, timestamps, image region, pixel
+ * format, payload type and chunk presence of each frame. Frames received once the container is full are dropped.
+ *
+ * Direct I/O requires the buffer data to be 4096 byte aligned, which is the case of the buffers allocated using
+ * arv_buffer_new_allocate_full() with an alignment. The data of the other buffers is copied before being written. If
+ * the file system doesn't support direct I/O, the recorder falls back to buffered writes.
+ *
+ * |[<!-- language="C" -->
+ * for (i = 0; i < 50; i++)
+ * 	arv_stream_push_buffer (stream, arv_buffer_new_allocate_full (payload, ARV_BUFFER_ALLOCATION_FLAGS_NONE, 4096));
+ * recorder = arv_frame_recorder_new (stream, "capture.arvrec", 64 * payload, &error);
+ * arv_camera_start_acquisition (camera, &error);
+ * ...
+ * arv_camera_stop_acquisition (camera, &error);
+ * arv_frame_recorder_stop (recorder, &error);
+ * ]|
+ */
+
+/* For O_DIRECT */
+#define _GNU_SOURCE
+
+#include <arvframerecorderprivate.h>
+#include <arvstream.h>
+#include <arvbufferprivate.h>
+#include <arvdebugprivate.h>
+#include <arvfeatures.h>
+#include <gio/gio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+
+#ifndef G_OS_WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/uio.h>
+#endif
+
+#if ARAVIS_HAS_IO_URING
+#include <liburing.h>
+#endif
+
+/* Maximum number of writes in flight with io_uring */
+#define ARV_FRAME_RECORDER_QUEUE_DEPTH		8
+#define ARV_FRAME_RECORDER_POP_TIMEOUT_US	100000
+#define ARV_FRAME_RECORDER_WAIT_TIMEOUT_NS	1000000
+
+#define ARV_FRAME_RECORD_ALIGN(size)	(((size) + ARV_FRAME_RECORD_BLOCK_SIZE - 1) & \
+					 ~((guint64) ARV_FRAME_RECORD_BLOCK_SIZE - 1))
+
+G_STATIC_ASSERT (sizeof (ArvFrameRecordHeader) <= ARV_FRAME_RECORD_BLOCK_SIZE);
+
+typedef struct {
+	ArvBuffer *buffer;
+	ArvFrameRecordEntry entry;
+	struct iovec iovecs[2];
+	guint n_iovecs;
+	size_t length;
+	/* Block aligned copy of the unaligned part of the buffer data */
+	void *bounce;
+	size_t bounce_size;
+} ArvFrameRecorderSlot;
+
+struct _ArvFrameRecorder {
+	GObject object;
+
+	ArvStream *stream;
+	char *filename;
+	int fd;
+	guint64 size;
+	/* Offset of the next frame */
+	guint64 offset;
+
+	GThread *thread;
+	gint cancel;
+
+	ArvFrameRecorderSlot slots[ARV_FRAME_RECORDER_QUEUE_DEPTH];
+	guint n_in_flight;
+
+#if ARAVIS_HAS_IO_URING
+	struct io_uring ring;
+	gboolean use_io_uring;
+#endif
+
+	/* Index of the written frames, only accessed from the recorder thread until it is joined */
+	GArray *index;
+
+	guint64 n_frames;
+	guint64 n_dropped_frames;
+	guint64 n_written_bytes;
+};
+
+G_DEFINE_TYPE (ArvFrameRecorder, arv_frame_recorder, G_TYPE_OBJECT)
+
+#ifndef G_OS_WIN32
+
+static void *
+_aligned_alloc (size_t size)
+{
+	void *data;
+
+	if (posix_memalign (&data, ARV_FRAME_RECORD_BLOCK_SIZE, size) != 0)
+		return NULL;
+
+	return data;
+}
+
+static int
+_pwrite_all (int fd, const void *data, size_t size, guint64 offset)
+{
+	while (size > 0) {
+		ssize_t count;
+
+		count = pwrite (fd, data, size, offset);
+		if (count < 0) {
+			if (errno == EINTR)
+				continue;
+			return errno;
+		}
+		if (count == 0)
+			return EIO;
+
+		data = (const char *) data + count;
+		size -= count;
+		offset += count;
+	}
+
+	return 0;
+}
+
+/* Give the buffer back to the stream, and index the frame if it was written */
+
+static void
+_complete_slot (ArvFrameRecorder *recorder, ArvFrameRecorderSlot *slot, int errsv)
+{
+	if (errsv == 0) {
+		g_array_append_val (recorder->index, slot->entry);
+		__atomic_fetch_add (&recorder->n_frames, 1, __ATOMIC_RELAXED);
+		__atomic_fetch_add (&recorder->n_written_bytes, slot->entry.size, __ATOMIC_RELAXED);
+	} else {
+		arv_warning_stream ("[FrameRecorder::complete_slot] Failed to write frame %" G_GUINT64_FORMAT ": %s",
+				    slot->entry.frame_id, g_strerror (errsv));
+		__atomic_fetch_add (&recorder->n_dropped_frames, 1, __ATOMIC_RELAXED);
+	}
+
+	arv_stream_push_buffer (recorder->stream, slot->buffer);
+	slot->buffer = NULL;
+}
+
+static void
+_reap (ArvFrameRecorder *recorder)
+{
+#if ARAVIS_HAS_IO_URING
+	struct __kernel_timespec timeout = { 0, ARV_FRAME_RECORDER_WAIT_TIMEOUT_NS };
+	struct io_uring_cqe *cqe;
+
+	if (!recorder->use_io_uring || recorder->n_in_flight == 0)
+		return;
+
+	if (io_uring_wait_cqe_timeout (&recorder->ring, &cqe, &timeout) < 0)
+		return;
+
+	while (io_uring_peek_cqe (&recorder->ring, &cqe) == 0) {
+		ArvFrameRecorderSlot *slot = io_uring_cqe_get_data (cqe);
+		int errsv;
+
+		if (cqe->res < 0)
+			errsv = -cqe->res;
+		else
+			errsv = (size_t) cqe->res == slot->length ? 0 : EIO;
+
+		io_uring_cqe_seen (&recorder->ring, cqe);
+		recorder->n_in_flight--;
+
+		_complete_slot (recorder, slot, errsv);
+	}
+#endif
+}
+
+static void
+_submit (ArvFrameRecorder *recorder, ArvFrameRecorderSlot *slot)
+{
+	guint64 offset;
+	int errsv = 0;
+	guint i;
+
+#if ARAVIS_HAS_IO_URING
+	if (recorder->use_io_uring) {
+		struct io_uring_sqe *sqe;
+
+		sqe = io_uring_get_sqe (&recorder->ring);
+		if (sqe != NULL) {
+			io_uring_prep_writev (sqe, recorder->fd, slot->iovecs, slot->n_iovecs, slot->entry.offset);
+			io_uring_sqe_set_data (sqe, slot);
+			if (io_uring_submit (&recorder->ring) == 1) {
+				recorder->n_in_flight++;
+				return;
+			}
+		}
+
+		arv_info_stream ("[FrameRecorder::submit] io_uring submission failed, fall back to a synchronous write");
+	}
+#endif
+
+	offset = slot->entry.offset;
+	for (i = 0; i < slot->n_iovecs && errsv == 0; i++) {
+		errsv = _pwrite_all (recorder->fd, slot->iovecs[i].iov_base, slot->iovecs[i].iov_len, offset);
+		offset += slot->iovecs[i].iov_len;
+	}
+
+	_complete_slot (recorder, slot, errsv);
+}
+
+static ArvFrameRecorderSlot *
+_get_free_slot (ArvFrameRecorder *recorder)
+{
+	guint i;
+
+	for (i = 0; i < ARV_FRAME_RECORDER_QUEUE_DEPTH; i++)
+		if (recorder->slots[i].buffer == NULL)
+			return &recorder->slots[i];
+
+	return NULL;
+}
+
+static void
+_record_buffer (ArvFrameRecorder *recorder, ArvBuffer *buffer)
+{
+	ArvFrameRecorderSlot *slot;
+	ArvBufferPayloadType payload_type;
+	const guint8 *data;
+	size_t size;
+	size_t direct_size;
+	size_t bounce_length;
+	guint64 length;
+
+	if (arv_buffer_get_status (buffer) != ARV_BUFFER_STATUS_SUCCESS) {
+		arv_stream_push_buffer (recorder->stream, buffer);
+		return;
+	}
+
+	data = arv_buffer_get_data (buffer, &size);
+	length = ARV_FRAME_RECORD_ALIGN (size);
+
+	slot = _get_free_slot (recorder);
+	if (slot == NULL || recorder->offset + length > recorder->size) {
+		__atomic_fetch_add (&recorder->n_dropped_frames, 1, __ATOMIC_RELAXED);
+		arv_stream_push_buffer (recorder->stream, buffer);
+		return;
+	}
+
+	payload_type = arv_buffer_get_payload_type (buffer);
+
+	memset (&slot->entry, 0, sizeof (slot->entry));
+	slot->entry.frame_id = arv_buffer_get_frame_id (buffer);
+	slot->entry.timestamp_ns = arv_buffer_get_timestamp (buffer);
+	slot->entry.system_timestamp_ns = arv_buffer_get_system_timestamp (buffer);
+	slot->entry.offset = recorder->offset;
+	slot->entry.size = size;
+	slot->entry.payload_type = payload_type;
+	slot->entry.has_chunks = arv_buffer_has_chunks (buffer);
+	if (arv_buffer_payload_type_has_aoi (payload_type)) {
+		arv_buffer_get_image_region (buffer, &slot->entry.x, &slot->entry.y,
+					     &slot->entry.width, &slot->entry.height);
+		slot->entry.pixel_format = arv_buffer_get_image_pixel_format (buffer);
+	}
+
+	/* The block aligned part of an aligned buffer is written in place, the rest is copied */
+	if (((guintptr) data & (ARV_FRAME_RECORD_BLOCK_SIZE - 1)) == 0)
+		direct_size = size & ~((size_t) ARV_FRAME_RECORD_BLOCK_SIZE - 1);
+	else
+		direct_size = 0;
+	bounce_length = length - direct_size;
+
+	if (bounce_length > slot->bounce_size) {
+		free (slot->bounce);
+		slot->bounce = _aligned_alloc (bounce_length);
+		slot->bounce_size = slot->bounce != NULL ? bounce_length : 0;
+		if (slot->bounce == NULL) {
+			__atomic_fetch_add (&recorder->n_dropped_frames, 1, __ATOMIC_RELAXED);
+			arv_stream_push_buffer (recorder->stream, buffer);
+			return;
+		}
+	}
+
+	slot->n_iovecs = 0;
+	if (direct_size > 0) {
+		slot->iovecs[slot->n_iovecs].iov_base = (void *) data;
+		slot->iovecs[slot->n_iovecs].iov_len = direct_size;
+		slot->n_iovecs++;
+	}
+	if (bounce_length > 0) {
+		memcpy (slot->bounce, data + direct_size, size - direct_size);
+		memset ((char *) slot->bounce + size - direct_size, 0, bounce_length - (size - direct_size));
+		slot->iovecs[slot->n_iovecs].iov_base = slot->bounce;
+		slot->iovecs[slot->n_iovecs].iov_len = bounce_length;
+		slot->n_iovecs++;
+	}
+
+	slot->buffer = buffer;
+	slot->length = length;
+	recorder->offset += length;
+
+	_submit (recorder, slot);
+}
+
+static gint
+_compare_entries (gconstpointer a, gconstpointer b)
+{
+	const ArvFrameRecordEntry *entry_a = a;
+	const ArvFrameRecordEntry *entry_b = b;
+
+	return entry_a->offset < entry_b->offset ? -1 : entry_a->offset > entry_b->offset;
+}
+
+static void *
+_recorder_thread (void *data)
+{
+	ArvFrameRecorder *recorder = data;
+
+	while (!g_atomic_int_get (&recorder->cancel)) {
+		ArvBuffer *buffer;
+
+		if (recorder->n_in_flight == ARV_FRAME_RECORDER_QUEUE_DEPTH) {
+			_reap (recorder);
+			continue;
+		}
+
+		/* Keep an eye on the write completions while writes are in flight */
+		if (recorder->n_in_flight > 0) {
+			buffer = arv_stream_try_pop_buffer (recorder->stream);
+			if (buffer == NULL) {
+				_reap (recorder);
+				continue;
+			}
+		} else {
+			buffer = arv_stream_timeout_pop_buffer (recorder->stream, ARV_FRAME_RECORDER_POP_TIMEOUT_US);
+			if (buffer == NULL)
+				continue;
+		}
+
+		_record_buffer (recorder, buffer);
+	}
+
+	while (recorder->n_in_flight > 0)
+		_reap (recorder);
+
+	return NULL;
+}
+
+#endif
+
+/**
+ * arv_frame_recorder_new:
+ * @stream: a #ArvStream
+ * @filename: container file name
+ * @size: size of the preallocated container, in bytes
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Creates a recorder, and starts its thread, which pops the buffers from @stream and pushes them back once written.
+ * It must be the only consumer of @stream.
+ *
+ * Returns: (transfer full): a new #ArvFrameRecorder, %NULL on error
+ *
+ * Since: 0.8.11
+ */
+
+ArvFrameRecorder *
+arv_frame_recorder_new (ArvStream *stream, const char *filename, guint64 size, GError **error)
+{
+#ifndef G_OS_WIN32
+	ArvFrameRecorder *recorder;
+	gboolean direct = TRUE;
+	int fd;
+	int errsv;
+
+	g_return_val_if_fail (ARV_IS_STREAM (stream), NULL);
+	g_return_val_if_fail (filename != NULL, NULL);
+
+	fd = open (filename, O_WRONLY | O_CREAT | O_TRUNC | O_DIRECT, 0644);
+	if (fd < 0 && errno == EINVAL) {
+		arv_info_stream ("[FrameRecorder::new] No direct I/O support for '%s', use buffered writes", filename);
+		direct = FALSE;
+		fd = open (filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	}
+	if (fd < 0) {
+		errsv = errno;
+		g_set_error (error, G_IO_ERROR, g_io_error_from_errno (errsv),
+			     "Can't create frame record '%s': %s", filename, g_strerror (errsv));
+		return NULL;
+	}
+
+	size = ARV_FRAME_RECORD_ALIGN (MAX (size, ARV_FRAME_RECORD_BLOCK_SIZE));
+
+	errsv = posix_fallocate (fd, 0, size);
+	if (errsv != 0)
+		arv_info_stream ("[FrameRecorder::new] Can't preallocate %" G_GUINT64_FORMAT " bytes: %s",
+				 size, g_strerror (errsv));
+
+	recorder = g_object_new (ARV_TYPE_FRAME_RECORDER, NULL);
+	recorder->stream = g_object_ref (stream);
+	recorder->filename = g_strdup (filename);
+	recorder->fd = fd;
+	recorder->size = size;
+	recorder->offset = ARV_FRAME_RECORD_BLOCK_SIZE;
+
+#if ARAVIS_HAS_IO_URING
+	/* Room for the timeout submissions of io_uring_wait_cqe_timeout() on older kernels */
+	errsv = -io_uring_queue_init (2 * ARV_FRAME_RECORDER_QUEUE_DEPTH, &recorder->ring, 0);
+	recorder->use_io_uring = errsv == 0;
+	if (!recorder->use_io_uring)
+		arv_info_stream ("[FrameRecorder::new] io_uring not available (%s), use synchronous writes",
+				 g_strerror (errsv));
+#endif
+
+	arv_info_stream ("[FrameRecorder::new] Record frames to '%s' (%" G_GUINT64_FORMAT " bytes%s%s)",
+			 filename, size, direct ? ", direct I/O" : "",
+#if ARAVIS_HAS_IO_URING
+			 recorder->use_io_uring ? ", io_uring" : ""
+#else
+			 ""
+#endif
+			 );
+
+	recorder->thread = g_thread_new ("arv_recorder", _recorder_thread, recorder);
+
+	return recorder;
+#else
+	g_set_error (error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED, "Frame recording is not supported on this platform");
+
+	return NULL;
+#endif
+}
+
+/**
+ * arv_frame_recorder_stop:
+ * @recorder: a #ArvFrameRecorder
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Stops the recorder thread, once the writes in flight are complete, and writes the frame index and the container
+ * header. The frames still in the stream output queue are left there. Calling this function on a stopped
+ * recorder does nothing.
+ *
+ * Returns: %TRUE if the container was successfully completed
+ *
+ * Since: 0.8.11
+ */
+
+gboolean
+arv_frame_recorder_stop (ArvFrameRecorder *recorder, GError **error)
+{
+#ifndef G_OS_WIN32
+	ArvFrameRecordHeader *header;
+	guint64 index_size;
+	void *block;
+	int errsv = 0;
+
+	g_return_val_if_fail (ARV_IS_FRAME_RECORDER (recorder), FALSE);
+
+	if (recorder->thread == NULL)
+		return TRUE;
+
+	g_atomic_int_set (&recorder->cancel, 1);
+	g_thread_join (recorder->thread);
+	recorder->thread = NULL;
+
+	/* io_uring writes may complete out of order */
+	g_array_sort (recorder->index, _compare_entries);
+
+	index_size = ARV_FRAME_RECORD_ALIGN (recorder->index->len * sizeof (ArvFrameRecordEntry));
+
+	block = _aligned_alloc (index_size + ARV_FRAME_RECORD_BLOCK_SIZE);
+	if (block == NULL)
+		errsv = ENOMEM;
+
+	if (errsv == 0 && index_size > 0) {
+		memset (block, 0, index_size);
+		memcpy (block, recorder->index->data, recorder->index->len * sizeof (ArvFrameRecordEntry));
+		errsv = _pwrite_all (recorder->fd, block, index_size, recorder->offset);
+	}
+
+	if (errsv == 0) {
+		memset (block, 0, ARV_FRAME_RECORD_BLOCK_SIZE);
+		header = block;
+		memcpy (header->magic, ARV_FRAME_RECORD_MAGIC, sizeof (header->magic));
+		header->block_size = ARV_FRAME_RECORD_BLOCK_SIZE;
+		header->entry_size = sizeof (ArvFrameRecordEntry);
+		header->n_frames = recorder->index->len;
+		header->index_offset = recorder->offset;
+		errsv = _pwrite_all (recorder->fd, block, ARV_FRAME_RECORD_BLOCK_SIZE, 0);
+	}
+
+	free (block);
+
+	/* Release the unused part of the preallocated container */
+	if (errsv == 0 && ftruncate (recorder->fd, recorder->offset + index_size) != 0)
+		errsv = errno;
+	if (errsv == 0 && fdatasync (recorder->fd) != 0)
+		errsv = errno;
+
+	close (recorder->fd);
+	recorder->fd = -1;
+
+	arv_info_stream ("[FrameRecorder::stop] %" G_GUINT64_FORMAT " frames recorded to '%s', %" G_GUINT64_FORMAT
+			 " dropped", recorder->n_frames, recorder->filename, recorder->n_dropped_frames);
+
+	if (errsv != 0) {
+		g_set_error (error, G_IO_ERROR, g_io_error_from_errno (errsv),
+			     "Failed to complete frame record '%s': %s", recorder->filename, g_strerror (errsv));
+		return FALSE;
+	}
+#endif
+
+	return TRUE;
+}
+
+/**
+ * arv_frame_recorder_get_n_frames:
+ * @recorder: a #ArvFrameRecorder
+ *
+ * Returns: the number of frames written to the container
+ *
+ * Since: 0.8.11
+ */
+
+guint64
+arv_frame_recorder_get_n_frames (ArvFrameRecorder *recorder)
+{
+	g_return_val_if_fail (ARV_IS_FRAME_RECORDER (recorder), 0);
+
+	return __atomic_load_n (&recorder->n_frames, __ATOMIC_RELAXED);
+}
+
+/**
+ * arv_frame_recorder_get_n_dropped_frames:
+ * @recorder: a #ArvFrameRecorder
+ *
+ * Returns: the number of successfully received frames which could not be written, because the container was full
+ * or because of a write error
+ *
+ * Since: 0.8.11
+ */
+
+guint64
+arv_frame_recorder_get_n_dropped_frames (ArvFrameRecorder *recorder)
+{
+	g_return_val_if_fail (ARV_IS_FRAME_RECORDER (recorder), 0);
+
+	return __atomic_load_n (&recorder->n_dropped_frames, __ATOMIC_RELAXED);
+}
+
+/**
+ * arv_frame_recorder_get_n_written_bytes:
+ * @recorder: a #ArvFrameRecorder
+ *
+ * Returns: the number of frame data bytes written to the container, without the alignment padding
+ *
+ * Since: 0.8.11
+ */
+
+guint64
+arv_frame_recorder_get_n_written_bytes (ArvFrameRecorder *recorder)
+{
+	g_return_val_if_fail (ARV_IS_FRAME_RECORDER (recorder), 0);
+
+	return __atomic_load_n (&recorder->n_written_bytes, __ATOMIC_RELAXED);
+}
+
+static void
+arv_frame_recorder_init (ArvFrameRecorder *recorder)
+{
+	recorder->fd = -1;
+	recorder->index = g_array_new (FALSE, FALSE, sizeof (ArvFrameRecordEntry));
+}
+
+static void
+arv_frame_recorder_finalize (GObject *object)
+{
+	ArvFrameRecorder *recorder = ARV_FRAME_RECORDER (object);
+	guint i;
+
+	arv_frame_recorder_stop (recorder, NULL);
+
+#if ARAVIS_HAS_IO_URING
+	if (recorder->use_io_uring)
+		io_uring_queue_exit (&recorder->ring);
+#endif
+
+	for (i = 0; i < ARV_FRAME_RECORDER_QUEUE_DEPTH; i++)
+		free (recorder->slots[i].bounce);
+
+	g_clear_pointer (&recorder->index, g_array_unref);
+	g_clear_pointer (&recorder->filename, g_free);
+	g_clear_object (&recorder->stream);
+
+	G_OBJECT_CLASS (arv_frame_recorder_parent_class)->finalize (object);
+}
+
+static void
+arv_frame_recorder_class_init (ArvFrameRecorderClass *recorder_class)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS (recorder_class);
+
+	object_class->finalize = arv_frame_recorder_finalize;
+}
@@ -0,0 +1,67 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2019 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel@gnome.org>
+ */
+
+#ifndef ARV_FRAME_RECORDER_PRIVATE_H
+#define ARV_FRAME_RECORDER_PRIVATE_H
+
+#if !defined (ARV_H_INSIDE) && !defined (ARAVIS_COMPILATION)
+#error "Only <arv.h> can be included directly."
+#endif
+
+#include <arvframerecorder.h>
+
+G_BEGIN_DECLS
+
+#define ARV_FRAME_RECORD_MAGIC		"ARVREC01"
+
+/* Alignment of the file offsets, lengths and memory of the direct writes */
+#define ARV_FRAME_RECORD_BLOCK_SIZE	4096
+
+/* Container header, at the start of the first block of the file, in host byte order */
+typedef struct {
+	char magic[8];
+	guint32 block_size;
+	guint32 entry_size;
+	guint64 n_frames;
+	guint64 index_offset;
+} ArvFrameRecordHeader;
+
+/* Frame index entry, the frame data being stored at a block aligned offset */
+typedef struct {
+	guint64 frame_id;
+	guint64 timestamp_ns;
+	guint64 system_timestamp_ns;
+	guint64 offset;
+	guint64 size;
+	gint32 x;
+	gint32 y;
+	gint32 width;
+	gint32 height;
+	guint32 pixel_format;
+	guint32 payload_type;
+	guint32 has_chunks;
+	guint32 reserved;
+} ArvFrameRecordEntry;
+
+G_END_DECLS
+
+#endif
@@ -0,0 +1,270 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2019 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel@gnome.org>
+ */
+
+/*< private >
+ * SECTION: arvframetiming
+ * @short_description: Frame interval and jitter analytics
+ *
+ * #ArvFrameTiming measures the intervals between the successive frames of a stream, both from the device timestamps
+ * and from the host completion times, in constant time per frame. The mean and the standard deviation are updated
+ * using the Welford algorithm, and the deviations from a reference period are accumulated in an histogram, which
+ * gives the percentiles. The reference period is the expected period when it is set, and the median of the first
+ * %ARV_FRAME_TIMING_N_WARM_UP_INTERVALS intervals otherwise. Intervals longer than the gap ratio times the
+ * reference period are counted as gaps. The drift between the device and host clocks is estimated by a
+ * #ArvClockModel.
+ */
+
+#include <arvframetimingprivate.h>
+#include <string.h>
+#include <math.h>
+#include <stdlib.h>
+
+ArvFrameTiming *
+arv_frame_timing_new (void)
+{
+	ArvFrameTiming *timing;
+
+	timing = g_new0 (ArvFrameTiming, 1);
+	g_mutex_init (&timing->mutex);
+	timing->gap_ratio = ARV_FRAME_TIMING_GAP_RATIO_DEFAULT;
+	timing->statistic = arv_statistic_new (2, ARV_FRAME_TIMING_N_BINS, ARV_FRAME_TIMING_BIN_STEP_US,
+					       ARV_FRAME_TIMING_OFFSET_US);
+	arv_statistic_set_name (timing->statistic, ARV_FRAME_INTERVAL_SOURCE_DEVICE, "Device frame interval jitter");
+	arv_statistic_set_name (timing->statistic, ARV_FRAME_INTERVAL_SOURCE_HOST, "Host frame interval jitter");
+	timing->clock_model = arv_clock_model_new (ARV_CLOCK_MODEL_N_SAMPLES_DEFAULT);
+
+	arv_frame_timing_reset (timing);
+
+	return timing;
+}
+
+void
+arv_frame_timing_free (ArvFrameTiming *timing)
+{
+	if (timing == NULL)
+		return;
+
+	arv_statistic_free (timing->statistic);
+	arv_clock_model_free (timing->clock_model);
+	g_mutex_clear (&timing->mutex);
+	g_free (timing);
+}
+
+static void
+_reset (ArvFrameTiming *timing)
+{
+	memset (timing->trackers, 0, sizeof (timing->trackers));
+	arv_statistic_reset (timing->statistic);
+	arv_clock_model_reset (timing->clock_model);
+	timing->clock_drift_ppm = 0.0;
+}
+
+void
+arv_frame_timing_reset (ArvFrameTiming *timing)
+{
+	g_return_if_fail (timing != NULL);
+
+	g_mutex_lock (&timing->mutex);
+	_reset (timing);
+	g_mutex_unlock (&timing->mutex);
+}
+
+/* The histograms are relative to the reference period, hence restarted */
+
+void
+arv_frame_timing_set_expected_period (ArvFrameTiming *timing, double period_us)
+{
+	g_return_if_fail (timing != NULL);
+
+	g_mutex_lock (&timing->mutex);
+	if (timing->expected_period_us != MAX (period_us, 0.0)) {
+		timing->expected_period_us = MAX (period_us, 0.0);
+		_reset (timing);
+	}
+	g_mutex_unlock (&timing->mutex);
+}
+
+void
+arv_frame_timing_set_gap_ratio (ArvFrameTiming *timing, double gap_ratio)
+{
+	g_return_if_fail (timing != NULL);
+
+	g_mutex_lock (&timing->mutex);
+	timing->gap_ratio = MAX (gap_ratio, 1.0);
+	g_mutex_unlock (&timing->mutex);
+}
+
+static double
+_get_period (ArvFrameTiming *timing, ArvFrameIntervalTracker *tracker)
+{
+	return timing->expected_period_us > 0.0 ? timing->expected_period_us : tracker->reference_us;
+}
+
+static void
+_fill (ArvFrameTiming *timing, ArvFrameIntervalSource source, double interval_us)
+{
+	ArvFrameIntervalTracker *tracker = &timing->trackers[source];
+	double period_us = _get_period (timing, tracker);
+	double delta;
+
+	tracker->n_intervals++;
+	delta = interval_us - tracker->mean_us;
+	tracker->mean_us += delta / tracker->n_intervals;
+	tracker->m2 += delta * (interval_us - tracker->mean_us);
+	tracker->standard_deviation_us = tracker->n_intervals > 1 ?
+		sqrt (tracker->m2 / (tracker->n_intervals - 1)) : 0.0;
+
+	if (tracker->n_intervals == 1 || interval_us < tracker->min_us)
+		tracker->min_us = interval_us;
+	if (tracker->n_intervals == 1 || interval_us > tracker->max_us)
+		tracker->max_us = interval_us;
+
+	if (interval_us > timing->gap_ratio * period_us)
+		tracker->n_gaps++;
+
+	arv_statistic_fill (timing->statistic, source,
+			    (int) CLAMP (interval_us - period_us, G_MININT / 2, G_MAXINT / 2),
+			    tracker->n_intervals);
+}
+
+static int
+_compare_doubles (const void *a, const void *b)
+{
+	double da = *(const double *) a;
+	double db = *(const double *) b;
+
+	return da < db ? -1 : (da > db ? 1 : 0);
+}
+
+static void
+_add_time (ArvFrameTiming *timing, ArvFrameIntervalSource source, guint64 time_ns)
+{
+	ArvFrameIntervalTracker *tracker = &timing->trackers[source];
+	double interval_us;
+	guint i;
+
+	if (!tracker->has_last_time || time_ns <= tracker->last_time_ns) {
+		/* First frame, or clock reset */
+		tracker->has_last_time = TRUE;
+		tracker->last_time_ns = time_ns;
+		return;
+	}
+
+	interval_us = (time_ns - tracker->last_time_ns) / 1000.0;
+	tracker->last_time_ns = time_ns;
+
+	if (timing->expected_period_us > 0.0 || tracker->n_warm_up_intervals >= ARV_FRAME_TIMING_N_WARM_UP_INTERVALS) {
+		_fill (timing, source, interval_us);
+		return;
+	}
+
+	tracker->warm_up_us[tracker->n_warm_up_intervals++] = interval_us;
+	if (tracker->n_warm_up_intervals < ARV_FRAME_TIMING_N_WARM_UP_INTERVALS)
+		return;
+
+	/* The median is not biased by the initial gaps, unlike the mean */
+	{
+		double sorted_us[ARV_FRAME_TIMING_N_WARM_UP_INTERVALS];
+
+		memcpy (sorted_us, tracker->warm_up_us, sizeof (sorted_us));
+		qsort (sorted_us, ARV_FRAME_TIMING_N_WARM_UP_INTERVALS, sizeof (double), _compare_doubles);
+		tracker->reference_us = sorted_us[ARV_FRAME_TIMING_N_WARM_UP_INTERVALS / 2];
+	}
+
+	for (i = 0; i < ARV_FRAME_TIMING_N_WARM_UP_INTERVALS; i++)
+		_fill (timing, source, tracker->warm_up_us[i]);
+}
+
+/* Called from the stream thread for each completed frame, @device_time_ns being 0 if the device doesn't timestamp
+ * its frames */
+
+void
+arv_frame_timing_add_frame (ArvFrameTiming *timing, guint64 device_time_ns, guint64 host_time_ns)
+{
+	g_return_if_fail (timing != NULL);
+
+	g_mutex_lock (&timing->mutex);
+
+	if (device_time_ns != 0) {
+		_add_time (timing, ARV_FRAME_INTERVAL_SOURCE_DEVICE, device_time_ns);
+		arv_clock_model_add_sample (timing->clock_model, device_time_ns, host_time_ns);
+		timing->clock_drift_ppm = arv_clock_model_get_drift_ppm (timing->clock_model);
+	}
+
+	_add_time (timing, ARV_FRAME_INTERVAL_SOURCE_HOST, host_time_ns);
+
+	g_mutex_unlock (&timing->mutex);
+}
+
+gboolean
+arv_frame_timing_get_statistics (ArvFrameTiming *timing, ArvFrameIntervalSource source,
+				 ArvFrameIntervalStatistics *statistics)
+{
+	ArvFrameIntervalTracker *tracker;
+	double period_us;
+
+	g_return_val_if_fail (timing != NULL, FALSE);
+	g_return_val_if_fail (source == ARV_FRAME_INTERVAL_SOURCE_DEVICE ||
+			      source == ARV_FRAME_INTERVAL_SOURCE_HOST, FALSE);
+	g_return_val_if_fail (statistics != NULL, FALSE);
+
+	memset (statistics, 0, sizeof (ArvFrameIntervalStatistics));
+
+	g_mutex_lock (&timing->mutex);
+
+	tracker = &timing->trackers[source];
+	if (tracker->n_intervals == 0) {
+		g_mutex_unlock (&timing->mutex);
+		return FALSE;
+	}
+
+	period_us = _get_period (timing, tracker);
+
+	statistics->n_intervals = tracker->n_intervals;
+	statistics->reference_period_us = period_us;
+	statistics->mean_us = tracker->mean_us;
+	statistics->standard_deviation_us = tracker->standard_deviation_us;
+	statistics->min_us = tracker->min_us;
+	statistics->max_us = tracker->max_us;
+	statistics->median_us = period_us + arv_statistic_get_percentile (timing->statistic, source, 50.0);
+	statistics->p99_us = period_us + arv_statistic_get_percentile (timing->statistic, source, 99.0);
+	statistics->p999_us = period_us + arv_statistic_get_percentile (timing->statistic, source, 99.9);
+	statistics->n_gaps = tracker->n_gaps;
+
+	g_mutex_unlock (&timing->mutex);
+
+	return TRUE;
+}
+
+double
+arv_frame_timing_get_clock_drift (ArvFrameTiming *timing)
+{
+	double drift_ppm;
+
+	g_return_val_if_fail (timing != NULL, 0.0);
+
+	g_mutex_lock (&timing->mutex);
+	drift_ppm = timing->clock_drift_ppm;
+	g_mutex_unlock (&timing->mutex);
+
+	return drift_ppm;
+}
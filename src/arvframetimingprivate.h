@@ -0,0 +1,95 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2019 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel@gnome.org>
+ */
+
+#ifndef ARV_FRAME_TIMING_PRIVATE_H
+#define ARV_FRAME_TIMING_PRIVATE_H
+
+#if !defined (ARV_H_INSIDE) && !defined (ARAVIS_COMPILATION)
+#error "Only <arv.h> can be included directly."
+#endif
+
+#include <arvstream.h>
+#include <arvmiscprivate.h>
+#include <arvclockmodelprivate.h>
+
+G_BEGIN_DECLS
+
+/* Number of intervals whose median gives the reference period, when the expected period is not set */
+#define ARV_FRAME_TIMING_N_WARM_UP_INTERVALS	16
+
+/* Range and precision of the histograms of the deviations from the reference period */
+#define ARV_FRAME_TIMING_N_BINS			2000
+#define ARV_FRAME_TIMING_BIN_STEP_US		10
+#define ARV_FRAME_TIMING_OFFSET_US		-10000
+
+#define ARV_FRAME_TIMING_GAP_RATIO_DEFAULT	1.5
+
+/* Intervals of one clock, the statistics being stored with plain stores, for arv_stream_declare_info() */
+
+typedef struct {
+	gboolean has_last_time;
+	guint64 last_time_ns;
+
+	double warm_up_us[ARV_FRAME_TIMING_N_WARM_UP_INTERVALS];
+	guint n_warm_up_intervals;
+	double reference_us;
+
+	guint64 n_intervals;
+	double mean_us;
+	double m2;
+	double standard_deviation_us;
+	double min_us;
+	double max_us;
+	guint64 n_gaps;
+} ArvFrameIntervalTracker;
+
+typedef struct {
+	GMutex mutex;
+
+	double expected_period_us;
+	double gap_ratio;
+
+	ArvFrameIntervalTracker trackers[2];
+	/* Deviations from the reference period, one histogram per ArvFrameIntervalSource */
+	ArvStatistic *statistic;
+
+	ArvClockModel *clock_model;
+	double clock_drift_ppm;
+} ArvFrameTiming;
+
+ArvFrameTiming *	arv_frame_timing_new		(void);
+void			arv_frame_timing_free		(ArvFrameTiming *timing);
+
+void			arv_frame_timing_reset		(ArvFrameTiming *timing);
+void			arv_frame_timing_set_expected_period	(ArvFrameTiming *timing, double period_us);
+void			arv_frame_timing_set_gap_ratio	(ArvFrameTiming *timing, double gap_ratio);
+
+void			arv_frame_timing_add_frame	(ArvFrameTiming *timing, guint64 device_time_ns,
+							 guint64 host_time_ns);
+
+gboolean		arv_frame_timing_get_statistics	(ArvFrameTiming *timing, ArvFrameIntervalSource source,
+							 ArvFrameIntervalStatistics *statistics);
+double			arv_frame_timing_get_clock_drift	(ArvFrameTiming *timing);
+
+G_END_DECLS
+
+#endif
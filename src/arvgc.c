@@ -27,9 +27,22 @@
  * #ArvGc implements the root document for the storage of the Genicam feature
  * nodes. It builds the node tree by parsing an xml file in the Genicam
  * standard format. See http://www.genicam.org.
+ *
+ * The instances created from identical GenICam data share a single immutable binary snapshot of the data, which
+ * stands for the node graph, the formulas and the enumeration entries. Each instance only owns its per-device state:
+ * the nodes it actually uses, their register caches and change counts.
+ *
+ * The feature accesses of an instance can be done from several threads. The value reads are done in parallel, while
+ * the value writes and the command executions are serialized with all the other accesses. The state shared between
+ * the parallel readers, like the register caches or the nodes created on demand, is protected by finer grained locks.
  */
 
-#include <arvgc.h>
+#include <arvgcprivate.h>
+#include <arvgcsnapshotprivate.h>
+#include <arvgcxmlindexprivate.h>
+#include <arvgenicamcacheprivate.h>
+#include <arvxmlschemaprivate.h>
+#include <arvgcregistercacheprivate.h>
 #include <arvgcnode.h>
 #include <arvgcpropertynode.h>
 #include <arvgcindexnode.h>
@@ -42,7 +55,8 @@
 #include <arvgcenumentry.h>
 #include <arvgcintegernode.h>
 #include <arvgcfloatnode.h>
-#include <arvgcregisternode.h>
+#include <arvgcregisternodeprivate.h>
+#include <arvgcfeaturenodeprivate.h>
 #include <arvgcintregnode.h>
 #include <arvgcmaskedintregnode.h>
 #include <arvgcfloatregnode.h>
@@ -61,18 +75,62 @@
 #include <arvgcport.h>
 #include <arvbuffer.h>
 #include <arvdebugprivate.h>
+#include <arvmiscprivate.h>
 #include <arvdomparser.h>
+#include <arvdomtext.h>
+#include <arvdomcharacterdataprivate.h>
 #include <string.h>
 #include <stdarg.h>
 #include <stdio.h>
 
+/* Immutable snapshot shared by the genicam instances created from identical GenICam data. The snapshot is NULL while
+ * it is built by the first instance, the other ones waiting for its completion. */
+
+typedef struct {
+	char *key;
+	GBytes *snapshot;
+	gboolean is_building;
+	gint ref_count;
+} ArvGcSharedModel;
+
 typedef struct {
+	/* Indexed by feature names, the keys being the interned names. Looked up with any copy of a name, in a single
+	 * hash lookup. */
 	GHashTable *nodes;
 	ArvDevice *device;
 	ArvBuffer *buffer;
 
+	/* Data of the last event, read through the event ports */
+	guint event_id;
+	GBytes *event_data;
+
 	ArvRegisterCachePolicy cache_policy;
 	ArvRangeCheckPolicy range_check_policy;
+	ArvGcRegisterCache *register_cache;
+
+	/* Register image serving the port accesses instead of the device, and register image filled by the device
+	 * accesses */
+	ArvRegisterSnapshot *register_snapshot;
+	ArvRegisterSnapshot *register_recorder;
+
+	/* Source of the nodes not created yet, either a snapshot or an index of the XML data */
+	ArvGcSnapshot *snapshot;
+	ArvGcXmlIndex *xml_index;
+	ArvDomNode *lazy_root;
+	ArvGcSharedModel *shared_model;
+
+	/* String pool shared by the node names and the text data of the tree */
+	GStringChunk *string_chunk;
+	GHashTable *strings;
+
+	/* Held for reading by the feature reads, and for writing by the feature writes, see arv_gc_access_begin() */
+	GRWLock access_lock;
+	/* Protects the node table, the string pool and the node state updated by the reads */
+	GRecMutex state_mutex;
+
+	/* Stamps of the feature bounds cached on the nodes, see arv_gc_get_generation() */
+	gint generation;
+	gint n_volatile_reads;
 } ArvGcPrivate;
 
 struct _ArvGc {
@@ -274,14 +332,85 @@ arv_gc_create_element (ArvDomDocument *document, const char *tag_name)
 	return ARV_DOM_ELEMENT (node);
 }
 
+static ArvDomText *
+arv_gc_create_text_node (ArvDomDocument *document, const char *data)
+{
+	ArvDomText *text;
+
+	text = g_object_new (ARV_TYPE_DOM_TEXT, NULL);
+	arv_dom_character_data_set_static_data (ARV_DOM_CHARACTER_DATA (text),
+						arv_gc_intern_string (ARV_GC (document), data));
+
+	return text;
+}
+
 /* ArvGc implementation */
 
+/**
+ * arv_gc_intern_string:
+ * @genicam: a #ArvGc object
+ * @string: a string
+ *
+ * Returns the canonical representation of @string in the string pool of @genicam, adding it if needed. Two equal
+ * interned strings have the same address, and stay valid for the life time of @genicam.
+ */
+
+const char *
+arv_gc_intern_string (ArvGc *genicam, const char *string)
+{
+	const char *interned;
+
+	g_return_val_if_fail (ARV_IS_GC (genicam), NULL);
+
+	if (string == NULL)
+		return NULL;
+
+	g_rec_mutex_lock (&genicam->priv->state_mutex);
+
+	interned = g_hash_table_lookup (genicam->priv->strings, string);
+	if (interned == NULL) {
+		interned = g_string_chunk_insert (genicam->priv->string_chunk, string);
+		g_hash_table_add (genicam->priv->strings, (char *) interned);
+	}
+
+	g_rec_mutex_unlock (&genicam->priv->state_mutex);
+
+	return interned;
+}
+
+/**
+ * arv_gc_lookup_interned_string:
+ * @genicam: a #ArvGc object
+ * @string: a string
+ *
+ * Returns: the canonical representation of @string, or %NULL if it was never interned.
+ */
+
+const char *
+arv_gc_lookup_interned_string (ArvGc *genicam, const char *string)
+{
+	const char *interned;
+
+	g_return_val_if_fail (ARV_IS_GC (genicam), NULL);
+
+	if (string == NULL)
+		return NULL;
+
+	g_rec_mutex_lock (&genicam->priv->state_mutex);
+	interned = g_hash_table_lookup (genicam->priv->strings, string);
+	g_rec_mutex_unlock (&genicam->priv->state_mutex);
+
+	return interned;
+}
+
 /**
  * arv_gc_get_node:
  * @genicam: a #ArvGc object
  * @name: node name
  *
- * Retrieves a genicam node by name.
+ * Retrieves a genicam node by name. The returned node is a stable handle on the feature, valid for the lifetime of
+ * @genicam: applications accessing a feature repeatedly, for example from a control loop, should keep it and use the
+ * node API, like arv_gc_float_get_value(), instead of looking the name up at each access.
  *
  * Return value: (transfer none): a #ArvGcNode, null if not found.
  */
@@ -289,10 +418,25 @@ arv_gc_create_element (ArvDomDocument *document, const char *tag_name)
 ArvGcNode *
 arv_gc_get_node	(ArvGc *genicam, const char *name)
 {
+	ArvGcNode *node = NULL;
+
 	g_return_val_if_fail (ARV_IS_GC (genicam), NULL);
 	g_return_val_if_fail (name != NULL, NULL);
 
-	return g_hash_table_lookup (genicam->priv->nodes, name);
+	g_rec_mutex_lock (&genicam->priv->state_mutex);
+
+	node = g_hash_table_lookup (genicam->priv->nodes, name);
+	if (node == NULL &&
+	    ((genicam->priv->snapshot != NULL &&
+	      arv_gc_snapshot_materialize_node (genicam->priv->snapshot, genicam->priv->lazy_root, name)) ||
+	     (genicam->priv->xml_index != NULL &&
+	      arv_gc_xml_index_materialize_node (genicam->priv->xml_index, ARV_DOM_DOCUMENT (genicam),
+						 genicam->priv->lazy_root, name))))
+		node = g_hash_table_lookup (genicam->priv->nodes, name);
+
+	g_rec_mutex_unlock (&genicam->priv->state_mutex);
+
+	return node;
 }
 
 /**
@@ -321,14 +465,16 @@ arv_gc_register_feature_node (ArvGc *genicam, ArvGcFeatureNode *node)
 	g_return_if_fail (ARV_IS_GC_FEATURE_NODE (node));
 
 
-	name = arv_gc_feature_node_get_name (node);
+	name = arv_gc_intern_string (genicam, arv_gc_feature_node_get_name (node));
 	if (name == NULL)
 		return;
 
 	g_object_ref (node);
 
+	g_rec_mutex_lock (&genicam->priv->state_mutex);
 	g_hash_table_remove (genicam->priv->nodes, (char *) name);
 	g_hash_table_insert (genicam->priv->nodes, (char *) name, node);
+	g_rec_mutex_unlock (&genicam->priv->state_mutex);
 
 	arv_debug_genicam ("[Gc::register_feature_node] Register node '%s' [%s]", name,
 			 arv_dom_node_get_node_name (ARV_DOM_NODE (node)));
@@ -363,6 +509,9 @@ arv_gc_set_register_cache_policy (ArvGc *genicam, ArvRegisterCachePolicy policy)
 	g_return_if_fail (ARV_IS_GC (genicam));
 
 	genicam->priv->cache_policy = policy;
+
+	arv_gc_register_cache_flush (genicam->priv->register_cache);
+	arv_gc_increment_generation (genicam);
 }
 
 ArvRegisterCachePolicy
@@ -373,102 +522,1511 @@ arv_gc_get_register_cache_policy (ArvGc *genicam)
 	return genicam->priv->cache_policy;
 }
 
+/* Maximum length of the pValue chains followed by arv_gc_get_feature_register() */
+#define ARV_GC_MAX_LINKED_FEATURE_DEPTH	16
+
+/* Returns the register a feature is linked to, following the pValue chain, or %NULL */
+
+static ArvGcRegisterNode *
+_get_linked_register (ArvGcNode *node)
+{
+	int i;
+
+	for (i = 0; i < ARV_GC_MAX_LINKED_FEATURE_DEPTH && ARV_IS_GC_FEATURE_NODE (node) &&
+	     !ARV_IS_GC_REGISTER_NODE (node); i++)
+		node = ARV_GC_NODE (arv_gc_feature_node_get_linked_feature (ARV_GC_FEATURE_NODE (node)));
+
+	return ARV_IS_GC_REGISTER_NODE (node) ? ARV_GC_REGISTER_NODE (node) : NULL;
+}
+
+ArvGcRegisterNode *
+arv_gc_get_feature_register (ArvGc *genicam, const char *feature)
+{
+	g_return_val_if_fail (ARV_IS_GC (genicam), NULL);
+
+	return _get_linked_register (arv_gc_get_node (genicam, feature));
+}
+
+/* Reads together the registers the features are linked to, so that the next reads of the features don't need a device
+ * access. With the %ARV_REGISTER_CACHE_POLICY_ENABLE policy, the register block cache is filled. Otherwise, the 4 byte
+ * registers are read in a single batch, and the read data is only used by the next read of each feature. */
+
 void
-arv_gc_set_range_check_policy (ArvGc *genicam, ArvRangeCheckPolicy policy)
+arv_gc_prefetch_features (ArvGc *genicam, ArvGcFeatureNode **features, guint n_features)
 {
+	ArvGcRegisterNode **registers;
+	guint n_registers = 0;
+	guint i;
+
 	g_return_if_fail (ARV_IS_GC (genicam));
+	g_return_if_fail (features != NULL || n_features == 0);
 
-	genicam->priv->range_check_policy = policy;
+	registers = g_new (ArvGcRegisterNode *, n_features);
+
+	arv_gc_access_begin (genicam, FALSE);
+
+	for (i = 0; i < n_features; i++) {
+		ArvGcRegisterNode *gc_register = _get_linked_register (ARV_GC_NODE (features[i]));
+
+		if (gc_register != NULL)
+			registers[n_registers++] = gc_register;
+	}
+
+	if (arv_gc_get_register_cache_policy (genicam) == ARV_REGISTER_CACHE_POLICY_ENABLE)
+		arv_gc_register_node_prefetch_blocks (registers, n_registers);
+	else
+		arv_gc_register_node_prefetch (registers, n_registers);
+
+	arv_gc_access_end (genicam);
+
+	g_free (registers);
 }
 
-ArvRangeCheckPolicy
-arv_gc_get_range_check_policy (ArvGc *genicam)
+static gboolean
+_get_register_field (ArvGcNode *node, ArvGcRegisterField *field)
 {
-	g_return_val_if_fail (ARV_IS_GC (genicam), ARV_RANGE_CHECK_POLICY_DISABLE);
+	if (ARV_IS_GC_MASKED_INT_REG_NODE (node))
+		return arv_gc_masked_int_reg_node_get_field (ARV_GC_MASKED_INT_REG_NODE (node), field);
+	if (ARV_IS_GC_STRUCT_ENTRY_NODE (node))
+		return arv_gc_struct_entry_node_get_field (ARV_GC_STRUCT_ENTRY_NODE (node), field);
 
-	return genicam->priv->range_check_policy;
+	return FALSE;
+}
+
+/* Sets several integer features, in order. The MaskedIntReg and StructEntry features which are bit fields of the
+ * same register are written together, at the position of the first one, with a single register write preceded by
+ * at most one read, instead of one read-modify-write per field. The writes stop at the first error. */
+
+gboolean
+arv_gc_set_integer_values (ArvGc *genicam, guint n_features, const char **features, const gint64 *values,
+			   GError **error)
+{
+	ArvGcRegisterField *fields;
+	ArvGcRegisterField *group;
+	ArvGcNode **nodes;
+	GError *local_error = NULL;
+	gboolean *is_field;
+	gboolean *is_done;
+	guint i, j;
+
+	g_return_val_if_fail (ARV_IS_GC (genicam), FALSE);
+	g_return_val_if_fail (n_features == 0 || (features != NULL && values != NULL), FALSE);
+	g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+
+	nodes = g_new0 (ArvGcNode *, n_features);
+	fields = g_new0 (ArvGcRegisterField, n_features);
+	group = g_new0 (ArvGcRegisterField, n_features);
+	is_field = g_new0 (gboolean, n_features);
+	is_done = g_new0 (gboolean, n_features);
+
+	arv_gc_access_begin (genicam, TRUE);
+
+	/* All the features are checked before writing anything */
+	for (i = 0; i < n_features && local_error == NULL; i++) {
+		nodes[i] = arv_gc_get_node (genicam, features[i]);
+		if (!ARV_IS_GC_INTEGER (nodes[i])) {
+			g_set_error (&local_error, ARV_GC_ERROR, ARV_GC_ERROR_NODE_NOT_FOUND,
+				     "[%s] Integer feature not found", features[i]);
+			break;
+		}
+
+		if (!arv_gc_integer_check_range (ARV_GC_INTEGER (nodes[i]), values[i], &local_error))
+			break;
+
+		is_field[i] = _get_register_field (nodes[i], &fields[i]);
+		fields[i].value = values[i];
+	}
+
+	for (i = 0; i < n_features && local_error == NULL; i++) {
+		guint n_fields = 0;
+
+		if (is_done[i])
+			continue;
+
+		if (!is_field[i]) {
+			ARV_GC_INTEGER_GET_IFACE (nodes[i])->set_value (ARV_GC_INTEGER (nodes[i]), values[i],
+								       &local_error);
+			continue;
+		}
+
+		for (j = i; j < n_features; j++) {
+			if (!is_done[j] && is_field[j] &&
+			    arv_gc_register_node_is_same_register (fields[i].register_node, fields[j].register_node)) {
+				group[n_fields++] = fields[j];
+				is_done[j] = TRUE;
+
+				/* Like arv_gc_struct_entry_node_set_integer_value() */
+				if (ARV_IS_GC_STRUCT_ENTRY_NODE (nodes[j]))
+					arv_gc_feature_node_increment_change_count (ARV_GC_FEATURE_NODE (nodes[j]));
+			}
+		}
+
+		arv_gc_register_node_set_fields (fields[i].register_node, group, n_fields, &local_error);
+
+		/* The other nodes of the register, and the nodes they invalidate, are not aware of the write */
+		for (j = 0; j < n_fields; j++) {
+			if (group[j].register_node != fields[i].register_node)
+				arv_gc_feature_node_invalidate (ARV_GC_FEATURE_NODE (group[j].register_node));
+		}
+
+		arv_debug_genicam ("[Gc::set_integer_values] %u field%s of '%s' written at once", n_fields,
+				   n_fields > 1 ? "s" : "",
+				   arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (fields[i].register_node)));
+	}
+
+	arv_gc_access_end (genicam);
+
+	g_free (nodes);
+	g_free (fields);
+	g_free (group);
+	g_free (is_field);
+	g_free (is_done);
+
+	if (local_error != NULL) {
+		g_propagate_error (error, local_error);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+static ArvGcPropertyNode *
+_find_property_node (ArvGcNode *node, ArvGcPropertyNodeType type)
+{
+	ArvDomNode *iter;
+
+	for (iter = arv_dom_node_get_first_child (ARV_DOM_NODE (node));
+	     iter != NULL;
+	     iter = arv_dom_node_get_next_sibling (iter)) {
+		if (ARV_IS_GC_PROPERTY_NODE (iter) &&
+		    arv_gc_property_node_get_node_type (ARV_GC_PROPERTY_NODE (iter)) == type)
+			return ARV_GC_PROPERTY_NODE (iter);
+	}
+
+	return NULL;
+}
+
+/* Returns the value node of an Integer or Float node with a pIndex, for the given index value */
+
+static ArvGcPropertyNode *
+_find_value_indexed_node (ArvGcNode *node, gint64 index)
+{
+	ArvDomNode *iter;
+	ArvGcPropertyNode *value_default;
+
+	for (iter = arv_dom_node_get_first_child (ARV_DOM_NODE (node));
+	     iter != NULL;
+	     iter = arv_dom_node_get_next_sibling (iter)) {
+		if (ARV_IS_GC_VALUE_INDEXED_NODE (iter) &&
+		    arv_gc_value_indexed_node_get_index (ARV_GC_VALUE_INDEXED_NODE (iter)) == index)
+			return ARV_GC_PROPERTY_NODE (iter);
+	}
+
+	value_default = _find_property_node (node, ARV_GC_PROPERTY_NODE_TYPE_VALUE_DEFAULT);
+	if (value_default == NULL)
+		value_default = _find_property_node (node, ARV_GC_PROPERTY_NODE_TYPE_P_VALUE_DEFAULT);
+
+	return value_default;
+}
+
+/* The indexes usually refer to the integer node of an enumeration selector, which has the same value */
+
+static ArvGcNode *
+_get_selector_value_node (ArvGcFeatureNode *selector)
+{
+	ArvGcPropertyNode *property_node;
+
+	if (!ARV_IS_GC_ENUMERATION (selector))
+		return ARV_GC_NODE (selector);
+
+	property_node = _find_property_node (ARV_GC_NODE (selector), ARV_GC_PROPERTY_NODE_TYPE_P_VALUE);
+	if (property_node != NULL && ARV_IS_GC_INTEGER_NODE (arv_gc_property_node_get_linked_node (property_node)))
+		return arv_gc_property_node_get_linked_node (property_node);
+
+	return ARV_GC_NODE (selector);
+}
+
+/* Follows the plain pValue chain of Integer, Float and Enumeration nodes, without any value transformation */
+
+static ArvGcNode *
+_get_plain_value_node (ArvGcNode *node)
+{
+	int depth;
+
+	for (depth = 0; depth < ARV_GC_MAX_LINKED_FEATURE_DEPTH &&
+	     (ARV_IS_GC_INTEGER_NODE (node) || ARV_IS_GC_FLOAT_NODE (node) ||
+	      (depth == 0 && ARV_IS_GC_ENUMERATION (node))); depth++) {
+		ArvGcPropertyNode *property_node;
+
+		property_node = _find_property_node (node, ARV_GC_PROPERTY_NODE_TYPE_P_VALUE);
+		if (property_node == NULL)
+			break;
+		node = arv_gc_property_node_get_linked_node (property_node);
+	}
+
+	return node;
 }
 
 static void
-_weak_notify_cb (gpointer data, GObject *object)
+_decode_register_value (ArvGcNode *node, const guint8 *data, gint64 length, gboolean is_float, GValue *value)
 {
-	ArvGc *genicam = data;
+	ArvGcPropertyNode *property_node;
+	guint endianness;
+
+	endianness = arv_gc_property_node_get_endianness
+		(_find_property_node (node, ARV_GC_PROPERTY_NODE_TYPE_ENDIANNESS), G_LITTLE_ENDIAN);
+
+	if (ARV_IS_GC_FLOAT_REG_NODE (node)) {
+		double v_double = 0.0;
+
+		if (length == 4) {
+			float v_float = 0.0;
+
+			arv_copy_memory_with_endianness (&v_float, sizeof (v_float), G_BYTE_ORDER,
+							(void *) data, length, endianness);
+			v_double = v_float;
+		} else
+			arv_copy_memory_with_endianness (&v_double, sizeof (v_double), G_BYTE_ORDER,
+							(void *) data, length, endianness);
+
+		g_value_init (value, G_TYPE_DOUBLE);
+		g_value_set_double (value, v_double);
+	} else {
+		ArvGcSignedness signedness;
+		gint64 v_int64;
+		guint lsb = 0;
+		guint msb = 31;
+
+		signedness = arv_gc_property_node_get_sign
+			(_find_property_node (node, ARV_GC_PROPERTY_NODE_TYPE_SIGN), ARV_GC_SIGNEDNESS_UNSIGNED);
+
+		if (ARV_IS_GC_MASKED_INT_REG_NODE (node)) {
+			property_node = _find_property_node (node, ARV_GC_PROPERTY_NODE_TYPE_BIT);
+			if (property_node != NULL) {
+				lsb = arv_gc_property_node_get_lsb (property_node, 0);
+				msb = lsb;
+			} else {
+				lsb = arv_gc_property_node_get_lsb
+					(_find_property_node (node, ARV_GC_PROPERTY_NODE_TYPE_LSB), 0);
+				msb = arv_gc_property_node_get_msb
+					(_find_property_node (node, ARV_GC_PROPERTY_NODE_TYPE_MSB), 31);
+			}
+		}
+
+		v_int64 = arv_gc_register_node_decode_integer_value (data, length, lsb, msb, signedness, endianness,
+								     ARV_IS_GC_MASKED_INT_REG_NODE (node));
+
+		if (is_float) {
+			g_value_init (value, G_TYPE_DOUBLE);
+			g_value_set_double (value, v_int64);
+		} else {
+			g_value_init (value, G_TYPE_INT64);
+			g_value_set_int64 (value, v_int64);
+		}
+	}
+}
 
-	genicam->priv->buffer = NULL;
+/*
+ * arv_gc_read_feature_for_selector:
+ * @genicam: a #ArvGc
+ * @feature: an Integer, Float or Enumeration feature
+ * @selector: a selector of @feature
+ * @selector_values: (array length=n_selector_values): the selector values
+ * @n_selector_values: the number of selector values
+ * @values: (array length=n_selector_values): zero filled #GValue placeholders
+ * @error: a #GError placeholder
+ *
+ * Reads the value of @feature for each selector value, without changing the selector, when this can be done by
+ * computing the selected values locations: Integer and Float nodes with a pIndex linked to @selector, or a pValue
+ * chain of Integer and Float nodes ending on an IntReg, MaskedIntReg or FloatReg register with a pIndex linked to
+ * @selector. The values are then returned as #G_TYPE_INT64 for Integer features, #G_TYPE_DOUBLE for Float features,
+ * and as the entry names for Enumeration features, like the polled feature values.
+ *
+ * Returns: %TRUE if the values were read, %FALSE on error or if the feature doesn't allow a direct read, in which case
+ * @error is not set, and @values are left uninitialized.
+ */
+
+gboolean
+arv_gc_read_feature_for_selector (ArvGc *genicam, ArvGcFeatureNode *feature, ArvGcFeatureNode *selector,
+				  const gint64 *selector_values, guint n_selector_values, GValue *values,
+				  GError **error)
+{
+	ArvGcPropertyNode *property_node;
+	ArvGcNode *node = ARV_GC_NODE (feature);
+	ArvGcNode *selector_value_node;
+	GError *local_error = NULL;
+	gboolean is_float = FALSE;
+	guint8 *data = NULL;
+	gint64 length = 0;
+	guint i;
+
+	g_return_val_if_fail (ARV_IS_GC (genicam), FALSE);
+	g_return_val_if_fail (ARV_IS_GC_FEATURE_NODE (feature), FALSE);
+	g_return_val_if_fail (ARV_IS_GC_FEATURE_NODE (selector), FALSE);
+	g_return_val_if_fail (selector_values != NULL || n_selector_values == 0, FALSE);
+	g_return_val_if_fail (values != NULL || n_selector_values == 0, FALSE);
+	g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+
+	if (ARV_IS_GC_FLOAT_NODE (node) || ARV_IS_GC_FLOAT_REG_NODE (node))
+		is_float = TRUE;
+	else if (!ARV_IS_GC_INTEGER_NODE (node) && !ARV_IS_GC_ENUMERATION (node) &&
+		 !ARV_IS_GC_INT_REG_NODE (node) && !ARV_IS_GC_MASKED_INT_REG_NODE (node))
+		return FALSE;
+
+	selector_value_node = _get_selector_value_node (selector);
+
+	arv_gc_access_begin (genicam, FALSE);
+
+	property_node = _find_property_node (node, ARV_GC_PROPERTY_NODE_TYPE_P_INDEX);
+	if (!ARV_IS_GC_ENUMERATION (node) && property_node != NULL &&
+	    (arv_gc_property_node_get_linked_node (property_node) == ARV_GC_NODE (selector) ||
+	     arv_gc_property_node_get_linked_node (property_node) == selector_value_node) &&
+	    _find_property_node (node, ARV_GC_PROPERTY_NODE_TYPE_P_VALUE) == NULL &&
+	    _find_property_node (node, ARV_GC_PROPERTY_NODE_TYPE_VALUE) == NULL) {
+		for (i = 0; i < n_selector_values; i++) {
+			ArvGcPropertyNode *value_node = _find_value_indexed_node (node, selector_values[i]);
+
+			if (value_node == NULL) {
+				g_set_error (&local_error, ARV_GC_ERROR, ARV_GC_ERROR_PROPERTY_NOT_DEFINED,
+					     "[%s] No value for %s = %" G_GINT64_FORMAT,
+					     arv_gc_feature_node_get_name (feature),
+					     arv_gc_feature_node_get_name (selector), selector_values[i]);
+				break;
+			}
+
+			if (is_float) {
+				g_value_init (&values[i], G_TYPE_DOUBLE);
+				g_value_set_double (&values[i], arv_gc_property_node_get_double (value_node,
+												 &local_error));
+			} else {
+				g_value_init (&values[i], G_TYPE_INT64);
+				g_value_set_int64 (&values[i], arv_gc_property_node_get_int64 (value_node,
+											       &local_error));
+			}
+
+			if (local_error != NULL) {
+				g_value_unset (&values[i]);
+				break;
+			}
+		}
+
+		arv_gc_access_end (genicam);
+
+		if (local_error != NULL) {
+			while (i > 0)
+				g_value_unset (&values[--i]);
+			g_propagate_error (error, local_error);
+			return FALSE;
+		}
+
+		return TRUE;
+	}
+
+	node = _get_plain_value_node (node);
+
+	if (ARV_IS_GC_INT_REG_NODE (node) ||
+	    ARV_IS_GC_MASKED_INT_REG_NODE (node) ||
+	    (is_float && ARV_IS_GC_FLOAT_REG_NODE (node))) {
+		data = arv_gc_register_node_read_for_selector (ARV_GC_REGISTER_NODE (node), ARV_GC_NODE (selector),
+							       selector_values, n_selector_values, &length,
+							       &local_error);
+		if (data == NULL && local_error == NULL && selector_value_node != ARV_GC_NODE (selector))
+			data = arv_gc_register_node_read_for_selector (ARV_GC_REGISTER_NODE (node),
+								       selector_value_node,
+								       selector_values, n_selector_values,
+								       &length, &local_error);
+	}
+
+	arv_gc_access_end (genicam);
+
+	if (local_error != NULL) {
+		g_propagate_error (error, local_error);
+		return FALSE;
+	}
+
+	if (data == NULL)
+		return FALSE;
+
+	if ((ARV_IS_GC_FLOAT_REG_NODE (node) && length != 4 && length != 8) || length > 8) {
+		g_free (data);
+		return FALSE;
+	}
+
+	for (i = 0; i < n_selector_values; i++)
+		_decode_register_value (node, data + i * length, length, is_float, &values[i]);
+
+	g_free (data);
+
+	if (ARV_IS_GC_ENUMERATION (feature)) {
+		for (i = 0; i < n_selector_values && local_error == NULL; i++) {
+			const GSList *iter;
+			gint64 value = g_value_get_int64 (&values[i]);
+
+			g_value_unset (&values[i]);
+
+			for (iter = arv_gc_enumeration_get_entries (ARV_GC_ENUMERATION (feature));
+			     iter != NULL; iter = iter->next) {
+				if (arv_gc_enum_entry_get_value (iter->data, NULL) == value) {
+					g_value_init (&values[i], G_TYPE_STRING);
+					g_value_set_string (&values[i],
+							    arv_gc_feature_node_get_name (iter->data));
+					break;
+				}
+			}
+
+			if (iter == NULL)
+				g_set_error (&local_error, ARV_GC_ERROR, ARV_GC_ERROR_ENUM_ENTRY_NOT_FOUND,
+					     "[%s] Entry not found for value %" G_GINT64_FORMAT,
+					     arv_gc_feature_node_get_name (feature), value);
+		}
+
+		if (local_error != NULL) {
+			guint j;
+
+			for (j = 0; j + 1 < i; j++)
+				g_value_unset (&values[j]);
+			for (j = i; j < n_selector_values; j++)
+				g_value_unset (&values[j]);
+
+			g_propagate_error (error, local_error);
+			return FALSE;
+		}
+	}
+
+	return TRUE;
 }
 
-void
-arv_gc_set_buffer (ArvGc *genicam, ArvBuffer *buffer)
+/*
+ * arv_gc_write_integer_feature_for_selector:
+ * @genicam: a #ArvGc
+ * @feature: an Integer feature
+ * @selector: a selector of @feature
+ * @selector_values: (array length=n_selector_values): the selector values
+ * @n_selector_values: the number of selector values
+ * @values: (array length=n_selector_values): the feature values
+ * @error: a #GError placeholder
+ *
+ * Writes the value of @feature for each selector value, without changing the selector, when @feature, or the end of
+ * its plain pValue chain of Integer nodes, is an IntReg register with a pIndex linked to @selector, which is the
+ * pattern of the LUTValue/LUTIndex like tables. The values of contiguous registers are written using a single port
+ * access.
+ *
+ * Returns: %TRUE if the values were written, %FALSE on error or if the feature doesn't allow a direct write, in which
+ * case @error is not set.
+ */
+
+gboolean
+arv_gc_write_integer_feature_for_selector (ArvGc *genicam, ArvGcFeatureNode *feature, ArvGcFeatureNode *selector,
+					   const gint64 *selector_values, guint n_selector_values,
+					   const gint64 *values, GError **error)
 {
-	g_return_if_fail (ARV_IS_GC (genicam));
-	g_return_if_fail (ARV_IS_BUFFER (buffer));
+	ArvGcNode *node;
+	ArvGcNode *selector_value_node;
+	GError *local_error = NULL;
+	gboolean success = FALSE;
+	guint8 *data;
+	guint endianness;
+	gint64 length;
+	guint i;
+
+	g_return_val_if_fail (ARV_IS_GC (genicam), FALSE);
+	g_return_val_if_fail (ARV_IS_GC_FEATURE_NODE (feature), FALSE);
+	g_return_val_if_fail (ARV_IS_GC_FEATURE_NODE (selector), FALSE);
+	g_return_val_if_fail (selector_values != NULL || n_selector_values == 0, FALSE);
+	g_return_val_if_fail (values != NULL || n_selector_values == 0, FALSE);
+	g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+
+	if (!ARV_IS_GC_INTEGER_NODE (feature) && !ARV_IS_GC_INT_REG_NODE (feature))
+		return FALSE;
+
+	node = _get_plain_value_node (ARV_GC_NODE (feature));
+	if (!ARV_IS_GC_INT_REG_NODE (node) ||
+	    _find_property_node (ARV_GC_NODE (feature), ARV_GC_PROPERTY_NODE_TYPE_P_INDEX) != NULL)
+		return FALSE;
+
+	selector_value_node = _get_selector_value_node (selector);
+
+	arv_gc_access_begin (genicam, TRUE);
+
+	for (i = 0; i < n_selector_values; i++)
+		if (!arv_gc_integer_check_range (ARV_GC_INTEGER (feature), values[i], &local_error))
+			break;
+
+	length = local_error == NULL ? arv_gc_register_get_length (ARV_GC_REGISTER (node), &local_error) : 0;
+
+	if (local_error != NULL || length < 1 || length > 8) {
+		arv_gc_access_end (genicam);
+		if (local_error != NULL)
+			g_propagate_error (error, local_error);
+		return FALSE;
+	}
 
-	if (genicam->priv->buffer != NULL)
-		g_object_weak_unref (G_OBJECT (genicam->priv->buffer), _weak_notify_cb, genicam);
+	endianness = arv_gc_property_node_get_endianness
+		(_find_property_node (node, ARV_GC_PROPERTY_NODE_TYPE_ENDIANNESS), G_LITTLE_ENDIAN);
 
-	g_object_weak_ref (G_OBJECT (buffer), _weak_notify_cb, genicam);
+	data = g_malloc (n_selector_values * length);
+	for (i = 0; i < n_selector_values; i++)
+		arv_copy_memory_with_endianness (data + i * length, length, endianness,
+						(void *) &values[i], sizeof (values[i]), G_BYTE_ORDER);
 
-	genicam->priv->buffer = buffer;
+	success = arv_gc_register_node_write_for_selector (ARV_GC_REGISTER_NODE (node), ARV_GC_NODE (selector),
+							   selector_values, n_selector_values, data, length,
+							   &local_error);
+	if (!success && local_error == NULL && selector_value_node != ARV_GC_NODE (selector))
+		success = arv_gc_register_node_write_for_selector (ARV_GC_REGISTER_NODE (node), selector_value_node,
+								   selector_values, n_selector_values, data, length,
+								   &local_error);
+
+	/* Like a write of the feature, which doesn't go through its set_value implementation */
+	if (success && node != ARV_GC_NODE (feature))
+		arv_gc_feature_node_increment_change_count (feature);
+
+	arv_gc_access_end (genicam);
+
+	g_free (data);
+
+	if (local_error != NULL) {
+		g_propagate_error (error, local_error);
+		return FALSE;
+	}
+
+	return success;
 }
 
 /**
- * arv_gc_get_buffer:
+ * arv_gc_get_feature_statistics:
  * @genicam: a #ArvGc object
+ * @feature: feature name
+ * @n_reads: (out) (optional): number of register reads
+ * @n_writes: (out) (optional): number of register writes
+ * @n_cache_hits: (out) (optional): number of reads served by the register cache
+ * @n_cache_misses: (out) (optional): number of reads not served by the register cache
+ * @port_time_us: (out) (optional): cumulative time spent in port accesses, in µs
  *
- * Retrieves the binded buffer.
+ * Retrieves the register access statistics of a feature, since the document creation or the last call to
+ * arv_gc_reset_feature_statistics(). For features which are not registers, like an Integer with a pValue, the
+ * statistics of the register they are linked to are returned. Cache hits and misses are only counted when the
+ * register cache is not disabled.
  *
- * Return value: (transfer none): a #ArvBuffer.
+ * Returns: %TRUE if a register was found for @feature. Otherwise, the statistics are set to 0.
+ *
+ * Since: 0.8.11
  */
 
-ArvBuffer *
-arv_gc_get_buffer (ArvGc *genicam)
+gboolean
+arv_gc_get_feature_statistics (ArvGc *genicam, const char *feature,
+			       guint64 *n_reads, guint64 *n_writes,
+			       guint64 *n_cache_hits, guint64 *n_cache_misses,
+			       guint64 *port_time_us)
+{
+	ArvGcRegisterNode *node;
+
+	g_return_val_if_fail (ARV_IS_GC (genicam), FALSE);
+
+	node = arv_gc_get_feature_register (genicam, feature);
+
+	if (node == NULL) {
+		if (n_reads != NULL)
+			*n_reads = 0;
+		if (n_writes != NULL)
+			*n_writes = 0;
+		if (n_cache_hits != NULL)
+			*n_cache_hits = 0;
+		if (n_cache_misses != NULL)
+			*n_cache_misses = 0;
+		if (port_time_us != NULL)
+			*port_time_us = 0;
+
+		return FALSE;
+	}
+
+	arv_gc_register_node_get_statistics (node, n_reads, n_writes,
+					     n_cache_hits, n_cache_misses, port_time_us);
+
+	return TRUE;
+}
+
+/**
+ * arv_gc_reset_feature_statistics:
+ * @genicam: a #ArvGc object
+ *
+ * Resets the register access statistics of all the features.
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_gc_reset_feature_statistics (ArvGc *genicam)
+{
+	GHashTableIter iter;
+	gpointer value;
+
+	g_return_if_fail (ARV_IS_GC (genicam));
+
+	g_hash_table_iter_init (&iter, genicam->priv->nodes);
+	while (g_hash_table_iter_next (&iter, NULL, &value))
+		if (ARV_IS_GC_REGISTER_NODE (value))
+			arv_gc_register_node_reset_statistics (value);
+}
+
+/* Register block cache, shared by all the register nodes of the document */
+
+ArvGcRegisterCache *
+arv_gc_get_register_cache (ArvGc *genicam)
 {
 	g_return_val_if_fail (ARV_IS_GC (genicam), NULL);
 
-	return genicam->priv->buffer;
+	return genicam->priv->register_cache;
 }
 
-ArvGc *
-arv_gc_new (ArvDevice *device, const void *xml, size_t size)
+/* Drops all the cached register values, after registers were written behind the back of the node tree */
+
+void
+arv_gc_invalidate_registers (ArvGc *genicam)
 {
-	ArvDomDocument *document;
-	ArvGc *genicam;
+	GHashTableIter iter;
+	gpointer value;
 
-	document = arv_dom_document_new_from_memory (xml, size, NULL);
-	if (!ARV_IS_GC (document)) {
-		if (document != NULL)
-			g_object_unref (document);
-		return NULL;
-	}
+	g_return_if_fail (ARV_IS_GC (genicam));
 
-	genicam = ARV_GC (document);
-	genicam->priv->device = device;
+	arv_gc_access_begin (genicam, TRUE);
 
-	return genicam;
+	g_hash_table_iter_init (&iter, genicam->priv->nodes);
+	while (g_hash_table_iter_next (&iter, NULL, &value))
+		if (ARV_IS_GC_REGISTER_NODE (value))
+			arv_gc_feature_node_invalidate (ARV_GC_FEATURE_NODE (value));
+
+	arv_gc_register_cache_flush (genicam->priv->register_cache);
+
+	arv_gc_access_end (genicam);
 }
 
-G_DEFINE_TYPE_WITH_CODE (ArvGc, arv_gc, ARV_TYPE_DOM_DOCUMENT, G_ADD_PRIVATE (ArvGc))
+/* Change counter of the document, incremented each time a feature node is changed or invalidated, and when the
+ * register cache policy is changed. The feature bounds cached on the nodes are only valid for the generation in
+ * which they were computed. */
 
-static void
-arv_gc_init (ArvGc *genicam)
+guint
+arv_gc_get_generation (ArvGc *genicam)
 {
-	genicam->priv = arv_gc_get_instance_private (genicam);
+	g_return_val_if_fail (ARV_IS_GC (genicam), 0);
 
-	genicam->priv->nodes = g_hash_table_new_full (g_str_hash, g_str_equal, NULL, g_object_unref);
-	genicam->priv->cache_policy = ARV_REGISTER_CACHE_POLICY_DISABLE;
+	return g_atomic_int_get (&genicam->priv->generation);
+}
+
+void
+arv_gc_increment_generation (ArvGc *genicam)
+{
+	g_return_if_fail (ARV_IS_GC (genicam));
+
+	g_atomic_int_inc (&genicam->priv->generation);
+}
+
+/* Counter of the reads of non cachable registers, which values may change without the node tree knowing. A value
+ * computed while it was incremented can't be cached. */
+
+guint
+arv_gc_get_n_volatile_reads (ArvGc *genicam)
+{
+	g_return_val_if_fail (ARV_IS_GC (genicam), 0);
+
+	return g_atomic_int_get (&genicam->priv->n_volatile_reads);
+}
+
+void
+arv_gc_increment_n_volatile_reads (ArvGc *genicam)
+{
+	if (genicam == NULL)
+		return;
+
+	g_atomic_int_inc (&genicam->priv->n_volatile_reads);
 }
 
+/* Accesses in progress in the current thread, one per document. The document locks are not recursive, the nested
+ * accesses of a document, like the reads of the nodes a formula depends on, are covered by the outermost one. */
+
+typedef struct {
+	ArvGc *genicam;
+	guint depth;
+	gboolean exclusive;
+	/* Buffer read by the chunk ports during this access, see arv_gc_access_bind_buffer() */
+	ArvBuffer *buffer;
+	/* Port writes done on behalf of a selector feature, see arv_gc_access_set_selector_write() */
+	gboolean is_selector_write;
+} ArvGcAccess;
+
+/* A thread rarely accesses more than one document at a time, the accesses are stored in a per thread array,
+ * allocated on the first access of the thread, which only grows for the accesses of more than
+ * ARV_GC_N_PREALLOCATED_ACCESSES documents at once. The feature accesses don't allocate memory. */
+
+#define ARV_GC_N_PREALLOCATED_ACCESSES	4
+
+typedef struct {
+	ArvGcAccess *accesses;
+	guint n_accesses;
+	guint n_allocated_accesses;
+	ArvGcAccess preallocated_accesses[ARV_GC_N_PREALLOCATED_ACCESSES];
+} ArvGcAccesses;
+
 static void
-arv_gc_finalize (GObject *object)
+_accesses_free (gpointer data)
 {
-	ArvGc *genicam = ARV_GC (object);
+	ArvGcAccesses *accesses = data;
 
-	if (genicam->priv->buffer != NULL)
-		g_object_weak_unref (G_OBJECT (genicam->priv->buffer), _weak_notify_cb, genicam);
+	if (accesses->accesses != accesses->preallocated_accesses)
+		g_free (accesses->accesses);
+	g_free (accesses);
+}
 
-	g_hash_table_unref (genicam->priv->nodes);
+static GPrivate arv_gc_accesses = G_PRIVATE_INIT (_accesses_free);
 
-	G_OBJECT_CLASS (arv_gc_parent_class)->finalize (object);
+static ArvGcAccesses *
+_get_accesses (void)
+{
+	ArvGcAccesses *accesses = g_private_get (&arv_gc_accesses);
+
+	if (G_UNLIKELY (accesses == NULL)) {
+		accesses = g_new0 (ArvGcAccesses, 1);
+		accesses->accesses = accesses->preallocated_accesses;
+		accesses->n_allocated_accesses = ARV_GC_N_PREALLOCATED_ACCESSES;
+		g_private_set (&arv_gc_accesses, accesses);
+	}
+
+	return accesses;
+}
+
+static ArvGcAccess *
+_find_access (ArvGc *genicam)
+{
+	ArvGcAccesses *accesses = g_private_get (&arv_gc_accesses);
+	guint i;
+
+	if (accesses == NULL)
+		return NULL;
+
+	for (i = 0; i < accesses->n_accesses; i++)
+		if (accesses->accesses[i].genicam == genicam)
+			return &accesses->accesses[i];
+
+	return NULL;
+}
+
+/**
+ * arv_gc_access_begin:
+ * @genicam: (allow-none): a #ArvGc object
+ * @exclusive: %TRUE for a write access
+ *
+ * Starts a feature access. The reads run concurrently with the other reads, the exclusive accesses wait for all the
+ * other accesses to end. An access nested in an access of the same thread doesn't wait. A write nested in a read
+ * can't be made exclusive, it is only serialized with the other writes. Does nothing if @genicam is %NULL, for the
+ * nodes outside of a document.
+ */
+
+void
+arv_gc_access_begin (ArvGc *genicam, gboolean exclusive)
+{
+	ArvGcAccesses *accesses;
+	ArvGcAccess *access;
+
+	if (genicam == NULL)
+		return;
+
+	access = _find_access (genicam);
+	if (access != NULL) {
+		if (exclusive && !access->exclusive)
+			arv_debug_genicam ("[Gc::access_begin] Write nested in a read access");
+		access->depth++;
+		return;
+	}
+
+	if (exclusive)
+		g_rw_lock_writer_lock (&genicam->priv->access_lock);
+	else
+		g_rw_lock_reader_lock (&genicam->priv->access_lock);
+
+	accesses = _get_accesses ();
+	if (G_UNLIKELY (accesses->n_accesses == accesses->n_allocated_accesses)) {
+		ArvGcAccess *allocated_accesses = g_new (ArvGcAccess, 2 * accesses->n_allocated_accesses);
+
+		memcpy (allocated_accesses, accesses->accesses, accesses->n_accesses * sizeof (ArvGcAccess));
+		if (accesses->accesses != accesses->preallocated_accesses)
+			g_free (accesses->accesses);
+		accesses->accesses = allocated_accesses;
+		accesses->n_allocated_accesses *= 2;
+	}
+
+	access = &accesses->accesses[accesses->n_accesses++];
+	access->genicam = genicam;
+	access->depth = 1;
+	access->exclusive = exclusive;
+	access->buffer = NULL;
+	access->is_selector_write = FALSE;
+}
+
+/**
+ * arv_gc_access_end:
+ * @genicam: (allow-none): a #ArvGc object
+ *
+ * Ends a feature access started by arv_gc_access_begin().
+ */
+
+void
+arv_gc_access_end (ArvGc *genicam)
+{
+	ArvGcAccesses *accesses;
+	ArvGcAccess *access;
+	gboolean exclusive;
+
+	if (genicam == NULL)
+		return;
+
+	access = _find_access (genicam);
+	g_return_if_fail (access != NULL);
+
+	access->depth--;
+	if (access->depth > 0)
+		return;
+
+	exclusive = access->exclusive;
+
+	/* The accesses of the different documents may end in any order, the last one takes the free place */
+	accesses = g_private_get (&arv_gc_accesses);
+	*access = accesses->accesses[--accesses->n_accesses];
+
+	if (exclusive)
+		g_rw_lock_writer_unlock (&genicam->priv->access_lock);
+	else
+		g_rw_lock_reader_unlock (&genicam->priv->access_lock);
+}
+
+/**
+ * arv_gc_access_bind_buffer:
+ * @genicam: a #ArvGc object
+ * @buffer: (allow-none): a #ArvBuffer
+ *
+ * Binds @buffer to the current access of the calling thread. Until the end of the access, the chunk ports read
+ * the chunk data of @buffer instead of the buffer set by arv_gc_set_buffer(), which allows several threads to parse
+ * the chunks of different buffers with the same document. Must be called between arv_gc_access_begin() and
+ * arv_gc_access_end(). The caller keeps the ownership of @buffer.
+ *
+ * Returns: (transfer none): the previously bound buffer, to be restored after a nested binding.
+ */
+
+ArvBuffer *
+arv_gc_access_bind_buffer (ArvGc *genicam, ArvBuffer *buffer)
+{
+	ArvGcAccess *access;
+	ArvBuffer *previous;
+
+	g_return_val_if_fail (ARV_IS_GC (genicam), NULL);
+
+	access = _find_access (genicam);
+	g_return_val_if_fail (access != NULL, NULL);
+
+	previous = access->buffer;
+	access->buffer = buffer;
+
+	return previous;
+}
+
+/**
+ * arv_gc_access_set_selector_write:
+ * @genicam: (allow-none): a #ArvGc object
+ * @is_selector_write: %TRUE during the write of a selector feature
+ *
+ * Marks the port writes of the current access of the calling thread as the writes of a selector feature, which
+ * change the meaning of the registers written after them, see arv_device_journal_write(). Must be called between
+ * arv_gc_access_begin() and arv_gc_access_end().
+ *
+ * Returns: the previous state, to be restored after the selector write.
+ */
+
+gboolean
+arv_gc_access_set_selector_write (ArvGc *genicam, gboolean is_selector_write)
+{
+	ArvGcAccess *access;
+	gboolean previous;
+
+	if (genicam == NULL)
+		return FALSE;
+
+	access = _find_access (genicam);
+	g_return_val_if_fail (access != NULL, FALSE);
+
+	previous = access->is_selector_write;
+	access->is_selector_write = is_selector_write;
+
+	return previous;
+}
+
+gboolean
+arv_gc_access_is_selector_write (ArvGc *genicam)
+{
+	ArvGcAccess *access;
+
+	if (genicam == NULL)
+		return FALSE;
+
+	access = _find_access (genicam);
+
+	return access != NULL && access->is_selector_write;
+}
+
+/* Short critical sections on the node state modified by the reads, never held during a port access */
+
+void
+arv_gc_lock_state (ArvGc *genicam)
+{
+	if (genicam != NULL)
+		g_rec_mutex_lock (&genicam->priv->state_mutex);
+}
+
+void
+arv_gc_unlock_state (ArvGc *genicam)
+{
+	if (genicam != NULL)
+		g_rec_mutex_unlock (&genicam->priv->state_mutex);
+}
+
+/**
+ * arv_gc_set_register_snapshot:
+ * @genicam: a #ArvGc object
+ * @snapshot: (allow-none): a #ArvRegisterSnapshot, %NULL to access the device again
+ *
+ * Replaces the device by @snapshot for all the port accesses of the document. The register reads are served from the
+ * snapshot, failing with %ARV_GC_ERROR_NOT_IN_SNAPSHOT for the registers not in it, and the writes are applied to the
+ * snapshot and recorded by arv_register_snapshot_write(). The document doesn't need a device in this mode.
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_gc_set_register_snapshot (ArvGc *genicam, ArvRegisterSnapshot *snapshot)
+{
+	g_return_if_fail (ARV_IS_GC (genicam));
+	g_return_if_fail (snapshot == NULL || ARV_IS_REGISTER_SNAPSHOT (snapshot));
+
+	if (snapshot != NULL)
+		g_object_ref (snapshot);
+	g_clear_object (&genicam->priv->register_snapshot);
+	genicam->priv->register_snapshot = snapshot;
+
+	arv_gc_invalidate_registers (genicam);
+}
+
+/**
+ * arv_gc_get_register_snapshot:
+ * @genicam: a #ArvGc object
+ *
+ * Returns: (transfer none): the snapshot set by arv_gc_set_register_snapshot(), or %NULL.
+ *
+ * Since: 0.8.11
+ */
+
+ArvRegisterSnapshot *
+arv_gc_get_register_snapshot (ArvGc *genicam)
+{
+	g_return_val_if_fail (ARV_IS_GC (genicam), NULL);
+
+	return genicam->priv->register_snapshot;
+}
+
+/**
+ * arv_gc_set_register_recorder:
+ * @genicam: a #ArvGc object
+ * @recorder: (allow-none): a #ArvRegisterSnapshot, %NULL to stop recording
+ *
+ * Stores all the data read from the device through the ports of the document into @recorder, and records the
+ * writes. The resulting snapshot can later be used with arv_gc_set_register_snapshot() to evaluate the same features
+ * without the device.
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_gc_set_register_recorder (ArvGc *genicam, ArvRegisterSnapshot *recorder)
+{
+	g_return_if_fail (ARV_IS_GC (genicam));
+	g_return_if_fail (recorder == NULL || ARV_IS_REGISTER_SNAPSHOT (recorder));
+
+	if (recorder != NULL)
+		g_object_ref (recorder);
+	g_clear_object (&genicam->priv->register_recorder);
+	genicam->priv->register_recorder = recorder;
+}
+
+/**
+ * arv_gc_get_register_recorder:
+ * @genicam: a #ArvGc object
+ *
+ * Returns: (transfer none): the recorder set by arv_gc_set_register_recorder(), or %NULL.
+ *
+ * Since: 0.8.11
+ */
+
+ArvRegisterSnapshot *
+arv_gc_get_register_recorder (ArvGc *genicam)
+{
+	g_return_val_if_fail (ARV_IS_GC (genicam), NULL);
+
+	return genicam->priv->register_recorder;
+}
+
+void
+arv_gc_set_range_check_policy (ArvGc *genicam, ArvRangeCheckPolicy policy)
+{
+	g_return_if_fail (ARV_IS_GC (genicam));
+
+	genicam->priv->range_check_policy = policy;
+}
+
+ArvRangeCheckPolicy
+arv_gc_get_range_check_policy (ArvGc *genicam)
+{
+	g_return_val_if_fail (ARV_IS_GC (genicam), ARV_RANGE_CHECK_POLICY_DISABLE);
+
+	return genicam->priv->range_check_policy;
+}
+
+static void
+_weak_notify_cb (gpointer data, GObject *object)
+{
+	ArvGc *genicam = data;
+
+	genicam->priv->buffer = NULL;
+}
+
+void
+arv_gc_set_buffer (ArvGc *genicam, ArvBuffer *buffer)
+{
+	g_return_if_fail (ARV_IS_GC (genicam));
+	g_return_if_fail (ARV_IS_BUFFER (buffer));
+
+	if (genicam->priv->buffer != NULL)
+		g_object_weak_unref (G_OBJECT (genicam->priv->buffer), _weak_notify_cb, genicam);
+
+	g_object_weak_ref (G_OBJECT (buffer), _weak_notify_cb, genicam);
+
+	genicam->priv->buffer = buffer;
+}
+
+/**
+ * arv_gc_get_buffer:
+ * @genicam: a #ArvGc object
+ *
+ * Retrieves the binded buffer. Inside a feature access of the calling thread with a bound buffer, like the ones of
+ * #ArvChunkParser, this is the bound buffer.
+ *
+ * Return value: (transfer none): a #ArvBuffer.
+ */
+
+ArvBuffer *
+arv_gc_get_buffer (ArvGc *genicam)
+{
+	ArvGcAccess *access;
+
+	g_return_val_if_fail (ARV_IS_GC (genicam), NULL);
+
+	access = _find_access (genicam);
+	if (access != NULL && access->buffer != NULL)
+		return access->buffer;
+
+	return genicam->priv->buffer;
+}
+
+/**
+ * arv_gc_set_event_data:
+ * @genicam: a #ArvGc object
+ * @event_id: event identifier
+ * @data: (array length=size) (element-type guint8) (nullable): event data
+ * @size: size of @data, in bytes
+ *
+ * Binds the data of an event to the Genicam document, for the retrieval of the event features, which are read from a
+ * port with a matching EventID. The data is copied, and replaces the previous event data, whatever its identifier.
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_gc_set_event_data (ArvGc *genicam, guint event_id, const void *data, size_t size)
+{
+	g_return_if_fail (ARV_IS_GC (genicam));
+	g_return_if_fail (data != NULL || size == 0);
+
+	g_clear_pointer (&genicam->priv->event_data, g_bytes_unref);
+
+	genicam->priv->event_id = event_id;
+	genicam->priv->event_data = g_bytes_new (data, size);
+}
+
+/**
+ * arv_gc_get_event_data:
+ * @genicam: a #ArvGc object
+ * @event_id: event identifier
+ * @size: (out) (optional): size of the event data, in bytes
+ *
+ * Retrieves the event data bound using arv_gc_set_event_data().
+ *
+ * Return value: (transfer none) (nullable): the event data, %NULL if no data is bound for @event_id.
+ *
+ * Since: 0.8.11
+ */
+
+const void *
+arv_gc_get_event_data (ArvGc *genicam, guint event_id, size_t *size)
+{
+	g_return_val_if_fail (ARV_IS_GC (genicam), NULL);
+
+	if (genicam->priv->event_data == NULL || genicam->priv->event_id != event_id) {
+		if (size != NULL)
+			*size = 0;
+		return NULL;
+	}
+
+	return g_bytes_get_data (genicam->priv->event_data, size);
+}
+
+/*
+ * Creates a genicam instance from a binary snapshot of the GenICam data, built by arv_gc_snapshot_build(). The nodes
+ * are only created when first looked up with arv_gc_get_node(). The snapshot is used in place, and referenced for the
+ * lifetime of the genicam instance.
+ */
+
+ArvGc *
+arv_gc_new_from_snapshot (ArvDevice *device, GBytes *snapshot_bytes)
+{
+	ArvGcSnapshot *snapshot;
+	ArvGc *genicam;
+
+	g_return_val_if_fail (snapshot_bytes != NULL, NULL);
+
+	snapshot = arv_gc_snapshot_new (snapshot_bytes);
+	if (snapshot == NULL)
+		return NULL;
+
+	genicam = g_object_new (ARV_TYPE_GC, NULL);
+	genicam->priv->device = device;
+	genicam->priv->snapshot = snapshot;
+	genicam->priv->lazy_root = arv_gc_snapshot_materialize_root (snapshot, ARV_DOM_DOCUMENT (genicam));
+
+	if (genicam->priv->lazy_root == NULL ||
+	    g_strcmp0 (arv_dom_node_get_node_name (genicam->priv->lazy_root), "RegisterDescription") != 0) {
+		arv_warning_genicam ("[Gc::new_from_snapshot] Invalid root element");
+		g_object_unref (genicam);
+		return NULL;
+	}
+
+	return genicam;
+}
+
+static GMutex arv_gc_shared_models_mutex;
+static GCond arv_gc_shared_models_cond;
+static GHashTable *arv_gc_shared_models = NULL;
+
+/* Returns the shared model of @key, waiting for its snapshot if it is being built by another thread. If there is no
+ * model yet, an empty one is added, and @is_builder is set, the caller being then responsible of its snapshot, using
+ * _shared_model_complete(). Returns %NULL if the snapshot build failed in another thread. */
+
+static ArvGcSharedModel *
+_shared_model_acquire (const char *key, gboolean *is_builder)
+{
+	ArvGcSharedModel *model;
+	gboolean is_released = FALSE;
+
+	*is_builder = FALSE;
+
+	g_mutex_lock (&arv_gc_shared_models_mutex);
+
+	if (arv_gc_shared_models == NULL)
+		arv_gc_shared_models = g_hash_table_new (g_str_hash, g_str_equal);
+
+	model = g_hash_table_lookup (arv_gc_shared_models, key);
+	if (model != NULL) {
+		model->ref_count++;
+		while (model->is_building)
+			g_cond_wait (&arv_gc_shared_models_cond, &arv_gc_shared_models_mutex);
+		if (model->snapshot == NULL) {
+			/* Already removed from the table by the builder */
+			model->ref_count--;
+			is_released = model->ref_count == 0;
+		}
+	} else {
+		model = g_new0 (ArvGcSharedModel, 1);
+		model->key = g_strdup (key);
+		model->is_building = TRUE;
+		model->ref_count = 1;
+		g_hash_table_insert (arv_gc_shared_models, model->key, model);
+		*is_builder = TRUE;
+	}
+
+	g_mutex_unlock (&arv_gc_shared_models_mutex);
+
+	if (model->snapshot == NULL && !*is_builder) {
+		if (is_released) {
+			g_free (model->key);
+			g_free (model);
+		}
+		return NULL;
+	}
+
+	return model;
+}
+
+/* Sets the snapshot of a model added by _shared_model_acquire(), and wakes up the waiting threads. On failure, with a
+ * %NULL @snapshot, the model is removed from the table, and released. */
+
+static void
+_shared_model_complete (ArvGcSharedModel *model, GBytes *snapshot)
+{
+	gboolean is_released = FALSE;
+
+	g_mutex_lock (&arv_gc_shared_models_mutex);
+
+	if (snapshot != NULL)
+		model->snapshot = g_bytes_ref (snapshot);
+	model->is_building = FALSE;
+
+	if (snapshot == NULL) {
+		g_hash_table_remove (arv_gc_shared_models, model->key);
+		if (g_hash_table_size (arv_gc_shared_models) == 0)
+			g_clear_pointer (&arv_gc_shared_models, g_hash_table_unref);
+		model->ref_count--;
+		is_released = model->ref_count == 0;
+	}
+
+	g_cond_broadcast (&arv_gc_shared_models_cond);
+
+	g_mutex_unlock (&arv_gc_shared_models_mutex);
+
+	if (is_released) {
+		g_free (model->key);
+		g_free (model);
+	}
+}
+
+static void
+_shared_model_release (ArvGcSharedModel *model)
+{
+	if (model == NULL)
+		return;
+
+	g_mutex_lock (&arv_gc_shared_models_mutex);
+
+	model->ref_count--;
+	if (model->ref_count == 0) {
+		g_hash_table_remove (arv_gc_shared_models, model->key);
+		if (g_hash_table_size (arv_gc_shared_models) == 0)
+			g_clear_pointer (&arv_gc_shared_models, g_hash_table_unref);
+	} else
+		model = NULL;
+
+	g_mutex_unlock (&arv_gc_shared_models_mutex);
+
+	if (model != NULL) {
+		g_bytes_unref (model->snapshot);
+		g_free (model->key);
+		g_free (model);
+	}
+}
+
+static GMutex arv_gc_build_slots_mutex;
+static GCond arv_gc_build_slots_cond;
+static guint arv_gc_n_builds = 0;
+
+/* Limits the number of concurrent snapshot builds and document parses, which are CPU bound, to the number of
+ * processors, for the devices opened concurrently by arv_open_devices(). The data downloads of the other devices go on
+ * in the meantime. */
+
+static void
+_build_slot_acquire (void)
+{
+	guint n_builds_max = MAX (1, g_get_num_processors ());
+
+	g_mutex_lock (&arv_gc_build_slots_mutex);
+	while (arv_gc_n_builds >= n_builds_max)
+		g_cond_wait (&arv_gc_build_slots_cond, &arv_gc_build_slots_mutex);
+	arv_gc_n_builds++;
+	g_mutex_unlock (&arv_gc_build_slots_mutex);
+}
+
+static void
+_build_slot_release (void)
+{
+	g_mutex_lock (&arv_gc_build_slots_mutex);
+	arv_gc_n_builds--;
+	g_cond_signal (&arv_gc_build_slots_cond);
+	g_mutex_unlock (&arv_gc_build_slots_mutex);
+}
+
+/* The snapshot of @xml is shared with the other instances created from the same data. On the first use, it is mapped
+ * from the GenICam cache if enabled, or built and stored. */
+
+static ArvGc *
+_new_from_shared_model (ArvDevice *device, const void *xml, size_t size)
+{
+	g_autofree char *key = NULL;
+	ArvGcSharedModel *model;
+	ArvGc *genicam;
+	gboolean is_builder;
+
+	key = g_compute_checksum_for_data (G_CHECKSUM_SHA1, xml, size);
+
+	/* The devices opened concurrently with the same GenICam data wait for a single snapshot build */
+	model = _shared_model_acquire (key, &is_builder);
+	if (model == NULL)
+		return NULL;
+
+	if (!is_builder) {
+		arv_debug_genicam ("[Gc::new_from_shared_model] Shared model '%s'", key);
+	} else {
+		GBytes *snapshot;
+
+		snapshot = arv_genicam_cache_map_snapshot (key);
+		if (snapshot == NULL) {
+			_build_slot_acquire ();
+			snapshot = arv_gc_snapshot_build (xml, size);
+			_build_slot_release ();
+			if (snapshot != NULL)
+				arv_genicam_cache_store_snapshot (key, snapshot);
+		}
+
+		_shared_model_complete (model, snapshot);
+		if (snapshot == NULL)
+			return NULL;
+		g_bytes_unref (snapshot);
+	}
+
+	genicam = arv_gc_new_from_snapshot (device, model->snapshot);
+	if (genicam == NULL) {
+		_shared_model_release (model);
+		return NULL;
+	}
+
+	genicam->priv->shared_model = model;
+
+	return genicam;
+}
+
+static gint arv_gc_lazy_loading = FALSE;
+
+/* Applies to the genicam instances created afterwards by arv_gc_new() */
+
+void
+arv_gc_set_lazy_loading (gboolean enable)
+{
+	g_atomic_int_set (&arv_gc_lazy_loading, enable);
+}
+
+/* Only the root element is parsed, the top-level subtrees being parsed when first looked up */
+
+static ArvGc *
+_new_lazy (ArvDevice *device, const void *xml, size_t size)
+{
+	ArvGcXmlIndex *xml_index;
+	ArvDomDocument *document;
+	ArvGc *genicam;
+
+	xml_index = arv_gc_xml_index_new (xml, size);
+	if (xml_index == NULL)
+		return NULL;
+
+	document = arv_gc_xml_index_new_document (xml_index);
+	if (!ARV_IS_GC (document) || arv_dom_document_get_document_element (document) == NULL) {
+		g_clear_object (&document);
+		arv_gc_xml_index_free (xml_index);
+		return NULL;
+	}
+
+	genicam = ARV_GC (document);
+	genicam->priv->device = device;
+	genicam->priv->xml_index = xml_index;
+	genicam->priv->lazy_root = ARV_DOM_NODE (arv_dom_document_get_document_element (document));
+
+	return genicam;
+}
+
+ArvGc *
+arv_gc_new (ArvDevice *device, const void *xml, size_t size)
+{
+	ArvDomDocument *document;
+	ArvGc *genicam;
+
+	arv_xml_schema_validate_genicam (xml, size);
+
+	genicam = _new_from_shared_model (device, xml, size);
+	if (genicam != NULL) {
+		/* Without lazy loading, all the nodes are still created at device opening, from the snapshot */
+		if (!g_atomic_int_get (&arv_gc_lazy_loading) && !arv_genicam_cache_is_enabled ())
+			arv_gc_snapshot_materialize_all (genicam->priv->snapshot, genicam->priv->lazy_root);
+		return genicam;
+	}
+
+	if (g_atomic_int_get (&arv_gc_lazy_loading)) {
+		genicam = _new_lazy (device, xml, size);
+		if (genicam != NULL)
+			return genicam;
+	}
+
+	_build_slot_acquire ();
+	document = arv_dom_document_new_from_memory (xml, size, NULL);
+	_build_slot_release ();
+	if (!ARV_IS_GC (document)) {
+		if (document != NULL)
+			g_object_unref (document);
+		return NULL;
+	}
+
+	genicam = ARV_GC (document);
+	genicam->priv->device = device;
+
+	return genicam;
+}
+
+G_DEFINE_TYPE_WITH_CODE (ArvGc, arv_gc, ARV_TYPE_DOM_DOCUMENT, G_ADD_PRIVATE (ArvGc))
+
+static void
+arv_gc_init (ArvGc *genicam)
+{
+	genicam->priv = arv_gc_get_instance_private (genicam);
+
+	genicam->priv->nodes = g_hash_table_new_full (g_str_hash, g_str_equal, NULL, g_object_unref);
+	genicam->priv->string_chunk = g_string_chunk_new (4096);
+	genicam->priv->strings = g_hash_table_new (g_str_hash, g_str_equal);
+	genicam->priv->cache_policy = ARV_REGISTER_CACHE_POLICY_DISABLE;
+	genicam->priv->register_cache = arv_gc_register_cache_new ();
+
+	g_rw_lock_init (&genicam->priv->access_lock);
+	g_rec_mutex_init (&genicam->priv->state_mutex);
+}
+
+static void
+arv_gc_finalize (GObject *object)
+{
+	ArvGc *genicam = ARV_GC (object);
+	GStringChunk *string_chunk = genicam->priv->string_chunk;
+
+	if (genicam->priv->buffer != NULL)
+		g_object_weak_unref (G_OBJECT (genicam->priv->buffer), _weak_notify_cb, genicam);
+
+	g_clear_pointer (&genicam->priv->event_data, g_bytes_unref);
+	g_clear_object (&genicam->priv->register_snapshot);
+	g_clear_object (&genicam->priv->register_recorder);
+
+	g_hash_table_unref (genicam->priv->nodes);
+
+	arv_gc_snapshot_free (genicam->priv->snapshot);
+	_shared_model_release (genicam->priv->shared_model);
+	arv_gc_xml_index_free (genicam->priv->xml_index);
+	g_hash_table_unref (genicam->priv->strings);
+	arv_gc_register_cache_free (genicam->priv->register_cache);
+	genicam->priv->register_cache = NULL;
+
+	G_OBJECT_CLASS (arv_gc_parent_class)->finalize (object);
+
+	/* The tree nodes are released by the parent class, and may still use the interned strings until then */
+	g_string_chunk_free (string_chunk);
+
+	g_rw_lock_clear (&genicam->priv->access_lock);
+	g_rec_mutex_clear (&genicam->priv->state_mutex);
 }
 
 static void
@@ -481,4 +2039,5 @@ arv_gc_class_init (ArvGcClass *node_class)
 	object_class->finalize = arv_gc_finalize;
 	d_node_class->can_append_child = arv_gc_can_append_child;
 	d_document_class->create_element = arv_gc_create_element;
+	d_document_class->create_text_node = arv_gc_create_text_node;
 }
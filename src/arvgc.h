@@ -29,6 +29,7 @@
 
 #include <arvbuffer.h>
 #include <arvdomdocument.h>
+#include <arvregistersnapshot.h>
 
 G_BEGIN_DECLS
 
@@ -50,7 +51,9 @@ typedef enum {
 	ARV_GC_ERROR_READ_ONLY,
 	ARV_GC_ERROR_SET_FROM_STRING_UNDEFINED,
 	ARV_GC_ERROR_GET_AS_STRING_UNDEFINED,
-	ARV_GC_ERROR_INVALID_BIT_RANGE
+	ARV_GC_ERROR_INVALID_BIT_RANGE,
+	ARV_GC_ERROR_EVENT_NOT_FOUND,
+	ARV_GC_ERROR_NOT_IN_SNAPSHOT
 } ArvGcError;
 
 /**
@@ -96,11 +99,23 @@ void			arv_gc_set_register_cache_policy	(ArvGc *genicam, ArvRegisterCachePolicy
 ArvRegisterCachePolicy 	arv_gc_get_register_cache_policy 	(ArvGc *genicam);
 void			arv_gc_set_range_check_policy		(ArvGc *genicam, ArvRangeCheckPolicy policy);
 ArvRangeCheckPolicy 	arv_gc_get_range_check_policy	 	(ArvGc *genicam);
+void			arv_gc_set_register_snapshot		(ArvGc *genicam, ArvRegisterSnapshot *snapshot);
+ArvRegisterSnapshot *	arv_gc_get_register_snapshot		(ArvGc *genicam);
+void			arv_gc_set_register_recorder		(ArvGc *genicam, ArvRegisterSnapshot *recorder);
+ArvRegisterSnapshot *	arv_gc_get_register_recorder		(ArvGc *genicam);
+gboolean		arv_gc_get_feature_statistics		(ArvGc *genicam, const char *feature,
+								 guint64 *n_reads, guint64 *n_writes,
+								 guint64 *n_cache_hits, guint64 *n_cache_misses,
+								 guint64 *port_time_us);
+void			arv_gc_reset_feature_statistics		(ArvGc *genicam);
 void 			arv_gc_set_default_node_data 		(ArvGc *genicam, const char *node_name, ...) G_GNUC_NULL_TERMINATED;
 ArvGcNode *		arv_gc_get_node				(ArvGc *genicam, const char *name);
 ArvDevice *		arv_gc_get_device			(ArvGc *genicam);
 void			arv_gc_set_buffer			(ArvGc *genicam, ArvBuffer *buffer);
 ArvBuffer *		arv_gc_get_buffer			(ArvGc *genicam);
+void			arv_gc_set_event_data			(ArvGc *genicam, guint event_id,
+								 const void *data, size_t size);
+const void *		arv_gc_get_event_data			(ArvGc *genicam, guint event_id, size_t *size);
 
 G_END_DECLS
 
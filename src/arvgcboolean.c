@@ -29,6 +29,7 @@
 #include <arvgcinteger.h>
 #include <arvgcfeaturenodeprivate.h>
 #include <arvgc.h>
+#include <arvgcprivate.h>
 #include <arvmisc.h>
 #include <string.h>
 
@@ -168,6 +169,44 @@ arv_gc_boolean_get_value (ArvGcBoolean *gc_boolean, GError **error)
 	return value == on_value;
 }
 
+/**
+ * arv_gc_boolean_try_get_value:
+ * @gc_boolean: a #ArvGcBoolean
+ * @value: (out): feature value
+ *
+ * Status variant of arv_gc_boolean_get_value(), see arv_gc_integer_try_get_value().
+ *
+ * Returns: %TRUE on success, in which case @value is set.
+ *
+ * Since: 0.8.11
+ */
+
+gboolean
+arv_gc_boolean_try_get_value (ArvGcBoolean *gc_boolean, gboolean *value)
+{
+	gint64 v_int64;
+	gint64 on_value = 1;
+
+	g_return_val_if_fail (ARV_IS_GC_BOOLEAN (gc_boolean), FALSE);
+	g_return_val_if_fail (value != NULL, FALSE);
+
+	*value = FALSE;
+
+	if (gc_boolean->value == NULL)
+		return TRUE;
+
+	if (!arv_gc_property_node_try_get_int64 (gc_boolean->value, &v_int64))
+		return FALSE;
+
+	if (gc_boolean->on_value != NULL &&
+	    !arv_gc_property_node_try_get_int64 (gc_boolean->on_value, &on_value))
+		return FALSE;
+
+	*value = v_int64 == on_value;
+
+	return TRUE;
+}
+
 /**
  * arv_gc_boolean_get_value_gi: (rename-to arv_gc_boolean_get_value)
  * @gc_boolean: a #ArvGcBoolean
@@ -187,15 +226,12 @@ arv_gc_boolean_get_value_gi (ArvGcBoolean *gc_boolean, gboolean *value, GError *
 	*value = arv_gc_boolean_get_value (gc_boolean, error);
 }
 
-void
-arv_gc_boolean_set_value (ArvGcBoolean *gc_boolean, gboolean v_boolean, GError **error)
+static void
+_set_value (ArvGcBoolean *gc_boolean, gboolean v_boolean, GError **error)
 {
 	gboolean value;
 	GError *local_error = NULL;
 
-	g_return_if_fail (ARV_IS_GC_BOOLEAN (gc_boolean));
-	g_return_if_fail (error == NULL || *error == NULL);
-
 	if (v_boolean)
 		value = arv_gc_boolean_get_on_value (gc_boolean, &local_error);
 	else
@@ -213,6 +249,21 @@ arv_gc_boolean_set_value (ArvGcBoolean *gc_boolean, gboolean v_boolean, GError *
 		g_propagate_error (error, local_error);
 }
 
+void
+arv_gc_boolean_set_value (ArvGcBoolean *gc_boolean, gboolean v_boolean, GError **error)
+{
+	ArvGc *genicam;
+
+	g_return_if_fail (ARV_IS_GC_BOOLEAN (gc_boolean));
+	g_return_if_fail (error == NULL || *error == NULL);
+
+	genicam = arv_gc_node_get_genicam (ARV_GC_NODE (gc_boolean));
+
+	arv_gc_access_begin (genicam, TRUE);
+	_set_value (gc_boolean, v_boolean, error);
+	arv_gc_access_end (genicam);
+}
+
 static ArvGcFeatureNode *
 arv_gc_boolean_get_linked_feature (ArvGcFeatureNode *gc_feature_node)
 {
@@ -40,6 +40,7 @@ ArvGcNode * 	arv_gc_boolean_new 		(void);
 
 gboolean 	arv_gc_boolean_get_value 	(ArvGcBoolean *gc_boolean, GError **error);
 void	 	arv_gc_boolean_get_value_gi 	(ArvGcBoolean *gc_boolean, gboolean *value, GError **error);
+gboolean	arv_gc_boolean_try_get_value	(ArvGcBoolean *gc_boolean, gboolean *value);
 void 		arv_gc_boolean_set_value 	(ArvGcBoolean *gc_boolean, gboolean v_boolean, GError **error);
 
 G_END_DECLS
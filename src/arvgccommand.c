@@ -29,7 +29,10 @@
 #include <arvgcinteger.h>
 #include <arvgcfeaturenodeprivate.h>
 #include <arvgcport.h>
+#include <arvgcregister.h>
+#include <arvdeviceprivate.h>
 #include <arvgc.h>
+#include <arvgcprivate.h>
 #include <arvmisc.h>
 #include <arvdebugprivate.h>
 #include <stdlib.h>
@@ -90,17 +93,12 @@ arv_gc_command_pre_remove_child (ArvDomNode *self, ArvDomNode *child)
 
 /* ArvGcCommand implementation */
 
-void
-arv_gc_command_execute (ArvGcCommand *gc_command, GError **error)
+static void
+_execute (ArvGcCommand *gc_command, ArvGc *genicam, GError **error)
 {
-	ArvGc *genicam;
 	GError *local_error = NULL;
 	gint64 command_value;
 
-	g_return_if_fail (ARV_IS_GC_COMMAND (gc_command));
-	genicam = arv_gc_node_get_genicam (ARV_GC_NODE (gc_command));
-	g_return_if_fail (ARV_IS_GC (genicam));
-
 	if (gc_command->value == NULL)
 		return;
 
@@ -119,11 +117,48 @@ arv_gc_command_execute (ArvGcCommand *gc_command, GError **error)
 		return;
 	}
 
+	/* A command is an action, not a configuration: it is never replayed after a reconnection */
+	{
+		ArvGcNode *value_node = arv_gc_property_node_get_linked_node (gc_command->value);
+		ArvDevice *device = arv_gc_get_device (genicam);
+
+		if (ARV_IS_GC_REGISTER (value_node) && ARV_IS_DEVICE (device)) {
+			guint64 address;
+
+			address = arv_gc_register_get_address (ARV_GC_REGISTER (value_node), &local_error);
+			if (local_error == NULL)
+				arv_device_journal_forget (device, address);
+			g_clear_error (&local_error);
+		}
+	}
+
 	arv_debug_genicam ("[GcCommand::execute] %s (0x%" G_GINT64_MODIFIER "x)",
 			 arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (gc_command)),
 			 command_value);
 }
 
+void
+arv_gc_command_execute (ArvGcCommand *gc_command, GError **error)
+{
+	ArvGc *genicam;
+
+	g_return_if_fail (ARV_IS_GC_COMMAND (gc_command));
+	genicam = arv_gc_node_get_genicam (ARV_GC_NODE (gc_command));
+	g_return_if_fail (ARV_IS_GC (genicam));
+
+	/* The payload size of the buffer pools follows the configuration set before the acquisition start */
+	if (g_strcmp0 (arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (gc_command)), "AcquisitionStart") == 0) {
+		ArvDevice *device = arv_gc_get_device (genicam);
+
+		if (ARV_IS_DEVICE (device))
+			arv_device_prepare_streams (device);
+	}
+
+	arv_gc_access_begin (genicam, TRUE);
+	_execute (gc_command, genicam, error);
+	arv_gc_access_end (genicam);
+}
+
 static ArvGcFeatureNode *
 arv_gc_command_get_linked_feature (ArvGcFeatureNode *gc_feature_node)
 {
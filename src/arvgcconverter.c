@@ -32,6 +32,7 @@
 #include <arvgcfloat.h>
 #include <arvgcdefaultsprivate.h>
 #include <arvgc.h>
+#include <arvgcprivate.h>
 #include <arvdebugprivate.h>
 #include <string.h>
 
@@ -52,6 +53,17 @@ typedef struct {
 
 	ArvEvaluator *formula_to;
 	ArvEvaluator *formula_from;
+	gboolean formula_to_up_to_date;
+	gboolean formula_from_up_to_date;
+
+	/* Evaluator slots of the pVariable values, in the order of the variables list */
+	gint *formula_to_slots;
+	gint *formula_from_slots;
+	gint from_slot;
+	gint to_slot;
+
+	/* Protects the evaluator variables against the concurrent reads of the document */
+	GRecMutex mutex;
 } ArvGcConverterPrivate;
 
 G_DEFINE_ABSTRACT_TYPE_WITH_CODE (ArvGcConverter, arv_gc_converter, ARV_TYPE_GC_FEATURE_NODE,
@@ -70,21 +82,29 @@ arv_gc_converter_post_new_child (ArvDomNode *self, ArvDomNode *child)
 		switch (arv_gc_property_node_get_node_type (property_node)) {
 			case ARV_GC_PROPERTY_NODE_TYPE_P_VARIABLE:
 				priv->variables = g_slist_prepend (priv->variables, property_node);
+				g_clear_pointer (&priv->formula_to_slots, g_free);
+				g_clear_pointer (&priv->formula_from_slots, g_free);
 				break;
 			case ARV_GC_PROPERTY_NODE_TYPE_P_VALUE:
 				priv->value = property_node;
 				break;
 			case ARV_GC_PROPERTY_NODE_TYPE_FORMULA_TO:
 				priv->formula_to_node = property_node;
+				priv->formula_to_up_to_date = FALSE;
 				break;
 			case ARV_GC_PROPERTY_NODE_TYPE_FORMULA_FROM:
 				priv->formula_from_node = property_node;
+				priv->formula_from_up_to_date = FALSE;
 				break;
 			case ARV_GC_PROPERTY_NODE_TYPE_EXPRESSION:
 				priv->expressions = g_slist_prepend (priv->expressions, property_node);
+				priv->formula_to_up_to_date = FALSE;
+				priv->formula_from_up_to_date = FALSE;
 				break;
 			case ARV_GC_PROPERTY_NODE_TYPE_CONSTANT:
 				priv->constants = g_slist_prepend (priv->constants, property_node);
+				priv->formula_to_up_to_date = FALSE;
+				priv->formula_from_up_to_date = FALSE;
 				break;
 			case ARV_GC_PROPERTY_NODE_TYPE_UNIT:
 				priv->unit = property_node;
@@ -117,6 +137,17 @@ arv_gc_converter_pre_remove_child (ArvDomNode *self, ArvDomNode *child)
 	g_assert_not_reached ();
 }
 
+static gboolean
+arv_gc_converter_child_changed (ArvDomNode *self, ArvDomNode *child)
+{
+	ArvGcConverterPrivate *priv = arv_gc_converter_get_instance_private (ARV_GC_CONVERTER (self));
+
+	priv->formula_to_up_to_date = FALSE;
+	priv->formula_from_up_to_date = FALSE;
+
+	return FALSE;
+}
+
 /* ArvGcConverter implementation */
 
 static void
@@ -126,7 +157,10 @@ arv_gc_converter_init (ArvGcConverter *self)
 
 	priv->formula_to = arv_evaluator_new (NULL);
 	priv->formula_from = arv_evaluator_new (NULL);
+	priv->from_slot = arv_evaluator_get_variable_slot (priv->formula_to, "FROM");
+	priv->to_slot = arv_evaluator_get_variable_slot (priv->formula_from, "TO");
 	priv->value = NULL;
+	g_rec_mutex_init (&priv->mutex);
 }
 
 static ArvGcFeatureNode *
@@ -153,9 +187,12 @@ arv_gc_converter_finalize (GObject *object)
 	g_slist_free (priv->variables);
 	g_slist_free (priv->expressions);
 	g_slist_free (priv->constants);
+	g_free (priv->formula_to_slots);
+	g_free (priv->formula_from_slots);
 
 	g_object_unref (priv->formula_to);
 	g_object_unref (priv->formula_from);
+	g_rec_mutex_clear (&priv->mutex);
 
 	G_OBJECT_CLASS (arv_gc_converter_parent_class)->finalize (object);
 }
@@ -170,6 +207,7 @@ arv_gc_converter_class_init (ArvGcConverterClass *this_class)
 	object_class->finalize = arv_gc_converter_finalize;
 	dom_node_class->post_new_child = arv_gc_converter_post_new_child;
 	dom_node_class->pre_remove_child = arv_gc_converter_pre_remove_child;
+	dom_node_class->child_changed = arv_gc_converter_child_changed;
 	gc_feature_node_class->get_linked_feature = arv_gc_converter_get_linked_feature;
 }
 
@@ -194,17 +232,23 @@ arv_gc_converter_get_is_linear (ArvGcConverter *gc_converter, GError **error)
 	return ARV_GC_IS_LINEAR_NO;
 }
 
+/* The evaluators keep the parsed formulas, they are only updated when one of the formula, expression or constant
+ * properties changed */
+
 static gboolean
-arv_gc_converter_update_from_variables (ArvGcConverter *gc_converter, ArvGcConverterNodeType node_type, GError **error)
+_update_formula (ArvGcConverter *gc_converter, ArvEvaluator *evaluator, ArvGcPropertyNode *formula_node,
+		 gboolean *up_to_date, GError **error)
 {
 	ArvGcConverterPrivate *priv = arv_gc_converter_get_instance_private (gc_converter);
-	ArvGcNode *node = NULL;
 	GError *local_error = NULL;
 	GSList *iter;
 	const char *expression;
 
-	if (priv->formula_from_node != NULL)
-		expression = arv_gc_property_node_get_string (priv->formula_from_node, &local_error);
+	if (*up_to_date)
+		return TRUE;
+
+	if (formula_node != NULL)
+		expression = arv_gc_property_node_get_string (formula_node, &local_error);
 	else
 		expression = "";
 
@@ -213,7 +257,7 @@ arv_gc_converter_update_from_variables (ArvGcConverter *gc_converter, ArvGcConve
 		return FALSE;
 	}
 
-	arv_evaluator_set_expression (priv->formula_from, expression);
+	arv_evaluator_set_expression (evaluator, expression);
 
 	for (iter = priv->expressions; iter != NULL; iter = iter->next) {
 		const char *expression;
@@ -227,7 +271,7 @@ arv_gc_converter_update_from_variables (ArvGcConverter *gc_converter, ArvGcConve
 
 		name = arv_gc_property_node_get_name (iter->data);
 
-		arv_evaluator_set_sub_expression (priv->formula_from, name, expression);
+		arv_evaluator_set_sub_expression (evaluator, name, expression);
 	}
 
 	for (iter = priv->constants; iter != NULL; iter = iter->next) {
@@ -242,39 +286,64 @@ arv_gc_converter_update_from_variables (ArvGcConverter *gc_converter, ArvGcConve
 
 		name = arv_gc_property_node_get_name (iter->data);
 
-		arv_evaluator_set_constant (priv->formula_from, name, constant);
+		arv_evaluator_set_constant (evaluator, name, constant);
 	}
 
-	for (iter = priv->variables; iter != NULL; iter = iter->next) {
+	*up_to_date = TRUE;
+
+	return TRUE;
+}
+
+static gint *
+_get_variable_slots (GSList *variables, ArvEvaluator *evaluator)
+{
+	GSList *iter;
+	gint *slots;
+	guint i;
+
+	slots = g_new (gint, g_slist_length (variables));
+	for (iter = variables, i = 0; iter != NULL; iter = iter->next, i++)
+		slots[i] = arv_evaluator_get_variable_slot (evaluator, arv_gc_property_node_get_name (iter->data));
+
+	return slots;
+}
+
+/* Doesn't allocate any error for failed variable reads when error is NULL and node_type is
+ * ARV_GC_CONVERTER_NODE_TYPE_VALUE */
+
+static gboolean
+arv_gc_converter_update_from_variables (ArvGcConverter *gc_converter, ArvGcConverterNodeType node_type, GError **error)
+{
+	ArvGcConverterPrivate *priv = arv_gc_converter_get_instance_private (gc_converter);
+	ArvGcNode *node = NULL;
+	GError *local_error = NULL;
+	GSList *iter;
+	guint i;
+
+	if (!_update_formula (gc_converter, priv->formula_from, priv->formula_from_node, &priv->formula_from_up_to_date, error))
+		return FALSE;
+
+	if (priv->formula_from_slots == NULL)
+		priv->formula_from_slots = _get_variable_slots (priv->variables, priv->formula_from);
+
+	for (iter = priv->variables, i = 0; iter != NULL; iter = iter->next, i++) {
 		ArvGcPropertyNode *variable_node = iter->data;
 
 		node = arv_gc_property_node_get_linked_node (ARV_GC_PROPERTY_NODE (variable_node));
 		if (ARV_IS_GC_INTEGER (node)) {
 			gint64 value;
 
-			value = arv_gc_integer_get_value (ARV_GC_INTEGER (node), &local_error);
-
-			if (local_error != NULL) {
-				g_propagate_error (error, local_error);
+			if (!arv_gc_integer_get_value_checked (ARV_GC_INTEGER (node), &value, error))
 				return FALSE;
-			}
 
-			arv_evaluator_set_int64_variable (priv->formula_from,
-							  arv_gc_property_node_get_name (variable_node),
-							  value);
+			arv_evaluator_set_int64_variable_by_slot (priv->formula_from, priv->formula_from_slots[i], value);
 		} else if (ARV_IS_GC_FLOAT (node)) {
 			double value;
 
-			value =  arv_gc_float_get_value (ARV_GC_FLOAT (node), &local_error);
-
-			if (local_error != NULL) {
-				g_propagate_error (error, local_error);
+			if (!arv_gc_float_get_value_checked (ARV_GC_FLOAT (node), &value, error))
 				return FALSE;
-			}
 
-			arv_evaluator_set_double_variable (priv->formula_from,
-							  arv_gc_property_node_get_name (variable_node),
-							  value);
+			arv_evaluator_set_double_variable_by_slot (priv->formula_from, priv->formula_from_slots[i], value);
 		}
 	}
 
@@ -301,7 +370,8 @@ arv_gc_converter_update_from_variables (ArvGcConverter *gc_converter, ArvGcConve
 					value = arv_gc_integer_get_inc (ARV_GC_INTEGER (node), &local_error);
 					break;
 				default:
-					value = arv_gc_integer_get_value (ARV_GC_INTEGER (node), &local_error);
+					if (!arv_gc_integer_get_value_checked (ARV_GC_INTEGER (node), &value, error))
+						return FALSE;
 					break;
 			}
 
@@ -310,7 +380,7 @@ arv_gc_converter_update_from_variables (ArvGcConverter *gc_converter, ArvGcConve
 				return FALSE;
 			}
 
-			arv_evaluator_set_int64_variable (priv->formula_from, "TO", value);
+			arv_evaluator_set_int64_variable_by_slot (priv->formula_from, priv->to_slot, value);
 		} else if (ARV_IS_GC_FLOAT (node)) {
 			double value;
 
@@ -331,7 +401,8 @@ arv_gc_converter_update_from_variables (ArvGcConverter *gc_converter, ArvGcConve
 					value = arv_gc_float_get_inc (ARV_GC_FLOAT (node), &local_error);
 					break;
 				default:
-					value =  arv_gc_float_get_value (ARV_GC_FLOAT (node), &local_error);
+					if (!arv_gc_float_get_value_checked (ARV_GC_FLOAT (node), &value, error))
+						return FALSE;
 					break;
 			}
 
@@ -340,7 +411,7 @@ arv_gc_converter_update_from_variables (ArvGcConverter *gc_converter, ArvGcConve
 				return FALSE;
 			}
 
-			arv_evaluator_set_double_variable (priv->formula_from, "TO", value);
+			arv_evaluator_set_double_variable_by_slot (priv->formula_from, priv->to_slot, value);
 		} else {
 			arv_warning_genicam ("[GcConverter::set_value] Invalid pValue node '%s'",
 					     arv_gc_property_node_get_string (priv->value, NULL));
@@ -365,10 +436,20 @@ arv_gc_converter_convert_to_double (ArvGcConverter *gc_converter, ArvGcConverter
 {
 	ArvGcConverterPrivate *priv = arv_gc_converter_get_instance_private (gc_converter);
 	GError *local_error = NULL;
+	double value = 0.0;
+	gboolean success;
 
 	g_return_val_if_fail (ARV_IS_GC_CONVERTER (gc_converter), 0.0);
 
-	if (!arv_gc_converter_update_from_variables (gc_converter, node_type, &local_error)) {
+	g_rec_mutex_lock (&priv->mutex);
+
+	success = arv_gc_converter_update_from_variables (gc_converter, node_type, &local_error);
+	if (success)
+		value = arv_evaluator_evaluate_as_double (priv->formula_from, NULL);
+
+	g_rec_mutex_unlock (&priv->mutex);
+
+	if (!success) {
 		if (local_error != NULL)
 			g_propagate_error (error, local_error);
 
@@ -382,7 +463,45 @@ arv_gc_converter_convert_to_double (ArvGcConverter *gc_converter, ArvGcConverter
 		}
 	}
 
-	return arv_evaluator_evaluate_as_double (priv->formula_from, NULL);
+	return value;
+}
+
+/* Status variants of the value conversions */
+
+gboolean
+arv_gc_converter_try_convert_to_double (ArvGcConverter *gc_converter, double *value)
+{
+	ArvGcConverterPrivate *priv = arv_gc_converter_get_instance_private (gc_converter);
+	gboolean success;
+
+	g_return_val_if_fail (ARV_IS_GC_CONVERTER (gc_converter), FALSE);
+
+	g_rec_mutex_lock (&priv->mutex);
+
+	success = arv_gc_converter_update_from_variables (gc_converter, ARV_GC_CONVERTER_NODE_TYPE_VALUE, NULL);
+	*value = success ? arv_evaluator_evaluate_as_double (priv->formula_from, NULL) : 0.0;
+
+	g_rec_mutex_unlock (&priv->mutex);
+
+	return success;
+}
+
+gboolean
+arv_gc_converter_try_convert_to_int64 (ArvGcConverter *gc_converter, gint64 *value)
+{
+	ArvGcConverterPrivate *priv = arv_gc_converter_get_instance_private (gc_converter);
+	gboolean success;
+
+	g_return_val_if_fail (ARV_IS_GC_CONVERTER (gc_converter), FALSE);
+
+	g_rec_mutex_lock (&priv->mutex);
+
+	success = arv_gc_converter_update_from_variables (gc_converter, ARV_GC_CONVERTER_NODE_TYPE_VALUE, NULL);
+	*value = success ? arv_evaluator_evaluate_as_double (priv->formula_from, NULL) : 0;
+
+	g_rec_mutex_unlock (&priv->mutex);
+
+	return success;
 }
 
 gint64
@@ -390,10 +509,20 @@ arv_gc_converter_convert_to_int64 (ArvGcConverter *gc_converter, ArvGcConverterN
 {
 	ArvGcConverterPrivate *priv = arv_gc_converter_get_instance_private (gc_converter);
 	GError *local_error = NULL;
+	gint64 value = 0;
+	gboolean success;
 
 	g_return_val_if_fail (ARV_IS_GC_CONVERTER (gc_converter), 0);
 
-	if (!arv_gc_converter_update_from_variables (gc_converter, node_type, &local_error)) {
+	g_rec_mutex_lock (&priv->mutex);
+
+	success = arv_gc_converter_update_from_variables (gc_converter, node_type, &local_error);
+	if (success)
+		value = arv_evaluator_evaluate_as_double (priv->formula_from, NULL);
+
+	g_rec_mutex_unlock (&priv->mutex);
+
+	if (!success) {
 		if (local_error != NULL)
 			g_propagate_error (error, local_error);
 
@@ -407,7 +536,7 @@ arv_gc_converter_convert_to_int64 (ArvGcConverter *gc_converter, ArvGcConverterN
 		}
 	}
 
-	return arv_evaluator_evaluate_as_double (priv->formula_from, NULL);
+	return value;
 }
 
 static void
@@ -417,51 +546,15 @@ arv_gc_converter_update_to_variables (ArvGcConverter *gc_converter, GError **err
 	ArvGcNode *node;
 	GError *local_error = NULL;
 	GSList *iter;
-	const char *expression;
+	guint i;
 
-	if (priv->formula_to_node != NULL)
-		expression = arv_gc_property_node_get_string (priv->formula_to_node, &local_error);
-	else
-		expression = "";
-
-	if (local_error != NULL) {
-		g_propagate_error (error, local_error);
+	if (!_update_formula (gc_converter, priv->formula_to, priv->formula_to_node, &priv->formula_to_up_to_date, error))
 		return;
-	}
 
-	arv_evaluator_set_expression (priv->formula_to, expression);
-
-	for (iter = priv->expressions; iter != NULL; iter = iter->next) {
-		const char *expression;
-		const char *name;
-
-		expression = arv_gc_property_node_get_string (ARV_GC_PROPERTY_NODE (iter->data), &local_error);
-		if (local_error != NULL) {
-			g_propagate_error (error, local_error);
-			return;
-		}
-
-		name = arv_gc_property_node_get_name (iter->data);
-
-		arv_evaluator_set_sub_expression (priv->formula_to, name, expression);
-	}
-
-	for (iter = priv->constants; iter != NULL; iter = iter->next) {
-		const char *constant;
-		const char *name;
-
-		constant = arv_gc_property_node_get_string (ARV_GC_PROPERTY_NODE (iter->data), &local_error);
-		if (local_error != NULL) {
-			g_propagate_error (error, local_error);
-			return;
-		}
-
-		name = arv_gc_property_node_get_name (iter->data);
-
-		arv_evaluator_set_constant (priv->formula_to, name, constant);
-	}
+	if (priv->formula_to_slots == NULL)
+		priv->formula_to_slots = _get_variable_slots (priv->variables, priv->formula_to);
 
-	for (iter = priv->variables; iter != NULL; iter = iter->next) {
+	for (iter = priv->variables, i = 0; iter != NULL; iter = iter->next, i++) {
 		ArvGcPropertyNode *variable_node = iter->data;
 
 		node = arv_gc_property_node_get_linked_node (ARV_GC_PROPERTY_NODE (variable_node));
@@ -475,9 +568,7 @@ arv_gc_converter_update_to_variables (ArvGcConverter *gc_converter, GError **err
 				return;
 			}
 
-			arv_evaluator_set_int64_variable (priv->formula_to,
-							  arv_gc_property_node_get_name (variable_node),
-							  value);
+			arv_evaluator_set_int64_variable_by_slot (priv->formula_to, priv->formula_to_slots[i], value);
 		} else if (ARV_IS_GC_FLOAT (node)) {
 			double value;
 
@@ -488,9 +579,7 @@ arv_gc_converter_update_to_variables (ArvGcConverter *gc_converter, GError **err
 				return;
 			}
 
-			arv_evaluator_set_double_variable (priv->formula_to,
-							   arv_gc_property_node_get_name (variable_node),
-							   value);
+			arv_evaluator_set_double_variable_by_slot (priv->formula_to, priv->formula_to_slots[i], value);
 		}
 	}
 
@@ -529,7 +618,7 @@ arv_gc_converter_convert_from_double (ArvGcConverter *gc_converter, double value
 	g_return_if_fail (ARV_IS_GC_CONVERTER (gc_converter));
 
 	arv_gc_feature_node_increment_change_count (ARV_GC_FEATURE_NODE (gc_converter));
-	arv_evaluator_set_double_variable (priv->formula_to, "FROM", value);
+	arv_evaluator_set_double_variable_by_slot (priv->formula_to, priv->from_slot, value);
 	arv_gc_converter_update_to_variables (gc_converter, error);
 }
 
@@ -541,7 +630,7 @@ arv_gc_converter_convert_from_int64 (ArvGcConverter *gc_converter, gint64 value,
 	g_return_if_fail (ARV_IS_GC_CONVERTER (gc_converter));
 
 	arv_gc_feature_node_increment_change_count (ARV_GC_FEATURE_NODE (gc_converter));
-	arv_evaluator_set_int64_variable (priv->formula_to, "FROM", value);
+	arv_evaluator_set_int64_variable_by_slot (priv->formula_to, priv->from_slot, value);
 	arv_gc_converter_update_to_variables (gc_converter, error);
 }
 
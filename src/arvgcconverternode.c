@@ -70,6 +70,12 @@ arv_gc_converter_get_float_value (ArvGcFloat *gc_float, GError **error)
 	return arv_gc_converter_convert_to_double (ARV_GC_CONVERTER (gc_float), ARV_GC_CONVERTER_NODE_TYPE_VALUE, error);
 }
 
+static gboolean
+arv_gc_converter_try_get_float_value (ArvGcFloat *gc_float, double *value)
+{
+	return arv_gc_converter_try_convert_to_double (ARV_GC_CONVERTER (gc_float), value);
+}
+
 static double
 arv_gc_converter_get_float_min (ArvGcFloat *gc_float, GError **error)
 {
@@ -168,6 +174,7 @@ static void
 arv_gc_converter_node_float_interface_init (ArvGcFloatInterface *interface)
 {
 	interface->get_value = arv_gc_converter_get_float_value;
+	interface->try_get_value = arv_gc_converter_try_get_float_value;
 	interface->get_min = arv_gc_converter_get_float_min;
 	interface->get_max = arv_gc_converter_get_float_max;
 	interface->get_inc = _get_inc;
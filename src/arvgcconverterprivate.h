@@ -45,6 +45,8 @@ gint64 			arv_gc_converter_convert_to_int64 	(ArvGcConverter *gc_converter, ArvG
 								 GError **error);
 double 			arv_gc_converter_convert_to_double 	(ArvGcConverter *gc_converter, ArvGcConverterNodeType node_type,
 								 GError **error);
+gboolean		arv_gc_converter_try_convert_to_int64	(ArvGcConverter *gc_converter, gint64 *value);
+gboolean		arv_gc_converter_try_convert_to_double	(ArvGcConverter *gc_converter, double *value);
 void 			arv_gc_converter_convert_from_int64 	(ArvGcConverter *gc_converter, gint64 value, GError **error);
 void			arv_gc_converter_convert_from_double 	(ArvGcConverter *gc_converter, double value, GError **error);
 
@@ -32,10 +32,34 @@
 #include <arvgcstring.h>
 #include <arvgcfeaturenodeprivate.h>
 #include <arvgc.h>
+#include <arvgcprivate.h>
 #include <arvmisc.h>
+#include <arvmiscprivate.h>
 #include <arvdebugprivate.h>
+#include <stdlib.h>
 #include <string.h>
 
+/* The available and implemented entries, valid for one generation of the document */
+
+typedef struct {
+	gint ref_count;
+	guint generation;
+	guint n_entries;
+	gint64 *values;
+	const char **names;
+	const char **display_names;
+} ArvGcEnumerationAvailable;
+
+/* All the entries, sorted by value, built on the first value to entry conversion. Only used when all the entry values
+ * are constant, otherwise is_constant is FALSE and the entries are evaluated on each conversion. */
+
+typedef struct {
+	gboolean is_constant;
+	guint n_entries;
+	gint64 *values;
+	ArvGcFeatureNode **entries;
+} ArvGcEnumerationTable;
+
 struct _ArvGcEnumeration {
 	ArvGcFeatureNode base;
 
@@ -44,6 +68,9 @@ struct _ArvGcEnumeration {
 
 	GSList *selecteds;		/* #ArvGcPropertyNode */
 	GSList *selected_features;	/* #ArvGcFeatureNode */
+
+	ArvGcEnumerationAvailable *available;
+	ArvGcEnumerationTable *table;
 };
 
 struct _ArvGcEnumerationClass {
@@ -73,6 +100,8 @@ arv_gc_enumeration_can_append_child (ArvDomNode *node, ArvDomNode *child)
 	return (ARV_IS_GC_ENUM_ENTRY (child) || ARV_IS_GC_PROPERTY_NODE (child));
 }
 
+static void _table_free (ArvGcEnumerationTable *table);
+
 static void
 arv_gc_enumeration_post_new_child (ArvDomNode *self, ArvDomNode *child)
 {
@@ -93,8 +122,10 @@ arv_gc_enumeration_post_new_child (ArvDomNode *self, ArvDomNode *child)
 				ARV_DOM_NODE_CLASS (arv_gc_enumeration_parent_class)->post_new_child (self, child);
 				break;
 		}
-	} else if (ARV_IS_GC_ENUM_ENTRY (child))
+	} else if (ARV_IS_GC_ENUM_ENTRY (child)) {
 		node->entries = g_slist_prepend (node->entries, child);
+		g_clear_pointer (&node->table, _table_free);
+	}
 }
 
 static void
@@ -105,21 +136,276 @@ arv_gc_enumeration_pre_remove_child (ArvDomNode *self, ArvDomNode *child)
 
 /* ArvGcEnumeration implementation */
 
-const char *
-arv_gc_enumeration_get_string_value (ArvGcEnumeration *enumeration, GError **error)
+static void
+_available_unref (ArvGcEnumerationAvailable *available)
 {
+	if (available == NULL || !g_atomic_int_dec_and_test (&available->ref_count))
+		return;
+
+	g_free (available->values);
+	g_free (available->names);
+	g_free (available->display_names);
+	g_free (available);
+}
+
+static ArvGcEnumerationAvailable *
+_build_available (ArvGcEnumeration *enumeration, GError **error)
+{
+	ArvGcEnumerationAvailable *available;
+	GSList *available_entries = NULL;
 	const GSList *iter;
 	GError *local_error = NULL;
-	gint64 value;
+	unsigned int n_entries = 0;
+	unsigned int i;
 
-	g_return_val_if_fail (ARV_IS_GC_ENUMERATION (enumeration), NULL);
-	g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+	for (iter = enumeration->entries; iter != NULL; iter = iter->next) {
+		gboolean is_available;
 
-	value = arv_gc_enumeration_get_int_value (enumeration, &local_error);
+		is_available = arv_gc_feature_node_is_available (iter->data, &local_error);
 
-	if (local_error != NULL) {
-		g_propagate_error (error, local_error);
+		if (local_error == NULL && is_available &&
+		    arv_gc_feature_node_is_implemented (iter->data, &local_error)) {
+			available_entries = g_slist_prepend (available_entries, iter->data);
+			n_entries++;
+		}
+
+		if (local_error != NULL) {
+			g_propagate_error (error, local_error);
+			g_slist_free (available_entries);
+
+			return NULL;
+		}
+	}
+
+	available = g_new0 (ArvGcEnumerationAvailable, 1);
+	available->ref_count = 1;
+	available->n_entries = n_entries;
+	available->values = g_new (gint64, n_entries);
+	available->names = g_new (const char *, n_entries);
+	available->display_names = g_new (const char *, n_entries);
+
+	for (iter = available_entries, i = 0; iter != NULL; iter = iter->next, i++) {
+		available->values[i] = arv_gc_enum_entry_get_value (iter->data, &local_error);
+
+		if (local_error != NULL) {
+			g_propagate_error (error, local_error);
+			g_slist_free (available_entries);
+			_available_unref (available);
+
+			return NULL;
+		}
+
+		available->names[i] = arv_gc_feature_node_get_name (iter->data);
+		available->display_names[i] = arv_gc_feature_node_get_display_name (iter->data);
+		if (available->display_names[i] == NULL)
+			available->display_names[i] = available->names[i];
+	}
+
+	g_slist_free (available_entries);
+
+	return available;
+}
+
+/* Returns a reference to the available entries of @enumeration, to be released with _available_unref(). As for the
+ * feature bounds, they are only cached when the register cache is enabled, until the next change in the document,
+ * which includes the changes of the pIsAvailable and pIsImplemented nodes of the entries. */
+
+static ArvGcEnumerationAvailable *
+_get_available (ArvGcEnumeration *enumeration, GError **error)
+{
+	ArvGcEnumerationAvailable *available = NULL;
+	ArvGc *genicam;
+	guint generation;
+	guint n_volatile_reads;
+
+	genicam = arv_gc_node_get_genicam (ARV_GC_NODE (enumeration));
+	if (!ARV_IS_GC (genicam) ||
+	    arv_gc_get_register_cache_policy (genicam) != ARV_REGISTER_CACHE_POLICY_ENABLE)
+		return _build_available (enumeration, error);
+
+	arv_gc_lock_state (genicam);
+	if (enumeration->available != NULL &&
+	    enumeration->available->generation == arv_gc_get_generation (genicam)) {
+		available = enumeration->available;
+		g_atomic_int_inc (&available->ref_count);
+	}
+	arv_gc_unlock_state (genicam);
+
+	if (available != NULL)
+		return available;
+
+	generation = arv_gc_get_generation (genicam);
+	n_volatile_reads = arv_gc_get_n_volatile_reads (genicam);
+
+	available = _build_available (enumeration, error);
+	if (available == NULL)
 		return NULL;
+
+	/* Dropped if the document changed, or if a volatile register was read, in the meantime */
+	if (arv_gc_get_generation (genicam) != generation ||
+	    arv_gc_get_n_volatile_reads (genicam) != n_volatile_reads)
+		return available;
+
+	available->generation = generation;
+	g_atomic_int_inc (&available->ref_count);
+
+	arv_gc_lock_state (genicam);
+	_available_unref (enumeration->available);
+	enumeration->available = available;
+	arv_gc_unlock_state (genicam);
+
+	return available;
+}
+
+static void
+_table_free (ArvGcEnumerationTable *table)
+{
+	if (table == NULL)
+		return;
+
+	g_free (table->values);
+	g_free (table->entries);
+	g_free (table);
+}
+
+/* Retrieves the value of @entry if it is given by a <Value> property, the last value property of the entry being the
+ * one used by arv_gc_enum_entry_get_value(). Returns FALSE for a <pValue> property. */
+
+static gboolean
+_get_constant_entry_value (ArvGcEnumEntry *entry, gint64 *value)
+{
+	ArvGcPropertyNode *property = NULL;
+	ArvDomNode *iter;
+
+	for (iter = arv_dom_node_get_first_child (ARV_DOM_NODE (entry));
+	     iter != NULL;
+	     iter = arv_dom_node_get_next_sibling (iter)) {
+		if (ARV_IS_GC_PROPERTY_NODE (iter)) {
+			ArvGcPropertyNodeType type = arv_gc_property_node_get_node_type (ARV_GC_PROPERTY_NODE (iter));
+
+			if (type == ARV_GC_PROPERTY_NODE_TYPE_VALUE || type == ARV_GC_PROPERTY_NODE_TYPE_P_VALUE)
+				property = ARV_GC_PROPERTY_NODE (iter);
+		}
+	}
+
+	if (property == NULL) {
+		*value = 0;
+		return TRUE;
+	}
+
+	if (arv_gc_property_node_get_node_type (property) != ARV_GC_PROPERTY_NODE_TYPE_VALUE)
+		return FALSE;
+
+	*value = arv_gc_property_node_get_int64 (property, NULL);
+
+	return TRUE;
+}
+
+typedef struct {
+	gint64 value;
+	guint position;
+	ArvGcFeatureNode *entry;
+} ArvGcEnumerationTableEntry;
+
+static gint
+_compare_table_entries (gconstpointer a, gconstpointer b)
+{
+	const ArvGcEnumerationTableEntry *entry_a = a;
+	const ArvGcEnumerationTableEntry *entry_b = b;
+
+	if (entry_a->value != entry_b->value)
+		return entry_a->value < entry_b->value ? -1 : 1;
+
+	/* The entries sharing a value keep the order of the entry list */
+	return entry_a->position < entry_b->position ? -1 : (entry_a->position > entry_b->position ? 1 : 0);
+}
+
+static ArvGcEnumerationTable *
+_build_table (ArvGcEnumeration *enumeration)
+{
+	ArvGcEnumerationTable *table;
+	ArvGcEnumerationTableEntry *table_entries;
+	const GSList *iter;
+	guint n_entries;
+	guint i;
+
+	table = g_new0 (ArvGcEnumerationTable, 1);
+
+	n_entries = g_slist_length (enumeration->entries);
+	table_entries = g_new (ArvGcEnumerationTableEntry, n_entries);
+
+	for (iter = enumeration->entries, i = 0; iter != NULL; iter = iter->next, i++) {
+		if (!_get_constant_entry_value (iter->data, &table_entries[i].value)) {
+			g_free (table_entries);
+			return table;
+		}
+		table_entries[i].position = i;
+		table_entries[i].entry = iter->data;
+	}
+
+	qsort (table_entries, n_entries, sizeof (ArvGcEnumerationTableEntry), _compare_table_entries);
+
+	table->is_constant = TRUE;
+	table->n_entries = n_entries;
+	table->values = g_new (gint64, n_entries);
+	table->entries = g_new (ArvGcFeatureNode *, n_entries);
+	for (i = 0; i < n_entries; i++) {
+		table->values[i] = table_entries[i].value;
+		table->entries[i] = table_entries[i].entry;
+	}
+
+	g_free (table_entries);
+
+	return table;
+}
+
+/* Returns the value to entry table of @enumeration, built on the first call. The table is immutable, and only
+ * released when an entry is added, which only happens while the document is parsed. */
+
+static ArvGcEnumerationTable *
+_get_table (ArvGcEnumeration *enumeration)
+{
+	ArvGcEnumerationTable *table;
+
+	table = g_atomic_pointer_get (&enumeration->table);
+	if (table != NULL)
+		return table;
+
+	table = _build_table (enumeration);
+	if (!g_atomic_pointer_compare_and_exchange (&enumeration->table, NULL, table)) {
+		_table_free (table);
+		table = g_atomic_pointer_get (&enumeration->table);
+	}
+
+	return table;
+}
+
+/* Finds the entry of @value, with a binary search in the entry table when the entry values are constant, and by
+ * evaluating the value of each entry otherwise. Returns NULL, without error, if no entry matches @value. */
+
+static ArvGcFeatureNode *
+_find_entry_by_value (ArvGcEnumeration *enumeration, gint64 value, GError **error)
+{
+	ArvGcEnumerationTable *table;
+	const GSList *iter;
+	GError *local_error = NULL;
+
+	table = _get_table (enumeration);
+	if (table->is_constant) {
+		guint low = 0;
+		guint high = table->n_entries;
+
+		/* Lower bound, for the first entry of a shared value */
+		while (low < high) {
+			guint middle = low + (high - low) / 2;
+
+			if (table->values[middle] < value)
+				low = middle + 1;
+			else
+				high = middle;
+		}
+
+		return low < table->n_entries && table->values[low] == value ? table->entries[low] : NULL;
 	}
 
 	for (iter = enumeration->entries; iter != NULL; iter = iter->next) {
@@ -132,14 +418,81 @@ arv_gc_enumeration_get_string_value (ArvGcEnumeration *enumeration, GError **err
 			return NULL;
 		}
 
-		if (enum_value == value) {
-			const char *string;
+		if (enum_value == value)
+			return iter->data;
+	}
 
-			string = arv_gc_feature_node_get_name (iter->data);
-			arv_debug_genicam ("[GcEnumeration::get_string_value] value = %" G_GINT64_FORMAT " - string = %s",
-					 value, string);
-			return string;
-		}
+	return NULL;
+}
+
+/* Checks @value against the available entries, with error set on failure */
+
+static gboolean
+_check_available_value (ArvGcEnumeration *enumeration, gint64 value, GError **error)
+{
+	ArvGcEnumerationAvailable *available;
+	GError *local_error = NULL;
+	gboolean found = FALSE;
+	unsigned int i;
+
+	available = _get_available (enumeration, &local_error);
+	if (local_error != NULL) {
+		g_propagate_error (error, local_error);
+		return FALSE;
+	}
+
+	if (available->n_entries == 0) {
+		_available_unref (available);
+		g_set_error (error, ARV_GC_ERROR, ARV_GC_ERROR_EMPTY_ENUMERATION,
+			     "No available entry found in <Enumeration> '%s'",
+			     arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (enumeration)));
+		return FALSE;
+	}
+
+	for (i = 0; i < available->n_entries && !found; i++)
+		found = available->values[i] == value;
+
+	_available_unref (available);
+
+	if (!found)
+		g_set_error (error, ARV_GC_ERROR, ARV_GC_ERROR_OUT_OF_RANGE,
+			     "Value not found in <Enumeration> '%s'",
+			     arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (enumeration)));
+
+	return found;
+}
+
+const char *
+arv_gc_enumeration_get_string_value (ArvGcEnumeration *enumeration, GError **error)
+{
+	ArvGcFeatureNode *entry;
+	GError *local_error = NULL;
+	gint64 value;
+
+	g_return_val_if_fail (ARV_IS_GC_ENUMERATION (enumeration), NULL);
+	g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
+	value = arv_gc_enumeration_get_int_value (enumeration, &local_error);
+
+	if (local_error != NULL) {
+		g_propagate_error (error, local_error);
+		return NULL;
+	}
+
+	entry = _find_entry_by_value (enumeration, value, &local_error);
+
+	if (local_error != NULL) {
+		g_propagate_error (error, local_error);
+		return NULL;
+	}
+
+	if (entry != NULL) {
+		const char *string;
+
+		string = arv_gc_feature_node_get_name (entry);
+		arv_debug_genicam ("[GcEnumeration::get_string_value] value = %" G_GINT64_FORMAT " - string = %s",
+				   value, string);
+		return string;
 	}
 
 	arv_warning_genicam ("[GcEnumeration::get_string_value] value = %" G_GINT64_FORMAT " not found for node %s",
@@ -194,10 +547,6 @@ arv_gc_enumeration_get_int_value (ArvGcEnumeration *enumeration, GError **error)
 {
 	GError *local_error = NULL;
 	gint64 value;
-	gint64 *available_values;
-	unsigned n_values;
-	unsigned i;
-	gboolean found = FALSE;
 
 	g_return_val_if_fail (ARV_IS_GC_ENUMERATION (enumeration), 0);
 	g_return_val_if_fail (error == NULL || *error == NULL, 0);
@@ -212,29 +561,7 @@ arv_gc_enumeration_get_int_value (ArvGcEnumeration *enumeration, GError **error)
 		return 0;
 	}
 
-	available_values = arv_gc_enumeration_dup_available_int_values (enumeration, &n_values, &local_error);
-	if (local_error != NULL) {
-		g_propagate_error (error, local_error);
-		return value;
-	}
-
-	if (available_values == NULL) {
-		g_set_error (error, ARV_GC_ERROR, ARV_GC_ERROR_EMPTY_ENUMERATION,
-			     "No available entry found in <Enumeration> '%s'",
-			     arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (enumeration)));
-		return value;
-	}
-
-	for (i = 0; i < n_values; i++)
-		if (available_values[i] == value)
-			found = TRUE;
-
-	g_free (available_values);
-
-	if (!found)
-		g_set_error (error, ARV_GC_ERROR, ARV_GC_ERROR_OUT_OF_RANGE,
-			     "Value not found in <Enumeration> '%s'",
-			     arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (enumeration)));
+	_check_available_value (enumeration, value, error);
 
 	return value;
 }
@@ -253,11 +580,8 @@ arv_gc_enumeration_get_int_value (ArvGcEnumeration *enumeration, GError **error)
 gint64 *
 arv_gc_enumeration_dup_available_int_values (ArvGcEnumeration *enumeration, guint *n_values, GError **error)
 {
-	gint64 *values;
-	const GSList *entries, *iter;
-	GSList *available_entries = NULL;
-	unsigned int i;
-	GError *local_error = NULL;
+	ArvGcEnumerationAvailable *available;
+	gint64 *values = NULL;
 
 	g_return_val_if_fail (n_values != NULL, NULL);
 
@@ -266,64 +590,16 @@ arv_gc_enumeration_dup_available_int_values (ArvGcEnumeration *enumeration, guin
 	g_return_val_if_fail (ARV_IS_GC_ENUMERATION (enumeration), NULL);
 	g_return_val_if_fail (error == NULL || *error == NULL, NULL);
 
-	entries = arv_gc_enumeration_get_entries (enumeration);
-
-	*n_values = 0;
-	for (iter = entries; iter != NULL; iter = iter->next) {
-		gboolean is_available;
-
-		is_available = arv_gc_feature_node_is_available (iter->data, &local_error);
-
-		if (local_error != NULL) {
-			g_propagate_error (error, local_error);
-			*n_values = 0;
-			g_slist_free (available_entries);
-
-			return NULL;
-		}
-
-		if (is_available) {
-			gboolean is_implemented;
-
-			is_implemented = arv_gc_feature_node_is_implemented (iter->data, &local_error);
-
-			if (local_error != NULL) {
-				g_propagate_error (error, local_error);
-				*n_values = 0;
-				g_slist_free (available_entries);
-
-				return NULL;
-			}
-
-			if (is_implemented) {
-				(*n_values)++;
-				available_entries = g_slist_prepend (available_entries, iter->data);
-			}
-		}
-	}
-
-	if (*n_values == 0) {
-		g_slist_free (available_entries);
+	available = _get_available (enumeration, error);
+	if (available == NULL)
 		return NULL;
-	}
-
-	values = g_new (gint64, *n_values);
-	for (iter = available_entries, i = 0; iter != NULL; iter = iter->next) {
-
-		values[i] = arv_gc_enum_entry_get_value (iter->data, &local_error);
-
-		if (local_error != NULL) {
-			g_propagate_error (error, local_error);
-			*n_values = 0;
-			g_slist_free (available_entries);
-			g_free (values);
 
-			return NULL;
-		}
-		i++;
+	if (available->n_entries > 0) {
+		values = arv_memdup (available->values, available->n_entries * sizeof (gint64));
+		*n_values = available->n_entries;
 	}
 
-	g_slist_free (available_entries);
+	_available_unref (available);
 
 	return values;
 }
@@ -331,11 +607,8 @@ arv_gc_enumeration_dup_available_int_values (ArvGcEnumeration *enumeration, guin
 static const char **
 _dup_available_string_values (ArvGcEnumeration *enumeration, gboolean display_name ,guint *n_values, GError **error)
 {
-	const char ** strings;
-	const GSList *entries, *iter;
-	GSList *available_entries = NULL;
-	unsigned int i;
-	GError *local_error = NULL;
+	ArvGcEnumerationAvailable *available;
+	const char **strings = NULL;
 
 	g_return_val_if_fail (n_values != NULL, NULL);
 
@@ -344,58 +617,18 @@ _dup_available_string_values (ArvGcEnumeration *enumeration, gboolean display_na
 	g_return_val_if_fail (ARV_IS_GC_ENUMERATION (enumeration), NULL);
 	g_return_val_if_fail (error == NULL || *error == NULL, NULL);
 
-	entries = arv_gc_enumeration_get_entries (enumeration);
-
-	*n_values = 0;
-	for (iter = entries; iter != NULL; iter = iter->next) {
-		gboolean is_available;
-
-		is_available = arv_gc_feature_node_is_available (iter->data, &local_error);
-
-		if (local_error != NULL) {
-			g_propagate_error (error, local_error);
-			*n_values = 0;
-			g_slist_free (available_entries);
-
-			return NULL;
-		}
-
-		if (is_available) {
-			gboolean is_implemented;
-
-			is_implemented = arv_gc_feature_node_is_implemented (iter->data, &local_error);
-
-			if (local_error != NULL) {
-				g_propagate_error (error, local_error);
-				*n_values = 0;
-				g_slist_free (available_entries);
-
-				return NULL;
-			}
-
-			if (is_implemented) {
-				(*n_values)++;
-				available_entries = g_slist_prepend (available_entries, iter->data);
-			}
-		}
-	}
-
-	if (*n_values == 0) {
-		g_slist_free (available_entries);
+	available = _get_available (enumeration, error);
+	if (available == NULL)
 		return NULL;
-	}
 
-	strings = g_new (const char*, *n_values);
-	for (iter = available_entries, i = 0; iter != NULL; iter = iter->next, i++) {
-		const char *string = NULL;
-		if (display_name)
-			string = arv_gc_feature_node_get_display_name (iter->data);
-		if (string == NULL)
-			string = arv_gc_feature_node_get_name (iter->data);
-		strings[i] = string;
+	/* The strings are owned by the entry nodes, only the container is copied */
+	if (available->n_entries > 0) {
+		strings = arv_memdup (display_name ? available->display_names : available->names,
+				      available->n_entries * sizeof (const char *));
+		*n_values = available->n_entries;
 	}
 
-	g_slist_free (available_entries);
+	_available_unref (available);
 
 	return strings;
 }
@@ -440,47 +673,14 @@ arv_gc_enumeration_dup_available_display_names (ArvGcEnumeration *enumeration, g
 	return _dup_available_string_values (enumeration, TRUE, n_values, error);
 }
 
-gboolean
-arv_gc_enumeration_set_int_value (ArvGcEnumeration *enumeration, gint64 value, GError **error)
+static gboolean
+_set_int_value (ArvGcEnumeration *enumeration, gint64 value, GError **error)
 {
-	g_return_val_if_fail (ARV_IS_GC_ENUMERATION (enumeration), FALSE);
-	g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
-
 	if (enumeration->value) {
 		GError *local_error = NULL;
 
-		{
-			gint64 *available_values;
-			unsigned n_values;
-			unsigned i;
-			gboolean found = FALSE;
-
-			available_values = arv_gc_enumeration_dup_available_int_values (enumeration, &n_values, &local_error);
-			if (local_error != NULL) {
-				g_propagate_error (error, local_error);
-				return FALSE;
-			}
-
-			if (available_values == NULL) {
-				g_set_error (error, ARV_GC_ERROR, ARV_GC_ERROR_EMPTY_ENUMERATION,
-					     "No available entry found in <Enumeration> '%s'",
-					     arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (enumeration)));
-				return FALSE;
-			}
-
-			for (i = 0; i < n_values; i++)
-				if (available_values[i] == value)
-					found = TRUE;
-
-			g_free (available_values);
-
-			if (!found) {
-				g_set_error (error, ARV_GC_ERROR, ARV_GC_ERROR_OUT_OF_RANGE,
-					     "Value not found in <Enumeration> '%s'",
-					     arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (enumeration)));
-				return FALSE;
-			}
-		}
+		if (!_check_available_value (enumeration, value, error))
+			return FALSE;
 
 		arv_gc_feature_node_increment_change_count (ARV_GC_FEATURE_NODE (enumeration));
 		arv_gc_property_node_set_int64 (enumeration->value, value, &local_error);
@@ -499,6 +699,29 @@ arv_gc_enumeration_set_int_value (ArvGcEnumeration *enumeration, gint64 value, G
 	return FALSE;
 }
 
+gboolean
+arv_gc_enumeration_set_int_value (ArvGcEnumeration *enumeration, gint64 value, GError **error)
+{
+	ArvGc *genicam;
+	gboolean success;
+	gboolean was_selector_write;
+
+	g_return_val_if_fail (ARV_IS_GC_ENUMERATION (enumeration), FALSE);
+	g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+
+	genicam = arv_gc_node_get_genicam (ARV_GC_NODE (enumeration));
+
+	/* The availability check and the write are done atomically */
+	arv_gc_access_begin (genicam, TRUE);
+	was_selector_write = arv_gc_access_set_selector_write
+		(genicam, arv_gc_selector_is_selector (ARV_GC_SELECTOR (enumeration)));
+	success = _set_int_value (enumeration, value, error);
+	arv_gc_access_set_selector_write (genicam, was_selector_write);
+	arv_gc_access_end (genicam);
+
+	return success;
+}
+
 /**
  * arv_gc_enumeration_get_entries:
  * @enumeration: a #ArvGcEnumeration
@@ -553,6 +776,8 @@ arv_gc_enumeration_finalize (GObject *object)
 	g_clear_pointer (&enumeration->entries, g_slist_free);
 	g_clear_pointer (&enumeration->selecteds, g_slist_free);
 	g_clear_pointer (&enumeration->selected_features, g_slist_free);
+	g_clear_pointer (&enumeration->available, _available_unref);
+	g_clear_pointer (&enumeration->table, _table_free);
 
 	G_OBJECT_CLASS (arv_gc_enumeration_parent_class)->finalize (object);
 }
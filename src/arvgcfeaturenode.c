@@ -30,7 +30,7 @@
 
 #include <arvgcfeaturenodeprivate.h>
 #include <arvgcpropertynode.h>
-#include <arvgc.h>
+#include <arvgcprivate.h>
 #include <arvgcboolean.h>
 #include <arvgcinteger.h>
 #include <arvgcfloat.h>
@@ -43,7 +43,9 @@
 
 typedef struct {
 
-	char *name;
+	/* Interned in the string pool of the genicam document, unless the node is an orphan */
+	const char *name;
+	char *name_copy;
 	ArvGcNameSpace name_space;
 
 	ArvGcPropertyNode *tooltip;
@@ -58,6 +60,18 @@ typedef struct {
 
 	guint64 change_count;
 
+	/* Reverse dependency graph: nodes having this node as invalidator */
+	GSList *invalidated_nodes;	/* #ArvGcFeatureNode */
+	gboolean invalidated;
+	gboolean is_propagating;
+
+	/* Bounds computed by the integer and float interfaces, valid for one generation of the document */
+	struct {
+		ArvGcFeatureNodeBoundValue value;
+		guint generation;
+		gboolean is_valid;
+	} bounds[ARV_GC_FEATURE_NODE_N_BOUNDS];
+
 	char *string_buffer;
 } ArvGcFeatureNodePrivate;
 
@@ -162,10 +176,14 @@ arv_gc_feature_node_set_attribute (ArvDomElement *self, const char *name, const
 	if (strcmp (name, "Name") == 0) {
 		ArvGc *genicam;
 
-		g_free (priv->name);
-		priv->name = g_strdup (value);
-
 		genicam = arv_gc_node_get_genicam (ARV_GC_NODE (self));
+
+		g_clear_pointer (&priv->name_copy, g_free);
+		if (genicam != NULL)
+			priv->name = arv_gc_intern_string (genicam, value);
+		else
+			priv->name = priv->name_copy = g_strdup (value);
+
 		/* Kludge around ugly Genicam specification (Really, pre-parsing for EnumEntry Name substitution ?) */
 		if (strcmp (arv_dom_node_get_node_name (ARV_DOM_NODE (self)), "EnumEntry") != 0)
 			arv_gc_register_feature_node (genicam, ARV_GC_FEATURE_NODE (self));
@@ -200,7 +218,7 @@ arv_gc_feature_node_get_attribute (ArvDomElement *self, const char *name)
 
 /* ArvGcFeatureNode implementation */
 
-static ArvGcFeatureNode *
+ArvGcFeatureNode *
 arv_gc_feature_node_get_linked_feature (ArvGcFeatureNode *node)
 {
 	g_return_val_if_fail (ARV_IS_GC_FEATURE_NODE (node), NULL);
@@ -497,14 +515,155 @@ arv_gc_feature_node_get_value_as_string (ArvGcFeatureNode *self, GError **error)
 	return NULL;
 }
 
+static void
+_propagate_invalidation (ArvGcFeatureNodePrivate *priv)
+{
+	GSList *iter;
+
+	/* Invalidator loops are not forbidden by the standard */
+	if (priv->is_propagating)
+		return;
+
+	priv->is_propagating = TRUE;
+
+	for (iter = priv->invalidated_nodes; iter != NULL; iter = iter->next) {
+		ArvGcFeatureNodePrivate *invalidated_priv = arv_gc_feature_node_get_instance_private (iter->data);
+
+		invalidated_priv->invalidated = TRUE;
+		_propagate_invalidation (invalidated_priv);
+	}
+
+	priv->is_propagating = FALSE;
+}
+
 void
 arv_gc_feature_node_increment_change_count (ArvGcFeatureNode *self)
 {
 	ArvGcFeatureNodePrivate *priv = arv_gc_feature_node_get_instance_private (self);
+	ArvGc *genicam;
 
 	g_return_if_fail (ARV_IS_GC_FEATURE_NODE (self));
 
 	priv->change_count++;
+
+	_propagate_invalidation (priv);
+
+	/* A change may have side effects on any register, and on any bound */
+	genicam = arv_gc_node_get_genicam (ARV_GC_NODE (self));
+	if (ARV_IS_GC (genicam)) {
+		arv_gc_register_cache_flush (arv_gc_get_register_cache (genicam));
+		arv_gc_increment_generation (genicam);
+	}
+}
+
+/* Any change of self will mark invalidated_node, and the nodes it invalidates, as invalidated */
+
+void
+arv_gc_feature_node_add_invalidated_node (ArvGcFeatureNode *self, ArvGcFeatureNode *invalidated_node)
+{
+	ArvGcFeatureNodePrivate *priv = arv_gc_feature_node_get_instance_private (self);
+
+	g_return_if_fail (ARV_IS_GC_FEATURE_NODE (self));
+	g_return_if_fail (ARV_IS_GC_FEATURE_NODE (invalidated_node));
+
+	if (g_slist_find (priv->invalidated_nodes, invalidated_node) == NULL)
+		priv->invalidated_nodes = g_slist_prepend (priv->invalidated_nodes, invalidated_node);
+}
+
+/* Returns TRUE if one of the invalidators of self has changed since the last call */
+
+gboolean
+arv_gc_feature_node_clear_invalidated (ArvGcFeatureNode *self)
+{
+	ArvGcFeatureNodePrivate *priv = arv_gc_feature_node_get_instance_private (self);
+	gboolean invalidated;
+
+	g_return_val_if_fail (ARV_IS_GC_FEATURE_NODE (self), FALSE);
+
+	invalidated = priv->invalidated;
+	priv->invalidated = FALSE;
+
+	return invalidated;
+}
+
+/* Marks the node, and the nodes it invalidates, as invalidated, after a change the node tree didn't see */
+
+void
+arv_gc_feature_node_invalidate (ArvGcFeatureNode *self)
+{
+	ArvGcFeatureNodePrivate *priv = arv_gc_feature_node_get_instance_private (self);
+	ArvGc *genicam;
+
+	g_return_if_fail (ARV_IS_GC_FEATURE_NODE (self));
+
+	priv->invalidated = TRUE;
+	_propagate_invalidation (priv);
+
+	genicam = arv_gc_node_get_genicam (ARV_GC_NODE (self));
+	if (ARV_IS_GC (genicam))
+		arv_gc_increment_generation (genicam);
+}
+
+/* Returns TRUE and the cached value if the bound was computed in the current generation of the document. Bounds are
+ * only cached along with the register values, when the register cache is enabled. */
+
+gboolean
+arv_gc_feature_node_lookup_bound (ArvGcFeatureNode *self, ArvGcFeatureNodeBound bound,
+				  ArvGcFeatureNodeBoundValue *value)
+{
+	ArvGcFeatureNodePrivate *priv = arv_gc_feature_node_get_instance_private (self);
+	ArvGc *genicam;
+	gboolean found;
+
+	g_return_val_if_fail (ARV_IS_GC_FEATURE_NODE (self), FALSE);
+	g_return_val_if_fail (bound < ARV_GC_FEATURE_NODE_N_BOUNDS, FALSE);
+	g_return_val_if_fail (value != NULL, FALSE);
+
+	genicam = arv_gc_node_get_genicam (ARV_GC_NODE (self));
+	if (!ARV_IS_GC (genicam) ||
+	    arv_gc_get_register_cache_policy (genicam) != ARV_REGISTER_CACHE_POLICY_ENABLE)
+		return FALSE;
+
+	arv_gc_lock_state (genicam);
+
+	found = priv->bounds[bound].is_valid && priv->bounds[bound].generation == arv_gc_get_generation (genicam);
+	if (found)
+		*value = priv->bounds[bound].value;
+
+	arv_gc_unlock_state (genicam);
+
+	return found;
+}
+
+/* Caches a bound computed from the given generation and volatile read count, sampled before the computation. It is
+ * dropped if the document changed, or if a volatile register was read, during the computation. */
+
+void
+arv_gc_feature_node_store_bound (ArvGcFeatureNode *self, ArvGcFeatureNodeBound bound,
+				 const ArvGcFeatureNodeBoundValue *value,
+				 guint generation, guint n_volatile_reads)
+{
+	ArvGcFeatureNodePrivate *priv = arv_gc_feature_node_get_instance_private (self);
+	ArvGc *genicam;
+
+	g_return_if_fail (ARV_IS_GC_FEATURE_NODE (self));
+	g_return_if_fail (bound < ARV_GC_FEATURE_NODE_N_BOUNDS);
+	g_return_if_fail (value != NULL);
+
+	genicam = arv_gc_node_get_genicam (ARV_GC_NODE (self));
+	if (!ARV_IS_GC (genicam) ||
+	    arv_gc_get_register_cache_policy (genicam) != ARV_REGISTER_CACHE_POLICY_ENABLE ||
+	    arv_gc_get_generation (genicam) != generation ||
+	    arv_gc_get_n_volatile_reads (genicam) != n_volatile_reads)
+		return;
+
+	arv_gc_lock_state (genicam);
+
+	priv->bounds[bound].value = *value;
+	priv->bounds[bound].generation = generation;
+	priv->bounds[bound].is_valid = TRUE;
+
+	arv_gc_unlock_state (genicam);
 }
 
 guint64
@@ -530,8 +689,9 @@ arv_gc_feature_node_finalize (GObject *object)
 {
 	ArvGcFeatureNodePrivate *priv = arv_gc_feature_node_get_instance_private (ARV_GC_FEATURE_NODE(object));
 
-	g_clear_pointer (&priv->name, g_free);
+	g_clear_pointer (&priv->name_copy, g_free);
 	g_clear_pointer (&priv->string_buffer, g_free);
+	g_clear_pointer (&priv->invalidated_nodes, g_slist_free);
 
 	G_OBJECT_CLASS (arv_gc_feature_node_parent_class)->finalize (object);
 }
@@ -28,9 +28,39 @@
 
 G_BEGIN_DECLS
 
+typedef enum {
+	ARV_GC_FEATURE_NODE_BOUND_INTEGER_MIN,
+	ARV_GC_FEATURE_NODE_BOUND_INTEGER_MAX,
+	ARV_GC_FEATURE_NODE_BOUND_INTEGER_INC,
+	ARV_GC_FEATURE_NODE_BOUND_FLOAT_MIN,
+	ARV_GC_FEATURE_NODE_BOUND_FLOAT_MAX,
+	ARV_GC_FEATURE_NODE_BOUND_FLOAT_INC,
+	ARV_GC_FEATURE_NODE_N_BOUNDS
+} ArvGcFeatureNodeBound;
+
+typedef union {
+	gint64 v_int64;
+	double v_double;
+} ArvGcFeatureNodeBoundValue;
+
 void			arv_gc_feature_node_increment_change_count	(ArvGcFeatureNode *gc_feature_node);
 guint64 		arv_gc_feature_node_get_change_count 		(ArvGcFeatureNode *gc_feature_node);
 
+void			arv_gc_feature_node_add_invalidated_node	(ArvGcFeatureNode *gc_feature_node,
+									 ArvGcFeatureNode *invalidated_node);
+gboolean		arv_gc_feature_node_clear_invalidated		(ArvGcFeatureNode *gc_feature_node);
+void			arv_gc_feature_node_invalidate			(ArvGcFeatureNode *gc_feature_node);
+
+gboolean		arv_gc_feature_node_lookup_bound		(ArvGcFeatureNode *gc_feature_node,
+									 ArvGcFeatureNodeBound bound,
+									 ArvGcFeatureNodeBoundValue *value);
+void			arv_gc_feature_node_store_bound			(ArvGcFeatureNode *gc_feature_node,
+									 ArvGcFeatureNodeBound bound,
+									 const ArvGcFeatureNodeBoundValue *value,
+									 guint generation, guint n_volatile_reads);
+
+ArvGcFeatureNode *	arv_gc_feature_node_get_linked_feature		(ArvGcFeatureNode *gc_feature_node);
+
 G_END_DECLS
 
 #endif
@@ -27,8 +27,10 @@
 
 #include <arvgcfloat.h>
 #include <arvgcfeaturenode.h>
+#include <arvgcfeaturenodeprivate.h>
 #include <arvgcdefaultsprivate.h>
 #include <arvgc.h>
+#include <arvgcprivate.h>
 #include <arvmisc.h>
 #include <stdio.h>
 #include <arvdebugprivate.h>
@@ -43,10 +45,126 @@ G_DEFINE_INTERFACE (ArvGcFloat, arv_gc_float, G_TYPE_OBJECT)
 double
 arv_gc_float_get_value (ArvGcFloat *gc_float, GError **error)
 {
+	ArvGc *genicam;
+	double value;
+
 	g_return_val_if_fail (ARV_IS_GC_FLOAT (gc_float), 0.0);
 	g_return_val_if_fail (error == NULL || *error == NULL, 0.0);
 
-	return ARV_GC_FLOAT_GET_IFACE (gc_float)->get_value (gc_float, error);
+	genicam = arv_gc_node_get_genicam (ARV_GC_NODE (gc_float));
+
+	arv_gc_access_begin (genicam, FALSE);
+	value = ARV_GC_FLOAT_GET_IFACE (gc_float)->get_value (gc_float, error);
+	arv_gc_access_end (genicam);
+
+	return value;
+}
+
+static gboolean
+_try_get_value (ArvGcFloat *gc_float, double *value)
+{
+	ArvGcFloatInterface *float_interface;
+	GError *local_error = NULL;
+
+	float_interface = ARV_GC_FLOAT_GET_IFACE (gc_float);
+
+	if (float_interface->try_get_value != NULL)
+		return float_interface->try_get_value (gc_float, value);
+
+	/* Register backed features only allocate an error on a failed device access */
+	*value = float_interface->get_value (gc_float, &local_error);
+	if (local_error != NULL) {
+		g_error_free (local_error);
+		*value = 0.0;
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+/**
+ * arv_gc_float_try_get_value:
+ * @gc_float: a #ArvGcFloat
+ * @value: (out): feature value
+ *
+ * Gets the feature value, like arv_gc_float_get_value(), but only returns a status. The features computed by the
+ * GenICam engine, like the swiss knives, converters or selected values, are evaluated without allocating any error on
+ * failure, which makes it suitable for polling features which may be unavailable.
+ *
+ * Returns: %TRUE on success, in which case @value is set.
+ *
+ * Since: 0.8.11
+ */
+
+gboolean
+arv_gc_float_try_get_value (ArvGcFloat *gc_float, double *value)
+{
+	ArvGc *genicam;
+	gboolean success;
+
+	g_return_val_if_fail (ARV_IS_GC_FLOAT (gc_float), FALSE);
+	g_return_val_if_fail (value != NULL, FALSE);
+
+	genicam = arv_gc_node_get_genicam (ARV_GC_NODE (gc_float));
+
+	arv_gc_access_begin (genicam, FALSE);
+	success = _try_get_value (gc_float, value);
+	arv_gc_access_end (genicam);
+
+	return success;
+}
+
+gboolean
+arv_gc_float_get_value_checked (ArvGcFloat *gc_float, double *value, GError **error)
+{
+	GError *local_error = NULL;
+
+	if (error == NULL)
+		return arv_gc_float_try_get_value (gc_float, value);
+
+	*value = arv_gc_float_get_value (gc_float, &local_error);
+	if (local_error != NULL) {
+		g_propagate_error (error, local_error);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+/* The bounds are cached on the feature node until the next change of the document, as evaluating them usually
+ * involves formulas and register reads */
+
+static double
+_get_bound (ArvGcFloat *gc_float, ArvGcFeatureNodeBound bound,
+	    double (*get_bound) (ArvGcFloat *gc_float, GError **error), GError **error)
+{
+	ArvGcFeatureNodeBoundValue cached;
+	GError *local_error = NULL;
+	ArvGc *genicam;
+	guint generation;
+	guint n_volatile_reads;
+	double value;
+
+	if (arv_gc_feature_node_lookup_bound (ARV_GC_FEATURE_NODE (gc_float), bound, &cached))
+		return cached.v_double;
+
+	genicam = arv_gc_node_get_genicam (ARV_GC_NODE (gc_float));
+	if (genicam == NULL)
+		return get_bound (gc_float, error);
+
+	generation = arv_gc_get_generation (genicam);
+	n_volatile_reads = arv_gc_get_n_volatile_reads (genicam);
+
+	value = get_bound (gc_float, &local_error);
+	if (local_error != NULL) {
+		g_propagate_error (error, local_error);
+		return value;
+	}
+
+	cached.v_double = value;
+	arv_gc_feature_node_store_bound (ARV_GC_FEATURE_NODE (gc_float), bound, &cached, generation, n_volatile_reads);
+
+	return value;
 }
 
 void
@@ -64,11 +182,15 @@ arv_gc_float_set_value (ArvGcFloat *gc_float, double value, GError **error)
 
 	policy = arv_gc_get_range_check_policy (genicam);
 
+	/* The range check and the write are done atomically */
+	arv_gc_access_begin (genicam, TRUE);
+
 	if (policy != ARV_RANGE_CHECK_POLICY_DISABLE) {
 		ArvGcFloatInterface *iface = ARV_GC_FLOAT_GET_IFACE (gc_float);
 
 		if (iface->get_min != NULL) {
-			double min = iface->get_min (gc_float, &local_error);
+			double min = _get_bound (gc_float, ARV_GC_FEATURE_NODE_BOUND_FLOAT_MIN,
+						 iface->get_min, &local_error);
 
 			if (local_error == NULL && value < min) {
 				g_set_error (&local_error, ARV_GC_ERROR, ARV_GC_ERROR_OUT_OF_RANGE,
@@ -79,7 +201,8 @@ arv_gc_float_set_value (ArvGcFloat *gc_float, double value, GError **error)
 		}
 
 		if (local_error == NULL && iface->get_max != NULL) {
-			double max = iface->get_max (gc_float, &local_error);
+			double max = _get_bound (gc_float, ARV_GC_FEATURE_NODE_BOUND_FLOAT_MAX,
+						 iface->get_max, &local_error);
 
 			if (local_error == NULL && value > max) {
 				g_set_error (&local_error, ARV_GC_ERROR, ARV_GC_ERROR_OUT_OF_RANGE,
@@ -94,6 +217,7 @@ arv_gc_float_set_value (ArvGcFloat *gc_float, double value, GError **error)
 				arv_warning_policies ("Range check (%s) ignored", local_error->message);
 			} else if (policy == ARV_RANGE_CHECK_POLICY_ENABLE) {
 				g_propagate_error (error, local_error);
+				arv_gc_access_end (genicam);
 				return;
 			}
 			g_clear_error (&local_error);
@@ -101,6 +225,8 @@ arv_gc_float_set_value (ArvGcFloat *gc_float, double value, GError **error)
 	}
 
 	ARV_GC_FLOAT_GET_IFACE (gc_float)->set_value (gc_float, value, error);
+
+	arv_gc_access_end (genicam);
 }
 
 double
@@ -113,8 +239,16 @@ arv_gc_float_get_min (ArvGcFloat *gc_float, GError **error)
 
 	float_interface = ARV_GC_FLOAT_GET_IFACE (gc_float);
 
-	if (float_interface->get_min != NULL)
-		return float_interface->get_min (gc_float, error);
+	if (float_interface->get_min != NULL) {
+		ArvGc *genicam = arv_gc_node_get_genicam (ARV_GC_NODE (gc_float));
+		double value;
+
+		arv_gc_access_begin (genicam, FALSE);
+		value = _get_bound (gc_float, ARV_GC_FEATURE_NODE_BOUND_FLOAT_MIN, float_interface->get_min, error);
+		arv_gc_access_end (genicam);
+
+		return value;
+	}
 
 	g_set_error (error, ARV_GC_ERROR, ARV_GC_ERROR_PROPERTY_NOT_DEFINED, "<Min> node not found for '%s'",
 		     arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (gc_float)));
@@ -132,8 +266,16 @@ arv_gc_float_get_max (ArvGcFloat *gc_float, GError **error)
 
 	float_interface = ARV_GC_FLOAT_GET_IFACE (gc_float);
 
-	if (float_interface->get_max != NULL)
-		return float_interface->get_max (gc_float, error);
+	if (float_interface->get_max != NULL) {
+		ArvGc *genicam = arv_gc_node_get_genicam (ARV_GC_NODE (gc_float));
+		double value;
+
+		arv_gc_access_begin (genicam, FALSE);
+		value = _get_bound (gc_float, ARV_GC_FEATURE_NODE_BOUND_FLOAT_MAX, float_interface->get_max, error);
+		arv_gc_access_end (genicam);
+
+		return value;
+	}
 
 	g_set_error (error, ARV_GC_ERROR, ARV_GC_ERROR_PROPERTY_NOT_DEFINED, "<Max> node not found for '%s'",
 		     arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (gc_float)));
@@ -151,8 +293,16 @@ arv_gc_float_get_inc (ArvGcFloat *gc_float, GError **error)
 
 	float_interface = ARV_GC_FLOAT_GET_IFACE (gc_float);
 
-	if (float_interface->get_inc != NULL)
-		return float_interface->get_inc (gc_float, error);
+	if (float_interface->get_inc != NULL) {
+		ArvGc *genicam = arv_gc_node_get_genicam (ARV_GC_NODE (gc_float));
+		double value;
+
+		arv_gc_access_begin (genicam, FALSE);
+		value = _get_bound (gc_float, ARV_GC_FEATURE_NODE_BOUND_FLOAT_INC, float_interface->get_inc, error);
+		arv_gc_access_end (genicam);
+
+		return value;
+	}
 
 	g_set_error (error, ARV_GC_ERROR, ARV_GC_ERROR_PROPERTY_NOT_DEFINED, "<Inc> node not found for '%s'",
 		     arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (gc_float)));
@@ -261,9 +411,15 @@ void arv_gc_float_impose_min (ArvGcFloat *gc_float, double minimum, GError **err
 
 	float_interface = ARV_GC_FLOAT_GET_IFACE (gc_float);
 
-	if (float_interface->impose_min != NULL)
+	if (float_interface->impose_min != NULL) {
+		ArvGc *genicam = arv_gc_node_get_genicam (ARV_GC_NODE (gc_float));
+
 		float_interface->impose_min (gc_float, minimum, error);
-	else
+
+		/* Drops the cached bounds */
+		if (genicam != NULL)
+			arv_gc_increment_generation (genicam);
+	} else
 		g_set_error (error, ARV_GC_ERROR, ARV_GC_ERROR_PROPERTY_NOT_DEFINED, "<Min> node not found for '%s'",
 			     arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (gc_float)));
 }
@@ -277,9 +433,15 @@ void arv_gc_float_impose_max (ArvGcFloat *gc_float, double maximum, GError **err
 
 	float_interface = ARV_GC_FLOAT_GET_IFACE (gc_float);
 
-	if (float_interface->impose_max != NULL)
+	if (float_interface->impose_max != NULL) {
+		ArvGc *genicam = arv_gc_node_get_genicam (ARV_GC_NODE (gc_float));
+
 		float_interface->impose_max (gc_float, maximum, error);
-	else
+
+		/* Drops the cached bounds */
+		if (genicam != NULL)
+			arv_gc_increment_generation (genicam);
+	} else
 		g_set_error (error, ARV_GC_ERROR, ARV_GC_ERROR_PROPERTY_NOT_DEFINED, "<Max> node not found for '%s'",
 			     arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (gc_float)));
 }
@@ -49,9 +49,11 @@ struct _ArvGcFloatInterface {
 	const char *		(*get_unit)		(ArvGcFloat *gc_float);
 	void			(*impose_min)		(ArvGcFloat *gc_float, double minimum, GError **error);
 	void			(*impose_max)		(ArvGcFloat *gc_float, double maximum, GError **error);
+	gboolean		(*try_get_value)	(ArvGcFloat *gc_float, double *value);
 };
 
 double			arv_gc_float_get_value			(ArvGcFloat *gc_float, GError **error);
+gboolean		arv_gc_float_try_get_value		(ArvGcFloat *gc_float, double *value);
 void			arv_gc_float_set_value			(ArvGcFloat *gc_float, double value, GError **error);
 double			arv_gc_float_get_min			(ArvGcFloat *gc_float, GError **error);
 double			arv_gc_float_get_max			(ArvGcFloat *gc_float, GError **error);
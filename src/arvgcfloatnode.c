@@ -242,6 +242,35 @@ arv_gc_float_node_get_float_value (ArvGcFloat *gc_float, GError **error)
 	return value;
 }
 
+static gboolean
+arv_gc_float_node_try_get_float_value (ArvGcFloat *gc_float, double *value)
+{
+	ArvGcFloatNode *gc_float_node = ARV_GC_FLOAT_NODE (gc_float);
+	ArvGcPropertyNode *value_node = gc_float_node->value;
+
+	if (value_node == NULL && gc_float_node->index != NULL) {
+		GSList *iter;
+		gint64 index;
+
+		if (!arv_gc_property_node_try_get_int64 (ARV_GC_PROPERTY_NODE (gc_float_node->index), &index))
+			return FALSE;
+
+		for (iter = gc_float_node->value_indexed_nodes; iter != NULL && value_node == NULL; iter = iter->next)
+			if (arv_gc_value_indexed_node_get_index (iter->data) == index)
+				value_node = iter->data;
+
+		if (value_node == NULL)
+			value_node = gc_float_node->value_default;
+	}
+
+	if (value_node == NULL) {
+		*value = 0;
+		return TRUE;
+	}
+
+	return arv_gc_property_node_try_get_double (value_node, value);
+}
+
 static void
 arv_gc_float_node_set_float_value (ArvGcFloat *gc_float, double value, GError **error)
 {
@@ -452,6 +481,7 @@ static void
 arv_gc_float_node_float_interface_init (ArvGcFloatInterface *interface)
 {
 	interface->get_value = arv_gc_float_node_get_float_value;
+	interface->try_get_value = arv_gc_float_node_try_get_float_value;
 	interface->set_value = arv_gc_float_node_set_float_value;
 	interface->get_min = arv_gc_float_node_get_min;
 	interface->get_max = arv_gc_float_node_get_max;
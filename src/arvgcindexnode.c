@@ -88,6 +88,39 @@ arv_gc_index_node_get_attribute (ArvDomElement *self, const char *name)
 
 /* ArvGcIndexNode implementation */
 
+/* Address offset per unit of the index value */
+
+gint64
+arv_gc_index_node_get_offset (ArvGcIndexNode *index_node, gint64 default_offset, GError **error)
+{
+	gint64 offset;
+	GError *local_error = NULL;
+
+	g_return_val_if_fail (ARV_IS_GC_INDEX_NODE (index_node), 0);
+	g_return_val_if_fail (error == NULL || *error == NULL, 0);
+
+	if (index_node->offset == NULL)
+		return default_offset;
+
+	if (index_node->is_p_offset) {
+		ArvGcNode *node;
+		ArvGc *genicam;
+
+		genicam = arv_gc_node_get_genicam (ARV_GC_NODE (index_node));
+		node = arv_gc_get_node (genicam, index_node->offset);
+		offset = arv_gc_integer_get_value (ARV_GC_INTEGER (node), &local_error);
+
+		if (local_error != NULL) {
+			g_propagate_error (error, local_error);
+
+			return 0;
+		}
+	} else
+		offset = g_ascii_strtoll (index_node->offset, NULL, 0);
+
+	return offset;
+}
+
 gint64
 arv_gc_index_node_get_index (ArvGcIndexNode *index_node, gint64 default_offset, GError **error)
 {
@@ -98,24 +131,10 @@ arv_gc_index_node_get_index (ArvGcIndexNode *index_node, gint64 default_offset,
 	g_return_val_if_fail (ARV_IS_GC_INDEX_NODE (index_node), 0);
 	g_return_val_if_fail (error == NULL || *error == NULL, 0);
 
-	if (index_node->offset == NULL)
-		offset = default_offset;
-	else {
-		if (index_node->is_p_offset) {
-			ArvGcNode *node;
-			ArvGc *genicam;
-
-			genicam = arv_gc_node_get_genicam (ARV_GC_NODE (index_node));
-			node = arv_gc_get_node (genicam, index_node->offset);
-			offset = arv_gc_integer_get_value (ARV_GC_INTEGER (node), &local_error);
-
-			if (local_error != NULL) {
-				g_propagate_error (error, local_error);
-
-				return 0;
-			}
-		} else
-			offset = g_ascii_strtoll (index_node->offset, NULL, 0);
+	offset = arv_gc_index_node_get_offset (index_node, default_offset, &local_error);
+	if (local_error != NULL) {
+		g_propagate_error (error, local_error);
+		return 0;
 	}
 
 	node_value = arv_gc_property_node_get_int64 (ARV_GC_PROPERTY_NODE (index_node), &local_error);
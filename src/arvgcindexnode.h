@@ -37,6 +37,7 @@ G_DECLARE_FINAL_TYPE (ArvGcIndexNode, arv_gc_index_node, ARV, GC_INDEX_NODE, Arv
 
 ArvGcNode * 	arv_gc_index_node_new 		(void);
 gint64		arv_gc_index_node_get_index	(ArvGcIndexNode *index_node, gint64 default_offset, GError **error);
+gint64		arv_gc_index_node_get_offset	(ArvGcIndexNode *index_node, gint64 default_offset, GError **error);
 
 G_END_DECLS
 
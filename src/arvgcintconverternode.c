@@ -71,6 +71,12 @@ arv_gc_converter_get_integer_value (ArvGcInteger *gc_integer, GError **error)
 	return arv_gc_converter_convert_to_int64 (ARV_GC_CONVERTER (gc_integer), ARV_GC_CONVERTER_NODE_TYPE_VALUE, error);
 }
 
+static gboolean
+arv_gc_converter_try_get_integer_value (ArvGcInteger *gc_integer, gint64 *value)
+{
+	return arv_gc_converter_try_convert_to_int64 (ARV_GC_CONVERTER (gc_integer), value);
+}
+
 static gint64
 arv_gc_converter_get_integer_min (ArvGcInteger *gc_integer, GError **error)
 {
@@ -147,6 +153,7 @@ static void
 arv_gc_int_converter_node_integer_interface_init (ArvGcIntegerInterface *interface)
 {
 	interface->get_value = arv_gc_converter_get_integer_value;
+	interface->try_get_value = arv_gc_converter_try_get_integer_value;
 	interface->get_min = arv_gc_converter_get_integer_min;
 	interface->get_max = arv_gc_converter_get_integer_max;
 	interface->get_inc = _get_inc;
@@ -27,7 +27,10 @@
 
 #include <arvgcinteger.h>
 #include <arvgcfeaturenode.h>
+#include <arvgcfeaturenodeprivate.h>
+#include <arvgcselector.h>
 #include <arvgc.h>
+#include <arvgcprivate.h>
 #include <arvmisc.h>
 #include <arvdebugprivate.h>
 
@@ -41,64 +44,207 @@ G_DEFINE_INTERFACE (ArvGcInteger, arv_gc_integer, G_TYPE_OBJECT)
 gint64
 arv_gc_integer_get_value (ArvGcInteger *gc_integer, GError **error)
 {
+	ArvGc *genicam;
+	gint64 value;
+
 	g_return_val_if_fail (ARV_IS_GC_INTEGER (gc_integer), 0);
 	g_return_val_if_fail (error == NULL || *error == NULL, 0);
 
-	return ARV_GC_INTEGER_GET_IFACE (gc_integer)->get_value (gc_integer, error);
+	genicam = arv_gc_node_get_genicam (ARV_GC_NODE (gc_integer));
+
+	arv_gc_access_begin (genicam, FALSE);
+	value = ARV_GC_INTEGER_GET_IFACE (gc_integer)->get_value (gc_integer, error);
+	arv_gc_access_end (genicam);
+
+	return value;
 }
 
-void
-arv_gc_integer_set_value (ArvGcInteger *gc_integer, gint64 value, GError **error)
+static gboolean
+_try_get_value (ArvGcInteger *gc_integer, gint64 *value)
+{
+	ArvGcIntegerInterface *integer_interface;
+	GError *local_error = NULL;
+
+	integer_interface = ARV_GC_INTEGER_GET_IFACE (gc_integer);
+
+	if (integer_interface->try_get_value != NULL)
+		return integer_interface->try_get_value (gc_integer, value);
+
+	/* Register backed features only allocate an error on a failed device access */
+	*value = integer_interface->get_value (gc_integer, &local_error);
+	if (local_error != NULL) {
+		g_error_free (local_error);
+		*value = 0;
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+/**
+ * arv_gc_integer_try_get_value:
+ * @gc_integer: a #ArvGcInteger
+ * @value: (out): feature value
+ *
+ * Gets the feature value, like arv_gc_integer_get_value(), but only returns a status. The features computed by the
+ * GenICam engine, like the swiss knives, converters or selected values, are evaluated without allocating any error on
+ * failure, which makes it suitable for polling features which may be unavailable.
+ *
+ * Returns: %TRUE on success, in which case @value is set.
+ *
+ * Since: 0.8.11
+ */
+
+gboolean
+arv_gc_integer_try_get_value (ArvGcInteger *gc_integer, gint64 *value)
 {
 	ArvGc *genicam;
-	ArvRangeCheckPolicy policy;
+	gboolean success;
+
+	g_return_val_if_fail (ARV_IS_GC_INTEGER (gc_integer), FALSE);
+	g_return_val_if_fail (value != NULL, FALSE);
+
+	genicam = arv_gc_node_get_genicam (ARV_GC_NODE (gc_integer));
+
+	arv_gc_access_begin (genicam, FALSE);
+	success = _try_get_value (gc_integer, value);
+	arv_gc_access_end (genicam);
+
+	return success;
+}
+
+gboolean
+arv_gc_integer_get_value_checked (ArvGcInteger *gc_integer, gint64 *value, GError **error)
+{
 	GError *local_error = NULL;
 
-	g_return_if_fail (ARV_IS_GC_INTEGER (gc_integer));
-	g_return_if_fail (error == NULL || *error == NULL);
+	if (error == NULL)
+		return arv_gc_integer_try_get_value (gc_integer, value);
+
+	*value = arv_gc_integer_get_value (gc_integer, &local_error);
+	if (local_error != NULL) {
+		g_propagate_error (error, local_error);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+/* The bounds are cached on the feature node until the next change of the document, as evaluating them usually
+ * involves formulas and register reads */
+
+static gint64
+_get_bound (ArvGcInteger *gc_integer, ArvGcFeatureNodeBound bound,
+	    gint64 (*get_bound) (ArvGcInteger *gc_integer, GError **error), GError **error)
+{
+	ArvGcFeatureNodeBoundValue cached;
+	GError *local_error = NULL;
+	ArvGc *genicam;
+	guint generation;
+	guint n_volatile_reads;
+	gint64 value;
+
+	if (arv_gc_feature_node_lookup_bound (ARV_GC_FEATURE_NODE (gc_integer), bound, &cached))
+		return cached.v_int64;
 
 	genicam = arv_gc_node_get_genicam (ARV_GC_NODE (gc_integer));
-	g_return_if_fail (ARV_IS_GC (genicam));
+	if (genicam == NULL)
+		return get_bound (gc_integer, error);
 
-	policy = arv_gc_get_range_check_policy (genicam);
+	generation = arv_gc_get_generation (genicam);
+	n_volatile_reads = arv_gc_get_n_volatile_reads (genicam);
+
+	value = get_bound (gc_integer, &local_error);
+	if (local_error != NULL) {
+		g_propagate_error (error, local_error);
+		return value;
+	}
+
+	cached.v_int64 = value;
+	arv_gc_feature_node_store_bound (ARV_GC_FEATURE_NODE (gc_integer), bound, &cached, generation, n_volatile_reads);
+
+	return value;
+}
 
-	if (policy != ARV_RANGE_CHECK_POLICY_DISABLE) {
-		ArvGcIntegerInterface *iface = ARV_GC_INTEGER_GET_IFACE (gc_integer);
+/* Applies the range check policy of the document to a value about to be written. Returns FALSE if the write must be
+ * refused, with error set. Must be called inside a feature access. */
 
-		if (iface->get_min != NULL) {
-			gint64 min = iface->get_min (gc_integer, &local_error);
+gboolean
+arv_gc_integer_check_range (ArvGcInteger *gc_integer, gint64 value, GError **error)
+{
+	ArvGcIntegerInterface *iface = ARV_GC_INTEGER_GET_IFACE (gc_integer);
+	ArvRangeCheckPolicy policy;
+	GError *local_error = NULL;
+	ArvGc *genicam;
 
-			if (local_error == NULL && value < min) {
-				g_set_error (&local_error, ARV_GC_ERROR, ARV_GC_ERROR_OUT_OF_RANGE,
-					     "Value '%" G_GINT64_FORMAT "' "
-					     "for node '%s' lower than allowed minimum '%" G_GINT64_FORMAT "'",
-					     value, arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (gc_integer)), min);
-			}
+	genicam = arv_gc_node_get_genicam (ARV_GC_NODE (gc_integer));
+	g_return_val_if_fail (ARV_IS_GC (genicam), FALSE);
+
+	policy = arv_gc_get_range_check_policy (genicam);
+	if (policy == ARV_RANGE_CHECK_POLICY_DISABLE)
+		return TRUE;
+
+	if (iface->get_min != NULL) {
+		gint64 min = _get_bound (gc_integer, ARV_GC_FEATURE_NODE_BOUND_INTEGER_MIN,
+					 iface->get_min, &local_error);
+
+		if (local_error == NULL && value < min) {
+			g_set_error (&local_error, ARV_GC_ERROR, ARV_GC_ERROR_OUT_OF_RANGE,
+				     "Value '%" G_GINT64_FORMAT "' "
+				     "for node '%s' lower than allowed minimum '%" G_GINT64_FORMAT "'",
+				     value, arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (gc_integer)), min);
 		}
+	}
 
-		if (local_error == NULL && iface->get_max != NULL) {
-			gint64 max = iface->get_max (gc_integer, &local_error);
+	if (local_error == NULL && iface->get_max != NULL) {
+		gint64 max = _get_bound (gc_integer, ARV_GC_FEATURE_NODE_BOUND_INTEGER_MAX,
+					 iface->get_max, &local_error);
 
-			if (local_error == NULL && value > max) {
-				g_set_error (&local_error, ARV_GC_ERROR, ARV_GC_ERROR_OUT_OF_RANGE,
-					     "Value '%" G_GINT64_FORMAT "' "
-					     "for node '%s' greater than allowed maximum '%" G_GINT64_FORMAT "'",
-					     value, arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (gc_integer)), max);
-			}
+		if (local_error == NULL && value > max) {
+			g_set_error (&local_error, ARV_GC_ERROR, ARV_GC_ERROR_OUT_OF_RANGE,
+				     "Value '%" G_GINT64_FORMAT "' "
+				     "for node '%s' greater than allowed maximum '%" G_GINT64_FORMAT "'",
+				     value, arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (gc_integer)), max);
 		}
+	}
 
-		if (local_error != NULL) {
-			if (policy == ARV_RANGE_CHECK_POLICY_DEBUG) {
-				arv_warning_policies ("Range check (%s) ignored", local_error->message);
-			} else if (policy == ARV_RANGE_CHECK_POLICY_ENABLE) {
-				g_propagate_error (error, local_error);
-				return;
-			}
-			g_clear_error (&local_error);
+	if (local_error != NULL) {
+		if (policy == ARV_RANGE_CHECK_POLICY_DEBUG) {
+			arv_warning_policies ("Range check (%s) ignored", local_error->message);
+		} else if (policy == ARV_RANGE_CHECK_POLICY_ENABLE) {
+			g_propagate_error (error, local_error);
+			return FALSE;
 		}
+		g_clear_error (&local_error);
 	}
 
-	ARV_GC_INTEGER_GET_IFACE (gc_integer)->set_value (gc_integer, value, error);
+	return TRUE;
+}
+
+void
+arv_gc_integer_set_value (ArvGcInteger *gc_integer, gint64 value, GError **error)
+{
+	ArvGc *genicam;
+	gboolean was_selector_write;
+
+	g_return_if_fail (ARV_IS_GC_INTEGER (gc_integer));
+	g_return_if_fail (error == NULL || *error == NULL);
+
+	genicam = arv_gc_node_get_genicam (ARV_GC_NODE (gc_integer));
+	g_return_if_fail (ARV_IS_GC (genicam));
+
+	/* The range check and the write are done atomically */
+	arv_gc_access_begin (genicam, TRUE);
+
+	was_selector_write = arv_gc_access_set_selector_write
+		(genicam, ARV_IS_GC_SELECTOR (gc_integer) && arv_gc_selector_is_selector (ARV_GC_SELECTOR (gc_integer)));
+
+	if (arv_gc_integer_check_range (gc_integer, value, error))
+		ARV_GC_INTEGER_GET_IFACE (gc_integer)->set_value (gc_integer, value, error);
+
+	arv_gc_access_set_selector_write (genicam, was_selector_write);
+
+	arv_gc_access_end (genicam);
 }
 
 gint64
@@ -111,8 +257,16 @@ arv_gc_integer_get_min (ArvGcInteger *gc_integer, GError **error)
 
 	integer_interface = ARV_GC_INTEGER_GET_IFACE (gc_integer);
 
-	if (integer_interface->get_min != NULL)
-		return integer_interface->get_min (gc_integer, error);
+	if (integer_interface->get_min != NULL) {
+		ArvGc *genicam = arv_gc_node_get_genicam (ARV_GC_NODE (gc_integer));
+		gint64 value;
+
+		arv_gc_access_begin (genicam, FALSE);
+		value = _get_bound (gc_integer, ARV_GC_FEATURE_NODE_BOUND_INTEGER_MIN, integer_interface->get_min, error);
+		arv_gc_access_end (genicam);
+
+		return value;
+	}
 
 	g_set_error (error, ARV_GC_ERROR, ARV_GC_ERROR_PROPERTY_NOT_DEFINED, "<Min> node not found for '%s'",
 		     arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (gc_integer)));
@@ -130,8 +284,16 @@ arv_gc_integer_get_max (ArvGcInteger *gc_integer, GError **error)
 
 	integer_interface = ARV_GC_INTEGER_GET_IFACE (gc_integer);
 
-	if (integer_interface->get_max != NULL)
-		return integer_interface->get_max (gc_integer, error);
+	if (integer_interface->get_max != NULL) {
+		ArvGc *genicam = arv_gc_node_get_genicam (ARV_GC_NODE (gc_integer));
+		gint64 value;
+
+		arv_gc_access_begin (genicam, FALSE);
+		value = _get_bound (gc_integer, ARV_GC_FEATURE_NODE_BOUND_INTEGER_MAX, integer_interface->get_max, error);
+		arv_gc_access_end (genicam);
+
+		return value;
+	}
 
 	g_set_error (error, ARV_GC_ERROR, ARV_GC_ERROR_PROPERTY_NOT_DEFINED, "<Max> node not found for '%s'",
 		     arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (gc_integer)));
@@ -149,8 +311,16 @@ arv_gc_integer_get_inc (ArvGcInteger *gc_integer, GError **error)
 
 	integer_interface = ARV_GC_INTEGER_GET_IFACE (gc_integer);
 
-	if (integer_interface->get_inc != NULL)
-		return integer_interface->get_inc (gc_integer, error);
+	if (integer_interface->get_inc != NULL) {
+		ArvGc *genicam = arv_gc_node_get_genicam (ARV_GC_NODE (gc_integer));
+		gint64 value;
+
+		arv_gc_access_begin (genicam, FALSE);
+		value = _get_bound (gc_integer, ARV_GC_FEATURE_NODE_BOUND_INTEGER_INC, integer_interface->get_inc, error);
+		arv_gc_access_end (genicam);
+
+		return value;
+	}
 
 	g_set_error (error, ARV_GC_ERROR, ARV_GC_ERROR_PROPERTY_NOT_DEFINED, "<Inc> node not found for '%s'",
 		     arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (gc_integer)));
@@ -206,9 +376,15 @@ void arv_gc_integer_impose_min (ArvGcInteger *gc_integer, gint64 minimum, GError
 
 	integer_interface = ARV_GC_INTEGER_GET_IFACE (gc_integer);
 
-	if (integer_interface->impose_min != NULL)
+	if (integer_interface->impose_min != NULL) {
+		ArvGc *genicam = arv_gc_node_get_genicam (ARV_GC_NODE (gc_integer));
+
 		integer_interface->impose_min (gc_integer, minimum, error);
-	else
+
+		/* Drops the cached bounds */
+		if (genicam != NULL)
+			arv_gc_increment_generation (genicam);
+	} else
 		g_set_error (error, ARV_GC_ERROR, ARV_GC_ERROR_PROPERTY_NOT_DEFINED, "<Min> node not found for '%s'",
 			     arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (gc_integer)));
 }
@@ -222,9 +398,15 @@ void arv_gc_integer_impose_max (ArvGcInteger *gc_integer, gint64 maximum, GError
 
 	integer_interface = ARV_GC_INTEGER_GET_IFACE (gc_integer);
 
-	if (integer_interface->impose_max != NULL)
+	if (integer_interface->impose_max != NULL) {
+		ArvGc *genicam = arv_gc_node_get_genicam (ARV_GC_NODE (gc_integer));
+
 		integer_interface->impose_max (gc_integer, maximum, error);
-	else
+
+		/* Drops the cached bounds */
+		if (genicam != NULL)
+			arv_gc_increment_generation (genicam);
+	} else
 		g_set_error (error, ARV_GC_ERROR, ARV_GC_ERROR_PROPERTY_NOT_DEFINED, "<Max> node not found for '%s'",
 			     arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (gc_integer)));
 }
@@ -47,9 +47,11 @@ struct _ArvGcIntegerInterface {
 	const char *		(*get_unit)		(ArvGcInteger *gc_integer);
 	void			(*impose_min)		(ArvGcInteger *gc_integer, gint64 minimum, GError **error);
 	void			(*impose_max)		(ArvGcInteger *gc_integer, gint64 maximum, GError **error);
+	gboolean		(*try_get_value)	(ArvGcInteger *gc_integer, gint64 *value);
 };
 
 gint64			arv_gc_integer_get_value		(ArvGcInteger *gc_integer, GError **error);
+gboolean		arv_gc_integer_try_get_value		(ArvGcInteger *gc_integer, gint64 *value);
 void			arv_gc_integer_set_value		(ArvGcInteger *gc_integer, gint64 value, GError **error);
 gint64			arv_gc_integer_get_min			(ArvGcInteger *gc_integer, GError **error);
 gint64			arv_gc_integer_get_max			(ArvGcInteger *gc_integer, GError **error);
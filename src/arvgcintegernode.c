@@ -245,6 +245,35 @@ arv_gc_integer_node_get_integer_value (ArvGcInteger *gc_integer, GError **error)
 	return value;
 }
 
+static gboolean
+arv_gc_integer_node_try_get_integer_value (ArvGcInteger *gc_integer, gint64 *value)
+{
+	ArvGcIntegerNode *gc_integer_node = ARV_GC_INTEGER_NODE (gc_integer);
+	ArvGcPropertyNode *value_node = gc_integer_node->value;
+
+	if (value_node == NULL && gc_integer_node->index != NULL) {
+		GSList *iter;
+		gint64 index;
+
+		if (!arv_gc_property_node_try_get_int64 (ARV_GC_PROPERTY_NODE (gc_integer_node->index), &index))
+			return FALSE;
+
+		for (iter = gc_integer_node->value_indexed_nodes; iter != NULL && value_node == NULL; iter = iter->next)
+			if (arv_gc_value_indexed_node_get_index (iter->data) == index)
+				value_node = iter->data;
+
+		if (value_node == NULL)
+			value_node = gc_integer_node->value_default;
+	}
+
+	if (value_node == NULL) {
+		*value = 0;
+		return TRUE;
+	}
+
+	return arv_gc_property_node_try_get_int64 (value_node, value);
+}
+
 static void
 arv_gc_integer_node_set_integer_value (ArvGcInteger *gc_integer, gint64 value, GError **error)
 {
@@ -432,6 +461,7 @@ static void
 arv_gc_integer_node_integer_interface_init (ArvGcIntegerInterface *interface)
 {
 	interface->get_value = arv_gc_integer_node_get_integer_value;
+	interface->try_get_value = arv_gc_integer_node_try_get_integer_value;
 	interface->set_value = arv_gc_integer_node_set_integer_value;
 	interface->get_min = arv_gc_integer_node_get_min;
 	interface->get_max = arv_gc_integer_node_get_max;
@@ -45,6 +45,12 @@ arv_gc_int_swiss_knife_node_get_integer_value (ArvGcInteger *self, GError **erro
 	return arv_gc_swiss_knife_get_integer_value (ARV_GC_SWISS_KNIFE (self), error);
 }
 
+static gboolean
+arv_gc_int_swiss_knife_node_try_get_integer_value (ArvGcInteger *self, gint64 *value)
+{
+	return arv_gc_swiss_knife_try_get_integer_value (ARV_GC_SWISS_KNIFE (self), value);
+}
+
 static void
 arv_gc_int_swiss_knife_node_set_integer_value (ArvGcInteger *self, gint64 value, GError **error)
 {
@@ -73,6 +79,7 @@ static void
 arv_gc_int_swiss_knife_node_integer_interface_init (ArvGcIntegerInterface *interface)
 {
 	interface->get_value = arv_gc_int_swiss_knife_node_get_integer_value;
+	interface->try_get_value = arv_gc_int_swiss_knife_node_try_get_integer_value;
 	interface->set_value = arv_gc_int_swiss_knife_node_set_integer_value;
 	interface->get_representation = arv_gc_swiss_knife_node_get_integer_representation;
 	interface->get_unit = arv_gc_swiss_knife_node_get_integer_unit;
@@ -130,6 +130,26 @@ arv_gc_masked_int_reg_node_set_integer_value (ArvGcInteger *self, gint64 value,
 		 TRUE, value, error);
 }
 
+/* Describes the bit field written by arv_gc_masked_int_reg_node_set_integer_value(), see arv_gc_register_node_set_fields() */
+
+gboolean
+arv_gc_masked_int_reg_node_get_field (ArvGcMaskedIntRegNode *self, ArvGcRegisterField *field)
+{
+	ArvGcMaskedIntRegNodePrivate *priv = arv_gc_masked_int_reg_node_get_instance_private (self);
+
+	g_return_val_if_fail (ARV_IS_GC_MASKED_INT_REG_NODE (self), FALSE);
+	g_return_val_if_fail (field != NULL, FALSE);
+
+	field->register_node = ARV_GC_REGISTER_NODE (self);
+	field->lsb = arv_gc_property_node_get_lsb (priv->lsb, 0);
+	field->msb = arv_gc_property_node_get_msb (priv->msb, 31);
+	field->endianness = arv_gc_property_node_get_endianness (priv->endianness,
+								  ARV_GC_MASKED_INT_REG_NODE_DEFAULT_ENDIANNESS);
+	field->cachable = ARV_GC_CACHABLE_UNDEFINED;
+
+	return TRUE;
+}
+
 static gint64
 arv_gc_masked_int_reg_node_get_min (ArvGcInteger *self, GError **error)
 {
@@ -25,15 +25,18 @@
  * @short_description: Class for Port nodes
  */
 
-#include <arvgcport.h>
+#include <arvgcportprivate.h>
+#include <arvgcprivate.h>
 #include <arvgcregisterdescriptionnode.h>
 #include <arvgcfeaturenodeprivate.h>
 #include <arvdevice.h>
+#include <arvdeviceprivate.h>
 #include <arvgvdevice.h>
 #include <arvchunkparserprivate.h>
 #include <arvbuffer.h>
 #include <arvgcpropertynode.h>
 #include <arvgc.h>
+#include <arvdebugprivate.h>
 #include <memory.h>
 
 typedef struct {
@@ -138,24 +141,52 @@ arv_gc_port_read (ArvGcPort *port, void *buffer, guint64 address, guint64 length
 			}
 		}
 	} else if (port->priv->event_id != NULL) {
-		g_set_error (error, ARV_GC_ERROR, ARV_GC_ERROR_NO_EVENT_IMPLEMENTATION,
-			     "[ArvGcPort::read] Event support is not implemented");
+		const char *event_data;
+		size_t event_data_size;
+		guint event_id;
+
+		event_id = g_ascii_strtoll (arv_gc_property_node_get_string (port->priv->event_id, NULL), NULL, 16);
+		event_data = arv_gc_get_event_data (genicam, event_id, &event_data_size);
+
+		if (event_data != NULL && address < event_data_size) {
+			memcpy (buffer, event_data + address, MIN (event_data_size - address, length));
+		} else {
+			g_set_error (error, ARV_GC_ERROR, ARV_GC_ERROR_EVENT_NOT_FOUND,
+				     "[ArvGcPort::read] Event 0x%04x data not found", event_id);
+		}
 	} else {
+		ArvRegisterSnapshot *snapshot;
 		ArvDevice *device;
 
+		snapshot = arv_gc_get_register_snapshot (genicam);
 		device = arv_gc_get_device (genicam);
-		if (ARV_IS_DEVICE (device)) {
+		if (snapshot != NULL) {
+			if (!arv_register_snapshot_read (snapshot, address, length, buffer))
+				g_set_error (error, ARV_GC_ERROR, ARV_GC_ERROR_NOT_IN_SNAPSHOT,
+					     "[ArvGcPort::read] %" G_GUINT64_FORMAT " bytes at 0x%" G_GINT64_MODIFIER "x not in snapshot",
+					     length, address);
+		} else if (ARV_IS_DEVICE (device)) {
+			ArvRegisterSnapshot *recorder;
+			GError *local_error = NULL;
+
 			/* For schema < 1.1.0 and length == 4, register read must be used instead of memory read.
 			 * Only applies to GigE Vision devices. See Appendix 3 of Genicam 2.0 specification. */
 			if (ARV_IS_GV_DEVICE (device) && _use_legacy_endianness_mechanism (port, length)) {
 				guint32 value = 0;
 
-				arv_device_read_register (device, address, &value, error);
+				arv_device_read_register (device, address, &value, &local_error);
 
 				/* For schema < 1.1.0, all registers are big endian. */
 				*((guint32 *) buffer) = GUINT32_TO_BE (value);
 			} else
-				arv_device_read_memory (device, address, length, buffer, error);
+				arv_device_read_memory (device, address, length, buffer, &local_error);
+
+			recorder = arv_gc_get_register_recorder (genicam);
+			if (local_error == NULL && recorder != NULL)
+				arv_register_snapshot_store (recorder, address, length, buffer);
+
+			if (local_error != NULL)
+				g_propagate_error (error, local_error);
 		} else {
 			g_set_error (error, ARV_GC_ERROR, ARV_GC_ERROR_NO_DEVICE_SET,
 				     "[ArvGcPort::read] No device set");
@@ -163,6 +194,187 @@ arv_gc_port_read (ArvGcPort *port, void *buffer, guint64 address, guint64 length
 	}
 }
 
+/* Same as arv_gc_port_read(), but served from the register block cache of the Genicam document. On a miss, the whole
+ * aligned block containing the range is read from the device. Chunk data, event ports and the legacy register access
+ * of old schemas are not cached. */
+
+void
+arv_gc_port_read_cached (ArvGcPort *port, void *buffer, guint64 address, guint64 length, GError **error)
+{
+	ArvGcRegisterCache *cache;
+	ArvGc *genicam;
+	ArvDevice *device;
+	GError *local_error = NULL;
+	guint64 block_address;
+	gboolean is_readable;
+	void *block;
+
+	g_return_if_fail (ARV_IS_GC_PORT (port));
+	g_return_if_fail (buffer != NULL);
+
+	genicam = arv_gc_node_get_genicam (ARV_GC_NODE (port));
+	device = arv_gc_get_device (genicam);
+
+	if (port->priv->chunk_id != NULL ||
+	    port->priv->event_id != NULL ||
+	    !ARV_IS_DEVICE (device) ||
+	    arv_gc_get_register_snapshot (genicam) != NULL ||
+	    (ARV_IS_GV_DEVICE (device) && _use_legacy_endianness_mechanism (port, length)) ||
+	    !arv_gc_register_cache_get_block_address (address, length, &block_address)) {
+		arv_gc_port_read (port, buffer, address, length, error);
+		return;
+	}
+
+	cache = arv_gc_get_register_cache (genicam);
+
+	if (arv_gc_register_cache_lookup (cache, port, address, length, buffer, &is_readable)) {
+		if (!is_readable)
+			arv_gc_port_read (port, buffer, address, length, error);
+		return;
+	}
+
+	block = g_malloc (ARV_GC_REGISTER_CACHE_BLOCK_SIZE);
+
+	arv_device_read_memory (device, block_address, ARV_GC_REGISTER_CACHE_BLOCK_SIZE, block, &local_error);
+	if (local_error == NULL) {
+		ArvRegisterSnapshot *recorder = arv_gc_get_register_recorder (genicam);
+
+		if (recorder != NULL)
+			arv_register_snapshot_store (recorder, block_address, ARV_GC_REGISTER_CACHE_BLOCK_SIZE, block);
+
+		arv_gc_register_cache_store (cache, port, block_address, block);
+		memcpy (buffer, ((char *) block) + (address - block_address), length);
+	} else {
+		arv_debug_genicam ("[GcPort::read_cached] Block 0x%" G_GINT64_MODIFIER "x not readable (%s)",
+				   block_address, local_error->message);
+		g_clear_error (&local_error);
+
+		arv_gc_register_cache_store (cache, port, block_address, NULL);
+		arv_gc_port_read (port, buffer, address, length, error);
+	}
+
+	g_free (block);
+}
+
+/* Maximum size of a single memory read of arv_gc_port_prefetch_blocks() */
+#define ARV_GC_PORT_PREFETCH_SIZE_MAX	(16 * ARV_GC_REGISTER_CACHE_BLOCK_SIZE)
+
+/* Fills the register block cache with the blocks at @block_addresses, sorted in increasing order and without
+ * duplicates. Runs of consecutive blocks which are not cached yet are read with a single memory read. A run which
+ * can't be read is left to arv_gc_port_read_cached(), which will then try its blocks one by one. */
+
+void
+arv_gc_port_prefetch_blocks (ArvGcPort *port, const guint64 *block_addresses, guint n_blocks)
+{
+	ArvGcRegisterCache *cache;
+	ArvRegisterSnapshot *recorder;
+	ArvGc *genicam;
+	ArvDevice *device;
+	guint8 *data;
+	guint i, j;
+
+	g_return_if_fail (ARV_IS_GC_PORT (port));
+	g_return_if_fail (block_addresses != NULL || n_blocks == 0);
+
+	genicam = arv_gc_node_get_genicam (ARV_GC_NODE (port));
+	device = arv_gc_get_device (genicam);
+
+	if (port->priv->chunk_id != NULL ||
+	    port->priv->event_id != NULL ||
+	    !ARV_IS_DEVICE (device) ||
+	    arv_gc_get_register_snapshot (genicam) != NULL ||
+	    (ARV_IS_GV_DEVICE (device) && _use_legacy_endianness_mechanism (port, 4)))
+		return;
+
+	cache = arv_gc_get_register_cache (genicam);
+	recorder = arv_gc_get_register_recorder (genicam);
+	data = g_malloc (ARV_GC_PORT_PREFETCH_SIZE_MAX);
+
+	for (i = 0; i < n_blocks; i = j) {
+		GError *local_error = NULL;
+		gboolean is_readable;
+		guint32 size;
+		guint k;
+
+		if (arv_gc_register_cache_lookup (cache, port, block_addresses[i], 1, data, &is_readable)) {
+			j = i + 1;
+			continue;
+		}
+
+		for (j = i + 1;
+		     j < n_blocks &&
+		     block_addresses[j] == block_addresses[j - 1] + ARV_GC_REGISTER_CACHE_BLOCK_SIZE &&
+		     (j - i + 1) * ARV_GC_REGISTER_CACHE_BLOCK_SIZE <= ARV_GC_PORT_PREFETCH_SIZE_MAX &&
+		     !arv_gc_register_cache_lookup (cache, port, block_addresses[j], 1, data, &is_readable);
+		     j++);
+
+		size = (j - i) * ARV_GC_REGISTER_CACHE_BLOCK_SIZE;
+
+		if (!arv_device_read_memory (device, block_addresses[i], size, data, &local_error)) {
+			arv_debug_genicam ("[GcPort::prefetch_blocks] %u bytes at 0x%" G_GINT64_MODIFIER "x not readable (%s)",
+					   size, block_addresses[i], local_error->message);
+			g_clear_error (&local_error);
+			continue;
+		}
+
+		if (recorder != NULL)
+			arv_register_snapshot_store (recorder, block_addresses[i], size, data);
+
+		for (k = i; k < j; k++)
+			arv_gc_register_cache_store (cache, port, block_addresses[k],
+						     data + (k - i) * ARV_GC_REGISTER_CACHE_BLOCK_SIZE);
+	}
+
+	g_free (data);
+}
+
+/* Reads @n_registers 4 byte registers, each into the corresponding buffer of @buffers, with the byte layout of
+ * arv_gc_port_read(). On GigE Vision devices, where the registers are big endian, they are read in batches using
+ * arv_device_read_registers(). */
+
+void
+arv_gc_port_read_registers (ArvGcPort *port, guint n_registers, const guint64 *addresses, void **buffers,
+			    GError **error)
+{
+	ArvRegisterSnapshot *recorder;
+	ArvGc *genicam;
+	ArvDevice *device;
+	guint32 *values;
+	guint i;
+
+	g_return_if_fail (ARV_IS_GC_PORT (port));
+	g_return_if_fail (addresses != NULL || n_registers == 0);
+	g_return_if_fail (buffers != NULL || n_registers == 0);
+
+	genicam = arv_gc_node_get_genicam (ARV_GC_NODE (port));
+	device = arv_gc_get_device (genicam);
+
+	if (port->priv->chunk_id != NULL || port->priv->event_id != NULL || !ARV_IS_GV_DEVICE (device) ||
+	    arv_gc_get_register_snapshot (genicam) != NULL) {
+		GError *local_error = NULL;
+
+		for (i = 0; i < n_registers && local_error == NULL; i++)
+			arv_gc_port_read (port, buffers[i], addresses[i], 4, &local_error);
+
+		if (local_error != NULL)
+			g_propagate_error (error, local_error);
+
+		return;
+	}
+
+	values = g_new (guint32, n_registers);
+	recorder = arv_gc_get_register_recorder (genicam);
+
+	if (arv_device_read_registers (device, n_registers, addresses, values, error))
+		for (i = 0; i < n_registers; i++) {
+			*((guint32 *) buffers[i]) = GUINT32_TO_BE (values[i]);
+			if (recorder != NULL)
+				arv_register_snapshot_store (recorder, addresses[i], 4, buffers[i]);
+		}
+
+	g_free (values);
+}
+
 void
 arv_gc_port_write (ArvGcPort *port, void *buffer, guint64 address, guint64 length, GError **error)
 {
@@ -202,10 +414,14 @@ arv_gc_port_write (ArvGcPort *port, void *buffer, guint64 address, guint64 lengt
 	} else if (port->priv->event_id != NULL) {
 		g_set_error (error, ARV_GC_ERROR, ARV_GC_ERROR_NO_EVENT_IMPLEMENTATION,
 			     "[ArvGcPort::read] Event support is not implemented");
+	} else if (arv_gc_get_register_snapshot (genicam) != NULL) {
+		arv_register_snapshot_write (arv_gc_get_register_snapshot (genicam), address, length, buffer);
 	} else {
 		device = arv_gc_get_device (genicam);
 
 		if (ARV_IS_DEVICE (device)) {
+			GError *local_error = NULL;
+
 			/* For schema < 1.1.0 and length == 4, register write must be used instead of memory write.
 			 * Only applies to GigE Vision devices. See Appendix 3 of Genicam 2.0 specification. */
 			if (ARV_IS_GV_DEVICE (device) && _use_legacy_endianness_mechanism (port, length)) {
@@ -215,9 +431,21 @@ arv_gc_port_write (ArvGcPort *port, void *buffer, guint64 address, guint64 lengt
 				value = *((guint32 *) buffer);
 				value = GUINT32_FROM_BE (value);
 
-				arv_device_write_register (device, address, value, error);
-			} else
-				arv_device_write_memory (device, address, length, buffer, error);
+				if (arv_device_write_register (device, address, value, &local_error))
+					arv_device_journal_write (device, address, sizeof (value), &value, TRUE,
+								  arv_gc_access_is_selector_write (genicam));
+			} else {
+				if (arv_device_write_memory (device, address, length, buffer, &local_error))
+					arv_device_journal_write (device, address, length, buffer, FALSE,
+								  arv_gc_access_is_selector_write (genicam));
+			}
+
+			if (local_error == NULL && arv_gc_get_register_recorder (genicam) != NULL)
+				arv_register_snapshot_write (arv_gc_get_register_recorder (genicam),
+							     address, length, buffer);
+
+			if (local_error != NULL)
+				g_propagate_error (error, local_error);
 		} else {
 			g_set_error (error, ARV_GC_ERROR, ARV_GC_ERROR_NO_DEVICE_SET,
 				     "[ArvGcPort::read] No device set");
@@ -0,0 +1,82 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2019 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel@gnome.org>
+ */
+
+#ifndef ARV_GC_PRIVATE_H
+#define ARV_GC_PRIVATE_H
+
+#if !defined (ARV_H_INSIDE) && !defined (ARAVIS_COMPILATION)
+#error "Only <arv.h> can be included directly."
+#endif
+
+#include <arvgc.h>
+#include <arvgcregistercacheprivate.h>
+
+G_BEGIN_DECLS
+
+ArvGc *		arv_gc_new_from_snapshot	(ArvDevice *device, GBytes *snapshot);
+
+void		arv_gc_set_lazy_loading		(gboolean enable);
+
+const char *	arv_gc_intern_string		(ArvGc *genicam, const char *string);
+const char *	arv_gc_lookup_interned_string	(ArvGc *genicam, const char *string);
+
+void			arv_gc_access_begin		(ArvGc *genicam, gboolean exclusive);
+void			arv_gc_access_end		(ArvGc *genicam);
+ArvBuffer *		arv_gc_access_bind_buffer	(ArvGc *genicam, ArvBuffer *buffer);
+gboolean		arv_gc_access_set_selector_write	(ArvGc *genicam, gboolean is_selector_write);
+gboolean		arv_gc_access_is_selector_write		(ArvGc *genicam);
+void			arv_gc_lock_state		(ArvGc *genicam);
+void			arv_gc_unlock_state		(ArvGc *genicam);
+
+ArvGcRegisterCache *	arv_gc_get_register_cache	(ArvGc *genicam);
+void			arv_gc_invalidate_registers	(ArvGc *genicam);
+
+guint			arv_gc_get_generation			(ArvGc *genicam);
+void			arv_gc_increment_generation		(ArvGc *genicam);
+guint			arv_gc_get_n_volatile_reads		(ArvGc *genicam);
+void			arv_gc_increment_n_volatile_reads	(ArvGc *genicam);
+
+ArvGcRegisterNode *	arv_gc_get_feature_register	(ArvGc *genicam, const char *feature);
+void			arv_gc_prefetch_features	(ArvGc *genicam, ArvGcFeatureNode **features, guint n_features);
+gboolean		arv_gc_set_integer_values	(ArvGc *genicam, guint n_features, const char **features,
+							 const gint64 *values, GError **error);
+gboolean		arv_gc_read_feature_for_selector	(ArvGc *genicam, ArvGcFeatureNode *feature,
+								 ArvGcFeatureNode *selector,
+								 const gint64 *selector_values,
+								 guint n_selector_values,
+								 GValue *values, GError **error);
+gboolean		arv_gc_write_integer_feature_for_selector	(ArvGc *genicam, ArvGcFeatureNode *feature,
+									 ArvGcFeatureNode *selector,
+									 const gint64 *selector_values,
+									 guint n_selector_values,
+									 const gint64 *values, GError **error);
+
+/* Status variants of the value getters, which don't allocate when error is NULL */
+
+gboolean		arv_gc_integer_get_value_checked	(ArvGcInteger *gc_integer, gint64 *value, GError **error);
+gboolean		arv_gc_float_get_value_checked		(ArvGcFloat *gc_float, double *value, GError **error);
+
+gboolean		arv_gc_integer_check_range		(ArvGcInteger *gc_integer, gint64 value, GError **error);
+
+G_END_DECLS
+
+#endif
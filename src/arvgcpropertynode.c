@@ -34,6 +34,7 @@
 #include <arvgcfloat.h>
 #include <arvgcstring.h>
 #include <arvgc.h>
+#include <arvgcprivate.h>
 #include <arvdomtext.h>
 #include <arvmisc.h>
 #include <arvdebugprivate.h>
@@ -54,6 +55,12 @@ typedef struct {
 
 	gboolean value_data_up_to_date;
 	char *value_data;
+
+	/* Numeric conversions of the value data, parsed once until the data changes */
+	gboolean int64_up_to_date;
+	gint64 int64_value;
+	gboolean double_up_to_date;
+	double double_value;
 } ArvGcPropertyNodePrivate;
 
 G_DEFINE_TYPE_WITH_CODE (ArvGcPropertyNode, arv_gc_property_node, ARV_TYPE_GC_NODE, G_ADD_PRIVATE (ArvGcPropertyNode))
@@ -180,19 +187,35 @@ _can_append_child (ArvDomNode *self, ArvDomNode *child)
 }
 
 static void
-_post_new_child (ArvDomNode *parent, ArvDomNode *child)
+_invalidate_value_data (ArvGcPropertyNode *property_node)
 {
-	ArvGcPropertyNodePrivate *priv = arv_gc_property_node_get_instance_private (ARV_GC_PROPERTY_NODE (parent));
+	ArvGcPropertyNodePrivate *priv = arv_gc_property_node_get_instance_private (property_node);
 
 	priv->value_data_up_to_date = FALSE;
+	priv->int64_up_to_date = FALSE;
+	priv->double_up_to_date = FALSE;
+}
+
+static void
+_post_new_child (ArvDomNode *parent, ArvDomNode *child)
+{
+	_invalidate_value_data (ARV_GC_PROPERTY_NODE (parent));
 }
 
 static void
 _pre_remove_child (ArvDomNode *parent, ArvDomNode *child)
 {
-	ArvGcPropertyNodePrivate *priv = arv_gc_property_node_get_instance_private (ARV_GC_PROPERTY_NODE (parent));
+	_invalidate_value_data (ARV_GC_PROPERTY_NODE (parent));
+}
 
-	priv->value_data_up_to_date = FALSE;
+/* Let the owner node know the text data changed, for example to update a cached formula */
+
+static gboolean
+_child_changed (ArvDomNode *parent, ArvDomNode *child)
+{
+	_invalidate_value_data (ARV_GC_PROPERTY_NODE (parent));
+
+	return TRUE;
 }
 
 /* ArvDomElement implementation */
@@ -229,24 +252,66 @@ _get_value_data (ArvGcPropertyNode *property_node)
 {
 	ArvGcPropertyNodePrivate *priv = arv_gc_property_node_get_instance_private (property_node);
 	ArvDomNode *dom_node = ARV_DOM_NODE (property_node);
+	ArvDomNode *first_child;
 
-	if (!priv->value_data_up_to_date) {
-		ArvDomNode *iter;
-		GString *string = g_string_new (NULL);
+	/* Most properties have a single text child, use its data directly instead of keeping a copy */
+	first_child = arv_dom_node_get_first_child (dom_node);
+	if (first_child != NULL && arv_dom_node_get_next_sibling (first_child) == NULL)
+		return arv_dom_character_data_get_data (ARV_DOM_CHARACTER_DATA (first_child));
 
-		for (iter = arv_dom_node_get_first_child (dom_node);
-		     iter != NULL;
-		     iter = arv_dom_node_get_next_sibling (iter))
-			g_string_append (string, arv_dom_character_data_get_data (ARV_DOM_CHARACTER_DATA (iter)));
-		g_free (priv->value_data);
-		priv->value_data = string->str;
-		g_string_free (string, FALSE);
-		priv->value_data_up_to_date = TRUE;
+	if (!priv->value_data_up_to_date) {
+		ArvGc *genicam = arv_gc_node_get_genicam (ARV_GC_NODE (property_node));
+
+		/* Concatenated once, by the first of the concurrent readers */
+		arv_gc_lock_state (genicam);
+
+		if (!priv->value_data_up_to_date) {
+			ArvDomNode *iter;
+			GString *string = g_string_new (NULL);
+
+			for (iter = arv_dom_node_get_first_child (dom_node);
+			     iter != NULL;
+			     iter = arv_dom_node_get_next_sibling (iter))
+				g_string_append (string,
+						 arv_dom_character_data_get_data (ARV_DOM_CHARACTER_DATA (iter)));
+			g_free (priv->value_data);
+			priv->value_data = string->str;
+			g_string_free (string, FALSE);
+			priv->value_data_up_to_date = TRUE;
+		}
+
+		arv_gc_unlock_state (genicam);
 	}
 
 	return priv->value_data;
 }
 
+static gint64
+_get_value_int64 (ArvGcPropertyNode *property_node)
+{
+	ArvGcPropertyNodePrivate *priv = arv_gc_property_node_get_instance_private (property_node);
+
+	if (!priv->int64_up_to_date) {
+		priv->int64_value = g_ascii_strtoll (_get_value_data (property_node), NULL, 0);
+		priv->int64_up_to_date = TRUE;
+	}
+
+	return priv->int64_value;
+}
+
+static double
+_get_value_double (ArvGcPropertyNode *property_node)
+{
+	ArvGcPropertyNodePrivate *priv = arv_gc_property_node_get_instance_private (property_node);
+
+	if (!priv->double_up_to_date) {
+		priv->double_value = g_ascii_strtod (_get_value_data (property_node), NULL);
+		priv->double_up_to_date = TRUE;
+	}
+
+	return priv->double_value;
+}
+
 static void
 _set_value_data (ArvGcPropertyNode *property_node, const char *data)
 {
@@ -266,6 +331,12 @@ _set_value_data (ArvGcPropertyNode *property_node, const char *data)
 	g_free (priv->value_data);
 	priv->value_data = g_strdup (data);
 	priv->value_data_up_to_date = TRUE;
+	priv->int64_up_to_date = FALSE;
+	priv->double_up_to_date = FALSE;
+
+	/* Changes of the text children are already notified */
+	if (arv_dom_node_get_first_child (dom_node) == NULL)
+		arv_dom_node_changed (dom_node);
 }
 
 static ArvDomNode *
@@ -373,7 +444,7 @@ arv_gc_property_node_get_int64 (ArvGcPropertyNode *node, GError **error)
 
 	pvalue_node = _get_pvalue_node (node);
 	if (pvalue_node == NULL)
-		return g_ascii_strtoll (_get_value_data (node), NULL, 0);
+		return _get_value_int64 (node);
 
 	if (ARV_IS_GC_INTEGER (pvalue_node)) {
 		return arv_gc_integer_get_value (ARV_GC_INTEGER (pvalue_node), error);
@@ -387,6 +458,54 @@ arv_gc_property_node_get_int64 (ArvGcPropertyNode *node, GError **error)
 	return 0;
 }
 
+/**
+ * arv_gc_property_node_try_get_int64:
+ * @node: a #ArvGcPropertyNode
+ * @value: (out): property value
+ *
+ * Status variant of arv_gc_property_node_get_int64(), see arv_gc_integer_try_get_value().
+ *
+ * Returns: %TRUE on success, in which case @value is set.
+ *
+ * Since: 0.8.11
+ */
+
+gboolean
+arv_gc_property_node_try_get_int64 (ArvGcPropertyNode *node, gint64 *value)
+{
+	ArvDomNode *pvalue_node;
+
+	g_return_val_if_fail (ARV_IS_GC_PROPERTY_NODE (node), FALSE);
+	g_return_val_if_fail (value != NULL, FALSE);
+
+	pvalue_node = _get_pvalue_node (node);
+	if (pvalue_node == NULL) {
+		*value = _get_value_int64 (node);
+		return TRUE;
+	}
+
+	if (ARV_IS_GC_INTEGER (pvalue_node)) {
+		return arv_gc_integer_try_get_value (ARV_GC_INTEGER (pvalue_node), value);
+	} else if (ARV_IS_GC_FLOAT (pvalue_node)) {
+		double v_double;
+
+		if (!arv_gc_float_try_get_value (ARV_GC_FLOAT (pvalue_node), &v_double)) {
+			*value = 0;
+			return FALSE;
+		}
+
+		*value = (gint64) v_double;
+		return TRUE;
+	}
+
+	arv_warning_genicam ("[GcPropertyNode::try_get_int64] Invalid node '%s'",
+			     arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (pvalue_node)));
+
+	*value = 0;
+
+	return TRUE;
+}
+
 void
 arv_gc_property_node_set_int64 (ArvGcPropertyNode *node, gint64 v_int64, GError **error)
 {
@@ -427,7 +546,7 @@ arv_gc_property_node_get_double (ArvGcPropertyNode *node, GError **error)
 
 	pvalue_node = _get_pvalue_node (node);
 	if (pvalue_node == NULL)
-		return g_ascii_strtod (_get_value_data (node), NULL);
+		return _get_value_double (node);
 
 
 	if (ARV_IS_GC_FLOAT (pvalue_node)) {
@@ -442,6 +561,54 @@ arv_gc_property_node_get_double (ArvGcPropertyNode *node, GError **error)
 	return 0.0;
 }
 
+/**
+ * arv_gc_property_node_try_get_double:
+ * @node: a #ArvGcPropertyNode
+ * @value: (out): property value
+ *
+ * Status variant of arv_gc_property_node_get_double(), see arv_gc_float_try_get_value().
+ *
+ * Returns: %TRUE on success, in which case @value is set.
+ *
+ * Since: 0.8.11
+ */
+
+gboolean
+arv_gc_property_node_try_get_double (ArvGcPropertyNode *node, double *value)
+{
+	ArvDomNode *pvalue_node;
+
+	g_return_val_if_fail (ARV_IS_GC_PROPERTY_NODE (node), FALSE);
+	g_return_val_if_fail (value != NULL, FALSE);
+
+	pvalue_node = _get_pvalue_node (node);
+	if (pvalue_node == NULL) {
+		*value = _get_value_double (node);
+		return TRUE;
+	}
+
+	if (ARV_IS_GC_FLOAT (pvalue_node)) {
+		return arv_gc_float_try_get_value (ARV_GC_FLOAT (pvalue_node), value);
+	} else if (ARV_IS_GC_INTEGER (pvalue_node)) {
+		gint64 v_int64;
+
+		if (!arv_gc_integer_try_get_value (ARV_GC_INTEGER (pvalue_node), &v_int64)) {
+			*value = 0.0;
+			return FALSE;
+		}
+
+		*value = v_int64;
+		return TRUE;
+	}
+
+	arv_warning_genicam ("[GcPropertyNode::try_get_double] Invalid node '%s'",
+			     arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (pvalue_node)));
+
+	*value = 0.0;
+
+	return TRUE;
+}
+
 void
 arv_gc_property_node_set_double (ArvGcPropertyNode *node, double v_double, GError **error)
 {
@@ -721,7 +888,7 @@ arv_gc_property_node_get_display_precision (ArvGcPropertyNode *self, gint64 defa
 	g_return_val_if_fail (ARV_IS_GC_PROPERTY_NODE (self), default_value);
 	g_return_val_if_fail (priv->type == ARV_GC_PROPERTY_NODE_TYPE_DISPLAY_PRECISION, default_value);
 
-	return g_ascii_strtoll (_get_value_data (self), NULL, 0);
+	return _get_value_int64 (self);
 }
 
 ArvGcNode *
@@ -1086,7 +1253,7 @@ arv_gc_property_node_init (ArvGcPropertyNode *self)
 
 	priv->type = ARV_GC_PROPERTY_NODE_TYPE_UNKNOWN;
 	priv->value_data = NULL;
-	priv->value_data_up_to_date = FALSE;
+	_invalidate_value_data (self);
 }
 
 static void
@@ -1114,6 +1281,7 @@ arv_gc_property_node_class_init (ArvGcPropertyNodeClass *this_class)
 	dom_node_class->can_append_child = _can_append_child;
 	dom_node_class->post_new_child = _post_new_child;
 	dom_node_class->pre_remove_child = _pre_remove_child;
+	dom_node_class->child_changed = _child_changed;
 	dom_element_class->set_attribute = arv_gc_property_node_set_attribute;
 	dom_element_class->get_attribute = arv_gc_property_node_get_attribute;
 
@@ -162,6 +162,8 @@ void			arv_gc_property_node_set_string			(ArvGcPropertyNode *node, const char *s
 gint64			arv_gc_property_node_get_int64			(ArvGcPropertyNode *node, GError **error);
 void			arv_gc_property_node_set_int64			(ArvGcPropertyNode *node, gint64 v_int64, GError **error);
 double			arv_gc_property_node_get_double			(ArvGcPropertyNode *node, GError **error);
+gboolean		arv_gc_property_node_try_get_int64		(ArvGcPropertyNode *node, gint64 *value);
+gboolean		arv_gc_property_node_try_get_double		(ArvGcPropertyNode *node, double *value);
 void			arv_gc_property_node_set_double			(ArvGcPropertyNode *node, double v_double, GError **error);
 
 guint			arv_gc_property_node_get_endianness		(ArvGcPropertyNode *self, guint default_value);
@@ -26,6 +26,7 @@
  */
 
 #include <arvgcregister.h>
+#include <arvgcprivate.h>
 #include <arvmisc.h>
 
 static void
@@ -38,23 +39,35 @@ G_DEFINE_INTERFACE (ArvGcRegister, arv_gc_register, G_TYPE_OBJECT)
 void
 arv_gc_register_get (ArvGcRegister *gc_register, void *buffer, guint64 length, GError **error)
 {
+	ArvGc *genicam;
+
 	g_return_if_fail (ARV_IS_GC_REGISTER (gc_register));
 	g_return_if_fail (buffer != NULL);
 	g_return_if_fail (length > 0);
 	g_return_if_fail (error == NULL || *error == NULL);
 
+	genicam = arv_gc_node_get_genicam (ARV_GC_NODE (gc_register));
+
+	arv_gc_access_begin (genicam, FALSE);
 	ARV_GC_REGISTER_GET_IFACE (gc_register)->get (gc_register, buffer, length, error);
+	arv_gc_access_end (genicam);
 }
 
 void
 arv_gc_register_set (ArvGcRegister *gc_register, const void *buffer, guint64 length, GError **error)
 {
+	ArvGc *genicam;
+
 	g_return_if_fail (ARV_IS_GC_REGISTER (gc_register));
 	g_return_if_fail (buffer != NULL);
 	g_return_if_fail (length > 0);
 	g_return_if_fail (error == NULL || *error == NULL);
 
+	genicam = arv_gc_node_get_genicam (ARV_GC_NODE (gc_register));
+
+	arv_gc_access_begin (genicam, TRUE);
 	ARV_GC_REGISTER_GET_IFACE (gc_register)->set (gc_register, buffer, length, error);
+	arv_gc_access_end (genicam);
 }
 
 guint64
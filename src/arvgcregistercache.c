@@ -0,0 +1,178 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2019 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel@gnome.org>
+ */
+
+/*< private >
+ * SECTION: arvgcregistercache
+ * @short_description: Register block cache shared by the register nodes of a Genicam document
+ *
+ * The device memory is cached by aligned blocks of %ARV_GC_REGISTER_CACHE_BLOCK_SIZE bytes, read with a single port
+ * access, so neighbouring register nodes can be served by the same device read. A block that could not be read, for
+ * example because it spans unmapped addresses, is stored as unreadable, and its registers are then read one by one.
+ *
+ * The register nodes are still in charge of their own Cachable and pInvalidator semantics. The block cache is only
+ * used for the reads they don't serve from their own cache, and it is flushed on any feature change, since a write
+ * can have side effects on any register.
+ *
+ * The cache is shared by the concurrent reads of the document, its accesses are protected by a mutex.
+ */
+
+#include <arvgcregistercacheprivate.h>
+#include <string.h>
+
+typedef struct {
+	gconstpointer port;
+	guint64 address;
+} ArvGcRegisterCacheKey;
+
+typedef struct {
+	ArvGcRegisterCacheKey key;
+	gboolean is_readable;
+	guint8 data[ARV_GC_REGISTER_CACHE_BLOCK_SIZE];
+} ArvGcRegisterCacheBlock;
+
+struct _ArvGcRegisterCache {
+	GMutex mutex;
+	GHashTable *blocks;
+};
+
+static guint
+_key_hash (gconstpointer v)
+{
+	const ArvGcRegisterCacheKey *key = v;
+
+	return g_direct_hash (key->port) ^ g_int64_hash (&key->address);
+}
+
+static gboolean
+_key_equal (gconstpointer v1, gconstpointer v2)
+{
+	const ArvGcRegisterCacheKey *key1 = v1;
+	const ArvGcRegisterCacheKey *key2 = v2;
+
+	return key1->port == key2->port && key1->address == key2->address;
+}
+
+ArvGcRegisterCache *
+arv_gc_register_cache_new (void)
+{
+	ArvGcRegisterCache *cache;
+
+	cache = g_new0 (ArvGcRegisterCache, 1);
+	/* The key is embedded in the block */
+	cache->blocks = g_hash_table_new_full (_key_hash, _key_equal, NULL, g_free);
+	g_mutex_init (&cache->mutex);
+
+	return cache;
+}
+
+void
+arv_gc_register_cache_free (ArvGcRegisterCache *cache)
+{
+	if (cache == NULL)
+		return;
+
+	g_hash_table_unref (cache->blocks);
+	g_mutex_clear (&cache->mutex);
+	g_free (cache);
+}
+
+/* Returns FALSE if the range doesn't fit in a single block */
+
+gboolean
+arv_gc_register_cache_get_block_address (guint64 address, guint64 length, guint64 *block_address)
+{
+	guint64 start = address & ~((guint64) ARV_GC_REGISTER_CACHE_BLOCK_SIZE - 1);
+
+	if (length == 0 || length > ARV_GC_REGISTER_CACHE_BLOCK_SIZE ||
+	    address - start > ARV_GC_REGISTER_CACHE_BLOCK_SIZE - length)
+		return FALSE;
+
+	if (block_address != NULL)
+		*block_address = start;
+
+	return TRUE;
+}
+
+/* Returns TRUE if the block containing the range is in the cache. is_readable is set to FALSE, and buffer is left
+ * untouched, if it is stored as unreadable. */
+
+gboolean
+arv_gc_register_cache_lookup (ArvGcRegisterCache *cache, gconstpointer port, guint64 address, guint64 length,
+			      void *buffer, gboolean *is_readable)
+{
+	ArvGcRegisterCacheKey key;
+	ArvGcRegisterCacheBlock *block;
+
+	g_return_val_if_fail (cache != NULL, FALSE);
+	g_return_val_if_fail (is_readable != NULL, FALSE);
+
+	if (!arv_gc_register_cache_get_block_address (address, length, &key.address))
+		return FALSE;
+
+	key.port = port;
+
+	g_mutex_lock (&cache->mutex);
+
+	block = g_hash_table_lookup (cache->blocks, &key);
+	if (block != NULL) {
+		*is_readable = block->is_readable;
+		if (block->is_readable)
+			memcpy (buffer, block->data + (address - key.address), length);
+	}
+
+	g_mutex_unlock (&cache->mutex);
+
+	return block != NULL;
+}
+
+/* A NULL block marks the block as unreadable */
+
+void
+arv_gc_register_cache_store (ArvGcRegisterCache *cache, gconstpointer port, guint64 block_address, const void *block)
+{
+	ArvGcRegisterCacheBlock *cache_block;
+
+	g_return_if_fail (cache != NULL);
+	g_return_if_fail (block_address % ARV_GC_REGISTER_CACHE_BLOCK_SIZE == 0);
+
+	cache_block = g_new (ArvGcRegisterCacheBlock, 1);
+	cache_block->key.port = port;
+	cache_block->key.address = block_address;
+	cache_block->is_readable = block != NULL;
+	if (block != NULL)
+		memcpy (cache_block->data, block, ARV_GC_REGISTER_CACHE_BLOCK_SIZE);
+
+	g_mutex_lock (&cache->mutex);
+	g_hash_table_replace (cache->blocks, &cache_block->key, cache_block);
+	g_mutex_unlock (&cache->mutex);
+}
+
+void
+arv_gc_register_cache_flush (ArvGcRegisterCache *cache)
+{
+	g_return_if_fail (cache != NULL);
+
+	g_mutex_lock (&cache->mutex);
+	if (g_hash_table_size (cache->blocks) > 0)
+		g_hash_table_remove_all (cache->blocks);
+	g_mutex_unlock (&cache->mutex);
+}
@@ -0,0 +1,54 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2019 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel@gnome.org>
+ */
+
+#ifndef ARV_GC_REGISTER_CACHE_PRIVATE_H
+#define ARV_GC_REGISTER_CACHE_PRIVATE_H
+
+#if !defined (ARV_H_INSIDE) && !defined (ARAVIS_COMPILATION)
+#error "Only <arv.h> can be included directly."
+#endif
+
+#include <arvtypes.h>
+
+G_BEGIN_DECLS
+
+/* Size and alignment of the register blocks, small enough for a single GigE Vision READMEM */
+#define ARV_GC_REGISTER_CACHE_BLOCK_SIZE	256
+
+typedef struct _ArvGcRegisterCache ArvGcRegisterCache;
+
+ArvGcRegisterCache *	arv_gc_register_cache_new		(void);
+void			arv_gc_register_cache_free		(ArvGcRegisterCache *cache);
+
+gboolean		arv_gc_register_cache_get_block_address	(guint64 address, guint64 length,
+								 guint64 *block_address);
+
+gboolean		arv_gc_register_cache_lookup		(ArvGcRegisterCache *cache, gconstpointer port,
+								 guint64 address, guint64 length, void *buffer,
+								 gboolean *is_readable);
+void			arv_gc_register_cache_store		(ArvGcRegisterCache *cache, gconstpointer port,
+								 guint64 block_address, const void *block);
+void			arv_gc_register_cache_flush		(ArvGcRegisterCache *cache);
+
+G_END_DECLS
+
+#endif
@@ -27,7 +27,6 @@
 
 #include <arvgcregisternodeprivate.h>
 #include <arvgcindexnode.h>
-#include <arvgcinvalidatornode.h>
 #include <arvgcfeaturenodeprivate.h>
 #include <arvgcswissknife.h>
 #include <arvgcregister.h>
@@ -35,7 +34,8 @@
 #include <arvgcselector.h>
 #include <arvgcfloat.h>
 #include <arvgcstring.h>
-#include <arvgcport.h>
+#include <arvgcportprivate.h>
+#include <arvgcregistercacheprivate.h>
 #include <arvgc.h>
 #include <arvmiscprivate.h>
 #include <arvdebugprivate.h>
@@ -84,13 +84,24 @@ typedef struct {
 	ArvGcPropertyNode *endianness;
 
 	GSList *invalidators;		/* #ArvGcPropertyNode */
+	gboolean invalidators_bound;
 
+	/* Protects the caches and the cache state against the concurrent reads of the document */
+	GRecMutex mutex;
 	gboolean cached;
 	GHashTable *caches;
+	/* Address of the cache filled by arv_gc_register_node_prefetch(), if any */
+	gboolean prefetched;
+	gint64 prefetched_address;
 	guint n_cache_hits;
 	guint n_cache_misses;
 	guint n_cache_errors;
 
+	/* Profiling statistics */
+	guint64 n_reads;
+	guint64 n_writes;
+	guint64 port_time_us;
+
 	char v_string[G_ASCII_DTOSTR_BUF_SIZE];
 } ArvGcRegisterNodePrivate;
 
@@ -135,7 +146,6 @@ arv_gc_register_node_post_new_child (ArvDomNode *self, ArvDomNode *child)
 				priv->cachable = property_node;
 				break;
 			case ARV_GC_PROPERTY_NODE_TYPE_POLLING_TIME:
-				/* TODO */
 				priv->polling_time = property_node;
 				break;
 			case ARV_GC_PROPERTY_NODE_TYPE_ENDIANNESS:
@@ -146,6 +156,7 @@ arv_gc_register_node_post_new_child (ArvDomNode *self, ArvDomNode *child)
 				break;
 			case ARV_GC_PROPERTY_NODE_TYPE_P_INVALIDATOR:
 				priv->invalidators = g_slist_prepend (priv->invalidators, property_node);
+				priv->invalidators_bound = FALSE;
 				break;
 			default:
 				ARV_DOM_NODE_CLASS (arv_gc_register_node_parent_class)->post_new_child (self, child);
@@ -176,8 +187,12 @@ _get_length (ArvGcRegisterNode *self, GError **error)
 	return arv_gc_property_node_get_int64 (priv->length, error);
 }
 
+/* When selector is not NULL, the pIndex entries linked to the selector use selector_value instead of the current
+ * selector value, and is_indexed is set if there is at least one of them */
+
 static guint64
-_get_address (ArvGcRegisterNode *self, GError **error)
+_get_address_for_index (ArvGcRegisterNode *self, ArvGcNode *selector, gint64 selector_value, gboolean *is_indexed,
+			GError **error)
 {
 	ArvGcRegisterNodePrivate *priv = arv_gc_register_node_get_instance_private (ARV_GC_REGISTER_NODE (self));
 	ArvGc *genicam;
@@ -185,6 +200,9 @@ _get_address (ArvGcRegisterNode *self, GError **error)
 	GSList *iter;
 	guint64 value = 0;
 
+	if (is_indexed != NULL)
+		*is_indexed = FALSE;
+
 	genicam = arv_gc_node_get_genicam (ARV_GC_NODE (self));
 	g_return_val_if_fail (ARV_IS_GC (genicam), 0);
 
@@ -216,7 +234,15 @@ _get_address (ArvGcRegisterNode *self, GError **error)
 		}
 
 		for (iter = priv->indexes; iter != NULL; iter = iter->next) {
-			value += arv_gc_index_node_get_index (ARV_GC_INDEX_NODE (iter->data), length, &local_error);
+			if (selector != NULL && arv_gc_property_node_get_linked_node (iter->data) == selector) {
+				value += selector_value *
+					arv_gc_index_node_get_offset (ARV_GC_INDEX_NODE (iter->data), length,
+								      &local_error);
+				if (is_indexed != NULL)
+					*is_indexed = TRUE;
+			} else
+				value += arv_gc_index_node_get_index (ARV_GC_INDEX_NODE (iter->data), length,
+								      &local_error);
 
 			if (local_error != NULL) {
 				g_propagate_error (error, local_error);
@@ -228,6 +254,12 @@ _get_address (ArvGcRegisterNode *self, GError **error)
 	return value;
 }
 
+static guint64
+_get_address (ArvGcRegisterNode *self, GError **error)
+{
+	return _get_address_for_index (self, NULL, 0, NULL, error);
+}
+
 static ArvGcCachable
 _get_cachable (ArvGcRegisterNode *self)
 {
@@ -244,12 +276,49 @@ _get_endianness (ArvGcRegisterNode *self)
 	return arv_gc_property_node_get_endianness (priv->endianness, G_LITTLE_ENDIAN);
 }
 
+/* Register this node in the reverse dependency graph of its invalidators, which will then mark it as invalidated on
+ * change. It is done before the first port access, as there is nothing to invalidate before. */
+
+static void
+_bind_invalidators (ArvGcRegisterNode *self)
+{
+	ArvGcRegisterNodePrivate *priv = arv_gc_register_node_get_instance_private (ARV_GC_REGISTER_NODE (self));
+	ArvGc *genicam;
+	GSList *iter;
+
+	if (G_LIKELY (priv->invalidators_bound))
+		return;
+
+	/* The invalidators are shared with the other nodes */
+	genicam = arv_gc_node_get_genicam (ARV_GC_NODE (self));
+	arv_gc_lock_state (genicam);
+
+	if (priv->invalidators_bound) {
+		arv_gc_unlock_state (genicam);
+		return;
+	}
+
+	for (iter = priv->invalidators; iter != NULL; iter = iter->next) {
+		ArvGcNode *node = arv_gc_property_node_get_linked_node (iter->data);
+
+		if (ARV_IS_GC_FEATURE_NODE (node))
+			arv_gc_feature_node_add_invalidated_node (ARV_GC_FEATURE_NODE (node), ARV_GC_FEATURE_NODE (self));
+		else
+			arv_warning_genicam ("[GcRegisterNode::bind_invalidators] Invalidator not found for '%s'",
+					     arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (self)));
+	}
+
+	priv->invalidators_bound = TRUE;
+	arv_gc_feature_node_clear_invalidated (ARV_GC_FEATURE_NODE (self));
+
+	arv_gc_unlock_state (genicam);
+}
+
 static gboolean
 _get_cached (ArvGcRegisterNode *self, ArvRegisterCachePolicy *cache_policy)
 {
 	ArvGcRegisterNodePrivate *priv = arv_gc_register_node_get_instance_private (ARV_GC_REGISTER_NODE (self));
 	ArvGc *genicam;
-	GSList *iter;
 	gboolean cached = priv->cached;
 
 	*cache_policy = ARV_REGISTER_CACHE_POLICY_DISABLE;
@@ -262,10 +331,8 @@ _get_cached (ArvGcRegisterNode *self, ArvRegisterCachePolicy *cache_policy)
 	if (*cache_policy == ARV_REGISTER_CACHE_POLICY_DISABLE)
 		return FALSE;
 
-	for (iter = priv->invalidators; iter != NULL; iter = iter->next) {
-		if (arv_gc_invalidator_has_changed (iter->data))
-			cached = FALSE;
-	}
+	if (arv_gc_feature_node_clear_invalidated (ARV_GC_FEATURE_NODE (self)))
+		cached = FALSE;
 
 	if (cached)
 		priv->n_cache_hits++;
@@ -327,6 +394,24 @@ _read_from_port (ArvGcRegisterNode *self, gint64 address, gint64 length, void *b
 	ArvRegisterCachePolicy cache_policy;
 	void *cache = NULL;
 	gboolean cached;
+	gint64 start_time;
+
+	_bind_invalidators (self);
+
+	priv->n_reads++;
+
+	/* Values depending on a volatile register can't be cached */
+	if (cachable == ARV_GC_CACHABLE_NO_CACHE)
+		arv_gc_increment_n_volatile_reads (arv_gc_node_get_genicam (ARV_GC_NODE (self)));
+
+	/* The prefetched value is only used once, by the read that follows the prefetch */
+	if (priv->prefetched) {
+		priv->prefetched = FALSE;
+		if (priv->prefetched_address == address && length == 4) {
+			priv->cached = cachable != ARV_GC_CACHABLE_NO_CACHE;
+			return;
+		}
+	}
 
 	cached = _get_cached (self, &cache_policy);
 
@@ -344,9 +429,17 @@ _read_from_port (ArvGcRegisterNode *self, gint64 address, gint64 length, void *b
 		memcpy (cache, buffer, length);
 	}
 
-	if (!cached || cache_policy == ARV_REGISTER_CACHE_POLICY_DEBUG)
+	start_time = g_get_monotonic_time ();
+
+	/* Neighbouring registers are served by the same block read, but volatile registers are always read directly,
+	 * as well as all registers in debug mode */
+	if (!cached && cache_policy == ARV_REGISTER_CACHE_POLICY_ENABLE && cachable != ARV_GC_CACHABLE_NO_CACHE)
+		arv_gc_port_read_cached (ARV_GC_PORT (port), buffer, address, length, &local_error);
+	else if (!cached || cache_policy == ARV_REGISTER_CACHE_POLICY_DEBUG)
 		arv_gc_port_read (ARV_GC_PORT (port), buffer, address, length, &local_error);
 
+	priv->port_time_us += g_get_monotonic_time () - start_time;
+
 	if (local_error != NULL) {
 		g_propagate_error (error, local_error);
 		priv->cached = FALSE;
@@ -375,6 +468,12 @@ _write_to_port (ArvGcRegisterNode *self, gint64 address, gint64 length, void *bu
 	ArvGcRegisterNodePrivate *priv = arv_gc_register_node_get_instance_private (ARV_GC_REGISTER_NODE (self));
 	GError *local_error = NULL;
 	ArvGcNode *port;
+	gint64 start_time;
+
+	_bind_invalidators (self);
+
+	priv->prefetched = FALSE;
+	priv->n_writes++;
 
 	port = arv_gc_property_node_get_linked_node (priv->port);
 	if (!ARV_IS_GC_PORT (port)) {
@@ -386,7 +485,10 @@ _write_to_port (ArvGcRegisterNode *self, gint64 address, gint64 length, void *bu
 	}
 
 	arv_gc_feature_node_increment_change_count (ARV_GC_FEATURE_NODE (self));
+
+	start_time = g_get_monotonic_time ();
 	arv_gc_port_write (ARV_GC_PORT (port), buffer, address, length, &local_error);
+	priv->port_time_us += g_get_monotonic_time () - start_time;
 
 	if (local_error != NULL) {
 		g_propagate_error (error, local_error);
@@ -400,6 +502,41 @@ _write_to_port (ArvGcRegisterNode *self, gint64 address, gint64 length, void *bu
 		priv->cached = FALSE;
 }
 
+void
+arv_gc_register_node_get_statistics (ArvGcRegisterNode *self, guint64 *n_reads, guint64 *n_writes,
+				     guint64 *n_cache_hits, guint64 *n_cache_misses, guint64 *port_time_us)
+{
+	ArvGcRegisterNodePrivate *priv = arv_gc_register_node_get_instance_private (ARV_GC_REGISTER_NODE (self));
+
+	g_return_if_fail (ARV_IS_GC_REGISTER_NODE (self));
+
+	if (n_reads != NULL)
+		*n_reads = priv->n_reads;
+	if (n_writes != NULL)
+		*n_writes = priv->n_writes;
+	if (n_cache_hits != NULL)
+		*n_cache_hits = priv->n_cache_hits;
+	if (n_cache_misses != NULL)
+		*n_cache_misses = priv->n_cache_misses;
+	if (port_time_us != NULL)
+		*port_time_us = priv->port_time_us;
+}
+
+void
+arv_gc_register_node_reset_statistics (ArvGcRegisterNode *self)
+{
+	ArvGcRegisterNodePrivate *priv = arv_gc_register_node_get_instance_private (ARV_GC_REGISTER_NODE (self));
+
+	g_return_if_fail (ARV_IS_GC_REGISTER_NODE (self));
+
+	priv->n_reads = 0;
+	priv->n_writes = 0;
+	priv->n_cache_hits = 0;
+	priv->n_cache_misses = 0;
+	priv->n_cache_errors = 0;
+	priv->port_time_us = 0;
+}
+
 ArvGcNode *
 arv_gc_register_node_new (void)
 {
@@ -411,8 +548,10 @@ arv_gc_register_node_init (ArvGcRegisterNode *self)
 {
 	ArvGcRegisterNodePrivate *priv = arv_gc_register_node_get_instance_private (ARV_GC_REGISTER_NODE (self));
 
+	g_rec_mutex_init (&priv->mutex);
 	priv->cached = FALSE;
 	priv->caches = g_hash_table_new_full (arv_gc_cache_key_hash, arv_gc_cache_key_equal, g_free, g_free);
+	priv->prefetched = FALSE;
 	priv->n_cache_hits = 0;
 	priv->n_cache_misses = 0;
 	priv->n_cache_errors = 0;
@@ -456,6 +595,8 @@ arv_gc_register_node_finalize (GObject *self)
 		}
 	}
 
+	g_rec_mutex_clear (&priv->mutex);
+
 	G_OBJECT_CLASS (arv_gc_register_node_parent_class)->finalize (self);
 }
 
@@ -477,8 +618,10 @@ arv_gc_register_node_class_init (ArvGcRegisterNodeClass *this_class)
 
 /* ArvGcRegister interface implementation */
 
+/* The _locked functions are called with the node mutex locked */
+
 static void
-arv_gc_register_node_get (ArvGcRegister *gc_register, void *buffer, guint64 length, GError **error)
+_get_locked (ArvGcRegister *gc_register, void *buffer, guint64 length, GError **error)
 {
 	ArvGcRegisterNode *gc_register_node = ARV_GC_REGISTER_NODE (gc_register);
 	GError *local_error = NULL;
@@ -514,7 +657,17 @@ arv_gc_register_node_get (ArvGcRegister *gc_register, void *buffer, guint64 leng
 }
 
 static void
-arv_gc_register_node_set (ArvGcRegister *gc_register, const void *buffer, guint64 length, GError **error)
+arv_gc_register_node_get (ArvGcRegister *gc_register, void *buffer, guint64 length, GError **error)
+{
+	ArvGcRegisterNodePrivate *priv = arv_gc_register_node_get_instance_private (ARV_GC_REGISTER_NODE (gc_register));
+
+	g_rec_mutex_lock (&priv->mutex);
+	_get_locked (gc_register, buffer, length, error);
+	g_rec_mutex_unlock (&priv->mutex);
+}
+
+static void
+_set_locked (ArvGcRegister *gc_register, const void *buffer, guint64 length, GError **error)
 {
 	ArvGcRegisterNode *gc_register_node = ARV_GC_REGISTER_NODE (gc_register);
 	GError *local_error = NULL;
@@ -550,6 +703,16 @@ arv_gc_register_node_set (ArvGcRegister *gc_register, const void *buffer, guint6
 	arv_debug_genicam ("[GcRegisterNode::set] 0x%" G_GINT64_MODIFIER "x,%" G_GUINT64_FORMAT, address, length);
 }
 
+static void
+arv_gc_register_node_set (ArvGcRegister *gc_register, const void *buffer, guint64 length, GError **error)
+{
+	ArvGcRegisterNodePrivate *priv = arv_gc_register_node_get_instance_private (ARV_GC_REGISTER_NODE (gc_register));
+
+	g_rec_mutex_lock (&priv->mutex);
+	_set_locked (gc_register, buffer, length, error);
+	g_rec_mutex_unlock (&priv->mutex);
+}
+
 static guint64
 arv_gc_register_node_get_address (ArvGcRegister *gc_register, GError **error)
 {
@@ -577,31 +740,20 @@ arv_gc_register_node_register_interface_init (ArvGcRegisterInterface *interface)
 
 /* ArvGcInteger interface implementation */
 
-static gint64
-_get_integer_value (ArvGcRegisterNode *gc_register_node,
-		    guint register_lsb, guint register_msb,
-		    ArvGcSignedness signedness, guint endianness,
-		    ArvGcCachable cachable,
-		    gboolean is_masked, GError **error)
+/* Converts the raw register data to an integer value, also used by the compiled chunk plans */
+
+gint64
+arv_gc_register_node_decode_integer_value (const void *data, gint64 length,
+					   guint register_lsb, guint register_msb,
+					   ArvGcSignedness signedness, guint endianness,
+					   gboolean is_masked)
 {
-	GError *local_error = NULL;
 	gint64 value;
 	guint lsb;
 	guint msb;
-	void *cache;
-	gint64 address;
-	gint64 length;
-
-	cache = _get_cache (gc_register_node, &address, &length, &local_error);
-	if (local_error == NULL)
-		_read_from_port (gc_register_node, address, length, cache, cachable, &local_error);
-	if (local_error != NULL) {
-		g_propagate_error (error, local_error);
-		return 0;
-	}
 
 	arv_copy_memory_with_endianness (&value, sizeof (value), G_BYTE_ORDER,
-					cache, length, endianness);
+					(void *) data, length, endianness);
 
 	if (is_masked) {
 		guint64 mask;
@@ -639,12 +791,57 @@ _get_integer_value (ArvGcRegisterNode *gc_register_node,
 			value |= G_MAXUINT64 ^ ((((guint64) 1) << (length * 8)) - 1);
 	}
 
+	return value;
+}
+
+static gint64
+_get_integer_value_locked (ArvGcRegisterNode *gc_register_node,
+			   guint register_lsb, guint register_msb,
+			   ArvGcSignedness signedness, guint endianness,
+			   ArvGcCachable cachable,
+			   gboolean is_masked, GError **error)
+{
+	GError *local_error = NULL;
+	gint64 value;
+	void *cache;
+	gint64 address;
+	gint64 length;
+
+	cache = _get_cache (gc_register_node, &address, &length, &local_error);
+	if (local_error == NULL)
+		_read_from_port (gc_register_node, address, length, cache, cachable, &local_error);
+	if (local_error != NULL) {
+		g_propagate_error (error, local_error);
+		return 0;
+	}
+
+	value = arv_gc_register_node_decode_integer_value (cache, length, register_lsb, register_msb,
+							   signedness, endianness, is_masked);
+
 	arv_debug_genicam ("[GcRegisterNode::_get_integer_value] address = 0x%" G_GINT64_MODIFIER "x, value = 0x%" G_GINT64_MODIFIER "x",
 			 _get_address (gc_register_node, NULL), value);
 
 	return value;
 }
 
+static gint64
+_get_integer_value (ArvGcRegisterNode *gc_register_node,
+		    guint register_lsb, guint register_msb,
+		    ArvGcSignedness signedness, guint endianness,
+		    ArvGcCachable cachable,
+		    gboolean is_masked, GError **error)
+{
+	ArvGcRegisterNodePrivate *priv = arv_gc_register_node_get_instance_private (gc_register_node);
+	gint64 value;
+
+	g_rec_mutex_lock (&priv->mutex);
+	value = _get_integer_value_locked (gc_register_node, register_lsb, register_msb, signedness, endianness,
+					   cachable, is_masked, error);
+	g_rec_mutex_unlock (&priv->mutex);
+
+	return value;
+}
+
 gint64
 arv_gc_register_node_get_masked_integer_value (ArvGcRegisterNode *self,
 					       guint lsb, guint msb,
@@ -664,16 +861,46 @@ arv_gc_register_node_get_masked_integer_value (ArvGcRegisterNode *self,
 	return _get_integer_value (self, lsb, msb, signedness, endianness, cachable, is_masked, error);
 }
 
-static void
-_set_integer_value (ArvGcRegisterNode *gc_register_node,
-		    guint register_lsb, guint register_msb,
-		    ArvGcSignedness signedness, guint endianness,
-		    ArvGcCachable cachable,
-		    gboolean is_masked, gint64 value, GError **error)
+/* Replaces the register_lsb..register_msb bit field of current_value by value */
+
+static gint64
+_merge_field (gint64 current_value, gint64 length, guint endianness, guint register_lsb, guint register_msb,
+	      gint64 value)
 {
-	GError *local_error = NULL;
+	guint64 mask;
 	guint lsb;
 	guint msb;
+
+	if (endianness == G_LITTLE_ENDIAN) {
+		msb = register_msb;
+		lsb = register_lsb;
+	} else {
+		lsb = 8 * length - register_lsb - 1;
+		msb = 8 * length - register_msb - 1;
+	}
+
+	arv_debug_genicam ("[GcRegisterNode::_set_integer_value] reglsb = %d, regmsb, %d, lsb = %d, msb = %d",
+			 register_lsb, register_msb, lsb, msb);
+	arv_debug_genicam ("[GcRegisterNode::_set_integer_value] value = 0x%08" G_GINT64_MODIFIER "x", value);
+
+	if (msb - lsb < 63)
+		mask = ((((guint64) 1) << (msb - lsb + 1)) - 1) << lsb;
+	else
+		mask = G_MAXUINT64;
+
+	arv_debug_genicam ("[GcRegisterNode::_set_integer_value] mask  = 0x%08" G_GINT64_MODIFIER "x", mask);
+
+	return ((value << lsb) & mask) | (current_value & ~mask);
+}
+
+static void
+_set_integer_value_locked (ArvGcRegisterNode *gc_register_node,
+			   guint register_lsb, guint register_msb,
+			   ArvGcSignedness signedness, guint endianness,
+			   ArvGcCachable cachable,
+			   gboolean is_masked, gint64 value, GError **error)
+{
+	GError *local_error = NULL;
 	void *cache;
 	gint64 address;
 	gint64 length;
@@ -686,7 +913,6 @@ _set_integer_value (ArvGcRegisterNode *gc_register_node,
 
 	if (is_masked) {
 		gint64 current_value;
-		guint64 mask;
 
 		if (ARV_GC_ACCESS_MODE_WO != arv_gc_register_node_get_access_mode(ARV_GC_FEATURE_NODE(gc_register_node))) {
 			_read_from_port (gc_register_node, address, length, cache, cachable, &local_error);
@@ -699,26 +925,7 @@ _set_integer_value (ArvGcRegisterNode *gc_register_node,
 		arv_copy_memory_with_endianness (&current_value, sizeof (current_value), G_BYTE_ORDER,
 						cache, length, endianness);
 
-		if (endianness == G_LITTLE_ENDIAN) {
-			msb = register_msb;
-			lsb = register_lsb;
-		} else {
-			lsb = 8 * length - register_lsb - 1;
-			msb = 8 * length - register_msb - 1;
-		}
-
-		arv_debug_genicam ("[GcRegisterNode::_set_integer_value] reglsb = %d, regmsb, %d, lsb = %d, msb = %d",
-				 register_lsb, register_msb, lsb, msb);
-		arv_debug_genicam ("[GcRegisterNode::_set_integer_value] value = 0x%08" G_GINT64_MODIFIER "x", value);
-
-		if (msb - lsb < 63)
-			mask = ((((guint64) 1) << (msb - lsb + 1)) - 1) << lsb;
-		else
-			mask = G_MAXUINT64;
-
-		value = ((value << lsb) & mask) | (current_value & ~mask);
-
-		arv_debug_genicam ("[GcRegisterNode::_set_integer_value] mask  = 0x%08" G_GINT64_MODIFIER "x", mask);
+		value = _merge_field (current_value, length, endianness, register_lsb, register_msb, value);
 	}
 
 	arv_debug_genicam ("[GcRegisterNode::_set_integer_value] address = 0x%" G_GINT64_MODIFIER "x, value = 0x%" G_GINT64_MODIFIER "x",
@@ -735,6 +942,21 @@ _set_integer_value (ArvGcRegisterNode *gc_register_node,
 
 }
 
+static void
+_set_integer_value (ArvGcRegisterNode *gc_register_node,
+		    guint register_lsb, guint register_msb,
+		    ArvGcSignedness signedness, guint endianness,
+		    ArvGcCachable cachable,
+		    gboolean is_masked, gint64 value, GError **error)
+{
+	ArvGcRegisterNodePrivate *priv = arv_gc_register_node_get_instance_private (gc_register_node);
+
+	g_rec_mutex_lock (&priv->mutex);
+	_set_integer_value_locked (gc_register_node, register_lsb, register_msb, signedness, endianness,
+				   cachable, is_masked, value, error);
+	g_rec_mutex_unlock (&priv->mutex);
+}
+
 void
 arv_gc_register_node_set_masked_integer_value (ArvGcRegisterNode *self,
 					       guint lsb, guint msb,
@@ -755,6 +977,103 @@ arv_gc_register_node_set_masked_integer_value (ArvGcRegisterNode *self,
 	_set_integer_value (self, lsb, msb, signedness, endianness, cachable, is_masked, value, error);
 }
 
+/* Writes several bit fields of the register with one register write, preceded by at most one read, or none for a
+ * write only register. The endianness and the cachable attribute of the first field are used for the whole
+ * register. */
+
+void
+arv_gc_register_node_set_fields (ArvGcRegisterNode *self, const ArvGcRegisterField *fields, guint n_fields,
+				 GError **error)
+{
+	ArvGcRegisterNodePrivate *priv = arv_gc_register_node_get_instance_private (ARV_GC_REGISTER_NODE (self));
+	GError *local_error = NULL;
+	ArvGcCachable cachable;
+	gint64 current_value = 0;
+	gint64 address;
+	gint64 length;
+	guint endianness;
+	void *cache;
+	guint i;
+
+	g_return_if_fail (ARV_IS_GC_REGISTER_NODE (self));
+	g_return_if_fail (fields != NULL || n_fields == 0);
+	g_return_if_fail (error == NULL || *error == NULL);
+
+	if (n_fields == 0)
+		return;
+
+	cachable = fields[0].cachable != ARV_GC_CACHABLE_UNDEFINED ? fields[0].cachable : _get_cachable (self);
+	endianness = fields[0].endianness != 0 ? fields[0].endianness : _get_endianness (self);
+
+	g_rec_mutex_lock (&priv->mutex);
+
+	cache = _get_cache (self, &address, &length, &local_error);
+
+	if (local_error == NULL &&
+	    arv_gc_register_node_get_access_mode (ARV_GC_FEATURE_NODE (self)) != ARV_GC_ACCESS_MODE_WO)
+		_read_from_port (self, address, length, cache, cachable, &local_error);
+
+	if (local_error == NULL) {
+		arv_copy_memory_with_endianness (&current_value, sizeof (current_value), G_BYTE_ORDER,
+						 cache, length, endianness);
+
+		for (i = 0; i < n_fields; i++)
+			current_value = _merge_field (current_value, length, endianness,
+						      fields[i].lsb, fields[i].msb, fields[i].value);
+
+		arv_debug_genicam ("[GcRegisterNode::set_fields] %u fields, address = 0x%" G_GINT64_MODIFIER "x, "
+				   "value = 0x%" G_GINT64_MODIFIER "x", n_fields, address, current_value);
+
+		arv_copy_memory_with_endianness (cache, length, endianness,
+						 &current_value, sizeof (current_value), G_BYTE_ORDER);
+
+		_write_to_port (self, address, length, cache, cachable, &local_error);
+	}
+
+	g_rec_mutex_unlock (&priv->mutex);
+
+	if (local_error != NULL)
+		g_propagate_error (error, local_error);
+}
+
+/* Returns TRUE if both nodes access the same register of the same port */
+
+gboolean
+arv_gc_register_node_is_same_register (ArvGcRegisterNode *self, ArvGcRegisterNode *other)
+{
+	ArvGcRegisterNodePrivate *priv = arv_gc_register_node_get_instance_private (ARV_GC_REGISTER_NODE (self));
+	ArvGcRegisterNodePrivate *other_priv = arv_gc_register_node_get_instance_private (ARV_GC_REGISTER_NODE (other));
+	GError *local_error = NULL;
+	gint64 address;
+	gint64 length;
+	gboolean same;
+
+	g_return_val_if_fail (ARV_IS_GC_REGISTER_NODE (self), FALSE);
+	g_return_val_if_fail (ARV_IS_GC_REGISTER_NODE (other), FALSE);
+
+	if (self == other)
+		return TRUE;
+
+	if (arv_gc_property_node_get_linked_node (priv->port) !=
+	    arv_gc_property_node_get_linked_node (other_priv->port))
+		return FALSE;
+
+	address = _get_address (self, &local_error);
+	if (local_error == NULL)
+		length = _get_length (self, &local_error);
+	if (local_error == NULL)
+		same = address == _get_address (other, &local_error);
+	if (local_error == NULL)
+		same = same && length == _get_length (other, &local_error);
+
+	if (local_error != NULL) {
+		g_error_free (local_error);
+		return FALSE;
+	}
+
+	return same;
+}
+
 guint
 arv_gc_register_node_get_endianness  (ArvGcRegisterNode *register_node)
 {
@@ -763,3 +1082,459 @@ arv_gc_register_node_get_endianness  (ArvGcRegisterNode *register_node)
 	return _get_endianness (register_node);
 }
 
+/* Returns the suggested polling period in ms, or 0 if not specified */
+
+gint64
+arv_gc_register_node_get_polling_time (ArvGcRegisterNode *register_node)
+{
+	ArvGcRegisterNodePrivate *priv = arv_gc_register_node_get_instance_private (register_node);
+
+	g_return_val_if_fail (ARV_IS_GC_REGISTER_NODE (register_node), 0);
+
+	if (priv->polling_time == NULL)
+		return 0;
+
+	return MAX (0, arv_gc_property_node_get_int64 (priv->polling_time, NULL));
+}
+
+/**
+ * arv_gc_register_node_prefetch: (skip)
+ * @nodes: (array length=n_nodes): register nodes
+ * @n_nodes: number of nodes
+ *
+ * Reads together the 4 byte registers of @nodes which share the same port, using arv_gc_port_read_registers(). The
+ * read data is used by the next read of each node, instead of a port access. Nodes which are not readable 4 byte
+ * registers, or already have a valid cache, are ignored. Errors are not reported, the nodes are then simply read
+ * again on access.
+ */
+
+void
+arv_gc_register_node_prefetch (ArvGcRegisterNode **nodes, guint n_nodes)
+{
+	ArvGcNode **ports;
+	gint64 *node_addresses;
+	void **node_caches;
+	guint64 *addresses;
+	void **caches;
+	guint *indexes;
+	guint i, j;
+
+	if (n_nodes == 0)
+		return;
+
+	ports = g_new0 (ArvGcNode *, n_nodes);
+	node_addresses = g_new (gint64, n_nodes);
+	node_caches = g_new (void *, n_nodes);
+	addresses = g_new (guint64, n_nodes);
+	caches = g_new (void *, n_nodes);
+	indexes = g_new (guint, n_nodes);
+
+	for (i = 0; i < n_nodes; i++) {
+		ArvGcRegisterNodePrivate *priv;
+		ArvGcNode *port;
+		GError *local_error = NULL;
+		gint64 length;
+
+		if (!ARV_IS_GC_REGISTER_NODE (nodes[i]))
+			continue;
+
+		priv = arv_gc_register_node_get_instance_private (nodes[i]);
+		port = arv_gc_property_node_get_linked_node (priv->port);
+
+		if (!ARV_IS_GC_PORT (port) ||
+		    arv_gc_register_node_get_access_mode (ARV_GC_FEATURE_NODE (nodes[i])) == ARV_GC_ACCESS_MODE_WO ||
+		    (priv->cached && arv_gc_get_register_cache_policy (arv_gc_node_get_genicam (ARV_GC_NODE (nodes[i]))) ==
+		     ARV_REGISTER_CACHE_POLICY_ENABLE))
+			continue;
+
+		g_rec_mutex_lock (&priv->mutex);
+		node_caches[i] = _get_cache (nodes[i], &node_addresses[i], &length, &local_error);
+		g_rec_mutex_unlock (&priv->mutex);
+		if (local_error != NULL) {
+			g_clear_error (&local_error);
+			continue;
+		}
+
+		if (length == 4)
+			ports[i] = port;
+	}
+
+	for (i = 0; i < n_nodes; i++) {
+		ArvGcNode *port = ports[i];
+		GError *local_error = NULL;
+		guint n_registers = 0;
+
+		if (port == NULL)
+			continue;
+
+		for (j = i; j < n_nodes; j++) {
+			if (ports[j] == port) {
+				indexes[n_registers] = j;
+				addresses[n_registers] = node_addresses[j];
+				caches[n_registers] = node_caches[j];
+				n_registers++;
+				ports[j] = NULL;
+			}
+		}
+
+		arv_gc_port_read_registers (ARV_GC_PORT (port), n_registers, addresses, caches, &local_error);
+		if (local_error != NULL) {
+			arv_info_genicam ("[GcRegisterNode::prefetch] Failed to read %u registers: %s",
+					  n_registers, local_error->message);
+			g_clear_error (&local_error);
+			continue;
+		}
+
+		for (j = 0; j < n_registers; j++) {
+			ArvGcRegisterNodePrivate *priv = arv_gc_register_node_get_instance_private (nodes[indexes[j]]);
+
+			g_rec_mutex_lock (&priv->mutex);
+			priv->prefetched = TRUE;
+			priv->prefetched_address = addresses[j];
+			g_rec_mutex_unlock (&priv->mutex);
+		}
+	}
+
+	g_free (ports);
+	g_free (node_addresses);
+	g_free (node_caches);
+	g_free (addresses);
+	g_free (caches);
+	g_free (indexes);
+}
+
+static gint
+_compare_block_addresses (gconstpointer a, gconstpointer b)
+{
+	guint64 address_a = *((const guint64 *) a);
+	guint64 address_b = *((const guint64 *) b);
+
+	return address_a < address_b ? -1 : (address_a > address_b ? 1 : 0);
+}
+
+/**
+ * arv_gc_register_node_prefetch_blocks: (skip)
+ * @nodes: (array length=n_nodes): register nodes
+ * @n_nodes: number of nodes
+ *
+ * Fills the register block cache with the blocks containing the registers of @nodes, reading the neighbouring blocks
+ * of the same port together, using arv_gc_port_prefetch_blocks(). The next reads of the nodes are then served from
+ * the block cache. This only has an effect when the register cache policy is %ARV_REGISTER_CACHE_POLICY_ENABLE.
+ * Volatile registers, write only registers, and nodes which already have a valid cache are ignored.
+ */
+
+void
+arv_gc_register_node_prefetch_blocks (ArvGcRegisterNode **nodes, guint n_nodes)
+{
+	GHashTable *port_blocks;
+	GHashTableIter iter;
+	gpointer key, value;
+	guint i;
+
+	if (n_nodes == 0 ||
+	    arv_gc_get_register_cache_policy (arv_gc_node_get_genicam (ARV_GC_NODE (nodes[0]))) !=
+	    ARV_REGISTER_CACHE_POLICY_ENABLE)
+		return;
+
+	port_blocks = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, (GDestroyNotify) g_array_unref);
+
+	for (i = 0; i < n_nodes; i++) {
+		ArvGcRegisterNodePrivate *priv;
+		ArvGcNode *port;
+		GError *local_error = NULL;
+		GArray *blocks;
+		gint64 address;
+		gint64 length;
+		guint64 block_address;
+
+		if (!ARV_IS_GC_REGISTER_NODE (nodes[i]))
+			continue;
+
+		priv = arv_gc_register_node_get_instance_private (nodes[i]);
+		port = arv_gc_property_node_get_linked_node (priv->port);
+
+		if (!ARV_IS_GC_PORT (port) ||
+		    priv->cached ||
+		    _get_cachable (nodes[i]) == ARV_GC_CACHABLE_NO_CACHE ||
+		    arv_gc_register_node_get_access_mode (ARV_GC_FEATURE_NODE (nodes[i])) == ARV_GC_ACCESS_MODE_WO)
+			continue;
+
+		address = _get_address (nodes[i], &local_error);
+		if (local_error == NULL)
+			length = _get_length (nodes[i], &local_error);
+		if (local_error != NULL) {
+			g_clear_error (&local_error);
+			continue;
+		}
+
+		if (!arv_gc_register_cache_get_block_address (address, length, &block_address))
+			continue;
+
+		blocks = g_hash_table_lookup (port_blocks, port);
+		if (blocks == NULL) {
+			blocks = g_array_new (FALSE, FALSE, sizeof (guint64));
+			g_hash_table_insert (port_blocks, port, blocks);
+		}
+		g_array_append_val (blocks, block_address);
+	}
+
+	g_hash_table_iter_init (&iter, port_blocks);
+	while (g_hash_table_iter_next (&iter, &key, &value)) {
+		GArray *blocks = value;
+		guint n_unique = 0;
+
+		g_array_sort (blocks, _compare_block_addresses);
+
+		for (i = 0; i < blocks->len; i++)
+			if (n_unique == 0 ||
+			    g_array_index (blocks, guint64, i) != g_array_index (blocks, guint64, n_unique - 1))
+				g_array_index (blocks, guint64, n_unique++) = g_array_index (blocks, guint64, i);
+
+		arv_gc_port_prefetch_blocks (ARV_GC_PORT (key), (guint64 *) blocks->data, n_unique);
+	}
+
+	g_hash_table_unref (port_blocks);
+}
+
+
+/* Above this ratio between the spanned and the useful sizes, the registers are read one by one, unless the span
+ * fits in a single small memory read */
+#define ARV_GC_REGISTER_NODE_SELECTOR_SPAN_RATIO_MAX	2
+#define ARV_GC_REGISTER_NODE_SELECTOR_SPAN_MIN		512
+
+/*
+ * arv_gc_register_node_read_for_selector:
+ * @self: a #ArvGcRegisterNode
+ * @selector: the selector node
+ * @selector_values: the selector values
+ * @n_selector_values: the number of selector values
+ * @length: (out): the register length
+ * @error: a #GError placeholder
+ *
+ * Reads the register for each selector value, without changing the selector, when its address depends on the
+ * selector only through pIndex entries. The register address is computed for each selector value, and the
+ * registers are read using a single port access when they are contiguous enough. The register cache is bypassed.
+ *
+ * Returns: a newly allocated buffer of @n_selector_values * @length bytes, or %NULL if the register is not indexed
+ * by @selector, or on error.
+ */
+
+void *
+arv_gc_register_node_read_for_selector (ArvGcRegisterNode *self, ArvGcNode *selector,
+					const gint64 *selector_values, guint n_selector_values,
+					gint64 *length, GError **error)
+{
+	ArvGcRegisterNodePrivate *priv;
+	ArvGcNode *port;
+	GError *local_error = NULL;
+	guint64 *addresses;
+	guint64 min_address = G_MAXUINT64;
+	guint64 max_address = 0;
+	gboolean is_indexed = FALSE;
+	gboolean use_span;
+	gint64 register_length;
+	gint64 start_time;
+	guint8 *data = NULL;
+	guint i;
+
+	g_return_val_if_fail (ARV_IS_GC_REGISTER_NODE (self), NULL);
+	g_return_val_if_fail (ARV_IS_GC_NODE (selector), NULL);
+	g_return_val_if_fail (selector_values != NULL || n_selector_values == 0, NULL);
+	g_return_val_if_fail (length != NULL, NULL);
+	g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
+	priv = arv_gc_register_node_get_instance_private (self);
+
+	port = arv_gc_property_node_get_linked_node (priv->port);
+	if (n_selector_values == 0 || !ARV_IS_GC_PORT (port) ||
+	    arv_gc_register_node_get_access_mode (ARV_GC_FEATURE_NODE (self)) == ARV_GC_ACCESS_MODE_WO)
+		return NULL;
+
+	addresses = g_new (guint64, n_selector_values);
+
+	g_rec_mutex_lock (&priv->mutex);
+
+	register_length = _get_length (self, &local_error);
+
+	for (i = 0; i < n_selector_values && local_error == NULL; i++) {
+		addresses[i] = _get_address_for_index (self, selector, selector_values[i], &is_indexed, &local_error);
+		if (!is_indexed)
+			break;
+
+		min_address = MIN (min_address, addresses[i]);
+		max_address = MAX (max_address, addresses[i]);
+	}
+
+	if (local_error != NULL || !is_indexed || register_length < 1) {
+		g_rec_mutex_unlock (&priv->mutex);
+		g_free (addresses);
+		if (local_error != NULL)
+			g_propagate_error (error, local_error);
+		return NULL;
+	}
+
+	data = g_malloc (n_selector_values * register_length);
+
+	start_time = g_get_monotonic_time ();
+
+	use_span = max_address - min_address + register_length <=
+		MAX (ARV_GC_REGISTER_NODE_SELECTOR_SPAN_MIN,
+		     ARV_GC_REGISTER_NODE_SELECTOR_SPAN_RATIO_MAX * n_selector_values * register_length);
+
+	if (use_span) {
+		guint8 *span;
+
+		span = g_malloc (max_address - min_address + register_length);
+		arv_gc_port_read (ARV_GC_PORT (port), span, min_address, max_address - min_address + register_length,
+				  &local_error);
+		if (local_error == NULL)
+			for (i = 0; i < n_selector_values; i++)
+				memcpy (data + i * register_length, span + (addresses[i] - min_address),
+					register_length);
+		g_free (span);
+		priv->n_reads++;
+
+		if (local_error != NULL) {
+			arv_debug_genicam ("[GcRegisterNode::read_for_selector] Span read of '%s' failed (%s)",
+					   arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (self)),
+					   local_error->message);
+			g_clear_error (&local_error);
+			use_span = FALSE;
+		}
+	}
+
+	/* The span may contain unmapped addresses, the registers are then read one by one */
+	if (!use_span) {
+		for (i = 0; i < n_selector_values && local_error == NULL; i++) {
+			arv_gc_port_read (ARV_GC_PORT (port), data + i * register_length, addresses[i],
+					  register_length, &local_error);
+			priv->n_reads++;
+		}
+	}
+
+	priv->port_time_us += g_get_monotonic_time () - start_time;
+
+	g_rec_mutex_unlock (&priv->mutex);
+
+	g_free (addresses);
+
+	if (local_error != NULL) {
+		g_free (data);
+		g_propagate_error (error, local_error);
+		return NULL;
+	}
+
+	arv_debug_genicam ("[GcRegisterNode::read_for_selector] %u values of '%s' read from 0x%" G_GINT64_MODIFIER "x",
+			   n_selector_values, arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (self)), min_address);
+
+	*length = register_length;
+
+	return data;
+}
+
+/*
+ * arv_gc_register_node_write_for_selector:
+ * @self: a #ArvGcRegisterNode
+ * @selector: the selector node
+ * @selector_values: the selector values
+ * @n_selector_values: the number of selector values
+ * @data: the @n_selector_values register values, as raw data
+ * @length: the register length of each value
+ * @error: a #GError placeholder
+ *
+ * Writes the register for each selector value, without changing the selector, when its address depends on the
+ * selector only through pIndex entries. The values of contiguous registers, like the entries of a LUT, are written
+ * together, using a single port access per run of contiguous registers.
+ *
+ * Returns: %TRUE if the registers were written, %FALSE if the register is not indexed by @selector, or on error.
+ */
+
+gboolean
+arv_gc_register_node_write_for_selector (ArvGcRegisterNode *self, ArvGcNode *selector,
+					 const gint64 *selector_values, guint n_selector_values,
+					 const void *data, gint64 length, GError **error)
+{
+	ArvGcRegisterNodePrivate *priv;
+	ArvGcNode *port;
+	GError *local_error = NULL;
+	guint64 *addresses;
+	guint8 *run;
+	gboolean is_indexed = FALSE;
+	gint64 register_length;
+	gint64 start_time;
+	guint n_runs = 0;
+	guint i, j;
+
+	g_return_val_if_fail (ARV_IS_GC_REGISTER_NODE (self), FALSE);
+	g_return_val_if_fail (ARV_IS_GC_NODE (selector), FALSE);
+	g_return_val_if_fail (selector_values != NULL || n_selector_values == 0, FALSE);
+	g_return_val_if_fail (data != NULL || n_selector_values == 0, FALSE);
+	g_return_val_if_fail (error == NULL || *error == NULL, FALSE);
+
+	priv = arv_gc_register_node_get_instance_private (self);
+
+	port = arv_gc_property_node_get_linked_node (priv->port);
+	if (n_selector_values == 0 || !ARV_IS_GC_PORT (port) ||
+	    arv_gc_register_node_get_access_mode (ARV_GC_FEATURE_NODE (self)) == ARV_GC_ACCESS_MODE_RO)
+		return FALSE;
+
+	addresses = g_new (guint64, n_selector_values);
+
+	g_rec_mutex_lock (&priv->mutex);
+
+	register_length = _get_length (self, &local_error);
+
+	for (i = 0; i < n_selector_values && local_error == NULL; i++) {
+		addresses[i] = _get_address_for_index (self, selector, selector_values[i], &is_indexed, &local_error);
+		if (!is_indexed)
+			break;
+	}
+
+	if (local_error != NULL || !is_indexed || register_length != length) {
+		g_rec_mutex_unlock (&priv->mutex);
+		g_free (addresses);
+		if (local_error != NULL)
+			g_propagate_error (error, local_error);
+		return FALSE;
+	}
+
+	_bind_invalidators (self);
+
+	run = g_malloc (n_selector_values * length);
+
+	start_time = g_get_monotonic_time ();
+
+	/* Runs of values at increasing contiguous addresses, in the order of the selector values */
+	for (i = 0; i < n_selector_values && local_error == NULL; i = j) {
+		for (j = i + 1; j < n_selector_values && addresses[j] == addresses[j - 1] + length; j++);
+
+		memcpy (run, ((const guint8 *) data) + i * length, (j - i) * length);
+		arv_gc_port_write (ARV_GC_PORT (port), run, addresses[i], (j - i) * length, &local_error);
+
+		priv->n_writes++;
+		n_runs++;
+	}
+
+	priv->port_time_us += g_get_monotonic_time () - start_time;
+
+	/* The node cache only holds the value for the current selector */
+	priv->cached = FALSE;
+	priv->prefetched = FALSE;
+	arv_gc_feature_node_increment_change_count (ARV_GC_FEATURE_NODE (self));
+
+	g_rec_mutex_unlock (&priv->mutex);
+
+	g_free (run);
+	g_free (addresses);
+
+	if (local_error != NULL) {
+		g_propagate_error (error, local_error);
+		return FALSE;
+	}
+
+	arv_debug_genicam ("[GcRegisterNode::write_for_selector] %u values of '%s' written in %u access%s",
+			   n_selector_values, arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (self)),
+			   n_runs, n_runs > 1 ? "es" : "");
+
+	return TRUE;
+}
@@ -24,6 +24,7 @@
 #define ARV_GC_REGISTER_NODE_PRIVATE_H
 
 #include <arvgcregisternode.h>
+#include <arvgcmaskedintregnode.h>
 
 gint64 		arv_gc_register_node_get_masked_integer_value 	(ArvGcRegisterNode *gc_register_node,
 								 guint lsb, guint msb,
@@ -36,7 +37,55 @@ void 		arv_gc_register_node_set_masked_integer_value 	(ArvGcRegisterNode *gc_reg
 								 ArvGcCachable cachable,
 								 gboolean is_masked,
 								 gint64 value, GError **error);
+
+/* Bit field of a register, as described by a MaskedIntReg or a StructEntry node */
+
+typedef struct {
+	ArvGcRegisterNode *register_node;
+	guint lsb;
+	guint msb;
+	guint endianness;		/* 0 for the register endianness */
+	ArvGcCachable cachable;
+	gint64 value;
+} ArvGcRegisterField;
+
+void		arv_gc_register_node_set_fields			(ArvGcRegisterNode *gc_register_node,
+								 const ArvGcRegisterField *fields, guint n_fields,
+								 GError **error);
+gboolean	arv_gc_register_node_is_same_register		(ArvGcRegisterNode *gc_register_node,
+								 ArvGcRegisterNode *other);
+gboolean	arv_gc_masked_int_reg_node_get_field		(ArvGcMaskedIntRegNode *masked_int_reg_node,
+								 ArvGcRegisterField *field);
+gboolean	arv_gc_struct_entry_node_get_field		(ArvGcStructEntryNode *struct_entry_node,
+								 ArvGcRegisterField *field);
+
 guint 		arv_gc_register_node_get_endianness 		(ArvGcRegisterNode *register_node);
+gint64		arv_gc_register_node_get_polling_time		(ArvGcRegisterNode *register_node);
+
+void		arv_gc_register_node_prefetch			(ArvGcRegisterNode **nodes, guint n_nodes);
+void		arv_gc_register_node_prefetch_blocks		(ArvGcRegisterNode **nodes, guint n_nodes);
+void *		arv_gc_register_node_read_for_selector		(ArvGcRegisterNode *gc_register_node,
+								 ArvGcNode *selector,
+								 const gint64 *selector_values,
+								 guint n_selector_values,
+								 gint64 *length, GError **error);
+gboolean	arv_gc_register_node_write_for_selector		(ArvGcRegisterNode *gc_register_node,
+								 ArvGcNode *selector,
+								 const gint64 *selector_values,
+								 guint n_selector_values,
+								 const void *data, gint64 length,
+								 GError **error);
+
+void		arv_gc_register_node_get_statistics		(ArvGcRegisterNode *gc_register_node,
+								 guint64 *n_reads, guint64 *n_writes,
+								 guint64 *n_cache_hits, guint64 *n_cache_misses,
+								 guint64 *port_time_us);
+void		arv_gc_register_node_reset_statistics		(ArvGcRegisterNode *gc_register_node);
+
+gint64		arv_gc_register_node_decode_integer_value	(const void *data, gint64 length,
+								 guint lsb, guint msb,
+								 ArvGcSignedness signedness, guint endianness,
+								 gboolean is_masked);
 
 
 #endif
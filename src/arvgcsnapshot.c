@@ -0,0 +1,578 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2019 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel@gnome.org>
+ */
+
+/*< private >
+ * SECTION: arvgcsnapshot
+ * @short_description: Binary snapshot of the GenICam DOM tree
+ *
+ * A snapshot is a flat, relocatable, binary form of the GenICam XML data, that can be mapped from a file and used in
+ * place. It contains the elements and text nodes in document order, their attributes, an index of the feature names
+ * and a table of interned strings. All the references are 32 bit indices or string offsets.
+ *
+ * The #ArvGc node objects are created from a snapshot top-level subtree by top-level subtree, the first time one
+ * of the features it defines is looked up with arv_gc_get_node(), which avoids both the XML parsing and the creation
+ * of the unused nodes.
+ *
+ * Layout, in host byte order:
+ *
+ * |[
+ * ArvGcSnapshotHeader
+ * ArvGcSnapshotRecord records[n_records]           document order, records[0] being the root element
+ * ArvGcSnapshotAttribute attributes[n_attributes]
+ * ArvGcSnapshotName names[n_names]                 sorted by name
+ * char strings[strings_size]                       null terminated strings
+ * ]|
+ */
+
+#include <arvgcsnapshotprivate.h>
+#include <arvdomelement.h>
+#include <arvdebugprivate.h>
+#include <libxml/parser.h>
+#include <string.h>
+
+#define ARV_GC_SNAPSHOT_MAGIC		"ARVGCSNP"
+#define ARV_GC_SNAPSHOT_BYTE_ORDER	0x01020304
+
+typedef enum {
+	ARV_GC_SNAPSHOT_RECORD_TYPE_ELEMENT,
+	ARV_GC_SNAPSHOT_RECORD_TYPE_TEXT
+} ArvGcSnapshotRecordType;
+
+typedef struct {
+	char magic[8];
+	guint32 version;
+	guint32 byte_order;
+	guint32 n_records;
+	guint32 n_attributes;
+	guint32 n_names;
+	guint32 strings_size;
+} ArvGcSnapshotHeader;
+
+typedef struct {
+	guint32 type;
+	/* Tag name of elements, data of text nodes */
+	guint32 string;
+	guint32 first_attribute;
+	guint32 n_attributes;
+	/* Size of the subtree, not counting the record itself */
+	guint32 n_descendants;
+} ArvGcSnapshotRecord;
+
+typedef struct {
+	guint32 name;
+	guint32 value;
+} ArvGcSnapshotAttribute;
+
+typedef struct {
+	guint32 name;
+	/* Top-level record defining the feature */
+	guint32 record;
+} ArvGcSnapshotName;
+
+struct _ArvGcSnapshot {
+	GBytes *bytes;
+
+	const ArvGcSnapshotHeader *header;
+	const ArvGcSnapshotRecord *records;
+	const ArvGcSnapshotAttribute *attributes;
+	const ArvGcSnapshotName *names;
+	const char *strings;
+
+	ArvDomDocument *document;
+	guint8 *is_materialized;
+};
+
+/* Builder */
+
+typedef struct {
+	GArray *records;
+	GArray *attributes;
+	GHashTable *names;
+	GHashTable *string_offsets;
+	GString *strings;
+
+	GArray *stack;
+	GString *text;
+	gboolean has_element_child;
+	guint32 top_level_record;
+
+	gboolean is_error;
+} ArvGcSnapshotBuilder;
+
+static guint32
+_intern (ArvGcSnapshotBuilder *builder, const char *string)
+{
+	gpointer offset;
+
+	if (g_hash_table_lookup_extended (builder->string_offsets, string, NULL, &offset))
+		return GPOINTER_TO_UINT (offset);
+
+	offset = GUINT_TO_POINTER (builder->strings->len);
+	g_hash_table_insert (builder->string_offsets, g_strdup (string), offset);
+	g_string_append_len (builder->strings, string, strlen (string) + 1);
+
+	return GPOINTER_TO_UINT (offset);
+}
+
+static gboolean
+_is_blank (const char *text)
+{
+	for (; *text != '\0'; text++)
+		if (!g_ascii_isspace (*text))
+			return FALSE;
+
+	return TRUE;
+}
+
+/* Blank text between elements is dropped, as the GenICam nodes do not accept it anyway */
+
+static void
+_flush_text (ArvGcSnapshotBuilder *builder, gboolean drop_blank)
+{
+	ArvGcSnapshotRecord record = {0};
+
+	if (builder->text->len == 0)
+		return;
+
+	if (builder->stack->len > 0 && !(drop_blank && _is_blank (builder->text->str))) {
+		record.type = ARV_GC_SNAPSHOT_RECORD_TYPE_TEXT;
+		record.string = _intern (builder, builder->text->str);
+		g_array_append_val (builder->records, record);
+	}
+
+	g_string_truncate (builder->text, 0);
+}
+
+static void
+_start_element (void *user_data, const xmlChar *name, const xmlChar **attrs)
+{
+	ArvGcSnapshotBuilder *builder = user_data;
+	ArvGcSnapshotRecord record = {0};
+	guint32 index;
+	int i;
+
+	_flush_text (builder, TRUE);
+
+	index = builder->records->len;
+	if (builder->stack->len == 1)
+		builder->top_level_record = index;
+
+	record.type = ARV_GC_SNAPSHOT_RECORD_TYPE_ELEMENT;
+	record.string = _intern (builder, (const char *) name);
+	record.first_attribute = builder->attributes->len;
+
+	if (attrs != NULL)
+		for (i = 0; attrs[i] != NULL && attrs[i+1] != NULL; i += 2) {
+			ArvGcSnapshotAttribute attribute;
+
+			attribute.name = _intern (builder, (const char *) attrs[i]);
+			attribute.value = _intern (builder, (const char *) attrs[i+1]);
+			g_array_append_val (builder->attributes, attribute);
+			record.n_attributes++;
+
+			/* Same rule as arv_gc_register_feature_node() callers, the last definition wins */
+			if (builder->stack->len > 0 &&
+			    strcmp ((const char *) attrs[i], "Name") == 0 &&
+			    strcmp ((const char *) name, "EnumEntry") != 0)
+				g_hash_table_insert (builder->names, GUINT_TO_POINTER (attribute.value),
+						     GUINT_TO_POINTER (builder->top_level_record));
+		}
+
+	g_array_append_val (builder->records, record);
+	g_array_append_val (builder->stack, index);
+	builder->has_element_child = FALSE;
+}
+
+static void
+_end_element (void *user_data, const xmlChar *name)
+{
+	ArvGcSnapshotBuilder *builder = user_data;
+	ArvGcSnapshotRecord *record;
+	guint32 index;
+
+	_flush_text (builder, builder->has_element_child);
+
+	if (builder->stack->len == 0)
+		return;
+
+	index = g_array_index (builder->stack, guint32, builder->stack->len - 1);
+	g_array_set_size (builder->stack, builder->stack->len - 1);
+
+	record = &g_array_index (builder->records, ArvGcSnapshotRecord, index);
+	record->n_descendants = builder->records->len - index - 1;
+
+	builder->has_element_child = TRUE;
+}
+
+static void
+_characters (void *user_data, const xmlChar *ch, int len)
+{
+	ArvGcSnapshotBuilder *builder = user_data;
+
+	g_string_append_len (builder->text, (const char *) ch, len);
+}
+
+static void _error (void *user_data, const char *msg, ...) G_GNUC_PRINTF(2,3);
+
+static void
+_error (void *user_data, const char *msg, ...)
+{
+	ArvGcSnapshotBuilder *builder = user_data;
+
+	builder->is_error = TRUE;
+}
+
+static xmlSAXHandler sax_handler = {
+	.error = _error,
+	.fatalError = _error,
+	.startElement = _start_element,
+	.endElement = _end_element,
+	.characters = _characters
+};
+
+static gint
+_compare_names (gconstpointer a, gconstpointer b, gpointer user_data)
+{
+	const char *strings = user_data;
+
+	return strcmp (strings + ((const ArvGcSnapshotName *) a)->name,
+		       strings + ((const ArvGcSnapshotName *) b)->name);
+}
+
+/* Returns a snapshot of @xml, or %NULL if @xml is not a valid document */
+
+GBytes *
+arv_gc_snapshot_build (const void *xml, size_t size)
+{
+	ArvGcSnapshotBuilder builder = {0};
+	ArvGcSnapshotHeader header = {0};
+	GArray *names;
+	GHashTableIter iter;
+	gpointer key, value;
+	GByteArray *data = NULL;
+
+	g_return_val_if_fail (xml != NULL, NULL);
+
+	builder.records = g_array_new (FALSE, FALSE, sizeof (ArvGcSnapshotRecord));
+	builder.attributes = g_array_new (FALSE, FALSE, sizeof (ArvGcSnapshotAttribute));
+	builder.names = g_hash_table_new (g_direct_hash, g_direct_equal);
+	builder.string_offsets = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+	builder.strings = g_string_new ("");
+	builder.stack = g_array_new (FALSE, FALSE, sizeof (guint32));
+	builder.text = g_string_new ("");
+
+	if (xmlSAXUserParseMemory (&sax_handler, &builder, xml, (int) size) < 0 ||
+	    builder.is_error || builder.records->len == 0) {
+		arv_warning_genicam ("[GcSnapshot::build] Invalid document");
+		goto out;
+	}
+
+	names = g_array_sized_new (FALSE, FALSE, sizeof (ArvGcSnapshotName), g_hash_table_size (builder.names));
+	g_hash_table_iter_init (&iter, builder.names);
+	while (g_hash_table_iter_next (&iter, &key, &value)) {
+		ArvGcSnapshotName name;
+
+		name.name = GPOINTER_TO_UINT (key);
+		name.record = GPOINTER_TO_UINT (value);
+		g_array_append_val (names, name);
+	}
+	g_array_sort_with_data (names, _compare_names, builder.strings->str);
+
+	memcpy (header.magic, ARV_GC_SNAPSHOT_MAGIC, sizeof (header.magic));
+	header.version = ARV_GC_SNAPSHOT_VERSION;
+	header.byte_order = ARV_GC_SNAPSHOT_BYTE_ORDER;
+	header.n_records = builder.records->len;
+	header.n_attributes = builder.attributes->len;
+	header.n_names = names->len;
+	header.strings_size = builder.strings->len;
+
+	data = g_byte_array_sized_new (sizeof (header) +
+				       header.n_records * sizeof (ArvGcSnapshotRecord) +
+				       header.n_attributes * sizeof (ArvGcSnapshotAttribute) +
+				       header.n_names * sizeof (ArvGcSnapshotName) +
+				       header.strings_size);
+	g_byte_array_append (data, (const guint8 *) &header, sizeof (header));
+	g_byte_array_append (data, (const guint8 *) builder.records->data,
+			     header.n_records * sizeof (ArvGcSnapshotRecord));
+	g_byte_array_append (data, (const guint8 *) builder.attributes->data,
+			     header.n_attributes * sizeof (ArvGcSnapshotAttribute));
+	g_byte_array_append (data, (const guint8 *) names->data, header.n_names * sizeof (ArvGcSnapshotName));
+	g_byte_array_append (data, (const guint8 *) builder.strings->str, header.strings_size);
+
+	arv_info_genicam ("[GcSnapshot::build] %u records, %u attributes, %u names, %u bytes of strings",
+			  header.n_records, header.n_attributes, header.n_names, header.strings_size);
+
+	g_array_unref (names);
+
+out:
+	g_array_unref (builder.records);
+	g_array_unref (builder.attributes);
+	g_hash_table_unref (builder.names);
+	g_hash_table_unref (builder.string_offsets);
+	g_string_free (builder.strings, TRUE);
+	g_array_unref (builder.stack);
+	g_string_free (builder.text, TRUE);
+
+	return data != NULL ? g_byte_array_free_to_bytes (data) : NULL;
+}
+
+/* Loader */
+
+static gboolean
+_is_valid_string (ArvGcSnapshot *snapshot, guint32 offset)
+{
+	return offset < snapshot->header->strings_size;
+}
+
+static gboolean
+_validate (ArvGcSnapshot *snapshot, gsize size)
+{
+	const ArvGcSnapshotHeader *header = snapshot->header;
+	guint64 expected_size;
+	guint32 i;
+
+	if (size < sizeof (ArvGcSnapshotHeader) ||
+	    memcmp (header->magic, ARV_GC_SNAPSHOT_MAGIC, sizeof (header->magic)) != 0 ||
+	    header->version != ARV_GC_SNAPSHOT_VERSION ||
+	    header->byte_order != ARV_GC_SNAPSHOT_BYTE_ORDER ||
+	    header->n_records == 0)
+		return FALSE;
+
+	expected_size = sizeof (ArvGcSnapshotHeader) +
+		(guint64) header->n_records * sizeof (ArvGcSnapshotRecord) +
+		(guint64) header->n_attributes * sizeof (ArvGcSnapshotAttribute) +
+		(guint64) header->n_names * sizeof (ArvGcSnapshotName) +
+		header->strings_size;
+	if (expected_size != size ||
+	    header->strings_size == 0 ||
+	    snapshot->strings[header->strings_size - 1] != '\0')
+		return FALSE;
+
+	for (i = 0; i < header->n_records; i++) {
+		const ArvGcSnapshotRecord *record = &snapshot->records[i];
+
+		if (record->type > ARV_GC_SNAPSHOT_RECORD_TYPE_TEXT ||
+		    !_is_valid_string (snapshot, record->string) ||
+		    (guint64) record->first_attribute + record->n_attributes > header->n_attributes ||
+		    (guint64) i + record->n_descendants >= header->n_records)
+			return FALSE;
+	}
+
+	if (snapshot->records[0].n_descendants != header->n_records - 1)
+		return FALSE;
+
+	for (i = 0; i < header->n_attributes; i++)
+		if (!_is_valid_string (snapshot, snapshot->attributes[i].name) ||
+		    !_is_valid_string (snapshot, snapshot->attributes[i].value))
+			return FALSE;
+
+	for (i = 0; i < header->n_names; i++)
+		if (!_is_valid_string (snapshot, snapshot->names[i].name) ||
+		    snapshot->names[i].record == 0 ||
+		    snapshot->names[i].record >= header->n_records)
+			return FALSE;
+
+	return TRUE;
+}
+
+/* @bytes is referenced, and used in place. Typically obtained with g_mapped_file_get_bytes(). */
+
+ArvGcSnapshot *
+arv_gc_snapshot_new (GBytes *bytes)
+{
+	ArvGcSnapshot *snapshot;
+	const char *data;
+	gsize size;
+
+	g_return_val_if_fail (bytes != NULL, NULL);
+
+	data = g_bytes_get_data (bytes, &size);
+
+	/* The mapped files and the allocated buffers are suitably aligned */
+	if (data == NULL || size < sizeof (ArvGcSnapshotHeader) || ((gsize) data % sizeof (guint32)) != 0)
+		return NULL;
+
+	snapshot = g_new0 (ArvGcSnapshot, 1);
+	snapshot->header = (const ArvGcSnapshotHeader *) data;
+	data += sizeof (ArvGcSnapshotHeader);
+	snapshot->records = (const ArvGcSnapshotRecord *) data;
+	data += (gsize) snapshot->header->n_records * sizeof (ArvGcSnapshotRecord);
+	snapshot->attributes = (const ArvGcSnapshotAttribute *) data;
+	data += (gsize) snapshot->header->n_attributes * sizeof (ArvGcSnapshotAttribute);
+	snapshot->names = (const ArvGcSnapshotName *) data;
+	data += (gsize) snapshot->header->n_names * sizeof (ArvGcSnapshotName);
+	snapshot->strings = data;
+
+	if (!_validate (snapshot, size)) {
+		arv_warning_genicam ("[GcSnapshot::new] Invalid snapshot");
+		g_free (snapshot);
+		return NULL;
+	}
+
+	snapshot->bytes = g_bytes_ref (bytes);
+	snapshot->is_materialized = g_new0 (guint8, snapshot->header->n_records);
+
+	return snapshot;
+}
+
+void
+arv_gc_snapshot_free (ArvGcSnapshot *snapshot)
+{
+	if (snapshot == NULL)
+		return;
+
+	g_bytes_unref (snapshot->bytes);
+	g_free (snapshot->is_materialized);
+	g_free (snapshot);
+}
+
+static void
+_set_attributes (ArvGcSnapshot *snapshot, ArvDomElement *element, const ArvGcSnapshotRecord *record)
+{
+	guint32 i;
+
+	for (i = 0; i < record->n_attributes; i++) {
+		const ArvGcSnapshotAttribute *attribute = &snapshot->attributes[record->first_attribute + i];
+
+		arv_dom_element_set_attribute (element,
+					       snapshot->strings + attribute->name,
+					       snapshot->strings + attribute->value);
+	}
+}
+
+/* Same sequence of DOM operations as the XML parser. Returns the number of records of the subtree. */
+
+static guint32
+_materialize (ArvGcSnapshot *snapshot, ArvDomNode *parent, guint32 index)
+{
+	const ArvGcSnapshotRecord *record = &snapshot->records[index];
+	ArvDomNode *node;
+	guint32 child;
+
+	if (record->type == ARV_GC_SNAPSHOT_RECORD_TYPE_TEXT) {
+		node = ARV_DOM_NODE (arv_dom_document_create_text_node (snapshot->document,
+									 snapshot->strings + record->string));
+		arv_dom_node_append_child (parent, node);
+		return 1;
+	}
+
+	node = ARV_DOM_NODE (arv_dom_document_create_element (snapshot->document, snapshot->strings + record->string));
+	if (node == NULL || arv_dom_node_append_child (parent, node) == NULL)
+		return record->n_descendants + 1;
+
+	_set_attributes (snapshot, ARV_DOM_ELEMENT (node), record);
+
+	for (child = index + 1; child <= index + record->n_descendants; )
+		child += _materialize (snapshot, node, child);
+
+	return record->n_descendants + 1;
+}
+
+/* Creates the root element and its attributes, without the top-level subtrees. Returns the root element. */
+
+ArvDomNode *
+arv_gc_snapshot_materialize_root (ArvGcSnapshot *snapshot, ArvDomDocument *document)
+{
+	ArvDomNode *root;
+
+	g_return_val_if_fail (snapshot != NULL, NULL);
+	g_return_val_if_fail (ARV_IS_DOM_DOCUMENT (document), NULL);
+
+	snapshot->document = document;
+
+	root = ARV_DOM_NODE (arv_dom_document_create_element (document, snapshot->strings +
+								       snapshot->records[0].string));
+	if (root == NULL || arv_dom_node_append_child (ARV_DOM_NODE (document), root) == NULL)
+		return NULL;
+
+	_set_attributes (snapshot, ARV_DOM_ELEMENT (root), &snapshot->records[0]);
+
+	snapshot->is_materialized[0] = TRUE;
+
+	return root;
+}
+
+static const ArvGcSnapshotName *
+_lookup_name (ArvGcSnapshot *snapshot, const char *name)
+{
+	guint32 low = 0;
+	guint32 high = snapshot->header->n_names;
+
+	while (low < high) {
+		guint32 middle = low + (high - low) / 2;
+		gint result = strcmp (name, snapshot->strings + snapshot->names[middle].name);
+
+		if (result == 0)
+			return &snapshot->names[middle];
+		if (result < 0)
+			high = middle;
+		else
+			low = middle + 1;
+	}
+
+	return NULL;
+}
+
+/* Creates the top-level subtree defining the feature @name, if not already done. Returns %TRUE if new nodes were
+ * created. */
+
+gboolean
+arv_gc_snapshot_materialize_node (ArvGcSnapshot *snapshot, ArvDomNode *root, const char *name)
+{
+	const ArvGcSnapshotName *entry;
+
+	g_return_val_if_fail (snapshot != NULL, FALSE);
+	g_return_val_if_fail (name != NULL, FALSE);
+
+	entry = _lookup_name (snapshot, name);
+	if (entry == NULL || snapshot->is_materialized[entry->record])
+		return FALSE;
+
+	/* Set first, the creation of the subtree may look up other features */
+	snapshot->is_materialized[entry->record] = TRUE;
+
+	arv_debug_genicam ("[GcSnapshot::materialize_node] Create '%s' subtree for '%s'",
+			   snapshot->strings + snapshot->records[entry->record].string, name);
+
+	_materialize (snapshot, root, entry->record);
+
+	return TRUE;
+}
+
+/* Creates all the top-level subtrees not created yet, in document order */
+
+void
+arv_gc_snapshot_materialize_all (ArvGcSnapshot *snapshot, ArvDomNode *root)
+{
+	guint32 index;
+
+	g_return_if_fail (snapshot != NULL);
+
+	for (index = 1; index < snapshot->header->n_records;
+	     index += snapshot->records[index].n_descendants + 1) {
+		if (snapshot->is_materialized[index])
+			continue;
+
+		snapshot->is_materialized[index] = TRUE;
+		_materialize (snapshot, root, index);
+	}
+}
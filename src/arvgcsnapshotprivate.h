@@ -0,0 +1,51 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2019 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel@gnome.org>
+ */
+
+#ifndef ARV_GC_SNAPSHOT_PRIVATE_H
+#define ARV_GC_SNAPSHOT_PRIVATE_H
+
+#if !defined (ARV_H_INSIDE) && !defined (ARAVIS_COMPILATION)
+#error "Only <arv.h> can be included directly."
+#endif
+
+#include <arvtypes.h>
+#include <arvdomdocument.h>
+
+G_BEGIN_DECLS
+
+#define ARV_GC_SNAPSHOT_VERSION		1
+
+typedef struct _ArvGcSnapshot ArvGcSnapshot;
+
+GBytes *		arv_gc_snapshot_build			(const void *xml, size_t size);
+
+ArvGcSnapshot *		arv_gc_snapshot_new			(GBytes *bytes);
+void			arv_gc_snapshot_free			(ArvGcSnapshot *snapshot);
+
+ArvDomNode *		arv_gc_snapshot_materialize_root	(ArvGcSnapshot *snapshot, ArvDomDocument *document);
+gboolean		arv_gc_snapshot_materialize_node	(ArvGcSnapshot *snapshot, ArvDomNode *root,
+								 const char *name);
+void			arv_gc_snapshot_materialize_all		(ArvGcSnapshot *snapshot, ArvDomNode *root);
+
+G_END_DECLS
+
+#endif
@@ -26,6 +26,7 @@
  */
 
 #include <arvgcstring.h>
+#include <arvgcprivate.h>
 #include <arvmisc.h>
 
 static void
@@ -48,10 +49,19 @@ G_DEFINE_INTERFACE (ArvGcString, arv_gc_string, G_TYPE_OBJECT)
 const char *
 arv_gc_string_get_value (ArvGcString *gc_string, GError **error)
 {
+	ArvGc *genicam;
+	const char *value;
+
 	g_return_val_if_fail (ARV_IS_GC_STRING (gc_string), NULL);
 	g_return_val_if_fail (error == NULL || *error == NULL, NULL);
 
-	return ARV_GC_STRING_GET_IFACE (gc_string)->get_value (gc_string, error);
+	genicam = arv_gc_node_get_genicam (ARV_GC_NODE (gc_string));
+
+	arv_gc_access_begin (genicam, FALSE);
+	value = ARV_GC_STRING_GET_IFACE (gc_string)->get_value (gc_string, error);
+	arv_gc_access_end (genicam);
+
+	return value;
 }
 
 /**
@@ -66,10 +76,16 @@ arv_gc_string_get_value (ArvGcString *gc_string, GError **error)
 void
 arv_gc_string_set_value (ArvGcString *gc_string, const char *value, GError **error)
 {
+	ArvGc *genicam;
+
 	g_return_if_fail (ARV_IS_GC_STRING (gc_string));
 	g_return_if_fail (error == NULL || *error == NULL);
 
+	genicam = arv_gc_node_get_genicam (ARV_GC_NODE (gc_string));
+
+	arv_gc_access_begin (genicam, TRUE);
 	ARV_GC_STRING_GET_IFACE (gc_string)->set_value (gc_string, value, error);
+	arv_gc_access_end (genicam);
 }
 
 /**
@@ -281,6 +281,29 @@ arv_gc_struct_entry_node_set_integer_value (ArvGcInteger *gc_integer, gint64 val
 		 TRUE, value, error);
 }
 
+/* Describes the bit field written by arv_gc_struct_entry_node_set_integer_value(), see arv_gc_register_node_set_fields() */
+
+gboolean
+arv_gc_struct_entry_node_get_field (ArvGcStructEntryNode *self, ArvGcRegisterField *field)
+{
+	ArvDomNode *struct_register;
+
+	g_return_val_if_fail (ARV_IS_GC_STRUCT_ENTRY_NODE (self), FALSE);
+	g_return_val_if_fail (field != NULL, FALSE);
+
+	struct_register = arv_dom_node_get_parent_node (ARV_DOM_NODE (self));
+	if (!ARV_IS_GC_REGISTER_NODE (struct_register))
+		return FALSE;
+
+	field->register_node = ARV_GC_REGISTER_NODE (struct_register);
+	field->lsb = arv_gc_property_node_get_lsb (self->lsb, 0);
+	field->msb = arv_gc_property_node_get_msb (self->msb, 31);
+	field->endianness = 0;
+	field->cachable = arv_gc_property_node_get_cachable (self->cachable, ARV_GC_CACHABLE_WRITE_AROUND);
+
+	return TRUE;
+}
+
 static gint64
 arv_gc_struct_entry_node_get_min (ArvGcInteger *self, GError **error)
 {
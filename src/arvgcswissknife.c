@@ -31,6 +31,7 @@
 #include <arvgcfloat.h>
 #include <arvgcport.h>
 #include <arvgc.h>
+#include <arvgcprivate.h>
 #include <arvdebug.h>
 #include <string.h>
 
@@ -45,6 +46,11 @@ typedef struct {
 	ArvGcPropertyNode *representation;
 
 	ArvEvaluator *formula;
+	gboolean formula_up_to_date;
+	/* Evaluator slots of the pVariable values, in the order of the variables list */
+	gint *variable_slots;
+	/* Protects the evaluator variables against the concurrent reads of the document */
+	GRecMutex mutex;
 } ArvGcSwissKnifePrivate;
 
 G_DEFINE_ABSTRACT_TYPE_WITH_CODE (ArvGcSwissKnife, arv_gc_swiss_knife, ARV_TYPE_GC_FEATURE_NODE, G_ADD_PRIVATE (ArvGcSwissKnife))
@@ -62,9 +68,11 @@ arv_gc_swiss_knife_post_new_child (ArvDomNode *self, ArvDomNode *child)
 		switch (arv_gc_property_node_get_node_type (property_node)) {
 			case ARV_GC_PROPERTY_NODE_TYPE_P_VARIABLE:
 				priv->variables = g_slist_prepend (priv->variables, property_node);
+				g_clear_pointer (&priv->variable_slots, g_free);
 				break;
 			case ARV_GC_PROPERTY_NODE_TYPE_FORMULA:
 				priv->formula_node = property_node;
+				priv->formula_up_to_date = FALSE;
 				break;
 			case ARV_GC_PROPERTY_NODE_TYPE_UNIT:
 				priv->unit = property_node;
@@ -74,9 +82,11 @@ arv_gc_swiss_knife_post_new_child (ArvDomNode *self, ArvDomNode *child)
 				break;
 			case ARV_GC_PROPERTY_NODE_TYPE_EXPRESSION:
 				priv->expressions = g_slist_prepend (priv->expressions, property_node);
+				priv->formula_up_to_date = FALSE;
 				break;
 			case ARV_GC_PROPERTY_NODE_TYPE_CONSTANT:
 				priv->constants = g_slist_prepend (priv->constants, property_node);
+				priv->formula_up_to_date = FALSE;
 				break;
 			default:
 				ARV_DOM_NODE_CLASS (arv_gc_swiss_knife_parent_class)->post_new_child (self, child);
@@ -91,6 +101,16 @@ arv_gc_swiss_knife_pre_remove_child (ArvDomNode *self, ArvDomNode *child)
 	g_assert_not_reached ();
 }
 
+static gboolean
+arv_gc_swiss_knife_child_changed (ArvDomNode *self, ArvDomNode *child)
+{
+	ArvGcSwissKnifePrivate *priv = arv_gc_swiss_knife_get_instance_private (ARV_GC_SWISS_KNIFE (self));
+
+	priv->formula_up_to_date = FALSE;
+
+	return FALSE;
+}
+
 /* ArvGcFeatureNode implementation */
 
 static void
@@ -99,6 +119,7 @@ arv_gc_swiss_knife_init (ArvGcSwissKnife *self)
 	ArvGcSwissKnifePrivate *priv = arv_gc_swiss_knife_get_instance_private (self);
 
 	priv->formula = arv_evaluator_new (NULL);
+	g_rec_mutex_init (&priv->mutex);
 }
 
 static ArvGcAccessMode
@@ -115,8 +136,10 @@ arv_gc_swiss_knife_finalize (GObject *object)
 	g_slist_free (priv->variables);
 	g_slist_free (priv->expressions);
 	g_slist_free (priv->constants);
+	g_free (priv->variable_slots);
 
 	g_clear_object (&priv->formula);
+	g_rec_mutex_clear (&priv->mutex);
 
 	G_OBJECT_CLASS (arv_gc_swiss_knife_parent_class)->finalize (object);
 }
@@ -131,20 +154,26 @@ arv_gc_swiss_knife_class_init (ArvGcSwissKnifeClass *this_class)
 	object_class->finalize = arv_gc_swiss_knife_finalize;
 	dom_node_class->post_new_child = arv_gc_swiss_knife_post_new_child;
 	dom_node_class->pre_remove_child = arv_gc_swiss_knife_pre_remove_child;
+	dom_node_class->child_changed = arv_gc_swiss_knife_child_changed;
 	gc_feature_node_class->get_access_mode = arv_gc_swiss_knife_get_access_mode;
 }
 
 /* ArvGcInteger interface implementation */
 
-static void
-_update_variables (ArvGcSwissKnife *self, GError **error)
+/* The evaluator keeps the parsed formula, it is only updated when one of the formula, expression or constant
+ * properties changed */
+
+static gboolean
+_update_formula (ArvGcSwissKnife *self, GError **error)
 {
 	ArvGcSwissKnifePrivate *priv = arv_gc_swiss_knife_get_instance_private (self);
-	ArvGcNode *node;
 	GError *local_error = NULL;
 	GSList *iter;
 	const char *expression;
 
+	if (priv->formula_up_to_date)
+		return TRUE;
+
 	if (priv->formula_node != NULL)
 		expression = arv_gc_property_node_get_string (priv->formula_node, &local_error);
 	else
@@ -152,7 +181,7 @@ _update_variables (ArvGcSwissKnife *self, GError **error)
 
 	if (local_error != NULL) {
 		g_propagate_error (error, local_error);
-		return;
+		return FALSE;
 	}
 
 	arv_evaluator_set_expression (priv->formula, expression);
@@ -164,7 +193,7 @@ _update_variables (ArvGcSwissKnife *self, GError **error)
 		expression = arv_gc_property_node_get_string (ARV_GC_PROPERTY_NODE (iter->data), &local_error);
 		if (local_error != NULL) {
 			g_propagate_error (error, local_error);
-			return;
+			return FALSE;
 		}
 
 		name = arv_gc_property_node_get_name (iter->data);
@@ -179,7 +208,7 @@ _update_variables (ArvGcSwissKnife *self, GError **error)
 		constant = arv_gc_property_node_get_string (ARV_GC_PROPERTY_NODE (iter->data), &local_error);
 		if (local_error != NULL) {
 			g_propagate_error (error, local_error);
-			return;
+			return FALSE;
 		}
 
 		name = arv_gc_property_node_get_name (iter->data);
@@ -187,38 +216,54 @@ _update_variables (ArvGcSwissKnife *self, GError **error)
 		arv_evaluator_set_constant (priv->formula, name, constant);
 	}
 
-	for (iter = priv->variables; iter != NULL; iter = iter->next) {
+	priv->formula_up_to_date = TRUE;
+
+	return TRUE;
+}
+
+/* Doesn't allocate any error for failed variable reads when error is NULL */
+
+static gboolean
+_update_variables (ArvGcSwissKnife *self, GError **error)
+{
+	ArvGcSwissKnifePrivate *priv = arv_gc_swiss_knife_get_instance_private (self);
+	ArvGcNode *node;
+	GSList *iter;
+	guint i;
+
+	if (!_update_formula (self, error))
+		return FALSE;
+
+	if (priv->variable_slots == NULL) {
+		priv->variable_slots = g_new (gint, g_slist_length (priv->variables));
+		for (iter = priv->variables, i = 0; iter != NULL; iter = iter->next, i++)
+			priv->variable_slots[i] =
+				arv_evaluator_get_variable_slot (priv->formula,
+								 arv_gc_property_node_get_name (iter->data));
+	}
+
+	for (iter = priv->variables, i = 0; iter != NULL; iter = iter->next, i++) {
 		ArvGcPropertyNode *variable_node = iter->data;
 
 		node = arv_gc_property_node_get_linked_node (ARV_GC_PROPERTY_NODE (variable_node));
 		if (ARV_IS_GC_INTEGER (node)) {
 			gint64 value;
 
-			value = arv_gc_integer_get_value (ARV_GC_INTEGER (node), &local_error);
-
-			if (local_error != NULL) {
-				g_propagate_error (error, local_error);
-				return;
-			}
+			if (!arv_gc_integer_get_value_checked (ARV_GC_INTEGER (node), &value, error))
+				return FALSE;
 
-			arv_evaluator_set_int64_variable (priv->formula,
-							  arv_gc_property_node_get_name (variable_node),
-							  value);
+			arv_evaluator_set_int64_variable_by_slot (priv->formula, priv->variable_slots[i], value);
 		} else if (ARV_IS_GC_FLOAT (node)) {
 			double value;
 
-			value = arv_gc_float_get_value (ARV_GC_FLOAT (node), &local_error);
+			if (!arv_gc_float_get_value_checked (ARV_GC_FLOAT (node), &value, error))
+				return FALSE;
 
-			if (local_error != NULL) {
-				g_propagate_error (error, local_error);
-				return;
-			}
-
-			arv_evaluator_set_double_variable (priv->formula,
-							  arv_gc_property_node_get_name (variable_node),
-							  value);
+			arv_evaluator_set_double_variable_by_slot (priv->formula, priv->variable_slots[i], value);
 		}
 	}
+
+	return TRUE;
 }
 
 gint64
@@ -226,17 +271,24 @@ arv_gc_swiss_knife_get_integer_value (ArvGcSwissKnife *self, GError **error)
 {
 	ArvGcSwissKnifePrivate *priv = arv_gc_swiss_knife_get_instance_private (self);
 	GError *local_error = NULL;
+	gint64 value = 0;
 
 	g_return_val_if_fail (ARV_IS_GC_SWISS_KNIFE (self), 0);
 
+	g_rec_mutex_lock (&priv->mutex);
+
 	_update_variables (self, &local_error);
+	if (local_error == NULL)
+		value = arv_evaluator_evaluate_as_int64 (priv->formula, NULL);
+
+	g_rec_mutex_unlock (&priv->mutex);
 
 	if (local_error != NULL) {
 		g_propagate_error (error, local_error);
 		return 0;
 	}
 
-	return arv_evaluator_evaluate_as_int64 (priv->formula, NULL);
+	return value;
 }
 
 double
@@ -244,17 +296,60 @@ arv_gc_swiss_knife_get_float_value (ArvGcSwissKnife *self, GError **error)
 {
 	ArvGcSwissKnifePrivate *priv = arv_gc_swiss_knife_get_instance_private (self);
 	GError *local_error = NULL;
+	double value = 0.0;
 
 	g_return_val_if_fail (ARV_IS_GC_SWISS_KNIFE (self), 0.0);
 
+	g_rec_mutex_lock (&priv->mutex);
+
 	_update_variables (self, &local_error);
+	if (local_error == NULL)
+		value = arv_evaluator_evaluate_as_double (priv->formula, NULL);
+
+	g_rec_mutex_unlock (&priv->mutex);
 
 	if (local_error != NULL) {
 		g_propagate_error (error, local_error);
 		return 0.0;
 	}
 
-	return arv_evaluator_evaluate_as_double (priv->formula, NULL);
+	return value;
+}
+
+gboolean
+arv_gc_swiss_knife_try_get_integer_value (ArvGcSwissKnife *self, gint64 *value)
+{
+	ArvGcSwissKnifePrivate *priv = arv_gc_swiss_knife_get_instance_private (self);
+	gboolean success;
+
+	g_return_val_if_fail (ARV_IS_GC_SWISS_KNIFE (self), FALSE);
+
+	g_rec_mutex_lock (&priv->mutex);
+
+	success = _update_variables (self, NULL);
+	*value = success ? arv_evaluator_evaluate_as_int64 (priv->formula, NULL) : 0;
+
+	g_rec_mutex_unlock (&priv->mutex);
+
+	return success;
+}
+
+gboolean
+arv_gc_swiss_knife_try_get_float_value (ArvGcSwissKnife *self, double *value)
+{
+	ArvGcSwissKnifePrivate *priv = arv_gc_swiss_knife_get_instance_private (self);
+	gboolean success;
+
+	g_return_val_if_fail (ARV_IS_GC_SWISS_KNIFE (self), FALSE);
+
+	g_rec_mutex_lock (&priv->mutex);
+
+	success = _update_variables (self, NULL);
+	*value = success ? arv_evaluator_evaluate_as_double (priv->formula, NULL) : 0.0;
+
+	g_rec_mutex_unlock (&priv->mutex);
+
+	return success;
 }
 
 ArvGcRepresentation
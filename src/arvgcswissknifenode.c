@@ -76,6 +76,12 @@ arv_gc_swiss_knife_node_get_float_value (ArvGcFloat *self, GError **error)
 	return arv_gc_swiss_knife_get_float_value (ARV_GC_SWISS_KNIFE (self), error);
 }
 
+static gboolean
+arv_gc_swiss_knife_node_try_get_float_value (ArvGcFloat *self, double *value)
+{
+	return arv_gc_swiss_knife_try_get_float_value (ARV_GC_SWISS_KNIFE (self), value);
+}
+
 static void
 arv_gc_swiss_knife_node_set_float_value (ArvGcFloat *self, gdouble value, GError **error)
 {
@@ -126,6 +132,7 @@ static void
 arv_gc_swiss_knife_node_float_interface_init (ArvGcFloatInterface *interface)
 {
 	interface->get_value = arv_gc_swiss_knife_node_get_float_value;
+	interface->try_get_value = arv_gc_swiss_knife_node_try_get_float_value;
 	interface->set_value = arv_gc_swiss_knife_node_set_float_value;
 	interface->get_representation = arv_gc_swiss_knife_node_get_float_representation;
 	interface->get_unit = arv_gc_swiss_knife_node_get_float_unit;
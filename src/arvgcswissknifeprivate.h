@@ -30,5 +30,7 @@ const char *		arv_gc_swiss_knife_get_unit		(ArvGcSwissKnife *self);
 
 gint64			arv_gc_swiss_knife_get_integer_value	(ArvGcSwissKnife *self, GError **error);
 double			arv_gc_swiss_knife_get_float_value	(ArvGcSwissKnife *self, GError **error);
+gboolean		arv_gc_swiss_knife_try_get_integer_value	(ArvGcSwissKnife *self, gint64 *value);
+gboolean		arv_gc_swiss_knife_try_get_float_value	(ArvGcSwissKnife *self, double *value);
 
 #endif
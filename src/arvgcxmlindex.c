@@ -0,0 +1,347 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2019 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel@gnome.org>
+ */
+
+/*< private >
+ * SECTION: arvgcxmlindex
+ * @short_description: Index of the top-level elements of a GenICam XML document
+ *
+ * A light scan of the GenICam XML data, that records the byte range of each element child of the root element, and
+ * the names of the features these subtrees define. It allows to create an #ArvGc with only its root element, and to
+ * parse the subtree of a feature the first time it is looked up with arv_gc_get_node().
+ *
+ * Documents with a DTD or with entity references in the feature names are not indexed, and are parsed at once.
+ */
+
+#include <arvgcxmlindexprivate.h>
+#include <arvdomparser.h>
+#include <arvdebugprivate.h>
+#include <string.h>
+
+typedef struct {
+	gsize start;
+	gsize end;
+	gboolean is_materialized;
+} ArvGcXmlIndexElement;
+
+struct _ArvGcXmlIndex {
+	char *xml;
+	gsize size;
+
+	char *root_name;
+	gsize root_tag_end;
+	gboolean is_root_empty;
+
+	GArray *elements;
+	/* Feature name to element index */
+	GHashTable *names;
+};
+
+typedef struct {
+	const char *xml;
+	gsize size;
+	gsize position;
+} ArvGcXmlScanner;
+
+static gboolean
+_skip_to (ArvGcXmlScanner *scanner, const char *pattern)
+{
+	gsize length = strlen (pattern);
+
+	for (; scanner->position + length <= scanner->size; scanner->position++)
+		if (memcmp (scanner->xml + scanner->position, pattern, length) == 0) {
+			scanner->position += length;
+			return TRUE;
+		}
+
+	return FALSE;
+}
+
+static gboolean
+_has_prefix (ArvGcXmlScanner *scanner, const char *prefix)
+{
+	gsize length = strlen (prefix);
+
+	return scanner->position + length <= scanner->size &&
+		memcmp (scanner->xml + scanner->position, prefix, length) == 0;
+}
+
+static void
+_skip_spaces (ArvGcXmlScanner *scanner)
+{
+	while (scanner->position < scanner->size && g_ascii_isspace (scanner->xml[scanner->position]))
+		scanner->position++;
+}
+
+static gsize
+_scan_name (ArvGcXmlScanner *scanner)
+{
+	gsize start = scanner->position;
+
+	while (scanner->position < scanner->size) {
+		char c = scanner->xml[scanner->position];
+
+		if (g_ascii_isspace (c) || c == '/' || c == '>' || c == '=')
+			break;
+		scanner->position++;
+	}
+
+	return scanner->position - start;
+}
+
+/* Scans the tag whose name starts at the current position, up to its closing '>'. Returns the value of its Name
+ * attribute in @feature_name, if any. */
+
+static gboolean
+_scan_start_tag (ArvGcXmlScanner *scanner, char **tag_name, char **feature_name, gboolean *is_empty)
+{
+	gsize name_start = scanner->position;
+	gsize name_length;
+
+	*feature_name = NULL;
+	*is_empty = FALSE;
+
+	name_length = _scan_name (scanner);
+	if (name_length == 0)
+		return FALSE;
+
+	*tag_name = g_strndup (scanner->xml + name_start, name_length);
+
+	for (;;) {
+		gsize attribute_start;
+		gsize attribute_length;
+		gsize value_start;
+		char quote;
+
+		_skip_spaces (scanner);
+
+		if (_has_prefix (scanner, "/>")) {
+			scanner->position += 2;
+			*is_empty = TRUE;
+			return TRUE;
+		}
+		if (_has_prefix (scanner, ">")) {
+			scanner->position++;
+			return TRUE;
+		}
+
+		attribute_start = scanner->position;
+		attribute_length = _scan_name (scanner);
+		_skip_spaces (scanner);
+		if (attribute_length == 0 || !_has_prefix (scanner, "="))
+			break;
+		scanner->position++;
+		_skip_spaces (scanner);
+
+		if (scanner->position >= scanner->size)
+			break;
+		quote = scanner->xml[scanner->position];
+		if (quote != '"' && quote != '\'')
+			break;
+		scanner->position++;
+
+		value_start = scanner->position;
+		while (scanner->position < scanner->size && scanner->xml[scanner->position] != quote)
+			scanner->position++;
+		if (scanner->position >= scanner->size)
+			break;
+
+		if (attribute_length == 4 && memcmp (scanner->xml + attribute_start, "Name", 4) == 0) {
+			g_free (*feature_name);
+			*feature_name = g_strndup (scanner->xml + value_start, scanner->position - value_start);
+		}
+
+		scanner->position++;
+	}
+
+	g_clear_pointer (tag_name, g_free);
+	g_clear_pointer (feature_name, g_free);
+
+	return FALSE;
+}
+
+static gboolean
+_scan (ArvGcXmlIndex *index)
+{
+	ArvGcXmlScanner scanner = {index->xml, index->size, 0};
+	ArvGcXmlIndexElement element = {0};
+	guint depth = 0;
+
+	while (_skip_to (&scanner, "<")) {
+		g_autofree char *tag_name = NULL;
+		g_autofree char *feature_name = NULL;
+		gsize tag_start = scanner.position - 1;
+		gboolean is_empty;
+
+		if (_has_prefix (&scanner, "?")) {
+			if (!_skip_to (&scanner, "?>"))
+				return FALSE;
+		} else if (_has_prefix (&scanner, "!--")) {
+			if (!_skip_to (&scanner, "-->"))
+				return FALSE;
+		} else if (_has_prefix (&scanner, "![CDATA[")) {
+			if (!_skip_to (&scanner, "]]>"))
+				return FALSE;
+		} else if (_has_prefix (&scanner, "!")) {
+			/* Entities may be declared in the DTD */
+			return FALSE;
+		} else if (_has_prefix (&scanner, "/")) {
+			if (depth == 0 || !_skip_to (&scanner, ">"))
+				return FALSE;
+
+			depth--;
+			if (depth == 1) {
+				element.end = scanner.position;
+				g_array_append_val (index->elements, element);
+			} else if (depth == 0)
+				return TRUE;
+		} else {
+			if (!_scan_start_tag (&scanner, &tag_name, &feature_name, &is_empty))
+				return FALSE;
+
+			if (depth == 0) {
+				index->root_name = g_strdup (tag_name);
+				index->root_tag_end = scanner.position;
+				index->is_root_empty = is_empty;
+				if (is_empty)
+					return TRUE;
+			} else {
+				if (depth == 1) {
+					element.start = tag_start;
+					element.is_materialized = FALSE;
+				}
+
+				/* Same rule as arv_gc_register_feature_node() callers, the last definition wins */
+				if (feature_name != NULL && strcmp (tag_name, "EnumEntry") != 0) {
+					if (strchr (feature_name, '&') != NULL)
+						return FALSE;
+					g_hash_table_insert (index->names, g_steal_pointer (&feature_name),
+							     GUINT_TO_POINTER (index->elements->len));
+				}
+
+				if (depth == 1 && is_empty) {
+					element.end = scanner.position;
+					g_array_append_val (index->elements, element);
+				}
+			}
+
+			if (!is_empty)
+				depth++;
+		}
+	}
+
+	return FALSE;
+}
+
+/* @xml is copied. Returns %NULL if @xml can not be indexed. */
+
+ArvGcXmlIndex *
+arv_gc_xml_index_new (const char *xml, size_t size)
+{
+	ArvGcXmlIndex *index;
+
+	g_return_val_if_fail (xml != NULL, NULL);
+
+	index = g_new0 (ArvGcXmlIndex, 1);
+	index->xml = g_strndup (xml, size);
+	index->size = strlen (index->xml);
+	index->elements = g_array_new (FALSE, FALSE, sizeof (ArvGcXmlIndexElement));
+	index->names = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+
+	if (!_scan (index) || index->root_name == NULL) {
+		arv_info_genicam ("[GcXmlIndex::new] Document can not be indexed");
+		arv_gc_xml_index_free (index);
+		return NULL;
+	}
+
+	arv_info_genicam ("[GcXmlIndex::new] %u top-level elements, %u features",
+			  index->elements->len, g_hash_table_size (index->names));
+
+	return index;
+}
+
+void
+arv_gc_xml_index_free (ArvGcXmlIndex *index)
+{
+	if (index == NULL)
+		return;
+
+	g_free (index->xml);
+	g_free (index->root_name);
+	g_array_unref (index->elements);
+	g_hash_table_unref (index->names);
+	g_free (index);
+}
+
+/* Parses the document without the top-level subtrees */
+
+ArvDomDocument *
+arv_gc_xml_index_new_document (ArvGcXmlIndex *index)
+{
+	g_autofree char *root = NULL;
+
+	g_return_val_if_fail (index != NULL, NULL);
+
+	if (index->is_root_empty)
+		root = g_strndup (index->xml, index->root_tag_end);
+	else
+		root = g_strdup_printf ("%.*s</%s>", (int) index->root_tag_end, index->xml, index->root_name);
+
+	return arv_dom_document_new_from_memory (root, -1, NULL);
+}
+
+/* Parses the top-level subtree defining the feature @name, if not already done. Returns %TRUE if new nodes were
+ * created. */
+
+gboolean
+arv_gc_xml_index_materialize_node (ArvGcXmlIndex *index, ArvDomDocument *document, ArvDomNode *root,
+				   const char *name)
+{
+	ArvGcXmlIndexElement *element;
+	gpointer element_index;
+	GError *error = NULL;
+
+	g_return_val_if_fail (index != NULL, FALSE);
+	g_return_val_if_fail (name != NULL, FALSE);
+
+	if (!g_hash_table_lookup_extended (index->names, name, NULL, &element_index))
+		return FALSE;
+
+	element = &g_array_index (index->elements, ArvGcXmlIndexElement, GPOINTER_TO_UINT (element_index));
+	if (element->is_materialized)
+		return FALSE;
+
+	/* Set first, the creation of the subtree may look up other features */
+	element->is_materialized = TRUE;
+
+	arv_debug_genicam ("[GcXmlIndex::materialize_node] Parse subtree at %" G_GSIZE_FORMAT " for '%s'",
+			   element->start, name);
+
+	arv_dom_document_append_from_memory (document, root, index->xml + element->start,
+					     element->end - element->start, &error);
+	if (error != NULL) {
+		arv_warning_genicam ("[GcXmlIndex::materialize_node] Failed to parse '%s' subtree: %s",
+				     name, error->message);
+		g_clear_error (&error);
+	}
+
+	return TRUE;
+}
@@ -0,0 +1,345 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2019 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel@gnome.org>
+ */
+
+/*< private >
+ * SECTION: arvgenicamcache
+ * @short_description: On-disk GenICam data cache
+ *
+ * An opt-in cache of the uncompressed GenICam data of the devices, enabled by arv_enable_genicam_cache(). Each entry
+ * is a file, named after a SHA-1 key built from the device vendor, model and version, and from an identifier of the
+ * device GenICam data, like its URL or its manifest entry. A hit saves the download and the decompression of the
+ * data. The binary snapshots of the GenICam DOM trees are cached the same way, keyed by the SHA-1 of the data, and
+ * mapped in memory when used. The last working GigE Vision stream packet sizes are also kept there, keyed by the
+ * interface, device and stream channel, and so are the last known GigE Vision device addresses, keyed by the device
+ * id used at opening. The GenICam data successfully validated against an XML schema are recorded
+ * by the SHA-1 of the data, along with an identifier of the schema.
+ */
+
+#include <arvgenicamcacheprivate.h>
+#include <arvdebugprivate.h>
+#include <glib/gstdio.h>
+#include <string.h>
+
+static GMutex arv_genicam_cache_mutex;
+static char *arv_genicam_cache_directory = NULL;
+
+/* A NULL @directory disables the cache */
+
+void
+arv_genicam_cache_set_directory (const char *directory)
+{
+	g_mutex_lock (&arv_genicam_cache_mutex);
+	g_free (arv_genicam_cache_directory);
+	arv_genicam_cache_directory = g_strdup (directory);
+	g_mutex_unlock (&arv_genicam_cache_mutex);
+}
+
+gboolean
+arv_genicam_cache_is_enabled (void)
+{
+	gboolean is_enabled;
+
+	g_mutex_lock (&arv_genicam_cache_mutex);
+	is_enabled = arv_genicam_cache_directory != NULL;
+	g_mutex_unlock (&arv_genicam_cache_mutex);
+
+	return is_enabled;
+}
+
+static char *
+_get_filename (const char *key, const char *extension)
+{
+	char *filename = NULL;
+
+	g_mutex_lock (&arv_genicam_cache_mutex);
+	if (arv_genicam_cache_directory != NULL) {
+		g_autofree char *basename = g_strdup_printf ("%s.%s", key, extension);
+
+		filename = g_build_filename (arv_genicam_cache_directory, basename, NULL);
+	}
+	g_mutex_unlock (&arv_genicam_cache_mutex);
+
+	return filename;
+}
+
+/* @xml_id must change with the GenICam data of the device, and is typically its URL or its manifest entry */
+
+char *
+arv_genicam_cache_build_key (const char *vendor, const char *model, const char *device_version, const char *xml_id)
+{
+	GChecksum *checksum;
+	char *key;
+
+	g_return_val_if_fail (xml_id != NULL, NULL);
+
+	checksum = g_checksum_new (G_CHECKSUM_SHA1);
+
+	g_checksum_update (checksum, (const guchar *) (vendor != NULL ? vendor : ""), -1);
+	g_checksum_update (checksum, (const guchar *) "\n", 1);
+	g_checksum_update (checksum, (const guchar *) (model != NULL ? model : ""), -1);
+	g_checksum_update (checksum, (const guchar *) "\n", 1);
+	g_checksum_update (checksum, (const guchar *) (device_version != NULL ? device_version : ""), -1);
+	g_checksum_update (checksum, (const guchar *) "\n", 1);
+	g_checksum_update (checksum, (const guchar *) xml_id, -1);
+
+	key = g_strdup (g_checksum_get_string (checksum));
+
+	g_checksum_free (checksum);
+
+	return key;
+}
+
+/* Returns the cached data for @key, or %NULL if the cache is disabled or does not contain the data */
+
+char *
+arv_genicam_cache_load (const char *key, size_t *size)
+{
+	g_autofree char *filename = NULL;
+	char *xml = NULL;
+	gsize length;
+
+	g_return_val_if_fail (size != NULL, NULL);
+
+	*size = 0;
+
+	if (key == NULL)
+		return NULL;
+
+	filename = _get_filename (key, "xml");
+	if (filename == NULL)
+		return NULL;
+
+	if (!g_file_get_contents (filename, &xml, &length, NULL)) {
+		arv_debug_misc ("[GenicamCache::load] Miss for '%s'", key);
+		return NULL;
+	}
+
+	arv_info_misc ("[GenicamCache::load] Hit for '%s' (%" G_GSIZE_FORMAT " bytes)", key, length);
+
+	*size = length;
+
+	return xml;
+}
+
+static void
+_store (const char *key, const char *extension, const char *data, size_t size)
+{
+	g_autofree char *filename = NULL;
+	g_autofree char *directory = NULL;
+	GError *error = NULL;
+
+	if (key == NULL || data == NULL || size == 0)
+		return;
+
+	filename = _get_filename (key, extension);
+	if (filename == NULL)
+		return;
+
+	directory = g_path_get_dirname (filename);
+	if (g_mkdir_with_parents (directory, 0700) != 0) {
+		arv_warning_misc ("[GenicamCache::store] Failed to create '%s'", directory);
+		return;
+	}
+
+	/* Atomic, concurrent readers see either no file or the complete data */
+	if (!g_file_set_contents (filename, data, size, &error)) {
+		arv_warning_misc ("[GenicamCache::store] Failed to write '%s': %s", filename, error->message);
+		g_clear_error (&error);
+		return;
+	}
+
+	arv_info_misc ("[GenicamCache::store] Stored '%s.%s' (%" G_GSIZE_FORMAT " bytes)", key, extension, size);
+}
+
+void
+arv_genicam_cache_store (const char *key, const char *xml, size_t size)
+{
+	_store (key, "xml", xml, size);
+}
+
+/* Returns a read-only mapping of the cached snapshot for @key, or %NULL if the cache is disabled or does not contain
+ * it */
+
+GBytes *
+arv_genicam_cache_map_snapshot (const char *key)
+{
+	g_autofree char *filename = NULL;
+	GMappedFile *file;
+	GBytes *bytes;
+
+	if (key == NULL)
+		return NULL;
+
+	filename = _get_filename (key, "arvgc");
+	if (filename == NULL)
+		return NULL;
+
+	file = g_mapped_file_new (filename, FALSE, NULL);
+	if (file == NULL) {
+		arv_debug_misc ("[GenicamCache::map_snapshot] Miss for '%s'", key);
+		return NULL;
+	}
+
+	bytes = g_mapped_file_get_bytes (file);
+	g_mapped_file_unref (file);
+
+	arv_info_misc ("[GenicamCache::map_snapshot] Hit for '%s'", key);
+
+	return bytes;
+}
+
+void
+arv_genicam_cache_store_snapshot (const char *key, GBytes *snapshot)
+{
+	gsize size;
+	const char *data;
+
+	if (snapshot == NULL)
+		return;
+
+	data = g_bytes_get_data (snapshot, &size);
+
+	_store (key, "arvgc", data, size);
+}
+
+/* Returns the cached packet size for @key, or 0 if the cache is disabled or does not contain it */
+
+guint
+arv_genicam_cache_load_packet_size (const char *key)
+{
+	g_autofree char *filename = NULL;
+	g_autofree char *data = NULL;
+	guint64 packet_size;
+
+	if (key == NULL)
+		return 0;
+
+	filename = _get_filename (key, "packet-size");
+	if (filename == NULL)
+		return 0;
+
+	if (!g_file_get_contents (filename, &data, NULL, NULL)) {
+		arv_debug_misc ("[GenicamCache::load_packet_size] Miss for '%s'", key);
+		return 0;
+	}
+
+	packet_size = g_ascii_strtoull (data, NULL, 10);
+	if (packet_size > G_MAXUINT)
+		return 0;
+
+	arv_info_misc ("[GenicamCache::load_packet_size] Hit for '%s' (%" G_GUINT64_FORMAT " bytes)", key, packet_size);
+
+	return packet_size;
+}
+
+void
+arv_genicam_cache_store_packet_size (const char *key, guint packet_size)
+{
+	g_autofree char *data = NULL;
+
+	if (packet_size == 0)
+		return;
+
+	data = g_strdup_printf ("%u\n", packet_size);
+
+	_store (key, "packet-size", data, strlen (data));
+}
+
+/* Returns the cached device address entry for @key, or %NULL if the cache is disabled or does not contain it. The
+ * entry is opaque to the cache. */
+
+char *
+arv_genicam_cache_load_device_address (const char *key)
+{
+	g_autofree char *filename = NULL;
+	char *data = NULL;
+
+	if (key == NULL)
+		return NULL;
+
+	filename = _get_filename (key, "address");
+	if (filename == NULL)
+		return NULL;
+
+	if (!g_file_get_contents (filename, &data, NULL, NULL)) {
+		arv_debug_misc ("[GenicamCache::load_device_address] Miss for '%s'", key);
+		return NULL;
+	}
+
+	arv_info_misc ("[GenicamCache::load_device_address] Hit for '%s'", key);
+
+	return g_strchomp (data);
+}
+
+void
+arv_genicam_cache_store_device_address (const char *key, const char *entry)
+{
+	g_autofree char *data = NULL;
+
+	if (entry == NULL)
+		return;
+
+	data = g_strdup_printf ("%s\n", entry);
+
+	_store (key, "address", data, strlen (data));
+}
+
+/* Returns %TRUE if the data of SHA-1 @key were successfully validated against the schema identified by @schema_id */
+
+gboolean
+arv_genicam_cache_is_validated (const char *key, const char *schema_id)
+{
+	g_autofree char *filename = NULL;
+	g_autofree char *data = NULL;
+	gboolean is_validated;
+
+	if (key == NULL || schema_id == NULL)
+		return FALSE;
+
+	filename = _get_filename (key, "validated");
+	if (filename == NULL)
+		return FALSE;
+
+	if (!g_file_get_contents (filename, &data, NULL, NULL)) {
+		arv_debug_misc ("[GenicamCache::is_validated] Miss for '%s'", key);
+		return FALSE;
+	}
+
+	is_validated = g_strcmp0 (g_strchomp (data), schema_id) == 0;
+
+	arv_info_misc ("[GenicamCache::is_validated] %s for '%s'", is_validated ? "Hit" : "Other schema", key);
+
+	return is_validated;
+}
+
+void
+arv_genicam_cache_store_validation (const char *key, const char *schema_id)
+{
+	g_autofree char *data = NULL;
+
+	if (schema_id == NULL)
+		return;
+
+	data = g_strdup_printf ("%s\n", schema_id);
+
+	_store (key, "validated", data, strlen (data));
+}
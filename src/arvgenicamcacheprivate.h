@@ -0,0 +1,56 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2019 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel@gnome.org>
+ */
+
+#ifndef ARV_GENICAM_CACHE_PRIVATE_H
+#define ARV_GENICAM_CACHE_PRIVATE_H
+
+#if !defined (ARV_H_INSIDE) && !defined (ARAVIS_COMPILATION)
+#error "Only <arv.h> can be included directly."
+#endif
+
+#include <arvtypes.h>
+
+G_BEGIN_DECLS
+
+void		arv_genicam_cache_set_directory		(const char *directory);
+gboolean	arv_genicam_cache_is_enabled		(void);
+
+char *		arv_genicam_cache_build_key		(const char *vendor, const char *model,
+							 const char *device_version, const char *xml_id);
+char *		arv_genicam_cache_load			(const char *key, size_t *size);
+void		arv_genicam_cache_store			(const char *key, const char *xml, size_t size);
+
+GBytes *	arv_genicam_cache_map_snapshot		(const char *key);
+void		arv_genicam_cache_store_snapshot	(const char *key, GBytes *snapshot);
+
+guint		arv_genicam_cache_load_packet_size	(const char *key);
+void		arv_genicam_cache_store_packet_size	(const char *key, guint packet_size);
+
+char *		arv_genicam_cache_load_device_address	(const char *key);
+void		arv_genicam_cache_store_device_address	(const char *key, const char *entry);
+
+gboolean	arv_genicam_cache_is_validated		(const char *key, const char *schema_id);
+void		arv_genicam_cache_store_validation	(const char *key, const char *schema_id);
+
+G_END_DECLS
+
+#endif
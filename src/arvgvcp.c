@@ -198,23 +198,50 @@ ArvGvcpPacket *
 arv_gvcp_packet_new_read_register_cmd (guint32 address,
 				       guint16 packet_id,
 				       size_t *packet_size)
+{
+	return arv_gvcp_packet_new_read_registers_cmd (&address, 1, packet_id, packet_size);
+}
+
+/**
+ * arv_gvcp_packet_new_read_registers_cmd: (skip)
+ * @addresses: (array length=n_addresses): read addresses
+ * @n_addresses: number of addresses, at most %ARV_GVCP_N_READ_REGISTERS_MAX
+ * @packet_id: packet id
+ * @packet_size: (out): packet size, in bytes
+ * Return value: (transfer full): a new #ArvGvcpPacket
+ *
+ * Create a gvcp packet for a multiple register read command.
+ *
+ * Since: 0.8.11
+ */
+
+ArvGvcpPacket *
+arv_gvcp_packet_new_read_registers_cmd (const guint32 *addresses, guint n_addresses,
+					guint16 packet_id,
+					size_t *packet_size)
 {
 	ArvGvcpPacket *packet;
-	guint32 n_address = g_htonl (address);
+	guint i;
 
+	g_return_val_if_fail (addresses != NULL, NULL);
+	g_return_val_if_fail (n_addresses > 0 && n_addresses <= ARV_GVCP_N_READ_REGISTERS_MAX, NULL);
 	g_return_val_if_fail (packet_size != NULL, NULL);
 
-	*packet_size = sizeof (ArvGvcpHeader) + sizeof (guint32);
+	*packet_size = sizeof (ArvGvcpHeader) + n_addresses * sizeof (guint32);
 
 	packet = g_malloc (*packet_size);
 
 	packet->header.packet_type = ARV_GVCP_PACKET_TYPE_CMD;
 	packet->header.packet_flags = ARV_GVCP_CMD_PACKET_FLAGS_ACK_REQUIRED;
 	packet->header.command = g_htons (ARV_GVCP_COMMAND_READ_REGISTER_CMD);
-	packet->header.size = g_htons (sizeof (guint32));
+	packet->header.size = g_htons (n_addresses * sizeof (guint32));
 	packet->header.id = g_htons (packet_id);
 
-	memcpy (&packet->data, &n_address, sizeof (guint32));
+	for (i = 0; i < n_addresses; i++) {
+		guint32 n_address = g_htonl (addresses[i]);
+
+		memcpy (&packet->data[i * sizeof (guint32)], &n_address, sizeof (guint32));
+	}
 
 	return packet;
 }
@@ -233,23 +260,50 @@ ArvGvcpPacket *
 arv_gvcp_packet_new_read_register_ack (guint32 value,
 				       guint16 packet_id,
 				       size_t *packet_size)
+{
+	return arv_gvcp_packet_new_read_registers_ack (&value, 1, packet_id, packet_size);
+}
+
+/**
+ * arv_gvcp_packet_new_read_registers_ack: (skip)
+ * @values: (array length=n_values): read values
+ * @n_values: number of values
+ * @packet_id: packet id
+ * @packet_size: (out): packet size, in bytes
+ * Return value: (transfer full): a new #ArvGvcpPacket
+ *
+ * Create a gvcp packet for a multiple register read acknowledge.
+ *
+ * Since: 0.8.11
+ */
+
+ArvGvcpPacket *
+arv_gvcp_packet_new_read_registers_ack (const guint32 *values, guint n_values,
+					guint16 packet_id,
+					size_t *packet_size)
 {
 	ArvGvcpPacket *packet;
-	guint32 n_value = g_htonl (value);
+	guint i;
 
+	g_return_val_if_fail (values != NULL, NULL);
+	g_return_val_if_fail (n_values > 0 && n_values <= ARV_GVCP_N_READ_REGISTERS_MAX, NULL);
 	g_return_val_if_fail (packet_size != NULL, NULL);
 
-	*packet_size = arv_gvcp_packet_get_read_register_ack_size ();
+	*packet_size = arv_gvcp_packet_get_read_registers_ack_size (n_values);
 
 	packet = g_malloc (*packet_size);
 
 	packet->header.packet_type = ARV_GVCP_PACKET_TYPE_ACK;
 	packet->header.packet_flags = 0;
 	packet->header.command = g_htons (ARV_GVCP_COMMAND_READ_REGISTER_ACK);
-	packet->header.size = g_htons (sizeof (guint32));
+	packet->header.size = g_htons (n_values * sizeof (guint32));
 	packet->header.id = g_htons (packet_id);
 
-	memcpy (&packet->data, &n_value, sizeof (guint32));
+	for (i = 0; i < n_values; i++) {
+		guint32 n_value = g_htonl (values[i]);
+
+		memcpy (&packet->data[i * sizeof (guint32)], &n_value, sizeof (guint32));
+	}
 
 	return packet;
 }
@@ -270,25 +324,57 @@ arv_gvcp_packet_new_write_register_cmd (guint32 address,
 					guint32 value,
 					guint16 packet_id,
 					size_t *packet_size)
+{
+	return arv_gvcp_packet_new_write_registers_cmd (&address, &value, 1, packet_id, packet_size);
+}
+
+/**
+ * arv_gvcp_packet_new_write_registers_cmd: (skip)
+ * @addresses: (array length=n_registers): write addresses
+ * @values: (array length=n_registers): values to write
+ * @n_registers: number of registers, at most %ARV_GVCP_N_WRITE_REGISTERS_MAX
+ * @packet_id: packet id
+ * @packet_size: (out): packet size, in bytes
+ * Return value: (transfer full): a new #ArvGvcpPacket
+ *
+ * Create a gvcp packet for a multiple register write command. The device writes the registers in order, and stops at
+ * the first failure.
+ *
+ * Since: 0.8.11
+ */
+
+ArvGvcpPacket *
+arv_gvcp_packet_new_write_registers_cmd (const guint32 *addresses,
+					 const guint32 *values,
+					 guint n_registers,
+					 guint16 packet_id,
+					 size_t *packet_size)
 {
 	ArvGvcpPacket *packet;
-	guint32 n_address = g_htonl (address);
-	guint32 n_value = g_htonl (value);
+	guint i;
 
+	g_return_val_if_fail (addresses != NULL, NULL);
+	g_return_val_if_fail (values != NULL, NULL);
+	g_return_val_if_fail (n_registers > 0 && n_registers <= ARV_GVCP_N_WRITE_REGISTERS_MAX, NULL);
 	g_return_val_if_fail (packet_size != NULL, NULL);
 
-	*packet_size = sizeof (ArvGvcpHeader) + 2 * sizeof (guint32);
+	*packet_size = sizeof (ArvGvcpHeader) + 2 * n_registers * sizeof (guint32);
 
 	packet = g_malloc (*packet_size);
 
 	packet->header.packet_type = ARV_GVCP_PACKET_TYPE_CMD;
 	packet->header.packet_flags = ARV_GVCP_CMD_PACKET_FLAGS_ACK_REQUIRED;
 	packet->header.command = g_htons (ARV_GVCP_COMMAND_WRITE_REGISTER_CMD);
-	packet->header.size = g_htons (2 * sizeof (guint32));
+	packet->header.size = g_htons (2 * n_registers * sizeof (guint32));
 	packet->header.id = g_htons (packet_id);
 
-	memcpy (&packet->data, &n_address, sizeof (guint32));
-	memcpy (&packet->data[sizeof (guint32)], &n_value, sizeof (guint32));
+	for (i = 0; i < n_registers; i++) {
+		guint32 n_address = g_htonl (addresses[i]);
+		guint32 n_value = g_htonl (values[i]);
+
+		memcpy (&packet->data[2 * i * sizeof (guint32)], &n_address, sizeof (guint32));
+		memcpy (&packet->data[(2 * i + 1) * sizeof (guint32)], &n_value, sizeof (guint32));
+	}
 
 	return packet;
 }
@@ -388,6 +474,7 @@ arv_gvcp_packet_new_discovery_ack (guint16 packet_id, size_t *packet_size)
 
 /**
  * arv_gvcp_packet_new_packet_resend_cmd: (skip)
+ * @channel: stream channel index
  * @frame_id: frame id
  * @first_block: first missing packet
  * @last_block: last missing packet
@@ -401,7 +488,7 @@ arv_gvcp_packet_new_discovery_ack (guint16 packet_id, size_t *packet_size)
  */
 
 ArvGvcpPacket *
-arv_gvcp_packet_new_packet_resend_cmd (guint64 frame_id,
+arv_gvcp_packet_new_packet_resend_cmd (guint16 channel, guint64 frame_id,
 				       guint32 first_block, guint32 last_block,
 				       gboolean extended_ids,
 				       guint16 packet_id, size_t *packet_size)
@@ -424,12 +511,12 @@ arv_gvcp_packet_new_packet_resend_cmd (guint64 frame_id,
 	data = (guint32 *) &packet->data;
 
 	if (extended_ids) {
-		data[0] = 0;
+		data[0] = g_htonl ((guint32) channel << 16);
 		data[1] = g_htonl (first_block);
 		data[2] = g_htonl (last_block);
 		*((guint64 *) &data[3]) = GUINT64_TO_BE (frame_id);
 	} else {
-		data[0] = g_htonl ((guint32) frame_id);
+		data[0] = g_htonl (((guint32) channel << 16) | (frame_id & 0xffff));
 		/* With regular ids, only the 24 bits are valid */
 		data[1] = g_htonl (first_block & ARV_GVSP_PACKET_ID_MASK);
 		data[2] = g_htonl (last_block & ARV_GVSP_PACKET_ID_MASK);
@@ -438,6 +525,281 @@ arv_gvcp_packet_new_packet_resend_cmd (guint64 frame_id,
 	return packet;
 }
 
+/**
+ * arv_gvcp_packet_new_event_cmd: (skip)
+ * @event: event description
+ * @extended_ids: use 64 bit block ids
+ * @packet_id: packet id
+ * @packet_size: (out): packet size, in bytes
+ *
+ * Create a gvcp packet for an event command, or an event data command if @event has data.
+ *
+ * Return value: (transfer full): a new #ArvGvcpPacket
+ */
+
+ArvGvcpPacket *
+arv_gvcp_packet_new_event_cmd (const ArvGvcpEvent *event, gboolean extended_ids,
+			       guint16 packet_id, size_t *packet_size)
+{
+	ArvGvcpPacket *packet;
+	guint8 *data;
+	size_t header_size;
+	size_t event_size;
+
+	g_return_val_if_fail (event != NULL, NULL);
+	g_return_val_if_fail (packet_size != NULL, NULL);
+
+	header_size = extended_ids ? ARV_GVCP_EVENT_EXTENDED_HEADER_SIZE : ARV_GVCP_EVENT_HEADER_SIZE;
+	event_size = header_size + (event->data != NULL ? event->data_size : 0);
+
+	*packet_size = sizeof (ArvGvcpHeader) + event_size;
+
+	packet = g_malloc0 (*packet_size);
+
+	packet->header.packet_type = ARV_GVCP_PACKET_TYPE_CMD;
+	packet->header.packet_flags = ARV_GVCP_CMD_PACKET_FLAGS_ACK_REQUIRED |
+		(extended_ids ? ARV_GVCP_EVENT_PACKET_FLAGS_64BIT_ID : 0);
+	packet->header.command = g_htons (event->data != NULL ?
+					  ARV_GVCP_COMMAND_EVENT_DATA_CMD :
+					  ARV_GVCP_COMMAND_EVENT_CMD);
+	packet->header.size = g_htons (event_size);
+	packet->header.id = g_htons (packet_id);
+
+	data = packet->data;
+
+	*((guint16 *) &data[2]) = g_htons (event->event_id);
+	*((guint16 *) &data[4]) = g_htons (event->stream_channel_index);
+
+	if (extended_ids) {
+		*((guint16 *) &data[0]) = g_htons (event_size);
+		*((guint64 *) &data[8]) = GUINT64_TO_BE (event->block_id);
+		*((guint64 *) &data[16]) = GUINT64_TO_BE (event->timestamp);
+	} else {
+		*((guint16 *) &data[6]) = g_htons (event->block_id);
+		*((guint32 *) &data[8]) = g_htonl (event->timestamp >> 32);
+		*((guint32 *) &data[12]) = g_htonl (event->timestamp & 0xffffffff);
+	}
+
+	if (event->data != NULL)
+		memcpy (&data[header_size], event->data, event->data_size);
+
+	return packet;
+}
+
+/**
+ * arv_gvcp_packet_new_event_ack: (skip)
+ * @event_packet: the acknowledged event or event data command
+ * @packet_size: (out): packet size, in bytes
+ *
+ * Create a gvcp packet for an event acknowledge.
+ *
+ * Return value: (transfer full): a new #ArvGvcpPacket
+ */
+
+ArvGvcpPacket *
+arv_gvcp_packet_new_event_ack (const ArvGvcpPacket *event_packet, size_t *packet_size)
+{
+	ArvGvcpPacket *packet;
+
+	g_return_val_if_fail (event_packet != NULL, NULL);
+	g_return_val_if_fail (packet_size != NULL, NULL);
+
+	*packet_size = sizeof (ArvGvcpHeader);
+
+	packet = g_malloc (*packet_size);
+
+	packet->header.packet_type = ARV_GVCP_PACKET_TYPE_ACK;
+	packet->header.packet_flags = 0;
+	packet->header.command = g_htons (g_ntohs (event_packet->header.command) == ARV_GVCP_COMMAND_EVENT_DATA_CMD ?
+					  ARV_GVCP_COMMAND_EVENT_DATA_ACK :
+					  ARV_GVCP_COMMAND_EVENT_ACK);
+	packet->header.size = g_htons (0x0000);
+	packet->header.id = event_packet->header.id;
+
+	return packet;
+}
+
+/**
+ * arv_gvcp_packet_new_action_cmd: (skip)
+ * @device_key: device key, matched against the ActionDeviceKey of the devices
+ * @group_key: group key, matched against the ActionGroupKey of the devices
+ * @group_mask: group mask, bitwise ANDed with the ActionGroupMask of the devices
+ * @action_time_ns: action time, in device timestamp units, or 0 for an immediate action
+ * @ack_required: request an acknowledge from the devices
+ * @packet_id: packet id
+ * @packet_size: (out): packet size, in bytes
+ *
+ * Create a gvcp packet for an action command. If @action_time_ns is not 0, the action is scheduled, and the devices
+ * will wait until their timestamp counter reaches @action_time_ns before executing it.
+ *
+ * Return value: (transfer full): a new #ArvGvcpPacket
+ */
+
+ArvGvcpPacket *
+arv_gvcp_packet_new_action_cmd (guint32 device_key, guint32 group_key, guint32 group_mask,
+				guint64 action_time_ns, gboolean ack_required,
+				guint16 packet_id, size_t *packet_size)
+{
+	ArvGvcpPacket *packet;
+	guint32 *data;
+	size_t data_size;
+
+	g_return_val_if_fail (packet_size != NULL, NULL);
+
+	data_size = 3 * sizeof (guint32) + (action_time_ns != 0 ? sizeof (guint64) : 0);
+
+	*packet_size = sizeof (ArvGvcpHeader) + data_size;
+
+	packet = g_malloc (*packet_size);
+
+	packet->header.packet_type = ARV_GVCP_PACKET_TYPE_CMD;
+	packet->header.packet_flags = (ack_required ? ARV_GVCP_CMD_PACKET_FLAGS_ACK_REQUIRED : 0) |
+		(action_time_ns != 0 ? ARV_GVCP_ACTION_PACKET_FLAGS_SCHEDULED : 0);
+	packet->header.command = g_htons (ARV_GVCP_COMMAND_ACTION_CMD);
+	packet->header.size = g_htons (data_size);
+	packet->header.id = g_htons (packet_id);
+
+	data = (guint32 *) &packet->data;
+
+	data[0] = g_htonl (device_key);
+	data[1] = g_htonl (group_key);
+	data[2] = g_htonl (group_mask);
+
+	if (action_time_ns != 0) {
+		data[3] = g_htonl (action_time_ns >> 32);
+		data[4] = g_htonl (action_time_ns & 0xffffffff);
+	}
+
+	return packet;
+}
+
+/**
+ * arv_gvcp_packet_new_action_ack: (skip)
+ * @packet_id: packet id
+ * @packet_size: (out): packet size, in bytes
+ *
+ * Create a gvcp packet for an action acknowledge.
+ *
+ * Return value: (transfer full): a new #ArvGvcpPacket
+ */
+
+ArvGvcpPacket *
+arv_gvcp_packet_new_action_ack (guint16 packet_id, size_t *packet_size)
+{
+	ArvGvcpPacket *packet;
+
+	g_return_val_if_fail (packet_size != NULL, NULL);
+
+	*packet_size = sizeof (ArvGvcpHeader);
+
+	packet = g_malloc (*packet_size);
+
+	packet->header.packet_type = ARV_GVCP_PACKET_TYPE_ACK;
+	packet->header.packet_flags = 0;
+	packet->header.command = g_htons (ARV_GVCP_COMMAND_ACTION_ACK);
+	packet->header.size = g_htons (0x0000);
+	packet->header.id = g_htons (packet_id);
+
+	return packet;
+}
+
+/**
+ * arv_gvcp_packet_new_pending_ack: (skip)
+ * @packet_id: packet id of the pending command
+ * @timeout_ms: time to completion of the command, in ms
+ * @packet_size: (out): packet size, in bytes
+ *
+ * Create a gvcp packet telling the command @packet_id will be acknowledged in less than @timeout_ms.
+ *
+ * Return value: (transfer full): a new #ArvGvcpPacket
+ */
+
+ArvGvcpPacket *
+arv_gvcp_packet_new_pending_ack (guint16 packet_id, guint16 timeout_ms, size_t *packet_size)
+{
+	ArvGvcpPacket *packet;
+	guint32 n_timeout;
+
+	g_return_val_if_fail (packet_size != NULL, NULL);
+
+	*packet_size = arv_gvcp_packet_get_pending_ack_size ();
+
+	packet = g_malloc (*packet_size);
+
+	packet->header.packet_type = ARV_GVCP_PACKET_TYPE_ACK;
+	packet->header.packet_flags = 0;
+	packet->header.command = g_htons (ARV_GVCP_COMMAND_PENDING_ACK);
+	packet->header.size = g_htons (sizeof (guint32));
+	packet->header.id = g_htons (packet_id);
+
+	/* Reserved 16 bits, followed by the time to completion */
+	n_timeout = g_htonl (timeout_ms);
+	memcpy (&packet->data, &n_timeout, sizeof (guint32));
+
+	return packet;
+}
+
+/**
+ * arv_gvcp_packet_get_event: (skip)
+ * @packet: an event or event data command
+ * @offset: offset of the event in the packet data, 0 for the first one
+ * @event: (out): event placeholder
+ *
+ * Decodes an event of @packet. An event command may hold several events, which are retrieved by calling this
+ * function with the returned offset, until it returns 0. An event data command holds only one event.
+ *
+ * Return value: the offset of the next event, or 0 if there is no more valid event.
+ */
+
+size_t
+arv_gvcp_packet_get_event (const ArvGvcpPacket *packet, size_t offset, ArvGvcpEvent *event)
+{
+	const guint8 *data;
+	gboolean extended_ids;
+	size_t header_size;
+	size_t event_size;
+	size_t size;
+
+	g_return_val_if_fail (packet != NULL, 0);
+	g_return_val_if_fail (event != NULL, 0);
+
+	size = g_ntohs (packet->header.size);
+	extended_ids = (packet->header.packet_flags & ARV_GVCP_EVENT_PACKET_FLAGS_64BIT_ID) != 0;
+	header_size = extended_ids ? ARV_GVCP_EVENT_EXTENDED_HEADER_SIZE : ARV_GVCP_EVENT_HEADER_SIZE;
+
+	if (offset + header_size > size)
+		return 0;
+
+	data = packet->data + offset;
+
+	if (extended_ids)
+		event_size = g_ntohs (*((guint16 *) &data[0]));
+	else if (g_ntohs (packet->header.command) == ARV_GVCP_COMMAND_EVENT_DATA_CMD)
+		event_size = size - offset;
+	else
+		event_size = header_size;
+
+	if (event_size < header_size || offset + event_size > size)
+		return 0;
+
+	event->event_id = g_ntohs (*((guint16 *) &data[2]));
+	event->stream_channel_index = g_ntohs (*((guint16 *) &data[4]));
+
+	if (extended_ids) {
+		event->block_id = GUINT64_FROM_BE (*((guint64 *) &data[8]));
+		event->timestamp = GUINT64_FROM_BE (*((guint64 *) &data[16]));
+	} else {
+		event->block_id = g_ntohs (*((guint16 *) &data[6]));
+		event->timestamp = ((guint64) g_ntohl (*((guint32 *) &data[8])) << 32) |
+			g_ntohl (*((guint32 *) &data[12]));
+	}
+
+	event->data = event_size > header_size ? &data[header_size] : NULL;
+	event->data_size = event_size - header_size;
+
+	return offset + event_size;
+}
+
 static const char *
 arv_enum_to_string (GType type,
 		    guint enum_value)
@@ -490,9 +852,11 @@ arv_gvcp_packet_flags_to_string_new (ArvGvcpCommand command, guint8 flags)
 	unsigned i;
 
 	for (i = 0; i < 8; i++) {
-		if ((1 << i) & flags)
-			g_string_append_printf (string, "%s%s", string->len > 0 ? " " : "",
-						arv_enum_to_string (ARV_TYPE_GVCP_CMD_PACKET_FLAGS, 1 << i));
+		const char *name = arv_enum_to_string (ARV_TYPE_GVCP_CMD_PACKET_FLAGS, 1 << i);
+
+		/* Command specific flags are named below */
+		if (((1 << i) & flags) && name != NULL)
+			g_string_append_printf (string, "%s%s", string->len > 0 ? " " : "", name);
 	}
 
 	switch (command) {
@@ -504,12 +868,21 @@ arv_gvcp_packet_flags_to_string_new (ArvGvcpCommand command, guint8 flags)
 			}
 			break;
 		case ARV_GVCP_COMMAND_PACKET_RESEND_CMD:
+		case ARV_GVCP_COMMAND_EVENT_CMD:
+		case ARV_GVCP_COMMAND_EVENT_DATA_CMD:
 			for (i = 0; i < 8; i++) {
 				if ((1 << i) & flags)
 					g_string_append_printf (string, "%s%s", string->len > 0 ? " " : "",
 								arv_enum_to_string (ARV_TYPE_GVCP_EVENT_PACKET_FLAGS, 1 << i));
 			}
 			break;
+		case ARV_GVCP_COMMAND_ACTION_CMD:
+			for (i = 0; i < 8; i++) {
+				if ((1 << i) & flags)
+					g_string_append_printf (string, "%s%s", string->len > 0 ? " " : "",
+								arv_enum_to_string (ARV_TYPE_GVCP_ACTION_PACKET_FLAGS, 1 << i));
+			}
+			break;
 		default:
 			break;
 	}
@@ -575,6 +948,7 @@ arv_gvcp_packet_to_string (const ArvGvcpPacket *packet)
 	char *data;
 	int packet_size;
 	guint32 value;
+	guint i;
 
 	g_return_val_if_fail (packet != NULL, NULL);
 
@@ -621,12 +995,14 @@ arv_gvcp_packet_to_string (const ArvGvcpPacket *packet)
 						data[ARV_GVBS_CURRENT_IP_ADDRESS_OFFSET + 3] & 0xff);
 			break;
 		case ARV_GVCP_COMMAND_WRITE_REGISTER_CMD:
-			value = g_ntohl (*((guint32 *) &data[0]));
-			g_string_append_printf (string, "address      = %10u (0x%08x)\n",
-						value, value);
-			value = g_ntohl (*((guint32 *) &data[4]));
-			g_string_append_printf (string, "value        = %10u (0x%08x)\n",
-						value, value);
+			for (i = 0; i < g_ntohs (packet->header.size) / (2 * sizeof (guint32)); i++) {
+				value = g_ntohl (*((guint32 *) &data[2 * i * sizeof (guint32)]));
+				g_string_append_printf (string, "address      = %10u (0x%08x)\n",
+							value, value);
+				value = g_ntohl (*((guint32 *) &data[(2 * i + 1) * sizeof (guint32)]));
+				g_string_append_printf (string, "value        = %10u (0x%08x)\n",
+							value, value);
+			}
 			break;
 		case ARV_GVCP_COMMAND_WRITE_REGISTER_ACK:
 			value = g_ntohl (*((guint32 *) &data[0]));
@@ -634,14 +1010,18 @@ arv_gvcp_packet_to_string (const ArvGvcpPacket *packet)
 						value, value);
 			break;
 		case ARV_GVCP_COMMAND_READ_REGISTER_CMD:
-			value = g_ntohl (*((guint32 *) &data[0]));
-			g_string_append_printf (string, "address      = %10u (0x%08x)\n",
-						value, value);
+			for (i = 0; i < g_ntohs (packet->header.size) / sizeof (guint32); i++) {
+				value = g_ntohl (*((guint32 *) &data[i * sizeof (guint32)]));
+				g_string_append_printf (string, "address      = %10u (0x%08x)\n",
+							value, value);
+			}
 			break;
 		case ARV_GVCP_COMMAND_READ_REGISTER_ACK:
-			value = g_ntohl (*((guint32 *) &data[0]));
-			g_string_append_printf (string, "value        = %10u (0x%08x)\n",
-						value, value);
+			for (i = 0; i < g_ntohs (packet->header.size) / sizeof (guint32); i++) {
+				value = g_ntohl (*((guint32 *) &data[i * sizeof (guint32)]));
+				g_string_append_printf (string, "value        = %10u (0x%08x)\n",
+							value, value);
+			}
 			break;
 		case ARV_GVCP_COMMAND_READ_MEMORY_CMD:
 			value = g_ntohl (*((guint32 *) &data[0]));
@@ -656,6 +1036,40 @@ arv_gvcp_packet_to_string (const ArvGvcpPacket *packet)
 			g_string_append_printf (string, "address      = %10u (0x%08x)\n",
 						value, value);
 			break;
+		case ARV_GVCP_COMMAND_EVENT_CMD:
+		case ARV_GVCP_COMMAND_EVENT_DATA_CMD:
+			{
+				ArvGvcpEvent event;
+				size_t offset = 0;
+
+				while ((offset = arv_gvcp_packet_get_event (packet, offset, &event)) > 0) {
+					g_string_append_printf (string, "event id     = %10u (0x%04x)\n",
+								event.event_id, event.event_id);
+					g_string_append_printf (string, "block id     = %10" G_GUINT64_FORMAT "\n",
+								event.block_id);
+					g_string_append_printf (string, "timestamp    = %10" G_GUINT64_FORMAT "\n",
+								event.timestamp);
+					g_string_append_printf (string, "data size    = %10" G_GSIZE_FORMAT "\n",
+								event.data_size);
+				}
+			}
+			break;
+		case ARV_GVCP_COMMAND_ACTION_CMD:
+			value = g_ntohl (*((guint32 *) &data[0]));
+			g_string_append_printf (string, "device key   = %10u (0x%08x)\n",
+						value, value);
+			value = g_ntohl (*((guint32 *) &data[4]));
+			g_string_append_printf (string, "group key    = %10u (0x%08x)\n",
+						value, value);
+			value = g_ntohl (*((guint32 *) &data[8]));
+			g_string_append_printf (string, "group mask   = %10u (0x%08x)\n",
+						value, value);
+			if ((packet->header.packet_flags & ARV_GVCP_ACTION_PACKET_FLAGS_SCHEDULED) != 0 &&
+			    g_ntohs (packet->header.size) >= 20)
+				g_string_append_printf (string, "action time  = %10" G_GUINT64_FORMAT "\n",
+							((guint64) g_ntohl (*((guint32 *) &data[12])) << 32) |
+							g_ntohl (*((guint32 *) &data[16])));
+			break;
 	}
 
 	packet_size = sizeof (ArvGvcpHeader) + g_ntohs (packet->header.size);
@@ -112,6 +112,8 @@ G_BEGIN_DECLS
 #define ARV_GVBS_GVCP_CAPABILITY_SERIAL_NUMBER			1 << 30
 #define ARV_GVBS_GVCP_CAPABILITY_NAME_REGISTER			1 << 31
 
+#define ARV_GVBS_ACTION_DEVICE_KEY_OFFSET		0x0000090c
+
 #define ARV_GVBS_HEARTBEAT_TIMEOUT_OFFSET		0x00000938
 #define ARV_GVBS_TIMESTAMP_TICK_FREQUENCY_HIGH_OFFSET	0x0000093c
 #define ARV_GVBS_TIMESTAMP_TICK_FREQUENCY_LOW_OFFSET	0x00000940
@@ -123,7 +125,20 @@ G_BEGIN_DECLS
 #define ARV_GVBS_CONTROL_CHANNEL_PRIVILEGE_CONTROL	1 << 1
 #define ARV_GVBS_CONTROL_CHANNEL_PRIVILEGE_EXCLUSIVE	1 << 0
 
+#define ARV_GVBS_MESSAGE_CHANNEL_PORT_OFFSET			0x00000b00
+#define ARV_GVBS_MESSAGE_CHANNEL_PORT_MASK			0x0000ffff
+#define ARV_GVBS_MESSAGE_CHANNEL_DESTINATION_ADDRESS_OFFSET	0x00000b10
+#define ARV_GVBS_MESSAGE_CHANNEL_TRANSMISSION_TIMEOUT_OFFSET	0x00000b14
+#define ARV_GVBS_MESSAGE_CHANNEL_RETRY_COUNT_OFFSET		0x00000b18
+#define ARV_GVBS_MESSAGE_CHANNEL_SOURCE_PORT_OFFSET		0x00000b1c
+
 #define ARV_GVBS_STREAM_CHANNEL_0_PORT_OFFSET		0x00000d00
+#define ARV_GVBS_STREAM_CHANNEL_0_PORT_MASK		0x0000ffff
+#define ARV_GVBS_STREAM_CHANNEL_STRIDE			0x00000040
+
+#define ARV_GVBS_ACTION_GROUP_KEY_0_OFFSET		0x00009800
+#define ARV_GVBS_ACTION_GROUP_MASK_0_OFFSET		0x00009804
+#define ARV_GVBS_ACTION_GROUP_STRIDE			0x00000010
 
 #define ARV_GVBS_STREAM_CHANNEL_0_PACKET_SIZE_OFFSET		0x00000d04
 #define ARV_GVBS_STREAM_CHANNEL_0_PACKET_SIZE_MASK		0x0000ffff
@@ -158,6 +173,11 @@ G_BEGIN_DECLS
 
 #define ARV_GVCP_DATA_SIZE_MAX				512
 
+/* Maximum number of addresses of a single READREG_CMD */
+#define ARV_GVCP_N_READ_REGISTERS_MAX			(ARV_GVCP_DATA_SIZE_MAX / sizeof (guint32))
+/* Maximum number of address/value pairs of a single WRITEREG_CMD */
+#define ARV_GVCP_N_WRITE_REGISTERS_MAX			(ARV_GVCP_DATA_SIZE_MAX / (2 * sizeof (guint32)))
+
 /**
  * ArvGvcpPacketType:
  * @ARV_GVCP_PACKET_TYPE_ACK: acknowledge packet
@@ -252,6 +272,17 @@ typedef enum {
 	ARV_GVCP_EVENT_PACKET_FLAGS_64BIT_ID =			0x10,
 } ArvGvcpEventPacketFlags;
 
+/**
+ * ArvGvcpActionPacketFlags:
+ * @ARV_GVCP_ACTION_PACKET_FLAGS_NONE: no flag defined
+ * @ARV_GVCP_ACTION_PACKET_FLAGS_SCHEDULED: scheduled action, the command carries an action time
+ */
+
+typedef enum {
+	ARV_GVCP_ACTION_PACKET_FLAGS_NONE =			0x00,
+	ARV_GVCP_ACTION_PACKET_FLAGS_SCHEDULED =		0x80,
+} ArvGvcpActionPacketFlags;
+
 /**
  * ArvGvcpDiscoveryPacketFlags:
  * @ARV_GVCP_DISCOVERY_PACKET_FLAGS_NONE: no flag defined
@@ -280,6 +311,12 @@ typedef enum {
  * @ARV_GVCP_COMMAND_WRITE_MEMORY_CMD: write memory command
  * @ARV_GVCP_COMMAND_WRITE_MEMORY_ACK: write memory acknowledge
  * @ARV_GVCP_COMMAND_PENDING_ACK: pending command acknowledge
+ * @ARV_GVCP_COMMAND_EVENT_CMD: event command, sent by the device on the message channel
+ * @ARV_GVCP_COMMAND_EVENT_ACK: event acknowledge
+ * @ARV_GVCP_COMMAND_EVENT_DATA_CMD: event with data command, sent by the device on the message channel
+ * @ARV_GVCP_COMMAND_EVENT_DATA_ACK: event with data acknowledge
+ * @ARV_GVCP_COMMAND_ACTION_CMD: action command, usually broadcasted to several devices
+ * @ARV_GVCP_COMMAND_ACTION_ACK: action acknowledge
  */
 
 typedef enum {
@@ -297,7 +334,13 @@ typedef enum {
 	ARV_GVCP_COMMAND_READ_MEMORY_ACK =	0x0085,
 	ARV_GVCP_COMMAND_WRITE_MEMORY_CMD =	0x0086,
 	ARV_GVCP_COMMAND_WRITE_MEMORY_ACK =	0x0087,
-	ARV_GVCP_COMMAND_PENDING_ACK =		0x0089
+	ARV_GVCP_COMMAND_PENDING_ACK =		0x0089,
+	ARV_GVCP_COMMAND_EVENT_CMD =		0x00c0,
+	ARV_GVCP_COMMAND_EVENT_ACK =		0x00c1,
+	ARV_GVCP_COMMAND_EVENT_DATA_CMD =	0x00c2,
+	ARV_GVCP_COMMAND_EVENT_DATA_ACK =	0x00c3,
+	ARV_GVCP_COMMAND_ACTION_CMD =		0x0100,
+	ARV_GVCP_COMMAND_ACTION_ACK =		0x0101
 } ArvGvcpCommand;
 
 #pragma pack(push,1)
@@ -336,6 +379,31 @@ typedef struct {
 
 #pragma pack(pop)
 
+/* Size of the event headers in EVENT and EVENTDATA commands, with the regular and 64 bit ids */
+#define ARV_GVCP_EVENT_HEADER_SIZE		16
+#define ARV_GVCP_EVENT_EXTENDED_HEADER_SIZE	24
+
+/**
+ * ArvGvcpEvent:
+ * @event_id: event identifier, as declared in the Genicam data
+ * @stream_channel_index: index of the stream channel the event relates to, or 0xffff
+ * @block_id: id of the frame the event relates to, or 0
+ * @timestamp: device timestamp of the event
+ * @data: (nullable): event data, pointing into the packet
+ * @data_size: event data size, in bytes
+ *
+ * Event decoded from an EVENT or EVENTDATA command.
+ */
+
+typedef struct {
+	guint16 event_id;
+	guint16 stream_channel_index;
+	guint64 block_id;
+	guint64 timestamp;
+	const void *data;
+	size_t data_size;
+} ArvGvcpEvent;
+
 void 			arv_gvcp_packet_free 			(ArvGvcpPacket *packet);
 ArvGvcpPacket * 	arv_gvcp_packet_new_read_memory_cmd 	(guint32 address, guint32 size,
 								 guint16 packet_id, size_t *packet_size);
@@ -349,16 +417,33 @@ ArvGvcpPacket * 	arv_gvcp_packet_new_read_register_cmd 	(guint32 address,
 								 guint16 packet_id, size_t *packet_size);
 ArvGvcpPacket * 	arv_gvcp_packet_new_read_register_ack 	(guint32 value,
 								 guint16 packet_id, size_t *packet_size);
+ArvGvcpPacket * 	arv_gvcp_packet_new_read_registers_cmd 	(const guint32 *addresses, guint n_addresses,
+								 guint16 packet_id, size_t *packet_size);
+ArvGvcpPacket * 	arv_gvcp_packet_new_read_registers_ack 	(const guint32 *values, guint n_values,
+								 guint16 packet_id, size_t *packet_size);
 ArvGvcpPacket * 	arv_gvcp_packet_new_write_register_cmd 	(guint32 address, guint32 value,
 								 guint16 packet_id, size_t *packet_size);
 ArvGvcpPacket * 	arv_gvcp_packet_new_write_register_ack 	(guint32 data_index,
 								 guint16 packet_id, size_t *packet_size);
+ArvGvcpPacket * 	arv_gvcp_packet_new_write_registers_cmd	(const guint32 *addresses, const guint32 *values,
+								 guint n_registers,
+								 guint16 packet_id, size_t *packet_size);
 ArvGvcpPacket * 	arv_gvcp_packet_new_discovery_cmd 	(size_t *packet_size);
 ArvGvcpPacket * 	arv_gvcp_packet_new_discovery_ack 	(guint16 packet_id, size_t *packet_size);
-ArvGvcpPacket * 	arv_gvcp_packet_new_packet_resend_cmd 	(guint64 frame_id,
+ArvGvcpPacket * 	arv_gvcp_packet_new_packet_resend_cmd 	(guint16 channel, guint64 frame_id,
 								 guint32 first_block, guint32 last_block,
 								 gboolean extended_ids,
 								 guint16 packet_id, size_t *packet_size);
+ArvGvcpPacket * 	arv_gvcp_packet_new_event_cmd 		(const ArvGvcpEvent *event, gboolean extended_ids,
+								 guint16 packet_id, size_t *packet_size);
+ArvGvcpPacket * 	arv_gvcp_packet_new_event_ack 		(const ArvGvcpPacket *event_packet, size_t *packet_size);
+size_t			arv_gvcp_packet_get_event		(const ArvGvcpPacket *packet, size_t offset,
+								 ArvGvcpEvent *event);
+ArvGvcpPacket * 	arv_gvcp_packet_new_action_cmd 		(guint32 device_key, guint32 group_key, guint32 group_mask,
+								 guint64 action_time_ns, gboolean ack_required,
+								 guint16 packet_id, size_t *packet_size);
+ArvGvcpPacket * 	arv_gvcp_packet_new_action_ack 		(guint16 packet_id, size_t *packet_size);
+ArvGvcpPacket * 	arv_gvcp_packet_new_pending_ack 	(guint16 packet_id, guint16 timeout_ms, size_t *packet_size);
 
 const char *		arv_gvcp_packet_type_to_string 		(ArvGvcpPacketType value);
 const char * 		arv_gvcp_command_to_string 		(ArvGvcpCommand value);
@@ -515,6 +600,36 @@ arv_gvcp_packet_get_read_register_ack_size (void)
 	return sizeof (ArvGvcpHeader) + sizeof (guint32);
 }
 
+static inline guint
+arv_gvcp_packet_get_read_registers_cmd_n_addresses (const ArvGvcpPacket *packet)
+{
+	if (packet == NULL)
+		return 0;
+	return g_ntohs (packet->header.size) / sizeof (guint32);
+}
+
+static inline guint32
+arv_gvcp_packet_get_read_registers_cmd_address (const ArvGvcpPacket *packet, guint index)
+{
+	if (packet == NULL)
+		return 0;
+	return g_ntohl (*((guint32 *) ((char *) packet + sizeof (ArvGvcpPacket) + index * sizeof (guint32))));
+}
+
+static inline guint32
+arv_gvcp_packet_get_read_registers_ack_value (const ArvGvcpPacket *packet, guint index)
+{
+	if (packet == NULL)
+		return 0;
+	return g_ntohl (*((guint32 *) ((char *) packet + sizeof (ArvGvcpPacket) + index * sizeof (guint32))));
+}
+
+static inline size_t
+arv_gvcp_packet_get_read_registers_ack_size (guint n_values)
+{
+	return sizeof (ArvGvcpHeader) + n_values * sizeof (guint32);
+}
+
 static inline void
 arv_gvcp_packet_get_write_register_cmd_infos (const ArvGvcpPacket *packet, guint32 *address, guint32 *value)
 {
@@ -537,6 +652,74 @@ arv_gvcp_packet_get_write_register_ack_size (void)
 	return sizeof (ArvGvcpHeader) + sizeof (guint32);
 }
 
+static inline guint
+arv_gvcp_packet_get_write_registers_cmd_n_registers (const ArvGvcpPacket *packet)
+{
+	if (packet == NULL)
+		return 0;
+	return g_ntohs (packet->header.size) / (2 * sizeof (guint32));
+}
+
+static inline void
+arv_gvcp_packet_get_write_registers_cmd_infos (const ArvGvcpPacket *packet, guint index,
+					       guint32 *address, guint32 *value)
+{
+	if (packet == NULL) {
+		if (address != NULL)
+			*address = 0;
+		if (value != NULL)
+			*value = 0;
+		return;
+	}
+	if (address != NULL)
+		*address = g_ntohl (*((guint32 *) ((char *) packet + sizeof (ArvGvcpPacket) +
+						   2 * index * sizeof (guint32))));
+	if (value != NULL)
+		*value = g_ntohl (*((guint32 *) ((char *) packet + sizeof (ArvGvcpPacket) +
+						 (2 * index + 1) * sizeof (guint32))));
+}
+
+static inline void
+arv_gvcp_packet_get_packet_resend_cmd_infos (const ArvGvcpPacket *packet, guint64 *frame_id,
+					     guint32 *first_block, guint32 *last_block)
+{
+	const guint32 *data;
+	gboolean extended_ids;
+
+	if (packet == NULL) {
+		if (frame_id != NULL)
+			*frame_id = 0;
+		if (first_block != NULL)
+			*first_block = 0;
+		if (last_block != NULL)
+			*last_block = 0;
+		return;
+	}
+
+	data = (const guint32 *) &packet->data;
+	extended_ids = (packet->header.packet_flags & ARV_GVCP_CMD_PACKET_FLAGS_EXTENDED_IDS) != 0;
+
+	if (frame_id != NULL)
+		*frame_id = extended_ids ?
+			GUINT64_FROM_BE (*((guint64 *) &data[3])) :
+			g_ntohl (data[0]) & 0xffff;
+	/* With regular ids, only the 24 bits of the block ids are valid */
+	if (first_block != NULL)
+		*first_block = extended_ids ? g_ntohl (data[1]) : g_ntohl (data[1]) & 0x00ffffff;
+	if (last_block != NULL)
+		*last_block = extended_ids ? g_ntohl (data[2]) : g_ntohl (data[2]) & 0x00ffffff;
+}
+
+/* Number of successful writes, which is also the index of the failed write of an error acknowledge */
+
+static inline guint32
+arv_gvcp_packet_get_write_register_ack_data_index (const ArvGvcpPacket *packet)
+{
+	if (packet == NULL)
+		return 0;
+	return g_ntohl (*((guint32 *) ((char *) packet + sizeof (ArvGvcpPacket)))) & 0xffff;
+}
+
 static inline guint16
 arv_gvcp_next_packet_id (guint16 packet_id)
 {
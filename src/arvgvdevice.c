@@ -36,9 +36,11 @@
 #include <arvgvcpprivate.h>
 #include <arvgvspprivate.h>
 #include <arvnetworkprivate.h>
-#include <arvzip.h>
+#include <arvgenicamcacheprivate.h>
+#include <arvzipprivate.h>
 #include <arvstr.h>
 #include <arvmiscprivate.h>
+#include <arvrealtimeprivate.h>
 #include <arvenumtypes.h>
 #include <string.h>
 #include <stdlib.h>
@@ -70,6 +72,23 @@ typedef struct {
 	unsigned int gvcp_timeout_ms;
 
 	gboolean is_controller;
+	/* Control channel privilege written by the heartbeat */
+	guint32 privilege;
+
+	/* Time of the last acknowledged command, protected by the io mutex */
+	gint64 last_ack_time_us;
+
+	/* In-flight commands, protected by the io mutex */
+	GCond cond;
+	GSList *requests;
+	guint n_requests;
+	guint command_window;
+	gboolean is_receiving;
+	guint read_memory_depth;
+	guint write_memory_depth;
+
+	/* Protected by the io mutex */
+	ArvGvDeviceCommandStatistics statistics;
 } ArvGvDeviceIOData;
 
 typedef struct {
@@ -81,6 +100,9 @@ typedef struct {
 	void *heartbeat_thread;
 	void *heartbeat_data;
 
+	void *event_thread;
+	void *event_data;
+
 	ArvGc *genicam;
 
 	char *genicam_xml;
@@ -94,8 +116,25 @@ typedef struct {
 	ArvGvStreamOption stream_options;
 	ArvGvPacketSizeAdjustment packet_size_adjustment;
 
+	/* Packet resend budget shared by the device streams (stream threads) */
+	GMutex resend_mutex;
+	guint64 packet_resend_bandwidth;
+	gint64 resend_budget;
+	guint64 resend_budget_time_us;
+	/* Time of the last packet resend request, used to back off the feature polling */
+	guint64 resend_request_time_us;
+
+	/* Register writes queued between arv_device_begin_batch() and arv_device_commit_batch () */
+	GMutex batch_mutex;
+	gint batch_active;
+	GArray *batch_addresses;
+	GArray *batch_values;
+
 	gboolean first_stream_created;
 
+	/* Serial number read at creation, used to check the identity of the device on reconnection */
+	char serial_number[ARV_GVBS_SERIAL_NUMBER_SIZE];
+
 	gboolean init_success;
 } ArvGvDevicePrivate ;
 
@@ -109,247 +148,674 @@ struct _ArvGvDeviceClass {
 
 G_DEFINE_TYPE_WITH_CODE (ArvGvDevice, arv_gv_device, ARV_TYPE_DEVICE, G_ADD_PRIVATE (ArvGvDevice))
 
-static gboolean
-_send_cmd_and_receive_ack (ArvGvDeviceIOData *io_data, ArvGvcpCommand command,
-			   guint64 address, size_t size, void *buffer, GError **error)
+enum {
+	ARV_GV_DEVICE_SIGNAL_EVENT,
+	ARV_GV_DEVICE_SIGNAL_LAST
+} ArvGvDeviceSignals;
+
+static guint arv_gv_device_signals[ARV_GV_DEVICE_SIGNAL_LAST] = {0};
+
+const guint64 arv_gv_device_command_latency_bounds_us[ARV_GV_DEVICE_N_COMMAND_LATENCY_BOUNDS] = {
+	250, 500, 1000, 2500, 5000, 10000, 25000, 100000
+};
+
+static void
+_update_command_statistics (ArvGvDeviceIOData *io_data, gint64 time_us, unsigned int n_retries, gboolean success)
+{
+	ArvGvDeviceCommandStatistics *statistics = &io_data->statistics;
+	guint i;
+
+	statistics->n_commands++;
+	statistics->n_retries += n_retries > 0 ? n_retries - 1 : 0;
+	if (!success)
+		statistics->n_failures++;
+	statistics->total_time_us += time_us;
+
+	for (i = 0; i < ARV_GV_DEVICE_N_COMMAND_LATENCY_BOUNDS; i++)
+		if ((guint64) time_us <= arv_gv_device_command_latency_bounds_us[i])
+			break;
+	statistics->latency_buckets[i]++;
+}
+
+const char *arv_gv_device_command_type_names[ARV_GV_DEVICE_N_COMMAND_TYPES] = {
+	"read_memory", "write_memory", "read_register", "write_register"
+};
+
+static guint
+_get_command_type (ArvGvcpCommand command)
 {
+	switch (command) {
+		case ARV_GVCP_COMMAND_READ_MEMORY_CMD:
+			return 0;
+		case ARV_GVCP_COMMAND_WRITE_MEMORY_CMD:
+			return 1;
+		case ARV_GVCP_COMMAND_READ_REGISTER_CMD:
+			return 2;
+		case ARV_GVCP_COMMAND_WRITE_REGISTER_CMD:
+			return 3;
+		default:
+			g_assert_not_reached ();
+	}
+
+	return 0;
+}
+
+/* Round trip time estimation of RFC 6298, per command type. Must be called with the io mutex locked. */
+
+static void
+_update_round_trip_time (ArvGvDeviceIOData *io_data, guint command_type, guint64 rtt_us)
+{
+	ArvGvDeviceCommandStatistics *statistics = &io_data->statistics;
+	guint64 rto_max_us = (guint64) io_data->gvcp_timeout_ms * 1000 * ARV_GV_DEVICE_GVCP_RTO_MAX_FACTOR;
+	guint64 srtt_us = statistics->srtt_us[command_type];
+	guint64 rttvar_us = statistics->rttvar_us[command_type];
+
+	rtt_us = MAX (rtt_us, 1);
+
+	if (srtt_us == 0) {
+		srtt_us = rtt_us;
+		rttvar_us = rtt_us / 2;
+	} else {
+		guint64 delta_us = srtt_us > rtt_us ? srtt_us - rtt_us : rtt_us - srtt_us;
+
+		rttvar_us = (3 * rttvar_us + delta_us) / 4;
+		srtt_us = (7 * srtt_us + rtt_us) / 8;
+	}
+
+	statistics->srtt_us[command_type] = MAX (srtt_us, 1);
+	statistics->rttvar_us[command_type] = rttvar_us;
+	statistics->rto_us[command_type] = CLAMP (srtt_us + 4 * rttvar_us, ARV_GV_DEVICE_GVCP_RTO_MIN_US, rto_max_us);
+}
+
+/* Timeout of the next attempt of a command, which has already been sent @n_attempts times. It is doubled on each
+ * retry, and the last attempt waits at least the fixed GVCP timeout, for the devices which take a long time to
+ * answer some commands without sending a PENDING_ACK. Must be called with the io mutex locked. */
+
+static gint64
+_get_timeout_us (ArvGvDeviceIOData *io_data, guint command_type, unsigned int n_attempts)
+{
+	guint64 timeout_us = (guint64) io_data->gvcp_timeout_ms * 1000;
+	guint64 rto_us;
+
+	if (io_data->statistics.srtt_us[command_type] == 0)
+		return timeout_us;
+
+	rto_us = io_data->statistics.rto_us[command_type] << MIN (n_attempts, 16);
+	rto_us = MIN (rto_us, timeout_us * ARV_GV_DEVICE_GVCP_RTO_MAX_FACTOR);
+
+	if (n_attempts + 1 >= io_data->gvcp_n_retries)
+		rto_us = MAX (rto_us, timeout_us);
+
+	return rto_us;
+}
+
+/* GVCP command engine. Up to command_window commands can be in flight at the same time, each one with its own packet
+ * id, timeout and retries. There is no receiver thread: the first waiting command becomes the receiver, polls the
+ * socket and dispatches the acknowledges to the matching in-flight commands, while the other ones wait on the io
+ * condition. The in-flight command list is protected by the io mutex, which is not held during socket accesses. */
+
+typedef struct {
+	ArvGvcpCommand command;
 	ArvGvcpCommand expected_ack_command;
-	ArvGvcpPacket *ack_packet = io_data->buffer;
-	ArvGvcpPacket *packet;
+	guint command_type;
 	const char *operation;
-	size_t packet_size;
+	size_t size;
 	size_t ack_size;
-	unsigned int n_retries = 0;
-	gboolean success = FALSE;
-	ArvGvcpError command_error = ARV_GVCP_ERROR_NONE;
-	int count;
+
+	ArvGvcpPacket *packet;
+	size_t packet_size;
+	unsigned int n_retries;
+	gboolean is_sent;
+	gint64 start_time_us;
+
+	/* Protected by the io mutex */
+	guint16 packet_id;
+	gint64 deadline_us;
+	gint64 send_time_us;
+	gint64 ack_time_us;
+	gboolean is_pending;
+	gboolean ack_received;
+	int ack_count;
+	guint32 ack[ARV_GV_DEVICE_BUFFER_SIZE / sizeof (guint32)];
+} ArvGvDeviceRequest;
+
+/* Must be called with the io mutex locked */
+
+static void
+_dispatch_ack (ArvGvDeviceIOData *io_data, int count)
+{
+	ArvGvcpPacket *packet = io_data->buffer;
+	guint16 packet_id;
+	GSList *iter;
+
+	arv_gvcp_packet_debug (packet, ARV_DEBUG_LEVEL_TRACE);
+
+	packet_id = arv_gvcp_packet_get_packet_id (packet);
+
+	for (iter = io_data->requests; iter != NULL; iter = iter->next) {
+		ArvGvDeviceRequest *request = iter->data;
+
+		if (request->packet_id != packet_id || request->ack_received)
+			continue;
+
+		if (arv_gvcp_packet_get_command (packet) == ARV_GVCP_COMMAND_PENDING_ACK) {
+			if (count >= arv_gvcp_packet_get_pending_ack_size ()) {
+				gint64 pending_ack_timeout_ms = arv_gvcp_packet_get_pending_ack_timeout (packet);
+
+				request->deadline_us = g_get_monotonic_time () + pending_ack_timeout_ms * 1000;
+				/* The device processing time is not a round trip time measurement */
+				request->is_pending = TRUE;
+				io_data->statistics.n_pending_acks++;
+
+				arv_debug_device ("[GvDevice::dispatch_ack] Pending ack timeout = %" G_GINT64_FORMAT
+						  " for packet id %u", pending_ack_timeout_ms, packet_id);
+			}
+		} else {
+			memcpy (request->ack, packet, count);
+			request->ack_count = count;
+			request->ack_received = TRUE;
+			request->ack_time_us = g_get_monotonic_time ();
+		}
+
+		return;
+	}
+
+	arv_info_device ("[GvDevice::dispatch_ack] Unexpected answer (packet id %u)", packet_id);
+}
+
+/* Waits for an acknowledge or the deadline of @request. Must be called with the io mutex locked. */
+
+static void
+_wait_ack (ArvGvDeviceIOData *io_data, ArvGvDeviceRequest *request)
+{
+	gint64 time_us;
+
+	while (!request->ack_received && (time_us = g_get_monotonic_time ()) < request->deadline_us) {
+		GError *local_error = NULL;
+		int count = 0;
+
+		if (io_data->is_receiving) {
+			g_cond_wait_until (&io_data->cond, &io_data->mutex, request->deadline_us);
+			continue;
+		}
+
+		io_data->is_receiving = TRUE;
+		g_mutex_unlock (&io_data->mutex);
+
+		if (g_poll (&io_data->poll_in_event, 1, (request->deadline_us - time_us + 999) / 1000) > 0) {
+			arv_gpollfd_clear_one (&io_data->poll_in_event, io_data->socket);
+			count = g_socket_receive (io_data->socket, io_data->buffer,
+						  ARV_GV_DEVICE_BUFFER_SIZE, NULL, &local_error);
+		}
+
+		g_mutex_lock (&io_data->mutex);
+		io_data->is_receiving = FALSE;
+
+		if (count >= (int) sizeof (ArvGvcpHeader))
+			_dispatch_ack (io_data, count);
+		else if (local_error != NULL)
+			arv_warning_device ("[GvDevice::wait_ack] Ack reception error: %s", local_error->message);
+		g_clear_error (&local_error);
+
+		/* Hand over the receiver role, and wake up the commands whose acknowledge was dispatched */
+		g_cond_broadcast (&io_data->cond);
+	}
+}
+
+/* Waits for a free slot in the command window. Must be called with the io mutex locked. */
+
+static void
+_acquire_command_slot (ArvGvDeviceIOData *io_data)
+{
+	while (io_data->n_requests >= io_data->command_window)
+		g_cond_wait (&io_data->cond, &io_data->mutex);
+
+	io_data->n_requests++;
+}
+
+/* Must be called with the io mutex locked */
+
+static void
+_release_command_slot (ArvGvDeviceIOData *io_data)
+{
+	io_data->n_requests--;
+
+	/* Wake up the commands waiting for a free slot in the window */
+	g_cond_broadcast (&io_data->cond);
+}
+
+/* Memory commands use @address, register commands the @size / 4 addresses of @addresses. Registers @request in the
+ * in-flight list and builds its packet. */
+
+static void
+_request_begin (ArvGvDeviceIOData *io_data, ArvGvDeviceRequest *request, ArvGvcpCommand command,
+		guint64 address, const guint32 *addresses, size_t size, const void *buffer)
+{
+	request->command = command;
+	request->command_type = _get_command_type (command);
+	request->size = size;
+	request->n_retries = 0;
+	request->is_sent = FALSE;
+	request->is_pending = FALSE;
+	request->ack_received = FALSE;
+	request->ack_count = 0;
+	request->deadline_us = 0;
 
 	switch (command) {
 		case ARV_GVCP_COMMAND_READ_MEMORY_CMD:
-			operation = "read_memory";
-			expected_ack_command = ARV_GVCP_COMMAND_READ_MEMORY_ACK;
-			ack_size = arv_gvcp_packet_get_read_memory_ack_size (size);
+			request->operation = "read_memory";
+			request->expected_ack_command = ARV_GVCP_COMMAND_READ_MEMORY_ACK;
+			request->ack_size = arv_gvcp_packet_get_read_memory_ack_size (size);
 			break;
 		case ARV_GVCP_COMMAND_WRITE_MEMORY_CMD:
-			operation = "write_memory";
-			expected_ack_command = ARV_GVCP_COMMAND_WRITE_MEMORY_ACK;
-			ack_size = arv_gvcp_packet_get_write_memory_ack_size ();
+			request->operation = "write_memory";
+			request->expected_ack_command = ARV_GVCP_COMMAND_WRITE_MEMORY_ACK;
+			request->ack_size = arv_gvcp_packet_get_write_memory_ack_size ();
 			break;
 		case ARV_GVCP_COMMAND_READ_REGISTER_CMD:
-			operation = "read_register";
-			expected_ack_command = ARV_GVCP_COMMAND_READ_REGISTER_ACK;
-			ack_size = arv_gvcp_packet_get_read_register_ack_size ();
+			request->operation = "read_register";
+			request->expected_ack_command = ARV_GVCP_COMMAND_READ_REGISTER_ACK;
+			request->ack_size = arv_gvcp_packet_get_read_registers_ack_size (size / sizeof (guint32));
 			break;
 		case ARV_GVCP_COMMAND_WRITE_REGISTER_CMD:
-			operation = "write_register";
-			expected_ack_command = ARV_GVCP_COMMAND_WRITE_REGISTER_ACK;
-			ack_size = arv_gvcp_packet_get_write_register_ack_size ();
+			request->operation = "write_register";
+			request->expected_ack_command = ARV_GVCP_COMMAND_WRITE_REGISTER_ACK;
+			request->ack_size = arv_gvcp_packet_get_write_register_ack_size ();
 			break;
 		default:
 			g_assert_not_reached ();
 	}
 
-	g_return_val_if_fail (ack_size <= ARV_GV_DEVICE_BUFFER_SIZE, FALSE);
-
 	g_mutex_lock (&io_data->mutex);
 
+	request->start_time_us = g_get_monotonic_time ();
+
 	io_data->packet_id = arv_gvcp_next_packet_id (io_data->packet_id);
+	request->packet_id = io_data->packet_id;
+
+	io_data->requests = g_slist_prepend (io_data->requests, request);
+
+	g_mutex_unlock (&io_data->mutex);
 
 	switch (command) {
 		case ARV_GVCP_COMMAND_READ_MEMORY_CMD:
-			packet = arv_gvcp_packet_new_read_memory_cmd (address, size,
-								      io_data->packet_id, &packet_size);
+			request->packet = arv_gvcp_packet_new_read_memory_cmd (address, size,
+									       request->packet_id,
+									       &request->packet_size);
 			break;
 		case ARV_GVCP_COMMAND_WRITE_MEMORY_CMD:
-			packet = arv_gvcp_packet_new_write_memory_cmd (address, size, buffer,
-								       io_data->packet_id, &packet_size);
+			request->packet = arv_gvcp_packet_new_write_memory_cmd (address, size, buffer,
+										request->packet_id,
+										&request->packet_size);
 			break;
 		case ARV_GVCP_COMMAND_READ_REGISTER_CMD:
-			packet = arv_gvcp_packet_new_read_register_cmd (address,
-									io_data->packet_id, &packet_size);
+			request->packet = arv_gvcp_packet_new_read_registers_cmd (addresses, size / sizeof (guint32),
+										  request->packet_id,
+										  &request->packet_size);
 			break;
 		case ARV_GVCP_COMMAND_WRITE_REGISTER_CMD:
-			packet = arv_gvcp_packet_new_write_register_cmd (address, *((guint32 *) buffer),
-									 io_data->packet_id, &packet_size);
+			request->packet = arv_gvcp_packet_new_write_registers_cmd (addresses, buffer,
+										   size / sizeof (guint32),
+										   request->packet_id,
+										   &request->packet_size);
 			break;
 		default:
 			g_assert_not_reached ();
 	}
+}
 
-	do {
-		GError *local_error = NULL;
+/* Sends, or sends again, the command packet of @request, and arms its timeout */
 
-		arv_gvcp_packet_debug (packet, ARV_DEBUG_LEVEL_TRACE);
+static gboolean
+_request_send (ArvGvDeviceIOData *io_data, ArvGvDeviceRequest *request)
+{
+	GError *local_error = NULL;
 
-		success = g_socket_send_to (io_data->socket, io_data->device_address,
-					    (const char *) packet, packet_size,
-					    NULL, &local_error) >= 0;
+	arv_gvcp_packet_debug (request->packet, ARV_DEBUG_LEVEL_TRACE);
 
-		if (success) {
-			gint timeout_ms;
-			gint64 timeout_stop_ms;
-			gboolean pending_ack;
-			gboolean expected_answer;
+	/* Armed before sending, as the acknowledge may be dispatched by another thread right after */
+	g_mutex_lock (&io_data->mutex);
+	request->ack_received = FALSE;
+	request->send_time_us = g_get_monotonic_time ();
+	request->deadline_us = request->send_time_us +
+		_get_timeout_us (io_data, request->command_type, request->n_retries);
+	g_mutex_unlock (&io_data->mutex);
 
-			timeout_stop_ms = g_get_monotonic_time () / 1000 + io_data->gvcp_timeout_ms;
+	request->n_retries++;
 
-			do {
-				pending_ack = FALSE;
+	request->is_sent = g_socket_send_to (io_data->socket, io_data->device_address,
+					     (const char *) request->packet, request->packet_size,
+					     NULL, &local_error) >= 0;
+	if (!request->is_sent) {
+		if (local_error != NULL)
+			arv_warning_device ("[GvDevice::%s] Command sending error: %s", request->operation,
+					    local_error->message);
+		g_clear_error (&local_error);
+	}
 
-				timeout_ms = timeout_stop_ms - g_get_monotonic_time () / 1000;
-				if (timeout_ms < 0)
-					timeout_ms = 0;
+	return request->is_sent;
+}
 
-				success = TRUE;
-				success = success && g_poll (&io_data->poll_in_event, 1, timeout_ms) > 0;
+/* Waits for the acknowledge of @request, sending it again on timeout. Returns %TRUE if an answer was
+ * received, @command_error being set for an error answer. For register writes, @n_written is set to the number of
+ * registers the device acknowledged as written. */
 
-				if (success) {
-					arv_gpollfd_clear_one (&io_data->poll_in_event, io_data->socket);
-					count = g_socket_receive (io_data->socket, io_data->buffer,
-								  ARV_GV_DEVICE_BUFFER_SIZE, NULL, &local_error);
-				} else
-					count = 0;
-				success = success && (count >= sizeof (ArvGvcpHeader));
-
-				if (success) {
-					ArvGvcpPacketType packet_type;
-					ArvGvcpCommand ack_command;
-					guint16 packet_id;
-
-					arv_gvcp_packet_debug (ack_packet, ARV_DEBUG_LEVEL_TRACE);
-
-					packet_type = arv_gvcp_packet_get_packet_type (ack_packet);
-					ack_command = arv_gvcp_packet_get_command (ack_packet);
-					packet_id = arv_gvcp_packet_get_packet_id (ack_packet);
-
-					if (ack_command == ARV_GVCP_COMMAND_PENDING_ACK &&
-					    count >= arv_gvcp_packet_get_pending_ack_size ()) {
-						gint64 pending_ack_timeout_ms = arv_gvcp_packet_get_pending_ack_timeout (ack_packet);
-						pending_ack = TRUE;
-						expected_answer = FALSE;
-
-						timeout_stop_ms = g_get_monotonic_time () / 1000 + pending_ack_timeout_ms;
-
-						arv_debug_device ("[GvDevice::%s] Pending ack timeout = %" G_GINT64_FORMAT,
-								operation, pending_ack_timeout_ms);
-					} else if (packet_type == ARV_GVCP_PACKET_TYPE_ERROR) {
-						expected_answer = ack_command == expected_ack_command &&
-							packet_id == io_data->packet_id;
-						if (!expected_answer) {
-							arv_info_device ("[GvDevice::%s] Unexpected answer (0x%04x)", operation,
-									  packet_type);
-						} else
-							command_error = arv_gvcp_packet_get_packet_flags (ack_packet);
-					} else  {
-						expected_answer = packet_type == ARV_GVCP_PACKET_TYPE_ACK &&
-							ack_command == expected_ack_command &&
-							packet_id == io_data->packet_id &&
-							count >= ack_size;
-						if (!expected_answer) {
-							arv_info_device ("[GvDevice::%s] Unexpected answer (0x%04x)", operation,
-									  packet_type);
-						}
+static gboolean
+_request_complete (ArvGvDeviceIOData *io_data, ArvGvDeviceRequest *request, void *buffer, guint *n_written,
+		   ArvGvcpError *command_error)
+{
+	ArvGvcpPacket *ack_packet = (ArvGvcpPacket *) request->ack;
+	gboolean success = FALSE;
+
+	*command_error = ARV_GVCP_ERROR_NONE;
+	if (n_written != NULL)
+		*n_written = 0;
+
+	for (;;) {
+		if (request->is_sent) {
+			g_mutex_lock (&io_data->mutex);
+
+			do {
+				ArvGvcpPacketType packet_type;
+				ArvGvcpCommand ack_command;
+
+				_wait_ack (io_data, request);
+				if (!request->ack_received)
+					break;
+
+				packet_type = arv_gvcp_packet_get_packet_type (ack_packet);
+				ack_command = arv_gvcp_packet_get_command (ack_packet);
+
+				if (packet_type == ARV_GVCP_PACKET_TYPE_ERROR) {
+					success = ack_command == request->expected_ack_command;
+					if (success) {
+						*command_error = arv_gvcp_packet_get_packet_flags (ack_packet);
+						if (request->command == ARV_GVCP_COMMAND_WRITE_REGISTER_CMD &&
+						    n_written != NULL && request->ack_count >= request->ack_size)
+							*n_written = arv_gvcp_packet_get_write_register_ack_data_index (ack_packet);
 					}
-				} else {
-					expected_answer = FALSE;
-					if (local_error != NULL)
-						arv_warning_device ("[GvDevice::%s] Ack reception error: %s", operation,
-								    local_error->message);
-					else
-						arv_warning_device ("[GvDevice::%s] Ack reception timeout", operation);
-					g_clear_error (&local_error);
-				}
-			} while (pending_ack || (!expected_answer && timeout_ms > 0));
-
-			success = success && expected_answer;
-
-			if (success && command_error == ARV_GVCP_ERROR_NONE) {
-				switch (command) {
-					case ARV_GVCP_COMMAND_READ_MEMORY_CMD:
-						memcpy (buffer, arv_gvcp_packet_get_read_memory_ack_data (ack_packet), size);
-						break;
-					case ARV_GVCP_COMMAND_WRITE_MEMORY_CMD:
-						break;
-					case ARV_GVCP_COMMAND_READ_REGISTER_CMD:
-						*((gint32 *) buffer) = arv_gvcp_packet_get_read_register_ack_value (ack_packet);
-						break;
-					case ARV_GVCP_COMMAND_WRITE_REGISTER_CMD:
-						break;
-					default:
-						g_assert_not_reached ();
+				} else
+					success = packet_type == ARV_GVCP_PACKET_TYPE_ACK &&
+						ack_command == request->expected_ack_command &&
+						request->ack_count >= request->ack_size;
+
+				if (!success) {
+					arv_info_device ("[GvDevice::%s] Unexpected answer (0x%04x)", request->operation,
+							  packet_type);
+					request->ack_received = FALSE;
 				}
-			}
-		} else {
-			if (local_error != NULL)
-				arv_warning_device ("[GvDevice::%s] Command sending error: %s", operation, local_error->message);
-			g_clear_error (&local_error);
-		}
+			} while (!success);
 
-		n_retries++;
-	} while (!success && n_retries < io_data->gvcp_n_retries);
+			g_mutex_unlock (&io_data->mutex);
 
-	arv_gvcp_packet_free (packet);
+			if (success)
+				break;
 
-	g_mutex_unlock (&io_data->mutex);
+			arv_warning_device ("[GvDevice::%s] Ack reception timeout", request->operation);
+		}
 
-	success = success && command_error == ARV_GVCP_ERROR_NONE;
+		if (request->n_retries >= io_data->gvcp_n_retries)
+			break;
 
-	if (!success) {
-		switch (command) {
+		_request_send (io_data, request);
+	}
+
+	if (success && *command_error == ARV_GVCP_ERROR_NONE) {
+		switch (request->command) {
 			case ARV_GVCP_COMMAND_READ_MEMORY_CMD:
-				memset (buffer, 0, size);
+				memcpy (buffer, arv_gvcp_packet_get_read_memory_ack_data (ack_packet), request->size);
 				break;
 			case ARV_GVCP_COMMAND_WRITE_MEMORY_CMD:
 				break;
 			case ARV_GVCP_COMMAND_READ_REGISTER_CMD:
-				*((guint32 *) buffer) = 0;
+				{
+					guint i;
+
+					for (i = 0; i < request->size / sizeof (guint32); i++)
+						((guint32 *) buffer)[i] =
+							arv_gvcp_packet_get_read_registers_ack_value (ack_packet, i);
+				}
 				break;
 			case ARV_GVCP_COMMAND_WRITE_REGISTER_CMD:
+				if (n_written != NULL)
+					*n_written = request->size / sizeof (guint32);
 				break;
 			default:
 				g_assert_not_reached ();
 		}
+	}
 
-		if (error != NULL && *error == NULL) {
-			if (command_error != ARV_GVCP_ERROR_NONE)
-				*error = g_error_new (ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_PROTOCOL_ERROR,
-						      "GigEVision %s error (%s)", operation,
-						      arv_gvcp_error_to_string (command_error));
-			else
-				*error = g_error_new (ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_TIMEOUT,
-						      "GigEVision %s timeout", operation);
+	return success;
+}
+
+/* Removes @request from the in-flight list and accounts for it. Must be called with the io mutex locked. */
+
+static void
+_request_end (ArvGvDeviceIOData *io_data, ArvGvDeviceRequest *request, gboolean success)
+{
+	io_data->requests = g_slist_remove (io_data->requests, request);
+
+	if (success)
+		io_data->last_ack_time_us = g_get_monotonic_time ();
+
+	/* Karn's algorithm, the acknowledges of resent commands are ambiguous */
+	if (success && request->n_retries == 1 && !request->is_pending && request->ack_time_us >= request->send_time_us)
+		_update_round_trip_time (io_data, request->command_type, request->ack_time_us - request->send_time_us);
+
+	_update_command_statistics (io_data, g_get_monotonic_time () - request->start_time_us, request->n_retries,
+				    success);
+
+	g_clear_pointer (&request->packet, arv_gvcp_packet_free);
+}
+
+static void
+_set_command_error (ArvGvDeviceRequest *request, void *buffer, ArvGvcpError command_error, GError **error)
+{
+	switch (request->command) {
+		case ARV_GVCP_COMMAND_READ_MEMORY_CMD:
+		case ARV_GVCP_COMMAND_READ_REGISTER_CMD:
+			memset (buffer, 0, request->size);
+			break;
+		case ARV_GVCP_COMMAND_WRITE_MEMORY_CMD:
+		case ARV_GVCP_COMMAND_WRITE_REGISTER_CMD:
+			break;
+		default:
+			g_assert_not_reached ();
+	}
+
+	if (error != NULL && *error == NULL) {
+		if (command_error != ARV_GVCP_ERROR_NONE)
+			*error = g_error_new (ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_PROTOCOL_ERROR,
+					      "GigEVision %s error (%s)", request->operation,
+					      arv_gvcp_error_to_string (command_error));
+		else
+			*error = g_error_new (ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_TIMEOUT,
+					      "GigEVision %s timeout", request->operation);
+	}
+}
+
+/* Memory commands use @address, register commands the @size / 4 addresses of @addresses. For register writes,
+ * @n_written is set to the number of registers the device acknowledged as written. */
+
+static gboolean
+_send_cmd_and_receive_ack (ArvGvDeviceIOData *io_data, ArvGvcpCommand command,
+			   guint64 address, const guint32 *addresses, size_t size, void *buffer,
+			   guint *n_written, GError **error)
+{
+	ArvGvDeviceRequest request;
+	ArvGvcpError command_error;
+	gboolean success;
+
+	g_mutex_lock (&io_data->mutex);
+	_acquire_command_slot (io_data);
+	g_mutex_unlock (&io_data->mutex);
+
+	_request_begin (io_data, &request, command, address, addresses, size, buffer);
+	g_return_val_if_fail (request.ack_size <= ARV_GV_DEVICE_BUFFER_SIZE, FALSE);
+
+	_request_send (io_data, &request);
+
+	success = _request_complete (io_data, &request, buffer, n_written, &command_error);
+	success = success && command_error == ARV_GVCP_ERROR_NONE;
+
+	g_mutex_lock (&io_data->mutex);
+	_request_end (io_data, &request, success);
+	_release_command_slot (io_data);
+	g_mutex_unlock (&io_data->mutex);
+
+	if (!success)
+		_set_command_error (&request, buffer, command_error, error);
+
+	return success;
+}
+
+/* Reads or writes @size bytes at @address with up to *@memory_depth READMEM or WRITEMEM commands in flight, each one
+ * with the maximum payload. The whole transfer occupies a single slot of the command window. As soon as a command
+ * needs to be sent again, which likely means the device does not process several commands at once, the remaining
+ * blocks and the following transfers of the same kind are done one block at a time. */
+
+static gboolean
+_transfer_memory_pipelined (ArvGvDeviceIOData *io_data, ArvGvcpCommand command, guint *memory_depth,
+			    guint64 address, size_t size, void *buffer, GError **error)
+{
+	ArvGvDeviceRequest *requests;
+	guint n_slots;
+	guint n_blocks = (size + ARV_GVCP_DATA_SIZE_MAX - 1) / ARV_GVCP_DATA_SIZE_MAX;
+	guint n_sent = 0;
+	guint n_completed = 0;
+	guint depth;
+	gboolean success = TRUE;
+
+	if (n_blocks == 0)
+		return TRUE;
+
+	g_mutex_lock (&io_data->mutex);
+	_acquire_command_slot (io_data);
+	depth = CLAMP (*memory_depth, 1, n_blocks);
+	g_mutex_unlock (&io_data->mutex);
+
+	n_slots = depth;
+	requests = g_new (ArvGvDeviceRequest, n_slots);
+
+	while (n_completed < n_blocks) {
+		ArvGvDeviceRequest *request;
+		ArvGvcpError command_error;
+		gboolean block_success;
+		char *block;
+
+		/* Fill the pipeline */
+		while (success && n_sent < n_blocks && n_sent - n_completed < depth) {
+			request = &requests[n_sent % n_slots];
+
+			_request_begin (io_data, request, command,
+					address + (guint64) n_sent * ARV_GVCP_DATA_SIZE_MAX, NULL,
+					MIN (ARV_GVCP_DATA_SIZE_MAX, size - n_sent * ARV_GVCP_DATA_SIZE_MAX),
+					((char *) buffer) + (gsize) n_sent * ARV_GVCP_DATA_SIZE_MAX);
+			_request_send (io_data, request);
+			n_sent++;
+		}
+
+		if (n_completed == n_sent)
+			break;
+
+		/* Blocks are completed in order, the following ones being received meanwhile */
+		request = &requests[n_completed % n_slots];
+		block = ((char *) buffer) + (gsize) n_completed * ARV_GVCP_DATA_SIZE_MAX;
+
+		/* After a failure, the commands still in flight are just dropped */
+		block_success = success &&
+			_request_complete (io_data, request, block, NULL, &command_error) &&
+			command_error == ARV_GVCP_ERROR_NONE;
+
+		if (request->n_retries > 1 && depth > 1) {
+			arv_info_device ("[GvDevice::transfer_memory_pipelined] %s command resent, "
+					  "transferring the memory one block at a time", request->operation);
+			depth = 1;
+			g_mutex_lock (&io_data->mutex);
+			*memory_depth = 1;
+			g_mutex_unlock (&io_data->mutex);
+		}
+
+		if (!block_success && success) {
+			_set_command_error (request, block, command_error, error);
+			success = FALSE;
 		}
+
+		g_mutex_lock (&io_data->mutex);
+		_request_end (io_data, request, block_success);
+		g_mutex_unlock (&io_data->mutex);
+
+		n_completed++;
 	}
 
+	g_mutex_lock (&io_data->mutex);
+	_release_command_slot (io_data);
+	g_mutex_unlock (&io_data->mutex);
+
+	g_free (requests);
+
+	if (!success && command == ARV_GVCP_COMMAND_READ_MEMORY_CMD)
+		memset (buffer, 0, size);
+
 	return success;
 }
 
+static gboolean
+_read_memory_pipelined (ArvGvDeviceIOData *io_data, guint64 address, size_t size, void *buffer, GError **error)
+{
+	return _transfer_memory_pipelined (io_data, ARV_GVCP_COMMAND_READ_MEMORY_CMD, &io_data->read_memory_depth,
+					   address, size, buffer, error);
+}
+
+static gboolean
+_write_memory_pipelined (ArvGvDeviceIOData *io_data, guint64 address, size_t size, void *buffer, GError **error)
+{
+	return _transfer_memory_pipelined (io_data, ARV_GVCP_COMMAND_WRITE_MEMORY_CMD, &io_data->write_memory_depth,
+					   address, size, buffer, error);
+}
+
 static gboolean
 _read_memory (ArvGvDeviceIOData *io_data, guint64 address, guint32 size, void *buffer, GError **error)
 {
 	return _send_cmd_and_receive_ack (io_data, ARV_GVCP_COMMAND_READ_MEMORY_CMD,
-					  address, size, buffer, error);
+					  address, NULL, size, buffer, NULL, error);
 }
 
 static gboolean
 _write_memory (ArvGvDeviceIOData *io_data, guint64 address, guint32 size, void *buffer, GError **error)
 {
 	return  _send_cmd_and_receive_ack (io_data, ARV_GVCP_COMMAND_WRITE_MEMORY_CMD,
-					   address, size, buffer, error);
+					   address, NULL, size, buffer, NULL, error);
 }
 
 static gboolean
 _read_register (ArvGvDeviceIOData *io_data, guint32 address, guint32 *value_placeholder, GError **error)
 {
 	return _send_cmd_and_receive_ack (io_data, ARV_GVCP_COMMAND_READ_REGISTER_CMD,
-					  address, sizeof (guint32), value_placeholder, error);
+					  0, &address, sizeof (guint32), value_placeholder, NULL, error);
+}
+
+static gboolean
+_read_registers (ArvGvDeviceIOData *io_data, const guint32 *addresses, guint n_registers, guint32 *values,
+		 GError **error)
+{
+	return _send_cmd_and_receive_ack (io_data, ARV_GVCP_COMMAND_READ_REGISTER_CMD,
+					  0, addresses, n_registers * sizeof (guint32), values, NULL, error);
 }
 
 static gboolean
 _write_register (ArvGvDeviceIOData *io_data, guint32 address, guint32 value, GError **error)
 {
 	return _send_cmd_and_receive_ack (io_data, ARV_GVCP_COMMAND_WRITE_REGISTER_CMD,
-					  address, sizeof (guint32), &value, error);
+					  0, &address, sizeof (guint32), &value, NULL, error);
+}
+
+static gboolean
+_write_registers (ArvGvDeviceIOData *io_data, const guint32 *addresses, guint n_registers, const guint32 *values,
+		  guint *n_written, GError **error)
+{
+	return _send_cmd_and_receive_ack (io_data, ARV_GVCP_COMMAND_WRITE_REGISTER_CMD,
+					  0, addresses, n_registers * sizeof (guint32), (void *) values, n_written, error);
 }
 
 /* Heartbeat thread */
@@ -370,59 +836,326 @@ arv_gv_device_heartbeat_thread (void *data)
 	GPollFD poll_fd;
 	gboolean use_poll;
 	GTimer *timer;
-	guint32 value;
+	gint auxiliary_generation = 0;
+
+	arv_apply_internal_thread_scheduling (ARV_INTERNAL_THREAD_HEARTBEAT);
+
+	timer = g_timer_new ();
+
+	use_poll = g_cancellable_make_pollfd (thread_data->cancellable, &poll_fd);
+
+	do {
+		arv_device_update_auxiliary_thread_placement (ARV_DEVICE (thread_data->gv_device),
+							      &auxiliary_generation);
+
+		if (use_poll)
+			g_poll (&poll_fd, 1, thread_data->period_us / 1000);
+		else
+			g_usleep (thread_data->period_us);
+
+		if (io_data->is_controller) {
+			GError *local_error = NULL;
+			gboolean control_lost = FALSE;
+			gint64 last_ack_time_us;
+			guint counter = 1;
+
+			/* Any acknowledged command already reset the heartbeat timer of the device */
+			g_mutex_lock (&io_data->mutex);
+			last_ack_time_us = io_data->last_ack_time_us;
+			g_mutex_unlock (&io_data->mutex);
+
+			if (last_ack_time_us > 0 &&
+			    g_get_monotonic_time () - last_ack_time_us < thread_data->period_us) {
+				arv_debug_device ("[GvDevice::Heartbeat] Skipped, control channel in use");
+				continue;
+			}
+
+			/* Like Pylon, write the privilege instead of reading it: if the control access was lost, the
+			 * device answers with an error acknowledge. */
+
+			g_timer_start (timer);
+
+			while (!_write_register (io_data, ARV_GVBS_CONTROL_CHANNEL_PRIVILEGE_OFFSET, io_data->privilege,
+						 &local_error)) {
+				if (g_error_matches (local_error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_PROTOCOL_ERROR)) {
+					arv_info_device ("[GvDevice::Heartbeat] %s", local_error->message);
+					control_lost = TRUE;
+					break;
+				}
+				g_clear_error (&local_error);
+
+				if (g_cancellable_is_cancelled (thread_data->cancellable))
+					break;
+
+				if (g_timer_elapsed (timer, NULL) >= ARV_GV_DEVICE_HEARTBEAT_RETRY_TIMEOUT_S) {
+					control_lost = TRUE;
+					break;
+				}
+
+				g_usleep (ARV_GV_DEVICE_HEARTBEAT_RETRY_DELAY_US);
+				counter++;
+			}
+			g_clear_error (&local_error);
+
+			if (!g_cancellable_is_cancelled (thread_data->cancellable)) {
+				if (counter > 1)
+					arv_debug_device ("[GvDevice::Heartbeat] Tried %u times", counter);
+
+				if (control_lost) {
+					arv_warning_device ("[GvDevice::Heartbeat] Control access lost");
+
+					arv_device_emit_control_lost_signal (ARV_DEVICE (thread_data->gv_device));
+
+					io_data->is_controller = FALSE;
+				}
+			} else
+				io_data->is_controller = FALSE;
+		}
+	} while (!g_cancellable_is_cancelled (thread_data->cancellable));
+
+	if (use_poll)
+		g_cancellable_release_fd (thread_data->cancellable);
+
+	g_timer_destroy (timer);
+
+	return NULL;
+}
+
+/* Message channel thread */
+
+typedef struct {
+	ArvGvDevice *gv_device;
+	GSocket *socket;
+	guint16 port;
+
+	gboolean has_packet_id;
+	guint16 packet_id;
+
+	GCancellable *cancellable;
+} ArvGvDeviceEventData;
+
+static void
+_dispatch_event_packet (ArvGvDeviceEventData *thread_data, ArvGvcpPacket *packet, GSocketAddress *source_address)
+{
+	ArvGvcpCommand command;
+	ArvGvcpEvent event;
+	size_t offset = 0;
+	guint16 packet_id;
+
+	command = arv_gvcp_packet_get_command (packet);
+	if (arv_gvcp_packet_get_packet_type (packet) != ARV_GVCP_PACKET_TYPE_CMD ||
+	    (command != ARV_GVCP_COMMAND_EVENT_CMD && command != ARV_GVCP_COMMAND_EVENT_DATA_CMD)) {
+		arv_debug_device ("[GvDevice::event_thread] Unexpected %s packet on the message channel",
+				  arv_gvcp_command_to_string (command));
+		return;
+	}
+
+	/* The acknowledge is sent first, as the device may be waiting for it before sending the next event */
+	if ((arv_gvcp_packet_get_packet_flags (packet) & ARV_GVCP_CMD_PACKET_FLAGS_ACK_REQUIRED) != 0) {
+		ArvGvcpPacket *ack_packet;
+		size_t ack_packet_size;
+
+		ack_packet = arv_gvcp_packet_new_event_ack (packet, &ack_packet_size);
+		g_socket_send_to (thread_data->socket, source_address, (const char *) ack_packet, ack_packet_size,
+				  NULL, NULL);
+		arv_gvcp_packet_free (ack_packet);
+	}
+
+	/* Retransmission of an event whose acknowledge was lost */
+	packet_id = arv_gvcp_packet_get_packet_id (packet);
+	if (thread_data->has_packet_id && packet_id == thread_data->packet_id)
+		return;
+	thread_data->has_packet_id = TRUE;
+	thread_data->packet_id = packet_id;
+
+	while ((offset = arv_gvcp_packet_get_event (packet, offset, &event)) > 0) {
+		GBytes *data = event.data != NULL ? g_bytes_new (event.data, event.data_size) : NULL;
+
+		arv_debug_device ("[GvDevice::event_thread] Event 0x%04x, block id %" G_GUINT64_FORMAT
+				  ", timestamp %" G_GUINT64_FORMAT,
+				  event.event_id, event.block_id, event.timestamp);
+
+		g_signal_emit (thread_data->gv_device, arv_gv_device_signals[ARV_GV_DEVICE_SIGNAL_EVENT], 0,
+			       event.event_id, event.stream_channel_index, event.block_id, event.timestamp, data);
+
+		if (data != NULL)
+			g_bytes_unref (data);
+	}
+}
+
+static void *
+arv_gv_device_event_thread (void *data)
+{
+	ArvGvDeviceEventData *thread_data = data;
+	GPollFD poll_fd[2];
+	gboolean use_poll;
+	char *buffer;
+	gint auxiliary_generation = 0;
+
+	arv_apply_internal_thread_scheduling (ARV_INTERNAL_THREAD_EVENT);
+
+	buffer = g_malloc (ARV_GV_DEVICE_BUFFER_SIZE);
+
+	poll_fd[0].fd = g_socket_get_fd (thread_data->socket);
+	poll_fd[0].events = G_IO_IN;
+	poll_fd[0].revents = 0;
+
+	arv_gpollfd_prepare_all (poll_fd, 1);
+
+	use_poll = g_cancellable_make_pollfd (thread_data->cancellable, &poll_fd[1]);
+
+	do {
+		GSocketAddress *source_address = NULL;
+		gssize count;
+
+		/* Applied once the placement changed, on the next event */
+		arv_device_update_auxiliary_thread_placement (ARV_DEVICE (thread_data->gv_device),
+							      &auxiliary_generation);
+
+		/* Without a cancellable file descriptor, wake up regularly to check for the cancellation */
+		if (g_poll (poll_fd, use_poll ? 2 : 1, use_poll ? -1 : ARV_GV_DEVICE_EVENT_POLL_TIMEOUT_MS) <= 0 ||
+		    (poll_fd[0].revents & G_IO_IN) == 0)
+			continue;
+
+		arv_gpollfd_clear_one (&poll_fd[0], thread_data->socket);
+
+		count = g_socket_receive_from (thread_data->socket, &source_address, buffer,
+					       ARV_GV_DEVICE_BUFFER_SIZE, NULL, NULL);
+		if (count >= (gssize) sizeof (ArvGvcpHeader) &&
+		    count >= (gssize) (sizeof (ArvGvcpHeader) + g_ntohs (((ArvGvcpPacket *) buffer)->header.size))) {
+			arv_gvcp_packet_debug ((ArvGvcpPacket *) buffer, ARV_DEBUG_LEVEL_DEBUG);
+			_dispatch_event_packet (thread_data, (ArvGvcpPacket *) buffer, source_address);
+		}
+
+		g_clear_object (&source_address);
+	} while (!g_cancellable_is_cancelled (thread_data->cancellable));
+
+	if (use_poll)
+		g_cancellable_release_fd (thread_data->cancellable);
+
+	arv_gpollfd_finish_all (poll_fd, 1);
+
+	g_free (buffer);
+
+	return NULL;
+}
+
+/**
+ * arv_gv_device_enable_events:
+ * @gv_device: a #ArvGvDevice
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Opens the GigE Vision message channel of the device, and starts a thread receiving the EVENT and EVENTDATA
+ * commands. Each received event is emitted right away from this thread through the #ArvGvDevice::event signal,
+ * with its device timestamp. The events themselves must still be enabled using the device features, usually
+ * EventSelector and EventNotification.
+ *
+ * Returns: %TRUE if the message channel is open.
+ *
+ * Since: 0.8.11
+ */
+
+gboolean
+arv_gv_device_enable_events (ArvGvDevice *gv_device, GError **error)
+{
+	ArvGvDevicePrivate *priv = arv_gv_device_get_instance_private (gv_device);
+	ArvGvDeviceEventData *event_data;
+	GSocketAddress *interface_socket_address;
+	GInetSocketAddress *local_address;
+	const guint8 *address_bytes;
+	GError *local_error = NULL;
+	guint32 n_message_channels = 0;
+	GSocket *socket;
+
+	g_return_val_if_fail (ARV_IS_GV_DEVICE (gv_device), FALSE);
 
-	timer = g_timer_new ();
+	if (priv->event_thread != NULL)
+		return TRUE;
 
-	use_poll = g_cancellable_make_pollfd (thread_data->cancellable, &poll_fd);
+	if (!arv_device_read_register (ARV_DEVICE (gv_device), ARV_GVBS_N_MESSAGE_CHANNELS_OFFSET,
+				       &n_message_channels, error))
+		return FALSE;
 
-	do {
-		if (use_poll)
-			g_poll (&poll_fd, 1, thread_data->period_us / 1000);
-		else
-			g_usleep (thread_data->period_us);
+	if (n_message_channels < 1) {
+		g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_PROTOCOL_ERROR,
+			     "[GvDevice::enable_events] Device has no message channel");
+		return FALSE;
+	}
 
-		if (io_data->is_controller) {
-			guint counter = 1;
+	interface_socket_address = g_inet_socket_address_new (priv->interface_address, 0);
+	socket = g_socket_new (G_SOCKET_FAMILY_IPV4, G_SOCKET_TYPE_DATAGRAM, G_SOCKET_PROTOCOL_UDP, &local_error);
+	if (socket != NULL)
+		g_socket_bind (socket, interface_socket_address, FALSE, &local_error);
+	g_object_unref (interface_socket_address);
 
-			/* TODO: Instead of reading the control register, Pylon does write the heartbeat
-			 * timeout value, which is interresting, as doing this we could get an error
-			 * ack packet which will indicate we lost the control access. */
+	if (local_error != NULL) {
+		g_clear_object (&socket);
+		g_propagate_error (error, local_error);
+		return FALSE;
+	}
 
-			g_timer_start (timer);
+	event_data = g_new0 (ArvGvDeviceEventData, 1);
+	event_data->gv_device = gv_device;
+	event_data->socket = socket;
+	event_data->cancellable = g_cancellable_new ();
 
-			while (!_read_register (io_data, ARV_GVBS_CONTROL_CHANNEL_PRIVILEGE_OFFSET, &value, NULL) &&
-			       g_timer_elapsed (timer, NULL) < ARV_GV_DEVICE_HEARTBEAT_RETRY_TIMEOUT_S &&
-			       !g_cancellable_is_cancelled (thread_data->cancellable)) {
-				g_usleep (ARV_GV_DEVICE_HEARTBEAT_RETRY_DELAY_US);
-				counter++;
-			}
+	local_address = G_INET_SOCKET_ADDRESS (g_socket_get_local_address (socket, NULL));
+	event_data->port = g_inet_socket_address_get_port (local_address);
+	g_object_unref (local_address);
+
+	address_bytes = g_inet_address_to_bytes (priv->interface_address);
+
+	if (!arv_device_write_register (ARV_DEVICE (gv_device), ARV_GVBS_MESSAGE_CHANNEL_DESTINATION_ADDRESS_OFFSET,
+					g_htonl (*((guint32 *) address_bytes)), &local_error) ||
+	    !arv_device_write_register (ARV_DEVICE (gv_device), ARV_GVBS_MESSAGE_CHANNEL_PORT_OFFSET,
+					event_data->port, &local_error)) {
+		g_clear_object (&event_data->cancellable);
+		g_clear_object (&event_data->socket);
+		g_free (event_data);
+		g_propagate_error (error, local_error);
+		return FALSE;
+	}
 
-			if (!g_cancellable_is_cancelled (thread_data->cancellable)) {
-				arv_debug_device ("[GvDevice::Heartbeat] Ack value = %d", value);
+	arv_info_device ("[GvDevice::enable_events] Message channel port = %d", event_data->port);
 
-				if (counter > 1)
-					arv_debug_device ("[GvDevice::Heartbeat] Tried %u times", counter);
+	priv->event_data = event_data;
+	priv->event_thread = g_thread_new ("arv_gv_event", arv_gv_device_event_thread, event_data);
 
-				if ((value & (ARV_GVBS_CONTROL_CHANNEL_PRIVILEGE_CONTROL |
-					      ARV_GVBS_CONTROL_CHANNEL_PRIVILEGE_EXCLUSIVE)) == 0) {
-					arv_warning_device ("[GvDevice::Heartbeat] Control access lost");
+	return TRUE;
+}
 
-					arv_device_emit_control_lost_signal (ARV_DEVICE (thread_data->gv_device));
+/**
+ * arv_gv_device_disable_events:
+ * @gv_device: a #ArvGvDevice
+ *
+ * Closes the message channel opened by arv_gv_device_enable_events().
+ *
+ * Since: 0.8.11
+ */
 
-					io_data->is_controller = FALSE;
-				}
-			} else
-				io_data->is_controller = FALSE;
-		}
-	} while (!g_cancellable_is_cancelled (thread_data->cancellable));
+void
+arv_gv_device_disable_events (ArvGvDevice *gv_device)
+{
+	ArvGvDevicePrivate *priv = arv_gv_device_get_instance_private (gv_device);
+	ArvGvDeviceEventData *event_data;
 
-	if (use_poll)
-		g_cancellable_release_fd (thread_data->cancellable);
+	g_return_if_fail (ARV_IS_GV_DEVICE (gv_device));
 
-	g_timer_destroy (timer);
+	if (priv->event_thread == NULL)
+		return;
 
-	return NULL;
+	event_data = priv->event_data;
+
+	arv_device_write_register (ARV_DEVICE (gv_device), ARV_GVBS_MESSAGE_CHANNEL_PORT_OFFSET, 0, NULL);
+
+	g_cancellable_cancel (event_data->cancellable);
+	g_thread_join (priv->event_thread);
+	g_clear_object (&event_data->cancellable);
+	g_clear_object (&event_data->socket);
+	g_free (event_data);
+
+	priv->event_data = NULL;
+	priv->event_thread = NULL;
 }
 
 /* ArvGvDevice implemenation */
@@ -448,9 +1181,10 @@ arv_gv_device_take_control (ArvGvDevice *gv_device, GError **error)
 					     ARV_GVBS_CONTROL_CHANNEL_PRIVILEGE_CONTROL,
 					     error);
 
-	if (success)
+	if (success) {
+		priv->io_data->privilege = ARV_GVBS_CONTROL_CHANNEL_PRIVILEGE_CONTROL;
 		priv->io_data->is_controller = TRUE;
-	else
+	} else
 		arv_warning_device ("[GvDevice::take_control] Can't get control access");
 
 	return success;
@@ -565,8 +1299,11 @@ test_packet_check (ArvDevice *device,
 	return n_events != 0;
 }
 
+/* When @initial_size is not 0, it replaces the current packet size as the first candidate, and as the search upper
+ * bound if the check fails */
+
 static guint
-auto_packet_size (ArvGvDevice *gv_device, gboolean exit_early, GError **error)
+auto_packet_size (ArvGvDevice *gv_device, gboolean exit_early, guint initial_size, GError **error)
 {
 	ArvGvDevicePrivate *priv = arv_gv_device_get_instance_private (gv_device);
 	ArvDevice *device = ARV_DEVICE (gv_device);
@@ -637,6 +1374,12 @@ auto_packet_size (ArvGvDevice *gv_device, gboolean exit_early, GError **error)
 
 	buffer = g_malloc (max_size);
 
+	if (initial_size > 0) {
+		initial_size = CLAMP (initial_size, min_size, max_size);
+		arv_device_set_integer_feature_value (device, "GevSCPSPacketSize", initial_size, NULL);
+		packet_size = arv_device_get_integer_feature_value (device, "GevSCPSPacketSize", NULL);
+	}
+
 	success = test_packet_check (device, &poll_fd, socket, buffer, packet_size, is_command);
 
 	/* When exit_early is set, the function only checks the current packet size is working.
@@ -648,6 +1391,13 @@ auto_packet_size (ArvGvDevice *gv_device, gboolean exit_early, GError **error)
 	} else {
 		guint current_size = CLAMP (packet_size, min_size, max_size);
 
+		/* The initial size was just checked and failed, search below it */
+		if (initial_size > 0 && !success) {
+			max_size = current_size;
+			last_size = current_size;
+			current_size = (max_size - min_size) / 2 + min_size;
+		}
+
 		do {
 			current_size = ((current_size + inc - 1) / inc) * inc;
 
@@ -705,7 +1455,103 @@ auto_packet_size (ArvGvDevice *gv_device, gboolean exit_early, GError **error)
 guint
 arv_gv_device_auto_packet_size (ArvGvDevice *gv_device, GError **error)
 {
-	return auto_packet_size (gv_device, FALSE, error);
+	return auto_packet_size (gv_device, FALSE, 0, error);
+}
+
+static GMutex packet_size_cache_mutex;
+static GHashTable *packet_size_cache = NULL;
+
+static char *
+_build_packet_size_key (ArvGvDevice *gv_device, guint channel)
+{
+	ArvGvDevicePrivate *priv = arv_gv_device_get_instance_private (gv_device);
+	g_autofree char *interface_string = NULL;
+	g_autofree char *device_string = NULL;
+	g_autofree char *id = NULL;
+
+	interface_string = g_inet_address_to_string (priv->interface_address);
+	device_string = g_inet_address_to_string (priv->device_address);
+	id = g_strdup_printf ("%s\n%s\n%u", interface_string, device_string, channel);
+
+	return g_compute_checksum_for_string (G_CHECKSUM_SHA1, id, -1);
+}
+
+/* The in-process table is first looked up, then the on-disk cache if enabled by arv_enable_genicam_cache() */
+
+static guint
+_packet_size_cache_lookup (const char *key)
+{
+	guint packet_size = 0;
+
+	g_mutex_lock (&packet_size_cache_mutex);
+	if (packet_size_cache != NULL)
+		packet_size = GPOINTER_TO_UINT (g_hash_table_lookup (packet_size_cache, key));
+	g_mutex_unlock (&packet_size_cache_mutex);
+
+	if (packet_size == 0)
+		packet_size = arv_genicam_cache_load_packet_size (key);
+
+	return packet_size;
+}
+
+static void
+_packet_size_cache_store (const char *key, guint packet_size)
+{
+	guint previous_size;
+
+	g_mutex_lock (&packet_size_cache_mutex);
+	if (packet_size_cache == NULL)
+		packet_size_cache = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+	previous_size = GPOINTER_TO_UINT (g_hash_table_lookup (packet_size_cache, key));
+	g_hash_table_replace (packet_size_cache, g_strdup (key), GUINT_TO_POINTER (packet_size));
+	g_mutex_unlock (&packet_size_cache_mutex);
+
+	if (previous_size != packet_size)
+		arv_genicam_cache_store_packet_size (key, packet_size);
+}
+
+/* Checks the last working packet size of this interface, device and channel triplet, and only runs the full search
+ * if the check fails. Without a cached value, the host path MTU is tried first. */
+
+static guint
+cached_packet_size (ArvGvDevice *gv_device, guint channel, GError **error)
+{
+	ArvGvDevicePrivate *priv = arv_gv_device_get_instance_private (gv_device);
+	g_autofree char *key = NULL;
+	GError *local_error = NULL;
+	guint initial_size;
+	guint packet_size;
+
+	key = _build_packet_size_key (gv_device, channel);
+
+	initial_size = _packet_size_cache_lookup (key);
+	if (initial_size > 0) {
+		arv_info_device ("[GvDevice::cached_packet_size] Cached packet size = %u", initial_size);
+	} else {
+		initial_size = arv_network_get_path_mtu (priv->interface_address, priv->device_address);
+		if (initial_size > 0)
+			arv_info_device ("[GvDevice::cached_packet_size] Path MTU = %u", initial_size);
+		else {
+			ArvNetworkInterface *iface;
+
+			iface = arv_network_interface_lookup (priv->interface_address);
+			if (iface != NULL)
+				initial_size = arv_network_interface_get_mtu (iface);
+			arv_network_interface_free (iface);
+			if (initial_size > 0)
+				arv_info_device ("[GvDevice::cached_packet_size] Interface MTU = %u", initial_size);
+		}
+	}
+
+	packet_size = auto_packet_size (gv_device, TRUE, initial_size, &local_error);
+	if (local_error != NULL) {
+		g_propagate_error (error, local_error);
+		return packet_size;
+	}
+
+	_packet_size_cache_store (key, packet_size);
+
+	return packet_size;
 }
 
 /**
@@ -719,6 +1565,10 @@ arv_gv_device_auto_packet_size (ArvGvDevice *gv_device, GError **error)
  * check fails, and only the first time arv_device_create_stream() is successfully called during @gv_device instance
  * life.
  *
+ * With @ARV_GV_PACKET_SIZE_ADJUSTMENT_CACHED, the last packet size that worked for the same interface, device and
+ * stream channel is checked first, and the search only runs if this check fails. The working values are kept for the
+ * process life, and on disk if arv_enable_genicam_cache() was called.
+ *
  * Since: 0.8.3
  */
 
@@ -751,6 +1601,73 @@ arv_gv_device_is_controller (ArvGvDevice *gv_device)
 	return priv->io_data->is_controller;
 }
 
+/* Returns %NULL if the GenICam cache is disabled */
+
+static char *
+_get_genicam_cache_key (ArvGvDevice *gv_device, const char *url)
+{
+	/* Manufacturer name, model name and device version are contiguous */
+	char strings[ARV_GVBS_MANUFACTURER_NAME_SIZE + ARV_GVBS_MODEL_NAME_SIZE + ARV_GVBS_DEVICE_VERSION_SIZE];
+	g_autofree char *vendor = NULL;
+	g_autofree char *model = NULL;
+	g_autofree char *version = NULL;
+
+	if (!arv_genicam_cache_is_enabled ())
+		return NULL;
+
+	if (!arv_device_read_memory (ARV_DEVICE (gv_device), ARV_GVBS_MANUFACTURER_NAME_OFFSET,
+				     sizeof (strings), strings, NULL))
+		return NULL;
+
+	vendor = g_strndup (strings, ARV_GVBS_MANUFACTURER_NAME_SIZE);
+	model = g_strndup (strings + ARV_GVBS_MODEL_NAME_OFFSET - ARV_GVBS_MANUFACTURER_NAME_OFFSET,
+			   ARV_GVBS_MODEL_NAME_SIZE);
+	version = g_strndup (strings + ARV_GVBS_DEVICE_VERSION_OFFSET - ARV_GVBS_MANUFACTURER_NAME_OFFSET,
+			     ARV_GVBS_DEVICE_VERSION_SIZE);
+
+	return arv_genicam_cache_build_key (vendor, model, version, url);
+}
+
+#define ARV_GV_DEVICE_GENICAM_CHUNK_SIZE	65536
+
+/* Inflates the first entry of the zipped GenICam data while it is read, chunk by chunk, without keeping the
+ * compressed data, and stops reading at the end of the entry. Returns %NULL if the archive can't be extracted this
+ * way. */
+
+static char *
+_read_zipped_genicam (ArvGvDevice *gv_device, guint64 address, guint64 file_size, size_t *size)
+{
+	ArvZipStream *stream;
+	guint8 *chunk;
+	guint64 offset;
+	char *genicam;
+
+	stream = arv_zip_stream_new ();
+	chunk = g_malloc (ARV_GV_DEVICE_GENICAM_CHUNK_SIZE);
+
+	for (offset = 0; offset < file_size && !arv_zip_stream_is_done (stream);) {
+		guint32 chunk_size = MIN (ARV_GV_DEVICE_GENICAM_CHUNK_SIZE, file_size - offset);
+
+		if (!arv_device_read_memory (ARV_DEVICE (gv_device), address + offset, chunk_size, chunk, NULL) ||
+		    !arv_zip_stream_feed (stream, chunk, chunk_size))
+			break;
+
+		offset += chunk_size;
+	}
+
+	genicam = arv_zip_stream_steal_file (stream, size);
+
+	if (genicam != NULL)
+		arv_info_device ("[GvDevice::load_genicam] Inflated %" G_GSIZE_FORMAT " bytes from "
+				 "%" G_GUINT64_FORMAT " of %" G_GUINT64_FORMAT " zipped bytes",
+				 *size, offset, file_size);
+
+	g_free (chunk);
+	arv_zip_stream_free (stream);
+
+	return genicam;
+}
+
 static char *
 _load_genicam (ArvGvDevice *gv_device, guint32 address, size_t  *size, GError **error)
 {
@@ -758,6 +1675,7 @@ _load_genicam (ArvGvDevice *gv_device, guint32 address, size_t  *size, GError **
 	char *genicam = NULL;
 	g_autofree char *scheme = NULL;
 	g_autofree char *path = NULL;
+	g_autofree char *cache_key = NULL;
 	guint64 file_address;
 	guint64 file_size;
 
@@ -786,6 +1704,24 @@ _load_genicam (ArvGvDevice *gv_device, guint32 address, size_t  *size, GError **
 				  "size = 0x%" G_GINT64_MODIFIER "x - %s", file_address, file_size, path);
 
 		if (file_size > 0) {
+			cache_key = _get_genicam_cache_key (gv_device, filename);
+			genicam = arv_genicam_cache_load (cache_key, size);
+			if (genicam != NULL)
+				return genicam;
+
+			/* The raw data dump of the debug output needs the whole archive */
+			if (g_str_has_suffix (path, ".zip") &&
+			    !arv_debug_check (ARV_DEBUG_CATEGORY_MISC, ARV_DEBUG_LEVEL_DEBUG)) {
+				genicam = _read_zipped_genicam (gv_device, file_address, file_size, size);
+				if (genicam != NULL) {
+					arv_genicam_cache_store (cache_key, genicam, *size);
+					return genicam;
+				}
+
+				arv_info_device ("[GvDevice::load_genicam] Zip streaming failed, "
+						 "reading the whole archive");
+			}
+
 			genicam = g_malloc (file_size);
 			if (arv_device_read_memory (ARV_DEVICE (gv_device), file_address, file_size,
 						    genicam, NULL)) {
@@ -829,6 +1765,8 @@ _load_genicam (ArvGvDevice *gv_device, guint32 address, size_t  *size, GError **
 					arv_zip_free (zip);
 				}
 				*size = file_size;
+
+				arv_genicam_cache_store (cache_key, genicam, *size);
 			} else {
 				g_free (genicam);
 				genicam = NULL;
@@ -1072,6 +2010,22 @@ arv_gv_device_load_genicam (ArvGvDevice *gv_device, GError **error)
 					      "  <Endianess>BigEndian</Endianess>"
 					      "</MaskedIntReg>",
 					      NULL);
+		arv_gc_set_default_node_data (priv->genicam, "GevSCPD",
+					      "<Integer Name=\"GevSCPD\">"
+					      "  <Visibility>Expert</Visibility>"
+					      "  <pValue>ArvGevSCPDReg</pValue>"
+					      "</Integer>",
+					      "<IntReg Name=\"ArvGevSCPDReg\">"
+					      "  <Address>0xd08</Address>"
+					      "  <pAddress>GevSCPAddrCalc</pAddress>"
+					      "  <Length>4</Length>"
+					      "  <AccessMode>RW</AccessMode>"
+					      "  <pPort>Device</pPort>"
+					      "  <Cachable>NoCache</Cachable>"
+					      "  <Sign>Unsigned</Sign>"
+					      "  <Endianess>BigEndian</Endianess>"
+					      "</IntReg>",
+					      NULL);
 		arv_gc_set_default_node_data (priv->genicam, "GevSCDA",
 					      "<Integer Name=\"GevSCDA\">"
 					      "  <Visibility>Expert</Visibility>"
@@ -1135,101 +2089,287 @@ arv_gv_device_load_genicam (ArvGvDevice *gv_device, GError **error)
 	}
 }
 
-/* ArvDevice implemenation */
+/* Selects the stream channel the GevSCP* features refer to, and returns the previously selected one. Devices without a
+ * stream channel selector only have the channel 0. */
+
+static guint
+_select_stream_channel (ArvGvDevice *gv_device, guint channel)
+{
+	ArvDevice *device = ARV_DEVICE (gv_device);
+	const char *selector;
+	guint previous;
+
+	selector = arv_device_is_feature_available (device, "GevStreamChannelSelector", NULL) ?
+		"GevStreamChannelSelector" : "ArvGevStreamChannelSelector";
+
+	previous = arv_device_get_integer_feature_value (device, selector, NULL);
+	if (previous != channel)
+		arv_device_set_integer_feature_value (device, selector, channel, NULL);
+
+	return previous;
+}
+
+static ArvStream *
+_create_stream (ArvGvDevice *gv_device, guint channel, ArvStreamCallback callback, void *user_data, GError **error)
+{
+	ArvDevice *device = ARV_DEVICE (gv_device);
+	ArvGvDevicePrivate *priv = arv_gv_device_get_instance_private (gv_device);
+	ArvStream *stream;
+	guint32 n_stream_channels;
+	guint previous_channel;
+	GError *local_error = NULL;
+
+	n_stream_channels = arv_device_get_integer_feature_value (device, "GevStreamChannelCount", NULL);
+	arv_info_device ("[GvDevice::create_stream] Number of stream channels = %d", n_stream_channels);
+
+	if (n_stream_channels < 1) {
+		g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_NO_STREAM_CHANNEL,
+			     "No stream channel found");
+		return NULL;
+	}
+
+	if (channel >= n_stream_channels) {
+		g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_NO_STREAM_CHANNEL,
+			     "Stream channel %u not found (%u channel(s))", channel, n_stream_channels);
+		return NULL;
+	}
+
+	if (!priv->io_data->is_controller) {
+		arv_warning_device ("[GvDevice::create_stream] Can't create stream without control access");
+		g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_NOT_CONTROLLER,
+			     "Controller privilege required for streaming control");
+		return NULL;
+	}
+
+	/* The packet size and the SCP registers written by the stream refer to the selected channel */
+	previous_channel = _select_stream_channel (gv_device, channel);
+
+	if (priv->packet_size_adjustment == ARV_GV_PACKET_SIZE_ADJUSTMENT_CACHED) {
+		cached_packet_size (gv_device, channel, &local_error);
+		if (local_error != NULL) {
+			_select_stream_channel (gv_device, previous_channel);
+			g_propagate_error (error, local_error);
+			return NULL;
+		}
+	} else if (priv->packet_size_adjustment != ARV_GV_PACKET_SIZE_ADJUSTMENT_NEVER &&
+	    ((priv->packet_size_adjustment != ARV_GV_PACKET_SIZE_ADJUSTMENT_ONCE &&
+	      priv->packet_size_adjustment != ARV_GV_PACKET_SIZE_ADJUSTMENT_ON_FAILURE_ONCE) ||
+	     !priv->first_stream_created)) {
+		auto_packet_size (gv_device,
+				  priv->packet_size_adjustment == ARV_GV_PACKET_SIZE_ADJUSTMENT_ON_FAILURE ||
+				      priv->packet_size_adjustment == ARV_GV_PACKET_SIZE_ADJUSTMENT_ON_FAILURE_ONCE,
+				  0, &local_error);
+		if (local_error != NULL) {
+			_select_stream_channel (gv_device, previous_channel);
+			g_propagate_error (error, local_error);
+			return NULL;
+		}
+	}
+
+	stream = arv_gv_stream_new (gv_device, channel, callback, user_data, error);
+
+	_select_stream_channel (gv_device, previous_channel);
+
+	if (!ARV_IS_STREAM (stream))
+		return NULL;
+
+	if (!priv->is_packet_resend_supported)
+		g_object_set (stream, "packet-resend", ARV_GV_STREAM_PACKET_RESEND_NEVER, NULL);
+
+	priv->first_stream_created = TRUE;
+
+	return stream;
+}
+
+/**
+ * arv_gv_device_create_channel_stream:
+ * @gv_device: a #ArvGvDevice
+ * @channel: stream channel index, between 0 and GevStreamChannelCount - 1
+ * @callback: (scope call) (allow-none): a frame processing callback
+ * @user_data: (closure) (allow-none): user data for @callback
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Creates a new #ArvStream receiving the data of the stream channel @channel. Each stream has its own socket,
+ * receiving thread and statistics, so the streams of the different channels of a device can be created and used
+ * independently. arv_device_create_stream() receives the channel 0.
+ *
+ * Returns: (transfer full): a new #ArvStream, to be freed after use with g_object_unref().
+ *
+ * Since: 0.8.11
+ */
+
+ArvStream *
+arv_gv_device_create_channel_stream (ArvGvDevice *gv_device, guint channel,
+				     ArvStreamCallback callback, void *user_data, GError **error)
+{
+	g_return_val_if_fail (ARV_IS_GV_DEVICE (gv_device), NULL);
+
+	return _create_stream (gv_device, channel, callback, user_data, error);
+}
+
+/* ArvDevice implemenation */
+
+static ArvStream *
+arv_gv_device_create_stream (ArvDevice *device, ArvStreamCallback callback, void *user_data, GError **error)
+{
+	return _create_stream (ARV_GV_DEVICE (device), 0, callback, user_data, error);
+}
+
+static ArvGc *
+arv_gv_device_get_genicam (ArvDevice *device)
+{
+	ArvGvDevicePrivate *priv = arv_gv_device_get_instance_private (ARV_GV_DEVICE (device));
+
+	return priv->genicam;
+}
+
+/* Register write batch. While a batch is open, the register writes and the 4 byte memory writes are queued, and the
+ * reads return the queued values, so the GenICam read-modify-write sequences keep working. Any other write sends the
+ * queued writes first, in order to preserve the write ordering. Must be called with the batch mutex locked. */
+
+static void
+_batch_patch_memory (ArvGvDevicePrivate *priv, guint64 address, guint32 size, void *buffer)
+{
+	guint i;
+
+	for (i = 0; i < priv->batch_addresses->len; i++) {
+		guint32 batch_address = g_array_index (priv->batch_addresses, guint32, i);
+
+		if (batch_address >= address && batch_address + sizeof (guint32) <= address + size) {
+			guint32 value = GUINT32_TO_BE (g_array_index (priv->batch_values, guint32, i));
+
+			memcpy ((char *) buffer + (batch_address - address), &value, sizeof (guint32));
+		}
+	}
+}
+
+static void
+_batch_patch_registers (ArvGvDevicePrivate *priv, guint n_registers, const guint64 *addresses, guint32 *values)
+{
+	guint i, j;
+
+	for (i = 0; i < priv->batch_addresses->len; i++) {
+		guint32 batch_address = g_array_index (priv->batch_addresses, guint32, i);
+
+		for (j = 0; j < n_registers; j++)
+			if (addresses[j] == batch_address)
+				values[j] = g_array_index (priv->batch_values, guint32, i);
+	}
+}
+
+static void
+_batch_append (ArvGvDevicePrivate *priv, guint32 address, guint32 value)
+{
+	g_array_append_val (priv->batch_addresses, address);
+	g_array_append_val (priv->batch_values, value);
+}
 
-static ArvStream *
-arv_gv_device_create_stream (ArvDevice *device, ArvStreamCallback callback, void *user_data, GError **error)
+/* The registers are written by batches of up to ARV_GVCP_N_WRITE_REGISTERS_MAX, one WRITEREG command each. The
+ * device stops at the first failed write, which is reported with its index and address. */
+
+static gboolean
+_write_registers_batched (ArvGvDevicePrivate *priv, guint n_registers, const guint32 *addresses, const guint32 *values,
+			  guint *n_written, GError **error)
 {
-	ArvGvDevice *gv_device = ARV_GV_DEVICE (device);
-	ArvGvDevicePrivate *priv = arv_gv_device_get_instance_private (gv_device);
-	ArvStream *stream;
-	guint32 n_stream_channels;
 	GError *local_error = NULL;
+	guint i;
 
-	n_stream_channels = arv_device_get_integer_feature_value (device, "GevStreamChannelCount", NULL);
-	arv_info_device ("[GvDevice::create_stream] Number of stream channels = %d", n_stream_channels);
+	if (n_written != NULL)
+		*n_written = 0;
 
-	if (n_stream_channels < 1) {
-		g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_NO_STREAM_CHANNEL,
-			     "No stream channel found");
-		return NULL;
-	}
+	for (i = 0; i < n_registers; i += ARV_GVCP_N_WRITE_REGISTERS_MAX) {
+		guint n_batch_registers = MIN (ARV_GVCP_N_WRITE_REGISTERS_MAX, n_registers - i);
+		guint n_batch_written = 0;
 
-	if (!priv->io_data->is_controller) {
-		arv_warning_device ("[GvDevice::create_stream] Can't create stream without control access");
-		g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_NOT_CONTROLLER,
-			     "Controller privilege required for streaming control");
-		return NULL;
-	}
+		_write_registers (priv->io_data, &addresses[i], n_batch_registers, &values[i],
+				  &n_batch_written, &local_error);
+
+		n_batch_written = MIN (n_batch_written, n_batch_registers);
+		if (n_written != NULL)
+			*n_written += n_batch_written;
 
-	if (priv->packet_size_adjustment != ARV_GV_PACKET_SIZE_ADJUSTMENT_NEVER &&
-	    ((priv->packet_size_adjustment != ARV_GV_PACKET_SIZE_ADJUSTMENT_ONCE &&
-	      priv->packet_size_adjustment != ARV_GV_PACKET_SIZE_ADJUSTMENT_ON_FAILURE_ONCE) ||
-	     !priv->first_stream_created)) {
-		auto_packet_size (gv_device,
-				  priv->packet_size_adjustment == ARV_GV_PACKET_SIZE_ADJUSTMENT_ON_FAILURE ||
-				      priv->packet_size_adjustment == ARV_GV_PACKET_SIZE_ADJUSTMENT_ON_FAILURE_ONCE,
-				  &local_error);
 		if (local_error != NULL) {
+			if (local_error->code == ARV_DEVICE_ERROR_PROTOCOL_ERROR)
+				g_prefix_error (&local_error, "Register write %u (0x%08x): ",
+						i + n_batch_written, addresses[i + n_batch_written]);
 			g_propagate_error (error, local_error);
-			return NULL;
+			return FALSE;
 		}
 	}
 
-	stream = arv_gv_stream_new (gv_device, callback, user_data, error);
-	if (!ARV_IS_STREAM (stream))
-		return NULL;
-
-	if (!priv->is_packet_resend_supported)
-		g_object_set (stream, "packet-resend", ARV_GV_STREAM_PACKET_RESEND_NEVER, NULL);
-
-	priv->first_stream_created = TRUE;
-
-	return stream;
+	return TRUE;
 }
 
-static ArvGc *
-arv_gv_device_get_genicam (ArvDevice *device)
+static gboolean
+_batch_flush (ArvGvDevicePrivate *priv, guint *n_written, GError **error)
 {
-	ArvGvDevicePrivate *priv = arv_gv_device_get_instance_private (ARV_GV_DEVICE (device));
+	gboolean success;
 
-	return priv->genicam;
+	success = _write_registers_batched (priv, priv->batch_addresses->len,
+					    (guint32 *) priv->batch_addresses->data,
+					    (guint32 *) priv->batch_values->data,
+					    n_written, error);
+
+	g_array_set_size (priv->batch_addresses, 0);
+	g_array_set_size (priv->batch_values, 0);
+
+	return success;
 }
 
 static gboolean
 arv_gv_device_read_memory (ArvDevice *device, guint64 address, guint32 size, void *buffer, GError **error)
 {
 	ArvGvDevicePrivate *priv = arv_gv_device_get_instance_private (ARV_GV_DEVICE (device));
-	int i;
-	gint32 block_size;
-
-	for (i = 0; i < (size + ARV_GVCP_DATA_SIZE_MAX - 1) / ARV_GVCP_DATA_SIZE_MAX; i++) {
-		block_size = MIN (ARV_GVCP_DATA_SIZE_MAX, size - i * ARV_GVCP_DATA_SIZE_MAX);
-		if (!_read_memory (priv->io_data,
-				   address + i * ARV_GVCP_DATA_SIZE_MAX,
-				   block_size, ((char *) buffer) + i * ARV_GVCP_DATA_SIZE_MAX, error))
+
+	if (size <= ARV_GVCP_DATA_SIZE_MAX) {
+		if (!_read_memory (priv->io_data, address, size, buffer, error))
 			return FALSE;
+	} else if (!_read_memory_pipelined (priv->io_data, address, size, buffer, error))
+		return FALSE;
+
+	if (G_UNLIKELY (g_atomic_int_get (&priv->batch_active))) {
+		g_mutex_lock (&priv->batch_mutex);
+		_batch_patch_memory (priv, address, size, buffer);
+		g_mutex_unlock (&priv->batch_mutex);
 	}
 
 	return TRUE;
 }
 
+static gboolean
+_write_memory_unbatched (ArvGvDevicePrivate *priv, guint64 address, guint32 size, void *buffer, GError **error)
+{
+	if (size <= ARV_GVCP_DATA_SIZE_MAX)
+		return _write_memory (priv->io_data, address, size, buffer, error);
+
+	return _write_memory_pipelined (priv->io_data, address, size, buffer, error);
+}
+
 static gboolean
 arv_gv_device_write_memory (ArvDevice *device, guint64 address, guint32 size, void *buffer, GError **error)
 {
 	ArvGvDevicePrivate *priv = arv_gv_device_get_instance_private (ARV_GV_DEVICE (device));
-	int i;
-	gint32 block_size;
-
-	for (i = 0; i < (size + ARV_GVCP_DATA_SIZE_MAX - 1) / ARV_GVCP_DATA_SIZE_MAX; i++) {
-		block_size = MIN (ARV_GVCP_DATA_SIZE_MAX, size - i * ARV_GVCP_DATA_SIZE_MAX);
-		if (!_write_memory (priv->io_data,
-				    address + i * ARV_GVCP_DATA_SIZE_MAX,
-				    block_size, ((char *) buffer) + i * ARV_GVCP_DATA_SIZE_MAX, error))
-			return FALSE;
+	gboolean success;
+
+	if (G_LIKELY (!g_atomic_int_get (&priv->batch_active)))
+		return _write_memory_unbatched (priv, address, size, buffer, error);
+
+	g_mutex_lock (&priv->batch_mutex);
+
+	if (size == sizeof (guint32) && address % sizeof (guint32) == 0 && address <= G_MAXUINT32) {
+		guint32 value;
+
+		memcpy (&value, buffer, sizeof (guint32));
+		_batch_append (priv, address, GUINT32_FROM_BE (value));
+		success = TRUE;
+	} else {
+		success = _batch_flush (priv, NULL, error) &&
+			_write_memory_unbatched (priv, address, size, buffer, error);
 	}
 
-	return TRUE;
+	g_mutex_unlock (&priv->batch_mutex);
+
+	return success;
 }
 
 static gboolean
@@ -1237,7 +2377,47 @@ arv_gv_device_read_register (ArvDevice *device, guint64 address, guint32 *value,
 {
 	ArvGvDevicePrivate *priv = arv_gv_device_get_instance_private (ARV_GV_DEVICE (device));
 
-	return _read_register (priv->io_data, address, value, error);
+	if (!_read_register (priv->io_data, address, value, error))
+		return FALSE;
+
+	if (G_UNLIKELY (g_atomic_int_get (&priv->batch_active))) {
+		g_mutex_lock (&priv->batch_mutex);
+		_batch_patch_registers (priv, 1, &address, value);
+		g_mutex_unlock (&priv->batch_mutex);
+	}
+
+	return TRUE;
+}
+
+/* The registers are read by batches of up to ARV_GVCP_N_READ_REGISTERS_MAX, one READREG command each */
+
+static gboolean
+arv_gv_device_read_registers (ArvDevice *device, guint n_registers, const guint64 *addresses, guint32 *values,
+			      GError **error)
+{
+	ArvGvDevicePrivate *priv = arv_gv_device_get_instance_private (ARV_GV_DEVICE (device));
+	guint32 batch_addresses[ARV_GVCP_N_READ_REGISTERS_MAX];
+	guint i, j;
+
+	for (i = 0; i < n_registers; i += ARV_GVCP_N_READ_REGISTERS_MAX) {
+		guint n_batch_registers = MIN (ARV_GVCP_N_READ_REGISTERS_MAX, n_registers - i);
+
+		for (j = 0; j < n_batch_registers; j++)
+			batch_addresses[j] = addresses[i + j];
+
+		if (!_read_registers (priv->io_data, batch_addresses, n_batch_registers, &values[i], error)) {
+			memset (values, 0, n_registers * sizeof (guint32));
+			return FALSE;
+		}
+	}
+
+	if (G_UNLIKELY (g_atomic_int_get (&priv->batch_active))) {
+		g_mutex_lock (&priv->batch_mutex);
+		_batch_patch_registers (priv, n_registers, addresses, values);
+		g_mutex_unlock (&priv->batch_mutex);
+	}
+
+	return TRUE;
 }
 
 static gboolean
@@ -1245,9 +2425,73 @@ arv_gv_device_write_register (ArvDevice *device, guint64 address, guint32 value,
 {
 	ArvGvDevicePrivate *priv = arv_gv_device_get_instance_private (ARV_GV_DEVICE (device));
 
+	if (G_UNLIKELY (g_atomic_int_get (&priv->batch_active))) {
+		g_mutex_lock (&priv->batch_mutex);
+		_batch_append (priv, address, value);
+		g_mutex_unlock (&priv->batch_mutex);
+
+		return TRUE;
+	}
+
 	return _write_register (priv->io_data, address, value, error);
 }
 
+static gboolean
+arv_gv_device_write_registers (ArvDevice *device, guint n_registers, const guint64 *addresses, const guint32 *values,
+			       guint *n_written, GError **error)
+{
+	ArvGvDevicePrivate *priv = arv_gv_device_get_instance_private (ARV_GV_DEVICE (device));
+	guint32 *register_addresses;
+	gboolean success;
+	guint i;
+
+	if (G_UNLIKELY (g_atomic_int_get (&priv->batch_active))) {
+		g_mutex_lock (&priv->batch_mutex);
+		for (i = 0; i < n_registers; i++)
+			_batch_append (priv, addresses[i], values[i]);
+		g_mutex_unlock (&priv->batch_mutex);
+
+		if (n_written != NULL)
+			*n_written = n_registers;
+
+		return TRUE;
+	}
+
+	register_addresses = g_new (guint32, n_registers);
+	for (i = 0; i < n_registers; i++)
+		register_addresses[i] = addresses[i];
+
+	success = _write_registers_batched (priv, n_registers, register_addresses, values, n_written, error);
+
+	g_free (register_addresses);
+
+	return success;
+}
+
+static void
+arv_gv_device_begin_batch (ArvDevice *device)
+{
+	ArvGvDevicePrivate *priv = arv_gv_device_get_instance_private (ARV_GV_DEVICE (device));
+
+	g_mutex_lock (&priv->batch_mutex);
+	g_atomic_int_set (&priv->batch_active, TRUE);
+	g_mutex_unlock (&priv->batch_mutex);
+}
+
+static gboolean
+arv_gv_device_commit_batch (ArvDevice *device, guint *n_written, GError **error)
+{
+	ArvGvDevicePrivate *priv = arv_gv_device_get_instance_private (ARV_GV_DEVICE (device));
+	gboolean success;
+
+	g_mutex_lock (&priv->batch_mutex);
+	g_atomic_int_set (&priv->batch_active, FALSE);
+	success = _batch_flush (priv, n_written, error);
+	g_mutex_unlock (&priv->batch_mutex);
+
+	return success;
+}
+
 /**
  * arv_gv_device_get_stream_options:
  * @gv_device: a #ArvGvDevice
@@ -1287,6 +2531,242 @@ arv_gv_device_set_stream_options (ArvGvDevice *gv_device, ArvGvStreamOption opti
 	priv->stream_options = options;
 }
 
+/**
+ * arv_gv_device_set_packet_resend_bandwidth:
+ * @gv_device: a #ArvGvDevice
+ * @bandwidth: maximum resend bandwidth, in bytes per second, 0 for no limit
+ *
+ * Limits the bandwidth of the packets requested for resend, summed over all the streams of @gv_device. The
+ * requests exceeding the budget are postponed until the packet timeout expires, in order to avoid worsening a link
+ * congestion by a burst of resent packets.
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_gv_device_set_packet_resend_bandwidth (ArvGvDevice *gv_device, guint64 bandwidth)
+{
+	ArvGvDevicePrivate *priv = arv_gv_device_get_instance_private (gv_device);
+
+	g_return_if_fail (ARV_IS_GV_DEVICE (gv_device));
+
+	g_mutex_lock (&priv->resend_mutex);
+	priv->packet_resend_bandwidth = bandwidth;
+	priv->resend_budget = bandwidth * ARV_GV_DEVICE_PACKET_RESEND_BURST_US / 1000000;
+	priv->resend_budget_time_us = g_get_monotonic_time ();
+	g_mutex_unlock (&priv->resend_mutex);
+}
+
+/**
+ * arv_gv_device_get_packet_resend_bandwidth:
+ * @gv_device: a #ArvGvDevice
+ *
+ * Returns: the maximum resend bandwidth, in bytes per second, 0 meaning no limit
+ *
+ * Since: 0.8.11
+ */
+
+guint64
+arv_gv_device_get_packet_resend_bandwidth (ArvGvDevice *gv_device)
+{
+	ArvGvDevicePrivate *priv = arv_gv_device_get_instance_private (gv_device);
+
+	g_return_val_if_fail (ARV_IS_GV_DEVICE (gv_device), 0);
+
+	return priv->packet_resend_bandwidth;
+}
+
+/* Token bucket, allowing bursts of ARV_GV_DEVICE_PACKET_RESEND_BURST_US worth of bandwidth. A request is granted as
+ * long as the budget is positive, the overshoot being paid back by the following ones. */
+
+gboolean
+arv_gv_device_consume_packet_resend_budget (ArvGvDevice *gv_device, guint64 n_bytes, guint64 time_us)
+{
+	ArvGvDevicePrivate *priv = arv_gv_device_get_instance_private (gv_device);
+	gboolean granted = TRUE;
+
+	g_return_val_if_fail (ARV_IS_GV_DEVICE (gv_device), TRUE);
+
+	g_mutex_lock (&priv->resend_mutex);
+
+	priv->resend_request_time_us = time_us;
+
+	if (priv->packet_resend_bandwidth > 0) {
+		gint64 burst = priv->packet_resend_bandwidth * ARV_GV_DEVICE_PACKET_RESEND_BURST_US / 1000000;
+
+		if (time_us > priv->resend_budget_time_us) {
+			priv->resend_budget = MIN (burst,
+						   priv->resend_budget +
+						   (gint64) (priv->packet_resend_bandwidth *
+							     (time_us - priv->resend_budget_time_us) / 1000000));
+			priv->resend_budget_time_us = time_us;
+		}
+
+		granted = priv->resend_budget > 0;
+		if (granted)
+			priv->resend_budget -= n_bytes;
+	}
+
+	g_mutex_unlock (&priv->resend_mutex);
+
+	return granted;
+}
+
+/* The streams are considered under resend pressure for ARV_GV_DEVICE_RESEND_PRESSURE_US after a resend request */
+
+static gboolean
+arv_gv_device_has_resend_pressure (ArvDevice *device)
+{
+	ArvGvDevicePrivate *priv = arv_gv_device_get_instance_private (ARV_GV_DEVICE (device));
+	guint64 resend_request_time_us;
+
+	g_mutex_lock (&priv->resend_mutex);
+	resend_request_time_us = priv->resend_request_time_us;
+	g_mutex_unlock (&priv->resend_mutex);
+
+	return resend_request_time_us > 0 &&
+		g_get_monotonic_time () < resend_request_time_us + ARV_GV_DEVICE_RESEND_PRESSURE_US;
+}
+
+/* Waits for the device to answer again at the same address, checks it is the same device, takes the control again and
+ * replays the configuration. The stream sockets are kept, the stream destination is restored by the replay of
+ * GevSCDA and GevSCPHostPort. */
+
+static gboolean
+arv_gv_device_reconnect (ArvDevice *device, guint timeout_ms, GError **error)
+{
+	ArvGvDevice *gv_device = ARV_GV_DEVICE (device);
+	ArvGvDevicePrivate *priv = arv_gv_device_get_instance_private (gv_device);
+	char serial_number[ARV_GVBS_SERIAL_NUMBER_SIZE];
+	gint64 end_time_us;
+	gboolean found = FALSE;
+
+	if (!priv->init_success) {
+		g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_NOT_CONNECTED,
+			     "Device was not successfully initialized");
+		return FALSE;
+	}
+
+	priv->io_data->is_controller = FALSE;
+
+	end_time_us = g_get_monotonic_time () + (gint64) timeout_ms * 1000;
+
+	do {
+		if (_read_memory (priv->io_data, ARV_GVBS_SERIAL_NUMBER_OFFSET, ARV_GVBS_SERIAL_NUMBER_SIZE,
+				  serial_number, NULL)) {
+			found = TRUE;
+			break;
+		}
+		g_usleep (ARV_GV_DEVICE_RECONNECT_POLL_DELAY_US);
+	} while (g_get_monotonic_time () < end_time_us);
+
+	if (!found) {
+		g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_TIMEOUT,
+			     "Device did not answer within %u ms", timeout_ms);
+		return FALSE;
+	}
+
+	if (memcmp (serial_number, priv->serial_number, ARV_GVBS_SERIAL_NUMBER_SIZE) != 0) {
+		g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_NOT_FOUND,
+			     "Device serial number changed from '%.*s' to '%.*s'",
+			     ARV_GVBS_SERIAL_NUMBER_SIZE, priv->serial_number,
+			     ARV_GVBS_SERIAL_NUMBER_SIZE, serial_number);
+		return FALSE;
+	}
+
+	if (!arv_gv_device_take_control (gv_device, error))
+		return FALSE;
+
+	arv_device_journal_replay (device);
+
+	arv_info_device ("[GvDevice::reconnect] Device '%.*s' reconnected",
+			 ARV_GVBS_SERIAL_NUMBER_SIZE, priv->serial_number);
+
+	return TRUE;
+}
+
+/**
+ * arv_gv_device_set_command_window:
+ * @gv_device: a #ArvGvDevice
+ * @n_commands: maximum number of commands in flight, at least 1
+ *
+ * Sets how many control commands can be sent at the same time, without waiting for the acknowledge of the previous
+ * ones. The GigEVision specification only requires the devices to handle one outstanding command, which is the
+ * default. A larger window allows the commands issued from several threads, like register polling and memory reads,
+ * to overlap, on devices supporting it.
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_gv_device_set_command_window (ArvGvDevice *gv_device, guint n_commands)
+{
+	ArvGvDevicePrivate *priv = arv_gv_device_get_instance_private (gv_device);
+	ArvGvDeviceIOData *io_data;
+
+	g_return_if_fail (ARV_IS_GV_DEVICE (gv_device));
+	g_return_if_fail (n_commands > 0);
+
+	io_data = priv->io_data;
+	if (io_data == NULL)
+		return;
+
+	g_mutex_lock (&io_data->mutex);
+	io_data->command_window = n_commands;
+	g_cond_broadcast (&io_data->cond);
+	g_mutex_unlock (&io_data->mutex);
+}
+
+/**
+ * arv_gv_device_get_command_window:
+ * @gv_device: a #ArvGvDevice
+ *
+ * Returns: the maximum number of control commands in flight
+ *
+ * Since: 0.8.11
+ */
+
+guint
+arv_gv_device_get_command_window (ArvGvDevice *gv_device)
+{
+	ArvGvDevicePrivate *priv = arv_gv_device_get_instance_private (gv_device);
+	guint n_commands;
+
+	g_return_val_if_fail (ARV_IS_GV_DEVICE (gv_device), 1);
+
+	if (priv->io_data == NULL)
+		return 1;
+
+	g_mutex_lock (&priv->io_data->mutex);
+	n_commands = priv->io_data->command_window;
+	g_mutex_unlock (&priv->io_data->mutex);
+
+	return n_commands;
+}
+
+/* Copies the control channel statistics */
+
+void
+arv_gv_device_get_command_statistics (ArvGvDevice *gv_device, ArvGvDeviceCommandStatistics *statistics)
+{
+	ArvGvDevicePrivate *priv = arv_gv_device_get_instance_private (gv_device);
+	ArvGvDeviceIOData *io_data;
+
+	g_return_if_fail (statistics != NULL);
+
+	memset (statistics, 0, sizeof (ArvGvDeviceCommandStatistics));
+
+	g_return_if_fail (ARV_IS_GV_DEVICE (gv_device));
+
+	io_data = priv->io_data;
+	if (io_data == NULL)
+		return;
+
+	g_mutex_lock (&io_data->mutex);
+	*statistics = io_data->statistics;
+	g_mutex_unlock (&io_data->mutex);
+}
+
 /**
  * arv_gv_device_new:
  * @interface_address: address of the interface connected to the device
@@ -1320,6 +2800,7 @@ arv_gv_device_constructed (GObject *object)
 	char *address_string;
 	guint32 capabilities;
 	guint32 device_mode;
+	guint i;
 
 	if (!G_IS_INET_ADDRESS (priv->interface_address) ||
 	    !G_IS_INET_ADDRESS (priv->device_address)) {
@@ -1338,6 +2819,10 @@ arv_gv_device_constructed (GObject *object)
 	io_data = g_new0 (ArvGvDeviceIOData, 1);
 
 	g_mutex_init (&io_data->mutex);
+	g_cond_init (&io_data->cond);
+	io_data->command_window = 1;
+	io_data->read_memory_depth = ARV_GV_DEVICE_READ_MEMORY_DEPTH_DEFAULT;
+	io_data->write_memory_depth = ARV_GV_DEVICE_WRITE_MEMORY_DEPTH_DEFAULT;
 
 	io_data->packet_id = 65300; /* Start near the end of the circular counter */
 
@@ -1358,6 +2843,8 @@ arv_gv_device_constructed (GObject *object)
 	io_data->buffer = g_malloc (ARV_GV_DEVICE_BUFFER_SIZE);
 	io_data->gvcp_n_retries = ARV_GV_DEVICE_GVCP_N_RETRIES_DEFAULT;
 	io_data->gvcp_timeout_ms = ARV_GV_DEVICE_GVCP_TIMEOUT_MS_DEFAULT;
+	for (i = 0; i < ARV_GV_DEVICE_N_COMMAND_TYPES; i++)
+		io_data->statistics.rto_us[i] = (guint64) io_data->gvcp_timeout_ms * 1000;
 	io_data->poll_in_event.fd = g_socket_get_fd (io_data->socket);
 	io_data->poll_in_event.events =  G_IO_IN;
 	io_data->poll_in_event.revents = 0;
@@ -1382,6 +2869,8 @@ arv_gv_device_constructed (GObject *object)
 
 	arv_gv_device_take_control (gv_device, NULL);
 
+	_read_memory (io_data, ARV_GVBS_SERIAL_NUMBER_OFFSET, ARV_GVBS_SERIAL_NUMBER_SIZE, priv->serial_number, NULL);
+
 	heartbeat_data = g_new (ArvGvDeviceHeartbeatData, 1);
 	heartbeat_data->gv_device = gv_device;
 	heartbeat_data->io_data = io_data;
@@ -1421,6 +2910,13 @@ arv_gv_device_init (ArvGvDevice *gv_device)
 	priv->genicam_xml = NULL;
 	priv->genicam_xml_size = 0;
 	priv->stream_options = ARV_GV_STREAM_OPTION_NONE;
+
+	g_mutex_init (&priv->resend_mutex);
+	priv->packet_resend_bandwidth = 0;
+
+	g_mutex_init (&priv->batch_mutex);
+	priv->batch_addresses = g_array_new (FALSE, FALSE, sizeof (guint32));
+	priv->batch_values = g_array_new (FALSE, FALSE, sizeof (guint32));
 }
 
 static void
@@ -1445,6 +2941,8 @@ arv_gv_device_finalize (GObject *object)
 		priv->heartbeat_thread = NULL;
 	}
 
+	arv_gv_device_disable_events (gv_device);
+
 	if (priv->init_success)
 		arv_gv_device_leave_control (gv_device, NULL);
 
@@ -1454,6 +2952,7 @@ arv_gv_device_finalize (GObject *object)
 	g_clear_object (&io_data->socket);
 	g_clear_pointer (&io_data->buffer, g_free);
 	g_mutex_clear (&io_data->mutex);
+	g_cond_clear (&io_data->cond);
 
 	arv_gpollfd_finish_all (&io_data->poll_in_event, 1);
 
@@ -1465,6 +2964,12 @@ arv_gv_device_finalize (GObject *object)
 	g_clear_object (&priv->interface_address);
 	g_clear_object (&priv->device_address);
 
+	g_mutex_clear (&priv->resend_mutex);
+
+	g_mutex_clear (&priv->batch_mutex);
+	g_array_unref (priv->batch_addresses);
+	g_array_unref (priv->batch_values);
+
 	G_OBJECT_CLASS (arv_gv_device_parent_class)->finalize (object);
 }
 
@@ -1557,6 +3062,39 @@ arv_gv_device_class_init (ArvGvDeviceClass *gv_device_class)
 	device_class->write_memory = arv_gv_device_write_memory;
 	device_class->read_register = arv_gv_device_read_register;
 	device_class->write_register = arv_gv_device_write_register;
+	device_class->read_registers = arv_gv_device_read_registers;
+	device_class->write_registers = arv_gv_device_write_registers;
+	device_class->begin_batch = arv_gv_device_begin_batch;
+	device_class->commit_batch = arv_gv_device_commit_batch;
+	device_class->has_resend_pressure = arv_gv_device_has_resend_pressure;
+	device_class->reconnect = arv_gv_device_reconnect;
+
+	/**
+	 * ArvGvDevice::event:
+	 * @gv_device: a #ArvGvDevice
+	 * @event_id: event identifier
+	 * @stream_channel_index: index of the related stream channel, or 0xffff
+	 * @block_id: id of the related frame, or 0
+	 * @timestamp: device timestamp of the event
+	 * @data: (nullable): event data, for EVENTDATA commands
+	 *
+	 * Signal that an event was received on the message channel, opened with arv_gv_device_enable_events().
+	 * The @data can be bound to the Genicam document using arv_gc_set_event_data(), for reading the event
+	 * features.
+	 *
+	 * This signal is emited from the message channel thread, so please take care to shared data access from
+	 * the callback.
+	 *
+	 * Since: 0.8.11
+	 */
+
+	arv_gv_device_signals[ARV_GV_DEVICE_SIGNAL_EVENT] =
+		g_signal_new ("event",
+			      G_TYPE_FROM_CLASS (device_class),
+			      G_SIGNAL_RUN_LAST,
+			      0, NULL, NULL,
+			      NULL, G_TYPE_NONE, 5,
+			      G_TYPE_UINT, G_TYPE_UINT, G_TYPE_UINT64, G_TYPE_UINT64, G_TYPE_BYTES);
 
 	g_object_class_install_property
 		(object_class,
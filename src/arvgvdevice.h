@@ -42,6 +42,8 @@ G_BEGIN_DECLS
  * @ARV_GV_PACKET_SIZE_ADJUSTMENT_ON_FAILURE: adjust packet size if test packet check fails with current packet size
  * @ARV_GV_PACKET_SIZE_ADJUSTMENT_ONCE: adjust packet size on the first stream creation
  * @ARV_GV_PACKET_SIZE_ADJUSTMENT_ALWAYS: always adjust the stream packet size
+ * @ARV_GV_PACKET_SIZE_ADJUSTMENT_CACHED: check the last working packet size, adjust it on failure, at each stream
+ * creation (Since 0.8.11)
  * @ARV_GV_PACKET_SIZE_ADJUSTMENT_DEFAULT: default adjustment, which is ON_FAILURE_ONCE (Since 0.8.8)
  */
 
@@ -52,6 +54,7 @@ typedef enum
 	ARV_GV_PACKET_SIZE_ADJUSTMENT_ON_FAILURE,
 	ARV_GV_PACKET_SIZE_ADJUSTMENT_ONCE,
 	ARV_GV_PACKET_SIZE_ADJUSTMENT_ALWAYS,
+	ARV_GV_PACKET_SIZE_ADJUSTMENT_CACHED,
 	ARV_GV_PACKET_SIZE_ADJUSTMENT_DEFAULT = ARV_GV_PACKET_SIZE_ADJUSTMENT_NEVER
 } ArvGvPacketSizeAdjustment;
 
@@ -77,9 +80,21 @@ guint			arv_gv_device_auto_packet_size 			(ArvGvDevice *gv_device, GError **erro
 
 ArvGvStreamOption	arv_gv_device_get_stream_options		(ArvGvDevice *gv_device);
 void 			arv_gv_device_set_stream_options 		(ArvGvDevice *gv_device, ArvGvStreamOption options);
+ArvStream *		arv_gv_device_create_channel_stream		(ArvGvDevice *gv_device, guint channel,
+									 ArvStreamCallback callback, void *user_data,
+									 GError **error);
+
+void			arv_gv_device_set_packet_resend_bandwidth	(ArvGvDevice *gv_device, guint64 bandwidth);
+guint64			arv_gv_device_get_packet_resend_bandwidth	(ArvGvDevice *gv_device);
+
+void			arv_gv_device_set_command_window		(ArvGvDevice *gv_device, guint n_commands);
+guint			arv_gv_device_get_command_window		(ArvGvDevice *gv_device);
 
 gboolean		arv_gv_device_is_controller			(ArvGvDevice *gv_device);
 
+gboolean		arv_gv_device_enable_events			(ArvGvDevice *gv_device, GError **error);
+void			arv_gv_device_disable_events			(ArvGvDevice *gv_device);
+
 G_END_DECLS
 
 #endif
@@ -49,8 +49,61 @@ G_BEGIN_DECLS
 
 #define ARV_GV_DEVICE_BUFFER_SIZE	1024
 
+/* Number of READMEM commands in flight for large memory reads, like the GenICam data download */
+#define ARV_GV_DEVICE_READ_MEMORY_DEPTH_DEFAULT	4
+/* Number of WRITEMEM commands in flight for large memory writes, like the LUT uploads */
+#define ARV_GV_DEVICE_WRITE_MEMORY_DEPTH_DEFAULT	4
+
+/* Duration of the resend bandwidth budget that can be consumed at once */
+#define ARV_GV_DEVICE_PACKET_RESEND_BURST_US	10000
+
+/* Delay after the last packet resend request during which the feature polling is suspended */
+#define ARV_GV_DEVICE_RESEND_PRESSURE_US	500000
+
+/* Wake up period of the message channel thread, when the cancellable can't be polled */
+#define ARV_GV_DEVICE_EVENT_POLL_TIMEOUT_MS	100
+
+/* Delay between two device probes during a reconnection */
+#define ARV_GV_DEVICE_RECONNECT_POLL_DELAY_US	100000
+
+/* Upper bounds of the command latency histogram buckets, in µs */
+#define ARV_GV_DEVICE_N_COMMAND_LATENCY_BOUNDS	8
+
+extern const guint64 arv_gv_device_command_latency_bounds_us[ARV_GV_DEVICE_N_COMMAND_LATENCY_BOUNDS];
+
+/* Bounds of the adaptive command timeout. The upper one is a multiple of the fixed GVCP timeout, which is also
+ * used before the first round trip time measurement and for the last attempt of a command. */
+#define ARV_GV_DEVICE_GVCP_RTO_MIN_US		2000
+#define ARV_GV_DEVICE_GVCP_RTO_MAX_FACTOR	4
+
+/* Command types with their own round trip time estimator: READMEM, WRITEMEM, READREG and WRITEREG */
+#define ARV_GV_DEVICE_N_COMMAND_TYPES		4
+
+extern const char *arv_gv_device_command_type_names[ARV_GV_DEVICE_N_COMMAND_TYPES];
+
+typedef struct {
+	guint64 n_commands;
+	guint64 n_retries;
+	guint64 n_failures;
+	guint64 n_pending_acks;
+	guint64 total_time_us;
+	/* Non cumulative counts, the last bucket is for the latencies above the last bound */
+	guint64 latency_buckets[ARV_GV_DEVICE_N_COMMAND_LATENCY_BOUNDS + 1];
+	/* Smoothed round trip time and its mean deviation, 0 before the first measurement, and timeout of the
+	 * first attempt of a command */
+	guint64 srtt_us[ARV_GV_DEVICE_N_COMMAND_TYPES];
+	guint64 rttvar_us[ARV_GV_DEVICE_N_COMMAND_TYPES];
+	guint64 rto_us[ARV_GV_DEVICE_N_COMMAND_TYPES];
+} ArvGvDeviceCommandStatistics;
+
 GRegex * 		arv_gv_device_get_url_regex 			(void);
 
+void			arv_gv_device_get_command_statistics		(ArvGvDevice *gv_device,
+									 ArvGvDeviceCommandStatistics *statistics);
+
+gboolean		arv_gv_device_consume_packet_resend_budget	(ArvGvDevice *gv_device, guint64 n_bytes,
+									 guint64 time_us);
+
 G_END_DECLS
 
 #endif
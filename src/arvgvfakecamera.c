@@ -20,14 +20,18 @@
  * Author: Emmanuel Pacaud <emmanuel@gnome.org>
  */
 
-#include <arvgvfakecamera.h>
+#include <arvgvfakecameraprivate.h>
 #include <arvfakecamera.h>
 #include <arvbufferprivate.h>
 #include <arvgvcpprivate.h>
 #include <arvgvspprivate.h>
+#include <arvgvspsenderprivate.h>
 #include <arvmisc.h>
 #include <arvmiscprivate.h>
 #include <arvnetworkprivate.h>
+#include <arvdebugprivate.h>
+#include <arvfeatures.h>
+#include <string.h>
 
 /**
  * SECTION: arvgvfakecamera
@@ -38,6 +42,16 @@
 
 #define ARV_GV_FAKE_CAMERA_BUFFER_SIZE	65536
 
+/* Network impairments */
+
+#define ARV_GV_FAKE_CAMERA_FRAME_HISTORY_DEFAULT	4
+
+/* Control plane impairments */
+
+#define ARV_GV_FAKE_CAMERA_GVCP_ACK_LATENCY_MAX_US	(10 * G_USEC_PER_SEC)
+/* Scheduling slack added to the time to completion of the pending acknowledges */
+#define ARV_GV_FAKE_CAMERA_PENDING_ACK_MARGIN_MS	5
+
 enum {
 	ARV_GV_FAKE_CAMERA_INPUT_SOCKET_GVCP = 0,
 	ARV_GV_FAKE_CAMERA_INPUT_SOCKET_GLOBAL_DISCOVERY,
@@ -52,13 +66,48 @@ enum
   PROP_SERIAL_NUMBER,
   PROP_GENICAM_FILENAME,
   PROP_GVSP_LOST_PACKET_RATIO,
+  PROP_GVSP_LOST_BURST_LENGTH,
+  PROP_GVSP_REORDER_WINDOW,
+  PROP_GVSP_DUPLICATE_RATIO,
+  PROP_GVSP_ERROR_RATIO,
+  PROP_GVSP_TRAILER_DELAY,
+  PROP_GVSP_SEED,
+  PROP_GVSP_MULTIPART,
+  PROP_FRAME_HISTORY,
+  PROP_ADDRESS,
+  PROP_OWN_THREAD,
+  PROP_TRAFFIC_GENERATOR,
+  PROP_UDP_GSO,
+  PROP_N_STREAM_CHANNELS,
+  PROP_CONTROL_THREAD,
+  PROP_GVCP_ACK_LATENCY,
+  PROP_GVCP_PENDING_ACK,
   PROP_CM_DOMAIN
 };
 
+/* Frame kept for the servicing of packet resend requests */
+
+typedef struct {
+	ArvBuffer *buffer;
+	guint32 gv_packet_size;
+} ArvGvFakeCameraRetainedFrame;
+
+/* Acknowledge held back by the control thread until its emission time */
+
+typedef struct {
+	gint64 emission_time_us;
+	GSocket *socket;
+	GSocketAddress *address;
+	ArvGvcpPacket *packet;
+	size_t packet_size;
+} ArvGvFakeCameraDelayedAck;
+
 typedef struct {
 	char *interface_name;
 	char *serial_number;
 	char *genicam_filename;
+	char *address;
+	gboolean own_thread;
 
 	ArvFakeCamera *camera;
 
@@ -77,7 +126,45 @@ typedef struct {
 	GThread *thread;
 	gboolean cancel;
 
+	/* Optional GVCP servicing thread, the other thread then only streams */
+	gboolean control_thread;
+	GThread *gvcp_thread;
+	guint gvcp_ack_latency_us;
+	gboolean gvcp_pending_ack;
+	/* Only accessed by the GVCP thread */
+	GQueue delayed_acks;
+
+	/* Protects the streaming state and the frame history, accessed by the packet resend command servicing */
+	GMutex stream_mutex;
+
 	double gvsp_lost_packet_ratio;
+	guint gvsp_lost_burst_length;
+	guint gvsp_reorder_window;
+	double gvsp_duplicate_ratio;
+	double gvsp_error_ratio;
+	guint gvsp_trailer_delay_us;
+	guint gvsp_seed;
+	gboolean gvsp_multipart;
+	GRand *rand;
+	guint n_pending_lost_packets;
+
+	ArvGvFakeCameraRetainedFrame history[ARV_GV_FAKE_CAMERA_FRAME_HISTORY_MAX];
+	guint history_length;
+	guint history_index;
+
+	/* Streaming state, only accessed by the thread servicing the camera */
+	ArvBuffer *image_buffer;
+	GSocketAddress *stream_address;
+	size_t payload;
+	void *packet_buffer;
+	GInputVector input_vector;
+	ArvGvspSender *senders[ARV_GV_FAKE_CAMERA_N_STREAM_CHANNELS_MAX];
+	gboolean is_streaming;
+	guint64 next_timestamp_us;
+
+	gboolean traffic_generator;
+	gboolean udp_gso;
+	guint n_stream_channels;
 } ArvGvFakeCameraPrivate;
 
 struct _ArvGvFakeCamera {
@@ -106,6 +193,398 @@ _g_inet_socket_address_is_equal (GInetSocketAddress *a, GInetSocketAddress *b)
 				     g_inet_socket_address_get_address (b));
 }
 
+/* With gvsp-multipart, the image is sent as a 2 parts multipart payload, the first part holding the first half of
+ * the image lines */
+
+static void
+_setup_multipart (ArvGvFakeCamera *gv_fake_camera, ArvBuffer *image_buffer)
+{
+	guint32 height = image_buffer->priv->height;
+	size_t line_size;
+	guint i;
+
+	if (!gv_fake_camera->priv->gvsp_multipart || gv_fake_camera->priv->traffic_generator || height < 2)
+		return;
+
+	line_size = image_buffer->priv->size / height;
+
+	image_buffer->priv->payload_type = ARV_BUFFER_PAYLOAD_TYPE_MULTIPART;
+	arv_buffer_set_n_parts (image_buffer, 2);
+
+	for (i = 0; i < 2; i++) {
+		ArvBufferPart *part = &image_buffer->priv->parts[i];
+
+		part->data_type = ARV_BUFFER_PART_DATA_TYPE_2D_IMAGE;
+		part->pixel_format = image_buffer->priv->pixel_format;
+		part->width = image_buffer->priv->width;
+		part->height = i == 0 ? height / 2 : height - height / 2;
+		part->x_offset = image_buffer->priv->x_offset;
+		part->y_offset = image_buffer->priv->y_offset + (i == 0 ? 0 : height / 2);
+		part->data_offset = i == 0 ? 0 : (height / 2) * line_size;
+		part->size = i == 0 ? (height / 2) * line_size : image_buffer->priv->size - part->data_offset;
+	}
+}
+
+/* The multipart data blocks carry the data of a single part, after a part header */
+
+static guint
+_get_n_packets (ArvBuffer *image_buffer, guint32 gv_packet_size)
+{
+	size_t block_size = gv_packet_size - ARV_GVSP_PACKET_PROTOCOL_OVERHEAD;
+	guint n_packets = 2;
+	guint i;
+
+	if (image_buffer->priv->payload_type != ARV_BUFFER_PAYLOAD_TYPE_MULTIPART)
+		return (image_buffer->priv->size + block_size - 1) / block_size + 2;
+
+	block_size -= sizeof (ArvGvspMultipart);
+	for (i = 0; i < image_buffer->priv->n_parts; i++)
+		n_packets += (image_buffer->priv->parts[i].size + block_size - 1) / block_size;
+
+	return n_packets;
+}
+
+static size_t
+_build_multipart_packet (ArvBuffer *image_buffer, guint32 gv_packet_size, guint32 packet_id, void *packet_buffer)
+{
+	size_t block_size = gv_packet_size - ARV_GVSP_PACKET_PROTOCOL_OVERHEAD - sizeof (ArvGvspMultipart);
+	size_t packet_size = ARV_GV_FAKE_CAMERA_BUFFER_SIZE;
+	guint32 first_packet_id = 1;
+	guint i;
+
+	if (packet_id == 0) {
+		ArvGvspPacket *packet;
+
+		packet = arv_gvsp_packet_new_multipart_leader (image_buffer->priv->frame_id, 0,
+							       image_buffer->priv->timestamp_ns,
+							       image_buffer->priv->n_parts,
+							       packet_buffer, &packet_size);
+		for (i = 0; i < image_buffer->priv->n_parts; i++) {
+			ArvBufferPart *part = &image_buffer->priv->parts[i];
+
+			arv_gvsp_packet_set_part_infos (packet, i, part->data_type, part->pixel_format, part->size,
+							part->width, part->height, part->x_offset, part->y_offset);
+		}
+
+		return packet_size;
+	}
+
+	for (i = 0; i < image_buffer->priv->n_parts; i++) {
+		ArvBufferPart *part = &image_buffer->priv->parts[i];
+		guint n_blocks = (part->size + block_size - 1) / block_size;
+
+		if (packet_id < first_packet_id + n_blocks) {
+			size_t offset = (packet_id - first_packet_id) * block_size;
+
+			arv_gvsp_packet_new_multipart_block (image_buffer->priv->frame_id, packet_id, i, offset,
+							     MIN (block_size, part->size - offset),
+							     ((char *) image_buffer->priv->data) + part->data_offset + offset,
+							     packet_buffer, &packet_size);
+			return packet_size;
+		}
+
+		first_packet_id += n_blocks;
+	}
+
+	arv_gvsp_packet_new_data_trailer (image_buffer->priv->frame_id, packet_id, packet_buffer, &packet_size);
+	((ArvGvspDataTrailer *) arv_gvsp_packet_get_data (packet_buffer))->payload_type =
+		g_htonl (ARV_GVSP_PAYLOAD_TYPE_MULTIPART);
+
+	return packet_size;
+}
+
+/* Builds the packet @packet_id of the frame stored in @image_buffer, the leader being packet 0 and the trailer the
+ * last one. */
+
+static size_t
+_build_packet (ArvBuffer *image_buffer, guint32 gv_packet_size, guint32 packet_id, void *packet_buffer)
+{
+	size_t block_size = gv_packet_size - ARV_GVSP_PACKET_PROTOCOL_OVERHEAD;
+	size_t packet_size = ARV_GV_FAKE_CAMERA_BUFFER_SIZE;
+	guint n_packets;
+
+	if (image_buffer->priv->payload_type == ARV_BUFFER_PAYLOAD_TYPE_MULTIPART)
+		return _build_multipart_packet (image_buffer, gv_packet_size, packet_id, packet_buffer);
+
+	n_packets = _get_n_packets (image_buffer, gv_packet_size);
+
+	if (packet_id == 0) {
+		arv_gvsp_packet_new_data_leader (image_buffer->priv->frame_id, 0,
+						 image_buffer->priv->timestamp_ns,
+						 image_buffer->priv->pixel_format,
+						 image_buffer->priv->width, image_buffer->priv->height,
+						 image_buffer->priv->x_offset, image_buffer->priv->y_offset,
+						 packet_buffer, &packet_size);
+	} else if (packet_id == n_packets - 1) {
+		arv_gvsp_packet_new_data_trailer (image_buffer->priv->frame_id, packet_id,
+						  packet_buffer, &packet_size);
+	} else {
+		ptrdiff_t offset = (packet_id - 1) * block_size;
+
+		arv_gvsp_packet_new_data_block (image_buffer->priv->frame_id, packet_id,
+						MIN (block_size, image_buffer->priv->size - offset),
+						((char *) image_buffer->priv->data) + offset,
+						packet_buffer, &packet_size);
+	}
+
+	return packet_size;
+}
+
+static void
+_send_packet (ArvGvFakeCamera *gv_fake_camera, GSocketAddress *address, void *packet_buffer, size_t packet_size,
+	      guint64 frame_id, guint32 packet_id)
+{
+	GError *error = NULL;
+
+	g_socket_send_to (gv_fake_camera->priv->gvsp_socket, address, packet_buffer, packet_size, NULL, &error);
+	if (error != NULL) {
+		arv_info_stream_thread ("[GvFakeCamera::send_packet] Failed to send packet %u for frame"
+					" %" G_GUINT64_FORMAT ": %s", packet_id, frame_id, error->message);
+		g_clear_error (&error);
+	}
+}
+
+/* Sends a packet through the simulated network impairments: the packet may be dropped, alone or as the start of a
+ * burst, replaced by an error packet, or duplicated. The decisions are taken using the seeded random generator,
+ * which makes a given impairment sequence reproducible. */
+
+static void
+_send_impaired_packet (ArvGvFakeCamera *gv_fake_camera, GSocketAddress *address, ArvBuffer *image_buffer,
+		       guint32 gv_packet_size, guint32 packet_id, void *packet_buffer)
+{
+	GRand *rand = gv_fake_camera->priv->rand;
+	guint64 frame_id = image_buffer->priv->frame_id;
+	size_t packet_size;
+
+	if (gv_fake_camera->priv->n_pending_lost_packets > 0) {
+		gv_fake_camera->priv->n_pending_lost_packets--;
+		arv_info_stream_thread ("Drop GVSP packet frame:%" G_GUINT64_FORMAT ", packet:%u (burst)",
+					frame_id, packet_id);
+		return;
+	}
+
+	if (gv_fake_camera->priv->gvsp_lost_packet_ratio > 0.0 &&
+	    g_rand_double (rand) < gv_fake_camera->priv->gvsp_lost_packet_ratio) {
+		gv_fake_camera->priv->n_pending_lost_packets = gv_fake_camera->priv->gvsp_lost_burst_length - 1;
+		arv_info_stream_thread ("Drop GVSP packet frame:%" G_GUINT64_FORMAT ", packet:%u", frame_id, packet_id);
+		return;
+	}
+
+	if (gv_fake_camera->priv->gvsp_error_ratio > 0.0 &&
+	    g_rand_double (rand) < gv_fake_camera->priv->gvsp_error_ratio) {
+		packet_size = ARV_GV_FAKE_CAMERA_BUFFER_SIZE;
+		arv_gvsp_packet_new_error (frame_id, packet_id, ARV_GVSP_PACKET_TYPE_PACKET_UNAVAILABLE,
+					   packet_buffer, &packet_size);
+		arv_info_stream_thread ("Replace GVSP packet frame:%" G_GUINT64_FORMAT ", packet:%u by an error packet",
+					frame_id, packet_id);
+		_send_packet (gv_fake_camera, address, packet_buffer, packet_size, frame_id, packet_id);
+		return;
+	}
+
+	packet_size = _build_packet (image_buffer, gv_packet_size, packet_id, packet_buffer);
+	_send_packet (gv_fake_camera, address, packet_buffer, packet_size, frame_id, packet_id);
+
+	if (gv_fake_camera->priv->gvsp_duplicate_ratio > 0.0 &&
+	    g_rand_double (rand) < gv_fake_camera->priv->gvsp_duplicate_ratio) {
+		arv_info_stream_thread ("Duplicate GVSP packet frame:%" G_GUINT64_FORMAT ", packet:%u",
+					frame_id, packet_id);
+		_send_packet (gv_fake_camera, address, packet_buffer, packet_size, frame_id, packet_id);
+	}
+}
+
+/* The leader and the data blocks are shuffled inside consecutive windows of gvsp-reorder-window packets. The trailer
+ * is always sent last, after the optional trailer delay. */
+
+static void
+_send_frame (ArvGvFakeCamera *gv_fake_camera, GSocketAddress *address, ArvBuffer *image_buffer,
+	     guint32 gv_packet_size, void *packet_buffer)
+{
+	guint32 packet_ids[ARV_GV_FAKE_CAMERA_REORDER_WINDOW_MAX];
+	guint n_packets;
+	guint window;
+	guint first;
+
+	n_packets = _get_n_packets (image_buffer, gv_packet_size);
+	window = CLAMP (gv_fake_camera->priv->gvsp_reorder_window, 1, ARV_GV_FAKE_CAMERA_REORDER_WINDOW_MAX);
+
+	for (first = 0; first < n_packets - 1; first += window) {
+		guint n_window_packets = MIN (window, n_packets - 1 - first);
+		guint i;
+
+		for (i = 0; i < n_window_packets; i++)
+			packet_ids[i] = first + i;
+
+		for (i = n_window_packets - 1; i > 0; i--) {
+			guint j = g_rand_int_range (gv_fake_camera->priv->rand, 0, i + 1);
+			guint32 packet_id = packet_ids[i];
+
+			packet_ids[i] = packet_ids[j];
+			packet_ids[j] = packet_id;
+		}
+
+		for (i = 0; i < n_window_packets; i++)
+			_send_impaired_packet (gv_fake_camera, address, image_buffer, gv_packet_size, packet_ids[i],
+					       packet_buffer);
+	}
+
+	if (gv_fake_camera->priv->gvsp_trailer_delay_us > 0)
+		g_usleep (gv_fake_camera->priv->gvsp_trailer_delay_us);
+
+	_send_impaired_packet (gv_fake_camera, address, image_buffer, gv_packet_size, n_packets - 1, packet_buffer);
+}
+
+/* Stores @image_buffer in the frame history, and returns the evicted buffer, which may be NULL, for the next frame.
+ * Without history, @image_buffer is returned as is. */
+
+static ArvBuffer *
+_retain_frame (ArvGvFakeCamera *gv_fake_camera, ArvBuffer *image_buffer, guint32 gv_packet_size)
+{
+	ArvGvFakeCameraRetainedFrame *frame;
+	ArvBuffer *evicted_buffer;
+
+	if (gv_fake_camera->priv->history_length == 0)
+		return image_buffer;
+
+	frame = &gv_fake_camera->priv->history[gv_fake_camera->priv->history_index];
+	evicted_buffer = frame->buffer;
+	frame->buffer = image_buffer;
+	frame->gv_packet_size = gv_packet_size;
+
+	gv_fake_camera->priv->history_index = (gv_fake_camera->priv->history_index + 1) %
+		gv_fake_camera->priv->history_length;
+
+	return evicted_buffer;
+}
+
+static void
+_clear_frame_history (ArvGvFakeCamera *gv_fake_camera)
+{
+	unsigned int i;
+
+	for (i = 0; i < ARV_GV_FAKE_CAMERA_FRAME_HISTORY_MAX; i++)
+		g_clear_object (&gv_fake_camera->priv->history[i].buffer);
+	gv_fake_camera->priv->history_index = 0;
+}
+
+/* Resent packets go through the same impairments as the original ones. When the frame is not in the history anymore,
+ * or the requested range is invalid, a packet unavailable error is sent instead. */
+
+static void
+_resend_packets (ArvGvFakeCamera *gv_fake_camera, guint64 frame_id, guint32 first_block, guint32 last_block)
+{
+	ArvGvFakeCameraRetainedFrame *frame = NULL;
+	GSocketAddress *stream_address;
+	void *packet_buffer = gv_fake_camera->priv->packet_buffer;
+	unsigned int i;
+
+	for (i = 0; i < gv_fake_camera->priv->history_length && frame == NULL; i++) {
+		ArvBuffer *buffer = gv_fake_camera->priv->history[i].buffer;
+
+		if (buffer != NULL && buffer->priv->frame_id == frame_id)
+			frame = &gv_fake_camera->priv->history[i];
+	}
+
+	stream_address = arv_fake_camera_get_stream_address (gv_fake_camera->priv->camera);
+
+	if (frame != NULL &&
+	    first_block <= last_block &&
+	    last_block < _get_n_packets (frame->buffer, frame->gv_packet_size)) {
+		guint32 packet_id;
+
+		arv_info_stream_thread ("[GvFakeCamera::resend_packets] Resend packets %u to %u of frame %"
+					G_GUINT64_FORMAT, first_block, last_block, frame_id);
+
+		for (packet_id = first_block; packet_id <= last_block; packet_id++)
+			_send_impaired_packet (gv_fake_camera, stream_address, frame->buffer, frame->gv_packet_size,
+					       packet_id, packet_buffer);
+	} else {
+		size_t packet_size = ARV_GV_FAKE_CAMERA_BUFFER_SIZE;
+
+		arv_info_stream_thread ("[GvFakeCamera::resend_packets] Packets %u to %u of frame %" G_GUINT64_FORMAT
+					" unavailable", first_block, last_block, frame_id);
+
+		arv_gvsp_packet_new_error (frame_id, first_block, ARV_GVSP_PACKET_TYPE_PACKET_UNAVAILABLE,
+					   packet_buffer, &packet_size);
+		_send_packet (gv_fake_camera, stream_address, packet_buffer, packet_size, frame_id, first_block);
+	}
+
+	g_object_unref (stream_address);
+}
+
+static void
+_delayed_ack_free (ArvGvFakeCameraDelayedAck *delayed_ack)
+{
+	g_object_unref (delayed_ack->socket);
+	g_object_unref (delayed_ack->address);
+	g_free (delayed_ack->packet);
+	g_free (delayed_ack);
+}
+
+/* Sends the acknowledge, now or once the GVCP acknowledge latency has elapsed. @ack_packet is consumed. */
+
+static void
+_send_ack (ArvGvFakeCamera *gv_fake_camera, GSocket *socket, GSocketAddress *remote_address,
+	   ArvGvcpPacket *ack_packet, size_t ack_packet_size)
+{
+	ArvGvFakeCameraDelayedAck *delayed_ack;
+	guint latency_us = gv_fake_camera->priv->gvcp_ack_latency_us;
+
+	if (!gv_fake_camera->priv->control_thread || latency_us == 0) {
+		g_socket_send_to (socket, remote_address, (char *) ack_packet, ack_packet_size, NULL, NULL);
+		arv_gvcp_packet_debug (ack_packet, ARV_DEBUG_LEVEL_DEBUG);
+		g_free (ack_packet);
+		return;
+	}
+
+	if (gv_fake_camera->priv->gvcp_pending_ack) {
+		ArvGvcpPacket *pending_ack_packet;
+		size_t pending_ack_packet_size;
+
+		pending_ack_packet = arv_gvcp_packet_new_pending_ack (arv_gvcp_packet_get_packet_id (ack_packet),
+								      (latency_us + 999) / 1000 +
+								      ARV_GV_FAKE_CAMERA_PENDING_ACK_MARGIN_MS,
+								      &pending_ack_packet_size);
+		g_socket_send_to (socket, remote_address, (char *) pending_ack_packet, pending_ack_packet_size,
+				  NULL, NULL);
+		arv_gvcp_packet_debug (pending_ack_packet, ARV_DEBUG_LEVEL_DEBUG);
+		g_free (pending_ack_packet);
+	}
+
+	delayed_ack = g_new (ArvGvFakeCameraDelayedAck, 1);
+	delayed_ack->emission_time_us = g_get_monotonic_time () + latency_us;
+	delayed_ack->socket = g_object_ref (socket);
+	delayed_ack->address = g_object_ref (remote_address);
+	delayed_ack->packet = ack_packet;
+	delayed_ack->packet_size = ack_packet_size;
+
+	/* The latency is constant, the queue is sorted by emission time */
+	g_queue_push_tail (&gv_fake_camera->priv->delayed_acks, delayed_ack);
+}
+
+/* Sends the delayed acknowledges whose emission time is reached, and returns the time until the next one, in µs, or
+ * -1 if there is none left */
+
+static gint64
+_send_delayed_acks (ArvGvFakeCamera *gv_fake_camera)
+{
+	ArvGvFakeCameraDelayedAck *delayed_ack;
+	gint64 time_us = g_get_monotonic_time ();
+
+	while ((delayed_ack = g_queue_peek_head (&gv_fake_camera->priv->delayed_acks)) != NULL) {
+		if (delayed_ack->emission_time_us > time_us)
+			return delayed_ack->emission_time_us - time_us;
+
+		g_queue_pop_head (&gv_fake_camera->priv->delayed_acks);
+
+		g_socket_send_to (delayed_ack->socket, delayed_ack->address,
+				  (char *) delayed_ack->packet, delayed_ack->packet_size, NULL, NULL);
+		arv_gvcp_packet_debug (delayed_ack->packet, ARV_DEBUG_LEVEL_DEBUG);
+		_delayed_ack_free (delayed_ack);
+	}
+
+	return -1;
+}
+
 static gboolean
 _handle_control_packet (ArvGvFakeCamera *gv_fake_camera, GSocket *socket,
 			GSocketAddress *remote_address,
@@ -136,10 +615,14 @@ _handle_control_packet (ArvGvFakeCamera *gv_fake_camera, GSocket *socket,
 			write_access = TRUE;
 			arv_warning_device ("[GvFakeCamera::handle_control_packet] Heartbeat timeout");
 			arv_fake_camera_set_control_channel_privilege (gv_fake_camera->priv->camera, 0);
-		} else
+		} else {
 			write_access = _g_inet_socket_address_is_equal
 				(G_INET_SOCKET_ADDRESS (remote_address),
 				 G_INET_SOCKET_ADDRESS (gv_fake_camera->priv->controller_address));
+			/* Any command of the controller resets the heartbeat timer */
+			if (write_access)
+				gv_fake_camera->priv->controller_time = time;
+		}
 	} else
 		write_access = TRUE;
 
@@ -186,39 +669,82 @@ _handle_control_packet (ArvGvFakeCamera *gv_fake_camera, GSocket *socket,
 									   &ack_packet_size);
 			break;
 		case ARV_GVCP_COMMAND_READ_REGISTER_CMD:
-			arv_gvcp_packet_get_read_register_cmd_infos (packet, &register_address);
-			arv_fake_camera_read_register (gv_fake_camera->priv->camera, register_address, &register_value);
-			arv_info_device ("[GvFakeCamera::handle_control_packet] Read register command %d -> %d",
-					  register_address, register_value);
-			ack_packet = arv_gvcp_packet_new_read_register_ack (register_value, packet_id,
-									    &ack_packet_size);
-
-			if (register_address == ARV_GVBS_CONTROL_CHANNEL_PRIVILEGE_OFFSET)
-				gv_fake_camera->priv->controller_time = g_get_real_time ();
+			{
+				guint32 register_values[ARV_GVCP_N_READ_REGISTERS_MAX];
+				guint n_registers;
+				guint i;
+
+				n_registers = MIN (arv_gvcp_packet_get_read_registers_cmd_n_addresses (packet),
+						   ARV_GVCP_N_READ_REGISTERS_MAX);
+				if (n_registers == 0)
+					break;
+
+				for (i = 0; i < n_registers; i++) {
+					register_address = arv_gvcp_packet_get_read_registers_cmd_address (packet, i);
+					arv_fake_camera_read_register (gv_fake_camera->priv->camera, register_address,
+								       &register_values[i]);
+					arv_info_device ("[GvFakeCamera::handle_control_packet] Read register command %d -> %d",
+							  register_address, register_values[i]);
+
+					if (register_address == ARV_GVBS_CONTROL_CHANNEL_PRIVILEGE_OFFSET)
+						gv_fake_camera->priv->controller_time = g_get_real_time ();
+				}
 
+				ack_packet = arv_gvcp_packet_new_read_registers_ack (register_values, n_registers, packet_id,
+										     &ack_packet_size);
+			}
 			break;
 		case ARV_GVCP_COMMAND_WRITE_REGISTER_CMD:
-			arv_gvcp_packet_get_write_register_cmd_infos (packet, &register_address, &register_value);
-			if (!write_access) {
-				arv_warning_device("[GvFakeCamera::handle_control_packet] Ignore Write register command %d (%d) not controller",
-					register_address, register_value);
-				break;
-			}
+			{
+				guint n_registers;
+				guint i;
+
+				n_registers = arv_gvcp_packet_get_write_registers_cmd_n_registers (packet);
+				if (n_registers == 0)
+					break;
+
+				if (!write_access) {
+					arv_gvcp_packet_get_write_registers_cmd_infos (packet, 0, &register_address, &register_value);
+					arv_warning_device("[GvFakeCamera::handle_control_packet] Deny Write register command %d (%d) not controller",
+						register_address, register_value);
+					ack_packet = arv_gvcp_packet_new_write_register_ack (0, packet_id, &ack_packet_size);
+					ack_packet->header.packet_type = ARV_GVCP_PACKET_TYPE_ERROR;
+					ack_packet->header.packet_flags = ARV_GVCP_ERROR_ACCESS_DENIED;
+					break;
+				}
+
+				for (i = 0; i < n_registers; i++) {
+					arv_gvcp_packet_get_write_registers_cmd_infos (packet, i, &register_address, &register_value);
+					arv_fake_camera_write_register (gv_fake_camera->priv->camera, register_address, register_value);
+					arv_info_device ("[GvFakeCamera::handle_control_packet] Write register command %d -> %d",
+							  register_address, register_value);
+				}
 
-			arv_fake_camera_write_register (gv_fake_camera->priv->camera, register_address, register_value);
-			arv_info_device ("[GvFakeCamera::handle_control_packet] Write register command %d -> %d",
-					  register_address, register_value);
-			ack_packet = arv_gvcp_packet_new_write_register_ack (1, packet_id,
-									     &ack_packet_size);
+				ack_packet = arv_gvcp_packet_new_write_register_ack (n_registers, packet_id,
+										     &ack_packet_size);
+			}
+			break;
+		case ARV_GVCP_COMMAND_PACKET_RESEND_CMD:
+			{
+				guint64 frame_id;
+				guint32 first_block;
+				guint32 last_block;
+
+				/* Packet resend commands are not acknowledged */
+				arv_gvcp_packet_get_packet_resend_cmd_infos (packet, &frame_id, &first_block, &last_block);
+				arv_info_device ("[GvFakeCamera::handle_control_packet] Packet resend command %"
+						 G_GUINT64_FORMAT " (%u-%u)", frame_id, first_block, last_block);
+				g_mutex_lock (&gv_fake_camera->priv->stream_mutex);
+				_resend_packets (gv_fake_camera, frame_id, first_block, last_block);
+				g_mutex_unlock (&gv_fake_camera->priv->stream_mutex);
+			}
 			break;
 		default:
 			arv_warning_device ("[GvFakeCamera::handle_control_packet] Unknown command");
 	}
 
 	if (ack_packet != NULL) {
-		g_socket_send_to (socket, remote_address, (char *) ack_packet, ack_packet_size, NULL, NULL);
-		arv_gvcp_packet_debug (ack_packet, ARV_DEBUG_LEVEL_DEBUG);
-		g_free (ack_packet);
+		_send_ack (gv_fake_camera, socket, remote_address, ack_packet, ack_packet_size);
 
 		success = TRUE;
 	}
@@ -241,192 +767,303 @@ _handle_control_packet (ArvGvFakeCamera *gv_fake_camera, GSocket *socket,
 	return success;
 }
 
-static void *
-_thread (void *user_data)
+static GSocketAddress *
+_get_stream_channel_address (ArvFakeCamera *camera, guint channel)
 {
-	ArvGvFakeCamera *gv_fake_camera = user_data;
-	ArvBuffer *image_buffer = NULL;
-	GError *error = NULL;
-	GSocketAddress *stream_address = NULL;
-	void *packet_buffer;
-	size_t packet_size;
-	size_t payload = 0;
-	guint16 block_id;
-	ptrdiff_t offset;
-	guint32 gv_packet_size;
-	GInputVector input_vector;
-	int n_events;
-	gboolean is_streaming = FALSE;
+	GInetAddress *inet_address;
+	GSocketAddress *address;
+	guint32 ip_address;
+	guint32 port;
 
-	input_vector.buffer = g_malloc0 (ARV_GV_FAKE_CAMERA_BUFFER_SIZE);
-	input_vector.size = ARV_GV_FAKE_CAMERA_BUFFER_SIZE;
+	arv_fake_camera_read_register (camera, ARV_GVBS_STREAM_CHANNEL_0_PORT_OFFSET +
+				       channel * ARV_GVBS_STREAM_CHANNEL_STRIDE, &port);
+	port &= ARV_GVBS_STREAM_CHANNEL_0_PORT_MASK;
+	arv_fake_camera_read_memory (camera, ARV_GVBS_STREAM_CHANNEL_0_IP_ADDRESS_OFFSET +
+				     channel * ARV_GVBS_STREAM_CHANNEL_STRIDE, sizeof (ip_address), &ip_address);
 
-	packet_buffer = g_malloc (ARV_GV_FAKE_CAMERA_BUFFER_SIZE);
+	if (port == 0 || ip_address == 0)
+		return NULL;
 
-	do {
-		guint64 next_timestamp_us;
+	inet_address = g_inet_address_new_from_bytes ((guint8 *) &ip_address, G_SOCKET_FAMILY_IPV4);
+	address = g_inet_socket_address_new (inet_address, port);
+	g_object_unref (inet_address);
 
-		if (is_streaming) {
-			arv_fake_camera_get_sleep_time_for_next_frame (gv_fake_camera->priv->camera, &next_timestamp_us);
-		} else {
-			next_timestamp_us = g_get_real_time () + 100000;
-		}
+	return address;
+}
 
-		do {
-			gint timeout_ms;
+static guint64
+_get_stream_channel_packet_delay_ns (ArvFakeCamera *camera, guint channel)
+{
+	guint32 tick_frequency_high;
+	guint32 tick_frequency_low;
+	guint64 tick_frequency;
+	guint32 packet_delay;
 
-			timeout_ms =  (next_timestamp_us - g_get_real_time ()) / 1000LL;
-			if (timeout_ms < 0)
-				timeout_ms = 0;
-			else if (timeout_ms > 100)
-				timeout_ms = 100;
+	arv_fake_camera_read_register (camera, ARV_GVBS_STREAM_CHANNEL_0_PACKET_DELAY_OFFSET +
+				       channel * ARV_GVBS_STREAM_CHANNEL_STRIDE, &packet_delay);
+	arv_fake_camera_read_register (camera, ARV_GVBS_TIMESTAMP_TICK_FREQUENCY_HIGH_OFFSET, &tick_frequency_high);
+	arv_fake_camera_read_register (camera, ARV_GVBS_TIMESTAMP_TICK_FREQUENCY_LOW_OFFSET, &tick_frequency_low);
 
-			n_events = g_poll (gv_fake_camera->priv->socket_fds, gv_fake_camera->priv->n_socket_fds, timeout_ms);
-			if (n_events > 0) {
-				unsigned int i;
+	tick_frequency = ((guint64) tick_frequency_high << 32) | tick_frequency_low;
+	if (tick_frequency == 0)
+		return 0;
 
-				for (i = 0; i < ARV_GV_FAKE_CAMERA_N_INPUT_SOCKETS; i++) {
-					GSocket *socket = gv_fake_camera->priv->input_sockets[i];
-					int count;
+	return (guint64) packet_delay * 1000000000LL / tick_frequency;
+}
 
-					if (G_IS_SOCKET (socket)) {
-						GSocketAddress *remote_address = NULL;
-
-						arv_gpollfd_clear_one (&gv_fake_camera->priv->socket_fds[i], socket);
-
-						count = g_socket_receive_message (socket, &remote_address, &input_vector, 1, NULL, NULL,
-										  NULL, NULL, NULL);
-						if (count > 0) {
-							if (_handle_control_packet (gv_fake_camera, socket,
-										    remote_address, input_vector.buffer, count))
-								arv_info_device ("[GvFakeCamera::thread] Control packet received");
-						}
-						g_clear_object (&remote_address);
-					}
-				}
+/* Sends a frame on all the configured stream channels, using a stream sender per channel, all sharing the GVSP
+ * socket */
 
-				if (arv_fake_camera_get_control_channel_privilege (gv_fake_camera->priv->camera) == 0 ||
-				    arv_fake_camera_get_acquisition_status (gv_fake_camera->priv->camera) == 0) {
-					if (stream_address != NULL) {
-						g_object_unref (stream_address);
-						stream_address = NULL;
-						g_object_unref (image_buffer);
-						image_buffer = NULL;
-						arv_info_stream_thread ("[GvFakeCamera::thread] Stop stream");
-					}
-					is_streaming = FALSE;
-				}
+static void
+_send_frame_generator (ArvGvFakeCamera *gv_fake_camera, ArvBuffer *image_buffer)
+{
+	ArvFakeCamera *camera = gv_fake_camera->priv->camera;
+	guint channel;
+
+	for (channel = 0; channel < gv_fake_camera->priv->n_stream_channels; channel++) {
+		ArvGvspSender *sender;
+		GSocketAddress *address;
+		GError *error = NULL;
+		guint32 gv_packet_size;
+
+		address = _get_stream_channel_address (camera, channel);
+		if (address == NULL)
+			continue;
+
+		arv_fake_camera_read_register (camera, ARV_GVBS_STREAM_CHANNEL_0_PACKET_SIZE_OFFSET +
+					       channel * ARV_GVBS_STREAM_CHANNEL_STRIDE, &gv_packet_size);
+		gv_packet_size = (gv_packet_size >> ARV_GVBS_STREAM_CHANNEL_0_PACKET_SIZE_POS) &
+			ARV_GVBS_STREAM_CHANNEL_0_PACKET_SIZE_MASK;
+
+		if (gv_packet_size > ARV_GVSP_PACKET_PROTOCOL_OVERHEAD) {
+			if (gv_fake_camera->priv->senders[channel] == NULL) {
+				sender = arv_gvsp_sender_new_for_socket (gv_fake_camera->priv->gvsp_socket);
+				arv_gvsp_sender_set_udp_gso (sender, gv_fake_camera->priv->udp_gso);
+				arv_gvsp_sender_set_impairments (sender, gv_fake_camera->priv->rand,
+								 gv_fake_camera->priv->gvsp_lost_packet_ratio);
+				gv_fake_camera->priv->senders[channel] = sender;
 			}
-		} while (!g_atomic_int_get (&gv_fake_camera->priv->cancel) && g_get_real_time () < next_timestamp_us);
-
-		if (arv_fake_camera_get_control_channel_privilege (gv_fake_camera->priv->camera) != 0 &&
-		    arv_fake_camera_get_acquisition_status (gv_fake_camera->priv->camera) != 0) {
-			if (stream_address == NULL) {
-				GInetAddress *inet_address;
-				char *inet_address_string;
-
-				stream_address = arv_fake_camera_get_stream_address (gv_fake_camera->priv->camera);
-				inet_address = g_inet_socket_address_get_address
-					(G_INET_SOCKET_ADDRESS (stream_address));
-				inet_address_string = g_inet_address_to_string (inet_address);
-				arv_info_stream_thread ("[GvFakeCamera::thread] Start stream to %s (%d)",
-							 inet_address_string,
-							 g_inet_socket_address_get_port
-							 (G_INET_SOCKET_ADDRESS (stream_address)));
-				g_free (inet_address_string);
-
-				payload = arv_fake_camera_get_payload (gv_fake_camera->priv->camera);
-				image_buffer = arv_buffer_new (payload, NULL);
+			sender = gv_fake_camera->priv->senders[channel];
+
+			arv_gvsp_sender_set_destination (sender, address);
+			arv_gvsp_sender_set_packet_size (sender, gv_packet_size);
+			arv_gvsp_sender_set_packet_delay (sender, _get_stream_channel_packet_delay_ns (camera, channel));
+
+			if (!arv_gvsp_sender_send_buffer (sender, image_buffer, &error)) {
+				arv_info_stream_thread ("[GvFakeCamera::send_frame_generator] Failed to send frame: %s",
+							error->message);
+				g_clear_error (&error);
 			}
+		}
 
-			arv_fake_camera_fill_buffer (gv_fake_camera->priv->camera, image_buffer, &gv_packet_size);
+		g_object_unref (address);
+	}
+}
+
+static void
+_stop_stream (ArvGvFakeCamera *gv_fake_camera)
+{
+	unsigned int channel;
 
-			arv_info_stream_thread ("[GvFakeCamera::thread] Send frame %" G_GUINT64_FORMAT, image_buffer->priv->frame_id);
+	if (gv_fake_camera->priv->stream_address != NULL)
+		arv_info_stream_thread ("[GvFakeCamera::stop_stream] Stop stream");
 
-			block_id = 0;
+	g_clear_object (&gv_fake_camera->priv->stream_address);
+	g_clear_object (&gv_fake_camera->priv->image_buffer);
+	_clear_frame_history (gv_fake_camera);
 
-			packet_size = ARV_GV_FAKE_CAMERA_BUFFER_SIZE;
-			arv_gvsp_packet_new_data_leader (image_buffer->priv->frame_id,
-							 block_id,
-							 image_buffer->priv->timestamp_ns,
-							 image_buffer->priv->pixel_format,
-							 image_buffer->priv->width, image_buffer->priv->height,
-							 image_buffer->priv->x_offset, image_buffer->priv->y_offset,
-							 packet_buffer, &packet_size);
+	for (channel = 0; channel < ARV_GV_FAKE_CAMERA_N_STREAM_CHANNELS_MAX; channel++)
+		g_clear_object (&gv_fake_camera->priv->senders[channel]);
 
-			if (g_random_double () >= gv_fake_camera->priv->gvsp_lost_packet_ratio)
-				g_socket_send_to (gv_fake_camera->priv->gvsp_socket, stream_address,
-						  packet_buffer, packet_size, NULL, &error);
-			else
-				arv_info_stream_thread ("Drop GVSP leader packet frame: %" G_GUINT64_FORMAT, image_buffer->priv->frame_id);
+	gv_fake_camera->priv->is_streaming = FALSE;
+}
 
-			if (error != NULL) {
-				arv_warning_stream_thread ("[GvFakeCamera::thread] Failed to send leader for frame %" G_GUINT64_FORMAT
-							   ": %s", image_buffer->priv->frame_id, error->message);
-				g_clear_error (&error);
-			}
+/* The three functions below are the steps of the camera servicing loop, run either by the camera thread, or by a
+ * thread of a #ArvGvFakeCameraFarm shared by several cameras. The GVCP sockets are hidden from the external threads
+ * when the camera has its own control thread. */
 
-			block_id++;
+guint
+arv_gv_fake_camera_get_socket_fds (ArvGvFakeCamera *gv_fake_camera, GPollFD **socket_fds)
+{
+	g_return_val_if_fail (ARV_IS_GV_FAKE_CAMERA (gv_fake_camera), 0);
 
-			offset = 0;
-			while (offset < payload) {
-				size_t data_size;
+	if (socket_fds != NULL)
+		*socket_fds = gv_fake_camera->priv->socket_fds;
 
-				data_size = MIN (gv_packet_size - ARV_GVSP_PACKET_PROTOCOL_OVERHEAD,
-						 payload - offset);
+	if (gv_fake_camera->priv->control_thread)
+		return 0;
 
-				packet_size = ARV_GV_FAKE_CAMERA_BUFFER_SIZE;
-				arv_gvsp_packet_new_data_block (image_buffer->priv->frame_id, block_id,
-								data_size, ((char *) image_buffer->priv->data) + offset,
-								packet_buffer, &packet_size);
+	return gv_fake_camera->priv->n_socket_fds;
+}
 
-				if (g_random_double () >= gv_fake_camera->priv->gvsp_lost_packet_ratio)
-					g_socket_send_to (gv_fake_camera->priv->gvsp_socket, stream_address,
-							  packet_buffer, packet_size, NULL, &error);
-				else
-					arv_info_stream_thread ("Drop GVSP data packet frame:%" G_GUINT64_FORMAT
-								 ", block:%u", image_buffer->priv->frame_id, block_id);
+guint64
+arv_gv_fake_camera_get_next_timestamp_us (ArvGvFakeCamera *gv_fake_camera)
+{
+	g_return_val_if_fail (ARV_IS_GV_FAKE_CAMERA (gv_fake_camera), 0);
 
-				if (error != NULL) {
-					arv_info_stream_thread ("[GvFakeCamera::thread] Failed to send frame block %d for frame"
-								 " %" G_GUINT64_FORMAT ": %s",
-								 block_id, image_buffer->priv->frame_id, error->message);
-					g_clear_error (&error);
-				}
+	return gv_fake_camera->priv->next_timestamp_us;
+}
 
-				offset += data_size;
-				block_id++;
-			}
+void
+arv_gv_fake_camera_process_input (ArvGvFakeCamera *gv_fake_camera)
+{
+	unsigned int i;
 
-			packet_size = ARV_GV_FAKE_CAMERA_BUFFER_SIZE;
-			arv_gvsp_packet_new_data_trailer (image_buffer->priv->frame_id, block_id,
-							  packet_buffer, &packet_size);
+	g_return_if_fail (ARV_IS_GV_FAKE_CAMERA (gv_fake_camera));
 
-			if (g_random_double () >= gv_fake_camera->priv->gvsp_lost_packet_ratio)
-				g_socket_send_to (gv_fake_camera->priv->gvsp_socket, stream_address,
-						  packet_buffer, packet_size, NULL, &error);
-			else
-				arv_info_stream_thread ("Drop GVSP trailer packet frame: %" G_GUINT64_FORMAT,
-							 image_buffer->priv->frame_id);
+	for (i = 0; i < ARV_GV_FAKE_CAMERA_N_INPUT_SOCKETS; i++) {
+		GSocket *socket = gv_fake_camera->priv->input_sockets[i];
+		int count;
 
-			if (error != NULL) {
-				arv_info_stream_thread ("[GvFakeCamera::thread] Failed to send trailer for frame %" G_GUINT64_FORMAT
-							 ": %s", image_buffer->priv->frame_id, error->message);
-				g_clear_error (&error);
+		if (G_IS_SOCKET (socket)) {
+			GSocketAddress *remote_address = NULL;
+
+			arv_gpollfd_clear_one (&gv_fake_camera->priv->socket_fds[i], socket);
+
+			count = g_socket_receive_message (socket, &remote_address,
+							  &gv_fake_camera->priv->input_vector, 1, NULL, NULL,
+							  NULL, NULL, NULL);
+			if (count > 0) {
+				if (_handle_control_packet (gv_fake_camera, socket, remote_address,
+							    gv_fake_camera->priv->input_vector.buffer, count))
+					arv_info_device ("[GvFakeCamera::process_input] Control packet received");
 			}
+			g_clear_object (&remote_address);
+		}
+	}
+
+	g_mutex_lock (&gv_fake_camera->priv->stream_mutex);
+	if (arv_fake_camera_get_control_channel_privilege (gv_fake_camera->priv->camera) == 0 ||
+	    arv_fake_camera_get_acquisition_status (gv_fake_camera->priv->camera) == 0)
+		_stop_stream (gv_fake_camera);
+	g_mutex_unlock (&gv_fake_camera->priv->stream_mutex);
+}
 
-			is_streaming = TRUE;
+/* Sends a frame if the next frame time is reached and the acquisition is running, and schedules the next frame. */
+
+void
+arv_gv_fake_camera_process_frame (ArvGvFakeCamera *gv_fake_camera)
+{
+	ArvBuffer *image_buffer;
+	guint32 gv_packet_size;
+
+	g_return_if_fail (ARV_IS_GV_FAKE_CAMERA (gv_fake_camera));
+
+	if (g_get_real_time () < gv_fake_camera->priv->next_timestamp_us)
+		return;
+
+	g_mutex_lock (&gv_fake_camera->priv->stream_mutex);
+
+	if (arv_fake_camera_get_control_channel_privilege (gv_fake_camera->priv->camera) != 0 &&
+	    arv_fake_camera_get_acquisition_status (gv_fake_camera->priv->camera) != 0) {
+		if (gv_fake_camera->priv->stream_address == NULL) {
+			GSocketAddress *stream_address;
+			GInetAddress *inet_address;
+			char *inet_address_string;
+
+			stream_address = arv_fake_camera_get_stream_address (gv_fake_camera->priv->camera);
+			inet_address = g_inet_socket_address_get_address (G_INET_SOCKET_ADDRESS (stream_address));
+			inet_address_string = g_inet_address_to_string (inet_address);
+			arv_info_stream_thread ("[GvFakeCamera::process_frame] Start stream to %s (%d)",
+						inet_address_string,
+						g_inet_socket_address_get_port (G_INET_SOCKET_ADDRESS (stream_address)));
+			g_free (inet_address_string);
+
+			gv_fake_camera->priv->stream_address = stream_address;
+			gv_fake_camera->priv->payload = arv_fake_camera_get_payload (gv_fake_camera->priv->camera);
 		}
 
+		if (gv_fake_camera->priv->image_buffer == NULL)
+			gv_fake_camera->priv->image_buffer = arv_buffer_new (gv_fake_camera->priv->payload, NULL);
+		image_buffer = gv_fake_camera->priv->image_buffer;
+
+		arv_fake_camera_fill_buffer (gv_fake_camera->priv->camera, image_buffer, &gv_packet_size);
+		_setup_multipart (gv_fake_camera, image_buffer);
+
+		arv_info_stream_thread ("[GvFakeCamera::process_frame] Send frame %" G_GUINT64_FORMAT,
+					image_buffer->priv->frame_id);
+
+		if (gv_fake_camera->priv->traffic_generator) {
+			_send_frame_generator (gv_fake_camera, image_buffer);
+		} else {
+			_send_frame (gv_fake_camera, gv_fake_camera->priv->stream_address, image_buffer, gv_packet_size,
+				     gv_fake_camera->priv->packet_buffer);
+
+			gv_fake_camera->priv->image_buffer = _retain_frame (gv_fake_camera, image_buffer, gv_packet_size);
+		}
+
+		gv_fake_camera->priv->is_streaming = TRUE;
+	}
+
+	if (gv_fake_camera->priv->is_streaming)
+		arv_fake_camera_get_sleep_time_for_next_frame (gv_fake_camera->priv->camera,
+							       &gv_fake_camera->priv->next_timestamp_us);
+	else
+		gv_fake_camera->priv->next_timestamp_us = g_get_real_time () + 100000;
+
+	g_mutex_unlock (&gv_fake_camera->priv->stream_mutex);
+}
+
+static void *
+_thread (void *user_data)
+{
+	ArvGvFakeCamera *gv_fake_camera = user_data;
+	int n_events;
+
+	if (gv_fake_camera->priv->control_thread) {
+		/* Streaming only, the GVCP commands are serviced by _control_thread */
+		do {
+			gint64 delay_us;
+
+			delay_us = (gint64) gv_fake_camera->priv->next_timestamp_us - g_get_real_time ();
+			if (delay_us > 0)
+				g_usleep (MIN (delay_us, 100000));
+
+			arv_gv_fake_camera_process_frame (gv_fake_camera);
+		} while (!g_atomic_int_get (&gv_fake_camera->priv->cancel));
+
+		return NULL;
+	}
+
+	do {
+		do {
+			gint timeout_ms;
+
+			timeout_ms =  ((gint64) gv_fake_camera->priv->next_timestamp_us - g_get_real_time ()) / 1000LL;
+			if (timeout_ms < 0)
+				timeout_ms = 0;
+			else if (timeout_ms > 100)
+				timeout_ms = 100;
+
+			n_events = g_poll (gv_fake_camera->priv->socket_fds, gv_fake_camera->priv->n_socket_fds, timeout_ms);
+			if (n_events > 0)
+				arv_gv_fake_camera_process_input (gv_fake_camera);
+		} while (!g_atomic_int_get (&gv_fake_camera->priv->cancel) &&
+			 g_get_real_time () < gv_fake_camera->priv->next_timestamp_us);
+
+		arv_gv_fake_camera_process_frame (gv_fake_camera);
 	} while (!g_atomic_int_get (&gv_fake_camera->priv->cancel));
 
-	if (stream_address != NULL)
-		g_object_unref (stream_address);
-	if (image_buffer != NULL)
-		g_object_unref (image_buffer);
+	return NULL;
+}
 
-	g_free (packet_buffer);
-	g_free (input_vector.buffer);
+static void *
+_control_thread (void *user_data)
+{
+	ArvGvFakeCamera *gv_fake_camera = user_data;
+
+	do {
+		gint64 delay_us;
+		gint timeout_ms;
+
+		delay_us = _send_delayed_acks (gv_fake_camera);
+		timeout_ms = delay_us < 0 ? 100 : MIN ((delay_us + 999) / 1000, 100);
+
+		if (g_poll (gv_fake_camera->priv->socket_fds, gv_fake_camera->priv->n_socket_fds, timeout_ms) > 0)
+			arv_gv_fake_camera_process_input (gv_fake_camera);
+	} while (!g_atomic_int_get (&gv_fake_camera->priv->cancel));
+
+	g_queue_clear_full (&gv_fake_camera->priv->delayed_acks, (GDestroyNotify) _delayed_ack_free);
 
 	return NULL;
 }
@@ -496,13 +1133,26 @@ arv_gv_fake_camera_start (ArvGvFakeCamera *gv_fake_camera)
 			       arv_network_interface_get_name (iface_iter->data)) == 0) {
 			GSocketAddress *socket_address;
 			GInetAddress *inet_address;
+			GInetAddress *interface_inet_address;
 			GInetAddress *gvcp_inet_address;
 			unsigned int n_socket_fds;
 			unsigned int i;
 			socket_address = g_socket_address_new_from_native (arv_network_interface_get_addr(iface_iter->data),
 									   sizeof (struct sockaddr));
-			gvcp_inet_address = g_object_ref (g_inet_socket_address_get_address (G_INET_SOCKET_ADDRESS (socket_address)));
+			interface_inet_address = g_object_ref (g_inet_socket_address_get_address
+							       (G_INET_SOCKET_ADDRESS (socket_address)));
 			g_clear_object (&socket_address);
+			if (gv_fake_camera->priv->address != NULL)
+				gvcp_inet_address = g_inet_address_new_from_string (gv_fake_camera->priv->address);
+			else
+				gvcp_inet_address = g_object_ref (interface_inet_address);
+			if (gvcp_inet_address == NULL) {
+				arv_warning_device ("[GvFakeCamera::start] Invalid address '%s'",
+						    gv_fake_camera->priv->address);
+				g_clear_object (&interface_inet_address);
+				success = FALSE;
+				break;
+			}
 			arv_fake_camera_set_inet_address (gv_fake_camera->priv->camera, gvcp_inet_address);
 
 			success = success && _create_and_bind_input_socket (&gv_fake_camera->priv->gvsp_socket,
@@ -521,13 +1171,16 @@ arv_gv_fake_camera_start (ArvGvFakeCamera *gv_fake_camera)
 									   sizeof (struct sockaddr));
 			inet_address = g_object_ref (g_inet_socket_address_get_address (G_INET_SOCKET_ADDRESS (socket_address)));
 			g_clear_object (&socket_address);
-			if (!g_inet_address_equal (gvcp_inet_address, inet_address))
+			/* Cameras bound to an explicit address may share the interface with other ones */
+			if (!g_inet_address_equal (interface_inet_address, inet_address))
 				success = success && _create_and_bind_input_socket
 					(&gv_fake_camera->priv->input_sockets[ARV_GV_FAKE_CAMERA_INPUT_SOCKET_SUBNET_DISCOVERY],
-					 "Subnet discovery", inet_address, ARV_GVCP_PORT, FALSE, FALSE);
+					 "Subnet discovery", inet_address, ARV_GVCP_PORT,
+					 gv_fake_camera->priv->address != NULL, FALSE);
 			g_clear_object (&inet_address);
 
 			g_clear_object (&gvcp_inet_address);
+			g_clear_object (&interface_inet_address);
 
 			n_socket_fds = 0;
 			if (success) {
@@ -570,7 +1223,10 @@ arv_gv_fake_camera_start (ArvGvFakeCamera *gv_fake_camera)
 	}
 
 	gv_fake_camera->priv->cancel = FALSE;
-	gv_fake_camera->priv->thread = g_thread_new ("arv_fake_gv_fake_camera", _thread, gv_fake_camera);
+	if (gv_fake_camera->priv->own_thread)
+		gv_fake_camera->priv->thread = g_thread_new ("arv_fake_gv_fake_camera", _thread, gv_fake_camera);
+	if (gv_fake_camera->priv->control_thread)
+		gv_fake_camera->priv->gvcp_thread = g_thread_new ("arv_fake_gv_gvcp", _control_thread, gv_fake_camera);
 
 	return TRUE;
 }
@@ -582,12 +1238,19 @@ arv_gv_fake_camera_stop (ArvGvFakeCamera *gv_fake_camera)
 
 	g_return_if_fail (ARV_IS_GV_FAKE_CAMERA (gv_fake_camera));
 
-	if (gv_fake_camera->priv->thread == NULL)
-		return;
-
 	g_atomic_int_set (&gv_fake_camera->priv->cancel, TRUE);
-	g_thread_join (gv_fake_camera->priv->thread);
-	gv_fake_camera->priv->thread = NULL;
+
+	if (gv_fake_camera->priv->thread != NULL) {
+		g_thread_join (gv_fake_camera->priv->thread);
+		gv_fake_camera->priv->thread = NULL;
+	}
+
+	if (gv_fake_camera->priv->gvcp_thread != NULL) {
+		g_thread_join (gv_fake_camera->priv->gvcp_thread);
+		gv_fake_camera->priv->gvcp_thread = NULL;
+	}
+
+	_stop_stream (gv_fake_camera);
 
 	arv_gpollfd_finish_all (gv_fake_camera->priv->socket_fds, gv_fake_camera->priv->n_socket_fds);
 
@@ -660,6 +1323,59 @@ _set_property (GObject *object, guint prop_id, const GValue *value, GParamSpec *
 		case PROP_GVSP_LOST_PACKET_RATIO:
 			gv_fake_camera->priv->gvsp_lost_packet_ratio = g_value_get_double (value);
 			break;
+		case PROP_GVSP_LOST_BURST_LENGTH:
+			gv_fake_camera->priv->gvsp_lost_burst_length = g_value_get_uint (value);
+			break;
+		case PROP_GVSP_REORDER_WINDOW:
+			gv_fake_camera->priv->gvsp_reorder_window = g_value_get_uint (value);
+			break;
+		case PROP_GVSP_DUPLICATE_RATIO:
+			gv_fake_camera->priv->gvsp_duplicate_ratio = g_value_get_double (value);
+			break;
+		case PROP_GVSP_ERROR_RATIO:
+			gv_fake_camera->priv->gvsp_error_ratio = g_value_get_double (value);
+			break;
+		case PROP_GVSP_TRAILER_DELAY:
+			gv_fake_camera->priv->gvsp_trailer_delay_us = g_value_get_uint (value);
+			break;
+		case PROP_GVSP_MULTIPART:
+			gv_fake_camera->priv->gvsp_multipart = g_value_get_boolean (value);
+			break;
+		case PROP_GVSP_SEED:
+			gv_fake_camera->priv->gvsp_seed = g_value_get_uint (value);
+			break;
+		case PROP_FRAME_HISTORY:
+			gv_fake_camera->priv->history_length = g_value_get_uint (value);
+			break;
+		case PROP_ADDRESS:
+			g_free (gv_fake_camera->priv->address);
+			gv_fake_camera->priv->address = g_value_dup_string (value);
+			break;
+		case PROP_OWN_THREAD:
+			gv_fake_camera->priv->own_thread = g_value_get_boolean (value);
+			break;
+		case PROP_TRAFFIC_GENERATOR:
+			gv_fake_camera->priv->traffic_generator = g_value_get_boolean (value);
+			break;
+		case PROP_UDP_GSO:
+			gv_fake_camera->priv->udp_gso = g_value_get_boolean (value);
+			break;
+		case PROP_CONTROL_THREAD:
+			gv_fake_camera->priv->control_thread = g_value_get_boolean (value);
+			break;
+		case PROP_GVCP_ACK_LATENCY:
+			gv_fake_camera->priv->gvcp_ack_latency_us = g_value_get_uint (value);
+			break;
+		case PROP_GVCP_PENDING_ACK:
+			gv_fake_camera->priv->gvcp_pending_ack = g_value_get_boolean (value);
+			break;
+		case PROP_N_STREAM_CHANNELS:
+			gv_fake_camera->priv->n_stream_channels = g_value_get_uint (value);
+			if (gv_fake_camera->priv->camera != NULL)
+				arv_fake_camera_write_register (gv_fake_camera->priv->camera,
+								ARV_GVBS_N_STREAM_CHANNELS_OFFSET,
+								gv_fake_camera->priv->n_stream_channels);
+			break;
 		default:
 			G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
 			break;
@@ -706,6 +1422,13 @@ static void
 arv_gv_fake_camera_init (ArvGvFakeCamera *gv_fake_camera)
 {
 	gv_fake_camera->priv = arv_gv_fake_camera_get_instance_private (gv_fake_camera);
+
+	gv_fake_camera->priv->packet_buffer = g_malloc (ARV_GV_FAKE_CAMERA_BUFFER_SIZE);
+	gv_fake_camera->priv->input_vector.buffer = g_malloc0 (ARV_GV_FAKE_CAMERA_BUFFER_SIZE);
+	gv_fake_camera->priv->input_vector.size = ARV_GV_FAKE_CAMERA_BUFFER_SIZE;
+
+	g_queue_init (&gv_fake_camera->priv->delayed_acks);
+	g_mutex_init (&gv_fake_camera->priv->stream_mutex);
 }
 
 static void
@@ -716,6 +1439,29 @@ _constructed (GObject *gobject)
 	G_OBJECT_CLASS (arv_gv_fake_camera_parent_class)->constructed (gobject);
 
 	gv_fake_camera->priv->camera = arv_fake_camera_new_full (gv_fake_camera->priv->serial_number, gv_fake_camera->priv->genicam_filename);
+	arv_fake_camera_write_register (gv_fake_camera->priv->camera, ARV_GVBS_N_STREAM_CHANNELS_OFFSET,
+					gv_fake_camera->priv->n_stream_channels);
+
+	if (gv_fake_camera->priv->history_length > 0) {
+		guint32 capabilities = 0;
+
+		arv_fake_camera_read_register (gv_fake_camera->priv->camera, ARV_GVBS_GVCP_CAPABILITY_OFFSET,
+					       &capabilities);
+		arv_fake_camera_write_register (gv_fake_camera->priv->camera, ARV_GVBS_GVCP_CAPABILITY_OFFSET,
+						capabilities | ARV_GVBS_GVCP_CAPABILITY_PACKET_RESEND);
+	}
+
+	if (gv_fake_camera->priv->control_thread && gv_fake_camera->priv->gvcp_pending_ack) {
+		guint32 capabilities = 0;
+
+		arv_fake_camera_read_register (gv_fake_camera->priv->camera, ARV_GVBS_GVCP_CAPABILITY_OFFSET,
+					       &capabilities);
+		arv_fake_camera_write_register (gv_fake_camera->priv->camera, ARV_GVBS_GVCP_CAPABILITY_OFFSET,
+						capabilities | ARV_GVBS_GVCP_CAPABILITY_PENDING_ACK);
+	}
+
+	gv_fake_camera->priv->rand = g_rand_new_with_seed (gv_fake_camera->priv->gvsp_seed);
+
 	gv_fake_camera->priv->is_running = arv_gv_fake_camera_start (gv_fake_camera);
 }
 
@@ -729,10 +1475,16 @@ _finalize (GObject *object)
 	arv_gv_fake_camera_stop (gv_fake_camera);
 
 	g_object_unref (gv_fake_camera->priv->camera);
+	g_clear_pointer (&gv_fake_camera->priv->rand, g_rand_free);
+	g_clear_pointer (&gv_fake_camera->priv->packet_buffer, g_free);
+	g_clear_pointer (&gv_fake_camera->priv->input_vector.buffer, g_free);
 
 	g_clear_pointer (&gv_fake_camera->priv->interface_name, g_free);
 	g_clear_pointer (&gv_fake_camera->priv->serial_number, g_free);
 	g_clear_pointer (&gv_fake_camera->priv->genicam_filename, g_free);
+	g_clear_pointer (&gv_fake_camera->priv->address, g_free);
+
+	g_mutex_clear (&gv_fake_camera->priv->stream_mutex);
 
 	G_OBJECT_CLASS (arv_gv_fake_camera_parent_class)->finalize (object);
 }
@@ -773,6 +1525,41 @@ arv_gv_fake_camera_class_init (ArvGvFakeCameraClass *this_class)
 							      G_PARAM_CONSTRUCT_ONLY | G_PARAM_WRITABLE |
 							      G_PARAM_STATIC_NAME | G_PARAM_STATIC_NICK |
 							      G_PARAM_STATIC_BLURB));
+	/**
+	 * ArvGvFakeCamera:address:
+	 *
+	 * IPv4 address the camera is bound to, instead of the address of the listening interface. It allows to run
+	 * several cameras on the same interface, using aliased addresses, or any address of 127.0.0.0/8 on the
+	 * loopback interface.
+	 *
+	 * Since: 0.8.11
+	 */
+	g_object_class_install_property (object_class,
+					 PROP_ADDRESS,
+					 g_param_spec_string ("address",
+							      "Address",
+							      "Camera IPv4 address",
+							      NULL,
+							      G_PARAM_CONSTRUCT_ONLY | G_PARAM_WRITABLE |
+							      G_PARAM_STATIC_NAME | G_PARAM_STATIC_NICK |
+							      G_PARAM_STATIC_BLURB));
+	/**
+	 * ArvGvFakeCamera:own-thread:
+	 *
+	 * Service the camera using its own thread. When %FALSE, the camera is serviced by an external thread, like
+	 * the ones of an #ArvGvFakeCameraFarm.
+	 *
+	 * Since: 0.8.11
+	 */
+	g_object_class_install_property (object_class,
+					 PROP_OWN_THREAD,
+					 g_param_spec_boolean ("own-thread",
+							       "Own thread",
+							       "Service the camera using its own thread",
+							       TRUE,
+							       G_PARAM_CONSTRUCT_ONLY | G_PARAM_WRITABLE |
+							       G_PARAM_STATIC_NAME | G_PARAM_STATIC_NICK |
+							       G_PARAM_STATIC_BLURB));
 	g_object_class_install_property (object_class,
 					 PROP_GVSP_LOST_PACKET_RATIO,
 					 g_param_spec_double ("gvsp-lost-ratio",
@@ -782,4 +1569,242 @@ arv_gv_fake_camera_class_init (ArvGvFakeCameraClass *this_class)
 							      G_PARAM_WRITABLE | G_PARAM_CONSTRUCT |
 							      G_PARAM_STATIC_NAME | G_PARAM_STATIC_NICK |
 							      G_PARAM_STATIC_BLURB));
+	/**
+	 * ArvGvFakeCamera:gvsp-lost-burst-length:
+	 *
+	 * Number of consecutive packets dropped each time a packet is lost, according to the GVSP lost packet ratio.
+	 *
+	 * Since: 0.8.11
+	 */
+	g_object_class_install_property (object_class,
+					 PROP_GVSP_LOST_BURST_LENGTH,
+					 g_param_spec_uint ("gvsp-lost-burst-length",
+							    "GVSP lost burst length",
+							    "Number of consecutive lost packets",
+							    1, G_MAXUINT16, 1,
+							    G_PARAM_WRITABLE | G_PARAM_CONSTRUCT |
+							    G_PARAM_STATIC_NAME | G_PARAM_STATIC_NICK |
+							    G_PARAM_STATIC_BLURB));
+	/**
+	 * ArvGvFakeCamera:gvsp-reorder-window:
+	 *
+	 * Size of the windows of consecutive packets inside which the leader and data blocks are sent in a random
+	 * order. A value lower than 2 disables the reordering.
+	 *
+	 * Since: 0.8.11
+	 */
+	g_object_class_install_property (object_class,
+					 PROP_GVSP_REORDER_WINDOW,
+					 g_param_spec_uint ("gvsp-reorder-window",
+							    "GVSP reorder window",
+							    "GVSP packet reordering window",
+							    0, ARV_GV_FAKE_CAMERA_REORDER_WINDOW_MAX, 0,
+							    G_PARAM_WRITABLE | G_PARAM_CONSTRUCT |
+							    G_PARAM_STATIC_NAME | G_PARAM_STATIC_NICK |
+							    G_PARAM_STATIC_BLURB));
+	/**
+	 * ArvGvFakeCamera:gvsp-duplicate-ratio:
+	 *
+	 * Ratio of the packets sent twice.
+	 *
+	 * Since: 0.8.11
+	 */
+	g_object_class_install_property (object_class,
+					 PROP_GVSP_DUPLICATE_RATIO,
+					 g_param_spec_double ("gvsp-duplicate-ratio",
+							      "GVSP duplicated packet ratio",
+							      "GVSP duplicated packet ratio",
+							      0.0, 1.0, 0.0,
+							      G_PARAM_WRITABLE | G_PARAM_CONSTRUCT |
+							      G_PARAM_STATIC_NAME | G_PARAM_STATIC_NICK |
+							      G_PARAM_STATIC_BLURB));
+	/**
+	 * ArvGvFakeCamera:gvsp-error-ratio:
+	 *
+	 * Ratio of the packets replaced by a packet unavailable error packet.
+	 *
+	 * Since: 0.8.11
+	 */
+	g_object_class_install_property (object_class,
+					 PROP_GVSP_ERROR_RATIO,
+					 g_param_spec_double ("gvsp-error-ratio",
+							      "GVSP error packet ratio",
+							      "GVSP error packet ratio",
+							      0.0, 1.0, 0.0,
+							      G_PARAM_WRITABLE | G_PARAM_CONSTRUCT |
+							      G_PARAM_STATIC_NAME | G_PARAM_STATIC_NICK |
+							      G_PARAM_STATIC_BLURB));
+	/**
+	 * ArvGvFakeCamera:gvsp-trailer-delay:
+	 *
+	 * Delay inserted before the trailer of each frame, in µs.
+	 *
+	 * Since: 0.8.11
+	 */
+	g_object_class_install_property (object_class,
+					 PROP_GVSP_TRAILER_DELAY,
+					 g_param_spec_uint ("gvsp-trailer-delay",
+							    "GVSP trailer delay",
+							    "GVSP trailer delay, in µs",
+							    0, G_USEC_PER_SEC, 0,
+							    G_PARAM_WRITABLE | G_PARAM_CONSTRUCT |
+							    G_PARAM_STATIC_NAME | G_PARAM_STATIC_NICK |
+							    G_PARAM_STATIC_BLURB));
+	/**
+	 * ArvGvFakeCamera:gvsp-multipart:
+	 *
+	 * Send the images as 2 parts multipart payloads, each part holding half of the image lines. Not used by the
+	 * traffic generator.
+	 *
+	 * Since: 0.8.11
+	 */
+	g_object_class_install_property (object_class,
+					 PROP_GVSP_MULTIPART,
+					 g_param_spec_boolean ("gvsp-multipart",
+							       "GVSP multipart",
+							       "Send multipart payloads",
+							       FALSE,
+							       G_PARAM_WRITABLE | G_PARAM_CONSTRUCT |
+							       G_PARAM_STATIC_NAME | G_PARAM_STATIC_NICK |
+							       G_PARAM_STATIC_BLURB));
+	/**
+	 * ArvGvFakeCamera:gvsp-seed:
+	 *
+	 * Seed of the random generator driving the packet loss, reordering, duplication and error injection. A given
+	 * seed and configuration always produce the same impairment sequence.
+	 *
+	 * Since: 0.8.11
+	 */
+	g_object_class_install_property (object_class,
+					 PROP_GVSP_SEED,
+					 g_param_spec_uint ("gvsp-seed",
+							    "GVSP impairment seed",
+							    "Seed of the GVSP impairment random generator",
+							    0, G_MAXUINT32, 0,
+							    G_PARAM_CONSTRUCT_ONLY | G_PARAM_WRITABLE |
+							    G_PARAM_STATIC_NAME | G_PARAM_STATIC_NICK |
+							    G_PARAM_STATIC_BLURB));
+	/**
+	 * ArvGvFakeCamera:frame-history:
+	 *
+	 * Number of sent frames kept for the servicing of packet resend requests. Packet resend support is advertised
+	 * in the GVCP capabilities when it is not 0. Frames sent in traffic generator mode are not retained.
+	 *
+	 * Since: 0.8.11
+	 */
+	g_object_class_install_property (object_class,
+					 PROP_FRAME_HISTORY,
+					 g_param_spec_uint ("frame-history",
+							    "Frame history",
+							    "Number of frames retained for packet resend",
+							    0, ARV_GV_FAKE_CAMERA_FRAME_HISTORY_MAX,
+							    ARV_GV_FAKE_CAMERA_FRAME_HISTORY_DEFAULT,
+							    G_PARAM_CONSTRUCT_ONLY | G_PARAM_WRITABLE |
+							    G_PARAM_STATIC_NAME | G_PARAM_STATIC_NICK |
+							    G_PARAM_STATIC_BLURB));
+	/**
+	 * ArvGvFakeCamera:traffic-generator:
+	 *
+	 * Send the frames using batches of packets rendered once per frame geometry, which honour the packet delay
+	 * of the stream channels, on all the configured stream channels. This mode is meant for high rate load
+	 * testing.
+	 *
+	 * Since: 0.8.11
+	 */
+	g_object_class_install_property (object_class,
+					 PROP_TRAFFIC_GENERATOR,
+					 g_param_spec_boolean ("traffic-generator",
+							       "Traffic generator",
+							       "High rate traffic generator mode",
+							       FALSE,
+							       G_PARAM_WRITABLE | G_PARAM_CONSTRUCT |
+							       G_PARAM_STATIC_NAME | G_PARAM_STATIC_NICK |
+							       G_PARAM_STATIC_BLURB));
+	/**
+	 * ArvGvFakeCamera:udp-gso:
+	 *
+	 * In traffic generator mode, let the kernel segment the data blocks using UDP generic segmentation offload,
+	 * when available. It is not used when a GVSP lost packet ratio is set.
+	 *
+	 * Since: 0.8.11
+	 */
+	g_object_class_install_property (object_class,
+					 PROP_UDP_GSO,
+					 g_param_spec_boolean ("udp-gso",
+							       "UDP GSO",
+							       "Use UDP generic segmentation offload",
+							       FALSE,
+							       G_PARAM_WRITABLE | G_PARAM_CONSTRUCT |
+							       G_PARAM_STATIC_NAME | G_PARAM_STATIC_NICK |
+							       G_PARAM_STATIC_BLURB));
+	/**
+	 * ArvGvFakeCamera:n-stream-channels:
+	 *
+	 * Number of stream channels advertised by the device. The additional channels are only used in traffic
+	 * generator mode, once their destination address and port are set.
+	 *
+	 * Since: 0.8.11
+	 */
+	g_object_class_install_property (object_class,
+					 PROP_N_STREAM_CHANNELS,
+					 g_param_spec_uint ("n-stream-channels",
+							    "Number of stream channels",
+							    "Number of stream channels",
+							    1, ARV_GV_FAKE_CAMERA_N_STREAM_CHANNELS_MAX, 1,
+							    G_PARAM_WRITABLE | G_PARAM_CONSTRUCT |
+							    G_PARAM_STATIC_NAME | G_PARAM_STATIC_NICK |
+							    G_PARAM_STATIC_BLURB));
+	/**
+	 * ArvGvFakeCamera:control-thread:
+	 *
+	 * Service the GVCP commands in a dedicated thread, the camera thread, or the #ArvGvFakeCameraFarm one, then
+	 * only sending the stream packets. Heavy register polling doesn't delay the frames anymore, and the control
+	 * plane can be slowed down by #ArvGvFakeCamera:gvcp-ack-latency.
+	 *
+	 * Since: 0.8.11
+	 */
+	g_object_class_install_property (object_class,
+					 PROP_CONTROL_THREAD,
+					 g_param_spec_boolean ("control-thread",
+							       "Control thread",
+							       "Service the GVCP commands in a dedicated thread",
+							       FALSE,
+							       G_PARAM_CONSTRUCT_ONLY | G_PARAM_WRITABLE |
+							       G_PARAM_STATIC_NAME | G_PARAM_STATIC_NICK |
+							       G_PARAM_STATIC_BLURB));
+	/**
+	 * ArvGvFakeCamera:gvcp-ack-latency:
+	 *
+	 * Delay between the reception of a GVCP command and the emission of its acknowledge, in µs. The commands are
+	 * executed on reception, and the control thread keeps servicing the next ones meanwhile, which lets the
+	 * pipelined commands of a client overlap. Only used with #ArvGvFakeCamera:control-thread.
+	 *
+	 * Since: 0.8.11
+	 */
+	g_object_class_install_property (object_class,
+					 PROP_GVCP_ACK_LATENCY,
+					 g_param_spec_uint ("gvcp-ack-latency",
+							    "GVCP acknowledge latency",
+							    "GVCP acknowledge latency, in µs",
+							    0, ARV_GV_FAKE_CAMERA_GVCP_ACK_LATENCY_MAX_US, 0,
+							    G_PARAM_CONSTRUCT_ONLY | G_PARAM_WRITABLE |
+							    G_PARAM_STATIC_NAME | G_PARAM_STATIC_NICK |
+							    G_PARAM_STATIC_BLURB));
+	/**
+	 * ArvGvFakeCamera:gvcp-pending-ack:
+	 *
+	 * Send a PENDING_ACK with the time to completion as soon as a command is received, when its acknowledge is
+	 * delayed by #ArvGvFakeCamera:gvcp-ack-latency. The capability is advertised in the GVCP capabilities.
+	 *
+	 * Since: 0.8.11
+	 */
+	g_object_class_install_property (object_class,
+					 PROP_GVCP_PENDING_ACK,
+					 g_param_spec_boolean ("gvcp-pending-ack",
+							       "GVCP pending acknowledge",
+							       "Send pending acknowledges for the delayed commands",
+							       FALSE,
+							       G_PARAM_CONSTRUCT_ONLY | G_PARAM_WRITABLE |
+							       G_PARAM_STATIC_NAME | G_PARAM_STATIC_NICK |
+							       G_PARAM_STATIC_BLURB));
 }
@@ -33,6 +33,9 @@ G_BEGIN_DECLS
 
 #define ARV_GV_FAKE_CAMERA_DEFAULT_SERIAL_NUMBER	"GV01"
 #define ARV_GV_FAKE_CAMERA_DEFAULT_INTERFACE		"lo"
+#define ARV_GV_FAKE_CAMERA_N_STREAM_CHANNELS_MAX	4
+#define ARV_GV_FAKE_CAMERA_FRAME_HISTORY_MAX		32
+#define ARV_GV_FAKE_CAMERA_REORDER_WINDOW_MAX		256
 
 #define ARV_TYPE_GV_FAKE_CAMERA (arv_gv_fake_camera_get_type ())
 G_DECLARE_FINAL_TYPE (ArvGvFakeCamera, arv_gv_fake_camera, ARV, GV_FAKE_CAMERA, GObject)
@@ -0,0 +1,430 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2019 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel@gnome.org>
+ */
+
+#include <arvgvfakecamerafarm.h>
+#include <arvgvfakecameraprivate.h>
+#include <arvdebugprivate.h>
+#include <gio/gio.h>
+#include <string.h>
+
+/**
+ * SECTION: arvgvfakecamerafarm
+ * @short_description: Set of GigE Vision simulators
+ *
+ * #ArvGvFakeCameraFarm runs a set of #ArvGvFakeCamera in the same process, each one bound to its own address on
+ * the same network interface. The cameras are serviced by a small pool of shared threads, which makes it possible
+ * to simulate large camera fleets on a single host. Each camera can be configured independently, either using
+ * its features, or through the #ArvGvFakeCamera returned by arv_gv_fake_camera_farm_get_camera().
+ *
+ * On Linux, any address of the 127.0.0.0/8 range can be used on the loopback interface, without any additional
+ * configuration.
+ */
+
+#define ARV_GV_FAKE_CAMERA_FARM_N_THREADS_DEFAULT	4
+
+enum
+{
+  PROP_0,
+  PROP_INTERFACE_NAME,
+  PROP_ADDRESS,
+  PROP_N_CAMERAS,
+  PROP_N_THREADS
+};
+
+typedef struct {
+	GThread *thread;
+	GPtrArray *cameras;
+	GPollFD *poll_fds;
+	gboolean cancel;
+} ArvGvFakeCameraFarmThread;
+
+typedef struct {
+	char *interface_name;
+	char *address;
+	guint n_cameras;
+	guint n_threads;
+
+	GPtrArray *cameras;
+	ArvGvFakeCameraFarmThread *threads;
+
+	gboolean is_running;
+} ArvGvFakeCameraFarmPrivate;
+
+struct _ArvGvFakeCameraFarm {
+	GObject	object;
+
+	ArvGvFakeCameraFarmPrivate *priv;
+};
+
+struct _ArvGvFakeCameraFarmClass {
+	GObjectClass parent_class;
+};
+
+G_DEFINE_TYPE_WITH_CODE (ArvGvFakeCameraFarm, arv_gv_fake_camera_farm, G_TYPE_OBJECT,
+			 G_ADD_PRIVATE (ArvGvFakeCameraFarm))
+
+/* Polls the sockets of all the cameras of the thread at once, until the earliest next frame time. */
+
+static void *
+_thread (void *user_data)
+{
+	ArvGvFakeCameraFarmThread *thread = user_data;
+
+	while (!g_atomic_int_get (&thread->cancel)) {
+		guint64 next_timestamp_us;
+		gint64 time_us;
+		gint timeout_ms;
+		guint n_poll_fds = 0;
+		guint i;
+
+		time_us = g_get_real_time ();
+		next_timestamp_us = time_us + 100000;
+
+		for (i = 0; i < thread->cameras->len; i++) {
+			ArvGvFakeCamera *camera = g_ptr_array_index (thread->cameras, i);
+			GPollFD *socket_fds;
+			guint n_socket_fds;
+
+			n_socket_fds = arv_gv_fake_camera_get_socket_fds (camera, &socket_fds);
+			memcpy (&thread->poll_fds[n_poll_fds], socket_fds, n_socket_fds * sizeof (GPollFD));
+			n_poll_fds += n_socket_fds;
+
+			next_timestamp_us = MIN (next_timestamp_us, arv_gv_fake_camera_get_next_timestamp_us (camera));
+		}
+
+		timeout_ms = CLAMP (((gint64) next_timestamp_us - time_us) / 1000, 0, 100);
+
+		if (g_poll (thread->poll_fds, n_poll_fds, timeout_ms) > 0) {
+			n_poll_fds = 0;
+
+			for (i = 0; i < thread->cameras->len; i++) {
+				ArvGvFakeCamera *camera = g_ptr_array_index (thread->cameras, i);
+				GPollFD *socket_fds;
+				guint n_socket_fds;
+				gboolean has_events = FALSE;
+				guint j;
+
+				n_socket_fds = arv_gv_fake_camera_get_socket_fds (camera, &socket_fds);
+				for (j = 0; j < n_socket_fds; j++) {
+					socket_fds[j].revents = thread->poll_fds[n_poll_fds + j].revents;
+					has_events = has_events || socket_fds[j].revents != 0;
+				}
+				n_poll_fds += n_socket_fds;
+
+				if (has_events)
+					arv_gv_fake_camera_process_input (camera);
+			}
+		}
+
+		for (i = 0; i < thread->cameras->len; i++)
+			arv_gv_fake_camera_process_frame (g_ptr_array_index (thread->cameras, i));
+	}
+
+	return NULL;
+}
+
+/* Returns the string representation of the IPv4 address @offset addresses after @address */
+
+static char *
+_get_camera_address (GInetAddress *address, guint offset)
+{
+	GInetAddress *camera_address;
+	guint32 value;
+	char *string;
+
+	memcpy (&value, g_inet_address_to_bytes (address), sizeof (value));
+	value = g_htonl (g_ntohl (value) + offset);
+
+	camera_address = g_inet_address_new_from_bytes ((guint8 *) &value, G_SOCKET_FAMILY_IPV4);
+	string = g_inet_address_to_string (camera_address);
+	g_object_unref (camera_address);
+
+	return string;
+}
+
+/**
+ * arv_gv_fake_camera_farm_new:
+ * @interface_name: (nullable): listening network interface, default is lo
+ * @address: (nullable): address of the first camera, default is 127.0.1.1
+ * @n_cameras: number of cameras
+ * @n_threads: number of threads servicing the cameras, 0 for the default
+ *
+ * Creates a set of @n_cameras simulators, bound to consecutive addresses starting at @address. Their serial
+ * numbers are made of the "GVF" prefix, followed by the camera index.
+ *
+ * Returns: a new #ArvGvFakeCameraFarm
+ *
+ * Since: 0.8.11
+ */
+
+ArvGvFakeCameraFarm *
+arv_gv_fake_camera_farm_new (const char *interface_name, const char *address, guint n_cameras, guint n_threads)
+{
+	return g_object_new (ARV_TYPE_GV_FAKE_CAMERA_FARM,
+			     "interface-name", interface_name != NULL ?
+			     interface_name : ARV_GV_FAKE_CAMERA_DEFAULT_INTERFACE,
+			     "address", address != NULL ?
+			     address : ARV_GV_FAKE_CAMERA_FARM_DEFAULT_ADDRESS,
+			     "n-cameras", MIN (n_cameras, ARV_GV_FAKE_CAMERA_FARM_N_CAMERAS_MAX),
+			     "n-threads", n_threads > 0 ?
+			     MIN (n_threads, ARV_GV_FAKE_CAMERA_FARM_N_THREADS_MAX) :
+			     ARV_GV_FAKE_CAMERA_FARM_N_THREADS_DEFAULT,
+			     NULL);
+}
+
+/**
+ * arv_gv_fake_camera_farm_is_running:
+ * @farm: a #ArvGvFakeCameraFarm
+ *
+ * Returns: %TRUE if all the cameras of the farm are running.
+ *
+ * Since: 0.8.11
+ */
+
+gboolean
+arv_gv_fake_camera_farm_is_running (ArvGvFakeCameraFarm *farm)
+{
+	g_return_val_if_fail (ARV_IS_GV_FAKE_CAMERA_FARM (farm), FALSE);
+
+	return farm->priv->is_running;
+}
+
+/**
+ * arv_gv_fake_camera_farm_get_n_cameras:
+ * @farm: a #ArvGvFakeCameraFarm
+ *
+ * Returns: the number of cameras of the farm.
+ *
+ * Since: 0.8.11
+ */
+
+guint
+arv_gv_fake_camera_farm_get_n_cameras (ArvGvFakeCameraFarm *farm)
+{
+	g_return_val_if_fail (ARV_IS_GV_FAKE_CAMERA_FARM (farm), 0);
+
+	return farm->priv->cameras->len;
+}
+
+/**
+ * arv_gv_fake_camera_farm_get_camera:
+ * @farm: a #ArvGvFakeCameraFarm
+ * @index: camera index
+ *
+ * Returns: (transfer none) (nullable): the camera at @index.
+ *
+ * Since: 0.8.11
+ */
+
+ArvGvFakeCamera *
+arv_gv_fake_camera_farm_get_camera (ArvGvFakeCameraFarm *farm, guint index)
+{
+	g_return_val_if_fail (ARV_IS_GV_FAKE_CAMERA_FARM (farm), NULL);
+
+	if (index >= farm->priv->cameras->len)
+		return NULL;
+
+	return g_ptr_array_index (farm->priv->cameras, index);
+}
+
+static void
+_set_property (GObject *object, guint prop_id, const GValue *value, GParamSpec *pspec)
+{
+	ArvGvFakeCameraFarm *farm = ARV_GV_FAKE_CAMERA_FARM (object);
+
+	switch (prop_id)
+	{
+		case PROP_INTERFACE_NAME:
+			g_free (farm->priv->interface_name);
+			farm->priv->interface_name = g_value_dup_string (value);
+			break;
+		case PROP_ADDRESS:
+			g_free (farm->priv->address);
+			farm->priv->address = g_value_dup_string (value);
+			break;
+		case PROP_N_CAMERAS:
+			farm->priv->n_cameras = g_value_get_uint (value);
+			break;
+		case PROP_N_THREADS:
+			farm->priv->n_threads = g_value_get_uint (value);
+			break;
+		default:
+			G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+			break;
+	}
+}
+
+static void
+arv_gv_fake_camera_farm_init (ArvGvFakeCameraFarm *farm)
+{
+	farm->priv = arv_gv_fake_camera_farm_get_instance_private (farm);
+
+	farm->priv->cameras = g_ptr_array_new_with_free_func (g_object_unref);
+}
+
+static void
+_constructed (GObject *gobject)
+{
+	ArvGvFakeCameraFarm *farm = ARV_GV_FAKE_CAMERA_FARM (gobject);
+	GInetAddress *first_address;
+	guint n_threads;
+	guint i;
+
+	G_OBJECT_CLASS (arv_gv_fake_camera_farm_parent_class)->constructed (gobject);
+
+	first_address = g_inet_address_new_from_string (farm->priv->address);
+	if (first_address == NULL || g_inet_address_get_family (first_address) != G_SOCKET_FAMILY_IPV4) {
+		arv_warning_device ("[GvFakeCameraFarm::constructed] Invalid address '%s'", farm->priv->address);
+		g_clear_object (&first_address);
+		return;
+	}
+
+	farm->priv->is_running = TRUE;
+
+	for (i = 0; i < farm->priv->n_cameras; i++) {
+		ArvGvFakeCamera *camera;
+		char *address;
+		char *serial_number;
+
+		address = _get_camera_address (first_address, i);
+		serial_number = g_strdup_printf ("%s%04u", ARV_GV_FAKE_CAMERA_FARM_SERIAL_NUMBER_PREFIX, i);
+
+		camera = g_object_new (ARV_TYPE_GV_FAKE_CAMERA,
+				       "interface-name", farm->priv->interface_name,
+				       "serial-number", serial_number,
+				       "address", address,
+				       "own-thread", FALSE,
+				       NULL);
+
+		if (!arv_gv_fake_camera_is_running (camera)) {
+			arv_warning_device ("[GvFakeCameraFarm::constructed] Failed to start camera %s at %s",
+					    serial_number, address);
+			farm->priv->is_running = FALSE;
+		}
+
+		g_ptr_array_add (farm->priv->cameras, camera);
+
+		g_free (serial_number);
+		g_free (address);
+	}
+
+	g_object_unref (first_address);
+
+	n_threads = CLAMP (farm->priv->n_threads, 1, MAX (1, farm->priv->cameras->len));
+	farm->priv->threads = g_new0 (ArvGvFakeCameraFarmThread, n_threads);
+	farm->priv->n_threads = n_threads;
+
+	for (i = 0; i < n_threads; i++) {
+		ArvGvFakeCameraFarmThread *thread = &farm->priv->threads[i];
+		guint n_poll_fds = 0;
+		guint j;
+
+		thread->cameras = g_ptr_array_new ();
+		for (j = i; j < farm->priv->cameras->len; j += n_threads) {
+			ArvGvFakeCamera *camera = g_ptr_array_index (farm->priv->cameras, j);
+
+			g_ptr_array_add (thread->cameras, camera);
+			n_poll_fds += arv_gv_fake_camera_get_socket_fds (camera, NULL);
+		}
+
+		thread->poll_fds = g_new0 (GPollFD, MAX (1, n_poll_fds));
+		thread->thread = g_thread_new ("arv_gv_fake_camera_farm", _thread, thread);
+	}
+
+	arv_info_device ("[GvFakeCameraFarm::constructed] %u cameras serviced by %u threads",
+			 farm->priv->cameras->len, n_threads);
+}
+
+static void
+_finalize (GObject *object)
+{
+	ArvGvFakeCameraFarm *farm = ARV_GV_FAKE_CAMERA_FARM (object);
+	guint i;
+
+	if (farm->priv->threads != NULL) {
+		for (i = 0; i < farm->priv->n_threads; i++)
+			g_atomic_int_set (&farm->priv->threads[i].cancel, TRUE);
+
+		for (i = 0; i < farm->priv->n_threads; i++) {
+			g_thread_join (farm->priv->threads[i].thread);
+			g_ptr_array_unref (farm->priv->threads[i].cameras);
+			g_free (farm->priv->threads[i].poll_fds);
+		}
+
+		g_clear_pointer (&farm->priv->threads, g_free);
+	}
+
+	g_clear_pointer (&farm->priv->cameras, g_ptr_array_unref);
+
+	g_clear_pointer (&farm->priv->interface_name, g_free);
+	g_clear_pointer (&farm->priv->address, g_free);
+
+	G_OBJECT_CLASS (arv_gv_fake_camera_farm_parent_class)->finalize (object);
+}
+
+static void
+arv_gv_fake_camera_farm_class_init (ArvGvFakeCameraFarmClass *this_class)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS (this_class);
+
+	object_class->set_property = _set_property;
+	object_class->constructed = _constructed;
+	object_class->finalize = _finalize;
+
+	g_object_class_install_property (object_class,
+					 PROP_INTERFACE_NAME,
+					 g_param_spec_string ("interface-name",
+							      "Interface name",
+							      "Interface name",
+							      ARV_GV_FAKE_CAMERA_DEFAULT_INTERFACE,
+							      G_PARAM_CONSTRUCT_ONLY | G_PARAM_WRITABLE |
+							      G_PARAM_STATIC_NAME | G_PARAM_STATIC_NICK |
+							      G_PARAM_STATIC_BLURB));
+	g_object_class_install_property (object_class,
+					 PROP_ADDRESS,
+					 g_param_spec_string ("address",
+							      "Address",
+							      "IPv4 address of the first camera",
+							      ARV_GV_FAKE_CAMERA_FARM_DEFAULT_ADDRESS,
+							      G_PARAM_CONSTRUCT_ONLY | G_PARAM_WRITABLE |
+							      G_PARAM_STATIC_NAME | G_PARAM_STATIC_NICK |
+							      G_PARAM_STATIC_BLURB));
+	g_object_class_install_property (object_class,
+					 PROP_N_CAMERAS,
+					 g_param_spec_uint ("n-cameras",
+							    "Number of cameras",
+							    "Number of cameras",
+							    0, ARV_GV_FAKE_CAMERA_FARM_N_CAMERAS_MAX, 1,
+							    G_PARAM_CONSTRUCT_ONLY | G_PARAM_WRITABLE |
+							    G_PARAM_STATIC_NAME | G_PARAM_STATIC_NICK |
+							    G_PARAM_STATIC_BLURB));
+	g_object_class_install_property (object_class,
+					 PROP_N_THREADS,
+					 g_param_spec_uint ("n-threads",
+							    "Number of threads",
+							    "Number of threads servicing the cameras",
+							    1, ARV_GV_FAKE_CAMERA_FARM_N_THREADS_MAX,
+							    ARV_GV_FAKE_CAMERA_FARM_N_THREADS_DEFAULT,
+							    G_PARAM_CONSTRUCT_ONLY | G_PARAM_WRITABLE |
+							    G_PARAM_STATIC_NAME | G_PARAM_STATIC_NICK |
+							    G_PARAM_STATIC_BLURB));
+}
@@ -0,0 +1,51 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2019 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel@gnome.org>
+ */
+
+#if !defined (ARV_H_INSIDE) && !defined (ARAVIS_COMPILATION)
+#error "Only <arv.h> can be included directly."
+#endif
+
+#ifndef ARV_GV_FAKE_CAMERA_FARM_H
+#define ARV_GV_FAKE_CAMERA_FARM_H
+
+#include <arvtypes.h>
+#include <arvgvfakecamera.h>
+
+G_BEGIN_DECLS
+
+#define ARV_GV_FAKE_CAMERA_FARM_DEFAULT_ADDRESS		"127.0.1.1"
+#define ARV_GV_FAKE_CAMERA_FARM_SERIAL_NUMBER_PREFIX	"GVF"
+#define ARV_GV_FAKE_CAMERA_FARM_N_CAMERAS_MAX		256
+#define ARV_GV_FAKE_CAMERA_FARM_N_THREADS_MAX		64
+
+#define ARV_TYPE_GV_FAKE_CAMERA_FARM (arv_gv_fake_camera_farm_get_type ())
+G_DECLARE_FINAL_TYPE (ArvGvFakeCameraFarm, arv_gv_fake_camera_farm, ARV, GV_FAKE_CAMERA_FARM, GObject)
+
+ArvGvFakeCameraFarm *		arv_gv_fake_camera_farm_new		(const char *interface_name, const char *address,
+									 guint n_cameras, guint n_threads);
+gboolean			arv_gv_fake_camera_farm_is_running	(ArvGvFakeCameraFarm *farm);
+guint				arv_gv_fake_camera_farm_get_n_cameras	(ArvGvFakeCameraFarm *farm);
+ArvGvFakeCamera *		arv_gv_fake_camera_farm_get_camera	(ArvGvFakeCameraFarm *farm, guint index);
+
+G_END_DECLS
+
+#endif
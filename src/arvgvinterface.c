@@ -29,6 +29,7 @@
 #include <arvinterfaceprivate.h>
 #include <arvgvdeviceprivate.h>
 #include <arvgvcpprivate.h>
+#include <arvgenicamcacheprivate.h>
 #include <arvdebugprivate.h>
 #include <arvmisc.h>
 #include <arvmiscprivate.h>
@@ -289,10 +290,25 @@ arv_gv_interface_device_infos_unref (ArvGvInterfaceDeviceInfos *infos)
 	}
 }
 
+static gboolean
+arv_gv_interface_device_infos_match (ArvGvInterfaceDeviceInfos *infos, const char *device_id)
+{
+	return device_id == NULL ||
+		g_strcmp0 (infos->id, device_id) == 0 ||
+		g_strcmp0 (infos->user_id, device_id) == 0 ||
+		g_strcmp0 (infos->vendor_serial, device_id) == 0 ||
+		g_strcmp0 (infos->vendor_alias_serial, device_id) == 0 ||
+		g_strcmp0 (infos->mac, device_id) == 0;
+}
+
 /* ArvGvInterface implementation */
 
 typedef struct {
 	GHashTable *devices;
+
+	/* Device id used at opening -> "interface_address device_address unix_time" */
+	GMutex address_cache_mutex;
+	GHashTable *address_cache;
 } ArvGvInterfacePrivate;
 
 struct _ArvGvInterface {
@@ -307,12 +323,15 @@ struct _ArvGvInterfaceClass {
 
 G_DEFINE_TYPE_WITH_CODE (ArvGvInterface, arv_gv_interface, ARV_TYPE_INTERFACE, G_ADD_PRIVATE (ArvGvInterface))
 
+/* @interface, if not NULL, is notified of each found device, and can stop the discovery before the timeout */
+
 static ArvGvInterfaceDeviceInfos *
-_discover (GHashTable *devices, const char *device_id)
+_discover (GHashTable *devices, const char *device_id, ArvInterface *interface)
 {
 	ArvGvDiscoverSocketList *socket_list;
 	GSList *iter;
 	char buffer[ARV_GV_INTERFACE_SOCKET_BUFFER_SIZE];
+	gint64 deadline;
 	int count;
 	int i;
 
@@ -330,10 +349,20 @@ _discover (GHashTable *devices, const char *device_id)
 
 	arv_gv_discover_socket_list_send_discover_packet (socket_list);
 
+	deadline = g_get_monotonic_time () + 1000 * ARV_GV_INTERFACE_DISCOVERY_TIMEOUT_MS;
+
 	do {
 		gint res;
 
-		res = g_poll (socket_list->poll_fds, socket_list->n_sockets, ARV_GV_INTERFACE_DISCOVERY_TIMEOUT_MS);
+		/* Poll in short slices, in order to honour a discovery cancellation */
+		res = g_poll (socket_list->poll_fds, socket_list->n_sockets,
+			      interface != NULL ? ARV_GV_INTERFACE_DISCOVERY_POLL_MS :
+			      ARV_GV_INTERFACE_DISCOVERY_TIMEOUT_MS);
+		if (res == 0 && interface != NULL &&
+		    !arv_interface_is_discovery_cancelled (interface) &&
+		    g_get_monotonic_time () < deadline)
+			continue;
+
 		if (res <= 0) {
 			arv_gv_discover_socket_list_free (socket_list);
 
@@ -346,6 +375,8 @@ _discover (GHashTable *devices, const char *device_id)
 			return NULL;
 		}
 
+		deadline = g_get_monotonic_time () + 1000 * ARV_GV_INTERFACE_DISCOVERY_TIMEOUT_MS;
+
 		for (i = 0, iter = socket_list->sockets; iter != NULL; i++, iter = iter->next) {
 			ArvGvDiscoverSocket *discover_socket = iter->data;
 
@@ -399,13 +430,27 @@ _discover (GHashTable *devices, const char *device_id)
 										      arv_gv_interface_device_infos_ref (device_infos));
 							g_hash_table_replace (devices, device_infos->mac,
 									      arv_gv_interface_device_infos_ref (device_infos));
+
+							if (interface != NULL && device_infos->id != NULL &&
+							    device_infos->id[0] != '\0') {
+								const char *aliases[] = {
+									device_infos->user_id,
+									device_infos->vendor_serial,
+									device_infos->vendor_alias_serial,
+									device_infos->mac,
+									NULL
+								};
+
+								if (arv_interface_device_found (interface, device_infos->id,
+												aliases)) {
+									arv_gv_interface_device_infos_unref (device_infos);
+									arv_gv_discover_socket_list_free (socket_list);
+
+									return NULL;
+								}
+							}
 						} else {
-							if (device_id == NULL ||
-							    g_strcmp0 (device_infos->id, device_id) == 0 ||
-							    g_strcmp0 (device_infos->user_id, device_id) == 0 ||
-							    g_strcmp0 (device_infos->vendor_serial, device_id) == 0 ||
-							    g_strcmp0 (device_infos->vendor_alias_serial, device_id) == 0 ||
-							    g_strcmp0 (device_infos->mac, device_id) == 0) {
+							if (arv_gv_interface_device_infos_match (device_infos, device_id)) {
 								arv_gv_discover_socket_list_free (socket_list);
 
 								return device_infos;
@@ -423,7 +468,7 @@ _discover (GHashTable *devices, const char *device_id)
 static void
 arv_gv_interface_discover (ArvGvInterface *gv_interface)
 {
-	_discover (gv_interface->priv->devices, NULL);
+	_discover (gv_interface->priv->devices, NULL, ARV_INTERFACE (gv_interface));
 }
 
 static GInetAddress *
@@ -438,6 +483,181 @@ _device_infos_to_ginetaddress (ArvGvInterfaceDeviceInfos *device_infos)
 	return device_address;
 }
 
+/* Sends a discovery command to @device_address only, and returns the infos of the answering device if it matches
+ * @device_id */
+
+static ArvGvInterfaceDeviceInfos *
+_unicast_discover (GInetAddress *interface_address, GInetAddress *device_address, const char *device_id)
+{
+	ArvGvInterfaceDeviceInfos *device_infos = NULL;
+	GSocketAddress *interface_socket_address;
+	GSocketAddress *device_socket_address;
+	GSocket *socket;
+	ArvGvcpPacket *packet;
+	char buffer[ARV_GV_INTERFACE_SOCKET_BUFFER_SIZE];
+	GError *error = NULL;
+	size_t size;
+
+	socket = g_socket_new (G_SOCKET_FAMILY_IPV4, G_SOCKET_TYPE_DATAGRAM, G_SOCKET_PROTOCOL_UDP, &error);
+	if (socket == NULL) {
+		arv_warning_interface ("[GvInterface::unicast_discover] Error: %s", error->message);
+		g_clear_error (&error);
+		return NULL;
+	}
+
+	interface_socket_address = g_inet_socket_address_new (interface_address, 0);
+	device_socket_address = g_inet_socket_address_new (device_address, ARV_GVCP_PORT);
+	packet = arv_gvcp_packet_new_discovery_cmd (&size);
+
+	if (g_socket_bind (socket, interface_socket_address, FALSE, &error) &&
+	    g_socket_send_to (socket, device_socket_address, (const char *) packet, size, NULL, &error) >= 0) {
+		gint64 deadline = g_get_monotonic_time () + 1000 * ARV_GV_INTERFACE_UNICAST_DISCOVERY_TIMEOUT_MS;
+
+		while (device_infos == NULL) {
+			ArvGvcpPacket *ack = (ArvGvcpPacket *) buffer;
+			gint64 timeout_us = deadline - g_get_monotonic_time ();
+			gssize count;
+
+			if (timeout_us <= 0 ||
+			    !g_socket_condition_timed_wait (socket, G_IO_IN, timeout_us, NULL, NULL))
+				break;
+
+			count = g_socket_receive (socket, buffer, ARV_GV_INTERFACE_SOCKET_BUFFER_SIZE, NULL, NULL);
+			if (count < (gssize) (sizeof (ArvGvcpHeader) + ARV_GVBS_DISCOVERY_DATA_SIZE) ||
+			    g_ntohs (ack->header.command) != ARV_GVCP_COMMAND_DISCOVERY_ACK ||
+			    g_ntohs (ack->header.id) != 0xffff)
+				continue;
+
+			device_infos = arv_gv_interface_device_infos_new (interface_address,
+									  buffer + sizeof (ArvGvcpHeader));
+			if (!arv_gv_interface_device_infos_match (device_infos, device_id)) {
+				arv_info_interface ("[GvInterface::unicast_discover] '%s' expected, '%s' found",
+						    device_id, device_infos->id);
+				g_clear_pointer (&device_infos, arv_gv_interface_device_infos_unref);
+				break;
+			}
+		}
+	}
+
+	if (error != NULL) {
+		arv_info_interface ("[GvInterface::unicast_discover] Error: %s", error->message);
+		g_clear_error (&error);
+	}
+
+	arv_gvcp_packet_free (packet);
+	g_object_unref (device_socket_address);
+	g_object_unref (interface_socket_address);
+	g_object_unref (socket);
+
+	return device_infos;
+}
+
+static char *
+_address_cache_build_key (const char *device_id)
+{
+	g_autofree char *id = g_strdup_printf ("GigEVision\n%s", device_id);
+
+	return g_compute_checksum_for_string (G_CHECKSUM_SHA1, id, -1);
+}
+
+/* The last known addresses of a device are looked up in the in-process table, then in the on-disk cache if enabled
+ * by arv_enable_genicam_cache(), and checked by a unicast discovery. Returns %NULL on a miss, an expired entry or a
+ * failed check. */
+
+static ArvGvInterfaceDeviceInfos *
+_address_cache_lookup (ArvGvInterface *gv_interface, const char *device_id)
+{
+	ArvGvInterfacePrivate *priv = gv_interface->priv;
+	ArvGvInterfaceDeviceInfos *device_infos = NULL;
+	g_autofree char *entry = NULL;
+	g_auto (GStrv) fields = NULL;
+
+	g_mutex_lock (&priv->address_cache_mutex);
+	entry = g_strdup (g_hash_table_lookup (priv->address_cache, device_id));
+	g_mutex_unlock (&priv->address_cache_mutex);
+
+	if (entry == NULL) {
+		g_autofree char *key = _address_cache_build_key (device_id);
+
+		entry = arv_genicam_cache_load_device_address (key);
+		if (entry == NULL)
+			return NULL;
+	}
+
+	fields = g_strsplit (entry, " ", 3);
+	if (g_strv_length (fields) == 3) {
+		gint64 age_s = g_get_real_time () / G_USEC_PER_SEC - g_ascii_strtoll (fields[2], NULL, 10);
+
+		if (age_s >= 0 && age_s < ARV_GV_INTERFACE_ADDRESS_CACHE_TTL_S) {
+			GInetAddress *interface_address = g_inet_address_new_from_string (fields[0]);
+			GInetAddress *device_address = g_inet_address_new_from_string (fields[1]);
+
+			if (interface_address != NULL && device_address != NULL)
+				device_infos = _unicast_discover (interface_address, device_address, device_id);
+
+			g_clear_object (&interface_address);
+			g_clear_object (&device_address);
+		} else
+			arv_info_interface ("[GvInterface::address_cache_lookup] Expired entry for '%s'", device_id);
+	}
+
+	if (device_infos == NULL) {
+		arv_info_interface ("[GvInterface::address_cache_lookup] Stale entry for '%s'", device_id);
+
+		g_mutex_lock (&priv->address_cache_mutex);
+		g_hash_table_remove (priv->address_cache, device_id);
+		g_mutex_unlock (&priv->address_cache_mutex);
+	} else
+		arv_info_interface ("[GvInterface::address_cache_lookup] Device '%s' found at %s", device_id, fields[1]);
+
+	return device_infos;
+}
+
+static void
+_address_cache_store (ArvGvInterface *gv_interface, const char *device_id, ArvGvInterfaceDeviceInfos *device_infos)
+{
+	ArvGvInterfacePrivate *priv = gv_interface->priv;
+	GInetAddress *device_address;
+	g_autofree char *interface_string = NULL;
+	g_autofree char *device_string = NULL;
+	g_autofree char *key = NULL;
+	char *entry;
+
+	device_address = _device_infos_to_ginetaddress (device_infos);
+	interface_string = g_inet_address_to_string (device_infos->interface_address);
+	device_string = g_inet_address_to_string (device_address);
+	g_object_unref (device_address);
+
+	entry = g_strdup_printf ("%s %s %" G_GINT64_FORMAT, interface_string, device_string,
+				 g_get_real_time () / G_USEC_PER_SEC);
+
+	key = _address_cache_build_key (device_id);
+	arv_genicam_cache_store_device_address (key, entry);
+
+	g_mutex_lock (&priv->address_cache_mutex);
+	g_hash_table_replace (priv->address_cache, g_strdup (device_id), entry);
+	g_mutex_unlock (&priv->address_cache_mutex);
+}
+
+/* The address of a device successfully opened by its id is cached, for the next openings */
+
+static ArvDevice *
+_create_device (ArvGvInterface *gv_interface, const char *device_id, ArvGvInterfaceDeviceInfos *device_infos,
+		GError **error)
+{
+	ArvDevice *device;
+	GInetAddress *device_address;
+
+	device_address = _device_infos_to_ginetaddress (device_infos);
+	device = arv_gv_device_new (device_infos->interface_address, device_address, error);
+	g_object_unref (device_address);
+
+	if (ARV_IS_DEVICE (device) && device_id != NULL)
+		_address_cache_store (gv_interface, device_id, device_infos);
+
+	return device;
+}
+
 static void
 arv_gv_interface_update_device_list (ArvInterface *interface, GArray *device_ids)
 {
@@ -651,34 +871,43 @@ _open_device (ArvInterface *interface, GHashTable *devices, const char *device_i
 		return device;
 	}
 
-	device_address = _device_infos_to_ginetaddress (device_infos);
-	device = arv_gv_device_new (device_infos->interface_address, device_address, error);
-	g_object_unref (device_address);
-
-	return device;
+	return _create_device (gv_interface, device_id, device_infos, error);
 }
 
 static ArvDevice *
 arv_gv_interface_open_device (ArvInterface *interface, const char *device_id, GError **error)
 {
+	ArvGvInterface *gv_interface = ARV_GV_INTERFACE (interface);
 	ArvDevice *device;
 	ArvGvInterfaceDeviceInfos *device_infos;
 	GError *local_error = NULL;
 
-	device = _open_device (interface, ARV_GV_INTERFACE (interface)->priv->devices, device_id, &local_error);
+	/* A unicast check of the last known address saves the broadcast discovery timeout */
+	if (device_id != NULL && g_hash_table_lookup (gv_interface->priv->devices, device_id) == NULL) {
+		device_infos = _address_cache_lookup (gv_interface, device_id);
+		if (device_infos != NULL) {
+			device = _create_device (gv_interface, device_id, device_infos, &local_error);
+			arv_gv_interface_device_infos_unref (device_infos);
+
+			if (ARV_IS_DEVICE (device))
+				return device;
+
+			arv_info_interface ("[GvInterface::open_device] Cached address of '%s' failed: %s",
+					    device_id, local_error != NULL ? local_error->message : "unknown error");
+			g_clear_error (&local_error);
+		}
+	}
+
+	device = _open_device (interface, gv_interface->priv->devices, device_id, &local_error);
 	if (ARV_IS_DEVICE (device) || local_error != NULL) {
 		if (local_error != NULL)
 			g_propagate_error (error, local_error);
 		return device;
 	}
 
-	device_infos = _discover (NULL, device_id);
+	device_infos = _discover (NULL, device_id, NULL);
 	if (device_infos != NULL) {
-		GInetAddress *device_address;
-
-		device_address = _device_infos_to_ginetaddress (device_infos);
-		device = arv_gv_device_new (device_infos->interface_address, device_address, error);
-		g_object_unref (device_address);
+		device = _create_device (gv_interface, device_id, device_infos, error);
 
 		arv_gv_interface_device_infos_unref (device_infos);
 
@@ -688,6 +917,159 @@ arv_gv_interface_open_device (ArvInterface *interface, const char *device_id, GE
 	return NULL;
 }
 
+static gint arv_gv_interface_action_packet_id = 0;
+
+/**
+ * arv_gv_interface_send_action_command:
+ * @device_key: device key, matched against the ActionDeviceKey feature of the devices
+ * @group_key: group key, matched against the ActionGroupKey feature of the devices
+ * @group_mask: group mask, matched against the ActionGroupMask feature of the devices
+ * @action_time_ns: action time in device timestamp units, or 0 for an immediate action
+ * @timeout_ms: acknowledge timeout, in milliseconds
+ * @n_acknowledges: (out) (optional): placeholder for the number of devices which acknowledged the command
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Broadcasts an action command on all the network interfaces. Every device with a matching device key, group key and
+ * group mask executes the corresponding action at the same time, which makes it possible to trigger several cameras
+ * with a single packet. If @action_time_ns is not 0, the action is scheduled at the given device time, which is
+ * meaningful when the device clocks are synchronized using PTP.
+ *
+ * If @n_acknowledges is not %NULL, the devices are asked to acknowledge the command, and this function waits for
+ * @timeout_ms milliseconds, counting the successful acknowledges. Devices which don't match the keys don't reply.
+ *
+ * Returns: %TRUE if the command was sent on at least one interface.
+ *
+ * Since: 0.8.11
+ */
+
+gboolean
+arv_gv_interface_send_action_command (guint32 device_key, guint32 group_key, guint32 group_mask,
+				      guint64 action_time_ns, guint timeout_ms,
+				      guint *n_acknowledges, GError **error)
+{
+	ArvGvDiscoverSocketList *socket_list;
+	GInetAddress *broadcast_address;
+	GSocketAddress *broadcast_socket_address;
+	ArvGvcpPacket *packet;
+	GSList *iter;
+	char buffer[ARV_GV_INTERFACE_SOCKET_BUFFER_SIZE];
+	size_t size;
+	guint16 packet_id;
+	guint n_sent = 0;
+	guint n_acks = 0;
+	guint n_errors = 0;
+	gint64 deadline;
+	int i;
+
+	if (n_acknowledges != NULL)
+		*n_acknowledges = 0;
+
+	socket_list = arv_gv_discover_socket_list_new ();
+
+	if (socket_list->n_sockets < 1) {
+		arv_gv_discover_socket_list_free (socket_list);
+		g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_NOT_FOUND,
+			     "No network interface found for action command");
+		return FALSE;
+	}
+
+	/* Packet id 0 is not allowed */
+	packet_id = ((guint) g_atomic_int_add (&arv_gv_interface_action_packet_id, 1)) % 0xffff + 1;
+
+	packet = arv_gvcp_packet_new_action_cmd (device_key, group_key, group_mask, action_time_ns,
+						 n_acknowledges != NULL, packet_id, &size);
+
+	arv_gvcp_packet_debug (packet, ARV_DEBUG_LEVEL_DEBUG);
+
+	broadcast_address = g_inet_address_new_from_string ("255.255.255.255");
+	broadcast_socket_address = g_inet_socket_address_new (broadcast_address, ARV_GVCP_PORT);
+	g_object_unref (broadcast_address);
+
+	for (iter = socket_list->sockets; iter != NULL; iter = iter->next) {
+		ArvGvDiscoverSocket *discover_socket = iter->data;
+		GError *local_error = NULL;
+
+		arv_gv_discover_socket_set_broadcast (discover_socket, TRUE);
+		if (g_socket_send_to (discover_socket->socket, broadcast_socket_address,
+				      (const char *) packet, size, NULL, &local_error) >= 0)
+			n_sent++;
+		else {
+			arv_warning_interface ("[GvInterface::send_action_command] Error: %s", local_error->message);
+			g_clear_error (&local_error);
+		}
+		arv_gv_discover_socket_set_broadcast (discover_socket, FALSE);
+	}
+
+	g_object_unref (broadcast_socket_address);
+	arv_gvcp_packet_free (packet);
+
+	if (n_sent == 0) {
+		arv_gv_discover_socket_list_free (socket_list);
+		g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_TRANSFER_ERROR,
+			     "Failed to send action command");
+		return FALSE;
+	}
+
+	if (n_acknowledges == NULL) {
+		arv_gv_discover_socket_list_free (socket_list);
+		return TRUE;
+	}
+
+	deadline = g_get_monotonic_time () + 1000 * (gint64) timeout_ms;
+
+	do {
+		gint64 timeout_us;
+		gint res;
+
+		timeout_us = deadline - g_get_monotonic_time ();
+		if (timeout_us <= 0)
+			break;
+
+		res = g_poll (socket_list->poll_fds, socket_list->n_sockets, (timeout_us + 999) / 1000);
+		if (res <= 0)
+			break;
+
+		for (i = 0, iter = socket_list->sockets; iter != NULL; i++, iter = iter->next) {
+			ArvGvDiscoverSocket *discover_socket = iter->data;
+			int count;
+
+			arv_gpollfd_clear_one (&socket_list->poll_fds[i], discover_socket->socket);
+
+			do {
+				g_socket_set_blocking (discover_socket->socket, FALSE);
+				count = g_socket_receive (discover_socket->socket, buffer,
+							  ARV_GV_INTERFACE_SOCKET_BUFFER_SIZE, NULL, NULL);
+				g_socket_set_blocking (discover_socket->socket, TRUE);
+
+				if (count >= (int) sizeof (ArvGvcpHeader)) {
+					ArvGvcpPacket *ack_packet = (ArvGvcpPacket *) buffer;
+
+					if (g_ntohs (ack_packet->header.command) == ARV_GVCP_COMMAND_ACTION_ACK &&
+					    g_ntohs (ack_packet->header.id) == packet_id) {
+						if (ack_packet->header.packet_type == ARV_GVCP_PACKET_TYPE_ACK)
+							n_acks++;
+						else {
+							arv_warning_interface ("[GvInterface::send_action_command] "
+									       "Action error: %s",
+									       arv_gvcp_error_to_string
+									       (ack_packet->header.packet_flags));
+							n_errors++;
+						}
+					}
+				}
+			} while (count > 0);
+		}
+	} while (1);
+
+	arv_gv_discover_socket_list_free (socket_list);
+
+	arv_info_interface ("[GvInterface::send_action_command] %u acknowledge(s), %u error(s)", n_acks, n_errors);
+
+	*n_acknowledges = n_acks;
+
+	return TRUE;
+}
+
 static ArvInterface *arv_gv_interface = NULL;
 static GMutex arv_gv_interface_mutex;
 
@@ -732,6 +1114,9 @@ arv_gv_interface_init (ArvGvInterface *gv_interface)
 
 	gv_interface->priv->devices = g_hash_table_new_full (g_str_hash, g_str_equal, NULL,
 							     (GDestroyNotify) arv_gv_interface_device_infos_unref);
+
+	g_mutex_init (&gv_interface->priv->address_cache_mutex);
+	gv_interface->priv->address_cache = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
 }
 
 static void
@@ -742,6 +1127,10 @@ arv_gv_interface_finalize (GObject *object)
 	g_hash_table_unref (gv_interface->priv->devices);
 	gv_interface->priv->devices = NULL;
 
+	g_hash_table_unref (gv_interface->priv->address_cache);
+	gv_interface->priv->address_cache = NULL;
+	g_mutex_clear (&gv_interface->priv->address_cache_mutex);
+
 	G_OBJECT_CLASS (arv_gv_interface_parent_class)->finalize (object);
 }
 
@@ -33,6 +33,9 @@
 G_BEGIN_DECLS
 
 #define ARV_GV_INTERFACE_DISCOVERY_TIMEOUT_MS	1000
+#define ARV_GV_INTERFACE_DISCOVERY_POLL_MS	50
+#define ARV_GV_INTERFACE_UNICAST_DISCOVERY_TIMEOUT_MS	200
+#define ARV_GV_INTERFACE_ADDRESS_CACHE_TTL_S	(7 * 24 * 3600)
 #define ARV_GV_INTERFACE_SOCKET_BUFFER_SIZE	1024
 #define ARV_GV_INTERFACE_DISCOVERY_SOCKET_BUFFER_SIZE	(256*1024)
 
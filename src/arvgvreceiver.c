@@ -0,0 +1,430 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2019 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel@gnome.org>
+ */
+
+/*< private >
+ * SECTION: arvgvreceiver
+ * @short_description: Shared GigEVision stream receive engine
+ *
+ * The shared receiver runs a fixed number of worker threads, optionally
+ * pinned to a CPU, each servicing a set of stream sockets through a single
+ * epoll set. It allows to match the receive threads to the network interface
+ * receive queues, instead of having one unpinned thread per stream.
+ */
+
+/* For CPU_SET */
+#define _GNU_SOURCE
+
+#define ARV_DEBUG_HOT_PATH
+
+#include <arvgvreceiverprivate.h>
+#include <arvfeatures.h>
+#include <arvdebugprivate.h>
+#include <arvmiscprivate.h>
+
+#if ARAVIS_HAS_EPOLL
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sched.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#endif
+
+#define ARV_GV_RECEIVER_POLL_TIMEOUT_MS		1000
+#define ARV_GV_RECEIVER_N_EVENTS_MAX		32
+
+static GMutex arv_gv_receiver_mutex;
+
+#if ARAVIS_HAS_EPOLL
+
+typedef struct {
+	ArvGvReceiverClient *client;
+	gboolean add;
+	gboolean done;
+} ArvGvReceiverCommand;
+
+struct _ArvGvReceiverWorker {
+	GThread *thread;
+	int cpu;
+	int epoll_fd;
+	int event_fd;
+
+	GMutex mutex;
+	GCond cond;
+	GQueue commands;
+	gboolean quit;
+
+	/* Protected by arv_gv_receiver_mutex */
+	guint n_clients;
+
+	/* Only accessed from the worker thread */
+	GPtrArray *clients;
+};
+
+static GPtrArray *arv_gv_receiver_workers = NULL;
+static guint arv_gv_receiver_n_threads = 1;
+static gint *arv_gv_receiver_cpus = NULL;
+
+static void
+_worker_signal (ArvGvReceiverWorker *worker)
+{
+	guint64 value = 1;
+
+	if (write (worker->event_fd, &value, sizeof (value)) != sizeof (value))
+		arv_warning_stream ("[GvReceiver::signal] Failed to wake up worker (%s)", strerror (errno));
+}
+
+static void
+_worker_process_commands (ArvGvReceiverWorker *worker)
+{
+	ArvGvReceiverCommand *command;
+	guint64 value;
+
+	if (read (worker->event_fd, &value, sizeof (value)) != sizeof (value) && errno != EAGAIN)
+		arv_warning_stream_thread ("[GvReceiver::process_commands] Failed to read event (%s)",
+					   strerror (errno));
+
+	g_mutex_lock (&worker->mutex);
+
+	while ((command = g_queue_pop_head (&worker->commands)) != NULL) {
+		ArvGvReceiverClient *client = command->client;
+
+		/* Client callbacks are called without the lock held */
+		g_mutex_unlock (&worker->mutex);
+
+		if (command->add) {
+			struct epoll_event event = {0};
+
+			client->start (client->data);
+
+			event.events = EPOLLIN;
+			event.data.ptr = client;
+			if (epoll_ctl (worker->epoll_fd, EPOLL_CTL_ADD, client->fd, &event) != 0)
+				arv_warning_stream_thread ("[GvReceiver::process_commands] Failed to add socket (%s)",
+							   strerror (errno));
+			g_ptr_array_add (worker->clients, client);
+		} else {
+			epoll_ctl (worker->epoll_fd, EPOLL_CTL_DEL, client->fd, NULL);
+			g_ptr_array_remove (worker->clients, client);
+
+			client->stop (client->data);
+		}
+
+		g_mutex_lock (&worker->mutex);
+
+		if (command->add)
+			g_free (command);
+		else {
+			command->done = TRUE;
+			g_cond_broadcast (&worker->cond);
+		}
+	}
+
+	g_mutex_unlock (&worker->mutex);
+}
+
+static void *
+_worker_thread (void *data)
+{
+	ArvGvReceiverWorker *worker = data;
+	struct epoll_event events[ARV_GV_RECEIVER_N_EVENTS_MAX];
+
+	if (worker->cpu >= 0) {
+		cpu_set_t cpu_set;
+
+		CPU_ZERO (&cpu_set);
+		CPU_SET (worker->cpu, &cpu_set);
+
+		if (sched_setaffinity (0, sizeof (cpu_set), &cpu_set) != 0)
+			arv_warning_stream_thread ("[GvReceiver::worker_thread] Failed to pin thread to cpu %d (%s)",
+						   worker->cpu, strerror (errno));
+		else
+			arv_info_stream_thread ("[GvReceiver::worker_thread] Thread pinned to cpu %d", worker->cpu);
+	}
+
+	while (!g_atomic_int_get (&worker->quit)) {
+		guint64 time_us;
+		int timeout_ms = ARV_GV_RECEIVER_POLL_TIMEOUT_MS;
+		int n_events;
+		int i;
+		guint j;
+
+		for (j = 0; j < worker->clients->len; j++) {
+			ArvGvReceiverClient *client = g_ptr_array_index (worker->clients, j);
+
+			timeout_ms = MIN (timeout_ms, client->get_timeout_ms (client->data));
+		}
+
+		n_events = epoll_wait (worker->epoll_fd, events, ARV_GV_RECEIVER_N_EVENTS_MAX, timeout_ms);
+		if (n_events < 0) {
+			if (errno != EINTR)
+				arv_warning_stream_thread ("[GvReceiver::worker_thread] epoll_wait error (%s)",
+							   strerror (errno));
+			continue;
+		}
+
+		time_us = g_get_monotonic_time ();
+
+		for (i = 0; i < n_events; i++) {
+			ArvGvReceiverClient *client = events[i].data.ptr;
+
+			if (client == NULL)
+				_worker_process_commands (worker);
+			else
+				client->receive (client->data, time_us);
+		}
+
+		for (j = 0; j < worker->clients->len; j++) {
+			ArvGvReceiverClient *client = g_ptr_array_index (worker->clients, j);
+
+			client->check (client->data, time_us);
+		}
+	}
+
+	return NULL;
+}
+
+static ArvGvReceiverWorker *
+_worker_new (int index, int cpu)
+{
+	ArvGvReceiverWorker *worker;
+	struct epoll_event event = {0};
+	char *name;
+
+	worker = g_new0 (ArvGvReceiverWorker, 1);
+	worker->cpu = cpu;
+	worker->epoll_fd = epoll_create1 (EPOLL_CLOEXEC);
+	worker->event_fd = eventfd (0, EFD_CLOEXEC | EFD_NONBLOCK);
+
+	if (worker->epoll_fd < 0 || worker->event_fd < 0) {
+		arv_warning_stream ("[GvReceiver::worker_new] Failed to create worker (%s)", strerror (errno));
+		if (worker->epoll_fd >= 0)
+			close (worker->epoll_fd);
+		if (worker->event_fd >= 0)
+			close (worker->event_fd);
+		g_free (worker);
+		return NULL;
+	}
+
+	event.events = EPOLLIN;
+	event.data.ptr = NULL;
+	epoll_ctl (worker->epoll_fd, EPOLL_CTL_ADD, worker->event_fd, &event);
+
+	g_mutex_init (&worker->mutex);
+	g_cond_init (&worker->cond);
+	g_queue_init (&worker->commands);
+	worker->clients = g_ptr_array_new ();
+
+	name = g_strdup_printf ("arv_gv_recv_%d", index);
+	worker->thread = g_thread_new (name, _worker_thread, worker);
+	g_free (name);
+
+	return worker;
+}
+
+static void
+_worker_free (ArvGvReceiverWorker *worker)
+{
+	g_atomic_int_set (&worker->quit, TRUE);
+	_worker_signal (worker);
+	g_thread_join (worker->thread);
+
+	close (worker->epoll_fd);
+	close (worker->event_fd);
+	g_ptr_array_unref (worker->clients);
+	g_queue_clear (&worker->commands);
+	g_cond_clear (&worker->cond);
+	g_mutex_clear (&worker->mutex);
+	g_free (worker);
+}
+
+static gboolean
+_has_clients (void)
+{
+	guint i;
+
+	if (arv_gv_receiver_workers == NULL)
+		return FALSE;
+
+	for (i = 0; i < arv_gv_receiver_workers->len; i++)
+		if (((ArvGvReceiverWorker *) g_ptr_array_index (arv_gv_receiver_workers, i))->n_clients > 0)
+			return TRUE;
+
+	return FALSE;
+}
+
+static void
+_free_workers (void)
+{
+	g_clear_pointer (&arv_gv_receiver_workers, g_ptr_array_unref);
+}
+
+void
+arv_gv_receiver_configure (guint n_threads, const gint *cpus)
+{
+	g_mutex_lock (&arv_gv_receiver_mutex);
+
+	if (_has_clients ()) {
+		arv_warning_stream ("[GvReceiver::configure] Shared receiver in use, configuration ignored");
+		g_mutex_unlock (&arv_gv_receiver_mutex);
+		return;
+	}
+
+	_free_workers ();
+
+	arv_gv_receiver_n_threads = MAX (n_threads, 1);
+	g_clear_pointer (&arv_gv_receiver_cpus, g_free);
+	if (cpus != NULL)
+		arv_gv_receiver_cpus = arv_memdup (cpus, arv_gv_receiver_n_threads * sizeof (gint));
+
+	g_mutex_unlock (&arv_gv_receiver_mutex);
+}
+
+gboolean
+arv_gv_receiver_add (ArvGvReceiverClient *client)
+{
+	ArvGvReceiverWorker *worker = NULL;
+	ArvGvReceiverCommand *command;
+	guint i;
+
+	g_return_val_if_fail (client != NULL, FALSE);
+	g_return_val_if_fail (client->worker == NULL, FALSE);
+
+	g_mutex_lock (&arv_gv_receiver_mutex);
+
+	if (arv_gv_receiver_workers == NULL) {
+		arv_gv_receiver_workers = g_ptr_array_new_with_free_func ((GDestroyNotify) _worker_free);
+
+		for (i = 0; i < arv_gv_receiver_n_threads; i++) {
+			ArvGvReceiverWorker *new_worker;
+
+			new_worker = _worker_new (i, arv_gv_receiver_cpus != NULL ? arv_gv_receiver_cpus[i] : -1);
+			if (new_worker != NULL)
+				g_ptr_array_add (arv_gv_receiver_workers, new_worker);
+		}
+
+		arv_info_stream ("[GvReceiver::add] Started %u shared receiver threads", arv_gv_receiver_workers->len);
+	}
+
+	/* Least loaded worker */
+	for (i = 0; i < arv_gv_receiver_workers->len; i++) {
+		ArvGvReceiverWorker *candidate = g_ptr_array_index (arv_gv_receiver_workers, i);
+
+		if (worker == NULL || candidate->n_clients < worker->n_clients)
+			worker = candidate;
+	}
+
+	if (worker == NULL) {
+		g_mutex_unlock (&arv_gv_receiver_mutex);
+		return FALSE;
+	}
+
+	worker->n_clients++;
+	client->worker = worker;
+
+	g_mutex_unlock (&arv_gv_receiver_mutex);
+
+	command = g_new0 (ArvGvReceiverCommand, 1);
+	command->client = client;
+	command->add = TRUE;
+
+	g_mutex_lock (&worker->mutex);
+	g_queue_push_tail (&worker->commands, command);
+	g_mutex_unlock (&worker->mutex);
+
+	_worker_signal (worker);
+
+	return TRUE;
+}
+
+void
+arv_gv_receiver_remove (ArvGvReceiverClient *client)
+{
+	ArvGvReceiverWorker *worker;
+	ArvGvReceiverCommand command = {0};
+
+	g_return_if_fail (client != NULL);
+	g_return_if_fail (client->worker != NULL);
+
+	worker = client->worker;
+
+	command.client = client;
+	command.add = FALSE;
+
+	g_mutex_lock (&worker->mutex);
+	g_queue_push_tail (&worker->commands, &command);
+	g_mutex_unlock (&worker->mutex);
+
+	_worker_signal (worker);
+
+	g_mutex_lock (&worker->mutex);
+	while (!command.done)
+		g_cond_wait (&worker->cond, &worker->mutex);
+	g_mutex_unlock (&worker->mutex);
+
+	g_mutex_lock (&arv_gv_receiver_mutex);
+	worker->n_clients--;
+	g_mutex_unlock (&arv_gv_receiver_mutex);
+
+	client->worker = NULL;
+}
+
+void
+arv_gv_receiver_shutdown (void)
+{
+	g_mutex_lock (&arv_gv_receiver_mutex);
+
+	if (_has_clients ())
+		arv_warning_stream ("[GvReceiver::shutdown] Shared receiver still in use");
+	else
+		_free_workers ();
+
+	g_clear_pointer (&arv_gv_receiver_cpus, g_free);
+
+	g_mutex_unlock (&arv_gv_receiver_mutex);
+}
+
+#else /* ARAVIS_HAS_EPOLL */
+
+void
+arv_gv_receiver_configure (guint n_threads, const gint *cpus)
+{
+	arv_warning_stream ("[GvReceiver::configure] Shared receiver not available on this platform");
+}
+
+gboolean
+arv_gv_receiver_add (ArvGvReceiverClient *client)
+{
+	return FALSE;
+}
+
+void
+arv_gv_receiver_remove (ArvGvReceiverClient *client)
+{
+}
+
+void
+arv_gv_receiver_shutdown (void)
+{
+}
+
+#endif /* ARAVIS_HAS_EPOLL */
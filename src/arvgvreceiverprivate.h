@@ -0,0 +1,66 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2019 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel@gnome.org>
+ */
+
+#ifndef ARV_GV_RECEIVER_PRIVATE_H
+#define ARV_GV_RECEIVER_PRIVATE_H
+
+#if !defined (ARV_H_INSIDE) && !defined (ARAVIS_COMPILATION)
+#error "Only <arv.h> can be included directly."
+#endif
+
+#include <arvtypes.h>
+
+G_BEGIN_DECLS
+
+typedef struct _ArvGvReceiverWorker ArvGvReceiverWorker;
+
+/* A socket serviced by one of the shared receiver worker threads. All the
+ * callbacks are called from the worker thread. */
+
+typedef struct {
+	int fd;
+
+	/* Called once, when the socket is attached to a worker */
+	void 	(*start) 		(void *data);
+	/* Called when the socket is readable, the socket is non blocking */
+	void 	(*receive) 		(void *data, guint64 time_us);
+	/* Called after each worker wakeup, for timeout handling */
+	void 	(*check) 		(void *data, guint64 time_us);
+	/* Maximum time the worker may sleep for this socket */
+	int 	(*get_timeout_ms) 	(void *data);
+	/* Called once, when the socket is detached from the worker */
+	void 	(*stop) 		(void *data);
+
+	void *data;
+
+	/*< private >*/
+	ArvGvReceiverWorker *worker;
+} ArvGvReceiverClient;
+
+void		arv_gv_receiver_configure	(guint n_threads, const gint *cpus);
+gboolean	arv_gv_receiver_add		(ArvGvReceiverClient *client);
+void		arv_gv_receiver_remove		(ArvGvReceiverClient *client);
+void		arv_gv_receiver_shutdown	(void);
+
+G_END_DECLS
+
+#endif
@@ -129,6 +129,136 @@ arv_gvsp_packet_new_data_block (guint16 frame_id, guint32 packet_id,
 	return packet;
 }
 
+/* The image leader fields, with the 2 padding fields, and the image trailer fields, before the payload data */
+
+ArvGvspPacket *
+arv_gvsp_packet_new_all_in (guint16 frame_id, guint32 packet_id,
+			    guint64 timestamp, ArvPixelFormat pixel_format,
+			    guint32 width, guint32 height,
+			    guint32 x_offset, guint32 y_offset,
+			    size_t size, void *data,
+			    void *buffer, size_t *buffer_size)
+{
+	ArvGvspPacket *packet;
+
+	packet = arv_gvsp_packet_new (ARV_GVSP_CONTENT_TYPE_ALL_IN,
+				      frame_id, packet_id, ARV_GVSP_ALL_IN_IMAGE_HEADER_SIZE + size, buffer, buffer_size);
+
+	if (packet != NULL) {
+		ArvGvspDataLeader *leader;
+		ArvGvspDataTrailer *trailer;
+		guint8 *header;
+
+		header = arv_gvsp_packet_get_data (packet);
+		memset (header, 0, ARV_GVSP_ALL_IN_IMAGE_HEADER_SIZE);
+
+		leader = (ArvGvspDataLeader *) header;
+		leader->payload_type = g_htons (ARV_GVSP_PAYLOAD_TYPE_IMAGE);
+		leader->timestamp_high = g_htonl (((guint64) timestamp >> 32));
+		leader->timestamp_low  = g_htonl ((guint64) timestamp & 0xffffffff);
+		leader->pixel_format = g_htonl (pixel_format);
+		leader->width = g_htonl (width);
+		leader->height = g_htonl (height);
+		leader->x_offset = g_htonl (x_offset);
+		leader->y_offset = g_htonl (y_offset);
+
+		trailer = (ArvGvspDataTrailer *) (header + sizeof (ArvGvspDataLeader) + 2 * sizeof (guint16));
+		trailer->payload_type = g_htonl (ARV_GVSP_PAYLOAD_TYPE_IMAGE);
+
+		memcpy (header + ARV_GVSP_ALL_IN_IMAGE_HEADER_SIZE, data, size);
+	}
+
+	return packet;
+}
+
+/* The part descriptions are zeroed, and are set using arv_gvsp_packet_set_part_infos () */
+
+ArvGvspPacket *
+arv_gvsp_packet_new_multipart_leader (guint16 frame_id, guint32 packet_id,
+				      guint64 timestamp, guint n_parts,
+				      void *buffer, size_t *buffer_size)
+{
+	ArvGvspPacket *packet;
+
+	packet = arv_gvsp_packet_new (ARV_GVSP_CONTENT_TYPE_DATA_LEADER,
+				      frame_id, packet_id,
+				      sizeof (ArvGvspMultipartLeader) + n_parts * sizeof (ArvGvspPartInfos),
+				      buffer, buffer_size);
+
+	if (packet != NULL) {
+		ArvGvspMultipartLeader *leader;
+
+		leader = arv_gvsp_packet_get_data (packet);
+		memset (leader, 0, sizeof (ArvGvspMultipartLeader) + n_parts * sizeof (ArvGvspPartInfos));
+		leader->payload_type = g_htons (ARV_GVSP_PAYLOAD_TYPE_MULTIPART);
+		leader->timestamp_high = g_htonl (((guint64) timestamp >> 32));
+		leader->timestamp_low  = g_htonl ((guint64) timestamp & 0xffffffff);
+	}
+
+	return packet;
+}
+
+void
+arv_gvsp_packet_set_part_infos (ArvGvspPacket *packet, guint part_id,
+				ArvBufferPartDataType data_type, ArvPixelFormat pixel_format, guint64 size,
+				guint32 width, guint32 height,
+				guint32 x_offset, guint32 y_offset)
+{
+	ArvGvspMultipartLeader *leader;
+	ArvGvspPartInfos *infos;
+
+	leader = arv_gvsp_packet_get_data (packet);
+	infos = &leader->parts[part_id];
+	infos->data_type = g_htons (data_type);
+	infos->part_length_high = g_htons ((size >> 32) & 0xffff);
+	infos->part_length_low = g_htonl (size & 0xffffffff);
+	infos->pixel_format = g_htonl (pixel_format);
+	infos->width = g_htonl (width);
+	infos->height = g_htonl (height);
+	infos->x_offset = g_htonl (x_offset);
+	infos->y_offset = g_htonl (y_offset);
+}
+
+ArvGvspPacket *
+arv_gvsp_packet_new_multipart_block (guint16 frame_id, guint32 packet_id,
+				     guint part_id, guint64 offset,
+				     size_t size, void *data,
+				     void *buffer, size_t *buffer_size)
+{
+	ArvGvspPacket *packet;
+
+	packet = arv_gvsp_packet_new (ARV_GVSP_CONTENT_TYPE_MULTIPART,
+				      frame_id, packet_id, sizeof (ArvGvspMultipart) + size, buffer, buffer_size);
+
+	if (packet != NULL) {
+		ArvGvspMultipart *multipart;
+
+		multipart = arv_gvsp_packet_get_data (packet);
+		multipart->part_id = part_id;
+		multipart->zone_info = 0;
+		multipart->offset_high = g_htons ((offset >> 32) & 0xffff);
+		multipart->offset_low = g_htonl (offset & 0xffffffff);
+		memcpy (multipart->data, data, size);
+	}
+
+	return packet;
+}
+
+ArvGvspPacket *
+arv_gvsp_packet_new_error (guint16 frame_id, guint32 packet_id, ArvGvspPacketType packet_type,
+			   void *buffer, size_t *buffer_size)
+{
+	ArvGvspPacket *packet;
+
+	packet = arv_gvsp_packet_new (ARV_GVSP_CONTENT_TYPE_DATA_BLOCK,
+				      frame_id, packet_id, 0, buffer, buffer_size);
+
+	if (packet != NULL)
+		packet->packet_type = g_htons (packet_type);
+
+	return packet;
+}
+
 static const char *
 arv_enum_to_string (GType type,
 		    guint enum_value)
@@ -201,11 +331,31 @@ arv_gvsp_packet_to_string (const ArvGvspPacket *packet, size_t packet_size)
 				case ARV_GVSP_PAYLOAD_TYPE_IMAGE_EXTENDED_CHUNK:
 					g_string_append (string, "payload_type = image extended chunk\n");
 					break;
+				case ARV_GVSP_PAYLOAD_TYPE_MULTIPART:
+					g_string_append (string, "payload_type = multipart\n");
+					break;
 				default:
 					g_string_append_printf (string, "payload_type = unknown (0x%08x)\n",
 								g_ntohs (leader->payload_type));
 					break;
 			}
+			if (g_ntohs (leader->payload_type) == ARV_GVSP_PAYLOAD_TYPE_MULTIPART) {
+				guint n_parts = arv_gvsp_packet_get_n_parts (packet, packet_size);
+				guint i;
+
+				g_string_append_printf (string, "n_parts      = %d\n", n_parts);
+				for (i = 0; i < n_parts; i++) {
+					const ArvGvspPartInfos *infos = arv_gvsp_packet_get_part_infos (packet, i);
+
+					g_string_append_printf (string, "part %-7d = type 0x%04x, %s, %dx%d, %" G_GUINT64_FORMAT
+								" bytes\n", i,
+								g_ntohs (infos->data_type),
+								arv_pixel_format_to_gst_caps_string (g_ntohl (infos->pixel_format)),
+								g_ntohl (infos->width), g_ntohl (infos->height),
+								arv_gvsp_part_infos_get_size (infos));
+				}
+				break;
+			}
 			g_string_append_printf (string, "pixel format = %s\n",
 						arv_pixel_format_to_gst_caps_string (g_ntohl (leader->pixel_format)));
 			g_string_append_printf (string, "width        = %d\n", g_ntohl (leader->width));
@@ -219,6 +369,12 @@ arv_gvsp_packet_to_string (const ArvGvspPacket *packet, size_t packet_size)
 			break;
 		case ARV_GVSP_CONTENT_TYPE_ALL_IN:
 			break;
+		case ARV_GVSP_CONTENT_TYPE_MULTIPART:
+			g_string_append_printf (string, "part_id      = %8u\n",
+						arv_gvsp_packet_get_multipart_part_id (packet));
+			g_string_append_printf (string, "offset       = %8" G_GUINT64_FORMAT "\n",
+						arv_gvsp_packet_get_multipart_offset (packet));
+			break;
 	}
 
 	c_string = string->str;
@@ -229,7 +385,7 @@ arv_gvsp_packet_to_string (const ArvGvspPacket *packet, size_t packet_size)
 }
 
 void
-arv_gvsp_packet_debug (const ArvGvspPacket *packet, size_t packet_size, ArvDebugLevel level)
+arv_gvsp_packet_print (const ArvGvspPacket *packet, size_t packet_size, ArvDebugLevel level)
 {
 	char *string;
 
@@ -52,13 +52,16 @@ typedef enum {
  * @ARV_GVSP_CONTENT_TYPE_DATA_LEADER: leader packet
  * @ARV_GVSP_CONTENT_TYPE_DATA_TRAILER: trailer packet
  * @ARV_GVSP_CONTENT_TYPE_DATA_BLOCK: data packet
+ * @ARV_GVSP_CONTENT_TYPE_ALL_IN: leader, data and trailer in a single packet
+ * @ARV_GVSP_CONTENT_TYPE_MULTIPART: data packet of a multipart payload, prefixed with a #ArvGvspMultipart header
  */
 
 typedef enum {
 	ARV_GVSP_CONTENT_TYPE_DATA_LEADER = 	0x01,
 	ARV_GVSP_CONTENT_TYPE_DATA_TRAILER = 	0x02,
 	ARV_GVSP_CONTENT_TYPE_DATA_BLOCK =	0x03,
-	ARV_GVSP_CONTENT_TYPE_ALL_IN =		0x04
+	ARV_GVSP_CONTENT_TYPE_ALL_IN =		0x04,
+	ARV_GVSP_CONTENT_TYPE_MULTIPART =	0x05
 } ArvGvspContentType;
 
 /**
@@ -72,6 +75,8 @@ typedef enum {
  * @ARV_GVSP_PAYLOAD_TYPE_JPEG2000: JPEG2000 data
  * @ARV_GVSP_PAYLOAD_TYPE_H264: h264 data
  * @ARV_GVSP_PAYLOAD_TYPE_MULTIZONE_IMAGE: multizone image
+ * @ARV_GVSP_PAYLOAD_TYPE_MULTIPART: multipart data
+ * @ARV_GVSP_PAYLOAD_TYPE_IMAGE_EXTENDED_CHUNK: image and chunk data
 */
 
 typedef enum {
@@ -84,6 +89,7 @@ typedef enum {
 	ARV_GVSP_PAYLOAD_TYPE_JPEG2000 = 		0x0007,
 	ARV_GVSP_PAYLOAD_TYPE_H264 = 			0x0008,
 	ARV_GVSP_PAYLOAD_TYPE_MULTIZONE_IMAGE = 	0x0009,
+	ARV_GVSP_PAYLOAD_TYPE_MULTIPART = 		0x000a,
 	ARV_GVSP_PAYLOAD_TYPE_IMAGE_EXTENDED_CHUNK = 	0x4001,
 
 } ArvGvspPayloadType;
@@ -140,6 +146,88 @@ typedef struct {
 	guint32	y_offset;
 } ArvGvspDataLeader;
 
+/**
+ * ArvGvspPartInfos:
+ * @data_type: a #ArvBufferPartDataType identifier
+ * @part_length_high: most significant bits of the part size
+ * @part_length_low: least significant bits of the part size
+ * @pixel_format: a #ArvPixelFormat identifier
+ * @reserved: unused
+ * @source_id: identifier of the source of the part
+ * @additional_zones: number of additional zones
+ * @zone_directions: zone transmission directions
+ * @data_purpose_id: purpose of the part data
+ * @region_id: identifier of the region of the part
+ * @width: part width, in pixels
+ * @height: part height, in pixels
+ * @x_offset: part x offset, in pixels
+ * @y_offset: part y offset, in pixels
+ * @x_padding: horizontal padding, in bytes
+ * @reserved2: unused
+ * @type_specific: unused
+ *
+ * GVSP multipart leader description of a part, following the leader timestamp.
+ */
+
+typedef struct {
+	guint16 data_type;
+	guint16 part_length_high;
+	guint32 part_length_low;
+	guint32 pixel_format;
+	guint8 reserved;
+	guint8 source_id;
+	guint8 additional_zones;
+	guint8 reserved1;
+	guint32 zone_directions;
+	guint16 data_purpose_id;
+	guint16 region_id;
+	guint32 width;
+	guint32 height;
+	guint32 x_offset;
+	guint32 y_offset;
+	guint16 x_padding;
+	guint16 reserved2;
+	guint32 type_specific;
+} ArvGvspPartInfos;
+
+/**
+ * ArvGvspMultipartLeader:
+ * @flags: generic flags
+ * @payload_type: ID of the payload type
+ * @timestamp_high: most significant bits of frame timestamp
+ * @timestamp_low: least significant bits of frame timestamp_low
+ * @parts: part descriptions
+ *
+ * GVSP multipart data leader packet data area.
+ */
+
+typedef struct {
+	guint16 flags;
+	guint16 payload_type;
+	guint32 timestamp_high;
+	guint32 timestamp_low;
+	ArvGvspPartInfos parts[];
+} ArvGvspMultipartLeader;
+
+/**
+ * ArvGvspMultipart:
+ * @part_id: index of the part in the leader part list
+ * @zone_info: zone identifier and direction
+ * @offset_high: most significant bits of the data offset in the part
+ * @offset_low: least significant bits of the data offset in the part
+ * @data: part data
+ *
+ * GVSP multipart data packet data area.
+ */
+
+typedef struct {
+	guint8 part_id;
+	guint8 zone_info;
+	guint16 offset_high;
+	guint32 offset_low;
+	guint8 data[];
+} ArvGvspMultipart;
+
 /**
  * ArvGvspDataTrailer:
  * @payload_type: ID of the payload type
@@ -154,6 +242,10 @@ typedef struct {
 } ArvGvspDataTrailer;
 
 
+/* All-in packets carry the image leader fields, including the 2 padding fields missing from ArvGvspDataLeader, and
+ * the image trailer fields, before the payload data */
+#define ARV_GVSP_ALL_IN_IMAGE_HEADER_SIZE	(sizeof (ArvGvspDataLeader) + 2 * sizeof (guint16) + sizeof (ArvGvspDataTrailer))
+
 /**
  * ArvGvspPacket:
  * @packet_type: packet type, also known as status in wireshark dissector
@@ -184,9 +276,36 @@ ArvGvspPacket *		arv_gvsp_packet_new_data_trailer	(guint16 frame_id, guint32 pac
 ArvGvspPacket *		arv_gvsp_packet_new_data_block		(guint16 frame_id, guint32 packet_id,
 								 size_t size, void *data,
 								 void *buffer, size_t *buffer_size);
+ArvGvspPacket *		arv_gvsp_packet_new_all_in		(guint16 frame_id, guint32 packet_id,
+								 guint64 timestamp, ArvPixelFormat pixel_format,
+								 guint32 width, guint32 height,
+								 guint32 x_offset, guint32 y_offset,
+								 size_t size, void *data,
+								 void *buffer, size_t *buffer_size);
+ArvGvspPacket *		arv_gvsp_packet_new_multipart_leader	(guint16 frame_id, guint32 packet_id,
+								 guint64 timestamp, guint n_parts,
+								 void *buffer, size_t *buffer_size);
+void			arv_gvsp_packet_set_part_infos		(ArvGvspPacket *packet, guint part_id,
+								 ArvBufferPartDataType data_type,
+								 ArvPixelFormat pixel_format, guint64 size,
+								 guint32 width, guint32 height,
+								 guint32 x_offset, guint32 y_offset);
+ArvGvspPacket *		arv_gvsp_packet_new_multipart_block	(guint16 frame_id, guint32 packet_id,
+								 guint part_id, guint64 offset,
+								 size_t size, void *data,
+								 void *buffer, size_t *buffer_size);
+ArvGvspPacket *		arv_gvsp_packet_new_error		(guint16 frame_id, guint32 packet_id,
+								 ArvGvspPacketType packet_type,
+								 void *buffer, size_t *buffer_size);
 char * 			arv_gvsp_packet_to_string 		(const ArvGvspPacket *packet, size_t packet_size);
-void 			arv_gvsp_packet_debug 			(const ArvGvspPacket *packet, size_t packet_size,
+void 			arv_gvsp_packet_print 			(const ArvGvspPacket *packet, size_t packet_size,
 								 ArvDebugLevel level);
+
+#define arv_gvsp_packet_debug(packet,packet_size,level)					\
+	G_STMT_START {									\
+		if (arv_debug_is_enabled (ARV_DEBUG_CATEGORY_SP, level))		\
+			arv_gvsp_packet_print (packet, packet_size, level);		\
+	} G_STMT_END
 static inline ArvGvspPacketType
 arv_gvsp_packet_get_packet_type (const ArvGvspPacket *packet)
 {
@@ -292,6 +411,8 @@ arv_gvsp_packet_get_buffer_payload_type (const ArvGvspPacket *packet)
 			return ARV_BUFFER_PAYLOAD_TYPE_H264;
 		case ARV_GVSP_PAYLOAD_TYPE_MULTIZONE_IMAGE:
 			return ARV_BUFFER_PAYLOAD_TYPE_MULTIZONE_IMAGE;
+		case ARV_GVSP_PAYLOAD_TYPE_MULTIPART:
+			return ARV_BUFFER_PAYLOAD_TYPE_MULTIPART;
 		case ARV_GVSP_PAYLOAD_TYPE_IMAGE_EXTENDED_CHUNK:
 			return ARV_BUFFER_PAYLOAD_TYPE_IMAGE_EXTENDED_CHUNK;
 	}
@@ -376,6 +497,50 @@ arv_gvsp_packet_get_data_size (const ArvGvspPacket *packet, size_t packet_size)
 		return packet_size - sizeof (ArvGvspPacket) - sizeof (ArvGvspHeader);
 }
 
+static inline guint
+arv_gvsp_packet_get_n_parts (const ArvGvspPacket *packet, size_t packet_size)
+{
+	size_t data_size = arv_gvsp_packet_get_data_size (packet, packet_size);
+
+	if (data_size < sizeof (ArvGvspMultipartLeader))
+		return 0;
+
+	return (data_size - sizeof (ArvGvspMultipartLeader)) / sizeof (ArvGvspPartInfos);
+}
+
+static inline const ArvGvspPartInfos *
+arv_gvsp_packet_get_part_infos (const ArvGvspPacket *packet, guint part_id)
+{
+	ArvGvspMultipartLeader *leader;
+
+	leader = arv_gvsp_packet_get_data (packet);
+	return &leader->parts[part_id];
+}
+
+static inline guint64
+arv_gvsp_part_infos_get_size (const ArvGvspPartInfos *infos)
+{
+	return ((guint64) g_ntohs (infos->part_length_high) << 32) | g_ntohl (infos->part_length_low);
+}
+
+static inline guint
+arv_gvsp_packet_get_multipart_part_id (const ArvGvspPacket *packet)
+{
+	ArvGvspMultipart *multipart;
+
+	multipart = arv_gvsp_packet_get_data (packet);
+	return multipart->part_id;
+}
+
+static inline guint64
+arv_gvsp_packet_get_multipart_offset (const ArvGvspPacket *packet)
+{
+	ArvGvspMultipart *multipart;
+
+	multipart = arv_gvsp_packet_get_data (packet);
+	return ((guint64) g_ntohs (multipart->offset_high) << 32) | g_ntohl (multipart->offset_low);
+}
+
 G_END_DECLS
 
 #endif
@@ -0,0 +1,708 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2019 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel@gnome.org>
+ */
+
+
+/**
+ * SECTION: arvgvspsender
+ * @short_description: GigE Vision stream transmitter
+ *
+ * #ArvGvspSender packetizes #ArvBuffer images into a GigE Vision stream, for example for the re-publication of
+ * processed frames to downstream GigE Vision receivers. The data block vectors point to the buffer data, the payload is
+ * never copied. The packets are sent in batches of datagrams, and with UDP generic segmentation offload when
+ * available, the consecutive data blocks are segmented by the kernel. A packet delay spaces the batches, in order to
+ * respect the delay on average.
+ *
+ * The last sent buffers are retained, for the servicing of the packet resend requests by
+ * arv_gvsp_sender_resend_packets(), typically called by the GVCP server of the application on packet resend commands.
+ * The frame ids are 16 bit wide, as in the GigE Vision 1.x standard stream protocol.
+ *
+ * |[<!-- language="C" -->
+ * sender = arv_gvsp_sender_new (interface_address, 0, &error);
+ * arv_gvsp_sender_set_destination (sender, receiver_address);
+ * arv_gvsp_sender_set_packet_size (sender, 8000);
+ * arv_gvsp_sender_set_history_length (sender, 4);
+ * arv_gvsp_sender_send_buffer (sender, buffer, &error);
+ * ]|
+ */
+
+#include <arvgvspsenderprivate.h>
+#include <arvbufferprivate.h>
+#include <arvgvspprivate.h>
+#include <arvdebugprivate.h>
+#include <arvfeatures.h>
+#include <string.h>
+#if ARAVIS_HAS_UDP_GSO
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#include <sys/socket.h>
+#endif
+
+#define ARV_GVSP_SENDER_BATCH_SIZE		64
+#define ARV_GVSP_SENDER_HEADER_SLOT_SIZE	64
+#define ARV_GVSP_SENDER_PACING_QUANTUM_NS	50000
+#define ARV_GVSP_SENDER_GSO_SEGMENTS_MAX	64
+#define ARV_GVSP_SENDER_GSO_SIZE_MAX		65000
+#define ARV_GVSP_SENDER_PACKET_SIZE_DEFAULT	1500
+#define ARV_GVSP_SENDER_HISTORY_LENGTH_MAX	64
+
+/* Frame kept for the servicing of packet resend requests */
+
+typedef struct {
+	ArvBuffer *buffer;
+	guint32 packet_size;
+} ArvGvspSenderRetainedFrame;
+
+struct _ArvGvspSender {
+	GObject object;
+
+	GMutex mutex;
+
+	GSocket *socket;
+	GSocketAddress *destination;
+
+	guint32 packet_size;
+	guint64 packet_delay_ns;
+	gboolean udp_gso;
+	gboolean gso_available;
+
+	GRand *rand;
+	double lost_packet_ratio;
+
+	/* Packets of the last rendered frame. The data block headers are only built again on a payload or packet size
+	 * change, only their frame id is updated. The data block vectors point to the buffer data. */
+	size_t payload;
+	guint32 rendered_packet_size;
+	size_t block_size;
+	guint n_packets;
+	guint8 *headers;
+	GOutputVector *vectors;
+	GOutputMessage *messages;
+
+	ArvGvspSenderRetainedFrame history[ARV_GVSP_SENDER_HISTORY_LENGTH_MAX];
+	guint history_length;
+	guint history_index;
+
+	guint64 n_sent_packets;
+	guint64 n_resent_packets;
+};
+
+G_DEFINE_TYPE (ArvGvspSender, arv_gvsp_sender, G_TYPE_OBJECT)
+
+static void
+_clear_frame (ArvGvspSender *sender)
+{
+	g_clear_pointer (&sender->headers, g_free);
+	g_clear_pointer (&sender->vectors, g_free);
+	g_clear_pointer (&sender->messages, g_free);
+	sender->n_packets = 0;
+	sender->payload = 0;
+	sender->rendered_packet_size = 0;
+}
+
+static void
+_render_frame (ArvGvspSender *sender, ArvBuffer *buffer, guint32 packet_size)
+{
+	size_t payload = MIN (buffer->priv->received_size, buffer->priv->size);
+	size_t header_size;
+	guint n_blocks;
+	guint i;
+
+	if (sender->headers == NULL ||
+	    sender->payload != payload ||
+	    sender->rendered_packet_size != packet_size) {
+		_clear_frame (sender);
+
+		sender->payload = payload;
+		sender->rendered_packet_size = packet_size;
+		sender->block_size = packet_size - ARV_GVSP_PACKET_PROTOCOL_OVERHEAD;
+
+		n_blocks = (payload + sender->block_size - 1) / sender->block_size;
+		sender->n_packets = n_blocks + 2;
+
+		sender->headers = g_malloc0 (sender->n_packets * ARV_GVSP_SENDER_HEADER_SLOT_SIZE);
+		sender->vectors = g_new0 (GOutputVector, 2 * sender->n_packets);
+		sender->messages = g_new0 (GOutputMessage, ARV_GVSP_SENDER_BATCH_SIZE);
+
+		for (i = 1; i <= n_blocks; i++) {
+			guint8 *header = sender->headers + i * ARV_GVSP_SENDER_HEADER_SLOT_SIZE;
+
+			header_size = ARV_GVSP_SENDER_HEADER_SLOT_SIZE;
+			arv_gvsp_packet_new_data_block (0, i, 0, header, header, &header_size);
+
+			sender->vectors[2 * i].buffer = header;
+			sender->vectors[2 * i].size = header_size;
+			sender->vectors[2 * i + 1].size = MIN (sender->block_size, payload - (i - 1) * sender->block_size);
+		}
+
+		arv_debug_stream ("[GvspSender::render_frame] %u packets of %u bytes", sender->n_packets, packet_size);
+	}
+
+	header_size = ARV_GVSP_SENDER_HEADER_SLOT_SIZE;
+	arv_gvsp_packet_new_data_leader (buffer->priv->frame_id, 0,
+					 buffer->priv->timestamp_ns,
+					 buffer->priv->pixel_format,
+					 buffer->priv->width, buffer->priv->height,
+					 buffer->priv->x_offset, buffer->priv->y_offset,
+					 sender->headers, &header_size);
+	sender->vectors[0].buffer = sender->headers;
+	sender->vectors[0].size = header_size;
+
+	for (i = 1; i < sender->n_packets - 1; i++) {
+		ArvGvspPacket *packet = (ArvGvspPacket *) (sender->headers + i * ARV_GVSP_SENDER_HEADER_SLOT_SIZE);
+		ArvGvspHeader *header = (ArvGvspHeader *) &packet->header;
+
+		header->frame_id = g_htons (buffer->priv->frame_id);
+		sender->vectors[2 * i + 1].buffer = buffer->priv->data + (i - 1) * sender->block_size;
+	}
+
+	header_size = ARV_GVSP_SENDER_HEADER_SLOT_SIZE;
+	arv_gvsp_packet_new_data_trailer (buffer->priv->frame_id, sender->n_packets - 1,
+					  sender->headers + (sender->n_packets - 1) * ARV_GVSP_SENDER_HEADER_SLOT_SIZE,
+					  &header_size);
+	sender->vectors[2 * (sender->n_packets - 1)].buffer =
+		sender->headers + (sender->n_packets - 1) * ARV_GVSP_SENDER_HEADER_SLOT_SIZE;
+	sender->vectors[2 * (sender->n_packets - 1)].size = header_size;
+}
+
+/* The segment size is set for each sending, as the socket may be shared by several senders */
+
+static gboolean
+_set_gso_size (ArvGvspSender *sender, int gso_size)
+{
+#if ARAVIS_HAS_UDP_GSO
+	return setsockopt (g_socket_get_fd (sender->socket), SOL_UDP, UDP_SEGMENT, &gso_size, sizeof (gso_size)) == 0;
+#else
+	return gso_size == 0;
+#endif
+}
+
+/* Sends the packets [first, last] of the rendered frame, in batches of messages. Each message contains either a
+ * single packet, or with UDP GSO, a sequence of data blocks of the same size, segmented by the kernel. When a packet
+ * delay is set, the batches are reduced, and spaced in order to respect the delay on average. */
+
+static gboolean
+_send_packets (ArvGvspSender *sender, guint first, guint last, GError **error)
+{
+	GError *local_error = NULL;
+	gint64 start_time_us;
+	guint n_segments_max = 1;
+	guint batch_size = ARV_GVSP_SENDER_BATCH_SIZE;
+	guint n_sent_packets = 0;
+	guint packet_index = first;
+
+	if (sender->packet_delay_ns > 0)
+		batch_size = CLAMP (ARV_GVSP_SENDER_PACING_QUANTUM_NS / sender->packet_delay_ns,
+				    1, ARV_GVSP_SENDER_BATCH_SIZE);
+
+	/* Dropped packets would break the segment sequences */
+	if (sender->udp_gso && sender->gso_available && sender->lost_packet_ratio <= 0.0 && sender->n_packets > 2) {
+		size_t segment_size = sender->vectors[2].size + sender->block_size;
+
+		n_segments_max = MIN (ARV_GVSP_SENDER_GSO_SEGMENTS_MAX, ARV_GVSP_SENDER_GSO_SIZE_MAX / segment_size);
+		if (sender->packet_delay_ns > 0)
+			n_segments_max = MIN (n_segments_max, batch_size);
+		if (n_segments_max > 1 && !_set_gso_size (sender, segment_size)) {
+			arv_warning_stream ("[GvspSender::send_packets] UDP GSO not available");
+			sender->gso_available = FALSE;
+			n_segments_max = 1;
+		}
+	}
+
+	if (n_segments_max <= 1)
+		_set_gso_size (sender, 0);
+
+	start_time_us = g_get_monotonic_time ();
+
+	while (packet_index <= last) {
+		guint n_messages = 0;
+		guint n_batch_packets = 0;
+		gint n_sent;
+
+		while (n_messages < ARV_GVSP_SENDER_BATCH_SIZE &&
+		       n_batch_packets < batch_size &&
+		       packet_index <= last) {
+			guint n_packets = 1;
+
+			/* Data blocks are grouped, leader and trailer are sent alone */
+			if (n_segments_max > 1 && packet_index > 0 && packet_index < sender->n_packets - 1)
+				n_packets = MIN (n_segments_max, MIN (last + 1, sender->n_packets - 1) - packet_index);
+
+			if (n_packets > 1 || sender->lost_packet_ratio <= 0.0 ||
+			    g_rand_double (sender->rand) >= sender->lost_packet_ratio) {
+				GOutputMessage *message = &sender->messages[n_messages++];
+
+				message->address = sender->destination;
+				message->vectors = &sender->vectors[2 * packet_index];
+				message->num_vectors = 2 * n_packets;
+				message->bytes_sent = 0;
+				message->control_messages = NULL;
+				message->num_control_messages = 0;
+			} else
+				arv_info_stream ("[GvspSender::send_packets] Drop GVSP packet %u", packet_index);
+
+			packet_index += n_packets;
+			n_batch_packets += n_packets;
+		}
+
+		n_sent = 0;
+		while (n_sent < (gint) n_messages) {
+			gint count;
+
+			count = g_socket_send_messages (sender->socket, &sender->messages[n_sent], n_messages - n_sent,
+							0, NULL, &local_error);
+			if (count <= 0) {
+				if (local_error == NULL)
+					local_error = g_error_new (G_IO_ERROR, G_IO_ERROR_FAILED, "No packet sent");
+				g_propagate_error (error, local_error);
+				return FALSE;
+			}
+			n_sent += count;
+		}
+
+		n_sent_packets += n_batch_packets;
+		sender->n_sent_packets += n_batch_packets;
+
+		if (sender->packet_delay_ns > 0) {
+			gint64 wait_time_us;
+
+			wait_time_us = start_time_us + (n_sent_packets * sender->packet_delay_ns) / 1000 -
+				g_get_monotonic_time ();
+			if (wait_time_us > 0)
+				g_usleep (wait_time_us);
+		}
+	}
+
+	return TRUE;
+}
+
+static void
+_retain_frame (ArvGvspSender *sender, ArvBuffer *buffer, guint32 packet_size)
+{
+	ArvGvspSenderRetainedFrame *frame;
+
+	if (sender->history_length == 0)
+		return;
+
+	frame = &sender->history[sender->history_index];
+	g_clear_object (&frame->buffer);
+	frame->buffer = g_object_ref (buffer);
+	frame->packet_size = packet_size;
+
+	sender->history_index = (sender->history_index + 1) % sender->history_length;
+}
+
+static void
+_clear_history (ArvGvspSender *sender)
+{
+	unsigned int i;
+
+	for (i = 0; i < ARV_GVSP_SENDER_HISTORY_LENGTH_MAX; i++)
+		g_clear_object (&sender->history[i].buffer);
+	sender->history_index = 0;
+}
+
+/**
+ * arv_gvsp_sender_send_buffer:
+ * @sender: a #ArvGvspSender
+ * @buffer: a #ArvBuffer containing an image
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Sends the received data of @buffer as a GigE Vision frame, using its frame id, timestamp and image informations for
+ * the leader. The packets point to the buffer data, which must not change during the call. If a history is set by
+ * arv_gvsp_sender_set_history_length(), @buffer is referenced until it is evicted by the next frames, and its data
+ * must not change before that, in order to be served to the packet resend requests.
+ *
+ * Returns: %TRUE if all the packets were sent.
+ *
+ * Since: 0.8.11
+ */
+
+gboolean
+arv_gvsp_sender_send_buffer (ArvGvspSender *sender, ArvBuffer *buffer, GError **error)
+{
+	gboolean success;
+
+	g_return_val_if_fail (ARV_IS_GVSP_SENDER (sender), FALSE);
+	g_return_val_if_fail (ARV_IS_BUFFER (buffer), FALSE);
+
+	g_mutex_lock (&sender->mutex);
+
+	if (sender->destination == NULL) {
+		g_set_error (error, G_IO_ERROR, G_IO_ERROR_FAILED, "No stream destination");
+		g_mutex_unlock (&sender->mutex);
+		return FALSE;
+	}
+
+	_render_frame (sender, buffer, sender->packet_size);
+	success = _send_packets (sender, 0, sender->n_packets - 1, error);
+	_retain_frame (sender, buffer, sender->packet_size);
+
+	g_mutex_unlock (&sender->mutex);
+
+	return success;
+}
+
+/**
+ * arv_gvsp_sender_resend_packets:
+ * @sender: a #ArvGvspSender
+ * @frame_id: id of the frame
+ * @first_packet_id: id of the first packet to send again
+ * @last_packet_id: id of the last packet to send again
+ *
+ * Services a packet resend request, from the frame history. When the frame is not in the history anymore, or the
+ * requested range is invalid, a packet unavailable error packet is sent instead.
+ *
+ * Returns: %TRUE if the packets were sent again.
+ *
+ * Since: 0.8.11
+ */
+
+gboolean
+arv_gvsp_sender_resend_packets (ArvGvspSender *sender, guint64 frame_id,
+				guint32 first_packet_id, guint32 last_packet_id)
+{
+	ArvGvspSenderRetainedFrame *frame = NULL;
+	GError *error = NULL;
+	gboolean success = FALSE;
+	unsigned int i;
+
+	g_return_val_if_fail (ARV_IS_GVSP_SENDER (sender), FALSE);
+
+	g_mutex_lock (&sender->mutex);
+
+	if (sender->destination == NULL) {
+		g_mutex_unlock (&sender->mutex);
+		return FALSE;
+	}
+
+	/* Only the 16 low bits of the frame id are transmitted */
+	for (i = 0; i < sender->history_length && frame == NULL; i++) {
+		ArvBuffer *buffer = sender->history[i].buffer;
+
+		if (buffer != NULL && (guint16) buffer->priv->frame_id == (guint16) frame_id)
+			frame = &sender->history[i];
+	}
+
+	if (frame != NULL)
+		_render_frame (sender, frame->buffer, frame->packet_size);
+
+	if (frame != NULL &&
+	    first_packet_id <= last_packet_id &&
+	    last_packet_id < sender->n_packets) {
+		arv_info_stream ("[GvspSender::resend_packets] Resend packets %u to %u of frame %" G_GUINT64_FORMAT,
+				 first_packet_id, last_packet_id, frame_id);
+
+		success = _send_packets (sender, first_packet_id, last_packet_id, &error);
+		if (success)
+			sender->n_resent_packets += last_packet_id - first_packet_id + 1;
+	} else {
+		guint8 packet[ARV_GVSP_SENDER_HEADER_SLOT_SIZE];
+		size_t packet_size = sizeof (packet);
+
+		arv_info_stream ("[GvspSender::resend_packets] Packets %u to %u of frame %" G_GUINT64_FORMAT
+				 " unavailable", first_packet_id, last_packet_id, frame_id);
+
+		arv_gvsp_packet_new_error (frame_id, first_packet_id, ARV_GVSP_PACKET_TYPE_PACKET_UNAVAILABLE,
+					   packet, &packet_size);
+		g_socket_send_to (sender->socket, sender->destination, (char *) packet, packet_size, NULL, &error);
+	}
+
+	if (error != NULL) {
+		arv_info_stream ("[GvspSender::resend_packets] Failed to send packets of frame %" G_GUINT64_FORMAT
+				 ": %s", frame_id, error->message);
+		g_clear_error (&error);
+	}
+
+	g_mutex_unlock (&sender->mutex);
+
+	return success;
+}
+
+/**
+ * arv_gvsp_sender_set_destination:
+ * @sender: a #ArvGvspSender
+ * @address: (allow-none): address of the stream receiver, %NULL to stop sending
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_gvsp_sender_set_destination (ArvGvspSender *sender, GSocketAddress *address)
+{
+	g_return_if_fail (ARV_IS_GVSP_SENDER (sender));
+	g_return_if_fail (address == NULL || G_IS_SOCKET_ADDRESS (address));
+
+	g_mutex_lock (&sender->mutex);
+	if (address != NULL)
+		g_object_ref (address);
+	g_clear_object (&sender->destination);
+	sender->destination = address;
+	g_mutex_unlock (&sender->mutex);
+}
+
+/**
+ * arv_gvsp_sender_set_packet_size:
+ * @sender: a #ArvGvspSender
+ * @packet_size: size of the stream IP packets, including the IP, UDP and GVSP headers
+ *
+ * Sets the stream packet size, as the SCPS register of a GigE Vision device. It must fit in the path MTU to the
+ * receiver.
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_gvsp_sender_set_packet_size (ArvGvspSender *sender, guint packet_size)
+{
+	g_return_if_fail (ARV_IS_GVSP_SENDER (sender));
+	g_return_if_fail (packet_size > ARV_GVSP_PACKET_PROTOCOL_OVERHEAD);
+
+	g_mutex_lock (&sender->mutex);
+	sender->packet_size = MIN (packet_size, ARV_GVSP_SENDER_GSO_SIZE_MAX);
+	g_mutex_unlock (&sender->mutex);
+}
+
+/**
+ * arv_gvsp_sender_get_packet_size:
+ * @sender: a #ArvGvspSender
+ *
+ * Returns: the stream packet size, including the IP, UDP and GVSP headers.
+ *
+ * Since: 0.8.11
+ */
+
+guint
+arv_gvsp_sender_get_packet_size (ArvGvspSender *sender)
+{
+	g_return_val_if_fail (ARV_IS_GVSP_SENDER (sender), 0);
+
+	return sender->packet_size;
+}
+
+/**
+ * arv_gvsp_sender_set_packet_delay:
+ * @sender: a #ArvGvspSender
+ * @delay_ns: average delay between two packets, in nanoseconds, 0 to send as fast as possible
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_gvsp_sender_set_packet_delay (ArvGvspSender *sender, guint64 delay_ns)
+{
+	g_return_if_fail (ARV_IS_GVSP_SENDER (sender));
+
+	g_mutex_lock (&sender->mutex);
+	sender->packet_delay_ns = delay_ns;
+	g_mutex_unlock (&sender->mutex);
+}
+
+/**
+ * arv_gvsp_sender_set_udp_gso:
+ * @sender: a #ArvGvspSender
+ * @enable: %TRUE to let the kernel segment the data blocks
+ *
+ * Enables the UDP generic segmentation offload of the data blocks, if supported by the system (see
+ * %ARAVIS_HAS_UDP_GSO). It is enabled by default.
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_gvsp_sender_set_udp_gso (ArvGvspSender *sender, gboolean enable)
+{
+	g_return_if_fail (ARV_IS_GVSP_SENDER (sender));
+
+	g_mutex_lock (&sender->mutex);
+	sender->udp_gso = enable;
+	g_mutex_unlock (&sender->mutex);
+}
+
+/**
+ * arv_gvsp_sender_set_history_length:
+ * @sender: a #ArvGvspSender
+ * @n_frames: number of sent frames retained for the packet resend requests, 0 to disable
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_gvsp_sender_set_history_length (ArvGvspSender *sender, guint n_frames)
+{
+	g_return_if_fail (ARV_IS_GVSP_SENDER (sender));
+
+	g_mutex_lock (&sender->mutex);
+	_clear_history (sender);
+	sender->history_length = MIN (n_frames, ARV_GVSP_SENDER_HISTORY_LENGTH_MAX);
+	g_mutex_unlock (&sender->mutex);
+}
+
+/**
+ * arv_gvsp_sender_get_local_port:
+ * @sender: a #ArvGvspSender
+ *
+ * Returns: the source port of the stream packets, to be reported by the SCSP register of a simulated device.
+ *
+ * Since: 0.8.11
+ */
+
+guint16
+arv_gvsp_sender_get_local_port (ArvGvspSender *sender)
+{
+	GSocketAddress *address;
+	guint16 port = 0;
+
+	g_return_val_if_fail (ARV_IS_GVSP_SENDER (sender), 0);
+
+	address = g_socket_get_local_address (sender->socket, NULL);
+	if (G_IS_INET_SOCKET_ADDRESS (address))
+		port = g_inet_socket_address_get_port (G_INET_SOCKET_ADDRESS (address));
+	g_clear_object (&address);
+
+	return port;
+}
+
+/**
+ * arv_gvsp_sender_get_statistics:
+ * @sender: a #ArvGvspSender
+ * @n_sent_packets: (out) (optional): number of sent packets, resent ones included
+ * @n_resent_packets: (out) (optional): number of packets sent again on resend requests
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_gvsp_sender_get_statistics (ArvGvspSender *sender, guint64 *n_sent_packets, guint64 *n_resent_packets)
+{
+	g_return_if_fail (ARV_IS_GVSP_SENDER (sender));
+
+	g_mutex_lock (&sender->mutex);
+	if (n_sent_packets != NULL)
+		*n_sent_packets = sender->n_sent_packets;
+	if (n_resent_packets != NULL)
+		*n_resent_packets = sender->n_resent_packets;
+	g_mutex_unlock (&sender->mutex);
+}
+
+void
+arv_gvsp_sender_set_impairments (ArvGvspSender *sender, GRand *rand, double lost_packet_ratio)
+{
+	g_return_if_fail (ARV_IS_GVSP_SENDER (sender));
+
+	g_mutex_lock (&sender->mutex);
+	sender->rand = rand;
+	sender->lost_packet_ratio = rand != NULL ? lost_packet_ratio : 0.0;
+	g_mutex_unlock (&sender->mutex);
+}
+
+ArvGvspSender *
+arv_gvsp_sender_new_for_socket (GSocket *socket)
+{
+	ArvGvspSender *sender;
+
+	g_return_val_if_fail (G_IS_SOCKET (socket), NULL);
+
+	sender = g_object_new (ARV_TYPE_GVSP_SENDER, NULL);
+	sender->socket = g_object_ref (socket);
+
+	return sender;
+}
+
+/**
+ * arv_gvsp_sender_new:
+ * @interface_address: (allow-none): address of the sending network interface, %NULL for any
+ * @port: source port of the stream packets, 0 for any
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Creates a GigE Vision stream sender, with its own UDP socket.
+ *
+ * Returns: (transfer full): a new #ArvGvspSender, %NULL on error.
+ *
+ * Since: 0.8.11
+ */
+
+ArvGvspSender *
+arv_gvsp_sender_new (GInetAddress *interface_address, guint16 port, GError **error)
+{
+	ArvGvspSender *sender;
+	GSocketAddress *address;
+	GInetAddress *any_address = NULL;
+	GSocket *socket;
+	gboolean success;
+
+	g_return_val_if_fail (interface_address == NULL || G_IS_INET_ADDRESS (interface_address), NULL);
+
+	socket = g_socket_new (G_SOCKET_FAMILY_IPV4, G_SOCKET_TYPE_DATAGRAM, G_SOCKET_PROTOCOL_UDP, error);
+	if (socket == NULL)
+		return NULL;
+
+	if (interface_address == NULL)
+		interface_address = any_address = g_inet_address_new_any (G_SOCKET_FAMILY_IPV4);
+
+	address = g_inet_socket_address_new (interface_address, port);
+	success = g_socket_bind (socket, address, FALSE, error);
+	g_object_unref (address);
+	g_clear_object (&any_address);
+
+	if (!success) {
+		g_object_unref (socket);
+		return NULL;
+	}
+
+	sender = arv_gvsp_sender_new_for_socket (socket);
+	g_object_unref (socket);
+
+	return sender;
+}
+
+static void
+arv_gvsp_sender_init (ArvGvspSender *sender)
+{
+	g_mutex_init (&sender->mutex);
+
+	sender->packet_size = ARV_GVSP_SENDER_PACKET_SIZE_DEFAULT;
+	sender->udp_gso = TRUE;
+	sender->gso_available = TRUE;
+}
+
+static void
+arv_gvsp_sender_finalize (GObject *object)
+{
+	ArvGvspSender *sender = ARV_GVSP_SENDER (object);
+
+	_clear_history (sender);
+	_clear_frame (sender);
+	g_clear_object (&sender->destination);
+	g_clear_object (&sender->socket);
+
+	g_mutex_clear (&sender->mutex);
+
+	G_OBJECT_CLASS (arv_gvsp_sender_parent_class)->finalize (object);
+}
+
+static void
+arv_gvsp_sender_class_init (ArvGvspSenderClass *sender_class)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS (sender_class);
+
+	object_class->finalize = arv_gvsp_sender_finalize;
+}
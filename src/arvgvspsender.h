@@ -0,0 +1,60 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2019 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel@gnome.org>
+ */
+
+#ifndef ARV_GVSP_SENDER_H
+#define ARV_GVSP_SENDER_H
+
+#if !defined (ARV_H_INSIDE) && !defined (ARAVIS_COMPILATION)
+#error "Only <arv.h> can be included directly."
+#endif
+
+#include <arvtypes.h>
+#include <arvbuffer.h>
+#include <gio/gio.h>
+
+G_BEGIN_DECLS
+
+#define ARV_TYPE_GVSP_SENDER             (arv_gvsp_sender_get_type ())
+G_DECLARE_FINAL_TYPE (ArvGvspSender, arv_gvsp_sender, ARV, GVSP_SENDER, GObject)
+
+ArvGvspSender *		arv_gvsp_sender_new			(GInetAddress *interface_address, guint16 port,
+								 GError **error);
+
+void			arv_gvsp_sender_set_destination		(ArvGvspSender *sender, GSocketAddress *address);
+void			arv_gvsp_sender_set_packet_size		(ArvGvspSender *sender, guint packet_size);
+guint			arv_gvsp_sender_get_packet_size		(ArvGvspSender *sender);
+void			arv_gvsp_sender_set_packet_delay	(ArvGvspSender *sender, guint64 delay_ns);
+void			arv_gvsp_sender_set_udp_gso		(ArvGvspSender *sender, gboolean enable);
+void			arv_gvsp_sender_set_history_length	(ArvGvspSender *sender, guint n_frames);
+
+gboolean		arv_gvsp_sender_send_buffer		(ArvGvspSender *sender, ArvBuffer *buffer,
+								 GError **error);
+gboolean		arv_gvsp_sender_resend_packets		(ArvGvspSender *sender, guint64 frame_id,
+								 guint32 first_packet_id, guint32 last_packet_id);
+
+guint16			arv_gvsp_sender_get_local_port		(ArvGvspSender *sender);
+void			arv_gvsp_sender_get_statistics		(ArvGvspSender *sender, guint64 *n_sent_packets,
+								 guint64 *n_resent_packets);
+
+G_END_DECLS
+
+#endif
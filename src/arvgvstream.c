@@ -25,6 +25,11 @@
  * @short_description: GigEVision stream
  */
 
+/* For recvmmsg */
+#define _GNU_SOURCE
+
+#define ARV_DEBUG_HOT_PATH
+
 #include <arvgvstreamprivate.h>
 #include <arvgvdeviceprivate.h>
 #include <arvstreamprivate.h>
@@ -32,10 +37,16 @@
 #include <arvfeatures.h>
 #include <arvgvspprivate.h>
 #include <arvgvcpprivate.h>
+#include <arvgvreceiverprivate.h>
+#include <arvclockmodelprivate.h>
+#include <arvpacketrecorderprivate.h>
+#include <arvbufferconvertprivate.h>
+#include <arvchecksumprivate.h>
 #include <arvdebug.h>
 #include <arvmisc.h>
 #include <arvmiscprivate.h>
 #include <arvnetworkprivate.h>
+#include <arvtraceprivate.h>
 #include <arvstr.h>
 #include <arvenumtypes.h>
 #include <string.h>
@@ -53,17 +64,91 @@
 #include <linux/filter.h>
 #include <sys/types.h>
 #include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#if ARAVIS_HAS_XDP
+#include <arvxdpprivate.h>
+#endif
+
+#if ARAVIS_HAS_IO_URING
+#include <liburing.h>
+#endif
+
+#if ARAVIS_HAS_HARDWARE_TIMESTAMPS
+#include <linux/net_tstamp.h>
+#include <linux/sockios.h>
+#include <sys/ioctl.h>
+#include <net/if.h>
+#include <ifaddrs.h>
+#endif
+
+#ifndef G_OS_WIN32
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/resource.h>
+#endif
+
+#ifdef SO_MEMINFO
+#include <linux/sock_diag.h>
 #endif
 
 #define ARV_GV_STREAM_INCOMING_BUFFER_SIZE	65536
+#define ARV_GV_STREAM_BATCH_SIZE		32
 
 #define ARV_GV_STREAM_POLL_TIMEOUT_US			1000000
 #define ARV_GV_STREAM_PACKET_TIMEOUT_US_DEFAULT		40000
 #define ARV_GV_STREAM_FRAME_RETENTION_US_DEFAULT	200000
 #define ARV_GV_STREAM_PACKET_REQUEST_RATIO_DEFAULT	0.25
+/* Lower bound of the adaptive resend timeout */
+#define ARV_GV_STREAM_RESEND_TIMEOUT_US_MIN		1000
 
 #define ARV_GV_STREAM_DISCARD_LATE_FRAME_THRESHOLD	100
 
+/* Low latency mode: busy polling time of the device queue by the socket receives, and maximum number of packets
+ * received before going back to poll */
+#define ARV_GV_STREAM_BUSY_POLL_US			50
+#define ARV_GV_STREAM_LOW_LATENCY_DRAIN_MAX		256
+
+/* Start of the next input buffer prefetched by the stream thread, all its cache lines for the first page, and the
+ * first line of the next pages, for the TLB */
+#define ARV_GV_STREAM_PREFETCH_SIZE			(64 * 1024)
+#define ARV_GV_STREAM_PREFETCH_PAGE_SIZE		4096
+#define ARV_GV_STREAM_PREFETCH_LINE_SIZE		64
+
+/* io_uring method: number of buffers of the provided buffer ring, a power of 2, and size of each buffer, large enough
+ * for the recvmsg header, the control messages and a jumbo frame packet */
+#define ARV_GV_STREAM_IO_URING_N_BUFFERS		512
+#define ARV_GV_STREAM_IO_URING_BUFFER_SIZE		16384
+#define ARV_GV_STREAM_IO_URING_BUFFER_GROUP		0
+
+#define ARV_GV_STREAM_HEALTH_SAMPLING_PERIOD_US		1000000
+
+/* Adaptive socket buffer size bounds, the upper one being used if socket-buffer-size is not set */
+#define ARV_GV_STREAM_ADAPTIVE_SOCKET_BUFFER_MIN	(1 << 20)
+#define ARV_GV_STREAM_ADAPTIVE_SOCKET_BUFFER_MAX	(256 << 20)
+
+/* Missing packet runs separated by at most this number of received packets are requested at once */
+#define ARV_GV_STREAM_RESEND_COALESCE_GAP		8
+
+/* Maximum number of simultaneously open frames, must be a power of two */
+#define ARV_GV_STREAM_N_FRAMES_MAX			64
+
+#define ARV_GV_STREAM_RING_SIZE_MIN			(32 << 20)
+#define ARV_GV_STREAM_RING_SIZE_MAX			(1 << 30)
+#define ARV_GV_STREAM_RING_BLOCK_SIZE_DEFAULT		(1 << 21)
+#define ARV_GV_STREAM_RING_RETIRE_TIMEOUT_MS_DEFAULT	5
+/* Duration of the stream that fits in an automatically sized ring */
+#define ARV_GV_STREAM_RING_AUTO_DURATION_S		0.2
+
+/* Size of the ancillary data buffer of the timestamped receptions */
+#define ARV_GV_STREAM_CONTROL_BUFFER_SIZE		128
+/* Period of the sampling of the offset between the real time and monotonic clocks */
+#define ARV_GV_STREAM_CLOCK_OFFSET_PERIOD_NS		1000000000LL
+
+/* Longest sleep of a replay, for a timely reaction to the stream thread stop */
+#define ARV_GV_STREAM_REPLAY_SLEEP_US_MAX		100000
+
 enum {
 	ARV_GV_STREAM_PROPERTY_0,
 	ARV_GV_STREAM_PROPERTY_SOCKET_BUFFER,
@@ -71,14 +156,37 @@ enum {
 	ARV_GV_STREAM_PROPERTY_PACKET_RESEND,
 	ARV_GV_STREAM_PROPERTY_PACKET_REQUEST_RATIO,
 	ARV_GV_STREAM_PROPERTY_PACKET_TIMEOUT,
-	ARV_GV_STREAM_PROPERTY_FRAME_RETENTION
+	ARV_GV_STREAM_PROPERTY_FRAME_RETENTION,
+	ARV_GV_STREAM_PROPERTY_ADAPTIVE_PACKET_TIMEOUT,
+	ARV_GV_STREAM_PROPERTY_EARLY_COMPLETION,
+	ARV_GV_STREAM_PROPERTY_REORDER_WINDOW,
+	ARV_GV_STREAM_PROPERTY_RING_SIZE,
+	ARV_GV_STREAM_PROPERTY_RING_BLOCK_SIZE,
+	ARV_GV_STREAM_PROPERTY_RING_RETIRE_TIMEOUT,
+	ARV_GV_STREAM_PROPERTY_PACKET_SOCKET_INTERFACES,
+	ARV_GV_STREAM_PROPERTY_XDP_QUEUE,
+	ARV_GV_STREAM_PROPERTY_RECORD_FILENAME,
+	ARV_GV_STREAM_PROPERTY_RECORD_SIZE,
+	ARV_GV_STREAM_PROPERTY_REPLAY_FILENAME,
+	ARV_GV_STREAM_PROPERTY_REPLAY_REALTIME,
+	ARV_GV_STREAM_PROPERTY_UNPACK_PIXEL_FORMAT,
+	ARV_GV_STREAM_PROPERTY_CROP_X,
+	ARV_GV_STREAM_PROPERTY_CROP_Y,
+	ARV_GV_STREAM_PROPERTY_CROP_WIDTH,
+	ARV_GV_STREAM_PROPERTY_CROP_HEIGHT,
+	ARV_GV_STREAM_PROPERTY_DECIMATION_HORIZONTAL,
+	ARV_GV_STREAM_PROPERTY_DECIMATION_VERTICAL,
+	ARV_GV_STREAM_PROPERTY_CHANNEL
 } ArvGvStreamProperties;
 
 typedef struct _ArvGvStreamThreadData ArvGvStreamThreadData;
 
 typedef struct {
 	GThread *thread;
+	gboolean thread_is_shared;
 	ArvGvStreamThreadData *thread_data;
+	/* Set at construction, before the thread data allocation */
+	guint channel;
 } ArvGvStreamPrivate;
 
 struct _ArvGvStream {
@@ -93,12 +201,43 @@ G_DEFINE_TYPE_WITH_CODE (ArvGvStream, arv_gv_stream, ARV_TYPE_STREAM, G_ADD_PRIV
 
 /* Acquisition thread */
 
+/* Range of packets covered by a resend request */
 typedef struct {
-	gboolean received;
+	guint32 first_packet;
+	guint32 last_packet;
 	guint64 time_us;
-} ArvGvStreamPacketData;
+	/* Postponed because of the device resend bandwidth budget */
+	gboolean throttled;
+} ArvGvStreamResendRange;
 
+/* Pixel group split between two consecutive data blocks, unpacked once both parts are received */
 typedef struct {
+	guint8 bytes[8];
+	guint8 mask;
+} ArvGvStreamUnpackSeam;
+
+/* CRC32C of a data block at its final location, combined in the packet order on the frame completion */
+typedef struct {
+	guint32 crc;
+	guint32 size;
+} ArvGvStreamBlockChecksum;
+
+/* Region of the received image copied to the buffer, in source pixels and bytes */
+typedef struct {
+	gboolean enabled;
+	size_t source_size;
+	size_t source_row_size;
+	size_t row_size;
+	guint pixel_size;
+	guint x;
+	guint y;
+	guint width;
+	guint height;
+	guint decimation_x;
+	guint decimation_y;
+} ArvGvStreamCrop;
+
+typedef struct _ArvGvStreamFrameData {
 	ArvBuffer *buffer;
 	guint64 frame_id;
 
@@ -109,18 +248,137 @@ typedef struct {
 	gboolean error_packet_received;
 
 	guint n_packets;
-	ArvGvStreamPacketData *packet_data;
+	/* Received packet bitset, one bit per packet id */
+	guint64 *received_packets;
+	guint n_allocated_words;
+	/* Pending resend requests, ordered by request time, hence by deadline */
+	GArray *resend_ranges;
+	/* Missing packets below this id are all covered by a resend request */
+	guint32 n_checked_packets;
 
 	guint n_packet_resend_requests;
+	/* Per frame resend counts, for the frame log */
+	guint n_requested_packets;
+	guint n_resent_packets;
 	gboolean resend_ratio_reached;
+	gboolean resend_requested;
 
 	gboolean extended_ids;
+
+	/* Packed payload unpacked at its final location during the reassembly, decided on the leader reception */
+	guint n_data_blocks;
+	gboolean unpack;
+	size_t packed_size;
+	/* Indexed by the id of the packet containing the first byte of the split group */
+	ArvGvStreamUnpackSeam *unpack_seams;
+	guint n_allocated_seams;
+
+	/* Software region of interest, decided on the leader reception */
+	ArvGvStreamCrop crop;
+
+	/* Data block checksums indexed by packet id, see ArvStream:checksum */
+	gboolean checksum;
+	ArvGvStreamBlockChecksum *block_checksums;
+	guint n_allocated_checksums;
+	guint n_checksummed_blocks;
+
+	/* Variable size payload, whose packet count is only known once the trailer is received */
+	gboolean is_size_unknown;
+	/* End of the data written in the buffer */
+	size_t received_size;
+
+	/* Next unused frame, when stored in the frame pool */
+	struct _ArvGvStreamFrameData *next;
 } ArvGvStreamFrameData;
 
+#define ARV_GV_STREAM_N_PACKETS_TO_N_WORDS(n_packets)	(((n_packets) + 63) / 64)
+
+static inline guint
+_count_trailing_zeros (guint64 word)
+{
+#if defined(__GNUC__)
+	return __builtin_ctzll (word);
+#else
+	guint n = 0;
+
+	while ((word & 1) == 0) {
+		word >>= 1;
+		n++;
+	}
+
+	return n;
+#endif
+}
+
+static inline gboolean
+_is_packet_received (ArvGvStreamFrameData *frame, guint32 packet_id)
+{
+	return (frame->received_packets[packet_id / 64] >> (packet_id % 64)) & 1;
+}
+
+static inline void
+_set_packet_received (ArvGvStreamFrameData *frame, guint32 packet_id)
+{
+	frame->received_packets[packet_id / 64] |= G_GUINT64_CONSTANT (1) << (packet_id % 64);
+}
+
+static inline void
+_clear_packet_received (ArvGvStreamFrameData *frame, guint32 packet_id)
+{
+	frame->received_packets[packet_id / 64] &= ~(G_GUINT64_CONSTANT (1) << (packet_id % 64));
+}
+
+/* Returns the first packet id in [from, to[ whose received state matches @received, or @to if there is none */
+
+static guint32
+_find_packet (ArvGvStreamFrameData *frame, guint32 from, guint32 to, gboolean received)
+{
+	guint w, n_words;
+
+	if (from >= to)
+		return to;
+
+	n_words = ARV_GV_STREAM_N_PACKETS_TO_N_WORDS (to);
+
+	for (w = from / 64; w < n_words; w++) {
+		guint64 word = received ? frame->received_packets[w] : ~frame->received_packets[w];
+
+		if (w == from / 64)
+			word &= ~G_GUINT64_CONSTANT (0) << (from % 64);
+
+		if (word != 0)
+			return MIN (w * 64 + _count_trailing_zeros (word), to);
+	}
+
+	return to;
+}
+
+/* Returns the time of the last resend request covering @packet_id, or 0 if it was never requested */
+
+static guint64
+_get_resend_time (ArvGvStreamFrameData *frame, guint32 packet_id)
+{
+	guint64 time_us = 0;
+	guint i;
+
+	for (i = 0; i < frame->resend_ranges->len; i++) {
+		ArvGvStreamResendRange *range = &g_array_index (frame->resend_ranges, ArvGvStreamResendRange, i);
+
+		if (!range->throttled && packet_id >= range->first_packet && packet_id <= range->last_packet)
+			time_us = MAX (time_us, range->time_us);
+	}
+
+	return time_us;
+}
+
 struct _ArvGvStreamThreadData {
 	GCancellable *cancellable;
 
 	ArvStream *stream;
+	/* Not referenced, the stream owns a reference to its device */
+	ArvGvDevice *gv_device;
+	/* Owned by the stream */
+	ArvEventRing *event_ring;
 
 	ArvStreamCallback callback;
 	void *callback_data;
@@ -132,22 +390,107 @@ struct _ArvGvStreamThreadData {
 	GSocketAddress *device_socket_address;
 	guint16 source_stream_port;
 	guint16 stream_port;
+	/* Stream channel index, used in the packet resend requests */
+	guint16 channel;
 
 	ArvGvStreamPacketResend packet_resend;
 	double packet_request_ratio;
 	guint packet_timeout_us;
 	guint frame_retention_us;
 
+	/* Close frames as soon as all the data blocks are received, without waiting for the trailer */
+	gboolean early_completion;
+	gboolean early_completion_frame_valid;
+	guint64 early_completion_frame_id;
+
+	/* Frame id order delivery: number of frame ids a frame may arrive late, 0 if disabled */
+	guint reorder_window;
+	gboolean last_closed_frame_valid;
+	guint64 last_closed_frame_id;
+
+	/* Smoothed round trip time of the resend requests, and its variation */
+	gboolean adaptive_packet_timeout;
+	guint64 resend_rtt_us;
+	guint64 resend_rtt_var_us;
+
 	guint64 timestamp_tick_frequency;
 	guint scps_packet_size;
 
+	/* Kernel reception timestamps, in real time, converted to the monotonic time base of the frame timeouts
+	 * with a periodically sampled clock offset */
+	gboolean use_kernel_timestamps;
+	guint64 packet_system_time_ns;
+	/* Network interface hardware reception time of the current packet */
+	gboolean use_hardware_timestamps;
+	guint64 packet_hardware_time_ns;
+	gint64 clock_offset_ns;
+	guint64 clock_offset_time_ns;
+	guint64 last_time_us;
+
+	/* Mapping of the device timestamps to the host monotonic time */
+	ArvClockModel *clock_model;
+	gboolean ptp_locked;
+	double clock_drift_ppm;
+	guint n_clock_resets;
+
+	/* Receive thread health, sampled once per second */
+	gint64 health_sample_time_us;
+	guint64 health_sample_cpu_time_us;
+	double thread_cpu_percent;
+	guint64 socket_buffer_fill;
+	guint64 socket_buffer_capacity;
+	guint64 n_socket_drops;
+	/* Loss counters at the previous adaptive socket buffer check */
+	guint64 adaptive_n_socket_drops;
+	guint adaptive_n_missing_packets;
+
 	guint16 packet_id;
 
-	GSList *frames;
+	/* Open frames, in reception order */
+	ArvGvStreamFrameData *frames[ARV_GV_STREAM_N_FRAMES_MAX];
+	guint first_frame;
+	guint n_frames;
+	/* Open frames, indexed by frame id modulo ARV_GV_STREAM_N_FRAMES_MAX */
+	ArvGvStreamFrameData *frame_table[ARV_GV_STREAM_N_FRAMES_MAX];
+	ArvGvStreamFrameData *last_frame;
+	/* Closed frames, kept for reuse with their packet data array */
+	ArvGvStreamFrameData *frame_pool;
+
 	gboolean first_packet;
 	guint64 last_frame_id;
+	/* Number of pauses of the stream seen by the thread */
+	guint n_pauses;
 
 	gboolean use_packet_socket;
+	gboolean use_batch_receive;
+	gboolean use_zero_copy;
+	gboolean use_shared_receiver;
+	gboolean use_xdp;
+	guint xdp_queue;
+	gboolean use_low_latency;
+	gboolean use_io_uring;
+	gboolean use_prefetch;
+
+	/* Payload copy kernel, refreshed from the stream at the start of each frame, NULL for memcpy */
+	ArvStreamCopyFunc copy_func;
+	void *copy_data;
+	/* Checksum of the received data, refreshed with the copy kernel */
+	gboolean checksum;
+	/* Combination operator of the checksums of the full size data blocks */
+	size_t checksum_block_size;
+	guint32 checksum_block_op;
+
+	/* Input buffer taken for the next frame, see ARV_GV_STREAM_OPTION_PREFETCH_ENABLED */
+	ArvBuffer *prefetched_buffer;
+
+	/* Shared receiver registration, and its packet buffer */
+	ArvGvReceiverClient receiver_client;
+	ArvGvspPacket *receiver_packet;
+
+	/* Zero copy reception: predicted destination of the next data block */
+	ArvGvStreamFrameData *zero_copy_frame;
+	guint32 zero_copy_packet_id;
+	gboolean zero_copy_hit;
 
 	/* Statistics */
 
@@ -157,17 +500,30 @@ struct _ArvGvStreamThreadData {
 	guint n_underruns;
 	guint n_aborteds;
 	guint n_missing_frames;
+	/* Late frames inserted back in frame id order */
+	guint n_reordered_frames;
 
 	guint n_size_mismatch_errors;
 
 	guint n_received_packets;
+	/* Packets received by the low latency mode without going through poll */
+	guint n_drained_packets;
 	guint n_missing_packets;
 	guint n_error_packets;
 	guint n_ignored_packets;
 	guint n_resend_requests;
 	guint n_resent_packets;
 	guint n_resend_ratio_reached;
+	guint n_throttled_resend_requests;
+	guint n_early_completions;
 	guint n_duplicated_packets;
+	guint n_zero_copy_packets;
+	guint n_avoided_allocations;
+	guint n_prefetched_buffers;
+
+	/* Payload bytes memcpy'd from the receive buffers versus received in place */
+	guint64 n_copied_bytes;
+	guint64 n_zero_copy_bytes;
 
 	ArvStatistic *statistic;
 	guint32 statistic_count;
@@ -175,6 +531,40 @@ struct _ArvGvStreamThreadData {
 	ArvGvStreamSocketBuffer socket_buffer_option;
 	int socket_buffer_size;
 	int current_socket_buffer_size;
+	/* Last successfully requested size, reported as a stream info */
+	guint requested_socket_buffer_size;
+
+	/* Packet socket ring geometry, a ring_size of 0 meaning automatic */
+	guint ring_size;
+	guint ring_block_size;
+	guint ring_retire_timeout_ms;
+	guint ring_auto_size;
+	/* Comma separated names of the interfaces a packet socket ring is bound to, NULL for the stream interface */
+	char *packet_socket_interfaces;
+
+	/* Raw packet capture, and replay of a capture instead of the socket reception */
+	char *record_filename;
+	guint64 record_size;
+	ArvPacketRecorder *recorder;
+	char *replay_filename;
+	gboolean replay_realtime;
+
+	/* Pixel format the packed payloads are unpacked to during the reassembly, 0 if disabled */
+	ArvPixelFormat unpack_pixel_format;
+	ArvConvertUnpacker unpacker;
+	guint n_unpacked_frames;
+
+	/* Software region of interest and decimation applied during the reassembly, a zero width or height extends
+	 * the region to the image border */
+	guint crop_x;
+	guint crop_y;
+	guint crop_width;
+	guint crop_height;
+	guint decimation_horizontal;
+	guint decimation_vertical;
+	/* Packet count of the last cropped frame, as the buffer is smaller than the received payload */
+	guint n_crop_packets;
+	guint n_cropped_frames;
 };
 
 static void
@@ -189,33 +579,63 @@ _send_packet_request (ArvGvStreamThreadData *thread_data,
 
 	thread_data->packet_id = arv_gvcp_next_packet_id (thread_data->packet_id);
 
-	packet = arv_gvcp_packet_new_packet_resend_cmd (frame_id, first_block, last_block, extended_ids,
-							thread_data->packet_id, &packet_size);
+	packet = arv_gvcp_packet_new_packet_resend_cmd (thread_data->channel, frame_id, first_block, last_block,
+							extended_ids, thread_data->packet_id, &packet_size);
 
 	arv_debug_stream_thread ("[GvStream::send_packet_request] frame_id = %" G_GUINT64_FORMAT
 			       " (from packet %" G_GUINT32_FORMAT " to %" G_GUINT32_FORMAT ")",
 			       frame_id, first_block, last_block);
+	arv_event_ring_record (thread_data->event_ring, ARV_EVENT_RING_EVENT_RESEND_REQUEST, frame_id, first_block,
+			       last_block - first_block + 1);
 
 	arv_gvcp_packet_debug (packet, ARV_DEBUG_LEVEL_DEBUG);
 
-	g_socket_send_to (thread_data->socket, thread_data->device_socket_address, (const char *) packet, packet_size,
-			  NULL, NULL);
+	/* Replayed packets can't be resent */
+	if (thread_data->replay_filename == NULL)
+		g_socket_send_to (thread_data->socket, thread_data->device_socket_address, (const char *) packet,
+				  packet_size, NULL, NULL);
 
 	arv_gvcp_packet_free (packet);
 }
 
+static void
+_set_socket_buffer_size (ArvGvStreamThreadData *thread_data, int buffer_size)
+{
+	int fd = g_socket_get_fd (thread_data->socket);
+	gboolean result;
+
+	if (thread_data->socket_buffer_option == ARV_GV_STREAM_SOCKET_BUFFER_ADAPTIVE)
+		result = arv_socket_force_recv_buffer_size (fd, buffer_size);
+	else
+		result = arv_socket_set_recv_buffer_size (fd, buffer_size);
+
+	if (result) {
+		thread_data->current_socket_buffer_size = buffer_size;
+		thread_data->requested_socket_buffer_size = buffer_size;
+		arv_info_stream_thread ("[GvStream::update_socket] Socket buffer size set to %d", buffer_size);
+	} else {
+		arv_warning_stream_thread ("[GvStream::update_socket] Failed to set socket buffer size to %d (%d)",
+					   buffer_size, errno);
+	}
+}
+
+static int
+_get_adaptive_socket_buffer_max (ArvGvStreamThreadData *thread_data)
+{
+	return thread_data->socket_buffer_size > 0 ?
+		thread_data->socket_buffer_size :
+		ARV_GV_STREAM_ADAPTIVE_SOCKET_BUFFER_MAX;
+}
+
 static void
 _update_socket (ArvGvStreamThreadData *thread_data, ArvBuffer *buffer)
 {
 	int buffer_size = thread_data->current_socket_buffer_size;
-	int fd;
 
 	if (thread_data->socket_buffer_option == ARV_GV_STREAM_SOCKET_BUFFER_FIXED &&
 	    thread_data->socket_buffer_size <= 0)
 		return;
 
-	fd = g_socket_get_fd (thread_data->socket);
-
 	switch (thread_data->socket_buffer_option) {
 		case ARV_GV_STREAM_SOCKET_BUFFER_FIXED:
 			buffer_size = thread_data->socket_buffer_size;
@@ -226,562 +646,3050 @@ _update_socket (ArvGvStreamThreadData *thread_data, ArvBuffer *buffer)
 			else
 				buffer_size = MIN (buffer->priv->size, thread_data->socket_buffer_size);
 			break;
+		case ARV_GV_STREAM_SOCKET_BUFFER_ADAPTIVE:
+			/* Never shrinks, the size grown after packet losses is kept */
+			buffer_size = MAX (buffer_size,
+					   MIN (MAX (buffer->priv->size, ARV_GV_STREAM_ADAPTIVE_SOCKET_BUFFER_MIN),
+						_get_adaptive_socket_buffer_max (thread_data)));
+			break;
 	}
 
-	if (buffer_size != thread_data->current_socket_buffer_size) {
-		gboolean result;
-
-		result = arv_socket_set_recv_buffer_size (fd, buffer_size);
-		if (result) {
-			thread_data->current_socket_buffer_size = buffer_size;
-			arv_info_stream_thread ("[GvStream::update_socket] Socket buffer size set to %d", buffer_size);
-		} else {
-			arv_warning_stream_thread ("[GvStream::update_socket] Failed to set socket buffer size to %d (%d)",
-						   buffer_size, errno);
-		}
-	}
+	if (buffer_size != thread_data->current_socket_buffer_size)
+		_set_socket_buffer_size (thread_data, buffer_size);
 }
 
+/* Doubles the socket buffer size if packets were lost since the last check, either dropped by the kernel on a full
+ * socket buffer, or reported missing at the frame closing, which also covers the systems without SO_MEMINFO */
+
 static void
-_process_data_leader (ArvGvStreamThreadData *thread_data,
-		      ArvGvStreamFrameData *frame,
-		      const ArvGvspPacket *packet,
-		      guint32 packet_id)
+_adapt_socket_buffer (ArvGvStreamThreadData *thread_data)
 {
-	if (frame->buffer->priv->status != ARV_BUFFER_STATUS_FILLING)
-		return;
+	gboolean lost;
+	int buffer_max;
+	int buffer_size;
 
-	if (packet_id != 0) {
-		frame->buffer->priv->status = ARV_BUFFER_STATUS_WRONG_PACKET_ID;
+	lost = thread_data->n_socket_drops > thread_data->adaptive_n_socket_drops ||
+		thread_data->n_missing_packets > thread_data->adaptive_n_missing_packets;
+
+	thread_data->adaptive_n_socket_drops = thread_data->n_socket_drops;
+	thread_data->adaptive_n_missing_packets = thread_data->n_missing_packets;
+
+	if (!lost ||
+	    thread_data->socket_buffer_option != ARV_GV_STREAM_SOCKET_BUFFER_ADAPTIVE ||
+	    thread_data->socket == NULL)
 		return;
-	}
 
-	frame->buffer->priv->payload_type = arv_gvsp_packet_get_buffer_payload_type (packet);
-	frame->buffer->priv->frame_id = frame->frame_id;
-	frame->buffer->priv->chunk_endianness = G_BIG_ENDIAN;
+	buffer_max = _get_adaptive_socket_buffer_max (thread_data);
+	if (thread_data->current_socket_buffer_size >= buffer_max)
+		return;
 
-	frame->buffer->priv->system_timestamp_ns = g_get_real_time() * 1000LL;
-	if (frame->buffer->priv->payload_type != ARV_BUFFER_PAYLOAD_TYPE_H264) {
-		if (G_LIKELY (thread_data->timestamp_tick_frequency != 0))
-			frame->buffer->priv->timestamp_ns = arv_gvsp_packet_get_timestamp (packet,
-											   thread_data->timestamp_tick_frequency);
-		else {
-			frame->buffer->priv->timestamp_ns = frame->buffer->priv->system_timestamp_ns;
-		}
-	} else
-		frame->buffer->priv->timestamp_ns = frame->buffer->priv->system_timestamp_ns;
+	buffer_size = thread_data->current_socket_buffer_size < ARV_GV_STREAM_ADAPTIVE_SOCKET_BUFFER_MIN ?
+		ARV_GV_STREAM_ADAPTIVE_SOCKET_BUFFER_MIN :
+		(thread_data->current_socket_buffer_size > buffer_max / 2 ?
+		 buffer_max : 2 * thread_data->current_socket_buffer_size);
 
-	if (arv_buffer_payload_type_has_aoi (frame->buffer->priv->payload_type)) {
-		frame->buffer->priv->x_offset = arv_gvsp_packet_get_x_offset (packet);
-		frame->buffer->priv->y_offset = arv_gvsp_packet_get_y_offset (packet);
-		frame->buffer->priv->width = arv_gvsp_packet_get_width (packet);
-		frame->buffer->priv->height = arv_gvsp_packet_get_height (packet);
-		frame->buffer->priv->pixel_format = arv_gvsp_packet_get_pixel_format (packet);
-	}
+	arv_info_stream_thread ("[GvStream::adapt_socket_buffer] Packet losses, grow socket buffer to %d bytes",
+				buffer_size);
 
-	if (frame->packet_data[packet_id].time_us > 0) {
-		thread_data->n_resent_packets++;
-		arv_debug_stream_thread ("[GvStream::process_data_leader] Received resent packet %u for frame %" G_GUINT64_FORMAT,
-				       packet_id, frame->frame_id);
-	}
+	_set_socket_buffer_size (thread_data, buffer_size);
 }
 
-static void
-_process_data_block (ArvGvStreamThreadData *thread_data,
-		     ArvGvStreamFrameData *frame,
-		     const ArvGvspPacket *packet,
-		     guint32 packet_id,
-		     size_t read_count)
+/* Current time for the frame timeouts, kept monotonic as the packets may carry slightly older kernel times */
+
+static guint64
+_get_time_us (ArvGvStreamThreadData *thread_data)
 {
-	size_t block_size;
-	ptrdiff_t block_offset;
-	ptrdiff_t block_end;
-	gboolean extended_ids;
+	thread_data->last_time_us = MAX (thread_data->last_time_us, (guint64) g_get_monotonic_time ());
 
-	if (frame->buffer->priv->status != ARV_BUFFER_STATUS_FILLING)
-		return;
+	return thread_data->last_time_us;
+}
 
-	if (packet_id > frame->n_packets - 2 || packet_id < 1) {
-		arv_gvsp_packet_debug (packet, read_count, ARV_DEBUG_LEVEL_INFO);
-		frame->buffer->priv->status = ARV_BUFFER_STATUS_WRONG_PACKET_ID;
-		return;
-	}
+/* Reception time of a packet, from its kernel reception time in real time nanoseconds, or 0 if not available */
 
-	extended_ids = arv_gvsp_packet_has_extended_ids (packet);
+static guint64
+_get_packet_time_us (ArvGvStreamThreadData *thread_data, guint64 system_time_ns)
+{
+	gint64 elapsed_ns;
 
-	block_size = arv_gvsp_packet_get_data_size (packet, read_count);
-	block_offset = (packet_id - 1) * (thread_data->scps_packet_size - (extended_ids ?
-									   ARV_GVSP_PACKET_EXTENDED_PROTOCOL_OVERHEAD :
-									   ARV_GVSP_PACKET_PROTOCOL_OVERHEAD));
-	block_end = block_size + block_offset;
+	thread_data->packet_system_time_ns = system_time_ns;
 
-	if (block_end > frame->buffer->priv->size) {
-		arv_info_stream_thread ("[GvStream::process_data_block] %" G_GINTPTR_FORMAT " unexpected bytes in packet %u "
-					 " for frame %" G_GUINT64_FORMAT,
-					 block_end - frame->buffer->priv->size,
-					 packet_id, frame->frame_id);
-		thread_data->n_size_mismatch_errors++;
+	if (system_time_ns == 0)
+		return _get_time_us (thread_data);
 
-		block_end = frame->buffer->priv->size;
-		block_size = block_end - block_offset;
+	/* Also resample after a step of the real time clock */
+	elapsed_ns = (gint64) (system_time_ns - thread_data->clock_offset_time_ns);
+	if (elapsed_ns > ARV_GV_STREAM_CLOCK_OFFSET_PERIOD_NS || elapsed_ns < -ARV_GV_STREAM_CLOCK_OFFSET_PERIOD_NS) {
+		thread_data->clock_offset_ns = (g_get_real_time () - g_get_monotonic_time ()) * 1000LL;
+		thread_data->clock_offset_time_ns = system_time_ns;
 	}
 
-	memcpy (((char *) frame->buffer->priv->data) + block_offset, arv_gvsp_packet_get_data (packet), block_size);
+	thread_data->last_time_us = MAX (thread_data->last_time_us,
+					 (system_time_ns - thread_data->clock_offset_ns) / 1000);
 
-	if (frame->packet_data[packet_id].time_us > 0) {
-		thread_data->n_resent_packets++;
-		arv_debug_stream_thread ("[GvStream::process_data_block] Received resent packet %u for frame %" G_GUINT64_FORMAT,
-				       packet_id, frame->frame_id);
-	}
+	return thread_data->last_time_us;
 }
 
+#ifndef G_OS_WIN32
+
 static void
-_process_data_trailer (ArvGvStreamThreadData *thread_data,
-		       ArvGvStreamFrameData *frame,
-		       guint32 packet_id)
+_enable_kernel_timestamps (ArvGvStreamThreadData *thread_data, int fd)
 {
-	if (frame->buffer->priv->status != ARV_BUFFER_STATUS_FILLING)
-		return;
-
-	if (packet_id != frame->n_packets - 1) {
-		frame->buffer->priv->status = ARV_BUFFER_STATUS_WRONG_PACKET_ID;
-		return;
-	}
+	int enable = 1;
 
-	if (frame->packet_data[packet_id].time_us > 0) {
-		thread_data->n_resent_packets++;
-		arv_debug_stream_thread ("[GvStream::process_data_trailer] Received resent packet %u for frame %" G_GUINT64_FORMAT,
-				       packet_id, frame->frame_id);
-	}
+	thread_data->use_kernel_timestamps = setsockopt (fd, SOL_SOCKET, SO_TIMESTAMPNS,
+							 &enable, sizeof (enable)) == 0;
+	if (!thread_data->use_kernel_timestamps)
+		arv_info_stream_thread ("[GvStream::enable_kernel_timestamps] Kernel timestamps not available (%s)",
+					strerror (errno));
 }
 
-static ArvGvStreamFrameData *
-_find_frame_data (ArvGvStreamThreadData *thread_data,
-		  const ArvGvspPacket *packet,
-		  size_t packet_size,
-		  guint64 frame_id,
-		  guint32 packet_id,
-		  gboolean extended_ids,
-		  size_t read_count,
-		  guint64 time_us)
-{
-	ArvGvStreamFrameData *frame = NULL;
-	ArvBuffer *buffer;
-	GSList *iter;
-	guint n_packets = 0;
-	gint64 frame_id_inc;
-	guint32 block_size;
+#if ARAVIS_HAS_HARDWARE_TIMESTAMPS
 
-	for (iter = thread_data->frames; iter != NULL; iter = iter->next) {
-		frame = iter->data;
-		if (frame->frame_id == frame_id) {
-			frame->last_packet_time_us = time_us;
-			return frame;
-		}
-	}
+/* Configures the network interface for the hardware timestamping of all the received packets, and requests the
+ * timestamps on the socket. The interface configuration requires CAP_NET_ADMIN, but may already be done, for example
+ * by a PTP daemon. */
 
-	if (extended_ids) {
-		frame_id_inc = (gint64) frame_id - (gint64) thread_data->last_frame_id;
-		/* Frame id 0 is not a valid value */
-		if ((gint64) frame_id > 0 && (gint64) thread_data->last_frame_id < 0)
-			frame_id_inc--;
-	} else {
-		frame_id_inc = (gint16) frame_id - (gint16) thread_data->last_frame_id;
-		/* Frame id 0 is not a valid value */
-		if ((gint16) frame_id > 0 && (gint16) thread_data->last_frame_id < 0)
-			frame_id_inc--;
+static gboolean
+_enable_hardware_timestamps (ArvGvStreamThreadData *thread_data, int fd, gboolean packet_socket)
+{
+	struct hwtstamp_config config;
+	struct ifreq request;
+	ArvNetworkInterface *iface;
+	gboolean interface_found = FALSE;
+	int flags;
+	int result;
+
+	memset (&request, 0, sizeof (request));
+	iface = arv_network_interface_lookup (thread_data->interface_address);
+	if (iface != NULL && arv_network_interface_get_name (iface) != NULL) {
+		g_strlcpy (request.ifr_name, arv_network_interface_get_name (iface), sizeof (request.ifr_name));
+		interface_found = TRUE;
 	}
+	arv_network_interface_free (iface);
 
-	if (frame_id_inc < 1  && frame_id_inc > -ARV_GV_STREAM_DISCARD_LATE_FRAME_THRESHOLD) {
-		arv_info_stream_thread ("[GvStream::find_frame_data] Discard late frame %" G_GUINT64_FORMAT
-					 " (last: %" G_GUINT64_FORMAT ")",
-					 frame_id, thread_data->last_frame_id);
-		arv_gvsp_packet_debug (packet, packet_size, ARV_DEBUG_LEVEL_INFO);
-		return NULL;
+	if (interface_found) {
+		memset (&config, 0, sizeof (config));
+		config.tx_type = HWTSTAMP_TX_OFF;
+		config.rx_filter = HWTSTAMP_FILTER_ALL;
+		request.ifr_data = (void *) &config;
+
+		if (ioctl (fd, SIOCSHWTSTAMP, &request) < 0)
+			arv_info_stream_thread ("[GvStream::enable_hardware_timestamps] Failed to configure %s (%s), "
+						"relying on the current configuration", request.ifr_name, strerror (errno));
 	}
 
-	buffer = arv_stream_pop_input_buffer (thread_data->stream);
-	if (buffer == NULL) {
-		thread_data->n_underruns++;
+	flags = SOF_TIMESTAMPING_RX_HARDWARE | SOF_TIMESTAMPING_RAW_HARDWARE;
+	if (packet_socket)
+		result = setsockopt (fd, SOL_PACKET, PACKET_TIMESTAMP, &flags, sizeof (flags));
+	else
+		result = setsockopt (fd, SOL_SOCKET, SO_TIMESTAMPING, &flags, sizeof (flags));
 
-		return NULL;
+	if (result < 0) {
+		arv_warning_stream_thread ("[GvStream::enable_hardware_timestamps] Hardware timestamps not available (%s)",
+					   strerror (errno));
+		return FALSE;
 	}
 
-	block_size = thread_data->scps_packet_size -
-		(extended_ids ? ARV_GVSP_PACKET_EXTENDED_PROTOCOL_OVERHEAD : ARV_GVSP_PACKET_PROTOCOL_OVERHEAD);
+	arv_info_stream_thread ("[GvStream::enable_hardware_timestamps] Hardware timestamps enabled");
 
-	frame = g_new0 (ArvGvStreamFrameData, 1);
+	return TRUE;
+}
 
-	frame->error_packet_received = FALSE;
+#endif
 
-	frame->frame_id = frame_id;
-	frame->last_valid_packet = -1;
+/* Returns the kernel reception time of a message, and stores its hardware reception time in the thread data */
 
-	frame->buffer = buffer;
-	_update_socket (thread_data, frame->buffer);
-	frame->buffer->priv->status = ARV_BUFFER_STATUS_FILLING;
-	n_packets = (frame->buffer->priv->size + block_size - 1) / block_size + 2;
+static guint64
+_get_message_system_time_ns (ArvGvStreamThreadData *thread_data, struct msghdr *message)
+{
+	struct cmsghdr *cmsg;
+	guint64 system_time_ns = 0;
 
-	frame->first_packet_time_us = time_us;
-	frame->last_packet_time_us = time_us;
+	thread_data->packet_hardware_time_ns = 0;
 
-	frame->packet_data = g_new0 (ArvGvStreamPacketData, n_packets);
-	frame->n_packets = n_packets;
+	for (cmsg = CMSG_FIRSTHDR (message); cmsg != NULL; cmsg = CMSG_NXTHDR (message, cmsg)) {
+		if (cmsg->cmsg_level != SOL_SOCKET)
+			continue;
 
-	if (thread_data->callback != NULL &&
-	    frame->buffer != NULL)
-		thread_data->callback (thread_data->callback_data,
-				       ARV_STREAM_CALLBACK_TYPE_START_BUFFER,
-				       NULL);
+		if (cmsg->cmsg_type == SCM_TIMESTAMPNS) {
+			struct timespec timestamp;
 
-	thread_data->last_frame_id = frame_id;
+			memcpy (&timestamp, CMSG_DATA (cmsg), sizeof (timestamp));
 
-	if (frame_id_inc > 1) {
-		thread_data->n_missing_frames++;
-		arv_debug_stream_thread ("[GvStream::find_frame_data] Missed %" G_GINT64_FORMAT " frame(s) before %" G_GUINT64_FORMAT,
-				       frame_id_inc - 1, frame_id);
-	}
+			system_time_ns = (guint64) timestamp.tv_sec * 1000000000ULL + timestamp.tv_nsec;
+		}
+#if ARAVIS_HAS_HARDWARE_TIMESTAMPS
+		else if (cmsg->cmsg_type == SCM_TIMESTAMPING) {
+			/* Software, deprecated, and raw hardware timestamps */
+			struct timespec timestamps[3];
 
-	thread_data->frames = g_slist_append (thread_data->frames, frame);
+			memcpy (timestamps, CMSG_DATA (cmsg), sizeof (timestamps));
 
-	arv_debug_stream_thread ("[GvStream::find_frame_data] Start frame %" G_GUINT64_FORMAT, frame_id);
+			thread_data->packet_hardware_time_ns = (guint64) timestamps[2].tv_sec * 1000000000ULL +
+				timestamps[2].tv_nsec;
+		}
+#endif
+	}
 
-	frame->extended_ids = extended_ids;
+	return system_time_ns;
+}
 
-	return frame;
+static size_t
+_timestamped_receive (ArvGvStreamThreadData *thread_data, ArvGvspPacket *packet, guint64 *system_time_ns)
+{
+	char control[ARV_GV_STREAM_CONTROL_BUFFER_SIZE];
+	struct iovec iovec;
+	struct msghdr message;
+	ssize_t read_count;
+
+	memset (&message, 0, sizeof (message));
+	iovec.iov_base = packet;
+	iovec.iov_len = ARV_GV_STREAM_INCOMING_BUFFER_SIZE;
+	message.msg_iov = &iovec;
+	message.msg_iovlen = 1;
+	message.msg_control = control;
+	message.msg_controllen = sizeof (control);
+
+	read_count = recvmsg (g_socket_get_fd (thread_data->socket), &message, MSG_DONTWAIT);
+	if (read_count <= 0)
+		return 0;
+
+	*system_time_ns = _get_message_system_time_ns (thread_data, &message);
+
+	return read_count;
 }
 
+#endif
+
+/* The conversion is only enabled if no data block was written yet in the packed layout, and if the buffer is large
+ * enough, otherwise the frame is delivered in its original pixel format */
+
 static void
-_missing_packet_check (ArvGvStreamThreadData *thread_data,
-		       ArvGvStreamFrameData *frame,
-		       guint32 packet_id,
-		       guint64 time_us)
+_setup_unpack (ArvGvStreamThreadData *thread_data, ArvGvStreamFrameData *frame)
 {
-	int i;
+	ArvBuffer *buffer = frame->buffer;
+	ArvConvertUnpacker *unpacker = &thread_data->unpacker;
+	guint64 n_pixels = (guint64) buffer->priv->width * buffer->priv->height;
 
-	if (thread_data->packet_resend == ARV_GV_STREAM_PACKET_RESEND_NEVER ||
-	    frame->error_packet_received ||
-	    frame->resend_ratio_reached)
+	if (frame->n_data_blocks > 0)
 		return;
 
-	if ((int) (frame->n_packets * thread_data->packet_request_ratio) <= 0)
+	if ((unpacker->source != buffer->priv->pixel_format ||
+	     unpacker->target != thread_data->unpack_pixel_format) &&
+	    !arv_convert_unpacker_init (unpacker, buffer->priv->pixel_format, thread_data->unpack_pixel_format))
 		return;
 
-	if (packet_id < frame->n_packets) {
-		int first_missing = -1;
-
-		for (i = frame->last_valid_packet + 1; i <= packet_id + 1; i++) {
-			gboolean need_resend;
+	if (n_pixels % unpacker->group_pixels != 0 ||
+	    n_pixels * 2 > buffer->priv->size) {
+		arv_debug_stream_thread ("[GvStream::setup_unpack] Can't unpack %" G_GUINT64_FORMAT
+					 " pixels in a %" G_GSIZE_FORMAT " bytes buffer", n_pixels, buffer->priv->size);
+		return;
+	}
 
-			need_resend = i <= packet_id &&
-				!frame->packet_data[i].received &&
-				(frame->packet_data[i].time_us == 0 ||
-				 (time_us - frame->packet_data[i].time_us > thread_data->packet_timeout_us));
+	if (frame->n_allocated_seams < frame->n_packets) {
+		g_free (frame->unpack_seams);
+		frame->unpack_seams = g_new0 (ArvGvStreamUnpackSeam, frame->n_packets);
+		frame->n_allocated_seams = frame->n_packets;
+	} else
+		memset (frame->unpack_seams, 0, frame->n_packets * sizeof (ArvGvStreamUnpackSeam));
 
-			if (need_resend) {
-				if (first_missing < 0)
-					first_missing = i;
-			}
+	frame->unpack = TRUE;
+	frame->packed_size = n_pixels / unpacker->group_pixels * unpacker->group_bytes;
+	buffer->priv->pixel_format = unpacker->target;
 
-			if (i > packet_id || !need_resend) {
-				if (first_missing >= 0) {
-					int last_missing;
-					int n_missing_packets;
-					int j;
+	thread_data->n_unpacked_frames++;
+}
 
-					last_missing = i - 1;
-					n_missing_packets = last_missing - first_missing + 1;
+static void
+_add_unpack_seam (ArvGvStreamThreadData *thread_data, ArvGvStreamFrameData *frame, guint32 seam_id,
+		  const guint8 *data, size_t offset, size_t size)
+{
+	ArvConvertUnpacker *unpacker = &thread_data->unpacker;
+	ArvGvStreamUnpackSeam *seam = &frame->unpack_seams[seam_id];
+	size_t group = offset / unpacker->group_bytes;
+	size_t i;
+
+	for (i = 0; i < size; i++) {
+		guint position = offset + i - group * unpacker->group_bytes;
+
+		seam->bytes[position] = data[i];
+		seam->mask |= 1 << position;
+	}
+
+	if (seam->mask == (1 << unpacker->group_bytes) - 1)
+		arv_convert_unpacker_unpack (unpacker, seam->bytes, 1,
+					     (guint16 *) frame->buffer->priv->data + group * unpacker->group_pixels);
+}
+
+/* Groups fully contained in the block are unpacked immediately, split groups at the block boundaries are kept until
+ * their other part arrives. The data blocks are larger than a group, except the last one. */
+
+static void
+_unpack_data_block (ArvGvStreamThreadData *thread_data, ArvGvStreamFrameData *frame, guint32 packet_id,
+		    const guint8 *data, size_t block_offset, size_t block_size)
+{
+	ArvConvertUnpacker *unpacker = &thread_data->unpacker;
+	size_t group_bytes = unpacker->group_bytes;
+	size_t block_end = block_offset + block_size;
+	size_t first_group = (block_offset + group_bytes - 1) / group_bytes;
+	size_t end_group = block_end / group_bytes;
+	size_t head_end = MIN (first_group * group_bytes, block_end);
+
+	if (head_end > block_offset)
+		_add_unpack_seam (thread_data, frame, packet_id - 1, data, block_offset, head_end - block_offset);
+
+	if (end_group > first_group)
+		arv_convert_unpacker_unpack (unpacker, data + first_group * group_bytes - block_offset,
+					     end_group - first_group,
+					     (guint16 *) frame->buffer->priv->data + first_group * unpacker->group_pixels);
+
+	if (end_group >= first_group && block_end > end_group * group_bytes)
+		_add_unpack_seam (thread_data, frame, packet_id, data + end_group * group_bytes - block_offset,
+				  end_group * group_bytes, block_end - end_group * group_bytes);
+}
+
+static gboolean
+_is_crop_enabled (ArvGvStreamThreadData *thread_data)
+{
+	return thread_data->crop_x != 0 || thread_data->crop_y != 0 ||
+		thread_data->crop_width != 0 || thread_data->crop_height != 0 ||
+		thread_data->decimation_horizontal > 1 || thread_data->decimation_vertical > 1;
+}
+
+/* The frame packet count is computed from the buffer size on the frame creation, it is updated to the received
+ * payload size once the leader is received */
+
+static void
+_set_frame_n_packets (ArvGvStreamFrameData *frame, guint n_packets)
+{
+	guint n_words = ARV_GV_STREAM_N_PACKETS_TO_N_WORDS (n_packets);
+
+	if (frame->n_allocated_words < n_words) {
+		guint64 *received_packets = g_new0 (guint64, n_words);
+
+		memcpy (received_packets, frame->received_packets, frame->n_allocated_words * sizeof (guint64));
+		g_free (frame->received_packets);
+		frame->received_packets = received_packets;
+		frame->n_allocated_words = n_words;
+	}
+
+	frame->n_packets = n_packets;
+}
+
+/* Only the byte aligned pixel formats are cropped, and only if no data block was written yet in the full layout */
+
+static void
+_setup_crop (ArvGvStreamThreadData *thread_data, ArvGvStreamFrameData *frame)
+{
+	ArvBuffer *buffer = frame->buffer;
+	ArvGvStreamCrop *crop = &frame->crop;
+	guint bit_per_pixel = ARV_PIXEL_FORMAT_BIT_PER_PIXEL (buffer->priv->pixel_format);
+	guint width = buffer->priv->width;
+	guint height = buffer->priv->height;
+	size_t block_size;
+	size_t size;
+
+	if (frame->n_data_blocks > 0 || bit_per_pixel == 0 || bit_per_pixel % 8 != 0)
+		return;
+
+	crop->pixel_size = bit_per_pixel / 8;
+	crop->x = MIN (thread_data->crop_x, width);
+	crop->y = MIN (thread_data->crop_y, height);
+	crop->width = thread_data->crop_width != 0 ? MIN (thread_data->crop_width, width - crop->x) : width - crop->x;
+	crop->height = thread_data->crop_height != 0 ?
+		MIN (thread_data->crop_height, height - crop->y) : height - crop->y;
+	crop->decimation_x = MAX (thread_data->decimation_horizontal, 1);
+	crop->decimation_y = MAX (thread_data->decimation_vertical, 1);
+
+	if (crop->width == 0 || crop->height == 0)
+		return;
+
+	crop->source_row_size = (size_t) width * crop->pixel_size;
+	crop->source_size = crop->source_row_size * height;
+	crop->row_size = (size_t) ((crop->width + crop->decimation_x - 1) / crop->decimation_x) * crop->pixel_size;
+	size = crop->row_size * ((crop->height + crop->decimation_y - 1) / crop->decimation_y);
+
+	if (size > buffer->priv->size) {
+		arv_debug_stream_thread ("[GvStream::setup_crop] Can't crop to %" G_GSIZE_FORMAT
+					 " bytes in a %" G_GSIZE_FORMAT " bytes buffer", size, buffer->priv->size);
+		return;
+	}
+
+	block_size = thread_data->scps_packet_size - (frame->extended_ids ?
+						       ARV_GVSP_PACKET_EXTENDED_PROTOCOL_OVERHEAD :
+						       ARV_GVSP_PACKET_PROTOCOL_OVERHEAD);
+	thread_data->n_crop_packets = (crop->source_size + block_size - 1) / block_size + 2;
+	_set_frame_n_packets (frame, thread_data->n_crop_packets);
+
+	crop->enabled = TRUE;
+	buffer->priv->x_offset += crop->x;
+	buffer->priv->y_offset += crop->y;
+	buffer->priv->width = crop->row_size / crop->pixel_size;
+	buffer->priv->height = size / crop->row_size;
+
+	thread_data->n_cropped_frames++;
+}
+
+/* Copies the part of the block inside the region, row by row, or pixel by pixel with an horizontal decimation.
+ * Pixels split between two blocks are copied in two parts. */
+
+static void
+_crop_data_block (ArvGvStreamFrameData *frame, const guint8 *data, size_t block_offset, size_t block_size)
+{
+	const ArvGvStreamCrop *crop = &frame->crop;
+	guint8 *buffer_data = frame->buffer->priv->data;
+	size_t block_end = block_offset + block_size;
+	size_t pixel_size = crop->pixel_size;
+	size_t row;
+
+	for (row = block_offset / crop->source_row_size;
+	     row * crop->source_row_size < block_end && row < crop->y + crop->height;
+	     row++) {
+		size_t row_start = row * crop->source_row_size;
+		size_t region_start = row_start + crop->x * pixel_size;
+		size_t start = MAX (block_offset, region_start);
+		size_t end = MIN (block_end, region_start + crop->width * pixel_size);
+		guint8 *dst;
+		size_t pixel;
+
+		if (row < crop->y || (row - crop->y) % crop->decimation_y != 0 || start >= end)
+			continue;
+
+		dst = buffer_data + ((row - crop->y) / crop->decimation_y) * crop->row_size;
+
+		if (crop->decimation_x == 1) {
+			memcpy (dst + start - region_start, data + start - block_offset, end - start);
+			continue;
+		}
+
+		for (pixel = ((start - region_start) / pixel_size + crop->decimation_x - 1) /
+		     crop->decimation_x * crop->decimation_x;
+		     region_start + pixel * pixel_size < end;
+		     pixel += crop->decimation_x) {
+			size_t pixel_start = region_start + pixel * pixel_size;
+			size_t copy_start = MAX (pixel_start, start);
+			size_t copy_end = MIN (pixel_start + pixel_size, end);
+
+			memcpy (dst + (pixel / crop->decimation_x) * pixel_size + copy_start - pixel_start,
+				data + copy_start - block_offset, copy_end - copy_start);
+		}
+	}
+}
+
+/* Sets the buffer timestamps from a packet starting with the leader fields */
+
+static void
+_set_buffer_timestamps (ArvGvStreamThreadData *thread_data,
+			ArvBuffer *buffer,
+			const ArvGvspPacket *packet,
+			gboolean resent,
+			guint64 time_us)
+{
+	buffer->priv->system_timestamp_ns = thread_data->packet_system_time_ns != 0 ?
+		thread_data->packet_system_time_ns :
+		g_get_real_time() * 1000LL;
+	buffer->priv->host_timestamp_ns = time_us * 1000LL;
+	buffer->priv->leader_hardware_timestamp_ns = thread_data->packet_hardware_time_ns;
+	if (buffer->priv->payload_type != ARV_BUFFER_PAYLOAD_TYPE_H264) {
+		if (G_LIKELY (thread_data->timestamp_tick_frequency != 0)) {
+			buffer->priv->timestamp_ns = arv_gvsp_packet_get_timestamp (packet,
+										    thread_data->timestamp_tick_frequency);
+
+			/* Resent leaders arrive late, and would bias the lower envelope of the clock model */
+			if (!resent) {
+				buffer->priv->host_timestamp_ns =
+					arv_clock_model_add_sample (thread_data->clock_model,
+								    buffer->priv->timestamp_ns,
+								    time_us * 1000LL);
+				thread_data->clock_drift_ppm = arv_clock_model_get_drift_ppm (thread_data->clock_model);
+				thread_data->n_clock_resets = arv_clock_model_get_n_resets (thread_data->clock_model);
+			} else if (arv_clock_model_is_valid (thread_data->clock_model))
+				buffer->priv->host_timestamp_ns =
+					arv_clock_model_convert (thread_data->clock_model,
+								 buffer->priv->timestamp_ns);
+		} else {
+			buffer->priv->timestamp_ns = buffer->priv->system_timestamp_ns;
+		}
+	} else
+		buffer->priv->timestamp_ns = buffer->priv->system_timestamp_ns;
+}
+
+/* Each multipart data packet carries the data of a single part, the packet count is computed from the part sizes */
+
+static void
+_setup_multipart (ArvGvStreamThreadData *thread_data,
+		  ArvGvStreamFrameData *frame,
+		  const ArvGvspPacket *packet,
+		  size_t read_count)
+{
+	ArvBuffer *buffer = frame->buffer;
+	guint n_parts = arv_gvsp_packet_get_n_parts (packet, read_count);
+	size_t block_size;
+	size_t offset = 0;
+	guint n_packets = 2;
+	guint i;
+
+	block_size = thread_data->scps_packet_size - sizeof (ArvGvspMultipart) -
+		(frame->extended_ids ? ARV_GVSP_PACKET_EXTENDED_PROTOCOL_OVERHEAD : ARV_GVSP_PACKET_PROTOCOL_OVERHEAD);
+
+	arv_buffer_set_n_parts (buffer, n_parts);
+
+	for (i = 0; i < n_parts; i++) {
+		const ArvGvspPartInfos *infos = arv_gvsp_packet_get_part_infos (packet, i);
+		ArvBufferPart *part = &buffer->priv->parts[i];
+		guint64 size = arv_gvsp_part_infos_get_size (infos);
+
+		if (size > buffer->priv->size - offset) {
+			arv_info_stream_thread ("[GvStream::setup_multipart] Part %u of frame %" G_GUINT64_FORMAT
+						" doesn't fit in a %" G_GSIZE_FORMAT " bytes buffer",
+						i, frame->frame_id, buffer->priv->size);
+			thread_data->n_size_mismatch_errors++;
+			buffer->priv->status = ARV_BUFFER_STATUS_SIZE_MISMATCH;
+			return;
+		}
+
+		part->data_offset = offset;
+		part->size = size;
+		part->data_type = g_ntohs (infos->data_type);
+		part->pixel_format = g_ntohl (infos->pixel_format);
+		part->x_offset = g_ntohl (infos->x_offset);
+		part->y_offset = g_ntohl (infos->y_offset);
+		part->width = g_ntohl (infos->width);
+		part->height = g_ntohl (infos->height);
+
+		offset += size;
+		n_packets += (size + block_size - 1) / block_size;
+	}
+
+	_set_frame_n_packets (frame, n_packets);
+}
+
+static void
+_process_data_leader (ArvGvStreamThreadData *thread_data,
+		      ArvGvStreamFrameData *frame,
+		      const ArvGvspPacket *packet,
+		      guint32 packet_id,
+		      size_t read_count,
+		      guint64 time_us)
+{
+	if (frame->buffer->priv->status != ARV_BUFFER_STATUS_FILLING)
+		return;
+
+	if (packet_id != 0) {
+		frame->buffer->priv->status = ARV_BUFFER_STATUS_WRONG_PACKET_ID;
+		return;
+	}
+
+	ARV_TRACE_LEADER_RECEIVED (frame->frame_id, time_us);
+	arv_event_ring_record (thread_data->event_ring, ARV_EVENT_RING_EVENT_LEADER, frame->frame_id, 0, 0);
+
+	frame->buffer->priv->payload_type = arv_gvsp_packet_get_buffer_payload_type (packet);
+	frame->buffer->priv->frame_id = frame->frame_id;
+	frame->buffer->priv->chunk_endianness = G_BIG_ENDIAN;
+
+	/* Unless the trailer was received first */
+	frame->is_size_unknown = arv_buffer_payload_type_is_variable_size (frame->buffer->priv->payload_type) &&
+		!_is_packet_received (frame, frame->n_packets - 1);
+
+	_set_buffer_timestamps (thread_data, frame->buffer, packet, _get_resend_time (frame, packet_id) > 0, time_us);
+
+	if (arv_buffer_payload_type_has_aoi (frame->buffer->priv->payload_type)) {
+		frame->buffer->priv->x_offset = arv_gvsp_packet_get_x_offset (packet);
+		frame->buffer->priv->y_offset = arv_gvsp_packet_get_y_offset (packet);
+		frame->buffer->priv->width = arv_gvsp_packet_get_width (packet);
+		frame->buffer->priv->height = arv_gvsp_packet_get_height (packet);
+		frame->buffer->priv->pixel_format = arv_gvsp_packet_get_pixel_format (packet);
+	} else if (frame->buffer->priv->payload_type == ARV_BUFFER_PAYLOAD_TYPE_MULTIPART)
+		_setup_multipart (thread_data, frame, packet, read_count);
+
+	if (thread_data->unpack_pixel_format != 0 &&
+	    frame->buffer->priv->payload_type == ARV_BUFFER_PAYLOAD_TYPE_IMAGE)
+		_setup_unpack (thread_data, frame);
+
+	if (!frame->unpack && _is_crop_enabled (thread_data) &&
+	    frame->buffer->priv->payload_type == ARV_BUFFER_PAYLOAD_TYPE_IMAGE)
+		_setup_crop (thread_data, frame);
+
+	if (_get_resend_time (frame, packet_id) > 0) {
+		thread_data->n_resent_packets++;
+		frame->n_resent_packets++;
+		arv_debug_stream_thread ("[GvStream::process_data_leader] Received resent packet %u for frame %" G_GUINT64_FORMAT,
+				       packet_id, frame->frame_id);
+		arv_event_ring_record (thread_data->event_ring, ARV_EVENT_RING_EVENT_RESENT_PACKET, frame->frame_id, packet_id, 0);
+	}
+}
+
+static inline void
+_copy_block (ArvGvStreamThreadData *thread_data, void *dst, const void *src, size_t size)
+{
+	if (thread_data->copy_func != NULL)
+		thread_data->copy_func (dst, src, size, thread_data->copy_data);
+	else
+		memcpy (dst, src, size);
+}
+
+static ArvBuffer *
+_pop_input_buffer (ArvGvStreamThreadData *thread_data)
+{
+	ArvBuffer *buffer = thread_data->prefetched_buffer;
+
+	thread_data->copy_func = arv_stream_get_copy_function (thread_data->stream, &thread_data->copy_data);
+	thread_data->checksum = arv_stream_is_checksum_enabled (thread_data->stream);
+
+	if (buffer != NULL) {
+		thread_data->prefetched_buffer = NULL;
+		return buffer;
+	}
+
+	return arv_stream_pop_input_buffer (thread_data->stream);
+}
+
+/* Takes the next input buffer once the current frame is half received, and warms the caches and the TLB for its
+ * first data blocks and for the frame data of the pool */
+
+static void
+_prefetch_next_buffer (ArvGvStreamThreadData *thread_data, ArvGvStreamFrameData *frame)
+{
+	ArvBuffer *buffer;
+	const char *data;
+	size_t size;
+	size_t offset;
+
+	if (frame->n_data_blocks != frame->n_packets / 2 || thread_data->prefetched_buffer != NULL)
+		return;
+
+	buffer = arv_stream_pop_input_buffer (thread_data->stream);
+	if (buffer == NULL)
+		return;
+
+	thread_data->prefetched_buffer = buffer;
+	thread_data->n_prefetched_buffers++;
+
+	__builtin_prefetch (buffer->priv, 1, 3);
+
+	data = buffer->priv->data;
+	size = MIN (buffer->priv->size, ARV_GV_STREAM_PREFETCH_SIZE);
+	for (offset = 0; offset < size; offset += ARV_GV_STREAM_PREFETCH_LINE_SIZE)
+		if (offset < ARV_GV_STREAM_PREFETCH_PAGE_SIZE || offset % ARV_GV_STREAM_PREFETCH_PAGE_SIZE == 0)
+			__builtin_prefetch (data + offset, 1, 3);
+
+	if (thread_data->frame_pool != NULL) {
+		__builtin_prefetch (thread_data->frame_pool, 1, 3);
+		__builtin_prefetch (thread_data->frame_pool->received_packets, 1, 3);
+	}
+}
+
+static void
+_process_data_block (ArvGvStreamThreadData *thread_data,
+		     ArvGvStreamFrameData *frame,
+		     const ArvGvspPacket *packet,
+		     guint32 packet_id,
+		     size_t read_count)
+{
+	size_t block_size;
+	size_t payload_size;
+	ptrdiff_t block_offset;
+	ptrdiff_t block_end;
+	gboolean extended_ids;
+
+	if (frame->buffer->priv->status != ARV_BUFFER_STATUS_FILLING)
+		return;
+
+	frame->n_data_blocks++;
+
+	if (packet_id > frame->n_packets - 2 && frame->is_size_unknown) {
+		arv_info_stream_thread ("[GvStream::process_data_block] Variable size payload of frame %" G_GUINT64_FORMAT
+					" larger than the %" G_GSIZE_FORMAT " bytes buffer",
+					frame->frame_id, frame->buffer->priv->size);
+		thread_data->n_size_mismatch_errors++;
+		frame->buffer->priv->status = ARV_BUFFER_STATUS_SIZE_MISMATCH;
+		return;
+	}
+
+	if (packet_id > frame->n_packets - 2 || packet_id < 1) {
+		arv_gvsp_packet_debug (packet, read_count, ARV_DEBUG_LEVEL_INFO);
+		frame->buffer->priv->status = ARV_BUFFER_STATUS_WRONG_PACKET_ID;
+		return;
+	}
+
+	extended_ids = arv_gvsp_packet_has_extended_ids (packet);
+
+	block_size = arv_gvsp_packet_get_data_size (packet, read_count);
+	block_offset = (packet_id - 1) * (thread_data->scps_packet_size - (extended_ids ?
+									   ARV_GVSP_PACKET_EXTENDED_PROTOCOL_OVERHEAD :
+									   ARV_GVSP_PACKET_PROTOCOL_OVERHEAD));
+	block_end = block_size + block_offset;
+
+	payload_size = frame->unpack ? frame->packed_size :
+		(frame->crop.enabled ? frame->crop.source_size : frame->buffer->priv->size);
+
+	if (block_end > payload_size) {
+		arv_info_stream_thread ("[GvStream::process_data_block] %" G_GINTPTR_FORMAT " unexpected bytes in packet %u "
+					 " for frame %" G_GUINT64_FORMAT,
+					 block_end - payload_size,
+					 packet_id, frame->frame_id);
+		thread_data->n_size_mismatch_errors++;
+
+		if (block_offset >= payload_size)
+			return;
+
+		block_end = payload_size;
+		block_size = block_end - block_offset;
+	}
+
+	if (block_end > frame->received_size)
+		frame->received_size = block_end;
+
+	if (frame->unpack) {
+		_unpack_data_block (thread_data, frame, packet_id, arv_gvsp_packet_get_data (packet),
+				    block_offset, block_size);
+	} else if (frame->crop.enabled) {
+		_crop_data_block (frame, arv_gvsp_packet_get_data (packet), block_offset, block_size);
+		thread_data->n_copied_bytes += block_size;
+	} else if (thread_data->zero_copy_hit) {
+		/* Payload may have already been received at its final location */
+		thread_data->n_zero_copy_packets++;
+		thread_data->n_zero_copy_bytes += block_size;
+	} else {
+		_copy_block (thread_data, ((char *) frame->buffer->priv->data) + block_offset,
+			     arv_gvsp_packet_get_data (packet), block_size);
+		thread_data->n_copied_bytes += block_size;
+	}
+
+	if (frame->checksum && !frame->unpack && !frame->crop.enabled && packet_id < frame->n_allocated_checksums) {
+		/* The block is still in the cache */
+		frame->block_checksums[packet_id].crc = arv_crc32c (0, ((char *) frame->buffer->priv->data) + block_offset,
+								     block_size);
+		frame->block_checksums[packet_id].size = block_size;
+		frame->n_checksummed_blocks++;
+	}
+
+	if (thread_data->use_prefetch)
+		_prefetch_next_buffer (thread_data, frame);
+
+	if (_get_resend_time (frame, packet_id) > 0) {
+		thread_data->n_resent_packets++;
+		frame->n_resent_packets++;
+		arv_debug_stream_thread ("[GvStream::process_data_block] Received resent packet %u for frame %" G_GUINT64_FORMAT,
+				       packet_id, frame->frame_id);
+		arv_event_ring_record (thread_data->event_ring, ARV_EVENT_RING_EVENT_RESENT_PACKET, frame->frame_id, packet_id, 0);
+	}
+}
+
+static void
+_process_multipart_block (ArvGvStreamThreadData *thread_data,
+			  ArvGvStreamFrameData *frame,
+			  const ArvGvspPacket *packet,
+			  guint32 packet_id,
+			  size_t read_count)
+{
+	const ArvGvspMultipart *multipart;
+	ArvBufferPart *part;
+	size_t data_size;
+	size_t block_size;
+	guint part_id;
+	guint64 offset;
+
+	if (frame->buffer->priv->status != ARV_BUFFER_STATUS_FILLING)
+		return;
+
+	if (frame->buffer->priv->n_parts == 0 && !_is_packet_received (frame, 0)) {
+		/* The part layout is only known once the leader is received, the block will be requested again */
+		if (packet_id < frame->n_packets)
+			_clear_packet_received (frame, packet_id);
+		return;
+	}
+
+	frame->n_data_blocks++;
+
+	data_size = arv_gvsp_packet_get_data_size (packet, read_count);
+	part_id = arv_gvsp_packet_get_multipart_part_id (packet);
+
+	if (packet_id > frame->n_packets - 2 || packet_id < 1 ||
+	    frame->buffer->priv->payload_type != ARV_BUFFER_PAYLOAD_TYPE_MULTIPART ||
+	    part_id >= frame->buffer->priv->n_parts ||
+	    data_size < sizeof (ArvGvspMultipart)) {
+		arv_gvsp_packet_debug (packet, read_count, ARV_DEBUG_LEVEL_INFO);
+		frame->buffer->priv->status = ARV_BUFFER_STATUS_WRONG_PACKET_ID;
+		return;
+	}
+
+	multipart = arv_gvsp_packet_get_data (packet);
+	part = &frame->buffer->priv->parts[part_id];
+	offset = arv_gvsp_packet_get_multipart_offset (packet);
+	block_size = data_size - sizeof (ArvGvspMultipart);
+
+	if (offset + block_size > part->size) {
+		arv_info_stream_thread ("[GvStream::process_multipart_block] %" G_GUINT64_FORMAT " unexpected bytes"
+					" in packet %u for part %u of frame %" G_GUINT64_FORMAT,
+					offset + block_size - part->size, packet_id, part_id, frame->frame_id);
+		thread_data->n_size_mismatch_errors++;
+
+		if (offset >= part->size)
+			return;
+
+		block_size = part->size - offset;
+	}
+
+	_copy_block (thread_data, frame->buffer->priv->data + part->data_offset + offset, multipart->data, block_size);
+	thread_data->n_copied_bytes += block_size;
+
+	if (thread_data->use_prefetch)
+		_prefetch_next_buffer (thread_data, frame);
+
+	if (_get_resend_time (frame, packet_id) > 0) {
+		thread_data->n_resent_packets++;
+		frame->n_resent_packets++;
+		arv_debug_stream_thread ("[GvStream::process_multipart_block] Received resent packet %u for frame %"
+					 G_GUINT64_FORMAT, packet_id, frame->frame_id);
+		arv_event_ring_record (thread_data->event_ring, ARV_EVENT_RING_EVENT_RESENT_PACKET, frame->frame_id, packet_id, 0);
+	}
+}
+
+static void
+_process_data_trailer (ArvGvStreamThreadData *thread_data,
+		       ArvGvStreamFrameData *frame,
+		       guint32 packet_id)
+{
+	if (frame->buffer->priv->status != ARV_BUFFER_STATUS_FILLING)
+		return;
+
+	if (frame->is_size_unknown && packet_id > 0 && packet_id < frame->n_packets - 1) {
+		/* The trailer id gives the actual packet count of the variable size payloads */
+		arv_debug_stream_thread ("[GvStream::process_data_trailer] %u packets in frame %" G_GUINT64_FORMAT,
+					 packet_id + 1, frame->frame_id);
+		_set_frame_n_packets (frame, packet_id + 1);
+	}
+
+	if (packet_id != frame->n_packets - 1) {
+		frame->buffer->priv->status = ARV_BUFFER_STATUS_WRONG_PACKET_ID;
+		return;
+	}
+
+	frame->is_size_unknown = FALSE;
+	frame->buffer->priv->trailer_hardware_timestamp_ns = thread_data->packet_hardware_time_ns;
+
+	if (_get_resend_time (frame, packet_id) > 0) {
+		thread_data->n_resent_packets++;
+		frame->n_resent_packets++;
+		arv_debug_stream_thread ("[GvStream::process_data_trailer] Received resent packet %u for frame %" G_GUINT64_FORMAT,
+				       packet_id, frame->frame_id);
+		arv_event_ring_record (thread_data->event_ring, ARV_EVENT_RING_EVENT_RESENT_PACKET, frame->frame_id, packet_id, 0);
+	}
+}
+
+/* Converts the data packets never received into byte ranges of the buffer. The unpacked and cropped payloads are
+ * not mapped one to one to the buffer, and the multipart blocks have their own offsets, their ranges are unknown. */
+
+static void
+_set_missing_ranges (ArvGvStreamThreadData *thread_data, ArvGvStreamFrameData *frame)
+{
+	ArvBuffer *buffer = frame->buffer;
+	size_t block_size;
+	guint32 last_data_packet;
+	guint32 first;
+	guint32 end;
+
+	arv_buffer_clear_missing_ranges (buffer);
+
+	if ((buffer->priv->status != ARV_BUFFER_STATUS_MISSING_PACKETS &&
+	     buffer->priv->status != ARV_BUFFER_STATUS_TIMEOUT) ||
+	    frame->unpack || frame->crop.enabled || frame->is_size_unknown ||
+	    buffer->priv->payload_type == ARV_BUFFER_PAYLOAD_TYPE_MULTIPART ||
+	    frame->n_packets < 3)
+		return;
+
+	block_size = thread_data->scps_packet_size - (frame->extended_ids ?
+						      ARV_GVSP_PACKET_EXTENDED_PROTOCOL_OVERHEAD :
+						      ARV_GVSP_PACKET_PROTOCOL_OVERHEAD);
+	last_data_packet = frame->n_packets - 1;
+
+	for (first = _find_packet (frame, 1, last_data_packet, FALSE);
+	     first < last_data_packet;
+	     first = _find_packet (frame, end, last_data_packet, FALSE)) {
+		size_t offset = (size_t) (first - 1) * block_size;
+
+		end = _find_packet (frame, first, last_data_packet, TRUE);
+
+		if (offset >= buffer->priv->size)
+			break;
+
+		arv_buffer_append_missing_range (buffer, offset,
+						 MIN ((size_t) (end - 1) * block_size, buffer->priv->size) - offset);
+	}
+}
+
+/* Combines the data block checksums in the packet order, if they cover the start of the buffer data contiguously, and
+ * checksums the remaining data. */
+
+static void
+_set_frame_checksum (ArvGvStreamThreadData *thread_data, ArvGvStreamFrameData *frame)
+{
+	ArvBuffer *buffer = frame->buffer;
+	size_t size = MIN (buffer->priv->received_size, buffer->priv->size);
+	size_t block_size;
+	size_t offset = 0;
+	guint32 crc = 0;
+	guint n_blocks = frame->n_packets > 2 ? frame->n_packets - 2 : 0;
+	guint i;
+
+	block_size = thread_data->scps_packet_size -
+		(frame->extended_ids ? ARV_GVSP_PACKET_EXTENDED_PROTOCOL_OVERHEAD : ARV_GVSP_PACKET_PROTOCOL_OVERHEAD);
+
+	if (thread_data->checksum_block_size != block_size) {
+		thread_data->checksum_block_size = block_size;
+		thread_data->checksum_block_op = arv_crc32c_combine_gen (block_size);
+	}
+
+	if (!frame->unpack && !frame->crop.enabled &&
+	    buffer->priv->payload_type != ARV_BUFFER_PAYLOAD_TYPE_MULTIPART &&
+	    frame->n_checksummed_blocks == n_blocks) {
+		for (i = 1; i <= n_blocks; i++) {
+			ArvGvStreamBlockChecksum *block = &frame->block_checksums[i];
+
+			if (block->size == block_size)
+				crc = arv_crc32c_combine_op (crc, block->crc, thread_data->checksum_block_op);
+			else if (i == n_blocks)
+				crc = arv_crc32c_combine (crc, block->crc, block->size);
+			else
+				break;
+
+			offset += block->size;
+		}
+
+		if (i <= n_blocks || offset > size) {
+			/* Short block before the last one */
+			crc = 0;
+			offset = 0;
+		}
+	}
+
+	buffer->priv->checksum = arv_crc32c (crc, buffer->priv->data + offset, size - offset);
+	buffer->priv->has_checksum = TRUE;
+}
+
+static void
+_close_frame (ArvGvStreamThreadData *thread_data, ArvGvStreamFrameData *frame)
+{
+	ArvFrameLog *frame_log;
+	guint n_missing_packets = 0;
+
+	frame->buffer->priv->received_size =
+		arv_buffer_payload_type_is_variable_size (frame->buffer->priv->payload_type) ?
+		frame->received_size : frame->buffer->priv->size;
+
+	if (frame->checksum && frame->buffer->priv->status == ARV_BUFFER_STATUS_SUCCESS)
+		_set_frame_checksum (thread_data, frame);
+
+	if (frame->buffer->priv->status == ARV_BUFFER_STATUS_SUCCESS)
+		thread_data->n_completed_buffers++;
+	else
+		if (frame->buffer->priv->status != ARV_BUFFER_STATUS_ABORTED)
+			thread_data->n_failures++;
+
+	if (frame->buffer->priv->status == ARV_BUFFER_STATUS_TIMEOUT)
+		thread_data->n_timeouts++;
+
+	if (frame->buffer->priv->status == ARV_BUFFER_STATUS_ABORTED)
+		thread_data->n_aborteds++;
+
+	if (frame->buffer->priv->status != ARV_BUFFER_STATUS_SUCCESS &&
+	    frame->buffer->priv->status != ARV_BUFFER_STATUS_ABORTED) {
+		n_missing_packets = (int) frame->n_packets - (frame->last_valid_packet + 1);
+		thread_data->n_missing_packets += n_missing_packets;
+	}
+
+	_set_missing_ranges (thread_data, frame);
+
+	thread_data->last_closed_frame_valid = TRUE;
+	thread_data->last_closed_frame_id = frame->frame_id;
+
+	ARV_TRACE_FRAME_CLOSED (frame->frame_id, frame->buffer->priv->status, g_get_monotonic_time ());
+	arv_event_ring_record (thread_data->event_ring, ARV_EVENT_RING_EVENT_FRAME_CLOSED, frame->frame_id, frame->last_valid_packet + 1,
+			       frame->buffer->priv->status);
+
+	frame_log = arv_stream_get_frame_log (thread_data->stream);
+	if (frame_log != NULL)
+		arv_frame_log_append (frame_log, frame->buffer, n_missing_packets,
+				      frame->n_resent_packets, frame->n_requested_packets);
+
+	arv_stream_push_output_buffer (thread_data->stream, frame->buffer);
+	if (thread_data->callback != NULL)
+		thread_data->callback (thread_data->callback_data,
+				       ARV_STREAM_CALLBACK_TYPE_BUFFER_DONE,
+				       frame->buffer);
+
+	if (thread_data->statistic_count > 5) {
+		arv_statistic_fill (thread_data->statistic, 0,
+				    g_get_monotonic_time () - frame->first_packet_time_us,
+				    frame->frame_id);
+	} else
+		thread_data->statistic_count++;
+
+	arv_debug_stream_thread ("[GvStream::close_frame] Close frame %" G_GUINT64_FORMAT, frame->frame_id);
+
+	if (thread_data->zero_copy_frame == frame)
+		thread_data->zero_copy_frame = NULL;
+
+	frame->buffer = NULL;
+	frame->frame_id = 0;
+
+	frame->next = thread_data->frame_pool;
+	thread_data->frame_pool = frame;
+}
+
+static ArvGvStreamFrameData *
+_new_frame (ArvGvStreamThreadData *thread_data, guint n_packets)
+{
+	ArvGvStreamFrameData *frame;
+	guint64 *received_packets;
+	GArray *resend_ranges;
+	ArvGvStreamUnpackSeam *unpack_seams;
+	ArvGvStreamBlockChecksum *block_checksums;
+	guint n_allocated_words;
+	guint n_allocated_seams;
+	guint n_allocated_checksums;
+	guint n_words = ARV_GV_STREAM_N_PACKETS_TO_N_WORDS (n_packets);
+
+	frame = thread_data->frame_pool;
+	if (frame == NULL) {
+		frame = g_new0 (ArvGvStreamFrameData, 1);
+		frame->received_packets = g_new0 (guint64, n_words);
+		frame->n_allocated_words = n_words;
+		frame->resend_ranges = g_array_new (FALSE, FALSE, sizeof (ArvGvStreamResendRange));
+		frame->n_packets = n_packets;
+
+		return frame;
+	}
+
+	thread_data->frame_pool = frame->next;
+
+	received_packets = frame->received_packets;
+	n_allocated_words = frame->n_allocated_words;
+	resend_ranges = frame->resend_ranges;
+	unpack_seams = frame->unpack_seams;
+	n_allocated_seams = frame->n_allocated_seams;
+	block_checksums = frame->block_checksums;
+	n_allocated_checksums = frame->n_allocated_checksums;
+
+	if (n_allocated_words < n_words) {
+		/* Payload size has grown since this frame was allocated */
+		g_free (received_packets);
+		received_packets = g_new0 (guint64, n_words);
+		n_allocated_words = n_words;
+	} else {
+		memset (received_packets, 0, n_words * sizeof (guint64));
+		thread_data->n_avoided_allocations++;
+	}
+
+	g_array_set_size (resend_ranges, 0);
+
+	memset (frame, 0, sizeof (ArvGvStreamFrameData));
+	frame->received_packets = received_packets;
+	frame->n_allocated_words = n_allocated_words;
+	frame->resend_ranges = resend_ranges;
+	frame->unpack_seams = unpack_seams;
+	frame->n_allocated_seams = n_allocated_seams;
+	frame->block_checksums = block_checksums;
+	frame->n_allocated_checksums = n_allocated_checksums;
+	frame->n_packets = n_packets;
+
+	return frame;
+}
+
+static void
+_free_frame_pool (ArvGvStreamThreadData *thread_data)
+{
+	while (thread_data->frame_pool != NULL) {
+		ArvGvStreamFrameData *frame = thread_data->frame_pool;
+
+		thread_data->frame_pool = frame->next;
+		g_free (frame->received_packets);
+		g_free (frame->unpack_seams);
+		g_free (frame->block_checksums);
+		g_array_unref (frame->resend_ranges);
+		g_free (frame);
+	}
+}
+
+static inline ArvGvStreamFrameData *
+_get_frame (ArvGvStreamThreadData *thread_data, guint index)
+{
+	return thread_data->frames[(thread_data->first_frame + index) % ARV_GV_STREAM_N_FRAMES_MAX];
+}
+
+static ArvGvStreamFrameData *
+_lookup_frame (ArvGvStreamThreadData *thread_data, guint64 frame_id)
+{
+	ArvGvStreamFrameData *frame;
+	guint i;
+
+	/* Consecutive packets almost always belong to the same frame */
+	frame = thread_data->last_frame;
+	if (frame != NULL && frame->frame_id == frame_id)
+		return frame;
+
+	frame = thread_data->frame_table[frame_id % ARV_GV_STREAM_N_FRAMES_MAX];
+	if (frame == NULL || frame->frame_id != frame_id) {
+		/* Frame table collision, or unknown frame */
+		for (i = 0, frame = NULL; i < thread_data->n_frames; i++) {
+			if (_get_frame (thread_data, i)->frame_id == frame_id) {
+				frame = _get_frame (thread_data, i);
+				break;
+			}
+		}
+	}
+
+	if (frame != NULL)
+		thread_data->last_frame = frame;
+
+	return frame;
+}
+
+static void
+_close_first_frame (ArvGvStreamThreadData *thread_data)
+{
+	ArvGvStreamFrameData *frame;
+	guint slot;
+
+	g_return_if_fail (thread_data->n_frames > 0);
+
+	frame = thread_data->frames[thread_data->first_frame];
+	thread_data->frames[thread_data->first_frame] = NULL;
+	thread_data->first_frame = (thread_data->first_frame + 1) % ARV_GV_STREAM_N_FRAMES_MAX;
+	thread_data->n_frames--;
+
+	slot = frame->frame_id % ARV_GV_STREAM_N_FRAMES_MAX;
+	if (thread_data->frame_table[slot] == frame)
+		thread_data->frame_table[slot] = NULL;
+	if (thread_data->last_frame == frame)
+		thread_data->last_frame = NULL;
+
+	_close_frame (thread_data, frame);
+}
+
+static void
+_append_frame (ArvGvStreamThreadData *thread_data, ArvGvStreamFrameData *frame)
+{
+	if (thread_data->n_frames >= ARV_GV_STREAM_N_FRAMES_MAX) {
+		ArvGvStreamFrameData *oldest = thread_data->frames[thread_data->first_frame];
+
+		oldest->buffer->priv->status = ARV_BUFFER_STATUS_MISSING_PACKETS;
+		arv_info_stream_thread ("[GvStream::append_frame] Too many open frames, close frame %" G_GUINT64_FORMAT,
+					oldest->frame_id);
+		arv_event_ring_record (thread_data->event_ring, ARV_EVENT_RING_EVENT_FRAME_FLUSHED, oldest->frame_id, 0, 0);
+		_close_first_frame (thread_data);
+	}
+
+	thread_data->frames[(thread_data->first_frame + thread_data->n_frames) % ARV_GV_STREAM_N_FRAMES_MAX] = frame;
+	thread_data->n_frames++;
+	thread_data->frame_table[frame->frame_id % ARV_GV_STREAM_N_FRAMES_MAX] = frame;
+	thread_data->last_frame = frame;
+}
+
+static gint64
+_get_frame_id_diff (guint64 frame_id, guint64 reference_id, gboolean extended_ids)
+{
+	gint64 frame_id_inc;
+
+	if (extended_ids) {
+		frame_id_inc = (gint64) frame_id - (gint64) reference_id;
+		/* Frame id 0 is not a valid value */
+		if ((gint64) frame_id > 0 && (gint64) reference_id < 0)
+			frame_id_inc--;
+	} else {
+		frame_id_inc = (gint16) frame_id - (gint16) reference_id;
+		/* Frame id 0 is not a valid value */
+		if ((gint16) frame_id > 0 && (gint16) reference_id < 0)
+			frame_id_inc--;
+	}
+
+	return frame_id_inc;
+}
+
+/* Moves a frame appended to the open frame list before the frames with a greater id */
+
+static void
+_insert_frame (ArvGvStreamThreadData *thread_data, ArvGvStreamFrameData *frame)
+{
+	guint i;
+
+	_append_frame (thread_data, frame);
+
+	for (i = thread_data->n_frames - 1; i > 0; i--) {
+		ArvGvStreamFrameData *previous = _get_frame (thread_data, i - 1);
+
+		if (_get_frame_id_diff (previous->frame_id, frame->frame_id, frame->extended_ids) < 0)
+			break;
+
+		thread_data->frames[(thread_data->first_frame + i) % ARV_GV_STREAM_N_FRAMES_MAX] = previous;
+	}
+
+	thread_data->frames[(thread_data->first_frame + i) % ARV_GV_STREAM_N_FRAMES_MAX] = frame;
+}
+
+static gint64
+_get_frame_id_inc (ArvGvStreamThreadData *thread_data, guint64 frame_id, gboolean extended_ids)
+{
+	return _get_frame_id_diff (frame_id, thread_data->last_frame_id, extended_ids);
+}
+
+/* A late frame is accepted back in the open frame list if it lies within the reorder window, and if no newer frame
+ * was delivered yet */
+
+static gboolean
+_is_late_frame_reorderable (ArvGvStreamThreadData *thread_data, guint64 frame_id, gint64 frame_id_inc,
+			    gboolean extended_ids)
+{
+	if (thread_data->reorder_window == 0 ||
+	    frame_id_inc >= 0 ||
+	    -frame_id_inc >= thread_data->reorder_window ||
+	    thread_data->n_frames >= ARV_GV_STREAM_N_FRAMES_MAX)
+		return FALSE;
+
+	return !thread_data->last_closed_frame_valid ||
+		_get_frame_id_diff (frame_id, thread_data->last_closed_frame_id, extended_ids) > 0;
+}
+
+/* In frame id order delivery, a frame following missing frames is held while they can still be accepted by
+ * _is_late_frame_reorderable, at most for the frame retention time */
+
+static gboolean
+_is_waiting_for_late_frame (ArvGvStreamThreadData *thread_data, ArvGvStreamFrameData *frame, guint64 time_us)
+{
+	gint64 gap;
+
+	if (thread_data->reorder_window == 0 ||
+	    !thread_data->last_closed_frame_valid)
+		return FALSE;
+
+	gap = _get_frame_id_diff (frame->frame_id, thread_data->last_closed_frame_id, frame->extended_ids);
+	if (gap < 2 || gap >= ARV_GV_STREAM_DISCARD_LATE_FRAME_THRESHOLD)
+		return FALSE;
+
+	if (_get_frame_id_diff (thread_data->last_frame_id, thread_data->last_closed_frame_id,
+				frame->extended_ids) > thread_data->reorder_window)
+		return FALSE;
+
+	return time_us - frame->first_packet_time_us < thread_data->frame_retention_us;
+}
+
+static ArvGvStreamFrameData *
+_find_frame_data (ArvGvStreamThreadData *thread_data,
+		  const ArvGvspPacket *packet,
+		  size_t packet_size,
+		  guint64 frame_id,
+		  guint32 packet_id,
+		  gboolean extended_ids,
+		  size_t read_count,
+		  guint64 time_us)
+{
+	ArvGvStreamFrameData *frame = NULL;
+	ArvBuffer *buffer;
+	guint n_packets = 0;
+	gint64 frame_id_inc;
+	guint32 block_size;
+	gboolean is_late = FALSE;
+
+	frame = _lookup_frame (thread_data, frame_id);
+	if (frame != NULL) {
+		frame->last_packet_time_us = time_us;
+		return frame;
+	}
+
+	frame_id_inc = _get_frame_id_inc (thread_data, frame_id, extended_ids);
+
+	if (frame_id_inc < 1  && frame_id_inc > -ARV_GV_STREAM_DISCARD_LATE_FRAME_THRESHOLD) {
+		if (thread_data->early_completion_frame_valid &&
+		    frame_id == thread_data->early_completion_frame_id) {
+			/* Trailer, or resent packet, of a frame closed before its trailer arrival */
+			arv_debug_stream_thread ("[GvStream::find_frame_data] Ignore late packet %u of early completed frame %"
+						 G_GUINT64_FORMAT, packet_id, frame_id);
+			arv_event_ring_record (thread_data->event_ring, ARV_EVENT_RING_EVENT_LATE_PACKET, frame_id, packet_id, 0);
+			return NULL;
+		}
+
+		is_late = _is_late_frame_reorderable (thread_data, frame_id, frame_id_inc, extended_ids);
+		if (!is_late) {
+			arv_info_stream_thread ("[GvStream::find_frame_data] Discard late frame %" G_GUINT64_FORMAT
+						 " (last: %" G_GUINT64_FORMAT ")",
+						 frame_id, thread_data->last_frame_id);
+			arv_event_ring_record (thread_data->event_ring, ARV_EVENT_RING_EVENT_LATE_FRAME,
+					       frame_id, packet_id, 0);
+			arv_gvsp_packet_debug (packet, packet_size, ARV_DEBUG_LEVEL_INFO);
+			return NULL;
+		}
+	}
+
+	buffer = _pop_input_buffer (thread_data);
+	if (buffer == NULL) {
+		thread_data->n_underruns++;
+		arv_event_ring_record (thread_data->event_ring, ARV_EVENT_RING_EVENT_UNDERRUN, frame_id, packet_id, 0);
+
+		return NULL;
+	}
+
+	block_size = thread_data->scps_packet_size -
+		(extended_ids ? ARV_GVSP_PACKET_EXTENDED_PROTOCOL_OVERHEAD : ARV_GVSP_PACKET_PROTOCOL_OVERHEAD);
+
+	n_packets = (buffer->priv->size + block_size - 1) / block_size + 2;
+	if (thread_data->n_crop_packets > n_packets && _is_crop_enabled (thread_data))
+		n_packets = thread_data->n_crop_packets;
+
+	frame = _new_frame (thread_data, n_packets);
+
+	frame->error_packet_received = FALSE;
+	frame->resend_requested = FALSE;
+
+	frame->frame_id = frame_id;
+	frame->last_valid_packet = -1;
+
+	frame->buffer = buffer;
+	_update_socket (thread_data, frame->buffer);
+	frame->buffer->priv->status = ARV_BUFFER_STATUS_FILLING;
+	frame->buffer->priv->ready_offset = 0;
+	frame->buffer->priv->ready_size = 0;
+	frame->buffer->priv->has_chunk_index = FALSE;
+	frame->buffer->priv->n_parts = 0;
+	frame->buffer->priv->leader_hardware_timestamp_ns = 0;
+	frame->buffer->priv->trailer_hardware_timestamp_ns = 0;
+	frame->buffer->priv->has_checksum = FALSE;
+
+	frame->checksum = thread_data->checksum;
+	if (frame->checksum && frame->n_allocated_checksums < n_packets) {
+		/* Entries are only read once all the data blocks are checksummed, they don't need to be cleared */
+		g_free (frame->block_checksums);
+		frame->block_checksums = g_new (ArvGvStreamBlockChecksum, n_packets);
+		frame->n_allocated_checksums = n_packets;
+	}
+
+	frame->first_packet_time_us = time_us;
+	frame->last_packet_time_us = time_us;
+
+	if (thread_data->callback != NULL &&
+	    frame->buffer != NULL)
+		thread_data->callback (thread_data->callback_data,
+				       ARV_STREAM_CALLBACK_TYPE_START_BUFFER,
+				       NULL);
+
+	frame->extended_ids = extended_ids;
+
+	if (is_late) {
+		/* The frame was counted as missing on the reception of the next one */
+		if (thread_data->n_missing_frames > 0)
+			thread_data->n_missing_frames--;
+		thread_data->n_reordered_frames++;
+
+		_insert_frame (thread_data, frame);
+
+		arv_debug_stream_thread ("[GvStream::find_frame_data] Start late frame %" G_GUINT64_FORMAT
+					 " (last: %" G_GUINT64_FORMAT ")", frame_id, thread_data->last_frame_id);
+
+		return frame;
+	}
+
+	thread_data->last_frame_id = frame_id;
+
+	if (frame_id_inc > 1) {
+		thread_data->n_missing_frames++;
+		arv_debug_stream_thread ("[GvStream::find_frame_data] Missed %" G_GINT64_FORMAT " frame(s) before %" G_GUINT64_FORMAT,
+				       frame_id_inc - 1, frame_id);
+		arv_event_ring_record (thread_data->event_ring, ARV_EVENT_RING_EVENT_MISSED_FRAMES, frame_id, packet_id, frame_id_inc - 1);
+	}
+
+	_append_frame (thread_data, frame);
+
+	arv_debug_stream_thread ("[GvStream::find_frame_data] Start frame %" G_GUINT64_FORMAT, frame_id);
+
+	return frame;
+}
+
+/* Sends resend requests for the missing packets in [from, to[. Returns FALSE if the resend ratio is reached. */
+
+static gboolean
+_request_missing_packets (ArvGvStreamThreadData *thread_data,
+			  ArvGvStreamFrameData *frame,
+			  guint32 from,
+			  guint32 to,
+			  guint64 time_us)
+{
+	guint32 first_missing;
+	guint32 next_missing;
+
+	for (first_missing = _find_packet (frame, from, to, FALSE);
+	     first_missing < to;
+	     first_missing = next_missing) {
+		ArvGvStreamResendRange range;
+		guint32 end_missing;
+		guint n_missing_packets;
+
+		/* End of a continuous block of missing packets, merged with the following blocks if they are close enough,
+		 * as a resend request can only cover a single packet range. Only the missing packets of the merged range
+		 * are counted, for the request ratio, the resend budget and the statistics. */
+		end_missing = _find_packet (frame, first_missing, to, TRUE);
+		next_missing = _find_packet (frame, end_missing, to, FALSE);
+		n_missing_packets = end_missing - first_missing;
+		while (next_missing < to && next_missing - end_missing <= ARV_GV_STREAM_RESEND_COALESCE_GAP) {
+			end_missing = _find_packet (frame, next_missing, to, TRUE);
+			n_missing_packets += end_missing - next_missing;
+			next_missing = _find_packet (frame, end_missing, to, FALSE);
+		}
+
+		if (frame->n_packet_resend_requests + n_missing_packets >
+		    (frame->n_packets * thread_data->packet_request_ratio)) {
+			frame->n_packet_resend_requests += n_missing_packets;
+
+			arv_info_stream_thread ("[GvStream::missing_packet_check]"
+						 " Maximum number of requests "
+						 "reached at dt = %" G_GINT64_FORMAT
+						 ", n_packet_requests = %u (%u packets/frame), frame_id = %"
+						 G_GUINT64_FORMAT,
+						 time_us - frame->first_packet_time_us,
+						 frame->n_packet_resend_requests, frame->n_packets,
+						 frame->frame_id);
+
+			thread_data->n_resend_ratio_reached++;
+			frame->resend_ratio_reached = TRUE;
+
+			return FALSE;
+		}
+
+		/* Throttled requests are still queued, in order to be retried after the resend timeout */
+		range.throttled = thread_data->gv_device != NULL &&
+			!arv_gv_device_consume_packet_resend_budget (thread_data->gv_device,
+								     (guint64) n_missing_packets *
+								     thread_data->scps_packet_size,
+								     time_us);
+
+		if (range.throttled) {
+			arv_debug_stream_thread ("[GvStream::missing_packet_check]"
+					       " Resend request postponed at dt = %" G_GINT64_FORMAT
+					       ", packets %u to %u (%u packets/frame)",
+					       time_us - frame->first_packet_time_us,
+					       first_missing, end_missing - 1, frame->n_packets);
+
+			thread_data->n_throttled_resend_requests++;
+		} else {
+			arv_debug_stream_thread ("[GvStream::missing_packet_check]"
+					       " Resend request at dt = %" G_GINT64_FORMAT
+					       ", packets %u to %u (%u packets/frame)",
+					       time_us - frame->first_packet_time_us,
+					       first_missing, end_missing - 1, frame->n_packets);
+
+			if (!frame->resend_requested) {
+				ARV_TRACE_FIRST_RESEND (frame->frame_id, first_missing, time_us);
+				frame->resend_requested = TRUE;
+			}
+
+			_send_packet_request (thread_data,
+					      frame->frame_id,
+					      first_missing,
+					      end_missing - 1,
+					      frame->extended_ids);
+
+			thread_data->n_resend_requests += n_missing_packets;
+			frame->n_requested_packets += n_missing_packets;
+		}
+
+		range.first_packet = first_missing;
+		range.last_packet = end_missing - 1;
+		range.time_us = time_us;
+		g_array_append_val (frame->resend_ranges, range);
+	}
+
+	return TRUE;
+}
+
+/* Resend timeout, derived from the measured round trip time of the resend requests like a TCP retransmission timeout,
+ * and bounded by the packet-timeout property */
+
+static guint64
+_get_resend_timeout (ArvGvStreamThreadData *thread_data)
+{
+	if (!thread_data->adaptive_packet_timeout || thread_data->resend_rtt_us == 0)
+		return thread_data->packet_timeout_us;
+
+	return MIN (MAX (thread_data->resend_rtt_us + 4 * thread_data->resend_rtt_var_us,
+			 ARV_GV_STREAM_RESEND_TIMEOUT_US_MIN),
+		    thread_data->packet_timeout_us);
+}
+
+static void
+_update_resend_rtt (ArvGvStreamThreadData *thread_data, guint64 rtt_us)
+{
+	if (thread_data->resend_rtt_us == 0) {
+		thread_data->resend_rtt_us = rtt_us;
+		thread_data->resend_rtt_var_us = rtt_us / 2;
+	} else {
+		guint64 delta_us = thread_data->resend_rtt_us > rtt_us ?
+			thread_data->resend_rtt_us - rtt_us :
+			rtt_us - thread_data->resend_rtt_us;
+
+		thread_data->resend_rtt_var_us = (3 * thread_data->resend_rtt_var_us + delta_us) / 4;
+		thread_data->resend_rtt_us = (7 * thread_data->resend_rtt_us + rtt_us) / 8;
+	}
+}
+
+/* New gaps are only searched above n_checked_packets, and as all the requests share the same timeout, resend_ranges is
+ * a queue sorted by deadline, where only the expired requests at its head have to be looked at. */
+
+static void
+_missing_packet_check (ArvGvStreamThreadData *thread_data,
+		       ArvGvStreamFrameData *frame,
+		       guint32 packet_id,
+		       guint64 time_us)
+{
+	guint64 resend_timeout_us;
+	guint n_expired_ranges;
+	guint n_ranges;
+
+	if (thread_data->packet_resend == ARV_GV_STREAM_PACKET_RESEND_NEVER ||
+	    frame->error_packet_received ||
+	    frame->resend_ratio_reached)
+		return;
+
+	if ((int) (frame->n_packets * thread_data->packet_request_ratio) <= 0)
+		return;
+
+	if (packet_id >= frame->n_packets)
+		return;
+
+	/* Renew the expired requests for the packets still missing */
+	resend_timeout_us = _get_resend_timeout (thread_data);
+	n_ranges = frame->resend_ranges->len;
+	for (n_expired_ranges = 0; n_expired_ranges < n_ranges; n_expired_ranges++) {
+		ArvGvStreamResendRange range = g_array_index (frame->resend_ranges, ArvGvStreamResendRange,
+							      n_expired_ranges);
+
+		if (time_us - range.time_us <= resend_timeout_us)
+			break;
+
+		if (!_request_missing_packets (thread_data, frame,
+					       MAX ((gint64) range.first_packet, frame->last_valid_packet + 1),
+					       range.last_packet + 1, time_us))
+			return;
+	}
+
+	if (n_expired_ranges > 0)
+		g_array_remove_range (frame->resend_ranges, 0, n_expired_ranges);
+
+	/* Request the packets missing before the current one, which were never requested */
+	if (packet_id + 1 > frame->n_checked_packets) {
+		if (!_request_missing_packets (thread_data, frame,
+					       MAX ((gint64) frame->n_checked_packets, frame->last_valid_packet + 1),
+					       packet_id + 1, time_us))
+			return;
+
+		frame->n_checked_packets = packet_id + 1;
+	}
+}
+
+/* Cheap enough to be always on: two system calls per second */
+
+static void
+_sample_thread_health (ArvGvStreamThreadData *thread_data)
+{
+	gint64 time_us = g_get_monotonic_time ();
+
+	if (time_us - thread_data->health_sample_time_us < ARV_GV_STREAM_HEALTH_SAMPLING_PERIOD_US)
+		return;
+
+#ifdef RUSAGE_THREAD
+	{
+		struct rusage usage;
+
+		if (getrusage (RUSAGE_THREAD, &usage) == 0) {
+			guint64 cpu_time_us;
+
+			cpu_time_us = (guint64) (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000 +
+				usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+			if (thread_data->health_sample_time_us > 0)
+				thread_data->thread_cpu_percent = 100.0 *
+					(double) (cpu_time_us - thread_data->health_sample_cpu_time_us) /
+					(double) (time_us - thread_data->health_sample_time_us);
+			thread_data->health_sample_cpu_time_us = cpu_time_us;
+		}
+	}
+#endif
+
+#ifdef SO_MEMINFO
+	if (thread_data->socket != NULL) {
+		guint32 meminfo[SK_MEMINFO_VARS];
+		socklen_t length = sizeof (meminfo);
+
+		if (getsockopt (g_socket_get_fd (thread_data->socket), SOL_SOCKET, SO_MEMINFO,
+				meminfo, &length) == 0) {
+			thread_data->socket_buffer_fill = meminfo[SK_MEMINFO_RMEM_ALLOC];
+			thread_data->socket_buffer_capacity = meminfo[SK_MEMINFO_RCVBUF];
+			if (length > SK_MEMINFO_DROPS * sizeof (guint32))
+				thread_data->n_socket_drops = meminfo[SK_MEMINFO_DROPS];
+		}
+	}
+#endif
+
+	_adapt_socket_buffer (thread_data);
+
+	thread_data->health_sample_time_us = time_us;
+}
+
+static void
+_flush_frames (ArvGvStreamThreadData *thread_data)
+{
+	while (thread_data->n_frames > 0) {
+		_get_frame (thread_data, 0)->buffer->priv->status = ARV_BUFFER_STATUS_ABORTED;
+		_close_first_frame (thread_data);
+	}
+}
+
+/* Flushes the open frames after a pause of the stream, the first packet of the next acquisition giving the new frame
+ * id reference. Returns TRUE while the stream is paused, the incoming packets being dropped. */
+
+static gboolean
+_check_pause (ArvGvStreamThreadData *thread_data)
+{
+	guint n_pauses = arv_stream_get_n_pauses (thread_data->stream);
+
+	if (G_UNLIKELY (n_pauses != thread_data->n_pauses)) {
+		arv_info_stream_thread ("[GvStream::check_pause] Flush %u frame[s]", thread_data->n_frames);
+		_flush_frames (thread_data);
+		thread_data->n_pauses = n_pauses;
+		thread_data->first_packet = TRUE;
+		thread_data->last_closed_frame_valid = FALSE;
+	}
+
+	return arv_stream_is_paused (thread_data->stream);
+}
+
+static void
+_check_frame_completion (ArvGvStreamThreadData *thread_data,
+			 guint64 time_us,
+			 ArvGvStreamFrameData *current_frame)
+{
+	ArvGvStreamFrameData *frame;
+	gboolean can_close_frame = TRUE;
+	guint i;
+
+	_sample_thread_health (thread_data);
+
+	if (G_UNLIKELY (_check_pause (thread_data)))
+		return;
+
+	/* Frames can only be closed in list order, can_close_frame implies i == 0 */
+	for (i = 0; i < thread_data->n_frames;) {
+		frame = _get_frame (thread_data, i);
+
+		if (can_close_frame &&
+		    _is_waiting_for_late_frame (thread_data, frame, time_us))
+			can_close_frame = FALSE;
+
+		if (can_close_frame &&
+		    thread_data->packet_resend == ARV_GV_STREAM_PACKET_RESEND_NEVER &&
+		    i + 1 < thread_data->n_frames) {
+			frame->buffer->priv->status = ARV_BUFFER_STATUS_MISSING_PACKETS;
+			arv_info_stream_thread ("[GvStream::check_frame_completion] Incomplete frame %" G_GUINT64_FORMAT,
+						 frame->frame_id);
+			_close_first_frame (thread_data);
+			continue;
+		}
+
+		if (can_close_frame &&
+		    frame->last_valid_packet == frame->n_packets - 1) {
+			frame->buffer->priv->status = ARV_BUFFER_STATUS_SUCCESS;
+			arv_debug_stream_thread ("[GvStream::check_frame_completion] Completed frame %" G_GUINT64_FORMAT,
+					       frame->frame_id);
+			_close_first_frame (thread_data);
+			continue;
+		}
+
+		/* The trailer does not carry anything needed for the buffer delivery */
+		if (can_close_frame &&
+		    thread_data->early_completion &&
+		    !frame->is_size_unknown &&
+		    frame->last_valid_packet == frame->n_packets - 2) {
+			frame->buffer->priv->status = ARV_BUFFER_STATUS_SUCCESS;
+			arv_debug_stream_thread ("[GvStream::check_frame_completion] Completed frame %" G_GUINT64_FORMAT
+						 " before trailer", frame->frame_id);
+			thread_data->early_completion_frame_valid = TRUE;
+			thread_data->early_completion_frame_id = frame->frame_id;
+			thread_data->n_early_completions++;
+			_close_first_frame (thread_data);
+			continue;
+		}
+
+		if (can_close_frame &&
+		    time_us - frame->last_packet_time_us >= thread_data->frame_retention_us) {
+			frame->buffer->priv->status = ARV_BUFFER_STATUS_TIMEOUT;
+			arv_warning_stream_thread ("[GvStream::check_frame_completion] Timeout for frame %"
+						   G_GUINT64_FORMAT " at dt = %" G_GUINT64_FORMAT,
+						   frame->frame_id, time_us - frame->first_packet_time_us);
+#if 0
+			if (arv_debug_check (&arv_debug_category_stream_thread, ARV_DEBUG_LEVEL_LOG)) {
+				int i;
+				arv_debug_stream_thread ("frame_id          = %Lu", frame->frame_id);
+				arv_debug_stream_thread ("last_valid_packet = %d", frame->last_valid_packet);
+				for (i = 0; i < frame->n_packets; i++) {
+					arv_debug_stream_thread ("%d - time = %Lu%s", i,
+							       _get_resend_time (frame, i),
+							       _is_packet_received (frame, i) ? " - OK" : "");
+				}
+			}
+#endif
+			_close_first_frame (thread_data);
+			continue;
+		}
+
+		can_close_frame = FALSE;
+
+		if (frame != current_frame &&
+		    time_us - frame->last_packet_time_us >= thread_data->packet_timeout_us) {
+			/* The end of a variable size payload is unknown, only the known gaps are requested */
+			if (!frame->is_size_unknown)
+				_missing_packet_check (thread_data, frame, frame->n_packets - 1, time_us);
+			else if (frame->n_checked_packets > 0)
+				_missing_packet_check (thread_data, frame, frame->n_checked_packets - 1, time_us);
+			i++;
+			continue;
+		}
+
+		i++;
+	}
+}
+
+/* Small payloads may be sent in a single packet, which is copied to a buffer and delivered directly, without going
+ * through the frame reassembly */
+
+static void
+_process_all_in_packet (ArvGvStreamThreadData *thread_data,
+			const ArvGvspPacket *packet,
+			size_t packet_size,
+			guint64 frame_id,
+			gboolean extended_ids,
+			guint64 time_us)
+{
+	ArvBuffer *buffer;
+	size_t data_size;
+	size_t payload_size;
+	gint64 frame_id_inc;
+
+	data_size = arv_gvsp_packet_get_data_size (packet, packet_size);
+
+	if (data_size < ARV_GVSP_ALL_IN_IMAGE_HEADER_SIZE ||
+	    arv_gvsp_packet_get_buffer_payload_type (packet) != ARV_BUFFER_PAYLOAD_TYPE_IMAGE) {
+		thread_data->n_ignored_packets++;
+		return;
+	}
+
+	frame_id_inc = _get_frame_id_inc (thread_data, frame_id, extended_ids);
+	if (frame_id_inc < 1  && frame_id_inc > -ARV_GV_STREAM_DISCARD_LATE_FRAME_THRESHOLD) {
+		arv_info_stream_thread ("[GvStream::process_all_in_packet] Discard late frame %" G_GUINT64_FORMAT
+					" (last: %" G_GUINT64_FORMAT ")",
+					frame_id, thread_data->last_frame_id);
+		arv_event_ring_record (thread_data->event_ring, ARV_EVENT_RING_EVENT_LATE_FRAME, frame_id, 0, 0);
+		return;
+	}
+
+	buffer = _pop_input_buffer (thread_data);
+	if (buffer == NULL) {
+		thread_data->n_underruns++;
+		arv_event_ring_record (thread_data->event_ring, ARV_EVENT_RING_EVENT_UNDERRUN, frame_id, 0, 0);
+		return;
+	}
+
+	thread_data->last_frame_id = frame_id;
+
+	if (frame_id_inc > 1) {
+		thread_data->n_missing_frames++;
+		arv_debug_stream_thread ("[GvStream::process_all_in_packet] Missed %" G_GINT64_FORMAT
+					 " frame(s) before %" G_GUINT64_FORMAT, frame_id_inc - 1, frame_id);
+		arv_event_ring_record (thread_data->event_ring, ARV_EVENT_RING_EVENT_MISSED_FRAMES, frame_id, 0, frame_id_inc - 1);
+	}
+
+	_update_socket (thread_data, buffer);
+
+	if (thread_data->callback != NULL)
+		thread_data->callback (thread_data->callback_data,
+				       ARV_STREAM_CALLBACK_TYPE_START_BUFFER,
+				       NULL);
+
+	ARV_TRACE_LEADER_RECEIVED (frame_id, time_us);
+	arv_event_ring_record (thread_data->event_ring, ARV_EVENT_RING_EVENT_LEADER, frame_id, 0, 0);
+
+	buffer->priv->payload_type = ARV_BUFFER_PAYLOAD_TYPE_IMAGE;
+	buffer->priv->frame_id = frame_id;
+	buffer->priv->chunk_endianness = G_BIG_ENDIAN;
+	buffer->priv->ready_offset = 0;
+	buffer->priv->ready_size = 0;
+	buffer->priv->has_chunk_index = FALSE;
+	buffer->priv->has_checksum = FALSE;
+	buffer->priv->n_parts = 0;
+	buffer->priv->x_offset = arv_gvsp_packet_get_x_offset (packet);
+	buffer->priv->y_offset = arv_gvsp_packet_get_y_offset (packet);
+	buffer->priv->width = arv_gvsp_packet_get_width (packet);
+	buffer->priv->height = arv_gvsp_packet_get_height (packet);
+	buffer->priv->pixel_format = arv_gvsp_packet_get_pixel_format (packet);
+
+	_set_buffer_timestamps (thread_data, buffer, packet, FALSE, time_us);
+	buffer->priv->trailer_hardware_timestamp_ns = thread_data->packet_hardware_time_ns;
+
+	payload_size = data_size - ARV_GVSP_ALL_IN_IMAGE_HEADER_SIZE;
+	if (payload_size > buffer->priv->size) {
+		arv_info_stream_thread ("[GvStream::process_all_in_packet] %" G_GSIZE_FORMAT " unexpected bytes"
+					" for frame %" G_GUINT64_FORMAT,
+					payload_size - buffer->priv->size, frame_id);
+		thread_data->n_size_mismatch_errors++;
+		buffer->priv->status = ARV_BUFFER_STATUS_SIZE_MISMATCH;
+		thread_data->n_failures++;
+	} else {
+		_copy_block (thread_data, buffer->priv->data,
+			     (const guint8 *) arv_gvsp_packet_get_data (packet) + ARV_GVSP_ALL_IN_IMAGE_HEADER_SIZE,
+			     payload_size);
+		buffer->priv->received_size = buffer->priv->size;
+		thread_data->n_copied_bytes += payload_size;
+		if (thread_data->checksum) {
+			buffer->priv->checksum = arv_crc32c (0, buffer->priv->data, buffer->priv->size);
+			buffer->priv->has_checksum = TRUE;
+		}
+		buffer->priv->status = ARV_BUFFER_STATUS_SUCCESS;
+		thread_data->n_completed_buffers++;
+	}
+
+	ARV_TRACE_FRAME_CLOSED (frame_id, buffer->priv->status, g_get_monotonic_time ());
+	arv_event_ring_record (thread_data->event_ring, ARV_EVENT_RING_EVENT_FRAME_CLOSED, frame_id, 0, buffer->priv->status);
+
+	arv_stream_push_output_buffer (thread_data->stream, buffer);
+	if (thread_data->callback != NULL)
+		thread_data->callback (thread_data->callback_data,
+				       ARV_STREAM_CALLBACK_TYPE_BUFFER_DONE,
+				       buffer);
+
+	if (thread_data->statistic_count > 5)
+		arv_statistic_fill (thread_data->statistic, 0, 0, frame_id);
+	else
+		thread_data->statistic_count++;
+}
+
+static ArvGvStreamFrameData *
+_process_packet (ArvGvStreamThreadData *thread_data, const ArvGvspPacket *packet, size_t packet_size, guint64 time_us)
+
+{
+	ArvGvStreamFrameData *frame;
+	guint32 packet_id;
+	guint64 frame_id;
+	gboolean extended_ids;
+	int i;
+
+	thread_data->n_received_packets++;
+
+	if (G_UNLIKELY (_check_pause (thread_data))) {
+		thread_data->n_ignored_packets++;
+		return NULL;
+	}
+
+	if (thread_data->recorder != NULL)
+		arv_packet_recorder_write (thread_data->recorder, time_us, packet, packet_size);
+
+	extended_ids = arv_gvsp_packet_has_extended_ids (packet);
+	frame_id = arv_gvsp_packet_get_frame_id (packet);
+	packet_id = arv_gvsp_packet_get_packet_id (packet);
+
+	if (thread_data->first_packet) {
+		thread_data->last_frame_id = frame_id - 1;
+		thread_data->first_packet = FALSE;
+	}
+
+	/* A device sending all-in packets doesn't use the reassembly for the same stream, no frame order is at stake */
+	if (arv_gvsp_packet_get_content_type (packet) == ARV_GVSP_CONTENT_TYPE_ALL_IN &&
+	    !arv_gvsp_packet_type_is_error (arv_gvsp_packet_get_packet_type (packet))) {
+		_process_all_in_packet (thread_data, packet, packet_size, frame_id, extended_ids, time_us);
+		return NULL;
+	}
+
+	frame = _find_frame_data (thread_data, packet, packet_size, frame_id, packet_id, extended_ids, packet_size, time_us);
+
+	if (frame != NULL) {
+		ArvGvspPacketType packet_type = arv_gvsp_packet_get_packet_type (packet);
+
+		if (arv_gvsp_packet_type_is_error (packet_type)) {
+			arv_info_stream_thread ("[GvStream::process_packet]"
+						 " Error packet at dt = %" G_GINT64_FORMAT ", packet id = %u"
+						 " frame id = %" G_GUINT64_FORMAT,
+						 time_us - frame->first_packet_time_us,
+						 packet_id, frame->frame_id);
+			arv_gvsp_packet_debug (packet, packet_size, ARV_DEBUG_LEVEL_INFO);
+			arv_event_ring_record (thread_data->event_ring, ARV_EVENT_RING_EVENT_ERROR_PACKET, frame->frame_id, packet_id,
+					       packet_type);
+			frame->error_packet_received = TRUE;
+
+			thread_data->n_error_packets++;
+		} else if (packet_id < frame->n_packets &&
+		           _is_packet_received (frame, packet_id)) {
+			/* Ignore duplicate packet */
+			thread_data->n_duplicated_packets++;
+			arv_debug_stream_thread ("[GvStream::process_packet] Duplicated packet %d for frame %" G_GUINT64_FORMAT,
+						 packet_id, frame->frame_id);
+			arv_event_ring_record (thread_data->event_ring, ARV_EVENT_RING_EVENT_DUPLICATED_PACKET, frame->frame_id, packet_id, 0);
+			arv_gvsp_packet_debug (packet, packet_size, ARV_DEBUG_LEVEL_DEBUG);
+		} else {
+			ArvGvspContentType content_type;
+
+			if (packet_id < frame->n_packets) {
+				_set_packet_received (frame, packet_id);
+			}
+
+			/* Keep track of last packet of a continuous block starting from packet 0 */
+			if (packet_id == frame->last_valid_packet + 1)
+				frame->last_valid_packet = _find_packet (frame, packet_id, frame->n_packets, FALSE) - 1;
+
+			if (frame->resend_ranges->len > 0) {
+				guint64 resend_time_us = _get_resend_time (frame, packet_id);
+
+				if (resend_time_us > 0 && time_us >= resend_time_us)
+					_update_resend_rtt (thread_data, time_us - resend_time_us);
+			}
+
+			content_type = arv_gvsp_packet_get_content_type (packet);
+
+			arv_gvsp_packet_debug (packet, packet_size,
+					       content_type == ARV_GVSP_CONTENT_TYPE_DATA_BLOCK ||
+					       content_type == ARV_GVSP_CONTENT_TYPE_MULTIPART ?
+					       ARV_DEBUG_LEVEL_TRACE :
+					       ARV_DEBUG_LEVEL_DEBUG);
+
+			switch (content_type) {
+				case ARV_GVSP_CONTENT_TYPE_DATA_LEADER:
+					_process_data_leader (thread_data, frame, packet, packet_id, packet_size, time_us);
+					break;
+				case ARV_GVSP_CONTENT_TYPE_MULTIPART:
+					_process_multipart_block (thread_data, frame, packet, packet_id,
+								  packet_size);
+					break;
+				case ARV_GVSP_CONTENT_TYPE_DATA_BLOCK:
+					_process_data_block (thread_data, frame, packet, packet_id,
+							     packet_size);
+					break;
+				case ARV_GVSP_CONTENT_TYPE_DATA_TRAILER:
+					_process_data_trailer (thread_data, frame, packet_id);
+					break;
+				default:
+					thread_data->n_ignored_packets++;
+					break;
+			}
+
+			/* Contiguous data blocks following the leader */
+			if (thread_data->callback != NULL &&
+			    frame->last_valid_packet > 0 &&
+			    !frame->unpack &&
+			    !frame->crop.enabled &&
+			    frame->buffer->priv->payload_type != ARV_BUFFER_PAYLOAD_TYPE_MULTIPART &&
+			    frame->buffer->priv->status == ARV_BUFFER_STATUS_FILLING) {
+				size_t block_size = thread_data->scps_packet_size -
+					(frame->extended_ids ?
+					 ARV_GVSP_PACKET_EXTENDED_PROTOCOL_OVERHEAD :
+					 ARV_GVSP_PACKET_PROTOCOL_OVERHEAD);
+
+				arv_stream_update_ready_region (thread_data->stream, frame->buffer,
+								MIN ((size_t) frame->last_valid_packet * block_size,
+								     frame->buffer->priv->size));
+			}
+
+			_missing_packet_check (thread_data, frame, packet_id, time_us);
+		}
+	} else
+		thread_data->n_ignored_packets++;
+
+	return frame;
+}
+
+#ifndef G_OS_WIN32
+
+static void
+_zero_copy_predict (ArvGvStreamThreadData *thread_data, ArvGvStreamFrameData *frame, const ArvGvspPacket *packet)
+{
+	guint32 packet_id;
+
+	thread_data->zero_copy_frame = NULL;
+
+	/* The multipart data blocks have a part header, and are stored at the offset of their part */
+	if (frame == NULL ||
+	    frame->buffer->priv->status != ARV_BUFFER_STATUS_FILLING ||
+	    frame->buffer->priv->payload_type == ARV_BUFFER_PAYLOAD_TYPE_MULTIPART ||
+	    frame->unpack || frame->crop.enabled)
+		return;
+
+	/* Packets are usually received in order, expect the next data block */
+	packet_id = arv_gvsp_packet_get_packet_id (packet) + 1;
+	if (packet_id < 1 || packet_id > frame->n_packets - 2 ||
+	    _is_packet_received (frame, packet_id))
+		return;
+
+	thread_data->zero_copy_frame = frame;
+	thread_data->zero_copy_packet_id = packet_id;
+}
+
+static size_t
+_zero_copy_receive (ArvGvStreamThreadData *thread_data, ArvGvspPacket *packet, guint64 *system_time_ns)
+{
+	ArvGvStreamFrameData *frame = thread_data->zero_copy_frame;
+	char control[ARV_GV_STREAM_CONTROL_BUFFER_SIZE];
+	struct iovec iovecs[3];
+	struct msghdr message;
+	size_t header_size = 0;
+	size_t block_size = 0;
+	ptrdiff_t block_offset = 0;
+	ssize_t read_count;
+
+	memset (&message, 0, sizeof (message));
+	message.msg_iov = iovecs;
+	message.msg_control = control;
+	message.msg_controllen = sizeof (control);
+
+	if (frame != NULL) {
+		block_size = thread_data->scps_packet_size - (frame->extended_ids ?
+							       ARV_GVSP_PACKET_EXTENDED_PROTOCOL_OVERHEAD :
+							       ARV_GVSP_PACKET_PROTOCOL_OVERHEAD);
+		block_offset = (thread_data->zero_copy_packet_id - 1) * block_size;
+
+		/* A prediction outside of the buffer is never used, whatever its origin */
+		if ((size_t) block_offset >= frame->buffer->priv->size) {
+			frame = NULL;
+			block_size = 0;
+			block_offset = 0;
+		} else if (block_offset + block_size > frame->buffer->priv->size)
+			block_size = frame->buffer->priv->size - block_offset;
+	}
+
+	if (frame != NULL) {
+		/* Scatter the predicted data block: header in the scratch buffer, payload directly in the frame
+		 * buffer, and anything unexpected after the header, at the same offset as in a contiguous
+		 * reception */
+		header_size = sizeof (ArvGvspPacket) +
+			(frame->extended_ids ? sizeof (ArvGvspExtendedHeader) : sizeof (ArvGvspHeader));
+
+		iovecs[0].iov_base = packet;
+		iovecs[0].iov_len = header_size;
+		iovecs[1].iov_base = ((char *) frame->buffer->priv->data) + block_offset;
+		iovecs[1].iov_len = block_size;
+		iovecs[2].iov_base = ((char *) packet) + header_size + block_size;
+		iovecs[2].iov_len = ARV_GV_STREAM_INCOMING_BUFFER_SIZE - header_size - block_size;
+		message.msg_iovlen = 3;
+	} else {
+		iovecs[0].iov_base = packet;
+		iovecs[0].iov_len = ARV_GV_STREAM_INCOMING_BUFFER_SIZE;
+		message.msg_iovlen = 1;
+	}
+
+	read_count = recvmsg (g_socket_get_fd (thread_data->socket), &message, MSG_DONTWAIT);
+	if (read_count <= 0)
+		return 0;
+
+	*system_time_ns = _get_message_system_time_ns (thread_data, &message);
+
+	if (frame == NULL || read_count <= header_size)
+		return read_count;
+
+	if (read_count - header_size <= block_size &&
+	    !arv_gvsp_packet_type_is_error (arv_gvsp_packet_get_packet_type (packet)) &&
+	    arv_gvsp_packet_has_extended_ids (packet) == frame->extended_ids &&
+	    arv_gvsp_packet_get_content_type (packet) == ARV_GVSP_CONTENT_TYPE_DATA_BLOCK &&
+	    arv_gvsp_packet_get_frame_id (packet) == frame->frame_id &&
+	    arv_gvsp_packet_get_packet_id (packet) == thread_data->zero_copy_packet_id) {
+		thread_data->zero_copy_hit = TRUE;
+	} else {
+		/* Wrong prediction. The predicted area is not filled yet, just move the payload back to the
+		 * scratch buffer and use the copy path */
+		memcpy (((char *) packet) + header_size, iovecs[1].iov_base, MIN (read_count - header_size, block_size));
+	}
+
+	return read_count;
+}
+
+#endif
+
+#ifndef G_OS_WIN32
+
+#if defined (__linux__) && !defined (SO_PREFER_BUSY_POLL)
+#define SO_PREFER_BUSY_POLL	69
+#endif
+
+/* Lets the socket receives poll the network device queue, instead of waiting for its interrupt. Raising the busy
+ * poll time above net.core.busy_read requires CAP_NET_ADMIN. */
+
+static void
+_enable_busy_poll (ArvGvStreamThreadData *thread_data, int fd)
+{
+#ifdef SO_BUSY_POLL
+	int busy_poll_us = ARV_GV_STREAM_BUSY_POLL_US;
+	int enable = 1;
+
+	if (setsockopt (fd, SOL_SOCKET, SO_BUSY_POLL, &busy_poll_us, sizeof (busy_poll_us)) != 0)
+		arv_info_stream_thread ("[GvStream::enable_busy_poll] SO_BUSY_POLL not available (%s)",
+					strerror (errno));
+#ifdef SO_PREFER_BUSY_POLL
+	if (setsockopt (fd, SOL_SOCKET, SO_PREFER_BUSY_POLL, &enable, sizeof (enable)) != 0)
+		arv_info_stream_thread ("[GvStream::enable_busy_poll] SO_PREFER_BUSY_POLL not available (%s)",
+					strerror (errno));
+#endif
+#else
+	arv_info_stream_thread ("[GvStream::enable_busy_poll] Busy polling not available");
+#endif
+}
+
+#endif
+
+/* Receives and processes one packet of the standard loop. The receive doesn't block in low latency mode. Returns
+ * FALSE if no packet was available. */
+
+static gboolean
+_loop_receive (ArvGvStreamThreadData *thread_data, ArvGvspPacket *packet,
+	       ArvGvStreamFrameData **frame, guint64 *time_us)
+{
+	gssize read_count;
+	guint64 system_time_ns = 0;
+
+#ifndef G_OS_WIN32
+	if (thread_data->use_zero_copy) {
+		read_count = _zero_copy_receive (thread_data, packet, &system_time_ns);
+		*time_us = _get_packet_time_us (thread_data, system_time_ns);
+		if (read_count > 0) {
+			*frame = _process_packet (thread_data, packet, read_count, *time_us);
+			thread_data->zero_copy_hit = FALSE;
+			_zero_copy_predict (thread_data, *frame, packet);
+		} else
+			*frame = NULL;
+
+		return read_count > 0;
+	} else if (thread_data->use_kernel_timestamps || thread_data->use_hardware_timestamps) {
+		read_count = _timestamped_receive (thread_data, packet, &system_time_ns);
+		*time_us = _get_packet_time_us (thread_data, system_time_ns);
+
+		if (thread_data->use_low_latency && read_count <= 0) {
+			*frame = NULL;
+			return FALSE;
+		}
+
+		*frame = _process_packet (thread_data, packet, read_count, *time_us);
+
+		return read_count > 0;
+	}
+#endif
+
+	if (thread_data->use_low_latency) {
+		read_count = g_socket_receive_with_blocking (thread_data->socket, (char *) packet,
+							     ARV_GV_STREAM_INCOMING_BUFFER_SIZE, FALSE, NULL, NULL);
+		*time_us = _get_packet_time_us (thread_data, 0);
+		if (read_count <= 0) {
+			*frame = NULL;
+			return FALSE;
+		}
+	} else {
+		read_count = g_socket_receive (thread_data->socket, (char *) packet,
+					       ARV_GV_STREAM_INCOMING_BUFFER_SIZE, NULL, NULL);
+		*time_us = _get_packet_time_us (thread_data, 0);
+	}
+
+	*frame = _process_packet (thread_data, packet, read_count, *time_us);
+
+	return read_count > 0;
+}
+
+static void
+_loop (ArvGvStreamThreadData *thread_data)
+{
+	ArvGvStreamFrameData *frame;
+	ArvGvspPacket *packet;
+	GPollFD poll_fd[2];
+	guint64 time_us;
+	int timeout_ms;
+	gboolean use_poll;
+
+	arv_info_stream ("[GvStream::loop] Standard socket method%s%s",
+			 thread_data->use_zero_copy ? " (zero copy)" : "",
+			 thread_data->use_low_latency ? " (low latency)" : "");
+
+#ifndef G_OS_WIN32
+	if (thread_data->use_low_latency)
+		_enable_busy_poll (thread_data, g_socket_get_fd (thread_data->socket));
+#endif
+
+#ifndef G_OS_WIN32
+	_enable_kernel_timestamps (thread_data, g_socket_get_fd (thread_data->socket));
+#endif
+#if ARAVIS_HAS_HARDWARE_TIMESTAMPS
+	if (thread_data->use_hardware_timestamps)
+		thread_data->use_hardware_timestamps = _enable_hardware_timestamps (thread_data,
+										    g_socket_get_fd (thread_data->socket),
+										    FALSE);
+#endif
+
+	poll_fd[0].fd = g_socket_get_fd (thread_data->socket);
+	poll_fd[0].events =  G_IO_IN;
+	poll_fd[0].revents = 0;
+
+	arv_gpollfd_prepare_all(poll_fd,1);
+
+	packet = g_malloc0 (ARV_GV_STREAM_INCOMING_BUFFER_SIZE);
+
+	use_poll = g_cancellable_make_pollfd (thread_data->cancellable, &poll_fd[1]);
+
+	do {
+		int n_events;
+		int errsv;
+
+		arv_stream_update_thread_placement (thread_data->stream);
+
+		if (thread_data->n_frames > 0)
+			timeout_ms = thread_data->packet_timeout_us / 1000;
+		else
+			timeout_ms = ARV_GV_STREAM_POLL_TIMEOUT_US / 1000;
+
+		do {
+			poll_fd[0].revents = 0;
+			n_events = g_poll (poll_fd, use_poll ?  2 : 1, timeout_ms);
+			errsv = errno;
+
+		} while (n_events < 0 && errsv == EINTR);
+
+		if (poll_fd[0].revents != 0) {
+			gboolean has_packet;
+			guint n_drained;
+
+			arv_gpollfd_clear_one (&poll_fd[0], thread_data->socket);
+
+			has_packet = _loop_receive (thread_data, packet, &frame, &time_us);
+
+			/* Drain the socket before paying for another poll wakeup */
+			for (n_drained = 0;
+			     thread_data->use_low_latency && has_packet && n_drained < ARV_GV_STREAM_LOW_LATENCY_DRAIN_MAX;
+			     n_drained++) {
+				_check_frame_completion (thread_data, time_us, frame);
+
+				has_packet = _loop_receive (thread_data, packet, &frame, &time_us);
+				if (has_packet)
+					thread_data->n_drained_packets++;
+			}
+		} else {
+			time_us = _get_time_us (thread_data);
+			frame = NULL;
+		}
+
+		_check_frame_completion (thread_data, time_us, frame);
+
+	} while (!g_cancellable_is_cancelled (thread_data->cancellable));
+
+	if (use_poll)
+		g_cancellable_release_fd (thread_data->cancellable);
+
+	arv_gpollfd_finish_all (poll_fd,1);
+	g_free (packet);
+}
+
+#if ARAVIS_HAS_RECVMMSG
+
+static void
+_batch_loop (ArvGvStreamThreadData *thread_data)
+{
+	ArvGvStreamFrameData *frame;
+	struct mmsghdr *messages;
+	struct iovec *iovecs;
+	char *packets;
+	char *controls;
+	GPollFD poll_fd[2];
+	guint64 time_us;
+	int timeout_ms;
+	int fd;
+	int i;
+	gboolean use_poll;
+	gboolean use_control;
+
+	arv_info_stream ("[GvStream::loop] Batch socket method (%d packets per call)", ARV_GV_STREAM_BATCH_SIZE);
+
+	fd = g_socket_get_fd (thread_data->socket);
+
+	poll_fd[0].fd = fd;
+	poll_fd[0].events =  G_IO_IN;
+	poll_fd[0].revents = 0;
 
-					if (frame->n_packet_resend_requests + n_missing_packets >
-					    (frame->n_packets * thread_data->packet_request_ratio)) {
-						frame->n_packet_resend_requests += n_missing_packets;
+	arv_gpollfd_prepare_all(poll_fd,1);
 
-						arv_info_stream_thread ("[GvStream::missing_packet_check]"
-									 " Maximum number of requests "
-									 "reached at dt = %" G_GINT64_FORMAT
-									 ", n_packet_requests = %u (%u packets/frame), frame_id = %"
-									 G_GUINT64_FORMAT,
-									 time_us - frame->first_packet_time_us,
-									 frame->n_packet_resend_requests, frame->n_packets,
-									 frame->frame_id);
+	_enable_kernel_timestamps (thread_data, fd);
+#if ARAVIS_HAS_HARDWARE_TIMESTAMPS
+	if (thread_data->use_hardware_timestamps)
+		thread_data->use_hardware_timestamps = _enable_hardware_timestamps (thread_data, fd, FALSE);
+#endif
+	use_control = thread_data->use_kernel_timestamps || thread_data->use_hardware_timestamps;
+
+	packets = g_malloc (ARV_GV_STREAM_BATCH_SIZE * ARV_GV_STREAM_INCOMING_BUFFER_SIZE);
+	controls = g_malloc (ARV_GV_STREAM_BATCH_SIZE * ARV_GV_STREAM_CONTROL_BUFFER_SIZE);
+	messages = g_new0 (struct mmsghdr, ARV_GV_STREAM_BATCH_SIZE);
+	iovecs = g_new0 (struct iovec, ARV_GV_STREAM_BATCH_SIZE);
+
+	for (i = 0; i < ARV_GV_STREAM_BATCH_SIZE; i++) {
+		iovecs[i].iov_base = packets + i * ARV_GV_STREAM_INCOMING_BUFFER_SIZE;
+		iovecs[i].iov_len = ARV_GV_STREAM_INCOMING_BUFFER_SIZE;
+		messages[i].msg_hdr.msg_iov = &iovecs[i];
+		messages[i].msg_hdr.msg_iovlen = 1;
+		if (use_control)
+			messages[i].msg_hdr.msg_control = controls + i * ARV_GV_STREAM_CONTROL_BUFFER_SIZE;
+	}
 
-						thread_data->n_resend_ratio_reached++;
-						frame->resend_ratio_reached = TRUE;
+	use_poll = g_cancellable_make_pollfd (thread_data->cancellable, &poll_fd[1]);
 
-						return;
-					}
+	do {
+		int n_events;
+		int n_packets;
+		int errsv;
+
+		arv_stream_update_thread_placement (thread_data->stream);
+
+		if (thread_data->n_frames > 0)
+			timeout_ms = thread_data->packet_timeout_us / 1000;
+		else
+			timeout_ms = ARV_GV_STREAM_POLL_TIMEOUT_US / 1000;
+
+		do {
+			poll_fd[0].revents = 0;
+			n_events = g_poll (poll_fd, use_poll ?  2 : 1, timeout_ms);
+			errsv = errno;
 
-					arv_debug_stream_thread ("[GvStream::missing_packet_check]"
-							       " Resend request at dt = %" G_GINT64_FORMAT
-							       ", packet id = %u (%u packets/frame)",
-							       time_us - frame->first_packet_time_us,
-							       packet_id, frame->n_packets);
+		} while (n_events < 0 && errsv == EINTR);
 
-					_send_packet_request (thread_data,
-							      frame->frame_id,
-							      first_missing,
-							      last_missing,
-							      frame->extended_ids);
+		n_packets = 0;
+		if (poll_fd[0].revents != 0) {
+			arv_gpollfd_clear_one (&poll_fd[0], thread_data->socket);
 
-					for (j = first_missing; j <= last_missing; j++)
-						frame->packet_data[j].time_us = time_us;
+			/* The control buffer length is updated by each reception */
+			if (use_control)
+				for (i = 0; i < ARV_GV_STREAM_BATCH_SIZE; i++)
+					messages[i].msg_hdr.msg_controllen = ARV_GV_STREAM_CONTROL_BUFFER_SIZE;
 
-					thread_data->n_resend_requests += n_missing_packets;
+			/* Drain up to ARV_GV_STREAM_BATCH_SIZE pending datagrams without blocking */
+			do {
+				n_packets = recvmmsg (fd, messages, ARV_GV_STREAM_BATCH_SIZE, MSG_DONTWAIT, NULL);
+				errsv = errno;
+			} while (n_packets < 0 && errsv == EINTR);
 
-					first_missing = -1;
-				}
+			if (n_packets < 0 && errsv != EAGAIN && errsv != EWOULDBLOCK)
+				arv_warning_stream_thread ("[GvStream::batch_loop] Packet reception error (%s)",
+							   strerror (errsv));
+		}
+
+		if (n_packets > 0) {
+			for (i = 0; i < n_packets; i++) {
+				time_us = _get_packet_time_us (thread_data, use_control ?
+							       _get_message_system_time_ns (thread_data,
+											    &messages[i].msg_hdr) :
+							       0);
+
+				frame = _process_packet (thread_data, iovecs[i].iov_base, messages[i].msg_len, time_us);
+
+				_check_frame_completion (thread_data, time_us, frame);
 			}
+		} else {
+			time_us = _get_time_us (thread_data);
+			_check_frame_completion (thread_data, time_us, NULL);
 		}
+
+	} while (!g_cancellable_is_cancelled (thread_data->cancellable));
+
+	if (use_poll)
+		g_cancellable_release_fd (thread_data->cancellable);
+
+	arv_gpollfd_finish_all (poll_fd,1);
+	g_free (iovecs);
+	g_free (messages);
+	g_free (controls);
+	g_free (packets);
+}
+
+#endif /* ARAVIS_HAS_RECVMMSG */
+
+
+#if ARAVIS_HAS_IO_URING
+
+static void
+_io_uring_arm_receive (struct io_uring *ring, int fd, struct msghdr *message)
+{
+	struct io_uring_sqe *sqe;
+
+	sqe = io_uring_get_sqe (ring);
+	io_uring_prep_recvmsg_multishot (sqe, fd, message, 0);
+	sqe->flags |= IOSQE_BUFFER_SELECT;
+	sqe->buf_group = ARV_GV_STREAM_IO_URING_BUFFER_GROUP;
+	io_uring_submit (ring);
+}
+
+/* A single multishot recvmsg submission keeps producing completions, one per datagram, in the buffers taken from a
+ * ring shared with the kernel. The buffers are given back to the ring once their packet is processed. Returns FALSE
+ * if io_uring multishot receives are not available, in order to fall back to the other methods. */
+
+static gboolean
+_io_uring_loop (ArvGvStreamThreadData *thread_data)
+{
+	struct io_uring ring;
+	struct io_uring_buf_ring *buffer_ring;
+	struct msghdr message;
+	guint64 time_us;
+	guint64 n_packets = 0;
+	char *buffers;
+	int buffer_mask;
+	int errsv;
+	int fd;
+	int i;
+	gboolean is_armed = FALSE;
+	gboolean is_supported = TRUE;
+	gboolean use_control;
+
+	errsv = -io_uring_queue_init (64, &ring, 0);
+	if (errsv != 0) {
+		arv_info_stream_thread ("[GvStream::loop] io_uring not available (%s)", strerror (errsv));
+		return FALSE;
+	}
+
+	buffer_ring = io_uring_setup_buf_ring (&ring, ARV_GV_STREAM_IO_URING_N_BUFFERS,
+					       ARV_GV_STREAM_IO_URING_BUFFER_GROUP, 0, &errsv);
+	if (buffer_ring == NULL) {
+		arv_info_stream_thread ("[GvStream::loop] io_uring buffer ring not available (%s)", strerror (-errsv));
+		io_uring_queue_exit (&ring);
+		return FALSE;
 	}
+
+	arv_info_stream ("[GvStream::loop] io_uring method (%d buffers)", ARV_GV_STREAM_IO_URING_N_BUFFERS);
+
+	fd = g_socket_get_fd (thread_data->socket);
+
+	_enable_kernel_timestamps (thread_data, fd);
+#if ARAVIS_HAS_HARDWARE_TIMESTAMPS
+	if (thread_data->use_hardware_timestamps)
+		thread_data->use_hardware_timestamps = _enable_hardware_timestamps (thread_data, fd, FALSE);
+#endif
+	use_control = thread_data->use_kernel_timestamps || thread_data->use_hardware_timestamps;
+
+	/* Only used by the kernel for the layout of each buffer: header, name, control, payload */
+	memset (&message, 0, sizeof (message));
+	message.msg_controllen = use_control ? ARV_GV_STREAM_CONTROL_BUFFER_SIZE : 0;
+
+	buffers = g_malloc (ARV_GV_STREAM_IO_URING_N_BUFFERS * ARV_GV_STREAM_IO_URING_BUFFER_SIZE);
+	buffer_mask = io_uring_buf_ring_mask (ARV_GV_STREAM_IO_URING_N_BUFFERS);
+	for (i = 0; i < ARV_GV_STREAM_IO_URING_N_BUFFERS; i++)
+		io_uring_buf_ring_add (buffer_ring, buffers + i * ARV_GV_STREAM_IO_URING_BUFFER_SIZE,
+				       ARV_GV_STREAM_IO_URING_BUFFER_SIZE, i, buffer_mask, i);
+	io_uring_buf_ring_advance (buffer_ring, ARV_GV_STREAM_IO_URING_N_BUFFERS);
+
+	do {
+		struct io_uring_cqe *cqe;
+		struct __kernel_timespec timeout;
+		guint64 timeout_us;
+		unsigned head;
+		unsigned n_cqes = 0;
+		int n_recycled = 0;
+		int n_batch_packets = 0;
+
+		arv_stream_update_thread_placement (thread_data->stream);
+
+		/* The multishot receive stops on error, or when the buffer ring is empty */
+		if (!is_armed) {
+			_io_uring_arm_receive (&ring, fd, &message);
+			is_armed = TRUE;
+		}
+
+		if (thread_data->n_frames > 0)
+			timeout_us = thread_data->packet_timeout_us;
+		else
+			timeout_us = ARV_GV_STREAM_POLL_TIMEOUT_US;
+		timeout.tv_sec = timeout_us / 1000000;
+		timeout.tv_nsec = (timeout_us % 1000000) * 1000;
+
+		errsv = -io_uring_wait_cqe_timeout (&ring, &cqe, &timeout);
+		if (errsv != 0 && errsv != ETIME && errsv != EINTR)
+			arv_warning_stream_thread ("[GvStream::io_uring_loop] Completion wait error (%s)",
+						   strerror (errsv));
+
+		io_uring_for_each_cqe (&ring, head, cqe) {
+			n_cqes++;
+
+			if ((cqe->flags & IORING_CQE_F_MORE) == 0)
+				is_armed = FALSE;
+
+			if (cqe->res < 0) {
+				if (cqe->res == -EINVAL && n_packets == 0)
+					is_supported = FALSE;
+				else if (cqe->res != -ENOBUFS)
+					arv_warning_stream_thread ("[GvStream::io_uring_loop] Packet reception error (%s)",
+								   strerror (-cqe->res));
+			}
+
+			if ((cqe->flags & IORING_CQE_F_BUFFER) != 0) {
+				struct io_uring_recvmsg_out *out;
+				unsigned buffer_id;
+				char *buffer;
+
+				buffer_id = cqe->flags >> IORING_CQE_BUFFER_SHIFT;
+				buffer = buffers + buffer_id * ARV_GV_STREAM_IO_URING_BUFFER_SIZE;
+
+				out = cqe->res > 0 ? io_uring_recvmsg_validate (buffer, cqe->res, &message) : NULL;
+				if (out != NULL && (out->flags & MSG_TRUNC) == 0) {
+					ArvGvStreamFrameData *frame;
+					guint64 system_time_ns = 0;
+
+					if (use_control) {
+						struct msghdr control;
+
+						memset (&control, 0, sizeof (control));
+						control.msg_control = (char *) io_uring_recvmsg_name (out) + message.msg_namelen;
+						control.msg_controllen = out->controllen;
+						system_time_ns = _get_message_system_time_ns (thread_data, &control);
+					}
+					time_us = _get_packet_time_us (thread_data, system_time_ns);
+
+					frame = _process_packet (thread_data, io_uring_recvmsg_payload (out, &message),
+								 io_uring_recvmsg_payload_length (out, cqe->res, &message),
+								 time_us);
+
+					_check_frame_completion (thread_data, time_us, frame);
+
+					n_batch_packets++;
+				} else if (out != NULL)
+					thread_data->n_ignored_packets++;
+
+				io_uring_buf_ring_add (buffer_ring, buffer, ARV_GV_STREAM_IO_URING_BUFFER_SIZE,
+						       buffer_id, buffer_mask, n_recycled);
+				n_recycled++;
+			}
+		}
+
+		io_uring_buf_ring_advance (buffer_ring, n_recycled);
+		io_uring_cq_advance (&ring, n_cqes);
+
+		n_packets += n_batch_packets;
+
+		if (n_batch_packets == 0) {
+			time_us = _get_time_us (thread_data);
+			_check_frame_completion (thread_data, time_us, NULL);
+		}
+	} while (is_supported && !g_cancellable_is_cancelled (thread_data->cancellable));
+
+	if (!is_supported)
+		arv_info_stream_thread ("[GvStream::loop] io_uring multishot receive not available");
+
+	io_uring_free_buf_ring (&ring, buffer_ring, ARV_GV_STREAM_IO_URING_N_BUFFERS,
+				ARV_GV_STREAM_IO_URING_BUFFER_GROUP);
+	io_uring_queue_exit (&ring);
+	g_free (buffers);
+
+	return is_supported;
 }
 
+#endif /* ARAVIS_HAS_IO_URING */
+
+#if ARAVIS_HAS_PACKET_SOCKET
+
+/* Classic BPF program accepting the IPv4 UDP packets of the stream tuple, untagged or with one or two 802.1Q / 802.1ad
+ * VLAN tags, and with or without IP options. The X register holds the length of the VLAN tags, then the one of the
+ * VLAN tags and of the IP header. Fragments are rejected. The kernel JIT compiles it if enabled. */
+
+#define ARV_GV_STREAM_BPF_ACCEPT	27
+#define ARV_GV_STREAM_BPF_REJECT	28
+#define ARV_GV_STREAM_BPF_JUMP(pc,target)	((target) - (pc) - 1)
+
 static void
-_close_frame (ArvGvStreamThreadData *thread_data, ArvGvStreamFrameData *frame)
+_set_socket_filter (int socket, guint32 source_ip, guint32 source_port, guint32 destination_ip, guint32 destination_port)
 {
-	if (frame->buffer->priv->status == ARV_BUFFER_STATUS_SUCCESS)
-		thread_data->n_completed_buffers++;
-	else
-		if (frame->buffer->priv->status != ARV_BUFFER_STATUS_ABORTED)
-			thread_data->n_failures++;
+	struct sock_filter bpf[] = {
+		/* 0: Ethernet type, after at most two VLAN tags */
+		BPF_STMT (BPF_LDX | BPF_IMM, 0),
+		BPF_STMT (BPF_LD | BPF_H | BPF_ABS, 12),
+		BPF_JUMP (BPF_JMP | BPF_JEQ | BPF_K, ETH_P_8021Q, ARV_GV_STREAM_BPF_JUMP (2, 4), 0),
+		BPF_JUMP (BPF_JMP | BPF_JEQ | BPF_K, ETH_P_8021AD, 0, ARV_GV_STREAM_BPF_JUMP (3, 9)),
+		BPF_STMT (BPF_LDX | BPF_IMM, 4),
+		/* 5 */
+		BPF_STMT (BPF_LD | BPF_H | BPF_ABS, 16),
+		BPF_JUMP (BPF_JMP | BPF_JEQ | BPF_K, ETH_P_8021Q, 0, ARV_GV_STREAM_BPF_JUMP (6, 9)),
+		BPF_STMT (BPF_LDX | BPF_IMM, 8),
+		BPF_STMT (BPF_LD | BPF_H | BPF_ABS, 20),
+		/* 9: IPv4, UDP, addresses, no fragment */
+		BPF_JUMP (BPF_JMP | BPF_JEQ | BPF_K, ETH_P_IP, 0, ARV_GV_STREAM_BPF_JUMP (9, ARV_GV_STREAM_BPF_REJECT)),
+		/* 10 */
+		BPF_STMT (BPF_LD | BPF_B | BPF_IND, ETH_HLEN + 9),
+		BPF_JUMP (BPF_JMP | BPF_JEQ | BPF_K, IPPROTO_UDP, 0, ARV_GV_STREAM_BPF_JUMP (11, ARV_GV_STREAM_BPF_REJECT)),
+		BPF_STMT (BPF_LD | BPF_W | BPF_IND, ETH_HLEN + 12),
+		BPF_JUMP (BPF_JMP | BPF_JEQ | BPF_K, source_ip, 0, ARV_GV_STREAM_BPF_JUMP (13, ARV_GV_STREAM_BPF_REJECT)),
+		BPF_STMT (BPF_LD | BPF_W | BPF_IND, ETH_HLEN + 16),
+		/* 15 */
+		BPF_JUMP (BPF_JMP | BPF_JEQ | BPF_K, destination_ip, 0,
+			  ARV_GV_STREAM_BPF_JUMP (15, ARV_GV_STREAM_BPF_REJECT)),
+		BPF_STMT (BPF_LD | BPF_H | BPF_IND, ETH_HLEN + 6),
+		BPF_JUMP (BPF_JMP | BPF_JSET | BPF_K, 0x1fff, ARV_GV_STREAM_BPF_JUMP (17, ARV_GV_STREAM_BPF_REJECT), 0),
+		/* 18: skip the IP header, options included */
+		BPF_STMT (BPF_LD | BPF_B | BPF_IND, ETH_HLEN),
+		BPF_STMT (BPF_ALU | BPF_AND | BPF_K, 0x0f),
+		/* 20 */
+		BPF_STMT (BPF_ALU | BPF_LSH | BPF_K, 2),
+		BPF_STMT (BPF_ALU | BPF_ADD | BPF_X, 0),
+		BPF_STMT (BPF_MISC | BPF_TAX, 0),
+		/* 23: UDP ports */
+		BPF_STMT (BPF_LD | BPF_H | BPF_IND, ETH_HLEN),
+		BPF_JUMP (BPF_JMP | BPF_JEQ | BPF_K, source_port, 0, ARV_GV_STREAM_BPF_JUMP (24, ARV_GV_STREAM_BPF_REJECT)),
+		/* 25 */
+		BPF_STMT (BPF_LD | BPF_H | BPF_IND, ETH_HLEN + 2),
+		BPF_JUMP (BPF_JMP | BPF_JEQ | BPF_K, destination_port, 0,
+			  ARV_GV_STREAM_BPF_JUMP (26, ARV_GV_STREAM_BPF_REJECT)),
+		/* 27 */
+		BPF_STMT (BPF_RET | BPF_K, 0x00040000),
+		BPF_STMT (BPF_RET | BPF_K, 0)
+	};
+	struct sock_fprog bpf_prog = {sizeof(bpf) / sizeof(struct sock_filter), bpf};
 
-	if (frame->buffer->priv->status == ARV_BUFFER_STATUS_TIMEOUT)
-		thread_data->n_timeouts++;
+	G_STATIC_ASSERT (G_N_ELEMENTS (bpf) == ARV_GV_STREAM_BPF_REJECT + 1);
 
-	if (frame->buffer->priv->status == ARV_BUFFER_STATUS_ABORTED)
-		thread_data->n_aborteds++;
+	arv_info_stream_thread ("[GvStream::set_socket_filter] source ip = 0x%08x - port = %d - dest ip = 0x%08x - port %d",
+				 source_ip, source_port, destination_ip, destination_port);
 
-	if (frame->buffer->priv->status != ARV_BUFFER_STATUS_SUCCESS &&
-	    frame->buffer->priv->status != ARV_BUFFER_STATUS_ABORTED)
-		thread_data->n_missing_packets += (int) frame->n_packets - (frame->last_valid_packet + 1);
+	if (setsockopt(socket, SOL_SOCKET, SO_ATTACH_FILTER, &bpf_prog, sizeof(bpf_prog)) != 0)
+		arv_warning_stream_thread ("[GvStream::set_socket_filter] Failed to attach Beckerley Packet Filter to stream socket");
+}
 
-	arv_stream_push_output_buffer (thread_data->stream, frame->buffer);
-	if (thread_data->callback != NULL)
-		thread_data->callback (thread_data->callback_data,
-				       ARV_STREAM_CALLBACK_TYPE_BUFFER_DONE,
-				       frame->buffer);
+/* Returns the UDP payload of a frame accepted by the socket filter, skipping the VLAN tags and the IP options */
 
-	if (thread_data->statistic_count > 5) {
-		arv_statistic_fill (thread_data->statistic, 0,
-				    g_get_monotonic_time () - frame->first_packet_time_us,
-				    frame->frame_id);
-	} else
-		thread_data->statistic_count++;
+static const ArvGvspPacket *
+_get_udp_payload (const guint8 *frame, size_t *size)
+{
+	const struct iphdr *ip;
+	size_t offset = ETH_HLEN;
+	guint16 ethertype;
+
+	ethertype = (frame[12] << 8) | frame[13];
+	while ((ethertype == ETH_P_8021Q || ethertype == ETH_P_8021AD) && offset < ETH_HLEN + 8) {
+		ethertype = (frame[offset + 2] << 8) | frame[offset + 3];
+		offset += 4;
+	}
 
-	arv_debug_stream_thread ("[GvStream::close_frame] Close frame %" G_GUINT64_FORMAT, frame->frame_id);
+	ip = (const void *) (frame + offset);
+	*size = g_ntohs (ip->tot_len) - ip->ihl * 4 - sizeof (struct udphdr);
 
-	frame->buffer = NULL;
-	frame->frame_id = 0;
+	return (const void *) (frame + offset + ip->ihl * 4 + sizeof (struct udphdr));
+}
+
+static unsigned
+_interface_index_from_address (GInetAddress *address)
+{
+	ArvNetworkInterface *iface;
+	unsigned index = 0;
+
+	iface = arv_network_interface_lookup (address);
+	if (iface != NULL)
+		index = arv_network_interface_get_index (iface);
+	arv_network_interface_free (iface);
+
+	return index;
+}
+
+typedef struct {
+	guint32 version;
+	guint32 offset_to_priv;
+	struct tpacket_hdr_v1 h1;
+} ArvGvStreamBlockDescriptor;
+
+/* One packet socket ring, bound to one network interface. The rings of the interfaces listed in
+ * #ArvGvStream:packet-socket-interfaces, but the first one, are drained by their own thread. The packets of all the
+ * rings are processed under @mutex, since they share the frame table. */
+
+typedef struct {
+	ArvGvStreamThreadData *thread_data;
+	GMutex *mutex;
+	int fd;
+	char *buffer;
+	struct tpacket_req3 req;
+	unsigned block_id;
+	GThread *thread;
+	GPollFD poll_fd[2];
+	gboolean use_poll;
+} ArvGvStreamRing;
+
+static gboolean
+_ring_open (ArvGvStreamThreadData *thread_data, ArvGvStreamRing *ring, unsigned interface_index)
+{
+	struct sockaddr_ll local_address;
+	enum tpacket_versions version;
+	const guint8 *bytes;
+	guint32 interface_address;
+	guint32 device_address;
+
+	ring->thread_data = thread_data;
+	ring->block_id = 0;
+	ring->buffer = MAP_FAILED;
+
+	ring->fd = socket (PF_PACKET, SOCK_RAW, g_htons (ETH_P_ALL));
+	if (ring->fd < 0) {
+		arv_warning_stream_thread ("[GvStream::loop] Failed to create AF_PACKET socket");
+		return FALSE;
+	}
+
+	version = TPACKET_V3;
+	if (setsockopt (ring->fd, SOL_PACKET, PACKET_VERSION, &version, sizeof(version)) < 0) {
+		arv_warning_stream_thread ("[GvStream::loop] Failed to set packet version");
+		goto error;
+	}
+
+	/* Block size must be a power of two multiple of the page size */
+	ring->req.tp_block_size = getpagesize ();
+	while (ring->req.tp_block_size < thread_data->ring_block_size && ring->req.tp_block_size < (1U << 31))
+		ring->req.tp_block_size <<= 1;
+	ring->req.tp_frame_size = 1024;
+	ring->req.tp_block_nr = MAX ((thread_data->ring_size > 0 ?
+				      thread_data->ring_size :
+				      thread_data->ring_auto_size) / ring->req.tp_block_size, 2);
+	ring->req.tp_frame_nr = (ring->req.tp_block_size / ring->req.tp_frame_size) * ring->req.tp_block_nr;
+	ring->req.tp_sizeof_priv = 0;
+	ring->req.tp_retire_blk_tov = thread_data->ring_retire_timeout_ms;
+	ring->req.tp_feature_req_word = TP_FT_REQ_FILL_RXHASH;
+	if (setsockopt (ring->fd, SOL_PACKET, PACKET_RX_RING, &ring->req, sizeof(ring->req)) < 0) {
+		arv_warning_stream_thread ("[GvStream::loop] Failed to set packet rx ring");
+		goto error;
+	}
+
+	arv_info_stream_thread ("[GvStream::loop] Ring of %u blocks of %u bytes, retire timeout %u ms, interface %u",
+				ring->req.tp_block_nr, ring->req.tp_block_size, ring->req.tp_retire_blk_tov,
+				interface_index);
+
+	ring->buffer = mmap (NULL, ring->req.tp_block_size * ring->req.tp_block_nr, PROT_READ | PROT_WRITE,
+			     MAP_SHARED | MAP_POPULATE, ring->fd, 0);
+	if (ring->buffer == MAP_FAILED) {
+		arv_warning_stream_thread ("[GvStream::loop] Failed to map ring buffer");
+		goto error;
+	}
+
+	bytes = g_inet_address_to_bytes (thread_data->interface_address);
+	interface_address = g_ntohl (*((guint32 *) bytes));
+	bytes = g_inet_address_to_bytes (thread_data->device_address);
+	device_address = g_ntohl (*((guint32 *) bytes));
+
+	local_address.sll_family   = AF_PACKET;
+	local_address.sll_protocol = g_htons(ETH_P_IP);
+	local_address.sll_ifindex  = interface_index;
+	local_address.sll_hatype   = 0;
+	local_address.sll_pkttype  = 0;
+	local_address.sll_halen    = 0;
+	if (bind (ring->fd, (struct sockaddr *) &local_address, sizeof(local_address)) == -1) {
+		arv_warning_stream_thread ("[GvStream::loop] Failed to bind packet socket");
+		goto error;
+	}
+
+	_set_socket_filter (ring->fd, device_address, thread_data->source_stream_port,
+			    interface_address, thread_data->stream_port);
+
+#if ARAVIS_HAS_HARDWARE_TIMESTAMPS
+	if (thread_data->use_hardware_timestamps)
+		thread_data->use_hardware_timestamps = _enable_hardware_timestamps (thread_data, ring->fd, TRUE);
+#endif
+
+	return TRUE;
 
-	g_free (frame->packet_data);
-	g_free (frame);
+error:
+	if (ring->buffer != MAP_FAILED)
+		munmap (ring->buffer, ring->req.tp_block_size * ring->req.tp_block_nr);
+	close (ring->fd);
+	ring->fd = -1;
+
+	return FALSE;
 }
 
 static void
-_check_frame_completion (ArvGvStreamThreadData *thread_data,
-			 guint64 time_us,
-			 ArvGvStreamFrameData *current_frame)
+_ring_close (ArvGvStreamRing *ring)
+{
+	if (ring->fd < 0)
+		return;
+
+	munmap (ring->buffer, ring->req.tp_block_size * ring->req.tp_block_nr);
+	close (ring->fd);
+	ring->fd = -1;
+}
+
+/* Processes the next block of @ring if the kernel released it, and returns %FALSE otherwise. The header of the next
+ * packet, and the start of its GVSP header, are prefetched while the current packet is processed. The completion
+ * check is skipped as long as the next packet belongs to the same frame, and this frame can't be complete yet, so
+ * that it runs once per run of packets of a frame, and always before the first packet of another frame. */
+
+static gboolean
+_ring_process_block (ArvGvStreamRing *ring)
 {
-	GSList *iter;
+	ArvGvStreamThreadData *thread_data = ring->thread_data;
+	ArvGvStreamBlockDescriptor *descriptor;
 	ArvGvStreamFrameData *frame;
-	gboolean can_close_frame = TRUE;
+	const struct tpacket3_hdr *header;
+	const ArvGvspPacket *packet;
+	size_t size = 0;
+	unsigned n_packets;
+	unsigned i;
+
+	descriptor = (void *) (ring->buffer + ring->block_id * ring->req.tp_block_size);
+	if ((descriptor->h1.block_status & TP_STATUS_USER) == 0)
+		return FALSE;
+
+	n_packets = descriptor->h1.num_pkts;
+	header = (void *) (((char *) descriptor) + descriptor->h1.offset_to_first_pkt);
+	packet = n_packets > 0 ? _get_udp_payload (((const guint8 *) header) + header->tp_mac, &size) : NULL;
+
+	if (ring->mutex != NULL)
+		g_mutex_lock (ring->mutex);
+
+	for (i = 0; i < n_packets; i++) {
+		const struct tpacket3_hdr *next_header = NULL;
+		const ArvGvspPacket *next_packet = NULL;
+		size_t next_size = 0;
+		guint64 time_us;
 
-	for (iter = thread_data->frames; iter != NULL;) {
-		frame = iter->data;
+		if (i + 1 < n_packets) {
+			next_header = (void *) (((char *) header) + header->tp_next_offset);
 
-		if (can_close_frame &&
-		    thread_data->packet_resend == ARV_GV_STREAM_PACKET_RESEND_NEVER &&
-		    iter->next != NULL) {
-			frame->buffer->priv->status = ARV_BUFFER_STATUS_MISSING_PACKETS;
-			arv_info_stream_thread ("[GvStream::check_frame_completion] Incomplete frame %" G_GUINT64_FORMAT,
-						 frame->frame_id);
-			_close_frame (thread_data, frame);
-			thread_data->frames = iter->next;
-			g_slist_free_1 (iter);
-			iter = thread_data->frames;
-			continue;
+			/* The MAC offset is the same for all the packets of a block */
+			__builtin_prefetch (next_header, 0, 3);
+			__builtin_prefetch (((const char *) next_header) + header->tp_mac + ETH_HLEN +
+					    sizeof (struct iphdr) + sizeof (struct udphdr), 0, 3);
 		}
 
-		if (can_close_frame &&
-		    frame->last_valid_packet == frame->n_packets - 1) {
-			frame->buffer->priv->status = ARV_BUFFER_STATUS_SUCCESS;
-			arv_debug_stream_thread ("[GvStream::check_frame_completion] Completed frame %" G_GUINT64_FORMAT,
-					       frame->frame_id);
-			_close_frame (thread_data, frame);
-			thread_data->frames = iter->next;
-			g_slist_free_1 (iter);
-			iter = thread_data->frames;
-			continue;
+		/* Kernel reception time, in real time, unless replaced by the hardware reception time */
+		if ((header->tp_status & TP_STATUS_TS_RAW_HARDWARE) != 0) {
+			thread_data->packet_hardware_time_ns = (guint64) header->tp_sec * 1000000000ULL +
+				header->tp_nsec;
+			time_us = _get_packet_time_us (thread_data, 0);
+		} else {
+			thread_data->packet_hardware_time_ns = 0;
+			time_us = _get_packet_time_us (thread_data, (guint64) header->tp_sec * 1000000000ULL +
+						       header->tp_nsec);
 		}
 
-		if (can_close_frame &&
-		    time_us - frame->last_packet_time_us >= thread_data->frame_retention_us) {
-			frame->buffer->priv->status = ARV_BUFFER_STATUS_TIMEOUT;
-			arv_warning_stream_thread ("[GvStream::check_frame_completion] Timeout for frame %"
-						   G_GUINT64_FORMAT " at dt = %" G_GUINT64_FORMAT,
-						   frame->frame_id, time_us - frame->first_packet_time_us);
-#if 0
-			if (arv_debug_check (&arv_debug_category_stream_thread, ARV_DEBUG_LEVEL_LOG)) {
-				int i;
-				arv_debug_stream_thread ("frame_id          = %Lu", frame->frame_id);
-				arv_debug_stream_thread ("last_valid_packet = %d", frame->last_valid_packet);
-				for (i = 0; i < frame->n_packets; i++) {
-					arv_debug_stream_thread ("%d - time = %Lu%s", i,
-							       frame->packet_data[i].time_us,
-							       frame->packet_data[i].received ? " - OK" : "");
-				}
-			}
-#endif
-			_close_frame (thread_data, frame);
-			thread_data->frames = iter->next;
-			g_slist_free_1 (iter);
-			iter = thread_data->frames;
-			continue;
-		}
+		frame = _process_packet (thread_data, packet, size, time_us);
 
-		can_close_frame = FALSE;
+		if (next_header != NULL)
+			next_packet = _get_udp_payload (((const guint8 *) next_header) + next_header->tp_mac,
+							&next_size);
 
-		if (frame != current_frame &&
-		    time_us - frame->last_packet_time_us >= thread_data->packet_timeout_us) {
-			_missing_packet_check (thread_data, frame, frame->n_packets - 1, time_us);
-			iter = iter->next;
-			continue;
-		}
+		/* Deferred while the next packet belongs to the same frame, which misses more than its trailer */
+		if (next_packet == NULL || frame == NULL ||
+		    frame->last_valid_packet + 2 >= (gint64) frame->n_packets ||
+		    arv_gvsp_packet_get_frame_id (next_packet) != frame->frame_id)
+			_check_frame_completion (thread_data, time_us, frame);
 
-		iter = iter->next;
+		header = next_header;
+		packet = next_packet;
+		size = next_size;
+	}
+
+	if (ring->mutex != NULL)
+		g_mutex_unlock (ring->mutex);
+
+	descriptor->h1.block_status = TP_STATUS_KERNEL;
+	ring->block_id = (ring->block_id + 1) % ring->req.tp_block_nr;
+
+	return TRUE;
+}
+
+static void
+_ring_prepare_poll (ArvGvStreamRing *ring)
+{
+	ring->poll_fd[0].fd = ring->fd;
+	ring->poll_fd[0].events =  G_IO_IN;
+	ring->poll_fd[0].revents = 0;
+
+	ring->use_poll = g_cancellable_make_pollfd (ring->thread_data->cancellable, &ring->poll_fd[1]);
+}
+
+static void
+_ring_finish_poll (ArvGvStreamRing *ring)
+{
+	if (ring->use_poll)
+		g_cancellable_release_fd (ring->thread_data->cancellable);
+}
+
+static void
+_ring_wait (ArvGvStreamRing *ring, gboolean check_completion)
+{
+	ArvGvStreamThreadData *thread_data = ring->thread_data;
+	int n_events;
+	int errsv;
+
+	if (check_completion) {
+		if (ring->mutex != NULL)
+			g_mutex_lock (ring->mutex);
+		_check_frame_completion (thread_data, _get_time_us (thread_data), NULL);
+		if (ring->mutex != NULL)
+			g_mutex_unlock (ring->mutex);
 	}
+
+	do {
+		n_events = g_poll (ring->poll_fd, ring->use_poll ? 2 : 1, 100);
+		errsv = errno;
+	} while (n_events < 0 && errsv == EINTR);
 }
 
-static void
-_flush_frames (ArvGvStreamThreadData *thread_data)
+static void *
+_ring_thread (void *data)
 {
-	GSList *iter;
-	ArvGvStreamFrameData *frame;
+	ArvGvStreamRing *ring = data;
 
-	for (iter = thread_data->frames; iter != NULL; iter = iter->next) {
-		frame = iter->data;
-		frame->buffer->priv->status = ARV_BUFFER_STATUS_ABORTED;
-		_close_frame (thread_data, frame);
-	}
+	_ring_prepare_poll (ring);
 
-	g_slist_free (thread_data->frames);
-	thread_data->frames = NULL;
+	while (!g_cancellable_is_cancelled (ring->thread_data->cancellable))
+		if (!_ring_process_block (ring))
+			_ring_wait (ring, FALSE);
+
+	_ring_finish_poll (ring);
+
+	return NULL;
 }
 
-static ArvGvStreamFrameData *
-_process_packet (ArvGvStreamThreadData *thread_data, const ArvGvspPacket *packet, size_t packet_size, guint64 time_us)
+/* Returns the indexes of the interfaces listed in #ArvGvStream:packet-socket-interfaces, or of the interface of the
+ * stream address if the list is empty */
 
+static GArray *
+_ring_get_interface_indexes (ArvGvStreamThreadData *thread_data)
 {
-	ArvGvStreamFrameData *frame;
-	guint32 packet_id;
-	guint64 frame_id;
-	gboolean extended_ids;
-	int i;
+	GArray *indexes;
+	unsigned index;
 
-	thread_data->n_received_packets++;
+	indexes = g_array_new (FALSE, FALSE, sizeof (unsigned));
 
-	extended_ids = arv_gvsp_packet_has_extended_ids (packet);
-	frame_id = arv_gvsp_packet_get_frame_id (packet);
-	packet_id = arv_gvsp_packet_get_packet_id (packet);
+	if (thread_data->packet_socket_interfaces != NULL) {
+		g_auto (GStrv) names = g_strsplit_set (thread_data->packet_socket_interfaces, ", ", -1);
+		unsigned i;
 
-	if (thread_data->first_packet) {
-		thread_data->last_frame_id = frame_id - 1;
-		thread_data->first_packet = FALSE;
+		for (i = 0; names[i] != NULL; i++) {
+			if (names[i][0] == '\0')
+				continue;
+
+			index = if_nametoindex (names[i]);
+			if (index > 0)
+				g_array_append_val (indexes, index);
+			else
+				arv_warning_stream_thread ("[GvStream::loop] Unknown interface '%s'", names[i]);
+		}
 	}
 
-	frame = _find_frame_data (thread_data, packet, packet_size, frame_id, packet_id, extended_ids, packet_size, time_us);
+	if (indexes->len == 0) {
+		index = _interface_index_from_address (thread_data->interface_address);
+		g_array_append_val (indexes, index);
+	}
 
-	if (frame != NULL) {
-		ArvGvspPacketType packet_type = arv_gvsp_packet_get_packet_type (packet);
+	return indexes;
+}
 
-		if (arv_gvsp_packet_type_is_error (packet_type)) {
-			arv_info_stream_thread ("[GvStream::process_packet]"
-						 " Error packet at dt = %" G_GINT64_FORMAT ", packet id = %u"
-						 " frame id = %" G_GUINT64_FORMAT,
-						 time_us - frame->first_packet_time_us,
-						 packet_id, frame->frame_id);
-			arv_gvsp_packet_debug (packet, packet_size, ARV_DEBUG_LEVEL_INFO);
-			frame->error_packet_received = TRUE;
+static void
+_ring_buffer_loop (ArvGvStreamThreadData *thread_data)
+{
+	ArvGvStreamRing *rings;
+	GArray *indexes;
+	GMutex mutex;
+	unsigned n_rings = 0;
+	unsigned i;
 
-			thread_data->n_error_packets++;
-		} else if (packet_id < frame->n_packets &&
-		           frame->packet_data[packet_id].received) {
-			/* Ignore duplicate packet */
-			thread_data->n_duplicated_packets++;
-			arv_debug_stream_thread ("[GvStream::process_packet] Duplicated packet %d for frame %" G_GUINT64_FORMAT,
-						 packet_id, frame->frame_id);
-			arv_gvsp_packet_debug (packet, packet_size, ARV_DEBUG_LEVEL_DEBUG);
-		} else {
-			ArvGvspContentType content_type;
+	arv_info_stream ("[GvStream::loop] Packet socket method");
 
-			if (packet_id < frame->n_packets) {
-				frame->packet_data[packet_id].received = TRUE;
-			}
+	indexes = _ring_get_interface_indexes (thread_data);
+	rings = g_new0 (ArvGvStreamRing, indexes->len);
+	g_mutex_init (&mutex);
 
-			/* Keep track of last packet of a continuous block starting from packet 0 */
-			for (i = frame->last_valid_packet + 1; i < frame->n_packets; i++)
-				if (!frame->packet_data[i].received)
-					break;
-			frame->last_valid_packet = i - 1;
+	for (i = 0; i < indexes->len; i++)
+		if (_ring_open (thread_data, &rings[n_rings], g_array_index (indexes, unsigned, i)))
+			n_rings++;
 
-			content_type = arv_gvsp_packet_get_content_type (packet);
+	if (n_rings > 0) {
+		for (i = 1; i < n_rings; i++) {
+			rings[0].mutex = &mutex;
+			rings[i].mutex = &mutex;
+			rings[i].thread = g_thread_new ("arv_gv_stream_ring", _ring_thread, &rings[i]);
+		}
 
-			arv_gvsp_packet_debug (packet, packet_size,
-					       content_type == ARV_GVSP_CONTENT_TYPE_DATA_BLOCK ?
-					       ARV_DEBUG_LEVEL_TRACE :
-					       ARV_DEBUG_LEVEL_DEBUG);
+		_ring_prepare_poll (&rings[0]);
 
-			switch (content_type) {
-				case ARV_GVSP_CONTENT_TYPE_DATA_LEADER:
-					_process_data_leader (thread_data, frame, packet, packet_id);
-					break;
-				case ARV_GVSP_CONTENT_TYPE_DATA_BLOCK:
-					_process_data_block (thread_data, frame, packet, packet_id,
-							     packet_size);
-					break;
-				case ARV_GVSP_CONTENT_TYPE_DATA_TRAILER:
-					_process_data_trailer (thread_data, frame, packet_id);
-					break;
-				default:
-					thread_data->n_ignored_packets++;
-					break;
-			}
+		do {
+			arv_stream_update_thread_placement (thread_data->stream);
 
-			_missing_packet_check (thread_data, frame, packet_id, time_us);
-		}
-	} else
-		thread_data->n_ignored_packets++;
+			if (!_ring_process_block (&rings[0]))
+				_ring_wait (&rings[0], TRUE);
+		} while (!g_cancellable_is_cancelled (thread_data->cancellable));
 
-	return frame;
+		_ring_finish_poll (&rings[0]);
+
+		for (i = 1; i < n_rings; i++)
+			g_thread_join (rings[i].thread);
+	}
+
+	for (i = 0; i < n_rings; i++)
+		_ring_close (&rings[i]);
+
+	g_mutex_clear (&mutex);
+	g_free (rings);
+	g_array_unref (indexes);
 }
 
+#if ARAVIS_HAS_XDP
+
+typedef struct {
+	ArvGvStreamThreadData *thread_data;
+	guint64 time_us;
+} ArvGvStreamXdpContext;
+
 static void
-_loop (ArvGvStreamThreadData *thread_data)
+_xdp_packet_cb (void *data, const void *payload, size_t size)
 {
+	ArvGvStreamXdpContext *context = data;
 	ArvGvStreamFrameData *frame;
-	ArvGvspPacket *packet;
+
+	frame = _process_packet (context->thread_data, payload, size, context->time_us);
+
+	_check_frame_completion (context->thread_data, context->time_us, frame);
+}
+
+static gboolean
+_xdp_loop (ArvGvStreamThreadData *thread_data)
+{
+	ArvGvStreamXdpContext context;
+	ArvXdpSocket *xdp_socket;
 	GPollFD poll_fd[2];
-	guint64 time_us;
-	size_t read_count;
-	int timeout_ms;
+	const guint8 *bytes;
+	guint32 interface_address;
+	guint32 device_address;
 	gboolean use_poll;
 
-	arv_info_stream ("[GvStream::loop] Standard socket method");
+	bytes = g_inet_address_to_bytes (thread_data->interface_address);
+	interface_address = g_ntohl (*((guint32 *) bytes));
+	bytes = g_inet_address_to_bytes (thread_data->device_address);
+	device_address = g_ntohl (*((guint32 *) bytes));
 
-	poll_fd[0].fd = g_socket_get_fd (thread_data->socket);
-	poll_fd[0].events =  G_IO_IN;
-	poll_fd[0].revents = 0;
+	xdp_socket = arv_xdp_socket_new (_interface_index_from_address (thread_data->interface_address), thread_data->xdp_queue,
+					 device_address, thread_data->source_stream_port,
+					 interface_address, thread_data->stream_port);
+	if (xdp_socket == NULL) {
+		arv_info_stream_thread ("[GvStream::loop] AF_XDP socket not available");
+		return FALSE;
+	}
 
-	arv_gpollfd_prepare_all(poll_fd,1);
+	if (thread_data->scps_packet_size > arv_xdp_socket_get_max_ip_packet_size (xdp_socket)) {
+		arv_info_stream_thread ("[GvStream::loop] Packet size too large for AF_XDP socket (%u > %" G_GSIZE_FORMAT ")",
+					thread_data->scps_packet_size,
+					arv_xdp_socket_get_max_ip_packet_size (xdp_socket));
+		arv_xdp_socket_free (xdp_socket);
+		return FALSE;
+	}
 
-	packet = g_malloc0 (ARV_GV_STREAM_INCOMING_BUFFER_SIZE);
+	arv_info_stream ("[GvStream::loop] AF_XDP socket method");
+
+	context.thread_data = thread_data;
+
+	poll_fd[0].fd = arv_xdp_socket_get_fd (xdp_socket);
+	poll_fd[0].events =  G_IO_IN;
+	poll_fd[0].revents = 0;
 
 	use_poll = g_cancellable_make_pollfd (thread_data->cancellable, &poll_fd[1]);
 
 	do {
+		int timeout_ms;
 		int n_events;
 		int errsv;
 
-		if (thread_data->frames != NULL)
+		arv_stream_update_thread_placement (thread_data->stream);
+
+		if (thread_data->n_frames > 0)
 			timeout_ms = thread_data->packet_timeout_us / 1000;
 		else
 			timeout_ms = ARV_GV_STREAM_POLL_TIMEOUT_US / 1000;
@@ -790,264 +3698,237 @@ _loop (ArvGvStreamThreadData *thread_data)
 			poll_fd[0].revents = 0;
 			n_events = g_poll (poll_fd, use_poll ?  2 : 1, timeout_ms);
 			errsv = errno;
-
 		} while (n_events < 0 && errsv == EINTR);
 
-		time_us = g_get_monotonic_time ();
-
-		if (poll_fd[0].revents != 0) {
-			arv_gpollfd_clear_one (&poll_fd[0], thread_data->socket);
-			read_count = g_socket_receive (thread_data->socket, (char *) packet,
-						       ARV_GV_STREAM_INCOMING_BUFFER_SIZE, NULL, NULL);
-
-			frame = _process_packet (thread_data, packet, read_count, time_us);
-		} else
-			frame = NULL;
-
-		_check_frame_completion (thread_data, time_us, frame);
+		context.time_us = g_get_monotonic_time ();
 
+		if (poll_fd[0].revents == 0 ||
+		    arv_xdp_socket_receive (xdp_socket, _xdp_packet_cb, &context) == 0)
+			_check_frame_completion (thread_data, context.time_us, NULL);
 	} while (!g_cancellable_is_cancelled (thread_data->cancellable));
 
 	if (use_poll)
 		g_cancellable_release_fd (thread_data->cancellable);
 
-	arv_gpollfd_finish_all (poll_fd,1);
-	g_free (packet);
+	arv_xdp_socket_free (xdp_socket);
+
+	return TRUE;
 }
 
+#endif /* ARAVIS_HAS_XDP */
 
-#if ARAVIS_HAS_PACKET_SOCKET
+#endif /* ARAVIS_HAS_PACKET_SOCKET */
+
+/* Feed a packet record to the reassembly, at its original pace or as fast as possible, with the packet times offset
+ * to the replay start time */
 
 static void
-_set_socket_filter (int socket, guint32 source_ip, guint32 source_port, guint32 destination_ip, guint32 destination_port)
+_replay_loop (ArvGvStreamThreadData *thread_data)
 {
-	struct sock_filter bpf[18] = {
-		{ 0x28, 0, 0, 0x0000000c },
-		{ 0x15, 15, 0, 0x000086dd },
-		{ 0x15, 0, 14, 0x00000800 },
-		{ 0x30, 0, 0, 0x00000017 },
-		{ 0x15, 0, 12, 0x00000011 },
-		{ 0x20, 0, 0, 0x0000001a },
-		{ 0x15, 0, 10, source_ip },
-		{ 0x28, 0, 0, 0x00000014 },
-		{ 0x45, 8, 0, 0x00001fff },
-		{ 0xb1, 0, 0, 0x0000000e },
-		{ 0x48, 0, 0, 0x0000000e },
-		{ 0x15, 0, 5, source_port },
-		{ 0x20, 0, 0, 0x0000001e },
-		{ 0x15, 0, 3, destination_ip },
-		{ 0x48, 0, 0, 0x00000010 },
-		{ 0x15, 0, 1, destination_port },
-		{ 0x6, 0, 0, 0x00040000 },
-		{ 0x6, 0, 0, 0x00000000 }
-	};
-	struct sock_fprog bpf_prog = {sizeof(bpf) / sizeof(struct sock_filter), bpf};
-
-	arv_info_stream_thread ("[GvStream::set_socket_filter] source ip = 0x%08x - port = %d - dest ip = 0x%08x - port %d",
-				 source_ip, source_port, destination_ip, destination_port);
-
-	if (setsockopt(socket, SOL_SOCKET, SO_ATTACH_FILTER, &bpf_prog, sizeof(bpf_prog)) != 0)
-		arv_warning_stream_thread ("[GvStream::set_socket_filter] Failed to attach Beckerley Packet Filter to stream socket");
-}
+	ArvGvStreamFrameData *frame;
+	ArvPacketPlayer *player;
+	GError *error = NULL;
+	const void *packet;
+	size_t packet_size;
+	guint64 packet_time_us;
+	guint64 first_packet_time_us = 0;
+	guint64 start_time_us;
+	guint64 time_us;
+	gboolean first_packet = TRUE;
+
+	player = arv_packet_player_new (thread_data->replay_filename, &error);
+	if (player == NULL) {
+		arv_warning_stream_thread ("[GvStream::replay_loop] %s", error->message);
+		g_clear_error (&error);
+	} else if (arv_packet_player_get_protocol (player) != ARV_PACKET_RECORD_PROTOCOL_GVSP) {
+		arv_warning_stream_thread ("[GvStream::replay_loop] '%s' is not a GVSP packet record",
+					   thread_data->replay_filename);
+		g_clear_pointer (&player, arv_packet_player_free);
+	} else
+		arv_info_stream_thread ("[GvStream::replay_loop] Replay %" G_GUINT64_FORMAT " packets from '%s'%s",
+					arv_packet_player_get_n_packets (player), thread_data->replay_filename,
+					thread_data->replay_realtime ? " at their original pace" : "");
+
+	start_time_us = _get_time_us (thread_data);
+
+	while (player != NULL &&
+	       !g_cancellable_is_cancelled (thread_data->cancellable) &&
+	       arv_packet_player_next (player, &packet_time_us, &packet, &packet_size)) {
+		if (first_packet) {
+			first_packet_time_us = packet_time_us;
+			first_packet = FALSE;
+		}
 
-static unsigned
-_interface_index_from_address (guint32 ip)
-{
-    struct ifaddrs *ifaddr = NULL;
-    struct ifaddrs *ifa;
-    unsigned index = 0;
+		time_us = start_time_us + (packet_time_us > first_packet_time_us ?
+					   packet_time_us - first_packet_time_us : 0);
 
-    if (getifaddrs(&ifaddr) == -1) {
-        return index;
-    }
+		if (thread_data->replay_realtime) {
+			guint64 now_us;
 
-    for (ifa = ifaddr; ifa != NULL; ifa = ifa->ifa_next) {
-	    if (ifa->ifa_addr != NULL &&
-		ifa->ifa_addr->sa_family == AF_INET) {
-		    struct sockaddr_in *sa;
+			while ((now_us = _get_time_us (thread_data)) < time_us &&
+			       !g_cancellable_is_cancelled (thread_data->cancellable))
+				g_usleep (MIN (time_us - now_us, ARV_GV_STREAM_REPLAY_SLEEP_US_MAX));
+		}
 
-		    sa = (struct sockaddr_in *) (ifa->ifa_addr);
-		    if (ip == g_ntohl (sa->sin_addr.s_addr)) {
-			    index = if_nametoindex (ifa->ifa_name);
-			    break;
-		    }
-	    }
-    }
+		frame = _process_packet (thread_data, packet, packet_size, time_us);
+		_check_frame_completion (thread_data, time_us, frame);
+	}
 
-    freeifaddrs (ifaddr);
+	g_clear_pointer (&player, arv_packet_player_free);
 
-    return index;
+	/* Let the incomplete frames time out, until the thread is stopped */
+	while (!g_cancellable_is_cancelled (thread_data->cancellable)) {
+		g_usleep (MIN (thread_data->packet_timeout_us, ARV_GV_STREAM_REPLAY_SLEEP_US_MAX));
+		_check_frame_completion (thread_data, _get_time_us (thread_data), NULL);
+	}
 }
 
-typedef struct {
-	guint32 version;
-	guint32 offset_to_priv;
-	struct tpacket_hdr_v1 h1;
-} ArvGvStreamBlockDescriptor;
-
 static void
-_ring_buffer_loop (ArvGvStreamThreadData *thread_data)
+_thread_start (void *data)
 {
-	GPollFD poll_fd[2];
-	char *buffer;
-	struct tpacket_req3 req;
-	struct sockaddr_ll local_address;
-	enum tpacket_versions version;
-	int fd;
-	unsigned block_id;
-	const guint8 *bytes;
-	guint32 interface_address;
-	guint32 device_address;
-	gboolean use_poll;
-
-	arv_info_stream ("[GvStream::loop] Packet socket method");
+	ArvGvStreamThreadData *thread_data = data;
 
-	fd = socket (PF_PACKET, SOCK_RAW, g_htons (ETH_P_ALL));
-	if (fd < 0) {
-		arv_warning_stream_thread ("[GvStream::loop] Failed to create AF_PACKET socket");
-		return;
-	}
+	memset (thread_data->frames, 0, sizeof (thread_data->frames));
+	memset (thread_data->frame_table, 0, sizeof (thread_data->frame_table));
+	thread_data->first_frame = 0;
+	thread_data->n_frames = 0;
+	thread_data->last_frame = NULL;
+	thread_data->frame_pool = NULL;
+	thread_data->last_frame_id = 0;
+	thread_data->first_packet = TRUE;
+	thread_data->last_closed_frame_valid = FALSE;
 
-	version = TPACKET_V3;
-	if (setsockopt (fd, SOL_PACKET, PACKET_VERSION, &version, sizeof(version)) < 0) {
-		arv_warning_stream_thread ("[GvStream::loop] Failed to set packet version");
-		goto socket_option_error;
-	}
+	arv_info_stream_thread ("[GvStream::stream_thread] Packet timeout = %g ms",
+				 thread_data->packet_timeout_us / 1000.0);
+	arv_info_stream_thread ("[GvStream::stream_thread] Frame retention = %g ms",
+				 thread_data->frame_retention_us / 1000.0);
 
-	req.tp_block_size = 1 << 21;
-	req.tp_frame_size = 1024;
-	req.tp_block_nr = 16;
-	req.tp_frame_nr = (req.tp_block_size * req.tp_block_nr) / req.tp_frame_size;
-	req.tp_sizeof_priv = 0;
-	req.tp_retire_blk_tov = 5;
-	req.tp_feature_req_word = TP_FT_REQ_FILL_RXHASH;
-	if (setsockopt (fd, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req)) < 0) {
-		arv_warning_stream_thread ("[GvStream::loop] Failed to set packet rx ring");
-		goto socket_option_error;
-	}
+	if (thread_data->callback != NULL)
+		thread_data->callback (thread_data->callback_data, ARV_STREAM_CALLBACK_TYPE_INIT, NULL);
+}
 
-	buffer = mmap (NULL, req.tp_block_size * req.tp_block_nr, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, 0);
-	if (buffer == MAP_FAILED) {
-		arv_warning_stream_thread ("[GvStream::loop] Failed to map ring buffer");
-		goto map_error;
-	}
+static void
+_thread_stop (void *data)
+{
+	ArvGvStreamThreadData *thread_data = data;
 
-	bytes = g_inet_address_to_bytes (thread_data->interface_address);
-	interface_address = g_ntohl (*((guint32 *) bytes));
-	bytes = g_inet_address_to_bytes (thread_data->device_address);
-	device_address = g_ntohl (*((guint32 *) bytes));
+	_flush_frames (thread_data);
+	_free_frame_pool (thread_data);
 
-	local_address.sll_family   = AF_PACKET;
-	local_address.sll_protocol = g_htons(ETH_P_IP);
-	local_address.sll_ifindex  = _interface_index_from_address (interface_address);
-	local_address.sll_hatype   = 0;
-	local_address.sll_pkttype  = 0;
-	local_address.sll_halen    = 0;
-	if (bind (fd, (struct sockaddr *) &local_address, sizeof(local_address)) == -1) {
-		arv_warning_stream_thread ("[GvStream::loop] Failed to bind packet socket");
-		goto bind_error;
+	/* Not used for a frame yet, given back to the input queue */
+	if (thread_data->prefetched_buffer != NULL) {
+		arv_stream_push_buffer (thread_data->stream, thread_data->prefetched_buffer);
+		thread_data->prefetched_buffer = NULL;
 	}
 
-	_set_socket_filter (fd, device_address, thread_data->source_stream_port, interface_address, thread_data->stream_port);
-
-	poll_fd[0].fd = fd;
-	poll_fd[0].events =  G_IO_IN;
-	poll_fd[0].revents = 0;
-
-	use_poll = g_cancellable_make_pollfd (thread_data->cancellable, &poll_fd[1]);
-
-	block_id = 0;
-	do {
-		ArvGvStreamBlockDescriptor *descriptor;
-		guint64 time_us;
-
-		time_us = g_get_monotonic_time ();
-
-		descriptor = (void *) (buffer + block_id * req.tp_block_size);
-		if ((descriptor->h1.block_status & TP_STATUS_USER) == 0) {
-			int n_events;
-			int errsv;
+	if (thread_data->callback != NULL)
+		thread_data->callback (thread_data->callback_data, ARV_STREAM_CALLBACK_TYPE_EXIT, NULL);
+}
 
-			_check_frame_completion (thread_data, time_us, NULL);
+static void *
+arv_gv_stream_thread (void *data)
+{
+	ArvGvStreamThreadData *thread_data = data;
+#if ARAVIS_HAS_PACKET_SOCKET
+	int fd;
+#endif
 
-			do {
-				n_events = g_poll (poll_fd, use_poll ? 2 : 1, 100);
-				errsv = errno;
-			} while (n_events < 0 && errsv == EINTR);
-		} else {
-			ArvGvStreamFrameData *frame;
-			const struct tpacket3_hdr *header;
-			unsigned i;
+	arv_stream_apply_thread_placement (thread_data->stream);
 
-			header = (void *) (((char *) descriptor) + descriptor->h1.offset_to_first_pkt);
+	_thread_start (thread_data);
 
-			for (i = 0; i < descriptor->h1.num_pkts; i++) {
-				const struct iphdr *ip;
-				const ArvGvspPacket *packet;
-				size_t size;
+	if (thread_data->replay_filename != NULL)
+		_replay_loop (thread_data);
+	else
+#if ARAVIS_HAS_XDP
+	if (thread_data->use_xdp && _xdp_loop (thread_data)) {
+		/* Done with the AF_XDP socket */
+	} else
+#endif
+#if ARAVIS_HAS_IO_URING
+	if (thread_data->use_io_uring && _io_uring_loop (thread_data)) {
+		/* Done with the io_uring receives */
+	} else
+#endif
+#if ARAVIS_HAS_PACKET_SOCKET
+	if (thread_data->use_packet_socket && (fd = socket (PF_PACKET, SOCK_RAW, g_htons (ETH_P_ALL))) >= 0) {
+		close (fd);
+		_ring_buffer_loop (thread_data);
+	} else
+#endif
+#if ARAVIS_HAS_RECVMMSG
+	if (thread_data->use_batch_receive)
+		_batch_loop (thread_data);
+	else
+#endif
+		_loop (thread_data);
 
-				ip = (void *) (((char *) header) + header->tp_mac + ETH_HLEN);
-				packet = (void *) (((char *) ip) + sizeof (struct iphdr) + sizeof (struct udphdr));
-				size = g_ntohs (ip->tot_len) -  sizeof (struct iphdr) - sizeof (struct udphdr);
+	_thread_stop (thread_data);
 
-				frame = _process_packet (thread_data, packet, size, time_us);
+	return NULL;
+}
 
-				_check_frame_completion (thread_data, time_us, frame);
+/* Shared receiver client, called from one of the shared receiver threads */
 
-				header = (void *) (((char *) header) + header->tp_next_offset);
-			}
+static void
+_shared_receiver_start (void *data)
+{
+	ArvGvStreamThreadData *thread_data = data;
 
-			descriptor->h1.block_status = TP_STATUS_KERNEL;
-			block_id = (block_id + 1) % req.tp_block_nr;
-		}
-	} while (!g_cancellable_is_cancelled (thread_data->cancellable));
+	arv_info_stream_thread ("[GvStream::shared_receiver_start] Shared receiver method");
 
-	if (use_poll)
-		g_cancellable_release_fd (thread_data->cancellable);
+	thread_data->receiver_packet = g_malloc0 (ARV_GV_STREAM_INCOMING_BUFFER_SIZE);
 
-bind_error:
-	munmap (buffer, req.tp_block_size * req.tp_block_nr);
-socket_option_error:
-map_error:
-	close (fd);
+	_thread_start (thread_data);
 }
 
-#endif /* ARAVIS_HAS_PACKET_SOCKET */
-
-static void *
-arv_gv_stream_thread (void *data)
+static void
+_shared_receiver_receive (void *data, guint64 time_us)
 {
 	ArvGvStreamThreadData *thread_data = data;
-#if ARAVIS_HAS_PACKET_SOCKET
-	int fd;
-#endif
+	ArvGvStreamFrameData *frame;
+	gssize read_count;
+	int i;
 
-	thread_data->frames = NULL;
-	thread_data->last_frame_id = 0;
-	thread_data->first_packet = TRUE;
+	/* Bounded, for fairness between the sockets of a same receiver thread */
+	for (i = 0; i < ARV_GV_STREAM_BATCH_SIZE; i++) {
+		read_count = g_socket_receive_with_blocking (thread_data->socket,
+							     (char *) thread_data->receiver_packet,
+							     ARV_GV_STREAM_INCOMING_BUFFER_SIZE,
+							     FALSE, NULL, NULL);
+		if (read_count <= 0)
+			break;
 
-	arv_info_stream_thread ("[GvStream::stream_thread] Packet timeout = %g ms",
-				 thread_data->packet_timeout_us / 1000.0);
-	arv_info_stream_thread ("[GvStream::stream_thread] Frame retention = %g ms",
-				 thread_data->frame_retention_us / 1000.0);
+		frame = _process_packet (thread_data, thread_data->receiver_packet, read_count, time_us);
+		_check_frame_completion (thread_data, time_us, frame);
+	}
+}
 
-	if (thread_data->callback != NULL)
-		thread_data->callback (thread_data->callback_data, ARV_STREAM_CALLBACK_TYPE_INIT, NULL);
+static void
+_shared_receiver_check (void *data, guint64 time_us)
+{
+	_check_frame_completion (data, time_us, NULL);
+}
 
-#if ARAVIS_HAS_PACKET_SOCKET
-	if (thread_data->use_packet_socket && (fd = socket (PF_PACKET, SOCK_RAW, g_htons (ETH_P_ALL))) >= 0) {
-		close (fd);
-		_ring_buffer_loop (thread_data);
-	} else
-#endif
-		_loop (thread_data);
+static int
+_shared_receiver_get_timeout_ms (void *data)
+{
+	ArvGvStreamThreadData *thread_data = data;
 
-	_flush_frames (thread_data);
+	if (thread_data->n_frames > 0)
+		return thread_data->packet_timeout_us / 1000;
 
-	if (thread_data->callback != NULL)
-		thread_data->callback (thread_data->callback_data, ARV_STREAM_CALLBACK_TYPE_EXIT, NULL);
+	return ARV_GV_STREAM_POLL_TIMEOUT_US / 1000;
+}
 
-	return NULL;
+static void
+_shared_receiver_stop (void *data)
+{
+	ArvGvStreamThreadData *thread_data = data;
+
+	_thread_stop (thread_data);
+
+	g_clear_pointer (&thread_data->receiver_packet, g_free);
 }
 
 /* ArvGvStream implementation */
@@ -1074,6 +3955,60 @@ arv_gv_stream_start_thread (ArvStream *stream)
 	thread_data = priv->thread_data;
 
 	thread_data->cancellable = g_cancellable_new ();
+
+	if (thread_data->record_filename != NULL) {
+		GError *error = NULL;
+
+		thread_data->recorder = arv_packet_recorder_new (thread_data->record_filename,
+								 ARV_PACKET_RECORD_PROTOCOL_GVSP,
+								 thread_data->record_size, &error);
+		if (error != NULL) {
+			arv_warning_stream ("[GvStream::start_thread] %s", error->message);
+			g_clear_error (&error);
+		}
+	}
+
+#if ARAVIS_HAS_PACKET_SOCKET
+	if (thread_data->use_packet_socket && thread_data->ring_size == 0) {
+		g_autoptr (ArvDevice) device = NULL;
+		double frame_rate;
+		gint64 payload;
+		double ring_size;
+
+		g_object_get (stream, "device", &device, NULL);
+
+		payload = arv_device_get_integer_feature_value (device, "PayloadSize", NULL);
+		frame_rate = arv_device_get_float_feature_value (device, "AcquisitionFrameRate", NULL);
+
+		ring_size = (double) payload * frame_rate * ARV_GV_STREAM_RING_AUTO_DURATION_S;
+		thread_data->ring_auto_size = CLAMP (ring_size, ARV_GV_STREAM_RING_SIZE_MIN, ARV_GV_STREAM_RING_SIZE_MAX);
+
+		arv_info_stream ("[GvStream::start_thread] Automatic ring size = %u bytes "
+				 "(payload = %" G_GINT64_FORMAT ", frame rate = %g Hz)",
+				 thread_data->ring_auto_size, payload, frame_rate);
+	}
+#endif
+
+	if (thread_data->use_shared_receiver && thread_data->replay_filename == NULL) {
+		ArvGvReceiverClient *client = &thread_data->receiver_client;
+
+		memset (client, 0, sizeof (ArvGvReceiverClient));
+		client->fd = g_socket_get_fd (thread_data->socket);
+		client->start = _shared_receiver_start;
+		client->receive = _shared_receiver_receive;
+		client->check = _shared_receiver_check;
+		client->get_timeout_ms = _shared_receiver_get_timeout_ms;
+		client->stop = _shared_receiver_stop;
+		client->data = thread_data;
+
+		if (arv_gv_receiver_add (client)) {
+			priv->thread_is_shared = TRUE;
+			return;
+		}
+
+		arv_warning_stream ("[GvStream::start_thread] Shared receiver not available, fall back to a stream thread");
+	}
+
 	priv->thread = g_thread_new ("arv_gv_stream", arv_gv_stream_thread, priv->thread_data);
 }
 
@@ -1083,21 +4018,27 @@ arv_gv_stream_stop_thread (ArvStream *stream)
 	ArvGvStreamPrivate *priv = arv_gv_stream_get_instance_private (ARV_GV_STREAM (stream));
 	ArvGvStreamThreadData *thread_data;
 
-	g_return_if_fail (priv->thread != NULL);
+	g_return_if_fail (priv->thread != NULL || priv->thread_is_shared);
 	g_return_if_fail (priv->thread_data != NULL);
 
 	thread_data = priv->thread_data;
 
 	g_cancellable_cancel (thread_data->cancellable);
-	g_thread_join (priv->thread);
+	if (priv->thread_is_shared)
+		arv_gv_receiver_remove (&thread_data->receiver_client);
+	else
+		g_thread_join (priv->thread);
 	g_clear_object (&thread_data->cancellable);
+	g_clear_pointer (&thread_data->recorder, arv_packet_recorder_free);
 
 	priv->thread = NULL;
+	priv->thread_is_shared = FALSE;
 }
 
 /**
  * arv_gv_stream_new: (skip)
  * @gv_device: a #ArvGvDevice
+ * @channel: stream channel index, selected in @gv_device by the caller during the creation
  * @callback: (scope call): processing callback
  * @callback_data: (closure): user data for @callback
  *
@@ -1105,15 +4046,38 @@ arv_gv_stream_stop_thread (ArvStream *stream)
  */
 
 ArvStream *
-arv_gv_stream_new (ArvGvDevice *gv_device, ArvStreamCallback callback, void *callback_data, GError **error)
+arv_gv_stream_new (ArvGvDevice *gv_device, guint channel,
+		   ArvStreamCallback callback, void *callback_data, GError **error)
 {
 	return g_initable_new (ARV_TYPE_GV_STREAM, NULL, error,
 			       "device", gv_device,
+			       "channel", channel,
 			       "callback", callback,
 			       "callback-data", callback_data,
 			       NULL);
 }
 
+/* A device clock disciplined by PTP is stable, and is worth a longer clock model fitting window */
+
+static gboolean
+_is_ptp_locked (ArvDevice *device)
+{
+	static const char *status_features[] = {"PtpStatus", "GevIEEE1588Status"};
+	guint i;
+
+	for (i = 0; i < G_N_ELEMENTS (status_features); i++) {
+		if (arv_device_is_feature_available (device, status_features[i], NULL)) {
+			const char *status;
+
+			status = arv_device_get_string_feature_value (device, status_features[i], NULL);
+
+			return g_strcmp0 (status, "Slave") == 0 || g_strcmp0 (status, "Master") == 0;
+		}
+	}
+
+	return FALSE;
+}
+
 static void
 arv_gv_stream_constructed (GObject *object)
 {
@@ -1154,6 +4118,8 @@ arv_gv_stream_constructed (GObject *object)
 	thread_data = g_new0 (ArvGvStreamThreadData, 1);
 
 	thread_data->stream = stream;
+	thread_data->event_ring = arv_stream_get_event_ring (stream);
+	thread_data->channel = priv->channel;
 
 	g_object_get (object,
 		      "callback", &thread_data->callback,
@@ -1164,9 +4130,25 @@ arv_gv_stream_constructed (GObject *object)
 	thread_data->packet_request_ratio = ARV_GV_STREAM_PACKET_REQUEST_RATIO_DEFAULT;
 	thread_data->packet_timeout_us = ARV_GV_STREAM_PACKET_TIMEOUT_US_DEFAULT;
 	thread_data->frame_retention_us = ARV_GV_STREAM_FRAME_RETENTION_US_DEFAULT;
+	thread_data->adaptive_packet_timeout = FALSE;
+	thread_data->early_completion = FALSE;
+	thread_data->gv_device = gv_device;
 	thread_data->timestamp_tick_frequency = timestamp_tick_frequency;
 	thread_data->scps_packet_size = packet_size;
+	thread_data->ptp_locked = _is_ptp_locked (ARV_DEVICE (gv_device));
+	thread_data->clock_model = arv_clock_model_new (thread_data->ptp_locked ?
+							ARV_CLOCK_MODEL_N_SAMPLES_PTP :
+							ARV_CLOCK_MODEL_N_SAMPLES_DEFAULT);
 	thread_data->use_packet_socket = (options & ARV_GV_STREAM_OPTION_PACKET_SOCKET_DISABLED) == 0;
+	thread_data->use_batch_receive = (options & ARV_GV_STREAM_OPTION_BATCH_RECEIVE_ENABLED) != 0;
+	thread_data->use_zero_copy = (options & ARV_GV_STREAM_OPTION_ZERO_COPY_ENABLED) != 0;
+	thread_data->use_shared_receiver = (options & ARV_GV_STREAM_OPTION_SHARED_RECEIVER_ENABLED) != 0;
+	thread_data->use_xdp = (options & ARV_GV_STREAM_OPTION_XDP_ENABLED) != 0;
+	thread_data->use_low_latency = (options & ARV_GV_STREAM_OPTION_LOW_LATENCY_ENABLED) != 0;
+	thread_data->use_io_uring = (options & ARV_GV_STREAM_OPTION_IO_URING_ENABLED) != 0;
+	thread_data->use_prefetch = (options & ARV_GV_STREAM_OPTION_PREFETCH_ENABLED) != 0;
+	thread_data->use_hardware_timestamps = ARAVIS_HAS_HARDWARE_TIMESTAMPS &&
+		(options & ARV_GV_STREAM_OPTION_HARDWARE_TIMESTAMPS_ENABLED) != 0;
 
 	thread_data->packet_id = 65300;
 
@@ -1176,6 +4158,52 @@ arv_gv_stream_constructed (GObject *object)
 
 	thread_data->socket_buffer_option = ARV_GV_STREAM_SOCKET_BUFFER_FIXED;
 
+	thread_data->ring_size = 0;
+	thread_data->ring_block_size = ARV_GV_STREAM_RING_BLOCK_SIZE_DEFAULT;
+	thread_data->ring_retire_timeout_ms = ARV_GV_STREAM_RING_RETIRE_TIMEOUT_MS_DEFAULT;
+	thread_data->ring_auto_size = ARV_GV_STREAM_RING_SIZE_MIN;
+
+	thread_data->record_size = ARV_PACKET_RECORDER_SIZE_DEFAULT;
+
+	thread_data->decimation_horizontal = 1;
+	thread_data->decimation_vertical = 1;
+
+	arv_stream_declare_info (stream, "n_completed_buffers", G_TYPE_UINT, &thread_data->n_completed_buffers);
+	arv_stream_declare_info (stream, "n_failures", G_TYPE_UINT, &thread_data->n_failures);
+	arv_stream_declare_info (stream, "n_timeouts", G_TYPE_UINT, &thread_data->n_timeouts);
+	arv_stream_declare_info (stream, "n_underruns", G_TYPE_UINT, &thread_data->n_underruns);
+	arv_stream_declare_info (stream, "n_aborteds", G_TYPE_UINT, &thread_data->n_aborteds);
+	arv_stream_declare_info (stream, "n_missing_frames", G_TYPE_UINT, &thread_data->n_missing_frames);
+	arv_stream_declare_info (stream, "n_reordered_frames", G_TYPE_UINT, &thread_data->n_reordered_frames);
+	arv_stream_declare_info (stream, "n_size_mismatch_errors", G_TYPE_UINT, &thread_data->n_size_mismatch_errors);
+	arv_stream_declare_info (stream, "n_received_packets", G_TYPE_UINT, &thread_data->n_received_packets);
+	arv_stream_declare_info (stream, "n_drained_packets", G_TYPE_UINT, &thread_data->n_drained_packets);
+	arv_stream_declare_info (stream, "n_missing_packets", G_TYPE_UINT, &thread_data->n_missing_packets);
+	arv_stream_declare_info (stream, "n_error_packets", G_TYPE_UINT, &thread_data->n_error_packets);
+	arv_stream_declare_info (stream, "n_ignored_packets", G_TYPE_UINT, &thread_data->n_ignored_packets);
+	arv_stream_declare_info (stream, "n_resend_requests", G_TYPE_UINT, &thread_data->n_resend_requests);
+	arv_stream_declare_info (stream, "n_resent_packets", G_TYPE_UINT, &thread_data->n_resent_packets);
+	arv_stream_declare_info (stream, "n_resend_ratio_reached", G_TYPE_UINT, &thread_data->n_resend_ratio_reached);
+	arv_stream_declare_info (stream, "n_throttled_resend_requests", G_TYPE_UINT, &thread_data->n_throttled_resend_requests);
+	arv_stream_declare_info (stream, "n_early_completions", G_TYPE_UINT, &thread_data->n_early_completions);
+	arv_stream_declare_info (stream, "n_duplicated_packets", G_TYPE_UINT, &thread_data->n_duplicated_packets);
+	arv_stream_declare_info (stream, "n_zero_copy_packets", G_TYPE_UINT, &thread_data->n_zero_copy_packets);
+	arv_stream_declare_info (stream, "n_avoided_allocations", G_TYPE_UINT, &thread_data->n_avoided_allocations);
+	arv_stream_declare_info (stream, "n_prefetched_buffers", G_TYPE_UINT, &thread_data->n_prefetched_buffers);
+	arv_stream_declare_info (stream, "n_copied_bytes", G_TYPE_UINT64, &thread_data->n_copied_bytes);
+	arv_stream_declare_info (stream, "n_zero_copy_bytes", G_TYPE_UINT64, &thread_data->n_zero_copy_bytes);
+	arv_stream_declare_info (stream, "n_unpacked_frames", G_TYPE_UINT, &thread_data->n_unpacked_frames);
+	arv_stream_declare_info (stream, "n_cropped_frames", G_TYPE_UINT, &thread_data->n_cropped_frames);
+	arv_stream_declare_info (stream, "resend_rtt_us", G_TYPE_UINT64, &thread_data->resend_rtt_us);
+	arv_stream_declare_info (stream, "clock_drift_ppm", G_TYPE_DOUBLE, &thread_data->clock_drift_ppm);
+	arv_stream_declare_info (stream, "n_clock_resets", G_TYPE_UINT, &thread_data->n_clock_resets);
+	arv_stream_declare_info (stream, "thread_cpu_percent", G_TYPE_DOUBLE, &thread_data->thread_cpu_percent);
+	arv_stream_declare_info (stream, "socket_buffer_fill", G_TYPE_UINT64, &thread_data->socket_buffer_fill);
+	arv_stream_declare_info (stream, "socket_buffer_capacity", G_TYPE_UINT64, &thread_data->socket_buffer_capacity);
+	arv_stream_declare_info (stream, "socket_buffer_size", G_TYPE_UINT, &thread_data->requested_socket_buffer_size);
+	arv_stream_declare_info (stream, "n_socket_drops", G_TYPE_UINT64, &thread_data->n_socket_drops);
+	arv_stream_declare_statistic (stream, "frame_assembly_time_us", thread_data->statistic, 0);
+
 	priv->thread_data = thread_data;
 
 	interface_address = g_inet_socket_address_get_address (G_INET_SOCKET_ADDRESS (arv_gv_device_get_interface_address (gv_device)));
@@ -1199,19 +4227,65 @@ arv_gv_stream_constructed (GObject *object)
 	arv_device_set_integer_feature_value (ARV_DEVICE (gv_device), "GevSCPHostPort", thread_data->stream_port, NULL);
 	thread_data->source_stream_port = arv_device_get_integer_feature_value (ARV_DEVICE (gv_device), "GevSCSP", NULL);
 
+	arv_info_stream ("[GvStream::stream_new] Stream channel = %d", thread_data->channel);
 	arv_info_stream ("[GvStream::stream_new] Destination stream port = %d", thread_data->stream_port);
 	arv_info_stream ("[GvStream::stream_new] Source stream port = %d", thread_data->source_stream_port);
 
+	/* Without explicit placement, the receive thread and the buffers go to the NUMA node of the network
+	 * controller */
+	{
+		ArvNetworkInterface *iface;
+		int numa_node;
+
+		g_object_get (object, "numa-node", &numa_node, NULL);
+		iface = arv_network_interface_lookup (interface_address);
+		if (numa_node < 0 && iface != NULL && arv_network_interface_get_numa_node (iface) >= 0) {
+			arv_info_stream ("[GvStream::stream_new] Interface %s on NUMA node %d",
+					 arv_network_interface_get_name (iface), arv_network_interface_get_numa_node (iface));
+			g_object_set (object, "numa-node", arv_network_interface_get_numa_node (iface), NULL);
+		}
+		arv_network_interface_free (iface);
+	}
+
+	if ((options & ARV_GV_STREAM_OPTION_NON_TEMPORAL_COPY_ENABLED) != 0)
+		arv_stream_set_copy_kernel (stream, ARV_STREAM_COPY_KERNEL_NON_TEMPORAL);
+
 	arv_gv_stream_start_thread (ARV_STREAM (gv_stream));
 }
 
 /* ArvStream implementation */
 
+/**
+ * arv_gv_stream_configure_shared_receiver:
+ * @n_threads: number of shared receiver threads
+ * @cpus: (array) (allow-none): CPU index for each of the @n_threads threads, or %NULL
+ *
+ * Configures the pool of receiver threads used by the streams created with the
+ * %ARV_GV_STREAM_OPTION_SHARED_RECEIVER_ENABLED option. Each thread services a set of
+ * stream sockets, and is pinned to the corresponding CPU in @cpus, if given. Streams are
+ * assigned to the least loaded thread when they start.
+ *
+ * This function must be called before any stream uses the shared receiver, as the
+ * configuration can't be changed while it is in use. By default, a single unpinned thread
+ * is used.
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_gv_stream_configure_shared_receiver (guint n_threads, const gint *cpus)
+{
+	arv_gv_receiver_configure (n_threads, cpus);
+}
+
 /**
  * arv_gv_stream_get_statistics:
  * @gv_stream: a #ArvGvStream
  * @n_resent_packets: (out)
  * @n_missing_packets: (out)
+ *
+ * The number of frames reusing a previously allocated frame structure is available as the
+ * "n_avoided_allocations" stream info, see arv_stream_get_info_uint64_by_name().
  */
 
 void
@@ -1233,6 +4307,40 @@ arv_gv_stream_get_statistics (ArvGvStream *gv_stream,
 		*n_missing_packets = thread_data->n_missing_packets;
 }
 
+/**
+ * arv_gv_stream_get_resend_statistics:
+ * @gv_stream: a #ArvGvStream
+ * @resend_timeout_us: (out): current resend request timeout, in µs
+ * @resend_rtt_us: (out): smoothed round trip time of the resend requests, in µs, 0 if not measured yet
+ * @n_throttled_requests: (out): number of resend requests postponed because of the device resend bandwidth
+ *
+ * Returns the state of the resend controller. The resend timeout only differs from #ArvGvStream:packet-timeout
+ * if #ArvGvStream:adaptive-packet-timeout is set.
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_gv_stream_get_resend_statistics (ArvGvStream *gv_stream,
+				     guint64 *resend_timeout_us,
+				     guint64 *resend_rtt_us,
+				     guint64 *n_throttled_requests)
+{
+	ArvGvStreamPrivate *priv = arv_gv_stream_get_instance_private (gv_stream);
+	ArvGvStreamThreadData *thread_data;
+
+	g_return_if_fail (ARV_IS_GV_STREAM (gv_stream));
+
+	thread_data = priv->thread_data;
+
+	if (resend_timeout_us != NULL)
+		*resend_timeout_us = _get_resend_timeout (thread_data);
+	if (resend_rtt_us != NULL)
+		*resend_rtt_us = thread_data->resend_rtt_us;
+	if (n_throttled_requests != NULL)
+		*n_throttled_requests = thread_data->n_throttled_resend_requests;
+}
+
 static void
 _get_statistics (ArvStream *stream,
 		 guint64 *n_completed_buffers,
@@ -1277,6 +4385,69 @@ arv_gv_stream_set_property (GObject * object, guint prop_id,
 		case ARV_GV_STREAM_PROPERTY_FRAME_RETENTION:
 			thread_data->frame_retention_us = g_value_get_uint (value);
 			break;
+		case ARV_GV_STREAM_PROPERTY_ADAPTIVE_PACKET_TIMEOUT:
+			thread_data->adaptive_packet_timeout = g_value_get_boolean (value);
+			break;
+		case ARV_GV_STREAM_PROPERTY_EARLY_COMPLETION:
+			thread_data->early_completion = g_value_get_boolean (value);
+			break;
+		case ARV_GV_STREAM_PROPERTY_REORDER_WINDOW:
+			thread_data->reorder_window = g_value_get_uint (value);
+			break;
+		case ARV_GV_STREAM_PROPERTY_RING_SIZE:
+			thread_data->ring_size = g_value_get_uint (value);
+			break;
+		case ARV_GV_STREAM_PROPERTY_RING_BLOCK_SIZE:
+			thread_data->ring_block_size = g_value_get_uint (value);
+			break;
+		case ARV_GV_STREAM_PROPERTY_RING_RETIRE_TIMEOUT:
+			thread_data->ring_retire_timeout_ms = g_value_get_uint (value);
+			break;
+		case ARV_GV_STREAM_PROPERTY_PACKET_SOCKET_INTERFACES:
+			g_free (thread_data->packet_socket_interfaces);
+			thread_data->packet_socket_interfaces = g_value_dup_string (value);
+			break;
+		case ARV_GV_STREAM_PROPERTY_XDP_QUEUE:
+			thread_data->xdp_queue = g_value_get_uint (value);
+			break;
+		case ARV_GV_STREAM_PROPERTY_RECORD_FILENAME:
+			g_free (thread_data->record_filename);
+			thread_data->record_filename = g_value_dup_string (value);
+			break;
+		case ARV_GV_STREAM_PROPERTY_RECORD_SIZE:
+			thread_data->record_size = g_value_get_uint64 (value);
+			break;
+		case ARV_GV_STREAM_PROPERTY_REPLAY_FILENAME:
+			g_free (thread_data->replay_filename);
+			thread_data->replay_filename = g_value_dup_string (value);
+			break;
+		case ARV_GV_STREAM_PROPERTY_REPLAY_REALTIME:
+			thread_data->replay_realtime = g_value_get_boolean (value);
+			break;
+		case ARV_GV_STREAM_PROPERTY_UNPACK_PIXEL_FORMAT:
+			thread_data->unpack_pixel_format = g_value_get_uint (value);
+			break;
+		case ARV_GV_STREAM_PROPERTY_CROP_X:
+			thread_data->crop_x = g_value_get_uint (value);
+			break;
+		case ARV_GV_STREAM_PROPERTY_CROP_Y:
+			thread_data->crop_y = g_value_get_uint (value);
+			break;
+		case ARV_GV_STREAM_PROPERTY_CROP_WIDTH:
+			thread_data->crop_width = g_value_get_uint (value);
+			break;
+		case ARV_GV_STREAM_PROPERTY_CROP_HEIGHT:
+			thread_data->crop_height = g_value_get_uint (value);
+			break;
+		case ARV_GV_STREAM_PROPERTY_DECIMATION_HORIZONTAL:
+			thread_data->decimation_horizontal = g_value_get_uint (value);
+			break;
+		case ARV_GV_STREAM_PROPERTY_DECIMATION_VERTICAL:
+			thread_data->decimation_vertical = g_value_get_uint (value);
+			break;
+		case ARV_GV_STREAM_PROPERTY_CHANNEL:
+			priv->channel = g_value_get_uint (value);
+			break;
 		default:
 			G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
 			break;
@@ -1311,6 +4482,66 @@ arv_gv_stream_get_property (GObject * object, guint prop_id,
 		case ARV_GV_STREAM_PROPERTY_FRAME_RETENTION:
 			g_value_set_uint (value, thread_data->frame_retention_us);
 			break;
+		case ARV_GV_STREAM_PROPERTY_ADAPTIVE_PACKET_TIMEOUT:
+			g_value_set_boolean (value, thread_data->adaptive_packet_timeout);
+			break;
+		case ARV_GV_STREAM_PROPERTY_EARLY_COMPLETION:
+			g_value_set_boolean (value, thread_data->early_completion);
+			break;
+		case ARV_GV_STREAM_PROPERTY_REORDER_WINDOW:
+			g_value_set_uint (value, thread_data->reorder_window);
+			break;
+		case ARV_GV_STREAM_PROPERTY_RING_SIZE:
+			g_value_set_uint (value, thread_data->ring_size);
+			break;
+		case ARV_GV_STREAM_PROPERTY_RING_BLOCK_SIZE:
+			g_value_set_uint (value, thread_data->ring_block_size);
+			break;
+		case ARV_GV_STREAM_PROPERTY_RING_RETIRE_TIMEOUT:
+			g_value_set_uint (value, thread_data->ring_retire_timeout_ms);
+			break;
+		case ARV_GV_STREAM_PROPERTY_PACKET_SOCKET_INTERFACES:
+			g_value_set_string (value, thread_data->packet_socket_interfaces);
+			break;
+		case ARV_GV_STREAM_PROPERTY_XDP_QUEUE:
+			g_value_set_uint (value, thread_data->xdp_queue);
+			break;
+		case ARV_GV_STREAM_PROPERTY_RECORD_FILENAME:
+			g_value_set_string (value, thread_data->record_filename);
+			break;
+		case ARV_GV_STREAM_PROPERTY_RECORD_SIZE:
+			g_value_set_uint64 (value, thread_data->record_size);
+			break;
+		case ARV_GV_STREAM_PROPERTY_REPLAY_FILENAME:
+			g_value_set_string (value, thread_data->replay_filename);
+			break;
+		case ARV_GV_STREAM_PROPERTY_REPLAY_REALTIME:
+			g_value_set_boolean (value, thread_data->replay_realtime);
+			break;
+		case ARV_GV_STREAM_PROPERTY_UNPACK_PIXEL_FORMAT:
+			g_value_set_uint (value, thread_data->unpack_pixel_format);
+			break;
+		case ARV_GV_STREAM_PROPERTY_CROP_X:
+			g_value_set_uint (value, thread_data->crop_x);
+			break;
+		case ARV_GV_STREAM_PROPERTY_CROP_Y:
+			g_value_set_uint (value, thread_data->crop_y);
+			break;
+		case ARV_GV_STREAM_PROPERTY_CROP_WIDTH:
+			g_value_set_uint (value, thread_data->crop_width);
+			break;
+		case ARV_GV_STREAM_PROPERTY_CROP_HEIGHT:
+			g_value_set_uint (value, thread_data->crop_height);
+			break;
+		case ARV_GV_STREAM_PROPERTY_DECIMATION_HORIZONTAL:
+			g_value_set_uint (value, thread_data->decimation_horizontal);
+			break;
+		case ARV_GV_STREAM_PROPERTY_DECIMATION_VERTICAL:
+			g_value_set_uint (value, thread_data->decimation_vertical);
+			break;
+		case ARV_GV_STREAM_PROPERTY_CHANNEL:
+			g_value_set_uint (value, priv->channel);
+			break;
 		default:
 			G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
 			break;
@@ -1352,6 +4583,8 @@ arv_gv_stream_finalize (GObject *object)
 				  thread_data->n_underruns);
 		arv_info_stream ("[GvStream::finalize] n_missing_frames       = %u",
 				  thread_data->n_missing_frames);
+		arv_info_stream ("[GvStream::finalize] n_reordered_frames     = %u",
+				  thread_data->n_reordered_frames);
 
 		arv_info_stream ("[GvStream::finalize] n_size_mismatch_errors = %u",
 				  thread_data->n_size_mismatch_errors);
@@ -1371,8 +4604,32 @@ arv_gv_stream_finalize (GObject *object)
 				  thread_data->n_resent_packets);
 		arv_info_stream ("[GvStream::finalize] n_resend_ratio_reached = %u",
 				  thread_data->n_resend_ratio_reached);
+		arv_info_stream ("[GvStream::finalize] n_throttled_requests   = %u",
+				  thread_data->n_throttled_resend_requests);
+		arv_info_stream ("[GvStream::finalize] n_early_completions    = %u",
+				  thread_data->n_early_completions);
+		arv_info_stream ("[GvStream::finalize] resend_rtt             = %" G_GUINT64_FORMAT " µs",
+				  thread_data->resend_rtt_us);
 		arv_info_stream ("[GvStream::finalize] n_duplicated_packets   = %u",
 				  thread_data->n_duplicated_packets);
+		arv_info_stream ("[GvStream::finalize] n_zero_copy_packets    = %u",
+				  thread_data->n_zero_copy_packets);
+		arv_info_stream ("[GvStream::finalize] n_avoided_allocations  = %u",
+				  thread_data->n_avoided_allocations);
+		arv_info_stream ("[GvStream::finalize] n_copied_bytes         = %" G_GUINT64_FORMAT,
+				  thread_data->n_copied_bytes);
+		arv_info_stream ("[GvStream::finalize] n_zero_copy_bytes      = %" G_GUINT64_FORMAT,
+				  thread_data->n_zero_copy_bytes);
+		arv_info_stream ("[GvStream::finalize] n_unpacked_frames      = %u",
+				  thread_data->n_unpacked_frames);
+		arv_info_stream ("[GvStream::finalize] n_cropped_frames       = %u",
+				  thread_data->n_cropped_frames);
+		arv_info_stream ("[GvStream::finalize] clock_drift            = %g ppm%s",
+				  thread_data->clock_drift_ppm, thread_data->ptp_locked ? " (PTP)" : "");
+		arv_info_stream ("[GvStream::finalize] n_clock_resets         = %u",
+				  thread_data->n_clock_resets);
+
+		arv_clock_model_free (thread_data->clock_model);
 
 		g_clear_object (&thread_data->device_address);
 		g_clear_object (&thread_data->interface_address);
@@ -1380,6 +4637,10 @@ arv_gv_stream_finalize (GObject *object)
 		g_clear_object (&thread_data->interface_socket_address);
 		g_clear_object (&thread_data->socket);
 
+		g_free (thread_data->record_filename);
+		g_free (thread_data->replay_filename);
+		g_free (thread_data->packet_socket_interfaces);
+
 		g_clear_pointer (&thread_data, g_free);
 	}
 
@@ -1449,4 +4710,365 @@ arv_gv_stream_class_init (ArvGvStreamClass *gv_stream_class)
 				   ARV_GV_STREAM_FRAME_RETENTION_US_DEFAULT,
 				   G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)
 		);
+
+	/**
+	 * ArvGvStream:adaptive-packet-timeout:
+	 *
+	 * Derive the resend request timeout from the measured round trip time of the previous requests, instead of
+	 * always waiting for #ArvGvStream:packet-timeout, which stays the upper bound.
+	 *
+	 * Since: 0.8.11
+	 */
+
+	g_object_class_install_property (
+		object_class, ARV_GV_STREAM_PROPERTY_ADAPTIVE_PACKET_TIMEOUT,
+		g_param_spec_boolean ("adaptive-packet-timeout", "Adaptive packet timeout",
+				      "Adapt the resend timeout to the request round trip time",
+				      FALSE,
+				      G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)
+		);
+
+	/**
+	 * ArvGvStream:early-completion:
+	 *
+	 * Deliver a buffer as soon as its leader and all its data blocks are received, without waiting for the
+	 * trailer. A trailer received after the buffer delivery is ignored.
+	 *
+	 * Since: 0.8.11
+	 */
+
+	g_object_class_install_property (
+		object_class, ARV_GV_STREAM_PROPERTY_EARLY_COMPLETION,
+		g_param_spec_boolean ("early-completion", "Early completion",
+				      "Deliver buffers without waiting for the trailer",
+				      FALSE,
+				      G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)
+		);
+
+	/**
+	 * ArvGvStream:reorder-window:
+	 *
+	 * Number of frame ids a frame may arrive late, for example on a link aggregation or a multipath route, and
+	 * still be delivered in frame id order. A frame following missing frames is held until they arrive, or until
+	 * the reorder window or the #ArvGvStream:frame-retention time is exceeded. 0 disables the reordering, late
+	 * frames are then discarded.
+	 *
+	 * Since: 0.8.11
+	 */
+
+	g_object_class_install_property (
+		object_class, ARV_GV_STREAM_PROPERTY_REORDER_WINDOW,
+		g_param_spec_uint ("reorder-window", "Reorder window",
+				   "Maximum frame id distance of a late frame, 0 to disable",
+				   0,
+				   ARV_GV_STREAM_N_FRAMES_MAX - 1,
+				   0,
+				   G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)
+		);
+
+	/**
+	 * ArvGvStream:ring-size:
+	 *
+	 * Size of the packet socket receive ring, in bytes. If 0, the ring is sized for the device payload size and
+	 * frame rate, with a minimum of 32 MB. It is only used by the packet socket method, and is applied when
+	 * the stream thread starts.
+	 *
+	 * Since: 0.8.11
+	 */
+
+	g_object_class_install_property (
+		object_class, ARV_GV_STREAM_PROPERTY_RING_SIZE,
+		g_param_spec_uint ("ring-size", "Ring size",
+				   "Packet socket ring size, in bytes, 0 for automatic",
+				   0,
+				   G_MAXUINT,
+				   0,
+				   G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)
+		);
+
+	/**
+	 * ArvGvStream:ring-block-size:
+	 *
+	 * Size of the packet socket ring blocks, in bytes, rounded up to a power of two multiple of the page size.
+	 *
+	 * Since: 0.8.11
+	 */
+
+	g_object_class_install_property (
+		object_class, ARV_GV_STREAM_PROPERTY_RING_BLOCK_SIZE,
+		g_param_spec_uint ("ring-block-size", "Ring block size",
+				   "Packet socket ring block size, in bytes",
+				   4096,
+				   G_MAXINT,
+				   ARV_GV_STREAM_RING_BLOCK_SIZE_DEFAULT,
+				   G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)
+		);
+
+	/**
+	 * ArvGvStream:ring-retire-timeout:
+	 *
+	 * Time after which a partially filled packet socket ring block is handed to the stream thread, in ms. Lower
+	 * values reduce the latency on low rate streams. If 0, the kernel computes it from the link speed.
+	 *
+	 * Since: 0.8.11
+	 */
+
+	g_object_class_install_property (
+		object_class, ARV_GV_STREAM_PROPERTY_RING_RETIRE_TIMEOUT,
+		g_param_spec_uint ("ring-retire-timeout", "Ring retire timeout",
+				   "Packet socket ring block retire timeout, in ms",
+				   0,
+				   G_MAXUINT,
+				   ARV_GV_STREAM_RING_RETIRE_TIMEOUT_MS_DEFAULT,
+				   G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)
+		);
+
+	/**
+	 * ArvGvStream:packet-socket-interfaces:
+	 *
+	 * Comma separated list of the names of the network interfaces the stream packets are received from by the
+	 * packet socket method, for example the ports of a link aggregation. A ring is bound to each interface, and all
+	 * but the first one are drained by their own thread, the packets being merged into the same frames. If %NULL,
+	 * the interface of the stream address is used. It is applied when the stream thread starts.
+	 *
+	 * Since: 0.8.11
+	 */
+
+	g_object_class_install_property (
+		object_class, ARV_GV_STREAM_PROPERTY_PACKET_SOCKET_INTERFACES,
+		g_param_spec_string ("packet-socket-interfaces", "Packet socket interfaces",
+				     "Comma separated names of the packet socket receive interfaces",
+				     NULL,
+				     G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)
+		);
+
+	/**
+	 * ArvGvStream:xdp-queue:
+	 *
+	 * Receive queue of the network interface the AF_XDP socket is bound to. The stream packets must be steered to
+	 * this queue, for example using an ethtool flow rule. It is applied when the stream thread starts.
+	 *
+	 * Since: 0.8.11
+	 */
+
+	g_object_class_install_property (
+		object_class, ARV_GV_STREAM_PROPERTY_XDP_QUEUE,
+		g_param_spec_uint ("xdp-queue", "XDP queue",
+				   "AF_XDP socket receive queue",
+				   0,
+				   G_MAXUINT,
+				   0,
+				   G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)
+		);
+
+	/**
+	 * ArvGvStream:record-filename:
+	 *
+	 * File the raw stream packets are captured to, with their reception time, if not %NULL. The file is a memory
+	 * mapped ring of #ArvGvStream:record-size bytes, which keeps the most recent packets. It is applied when the
+	 * stream thread starts, and the file is complete once the stream thread is stopped.
+	 *
+	 * Since: 0.8.11
+	 */
+
+	g_object_class_install_property (
+		object_class, ARV_GV_STREAM_PROPERTY_RECORD_FILENAME,
+		g_param_spec_string ("record-filename", "Record filename",
+				     "Raw packet capture file",
+				     NULL,
+				     G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)
+		);
+
+	/**
+	 * ArvGvStream:record-size:
+	 *
+	 * Size of the raw packet capture file, in bytes.
+	 *
+	 * Since: 0.8.11
+	 */
+
+	g_object_class_install_property (
+		object_class, ARV_GV_STREAM_PROPERTY_RECORD_SIZE,
+		g_param_spec_uint64 ("record-size", "Record size",
+				     "Raw packet capture file size, in bytes",
+				     0,
+				     G_MAXUINT64,
+				     ARV_PACKET_RECORDER_SIZE_DEFAULT,
+				     G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)
+		);
+
+	/**
+	 * ArvGvStream:replay-filename:
+	 *
+	 * Raw packet capture, as written using #ArvGvStream:record-filename, fed to the stream reassembly instead of
+	 * the packets received from the device, if not %NULL. Packet resend requests are not sent during a replay. It
+	 * is applied when the stream thread starts.
+	 *
+	 * Since: 0.8.11
+	 */
+
+	g_object_class_install_property (
+		object_class, ARV_GV_STREAM_PROPERTY_REPLAY_FILENAME,
+		g_param_spec_string ("replay-filename", "Replay filename",
+				     "Raw packet capture file to replay",
+				     NULL,
+				     G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)
+		);
+
+	/**
+	 * ArvGvStream:replay-realtime:
+	 *
+	 * Replay the packets at their original pace, instead of as fast as possible.
+	 *
+	 * Since: 0.8.11
+	 */
+
+	g_object_class_install_property (
+		object_class, ARV_GV_STREAM_PROPERTY_REPLAY_REALTIME,
+		g_param_spec_boolean ("replay-realtime", "Replay realtime",
+				      "Replay the packets at their original pace",
+				      FALSE,
+				      G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)
+		);
+
+	/**
+	 * ArvGvStream:unpack-pixel-format:
+	 *
+	 * Pixel format the packed image payloads are converted to while the frames are reassembled, saving the memory
+	 * pass of a later arv_buffer_convert() call, or 0 to keep the received format. Only the conversions from the
+	 * Mono and Bayer 10 and 12 bit packed formats to their 16 bit or same depth unpacked counterparts are done
+	 * this way. The buffers must be large enough for the unpacked image; other frames are delivered in their
+	 * original pixel format, as reported by arv_buffer_get_image_pixel_format(). Zero copy reception is not
+	 * used for the unpacked frames.
+	 *
+	 * Since: 0.8.11
+	 */
+
+	g_object_class_install_property (
+		object_class, ARV_GV_STREAM_PROPERTY_UNPACK_PIXEL_FORMAT,
+		g_param_spec_uint ("unpack-pixel-format", "Unpack pixel format",
+				   "Pixel format the packed payloads are unpacked to",
+				   0, G_MAXUINT32, 0,
+				   G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)
+		);
+
+	/**
+	 * ArvGvStream:crop-x:
+	 *
+	 * Left border of the image region copied to the buffers during the frame reassembly, for devices without a
+	 * hardware region of interest at the needed frame rate. The buffers only need to be large enough for the
+	 * cropped and decimated image, whose geometry is reported by arv_buffer_get_image_region(). The cropping is
+	 * not done for the packed pixel formats, nor for the frames unpacked using #ArvGvStream:unpack-pixel-format,
+	 * and zero copy reception is not used for the cropped frames. The region is read at each frame start.
+	 *
+	 * Since: 0.8.11
+	 */
+
+	g_object_class_install_property (
+		object_class, ARV_GV_STREAM_PROPERTY_CROP_X,
+		g_param_spec_uint ("crop-x", "Crop x",
+				   "Left border of the software region of interest",
+				   0, G_MAXUINT32, 0,
+				   G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)
+		);
+
+	/**
+	 * ArvGvStream:crop-y:
+	 *
+	 * Top border of the image region copied to the buffers, see #ArvGvStream:crop-x.
+	 *
+	 * Since: 0.8.11
+	 */
+
+	g_object_class_install_property (
+		object_class, ARV_GV_STREAM_PROPERTY_CROP_Y,
+		g_param_spec_uint ("crop-y", "Crop y",
+				   "Top border of the software region of interest",
+				   0, G_MAXUINT32, 0,
+				   G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)
+		);
+
+	/**
+	 * ArvGvStream:crop-width:
+	 *
+	 * Width of the image region copied to the buffers, 0 to extend it to the right border of the image, see
+	 * #ArvGvStream:crop-x.
+	 *
+	 * Since: 0.8.11
+	 */
+
+	g_object_class_install_property (
+		object_class, ARV_GV_STREAM_PROPERTY_CROP_WIDTH,
+		g_param_spec_uint ("crop-width", "Crop width",
+				   "Width of the software region of interest",
+				   0, G_MAXUINT32, 0,
+				   G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)
+		);
+
+	/**
+	 * ArvGvStream:crop-height:
+	 *
+	 * Height of the image region copied to the buffers, 0 to extend it to the bottom border of the image, see
+	 * #ArvGvStream:crop-x.
+	 *
+	 * Since: 0.8.11
+	 */
+
+	g_object_class_install_property (
+		object_class, ARV_GV_STREAM_PROPERTY_CROP_HEIGHT,
+		g_param_spec_uint ("crop-height", "Crop height",
+				   "Height of the software region of interest",
+				   0, G_MAXUINT32, 0,
+				   G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)
+		);
+
+	/**
+	 * ArvGvStream:decimation-horizontal:
+	 *
+	 * Only one column out of this number, starting at the left border of the region, is copied to the buffers,
+	 * see #ArvGvStream:crop-x.
+	 *
+	 * Since: 0.8.11
+	 */
+
+	g_object_class_install_property (
+		object_class, ARV_GV_STREAM_PROPERTY_DECIMATION_HORIZONTAL,
+		g_param_spec_uint ("decimation-horizontal", "Horizontal decimation",
+				   "Software horizontal decimation factor",
+				   1, G_MAXUINT16, 1,
+				   G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)
+		);
+
+	/**
+	 * ArvGvStream:decimation-vertical:
+	 *
+	 * Only one row out of this number, starting at the top border of the region, is copied to the buffers, see
+	 * #ArvGvStream:crop-x.
+	 *
+	 * Since: 0.8.11
+	 */
+
+	g_object_class_install_property (
+		object_class, ARV_GV_STREAM_PROPERTY_DECIMATION_VERTICAL,
+		g_param_spec_uint ("decimation-vertical", "Vertical decimation",
+				   "Software vertical decimation factor",
+				   1, G_MAXUINT16, 1,
+				   G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)
+		);
+
+	/**
+	 * ArvGvStream:channel:
+	 *
+	 * Index of the device stream channel received by the stream.
+	 *
+	 * Since: 0.8.11
+	 */
+
+	g_object_class_install_property (
+		object_class, ARV_GV_STREAM_PROPERTY_CHANNEL,
+		g_param_spec_uint ("channel", "Channel",
+				   "Stream channel index",
+				   0, G_MAXUINT16, 0,
+				   G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS)
+		);
 }
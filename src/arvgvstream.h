@@ -36,22 +36,59 @@ G_BEGIN_DECLS
  * ArvGvStreamOption:
  * @ARV_GV_STREAM_OPTION_NONE: no option specified
  * @ARV_GV_STREAM_OPTION_PACKET_SOCKET_DISABLED: use of packet socket is disabled
+ * @ARV_GV_STREAM_OPTION_BATCH_RECEIVE_ENABLED: receive several packets per system call when packet socket is not
+ * used (Since 0.8.11)
+ * @ARV_GV_STREAM_OPTION_ZERO_COPY_ENABLED: receive data blocks directly into the buffer memory when neither packet
+ * socket nor batch receive are used (Since 0.8.11)
+ * @ARV_GV_STREAM_OPTION_SHARED_RECEIVER_ENABLED: receive packets from the shared receiver threads, configured using
+ * arv_gv_stream_configure_shared_receiver(), instead of a dedicated stream thread (Since 0.8.11)
+ * @ARV_GV_STREAM_OPTION_XDP_ENABLED: receive packets from an AF_XDP socket, falling back to the other methods if it is not
+ * available (Since 0.8.11)
+ * @ARV_GV_STREAM_OPTION_HARDWARE_TIMESTAMPS_ENABLED: record the network interface hardware receive timestamps of the
+ * leader and trailer packets, see arv_buffer_get_leader_hardware_timestamp(). Not available with the shared receiver
+ * and AF_XDP methods (Since 0.8.11)
+ * @ARV_GV_STREAM_OPTION_LOW_LATENCY_ENABLED: with the standard socket method, busy poll the network device queue from
+ * the socket receives (SO_BUSY_POLL and SO_PREFER_BUSY_POLL), and drain the socket without blocking before going back
+ * to poll. Best combined with a stream thread pinned to an isolated core, see #ArvStream:cpu-affinity
+ * (Since 0.8.11)
+ * @ARV_GV_STREAM_OPTION_IO_URING_ENABLED: receive the packets with an io_uring multishot recvmsg into a provided
+ * buffer ring, without the privileges of the packet socket method. Needs a Linux 6.0 kernel and %ARAVIS_HAS_IO_URING,
+ * falls back to the other methods otherwise (Since 0.8.11)
+ * @ARV_GV_STREAM_OPTION_PREFETCH_ENABLED: once a frame is half received, take the next input buffer and prefetch
+ * its first pages and the frame bookkeeping, as the recycled buffers were last touched by the consumer from another
+ * core (Since 0.8.11)
+ * @ARV_GV_STREAM_OPTION_NON_TEMPORAL_COPY_ENABLED: copy the payload into the buffers with non-temporal stores,
+ * bypassing the caches of the stream thread, for the frames which are not processed on the cores sharing them, like
+ * recordings, equivalent to selecting %ARV_STREAM_COPY_KERNEL_NON_TEMPORAL using arv_stream_set_copy_kernel()
+ * (Since 0.8.11)
  */
 
 typedef enum {
 	ARV_GV_STREAM_OPTION_NONE = 0,
-	ARV_GV_STREAM_OPTION_PACKET_SOCKET_DISABLED
+	ARV_GV_STREAM_OPTION_PACKET_SOCKET_DISABLED = 1,
+	ARV_GV_STREAM_OPTION_BATCH_RECEIVE_ENABLED = 2,
+	ARV_GV_STREAM_OPTION_ZERO_COPY_ENABLED = 4,
+	ARV_GV_STREAM_OPTION_SHARED_RECEIVER_ENABLED = 8,
+	ARV_GV_STREAM_OPTION_XDP_ENABLED = 16,
+	ARV_GV_STREAM_OPTION_HARDWARE_TIMESTAMPS_ENABLED = 32,
+	ARV_GV_STREAM_OPTION_LOW_LATENCY_ENABLED = 64,
+	ARV_GV_STREAM_OPTION_IO_URING_ENABLED = 128,
+	ARV_GV_STREAM_OPTION_PREFETCH_ENABLED = 256,
+	ARV_GV_STREAM_OPTION_NON_TEMPORAL_COPY_ENABLED = 512
 } ArvGvStreamOption;
 
 /**
  * ArvGvStreamSocketBuffer:
  * @ARV_GV_STREAM_SOCKET_BUFFER_FIXED: socket buffer is set to a given fixed value
  * @ARV_GV_STREAM_SOCKET_BUFFER_AUTO: sockect buffer is set with respect to the payload size
+ * @ARV_GV_STREAM_SOCKET_BUFFER_ADAPTIVE: socket buffer is set with respect to the payload size, and doubled each
+ * time packets are lost, up to #ArvGvStream:socket-buffer-size if set (Since: 0.8.11)
  */
 
 typedef enum {
 	ARV_GV_STREAM_SOCKET_BUFFER_FIXED,
-	ARV_GV_STREAM_SOCKET_BUFFER_AUTO
+	ARV_GV_STREAM_SOCKET_BUFFER_AUTO,
+	ARV_GV_STREAM_SOCKET_BUFFER_ADAPTIVE
 } ArvGvStreamSocketBuffer;
 
 /**
@@ -72,6 +109,12 @@ guint16 	arv_gv_stream_get_port 			(ArvGvStream *gv_stream);
 void		arv_gv_stream_get_statistics		(ArvGvStream *gv_stream,
 							 guint64 *n_resent_packets,
 							 guint64 *n_missing_packets);
+void		arv_gv_stream_get_resend_statistics	(ArvGvStream *gv_stream,
+							 guint64 *resend_timeout_us,
+							 guint64 *resend_rtt_us,
+							 guint64 *n_throttled_requests);
+
+void		arv_gv_stream_configure_shared_receiver	(guint n_threads, const gint *cpus);
 
 G_END_DECLS
 
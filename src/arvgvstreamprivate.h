@@ -33,7 +33,8 @@
 
 G_BEGIN_DECLS
 
-ArvStream * 	arv_gv_stream_new		(ArvGvDevice *gv_device, ArvStreamCallback callback, void *callback_data, GError **error);
+ArvStream * 	arv_gv_stream_new		(ArvGvDevice *gv_device, guint channel,
+						 ArvStreamCallback callback, void *callback_data, GError **error);
 
 G_END_DECLS
 
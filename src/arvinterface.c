@@ -35,6 +35,14 @@
 
 typedef struct {
 	GArray *device_ids;
+
+	/* Valid during a device list update only */
+	const char *expected_device_id;
+	ArvInterfaceDiscoveryFunc discovery_func;
+	gpointer discovery_data;
+	GCancellable *discovery_cancellable;
+	GHashTable *found_device_ids;
+	gboolean expected_device_found;
 } ArvInterfacePrivate;
 
 G_DEFINE_ABSTRACT_TYPE_WITH_CODE (ArvInterface, arv_interface, G_TYPE_OBJECT, G_ADD_PRIVATE (ArvInterface))
@@ -80,17 +88,125 @@ _compare_device_ids (ArvInterfaceDeviceIds **a, ArvInterfaceDeviceIds **b)
 
 void
 arv_interface_update_device_list (ArvInterface *interface)
+{
+	arv_interface_update_device_list_full (interface, NULL, NULL, NULL, NULL);
+}
+
+/*
+ * arv_interface_update_device_list_full:
+ * @interface: a #ArvInterface
+ * @expected_device_id: (allow-none): id of a device which stops the update once found
+ * @func: (allow-none): function called for each found device
+ * @user_data: data passed to @func
+ * @cancellable: (allow-none): a #GCancellable, which stops the update when cancelled
+ *
+ * Updates the internal list of available devices like arv_interface_update_device_list(). Interfaces which discover
+ * their devices over time report them as they appear, the other ones once their enumeration is done. When
+ * @expected_device_id is found, or @cancellable is cancelled, the update stops early, and the device list only
+ * contains the devices found so far.
+ */
+
+void
+arv_interface_update_device_list_full (ArvInterface *interface, const char *expected_device_id,
+				       ArvInterfaceDiscoveryFunc func, gpointer user_data,
+				       GCancellable *cancellable)
 {
 	ArvInterfacePrivate *priv = arv_interface_get_instance_private (interface);
+	unsigned int i;
+
 	g_return_if_fail (ARV_IS_INTERFACE (interface));
 
 	arv_interface_clear_device_ids (interface);
 
+	priv->expected_device_id = expected_device_id;
+	priv->discovery_func = func;
+	priv->discovery_data = user_data;
+	priv->discovery_cancellable = cancellable;
+	priv->found_device_ids = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+	priv->expected_device_found = FALSE;
+
 	ARV_INTERFACE_GET_CLASS (interface)->update_device_list (interface, priv->device_ids);
 
+	/* Report the devices the interface did not report during its discovery */
+	for (i = 0; i < priv->device_ids->len; i++) {
+		ArvInterfaceDeviceIds *ids = g_array_index (priv->device_ids, ArvInterfaceDeviceIds *, i);
+		const char *aliases[] = {ids->physical, NULL};
+
+		if (ids->device != NULL && !g_hash_table_contains (priv->found_device_ids, ids->device))
+			arv_interface_device_found (interface, ids->device, aliases);
+	}
+
+	g_hash_table_unref (priv->found_device_ids);
+	priv->found_device_ids = NULL;
+	priv->expected_device_id = NULL;
+	priv->discovery_func = NULL;
+	priv->discovery_data = NULL;
+	priv->discovery_cancellable = NULL;
+
 	g_array_sort (priv->device_ids, (GCompareFunc) _compare_device_ids);
 }
 
+/*
+ * arv_interface_device_found:
+ * @interface: a #ArvInterface
+ * @device_id: id of the found device
+ * @aliases: (allow-none): %NULL terminated list of the other names of the device
+ *
+ * Reports a device found during a device list update. Subclasses call this function as soon as a device appears,
+ * when their discovery takes time.
+ *
+ * Returns: %TRUE if the discovery should stop, because the expected device was found or the update was cancelled.
+ */
+
+gboolean
+arv_interface_device_found (ArvInterface *interface, const char *device_id, const char * const *aliases)
+{
+	ArvInterfacePrivate *priv = arv_interface_get_instance_private (interface);
+	gboolean is_expected = FALSE;
+	unsigned int i;
+
+	g_return_val_if_fail (ARV_IS_INTERFACE (interface), TRUE);
+	g_return_val_if_fail (device_id != NULL, TRUE);
+
+	if (priv->found_device_ids == NULL)
+		return FALSE;
+
+	if (priv->expected_device_id != NULL) {
+		is_expected = g_strcmp0 (device_id, priv->expected_device_id) == 0;
+		for (i = 0; !is_expected && aliases != NULL && aliases[i] != NULL; i++)
+			is_expected = g_strcmp0 (aliases[i], priv->expected_device_id) == 0;
+	}
+
+	if (!g_hash_table_contains (priv->found_device_ids, device_id)) {
+		g_hash_table_add (priv->found_device_ids, g_strdup (device_id));
+
+		if (priv->discovery_func != NULL)
+			priv->discovery_func (interface, device_id, is_expected, priv->discovery_data);
+	}
+
+	if (is_expected)
+		priv->expected_device_found = TRUE;
+
+	return arv_interface_is_discovery_cancelled (interface);
+}
+
+/*
+ * arv_interface_is_discovery_cancelled:
+ * @interface: a #ArvInterface
+ *
+ * Returns: %TRUE if the current device list update should stop.
+ */
+
+gboolean
+arv_interface_is_discovery_cancelled (ArvInterface *interface)
+{
+	ArvInterfacePrivate *priv = arv_interface_get_instance_private (interface);
+
+	g_return_val_if_fail (ARV_IS_INTERFACE (interface), TRUE);
+
+	return priv->expected_device_found || g_cancellable_is_cancelled (priv->discovery_cancellable);
+}
+
 /**
  * arv_interface_get_n_devices:
  * @interface: a #ArvInterface
@@ -44,6 +44,18 @@ typedef struct {
 	char *serial_nbr;
 } ArvInterfaceDeviceIds;
 
+/* Called for each device found during a device list update, possibly from the interface discovery thread.
+ * @is_expected is TRUE when the device matches the expected device id of the update. */
+typedef void (*ArvInterfaceDiscoveryFunc) (ArvInterface *interface, const char *device_id, gboolean is_expected,
+					   gpointer user_data);
+
+void		arv_interface_update_device_list_full	(ArvInterface *interface, const char *expected_device_id,
+							 ArvInterfaceDiscoveryFunc func, gpointer user_data,
+							 GCancellable *cancellable);
+gboolean	arv_interface_device_found		(ArvInterface *interface, const char *device_id,
+							 const char * const *aliases);
+gboolean	arv_interface_is_discovery_cancelled	(ArvInterface *interface);
+
 G_END_DECLS
 
 #endif
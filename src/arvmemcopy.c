@@ -0,0 +1,245 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2019 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel@gnome.org>
+ */
+
+
+/*
+ * Non-temporal copies write the destination around the caches, for the payloads which are not read back by the
+ * receiving core, like the frames going to disk or to a GPU. When no streaming store is available, they fall back to
+ * memcpy.
+ */
+
+#include <arvmemcopyprivate.h>
+#include <arvdebugprivate.h>
+#include <string.h>
+
+#if defined (__GNUC__) && (defined (__x86_64__) || defined (__i386__))
+#define ARV_MEM_COPY_HAS_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined (__GNUC__) && defined (__aarch64__)
+#define ARV_MEM_COPY_HAS_NEON 1
+#endif
+
+/* Below this size, the store fence costs more than the cache pollution */
+#define ARV_MEM_COPY_NON_TEMPORAL_MIN	256
+
+#ifdef ARV_MEM_COPY_HAS_X86
+
+__attribute__ ((target ("sse2"))) static void
+_copy_non_temporal_sse2 (guint8 *dst, const guint8 *src, size_t size)
+{
+	size_t head = (16 - ((guintptr) dst & 15)) & 15;
+
+	/* Streaming stores need an aligned destination */
+	memcpy (dst, src, head);
+	dst += head;
+	src += head;
+	size -= head;
+
+	for (; size >= 64; size -= 64, dst += 64, src += 64) {
+		__m128i a = _mm_loadu_si128 ((const __m128i *) src);
+		__m128i b = _mm_loadu_si128 ((const __m128i *) (src + 16));
+		__m128i c = _mm_loadu_si128 ((const __m128i *) (src + 32));
+		__m128i d = _mm_loadu_si128 ((const __m128i *) (src + 48));
+
+		_mm_stream_si128 ((__m128i *) dst, a);
+		_mm_stream_si128 ((__m128i *) (dst + 16), b);
+		_mm_stream_si128 ((__m128i *) (dst + 32), c);
+		_mm_stream_si128 ((__m128i *) (dst + 48), d);
+	}
+
+	memcpy (dst, src, size);
+
+	/* The streaming stores are weakly ordered, they must be visible before the buffer is handed to the consumers */
+	_mm_sfence ();
+}
+
+__attribute__ ((target ("avx2"))) static void
+_copy_non_temporal_avx2 (guint8 *dst, const guint8 *src, size_t size)
+{
+	size_t head = (32 - ((guintptr) dst & 31)) & 31;
+
+	memcpy (dst, src, head);
+	dst += head;
+	src += head;
+	size -= head;
+
+	for (; size >= 128; size -= 128, dst += 128, src += 128) {
+		__m256i a = _mm256_loadu_si256 ((const __m256i *) src);
+		__m256i b = _mm256_loadu_si256 ((const __m256i *) (src + 32));
+		__m256i c = _mm256_loadu_si256 ((const __m256i *) (src + 64));
+		__m256i d = _mm256_loadu_si256 ((const __m256i *) (src + 96));
+
+		_mm256_stream_si256 ((__m256i *) dst, a);
+		_mm256_stream_si256 ((__m256i *) (dst + 32), b);
+		_mm256_stream_si256 ((__m256i *) (dst + 64), c);
+		_mm256_stream_si256 ((__m256i *) (dst + 96), d);
+	}
+
+	memcpy (dst, src, size);
+
+	_mm_sfence ();
+}
+
+__attribute__ ((target ("avx512f"))) static void
+_copy_non_temporal_avx512 (guint8 *dst, const guint8 *src, size_t size)
+{
+	size_t head = (64 - ((guintptr) dst & 63)) & 63;
+
+	memcpy (dst, src, head);
+	dst += head;
+	src += head;
+	size -= head;
+
+	for (; size >= 256; size -= 256, dst += 256, src += 256) {
+		__m512i a = _mm512_loadu_si512 ((const void *) src);
+		__m512i b = _mm512_loadu_si512 ((const void *) (src + 64));
+		__m512i c = _mm512_loadu_si512 ((const void *) (src + 128));
+		__m512i d = _mm512_loadu_si512 ((const void *) (src + 192));
+
+		_mm512_stream_si512 ((void *) dst, a);
+		_mm512_stream_si512 ((void *) (dst + 64), b);
+		_mm512_stream_si512 ((void *) (dst + 128), c);
+		_mm512_stream_si512 ((void *) (dst + 192), d);
+	}
+
+	memcpy (dst, src, size);
+
+	_mm_sfence ();
+}
+
+#endif
+
+#ifdef ARV_MEM_COPY_HAS_NEON
+
+/* STNP is only a hint of the absence of reuse, the stores keep the normal memory ordering of the barrier done
+ * before handing the buffer to the consumers */
+
+static void
+_copy_non_temporal_neon (guint8 *dst, const guint8 *src, size_t size)
+{
+	for (; size >= 64; size -= 64, dst += 64, src += 64) {
+		__asm__ volatile ("ldp q0, q1, [%1]\n\t"
+				  "ldp q2, q3, [%1, #32]\n\t"
+				  "stnp q0, q1, [%0]\n\t"
+				  "stnp q2, q3, [%0, #32]\n\t"
+				  : : "r" (dst), "r" (src) : "v0", "v1", "v2", "v3", "memory");
+	}
+
+	memcpy (dst, src, size);
+}
+
+#endif
+
+static gint arv_mem_copy_simd = -1;
+
+gboolean
+arv_mem_copy_is_simd_supported (ArvMemCopySimd simd)
+{
+	switch (simd) {
+		case ARV_MEM_COPY_SIMD_NONE:
+			return TRUE;
+#ifdef ARV_MEM_COPY_HAS_X86
+		case ARV_MEM_COPY_SIMD_SSE2:
+			return __builtin_cpu_supports ("sse2");
+		case ARV_MEM_COPY_SIMD_AVX2:
+			return __builtin_cpu_supports ("avx2");
+		case ARV_MEM_COPY_SIMD_AVX512:
+			return __builtin_cpu_supports ("avx512f");
+#endif
+#ifdef ARV_MEM_COPY_HAS_NEON
+		case ARV_MEM_COPY_SIMD_NEON:
+			return TRUE;
+#endif
+		default:
+			return FALSE;
+	}
+}
+
+/* Selects the widest streaming stores on first use. AVX-512 is not preferred over AVX2, as the streaming stores
+ * are bound by the memory bandwidth, and the wide registers lower the clock of some processors. */
+
+ArvMemCopySimd
+arv_mem_copy_get_simd (void)
+{
+	gint simd = g_atomic_int_get (&arv_mem_copy_simd);
+
+	if (simd < 0) {
+		if (arv_mem_copy_is_simd_supported (ARV_MEM_COPY_SIMD_AVX2))
+			simd = ARV_MEM_COPY_SIMD_AVX2;
+		else if (arv_mem_copy_is_simd_supported (ARV_MEM_COPY_SIMD_SSE2))
+			simd = ARV_MEM_COPY_SIMD_SSE2;
+		else if (arv_mem_copy_is_simd_supported (ARV_MEM_COPY_SIMD_NEON))
+			simd = ARV_MEM_COPY_SIMD_NEON;
+		else
+			simd = ARV_MEM_COPY_SIMD_NONE;
+
+		arv_info_misc ("[MemCopy::get_simd] Using instruction set %d", simd);
+
+		g_atomic_int_set (&arv_mem_copy_simd, simd);
+	}
+
+	return simd;
+}
+
+/* Forces the instruction set, used for comparing the kernels */
+
+gboolean
+arv_mem_copy_set_simd (ArvMemCopySimd simd)
+{
+	if (!arv_mem_copy_is_simd_supported (simd))
+		return FALSE;
+
+	g_atomic_int_set (&arv_mem_copy_simd, simd);
+
+	return TRUE;
+}
+
+void
+arv_mem_copy_non_temporal (void *dst, const void *src, size_t size)
+{
+	if (size >= ARV_MEM_COPY_NON_TEMPORAL_MIN) {
+		switch (arv_mem_copy_get_simd ()) {
+#ifdef ARV_MEM_COPY_HAS_X86
+			case ARV_MEM_COPY_SIMD_AVX512:
+				_copy_non_temporal_avx512 (dst, src, size);
+				return;
+			case ARV_MEM_COPY_SIMD_AVX2:
+				_copy_non_temporal_avx2 (dst, src, size);
+				return;
+			case ARV_MEM_COPY_SIMD_SSE2:
+				_copy_non_temporal_sse2 (dst, src, size);
+				return;
+#endif
+#ifdef ARV_MEM_COPY_HAS_NEON
+			case ARV_MEM_COPY_SIMD_NEON:
+				_copy_non_temporal_neon (dst, src, size);
+				return;
+#endif
+			default:
+				break;
+		}
+	}
+
+	memcpy (dst, src, size);
+}
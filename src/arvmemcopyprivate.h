@@ -0,0 +1,52 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2019 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel@gnome.org>
+ */
+
+#ifndef ARV_MEM_COPY_PRIVATE_H
+#define ARV_MEM_COPY_PRIVATE_H
+
+#if !defined (ARV_H_INSIDE) && !defined (ARAVIS_COMPILATION)
+#error "Only <arv.h> can be included directly."
+#endif
+
+#include <arvtypes.h>
+
+G_BEGIN_DECLS
+
+/* Payload copies of the frame reassembly */
+
+typedef enum {
+	ARV_MEM_COPY_SIMD_NONE,
+	ARV_MEM_COPY_SIMD_SSE2,
+	ARV_MEM_COPY_SIMD_AVX2,
+	ARV_MEM_COPY_SIMD_AVX512,
+	ARV_MEM_COPY_SIMD_NEON
+} ArvMemCopySimd;
+
+ArvMemCopySimd	arv_mem_copy_get_simd		(void);
+gboolean	arv_mem_copy_set_simd		(ArvMemCopySimd simd);
+gboolean	arv_mem_copy_is_simd_supported	(ArvMemCopySimd simd);
+
+void		arv_mem_copy_non_temporal	(void *dst, const void *src, size_t size);
+
+G_END_DECLS
+
+#endif
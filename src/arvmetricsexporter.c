@@ -0,0 +1,585 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2019 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel@gnome.org>
+ */
+
+
+/**
+ * SECTION: arvmetricsexporter
+ * @short_description: OpenMetrics exporter for stream and device statistics
+ *
+ * #ArvMetricsExporter serves the statistics of a set of streams and devices over HTTP, in the OpenMetrics text
+ * format, for a Prometheus scraper. The stream counters are read through the named statistics API (see
+ * arv_stream_get_n_infos()), from a dedicated thread, without any interaction with the stream receive threads.
+ *
+ * The stream statistics which names start with "n_" are exported as counters, the other ones as gauges. The stream
+ * histograms, like the frame assembly time or the output queue dwell time, are exported as summaries, with their
+ * median, 99th and 99.9th percentiles. For the
+ * GigEVision devices, the number of control commands, retries and failures, and a histogram of the command
+ * latencies are exported as well.
+ *
+ * |[<!-- language="C" -->
+ * exporter = arv_metrics_exporter_new (9464, &error);
+ * arv_metrics_exporter_add_device (exporter, "camera_1", arv_camera_get_device (camera));
+ * arv_metrics_exporter_add_stream (exporter, "camera_1", stream);
+ * ]|
+ */
+
+#include <arvmetricsexporter.h>
+#include <arvstreamprivate.h>
+#include <arvdevice.h>
+#include <arvgvdeviceprivate.h>
+#include <arvdebugprivate.h>
+#include <gio/gio.h>
+#include <string.h>
+
+#define ARV_METRICS_EXPORTER_REQUEST_SIZE	4096
+#define ARV_METRICS_EXPORTER_TIMEOUT_S		5
+
+typedef struct {
+	char *name;
+	gboolean is_stream;
+	GWeakRef object;
+} ArvMetricsSource;
+
+typedef struct {
+	char *name;
+	const char *type;
+	GString *samples;
+} ArvMetricsFamily;
+
+struct _ArvMetricsExporter {
+	GObject object;
+
+	GSocketListener *listener;
+	GCancellable *cancellable;
+	GThread *thread;
+	guint16 port;
+
+	GMutex mutex;
+	GPtrArray *sources;
+};
+
+G_DEFINE_TYPE (ArvMetricsExporter, arv_metrics_exporter, G_TYPE_OBJECT)
+
+static void
+_source_free (gpointer data)
+{
+	ArvMetricsSource *source = data;
+
+	g_weak_ref_clear (&source->object);
+	g_free (source->name);
+	g_free (source);
+}
+
+static void
+_add_source (ArvMetricsExporter *exporter, const char *name, GObject *object, gboolean is_stream)
+{
+	ArvMetricsSource *source;
+
+	source = g_new0 (ArvMetricsSource, 1);
+	source->name = g_strdup (name);
+	source->is_stream = is_stream;
+	g_weak_ref_init (&source->object, object);
+
+	g_mutex_lock (&exporter->mutex);
+	g_ptr_array_add (exporter->sources, source);
+	g_mutex_unlock (&exporter->mutex);
+}
+
+/**
+ * arv_metrics_exporter_add_stream:
+ * @exporter: a #ArvMetricsExporter
+ * @name: value of the "stream" label of the metrics
+ * @stream: a #ArvStream
+ *
+ * Adds the statistics of @stream to the exported metrics. The exporter only keeps a weak reference on @stream, the
+ * statistics of a destroyed stream are no longer exported.
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_metrics_exporter_add_stream (ArvMetricsExporter *exporter, const char *name, ArvStream *stream)
+{
+	g_return_if_fail (ARV_IS_METRICS_EXPORTER (exporter));
+	g_return_if_fail (name != NULL);
+	g_return_if_fail (ARV_IS_STREAM (stream));
+
+	_add_source (exporter, name, G_OBJECT (stream), TRUE);
+}
+
+/**
+ * arv_metrics_exporter_add_device:
+ * @exporter: a #ArvMetricsExporter
+ * @name: value of the "device" label of the metrics
+ * @device: a #ArvDevice
+ *
+ * Adds the control channel statistics of @device to the exported metrics. Only #ArvGvDevice instances currently
+ * publish statistics. The exporter only keeps a weak reference on @device.
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_metrics_exporter_add_device (ArvMetricsExporter *exporter, const char *name, ArvDevice *device)
+{
+	g_return_if_fail (ARV_IS_METRICS_EXPORTER (exporter));
+	g_return_if_fail (name != NULL);
+	g_return_if_fail (ARV_IS_DEVICE (device));
+
+	_add_source (exporter, name, G_OBJECT (device), FALSE);
+}
+
+static void
+_family_free (gpointer data)
+{
+	ArvMetricsFamily *family = data;
+
+	g_free (family->name);
+	g_string_free (family->samples, TRUE);
+	g_free (family);
+}
+
+/* Samples of a metric family must be contiguous, the samples of the different sources are grouped by family */
+
+static GString *
+_get_family_samples (GPtrArray *families, const char *name, const char *type)
+{
+	ArvMetricsFamily *family;
+	guint i;
+
+	for (i = 0; i < families->len; i++) {
+		family = g_ptr_array_index (families, i);
+		if (g_strcmp0 (family->name, name) == 0)
+			return family->samples;
+	}
+
+	family = g_new (ArvMetricsFamily, 1);
+	family->name = g_strdup (name);
+	family->type = type;
+	family->samples = g_string_new (NULL);
+
+	g_ptr_array_add (families, family);
+
+	return family->samples;
+}
+
+static char *
+_metric_name (const char *prefix, const char *name)
+{
+	char *metric_name;
+	char *c;
+
+	metric_name = g_strconcat (prefix, name, NULL);
+	for (c = metric_name; *c != '\0'; c++)
+		if (!g_ascii_isalnum (*c) && *c != '_')
+			*c = '_';
+
+	return metric_name;
+}
+
+static char *
+_label_value (const char *value)
+{
+	GString *string;
+	const char *c;
+
+	string = g_string_new (NULL);
+	for (c = value; *c != '\0'; c++) {
+		if (*c == '\\' || *c == '"')
+			g_string_append_c (string, '\\');
+		if (*c == '\n')
+			g_string_append (string, "\\n");
+		else
+			g_string_append_c (string, *c);
+	}
+
+	return g_string_free (string, FALSE);
+}
+
+static void
+_append_double (GString *string, double value)
+{
+	char buffer[G_ASCII_DTOSTR_BUF_SIZE];
+
+	g_string_append (string, g_ascii_dtostr (buffer, sizeof (buffer), value));
+}
+
+static const double arv_metrics_exporter_quantiles[] = { 0.5, 0.99, 0.999 };
+
+static void
+_render_stream (GPtrArray *families, const char *label, ArvStream *stream)
+{
+	guint n_infos;
+	guint n_statistics;
+	guint i, j;
+
+	n_infos = arv_stream_get_n_infos (stream);
+	for (i = 0; i < n_infos; i++) {
+		const char *info_name = arv_stream_get_info_name (stream, i);
+		gboolean is_counter;
+		char *name;
+		GString *samples;
+
+		is_counter = g_str_has_prefix (info_name, "n_") &&
+			arv_stream_get_info_type (stream, i) == G_TYPE_UINT64;
+		name = _metric_name ("aravis_stream_", is_counter ? info_name + 2 : info_name);
+		samples = _get_family_samples (families, name, is_counter ? "counter" : "gauge");
+
+		if (is_counter)
+			g_string_append_printf (samples, "%s_total{stream=\"%s\"} %" G_GUINT64_FORMAT "\n",
+						name, label, arv_stream_get_info_uint64 (stream, i));
+		else {
+			g_string_append_printf (samples, "%s{stream=\"%s\"} ", name, label);
+			_append_double (samples, arv_stream_get_info_double (stream, i));
+			g_string_append_c (samples, '\n');
+		}
+
+		g_free (name);
+	}
+
+	n_statistics = arv_stream_get_n_statistics (stream);
+	for (i = 0; i < n_statistics; i++) {
+		const ArvStatistic *statistic;
+		const char *statistic_name;
+		guint histogram_id;
+		char *name;
+		GString *samples;
+
+		statistic = arv_stream_get_statistic (stream, i, &statistic_name, &histogram_id);
+		name = _metric_name ("aravis_stream_", statistic_name);
+		samples = _get_family_samples (families, name, "summary");
+
+		for (j = 0; j < G_N_ELEMENTS (arv_metrics_exporter_quantiles); j++) {
+			g_string_append_printf (samples, "%s{stream=\"%s\",quantile=\"", name, label);
+			_append_double (samples, arv_metrics_exporter_quantiles[j]);
+			g_string_append_printf (samples, "\"} %d\n",
+						arv_statistic_get_percentile (statistic, histogram_id,
+									      100.0 * arv_metrics_exporter_quantiles[j]));
+		}
+		g_string_append_printf (samples, "%s_count{stream=\"%s\"} %" G_GUINT64_FORMAT "\n",
+					name, label, arv_statistic_get_n_values (statistic, histogram_id));
+
+		g_free (name);
+	}
+}
+
+static void
+_render_device (GPtrArray *families, const char *label, ArvDevice *device)
+{
+	ArvGvDeviceCommandStatistics statistics;
+	GString *samples;
+	guint64 count = 0;
+	guint i;
+
+	if (!ARV_IS_GV_DEVICE (device))
+		return;
+
+	arv_gv_device_get_command_statistics (ARV_GV_DEVICE (device), &statistics);
+
+	samples = _get_family_samples (families, "aravis_gvcp_commands", "counter");
+	g_string_append_printf (samples, "aravis_gvcp_commands_total{device=\"%s\"} %" G_GUINT64_FORMAT "\n",
+				label, statistics.n_commands);
+	samples = _get_family_samples (families, "aravis_gvcp_command_retries", "counter");
+	g_string_append_printf (samples, "aravis_gvcp_command_retries_total{device=\"%s\"} %" G_GUINT64_FORMAT "\n",
+				label, statistics.n_retries);
+	samples = _get_family_samples (families, "aravis_gvcp_command_failures", "counter");
+	g_string_append_printf (samples, "aravis_gvcp_command_failures_total{device=\"%s\"} %" G_GUINT64_FORMAT "\n",
+				label, statistics.n_failures);
+	samples = _get_family_samples (families, "aravis_gvcp_pending_acks", "counter");
+	g_string_append_printf (samples, "aravis_gvcp_pending_acks_total{device=\"%s\"} %" G_GUINT64_FORMAT "\n",
+				label, statistics.n_pending_acks);
+
+	samples = _get_family_samples (families, "aravis_gvcp_command_latency_seconds", "histogram");
+	for (i = 0; i < ARV_GV_DEVICE_N_COMMAND_LATENCY_BOUNDS; i++) {
+		count += statistics.latency_buckets[i];
+		g_string_append_printf (samples, "aravis_gvcp_command_latency_seconds_bucket{device=\"%s\",le=\"", label);
+		_append_double (samples, arv_gv_device_command_latency_bounds_us[i] / 1e6);
+		g_string_append_printf (samples, "\"} %" G_GUINT64_FORMAT "\n", count);
+	}
+	count += statistics.latency_buckets[ARV_GV_DEVICE_N_COMMAND_LATENCY_BOUNDS];
+	g_string_append_printf (samples, "aravis_gvcp_command_latency_seconds_bucket{device=\"%s\",le=\"+Inf\"} %"
+				G_GUINT64_FORMAT "\n", label, count);
+	g_string_append_printf (samples, "aravis_gvcp_command_latency_seconds_sum{device=\"%s\"} ", label);
+	_append_double (samples, statistics.total_time_us / 1e6);
+	g_string_append_printf (samples, "\naravis_gvcp_command_latency_seconds_count{device=\"%s\"} %"
+				G_GUINT64_FORMAT "\n", label, count);
+
+	for (i = 0; i < ARV_GV_DEVICE_N_COMMAND_TYPES; i++) {
+		const char *command = arv_gv_device_command_type_names[i];
+
+		if (statistics.srtt_us[i] == 0)
+			continue;
+
+		samples = _get_family_samples (families, "aravis_gvcp_round_trip_time_seconds", "gauge");
+		g_string_append_printf (samples, "aravis_gvcp_round_trip_time_seconds{device=\"%s\",command=\"%s\"} ",
+					label, command);
+		_append_double (samples, statistics.srtt_us[i] / 1e6);
+		g_string_append_c (samples, '\n');
+		samples = _get_family_samples (families, "aravis_gvcp_round_trip_time_deviation_seconds", "gauge");
+		g_string_append_printf (samples,
+					"aravis_gvcp_round_trip_time_deviation_seconds{device=\"%s\",command=\"%s\"} ",
+					label, command);
+		_append_double (samples, statistics.rttvar_us[i] / 1e6);
+		g_string_append_c (samples, '\n');
+		samples = _get_family_samples (families, "aravis_gvcp_command_timeout_seconds", "gauge");
+		g_string_append_printf (samples, "aravis_gvcp_command_timeout_seconds{device=\"%s\",command=\"%s\"} ",
+					label, command);
+		_append_double (samples, statistics.rto_us[i] / 1e6);
+		g_string_append_c (samples, '\n');
+	}
+}
+
+/**
+ * arv_metrics_exporter_render:
+ * @exporter: a #ArvMetricsExporter
+ *
+ * Returns the current metrics, in the OpenMetrics text format, as served over HTTP.
+ *
+ * Returns: (transfer full): a newly allocated string
+ *
+ * Since: 0.8.11
+ */
+
+char *
+arv_metrics_exporter_render (ArvMetricsExporter *exporter)
+{
+	GPtrArray *families;
+	GString *string;
+	guint i;
+
+	g_return_val_if_fail (ARV_IS_METRICS_EXPORTER (exporter), NULL);
+
+	families = g_ptr_array_new_with_free_func (_family_free);
+
+	g_mutex_lock (&exporter->mutex);
+
+	for (i = 0; i < exporter->sources->len; i++) {
+		ArvMetricsSource *source = g_ptr_array_index (exporter->sources, i);
+		GObject *object;
+		char *label;
+
+		object = g_weak_ref_get (&source->object);
+		if (object == NULL)
+			continue;
+
+		label = _label_value (source->name);
+		if (source->is_stream)
+			_render_stream (families, label, ARV_STREAM (object));
+		else
+			_render_device (families, label, ARV_DEVICE (object));
+		g_free (label);
+
+		g_object_unref (object);
+	}
+
+	g_mutex_unlock (&exporter->mutex);
+
+	string = g_string_new (NULL);
+	for (i = 0; i < families->len; i++) {
+		ArvMetricsFamily *family = g_ptr_array_index (families, i);
+
+		g_string_append_printf (string, "# TYPE %s %s\n", family->name, family->type);
+		g_string_append (string, family->samples->str);
+	}
+	g_string_append (string, "# EOF\n");
+
+	g_ptr_array_unref (families);
+
+	return g_string_free (string, FALSE);
+}
+
+static void
+_serve_connection (ArvMetricsExporter *exporter, GSocketConnection *connection)
+{
+	GInputStream *input;
+	GOutputStream *output;
+	char request[ARV_METRICS_EXPORTER_REQUEST_SIZE];
+	const char *status;
+	const char *content_type;
+	char *header;
+	char *body;
+	gsize size = 0;
+
+	g_socket_set_timeout (g_socket_connection_get_socket (connection), ARV_METRICS_EXPORTER_TIMEOUT_S);
+
+	input = g_io_stream_get_input_stream (G_IO_STREAM (connection));
+	output = g_io_stream_get_output_stream (G_IO_STREAM (connection));
+
+	/* Only the request line matters, the rest of the header is read and ignored */
+	request[0] = '\0';
+	while (size < sizeof (request) - 1) {
+		gssize count;
+
+		count = g_input_stream_read (input, request + size, sizeof (request) - 1 - size,
+					     exporter->cancellable, NULL);
+		if (count <= 0)
+			break;
+
+		size += count;
+		request[size] = '\0';
+
+		if (strstr (request, "\r\n\r\n") != NULL)
+			break;
+	}
+
+	if (g_str_has_prefix (request, "GET /metrics ") ||
+	    g_str_has_prefix (request, "GET /metrics?")) {
+		status = "200 OK";
+		content_type = "application/openmetrics-text; version=1.0.0; charset=utf-8";
+		body = arv_metrics_exporter_render (exporter);
+	} else {
+		status = "404 Not Found";
+		content_type = "text/plain; charset=utf-8";
+		body = g_strdup ("Not found\n");
+	}
+
+	header = g_strdup_printf ("HTTP/1.0 %s\r\n"
+				  "Content-Type: %s\r\n"
+				  "Content-Length: %" G_GSIZE_FORMAT "\r\n"
+				  "Connection: close\r\n"
+				  "\r\n", status, content_type, strlen (body));
+
+	if (g_output_stream_write_all (output, header, strlen (header), NULL, exporter->cancellable, NULL))
+		g_output_stream_write_all (output, body, strlen (body), NULL, exporter->cancellable, NULL);
+
+	g_io_stream_close (G_IO_STREAM (connection), NULL, NULL);
+
+	g_free (header);
+	g_free (body);
+}
+
+static void *
+_exporter_thread (void *data)
+{
+	ArvMetricsExporter *exporter = data;
+
+	while (!g_cancellable_is_cancelled (exporter->cancellable)) {
+		GSocketConnection *connection;
+		GError *error = NULL;
+
+		connection = g_socket_listener_accept (exporter->listener, NULL, exporter->cancellable, &error);
+		if (connection == NULL) {
+			if (!g_error_matches (error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+				arv_warning_misc ("[MetricsExporter::thread] Accept error: %s", error->message);
+			g_clear_error (&error);
+			continue;
+		}
+
+		_serve_connection (exporter, connection);
+
+		g_object_unref (connection);
+	}
+
+	return NULL;
+}
+
+/**
+ * arv_metrics_exporter_new:
+ * @port: TCP port, 0 for an automatically chosen one
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Creates an exporter listening on all the interfaces, and serving the metrics at the /metrics path. The requests
+ * are handled by a dedicated thread, until the exporter is destroyed.
+ *
+ * Returns: (transfer full): a new #ArvMetricsExporter, %NULL on error
+ *
+ * Since: 0.8.11
+ */
+
+ArvMetricsExporter *
+arv_metrics_exporter_new (guint16 port, GError **error)
+{
+	ArvMetricsExporter *exporter;
+	GError *local_error = NULL;
+
+	exporter = g_object_new (ARV_TYPE_METRICS_EXPORTER, NULL);
+
+	if (port == 0)
+		port = g_socket_listener_add_any_inet_port (exporter->listener, NULL, &local_error);
+	else
+		g_socket_listener_add_inet_port (exporter->listener, port, NULL, &local_error);
+
+	if (local_error != NULL) {
+		g_propagate_error (error, local_error);
+		g_object_unref (exporter);
+		return NULL;
+	}
+
+	exporter->port = port;
+	exporter->thread = g_thread_new ("arv_metrics", _exporter_thread, exporter);
+
+	arv_info_misc ("[MetricsExporter::new] Listening on port %d", port);
+
+	return exporter;
+}
+
+/**
+ * arv_metrics_exporter_get_port:
+ * @exporter: a #ArvMetricsExporter
+ *
+ * Returns: the TCP port the exporter listens on
+ *
+ * Since: 0.8.11
+ */
+
+guint16
+arv_metrics_exporter_get_port (ArvMetricsExporter *exporter)
+{
+	g_return_val_if_fail (ARV_IS_METRICS_EXPORTER (exporter), 0);
+
+	return exporter->port;
+}
+
+static void
+arv_metrics_exporter_init (ArvMetricsExporter *exporter)
+{
+	exporter->listener = g_socket_listener_new ();
+	exporter->cancellable = g_cancellable_new ();
+	exporter->sources = g_ptr_array_new_with_free_func (_source_free);
+	g_mutex_init (&exporter->mutex);
+}
+
+static void
+arv_metrics_exporter_finalize (GObject *object)
+{
+	ArvMetricsExporter *exporter = ARV_METRICS_EXPORTER (object);
+
+	g_cancellable_cancel (exporter->cancellable);
+	if (exporter->thread != NULL)
+		g_thread_join (exporter->thread);
+
+	g_socket_listener_close (exporter->listener);
+	g_clear_object (&exporter->listener);
+	g_clear_object (&exporter->cancellable);
+	g_clear_pointer (&exporter->sources, g_ptr_array_unref);
+	g_mutex_clear (&exporter->mutex);
+
+	G_OBJECT_CLASS (arv_metrics_exporter_parent_class)->finalize (object);
+}
+
+static void
+arv_metrics_exporter_class_init (ArvMetricsExporterClass *exporter_class)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS (exporter_class);
+
+	object_class->finalize = arv_metrics_exporter_finalize;
+}
@@ -0,0 +1,48 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2019 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel@gnome.org>
+ */
+
+
+#ifndef ARV_METRICS_EXPORTER_H
+#define ARV_METRICS_EXPORTER_H
+
+#if !defined (ARV_H_INSIDE) && !defined (ARAVIS_COMPILATION)
+#error "Only <arv.h> can be included directly."
+#endif
+
+#include <arvtypes.h>
+
+G_BEGIN_DECLS
+
+#define ARV_TYPE_METRICS_EXPORTER             (arv_metrics_exporter_get_type ())
+G_DECLARE_FINAL_TYPE (ArvMetricsExporter, arv_metrics_exporter, ARV, METRICS_EXPORTER, GObject)
+
+ArvMetricsExporter *	arv_metrics_exporter_new		(guint16 port, GError **error);
+guint16			arv_metrics_exporter_get_port		(ArvMetricsExporter *exporter);
+void			arv_metrics_exporter_add_stream		(ArvMetricsExporter *exporter, const char *name,
+								 ArvStream *stream);
+void			arv_metrics_exporter_add_device		(ArvMetricsExporter *exporter, const char *name,
+								 ArvDevice *device);
+char *			arv_metrics_exporter_render		(ArvMetricsExporter *exporter);
+
+G_END_DECLS
+
+#endif
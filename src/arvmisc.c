@@ -30,6 +30,11 @@
 /**
  * SECTION: arvstatistic
  * @short_description: An histogram tool
+ *
+ * The histograms can be filled from the stream receive threads and read at the same time from a monitoring thread.
+ * All the fields are updated with relaxed atomic operations, which costs a few cycles per value. A reader sees each
+ * field consistently, but not necessarily all the fields at the same instant: a percentile computed during a fill
+ * can be off by the value being added.
  */
 
 typedef struct _ArvHistogram ArvHistogram;
@@ -43,6 +48,8 @@ struct _ArvHistogram {
 	int 	      	worst;
 	int 	        best;
 
+	guint64		n_values;
+
 	guint64 *	bins;
 };
 
@@ -123,6 +130,8 @@ arv_statistic_free (ArvStatistic *statistic)
 	_arv_statistic_free (statistic);
 }
 
+/* Must not be called concurrently with arv_statistic_fill() */
+
 void
 arv_statistic_reset (ArvStatistic *statistic)
 {
@@ -131,17 +140,19 @@ arv_statistic_reset (ArvStatistic *statistic)
 
 	g_return_if_fail (statistic != NULL);
 
-	statistic->counter = 0;
+	__atomic_store_n (&statistic->counter, 0, __ATOMIC_RELAXED);
 
 	for (j = 0; j < statistic->n_histograms; j++) {
 		histogram = &statistic->histograms[j];
 
-		histogram->last_seen_worst = 0;
-		histogram->best = 0x7fffffff;
-		histogram->worst = 0x80000000;
-		histogram->and_more = histogram->and_less = 0;
+		__atomic_store_n (&histogram->last_seen_worst, 0, __ATOMIC_RELAXED);
+		__atomic_store_n (&histogram->best, G_MAXINT, __ATOMIC_RELAXED);
+		__atomic_store_n (&histogram->worst, G_MININT, __ATOMIC_RELAXED);
+		__atomic_store_n (&histogram->n_values, 0, __ATOMIC_RELAXED);
+		__atomic_store_n (&histogram->and_more, 0, __ATOMIC_RELAXED);
+		__atomic_store_n (&histogram->and_less, 0, __ATOMIC_RELAXED);
 		for (i = 0; i < statistic->n_bins; i++)
-			histogram->bins[i] = 0;
+			__atomic_store_n (&histogram->bins[i], 0, __ATOMIC_RELAXED);
 	}
 }
 
@@ -180,40 +191,146 @@ arv_statistic_fill (ArvStatistic *statistic, guint histogram_id, int value, guin
 {
 	ArvHistogram *histogram;
 	unsigned int class;
+	int extremum;
 
 	if (statistic == NULL)
 		return FALSE;
 	if (histogram_id >= statistic->n_histograms)
 		return FALSE;
 
-	statistic->counter = counter;
+	__atomic_store_n (&statistic->counter, counter, __ATOMIC_RELAXED);
 
 	histogram = &statistic->histograms[histogram_id];
 
-	if (histogram->best > value)
-		histogram->best = value;
+	extremum = __atomic_load_n (&histogram->best, __ATOMIC_RELAXED);
+	while (extremum > value &&
+	       !__atomic_compare_exchange_n (&histogram->best, &extremum, value, TRUE,
+					     __ATOMIC_RELAXED, __ATOMIC_RELAXED));
 
-	if (histogram->worst < value) {
-		histogram->worst = value;
-		histogram->last_seen_worst = counter;
+	extremum = __atomic_load_n (&histogram->worst, __ATOMIC_RELAXED);
+	while (extremum < value) {
+		if (__atomic_compare_exchange_n (&histogram->worst, &extremum, value, TRUE,
+						 __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+			__atomic_store_n (&histogram->last_seen_worst, counter, __ATOMIC_RELAXED);
+			break;
+		}
 	}
 
 	class = (value - statistic->offset) / statistic->bin_step;
 
 	if (value < statistic->offset)
-		histogram->and_less++;
+		__atomic_fetch_add (&histogram->and_less, 1, __ATOMIC_RELAXED);
 	else if (class >= statistic->n_bins)
-		histogram->and_more++;
+		__atomic_fetch_add (&histogram->and_more, 1, __ATOMIC_RELAXED);
 	else
-		histogram->bins[class]++;
+		__atomic_fetch_add (&histogram->bins[class], 1, __ATOMIC_RELAXED);
+
+	__atomic_fetch_add (&histogram->n_values, 1, __ATOMIC_RELAXED);
 
 	return TRUE;
 }
 
+guint64
+arv_statistic_get_n_values (const ArvStatistic *statistic, guint histogram_id)
+{
+	g_return_val_if_fail (statistic != NULL, 0);
+	g_return_val_if_fail (histogram_id < statistic->n_histograms, 0);
+
+	return __atomic_load_n (&statistic->histograms[histogram_id].n_values, __ATOMIC_RELAXED);
+}
+
+/* Returns 0 if the histogram is empty */
+
+int
+arv_statistic_get_min (const ArvStatistic *statistic, guint histogram_id)
+{
+	int best;
+
+	g_return_val_if_fail (statistic != NULL, 0);
+	g_return_val_if_fail (histogram_id < statistic->n_histograms, 0);
+
+	best = __atomic_load_n (&statistic->histograms[histogram_id].best, __ATOMIC_RELAXED);
+
+	return best != G_MAXINT ? best : 0;
+}
+
+int
+arv_statistic_get_max (const ArvStatistic *statistic, guint histogram_id)
+{
+	int worst;
+
+	g_return_val_if_fail (statistic != NULL, 0);
+	g_return_val_if_fail (histogram_id < statistic->n_histograms, 0);
+
+	worst = __atomic_load_n (&statistic->histograms[histogram_id].worst, __ATOMIC_RELAXED);
+
+	return worst != G_MININT ? worst : 0;
+}
+
+/**
+ * arv_statistic_get_percentile: (skip)
+ * @statistic: a #ArvStatistic
+ * @histogram_id: histogram index
+ * @percentile: percentile, between 0 and 100
+ *
+ * Returns the upper bound of the bin containing the requested percentile, clamped to the observed extremes. The
+ * precision is the bin step.
+ *
+ * Returns: the percentile value, 0 if the histogram is empty
+ */
+
+int
+arv_statistic_get_percentile (const ArvStatistic *statistic, guint histogram_id, double percentile)
+{
+	const ArvHistogram *histogram;
+	guint64 n_values;
+	guint64 rank;
+	guint64 cumulative;
+	unsigned int i;
+	int best, worst;
+
+	g_return_val_if_fail (statistic != NULL, 0);
+	g_return_val_if_fail (histogram_id < statistic->n_histograms, 0);
+
+	histogram = &statistic->histograms[histogram_id];
+
+	n_values = __atomic_load_n (&histogram->n_values, __ATOMIC_RELAXED);
+	if (n_values == 0)
+		return 0;
+
+	best = arv_statistic_get_min (statistic, histogram_id);
+	worst = arv_statistic_get_max (statistic, histogram_id);
+
+	rank = ceil (CLAMP (percentile, 0.0, 100.0) * n_values / 100.0);
+	rank = CLAMP (rank, 1, n_values);
+
+	cumulative = __atomic_load_n (&histogram->and_less, __ATOMIC_RELAXED);
+	if (cumulative >= rank)
+		return best;
+
+	for (i = 0; i < statistic->n_bins; i++) {
+		cumulative += __atomic_load_n (&histogram->bins[i], __ATOMIC_RELAXED);
+		if (cumulative >= rank)
+			return CLAMP ((int) ((i + 1) * statistic->bin_step) + statistic->offset, best, worst);
+	}
+
+	return worst;
+}
+
+static const struct {
+	const char *label;
+	double percentile;
+} arv_statistic_percentiles[] = {
+	{ "p50     ", 50.0 },
+	{ "p99     ", 99.0 },
+	{ "p999    ", 99.9 }
+};
+
 char *
 arv_statistic_to_string (const ArvStatistic *statistic)
 {
 	int i, j, bin_max;
+	unsigned int k;
 	gboolean max_found = FALSE;
 	GString *string;
 	char *str;
@@ -225,7 +342,7 @@ arv_statistic_to_string (const ArvStatistic *statistic)
 	bin_max = 0;
 	for (i = statistic->n_bins - 1; i > 0 && !max_found; i--) {
 		for (j = 0; j < statistic->n_histograms && !max_found; j++) {
-			if (statistic->histograms[j].bins[i] != 0) {
+			if (__atomic_load_n (&statistic->histograms[j].bins[i], __ATOMIC_RELAXED) != 0) {
 				bin_max = i;
 				max_found = TRUE;
 			}
@@ -249,7 +366,8 @@ arv_statistic_to_string (const ArvStatistic *statistic)
 		for (j = 0; j < statistic->n_histograms; j++) {
 			if (j == 0)
 				g_string_append_printf (string, "%8d", i * statistic->bin_step + statistic->offset);
-			g_string_append_printf (string, ";%8llu", (unsigned long long) statistic->histograms[j].bins[i]);
+			g_string_append_printf (string, ";%8llu", (unsigned long long)
+						__atomic_load_n (&statistic->histograms[j].bins[i], __ATOMIC_RELAXED));
 		}
 		g_string_append (string, "\n");
 	}
@@ -259,22 +377,24 @@ arv_statistic_to_string (const ArvStatistic *statistic)
 	for (j = 0; j < statistic->n_histograms; j++) {
 		if (j == 0)
 			g_string_append_printf (string, ">=%6d", i * statistic->bin_step + statistic->offset);
-		g_string_append_printf (string, ";%8llu", (unsigned long long) statistic->histograms[j].and_more);
+		g_string_append_printf (string, ";%8llu", (unsigned long long)
+					__atomic_load_n (&statistic->histograms[j].and_more, __ATOMIC_RELAXED));
 	}
 	g_string_append (string, "\n");
 
 	for (j = 0; j < statistic->n_histograms; j++) {
 		if (j == 0)
 			g_string_append_printf (string, "< %6d", statistic->offset);
-		g_string_append_printf (string, ";%8llu", (unsigned long long) statistic->histograms[j].and_less);
+		g_string_append_printf (string, ";%8llu", (unsigned long long)
+					__atomic_load_n (&statistic->histograms[j].and_less, __ATOMIC_RELAXED));
 	}
 	g_string_append (string, "\n");
 
 	for (j = 0; j < statistic->n_histograms; j++) {
 		if (j == 0)
 			g_string_append (string, "min     ");
-		if (statistic->histograms[j].best != 0x7fffffff)
-			g_string_append_printf (string, ";%8d", statistic->histograms[j].best);
+		if (arv_statistic_get_n_values (statistic, j) > 0)
+			g_string_append_printf (string, ";%8d", arv_statistic_get_min (statistic, j));
 		else
 			g_string_append_printf (string, ";%8s", "n/a");
 	}
@@ -283,21 +403,37 @@ arv_statistic_to_string (const ArvStatistic *statistic)
 	for (j = 0; j < statistic->n_histograms; j++) {
 		if (j == 0)
 			g_string_append (string, "max     ");
-		if (statistic->histograms[j].worst != 0x80000000)
-			g_string_append_printf (string, ";%8d", statistic->histograms[j].worst);
+		if (arv_statistic_get_n_values (statistic, j) > 0)
+			g_string_append_printf (string, ";%8d", arv_statistic_get_max (statistic, j));
 		else
 			g_string_append_printf (string, ";%8s", "n/a");
 	}
 	g_string_append (string, "\n");
 
+	for (k = 0; k < G_N_ELEMENTS (arv_statistic_percentiles); k++) {
+		for (j = 0; j < statistic->n_histograms; j++) {
+			if (j == 0)
+				g_string_append (string, arv_statistic_percentiles[k].label);
+			if (arv_statistic_get_n_values (statistic, j) > 0)
+				g_string_append_printf (string, ";%8d",
+							arv_statistic_get_percentile (statistic, j,
+										      arv_statistic_percentiles[k].percentile));
+			else
+				g_string_append_printf (string, ";%8s", "n/a");
+		}
+		g_string_append (string, "\n");
+	}
+
 	for (j = 0; j < statistic->n_histograms; j++) {
 		if (j == 0)
 			g_string_append (string, "last max\nat:     ");
-		g_string_append_printf (string, ";%8llu", (unsigned long long) statistic->histograms[j].last_seen_worst);
+		g_string_append_printf (string, ";%8llu", (unsigned long long)
+					__atomic_load_n (&statistic->histograms[j].last_seen_worst, __ATOMIC_RELAXED));
 	}
 	g_string_append (string, "\n");
 
-	g_string_append_printf (string, "Counter = %8llu", (unsigned long long) statistic->counter);
+	g_string_append_printf (string, "Counter = %8llu", (unsigned long long)
+				__atomic_load_n (&statistic->counter, __ATOMIC_RELAXED));
 
 	str = string->str;
 	g_string_free (string, FALSE);
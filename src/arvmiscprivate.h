@@ -34,6 +34,12 @@ gboolean 		arv_statistic_fill 		(ArvStatistic *statistic, guint histogram_id, in
 							 guint64 counter);
 void 			arv_statistic_set_name 		(ArvStatistic *statistic, guint histogram_id, char const *name);
 
+guint64			arv_statistic_get_n_values	(const ArvStatistic *statistic, guint histogram_id);
+int			arv_statistic_get_min		(const ArvStatistic *statistic, guint histogram_id);
+int			arv_statistic_get_max		(const ArvStatistic *statistic, guint histogram_id);
+int			arv_statistic_get_percentile	(const ArvStatistic *statistic, guint histogram_id,
+							 double percentile);
+
 char *			arv_statistic_to_string 	(const ArvStatistic *statistic);
 
 struct _ArvValue {
@@ -27,7 +27,18 @@
 
 #ifndef G_OS_WIN32
 	#include <ifaddrs.h>
-#else
+	#include <sys/ioctl.h>
+	#include <unistd.h>
+	#include <string.h>
+	#include <errno.h>
+#endif
+
+#ifdef __linux__
+	#include <linux/netlink.h>
+	#include <linux/rtnetlink.h>
+#endif
+
+#ifdef G_OS_WIN32
 	#include <winsock2.h>
 	#include <iphlpapi.h>
 	#include <winnt.h>	/* For PWCHAR */
@@ -38,6 +49,10 @@ struct _ArvNetworkInterface{
 	struct sockaddr *netmask;
 	struct sockaddr *broadaddr;
 	char* name;
+	guint index;
+	guint mtu;
+	guint link_speed;
+	int numa_node;
 };
 
 #ifdef G_OS_WIN32
@@ -186,6 +201,12 @@ arv_enumerate_network_interfaces (void)
 			if (!ok) continue;
 
 			a = (ArvNetworkInterface*) g_malloc0(sizeof(ArvNetworkInterface));
+			a->index = pAddrIter->IfIndex;
+			a->mtu = pAddrIter->Mtu;
+			#if WINVER >= _WIN32_WINNT_VISTA
+				a->link_speed = pAddrIter->ReceiveLinkSpeed / 1000000;
+			#endif
+			a->numa_node = -1;
 			if (lpSockaddr->sa_family == AF_INET){
 				struct sockaddr_in* mask;
 				struct sockaddr_in* broadaddr;
@@ -337,11 +358,136 @@ arv_gpollfd_finish_all (GPollFD *fds, guint nfds){
 	}
 }
 
+void
+arv_network_shutdown (void)
+{
+}
+
 
 #else /* not G_OS_WIN32 */
 
-GList*
-arv_enumerate_network_interfaces (void)
+/* The interface table is cached. On Linux, a netlink socket subscribed to the address and link changes invalidates
+ * the cache, which is checked without blocking at each call. Elsewhere, the interfaces are enumerated at each
+ * call. */
+
+static GMutex arv_network_interfaces_mutex;
+static GList *arv_network_interfaces = NULL;
+static gboolean arv_network_interfaces_valid = FALSE;
+#ifdef __linux__
+static int arv_network_netlink_fd = -1;
+static gboolean arv_network_netlink_initialized = FALSE;
+#endif
+
+#ifdef __linux__
+
+static gint64
+_read_sysfs_integer (const char *interface_name, const char *attribute, gint64 default_value)
+{
+	g_autofree char *path = NULL;
+	g_autofree char *contents = NULL;
+
+	path = g_build_filename ("/sys/class/net", interface_name, attribute, NULL);
+	if (!g_file_get_contents (path, &contents, NULL, NULL))
+		return default_value;
+
+	return g_ascii_strtoll (contents, NULL, 10);
+}
+
+/* Must be called with the interface table mutex held */
+
+static void
+_netlink_check_changes (void)
+{
+	char buffer[8192] __attribute__ ((aligned (__alignof__ (struct nlmsghdr))));
+
+	if (!arv_network_netlink_initialized) {
+		arv_network_netlink_initialized = TRUE;
+
+		arv_network_netlink_fd = socket (AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
+		if (arv_network_netlink_fd >= 0) {
+			struct sockaddr_nl address;
+
+			memset (&address, 0, sizeof (address));
+			address.nl_family = AF_NETLINK;
+			address.nl_groups = RTMGRP_LINK | RTMGRP_IPV4_IFADDR;
+
+			if (bind (arv_network_netlink_fd, (struct sockaddr *) &address, sizeof (address)) != 0) {
+				close (arv_network_netlink_fd);
+				arv_network_netlink_fd = -1;
+			}
+		}
+
+		if (arv_network_netlink_fd < 0)
+			arv_info_misc ("[Network::check_changes] No netlink change notification (%s),"
+				       " the interfaces are enumerated at each call", strerror (errno));
+	}
+
+	if (arv_network_netlink_fd < 0) {
+		arv_network_interfaces_valid = FALSE;
+		return;
+	}
+
+	for (;;) {
+		struct nlmsghdr *header;
+		ssize_t size;
+
+		size = recv (arv_network_netlink_fd, buffer, sizeof (buffer), MSG_DONTWAIT);
+		if (size < 0) {
+			/* Overrun of the socket queue, some changes were lost */
+			if (errno == ENOBUFS) {
+				arv_network_interfaces_valid = FALSE;
+				continue;
+			}
+			break;
+		}
+		if (size == 0)
+			break;
+
+		for (header = (struct nlmsghdr *) buffer; NLMSG_OK (header, (size_t) size);
+		     header = NLMSG_NEXT (header, size))
+			if (header->nlmsg_type == RTM_NEWADDR || header->nlmsg_type == RTM_DELADDR ||
+			    header->nlmsg_type == RTM_NEWLINK || header->nlmsg_type == RTM_DELLINK)
+				arv_network_interfaces_valid = FALSE;
+	}
+}
+
+#endif
+
+static void
+_fill_link_infos (ArvNetworkInterface *a)
+{
+	struct ifreq request;
+	int fd;
+
+	a->index = if_nametoindex (a->name);
+	a->numa_node = -1;
+
+	memset (&request, 0, sizeof (request));
+	g_strlcpy (request.ifr_name, a->name, sizeof (request.ifr_name));
+	fd = socket (AF_INET, SOCK_DGRAM, 0);
+	if (fd >= 0) {
+		if (ioctl (fd, SIOCGIFMTU, &request) == 0 && request.ifr_mtu > 0)
+			a->mtu = request.ifr_mtu;
+		close (fd);
+	}
+
+#ifdef __linux__
+	{
+		gint64 speed;
+
+		/* -1, or a read error, while the link is down */
+		speed = _read_sysfs_integer (a->name, "speed", 0);
+		a->link_speed = speed > 0 ? speed : 0;
+		/* Only available for interfaces backed by a PCI device */
+		a->numa_node = _read_sysfs_integer (a->name, "device/numa_node", -1);
+		if (a->numa_node < 0)
+			a->numa_node = -1;
+	}
+#endif
+}
+
+static GList *
+_enumerate_network_interfaces (void)
 {
 	struct ifaddrs *ifap = NULL;
 	struct ifaddrs *ifap_iter;
@@ -366,8 +512,11 @@ arv_enumerate_network_interfaces (void)
 			if (ifap_iter->ifa_ifu.ifu_broadaddr)
 				a->broadaddr = arv_memdup(ifap_iter->ifa_ifu.ifu_broadaddr, sizeof(struct sockaddr));
 #endif
-			if (ifap_iter->ifa_name)
+			if (ifap_iter->ifa_name) {
 				a->name = g_strdup(ifap_iter->ifa_name);
+				_fill_link_infos (a);
+			} else
+				a->numa_node = -1;
 
 			ret = g_list_prepend (ret, a);
 		}
@@ -378,6 +527,68 @@ arv_enumerate_network_interfaces (void)
 	return g_list_reverse (ret);
 };
 
+static ArvNetworkInterface *
+_network_interface_copy (const ArvNetworkInterface *a)
+{
+	ArvNetworkInterface *copy;
+
+	copy = g_new0 (ArvNetworkInterface, 1);
+	copy->addr = a->addr != NULL ? arv_memdup (a->addr, sizeof (struct sockaddr)) : NULL;
+	copy->netmask = a->netmask != NULL ? arv_memdup (a->netmask, sizeof (struct sockaddr)) : NULL;
+	copy->broadaddr = a->broadaddr != NULL ? arv_memdup (a->broadaddr, sizeof (struct sockaddr)) : NULL;
+	copy->name = g_strdup (a->name);
+	copy->index = a->index;
+	copy->mtu = a->mtu;
+	copy->link_speed = a->link_speed;
+	copy->numa_node = a->numa_node;
+
+	return copy;
+}
+
+GList*
+arv_enumerate_network_interfaces (void)
+{
+	GList *ret = NULL;
+	GList *iter;
+
+	g_mutex_lock (&arv_network_interfaces_mutex);
+
+#ifdef __linux__
+	_netlink_check_changes ();
+#endif
+
+	if (!arv_network_interfaces_valid) {
+		g_list_free_full (arv_network_interfaces, (GDestroyNotify) arv_network_interface_free);
+		arv_network_interfaces = _enumerate_network_interfaces ();
+		arv_network_interfaces_valid = TRUE;
+	}
+
+	for (iter = arv_network_interfaces; iter != NULL; iter = iter->next)
+		ret = g_list_prepend (ret, _network_interface_copy (iter->data));
+
+	g_mutex_unlock (&arv_network_interfaces_mutex);
+
+	return g_list_reverse (ret);
+}
+
+void
+arv_network_shutdown (void)
+{
+	g_mutex_lock (&arv_network_interfaces_mutex);
+
+	g_list_free_full (arv_network_interfaces, (GDestroyNotify) arv_network_interface_free);
+	arv_network_interfaces = NULL;
+	arv_network_interfaces_valid = FALSE;
+#ifdef __linux__
+	if (arv_network_netlink_fd >= 0)
+		close (arv_network_netlink_fd);
+	arv_network_netlink_fd = -1;
+	arv_network_netlink_initialized = FALSE;
+#endif
+
+	g_mutex_unlock (&arv_network_interfaces_mutex);
+}
+
 /* no-op functions for Win32 GLib bug workaround, see above */
 
 void
@@ -422,8 +633,75 @@ arv_network_interface_get_name(ArvNetworkInterface* a)
 	return a->name;
 }
 
+/* System index of the interface, 0 if unknown */
+
+guint
+arv_network_interface_get_index (ArvNetworkInterface *a)
+{
+	return a->index;
+}
+
+/* Interface MTU in bytes, 0 if unknown */
+
+guint
+arv_network_interface_get_mtu (ArvNetworkInterface *a)
+{
+	return a->mtu;
+}
+
+/* Link speed in Mb/s, 0 if unknown or if the link is down */
+
+guint
+arv_network_interface_get_link_speed (ArvNetworkInterface *a)
+{
+	return a->link_speed;
+}
+
+/* NUMA node of the network controller, -1 if unknown */
+
+int
+arv_network_interface_get_numa_node (ArvNetworkInterface *a)
+{
+	return a->numa_node;
+}
+
+/* Returns the interface owning the IPv4 @address, to be freed with arv_network_interface_free(), or NULL */
+
+ArvNetworkInterface *
+arv_network_interface_lookup (GInetAddress *address)
+{
+	ArvNetworkInterface *found = NULL;
+	GList *ifaces;
+	GList *iter;
+	const guint8 *bytes;
+
+	g_return_val_if_fail (G_IS_INET_ADDRESS (address), NULL);
+
+	if (g_inet_address_get_family (address) != G_SOCKET_FAMILY_IPV4)
+		return NULL;
+
+	bytes = g_inet_address_to_bytes (address);
+
+	ifaces = arv_enumerate_network_interfaces ();
+	for (iter = ifaces; iter != NULL && found == NULL; iter = iter->next) {
+		ArvNetworkInterface *a = iter->data;
+
+		if (a->addr != NULL && a->addr->sa_family == AF_INET &&
+		    memcmp (&((struct sockaddr_in *) a->addr)->sin_addr.s_addr, bytes, 4) == 0) {
+			found = a;
+			iter->data = NULL;
+		}
+	}
+	g_list_free_full (ifaces, (GDestroyNotify) arv_network_interface_free);
+
+	return found;
+}
+
 void
 arv_network_interface_free(ArvNetworkInterface *a) {
+	if (a == NULL)
+		return;
+
 	g_clear_pointer (&a->addr, g_free);
 	g_clear_pointer (&a->netmask, g_free);
 	g_clear_pointer (&a->broadaddr, g_free);
@@ -449,3 +727,55 @@ arv_socket_set_recv_buffer_size (int socket_fd, gint buffer_size)
 	return result == 0;
 }
 
+/* Goes beyond the rmem_max limit if the process has the CAP_NET_ADMIN capability */
+
+gboolean
+arv_socket_force_recv_buffer_size (int socket_fd, gint buffer_size)
+{
+#ifdef SO_RCVBUFFORCE
+	if (setsockopt (socket_fd, SOL_SOCKET, SO_RCVBUFFORCE, &buffer_size, sizeof (buffer_size)) == 0)
+		return TRUE;
+#endif
+
+	return arv_socket_set_recv_buffer_size (socket_fd, buffer_size);
+}
+
+/* Returns the path MTU known by the host kernel for the route from @interface_address to @device_address, or 0 if it
+ * is not available on this platform. No packet is sent, connecting a datagram socket only resolves the route. */
+
+guint
+arv_network_get_path_mtu (GInetAddress *interface_address, GInetAddress *device_address)
+{
+	guint mtu = 0;
+#if defined(IP_MTU_DISCOVER) && defined(IP_PMTUDISC_DO) && defined(IP_MTU)
+	GSocket *socket;
+	GSocketAddress *interface_socket_address;
+	GSocketAddress *device_socket_address;
+	gint value;
+
+	g_return_val_if_fail (G_IS_INET_ADDRESS (interface_address), 0);
+	g_return_val_if_fail (G_IS_INET_ADDRESS (device_address), 0);
+
+	socket = g_socket_new (G_SOCKET_FAMILY_IPV4, G_SOCKET_TYPE_DATAGRAM, G_SOCKET_PROTOCOL_UDP, NULL);
+	if (socket == NULL)
+		return 0;
+
+	interface_socket_address = g_inet_socket_address_new (interface_address, 0);
+	/* Any non zero port will do, nothing is sent */
+	device_socket_address = g_inet_socket_address_new (device_address, 9);
+
+	if (g_socket_bind (socket, interface_socket_address, FALSE, NULL) &&
+	    g_socket_set_option (socket, IPPROTO_IP, IP_MTU_DISCOVER, IP_PMTUDISC_DO, NULL) &&
+	    g_socket_connect (socket, device_socket_address, NULL, NULL) &&
+	    g_socket_get_option (socket, IPPROTO_IP, IP_MTU, &value, NULL) &&
+	    value > 0)
+		mtu = value;
+
+	g_object_unref (device_socket_address);
+	g_object_unref (interface_socket_address);
+	g_object_unref (socket);
+#endif
+
+	return mtu;
+}
+
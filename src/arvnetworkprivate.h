@@ -91,8 +91,20 @@ struct sockaddr *	arv_network_interface_get_addr		(ArvNetworkInterface *a);
 struct sockaddr *	arv_network_interface_get_netmask	(ArvNetworkInterface *a);
 struct sockaddr *	arv_network_interface_get_broadaddr	(ArvNetworkInterface *a);
 const char *		arv_network_interface_get_name		(ArvNetworkInterface *a);
+guint			arv_network_interface_get_index		(ArvNetworkInterface *a);
+guint			arv_network_interface_get_mtu		(ArvNetworkInterface *a);
+guint			arv_network_interface_get_link_speed	(ArvNetworkInterface *a);
+int			arv_network_interface_get_numa_node	(ArvNetworkInterface *a);
+
+ArvNetworkInterface *	arv_network_interface_lookup		(GInetAddress *address);
+
+void			arv_network_shutdown			(void);
 
 gboolean 		arv_socket_set_recv_buffer_size		(int socket_fd, gint buffer_size);
+gboolean 		arv_socket_force_recv_buffer_size	(int socket_fd, gint buffer_size);
+
+guint			arv_network_get_path_mtu		(GInetAddress *interface_address,
+								 GInetAddress *device_address);
 
 #ifdef G_OS_WIN32
 	/* mingw only defines with _WIN32_WINNT>=0x0600, see
@@ -0,0 +1,394 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2019 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel@gnome.org>
+ */
+
+/*< private >
+ * SECTION: arvpacketrecorder
+ * @short_description: Raw stream packet recording and replay
+ *
+ * #ArvPacketRecorder captures the raw stream packets of an acquisition, with their reception time, into a ring file,
+ * which keeps the most recent packets once full. The file is memory mapped, and written from the stream thread
+ * without any system call per packet. #ArvPacketPlayer reads the packets back, from the oldest one, for an offline
+ * replay through the stream reassembly code.
+ *
+ * The file starts with a #ArvPacketRecordHeader, followed by the records, each made of a #ArvPacketRecordEntry and
+ * the packet data, padded to 8 bytes. A record which doesn't fit before the end of the file is written at the start of
+ * the ring, after a wrap marker if there is room for one. All values are in host byte order.
+ */
+
+#include <arvpacketrecorderprivate.h>
+#include <arvdebugprivate.h>
+#include <gio/gio.h>
+#include <string.h>
+#include <errno.h>
+
+#ifndef G_OS_WIN32
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#define ARV_PACKET_RECORD_MAGIC		"ARVPKT01"
+#define ARV_PACKET_RECORD_HEADER_SIZE	64
+#define ARV_PACKET_RECORD_WRAP		G_MAXUINT32
+#define ARV_PACKET_RECORD_SIZE_MIN	4096
+
+#define ARV_PACKET_RECORD_ALIGN(size)	(((size) + 7) & ~((guint64) 7))
+
+typedef struct {
+	char magic[8];
+	guint32 protocol;
+	guint32 reserved;
+	guint64 size;
+	/* Offset of the next record */
+	guint64 head;
+	/* Offset of the oldest record */
+	guint64 tail;
+	/* Number of records between tail and head */
+	guint64 n_records;
+	guint64 n_packets;
+	guint64 n_overwritten;
+} ArvPacketRecordHeader;
+
+typedef struct {
+	guint64 time_us;
+	guint32 size;
+	guint32 reserved;
+} ArvPacketRecordEntry;
+
+G_STATIC_ASSERT (sizeof (ArvPacketRecordHeader) <= ARV_PACKET_RECORD_HEADER_SIZE);
+
+/* Offset of the record following the one at @offset, or of the start of the ring if it doesn't fit before the end */
+
+static guint64
+_wrap_offset (guint64 offset, guint64 size)
+{
+	if (offset + sizeof (ArvPacketRecordEntry) > size)
+		return ARV_PACKET_RECORD_HEADER_SIZE;
+
+	return offset;
+}
+
+struct _ArvPacketRecorder {
+	int fd;
+	guint8 *data;
+	ArvPacketRecordHeader *header;
+};
+
+ArvPacketRecorder *
+arv_packet_recorder_new (const char *filename, ArvPacketRecordProtocol protocol, guint64 size, GError **error)
+{
+#ifndef G_OS_WIN32
+	ArvPacketRecorder *recorder;
+	void *data;
+	int fd;
+
+	g_return_val_if_fail (filename != NULL, NULL);
+
+	size = MAX (ARV_PACKET_RECORD_ALIGN (size), ARV_PACKET_RECORD_SIZE_MIN);
+
+	fd = open (filename, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0) {
+		int errsv = errno;
+
+		g_set_error (error, G_IO_ERROR, g_io_error_from_errno (errsv),
+			     "Can't create packet record '%s': %s", filename, g_strerror (errsv));
+		return NULL;
+	}
+
+	if (ftruncate (fd, size) != 0 ||
+	    (data = mmap (NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)) == MAP_FAILED) {
+		int errsv = errno;
+
+		g_set_error (error, G_IO_ERROR, g_io_error_from_errno (errsv),
+			     "Can't map packet record '%s': %s", filename, g_strerror (errsv));
+		close (fd);
+		return NULL;
+	}
+
+	recorder = g_new0 (ArvPacketRecorder, 1);
+	recorder->fd = fd;
+	recorder->data = data;
+	recorder->header = data;
+
+	memcpy (recorder->header->magic, ARV_PACKET_RECORD_MAGIC, sizeof (recorder->header->magic));
+	recorder->header->protocol = protocol;
+	recorder->header->size = size;
+	recorder->header->head = ARV_PACKET_RECORD_HEADER_SIZE;
+	recorder->header->tail = ARV_PACKET_RECORD_HEADER_SIZE;
+
+	arv_info_misc ("[PacketRecorder::new] Record packets to '%s' (%" G_GUINT64_FORMAT " bytes)", filename, size);
+
+	return recorder;
+#else
+	g_set_error (error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED, "Packet recording is not supported on this platform");
+
+	return NULL;
+#endif
+}
+
+void
+arv_packet_recorder_free (ArvPacketRecorder *recorder)
+{
+	if (recorder == NULL)
+		return;
+
+#ifndef G_OS_WIN32
+	arv_info_misc ("[PacketRecorder::free] %" G_GUINT64_FORMAT " recorded packets, %" G_GUINT64_FORMAT
+		       " overwritten", recorder->header->n_packets, recorder->header->n_overwritten);
+
+	munmap (recorder->data, recorder->header->size);
+	close (recorder->fd);
+#endif
+
+	g_free (recorder);
+}
+
+/* Drop the oldest records until the [from, to) range of the ring is free */
+
+static void
+_make_room (ArvPacketRecorder *recorder, guint64 from, guint64 to)
+{
+	ArvPacketRecordHeader *header = recorder->header;
+
+	while (header->n_records > 0 && header->tail >= from && header->tail < to) {
+		ArvPacketRecordEntry *entry;
+
+		if (_wrap_offset (header->tail, header->size) != header->tail) {
+			header->tail = ARV_PACKET_RECORD_HEADER_SIZE;
+			continue;
+		}
+
+		entry = (ArvPacketRecordEntry *) (recorder->data + header->tail);
+		if (entry->size == ARV_PACKET_RECORD_WRAP) {
+			header->tail = ARV_PACKET_RECORD_HEADER_SIZE;
+			continue;
+		}
+
+		header->tail += ARV_PACKET_RECORD_ALIGN (sizeof (ArvPacketRecordEntry) + entry->size);
+		header->n_records--;
+		header->n_overwritten++;
+	}
+}
+
+/**
+ * arv_packet_recorder_write:
+ * @recorder: a #ArvPacketRecorder
+ * @time_us: packet reception time
+ * @data: packet data
+ * @size: size of @data
+ *
+ * Appends a packet to the record, overwriting the oldest ones if the ring is full.
+ *
+ * Returns: %FALSE if the packet is too large for the ring.
+ */
+
+gboolean
+arv_packet_recorder_write (ArvPacketRecorder *recorder, guint64 time_us, const void *data, size_t size)
+{
+	ArvPacketRecordHeader *header;
+	ArvPacketRecordEntry *entry;
+	guint64 record_size;
+	guint64 head;
+
+	g_return_val_if_fail (recorder != NULL, FALSE);
+
+	header = recorder->header;
+	record_size = ARV_PACKET_RECORD_ALIGN (sizeof (ArvPacketRecordEntry) + size);
+
+	if (size >= ARV_PACKET_RECORD_WRAP ||
+	    record_size > header->size - ARV_PACKET_RECORD_HEADER_SIZE)
+		return FALSE;
+
+	head = header->head;
+	if (head + record_size > header->size) {
+		_make_room (recorder, head, header->size);
+		if (_wrap_offset (head, header->size) == head) {
+			entry = (ArvPacketRecordEntry *) (recorder->data + head);
+			entry->time_us = 0;
+			entry->size = ARV_PACKET_RECORD_WRAP;
+		}
+		head = ARV_PACKET_RECORD_HEADER_SIZE;
+	}
+
+	_make_room (recorder, head, head + record_size);
+
+	if (header->n_records == 0)
+		header->tail = head;
+
+	entry = (ArvPacketRecordEntry *) (recorder->data + head);
+	entry->time_us = time_us;
+	entry->size = size;
+	entry->reserved = 0;
+	memcpy (recorder->data + head + sizeof (ArvPacketRecordEntry), data, size);
+
+	header->head = head + record_size;
+	header->n_records++;
+	header->n_packets++;
+
+	return TRUE;
+}
+
+guint64
+arv_packet_recorder_get_n_packets (ArvPacketRecorder *recorder)
+{
+	g_return_val_if_fail (recorder != NULL, 0);
+
+	return recorder->header->n_packets;
+}
+
+guint64
+arv_packet_recorder_get_n_overwritten (ArvPacketRecorder *recorder)
+{
+	g_return_val_if_fail (recorder != NULL, 0);
+
+	return recorder->header->n_overwritten;
+}
+
+struct _ArvPacketPlayer {
+	GMappedFile *file;
+	const guint8 *data;
+	const ArvPacketRecordHeader *header;
+
+	guint64 offset;
+	guint64 n_read_records;
+};
+
+ArvPacketPlayer *
+arv_packet_player_new (const char *filename, GError **error)
+{
+	ArvPacketPlayer *player;
+	const ArvPacketRecordHeader *header;
+	GMappedFile *file;
+	gsize length;
+
+	g_return_val_if_fail (filename != NULL, NULL);
+
+	file = g_mapped_file_new (filename, FALSE, error);
+	if (file == NULL)
+		return NULL;
+
+	length = g_mapped_file_get_length (file);
+	header = (const ArvPacketRecordHeader *) g_mapped_file_get_contents (file);
+
+	if (length < ARV_PACKET_RECORD_HEADER_SIZE ||
+	    memcmp (header->magic, ARV_PACKET_RECORD_MAGIC, sizeof (header->magic)) != 0 ||
+	    header->size != length ||
+	    header->tail < ARV_PACKET_RECORD_HEADER_SIZE || header->tail > length) {
+		g_set_error (error, G_IO_ERROR, G_IO_ERROR_FAILED, "Invalid packet record '%s'", filename);
+		g_mapped_file_unref (file);
+		return NULL;
+	}
+
+	player = g_new0 (ArvPacketPlayer, 1);
+	player->file = file;
+	player->data = (const guint8 *) header;
+	player->header = header;
+	player->offset = header->tail;
+
+	return player;
+}
+
+void
+arv_packet_player_free (ArvPacketPlayer *player)
+{
+	if (player == NULL)
+		return;
+
+	g_mapped_file_unref (player->file);
+	g_free (player);
+}
+
+ArvPacketRecordProtocol
+arv_packet_player_get_protocol (ArvPacketPlayer *player)
+{
+	g_return_val_if_fail (player != NULL, ARV_PACKET_RECORD_PROTOCOL_GVSP);
+
+	return player->header->protocol;
+}
+
+guint64
+arv_packet_player_get_n_packets (ArvPacketPlayer *player)
+{
+	g_return_val_if_fail (player != NULL, 0);
+
+	return player->header->n_records;
+}
+
+/**
+ * arv_packet_player_next:
+ * @player: a #ArvPacketPlayer
+ * @time_us: (out): packet reception time
+ * @data: (out): packet data, valid until @player is freed
+ * @size: (out): size of @data
+ *
+ * Returns: %FALSE at the end of the record, or if it is corrupted.
+ */
+
+gboolean
+arv_packet_player_next (ArvPacketPlayer *player, guint64 *time_us, const void **data, size_t *size)
+{
+	const ArvPacketRecordEntry *entry;
+	guint64 length;
+
+	g_return_val_if_fail (player != NULL, FALSE);
+
+	length = player->header->size;
+
+	while (player->n_read_records < player->header->n_records) {
+		player->offset = _wrap_offset (player->offset, length);
+		entry = (const ArvPacketRecordEntry *) (player->data + player->offset);
+
+		if (entry->size == ARV_PACKET_RECORD_WRAP) {
+			player->offset = ARV_PACKET_RECORD_HEADER_SIZE;
+			continue;
+		}
+
+		if (player->offset + sizeof (ArvPacketRecordEntry) + entry->size > length) {
+			arv_warning_misc ("[PacketPlayer::next] Corrupted record at offset %" G_GUINT64_FORMAT,
+					  player->offset);
+			return FALSE;
+		}
+
+		if (time_us != NULL)
+			*time_us = entry->time_us;
+		if (data != NULL)
+			*data = player->data + player->offset + sizeof (ArvPacketRecordEntry);
+		if (size != NULL)
+			*size = entry->size;
+
+		player->offset += ARV_PACKET_RECORD_ALIGN (sizeof (ArvPacketRecordEntry) + entry->size);
+		player->n_read_records++;
+
+		return TRUE;
+	}
+
+	return FALSE;
+}
+
+void
+arv_packet_player_rewind (ArvPacketPlayer *player)
+{
+	g_return_if_fail (player != NULL);
+
+	player->offset = player->header->tail;
+	player->n_read_records = 0;
+}
@@ -0,0 +1,65 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2019 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel@gnome.org>
+ */
+
+#ifndef ARV_PACKET_RECORDER_PRIVATE_H
+#define ARV_PACKET_RECORDER_PRIVATE_H
+
+#if !defined (ARV_H_INSIDE) && !defined (ARAVIS_COMPILATION)
+#error "Only <arv.h> can be included directly."
+#endif
+
+#include <arvtypes.h>
+
+G_BEGIN_DECLS
+
+/* Default size of the packet record ring file */
+#define ARV_PACKET_RECORDER_SIZE_DEFAULT	(256 << 20)
+
+typedef enum {
+	ARV_PACKET_RECORD_PROTOCOL_GVSP,
+	ARV_PACKET_RECORD_PROTOCOL_UVSP
+} ArvPacketRecordProtocol;
+
+typedef struct _ArvPacketRecorder ArvPacketRecorder;
+typedef struct _ArvPacketPlayer ArvPacketPlayer;
+
+ArvPacketRecorder *	arv_packet_recorder_new			(const char *filename, ArvPacketRecordProtocol protocol,
+								 guint64 size, GError **error);
+void			arv_packet_recorder_free		(ArvPacketRecorder *recorder);
+
+gboolean		arv_packet_recorder_write		(ArvPacketRecorder *recorder, guint64 time_us,
+								 const void *data, size_t size);
+guint64			arv_packet_recorder_get_n_packets	(ArvPacketRecorder *recorder);
+guint64			arv_packet_recorder_get_n_overwritten	(ArvPacketRecorder *recorder);
+
+ArvPacketPlayer *	arv_packet_player_new			(const char *filename, GError **error);
+void			arv_packet_player_free			(ArvPacketPlayer *player);
+
+ArvPacketRecordProtocol	arv_packet_player_get_protocol		(ArvPacketPlayer *player);
+guint64			arv_packet_player_get_n_packets		(ArvPacketPlayer *player);
+gboolean		arv_packet_player_next			(ArvPacketPlayer *player, guint64 *time_us,
+								 const void **data, size_t *size);
+void			arv_packet_player_rewind		(ArvPacketPlayer *player);
+
+G_END_DECLS
+
+#endif
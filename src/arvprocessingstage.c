@@ -0,0 +1,199 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2019 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel@gnome.org>
+ */
+
+/*< private >
+ * SECTION: arvprocessingstage
+ * @short_description: Single worker thread processing stage of the stream output
+ *
+ * A worker thread between the stream thread and the output queue, fed through a bounded queue. Buffers are processed
+ * and delivered in the order they were pushed. When the queue is full, the overflow policy either drops the oldest
+ * pending buffer, drops the new one, or blocks the stream thread until the worker catches up.
+ */
+
+#include <arvprocessingstageprivate.h>
+#include <arvdebugprivate.h>
+
+struct _ArvProcessingStage {
+	ArvStreamProcessFunc process_func;
+	void *user_data;
+	GDestroyNotify destroy;
+
+	guint depth;
+	ArvStreamOverflowPolicy policy;
+
+	ArvProcessingStageDeliverFunc deliver_func;
+	ArvProcessingStageDeliverFunc drop_func;
+	void *deliver_data;
+
+	GThread *thread;
+
+	/* Pending buffers in push order, protected by mutex. cond is signaled on each push and pop. */
+	GMutex mutex;
+	GCond cond;
+	GQueue buffers;
+	gboolean cancel;
+};
+
+/* Pending buffers are still processed and delivered after cancellation */
+
+static void *
+_worker_thread (void *data)
+{
+	ArvProcessingStage *stage = data;
+	ArvBuffer *buffer;
+
+	g_mutex_lock (&stage->mutex);
+
+	for (;;) {
+		while (g_queue_is_empty (&stage->buffers) && !stage->cancel)
+			g_cond_wait (&stage->cond, &stage->mutex);
+
+		buffer = g_queue_pop_head (&stage->buffers);
+		if (buffer == NULL)
+			break;
+
+		g_cond_broadcast (&stage->cond);
+		g_mutex_unlock (&stage->mutex);
+
+		stage->process_func (buffer, stage->user_data);
+		stage->deliver_func (stage->deliver_data, buffer);
+
+		g_mutex_lock (&stage->mutex);
+	}
+
+	g_mutex_unlock (&stage->mutex);
+
+	return NULL;
+}
+
+/* Returns FALSE if a buffer was dropped, either @buffer or the oldest pending one. @depth is set to the number of
+ * pending buffers after the push, @stall_time_us to the time spent waiting for the worker. */
+
+gboolean
+arv_processing_stage_push (ArvProcessingStage *stage, ArvBuffer *buffer, guint *depth, gint64 *stall_time_us)
+{
+	ArvBuffer *dropped_buffer = NULL;
+	gint64 stall_start_us;
+
+	g_return_val_if_fail (stage != NULL, FALSE);
+	g_return_val_if_fail (ARV_IS_BUFFER (buffer), FALSE);
+
+	if (stall_time_us != NULL)
+		*stall_time_us = 0;
+
+	g_mutex_lock (&stage->mutex);
+
+	if (g_queue_get_length (&stage->buffers) >= stage->depth) {
+		switch (stage->policy) {
+			case ARV_STREAM_OVERFLOW_POLICY_DROP_OLDEST:
+				dropped_buffer = g_queue_pop_head (&stage->buffers);
+				break;
+			case ARV_STREAM_OVERFLOW_POLICY_DROP_NEWEST:
+				dropped_buffer = buffer;
+				break;
+			case ARV_STREAM_OVERFLOW_POLICY_BLOCK:
+				stall_start_us = g_get_monotonic_time ();
+				while (g_queue_get_length (&stage->buffers) >= stage->depth)
+					g_cond_wait (&stage->cond, &stage->mutex);
+				if (stall_time_us != NULL)
+					*stall_time_us = g_get_monotonic_time () - stall_start_us;
+				break;
+		}
+	}
+
+	if (dropped_buffer != buffer) {
+		g_queue_push_tail (&stage->buffers, buffer);
+		g_cond_broadcast (&stage->cond);
+	}
+
+	if (depth != NULL)
+		*depth = g_queue_get_length (&stage->buffers);
+
+	g_mutex_unlock (&stage->mutex);
+
+	if (dropped_buffer != NULL) {
+		stage->drop_func (stage->deliver_data, dropped_buffer);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+ArvProcessingStage *
+arv_processing_stage_new (ArvStreamProcessFunc process_func, void *user_data, GDestroyNotify destroy,
+			  guint depth, ArvStreamOverflowPolicy policy,
+			  ArvProcessingStageDeliverFunc deliver_func,
+			  ArvProcessingStageDeliverFunc drop_func, void *deliver_data)
+{
+	ArvProcessingStage *stage;
+
+	g_return_val_if_fail (process_func != NULL, NULL);
+	g_return_val_if_fail (deliver_func != NULL, NULL);
+	g_return_val_if_fail (drop_func != NULL, NULL);
+	g_return_val_if_fail (depth > 0, NULL);
+
+	stage = g_new0 (ArvProcessingStage, 1);
+	stage->process_func = process_func;
+	stage->user_data = user_data;
+	stage->destroy = destroy;
+	stage->depth = depth;
+	stage->policy = policy;
+	stage->deliver_func = deliver_func;
+	stage->drop_func = drop_func;
+	stage->deliver_data = deliver_data;
+
+	g_mutex_init (&stage->mutex);
+	g_cond_init (&stage->cond);
+	g_queue_init (&stage->buffers);
+
+	stage->thread = g_thread_new ("arv_processing", _worker_thread, stage);
+
+	arv_info_stream ("[ProcessingStage::new] depth %u, overflow policy %d", depth, policy);
+
+	return stage;
+}
+
+/* Waits for the worker thread, all the buffers in the stage are delivered before return */
+
+void
+arv_processing_stage_free (ArvProcessingStage *stage)
+{
+	if (stage == NULL)
+		return;
+
+	g_mutex_lock (&stage->mutex);
+	stage->cancel = TRUE;
+	g_cond_broadcast (&stage->cond);
+	g_mutex_unlock (&stage->mutex);
+
+	g_thread_join (stage->thread);
+
+	g_assert (g_queue_is_empty (&stage->buffers));
+
+	g_cond_clear (&stage->cond);
+	g_mutex_clear (&stage->mutex);
+
+	if (stage->destroy != NULL)
+		stage->destroy (stage->user_data);
+
+	g_free (stage);
+}
@@ -0,0 +1,50 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2019 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel@gnome.org>
+ */
+
+#ifndef ARV_PROCESSING_STAGE_PRIVATE_H
+#define ARV_PROCESSING_STAGE_PRIVATE_H
+
+#if !defined (ARV_H_INSIDE) && !defined (ARAVIS_COMPILATION)
+#error "Only <arv.h> can be included directly."
+#endif
+
+#include <arvstream.h>
+
+G_BEGIN_DECLS
+
+typedef void (*ArvProcessingStageDeliverFunc) (void *deliver_data, ArvBuffer *buffer);
+
+typedef struct _ArvProcessingStage ArvProcessingStage;
+
+ArvProcessingStage *	arv_processing_stage_new	(ArvStreamProcessFunc process_func, void *user_data,
+							 GDestroyNotify destroy,
+							 guint depth, ArvStreamOverflowPolicy policy,
+							 ArvProcessingStageDeliverFunc deliver_func,
+							 ArvProcessingStageDeliverFunc drop_func, void *deliver_data);
+void			arv_processing_stage_free	(ArvProcessingStage *stage);
+
+gboolean		arv_processing_stage_push	(ArvProcessingStage *stage, ArvBuffer *buffer,
+							 guint *depth, gint64 *stall_time_us);
+
+G_END_DECLS
+
+#endif
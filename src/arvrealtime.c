@@ -27,13 +27,20 @@
 
 */
 
+/* For sched_setaffinity */
+#define _GNU_SOURCE
+
 #include <arvrealtimeprivate.h>
 #include <arvdebugprivate.h>
 #include <memory.h>
+#include <stdio.h>
 #include <errno.h>
 #include <sched.h>
 #include <sys/time.h>
 #include <sys/types.h>
+#if !defined(__APPLE__) && !defined(G_OS_WIN32)
+#include <sys/mman.h>
+#endif
 
 #define RTKIT_SERVICE_NAME "org.freedesktop.RealtimeKit1"
 #define RTKIT_OBJECT_PATH "/org/freedesktop/RealtimeKit1"
@@ -319,6 +326,302 @@ arv_make_thread_high_priority (int nice_level)
 	return TRUE;
 }
 
+/* From linux/mempolicy.h */
+#define ARV_MPOL_PREFERRED	1
+
+#define ARV_NUMA_N_NODES_MAX	1024
+
+static gboolean
+_parse_cpu_list (const char *cpulist, cpu_set_t *cpu_set)
+{
+	char **ranges;
+	int i;
+
+	/* cpulist format is "0-7,16-23" */
+	ranges = g_strsplit (cpulist, ",", -1);
+	for (i = 0; ranges[i] != NULL; i++) {
+		int first, last, cpu;
+
+		if (sscanf (ranges[i], "%d-%d", &first, &last) != 2) {
+			if (sscanf (ranges[i], "%d", &first) != 1)
+				continue;
+			last = first;
+		}
+
+		for (cpu = MAX (first, 0); cpu <= last && cpu < CPU_SETSIZE; cpu++)
+			CPU_SET (cpu, cpu_set);
+	}
+
+	g_strfreev (ranges);
+
+	return CPU_COUNT (cpu_set) > 0;
+}
+
+static gboolean
+_read_cpu_list (const char *filename, cpu_set_t *cpu_set)
+{
+	char *cpulist = NULL;
+	gboolean success;
+
+	if (!g_file_get_contents (filename, &cpulist, NULL, NULL))
+		return FALSE;
+
+	success = _parse_cpu_list (g_strstrip (cpulist), cpu_set);
+	g_free (cpulist);
+
+	return success;
+}
+
+static gboolean
+_set_numa_node_cpus (cpu_set_t *cpu_set, int numa_node)
+{
+	char *filename;
+	gboolean success;
+
+	filename = g_strdup_printf ("/sys/devices/system/node/node%d/cpulist", numa_node);
+	success = _read_cpu_list (filename, cpu_set);
+	g_free (filename);
+
+	return success;
+}
+
+/**
+ * arv_make_thread_affine:
+ * @cpu_index: index of the CPU the thread must run on, or -1
+ * @numa_node: NUMA node the thread must run and allocate memory on, or -1
+ *
+ * Try to pin the current thread to a CPU, and to make it prefer the memory of the
+ * given NUMA node for its allocations. If @cpu_index is -1 and @numa_node is set, the
+ * thread is allowed to run on all the CPUs of the NUMA node.
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 0.8.11
+ */
+
+gboolean
+arv_make_thread_affine (int cpu_index, int numa_node)
+{
+	cpu_set_t cpu_set;
+	gboolean success = TRUE;
+
+	CPU_ZERO (&cpu_set);
+
+	if (cpu_index >= 0 && cpu_index < CPU_SETSIZE)
+		CPU_SET (cpu_index, &cpu_set);
+	else if (numa_node >= 0 && !_set_numa_node_cpus (&cpu_set, numa_node)) {
+		arv_warning_misc ("Failed to get the CPUs of NUMA node %d", numa_node);
+		success = FALSE;
+	}
+
+	if (CPU_COUNT (&cpu_set) > 0) {
+		if (sched_setaffinity (_gettid (), sizeof (cpu_set), &cpu_set) < 0) {
+			arv_warning_misc ("Failed to set thread CPU affinity: %s", strerror (errno));
+			success = FALSE;
+		} else
+			arv_info_misc ("Thread CPU affinity set (cpu %d, NUMA node %d)", cpu_index, numa_node);
+	}
+
+#ifdef SYS_set_mempolicy
+	if (numa_node >= 0 && numa_node < ARV_NUMA_N_NODES_MAX) {
+		unsigned long node_mask[ARV_NUMA_N_NODES_MAX / (8 * sizeof (unsigned long))] = {0};
+
+		node_mask[numa_node / (8 * sizeof (unsigned long))] = 1UL << (numa_node % (8 * sizeof (unsigned long)));
+
+		if (syscall (SYS_set_mempolicy, ARV_MPOL_PREFERRED, node_mask, ARV_NUMA_N_NODES_MAX + 1) < 0) {
+			arv_warning_misc ("Failed to set thread memory policy: %s", strerror (errno));
+			success = FALSE;
+		}
+	}
+#endif
+
+	return success;
+}
+
+#ifndef SCHED_DEADLINE
+#define SCHED_DEADLINE		6
+#endif
+
+#define ARV_SCHED_FLAG_RESET_ON_FORK	0x01
+
+/* From linux/sched/types.h, not exposed by all the C libraries */
+struct arv_sched_attr {
+	guint32 size;
+	guint32 sched_policy;
+	guint64 sched_flags;
+	gint32 sched_nice;
+	guint32 sched_priority;
+	guint64 sched_runtime;
+	guint64 sched_deadline;
+	guint64 sched_period;
+};
+
+/**
+ * arv_make_thread_deadline:
+ * @runtime_us: CPU time the thread needs for each period, in µs
+ * @period_us: activation period of the thread, in µs, which is also its relative deadline
+ *
+ * Try to make the current thread use the SCHED_DEADLINE policy. For a stream thread, @period_us is typically the
+ * frame period, and @runtime_us the worst case processing time of a frame. This needs the CAP_SYS_NICE capability,
+ * and the kernel refuses to restrict the CPU affinity of a deadline thread outside of an exclusive cpuset.
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 0.8.11
+ */
+
+gboolean
+arv_make_thread_deadline (gint64 runtime_us, gint64 period_us)
+{
+#ifdef SYS_sched_setattr
+	struct arv_sched_attr attr;
+
+	g_return_val_if_fail (runtime_us > 0 && runtime_us <= period_us, FALSE);
+
+	memset (&attr, 0, sizeof (attr));
+	attr.size = sizeof (attr);
+	attr.sched_policy = SCHED_DEADLINE;
+	attr.sched_flags = ARV_SCHED_FLAG_RESET_ON_FORK;
+	/* The kernel rejects runtimes smaller than 1024 ns */
+	attr.sched_runtime = MAX (runtime_us, 2) * 1000;
+	attr.sched_deadline = period_us * 1000;
+	attr.sched_period = period_us * 1000;
+
+	if (syscall (SYS_sched_setattr, _gettid (), &attr, 0) < 0) {
+		arv_warning_misc ("Failed to set SCHED_DEADLINE (runtime %" G_GINT64_FORMAT " µs, period %"
+				  G_GINT64_FORMAT " µs): %s", runtime_us, period_us, strerror (errno));
+		return FALSE;
+	}
+
+	arv_info_misc ("Thread uses SCHED_DEADLINE with runtime %" G_GINT64_FORMAT " µs and period %"
+		       G_GINT64_FORMAT " µs", runtime_us, period_us);
+
+	return TRUE;
+#else
+	arv_info_misc ("SCHED_DEADLINE not supported");
+
+	return FALSE;
+#endif
+}
+
+/**
+ * arv_lock_memory:
+ *
+ * Lock the current and future memory of the process in RAM, including the buffers allocated afterwards, in order
+ * to avoid page faults in the acquisition path. The locked size is limited by RLIMIT_MEMLOCK, unless the process has
+ * the CAP_IPC_LOCK capability.
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 0.8.11
+ */
+
+gboolean
+arv_lock_memory (void)
+{
+	if (mlockall (MCL_CURRENT | MCL_FUTURE) < 0) {
+		arv_warning_misc ("Failed to lock memory: %s", strerror (errno));
+		return FALSE;
+	}
+
+	arv_info_misc ("Process memory locked");
+
+	return TRUE;
+}
+
+/**
+ * arv_get_isolated_cpus:
+ * @n_cpus: (out): number of isolated CPUs
+ *
+ * Retrieve the CPUs removed from the general scheduler by the isolcpus kernel parameter, which are the natural
+ * targets of arv_make_thread_affine() for the stream threads.
+ *
+ * Returns: (array length=n_cpus) (transfer full) (nullable): the isolated CPU indices, to be freed with g_free().
+ *
+ * Since: 0.8.11
+ */
+
+guint *
+arv_get_isolated_cpus (guint *n_cpus)
+{
+	cpu_set_t cpu_set;
+	guint *cpus;
+	guint n = 0;
+	int cpu;
+
+	g_return_val_if_fail (n_cpus != NULL, NULL);
+
+	*n_cpus = 0;
+
+	CPU_ZERO (&cpu_set);
+	if (!_read_cpu_list ("/sys/devices/system/cpu/isolated", &cpu_set))
+		return NULL;
+
+	cpus = g_new (guint, CPU_COUNT (&cpu_set));
+	for (cpu = 0; cpu < CPU_SETSIZE; cpu++)
+		if (CPU_ISSET (cpu, &cpu_set))
+			cpus[n++] = cpu;
+
+	*n_cpus = n;
+
+	return cpus;
+}
+
+/* Placement of the threads which are not in the acquisition path. @cpu_list uses the kernel cpulist format, %NULL
+ * leaves the affinity unchanged. A positive @nice_level lowers the priority of the thread, which needs no
+ * privilege. */
+
+gboolean
+arv_make_thread_auxiliary (const char *cpu_list, int nice_level)
+{
+	gboolean success = TRUE;
+
+	if (cpu_list != NULL && cpu_list[0] != '\0') {
+		cpu_set_t cpu_set;
+
+		CPU_ZERO (&cpu_set);
+		if (!_parse_cpu_list (cpu_list, &cpu_set)) {
+			arv_warning_misc ("Invalid CPU list '%s'", cpu_list);
+			success = FALSE;
+		} else if (sched_setaffinity (_gettid (), sizeof (cpu_set), &cpu_set) < 0) {
+			arv_warning_misc ("Failed to set thread CPU affinity to '%s': %s", cpu_list, strerror (errno));
+			success = FALSE;
+		}
+	}
+
+	if (setpriority (PRIO_PROCESS, _gettid (), nice_level) < 0) {
+		arv_warning_misc ("Failed to set thread nice level to %d: %s", nice_level, strerror (errno));
+		success = FALSE;
+	}
+
+	if (success)
+		arv_info_misc ("Auxiliary thread placed (cpus '%s', nice level %d)",
+			       cpu_list != NULL ? cpu_list : "", nice_level);
+
+	return success;
+}
+
+gboolean
+arv_numa_bind_memory (void *memory, size_t size, int numa_node)
+{
+#ifdef SYS_mbind
+	unsigned long node_mask[ARV_NUMA_N_NODES_MAX / (8 * sizeof (unsigned long))] = {0};
+
+	g_return_val_if_fail (numa_node >= 0 && numa_node < ARV_NUMA_N_NODES_MAX, FALSE);
+
+	node_mask[numa_node / (8 * sizeof (unsigned long))] = 1UL << (numa_node % (8 * sizeof (unsigned long)));
+
+	if (syscall (SYS_mbind, memory, size, ARV_MPOL_PREFERRED, node_mask, ARV_NUMA_N_NODES_MAX + 1, 0) < 0) {
+		arv_warning_misc ("Failed to bind memory to NUMA node %d: %s", numa_node, strerror (errno));
+		return FALSE;
+	}
+
+	return TRUE;
+#else
+	return FALSE;
+#endif
+}
+
 #else
 
 gboolean
@@ -336,4 +639,188 @@ arv_make_thread_high_priority (int nice_level)
 
 	return FALSE;
 }
+
+gboolean
+arv_make_thread_affine (int cpu_index, int numa_node)
+{
+	arv_info_misc ("Thread affinity not supported on OSX/Windows");
+
+	return FALSE;
+}
+
+gboolean
+arv_make_thread_deadline (gint64 runtime_us, gint64 period_us)
+{
+	arv_info_misc ("SCHED_DEADLINE not supported on OSX/Windows");
+
+	return FALSE;
+}
+
+gboolean
+arv_lock_memory (void)
+{
+	arv_info_misc ("Memory locking not supported on OSX/Windows");
+
+	return FALSE;
+}
+
+guint *
+arv_get_isolated_cpus (guint *n_cpus)
+{
+	g_return_val_if_fail (n_cpus != NULL, NULL);
+
+	*n_cpus = 0;
+
+	return NULL;
+}
+
+gboolean
+arv_make_thread_auxiliary (const char *cpu_list, int nice_level)
+{
+	arv_info_misc ("Thread placement not supported on OSX/Windows");
+
+	return FALSE;
+}
+
+gboolean
+arv_numa_bind_memory (void *memory, size_t size, int numa_node)
+{
+	return FALSE;
+}
 #endif
+
+#define ARV_N_INTERNAL_THREADS	3
+
+typedef struct {
+	ArvThreadScheduling scheduling;
+	int priority;
+	gint64 runtime_us;
+	gint64 period_us;
+	int cpu_index;
+} ArvInternalThreadSettings;
+
+static GMutex internal_thread_mutex;
+static ArvInternalThreadSettings internal_thread_settings[ARV_N_INTERNAL_THREADS] = {
+	{ARV_THREAD_SCHEDULING_DEFAULT, 0, 0, 0, -1},
+	{ARV_THREAD_SCHEDULING_DEFAULT, 0, 0, 0, -1},
+	{ARV_THREAD_SCHEDULING_DEFAULT, 0, 0, 0, -1}
+};
+
+/**
+ * arv_set_internal_thread_scheduling:
+ * @threads: the internal threads to configure
+ * @scheduling: scheduling policy
+ * @priority: realtime priority for %ARV_THREAD_SCHEDULING_REALTIME, nice level for
+ * %ARV_THREAD_SCHEDULING_HIGH_PRIORITY
+ *
+ * Set the scheduling policy the Aravis internal threads apply to themselves when they start. The threads already
+ * running are not affected. For %ARV_THREAD_SCHEDULING_DEADLINE, use arv_set_internal_thread_deadline().
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_set_internal_thread_scheduling (ArvInternalThread threads, ArvThreadScheduling scheduling, int priority)
+{
+	guint i;
+
+	g_return_if_fail (scheduling != ARV_THREAD_SCHEDULING_DEADLINE);
+
+	g_mutex_lock (&internal_thread_mutex);
+	for (i = 0; i < ARV_N_INTERNAL_THREADS; i++) {
+		if ((threads & (1 << i)) == 0)
+			continue;
+
+		internal_thread_settings[i].scheduling = scheduling;
+		internal_thread_settings[i].priority = priority;
+	}
+	g_mutex_unlock (&internal_thread_mutex);
+}
+
+/**
+ * arv_set_internal_thread_deadline:
+ * @threads: the internal threads to configure
+ * @runtime_us: CPU time needed for each period, in µs
+ * @period_us: activation period, in µs
+ *
+ * Make the Aravis internal threads use SCHED_DEADLINE when they start, see arv_make_thread_deadline(). The threads
+ * already running are not affected.
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_set_internal_thread_deadline (ArvInternalThread threads, gint64 runtime_us, gint64 period_us)
+{
+	guint i;
+
+	g_return_if_fail (runtime_us > 0 && runtime_us <= period_us);
+
+	g_mutex_lock (&internal_thread_mutex);
+	for (i = 0; i < ARV_N_INTERNAL_THREADS; i++) {
+		if ((threads & (1 << i)) == 0)
+			continue;
+
+		internal_thread_settings[i].scheduling = ARV_THREAD_SCHEDULING_DEADLINE;
+		internal_thread_settings[i].runtime_us = runtime_us;
+		internal_thread_settings[i].period_us = period_us;
+	}
+	g_mutex_unlock (&internal_thread_mutex);
+}
+
+/**
+ * arv_set_internal_thread_affinity:
+ * @threads: the internal threads to configure
+ * @cpu_index: index of the CPU the threads must run on, or -1
+ *
+ * Pin the Aravis internal threads to a CPU when they start, see arv_make_thread_affine(). The cpu-affinity property
+ * of a stream takes precedence over this setting for its thread.
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_set_internal_thread_affinity (ArvInternalThread threads, int cpu_index)
+{
+	guint i;
+
+	g_mutex_lock (&internal_thread_mutex);
+	for (i = 0; i < ARV_N_INTERNAL_THREADS; i++)
+		if ((threads & (1 << i)) != 0)
+			internal_thread_settings[i].cpu_index = cpu_index;
+	g_mutex_unlock (&internal_thread_mutex);
+}
+
+/* Called by the internal threads, when they start */
+
+void
+arv_apply_internal_thread_scheduling (ArvInternalThread thread)
+{
+	ArvInternalThreadSettings settings;
+	int index;
+
+	index = g_bit_nth_lsf (thread, -1);
+	g_return_if_fail (index >= 0 && index < ARV_N_INTERNAL_THREADS);
+
+	g_mutex_lock (&internal_thread_mutex);
+	settings = internal_thread_settings[index];
+	g_mutex_unlock (&internal_thread_mutex);
+
+	/* Affinity first, as the kernel may refuse to change the affinity of a deadline thread */
+	if (settings.cpu_index >= 0)
+		arv_make_thread_affine (settings.cpu_index, -1);
+
+	switch (settings.scheduling) {
+		case ARV_THREAD_SCHEDULING_HIGH_PRIORITY:
+			arv_make_thread_high_priority (settings.priority);
+			break;
+		case ARV_THREAD_SCHEDULING_REALTIME:
+			arv_make_thread_realtime (settings.priority);
+			break;
+		case ARV_THREAD_SCHEDULING_DEADLINE:
+			arv_make_thread_deadline (settings.runtime_us, settings.period_us);
+			break;
+		default:
+			break;
+	}
+}
@@ -31,8 +31,52 @@
 
 G_BEGIN_DECLS
 
+/**
+ * ArvInternalThread:
+ * @ARV_INTERNAL_THREAD_STREAM: stream receiving threads
+ * @ARV_INTERNAL_THREAD_HEARTBEAT: GigE Vision heartbeat threads
+ * @ARV_INTERNAL_THREAD_EVENT: device event threads
+ * @ARV_INTERNAL_THREAD_ALL: all the above threads
+ *
+ * Since: 0.8.11
+ */
+
+typedef enum {
+	ARV_INTERNAL_THREAD_STREAM =	1 << 0,
+	ARV_INTERNAL_THREAD_HEARTBEAT =	1 << 1,
+	ARV_INTERNAL_THREAD_EVENT =	1 << 2,
+	ARV_INTERNAL_THREAD_ALL =	0x7
+} ArvInternalThread;
+
+/**
+ * ArvThreadScheduling:
+ * @ARV_THREAD_SCHEDULING_DEFAULT: leave the scheduling of the thread unchanged
+ * @ARV_THREAD_SCHEDULING_HIGH_PRIORITY: nice level, see arv_make_thread_high_priority()
+ * @ARV_THREAD_SCHEDULING_REALTIME: SCHED_RR priority, see arv_make_thread_realtime()
+ * @ARV_THREAD_SCHEDULING_DEADLINE: SCHED_DEADLINE runtime and period, see arv_make_thread_deadline()
+ *
+ * Since: 0.8.11
+ */
+
+typedef enum {
+	ARV_THREAD_SCHEDULING_DEFAULT,
+	ARV_THREAD_SCHEDULING_HIGH_PRIORITY,
+	ARV_THREAD_SCHEDULING_REALTIME,
+	ARV_THREAD_SCHEDULING_DEADLINE
+} ArvThreadScheduling;
+
 gboolean	arv_make_thread_realtime 		(int priority);
 gboolean	arv_make_thread_high_priority 		(int nice_level);
+gboolean	arv_make_thread_affine			(int cpu_index, int numa_node);
+gboolean	arv_make_thread_deadline		(gint64 runtime_us, gint64 period_us);
+
+gboolean	arv_lock_memory				(void);
+guint *		arv_get_isolated_cpus			(guint *n_cpus);
+
+void		arv_set_internal_thread_scheduling	(ArvInternalThread threads, ArvThreadScheduling scheduling,
+							 int priority);
+void		arv_set_internal_thread_deadline	(ArvInternalThread threads, gint64 runtime_us, gint64 period_us);
+void		arv_set_internal_thread_affinity	(ArvInternalThread threads, int cpu_index);
 
 G_END_DECLS
 
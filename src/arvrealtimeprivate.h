@@ -40,4 +40,9 @@ gint64		arv_rtkit_get_rttime_usec_max 		(GDBusConnection *connection, GError **e
 void		arv_rtkit_make_realtime 		(GDBusConnection *connection, pid_t thread, int priority, GError **error);
 void		arv_rtkit_make_high_priority 		(GDBusConnection *connection, pid_t thread, int nice_level, GError **error);
 
+gboolean	arv_numa_bind_memory			(void *memory, size_t size, int numa_node);
+gboolean	arv_make_thread_auxiliary		(const char *cpu_list, int nice_level);
+
+void		arv_apply_internal_thread_scheduling	(ArvInternalThread thread);
+
 #endif
@@ -0,0 +1,612 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2019 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel@gnome.org>
+ */
+
+/**
+ * SECTION: arvregistersnapshot
+ * @short_description: In-memory image of the device registers
+ *
+ * #ArvRegisterSnapshot holds a copy of parts of the device memory, stored by aligned pages, with the validity of each
+ * byte, and optionally the Genicam data of the device. Once set on a Genicam document using
+ * arv_gc_set_register_recorder(), it is filled with the data of all the register reads. Once set using
+ * arv_gc_set_register_snapshot(), the document does not access the device anymore: the reads are served from the
+ * snapshot, and the writes are applied to the snapshot and recorded, in order. Features can then be evaluated without
+ * any device, in a deterministic way.
+ *
+ * A snapshot can be saved to a file and loaded back. The file is mapped in memory, and its pages are used in place
+ * until they are written.
+ *
+ * |[<!-- language="C" -->
+ * snapshot = arv_register_snapshot_new_from_file ("camera.arvregs", &error);
+ * xml = arv_register_snapshot_get_genicam_xml (snapshot, &size);
+ * genicam = arv_gc_new (NULL, xml, size);
+ * arv_gc_set_register_snapshot (genicam, snapshot);
+ * width = arv_gc_integer_get_value (ARV_GC_INTEGER (arv_gc_get_node (genicam, "Width")), &error);
+ * ]|
+ */
+
+#include <arvregistersnapshot.h>
+#include <arvdebugprivate.h>
+#include <gio/gio.h>
+#include <string.h>
+
+#define ARV_REGISTER_SNAPSHOT_MAGIC		0x53565241	/* "ARVS" */
+#define ARV_REGISTER_SNAPSHOT_VERSION		1
+#define ARV_REGISTER_SNAPSHOT_PAGE_SIZE		256
+
+/* File layout: the header, the pages sorted by address, then the Genicam data. All the fields are little endian. */
+
+typedef struct {
+	guint32 magic;
+	guint32 version;
+	guint32 n_pages;
+	guint32 genicam_xml_size;
+} ArvRegisterSnapshotHeader;
+
+typedef struct {
+	guint64 address;
+	guint8 valid[ARV_REGISTER_SNAPSHOT_PAGE_SIZE / 8];
+	guint8 data[ARV_REGISTER_SNAPSHOT_PAGE_SIZE];
+} ArvRegisterSnapshotPage;
+
+typedef struct {
+	guint64 address;
+	/* Either in the file mapping, or owned when is_owned is TRUE */
+	ArvRegisterSnapshotPage *page;
+	gboolean is_owned;
+} ArvRegisterSnapshotPageRef;
+
+typedef struct {
+	guint64 address;
+	guint32 size;
+	guint offset;
+} ArvRegisterSnapshotWrite;
+
+struct _ArvRegisterSnapshot {
+	GObject object;
+
+	GMutex mutex;
+
+	GMappedFile *mapped_file;
+	/* Sorted by address */
+	GArray *pages;
+
+	char *genicam_xml;
+	size_t genicam_xml_size;
+
+	GArray *writes;
+	GByteArray *write_data;
+};
+
+G_DEFINE_TYPE (ArvRegisterSnapshot, arv_register_snapshot, G_TYPE_OBJECT)
+
+/* Returns the index of the page at address, or of the page it should be inserted before */
+
+static guint
+_find_page (ArvRegisterSnapshot *snapshot, guint64 address, gboolean *found)
+{
+	guint low = 0;
+	guint high = snapshot->pages->len;
+
+	while (low < high) {
+		guint middle = low + (high - low) / 2;
+		guint64 middle_address = g_array_index (snapshot->pages, ArvRegisterSnapshotPageRef, middle).address;
+
+		if (middle_address == address) {
+			*found = TRUE;
+			return middle;
+		}
+
+		if (middle_address < address)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+
+	*found = FALSE;
+
+	return low;
+}
+
+/* Returns a page which can be modified, copying it from the file mapping if needed */
+
+static ArvRegisterSnapshotPage *
+_get_writable_page (ArvRegisterSnapshot *snapshot, guint64 address)
+{
+	ArvRegisterSnapshotPageRef *ref;
+	gboolean found;
+	guint index;
+
+	index = _find_page (snapshot, address, &found);
+
+	if (!found) {
+		ArvRegisterSnapshotPageRef new_ref;
+
+		new_ref.address = address;
+		new_ref.page = g_new0 (ArvRegisterSnapshotPage, 1);
+		new_ref.page->address = GUINT64_TO_LE (address);
+		new_ref.is_owned = TRUE;
+
+		g_array_insert_val (snapshot->pages, index, new_ref);
+	}
+
+	ref = &g_array_index (snapshot->pages, ArvRegisterSnapshotPageRef, index);
+
+	if (!ref->is_owned) {
+		ref->page = g_memdup (ref->page, sizeof (ArvRegisterSnapshotPage));
+		ref->is_owned = TRUE;
+	}
+
+	return ref->page;
+}
+
+static void
+_store (ArvRegisterSnapshot *snapshot, guint64 address, guint32 size, const guint8 *data)
+{
+	while (size > 0) {
+		ArvRegisterSnapshotPage *page;
+		guint64 page_address = address & ~((guint64) ARV_REGISTER_SNAPSHOT_PAGE_SIZE - 1);
+		guint offset = address - page_address;
+		guint length = MIN (size, ARV_REGISTER_SNAPSHOT_PAGE_SIZE - offset);
+		guint i;
+
+		page = _get_writable_page (snapshot, page_address);
+		memcpy (page->data + offset, data, length);
+		for (i = offset; i < offset + length; i++)
+			page->valid[i / 8] |= 1 << (i % 8);
+
+		address += length;
+		data += length;
+		size -= length;
+	}
+}
+
+/**
+ * arv_register_snapshot_store:
+ * @snapshot: a #ArvRegisterSnapshot
+ * @address: memory address
+ * @size: data size
+ * @data: (array length=size) (element-type guint8): register data
+ *
+ * Stores the data read at @address in the snapshot, replacing any previous value. Unlike
+ * arv_register_snapshot_write(), the write is not recorded.
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_register_snapshot_store (ArvRegisterSnapshot *snapshot, guint64 address, guint32 size, const void *data)
+{
+	g_return_if_fail (ARV_IS_REGISTER_SNAPSHOT (snapshot));
+	g_return_if_fail (data != NULL || size == 0);
+
+	g_mutex_lock (&snapshot->mutex);
+	_store (snapshot, address, size, data);
+	g_mutex_unlock (&snapshot->mutex);
+}
+
+/**
+ * arv_register_snapshot_read:
+ * @snapshot: a #ArvRegisterSnapshot
+ * @address: memory address
+ * @size: data size
+ * @buffer: (out caller-allocates) (array length=size) (element-type guint8): a buffer of @size bytes
+ *
+ * Reads the snapshot data at @address.
+ *
+ * Returns: %TRUE if all the requested data is in the snapshot.
+ *
+ * Since: 0.8.11
+ */
+
+gboolean
+arv_register_snapshot_read (ArvRegisterSnapshot *snapshot, guint64 address, guint32 size, void *buffer)
+{
+	guint8 *data = buffer;
+	gboolean success = TRUE;
+
+	g_return_val_if_fail (ARV_IS_REGISTER_SNAPSHOT (snapshot), FALSE);
+	g_return_val_if_fail (buffer != NULL || size == 0, FALSE);
+
+	g_mutex_lock (&snapshot->mutex);
+
+	while (size > 0 && success) {
+		const ArvRegisterSnapshotPage *page;
+		guint64 page_address = address & ~((guint64) ARV_REGISTER_SNAPSHOT_PAGE_SIZE - 1);
+		guint offset = address - page_address;
+		guint length = MIN (size, ARV_REGISTER_SNAPSHOT_PAGE_SIZE - offset);
+		gboolean found;
+		guint index;
+		guint i;
+
+		index = _find_page (snapshot, page_address, &found);
+		if (!found) {
+			success = FALSE;
+			break;
+		}
+
+		page = g_array_index (snapshot->pages, ArvRegisterSnapshotPageRef, index).page;
+		for (i = offset; i < offset + length && success; i++)
+			success = (page->valid[i / 8] & (1 << (i % 8))) != 0;
+
+		memcpy (data, page->data + offset, length);
+
+		address += length;
+		data += length;
+		size -= length;
+	}
+
+	g_mutex_unlock (&snapshot->mutex);
+
+	return success;
+}
+
+/**
+ * arv_register_snapshot_write:
+ * @snapshot: a #ArvRegisterSnapshot
+ * @address: memory address
+ * @size: data size
+ * @data: (array length=size) (element-type guint8): written data
+ *
+ * Applies a register write to the snapshot, and appends it to the list of recorded writes.
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_register_snapshot_write (ArvRegisterSnapshot *snapshot, guint64 address, guint32 size, const void *data)
+{
+	ArvRegisterSnapshotWrite write;
+
+	g_return_if_fail (ARV_IS_REGISTER_SNAPSHOT (snapshot));
+	g_return_if_fail (data != NULL || size == 0);
+
+	g_mutex_lock (&snapshot->mutex);
+
+	_store (snapshot, address, size, data);
+
+	write.address = address;
+	write.size = size;
+	write.offset = snapshot->write_data->len;
+	g_array_append_val (snapshot->writes, write);
+	g_byte_array_append (snapshot->write_data, data, size);
+
+	g_mutex_unlock (&snapshot->mutex);
+}
+
+/**
+ * arv_register_snapshot_get_n_writes:
+ * @snapshot: a #ArvRegisterSnapshot
+ *
+ * Returns: the number of writes recorded by arv_register_snapshot_write().
+ *
+ * Since: 0.8.11
+ */
+
+guint
+arv_register_snapshot_get_n_writes (ArvRegisterSnapshot *snapshot)
+{
+	guint n_writes;
+
+	g_return_val_if_fail (ARV_IS_REGISTER_SNAPSHOT (snapshot), 0);
+
+	g_mutex_lock (&snapshot->mutex);
+	n_writes = snapshot->writes->len;
+	g_mutex_unlock (&snapshot->mutex);
+
+	return n_writes;
+}
+
+/**
+ * arv_register_snapshot_get_write:
+ * @snapshot: a #ArvRegisterSnapshot
+ * @index: write index, in write order
+ * @address: (out) (optional): written address
+ * @size: (out) (optional): written size
+ *
+ * Returns: (transfer none): the written data, valid until the writes are cleared, or %NULL if @index is out of range.
+ *
+ * Since: 0.8.11
+ */
+
+const void *
+arv_register_snapshot_get_write (ArvRegisterSnapshot *snapshot, guint index, guint64 *address, guint32 *size)
+{
+	const void *data = NULL;
+
+	if (address != NULL)
+		*address = 0;
+	if (size != NULL)
+		*size = 0;
+
+	g_return_val_if_fail (ARV_IS_REGISTER_SNAPSHOT (snapshot), NULL);
+
+	g_mutex_lock (&snapshot->mutex);
+
+	if (index < snapshot->writes->len) {
+		ArvRegisterSnapshotWrite *write = &g_array_index (snapshot->writes, ArvRegisterSnapshotWrite, index);
+
+		if (address != NULL)
+			*address = write->address;
+		if (size != NULL)
+			*size = write->size;
+		data = snapshot->write_data->data + write->offset;
+	}
+
+	g_mutex_unlock (&snapshot->mutex);
+
+	return data;
+}
+
+/**
+ * arv_register_snapshot_clear_writes:
+ * @snapshot: a #ArvRegisterSnapshot
+ *
+ * Empties the list of recorded writes. The written values are kept in the snapshot.
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_register_snapshot_clear_writes (ArvRegisterSnapshot *snapshot)
+{
+	g_return_if_fail (ARV_IS_REGISTER_SNAPSHOT (snapshot));
+
+	g_mutex_lock (&snapshot->mutex);
+	g_array_set_size (snapshot->writes, 0);
+	g_byte_array_set_size (snapshot->write_data, 0);
+	g_mutex_unlock (&snapshot->mutex);
+}
+
+/**
+ * arv_register_snapshot_set_genicam_xml:
+ * @snapshot: a #ArvRegisterSnapshot
+ * @xml: (array length=size) (element-type guint8): Genicam data
+ * @size: size of @xml
+ *
+ * Stores the Genicam data of the device, saved along the registers.
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_register_snapshot_set_genicam_xml (ArvRegisterSnapshot *snapshot, const char *xml, size_t size)
+{
+	g_return_if_fail (ARV_IS_REGISTER_SNAPSHOT (snapshot));
+	g_return_if_fail (xml != NULL || size == 0);
+
+	g_mutex_lock (&snapshot->mutex);
+	g_free (snapshot->genicam_xml);
+	snapshot->genicam_xml = g_memdup (xml, size);
+	snapshot->genicam_xml_size = size;
+	g_mutex_unlock (&snapshot->mutex);
+}
+
+/**
+ * arv_register_snapshot_get_genicam_xml:
+ * @snapshot: a #ArvRegisterSnapshot
+ * @size: (out): size of the Genicam data
+ *
+ * Returns: (transfer none) (array length=size) (element-type guint8): the Genicam data, or %NULL.
+ *
+ * Since: 0.8.11
+ */
+
+const char *
+arv_register_snapshot_get_genicam_xml (ArvRegisterSnapshot *snapshot, size_t *size)
+{
+	g_return_val_if_fail (ARV_IS_REGISTER_SNAPSHOT (snapshot), NULL);
+
+	if (size != NULL)
+		*size = snapshot->genicam_xml_size;
+
+	return snapshot->genicam_xml;
+}
+
+/**
+ * arv_register_snapshot_save:
+ * @snapshot: a #ArvRegisterSnapshot
+ * @filename: file name
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Saves the snapshot registers and Genicam data to a file. The recorded writes are not saved.
+ *
+ * Returns: %TRUE on success.
+ *
+ * Since: 0.8.11
+ */
+
+gboolean
+arv_register_snapshot_save (ArvRegisterSnapshot *snapshot, const char *filename, GError **error)
+{
+	ArvRegisterSnapshotHeader header;
+	GByteArray *array;
+	gboolean success;
+	guint i;
+
+	g_return_val_if_fail (ARV_IS_REGISTER_SNAPSHOT (snapshot), FALSE);
+	g_return_val_if_fail (filename != NULL, FALSE);
+
+	array = g_byte_array_new ();
+
+	g_mutex_lock (&snapshot->mutex);
+
+	header.magic = GUINT32_TO_LE (ARV_REGISTER_SNAPSHOT_MAGIC);
+	header.version = GUINT32_TO_LE (ARV_REGISTER_SNAPSHOT_VERSION);
+	header.n_pages = GUINT32_TO_LE (snapshot->pages->len);
+	header.genicam_xml_size = GUINT32_TO_LE (snapshot->genicam_xml_size);
+	g_byte_array_append (array, (guint8 *) &header, sizeof (header));
+
+	for (i = 0; i < snapshot->pages->len; i++)
+		g_byte_array_append (array,
+				     (guint8 *) g_array_index (snapshot->pages, ArvRegisterSnapshotPageRef, i).page,
+				     sizeof (ArvRegisterSnapshotPage));
+
+	if (snapshot->genicam_xml != NULL)
+		g_byte_array_append (array, (guint8 *) snapshot->genicam_xml, snapshot->genicam_xml_size);
+
+	g_mutex_unlock (&snapshot->mutex);
+
+	success = g_file_set_contents (filename, (char *) array->data, array->len, error);
+
+	g_byte_array_unref (array);
+
+	return success;
+}
+
+/**
+ * arv_register_snapshot_new_from_file:
+ * @filename: file name
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Loads a snapshot saved by arv_register_snapshot_save(). The file is mapped in memory.
+ *
+ * Returns: (transfer full): a new #ArvRegisterSnapshot, or %NULL on error.
+ *
+ * Since: 0.8.11
+ */
+
+ArvRegisterSnapshot *
+arv_register_snapshot_new_from_file (const char *filename, GError **error)
+{
+	ArvRegisterSnapshot *snapshot;
+	ArvRegisterSnapshotHeader header;
+	GMappedFile *mapped_file;
+	const char *contents;
+	gsize length;
+	guint n_pages;
+	guint32 genicam_xml_size;
+	guint i;
+
+	g_return_val_if_fail (filename != NULL, NULL);
+
+	mapped_file = g_mapped_file_new (filename, FALSE, error);
+	if (mapped_file == NULL)
+		return NULL;
+
+	contents = g_mapped_file_get_contents (mapped_file);
+	length = g_mapped_file_get_length (mapped_file);
+
+	if (length < sizeof (header)) {
+		g_set_error (error, G_FILE_ERROR, G_FILE_ERROR_INVAL, "'%s' is too short for a register snapshot",
+			     filename);
+		g_mapped_file_unref (mapped_file);
+		return NULL;
+	}
+
+	memcpy (&header, contents, sizeof (header));
+	n_pages = GUINT32_FROM_LE (header.n_pages);
+	genicam_xml_size = GUINT32_FROM_LE (header.genicam_xml_size);
+
+	if (GUINT32_FROM_LE (header.magic) != ARV_REGISTER_SNAPSHOT_MAGIC ||
+	    GUINT32_FROM_LE (header.version) != ARV_REGISTER_SNAPSHOT_VERSION ||
+	    (length - sizeof (header)) / sizeof (ArvRegisterSnapshotPage) < n_pages ||
+	    length - sizeof (header) - (gsize) n_pages * sizeof (ArvRegisterSnapshotPage) != genicam_xml_size) {
+		g_set_error (error, G_FILE_ERROR, G_FILE_ERROR_INVAL, "'%s' is not a valid register snapshot",
+			     filename);
+		g_mapped_file_unref (mapped_file);
+		return NULL;
+	}
+
+	snapshot = arv_register_snapshot_new ();
+	snapshot->mapped_file = mapped_file;
+
+	for (i = 0; i < n_pages; i++) {
+		ArvRegisterSnapshotPageRef ref;
+
+		ref.page = (ArvRegisterSnapshotPage *) (contents + sizeof (header) + i * sizeof (ArvRegisterSnapshotPage));
+		ref.address = GUINT64_FROM_LE (ref.page->address);
+		ref.is_owned = FALSE;
+
+		if (i > 0 && ref.address <= g_array_index (snapshot->pages, ArvRegisterSnapshotPageRef, i - 1).address) {
+			g_set_error (error, G_FILE_ERROR, G_FILE_ERROR_INVAL, "Unsorted pages in register snapshot '%s'",
+				     filename);
+			g_object_unref (snapshot);
+			return NULL;
+		}
+
+		g_array_append_val (snapshot->pages, ref);
+	}
+
+	if (genicam_xml_size > 0) {
+		snapshot->genicam_xml = g_memdup (contents + sizeof (header) + n_pages * sizeof (ArvRegisterSnapshotPage),
+						  genicam_xml_size);
+		snapshot->genicam_xml_size = genicam_xml_size;
+	}
+
+	arv_info_genicam ("[RegisterSnapshot::new_from_file] %u pages loaded from '%s'", n_pages, filename);
+
+	return snapshot;
+}
+
+/**
+ * arv_register_snapshot_new:
+ *
+ * Returns: (transfer full): a new empty #ArvRegisterSnapshot.
+ *
+ * Since: 0.8.11
+ */
+
+ArvRegisterSnapshot *
+arv_register_snapshot_new (void)
+{
+	return g_object_new (ARV_TYPE_REGISTER_SNAPSHOT, NULL);
+}
+
+static void
+arv_register_snapshot_init (ArvRegisterSnapshot *snapshot)
+{
+	g_mutex_init (&snapshot->mutex);
+	snapshot->pages = g_array_new (FALSE, FALSE, sizeof (ArvRegisterSnapshotPageRef));
+	snapshot->writes = g_array_new (FALSE, FALSE, sizeof (ArvRegisterSnapshotWrite));
+	snapshot->write_data = g_byte_array_new ();
+}
+
+static void
+arv_register_snapshot_finalize (GObject *object)
+{
+	ArvRegisterSnapshot *snapshot = ARV_REGISTER_SNAPSHOT (object);
+	guint i;
+
+	for (i = 0; i < snapshot->pages->len; i++) {
+		ArvRegisterSnapshotPageRef *ref = &g_array_index (snapshot->pages, ArvRegisterSnapshotPageRef, i);
+
+		if (ref->is_owned)
+			g_free (ref->page);
+	}
+
+	g_array_unref (snapshot->pages);
+	g_clear_pointer (&snapshot->mapped_file, g_mapped_file_unref);
+	g_clear_pointer (&snapshot->genicam_xml, g_free);
+	g_array_unref (snapshot->writes);
+	g_byte_array_unref (snapshot->write_data);
+	g_mutex_clear (&snapshot->mutex);
+
+	G_OBJECT_CLASS (arv_register_snapshot_parent_class)->finalize (object);
+}
+
+static void
+arv_register_snapshot_class_init (ArvRegisterSnapshotClass *snapshot_class)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS (snapshot_class);
+
+	object_class->finalize = arv_register_snapshot_finalize;
+}
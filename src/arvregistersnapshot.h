@@ -0,0 +1,61 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2019 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel@gnome.org>
+ */
+
+
+#ifndef ARV_REGISTER_SNAPSHOT_H
+#define ARV_REGISTER_SNAPSHOT_H
+
+#if !defined (ARV_H_INSIDE) && !defined (ARAVIS_COMPILATION)
+#error "Only <arv.h> can be included directly."
+#endif
+
+#include <arvtypes.h>
+
+G_BEGIN_DECLS
+
+#define ARV_TYPE_REGISTER_SNAPSHOT             (arv_register_snapshot_get_type ())
+G_DECLARE_FINAL_TYPE (ArvRegisterSnapshot, arv_register_snapshot, ARV, REGISTER_SNAPSHOT, GObject)
+
+ArvRegisterSnapshot *	arv_register_snapshot_new			(void);
+ArvRegisterSnapshot *	arv_register_snapshot_new_from_file		(const char *filename, GError **error);
+gboolean		arv_register_snapshot_save			(ArvRegisterSnapshot *snapshot, const char *filename,
+									 GError **error);
+
+void			arv_register_snapshot_set_genicam_xml		(ArvRegisterSnapshot *snapshot,
+									 const char *xml, size_t size);
+const char *		arv_register_snapshot_get_genicam_xml		(ArvRegisterSnapshot *snapshot, size_t *size);
+
+void			arv_register_snapshot_store			(ArvRegisterSnapshot *snapshot, guint64 address,
+									 guint32 size, const void *data);
+gboolean		arv_register_snapshot_read			(ArvRegisterSnapshot *snapshot, guint64 address,
+									 guint32 size, void *buffer);
+void			arv_register_snapshot_write			(ArvRegisterSnapshot *snapshot, guint64 address,
+									 guint32 size, const void *data);
+
+guint			arv_register_snapshot_get_n_writes		(ArvRegisterSnapshot *snapshot);
+const void *		arv_register_snapshot_get_write			(ArvRegisterSnapshot *snapshot, guint index,
+									 guint64 *address, guint32 *size);
+void			arv_register_snapshot_clear_writes		(ArvRegisterSnapshot *snapshot);
+
+G_END_DECLS
+
+#endif
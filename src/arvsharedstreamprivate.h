@@ -0,0 +1,137 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2019 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel@gnome.org>
+ */
+
+#ifndef ARV_SHARED_STREAM_PRIVATE_H
+#define ARV_SHARED_STREAM_PRIVATE_H
+
+#if !defined (ARV_H_INSIDE) && !defined (ARAVIS_COMPILATION)
+#error "Only <arv.h> can be included directly."
+#endif
+
+#include <arvfeatures.h>
+#include <glib.h>
+#if ARAVIS_HAS_SHARED_STREAM
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+G_BEGIN_DECLS
+
+/* Layout of the memory file shared by a #ArvStreamPublisher and its #ArvStreamSubscriber instances:
+ *
+ *   [ ArvSharedStreamHeader ][ ArvSharedStreamSlot 0 ] ... [ slot n_slots - 1 ][ padding ][ data 0 ] ... [ data n - 1 ]
+ *   0                                                                          data_offset + i * slot_size
+ *
+ * The control area, up to data_offset, is mapped read-write by the subscribers, for the slot reference counts. The
+ * data area is mapped read-only. The file is handed to the subscribers through the abstract unix socket of the
+ * publisher, named after ARV_SHARED_STREAM_SOCKET_PREFIX.
+ *
+ * A slot reference count is -1 while the publisher writes into it. The publisher only takes slots with a null
+ * reference count, and the subscribers only reference slots with a positive or null one, by atomic exchanges. */
+
+#define ARV_SHARED_STREAM_MAGIC			0x41525653	/* ARVS */
+#define ARV_SHARED_STREAM_VERSION		2
+#define ARV_SHARED_STREAM_SOCKET_PREFIX		"aravis-stream-"
+#define ARV_SHARED_STREAM_N_SLOTS_MAX		256
+#define ARV_SHARED_STREAM_N_PARTS_MAX		16
+
+/* Multipart payload part, as in ArvBufferPart, with fixed size fields */
+
+typedef struct {
+	guint64 data_offset;
+	guint64 size;
+	guint32 data_type;
+	guint32 pixel_format;
+	guint32 x_offset;
+	guint32 y_offset;
+	guint32 width;
+	guint32 height;
+} ArvSharedStreamPart;
+
+typedef struct {
+	gint refcount;
+	guint32 status;
+	/* Index of the frame in the publication order, starting at 1, 0 for an empty slot */
+	guint64 frame_index;
+	guint64 frame_id;
+	guint64 timestamp_ns;
+	guint64 system_timestamp_ns;
+	guint64 size;
+	guint32 payload_type;
+	guint32 pixel_format;
+	guint32 width;
+	guint32 height;
+	guint32 x_offset;
+	guint32 y_offset;
+	guint32 chunk_endianness;
+	/* Number of parts of a multipart payload, 0 otherwise */
+	guint32 n_parts;
+	ArvSharedStreamPart parts[ARV_SHARED_STREAM_N_PARTS_MAX];
+} ArvSharedStreamSlot;
+
+typedef struct {
+	guint32 magic;
+	guint32 version;
+	guint32 n_slots;
+	guint32 is_closed;
+	guint64 slot_size;
+	guint64 data_offset;
+
+	/* Futex word, incremented on each publication and on the publisher destruction */
+	gint sequence;
+	guint32 reserved;
+
+	guint64 n_published;
+	guint64 n_dropped;
+
+	ArvSharedStreamSlot slots[];
+} ArvSharedStreamHeader;
+
+#if ARAVIS_HAS_SHARED_STREAM
+
+/* The futex operations are not private, the header is mapped by several processes */
+
+static inline void
+arv_shared_stream_wait (ArvSharedStreamHeader *header, gint sequence, gint64 timeout_us)
+{
+	struct timespec timeout;
+
+	timeout.tv_sec = timeout_us / 1000000;
+	timeout.tv_nsec = (timeout_us % 1000000) * 1000;
+
+	syscall (SYS_futex, &header->sequence, FUTEX_WAIT, sequence, &timeout, NULL, 0);
+}
+
+static inline void
+arv_shared_stream_wake (ArvSharedStreamHeader *header)
+{
+	g_atomic_int_inc (&header->sequence);
+	syscall (SYS_futex, &header->sequence, FUTEX_WAKE, G_MAXINT, NULL, NULL, 0);
+}
+
+#endif
+
+G_END_DECLS
+
+#endif
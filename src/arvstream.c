@@ -31,11 +31,32 @@
  */
 
 #include <arvstreamprivate.h>
-#include <arvbuffer.h>
+#include <arvbufferprivate.h>
+#include <arvbufferallocator.h>
+#include <arvbufferqueueprivate.h>
+#include <arvtilepipelineprivate.h>
+#include <arvprocessingstageprivate.h>
+#include <arveventringprivate.h>
+#include <arvwakeupprivate.h>
+#include <arvmemcopyprivate.h>
 #include <arvdevice.h>
+#include <arvdeviceprivate.h>
+#include <arvchunkparser.h>
 #include <arvdebugprivate.h>
+#include <arvtraceprivate.h>
+#include <arvrealtimeprivate.h>
+#include <arvframetimingprivate.h>
+#include <arvbufferbudgetprivate.h>
 #include <gio/gio.h>
 
+#define ARV_STREAM_POOL_MIN_SIZE_DEFAULT	4
+#define ARV_STREAM_POOL_MAX_SIZE_DEFAULT	64
+/* The pool shrinks when at least ARV_STREAM_POOL_IDLE_BUFFERS buffers stay unused during ARV_STREAM_POOL_IDLE_US */
+#define ARV_STREAM_POOL_IDLE_BUFFERS		2
+#define ARV_STREAM_POOL_IDLE_US			5000000
+/* Capacity margin of the pool buffers allocated after a payload size increase, as a fraction of the payload size */
+#define ARV_STREAM_POOL_GROWTH_MARGIN_DIVISOR	8
+
 enum {
 	ARV_STREAM_SIGNAL_NEW_BUFFER,
 	ARV_STREAM_SIGNAL_LAST
@@ -48,12 +69,91 @@ enum {
 	ARV_STREAM_PROPERTY_EMIT_SIGNALS,
 	ARV_STREAM_PROPERTY_DEVICE,
 	ARV_STREAM_PROPERTY_CALLBACK,
-	ARV_STREAM_PROPERTY_CALLBACK_DATA
+	ARV_STREAM_PROPERTY_CALLBACK_DATA,
+	ARV_STREAM_PROPERTY_CPU_AFFINITY,
+	ARV_STREAM_PROPERTY_NUMA_NODE,
+	ARV_STREAM_PROPERTY_REGION_READY_SIZE,
+	ARV_STREAM_PROPERTY_LOCK_FREE_QUEUES,
+	ARV_STREAM_PROPERTY_MAILBOX,
+	ARV_STREAM_PROPERTY_MAX_AGE,
+	ARV_STREAM_PROPERTY_BUFFER_POOL,
+	ARV_STREAM_PROPERTY_POOL_MIN_SIZE,
+	ARV_STREAM_PROPERTY_POOL_MAX_SIZE,
+	ARV_STREAM_PROPERTY_POOL_SIZE,
+	ARV_STREAM_PROPERTY_POOL_HIGH_WATER_MARK,
+	ARV_STREAM_PROPERTY_EVENT_RING_FILENAME,
+	ARV_STREAM_PROPERTY_EVENT_RING_FAILURES,
+	ARV_STREAM_PROPERTY_POP_SPIN_TIME,
+	ARV_STREAM_PROPERTY_POOL_ALLOCATOR,
+	ARV_STREAM_PROPERTY_CHECKSUM,
+	ARV_STREAM_PROPERTY_EXPECTED_FRAME_PERIOD,
+	ARV_STREAM_PROPERTY_FRAME_GAP_RATIO
 } ArvStreamProperties;
 
+/* Named statistic, pointing to a counter of the thread data of the backend */
+
+typedef struct {
+	char *name;
+	GType type;
+	gpointer data;
+} ArvStreamInfo;
+
+/* Histogram of an ArvStatistic, owned by the backend or the stream */
+
+typedef struct {
+	char *name;
+	const ArvStatistic *statistic;
+	guint histogram_id;
+} ArvStreamStatistic;
+
+/* Number of living pool buffers, shared with the buffer weak references as they may outlive the stream */
+
+typedef struct {
+	gint ref_count;
+	gint size;
+} ArvStreamPoolCounter;
+
 typedef struct {
 	GAsyncQueue *input_queue;
 	GAsyncQueue *output_queue;
+	/* Alternative lock-free queues, for a single consumer */
+	ArvBufferQueue *lock_free_input_queue;
+	ArvBufferQueue *lock_free_output_queue;
+	gint use_lock_free_queues;
+	/* Only keep the latest buffer in the output queue */
+	gint mailbox;
+	guint64 n_mailbox_drops;
+	/* Output buffers older than max_age_us are recycled to the input queue */
+	guint max_age_us;
+	guint n_expired_buffers;
+	/* CRC32C of the received data computed by the stream thread */
+	gint checksum;
+	/* Busy polling of the output queue before the blocking pops, and its outcome */
+	guint pop_spin_time_us;
+	guint n_pop_spin_hits;
+	guint n_pop_spin_misses;
+	/* Between two acquisitions, see arv_stream_pause() */
+	gint paused;
+	gint n_pauses;
+	/* Signalled while the output queue is not empty, created by arv_stream_get_output_fd() */
+	ArvWakeup *output_wakeup;
+
+	/* Stream allocated buffers */
+	gint use_buffer_pool;
+	GMutex pool_mutex;
+	ArvStreamPoolCounter *pool_counter;
+	guint pool_min_size;
+	guint pool_max_size;
+	guint pool_high_water_mark;
+	size_t pool_payload_size;
+	/* Allocation size of the new pool buffers, which only grows */
+	size_t pool_capacity;
+	gint64 pool_idle_since_us;
+	ArvBufferAllocator *pool_allocator;
+
+	/* Share of the process wide memory budget */
+	ArvBufferBudgetClient *budget_client;
+
 	GRecMutex mutex;
 	gboolean emit_signals;
 
@@ -61,6 +161,58 @@ typedef struct {
 	ArvStreamCallback callback;
 	void *callback_data;
 
+	int cpu_affinity;
+	int numa_node;
+	gint placement_changed;
+
+	guint region_ready_size;
+
+	/* Optional processing stage before the output queue, protected by tile_mutex while being replaced */
+	GMutex tile_mutex;
+	ArvTilePipeline *tile_pipeline;
+	guint64 n_tile_drops;
+
+	/* Optional worker thread after the tile processing stage, protected by processing_mutex while being replaced */
+	GMutex processing_mutex;
+	ArvProcessingStage *processing_stage;
+	guint64 n_processing_drops;
+	/* Queue depth after each push and stall time of the pushing thread */
+	ArvStatistic *processing_depth_statistic;
+	ArvStatistic *processing_stall_statistic;
+
+	/* Chunk features decoded into the completed buffers by the stream thread, protected by chunk_plan_mutex */
+	GMutex chunk_plan_mutex;
+	ArvChunkPlan *chunk_plan;
+	guint64 n_chunk_plan_failures;
+
+	/* Payload copy of the stream thread, protected by copy_mutex */
+	GMutex copy_mutex;
+	ArvStreamCopyKernel copy_kernel;
+	ArvStreamCopyFunc copy_func;
+	void *copy_data;
+	GDestroyNotify copy_destroy;
+
+	GPtrArray *infos;
+	GPtrArray *statistics;
+
+	/* Output queue dwell time, filled by the consumer threads */
+	ArvStatistic *dwell_statistic;
+
+	/* Intervals between the successfully received frames, filled by the stream thread */
+	ArvFrameTiming *frame_timing;
+	double expected_frame_period_us;
+	double frame_gap_ratio;
+
+	/* Binary record of the stream thread events, saved to event_ring_filename, protected by mutex, once
+	 * event_ring_failures frames failed */
+	ArvEventRing *event_ring;
+	char *event_ring_filename;
+	gint event_ring_failures;
+	gint n_event_ring_failures;
+
+	/* Per frame metadata records, appended by the stream thread. Only set once, and freed at finalization. */
+	ArvFrameLog *frame_log;
+
 	GError *init_error;
 } ArvStreamPrivate;
 
@@ -70,6 +222,99 @@ G_DEFINE_ABSTRACT_TYPE_WITH_CODE (ArvStream, arv_stream, G_TYPE_OBJECT,
 				  G_ADD_PRIVATE (ArvStream)
 				  G_IMPLEMENT_INTERFACE (G_TYPE_INITABLE, arv_stream_initable_iface_init))
 
+/* Clears the output file descriptor readiness once the output queue is empty. A buffer pushed before the length check
+ * signals the wakeup again, a buffer pushed after it signals the acknowledged wakeup. */
+
+static void
+_acknowledge_output_wakeup (ArvStreamPrivate *priv)
+{
+	ArvWakeup *wakeup = g_atomic_pointer_get (&priv->output_wakeup);
+
+	if (wakeup == NULL)
+		return;
+
+	arv_wakeup_acknowledge (wakeup);
+
+	if (g_async_queue_length (priv->output_queue) > 0 ||
+	    arv_buffer_queue_length (priv->lock_free_output_queue) > 0)
+		arv_wakeup_signal (wakeup);
+}
+
+/* The buffers are owned by the stream, for the memory budget, from their push or their allocation by the pool until
+ * their pop from the output queue */
+
+static void
+_budget_take (ArvStreamPrivate *priv, ArvBuffer *buffer)
+{
+	if (buffer->priv->is_budgeted)
+		return;
+
+	buffer->priv->is_budgeted = TRUE;
+	arv_buffer_budget_acquire (priv->budget_client, buffer->priv->capacity);
+}
+
+static void
+_budget_give (ArvStreamPrivate *priv, ArvBuffer *buffer)
+{
+	if (!buffer->priv->is_budgeted)
+		return;
+
+	buffer->priv->is_budgeted = FALSE;
+	arv_buffer_budget_release (priv->budget_client, buffer->priv->capacity);
+}
+
+static ArvBuffer *
+_output_buffer_popped (ArvStream *stream, ArvBuffer *buffer)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+
+	if (buffer != NULL) {
+		gint64 time_us = g_get_monotonic_time ();
+
+		_budget_give (priv, buffer);
+		_acknowledge_output_wakeup (priv);
+
+		ARV_TRACE_BUFFER_POPPED (buffer->priv->frame_id, time_us);
+
+		arv_statistic_fill (priv->dwell_statistic, 0, time_us - buffer->priv->output_time_us,
+				    buffer->priv->frame_id);
+	}
+
+	return buffer;
+}
+
+/* Returns TRUE if the output @buffer is older than #ArvStream:max-age at @time_us, in which case it is pushed back to
+ * the input queue */
+
+static gboolean
+_recycle_expired_buffer (ArvStreamPrivate *priv, ArvBuffer *buffer, gint64 time_us)
+{
+	guint max_age_us;
+
+	max_age_us = g_atomic_int_get (&priv->max_age_us);
+	if (max_age_us == 0 || time_us - buffer->priv->output_time_us <= (gint64) max_age_us)
+		return FALSE;
+
+	if (g_atomic_int_get (&priv->use_lock_free_queues))
+		arv_buffer_queue_push (priv->lock_free_input_queue, buffer);
+	else
+		g_async_queue_push (priv->input_queue, buffer);
+
+	g_atomic_int_inc ((gint *) &priv->n_expired_buffers);
+
+	return TRUE;
+}
+
+/* Part of @timeout, started at @start_us, left at @time_us */
+
+static guint64
+_remaining_timeout (gint64 start_us, guint64 timeout, gint64 time_us)
+{
+	guint64 elapsed = time_us > start_us ? time_us - start_us : 0;
+
+	return timeout > elapsed ? timeout - elapsed : 0;
+}
+
 /**
  * arv_stream_push_buffer:
  * @stream: a #ArvStream
@@ -91,7 +336,12 @@ arv_stream_push_buffer (ArvStream *stream, ArvBuffer *buffer)
 	g_return_if_fail (ARV_IS_STREAM (stream));
 	g_return_if_fail (ARV_IS_BUFFER (buffer));
 
-	g_async_queue_push (priv->input_queue, buffer);
+	_budget_take (priv, buffer);
+
+	if (g_atomic_int_get (&priv->use_lock_free_queues))
+		arv_buffer_queue_push (priv->lock_free_input_queue, buffer);
+	else
+		g_async_queue_push (priv->input_queue, buffer);
 }
 
 /**
@@ -109,14 +359,62 @@ arv_stream_push_buffer (ArvStream *stream, ArvBuffer *buffer)
  * Since: 0.2.0
  */
 
+/* Polls the output queue during #ArvStream:pop-spin-time, bounded by @timeout, in order to avoid the wakeup latency
+ * of the blocking pops. @timeout is decremented by the spin time on a miss. */
+
+static ArvBuffer *
+_spin_pop (ArvStreamPrivate *priv, guint64 *timeout)
+{
+	ArvBuffer *buffer;
+	gboolean use_lock_free_queues;
+	guint spin_time_us;
+	gint64 start;
+	gint64 now;
+
+	spin_time_us = g_atomic_int_get (&priv->pop_spin_time_us);
+	if (spin_time_us == 0 || *timeout == 0)
+		return NULL;
+
+	use_lock_free_queues = g_atomic_int_get (&priv->use_lock_free_queues);
+	start = g_get_monotonic_time ();
+
+	do {
+		buffer = use_lock_free_queues ?
+			arv_buffer_queue_try_pop (priv->lock_free_output_queue) :
+			g_async_queue_try_pop (priv->output_queue);
+		if (buffer != NULL) {
+			g_atomic_int_inc ((gint *) &priv->n_pop_spin_hits);
+			return buffer;
+		}
+
+		now = g_get_monotonic_time ();
+	} while (now - start < MIN (spin_time_us, *timeout));
+
+	g_atomic_int_inc ((gint *) &priv->n_pop_spin_misses);
+
+	*timeout = *timeout > (guint64) (now - start) ? *timeout - (now - start) : 0;
+
+	return NULL;
+}
+
 ArvBuffer *
 arv_stream_pop_buffer (ArvStream *stream)
 {
 	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+	guint64 timeout = G_MAXUINT64;
+	ArvBuffer *buffer;
 
 	g_return_val_if_fail (ARV_IS_STREAM (stream), NULL);
 
-	return g_async_queue_pop (priv->output_queue);
+	do {
+		buffer = _spin_pop (priv, &timeout);
+		if (buffer == NULL)
+			buffer = g_atomic_int_get (&priv->use_lock_free_queues) ?
+				arv_buffer_queue_pop (priv->lock_free_output_queue) :
+				g_async_queue_pop (priv->output_queue);
+	} while (_recycle_expired_buffer (priv, buffer, g_get_monotonic_time ()));
+
+	return _output_buffer_popped (stream, buffer);
 }
 
 /**
@@ -138,10 +436,17 @@ ArvBuffer *
 arv_stream_try_pop_buffer (ArvStream *stream)
 {
 	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+	ArvBuffer *buffer;
 
 	g_return_val_if_fail (ARV_IS_STREAM (stream), NULL);
 
-	return g_async_queue_try_pop (priv->output_queue);
+	do {
+		buffer = g_atomic_int_get (&priv->use_lock_free_queues) ?
+			arv_buffer_queue_try_pop (priv->lock_free_output_queue) :
+			g_async_queue_try_pop (priv->output_queue);
+	} while (buffer != NULL && _recycle_expired_buffer (priv, buffer, g_get_monotonic_time ()));
+
+	return _output_buffer_popped (stream, buffer);
 }
 
 /**
@@ -163,175 +468,1222 @@ ArvBuffer *
 arv_stream_timeout_pop_buffer (ArvStream *stream, guint64 timeout)
 {
 	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+	ArvBuffer *buffer;
+	guint64 remaining;
+	gint64 start_us;
+	gint64 time_us;
 
 	g_return_val_if_fail (ARV_IS_STREAM (stream), NULL);
 
-	return g_async_queue_timeout_pop (priv->output_queue, timeout);
+	start_us = g_get_monotonic_time ();
+	remaining = timeout;
+
+	for (;;) {
+		buffer = _spin_pop (priv, &remaining);
+		if (buffer == NULL)
+			buffer = g_atomic_int_get (&priv->use_lock_free_queues) ?
+				arv_buffer_queue_timeout_pop (priv->lock_free_output_queue, remaining) :
+				g_async_queue_timeout_pop (priv->output_queue, remaining);
+		if (buffer == NULL)
+			return NULL;
+
+		time_us = g_get_monotonic_time ();
+		if (!_recycle_expired_buffer (priv, buffer, time_us))
+			return _output_buffer_popped (stream, buffer);
+
+		remaining = _remaining_timeout (start_us, timeout, time_us);
+	}
 }
 
 /**
- * arv_stream_pop_input_buffer: (skip)
- * @stream: (transfer full): a #ArvStream
+ * arv_stream_push_buffers:
+ * @stream: a #ArvStream
+ * @buffers: (array length=n_buffers) (transfer full): buffers to push
+ * @n_buffers: number of buffers in @buffers
  *
- * Pops a buffer from the input queue of @stream.
+ * Pushes several #ArvBuffer to the @stream thread at once, see arv_stream_push_buffer().
  *
- * Since: 0.2.0
+ * This method is thread safe.
+ *
+ * Since: 0.8.11
  */
 
-ArvBuffer *
-arv_stream_pop_input_buffer (ArvStream *stream)
-{
-	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
-
-	g_return_val_if_fail (ARV_IS_STREAM (stream), NULL);
-
-	return g_async_queue_try_pop (priv->input_queue);
-}
-
 void
-arv_stream_push_output_buffer (ArvStream *stream, ArvBuffer *buffer)
+arv_stream_push_buffers (ArvStream *stream, ArvBuffer **buffers, guint n_buffers)
 {
 	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+	guint i;
 
 	g_return_if_fail (ARV_IS_STREAM (stream));
-	g_return_if_fail (ARV_IS_BUFFER (buffer));
+	g_return_if_fail (buffers != NULL || n_buffers == 0);
 
-	g_async_queue_push (priv->output_queue, buffer);
+	for (i = 0; i < n_buffers; i++)
+		g_return_if_fail (ARV_IS_BUFFER (buffers[i]));
 
-	g_rec_mutex_lock (&priv->mutex);
+	for (i = 0; i < n_buffers; i++)
+		_budget_take (priv, buffers[i]);
 
-	if (priv->emit_signals)
-		g_signal_emit (stream, arv_stream_signals[ARV_STREAM_SIGNAL_NEW_BUFFER], 0);
+	if (g_atomic_int_get (&priv->use_lock_free_queues)) {
+		for (i = 0; i < n_buffers; i++)
+			arv_buffer_queue_push (priv->lock_free_input_queue, buffers[i]);
+		return;
+	}
 
-	g_rec_mutex_unlock (&priv->mutex);
+	g_async_queue_lock (priv->input_queue);
+	for (i = 0; i < n_buffers; i++)
+		g_async_queue_push_unlocked (priv->input_queue, buffers[i]);
+	g_async_queue_unlock (priv->input_queue);
 }
 
 /**
- * arv_stream_get_n_buffers:
+ * arv_stream_pop_buffers:
  * @stream: a #ArvStream
- * @n_input_buffers: (out) (allow-none): input queue length
- * @n_output_buffers: (out) (allow-none): output queue length
+ * @buffers: (array length=max_n_buffers) (out caller-allocates) (transfer full): placeholder for the buffers
+ * @max_n_buffers: size of the @buffers array
+ * @timeout: timeout, in µs
  *
- * An accessor to the stream buffer queue lengths.
+ * Pops buffers from the output queue of @stream, waiting no more than @timeout for the first one, then taking all
+ * the available buffers, up to @max_n_buffers, with a single synchronization. The retrieved buffers may contain an
+ * invalid image. Caller should check the buffer status before using them.
  *
- * Since: 0.2.0
+ * This method is thread safe.
+ *
+ * Returns: the number of buffers stored in @buffers, 0 if no buffer is available until the timeout occurs.
+ *
+ * Since: 0.8.11
  */
 
-void
-arv_stream_get_n_buffers (ArvStream *stream, gint *n_input_buffers, gint *n_output_buffers)
+guint
+arv_stream_pop_buffers (ArvStream *stream, ArvBuffer **buffers, guint max_n_buffers, guint64 timeout)
 {
 	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+	guint64 remaining;
+	gint64 start_us;
+	gint64 time_us;
+	guint n_buffers;
+	guint n_fresh_buffers;
+	guint i;
 
-	if (!ARV_IS_STREAM (stream)) {
-		if (n_input_buffers != NULL)
-			*n_input_buffers = 0;
-		if (n_output_buffers != NULL)
-			*n_output_buffers = 0;
+	g_return_val_if_fail (ARV_IS_STREAM (stream), 0);
+	g_return_val_if_fail (buffers != NULL || max_n_buffers == 0, 0);
+
+	if (max_n_buffers == 0)
+		return 0;
+
+	start_us = g_get_monotonic_time ();
+	remaining = timeout;
+
+	do {
+		n_buffers = 0;
+		buffers[0] = _spin_pop (priv, &remaining);
+
+		if (g_atomic_int_get (&priv->use_lock_free_queues)) {
+			if (buffers[0] == NULL)
+				buffers[0] = arv_buffer_queue_timeout_pop (priv->lock_free_output_queue, remaining);
+			if (buffers[0] != NULL) {
+				for (n_buffers = 1; n_buffers < max_n_buffers; n_buffers++) {
+					buffers[n_buffers] = arv_buffer_queue_try_pop (priv->lock_free_output_queue);
+					if (buffers[n_buffers] == NULL)
+						break;
+				}
+			}
+		} else {
+			g_async_queue_lock (priv->output_queue);
+
+			if (buffers[0] == NULL)
+				buffers[0] = g_async_queue_timeout_pop_unlocked (priv->output_queue, remaining);
+			if (buffers[0] != NULL) {
+				for (n_buffers = 1; n_buffers < max_n_buffers; n_buffers++) {
+					buffers[n_buffers] = g_async_queue_try_pop_unlocked (priv->output_queue);
+					if (buffers[n_buffers] == NULL)
+						break;
+				}
+			}
+
+			g_async_queue_unlock (priv->output_queue);
+		}
+
+		if (n_buffers == 0)
+			return 0;
+
+		/* Keeps the order of the buffers younger than the maximum age */
+		time_us = g_get_monotonic_time ();
+		for (i = 0, n_fresh_buffers = 0; i < n_buffers; i++)
+			if (!_recycle_expired_buffer (priv, buffers[i], time_us))
+				buffers[n_fresh_buffers++] = buffers[i];
+
+		remaining = _remaining_timeout (start_us, timeout, time_us);
+	} while (n_fresh_buffers == 0);
+
+	for (i = 0; i < n_fresh_buffers; i++)
+		_output_buffer_popped (stream, buffers[i]);
+
+	return n_fresh_buffers;
+}
+
+static void
+_pool_counter_unref (ArvStreamPoolCounter *counter)
+{
+	if (g_atomic_int_dec_and_test (&counter->ref_count))
+		g_free (counter);
+}
+
+static void
+_pool_buffer_finalized (gpointer data, GObject *buffer)
+{
+	ArvStreamPoolCounter *counter = data;
+
+	g_atomic_int_add (&counter->size, -1);
+	_pool_counter_unref (counter);
+}
+
+/* Called with pool_mutex locked */
+
+static ArvBuffer *
+_pool_new_buffer (ArvStream *stream)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+	ArvBuffer *buffer;
+
+	buffer = priv->pool_allocator != NULL ?
+		arv_buffer_new_from_allocator (priv->pool_allocator, priv->pool_capacity) : NULL;
+	if (buffer == NULL)
+		buffer = arv_buffer_new_allocate_numa (priv->pool_capacity, priv->numa_node);
+	arv_buffer_set_size (buffer, priv->pool_payload_size);
+	buffer->priv->is_pool_buffer = TRUE;
+	_budget_take (priv, buffer);
+
+	g_atomic_int_inc (&priv->pool_counter->ref_count);
+	g_atomic_int_inc (&priv->pool_counter->size);
+	g_object_weak_ref (G_OBJECT (buffer), _pool_buffer_finalized, priv->pool_counter);
+
+	return buffer;
+}
+
+/* Reads the current payload size, from the main thread, and fills the input queue up to the pool minimum size */
+
+static void
+_pool_update (ArvStream *stream)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+	GError *error = NULL;
+	gint64 payload_size;
+
+	if (!g_atomic_int_get (&priv->use_buffer_pool) || priv->device == NULL)
+		return;
+
+	payload_size = arv_device_get_integer_feature_value (priv->device, "PayloadSize", &error);
+	if (error != NULL) {
+		arv_warning_stream ("[Stream::pool_update] Failed to read payload size (%s)", error->message);
+		g_clear_error (&error);
 		return;
 	}
 
-	if (n_input_buffers != NULL)
-		*n_input_buffers = g_async_queue_length (priv->input_queue);
-	if (n_output_buffers != NULL)
-		*n_output_buffers = g_async_queue_length (priv->output_queue);
+	g_mutex_lock (&priv->pool_mutex);
+
+	if (priv->pool_payload_size != (size_t) payload_size)
+		arv_info_stream ("[Stream::pool_update] Pool payload size = %" G_GINT64_FORMAT, payload_size);
+
+	priv->pool_payload_size = payload_size;
+
+	/* After a first allocation, keep a margin for the next modest increases */
+	if (priv->pool_capacity == 0)
+		priv->pool_capacity = payload_size;
+	else if (priv->pool_capacity < (size_t) payload_size)
+		priv->pool_capacity = payload_size + payload_size / ARV_STREAM_POOL_GROWTH_MARGIN_DIVISOR;
+
+	while ((guint) g_atomic_int_get (&priv->pool_counter->size) < priv->pool_min_size) {
+		if (!arv_buffer_budget_allows (priv->budget_client, priv->pool_capacity)) {
+			arv_warning_stream ("[Stream::pool_update] Pool size limited to %d by the memory budget",
+					    g_atomic_int_get (&priv->pool_counter->size));
+			break;
+		}
+		arv_stream_push_buffer (stream, _pool_new_buffer (stream));
+	}
+
+	g_mutex_unlock (&priv->pool_mutex);
 }
 
-/**
- * arv_stream_start_thread:
- * @stream: a #ArvStream
- *
- * Start the stream receiving thread. The thread is automatically started when
- * the #ArvStream object is instantiated, so this function is only useful if
- * the thread was stopped using @arv_stream_stop_thread.
- *
- * Since: 0.6.2
- */
+/* Called by the device before the execution of AcquisitionStart, the payload size may have changed since the start of
+ * the stream thread */
 
 void
-arv_stream_start_thread (ArvStream *stream)
+arv_stream_prepare_acquisition (ArvStream *stream)
 {
-	ArvStreamClass *stream_class;
-
 	g_return_if_fail (ARV_IS_STREAM (stream));
 
-	stream_class = ARV_STREAM_GET_CLASS (stream);
-	g_return_if_fail (stream_class->start_thread != NULL);
-
-	stream_class->start_thread (stream);
+	_pool_update (stream);
 }
 
-/**
- * arv_stream_stop_thread:
- * @stream: a #ArvStream
- * @delete_buffers: enable buffer deletion
- *
- * Stop the stream receiving thread, and optionally delete all the #ArvBuffer
- * stored in the stream object queues. Main use of this function is to be able
- * to quickly change an acquisition parameter that changes the payload size,
- * without deleting/recreating the stream object.
- *
- * Returns: the number of deleted buffers if @delete_buffers == %TRUE, 0 otherwise.
- *
- * Since: 0.6.2
- */
+/* Applies the memory budget policy, from the stream thread, when the pool can not grow without exceeding the share of
+ * the stream */
 
-unsigned int
-arv_stream_stop_thread (ArvStream *stream, gboolean delete_buffers)
+static ArvBuffer *
+_budget_apply_policy (ArvStream *stream)
 {
 	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
-	ArvStreamClass *stream_class;
-	ArvBuffer *buffer;
-	unsigned int n_deleted = 0;
-
-	g_return_val_if_fail (ARV_IS_STREAM (stream), 0);
+	ArvBuffer *buffer = NULL;
+	gboolean use_lock_free_queues = g_atomic_int_get (&priv->use_lock_free_queues);
+
+	switch (arv_buffer_budget_get_policy ()) {
+		case ARV_STREAM_BUDGET_POLICY_RECYCLE_OLDEST:
+			/* The lock-free output queue has a single consumer, the application */
+			if (!use_lock_free_queues)
+				buffer = g_async_queue_try_pop (priv->output_queue);
+			if (buffer != NULL) {
+				_acknowledge_output_wakeup (priv);
+				arv_buffer_budget_count (priv->budget_client, ARV_BUFFER_BUDGET_EVENT_RECYCLE);
+			}
+			break;
+		case ARV_STREAM_BUDGET_POLICY_BLOCK:
+			arv_buffer_budget_count (priv->budget_client, ARV_BUFFER_BUDGET_EVENT_BLOCK);
+			buffer = use_lock_free_queues ?
+				arv_buffer_queue_timeout_pop (priv->lock_free_input_queue,
+							      ARV_BUFFER_BUDGET_BLOCK_TIMEOUT_US) :
+				g_async_queue_timeout_pop (priv->input_queue, ARV_BUFFER_BUDGET_BLOCK_TIMEOUT_US);
+			break;
+		case ARV_STREAM_BUDGET_POLICY_DROP:
+		default:
+			break;
+	}
 
-	stream_class = ARV_STREAM_GET_CLASS (stream);
-	g_return_val_if_fail (stream_class->stop_thread != NULL, 0);
+	if (buffer == NULL)
+		arv_buffer_budget_count (priv->budget_client, ARV_BUFFER_BUDGET_EVENT_DROP);
 
-	stream_class->stop_thread (stream);
+	return buffer;
+}
 
-	if (!delete_buffers)
-		return 0;
+/* Called from the stream thread for each input buffer pop. The pool grows instead of an underrun, within the memory
+ * budget, resizes the buffers of an outdated payload size, replacing them only if they are too small, and shrinks
+ * when buffers stay unused. */
 
-	g_async_queue_lock (priv->input_queue);
-	do {
-		buffer = g_async_queue_try_pop_unlocked (priv->input_queue);
-		if (buffer != NULL) {
+static ArvBuffer *
+_pool_check_input_buffer (ArvStream *stream, ArvBuffer *buffer)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+	gboolean over_budget = FALSE;
+	gint n_input_buffers;
+	guint pool_size;
+
+	g_mutex_lock (&priv->pool_mutex);
+
+	if (buffer != NULL &&
+	    buffer->priv->is_pool_buffer &&
+	    buffer->priv->size != priv->pool_payload_size) {
+		if (buffer->priv->capacity >= priv->pool_payload_size)
+			arv_buffer_set_size (buffer, priv->pool_payload_size);
+		else {
+			_budget_give (priv, buffer);
 			g_object_unref (buffer);
-			n_deleted++;
+			buffer = NULL;
 		}
-	} while (buffer != NULL);
-	g_async_queue_unlock (priv->input_queue);
+	}
 
-	g_async_queue_lock (priv->output_queue);
-	do {
-		buffer = g_async_queue_try_pop_unlocked (priv->output_queue);
-		if (buffer != NULL) {
-			g_object_unref (buffer);
-			n_deleted++;
+	pool_size = g_atomic_int_get (&priv->pool_counter->size);
+
+	if (buffer == NULL && pool_size < priv->pool_max_size) {
+		if (arv_buffer_budget_allows (priv->budget_client, priv->pool_capacity)) {
+			buffer = _pool_new_buffer (stream);
+			pool_size++;
+			arv_info_stream_thread ("[Stream::pool_check] Pool size increased to %u", pool_size);
+		} else
+			over_budget = TRUE;
+	}
+
+	arv_stream_get_n_buffers (stream, &n_input_buffers, NULL);
+
+	if (pool_size > (guint) n_input_buffers &&
+	    pool_size - n_input_buffers > priv->pool_high_water_mark)
+		priv->pool_high_water_mark = pool_size - n_input_buffers;
+
+	if (n_input_buffers < ARV_STREAM_POOL_IDLE_BUFFERS || pool_size <= priv->pool_min_size)
+		priv->pool_idle_since_us = 0;
+	else {
+		gint64 time_us = g_get_monotonic_time ();
+
+		if (priv->pool_idle_since_us == 0)
+			priv->pool_idle_since_us = time_us;
+		else if (time_us - priv->pool_idle_since_us > ARV_STREAM_POOL_IDLE_US) {
+			ArvBuffer *idle_buffer;
+
+			idle_buffer = g_atomic_int_get (&priv->use_lock_free_queues) ?
+				arv_buffer_queue_try_pop (priv->lock_free_input_queue) :
+				g_async_queue_try_pop (priv->input_queue);
+			if (idle_buffer != NULL) {
+				if (idle_buffer->priv->is_pool_buffer) {
+					_budget_give (priv, idle_buffer);
+					g_object_unref (idle_buffer);
+					arv_info_stream_thread ("[Stream::pool_check] Pool size decreased to %u",
+								pool_size - 1);
+				} else
+					arv_stream_push_buffer (stream, idle_buffer);
+			}
+
+			priv->pool_idle_since_us = time_us;
 		}
-	} while (buffer != NULL);
-	g_async_queue_unlock (priv->output_queue);
+	}
 
-	arv_info_stream ("[Stream::reset] Deleted %u buffers\n", n_deleted);
+	g_mutex_unlock (&priv->pool_mutex);
 
-	return n_deleted;
+	if (over_budget)
+		return _budget_apply_policy (stream);
+
+	return buffer;
 }
 
 /**
- * arv_stream_get_statistics:
+ * arv_stream_pop_input_buffer:
  * @stream: a #ArvStream
- * @n_completed_buffers: (out) (allow-none): number of complete received buffers
- * @n_failures: (out) (allow-none): number of reception failures
- * @n_underruns: (out) (allow-none): number of input buffer underruns
  *
- * An accessor to the stream statistics.
+ * Pops a buffer from the input queue of @stream, from the receive thread of a stream backend. The buffer pool and
+ * the memory budget, if enabled, are applied to the returned buffer.
+ *
+ * Returns: (transfer full) (nullable): the buffer to fill, or %NULL if the input queue is empty, which the backend
+ * should account as an underrun.
  *
  * Since: 0.2.0
  */
 
-void
-arv_stream_get_statistics (ArvStream *stream,
+ArvBuffer *
+arv_stream_pop_input_buffer (ArvStream *stream)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+	ArvBuffer *buffer;
+
+	g_return_val_if_fail (ARV_IS_STREAM (stream), NULL);
+
+	if (g_atomic_int_get (&priv->use_lock_free_queues))
+		buffer = arv_buffer_queue_try_pop (priv->lock_free_input_queue);
+	else
+		buffer = g_async_queue_try_pop (priv->input_queue);
+
+	if (buffer != NULL)
+		arv_buffer_budget_set_rate (priv->budget_client, buffer->priv->size,
+					    priv->frame_timing->trackers[ARV_FRAME_INTERVAL_SOURCE_HOST].mean_us);
+
+	if (g_atomic_int_get (&priv->use_buffer_pool))
+		return _pool_check_input_buffer (stream, buffer);
+
+	return buffer;
+}
+
+static void
+_push_output_buffer (void *data, ArvBuffer *buffer)
+{
+	ArvStream *stream = data;
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+
+	buffer->priv->output_time_us = g_get_monotonic_time ();
+
+	ARV_TRACE_BUFFER_PUSHED (buffer->priv->frame_id, buffer->priv->output_time_us);
+
+	if (g_atomic_int_get (&priv->use_lock_free_queues))
+		arv_buffer_queue_push (priv->lock_free_output_queue, buffer);
+	else if (g_atomic_int_get (&priv->mailbox)) {
+		ArvBuffer *old_buffer;
+
+		/* Recycle the buffers the application didn't pop yet */
+		g_async_queue_lock (priv->output_queue);
+		while ((old_buffer = g_async_queue_try_pop_unlocked (priv->output_queue)) != NULL) {
+			g_async_queue_push (priv->input_queue, old_buffer);
+			priv->n_mailbox_drops++;
+		}
+		g_async_queue_push_unlocked (priv->output_queue, buffer);
+		g_async_queue_unlock (priv->output_queue);
+	} else if (g_atomic_int_get (&priv->max_age_us) > 0) {
+		ArvBuffer *old_buffer;
+
+		/* Recycle the expired buffers at the head of the queue, the younger ones follow them */
+		g_async_queue_lock (priv->output_queue);
+		while ((old_buffer = g_async_queue_try_pop_unlocked (priv->output_queue)) != NULL) {
+			if (!_recycle_expired_buffer (priv, old_buffer, buffer->priv->output_time_us)) {
+				g_async_queue_push_front_unlocked (priv->output_queue, old_buffer);
+				break;
+			}
+		}
+		g_async_queue_push_unlocked (priv->output_queue, buffer);
+		g_async_queue_unlock (priv->output_queue);
+	} else
+		g_async_queue_push (priv->output_queue, buffer);
+
+	if (g_atomic_pointer_get (&priv->output_wakeup) != NULL)
+		arv_wakeup_signal (priv->output_wakeup);
+
+	g_rec_mutex_lock (&priv->mutex);
+
+	if (priv->emit_signals)
+		g_signal_emit (stream, arv_stream_signals[ARV_STREAM_SIGNAL_NEW_BUFFER], 0);
+
+	g_rec_mutex_unlock (&priv->mutex);
+}
+
+/* Delivery of the stream thread and of the tile processing stage */
+
+static void
+_push_processing_stage (void *data, ArvBuffer *buffer)
+{
+	ArvStream *stream = data;
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+	gboolean is_queued = FALSE;
+
+	g_mutex_lock (&priv->processing_mutex);
+	if (priv->processing_stage != NULL) {
+		gint64 stall_time_us;
+		guint depth;
+
+		if (!arv_processing_stage_push (priv->processing_stage, buffer, &depth, &stall_time_us))
+			priv->n_processing_drops++;
+
+		arv_statistic_fill (priv->processing_depth_statistic, 0, depth, buffer->priv->frame_id);
+		arv_statistic_fill (priv->processing_stall_statistic, 0, stall_time_us, buffer->priv->frame_id);
+
+		is_queued = TRUE;
+	}
+	g_mutex_unlock (&priv->processing_mutex);
+
+	if (!is_queued)
+		_push_output_buffer (stream, buffer);
+}
+
+static void
+_return_input_buffer (void *data, ArvBuffer *buffer)
+{
+	arv_stream_push_buffer (data, buffer);
+}
+
+/* Called from the stream threads, for the failed frames */
+
+static void
+_event_ring_failure (ArvStream *stream)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+	GError *error = NULL;
+	char *filename;
+	gint threshold;
+
+	threshold = g_atomic_int_get (&priv->event_ring_failures);
+	if (threshold <= 0 ||
+	    g_atomic_int_add (&priv->n_event_ring_failures, 1) + 1 != threshold)
+		return;
+
+	g_rec_mutex_lock (&priv->mutex);
+	filename = g_strdup (priv->event_ring_filename);
+	g_rec_mutex_unlock (&priv->mutex);
+
+	if (filename == NULL)
+		return;
+
+	if (arv_event_ring_save (priv->event_ring, filename, &error))
+		arv_info_stream ("[Stream::event_ring_failure] %d failed frames, event ring saved to '%s'",
+				 threshold, filename);
+	else {
+		arv_warning_stream ("[Stream::event_ring_failure] Failed to save event ring: %s", error->message);
+		g_clear_error (&error);
+	}
+
+	g_free (filename);
+}
+
+/* Decodes the chunk features of the stream plan while the buffer data is still hot in the stream thread cache */
+
+static void
+_apply_chunk_plan (ArvStream *stream, ArvBuffer *buffer)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+	ArvChunkValue *values;
+
+	buffer->priv->n_chunk_values = 0;
+
+	if (G_LIKELY (priv->chunk_plan == NULL) ||
+	    buffer->priv->status != ARV_BUFFER_STATUS_SUCCESS ||
+	    !arv_buffer_has_chunks (buffer))
+		return;
+
+	g_mutex_lock (&priv->chunk_plan_mutex);
+	if (priv->chunk_plan != NULL) {
+		values = arv_buffer_set_n_chunk_values (buffer, arv_chunk_plan_get_n_chunks (priv->chunk_plan));
+		if (!arv_chunk_plan_apply (priv->chunk_plan, buffer, values, NULL))
+			priv->n_chunk_plan_failures++;
+	}
+	g_mutex_unlock (&priv->chunk_plan_mutex);
+}
+
+/**
+ * arv_stream_push_output_buffer:
+ * @stream: a #ArvStream
+ * @buffer: (transfer full): a buffer popped by arv_stream_pop_input_buffer()
+ *
+ * Delivers a filled buffer, from the receive thread of a stream backend. Its status must be set, using
+ * arv_buffer_set_status(). The chunk plan, the tile processing and the processing stage are applied, and the
+ * buffer is queued to the output queue of @stream. If no system or host timestamp was set by the backend, the
+ * current real time and monotonic time are used. See arv_buffer_start_fill() for the buffer properties to set.
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_stream_push_output_buffer (ArvStream *stream, ArvBuffer *buffer)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+	gboolean is_queued = FALSE;
+
+	g_return_if_fail (ARV_IS_STREAM (stream));
+	g_return_if_fail (ARV_IS_BUFFER (buffer));
+
+	if (G_UNLIKELY (buffer->priv->status != ARV_BUFFER_STATUS_SUCCESS))
+		_event_ring_failure (stream);
+
+	if (buffer->priv->system_timestamp_ns == 0)
+		buffer->priv->system_timestamp_ns = g_get_real_time () * 1000LL;
+	if (buffer->priv->host_timestamp_ns == 0)
+		buffer->priv->host_timestamp_ns = g_get_monotonic_time () * 1000LL;
+
+	_apply_chunk_plan (stream, buffer);
+
+	if (G_LIKELY (buffer->priv->status == ARV_BUFFER_STATUS_SUCCESS))
+		arv_frame_timing_add_frame (priv->frame_timing, buffer->priv->timestamp_ns,
+					    g_get_monotonic_time () * 1000LL);
+
+	g_mutex_lock (&priv->tile_mutex);
+	if (priv->tile_pipeline != NULL) {
+		is_queued = arv_tile_pipeline_push (priv->tile_pipeline, buffer);
+		if (!is_queued) {
+			/* Processing stage is full, drop the frame instead of stalling the stream thread */
+			arv_stream_push_buffer (stream, buffer);
+			priv->n_tile_drops++;
+			is_queued = TRUE;
+		}
+	}
+	g_mutex_unlock (&priv->tile_mutex);
+
+	if (!is_queued)
+		_push_processing_stage (stream, buffer);
+}
+
+/* Event ring of the stream thread, valid during the stream lifetime */
+
+ArvEventRing *
+arv_stream_get_event_ring (ArvStream *stream)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+
+	g_return_val_if_fail (ARV_IS_STREAM (stream), NULL);
+
+	return priv->event_ring;
+}
+
+/**
+ * arv_stream_dump_event_ring:
+ * @stream: a #ArvStream
+ * @filename: dump file name
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Saves the latest events of the stream thread (frame leaders, closed frames, resend requests, late, duplicated or
+ * erroneous packets...) to @filename. They are continuously recorded as fixed size binary records, with a negligible
+ * overhead, so they reflect the behaviour of the stream at full rate, unlike the stream-thread debug output. The dump
+ * can be decoded offline using the events command of arv-tool.
+ *
+ * See also #ArvStream:event-ring-filename, for an automatic dump after a number of failed frames.
+ *
+ * Returns: %TRUE on success
+ *
+ * Since: 0.8.11
+ */
+
+gboolean
+arv_stream_dump_event_ring (ArvStream *stream, const char *filename, GError **error)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+
+	g_return_val_if_fail (ARV_IS_STREAM (stream), FALSE);
+	g_return_val_if_fail (filename != NULL, FALSE);
+
+	return arv_event_ring_save (priv->event_ring, filename, error);
+}
+
+/**
+ * arv_stream_open_frame_log:
+ * @stream: a #ArvStream
+ * @filename: log file name
+ * @n_records: number of preallocated records, 0 for the default of about a million
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Starts logging the metadata of every completed frame to @filename: frame id, device and host timestamps, status,
+ * received size, missing, resent and requested packet counts. The records are fixed size, written by the stream
+ * thread into a preallocated memory mapped file, at the cost of about one cache line per frame, with no system call
+ * and no formatting. Once the @n_records records are used, the following frames are only counted.
+ *
+ * The log can only be opened once, and is closed when @stream is destroyed. It can be decoded using the frames command
+ * of arv-tool, even while it is written.
+ *
+ * Returns: %TRUE on success
+ *
+ * Since: 0.8.11
+ */
+
+gboolean
+arv_stream_open_frame_log (ArvStream *stream, const char *filename, guint n_records, GError **error)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+	ArvFrameLog *frame_log;
+
+	g_return_val_if_fail (ARV_IS_STREAM (stream), FALSE);
+	g_return_val_if_fail (filename != NULL, FALSE);
+
+	if (g_atomic_pointer_get (&priv->frame_log) != NULL) {
+		g_set_error_literal (error, G_IO_ERROR, G_IO_ERROR_EXISTS, "Frame log already opened");
+		return FALSE;
+	}
+
+	frame_log = arv_frame_log_new (filename, n_records > 0 ? n_records : ARV_FRAME_LOG_N_RECORDS_DEFAULT, error);
+	if (frame_log == NULL)
+		return FALSE;
+
+	if (!g_atomic_pointer_compare_and_exchange (&priv->frame_log, NULL, frame_log)) {
+		arv_frame_log_free (frame_log);
+		g_set_error_literal (error, G_IO_ERROR, G_IO_ERROR_EXISTS, "Frame log already opened");
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+/* Frame log of the stream thread, NULL if not opened, valid until the stream finalization */
+
+ArvFrameLog *
+arv_stream_get_frame_log (ArvStream *stream)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+
+	return g_atomic_pointer_get (&priv->frame_log);
+}
+
+/**
+ * arv_stream_get_n_buffers:
+ * @stream: a #ArvStream
+ * @n_input_buffers: (out) (allow-none): input queue length
+ * @n_output_buffers: (out) (allow-none): output queue length
+ *
+ * An accessor to the stream buffer queue lengths.
+ *
+ * Since: 0.2.0
+ */
+
+void
+arv_stream_get_n_buffers (ArvStream *stream, gint *n_input_buffers, gint *n_output_buffers)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+
+	if (!ARV_IS_STREAM (stream)) {
+		if (n_input_buffers != NULL)
+			*n_input_buffers = 0;
+		if (n_output_buffers != NULL)
+			*n_output_buffers = 0;
+		return;
+	}
+
+	if (n_input_buffers != NULL)
+		*n_input_buffers = g_async_queue_length (priv->input_queue) +
+			arv_buffer_queue_length (priv->lock_free_input_queue);
+	if (n_output_buffers != NULL)
+		*n_output_buffers = g_async_queue_length (priv->output_queue) +
+			arv_buffer_queue_length (priv->lock_free_output_queue);
+}
+
+/**
+ * arv_stream_get_n_dropped_buffers:
+ * @stream: a #ArvStream
+ *
+ * Returns: the number of output buffers recycled to the input queue before being popped by the application, because
+ * of the #ArvStream:mailbox mode.
+ *
+ * Since: 0.8.11
+ */
+
+guint64
+arv_stream_get_n_dropped_buffers (ArvStream *stream)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+	guint64 n_mailbox_drops;
+
+	g_return_val_if_fail (ARV_IS_STREAM (stream), 0);
+
+	g_async_queue_lock (priv->output_queue);
+	n_mailbox_drops = priv->n_mailbox_drops;
+	g_async_queue_unlock (priv->output_queue);
+
+	return n_mailbox_drops;
+}
+
+/**
+ * arv_stream_set_tile_processing:
+ * @stream: a #ArvStream
+ * @tile_func: (scope notified) (nullable): tile processing function, %NULL to remove the processing stage
+ * @user_data: (closure): data passed to @tile_func
+ * @destroy: (nullable): function releasing @user_data, called when the processing stage is removed
+ * @n_threads: number of worker threads, 0 for one thread per processor
+ * @tile_rows: number of image rows per tile
+ * @depth: maximum number of buffers in the processing stage
+ *
+ * Inserts a multi-threaded processing stage between the stream thread and the output queue. The image of each
+ * completed buffer is split in tiles of @tile_rows rows processed in parallel by @tile_func, for conversions, look
+ * up tables or binning. Buffers are pushed to the output queue in frame order once all their tiles are processed.
+ * Buffers without a complete image go through the stage unprocessed.
+ *
+ * When @depth buffers are already in the stage, new buffers are returned to the input queue, which bounds the
+ * latency of the stage instead of stalling the stream thread. These drops are counted in the n_tile_drops stream
+ * info.
+ *
+ * Replacing or removing the processing stage waits for the buffers being processed, which are pushed to the output
+ * queue. This function must not be called from @tile_func or from a #ArvStream::new-buffer handler.
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_stream_set_tile_processing (ArvStream *stream, ArvStreamTileFunc tile_func, void *user_data,
+				GDestroyNotify destroy, guint n_threads, guint tile_rows, guint depth)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+	ArvTilePipeline *pipeline = NULL;
+	ArvTilePipeline *old_pipeline;
+
+	g_return_if_fail (ARV_IS_STREAM (stream));
+	g_return_if_fail (tile_func == NULL || (tile_rows > 0 && depth > 0));
+
+	if (tile_func != NULL)
+		pipeline = arv_tile_pipeline_new (tile_func, user_data, destroy, n_threads, tile_rows, depth,
+						  _push_processing_stage, stream);
+
+	g_mutex_lock (&priv->tile_mutex);
+	old_pipeline = priv->tile_pipeline;
+	priv->tile_pipeline = pipeline;
+	g_mutex_unlock (&priv->tile_mutex);
+
+	arv_tile_pipeline_free (old_pipeline);
+}
+
+/**
+ * arv_stream_set_processing_stage:
+ * @stream: a #ArvStream
+ * @process_func: (scope notified) (nullable): buffer processing function, %NULL to remove the processing stage
+ * @user_data: (closure): data passed to @process_func
+ * @destroy: (nullable): function releasing @user_data, called when the processing stage is removed
+ * @depth: maximum number of buffers waiting for the processing stage
+ * @policy: what happens to a new buffer when @depth buffers are already waiting
+ *
+ * Runs @process_func on each completed buffer from a dedicated worker thread, between the stream thread and the
+ * output queue. Unlike the %ARV_STREAM_CALLBACK_TYPE_BUFFER_DONE stream callback, heavy processing doesn't delay the
+ * packet reception, and unlike an application thread popping the output queue, the processed buffers are still
+ * delivered through the output queue, in frame order. If a tile processing stage is set, it runs first.
+ *
+ * The buffers are passed to the worker through a queue of @depth buffers. When it is full, @policy either returns
+ * a buffer to the input queue, which is counted in the n_processing_drops stream info, or blocks the stream thread.
+ * The queue depth after each push and the time the stream thread was blocked are available as the
+ * processing_queue_depth and processing_stall_time_us stream statistics.
+ *
+ * Replacing or removing the processing stage waits for the pending buffers to be processed and pushed to the output
+ * queue. This function must not be called from @process_func or from a #ArvStream::new-buffer handler.
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_stream_set_processing_stage (ArvStream *stream, ArvStreamProcessFunc process_func, void *user_data,
+				 GDestroyNotify destroy, guint depth, ArvStreamOverflowPolicy policy)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+	ArvProcessingStage *stage = NULL;
+	ArvProcessingStage *old_stage;
+
+	g_return_if_fail (ARV_IS_STREAM (stream));
+	g_return_if_fail (process_func == NULL || depth > 0);
+
+	if (process_func != NULL)
+		stage = arv_processing_stage_new (process_func, user_data, destroy, depth, policy,
+						  _push_output_buffer, _return_input_buffer, stream);
+
+	g_mutex_lock (&priv->processing_mutex);
+	old_stage = priv->processing_stage;
+	priv->processing_stage = stage;
+	g_mutex_unlock (&priv->processing_mutex);
+
+	arv_processing_stage_free (old_stage);
+}
+
+/**
+ * arv_stream_set_chunk_plan:
+ * @stream: a #ArvStream
+ * @plan: (nullable): a chunk plan, %NULL to stop the chunk decoding
+ *
+ * Decodes the chunk features of @plan from each successfully received buffer in the stream thread, before the buffer
+ * is pushed to the output queue, while its data is still in the processor cache. The decoded values are attached to
+ * the buffer and are retrieved without any parsing using arv_buffer_get_chunk_values(). This is typically used for
+ * knowing the exposure time and the gain each frame was acquired with, after enabling the corresponding chunks using
+ * arv_camera_set_chunks().
+ *
+ * Buffers missing one of the chunks still get all their values, with the is_valid field of the missing ones set to
+ * %FALSE. They are counted in the n_chunk_plan_failures stream info.
+ *
+ * The chunk parser @plan was compiled from must not be used by the application while the plan is set, as its
+ * non-register chunk features are evaluated by the stream thread.
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_stream_set_chunk_plan (ArvStream *stream, ArvChunkPlan *plan)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+	ArvChunkPlan *old_plan;
+
+	g_return_if_fail (ARV_IS_STREAM (stream));
+	g_return_if_fail (plan == NULL || ARV_IS_CHUNK_PLAN (plan));
+
+	if (plan != NULL)
+		g_object_ref (plan);
+
+	g_mutex_lock (&priv->chunk_plan_mutex);
+	old_plan = priv->chunk_plan;
+	priv->chunk_plan = plan;
+	g_mutex_unlock (&priv->chunk_plan_mutex);
+
+	g_clear_object (&old_plan);
+}
+
+static void
+_non_temporal_copy (void *dst, const void *src, size_t size, void *user_data)
+{
+	arv_mem_copy_non_temporal (dst, src, size);
+}
+
+/**
+ * arv_stream_set_copy_kernel:
+ * @stream: a #ArvStream
+ * @kernel: the copy kernel
+ *
+ * Selects how the stream thread copies the received payload into the buffers. The non-temporal copy avoids evicting
+ * the working set of the application from the caches shared with the stream thread, and is worth it when the frames
+ * are not processed on these cores, like for recordings or GPU uploads. It is slower than the default when the
+ * consumer reads the frame right after its completion from a neighbour core.
+ *
+ * Selecting %ARV_STREAM_COPY_KERNEL_CUSTOM without a function set by arv_stream_set_copy_function() is ignored.
+ *
+ * The kernel is used starting from the next frame.
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_stream_set_copy_kernel (ArvStream *stream, ArvStreamCopyKernel kernel)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+
+	g_return_if_fail (ARV_IS_STREAM (stream));
+	g_return_if_fail (kernel <= ARV_STREAM_COPY_KERNEL_CUSTOM);
+
+	g_mutex_lock (&priv->copy_mutex);
+	if (kernel != ARV_STREAM_COPY_KERNEL_CUSTOM || priv->copy_func != NULL)
+		priv->copy_kernel = kernel;
+	g_mutex_unlock (&priv->copy_mutex);
+}
+
+/**
+ * arv_stream_get_copy_kernel:
+ * @stream: a #ArvStream
+ *
+ * Returns: the kernel used for copying the received payload into the buffers.
+ *
+ * Since: 0.8.11
+ */
+
+ArvStreamCopyKernel
+arv_stream_get_copy_kernel (ArvStream *stream)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+	ArvStreamCopyKernel kernel;
+
+	g_return_val_if_fail (ARV_IS_STREAM (stream), ARV_STREAM_COPY_KERNEL_DEFAULT);
+
+	g_mutex_lock (&priv->copy_mutex);
+	kernel = priv->copy_kernel;
+	g_mutex_unlock (&priv->copy_mutex);
+
+	return kernel;
+}
+
+/**
+ * arv_stream_set_copy_function:
+ * @stream: a #ArvStream
+ * @copy_func: (scope notified) (nullable): a copy function, %NULL to return to the default kernel
+ * @user_data: (closure): data passed to @copy_func
+ * @destroy: (destroy user_data) (nullable): destroy notification of @user_data
+ *
+ * Sets a function doing the copies of the received payload into the buffers, for example one writing into device
+ * memory, and selects %ARV_STREAM_COPY_KERNEL_CUSTOM. @user_data is destroyed once the function is replaced, or on
+ * the stream destruction, which means the stream thread may still use it until the next frame after this call
+ * returns, unless the thread is stopped.
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_stream_set_copy_function (ArvStream *stream, ArvStreamCopyFunc copy_func, void *user_data,
+			      GDestroyNotify destroy)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+	GDestroyNotify old_destroy;
+	void *old_data;
+
+	g_return_if_fail (ARV_IS_STREAM (stream));
+
+	g_mutex_lock (&priv->copy_mutex);
+	old_destroy = priv->copy_destroy;
+	old_data = priv->copy_data;
+	priv->copy_func = copy_func;
+	priv->copy_data = user_data;
+	priv->copy_destroy = destroy;
+	priv->copy_kernel = copy_func != NULL ? ARV_STREAM_COPY_KERNEL_CUSTOM : ARV_STREAM_COPY_KERNEL_DEFAULT;
+	g_mutex_unlock (&priv->copy_mutex);
+
+	if (old_destroy != NULL)
+		old_destroy (old_data);
+}
+
+/* Returns the copy function of the current kernel, or NULL for memcpy, which the stream threads inline for the small
+ * blocks. Called by the stream threads at the start of each frame. */
+
+ArvStreamCopyFunc
+arv_stream_get_copy_function (ArvStream *stream, void **user_data)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+	ArvStreamCopyFunc copy_func = NULL;
+
+	*user_data = NULL;
+
+	g_mutex_lock (&priv->copy_mutex);
+	switch (priv->copy_kernel) {
+		case ARV_STREAM_COPY_KERNEL_NON_TEMPORAL:
+			copy_func = _non_temporal_copy;
+			break;
+		case ARV_STREAM_COPY_KERNEL_CUSTOM:
+			copy_func = priv->copy_func;
+			*user_data = priv->copy_data;
+			break;
+		default:
+			break;
+	}
+	g_mutex_unlock (&priv->copy_mutex);
+
+	return copy_func;
+}
+
+/**
+ * arv_stream_start_thread:
+ * @stream: a #ArvStream
+ *
+ * Start the stream receiving thread. The thread is automatically started when
+ * the #ArvStream object is instantiated, so this function is only useful if
+ * the thread was stopped using @arv_stream_stop_thread.
+ *
+ * Since: 0.6.2
+ */
+
+void
+arv_stream_start_thread (ArvStream *stream)
+{
+	ArvStreamClass *stream_class;
+
+	g_return_if_fail (ARV_IS_STREAM (stream));
+
+	stream_class = ARV_STREAM_GET_CLASS (stream);
+	g_return_if_fail (stream_class->start_thread != NULL);
+
+	_pool_update (stream);
+
+	stream_class->start_thread (stream);
+}
+
+/**
+ * arv_stream_stop_thread:
+ * @stream: a #ArvStream
+ * @delete_buffers: enable buffer deletion
+ *
+ * Stop the stream receiving thread, and optionally delete all the #ArvBuffer
+ * stored in the stream object queues. Main use of this function is to be able
+ * to quickly change an acquisition parameter that changes the payload size,
+ * without deleting/recreating the stream object.
+ *
+ * Returns: the number of deleted buffers if @delete_buffers == %TRUE, 0 otherwise.
+ *
+ * Since: 0.6.2
+ */
+
+unsigned int
+arv_stream_stop_thread (ArvStream *stream, gboolean delete_buffers)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+	ArvStreamClass *stream_class;
+	ArvBuffer *buffer;
+	unsigned int n_deleted = 0;
+
+	g_return_val_if_fail (ARV_IS_STREAM (stream), 0);
+
+	stream_class = ARV_STREAM_GET_CLASS (stream);
+	g_return_val_if_fail (stream_class->stop_thread != NULL, 0);
+
+	stream_class->stop_thread (stream);
+
+	if (!delete_buffers)
+		return 0;
+
+	g_async_queue_lock (priv->input_queue);
+	do {
+		buffer = g_async_queue_try_pop_unlocked (priv->input_queue);
+		if (buffer != NULL) {
+			_budget_give (priv, buffer);
+			g_object_unref (buffer);
+			n_deleted++;
+		}
+	} while (buffer != NULL);
+	g_async_queue_unlock (priv->input_queue);
+
+	g_async_queue_lock (priv->output_queue);
+	do {
+		buffer = g_async_queue_try_pop_unlocked (priv->output_queue);
+		if (buffer != NULL) {
+			_budget_give (priv, buffer);
+			g_object_unref (buffer);
+			n_deleted++;
+		}
+	} while (buffer != NULL);
+	g_async_queue_unlock (priv->output_queue);
+
+	while ((buffer = arv_buffer_queue_try_pop (priv->lock_free_input_queue)) != NULL) {
+		_budget_give (priv, buffer);
+		g_object_unref (buffer);
+		n_deleted++;
+	}
+	while ((buffer = arv_buffer_queue_try_pop (priv->lock_free_output_queue)) != NULL) {
+		_budget_give (priv, buffer);
+		g_object_unref (buffer);
+		n_deleted++;
+	}
+
+	_acknowledge_output_wakeup (priv);
+
+	arv_info_stream ("[Stream::reset] Deleted %u buffers\n", n_deleted);
+
+	return n_deleted;
+}
+
+/**
+ * arv_stream_pause:
+ * @stream: a #ArvStream
+ *
+ * Pauses @stream between two acquisitions, keeping its socket, its thread and its buffer pool. The frames being
+ * received are given back with the %ARV_BUFFER_STATUS_ABORTED status, and the incoming data is dropped until
+ * arv_stream_resume() is called. Unlike arv_stream_stop_thread(), an acquisition restart only costs the
+ * register writes of the device.
+ *
+ * |[<!-- language="C" -->
+ * arv_camera_stop_acquisition (camera, &error);
+ * arv_stream_pause (stream);
+ * arv_camera_set_region (camera, 0, 0, 640, 480, &error);
+ * arv_stream_resume (stream);
+ * arv_camera_start_acquisition (camera, &error);
+ * ]|
+ *
+ * This method is thread safe.
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_stream_pause (ArvStream *stream)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+
+	g_return_if_fail (ARV_IS_STREAM (stream));
+
+	if (!g_atomic_int_compare_and_exchange (&priv->paused, FALSE, TRUE))
+		return;
+
+	g_atomic_int_inc (&priv->n_pauses);
+
+	arv_info_stream ("[Stream::pause] Stream paused");
+}
+
+/**
+ * arv_stream_resume:
+ * @stream: a #ArvStream
+ *
+ * Resumes a stream paused by arv_stream_pause(), before the start of the next acquisition. The payload size is read
+ * again, for the buffer pool and the transfers of the device, which allows region or pixel format changes during the
+ * pause. The frame ids of the next acquisition don't need to follow the ones of the previous acquisition.
+ *
+ * This method must not be called concurrently with arv_stream_pause().
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_stream_resume (ArvStream *stream)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+	ArvStreamClass *stream_class;
+
+	g_return_if_fail (ARV_IS_STREAM (stream));
+
+	stream_class = ARV_STREAM_GET_CLASS (stream);
+
+	if (!g_atomic_int_get (&priv->paused))
+		return;
+
+	_pool_update (stream);
+
+	/* The stream thread may be restarted, it must not wait for priv->mutex */
+	if (stream_class->resume != NULL)
+		stream_class->resume (stream);
+
+	g_atomic_int_set (&priv->paused, FALSE);
+
+	arv_info_stream ("[Stream::resume] Stream resumed");
+}
+
+/**
+ * arv_stream_is_paused:
+ * @stream: a #ArvStream
+ *
+ * Returns: %TRUE if @stream is paused by arv_stream_pause()
+ *
+ * Since: 0.8.11
+ */
+
+gboolean
+arv_stream_is_paused (ArvStream *stream)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+
+	g_return_val_if_fail (ARV_IS_STREAM (stream), FALSE);
+
+	return g_atomic_int_get (&priv->paused);
+}
+
+/**
+ * arv_stream_get_statistics:
+ * @stream: a #ArvStream
+ * @n_completed_buffers: (out) (allow-none): number of complete received buffers
+ * @n_failures: (out) (allow-none): number of reception failures
+ * @n_underruns: (out) (allow-none): number of input buffer underruns
+ *
+ * An accessor to the stream statistics.
+ *
+ * Since: 0.2.0
+ */
+
+void
+arv_stream_get_statistics (ArvStream *stream,
 			   guint64 *n_completed_buffers,
 			   guint64 *n_failures,
 			   guint64 *n_underruns)
@@ -346,15 +1698,446 @@ arv_stream_get_statistics (ArvStream *stream,
 	if (n_underruns == NULL)
 		n_underruns = &dummy;
 
-	*n_completed_buffers = 0;
-	*n_failures = 0;
-	*n_underruns = 0;
+	*n_completed_buffers = 0;
+	*n_failures = 0;
+	*n_underruns = 0;
+
+	g_return_if_fail (ARV_IS_STREAM (stream));
+
+	stream_class = ARV_STREAM_GET_CLASS (stream);
+	if (stream_class->get_statistics != NULL)
+		stream_class->get_statistics (stream, n_completed_buffers, n_failures, n_underruns);
+}
+
+static void
+_info_free (gpointer data)
+{
+	ArvStreamInfo *info = data;
+
+	g_free (info->name);
+	g_free (info);
+}
+
+/**
+ * arv_stream_declare_info:
+ * @stream: a #ArvStream
+ * @name: statistic name
+ * @type: value type, %G_TYPE_UINT, %G_TYPE_UINT64 or %G_TYPE_DOUBLE
+ * @data: pointer to the value, which must stay valid and aligned during the @stream lifetime
+ *
+ * Publishes a statistic of the backend. The statistics must be declared during the @stream construction, before
+ * the start of the stream thread. The values are only written by the stream thread, with plain stores, and are
+ * read with relaxed atomic loads, which gives a consistent value of each statistic without any synchronization
+ * cost on the reception side.
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_stream_declare_info (ArvStream *stream, const char *name, GType type, gpointer data)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+	ArvStreamInfo *info;
+
+	g_return_if_fail (ARV_IS_STREAM (stream));
+	g_return_if_fail (name != NULL);
+	g_return_if_fail (type == G_TYPE_UINT || type == G_TYPE_UINT64 || type == G_TYPE_DOUBLE);
+	g_return_if_fail (data != NULL);
+
+	info = g_new (ArvStreamInfo, 1);
+	info->name = g_strdup (name);
+	info->type = type;
+	info->data = data;
+
+	g_ptr_array_add (priv->infos, info);
+}
+
+static void
+_statistic_free (gpointer data)
+{
+	ArvStreamStatistic *statistic = data;
+
+	g_free (statistic->name);
+	g_free (statistic);
+}
+
+/**
+ * arv_stream_declare_statistic:
+ * @stream: a #ArvStream
+ * @name: histogram name
+ * @statistic: a #ArvStatistic, which must stay valid during the @stream lifetime
+ * @histogram_id: histogram index in @statistic
+ *
+ * Publishes an histogram of the backend, for the metrics exporter. Like the statistics, the histograms must be
+ * declared during the @stream construction.
+ */
+
+void
+arv_stream_declare_statistic (ArvStream *stream, const char *name, const ArvStatistic *statistic, guint histogram_id)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+	ArvStreamStatistic *stream_statistic;
+
+	g_return_if_fail (ARV_IS_STREAM (stream));
+	g_return_if_fail (name != NULL);
+	g_return_if_fail (statistic != NULL);
+
+	stream_statistic = g_new (ArvStreamStatistic, 1);
+	stream_statistic->name = g_strdup (name);
+	stream_statistic->statistic = statistic;
+	stream_statistic->histogram_id = histogram_id;
+
+	g_ptr_array_add (priv->statistics, stream_statistic);
+}
+
+guint
+arv_stream_get_n_statistics (ArvStream *stream)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+
+	g_return_val_if_fail (ARV_IS_STREAM (stream), 0);
+
+	return priv->statistics->len;
+}
+
+const ArvStatistic *
+arv_stream_get_statistic (ArvStream *stream, guint id, const char **name, guint *histogram_id)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+	ArvStreamStatistic *statistic;
+
+	g_return_val_if_fail (ARV_IS_STREAM (stream), NULL);
+	g_return_val_if_fail (id < priv->statistics->len, NULL);
+
+	statistic = g_ptr_array_index (priv->statistics, id);
+
+	if (name != NULL)
+		*name = statistic->name;
+	if (histogram_id != NULL)
+		*histogram_id = statistic->histogram_id;
+
+	return statistic->statistic;
+}
+
+/**
+ * arv_stream_get_frame_interval_statistics:
+ * @stream: a #ArvStream
+ * @source: clock of the measured intervals
+ * @statistics: (out caller-allocates): statistics placeholder
+ *
+ * Gets the statistics of the intervals between the successfully received frames, measured in the stream thread at
+ * a constant cost per frame. The device timestamps give the actual timing of the camera, for example of its
+ * trigger input, while the host completion times also include the transmission and reassembly jitter.
+ *
+ * Returns: %TRUE if at least one interval was measured after the reference period was determined.
+ *
+ * Since: 0.8.11
+ */
+
+gboolean
+arv_stream_get_frame_interval_statistics (ArvStream *stream, ArvFrameIntervalSource source,
+					  ArvFrameIntervalStatistics *statistics)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+
+	g_return_val_if_fail (ARV_IS_STREAM (stream), FALSE);
+
+	return arv_frame_timing_get_statistics (priv->frame_timing, source, statistics);
+}
+
+/**
+ * arv_stream_get_clock_drift:
+ * @stream: a #ArvStream
+ *
+ * Gets the drift of the device clock relative to the host clock, estimated from the device timestamps and the
+ * completion times of the received frames. A positive value means the device clock is slower than the host one.
+ *
+ * Returns: the clock drift, in parts per million, 0 until it can be estimated.
+ *
+ * Since: 0.8.11
+ */
+
+double
+arv_stream_get_clock_drift (ArvStream *stream)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+
+	g_return_val_if_fail (ARV_IS_STREAM (stream), 0.0);
+
+	return arv_frame_timing_get_clock_drift (priv->frame_timing);
+}
+
+/**
+ * arv_stream_reset_frame_interval_statistics:
+ * @stream: a #ArvStream
+ *
+ * Restarts the frame interval statistics and the clock drift estimation, for example after an acquisition restart,
+ * whose idle time would otherwise be counted as a gap.
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_stream_reset_frame_interval_statistics (ArvStream *stream)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+
+	g_return_if_fail (ARV_IS_STREAM (stream));
+
+	arv_frame_timing_reset (priv->frame_timing);
+}
+
+/**
+ * arv_set_stream_memory_budget:
+ * @max_bytes: maximum size of the buffers owned by all the streams of the process, 0 for no limit
+ * @policy: what happens when a stream can not grow its buffer pool
+ *
+ * Caps the total size of the buffers owned by the streams, that is the buffers pushed by the application, or
+ * allocated by the buffer pools, and not popped yet from the output queues. The cap is apportioned across the living
+ * streams in proportion of their payload throughput, the payload size times the measured frame rate, and a buffer
+ * pool can only grow while its stream stays within its share, @policy being applied instead. The buffers pushed by
+ * the application are accounted, but never refused. The per stream accounting is available through the
+ * budget_owned_bytes, budget_share_bytes, n_budget_refusals, n_budget_drops, n_budget_recycles and n_budget_blocks
+ * stream infos.
+ *
+ * This function is thread safe.
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_set_stream_memory_budget (guint64 max_bytes, ArvStreamBudgetPolicy policy)
+{
+	arv_buffer_budget_configure (max_bytes, policy);
+}
+
+/**
+ * arv_get_stream_memory_budget_statistics:
+ * @statistics: (out caller-allocates): placeholder for the statistics
+ *
+ * Retrieves the process wide statistics of the stream memory budget.
+ *
+ * This function is thread safe.
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_get_stream_memory_budget_statistics (ArvStreamBudgetStatistics *statistics)
+{
+	g_return_if_fail (statistics != NULL);
+
+	arv_buffer_budget_get_statistics (statistics);
+}
+
+/**
+ * arv_stream_get_n_infos:
+ * @stream: a #ArvStream
+ *
+ * Returns: the number of statistics published by @stream
+ *
+ * Since: 0.8.11
+ */
+
+guint
+arv_stream_get_n_infos (ArvStream *stream)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+
+	g_return_val_if_fail (ARV_IS_STREAM (stream), 0);
+
+	return priv->infos->len;
+}
+
+static ArvStreamInfo *
+_get_info (ArvStream *stream, guint id)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+
+	if (id >= priv->infos->len)
+		return NULL;
+
+	return g_ptr_array_index (priv->infos, id);
+}
+
+/**
+ * arv_stream_get_info_name:
+ * @stream: a #ArvStream
+ * @id: statistic index, lower than arv_stream_get_n_infos()
+ *
+ * Returns: the name of the statistic, %NULL if @id is out of range
+ *
+ * Since: 0.8.11
+ */
+
+const char *
+arv_stream_get_info_name (ArvStream *stream, guint id)
+{
+	ArvStreamInfo *info;
+
+	g_return_val_if_fail (ARV_IS_STREAM (stream), NULL);
+
+	info = _get_info (stream, id);
+
+	return info != NULL ? info->name : NULL;
+}
+
+/**
+ * arv_stream_get_info_type:
+ * @stream: a #ArvStream
+ * @id: statistic index, lower than arv_stream_get_n_infos()
+ *
+ * Returns: the value type of the statistic, %G_TYPE_UINT64 or %G_TYPE_DOUBLE, %G_TYPE_INVALID if @id is out of range
+ *
+ * Since: 0.8.11
+ */
+
+GType
+arv_stream_get_info_type (ArvStream *stream, guint id)
+{
+	ArvStreamInfo *info;
+
+	g_return_val_if_fail (ARV_IS_STREAM (stream), G_TYPE_INVALID);
+
+	info = _get_info (stream, id);
+	if (info == NULL)
+		return G_TYPE_INVALID;
+
+	return info->type == G_TYPE_DOUBLE ? G_TYPE_DOUBLE : G_TYPE_UINT64;
+}
+
+/**
+ * arv_stream_get_info_uint64:
+ * @stream: a #ArvStream
+ * @id: statistic index, lower than arv_stream_get_n_infos()
+ *
+ * Returns the current value of an integer statistic. This function can be called at any time from any thread.
+ *
+ * Returns: the statistic value, 0 if @id is out of range or is not an integer statistic
+ *
+ * Since: 0.8.11
+ */
+
+guint64
+arv_stream_get_info_uint64 (ArvStream *stream, guint id)
+{
+	ArvStreamInfo *info;
+
+	g_return_val_if_fail (ARV_IS_STREAM (stream), 0);
+
+	info = _get_info (stream, id);
+	g_return_val_if_fail (info != NULL, 0);
+
+	switch (info->type) {
+		case G_TYPE_UINT:
+			return __atomic_load_n ((guint *) info->data, __ATOMIC_RELAXED);
+		case G_TYPE_UINT64:
+			return __atomic_load_n ((guint64 *) info->data, __ATOMIC_RELAXED);
+		default:
+			break;
+	}
+
+	g_return_val_if_reached (0);
+}
+
+/**
+ * arv_stream_get_info_double:
+ * @stream: a #ArvStream
+ * @id: statistic index, lower than arv_stream_get_n_infos()
+ *
+ * Returns the current value of a statistic, as a floating point number. Integer statistics are converted. This
+ * function can be called at any time from any thread.
+ *
+ * Returns: the statistic value, 0.0 if @id is out of range
+ *
+ * Since: 0.8.11
+ */
+
+double
+arv_stream_get_info_double (ArvStream *stream, guint id)
+{
+	ArvStreamInfo *info;
+
+	g_return_val_if_fail (ARV_IS_STREAM (stream), 0.0);
+
+	info = _get_info (stream, id);
+	g_return_val_if_fail (info != NULL, 0.0);
+
+	if (info->type == G_TYPE_DOUBLE) {
+		double value;
+
+		__atomic_load ((double *) info->data, &value, __ATOMIC_RELAXED);
+
+		return value;
+	}
+
+	return arv_stream_get_info_uint64 (stream, id);
+}
+
+static gint
+_find_info (ArvStream *stream, const char *name)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+	guint i;
+
+	for (i = 0; i < priv->infos->len; i++) {
+		ArvStreamInfo *info = g_ptr_array_index (priv->infos, i);
+
+		if (g_strcmp0 (info->name, name) == 0)
+			return i;
+	}
+
+	return -1;
+}
+
+/**
+ * arv_stream_get_info_uint64_by_name:
+ * @stream: a #ArvStream
+ * @name: statistic name
+ *
+ * Returns: the value of the integer statistic @name, 0 if not found
+ *
+ * Since: 0.8.11
+ */
+
+guint64
+arv_stream_get_info_uint64_by_name (ArvStream *stream, const char *name)
+{
+	gint id;
+
+	g_return_val_if_fail (ARV_IS_STREAM (stream), 0);
+	g_return_val_if_fail (name != NULL, 0);
+
+	id = _find_info (stream, name);
+	if (id < 0)
+		return 0;
+
+	return arv_stream_get_info_uint64 (stream, id);
+}
+
+/**
+ * arv_stream_get_info_double_by_name:
+ * @stream: a #ArvStream
+ * @name: statistic name
+ *
+ * Returns: the value of the statistic @name, 0.0 if not found
+ *
+ * Since: 0.8.11
+ */
+
+double
+arv_stream_get_info_double_by_name (ArvStream *stream, const char *name)
+{
+	gint id;
+
+	g_return_val_if_fail (ARV_IS_STREAM (stream), 0.0);
+	g_return_val_if_fail (name != NULL, 0.0);
 
-	g_return_if_fail (ARV_IS_STREAM (stream));
+	id = _find_info (stream, name);
+	if (id < 0)
+		return 0.0;
 
-	stream_class = ARV_STREAM_GET_CLASS (stream);
-	if (stream_class->get_statistics != NULL)
-		stream_class->get_statistics (stream, n_completed_buffers, n_failures, n_underruns);
+	return arv_stream_get_info_double (stream, id);
 }
 
 /**
@@ -383,6 +2166,51 @@ arv_stream_set_emit_signals (ArvStream *stream, gboolean emit_signals)
 	g_rec_mutex_unlock (&priv->mutex);
 }
 
+/**
+ * arv_stream_get_output_fd:
+ * @stream: a #ArvStream
+ *
+ * Returns a file descriptor which is readable while the output queue of @stream is not empty, for the integration
+ * of the buffer retrieval in an external event loop, with poll(), epoll or a #GSource. The buffers are then popped
+ * using arv_stream_try_pop_buffer() or arv_stream_pop_buffers(), which clear the readiness once the output queue is
+ * empty. The file descriptor must not be read or closed by the caller. It is an eventfd on Linux, the read end of a
+ * pipe elsewhere.
+ *
+ * Unlike the `new-buffer` signal, nothing is done in the stream thread beyond a write to the file descriptor.
+ *
+ * This method is thread safe.
+ *
+ * Returns: a file descriptor owned by @stream, valid until @stream is destroyed.
+ *
+ * Since: 0.8.11
+ */
+
+int
+arv_stream_get_output_fd (ArvStream *stream)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+	GPollFD poll_fd;
+
+	g_return_val_if_fail (ARV_IS_STREAM (stream), -1);
+
+	g_rec_mutex_lock (&priv->mutex);
+
+	if (priv->output_wakeup == NULL) {
+		ArvWakeup *wakeup = arv_wakeup_new ();
+
+		g_atomic_pointer_set (&priv->output_wakeup, wakeup);
+
+		/* Buffers queued before the creation */
+		_acknowledge_output_wakeup (priv);
+	}
+
+	arv_wakeup_get_pollfd (priv->output_wakeup, &poll_fd);
+
+	g_rec_mutex_unlock (&priv->mutex);
+
+	return poll_fd.fd;
+}
+
 /**
  * arv_stream_get_emit_signals:
  * @stream: a #ArvStream
@@ -423,8 +2251,12 @@ arv_stream_set_property (GObject * object, guint prop_id,
 			arv_stream_set_emit_signals (stream, g_value_get_boolean (value));
 			break;
 		case ARV_STREAM_PROPERTY_DEVICE:
+			if (priv->device != NULL)
+				arv_device_remove_stream (priv->device, stream);
 			g_clear_object (&priv->device);
 			priv->device = g_value_dup_object (value);
+			if (priv->device != NULL)
+				arv_device_add_stream (priv->device, stream);
 			break;
 		case ARV_STREAM_PROPERTY_CALLBACK:
 			priv->callback = g_value_get_pointer (value);
@@ -432,6 +2264,82 @@ arv_stream_set_property (GObject * object, guint prop_id,
 		case ARV_STREAM_PROPERTY_CALLBACK_DATA:
 			priv->callback_data = g_value_get_pointer (value);
 			break;
+		case ARV_STREAM_PROPERTY_CPU_AFFINITY:
+			priv->cpu_affinity = g_value_get_int (value);
+			g_atomic_int_set (&priv->placement_changed, TRUE);
+			break;
+		case ARV_STREAM_PROPERTY_NUMA_NODE:
+			priv->numa_node = g_value_get_int (value);
+			g_atomic_int_set (&priv->placement_changed, TRUE);
+			break;
+		case ARV_STREAM_PROPERTY_REGION_READY_SIZE:
+			priv->region_ready_size = g_value_get_uint (value);
+			break;
+		case ARV_STREAM_PROPERTY_LOCK_FREE_QUEUES:
+			{
+				gint n_input_buffers, n_output_buffers;
+
+				arv_stream_get_n_buffers (stream, &n_input_buffers, &n_output_buffers);
+				if (n_input_buffers > 0 || n_output_buffers > 0) {
+					arv_warning_stream ("[Stream::set_property] Queue implementation can't be changed"
+							    " while buffers are queued");
+					break;
+				}
+				g_atomic_int_set (&priv->use_lock_free_queues, g_value_get_boolean (value));
+			}
+			break;
+		case ARV_STREAM_PROPERTY_MAILBOX:
+			g_atomic_int_set (&priv->mailbox, g_value_get_boolean (value));
+			break;
+		case ARV_STREAM_PROPERTY_MAX_AGE:
+			g_atomic_int_set (&priv->max_age_us, g_value_get_uint (value));
+			break;
+		case ARV_STREAM_PROPERTY_CHECKSUM:
+			g_atomic_int_set (&priv->checksum, g_value_get_boolean (value));
+			break;
+		case ARV_STREAM_PROPERTY_EXPECTED_FRAME_PERIOD:
+			priv->expected_frame_period_us = g_value_get_double (value);
+			arv_frame_timing_set_expected_period (priv->frame_timing, priv->expected_frame_period_us);
+			break;
+		case ARV_STREAM_PROPERTY_FRAME_GAP_RATIO:
+			priv->frame_gap_ratio = g_value_get_double (value);
+			arv_frame_timing_set_gap_ratio (priv->frame_timing, priv->frame_gap_ratio);
+			break;
+		case ARV_STREAM_PROPERTY_BUFFER_POOL:
+			g_atomic_int_set (&priv->use_buffer_pool, g_value_get_boolean (value));
+			_pool_update (stream);
+			break;
+		case ARV_STREAM_PROPERTY_POOL_MIN_SIZE:
+			g_mutex_lock (&priv->pool_mutex);
+			priv->pool_min_size = g_value_get_uint (value);
+			g_mutex_unlock (&priv->pool_mutex);
+			_pool_update (stream);
+			break;
+		case ARV_STREAM_PROPERTY_POOL_MAX_SIZE:
+			g_mutex_lock (&priv->pool_mutex);
+			priv->pool_max_size = g_value_get_uint (value);
+			g_mutex_unlock (&priv->pool_mutex);
+			break;
+		case ARV_STREAM_PROPERTY_EVENT_RING_FILENAME:
+			g_rec_mutex_lock (&priv->mutex);
+			g_free (priv->event_ring_filename);
+			priv->event_ring_filename = g_value_dup_string (value);
+			g_atomic_int_set (&priv->n_event_ring_failures, 0);
+			g_rec_mutex_unlock (&priv->mutex);
+			break;
+		case ARV_STREAM_PROPERTY_EVENT_RING_FAILURES:
+			g_atomic_int_set (&priv->n_event_ring_failures, 0);
+			g_atomic_int_set (&priv->event_ring_failures, g_value_get_uint (value));
+			break;
+		case ARV_STREAM_PROPERTY_POP_SPIN_TIME:
+			g_atomic_int_set (&priv->pop_spin_time_us, g_value_get_uint (value));
+			break;
+		case ARV_STREAM_PROPERTY_POOL_ALLOCATOR:
+			g_mutex_lock (&priv->pool_mutex);
+			g_clear_object (&priv->pool_allocator);
+			priv->pool_allocator = g_value_dup_object (value);
+			g_mutex_unlock (&priv->pool_mutex);
+			break;
 		default:
 			G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
 			break;
@@ -458,12 +2366,164 @@ arv_stream_get_property (GObject * object, guint prop_id,
 		case ARV_STREAM_PROPERTY_CALLBACK_DATA:
 			g_value_set_pointer (value, priv->callback_data);
 			break;
+		case ARV_STREAM_PROPERTY_CPU_AFFINITY:
+			g_value_set_int (value, priv->cpu_affinity);
+			break;
+		case ARV_STREAM_PROPERTY_NUMA_NODE:
+			g_value_set_int (value, priv->numa_node);
+			break;
+		case ARV_STREAM_PROPERTY_REGION_READY_SIZE:
+			g_value_set_uint (value, priv->region_ready_size);
+			break;
+		case ARV_STREAM_PROPERTY_LOCK_FREE_QUEUES:
+			g_value_set_boolean (value, g_atomic_int_get (&priv->use_lock_free_queues));
+			break;
+		case ARV_STREAM_PROPERTY_MAILBOX:
+			g_value_set_boolean (value, g_atomic_int_get (&priv->mailbox));
+			break;
+		case ARV_STREAM_PROPERTY_MAX_AGE:
+			g_value_set_uint (value, g_atomic_int_get (&priv->max_age_us));
+			break;
+		case ARV_STREAM_PROPERTY_CHECKSUM:
+			g_value_set_boolean (value, g_atomic_int_get (&priv->checksum));
+			break;
+		case ARV_STREAM_PROPERTY_EXPECTED_FRAME_PERIOD:
+			g_value_set_double (value, priv->expected_frame_period_us);
+			break;
+		case ARV_STREAM_PROPERTY_FRAME_GAP_RATIO:
+			g_value_set_double (value, priv->frame_gap_ratio);
+			break;
+		case ARV_STREAM_PROPERTY_BUFFER_POOL:
+			g_value_set_boolean (value, g_atomic_int_get (&priv->use_buffer_pool));
+			break;
+		case ARV_STREAM_PROPERTY_POOL_MIN_SIZE:
+			g_value_set_uint (value, priv->pool_min_size);
+			break;
+		case ARV_STREAM_PROPERTY_POOL_MAX_SIZE:
+			g_value_set_uint (value, priv->pool_max_size);
+			break;
+		case ARV_STREAM_PROPERTY_POOL_SIZE:
+			g_value_set_uint (value, g_atomic_int_get (&priv->pool_counter->size));
+			break;
+		case ARV_STREAM_PROPERTY_POOL_HIGH_WATER_MARK:
+			g_mutex_lock (&priv->pool_mutex);
+			g_value_set_uint (value, priv->pool_high_water_mark);
+			g_mutex_unlock (&priv->pool_mutex);
+			break;
+		case ARV_STREAM_PROPERTY_EVENT_RING_FILENAME:
+			g_rec_mutex_lock (&priv->mutex);
+			g_value_set_string (value, priv->event_ring_filename);
+			g_rec_mutex_unlock (&priv->mutex);
+			break;
+		case ARV_STREAM_PROPERTY_EVENT_RING_FAILURES:
+			g_value_set_uint (value, g_atomic_int_get (&priv->event_ring_failures));
+			break;
+		case ARV_STREAM_PROPERTY_POP_SPIN_TIME:
+			g_value_set_uint (value, g_atomic_int_get (&priv->pop_spin_time_us));
+			break;
+		case ARV_STREAM_PROPERTY_POOL_ALLOCATOR:
+			g_mutex_lock (&priv->pool_mutex);
+			g_value_set_object (value, priv->pool_allocator);
+			g_mutex_unlock (&priv->pool_mutex);
+			break;
 		default:
 			G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
 			break;
 	}
 }
 
+/* Called from the stream threads, when they start */
+
+void
+arv_stream_apply_thread_placement (ArvStream *stream)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+
+	g_return_if_fail (ARV_IS_STREAM (stream));
+
+	g_atomic_int_set (&priv->placement_changed, FALSE);
+
+	/* The stream placement properties take precedence over the global internal thread settings */
+	arv_apply_internal_thread_scheduling (ARV_INTERNAL_THREAD_STREAM);
+
+	if (priv->cpu_affinity < 0 && priv->numa_node < 0)
+		return;
+
+	if (!arv_make_thread_affine (priv->cpu_affinity, priv->numa_node))
+		arv_warning_stream_thread ("[Stream::apply_thread_placement] Failed to place stream thread"
+					   " (cpu %d, NUMA node %d)", priv->cpu_affinity, priv->numa_node);
+}
+
+/* Called from the stream threads, which flush their open frames and reset their acquisition state when the number of
+ * pauses changes */
+
+guint
+arv_stream_get_n_pauses (ArvStream *stream)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+
+	return g_atomic_int_get (&priv->n_pauses);
+}
+
+/* Called from the stream threads at the start of each frame */
+
+gboolean
+arv_stream_is_checksum_enabled (ArvStream *stream)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+
+	return g_atomic_int_get (&priv->checksum);
+}
+
+/* Called from the stream thread loops, for placement changes while the thread is running */
+
+void
+arv_stream_update_thread_placement (ArvStream *stream)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+
+	if (G_LIKELY (!g_atomic_int_get (&priv->placement_changed)))
+		return;
+
+	arv_stream_apply_thread_placement (stream);
+}
+
+/* Called from the stream threads, when the contiguously filled part of @buffer, starting at offset 0, grows to
+ * @ready_size bytes. The ready region callback is only emitted by steps of at least region-ready-size bytes, and
+ * for the last part of the buffer. */
+
+void
+arv_stream_update_ready_region (ArvStream *stream, ArvBuffer *buffer, size_t ready_size)
+{
+	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
+	size_t notified_size;
+
+	if (priv->callback == NULL || priv->region_ready_size == 0)
+		return;
+
+	notified_size = buffer->priv->ready_offset + buffer->priv->ready_size;
+
+	if (ready_size <= notified_size ||
+	    (ready_size - notified_size < priv->region_ready_size && ready_size < buffer->priv->size))
+		return;
+
+	buffer->priv->ready_offset = notified_size;
+	buffer->priv->ready_size = ready_size - notified_size;
+
+	priv->callback (priv->callback_data, ARV_STREAM_CALLBACK_TYPE_REGION_READY, buffer);
+}
+
+/**
+ * arv_stream_take_init_error:
+ * @stream: a #ArvStream
+ * @error: (transfer full): the construction error
+ *
+ * Sets the error returned by the #GInitable initialization of @stream, for the backends whose construction, in
+ * their #GObjectClass.constructed() implementation, failed.
+ *
+ * Since: 0.8.11
+ */
+
 void
 arv_stream_take_init_error (ArvStream *stream, GError *error)
 {
@@ -482,8 +2542,81 @@ arv_stream_init (ArvStream *stream)
 
 	priv->input_queue = g_async_queue_new ();
 	priv->output_queue = g_async_queue_new ();
+	priv->lock_free_input_queue = arv_buffer_queue_new ();
+	priv->lock_free_output_queue = arv_buffer_queue_new ();
+
+	g_mutex_init (&priv->pool_mutex);
+	priv->pool_counter = g_new0 (ArvStreamPoolCounter, 1);
+	priv->pool_counter->ref_count = 1;
+	priv->pool_min_size = ARV_STREAM_POOL_MIN_SIZE_DEFAULT;
+	priv->pool_max_size = ARV_STREAM_POOL_MAX_SIZE_DEFAULT;
 
 	priv->emit_signals = FALSE;
+	priv->cpu_affinity = -1;
+	priv->numa_node = -1;
+
+	priv->infos = g_ptr_array_new_with_free_func (_info_free);
+	priv->statistics = g_ptr_array_new_with_free_func (_statistic_free);
+
+	g_mutex_init (&priv->tile_mutex);
+	arv_stream_declare_info (stream, "n_tile_drops", G_TYPE_UINT64, &priv->n_tile_drops);
+
+	g_mutex_init (&priv->processing_mutex);
+	arv_stream_declare_info (stream, "n_processing_drops", G_TYPE_UINT64, &priv->n_processing_drops);
+	priv->processing_depth_statistic = arv_statistic_new (1, 100, 1, 0);
+	arv_statistic_set_name (priv->processing_depth_statistic, 0, "Processing queue depth");
+	arv_stream_declare_statistic (stream, "processing_queue_depth", priv->processing_depth_statistic, 0);
+	priv->processing_stall_statistic = arv_statistic_new (1, 100, 100, 0);
+	arv_statistic_set_name (priv->processing_stall_statistic, 0, "Processing stall time");
+	arv_stream_declare_statistic (stream, "processing_stall_time_us", priv->processing_stall_statistic, 0);
+
+	g_mutex_init (&priv->chunk_plan_mutex);
+	g_mutex_init (&priv->copy_mutex);
+	arv_stream_declare_info (stream, "n_chunk_plan_failures", G_TYPE_UINT64, &priv->n_chunk_plan_failures);
+
+	priv->dwell_statistic = arv_statistic_new (1, 100, 1000, 0);
+	arv_statistic_set_name (priv->dwell_statistic, 0, "Output queue dwell time");
+	arv_stream_declare_statistic (stream, "output_queue_dwell_time_us", priv->dwell_statistic, 0);
+
+	priv->frame_timing = arv_frame_timing_new ();
+	priv->frame_gap_ratio = ARV_FRAME_TIMING_GAP_RATIO_DEFAULT;
+	arv_stream_declare_statistic (stream, "device_frame_interval_jitter_us", priv->frame_timing->statistic,
+				      ARV_FRAME_INTERVAL_SOURCE_DEVICE);
+	arv_stream_declare_statistic (stream, "host_frame_interval_jitter_us", priv->frame_timing->statistic,
+				      ARV_FRAME_INTERVAL_SOURCE_HOST);
+	arv_stream_declare_info (stream, "device_frame_interval_mean_us", G_TYPE_DOUBLE,
+				 &priv->frame_timing->trackers[ARV_FRAME_INTERVAL_SOURCE_DEVICE].mean_us);
+	arv_stream_declare_info (stream, "device_frame_interval_stddev_us", G_TYPE_DOUBLE,
+				 &priv->frame_timing->trackers[ARV_FRAME_INTERVAL_SOURCE_DEVICE].standard_deviation_us);
+	arv_stream_declare_info (stream, "n_device_frame_gaps", G_TYPE_UINT64,
+				 &priv->frame_timing->trackers[ARV_FRAME_INTERVAL_SOURCE_DEVICE].n_gaps);
+	arv_stream_declare_info (stream, "host_frame_interval_mean_us", G_TYPE_DOUBLE,
+				 &priv->frame_timing->trackers[ARV_FRAME_INTERVAL_SOURCE_HOST].mean_us);
+	arv_stream_declare_info (stream, "host_frame_interval_stddev_us", G_TYPE_DOUBLE,
+				 &priv->frame_timing->trackers[ARV_FRAME_INTERVAL_SOURCE_HOST].standard_deviation_us);
+	arv_stream_declare_info (stream, "n_host_frame_gaps", G_TYPE_UINT64,
+				 &priv->frame_timing->trackers[ARV_FRAME_INTERVAL_SOURCE_HOST].n_gaps);
+	arv_stream_declare_info (stream, "frame_clock_drift_ppm", G_TYPE_DOUBLE, &priv->frame_timing->clock_drift_ppm);
+
+	priv->budget_client = arv_buffer_budget_register ();
+	arv_stream_declare_info (stream, "budget_owned_bytes", G_TYPE_UINT64, &priv->budget_client->owned_bytes);
+	arv_stream_declare_info (stream, "budget_share_bytes", G_TYPE_UINT64, &priv->budget_client->share_bytes);
+	arv_stream_declare_info (stream, "n_budget_refusals", G_TYPE_UINT64,
+				 &priv->budget_client->n_events[ARV_BUFFER_BUDGET_EVENT_REFUSAL]);
+	arv_stream_declare_info (stream, "n_budget_drops", G_TYPE_UINT64,
+				 &priv->budget_client->n_events[ARV_BUFFER_BUDGET_EVENT_DROP]);
+	arv_stream_declare_info (stream, "n_budget_recycles", G_TYPE_UINT64,
+				 &priv->budget_client->n_events[ARV_BUFFER_BUDGET_EVENT_RECYCLE]);
+	arv_stream_declare_info (stream, "n_budget_blocks", G_TYPE_UINT64,
+				 &priv->budget_client->n_events[ARV_BUFFER_BUDGET_EVENT_BLOCK]);
+
+	arv_stream_declare_info (stream, "n_pop_spin_hits", G_TYPE_UINT, &priv->n_pop_spin_hits);
+	arv_stream_declare_info (stream, "n_pop_spin_misses", G_TYPE_UINT, &priv->n_pop_spin_misses);
+
+	arv_stream_declare_info (stream, "n_expired_buffers", G_TYPE_UINT, &priv->n_expired_buffers);
+
+	priv->event_ring = arv_event_ring_new (ARV_EVENT_RING_N_RECORDS_DEFAULT);
+	priv->event_ring_failures = 1;
 
 	g_rec_mutex_init (&priv->mutex);
 }
@@ -495,16 +2628,47 @@ arv_stream_finalize (GObject *object)
 	ArvStreamPrivate *priv = arv_stream_get_instance_private (stream);
 	ArvBuffer *buffer;
 
+	if (priv->device != NULL)
+		arv_device_remove_stream (priv->device, stream);
+
 	arv_info_stream ("[Stream::finalize] Flush %d buffer[s] in input queue",
 			  g_async_queue_length (priv->input_queue));
 	arv_info_stream ("[Stream::finalize] Flush %d buffer[s] in output queue",
 			  g_async_queue_length (priv->output_queue));
+	if (priv->n_mailbox_drops > 0)
+		arv_info_stream ("[Stream::finalize] %" G_GUINT64_FORMAT " buffer[s] dropped in mailbox mode",
+				  priv->n_mailbox_drops);
+	if (priv->n_expired_buffers > 0)
+		arv_info_stream ("[Stream::finalize] %u buffer[s] older than the maximum age recycled",
+				  priv->n_expired_buffers);
+	if (priv->n_tile_drops > 0)
+		arv_info_stream ("[Stream::finalize] %" G_GUINT64_FORMAT " buffer[s] dropped by the tile processing stage",
+				  priv->n_tile_drops);
+	if (priv->n_processing_drops > 0)
+		arv_info_stream ("[Stream::finalize] %" G_GUINT64_FORMAT " buffer[s] dropped by the processing stage",
+				  priv->n_processing_drops);
 
 	if (priv->emit_signals) {
 		g_warning ("Stream finalized with 'new-buffer' signal enabled");
 		g_warning ("Please call arv_stream_set_emit_signals (stream, FALSE) before ArvStream object finalization");
+		priv->emit_signals = FALSE;
 	}
 
+	/* Flush the processing stage into the output queue */
+	arv_tile_pipeline_free (priv->tile_pipeline);
+	priv->tile_pipeline = NULL;
+	g_mutex_clear (&priv->tile_mutex);
+	arv_processing_stage_free (priv->processing_stage);
+	priv->processing_stage = NULL;
+	g_mutex_clear (&priv->processing_mutex);
+
+	g_clear_object (&priv->chunk_plan);
+	g_mutex_clear (&priv->chunk_plan_mutex);
+
+	if (priv->copy_destroy != NULL)
+		priv->copy_destroy (priv->copy_data);
+	g_mutex_clear (&priv->copy_mutex);
+
 	do {
 		buffer = g_async_queue_try_pop (priv->output_queue);
 		if (buffer != NULL)
@@ -517,13 +2681,47 @@ arv_stream_finalize (GObject *object)
 			g_object_unref (buffer);
 	} while (buffer != NULL);
 
+	while ((buffer = arv_buffer_queue_try_pop (priv->lock_free_output_queue)) != NULL)
+		g_object_unref (buffer);
+	while ((buffer = arv_buffer_queue_try_pop (priv->lock_free_input_queue)) != NULL)
+		g_object_unref (buffer);
+
 	g_async_queue_unref (priv->input_queue);
 	g_async_queue_unref (priv->output_queue);
+	arv_buffer_queue_free (priv->lock_free_input_queue);
+	arv_buffer_queue_free (priv->lock_free_output_queue);
+	g_clear_pointer (&priv->output_wakeup, arv_wakeup_free);
+
+	g_clear_pointer (&priv->pool_counter, _pool_counter_unref);
+	g_clear_object (&priv->pool_allocator);
+	g_mutex_clear (&priv->pool_mutex);
+
+	if (priv->budget_client->n_events[ARV_BUFFER_BUDGET_EVENT_REFUSAL] > 0)
+		arv_info_stream ("[Stream::finalize] %" G_GUINT64_FORMAT " buffer allocation[s] refused by the memory budget",
+				 priv->budget_client->n_events[ARV_BUFFER_BUDGET_EVENT_REFUSAL]);
+	g_clear_pointer (&priv->budget_client, arv_buffer_budget_unregister);
 
 	g_rec_mutex_clear (&priv->mutex);
 
 	g_clear_object (&priv->device);
 
+	if (arv_statistic_get_n_values (priv->dwell_statistic, 0) > 0)
+		arv_info_stream ("[Stream::finalize] Output queue dwell time p50 = %d µs, p99 = %d µs, max = %d µs",
+				 arv_statistic_get_percentile (priv->dwell_statistic, 0, 50.0),
+				 arv_statistic_get_percentile (priv->dwell_statistic, 0, 99.0),
+				 arv_statistic_get_max (priv->dwell_statistic, 0));
+
+	g_clear_pointer (&priv->infos, g_ptr_array_unref);
+	g_clear_pointer (&priv->statistics, g_ptr_array_unref);
+	g_clear_pointer (&priv->dwell_statistic, arv_statistic_free);
+	g_clear_pointer (&priv->frame_timing, arv_frame_timing_free);
+	g_clear_pointer (&priv->processing_depth_statistic, arv_statistic_free);
+	g_clear_pointer (&priv->processing_stall_statistic, arv_statistic_free);
+
+	g_clear_pointer (&priv->event_ring, arv_event_ring_free);
+	g_clear_pointer (&priv->event_ring_filename, g_free);
+	g_clear_pointer (&priv->frame_log, arv_frame_log_free);
+
 	g_clear_error (&priv->init_error);
 
 	G_OBJECT_CLASS (arv_stream_parent_class)->finalize (object);
@@ -591,6 +2789,320 @@ arv_stream_class_init (ArvStreamClass *node_class)
 				       "Stream callback data",
 				       "Optional user callback data",
 				       G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY));
+
+	/**
+	 * ArvStream:cpu-affinity:
+	 *
+	 * Index of the CPU the stream receive thread is pinned to, or -1 for no pinning.
+	 *
+	 * Since: 0.8.11
+	 */
+
+	g_object_class_install_property
+		(object_class,
+		 ARV_STREAM_PROPERTY_CPU_AFFINITY,
+		 g_param_spec_int ("cpu-affinity",
+				   "CPU affinity",
+				   "Stream thread CPU index",
+				   -1, G_MAXINT, -1,
+				   G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	/**
+	 * ArvStream:numa-node:
+	 *
+	 * NUMA node the stream receive thread runs and allocates its memory on, or -1. If
+	 * #ArvStream:cpu-affinity is not set, the thread may run on any CPU of this node. Buffers
+	 * should be allocated on the same node, using arv_buffer_new_allocate_numa().
+	 *
+	 * Since: 0.8.11
+	 */
+
+	g_object_class_install_property
+		(object_class,
+		 ARV_STREAM_PROPERTY_NUMA_NODE,
+		 g_param_spec_int ("numa-node",
+				   "NUMA node",
+				   "Stream thread NUMA node",
+				   -1, G_MAXINT, -1,
+				   G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	/**
+	 * ArvStream:region-ready-size:
+	 *
+	 * Minimum size of the regions reported by the %ARV_STREAM_CALLBACK_TYPE_REGION_READY stream callback, in
+	 * bytes, or 0 to disable it.
+	 *
+	 * Since: 0.8.11
+	 */
+
+	g_object_class_install_property
+		(object_class,
+		 ARV_STREAM_PROPERTY_REGION_READY_SIZE,
+		 g_param_spec_uint ("region-ready-size",
+				    "Region ready size",
+				    "Ready region callback granularity, in bytes",
+				    0, G_MAXUINT, 0,
+				    G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	/**
+	 * ArvStream:lock-free-queues:
+	 *
+	 * Use lock-free queues for the buffers exchanged with the stream thread, instead of #GAsyncQueue. They avoid
+	 * taking a mutex at each push and pop, and only issue a wakeup when the consumer is waiting. Buffers may still
+	 * be pushed from any thread, but only one thread at a time may pop buffers from the stream.
+	 *
+	 * It must be set before the first buffer is pushed to the stream.
+	 *
+	 * Since: 0.8.11
+	 */
+
+	g_object_class_install_property
+		(object_class,
+		 ARV_STREAM_PROPERTY_LOCK_FREE_QUEUES,
+		 g_param_spec_boolean ("lock-free-queues",
+				       "Lock free queues",
+				       "Use lock-free buffer queues",
+				       FALSE,
+				       G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	/**
+	 * ArvStream:mailbox:
+	 *
+	 * Only keep the latest buffer in the output queue: when a new buffer is done, the older ones not popped yet by
+	 * the application are pushed back to the input queue, and counted by arv_stream_get_n_dropped_buffers(). The
+	 * latency is then bounded to one frame even when the application falls behind.
+	 *
+	 * This mode is ignored if #ArvStream:lock-free-queues is set, as the stream thread would have to pop from the
+	 * output queue.
+	 *
+	 * Since: 0.8.11
+	 */
+
+	g_object_class_install_property
+		(object_class,
+		 ARV_STREAM_PROPERTY_MAILBOX,
+		 g_param_spec_boolean ("mailbox",
+				       "Mailbox",
+				       "Only keep the latest output buffer",
+				       FALSE,
+				       G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	/**
+	 * ArvStream:max-age:
+	 *
+	 * Maximum age of the output buffers, in µs, measured from their completion by the stream thread, 0 for no limit.
+	 * Older buffers are never returned by the pop functions: they are pushed back to the input queue, either when
+	 * popped or when a newer buffer is done, and counted by the `n_expired_buffers` stream statistic, see
+	 * arv_stream_get_info_uint64_by_name(). The consumers then only get frames younger than the deadline, without
+	 * having to skip the stale ones themselves.
+	 *
+	 * If #ArvStream:lock-free-queues is set, the expired buffers are only recycled by the pop functions.
+	 *
+	 * Since: 0.8.11
+	 */
+
+	g_object_class_install_property
+		(object_class,
+		 ARV_STREAM_PROPERTY_MAX_AGE,
+		 g_param_spec_uint ("max-age",
+				    "Maximum age",
+				    "Maximum age of the output buffers, in µs",
+				    0, G_MAXINT, 0,
+				    G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	/**
+	 * ArvStream:buffer-pool:
+	 *
+	 * Let the stream allocate its buffers, of the device PayloadSize, instead of having the application push
+	 * them. The pool starts with #ArvStream:pool-min-size buffers, grows up to #ArvStream:pool-max-size instead
+	 * of an underrun, and shrinks back when buffers stay unused for a few seconds. The payload size is read again
+	 * by arv_stream_start_thread() and before each execution of the AcquisitionStart command of the device, buffers
+	 * of an outdated size being reallocated when they are reused.
+	 *
+	 * Since: 0.8.11
+	 */
+
+	g_object_class_install_property
+		(object_class,
+		 ARV_STREAM_PROPERTY_BUFFER_POOL,
+		 g_param_spec_boolean ("buffer-pool",
+				       "Buffer pool",
+				       "Stream allocated buffers",
+				       FALSE,
+				       G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+	g_object_class_install_property
+		(object_class,
+		 ARV_STREAM_PROPERTY_POOL_MIN_SIZE,
+		 g_param_spec_uint ("pool-min-size",
+				    "Pool minimum size",
+				    "Minimum number of pool buffers",
+				    0, G_MAXUINT, ARV_STREAM_POOL_MIN_SIZE_DEFAULT,
+				    G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+	g_object_class_install_property
+		(object_class,
+		 ARV_STREAM_PROPERTY_POOL_MAX_SIZE,
+		 g_param_spec_uint ("pool-max-size",
+				    "Pool maximum size",
+				    "Maximum number of pool buffers",
+				    0, G_MAXUINT, ARV_STREAM_POOL_MAX_SIZE_DEFAULT,
+				    G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+	g_object_class_install_property
+		(object_class,
+		 ARV_STREAM_PROPERTY_POOL_SIZE,
+		 g_param_spec_uint ("pool-size",
+				    "Pool size",
+				    "Current number of pool buffers",
+				    0, G_MAXUINT, 0,
+				    G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+	g_object_class_install_property
+		(object_class,
+		 ARV_STREAM_PROPERTY_POOL_HIGH_WATER_MARK,
+		 g_param_spec_uint ("pool-high-water-mark",
+				    "Pool high water mark",
+				    "Maximum number of pool buffers simultaneously in use",
+				    0, G_MAXUINT, 0,
+				    G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
+	/**
+	 * ArvStream:event-ring-filename:
+	 *
+	 * File the event ring of the stream thread is automatically saved to, once #ArvStream:event-ring-failures
+	 * frames failed. %NULL disables the automatic dump. See arv_stream_dump_event_ring().
+	 *
+	 * Since: 0.8.11
+	 */
+
+	g_object_class_install_property
+		(object_class,
+		 ARV_STREAM_PROPERTY_EVENT_RING_FILENAME,
+		 g_param_spec_string ("event-ring-filename",
+				      "Event ring filename",
+				      "Automatic event ring dump file",
+				      NULL,
+				      G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	/**
+	 * ArvStream:event-ring-failures:
+	 *
+	 * Number of failed frames triggering the automatic save of the event ring to #ArvStream:event-ring-filename.
+	 * The ring is saved once, setting this property again rearms the trigger. 0 disables the automatic dump.
+	 *
+	 * Since: 0.8.11
+	 */
+
+	g_object_class_install_property
+		(object_class,
+		 ARV_STREAM_PROPERTY_EVENT_RING_FAILURES,
+		 g_param_spec_uint ("event-ring-failures",
+				    "Event ring failures",
+				    "Number of failed frames triggering the event ring dump",
+				    0, G_MAXINT, 1,
+				    G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	/**
+	 * ArvStream:pop-spin-time:
+	 *
+	 * Busy poll the output queue during this time, in µs, before falling back to blocking in
+	 * arv_stream_pop_buffer(), arv_stream_timeout_pop_buffer() and arv_stream_pop_buffers(). This avoids the
+	 * wakeup latency of the blocking pop for consumers running on a dedicated processor core, at the cost of
+	 * burning this core. It works best with #ArvStream:lock-free-queues, the polling of the default output queue
+	 * taking its lock.
+	 *
+	 * The outcome of the polling is published in the `n_pop_spin_hits` and `n_pop_spin_misses` stream
+	 * statistics, see arv_stream_get_info_uint64_by_name(): the hit rate is `n_pop_spin_hits / (n_pop_spin_hits +
+	 * n_pop_spin_misses)`. A low hit rate means the spin time is shorter than the frame period, and only wastes
+	 * processor time.
+	 *
+	 * Since: 0.8.11
+	 */
+
+	g_object_class_install_property
+		(object_class,
+		 ARV_STREAM_PROPERTY_POP_SPIN_TIME,
+		 g_param_spec_uint ("pop-spin-time",
+				    "Pop spin time",
+				    "Busy polling time of the output queue before blocking, in µs",
+				    0, G_MAXINT, 0,
+				    G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	/**
+	 * ArvStream:pool-allocator:
+	 *
+	 * Allocator of the data of the pool buffers (see #ArvStream:buffer-pool), for example for receiving the frames
+	 * directly into memory registered by a GPU. The buffers already in the pool keep their memory. The pool falls back
+	 * to the default allocation if the allocator fails.
+	 *
+	 * Since: 0.8.11
+	 */
+
+	g_object_class_install_property
+		(object_class,
+		 ARV_STREAM_PROPERTY_POOL_ALLOCATOR,
+		 g_param_spec_object ("pool-allocator",
+				      "Pool allocator",
+				      "Allocator of the pool buffer data",
+				      ARV_TYPE_BUFFER_ALLOCATOR,
+				      G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	/**
+	 * ArvStream:checksum:
+	 *
+	 * Compute the CRC32C of the received data of each successfully received buffer, available using
+	 * arv_buffer_get_checksum(). GigE Vision streams checksum each data block just after its copy, while it is
+	 * still in the cache, and USB3 Vision streams each transfer on its completion. The payloads rewritten during
+	 * the reassembly, when unpacked or cropped, and the multipart payloads, are checksummed at the frame completion
+	 * instead.
+	 *
+	 * It is taken into account at the start of the next frame.
+	 *
+	 * Since: 0.8.11
+	 */
+
+	g_object_class_install_property
+		(object_class,
+		 ARV_STREAM_PROPERTY_CHECKSUM,
+		 g_param_spec_boolean ("checksum",
+				       "Checksum",
+				       "Compute the CRC32C of the received buffers",
+				       FALSE,
+				       G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	/**
+	 * ArvStream:expected-frame-period:
+	 *
+	 * Expected interval between the frames, in µs, used as the reference period of the frame interval statistics,
+	 * see arv_stream_get_frame_interval_statistics(). If it is 0, the reference period is the median of the first
+	 * measured intervals. Setting it restarts the statistics.
+	 *
+	 * Since: 0.8.11
+	 */
+
+	g_object_class_install_property
+		(object_class,
+		 ARV_STREAM_PROPERTY_EXPECTED_FRAME_PERIOD,
+		 g_param_spec_double ("expected-frame-period",
+				      "Expected frame period",
+				      "Expected frame interval, in µs, 0 for automatic",
+				      0.0, G_MAXDOUBLE, 0.0,
+				      G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
+
+	/**
+	 * ArvStream:frame-gap-ratio:
+	 *
+	 * Ratio of the reference period above which a frame interval is counted as a gap, for example because of
+	 * missing frames or of a missed trigger.
+	 *
+	 * Since: 0.8.11
+	 */
+
+	g_object_class_install_property
+		(object_class,
+		 ARV_STREAM_PROPERTY_FRAME_GAP_RATIO,
+		 g_param_spec_double ("frame-gap-ratio",
+				      "Frame gap ratio",
+				      "Interval to reference period ratio of the frame gaps",
+				      1.0, G_MAXDOUBLE, ARV_FRAME_TIMING_GAP_RATIO_DEFAULT,
+				      G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS));
 }
 
 static gboolean
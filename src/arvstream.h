@@ -37,6 +37,8 @@ G_BEGIN_DECLS
  * @ARV_STREAM_CALLBACK_TYPE_EXIT: thread end, happens once
  * @ARV_STREAM_CALLBACK_TYPE_START_BUFFER: buffer filling start, happens at each frame
  * @ARV_STREAM_CALLBACK_TYPE_BUFFER_DONE: buffer filled, happens at each frame
+ * @ARV_STREAM_CALLBACK_TYPE_REGION_READY: a new region at the start of the buffer is filled, see
+ * arv_buffer_get_ready_region() and #ArvStream:region-ready-size (Since 0.8.11)
  *
  * Describes when the stream callback is called.
  */
@@ -45,12 +47,33 @@ typedef enum {
 	ARV_STREAM_CALLBACK_TYPE_INIT,
 	ARV_STREAM_CALLBACK_TYPE_EXIT,
 	ARV_STREAM_CALLBACK_TYPE_START_BUFFER,
-	ARV_STREAM_CALLBACK_TYPE_BUFFER_DONE
+	ARV_STREAM_CALLBACK_TYPE_BUFFER_DONE,
+	ARV_STREAM_CALLBACK_TYPE_REGION_READY
 } ArvStreamCallbackType;
 
 #define ARV_TYPE_STREAM             (arv_stream_get_type ())
 G_DECLARE_DERIVABLE_TYPE (ArvStream, arv_stream, ARV, STREAM, GObject)
 
+/**
+ * ArvStreamClass:
+ * @parent_class: the parent class
+ * @start_thread: starts the receive thread of the backend
+ * @stop_thread: stops the receive thread of the backend, which must not access the stream queues afterwards
+ * @get_statistics: returns the numbers of completed buffers, failures and underruns of the backend
+ * @new_buffer: class handler of the #ArvStream::new-buffer signal
+ * @resume: optional, called by arv_stream_resume()
+ *
+ * The stream backends, which receive the payload of a transport, derive from #ArvStream. Their receive thread takes
+ * the buffers to fill using arv_stream_pop_input_buffer() and arv_buffer_start_fill(), and delivers them using
+ * arv_stream_push_output_buffer(). The buffer pool, the processing stages and the consumer side of the stream are
+ * then shared with the built-in backends.
+ *
+ * New virtual functions are appended to the class, using the reserved padding, which keeps the class layout of the
+ * backends built against a previous version.
+ *
+ * Since: 0.8.11
+ */
+
 struct _ArvStreamClass {
 	GObjectClass parent_class;
 
@@ -61,27 +84,250 @@ struct _ArvStreamClass {
 
 	/* signals */
 	void        	(*new_buffer)   	(ArvStream *stream);
+
+	void		(*resume)		(ArvStream *stream);
+
+	/*< private >*/
+	gpointer padding[8];
 };
 
 typedef void (*ArvStreamCallback)	(void *user_data, ArvStreamCallbackType type, ArvBuffer *buffer);
 
+/**
+ * ArvStreamTileFunc:
+ * @buffer: a completed buffer
+ * @first_row: index of the first image row of the tile
+ * @n_rows: number of rows of the tile
+ * @user_data: data passed to arv_stream_set_tile_processing()
+ *
+ * Processes a band of rows of a completed image, from a worker thread of the tile processing stage. The tiles of a
+ * same buffer are processed concurrently.
+ *
+ * Since: 0.8.11
+ */
+
+typedef void (*ArvStreamTileFunc)	(ArvBuffer *buffer, guint first_row, guint n_rows, void *user_data);
+
+/**
+ * ArvStreamOverflowPolicy:
+ * @ARV_STREAM_OVERFLOW_POLICY_DROP_OLDEST: the oldest pending buffer is returned to the input queue
+ * @ARV_STREAM_OVERFLOW_POLICY_DROP_NEWEST: the new buffer is returned to the input queue
+ * @ARV_STREAM_OVERFLOW_POLICY_BLOCK: the stream thread waits for the processing stage
+ *
+ * Describes what happens to a completed buffer when the queue of the processing stage is full.
+ *
+ * Since: 0.8.11
+ */
+
+typedef enum {
+	ARV_STREAM_OVERFLOW_POLICY_DROP_OLDEST,
+	ARV_STREAM_OVERFLOW_POLICY_DROP_NEWEST,
+	ARV_STREAM_OVERFLOW_POLICY_BLOCK
+} ArvStreamOverflowPolicy;
+
+/**
+ * ArvStreamProcessFunc:
+ * @buffer: a completed buffer
+ * @user_data: data passed to arv_stream_set_processing_stage()
+ *
+ * Processes a completed buffer, from the worker thread of the processing stage.
+ *
+ * Since: 0.8.11
+ */
+
+typedef void (*ArvStreamProcessFunc)	(ArvBuffer *buffer, void *user_data);
+
+/**
+ * ArvStreamCopyKernel:
+ * @ARV_STREAM_COPY_KERNEL_DEFAULT: the payload is copied using memcpy()
+ * @ARV_STREAM_COPY_KERNEL_NON_TEMPORAL: the payload is copied using the widest non-temporal stores supported by the
+ * processor, bypassing its caches
+ * @ARV_STREAM_COPY_KERNEL_CUSTOM: the payload is copied by the function set using arv_stream_set_copy_function()
+ *
+ * Describes how the stream thread copies the received payload into the buffers.
+ *
+ * Since: 0.8.11
+ */
+
+typedef enum {
+	ARV_STREAM_COPY_KERNEL_DEFAULT,
+	ARV_STREAM_COPY_KERNEL_NON_TEMPORAL,
+	ARV_STREAM_COPY_KERNEL_CUSTOM
+} ArvStreamCopyKernel;
+
+/**
+ * ArvStreamCopyFunc:
+ * @dst: destination, inside the data of a buffer
+ * @src: received payload
+ * @size: number of bytes to copy
+ * @user_data: data passed to arv_stream_set_copy_function()
+ *
+ * Copies a block of received payload into a buffer, from the stream thread. The copied data must be visible to the
+ * other threads once the function returns.
+ *
+ * Since: 0.8.11
+ */
+
+typedef void (*ArvStreamCopyFunc)	(void *dst, const void *src, size_t size, void *user_data);
+
+/**
+ * ArvFrameIntervalSource:
+ * @ARV_FRAME_INTERVAL_SOURCE_DEVICE: intervals between the device timestamps
+ * @ARV_FRAME_INTERVAL_SOURCE_HOST: intervals between the host completion times
+ *
+ * Clock of the measured frame intervals.
+ *
+ * Since: 0.8.11
+ */
+
+typedef enum {
+	ARV_FRAME_INTERVAL_SOURCE_DEVICE,
+	ARV_FRAME_INTERVAL_SOURCE_HOST
+} ArvFrameIntervalSource;
+
+/**
+ * ArvFrameIntervalStatistics:
+ * @n_intervals: number of measured intervals
+ * @reference_period_us: expected frame period, or estimated one if #ArvStream:expected-frame-period is not set
+ * @mean_us: mean interval
+ * @standard_deviation_us: standard deviation of the intervals
+ * @min_us: shortest interval
+ * @max_us: longest interval
+ * @median_us: median interval
+ * @p99_us: 99th percentile of the intervals
+ * @p999_us: 99.9th percentile of the intervals
+ * @n_gaps: number of intervals longer than #ArvStream:frame-gap-ratio times the reference period
+ *
+ * Statistics of the intervals between the successfully received frames, filled by
+ * arv_stream_get_frame_interval_statistics(). The percentiles have a 10 µs precision, within 10 ms of the reference
+ * period.
+ *
+ * Since: 0.8.11
+ */
+
+typedef struct {
+	guint64 n_intervals;
+	double reference_period_us;
+	double mean_us;
+	double standard_deviation_us;
+	double min_us;
+	double max_us;
+	double median_us;
+	double p99_us;
+	double p999_us;
+	guint64 n_gaps;
+} ArvFrameIntervalStatistics;
+
+/**
+ * ArvStreamBudgetPolicy:
+ * @ARV_STREAM_BUDGET_POLICY_DROP: the frame is dropped, as on an input buffer underrun
+ * @ARV_STREAM_BUDGET_POLICY_RECYCLE_OLDEST: the oldest buffer of the output queue, not popped yet by the application,
+ * is reused for the frame
+ * @ARV_STREAM_BUDGET_POLICY_BLOCK: the stream thread waits up to 100 ms for a buffer pushed back by the application,
+ * then drops the frame
+ *
+ * Describes what happens when a stream without input buffer can not grow its buffer pool, because it would exceed
+ * its share of the memory budget set by arv_set_stream_memory_budget().
+ *
+ * Since: 0.8.11
+ */
+
+typedef enum {
+	ARV_STREAM_BUDGET_POLICY_DROP,
+	ARV_STREAM_BUDGET_POLICY_RECYCLE_OLDEST,
+	ARV_STREAM_BUDGET_POLICY_BLOCK
+} ArvStreamBudgetPolicy;
+
+/**
+ * ArvStreamBudgetStatistics:
+ * @max_bytes: memory budget, 0 if unlimited
+ * @owned_bytes: bytes of the buffers currently owned by the streams
+ * @high_water_mark_bytes: highest value of @owned_bytes
+ * @n_streams: number of living streams
+ * @n_refused_allocations: number of buffer allocations refused to the streams over their share
+ * @n_drops: number of frames dropped by %ARV_STREAM_BUDGET_POLICY_DROP, or after a timeout of
+ * %ARV_STREAM_BUDGET_POLICY_BLOCK
+ * @n_recycles: number of output buffers reused by %ARV_STREAM_BUDGET_POLICY_RECYCLE_OLDEST
+ * @n_blocks: number of waits of %ARV_STREAM_BUDGET_POLICY_BLOCK
+ *
+ * Process wide statistics of the stream memory budget, filled by arv_get_stream_memory_budget_statistics(). The
+ * buffers are owned by a stream from their push, or their allocation by the buffer pool, until their pop from the
+ * output queue.
+ *
+ * Since: 0.8.11
+ */
+
+typedef struct {
+	guint64 max_bytes;
+	guint64 owned_bytes;
+	guint64 high_water_mark_bytes;
+	guint n_streams;
+	guint64 n_refused_allocations;
+	guint64 n_drops;
+	guint64 n_recycles;
+	guint64 n_blocks;
+} ArvStreamBudgetStatistics;
+
 void		arv_stream_push_buffer 			(ArvStream *stream, ArvBuffer *buffer);
 ArvBuffer *	arv_stream_pop_buffer			(ArvStream *stream);
 ArvBuffer *	arv_stream_try_pop_buffer		(ArvStream *stream);
 ArvBuffer * 	arv_stream_timeout_pop_buffer 		(ArvStream *stream, guint64 timeout);
+void		arv_stream_push_buffers			(ArvStream *stream, ArvBuffer **buffers, guint n_buffers);
+guint		arv_stream_pop_buffers			(ArvStream *stream, ArvBuffer **buffers, guint max_n_buffers,
+							 guint64 timeout);
+guint64		arv_stream_get_n_dropped_buffers	(ArvStream *stream);
+gboolean	arv_stream_dump_event_ring		(ArvStream *stream, const char *filename, GError **error);
+gboolean	arv_stream_open_frame_log		(ArvStream *stream, const char *filename, guint n_records,
+							 GError **error);
+void		arv_stream_set_tile_processing		(ArvStream *stream, ArvStreamTileFunc tile_func,
+							 void *user_data, GDestroyNotify destroy,
+							 guint n_threads, guint tile_rows, guint depth);
+void		arv_stream_set_processing_stage	(ArvStream *stream, ArvStreamProcessFunc process_func,
+							 void *user_data, GDestroyNotify destroy,
+							 guint depth, ArvStreamOverflowPolicy policy);
+void		arv_stream_set_chunk_plan		(ArvStream *stream, ArvChunkPlan *plan);
+void		arv_stream_set_copy_kernel		(ArvStream *stream, ArvStreamCopyKernel kernel);
+ArvStreamCopyKernel	arv_stream_get_copy_kernel	(ArvStream *stream);
+void		arv_stream_set_copy_function		(ArvStream *stream, ArvStreamCopyFunc copy_func,
+							 void *user_data, GDestroyNotify destroy);
 void 		arv_stream_get_n_buffers 		(ArvStream *stream,
 							 gint *n_input_buffers,
 							 gint *n_output_buffers);
 void		arv_stream_start_thread			(ArvStream *stream);
 unsigned int	arv_stream_stop_thread			(ArvStream *stream, gboolean delete_buffers);
+void		arv_stream_pause			(ArvStream *stream);
+void		arv_stream_resume			(ArvStream *stream);
+gboolean	arv_stream_is_paused			(ArvStream *stream);
 
 void		arv_stream_get_statistics		(ArvStream *stream,
 							 guint64 *n_completed_buffers,
 							 guint64 *n_failures,
 							 guint64 *n_underruns);
 
+ArvBuffer *	arv_stream_pop_input_buffer		(ArvStream *stream);
+void		arv_stream_push_output_buffer		(ArvStream *stream, ArvBuffer *buffer);
+void		arv_stream_take_init_error		(ArvStream *stream, GError *error);
+void		arv_stream_declare_info			(ArvStream *stream, const char *name, GType type, gpointer data);
+
+guint		arv_stream_get_n_infos			(ArvStream *stream);
+const char *	arv_stream_get_info_name		(ArvStream *stream, guint id);
+GType		arv_stream_get_info_type		(ArvStream *stream, guint id);
+guint64		arv_stream_get_info_uint64		(ArvStream *stream, guint id);
+double		arv_stream_get_info_double		(ArvStream *stream, guint id);
+guint64		arv_stream_get_info_uint64_by_name	(ArvStream *stream, const char *name);
+double		arv_stream_get_info_double_by_name	(ArvStream *stream, const char *name);
+
+gboolean	arv_stream_get_frame_interval_statistics	(ArvStream *stream, ArvFrameIntervalSource source,
+								 ArvFrameIntervalStatistics *statistics);
+double		arv_stream_get_clock_drift		(ArvStream *stream);
+void		arv_stream_reset_frame_interval_statistics	(ArvStream *stream);
+
+void		arv_set_stream_memory_budget		(guint64 max_bytes, ArvStreamBudgetPolicy policy);
+void		arv_get_stream_memory_budget_statistics	(ArvStreamBudgetStatistics *statistics);
+
 void 		arv_stream_set_emit_signals 		(ArvStream *stream, gboolean emit_signals);
 gboolean 	arv_stream_get_emit_signals 		(ArvStream *stream);
+int		arv_stream_get_output_fd		(ArvStream *stream);
 
 G_END_DECLS
 
@@ -0,0 +1,429 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2019 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel@gnome.org>
+ */
+
+/**
+ * SECTION: arvstreamgroup
+ * @short_description: Frame set synchronizer of several streams
+ *
+ * #ArvStreamGroup is the consumer of several streams, which matches their buffers into frame sets, one buffer per
+ * stream, delivered through a single queue. A single thread waits for the output queues of all the streams, using
+ * arv_stream_get_output_fd(), the application must not pop the buffers of the grouped streams itself.
+ *
+ * Buffers are matched by their device timestamp, their device timestamp mapped to the host clock, or their frame
+ * id, depending on the #ArvStreamGroupMatch. A set is complete when the keys of the oldest buffer of each stream
+ * are within the matching window of the newest one. Since the keys of a stream only increase, a buffer older than
+ * the newest buffer minus the window can not be part of any set: it is recycled straight back to its stream, as are
+ * the buffers which are not successfully received, and the oldest buffer of a stream having more than
+ * %ARV_STREAM_GROUP_N_PENDING_BUFFERS_MAX buffers waiting for a match.
+ *
+ * |[<!-- language="C" -->
+ * ArvStream *streams[2] = {left_stream, right_stream};
+ * ArvBuffer *buffers[2];
+ *
+ * group = arv_stream_group_new (streams, 2, ARV_STREAM_GROUP_MATCH_DEVICE_TIMESTAMP, 1000000);
+ * ...
+ * while (arv_stream_group_timeout_pop_frame_set (group, buffers, 1000000)) {
+ * 	process (buffers[0], buffers[1]);
+ * 	arv_stream_group_push_frame_set (group, buffers);
+ * }
+ * ]|
+ */
+
+#include <arvstreamgroup.h>
+#include <arvstream.h>
+#include <arvbuffer.h>
+#include <arvwakeupprivate.h>
+#include <arvrealtimeprivate.h>
+#include <arvdebugprivate.h>
+#include <string.h>
+
+/* Buffers of a stream waiting for the other streams, above which the oldest one is recycled */
+#define ARV_STREAM_GROUP_N_PENDING_BUFFERS_MAX	8
+
+/* Wakeup period of the group thread without any buffer */
+#define ARV_STREAM_GROUP_POLL_TIMEOUT_MS	100
+
+struct _ArvStreamGroup {
+	GObject object;
+
+	ArvStream **streams;
+	guint n_streams;
+	ArvStreamGroupMatch match;
+	guint64 window;
+
+	/* Buffers waiting for a match, only accessed by the group thread until it is joined */
+	GQueue *pending;
+	/* Complete frame sets, as arrays of n_streams buffers */
+	GAsyncQueue *output_queue;
+
+	GThread *thread;
+	gint cancel;
+	ArvWakeup *cancel_wakeup;
+
+	guint64 n_frame_sets;
+	guint64 n_orphaned_buffers;
+	guint64 n_failed_buffers;
+};
+
+G_DEFINE_TYPE (ArvStreamGroup, arv_stream_group, G_TYPE_OBJECT)
+
+static guint64
+_get_key (ArvStreamGroup *group, ArvBuffer *buffer)
+{
+	switch (group->match) {
+		case ARV_STREAM_GROUP_MATCH_HOST_TIMESTAMP:
+			return arv_buffer_get_host_timestamp (buffer);
+		case ARV_STREAM_GROUP_MATCH_FRAME_ID:
+			return arv_buffer_get_frame_id (buffer);
+		case ARV_STREAM_GROUP_MATCH_DEVICE_TIMESTAMP:
+		default:
+			return arv_buffer_get_timestamp (buffer);
+	}
+}
+
+static void
+_recycle_orphan (ArvStreamGroup *group, guint index, ArvBuffer *buffer)
+{
+	arv_debug_stream_thread ("[StreamGroup::recycle_orphan] Frame %" G_GUINT64_FORMAT " of stream %u not matched",
+				 arv_buffer_get_frame_id (buffer), index);
+
+	__atomic_fetch_add (&group->n_orphaned_buffers, 1, __ATOMIC_RELAXED);
+	arv_stream_push_buffer (group->streams[index], buffer);
+}
+
+static void
+_add_buffer (ArvStreamGroup *group, guint index, ArvBuffer *buffer)
+{
+	if (arv_buffer_get_status (buffer) != ARV_BUFFER_STATUS_SUCCESS) {
+		__atomic_fetch_add (&group->n_failed_buffers, 1, __ATOMIC_RELAXED);
+		arv_stream_push_buffer (group->streams[index], buffer);
+		return;
+	}
+
+	g_queue_push_tail (&group->pending[index], buffer);
+
+	if (g_queue_get_length (&group->pending[index]) > ARV_STREAM_GROUP_N_PENDING_BUFFERS_MAX)
+		_recycle_orphan (group, index, g_queue_pop_head (&group->pending[index]));
+}
+
+/* Delivers the complete frame sets, after the recycling of the oldest buffers which can't be matched anymore */
+
+static void
+_match (ArvStreamGroup *group)
+{
+	for (;;) {
+		gboolean is_complete = TRUE;
+		gboolean has_orphans = FALSE;
+		guint64 newest = 0;
+		ArvBuffer **set;
+		guint i;
+
+		for (i = 0; i < group->n_streams; i++) {
+			ArvBuffer *buffer = g_queue_peek_head (&group->pending[i]);
+
+			if (buffer != NULL)
+				newest = MAX (newest, _get_key (group, buffer));
+			else
+				is_complete = FALSE;
+		}
+
+		/* The next buffers of the stream of the newest one have a greater key */
+		for (i = 0; i < group->n_streams; i++) {
+			ArvBuffer *buffer = g_queue_peek_head (&group->pending[i]);
+
+			if (buffer != NULL && _get_key (group, buffer) + group->window < newest) {
+				_recycle_orphan (group, i, g_queue_pop_head (&group->pending[i]));
+				has_orphans = TRUE;
+			}
+		}
+
+		if (has_orphans)
+			continue;
+		if (!is_complete)
+			return;
+
+		set = g_new (ArvBuffer *, group->n_streams);
+		for (i = 0; i < group->n_streams; i++)
+			set[i] = g_queue_pop_head (&group->pending[i]);
+
+		__atomic_fetch_add (&group->n_frame_sets, 1, __ATOMIC_RELAXED);
+		g_async_queue_push (group->output_queue, set);
+	}
+}
+
+static void *
+_group_thread (void *data)
+{
+	ArvStreamGroup *group = data;
+	GPollFD *poll_fds;
+	guint i;
+
+	arv_apply_internal_thread_scheduling (ARV_INTERNAL_THREAD_STREAM);
+
+	poll_fds = g_new0 (GPollFD, group->n_streams + 1);
+	for (i = 0; i < group->n_streams; i++) {
+		poll_fds[i].fd = arv_stream_get_output_fd (group->streams[i]);
+		poll_fds[i].events = G_IO_IN;
+	}
+	arv_wakeup_get_pollfd (group->cancel_wakeup, &poll_fds[group->n_streams]);
+
+	while (!g_atomic_int_get (&group->cancel)) {
+		g_poll (poll_fds, group->n_streams + 1, ARV_STREAM_GROUP_POLL_TIMEOUT_MS);
+
+		for (i = 0; i < group->n_streams; i++) {
+			ArvBuffer *buffer;
+
+			while ((buffer = arv_stream_try_pop_buffer (group->streams[i])) != NULL)
+				_add_buffer (group, i, buffer);
+		}
+
+		_match (group);
+	}
+
+	g_free (poll_fds);
+
+	return NULL;
+}
+
+/**
+ * arv_stream_group_new:
+ * @streams: (array length=n_streams): the grouped streams
+ * @n_streams: number of streams, at least 1
+ * @match: key of the matching
+ * @window: maximum difference between the keys of the buffers of a set, in ns for the timestamps, 0 for an exact
+ * frame id match
+ *
+ * Creates a frame set synchronizer of @streams, which becomes the consumer of their output queues.
+ *
+ * Returns: a new #ArvStreamGroup
+ *
+ * Since: 0.8.11
+ */
+
+ArvStreamGroup *
+arv_stream_group_new (ArvStream **streams, guint n_streams, ArvStreamGroupMatch match, guint64 window)
+{
+	ArvStreamGroup *group;
+	guint i;
+
+	g_return_val_if_fail (streams != NULL, NULL);
+	g_return_val_if_fail (n_streams > 0, NULL);
+
+	for (i = 0; i < n_streams; i++)
+		g_return_val_if_fail (ARV_IS_STREAM (streams[i]), NULL);
+
+	group = g_object_new (ARV_TYPE_STREAM_GROUP, NULL);
+	group->n_streams = n_streams;
+	group->match = match;
+	group->window = window;
+	group->streams = g_new (ArvStream *, n_streams);
+	group->pending = g_new0 (GQueue, n_streams);
+	for (i = 0; i < n_streams; i++) {
+		group->streams[i] = g_object_ref (streams[i]);
+		g_queue_init (&group->pending[i]);
+	}
+
+	group->thread = g_thread_new ("arv_stream_group", _group_thread, group);
+
+	return group;
+}
+
+/**
+ * arv_stream_group_get_n_streams:
+ * @group: a #ArvStreamGroup
+ *
+ * Returns: the number of buffers of a frame set
+ *
+ * Since: 0.8.11
+ */
+
+guint
+arv_stream_group_get_n_streams (ArvStreamGroup *group)
+{
+	g_return_val_if_fail (ARV_IS_STREAM_GROUP (group), 0);
+
+	return group->n_streams;
+}
+
+/**
+ * arv_stream_group_timeout_pop_frame_set:
+ * @group: a #ArvStreamGroup
+ * @buffers: (array) (out caller-allocates) (transfer full): placeholder for arv_stream_group_get_n_streams() buffers
+ * @timeout: timeout, in µs
+ *
+ * Pops the oldest complete frame set, waiting no more than @timeout. The buffers are stored in the order of the
+ * streams given to arv_stream_group_new(), and must be given back using arv_stream_group_push_frame_set(), or
+ * pushed back to their streams.
+ *
+ * This method is thread safe.
+ *
+ * Returns: %TRUE if a frame set was popped, %FALSE on timeout
+ *
+ * Since: 0.8.11
+ */
+
+gboolean
+arv_stream_group_timeout_pop_frame_set (ArvStreamGroup *group, ArvBuffer **buffers, guint64 timeout)
+{
+	ArvBuffer **set;
+
+	g_return_val_if_fail (ARV_IS_STREAM_GROUP (group), FALSE);
+	g_return_val_if_fail (buffers != NULL, FALSE);
+
+	set = g_async_queue_timeout_pop (group->output_queue, timeout);
+	if (set == NULL)
+		return FALSE;
+
+	memcpy (buffers, set, group->n_streams * sizeof (ArvBuffer *));
+	g_free (set);
+
+	return TRUE;
+}
+
+/**
+ * arv_stream_group_push_frame_set:
+ * @group: a #ArvStreamGroup
+ * @buffers: (array) (transfer full): arv_stream_group_get_n_streams() buffers, %NULL entries being ignored
+ *
+ * Gives the buffers of a frame set back to their streams.
+ *
+ * This method is thread safe.
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_stream_group_push_frame_set (ArvStreamGroup *group, ArvBuffer **buffers)
+{
+	guint i;
+
+	g_return_if_fail (ARV_IS_STREAM_GROUP (group));
+	g_return_if_fail (buffers != NULL);
+
+	for (i = 0; i < group->n_streams; i++)
+		if (buffers[i] != NULL)
+			arv_stream_push_buffer (group->streams[i], buffers[i]);
+}
+
+/**
+ * arv_stream_group_get_n_frame_sets:
+ * @group: a #ArvStreamGroup
+ *
+ * Returns: the number of complete frame sets
+ *
+ * Since: 0.8.11
+ */
+
+guint64
+arv_stream_group_get_n_frame_sets (ArvStreamGroup *group)
+{
+	g_return_val_if_fail (ARV_IS_STREAM_GROUP (group), 0);
+
+	return __atomic_load_n (&group->n_frame_sets, __ATOMIC_RELAXED);
+}
+
+/**
+ * arv_stream_group_get_n_orphaned_buffers:
+ * @group: a #ArvStreamGroup
+ *
+ * Returns: the number of successfully received buffers recycled without a match
+ *
+ * Since: 0.8.11
+ */
+
+guint64
+arv_stream_group_get_n_orphaned_buffers (ArvStreamGroup *group)
+{
+	g_return_val_if_fail (ARV_IS_STREAM_GROUP (group), 0);
+
+	return __atomic_load_n (&group->n_orphaned_buffers, __ATOMIC_RELAXED);
+}
+
+/**
+ * arv_stream_group_get_n_failed_buffers:
+ * @group: a #ArvStreamGroup
+ *
+ * Returns: the number of buffers recycled because they were not successfully received
+ *
+ * Since: 0.8.11
+ */
+
+guint64
+arv_stream_group_get_n_failed_buffers (ArvStreamGroup *group)
+{
+	g_return_val_if_fail (ARV_IS_STREAM_GROUP (group), 0);
+
+	return __atomic_load_n (&group->n_failed_buffers, __ATOMIC_RELAXED);
+}
+
+static void
+arv_stream_group_init (ArvStreamGroup *group)
+{
+	group->output_queue = g_async_queue_new ();
+	group->cancel_wakeup = arv_wakeup_new ();
+}
+
+static void
+arv_stream_group_finalize (GObject *object)
+{
+	ArvStreamGroup *group = ARV_STREAM_GROUP (object);
+	ArvBuffer **set;
+	ArvBuffer *buffer;
+	guint i;
+
+	if (group->thread != NULL) {
+		g_atomic_int_set (&group->cancel, TRUE);
+		arv_wakeup_signal (group->cancel_wakeup);
+		g_thread_join (group->thread);
+		group->thread = NULL;
+	}
+
+	while ((set = g_async_queue_try_pop (group->output_queue)) != NULL) {
+		arv_stream_group_push_frame_set (group, set);
+		g_free (set);
+	}
+
+	for (i = 0; i < group->n_streams; i++) {
+		while ((buffer = g_queue_pop_head (&group->pending[i])) != NULL)
+			arv_stream_push_buffer (group->streams[i], buffer);
+		g_object_unref (group->streams[i]);
+	}
+
+	arv_info_stream ("[StreamGroup::finalize] %" G_GUINT64_FORMAT " frame set[s], %" G_GUINT64_FORMAT
+			 " orphaned buffer[s], %" G_GUINT64_FORMAT " failed buffer[s]",
+			 group->n_frame_sets, group->n_orphaned_buffers, group->n_failed_buffers);
+
+	g_clear_pointer (&group->streams, g_free);
+	g_clear_pointer (&group->pending, g_free);
+	g_clear_pointer (&group->output_queue, g_async_queue_unref);
+	g_clear_pointer (&group->cancel_wakeup, arv_wakeup_free);
+
+	G_OBJECT_CLASS (arv_stream_group_parent_class)->finalize (object);
+}
+
+static void
+arv_stream_group_class_init (ArvStreamGroupClass *group_class)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS (group_class);
+
+	object_class->finalize = arv_stream_group_finalize;
+}
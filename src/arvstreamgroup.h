@@ -0,0 +1,72 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2019 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel@gnome.org>
+ */
+
+#ifndef ARV_STREAM_GROUP_H
+#define ARV_STREAM_GROUP_H
+
+#if !defined (ARV_H_INSIDE) && !defined (ARAVIS_COMPILATION)
+#error "Only <arv.h> can be included directly."
+#endif
+
+#include <arvtypes.h>
+#include <arvbuffer.h>
+
+G_BEGIN_DECLS
+
+/**
+ * ArvStreamGroupMatch:
+ * @ARV_STREAM_GROUP_MATCH_DEVICE_TIMESTAMP: buffers are matched by their device timestamp, for devices sharing a
+ * common time base, like PTP synchronized cameras
+ * @ARV_STREAM_GROUP_MATCH_HOST_TIMESTAMP: buffers are matched by their device timestamp mapped to the host clock
+ * (see arv_buffer_get_host_timestamp())
+ * @ARV_STREAM_GROUP_MATCH_FRAME_ID: buffers are matched by their frame id, for devices triggered by a common signal
+ *
+ * Key used by #ArvStreamGroup for the frame set matching.
+ *
+ * Since: 0.8.11
+ */
+
+typedef enum {
+	ARV_STREAM_GROUP_MATCH_DEVICE_TIMESTAMP,
+	ARV_STREAM_GROUP_MATCH_HOST_TIMESTAMP,
+	ARV_STREAM_GROUP_MATCH_FRAME_ID
+} ArvStreamGroupMatch;
+
+#define ARV_TYPE_STREAM_GROUP             (arv_stream_group_get_type ())
+G_DECLARE_FINAL_TYPE (ArvStreamGroup, arv_stream_group, ARV, STREAM_GROUP, GObject)
+
+ArvStreamGroup *	arv_stream_group_new			(ArvStream **streams, guint n_streams,
+								 ArvStreamGroupMatch match, guint64 window);
+
+guint			arv_stream_group_get_n_streams		(ArvStreamGroup *group);
+
+gboolean		arv_stream_group_timeout_pop_frame_set	(ArvStreamGroup *group, ArvBuffer **buffers,
+								 guint64 timeout);
+void			arv_stream_group_push_frame_set		(ArvStreamGroup *group, ArvBuffer **buffers);
+
+guint64			arv_stream_group_get_n_frame_sets	(ArvStreamGroup *group);
+guint64			arv_stream_group_get_n_orphaned_buffers	(ArvStreamGroup *group);
+guint64			arv_stream_group_get_n_failed_buffers	(ArvStreamGroup *group);
+
+G_END_DECLS
+
+#endif
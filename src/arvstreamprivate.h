@@ -28,12 +28,26 @@
 #endif
 
 #include <arvstream.h>
+#include <arvmiscprivate.h>
+#include <arveventringprivate.h>
+#include <arvframelogprivate.h>
 
 G_BEGIN_DECLS
 
-ArvBuffer *	arv_stream_pop_input_buffer		(ArvStream *stream);
-void		arv_stream_push_output_buffer		(ArvStream *stream, ArvBuffer *buffer);
-void		arv_stream_take_init_error		(ArvStream *device, GError *error);
+void		arv_stream_apply_thread_placement	(ArvStream *stream);
+void		arv_stream_update_thread_placement	(ArvStream *stream);
+void		arv_stream_prepare_acquisition		(ArvStream *stream);
+void		arv_stream_update_ready_region		(ArvStream *stream, ArvBuffer *buffer, size_t ready_size);
+ArvEventRing *	arv_stream_get_event_ring		(ArvStream *stream);
+ArvFrameLog *	arv_stream_get_frame_log		(ArvStream *stream);
+ArvStreamCopyFunc	arv_stream_get_copy_function	(ArvStream *stream, void **user_data);
+gboolean	arv_stream_is_checksum_enabled		(ArvStream *stream);
+guint		arv_stream_get_n_pauses			(ArvStream *stream);
+void		arv_stream_declare_statistic		(ArvStream *stream, const char *name,
+							 const ArvStatistic *statistic, guint histogram_id);
+guint		arv_stream_get_n_statistics		(ArvStream *stream);
+const ArvStatistic *	arv_stream_get_statistic	(ArvStream *stream, guint id, const char **name,
+							 guint *histogram_id);
 
 G_END_DECLS
 
@@ -0,0 +1,462 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2019 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel@gnome.org>
+ */
+
+
+/**
+ * SECTION: arvstreampublisher
+ * @short_description: Shared memory stream fan-out
+ *
+ * #ArvStreamPublisher shares the completed buffers of a stream with the other processes of the host. The buffers are
+ * copied into a ring of slots of a memory file, mapped read-only by the #ArvStreamSubscriber instances, which are
+ * notified of the new frames through a futex of the shared memory. The cost of the publication is a single copy of
+ * each frame, whatever the number of subscribers.
+ *
+ * The slots are reference counted. A slot referenced by a subscriber is not overwritten, the publisher uses the next
+ * free one, and the frame is dropped if all the slots are referenced. The subscribers find the publisher by its name,
+ * through an abstract unix socket.
+ *
+ * |[<!-- language="C" -->
+ * publisher = arv_stream_publisher_new ("camera_1", 8, arv_camera_get_payload (camera, NULL), &error);
+ *
+ * buffer = arv_stream_pop_buffer (stream);
+ * if (arv_buffer_get_status (buffer) == ARV_BUFFER_STATUS_SUCCESS)
+ *	arv_stream_publisher_publish (publisher, buffer);
+ * arv_stream_push_buffer (stream, buffer);
+ * ]|
+ */
+
+#define _GNU_SOURCE
+
+#include <arvstreampublisher.h>
+#include <arvsharedstreamprivate.h>
+#include <arvbufferprivate.h>
+#include <arvdebugprivate.h>
+#include <gio/gio.h>
+#include <string.h>
+#include <stddef.h>
+#if ARAVIS_HAS_SHARED_STREAM
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <fcntl.h>
+#include <errno.h>
+#endif
+
+struct _ArvStreamPublisher {
+	GObject object;
+
+	char *name;
+
+	int fd;
+	ArvSharedStreamHeader *header;
+	size_t mapped_size;
+	guint slot_index;
+
+	GSocket *listener;
+	GCancellable *cancellable;
+	GThread *thread;
+
+	GMutex mutex;
+};
+
+G_DEFINE_TYPE (ArvStreamPublisher, arv_stream_publisher, G_TYPE_OBJECT)
+
+#if ARAVIS_HAS_SHARED_STREAM
+
+/* Hands the memory file to a subscriber */
+
+static void
+_serve_subscriber (ArvStreamPublisher *publisher, GSocket *connection)
+{
+	struct msghdr message = {0};
+	struct cmsghdr *control_message;
+	struct iovec vector;
+	char control[CMSG_SPACE (sizeof (int))];
+	guint32 magic = ARV_SHARED_STREAM_MAGIC;
+
+	memset (control, 0, sizeof (control));
+
+	vector.iov_base = &magic;
+	vector.iov_len = sizeof (magic);
+	message.msg_iov = &vector;
+	message.msg_iovlen = 1;
+	message.msg_control = control;
+	message.msg_controllen = sizeof (control);
+
+	control_message = CMSG_FIRSTHDR (&message);
+	control_message->cmsg_level = SOL_SOCKET;
+	control_message->cmsg_type = SCM_RIGHTS;
+	control_message->cmsg_len = CMSG_LEN (sizeof (int));
+	memcpy (CMSG_DATA (control_message), &publisher->fd, sizeof (int));
+
+	if (sendmsg (g_socket_get_fd (connection), &message, MSG_NOSIGNAL) < 0)
+		arv_warning_stream ("[StreamPublisher::serve_subscriber] Failed to send the memory file: %s",
+				    strerror (errno));
+	else
+		arv_info_stream ("[StreamPublisher::serve_subscriber] New subscriber on '%s'", publisher->name);
+}
+
+static void *
+_publisher_thread (void *data)
+{
+	ArvStreamPublisher *publisher = data;
+
+	while (!g_cancellable_is_cancelled (publisher->cancellable)) {
+		GSocket *connection;
+		GError *error = NULL;
+
+		connection = g_socket_accept (publisher->listener, publisher->cancellable, &error);
+		if (connection == NULL) {
+			if (!g_error_matches (error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+				arv_warning_stream ("[StreamPublisher::thread] Accept error: %s", error->message);
+			g_clear_error (&error);
+			continue;
+		}
+
+		_serve_subscriber (publisher, connection);
+
+		g_object_unref (connection);
+	}
+
+	return NULL;
+}
+
+static GSocket *
+_listen (const char *name, GError **error)
+{
+	struct sockaddr_un address = {0};
+	GSocket *listener;
+	char *path;
+	size_t length;
+	int fd;
+
+	path = g_strdup_printf ("%s%s", ARV_SHARED_STREAM_SOCKET_PREFIX, name);
+	length = strlen (path);
+	if (length + 1 > sizeof (address.sun_path)) {
+		g_set_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT, "Stream name '%s' too long", name);
+		g_free (path);
+		return NULL;
+	}
+
+	/* Abstract socket, the first byte of the path is null */
+	address.sun_family = AF_UNIX;
+	memcpy (address.sun_path + 1, path, length);
+	g_free (path);
+
+	fd = socket (AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if (fd < 0 ||
+	    bind (fd, (struct sockaddr *) &address, offsetof (struct sockaddr_un, sun_path) + 1 + length) != 0 ||
+	    listen (fd, 16) != 0) {
+		int errsv = errno;
+
+		if (fd >= 0)
+			close (fd);
+		g_set_error (error, G_IO_ERROR, g_io_error_from_errno (errsv),
+			     "Failed to create the socket of stream '%s': %s", name, strerror (errsv));
+		return NULL;
+	}
+
+	listener = g_socket_new_from_fd (fd, error);
+	if (listener == NULL)
+		close (fd);
+
+	return listener;
+}
+
+#endif
+
+/**
+ * arv_stream_publisher_publish:
+ * @publisher: a #ArvStreamPublisher
+ * @buffer: a completed #ArvBuffer
+ *
+ * Copies the received data of @buffer into the next free slot, along with its status, frame id, timestamps and image
+ * informations, and notifies the subscribers. The multipart payloads are published as a single image, the
+ * subscribers only get the informations of the first part. @buffer is not referenced, it can be pushed back to its
+ * stream on return.
+ *
+ * Returns: %TRUE if the frame was published, %FALSE if it was dropped, because it is larger than the slots, because
+ * it has more than 16 parts, or because all the slots are referenced by subscribers.
+ *
+ * Since: 0.8.11
+ */
+
+gboolean
+arv_stream_publisher_publish (ArvStreamPublisher *publisher, ArvBuffer *buffer)
+{
+#if ARAVIS_HAS_SHARED_STREAM
+	ArvSharedStreamHeader *header;
+	ArvSharedStreamSlot *slot = NULL;
+	size_t size;
+	guint i;
+
+	g_return_val_if_fail (ARV_IS_STREAM_PUBLISHER (publisher), FALSE);
+	g_return_val_if_fail (ARV_IS_BUFFER (buffer), FALSE);
+
+	header = publisher->header;
+	size = MIN (buffer->priv->received_size, buffer->priv->size);
+
+	g_mutex_lock (&publisher->mutex);
+
+	if (size > header->slot_size) {
+		arv_warning_stream ("[StreamPublisher::publish] Frame of %zu bytes larger than the slots (%" G_GUINT64_FORMAT
+				    ")", size, header->slot_size);
+		header->n_dropped++;
+		g_mutex_unlock (&publisher->mutex);
+		return FALSE;
+	}
+
+	if (buffer->priv->n_parts > ARV_SHARED_STREAM_N_PARTS_MAX) {
+		arv_warning_stream ("[StreamPublisher::publish] Frame of %u parts, more than %u", buffer->priv->n_parts,
+				    ARV_SHARED_STREAM_N_PARTS_MAX);
+		header->n_dropped++;
+		g_mutex_unlock (&publisher->mutex);
+		return FALSE;
+	}
+
+	/* The slots are used in turn, which overwrites the oldest frame first */
+	for (i = 0; i < header->n_slots && slot == NULL; i++) {
+		guint index = (publisher->slot_index + i) % header->n_slots;
+
+		if (g_atomic_int_compare_and_exchange (&header->slots[index].refcount, 0, -1)) {
+			slot = &header->slots[index];
+			publisher->slot_index = (index + 1) % header->n_slots;
+		}
+	}
+
+	if (slot == NULL) {
+		arv_info_stream ("[StreamPublisher::publish] All slots referenced, frame %" G_GUINT64_FORMAT
+				 " dropped", buffer->priv->frame_id);
+		header->n_dropped++;
+		g_mutex_unlock (&publisher->mutex);
+		return FALSE;
+	}
+
+	memcpy ((char *) header + header->data_offset + (slot - header->slots) * header->slot_size,
+		buffer->priv->data, size);
+
+	slot->status = buffer->priv->status;
+	slot->frame_id = buffer->priv->frame_id;
+	slot->timestamp_ns = buffer->priv->timestamp_ns;
+	slot->system_timestamp_ns = buffer->priv->system_timestamp_ns;
+	slot->size = size;
+	slot->payload_type = buffer->priv->payload_type;
+	slot->pixel_format = buffer->priv->pixel_format;
+	slot->width = buffer->priv->width;
+	slot->height = buffer->priv->height;
+	slot->x_offset = buffer->priv->x_offset;
+	slot->y_offset = buffer->priv->y_offset;
+	slot->chunk_endianness = buffer->priv->chunk_endianness;
+	slot->n_parts = buffer->priv->n_parts;
+	for (i = 0; i < slot->n_parts; i++) {
+		const ArvBufferPart *part = &buffer->priv->parts[i];
+
+		slot->parts[i].data_offset = part->data_offset;
+		slot->parts[i].size = part->size;
+		slot->parts[i].data_type = part->data_type;
+		slot->parts[i].pixel_format = part->pixel_format;
+		slot->parts[i].x_offset = part->x_offset;
+		slot->parts[i].y_offset = part->y_offset;
+		slot->parts[i].width = part->width;
+		slot->parts[i].height = part->height;
+	}
+	slot->frame_index = ++header->n_published;
+
+	g_atomic_int_set (&slot->refcount, 0);
+
+	g_mutex_unlock (&publisher->mutex);
+
+	arv_shared_stream_wake (header);
+
+	return TRUE;
+#else
+	return FALSE;
+#endif
+}
+
+/**
+ * arv_stream_publisher_get_statistics:
+ * @publisher: a #ArvStreamPublisher
+ * @n_published: (out) (optional): number of published frames
+ * @n_dropped: (out) (optional): number of frames dropped for lack of free slot
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_stream_publisher_get_statistics (ArvStreamPublisher *publisher, guint64 *n_published, guint64 *n_dropped)
+{
+	g_return_if_fail (ARV_IS_STREAM_PUBLISHER (publisher));
+
+	g_mutex_lock (&publisher->mutex);
+	if (n_published != NULL)
+		*n_published = publisher->header != NULL ? publisher->header->n_published : 0;
+	if (n_dropped != NULL)
+		*n_dropped = publisher->header != NULL ? publisher->header->n_dropped : 0;
+	g_mutex_unlock (&publisher->mutex);
+}
+
+/**
+ * arv_stream_publisher_get_name:
+ * @publisher: a #ArvStreamPublisher
+ *
+ * Returns: the name of the shared stream, to be given to arv_stream_subscriber_new()
+ *
+ * Since: 0.8.11
+ */
+
+const char *
+arv_stream_publisher_get_name (ArvStreamPublisher *publisher)
+{
+	g_return_val_if_fail (ARV_IS_STREAM_PUBLISHER (publisher), NULL);
+
+	return publisher->name;
+}
+
+/**
+ * arv_stream_publisher_new:
+ * @name: name of the shared stream, unique on the host
+ * @n_slots: number of frame slots of the ring
+ * @slot_size: maximum frame size, usually the payload size of the camera
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Creates the memory file of the shared stream, and starts handing it to the subscribers connecting with @name,
+ * from a dedicated thread. A subscriber referencing a slot forever, for example because it crashed while holding a
+ * buffer, reduces the capacity of the ring. The number of slots should be higher than the number of buffers held at
+ * the same time by the subscribers.
+ *
+ * Returns: (transfer full): a new #ArvStreamPublisher, %NULL on error, or if the shared streams are not supported
+ * on this platform (see %ARAVIS_HAS_SHARED_STREAM).
+ *
+ * Since: 0.8.11
+ */
+
+ArvStreamPublisher *
+arv_stream_publisher_new (const char *name, guint n_slots, size_t slot_size, GError **error)
+{
+#if ARAVIS_HAS_SHARED_STREAM
+	ArvStreamPublisher *publisher;
+	ArvSharedStreamHeader *header;
+	size_t page_size = sysconf (_SC_PAGESIZE);
+	size_t data_offset;
+	size_t mapped_size;
+	void *data;
+	int fd;
+
+	g_return_val_if_fail (name != NULL && name[0] != '\0', NULL);
+	g_return_val_if_fail (n_slots > 0 && n_slots <= ARV_SHARED_STREAM_N_SLOTS_MAX, NULL);
+	g_return_val_if_fail (slot_size > 0, NULL);
+
+	slot_size = (slot_size + page_size - 1) / page_size * page_size;
+	data_offset = sizeof (ArvSharedStreamHeader) + n_slots * sizeof (ArvSharedStreamSlot);
+	data_offset = (data_offset + page_size - 1) / page_size * page_size;
+	mapped_size = data_offset + n_slots * slot_size;
+
+	fd = memfd_create ("arv-shared-stream", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+	if (fd < 0 || ftruncate (fd, mapped_size) != 0 ||
+	    (data = mmap (NULL, mapped_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)) == MAP_FAILED) {
+		int errsv = errno;
+
+		if (fd >= 0)
+			close (fd);
+		g_set_error (error, G_IO_ERROR, g_io_error_from_errno (errsv),
+			     "Failed to create the memory file of stream '%s': %s", name, strerror (errsv));
+		return NULL;
+	}
+
+	/* The subscribers can not resize the file under the other processes */
+	fcntl (fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL);
+
+	header = data;
+	header->magic = ARV_SHARED_STREAM_MAGIC;
+	header->version = ARV_SHARED_STREAM_VERSION;
+	header->n_slots = n_slots;
+	header->slot_size = slot_size;
+	header->data_offset = data_offset;
+
+	publisher = g_object_new (ARV_TYPE_STREAM_PUBLISHER, NULL);
+	publisher->name = g_strdup (name);
+	publisher->fd = fd;
+	publisher->header = header;
+	publisher->mapped_size = mapped_size;
+
+	publisher->listener = _listen (name, error);
+	if (publisher->listener == NULL) {
+		g_object_unref (publisher);
+		return NULL;
+	}
+
+	publisher->thread = g_thread_new ("arv_publisher", _publisher_thread, publisher);
+
+	arv_info_stream ("[StreamPublisher::new] Publish '%s', %u slots of %zu bytes", name, n_slots, slot_size);
+
+	return publisher;
+#else
+	g_set_error (error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED, "Shared streams not supported");
+	return NULL;
+#endif
+}
+
+static void
+arv_stream_publisher_init (ArvStreamPublisher *publisher)
+{
+	publisher->fd = -1;
+	publisher->cancellable = g_cancellable_new ();
+	g_mutex_init (&publisher->mutex);
+}
+
+static void
+arv_stream_publisher_finalize (GObject *object)
+{
+	ArvStreamPublisher *publisher = ARV_STREAM_PUBLISHER (object);
+
+	g_cancellable_cancel (publisher->cancellable);
+	if (publisher->thread != NULL)
+		g_thread_join (publisher->thread);
+
+	g_clear_object (&publisher->listener);
+	g_clear_object (&publisher->cancellable);
+
+#if ARAVIS_HAS_SHARED_STREAM
+	if (publisher->header != NULL) {
+		/* The mapping of the subscribers stays valid, they only see the end of the stream */
+		g_atomic_int_set ((gint *) &publisher->header->is_closed, 1);
+		arv_shared_stream_wake (publisher->header);
+		munmap (publisher->header, publisher->mapped_size);
+	}
+	if (publisher->fd >= 0)
+		close (publisher->fd);
+#endif
+
+	g_clear_pointer (&publisher->name, g_free);
+	g_mutex_clear (&publisher->mutex);
+
+	G_OBJECT_CLASS (arv_stream_publisher_parent_class)->finalize (object);
+}
+
+static void
+arv_stream_publisher_class_init (ArvStreamPublisherClass *publisher_class)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS (publisher_class);
+
+	object_class->finalize = arv_stream_publisher_finalize;
+}
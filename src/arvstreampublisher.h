@@ -0,0 +1,49 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2019 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel@gnome.org>
+ */
+
+#ifndef ARV_STREAM_PUBLISHER_H
+#define ARV_STREAM_PUBLISHER_H
+
+#if !defined (ARV_H_INSIDE) && !defined (ARAVIS_COMPILATION)
+#error "Only <arv.h> can be included directly."
+#endif
+
+#include <arvtypes.h>
+#include <arvbuffer.h>
+
+G_BEGIN_DECLS
+
+#define ARV_TYPE_STREAM_PUBLISHER             (arv_stream_publisher_get_type ())
+G_DECLARE_FINAL_TYPE (ArvStreamPublisher, arv_stream_publisher, ARV, STREAM_PUBLISHER, GObject)
+
+ArvStreamPublisher *	arv_stream_publisher_new		(const char *name, guint n_slots, size_t slot_size,
+								 GError **error);
+
+gboolean		arv_stream_publisher_publish		(ArvStreamPublisher *publisher, ArvBuffer *buffer);
+
+const char *		arv_stream_publisher_get_name		(ArvStreamPublisher *publisher);
+void			arv_stream_publisher_get_statistics	(ArvStreamPublisher *publisher, guint64 *n_published,
+								 guint64 *n_dropped);
+
+G_END_DECLS
+
+#endif
@@ -0,0 +1,474 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2019 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel@gnome.org>
+ */
+
+
+/**
+ * SECTION: arvstreamsubscriber
+ * @short_description: Shared memory stream consumer
+ *
+ * #ArvStreamSubscriber gives access to the frames of a #ArvStreamPublisher, typically run by another process. The
+ * buffers point to the read-only mapping of the publisher ring, without any copy. Each returned buffer references
+ * its slot, which is not overwritten by the publisher until the buffer is destroyed. The buffer data must not be
+ * modified.
+ *
+ * The frames are returned in the publication order, starting from the first frame published after the subscriber
+ * creation. The frames overwritten before the subscriber got them are counted as missed.
+ *
+ * |[<!-- language="C" -->
+ * subscriber = arv_stream_subscriber_new ("camera_1", &error);
+ *
+ * buffer = arv_stream_subscriber_timeout_pop_buffer (subscriber, 1000000);
+ * if (buffer != NULL) {
+ *	process (arv_buffer_get_data (buffer, &size), size);
+ *	g_object_unref (buffer);
+ * }
+ * ]|
+ */
+
+#define _GNU_SOURCE
+
+#include <arvstreamsubscriber.h>
+#include <arvsharedstreamprivate.h>
+#include <arvbufferprivate.h>
+#include <arvdebugprivate.h>
+#include <gio/gio.h>
+#include <string.h>
+#include <stddef.h>
+#if ARAVIS_HAS_SHARED_STREAM
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <errno.h>
+#endif
+
+#define ARV_STREAM_SUBSCRIBER_CONNECT_TIMEOUT_MS	1000
+
+struct _ArvStreamSubscriber {
+	GObject object;
+
+	ArvSharedStreamHeader *header;
+	size_t control_size;
+	const guint8 *data;
+	size_t data_size;
+
+	guint64 last_frame_index;
+	guint64 n_missed_frames;
+
+	GMutex mutex;
+};
+
+G_DEFINE_TYPE (ArvStreamSubscriber, arv_stream_subscriber, G_TYPE_OBJECT)
+
+#if ARAVIS_HAS_SHARED_STREAM
+
+typedef struct {
+	ArvStreamSubscriber *subscriber;
+	ArvSharedStreamSlot *slot;
+} ArvStreamSubscriberReference;
+
+static void
+_release_slot (void *data)
+{
+	ArvStreamSubscriberReference *reference = data;
+
+	g_atomic_int_add (&reference->slot->refcount, -1);
+	g_object_unref (reference->subscriber);
+	g_free (reference);
+}
+
+/* References the slot, if it is not being written by the publisher */
+
+static gboolean
+_reference_slot (ArvSharedStreamSlot *slot)
+{
+	gint refcount;
+
+	do {
+		refcount = g_atomic_int_get (&slot->refcount);
+		if (refcount < 0)
+			return FALSE;
+	} while (!g_atomic_int_compare_and_exchange (&slot->refcount, refcount, refcount + 1));
+
+	return TRUE;
+}
+
+/* Returns the oldest frame published after the last returned one. The frame index of a slot may change before it is
+ * referenced, it is checked again after. */
+
+static ArvBuffer *
+_acquire_next_buffer (ArvStreamSubscriber *subscriber)
+{
+	ArvSharedStreamHeader *header = subscriber->header;
+	unsigned int n_tries;
+
+	for (n_tries = 0; n_tries < header->n_slots; n_tries++) {
+		ArvStreamSubscriberReference *reference;
+		ArvSharedStreamSlot *slot = NULL;
+		ArvBuffer *buffer;
+		guint64 frame_index = G_MAXUINT64;
+		guint i;
+
+		for (i = 0; i < header->n_slots; i++) {
+			guint64 slot_frame_index = header->slots[i].frame_index;
+
+			if (g_atomic_int_get (&header->slots[i].refcount) >= 0 &&
+			    slot_frame_index > subscriber->last_frame_index &&
+			    slot_frame_index < frame_index) {
+				frame_index = slot_frame_index;
+				slot = &header->slots[i];
+			}
+		}
+
+		if (slot == NULL)
+			return NULL;
+
+		if (!_reference_slot (slot))
+			continue;
+
+		if (slot->frame_index != frame_index) {
+			g_atomic_int_add (&slot->refcount, -1);
+			continue;
+		}
+
+		subscriber->n_missed_frames += frame_index - subscriber->last_frame_index - 1;
+		subscriber->last_frame_index = frame_index;
+
+		reference = g_new (ArvStreamSubscriberReference, 1);
+		reference->subscriber = g_object_ref (subscriber);
+		reference->slot = slot;
+
+		buffer = arv_buffer_new_full (MIN (slot->size, header->slot_size),
+					      (void *) (subscriber->data + (slot - header->slots) * header->slot_size),
+					      reference, _release_slot);
+
+		buffer->priv->status = slot->status;
+		buffer->priv->frame_id = slot->frame_id;
+		buffer->priv->timestamp_ns = slot->timestamp_ns;
+		buffer->priv->system_timestamp_ns = slot->system_timestamp_ns;
+		buffer->priv->payload_type = slot->payload_type;
+		buffer->priv->pixel_format = slot->pixel_format;
+		buffer->priv->width = slot->width;
+		buffer->priv->height = slot->height;
+		buffer->priv->x_offset = slot->x_offset;
+		buffer->priv->y_offset = slot->y_offset;
+		buffer->priv->chunk_endianness = slot->chunk_endianness;
+
+		arv_buffer_set_n_parts (buffer, MIN (slot->n_parts, ARV_SHARED_STREAM_N_PARTS_MAX));
+		for (i = 0; i < buffer->priv->n_parts; i++) {
+			ArvBufferPart *part = &buffer->priv->parts[i];
+
+			part->data_offset = slot->parts[i].data_offset;
+			part->size = slot->parts[i].size;
+			part->data_type = slot->parts[i].data_type;
+			part->pixel_format = slot->parts[i].pixel_format;
+			part->x_offset = slot->parts[i].x_offset;
+			part->y_offset = slot->parts[i].y_offset;
+			part->width = slot->parts[i].width;
+			part->height = slot->parts[i].height;
+		}
+
+		return buffer;
+	}
+
+	return NULL;
+}
+
+static int
+_connect (const char *name, GError **error)
+{
+	struct sockaddr_un address = {0};
+	struct msghdr message = {0};
+	struct cmsghdr *control_message;
+	struct iovec vector;
+	struct timeval timeout;
+	char control[CMSG_SPACE (sizeof (int))];
+	guint32 magic = 0;
+	char *path;
+	size_t length;
+	int memory_fd = -1;
+	int fd;
+
+	path = g_strdup_printf ("%s%s", ARV_SHARED_STREAM_SOCKET_PREFIX, name);
+	length = strlen (path);
+	if (length + 1 > sizeof (address.sun_path)) {
+		g_set_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT, "Stream name '%s' too long", name);
+		g_free (path);
+		return -1;
+	}
+
+	address.sun_family = AF_UNIX;
+	memcpy (address.sun_path + 1, path, length);
+	g_free (path);
+
+	timeout.tv_sec = ARV_STREAM_SUBSCRIBER_CONNECT_TIMEOUT_MS / 1000;
+	timeout.tv_usec = (ARV_STREAM_SUBSCRIBER_CONNECT_TIMEOUT_MS % 1000) * 1000;
+
+	fd = socket (AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if (fd < 0 ||
+	    setsockopt (fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof (timeout)) != 0 ||
+	    connect (fd, (struct sockaddr *) &address, offsetof (struct sockaddr_un, sun_path) + 1 + length) != 0) {
+		int errsv = errno;
+
+		if (fd >= 0)
+			close (fd);
+		g_set_error (error, G_IO_ERROR, g_io_error_from_errno (errsv),
+			     "Failed to connect to stream '%s': %s", name, strerror (errsv));
+		return -1;
+	}
+
+	memset (control, 0, sizeof (control));
+	vector.iov_base = &magic;
+	vector.iov_len = sizeof (magic);
+	message.msg_iov = &vector;
+	message.msg_iovlen = 1;
+	message.msg_control = control;
+	message.msg_controllen = sizeof (control);
+
+	if (recvmsg (fd, &message, MSG_CMSG_CLOEXEC) == sizeof (magic) && magic == ARV_SHARED_STREAM_MAGIC) {
+		control_message = CMSG_FIRSTHDR (&message);
+		if (control_message != NULL &&
+		    control_message->cmsg_level == SOL_SOCKET &&
+		    control_message->cmsg_type == SCM_RIGHTS)
+			memcpy (&memory_fd, CMSG_DATA (control_message), sizeof (int));
+	}
+
+	close (fd);
+
+	if (memory_fd < 0)
+		g_set_error (error, G_IO_ERROR, G_IO_ERROR_FAILED, "No memory file received from stream '%s'", name);
+
+	return memory_fd;
+}
+
+#endif
+
+/**
+ * arv_stream_subscriber_timeout_pop_buffer:
+ * @subscriber: a #ArvStreamSubscriber
+ * @timeout: timeout, in µs
+ *
+ * Waits for the next frame of the shared stream. The returned buffer must be released with g_object_unref() as soon
+ * as possible, its slot can not be used by the publisher in the meantime.
+ *
+ * Returns: (transfer full) (nullable): a read-only #ArvBuffer, %NULL on timeout, or if the publisher was destroyed.
+ *
+ * Since: 0.8.11
+ */
+
+ArvBuffer *
+arv_stream_subscriber_timeout_pop_buffer (ArvStreamSubscriber *subscriber, guint64 timeout)
+{
+#if ARAVIS_HAS_SHARED_STREAM
+	ArvBuffer *buffer = NULL;
+	gint64 end_time_us;
+
+	g_return_val_if_fail (ARV_IS_STREAM_SUBSCRIBER (subscriber), NULL);
+
+	end_time_us = g_get_monotonic_time () + timeout;
+
+	g_mutex_lock (&subscriber->mutex);
+
+	while (TRUE) {
+		gint sequence = g_atomic_int_get (&subscriber->header->sequence);
+		gint64 remaining_us;
+
+		buffer = _acquire_next_buffer (subscriber);
+		if (buffer != NULL || g_atomic_int_get ((gint *) &subscriber->header->is_closed))
+			break;
+
+		remaining_us = end_time_us - g_get_monotonic_time ();
+		if (remaining_us <= 0)
+			break;
+
+		arv_shared_stream_wait (subscriber->header, sequence, remaining_us);
+	}
+
+	g_mutex_unlock (&subscriber->mutex);
+
+	return buffer;
+#else
+	return NULL;
+#endif
+}
+
+/**
+ * arv_stream_subscriber_try_pop_buffer:
+ * @subscriber: a #ArvStreamSubscriber
+ *
+ * Returns: (transfer full) (nullable): the next frame of the shared stream, %NULL if none is available yet.
+ *
+ * Since: 0.8.11
+ */
+
+ArvBuffer *
+arv_stream_subscriber_try_pop_buffer (ArvStreamSubscriber *subscriber)
+{
+	return arv_stream_subscriber_timeout_pop_buffer (subscriber, 0);
+}
+
+/**
+ * arv_stream_subscriber_is_closed:
+ * @subscriber: a #ArvStreamSubscriber
+ *
+ * Returns: %TRUE if the publisher was destroyed. The frames still in the ring can be popped.
+ *
+ * Since: 0.8.11
+ */
+
+gboolean
+arv_stream_subscriber_is_closed (ArvStreamSubscriber *subscriber)
+{
+	g_return_val_if_fail (ARV_IS_STREAM_SUBSCRIBER (subscriber), TRUE);
+
+	return subscriber->header == NULL || g_atomic_int_get ((gint *) &subscriber->header->is_closed);
+}
+
+/**
+ * arv_stream_subscriber_get_n_missed_frames:
+ * @subscriber: a #ArvStreamSubscriber
+ *
+ * Returns: the number of published frames overwritten before being popped.
+ *
+ * Since: 0.8.11
+ */
+
+guint64
+arv_stream_subscriber_get_n_missed_frames (ArvStreamSubscriber *subscriber)
+{
+	guint64 n_missed_frames;
+
+	g_return_val_if_fail (ARV_IS_STREAM_SUBSCRIBER (subscriber), 0);
+
+	g_mutex_lock (&subscriber->mutex);
+	n_missed_frames = subscriber->n_missed_frames;
+	g_mutex_unlock (&subscriber->mutex);
+
+	return n_missed_frames;
+}
+
+/**
+ * arv_stream_subscriber_new:
+ * @name: name of the shared stream, as given to arv_stream_publisher_new()
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Connects to a stream publisher of the host, and maps its frame ring.
+ *
+ * Returns: (transfer full): a new #ArvStreamSubscriber, %NULL on error.
+ *
+ * Since: 0.8.11
+ */
+
+ArvStreamSubscriber *
+arv_stream_subscriber_new (const char *name, GError **error)
+{
+#if ARAVIS_HAS_SHARED_STREAM
+	ArvStreamSubscriber *subscriber;
+	ArvSharedStreamHeader *header;
+	struct stat file_stat;
+	void *data;
+	size_t control_size;
+	int fd;
+
+	g_return_val_if_fail (name != NULL && name[0] != '\0', NULL);
+
+	fd = _connect (name, error);
+	if (fd < 0)
+		return NULL;
+
+	header = mmap (NULL, sizeof (ArvSharedStreamHeader), PROT_READ, MAP_SHARED, fd, 0);
+	if (header == MAP_FAILED || fstat (fd, &file_stat) != 0 ||
+	    header->magic != ARV_SHARED_STREAM_MAGIC || header->version != ARV_SHARED_STREAM_VERSION ||
+	    header->n_slots == 0 || header->n_slots > ARV_SHARED_STREAM_N_SLOTS_MAX ||
+	    header->data_offset + (guint64) header->n_slots * header->slot_size > (guint64) file_stat.st_size) {
+		if (header != MAP_FAILED)
+			munmap (header, sizeof (ArvSharedStreamHeader));
+		close (fd);
+		g_set_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA, "Invalid memory file for stream '%s'", name);
+		return NULL;
+	}
+
+	subscriber = g_object_new (ARV_TYPE_STREAM_SUBSCRIBER, NULL);
+	subscriber->control_size = header->data_offset;
+	subscriber->data_size = header->n_slots * header->slot_size;
+	munmap (header, sizeof (ArvSharedStreamHeader));
+
+	/* Only the reference counts of the control area are written */
+	control_size = subscriber->control_size;
+	header = mmap (NULL, control_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	data = mmap (NULL, subscriber->data_size, PROT_READ, MAP_SHARED, fd, control_size);
+	close (fd);
+
+	if (header == MAP_FAILED || data == MAP_FAILED) {
+		if (header != MAP_FAILED)
+			munmap (header, control_size);
+		if (data != MAP_FAILED)
+			munmap (data, subscriber->data_size);
+		g_set_error (error, G_IO_ERROR, G_IO_ERROR_FAILED, "Failed to map stream '%s'", name);
+		g_object_unref (subscriber);
+		return NULL;
+	}
+
+	subscriber->header = header;
+	subscriber->data = data;
+	subscriber->last_frame_index = header->n_published;
+
+	arv_info_stream ("[StreamSubscriber::new] Subscribed to '%s', %u slots of %" G_GUINT64_FORMAT " bytes",
+			 name, header->n_slots, header->slot_size);
+
+	return subscriber;
+#else
+	g_set_error (error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED, "Shared streams not supported");
+	return NULL;
+#endif
+}
+
+static void
+arv_stream_subscriber_init (ArvStreamSubscriber *subscriber)
+{
+	g_mutex_init (&subscriber->mutex);
+}
+
+static void
+arv_stream_subscriber_finalize (GObject *object)
+{
+	ArvStreamSubscriber *subscriber = ARV_STREAM_SUBSCRIBER (object);
+
+#if ARAVIS_HAS_SHARED_STREAM
+	if (subscriber->header != NULL)
+		munmap (subscriber->header, subscriber->control_size);
+	if (subscriber->data != NULL)
+		munmap ((void *) subscriber->data, subscriber->data_size);
+#endif
+
+	g_mutex_clear (&subscriber->mutex);
+
+	G_OBJECT_CLASS (arv_stream_subscriber_parent_class)->finalize (object);
+}
+
+static void
+arv_stream_subscriber_class_init (ArvStreamSubscriberClass *subscriber_class)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS (subscriber_class);
+
+	object_class->finalize = arv_stream_subscriber_finalize;
+}
@@ -0,0 +1,48 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2019 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel@gnome.org>
+ */
+
+#ifndef ARV_STREAM_SUBSCRIBER_H
+#define ARV_STREAM_SUBSCRIBER_H
+
+#if !defined (ARV_H_INSIDE) && !defined (ARAVIS_COMPILATION)
+#error "Only <arv.h> can be included directly."
+#endif
+
+#include <arvtypes.h>
+#include <arvbuffer.h>
+
+G_BEGIN_DECLS
+
+#define ARV_TYPE_STREAM_SUBSCRIBER             (arv_stream_subscriber_get_type ())
+G_DECLARE_FINAL_TYPE (ArvStreamSubscriber, arv_stream_subscriber, ARV, STREAM_SUBSCRIBER, GObject)
+
+ArvStreamSubscriber *	arv_stream_subscriber_new			(const char *name, GError **error);
+
+ArvBuffer *		arv_stream_subscriber_timeout_pop_buffer	(ArvStreamSubscriber *subscriber, guint64 timeout);
+ArvBuffer *		arv_stream_subscriber_try_pop_buffer		(ArvStreamSubscriber *subscriber);
+
+gboolean		arv_stream_subscriber_is_closed			(ArvStreamSubscriber *subscriber);
+guint64			arv_stream_subscriber_get_n_missed_frames	(ArvStreamSubscriber *subscriber);
+
+G_END_DECLS
+
+#endif
@@ -22,6 +22,11 @@
 
 #include <arvsystem.h>
 #include <arvgvinterfaceprivate.h>
+#include <arvgvreceiverprivate.h>
+#include <arvnetworkprivate.h>
+#include <arvgenicamcacheprivate.h>
+#include <arvgcprivate.h>
+#include <arvxmlschemaprivate.h>
 #include <arvfeatures.h>
 #if ARAVIS_HAS_USB
 #include <arvuvinterfaceprivate.h>
@@ -33,7 +38,9 @@
 #include <arvmisc.h>
 #include <arvdomimplementation.h>
 
-static GMutex arv_system_mutex;
+/* Protects the interface registry and the device lists. Device list updates are exclusive, while the device
+ * openings only hold a reader lock, as they mostly wait for the devices. */
+static GRWLock arv_system_lock;
 
 /**
  * SECTION: arv
@@ -151,29 +158,355 @@ arv_disable_interface (const char *interface_id)
 	g_warning ("[Arv::enable_interface] Unknown interface '%s'", interface_id);
 }
 
+/**
+ * arv_enable_genicam_cache:
+ * @directory: (allow-none): cache directory, %NULL for an aravis/genicam directory in the user cache directory
+ *
+ * Enable the on-disk cache of the device GenICam data. The data of a device are stored uncompressed on the first
+ * connection, and loaded from the cache instead of being downloaded on the next ones, as long as the device vendor,
+ * model and version, and the description of its GenICam data, like the URL or the manifest entry, are unchanged. The
+ * last known addresses of the GigE Vision devices opened by their id are also kept there, for a week, and checked by
+ * a unicast discovery at the next opening, which avoids the timeout of a broadcast discovery. By default, the cache is
+ * disabled.
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_enable_genicam_cache (const char *directory)
+{
+	g_autofree char *default_directory = NULL;
+
+	if (directory == NULL)
+		default_directory = g_build_filename (g_get_user_cache_dir (), "aravis", "genicam", NULL);
+
+	arv_genicam_cache_set_directory (directory != NULL ? directory : default_directory);
+}
+
+/**
+ * arv_disable_genicam_cache:
+ *
+ * Disable the on-disk cache of the device GenICam data. The already cached data are left untouched.
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_disable_genicam_cache (void)
+{
+	arv_genicam_cache_set_directory (NULL);
+}
+
+/**
+ * arv_enable_genicam_lazy_loading:
+ *
+ * Enable the lazy creation of the GenICam nodes, for the devices opened afterwards. The XML data are only scanned at
+ * device opening, for an index of the features it defines, and the nodes of a feature are only created the first
+ * time it is accessed. This reduces the opening time and the memory footprint of the devices, applications usually
+ * using a small part of the features. By default, all the nodes are created at device opening.
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_enable_genicam_lazy_loading (void)
+{
+	arv_gc_set_lazy_loading (TRUE);
+}
+
+/**
+ * arv_disable_genicam_lazy_loading:
+ *
+ * Disable the lazy creation of the GenICam nodes, for the devices opened afterwards.
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_disable_genicam_lazy_loading (void)
+{
+	arv_gc_set_lazy_loading (FALSE);
+}
+
+/**
+ * arv_set_genicam_schema_validation:
+ * @policy: a #ArvXmlSchemaValidationPolicy
+ * @schema: (allow-none): the GenAPI schema, %NULL to disable the validation
+ *
+ * Set the validation of the GenICam data of the devices opened afterwards against @schema. The validation runs on a
+ * background thread and does not delay the device opening, the invalid data being only reported by a warning. With
+ * %ARV_XML_SCHEMA_VALIDATION_POLICY_FIRST_SIGHT, a given GenICam data is only validated once per process, and not at
+ * all if the GenICam cache, enabled by arv_enable_genicam_cache(), holds a successful validation of the data against
+ * the same schema. By default, the GenICam data are not validated.
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_set_genicam_schema_validation (ArvXmlSchemaValidationPolicy policy, ArvXmlSchema *schema)
+{
+	g_return_if_fail (schema == NULL || ARV_IS_XML_SCHEMA (schema));
+
+	arv_xml_schema_set_genicam_validation (policy, schema);
+}
+
+typedef struct {
+	char *expected_device_id;
+	ArvDeviceFoundCallback device_found_callback;
+	gpointer device_found_data;
+	GMainContext *context;
+	GCancellable *cancellable;
+	gulong cancelled_handler;
+	gboolean expected_device_found;
+} ArvSystemDiscovery;
+
+typedef struct {
+	ArvSystemDiscovery *discovery;
+	ArvInterface *interface;
+} ArvSystemInterfaceDiscovery;
+
+typedef struct {
+	ArvDeviceFoundCallback callback;
+	gpointer user_data;
+	char *device_id;
+} ArvSystemDeviceFound;
+
+static gboolean
+_emit_device_found (gpointer data)
+{
+	ArvSystemDeviceFound *found = data;
+
+	found->callback (found->device_id, found->user_data);
+
+	return G_SOURCE_REMOVE;
+}
+
+static void
+_device_found_free (gpointer data)
+{
+	ArvSystemDeviceFound *found = data;
+
+	g_free (found->device_id);
+	g_free (found);
+}
+
+static void
+_interface_device_found (ArvInterface *interface, const char *device_id, gboolean is_expected, gpointer user_data)
+{
+	ArvSystemDiscovery *discovery = user_data;
+
+	arv_debug_interface ("[Arv::update_device_list] Device '%s' found%s", device_id,
+			     is_expected ? " (expected)" : "");
+
+	if (discovery->device_found_callback != NULL) {
+		ArvSystemDeviceFound *found;
+
+		found = g_new0 (ArvSystemDeviceFound, 1);
+		found->callback = discovery->device_found_callback;
+		found->user_data = discovery->device_found_data;
+		found->device_id = g_strdup (device_id);
+
+		g_main_context_invoke_full (discovery->context, G_PRIORITY_DEFAULT,
+					    _emit_device_found, found, _device_found_free);
+	}
+
+	/* Stop the discovery on the other interfaces */
+	if (is_expected) {
+		discovery->expected_device_found = TRUE;
+		g_cancellable_cancel (discovery->cancellable);
+	}
+}
+
+static gpointer
+_interface_discovery_thread (gpointer data)
+{
+	ArvSystemInterfaceDiscovery *interface_discovery = data;
+	ArvSystemDiscovery *discovery = interface_discovery->discovery;
+
+	arv_interface_update_device_list_full (interface_discovery->interface,
+					       discovery->expected_device_id,
+					       _interface_device_found, discovery,
+					       discovery->cancellable);
+
+	return NULL;
+}
+
+/* Updates the device lists of all the available interfaces, in parallel. Must be called with arv_system_lock
+ * locked for writing. */
+
+static void
+_update_device_list (ArvSystemDiscovery *discovery)
+{
+	ArvSystemInterfaceDiscovery interface_discoveries[G_N_ELEMENTS (interfaces)];
+	GThread *threads[G_N_ELEMENTS (interfaces)];
+	unsigned int n_interfaces = 0;
+	unsigned int i;
+
+	for (i = 0; i < G_N_ELEMENTS (interfaces); i++) {
+		if (interfaces[i].is_available) {
+			interface_discoveries[n_interfaces].discovery = discovery;
+			interface_discoveries[n_interfaces].interface = interfaces[i].get_interface_instance ();
+			n_interfaces++;
+		}
+	}
+
+	/* The last interface is scanned from the calling thread */
+	for (i = 0; i + 1 < n_interfaces; i++)
+		threads[i] = g_thread_new ("arv_discovery", _interface_discovery_thread, &interface_discoveries[i]);
+	if (n_interfaces > 0)
+		_interface_discovery_thread (&interface_discoveries[n_interfaces - 1]);
+	for (i = 0; i + 1 < n_interfaces; i++)
+		g_thread_join (threads[i]);
+}
+
+static void
+_cancel_discovery (GCancellable *cancellable, gpointer data)
+{
+	g_cancellable_cancel (data);
+}
+
+static ArvSystemDiscovery *
+arv_system_discovery_new (const char *expected_device_id, GCancellable *cancellable,
+			  ArvDeviceFoundCallback device_found_callback, gpointer device_found_data)
+{
+	ArvSystemDiscovery *discovery;
+
+	discovery = g_new0 (ArvSystemDiscovery, 1);
+	discovery->expected_device_id = g_strdup (expected_device_id);
+	discovery->device_found_callback = device_found_callback;
+	discovery->device_found_data = device_found_data;
+	discovery->context = g_main_context_ref_thread_default ();
+
+	/* Private cancellable, which stops all the interfaces when the expected device is found, without cancelling
+	 * the one owned by the caller */
+	discovery->cancellable = g_cancellable_new ();
+	if (cancellable != NULL)
+		discovery->cancelled_handler = g_cancellable_connect (cancellable,
+								      G_CALLBACK (_cancel_discovery),
+								      g_object_ref (discovery->cancellable),
+								      g_object_unref);
+
+	return discovery;
+}
+
+/* The caller cancellable is disconnected in arv_update_device_list_finish(), as the task data may be released from
+ * the discovery thread. The connected handler holds its own reference on the private cancellable. */
+
+static void
+arv_system_discovery_free (gpointer data)
+{
+	ArvSystemDiscovery *discovery = data;
+
+	g_object_unref (discovery->cancellable);
+	g_main_context_unref (discovery->context);
+	g_free (discovery->expected_device_id);
+	g_free (discovery);
+}
+
 /**
  * arv_update_device_list:
  *
- * Updates the list of currently online devices.
+ * Updates the list of currently online devices. The interfaces are scanned in parallel.
  **/
 
 void
 arv_update_device_list (void)
 {
-	unsigned int i;
+	ArvSystemDiscovery *discovery;
 
-	g_mutex_lock (&arv_system_mutex);
+	discovery = arv_system_discovery_new (NULL, NULL, NULL, NULL);
 
-	for (i = 0; i < G_N_ELEMENTS (interfaces); i++) {
-		ArvInterface *interface;
+	g_rw_lock_writer_lock (&arv_system_lock);
 
-		if (interfaces[i].is_available) {
-			interface = interfaces[i].get_interface_instance ();
-			arv_interface_update_device_list (interface);
-		}
+	_update_device_list (discovery);
+
+	g_rw_lock_writer_unlock (&arv_system_lock);
+
+	arv_system_discovery_free (discovery);
+}
+
+static void
+_update_device_list_thread (GTask *task, gpointer source_object, gpointer task_data, GCancellable *cancellable)
+{
+	ArvSystemDiscovery *discovery = task_data;
+
+	g_rw_lock_writer_lock (&arv_system_lock);
+
+	_update_device_list (discovery);
+
+	g_rw_lock_writer_unlock (&arv_system_lock);
+
+	if (discovery->expected_device_found)
+		g_task_return_boolean (task, TRUE);
+	else if (!g_task_return_error_if_cancelled (task))
+		g_task_return_boolean (task, discovery->expected_device_id == NULL);
+}
+
+/**
+ * arv_update_device_list_async:
+ * @expected_device_id: (allow-none): id of a device which stops the update once found, %NULL for a full update
+ * @cancellable: (allow-none): a #GCancellable
+ * @device_found_callback: (allow-none) (scope notified): a #ArvDeviceFoundCallback called for each found device
+ * @device_found_data: (closure device_found_callback): the data to pass to @device_found_callback
+ * @callback: (scope async): a #GAsyncReadyCallback to call when the update is done
+ * @user_data: (closure callback): the data to pass to @callback
+ *
+ * Asynchronous version of arv_update_device_list(). The interfaces are scanned in parallel from worker threads,
+ * and @device_found_callback is called in the thread default main context of the caller each time a device
+ * answers, before @callback. A device id passed as @expected_device_id may be any of the names accepted by
+ * arv_open_device(). When this device is found, the update stops on all interfaces without waiting for the
+ * discovery timeout, which speeds up a reconnection. In this case, the device list only contains the devices found
+ * so far.
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_update_device_list_async (const char *expected_device_id, GCancellable *cancellable,
+			      ArvDeviceFoundCallback device_found_callback, gpointer device_found_data,
+			      GAsyncReadyCallback callback, gpointer user_data)
+{
+	ArvSystemDiscovery *discovery;
+	GTask *task;
+
+	discovery = arv_system_discovery_new (expected_device_id, cancellable,
+					      device_found_callback, device_found_data);
+
+	task = g_task_new (NULL, cancellable, callback, user_data);
+	g_task_set_source_tag (task, arv_update_device_list_async);
+	g_task_set_task_data (task, discovery, arv_system_discovery_free);
+	g_task_run_in_thread (task, _update_device_list_thread);
+	g_object_unref (task);
+}
+
+/**
+ * arv_update_device_list_finish:
+ * @result: a #GAsyncResult
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Finishes an operation started with arv_update_device_list_async().
+ *
+ * Returns: %TRUE if the expected device was found, or once a full update is done when no device was expected,
+ * %FALSE if the expected device was not found, or with @error set if the update was cancelled.
+ *
+ * Since: 0.8.11
+ */
+
+gboolean
+arv_update_device_list_finish (GAsyncResult *result, GError **error)
+{
+	ArvSystemDiscovery *discovery;
+
+	g_return_val_if_fail (g_task_is_valid (result, NULL), FALSE);
+	g_return_val_if_fail (g_task_get_source_tag (G_TASK (result)) == arv_update_device_list_async, FALSE);
+
+	discovery = g_task_get_task_data (G_TASK (result));
+	if (discovery->cancelled_handler != 0) {
+		g_cancellable_disconnect (g_task_get_cancellable (G_TASK (result)), discovery->cancelled_handler);
+		discovery->cancelled_handler = 0;
 	}
 
-	g_mutex_unlock (&arv_system_mutex);
+	return g_task_propagate_boolean (G_TASK (result), error);
 }
 
 /**
@@ -191,7 +524,7 @@ arv_get_n_devices (void)
 	unsigned int n_devices = 0;
 	unsigned int i;
 
-	g_mutex_lock (&arv_system_mutex);
+	g_rw_lock_reader_lock (&arv_system_lock);
 
 	for (i = 0; i < G_N_ELEMENTS (interfaces); i++) {
 		ArvInterface *interface;
@@ -202,7 +535,7 @@ arv_get_n_devices (void)
 		}
 	}
 
-	g_mutex_unlock (&arv_system_mutex);
+	g_rw_lock_reader_unlock (&arv_system_lock);
 
 	return n_devices;
 }
@@ -214,7 +547,7 @@ arv_get_info (unsigned int index, const char *get_info (ArvInterface *, guint))
 	unsigned int i;
 	const char *info;
 
-	g_mutex_lock (&arv_system_mutex);
+	g_rw_lock_reader_lock (&arv_system_lock);
 
 	for (i = 0; i < G_N_ELEMENTS (interfaces); i++) {
 		ArvInterface *interface;
@@ -227,7 +560,7 @@ arv_get_info (unsigned int index, const char *get_info (ArvInterface *, guint))
 			if (index - offset < n_devices) {
 				info = get_info (interface, index - offset);
 
-				g_mutex_unlock (&arv_system_mutex);
+				g_rw_lock_reader_unlock (&arv_system_lock);
 
 				return info;
 			}
@@ -236,7 +569,7 @@ arv_get_info (unsigned int index, const char *get_info (ArvInterface *, guint))
 		}
 	}
 
-	g_mutex_unlock (&arv_system_mutex);
+	g_rw_lock_reader_unlock (&arv_system_lock);
 
 	return NULL;
 }
@@ -393,7 +726,7 @@ arv_open_device (const char *device_id, GError **error)
 {
 	unsigned int i;
 
-	g_mutex_lock (&arv_system_mutex);
+	g_rw_lock_reader_lock (&arv_system_lock);
 
 	for (i = 0; i < G_N_ELEMENTS (interfaces); i++) {
 		ArvInterface *interface;
@@ -407,13 +740,13 @@ arv_open_device (const char *device_id, GError **error)
 			if (ARV_IS_DEVICE (device) || local_error != NULL) {
 				if (local_error != NULL)
 					g_propagate_error (error, local_error);
-				g_mutex_unlock (&arv_system_mutex);
+				g_rw_lock_reader_unlock (&arv_system_lock);
 				return device;
 			}
 		}
 	}
 
-	g_mutex_unlock (&arv_system_mutex);
+	g_rw_lock_reader_unlock (&arv_system_lock);
 
 	if (device_id != NULL)
 		g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_NOT_FOUND,
@@ -425,6 +758,95 @@ arv_open_device (const char *device_id, GError **error)
 	return NULL;
 }
 
+typedef struct {
+	const char *device_id;
+	ArvDevice *device;
+	GError *error;
+} ArvSystemOpenDevice;
+
+static gpointer
+_open_device_thread (gpointer data)
+{
+	ArvSystemOpenDevice *open_device = data;
+
+	open_device->device = arv_open_device (open_device->device_id, &open_device->error);
+
+	return NULL;
+}
+
+/**
+ * arv_open_devices:
+ * @device_ids: (array zero-terminated=1): a %NULL terminated list of device identifier strings
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Opens the devices corresponding to the given identifiers, like arv_open_device(), but concurrently, each device
+ * being opened from its own thread. Most of the opening time is spent waiting for the GenICam data download, which
+ * makes this function much faster than successive calls to arv_open_device() for a large set of devices. Identical
+ * devices share the same entries of the GenICam cache, if enabled by arv_enable_genicam_cache(). The GenICam data
+ * of identical devices is only parsed once, and the number of concurrent parses is limited to the number of
+ * processors, while the downloads of the other devices go on.
+ *
+ * If any of the devices can't be opened, the other ones are released, and @error is set with the first failure.
+ *
+ * Return value: (transfer full) (element-type ArvDevice): an array of new #ArvDevice instances, in the order of
+ * @device_ids, or %NULL on error.
+ *
+ * Since: 0.8.11
+ */
+
+GPtrArray *
+arv_open_devices (const char **device_ids, GError **error)
+{
+	ArvSystemOpenDevice *open_devices;
+	GThread **threads;
+	GPtrArray *devices;
+	GError *local_error = NULL;
+	guint n_devices;
+	guint i;
+
+	g_return_val_if_fail (device_ids != NULL, NULL);
+
+	n_devices = g_strv_length ((char **) device_ids);
+
+	open_devices = g_new0 (ArvSystemOpenDevice, n_devices);
+	threads = g_new0 (GThread *, n_devices);
+
+	for (i = 0; i < n_devices; i++)
+		open_devices[i].device_id = device_ids[i];
+
+	/* The last device is opened from the calling thread */
+	for (i = 0; i + 1 < n_devices; i++)
+		threads[i] = g_thread_new ("arv_open_device", _open_device_thread, &open_devices[i]);
+	if (n_devices > 0)
+		_open_device_thread (&open_devices[n_devices - 1]);
+	for (i = 0; i + 1 < n_devices; i++)
+		g_thread_join (threads[i]);
+
+	devices = g_ptr_array_new_full (n_devices, g_object_unref);
+
+	for (i = 0; i < n_devices; i++) {
+		if (open_devices[i].error != NULL) {
+			if (local_error == NULL)
+				local_error = open_devices[i].error;
+			else
+				g_error_free (open_devices[i].error);
+		}
+		if (open_devices[i].device != NULL)
+			g_ptr_array_add (devices, open_devices[i].device);
+	}
+
+	g_free (threads);
+	g_free (open_devices);
+
+	if (local_error != NULL) {
+		g_ptr_array_unref (devices);
+		g_propagate_error (error, local_error);
+		return NULL;
+	}
+
+	return devices;
+}
+
 /**
  * arv_shutdown:
  *
@@ -438,12 +860,20 @@ arv_shutdown (void)
 {
 	unsigned int i;
 
-	g_mutex_lock (&arv_system_mutex);
+	g_rw_lock_writer_lock (&arv_system_lock);
 
 	for (i = 0; i < G_N_ELEMENTS (interfaces); i++)
 		interfaces[i].destroy_interface_instance ();
 
 	arv_dom_implementation_cleanup ();
 
-	g_mutex_unlock (&arv_system_mutex);
+	arv_gv_receiver_shutdown ();
+
+	arv_network_shutdown ();
+
+	arv_xml_schema_set_genicam_validation (ARV_XML_SCHEMA_VALIDATION_POLICY_NEVER, NULL);
+
+	arv_genicam_cache_set_directory (NULL);
+
+	g_rw_lock_writer_unlock (&arv_system_lock);
 }
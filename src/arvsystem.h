@@ -28,15 +28,43 @@
 #endif
 
 #include <arvtypes.h>
+#include <arvxmlschema.h>
+#include <gio/gio.h>
 
 G_BEGIN_DECLS
 
+/**
+ * ArvDeviceFoundCallback:
+ * @device_id: id of the found device
+ * @user_data: user data
+ *
+ * Callback called by arv_update_device_list_async() for each found device.
+ *
+ * Since: 0.8.11
+ */
+
+typedef void (*ArvDeviceFoundCallback) (const char *device_id, gpointer user_data);
+
 unsigned int 		arv_get_n_interfaces 		(void);
 const char * 		arv_get_interface_id 		(unsigned int index);
 void 			arv_enable_interface 		(const char *interface_id);
 void 			arv_disable_interface		(const char *interface_id);
 
+void			arv_enable_genicam_cache	(const char *directory);
+void			arv_disable_genicam_cache	(void);
+
+void			arv_enable_genicam_lazy_loading		(void);
+void			arv_disable_genicam_lazy_loading	(void);
+
+void			arv_set_genicam_schema_validation	(ArvXmlSchemaValidationPolicy policy,
+								 ArvXmlSchema *schema);
+
 void 			arv_update_device_list 		(void);
+void			arv_update_device_list_async	(const char *expected_device_id, GCancellable *cancellable,
+							 ArvDeviceFoundCallback device_found_callback,
+							 gpointer device_found_data,
+							 GAsyncReadyCallback callback, gpointer user_data);
+gboolean		arv_update_device_list_finish	(GAsyncResult *result, GError **error);
 unsigned int 		arv_get_n_devices 		(void);
 const char * 		arv_get_device_id 		(unsigned int index);
 const char * 		arv_get_device_physical_id 	(unsigned int index);
@@ -47,6 +75,7 @@ const char * 		arv_get_device_serial_nbr 	(unsigned int index);
 const char *		arv_get_device_protocol		(unsigned int index);
 
 ArvDevice * 		arv_open_device 		(const char *device_id, GError **error);
+GPtrArray *		arv_open_devices		(const char **device_ids, GError **error);
 
 void 			arv_shutdown 			(void);
 
@@ -0,0 +1,209 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2019 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel@gnome.org>
+ */
+
+/*< private >
+ * SECTION: arvtilepipeline
+ * @short_description: Multi-threaded processing stage of the stream output
+ *
+ * A pool of worker threads between the stream thread and the output queue. The image of each completed buffer is
+ * split in bands of rows, which are passed in parallel to a tile function. Buffers are delivered in the order they
+ * were pushed, by the thread completing the last pending tile of the oldest buffer. At most depth buffers are in the
+ * stage at any time, which bounds the added latency; push fails when the stage is full.
+ */
+
+#include <arvtilepipelineprivate.h>
+#include <arvbufferprivate.h>
+#include <arvdebugprivate.h>
+
+typedef struct _ArvTileFrame ArvTileFrame;
+
+typedef struct {
+	ArvTileFrame *frame;
+	guint first_row;
+	guint n_rows;
+} ArvTile;
+
+struct _ArvTileFrame {
+	ArvTilePipeline *pipeline;
+	ArvBuffer *buffer;
+	gint n_pending_tiles;
+	gboolean is_done;
+	ArvTile *tiles;
+};
+
+struct _ArvTilePipeline {
+	ArvStreamTileFunc tile_func;
+	void *user_data;
+	GDestroyNotify destroy;
+
+	guint tile_rows;
+	guint depth;
+
+	ArvTilePipelineDeliverFunc deliver_func;
+	void *deliver_data;
+
+	GThreadPool *pool;
+
+	/* Frames in push order, protected by mutex, which also serializes the deliveries */
+	GMutex mutex;
+	GQueue frames;
+};
+
+static void
+_frame_done (ArvTileFrame *frame)
+{
+	ArvTilePipeline *pipeline = frame->pipeline;
+	ArvTileFrame *head;
+
+	g_mutex_lock (&pipeline->mutex);
+
+	frame->is_done = TRUE;
+
+	while ((head = g_queue_peek_head (&pipeline->frames)) != NULL && head->is_done) {
+		g_queue_pop_head (&pipeline->frames);
+
+		pipeline->deliver_func (pipeline->deliver_data, head->buffer);
+
+		g_free (head->tiles);
+		g_free (head);
+	}
+
+	g_mutex_unlock (&pipeline->mutex);
+}
+
+static void
+_process_tile (gpointer data, gpointer user_data)
+{
+	ArvTile *tile = data;
+	ArvTileFrame *frame = tile->frame;
+	ArvTilePipeline *pipeline = frame->pipeline;
+
+	pipeline->tile_func (frame->buffer, tile->first_row, tile->n_rows, pipeline->user_data);
+
+	if (g_atomic_int_dec_and_test (&frame->n_pending_tiles))
+		_frame_done (frame);
+}
+
+/* Buffers without a complete image are delivered without calling the tile function */
+
+gboolean
+arv_tile_pipeline_push (ArvTilePipeline *pipeline, ArvBuffer *buffer)
+{
+	ArvTileFrame *frame;
+	guint n_tiles = 0;
+	guint i;
+
+	g_return_val_if_fail (pipeline != NULL, FALSE);
+	g_return_val_if_fail (ARV_IS_BUFFER (buffer), FALSE);
+
+	if (buffer->priv->status == ARV_BUFFER_STATUS_SUCCESS &&
+	    arv_buffer_payload_type_has_aoi (buffer->priv->payload_type))
+		n_tiles = (buffer->priv->height + pipeline->tile_rows - 1) / pipeline->tile_rows;
+
+	g_mutex_lock (&pipeline->mutex);
+
+	if (g_queue_get_length (&pipeline->frames) >= pipeline->depth) {
+		g_mutex_unlock (&pipeline->mutex);
+		return FALSE;
+	}
+
+	frame = g_new0 (ArvTileFrame, 1);
+	frame->pipeline = pipeline;
+	frame->buffer = buffer;
+	frame->n_pending_tiles = n_tiles;
+	frame->tiles = g_new (ArvTile, MAX (n_tiles, 1));
+
+	g_queue_push_tail (&pipeline->frames, frame);
+
+	g_mutex_unlock (&pipeline->mutex);
+
+	if (n_tiles == 0) {
+		_frame_done (frame);
+		return TRUE;
+	}
+
+	for (i = 0; i < n_tiles; i++) {
+		frame->tiles[i].frame = frame;
+		frame->tiles[i].first_row = i * pipeline->tile_rows;
+		frame->tiles[i].n_rows = MIN (pipeline->tile_rows, buffer->priv->height - i * pipeline->tile_rows);
+	}
+
+	for (i = 0; i < n_tiles; i++)
+		g_thread_pool_push (pipeline->pool, &frame->tiles[i], NULL);
+
+	return TRUE;
+}
+
+/* n_threads == 0 uses one thread per processor */
+
+ArvTilePipeline *
+arv_tile_pipeline_new (ArvStreamTileFunc tile_func, void *user_data, GDestroyNotify destroy,
+		       guint n_threads, guint tile_rows, guint depth,
+		       ArvTilePipelineDeliverFunc deliver_func, void *deliver_data)
+{
+	ArvTilePipeline *pipeline;
+
+	g_return_val_if_fail (tile_func != NULL, NULL);
+	g_return_val_if_fail (deliver_func != NULL, NULL);
+	g_return_val_if_fail (tile_rows > 0, NULL);
+	g_return_val_if_fail (depth > 0, NULL);
+
+	pipeline = g_new0 (ArvTilePipeline, 1);
+	pipeline->tile_func = tile_func;
+	pipeline->user_data = user_data;
+	pipeline->destroy = destroy;
+	pipeline->tile_rows = tile_rows;
+	pipeline->depth = depth;
+	pipeline->deliver_func = deliver_func;
+	pipeline->deliver_data = deliver_data;
+
+	g_mutex_init (&pipeline->mutex);
+	g_queue_init (&pipeline->frames);
+
+	pipeline->pool = g_thread_pool_new (_process_tile, NULL, n_threads > 0 ? n_threads : g_get_num_processors (),
+					    TRUE, NULL);
+
+	arv_info_stream ("[TilePipeline::new] %u thread[s], %u row tiles, depth %u",
+			 g_thread_pool_get_max_threads (pipeline->pool), tile_rows, depth);
+
+	return pipeline;
+}
+
+/* Waits for the pending tiles, all the buffers in the stage are delivered before return */
+
+void
+arv_tile_pipeline_free (ArvTilePipeline *pipeline)
+{
+	if (pipeline == NULL)
+		return;
+
+	g_thread_pool_free (pipeline->pool, FALSE, TRUE);
+
+	g_assert (g_queue_is_empty (&pipeline->frames));
+
+	g_mutex_clear (&pipeline->mutex);
+
+	if (pipeline->destroy != NULL)
+		pipeline->destroy (pipeline->user_data);
+
+	g_free (pipeline);
+}
@@ -21,17 +21,26 @@
  */
 
 #include <arvdebugprivate.h>
+#include <arveventringprivate.h>
+#include <arvframelogprivate.h>
+#include <arvgcprivate.h>
+#include <arvgvcpprivate.h>
+#include <arvgvdeviceprivate.h>
 #include <arv.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <math.h>
 
 static char *arv_option_device_name = NULL;
 static char *arv_option_device_address = NULL;
 static char *arv_option_debug_domains = NULL;
 static char *arv_option_register_cache = NULL;
 static char *arv_option_range_check = NULL;
+static char *arv_option_snapshot = NULL;
+static char *arv_option_record = NULL;
 static gboolean arv_option_show_time = FALSE;
+static gboolean arv_option_all = FALSE;
 
 static const GOptionEntry arv_option_entries[] =
 {
@@ -55,6 +64,21 @@ static const GOptionEntry arv_option_entries[] =
 		&arv_option_range_check,	"Range check policy",
 		"{disable|enable}"
 	},
+	{
+		"snapshot",			'\0', 0, G_OPTION_ARG_FILENAME,
+		&arv_option_snapshot,		"Evaluate the features against a register snapshot, without any device",
+		"<file>"
+	},
+	{
+		"record",			'\0', 0, G_OPTION_ARG_FILENAME,
+		&arv_option_record,		"Record the registers accessed by the command into a snapshot",
+		"<file>"
+	},
+	{
+		"all",				'\0', 0, G_OPTION_ARG_NONE,
+		&arv_option_all,		"Apply the configuration to all the devices concurrently (apply command only)",
+		NULL
+	},
 	{
 		"time",				't', 0, G_OPTION_ARG_NONE,
 		&arv_option_show_time, 		"Show execution time",
@@ -77,18 +101,51 @@ description_content[] =
 "  values:                           list all available feature values\n"
 "  description [<feature>] ...:      show the full feature description\n"
 "  control <feature>[=<value>] ...:  read/write device features\n"
+"  profile <feature>[=<value>] ...:  read/write device features in a loop, and show the register access statistics\n"
+"  dump:                             dump all the feature values, including the selected ones, in JSON format\n"
+"  apply <file>:                     write the feature values of a file in the dump format, and read them back\n"
+"  bench-control [<n>] [stream]:     measure the control channel round trip times and memory read throughput,\n"
+"                                    over n iterations, optionally while streaming\n"
+"  events <file> ...:                decode stream event ring dumps, without any device\n"
+"  frames <file> ...:                decode stream frame logs, without any device\n"
 "\n"
 "If no command is given, this utility will list all the available devices.\n"
 "For the control command, direct access to device registers is provided using a R[address] syntax"
 " in place of a feature name.\n"
+"A snapshot recorded with --record can be given to --snapshot for the genicam, features, values, description,"
+" control, profile and dump commands. Writes are then only applied to the snapshot.\n"
+"The apply command sends all the writes in a single register batch, and retries the failed ones after the others."
+" With --all, the devices are opened and configured concurrently, and the timings of each device are reported.\n"
 "\n"
 "Examples:\n"
 "\n"
 "arv-tool-" ARAVIS_API_VERSION " control Width=128 Height=128 Gain R[0x10000]=0x10\n"
 "arv-tool-" ARAVIS_API_VERSION " features\n"
 "arv-tool-" ARAVIS_API_VERSION " description Width Height\n"
+"arv-tool-" ARAVIS_API_VERSION " --register-cache=enable profile Width Height OffsetX=0\n"
+"arv-tool-" ARAVIS_API_VERSION " dump > camera.json\n"
+"arv-tool-" ARAVIS_API_VERSION " --all apply camera.json\n"
+"arv-tool-" ARAVIS_API_VERSION " bench-control 1000 stream\n"
+"arv-tool-" ARAVIS_API_VERSION " --record=camera.arvregs dump > camera.json\n"
+"arv-tool-" ARAVIS_API_VERSION " --snapshot=camera.arvregs control Width\n"
 "arv-tool-" ARAVIS_API_VERSION " -n Basler-210ab4 genicam";
 
+#define ARV_TOOL_PROFILE_N_ITERATIONS	10
+
+/* Maximum number of values of an integer selector iterated by the dump command */
+#define ARV_TOOL_DUMP_N_SELECTOR_VALUES_MAX	256
+
+/* Maximum number of passes of the apply command over the settings which failed */
+#define ARV_TOOL_APPLY_N_PASSES_MAX		4
+/* Relative tolerance of the read back of the float features, which may be rounded by the device */
+#define ARV_TOOL_APPLY_FLOAT_TOLERANCE		1e-3
+
+#define ARV_TOOL_BENCH_N_ITERATIONS_DEFAULT	1000
+#define ARV_TOOL_BENCH_N_STREAM_BUFFERS		8
+
+/* Memory read sizes of the bench-control command, read from address 0, in the bootstrap registers */
+static const guint32 arv_tool_bench_read_memory_sizes[] = {4, 64, 256, 512, 4096, 32768};
+
 typedef enum {
 	ARV_TOOL_LIST_MODE_FEATURES,
 	ARV_TOOL_LIST_MODE_DESCRIPTIONS,
@@ -193,6 +250,23 @@ arv_tool_list_features (ArvGc *genicam, const char *feature, ArvToolListMode lis
 
 			features = arv_gc_category_get_features (ARV_GC_CATEGORY (node));
 
+			/* The values of the category features are read together, before being listed */
+			if (list_mode == ARV_TOOL_LIST_MODE_VALUES) {
+				GPtrArray *prefetched;
+
+				prefetched = g_ptr_array_new ();
+				for (iter = features; iter != NULL; iter = iter->next) {
+					ArvGcNode *child = arv_gc_get_node (genicam, iter->data);
+
+					if (ARV_IS_GC_FEATURE_NODE (child) &&
+					    !ARV_IS_GC_CATEGORY (child) && !ARV_IS_GC_COMMAND (child))
+						g_ptr_array_add (prefetched, child);
+				}
+				arv_gc_prefetch_features (genicam, (ArvGcFeatureNode **) prefetched->pdata,
+							  prefetched->len);
+				g_ptr_array_unref (prefetched);
+			}
+
 			for (iter = features; iter != NULL; iter = iter->next)
 				arv_tool_list_features (genicam, iter->data, list_mode, level + 1);
 		} else if (ARV_IS_GC_ENUMERATION (node) && list_mode == ARV_TOOL_LIST_MODE_FEATURES) {
@@ -213,21 +287,1271 @@ arv_tool_list_features (ArvGc *genicam, const char *feature, ArvToolListMode lis
 }
 
 static void
-arv_tool_execute_command (int argc, char **argv, ArvDevice *device,
+arv_tool_profile_features (ArvGc *genicam, int n_features, char **features)
+{
+	char ***tokens;
+	int i, j;
+
+	tokens = g_new (char **, n_features);
+	for (i = 0; i < n_features; i++)
+		tokens[i] = g_strsplit (features[i], "=", 2);
+
+	arv_gc_reset_feature_statistics (genicam);
+
+	for (j = 0; j < ARV_TOOL_PROFILE_N_ITERATIONS; j++) {
+		for (i = 0; i < n_features; i++) {
+			ArvGcNode *feature;
+			GError *error = NULL;
+
+			feature = arv_gc_get_node (genicam, tokens[i][0]);
+			if (!ARV_IS_GC_FEATURE_NODE (feature) || ARV_IS_GC_COMMAND (feature))
+				continue;
+
+			if (tokens[i][1] != NULL)
+				arv_gc_feature_node_set_value_from_string (ARV_GC_FEATURE_NODE (feature), tokens[i][1],
+									   &error);
+			if (error == NULL)
+				arv_gc_feature_node_get_value_as_string (ARV_GC_FEATURE_NODE (feature), &error);
+
+			if (error != NULL) {
+				if (j == 0)
+					printf ("%s %s error: %s\n",
+						tokens[i][0],
+						tokens[i][1] != NULL ? "write" : "read",
+						error->message);
+				g_clear_error (&error);
+			}
+		}
+	}
+
+	printf ("%d iterations\n", ARV_TOOL_PROFILE_N_ITERATIONS);
+	printf ("%-32s %8s %8s %8s %8s %12s\n", "Feature", "Reads", "Writes", "Hits", "Misses", "Port time");
+
+	for (i = 0; i < n_features; i++) {
+		guint64 n_reads, n_writes, n_cache_hits, n_cache_misses, port_time_us;
+
+		if (arv_gc_get_feature_statistics (genicam, tokens[i][0], &n_reads, &n_writes,
+						   &n_cache_hits, &n_cache_misses, &port_time_us))
+			printf ("%-32s %8" G_GUINT64_FORMAT " %8" G_GUINT64_FORMAT " %8" G_GUINT64_FORMAT
+				" %8" G_GUINT64_FORMAT " %9.3f ms\n",
+				tokens[i][0], n_reads, n_writes, n_cache_hits, n_cache_misses, port_time_us / 1000.0);
+		else if (ARV_IS_GC_FEATURE_NODE (arv_gc_get_node (genicam, tokens[i][0])))
+			printf ("%-32s (not a register)\n", tokens[i][0]);
+		else
+			printf ("%-32s (not found)\n", tokens[i][0]);
+	}
+
+	for (i = 0; i < n_features; i++)
+		g_strfreev (tokens[i]);
+	g_free (tokens);
+}
+
+static void
+arv_tool_dump_collect_features (ArvGc *genicam, const char *feature, GHashTable *visited,
+				GPtrArray *features, GPtrArray *selectors)
+{
+	ArvGcNode *node;
+
+	if (g_hash_table_contains (visited, feature))
+		return;
+	g_hash_table_add (visited, (char *) feature);
+
+	node = arv_gc_get_node (genicam, feature);
+	if (!ARV_IS_GC_FEATURE_NODE (node) ||
+	    !arv_gc_feature_node_is_implemented (ARV_GC_FEATURE_NODE (node), NULL))
+		return;
+
+	if (ARV_IS_GC_CATEGORY (node)) {
+		const GSList *iter;
+
+		for (iter = arv_gc_category_get_features (ARV_GC_CATEGORY (node)); iter != NULL; iter = iter->next)
+			arv_tool_dump_collect_features (genicam, iter->data, visited, features, selectors);
+		return;
+	}
+
+	if (ARV_IS_GC_COMMAND (node) ||
+	    arv_gc_feature_node_get_actual_access_mode (ARV_GC_FEATURE_NODE (node)) == ARV_GC_ACCESS_MODE_WO ||
+	    !arv_gc_feature_node_is_available (ARV_GC_FEATURE_NODE (node), NULL))
+		return;
+
+	g_ptr_array_add (features, node);
+
+	if (ARV_IS_GC_SELECTOR (node) && arv_gc_selector_is_selector (ARV_GC_SELECTOR (node)))
+		g_ptr_array_add (selectors, node);
+}
+
+static void
+arv_tool_dump_print_string (const char *string)
+{
+	const char *iter;
+
+	putchar ('"');
+	for (iter = string; *iter != '\0'; iter++) {
+		if (*iter == '"' || *iter == '\\')
+			printf ("\\%c", *iter);
+		else if ((unsigned char) *iter < 0x20)
+			printf ("\\u%04x", (unsigned char) *iter);
+		else
+			putchar (*iter);
+	}
+	putchar ('"');
+}
+
+/* Prints the features as the members of a JSON object, skipping the ones which can't be read. The registers of all
+ * the features are read first, in as few memory reads as possible. */
+
+static void
+arv_tool_dump_print_features (ArvGc *genicam, GPtrArray *features, int level)
+{
+	gboolean first = TRUE;
+	guint i;
+
+	arv_gc_prefetch_features (genicam, (ArvGcFeatureNode **) features->pdata, features->len);
+
+	printf ("{");
+
+	for (i = 0; i < features->len; i++) {
+		ArvGcNode *node = g_ptr_array_index (features, i);
+		GError *error = NULL;
+		const char *string_value = NULL;
+		gint64 int_value = 0;
+		double float_value = 0.0;
+		gboolean boolean_value = FALSE;
+
+		if (ARV_IS_GC_ENUMERATION (node) || ARV_IS_GC_STRING (node))
+			string_value = arv_gc_string_get_value (ARV_GC_STRING (node), &error);
+		else if (ARV_IS_GC_INTEGER (node))
+			int_value = arv_gc_integer_get_value (ARV_GC_INTEGER (node), &error);
+		else if (ARV_IS_GC_FLOAT (node))
+			float_value = arv_gc_float_get_value (ARV_GC_FLOAT (node), &error);
+		else if (ARV_IS_GC_BOOLEAN (node))
+			boolean_value = arv_gc_boolean_get_value (ARV_GC_BOOLEAN (node), &error);
+		else
+			continue;
+
+		if (error != NULL) {
+			g_clear_error (&error);
+			continue;
+		}
+
+		printf ("%s\n%*s", first ? "" : ",", 4 * (level + 1), "");
+		arv_tool_dump_print_string (arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (node)));
+		printf (": ");
+
+		if (ARV_IS_GC_ENUMERATION (node) || ARV_IS_GC_STRING (node))
+			arv_tool_dump_print_string (string_value != NULL ? string_value : "");
+		else if (ARV_IS_GC_INTEGER (node))
+			printf ("%" G_GINT64_FORMAT, int_value);
+		else if (ARV_IS_GC_FLOAT (node)) {
+			if (isfinite (float_value))
+				printf ("%.17g", float_value);
+			else
+				printf ("null");
+		} else
+			printf ("%s", boolean_value ? "true" : "false");
+
+		first = FALSE;
+	}
+
+	if (!first)
+		printf ("\n%*s", 4 * level, "");
+	printf ("}");
+}
+
+/* Sets the selector to each of its values, and prints the selected features for each of them. The selector value is
+ * restored afterwards. */
+
+static void
+arv_tool_dump_print_selector (ArvGc *genicam, ArvGcFeatureNode *selector, int level)
+{
+	GPtrArray *selected;
+	char **values = NULL;
+	char *original_value;
+	guint n_values = 0;
+	guint n_printed = 0;
+	guint i;
+
+	original_value = g_strdup (arv_gc_feature_node_get_value_as_string (selector, NULL));
+	if (original_value == NULL)
+		return;
+
+	if (ARV_IS_GC_ENUMERATION (selector)) {
+		const char **strings;
+
+		strings = arv_gc_enumeration_dup_available_string_values (ARV_GC_ENUMERATION (selector), &n_values, NULL);
+		values = g_new0 (char *, n_values + 1);
+		for (i = 0; i < n_values; i++)
+			values[i] = g_strdup (strings[i]);
+		g_free (strings);
+	} else if (ARV_IS_GC_INTEGER (selector)) {
+		gint64 min, max, inc;
+
+		min = arv_gc_integer_get_min (ARV_GC_INTEGER (selector), NULL);
+		max = arv_gc_integer_get_max (ARV_GC_INTEGER (selector), NULL);
+		inc = MAX (1, arv_gc_integer_get_inc (ARV_GC_INTEGER (selector), NULL));
+
+		values = g_new0 (char *, ARV_TOOL_DUMP_N_SELECTOR_VALUES_MAX + 1);
+		for (; min <= max && n_values < ARV_TOOL_DUMP_N_SELECTOR_VALUES_MAX; min += inc)
+			values[n_values++] = g_strdup_printf ("%" G_GINT64_FORMAT, min);
+	}
+
+	selected = g_ptr_array_new ();
+
+	printf ("{");
+
+	for (i = 0; i < n_values; i++) {
+		const GSList *iter;
+		GError *error = NULL;
+
+		arv_gc_feature_node_set_value_from_string (selector, values[i], &error);
+		if (error != NULL) {
+			g_clear_error (&error);
+			continue;
+		}
+
+		g_ptr_array_set_size (selected, 0);
+		for (iter = arv_gc_selector_get_selected_features (ARV_GC_SELECTOR (selector));
+		     iter != NULL;
+		     iter = iter->next)
+			if (arv_gc_feature_node_is_implemented (iter->data, NULL) &&
+			    arv_gc_feature_node_is_available (iter->data, NULL) &&
+			    !ARV_IS_GC_COMMAND (iter->data))
+				g_ptr_array_add (selected, iter->data);
+
+		printf ("%s\n%*s", n_printed > 0 ? "," : "", 4 * (level + 1), "");
+		arv_tool_dump_print_string (values[i]);
+		printf (": ");
+		arv_tool_dump_print_features (genicam, selected, level + 1);
+		n_printed++;
+	}
+
+	if (n_printed > 0)
+		printf ("\n%*s", 4 * level, "");
+	printf ("}");
+
+	arv_gc_feature_node_set_value_from_string (selector, original_value, NULL);
+
+	g_ptr_array_unref (selected);
+	g_strfreev (values);
+	g_free (original_value);
+}
+
+static void
+arv_tool_dump_features (ArvGc *genicam)
+{
+	GHashTable *visited;
+	GPtrArray *features;
+	GPtrArray *selectors;
+	guint i;
+
+	visited = g_hash_table_new (g_str_hash, g_str_equal);
+	features = g_ptr_array_new ();
+	selectors = g_ptr_array_new ();
+
+	arv_tool_dump_collect_features (genicam, "Root", visited, features, selectors);
+
+	printf ("{\n    \"features\": ");
+	arv_tool_dump_print_features (genicam, features, 1);
+	printf (",\n    \"selectors\": {");
+
+	for (i = 0; i < selectors->len; i++) {
+		ArvGcFeatureNode *selector = g_ptr_array_index (selectors, i);
+
+		printf ("%s\n        ", i > 0 ? "," : "");
+		arv_tool_dump_print_string (arv_gc_feature_node_get_name (selector));
+		printf (": ");
+		arv_tool_dump_print_selector (genicam, selector, 2);
+	}
+
+	printf ("%s}\n}\n", selectors->len > 0 ? "\n    " : "");
+
+	g_ptr_array_unref (selectors);
+	g_ptr_array_unref (features);
+	g_hash_table_unref (visited);
+}
+
+typedef enum {
+	ARV_TOOL_BENCH_READ_REGISTER,
+	ARV_TOOL_BENCH_WRITE_REGISTER,
+	ARV_TOOL_BENCH_READ_MEMORY
+} ArvToolBenchOperation;
+
+typedef struct {
+	ArvStream *stream;
+	gint n_frames;
+	gint n_failures;
+} ArvToolBenchStream;
+
+static int
+arv_tool_bench_compare_times (const void *a, const void *b)
+{
+	gint64 time_a = *(const gint64 *) a;
+	gint64 time_b = *(const gint64 *) b;
+
+	return time_a < time_b ? -1 : time_a > time_b ? 1 : 0;
+}
+
+/* Retries and pending acknowledges are only accounted by the GigE Vision devices */
+
+static gboolean
+arv_tool_bench_get_statistics (ArvDevice *device, ArvGvDeviceCommandStatistics *statistics)
+{
+	memset (statistics, 0, sizeof (ArvGvDeviceCommandStatistics));
+
+	if (!ARV_IS_GV_DEVICE (device))
+		return FALSE;
+
+	arv_gv_device_get_command_statistics (ARV_GV_DEVICE (device), statistics);
+
+	return TRUE;
+}
+
+static void
+arv_tool_bench_operation (ArvDevice *device, ArvToolBenchOperation operation, guint64 address, guint32 size,
+			  guint n_iterations)
+{
+	ArvGvDeviceCommandStatistics before, after;
+	GError *error = NULL;
+	gint64 *times_us;
+	gint64 total_us = 0;
+	guint32 value = 0;
+	guint n_errors = 0;
+	char *name;
+	void *buffer;
+	guint i;
+
+	name = operation == ARV_TOOL_BENCH_READ_MEMORY ?
+		g_strdup_printf ("read_memory %u", size) :
+		g_strdup (operation == ARV_TOOL_BENCH_READ_REGISTER ? "read_register" : "write_register");
+
+	/* The register is written back with its current value */
+	if (operation == ARV_TOOL_BENCH_WRITE_REGISTER &&
+	    !arv_device_read_register (device, address, &value, &error)) {
+		printf ("%-20s error: %s\n", name, error != NULL ? error->message : "unknown error");
+		g_clear_error (&error);
+		g_free (name);
+		return;
+	}
+
+	buffer = g_malloc0 (size);
+	times_us = g_new (gint64, n_iterations);
+
+	arv_tool_bench_get_statistics (device, &before);
+
+	for (i = 0; i < n_iterations; i++) {
+		gint64 start_us = g_get_monotonic_time ();
+		gboolean success = FALSE;
+
+		switch (operation) {
+			case ARV_TOOL_BENCH_READ_REGISTER:
+				success = arv_device_read_register (device, address, buffer, &error);
+				break;
+			case ARV_TOOL_BENCH_WRITE_REGISTER:
+				success = arv_device_write_register (device, address, value, &error);
+				break;
+			case ARV_TOOL_BENCH_READ_MEMORY:
+				success = arv_device_read_memory (device, address, size, buffer, &error);
+				break;
+		}
+
+		times_us[i] = g_get_monotonic_time () - start_us;
+		total_us += times_us[i];
+
+		if (!success)
+			n_errors++;
+		g_clear_error (&error);
+	}
+
+	qsort (times_us, n_iterations, sizeof (gint64), arv_tool_bench_compare_times);
+
+	printf ("%-20s %8u %8u %9.1f %9" G_GINT64_FORMAT " %9" G_GINT64_FORMAT " %9" G_GINT64_FORMAT
+		" %9" G_GINT64_FORMAT,
+		name, n_iterations, n_errors, (double) total_us / n_iterations,
+		times_us[(n_iterations - 1) / 2],
+		times_us[(n_iterations - 1) * 90 / 100],
+		times_us[(n_iterations - 1) * 99 / 100],
+		times_us[n_iterations - 1]);
+
+	if (arv_tool_bench_get_statistics (device, &after))
+		printf (" %8" G_GUINT64_FORMAT " %8" G_GUINT64_FORMAT,
+			after.n_retries - before.n_retries, after.n_pending_acks - before.n_pending_acks);
+	else
+		printf (" %8s %8s", "-", "-");
+
+	if (operation == ARV_TOOL_BENCH_READ_MEMORY && total_us > 0)
+		printf (" %9.3f", (double) size * (n_iterations - n_errors) / total_us);
+
+	printf ("\n");
+
+	g_free (times_us);
+	g_free (buffer);
+	g_free (name);
+}
+
+static void
+arv_tool_bench_stream_callback (void *user_data, ArvStreamCallbackType type, ArvBuffer *buffer)
+{
+	ArvToolBenchStream *bench_stream = user_data;
+
+	if (type != ARV_STREAM_CALLBACK_TYPE_BUFFER_DONE || buffer == NULL)
+		return;
+
+	if (arv_buffer_get_status (buffer) == ARV_BUFFER_STATUS_SUCCESS)
+		g_atomic_int_inc (&bench_stream->n_frames);
+	else
+		g_atomic_int_inc (&bench_stream->n_failures);
+
+	/* Buffers are recycled as soon as they are output, only the control channel is measured */
+	if (bench_stream->stream != NULL) {
+		ArvBuffer *done_buffer;
+
+		while ((done_buffer = arv_stream_try_pop_buffer (bench_stream->stream)) != NULL)
+			arv_stream_push_buffer (bench_stream->stream, done_buffer);
+	}
+}
+
+static gboolean
+arv_tool_bench_start_stream (ArvDevice *device, ArvToolBenchStream *bench_stream)
+{
+	GError *error = NULL;
+	gint64 payload_size;
+	guint i;
+
+	payload_size = arv_device_get_integer_feature_value (device, "PayloadSize", &error);
+	if (error == NULL)
+		bench_stream->stream = arv_device_create_stream (device, arv_tool_bench_stream_callback,
+								 bench_stream, &error);
+	if (error == NULL) {
+		for (i = 0; i < ARV_TOOL_BENCH_N_STREAM_BUFFERS; i++)
+			arv_stream_push_buffer (bench_stream->stream, arv_buffer_new (payload_size, NULL));
+		arv_device_execute_command (device, "AcquisitionStart", &error);
+	}
+
+	if (error != NULL) {
+		printf ("Failed to start the stream: %s\n", error->message);
+		g_clear_error (&error);
+		g_clear_object (&bench_stream->stream);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+static void
+arv_tool_bench_stop_stream (ArvDevice *device, ArvToolBenchStream *bench_stream)
+{
+	GError *error = NULL;
+
+	arv_device_execute_command (device, "AcquisitionStop", &error);
+	if (error != NULL) {
+		printf ("Failed to stop the stream: %s\n", error->message);
+		g_clear_error (&error);
+	}
+
+	g_clear_object (&bench_stream->stream);
+
+	printf ("%d frames received during the benchmark, %d failures\n",
+		g_atomic_int_get (&bench_stream->n_frames), g_atomic_int_get (&bench_stream->n_failures));
+}
+
+/* Measures the round trip times of the control channel, through the public register and memory accessors, which
+ * end up in the GVCP or UVCP command and acknowledge exchanges */
+
+static void
+arv_tool_bench_control (ArvDevice *device, int argc, char **argv)
+{
+	ArvToolBenchStream bench_stream = {NULL, 0, 0};
+	guint n_iterations = ARV_TOOL_BENCH_N_ITERATIONS_DEFAULT;
+	gboolean with_stream = FALSE;
+	guint j;
+	int i;
+
+	for (i = 0; i < argc; i++) {
+		if (g_strcmp0 (argv[i], "stream") == 0)
+			with_stream = TRUE;
+		else if (g_ascii_strtoull (argv[i], NULL, 10) > 0)
+			n_iterations = MIN (g_ascii_strtoull (argv[i], NULL, 10), G_MAXUINT);
+		else
+			printf ("Ignored bench-control argument '%s'\n", argv[i]);
+	}
+
+	if (with_stream && !arv_tool_bench_start_stream (device, &bench_stream))
+		return;
+
+	printf ("%-20s %8s %8s %9s %9s %9s %9s %9s %8s %8s %9s\n",
+		"Operation", "Count", "Errors", "Mean (µs)", "p50", "p90", "p99", "Max",
+		"Retries", "Pending", "MB/s");
+
+	arv_tool_bench_operation (device, ARV_TOOL_BENCH_READ_REGISTER, 0, sizeof (guint32), n_iterations);
+
+	/* The heartbeat timeout register can be written by the controller at any time */
+	if (ARV_IS_GV_DEVICE (device))
+		arv_tool_bench_operation (device, ARV_TOOL_BENCH_WRITE_REGISTER, ARV_GVBS_HEARTBEAT_TIMEOUT_OFFSET,
+					  sizeof (guint32), n_iterations);
+	else
+		printf ("%-20s (GigE Vision devices only)\n", "write_register");
+
+	for (j = 0; j < G_N_ELEMENTS (arv_tool_bench_read_memory_sizes); j++)
+		arv_tool_bench_operation (device, ARV_TOOL_BENCH_READ_MEMORY, 0,
+					  arv_tool_bench_read_memory_sizes[j], n_iterations);
+
+	if (with_stream)
+		arv_tool_bench_stop_stream (device, &bench_stream);
+}
+
+/* @device is NULL when the features are evaluated against @snapshot */
+
+/* Settings of the apply command, read from a JSON file in the format of the dump command */
+
+typedef struct {
+	char *selector;
+	char *selector_value;
+	char *feature;
+	char *value;
+} ArvToolApplySetting;
+
+typedef enum {
+	ARV_TOOL_APPLY_STATE_PENDING,
+	ARV_TOOL_APPLY_STATE_WRITTEN,
+	ARV_TOOL_APPLY_STATE_UNCHANGED,
+	ARV_TOOL_APPLY_STATE_SKIPPED,
+	ARV_TOOL_APPLY_STATE_NOT_FOUND
+} ArvToolApplyState;
+
+typedef struct {
+	ArvToolApplyState state;
+	char *message;
+} ArvToolApplyStatus;
+
+typedef struct {
+	const char *device_id;
+	GPtrArray *settings;
+	ArvRegisterCachePolicy register_cache_policy;
+	ArvRangeCheckPolicy range_check_policy;
+
+	gboolean is_open;
+	double open_time_s;
+	double apply_time_s;
+	double verify_time_s;
+	guint n_written;
+	guint n_registers;
+	guint n_unchanged;
+	guint n_skipped;
+	guint n_failures;
+	GString *report;
+	GError *error;
+} ArvToolApplyDevice;
+
+typedef struct {
+	const char *start;
+	const char *ptr;
+	GError *error;
+} ArvToolJsonParser;
+
+typedef gboolean (*ArvToolJsonMemberFunc) (ArvToolJsonParser *parser, const char *name, gpointer data);
+
+typedef struct {
+	GPtrArray *settings;
+	const char *selector;
+	const char *selector_value;
+} ArvToolApplyContext;
+
+static void
+arv_tool_apply_setting_free (gpointer data)
+{
+	ArvToolApplySetting *setting = data;
+
+	g_free (setting->selector);
+	g_free (setting->selector_value);
+	g_free (setting->feature);
+	g_free (setting->value);
+	g_free (setting);
+}
+
+static void
+arv_tool_json_set_error (ArvToolJsonParser *parser, const char *message)
+{
+	if (parser->error == NULL)
+		g_set_error (&parser->error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA,
+			     "%s at offset %" G_GSIZE_FORMAT, message, (gsize) (parser->ptr - parser->start));
+}
+
+static gboolean
+arv_tool_json_accept (ArvToolJsonParser *parser, char c)
+{
+	while (g_ascii_isspace (*parser->ptr))
+		parser->ptr++;
+
+	if (*parser->ptr != c)
+		return FALSE;
+
+	parser->ptr++;
+
+	return TRUE;
+}
+
+static gboolean
+arv_tool_json_expect (ArvToolJsonParser *parser, char c)
+{
+	char *message;
+
+	if (arv_tool_json_accept (parser, c))
+		return TRUE;
+
+	message = g_strdup_printf ("Expected '%c'", c);
+	arv_tool_json_set_error (parser, message);
+	g_free (message);
+
+	return FALSE;
+}
+
+static char *
+arv_tool_json_parse_string (ArvToolJsonParser *parser)
+{
+	GString *string;
+
+	if (!arv_tool_json_expect (parser, '"'))
+		return NULL;
+
+	string = g_string_new (NULL);
+
+	for (; *parser->ptr != '"'; parser->ptr++) {
+		if (*parser->ptr == '\0') {
+			arv_tool_json_set_error (parser, "Unterminated string");
+			g_string_free (string, TRUE);
+			return NULL;
+		}
+
+		if (*parser->ptr != '\\') {
+			g_string_append_c (string, *parser->ptr);
+			continue;
+		}
+
+		parser->ptr++;
+		switch (*parser->ptr) {
+			case 'b': g_string_append_c (string, '\b'); break;
+			case 'f': g_string_append_c (string, '\f'); break;
+			case 'n': g_string_append_c (string, '\n'); break;
+			case 'r': g_string_append_c (string, '\r'); break;
+			case 't': g_string_append_c (string, '\t'); break;
+			case 'u':
+				{
+					char hex[5] = {0};
+					int i;
+
+					for (i = 0; i < 4; i++) {
+						if (!g_ascii_isxdigit (parser->ptr[i + 1])) {
+							arv_tool_json_set_error (parser, "Invalid unicode escape");
+							g_string_free (string, TRUE);
+							return NULL;
+						}
+						hex[i] = parser->ptr[i + 1];
+					}
+					g_string_append_unichar (string, strtoul (hex, NULL, 16));
+					parser->ptr += 4;
+				}
+				break;
+			case '\0':
+				arv_tool_json_set_error (parser, "Unterminated string");
+				g_string_free (string, TRUE);
+				return NULL;
+			default:
+				g_string_append_c (string, *parser->ptr);
+				break;
+		}
+	}
+
+	parser->ptr++;
+
+	return g_string_free (string, FALSE);
+}
+
+/* Returns the string, number or boolean value as a string, which can be given to
+ * arv_gc_feature_node_set_value_from_string(), and NULL for the null value of the non finite floats */
+
+static char *
+arv_tool_json_parse_scalar (ArvToolJsonParser *parser)
+{
+	const char *start;
+
+	while (g_ascii_isspace (*parser->ptr))
+		parser->ptr++;
+
+	if (*parser->ptr == '"')
+		return arv_tool_json_parse_string (parser);
+
+	for (start = parser->ptr;
+	     g_ascii_isalnum (*parser->ptr) || *parser->ptr == '-' || *parser->ptr == '+' || *parser->ptr == '.';
+	     parser->ptr++);
+
+	if (parser->ptr == start) {
+		arv_tool_json_set_error (parser, "Expected a value");
+		return NULL;
+	}
+
+	if (parser->ptr - start == 4 && strncmp (start, "null", 4) == 0)
+		return NULL;
+
+	return g_strndup (start, parser->ptr - start);
+}
+
+static gboolean
+arv_tool_json_parse_object (ArvToolJsonParser *parser, ArvToolJsonMemberFunc member_func, gpointer data)
+{
+	if (!arv_tool_json_expect (parser, '{'))
+		return FALSE;
+
+	if (arv_tool_json_accept (parser, '}'))
+		return TRUE;
+
+	do {
+		gboolean success;
+		char *name;
+
+		name = arv_tool_json_parse_string (parser);
+		if (name == NULL)
+			return FALSE;
+
+		success = arv_tool_json_expect (parser, ':') && member_func (parser, name, data);
+		g_free (name);
+
+		if (!success)
+			return FALSE;
+	} while (arv_tool_json_accept (parser, ','));
+
+	return arv_tool_json_expect (parser, '}');
+}
+
+static gboolean
+arv_tool_apply_parse_feature (ArvToolJsonParser *parser, const char *name, gpointer data)
+{
+	ArvToolApplyContext *context = data;
+	ArvToolApplySetting *setting;
+	char *value;
+
+	value = arv_tool_json_parse_scalar (parser);
+	if (value == NULL)
+		return parser->error == NULL;
+
+	setting = g_new0 (ArvToolApplySetting, 1);
+	setting->selector = g_strdup (context->selector);
+	setting->selector_value = g_strdup (context->selector_value);
+	setting->feature = g_strdup (name);
+	setting->value = value;
+
+	g_ptr_array_add (context->settings, setting);
+
+	return TRUE;
+}
+
+static gboolean
+arv_tool_apply_parse_selector_value (ArvToolJsonParser *parser, const char *name, gpointer data)
+{
+	ArvToolApplyContext *context = data;
+	ArvToolApplyContext selected = {context->settings, context->selector, name};
+
+	return arv_tool_json_parse_object (parser, arv_tool_apply_parse_feature, &selected);
+}
+
+static gboolean
+arv_tool_apply_parse_selector (ArvToolJsonParser *parser, const char *name, gpointer data)
+{
+	ArvToolApplyContext *context = data;
+	ArvToolApplyContext selector = {context->settings, name, NULL};
+
+	return arv_tool_json_parse_object (parser, arv_tool_apply_parse_selector_value, &selector);
+}
+
+static gboolean
+arv_tool_apply_parse_root (ArvToolJsonParser *parser, const char *name, gpointer data)
+{
+	if (g_strcmp0 (name, "features") == 0)
+		return arv_tool_json_parse_object (parser, arv_tool_apply_parse_feature, data);
+	if (g_strcmp0 (name, "selectors") == 0)
+		return arv_tool_json_parse_object (parser, arv_tool_apply_parse_selector, data);
+
+	arv_tool_json_set_error (parser, "Unknown member");
+
+	return FALSE;
+}
+
+static GPtrArray *
+arv_tool_apply_load (const char *filename, GError **error)
+{
+	ArvToolApplyContext context = {NULL, NULL, NULL};
+	ArvToolJsonParser parser = {NULL, NULL, NULL};
+	GError *local_error = NULL;
+	char *content;
+
+	if (!g_file_get_contents (filename, &content, NULL, &local_error)) {
+		g_propagate_error (error, local_error);
+		return NULL;
+	}
+
+	context.settings = g_ptr_array_new_with_free_func (arv_tool_apply_setting_free);
+	parser.start = content;
+	parser.ptr = content;
+
+	if (arv_tool_json_parse_object (&parser, arv_tool_apply_parse_root, &context)) {
+		while (g_ascii_isspace (*parser.ptr))
+			parser.ptr++;
+		if (*parser.ptr != '\0')
+			arv_tool_json_set_error (&parser, "Trailing data");
+	}
+
+	g_free (content);
+
+	if (parser.error != NULL) {
+		g_propagate_prefixed_error (error, parser.error, "%s: ", filename);
+		g_ptr_array_unref (context.settings);
+		return NULL;
+	}
+
+	return context.settings;
+}
+
+static gboolean
+arv_tool_apply_value_matches (ArvGcFeatureNode *node, const char *value, GError **error)
+{
+	GError *local_error = NULL;
+	gboolean match = FALSE;
+
+	if (ARV_IS_GC_ENUMERATION (node) || ARV_IS_GC_STRING (node)) {
+		match = g_strcmp0 (arv_gc_string_get_value (ARV_GC_STRING (node), &local_error), value) == 0;
+	} else if (ARV_IS_GC_INTEGER (node)) {
+		match = arv_gc_integer_get_value (ARV_GC_INTEGER (node), &local_error) == g_ascii_strtoll (value, NULL, 0);
+	} else if (ARV_IS_GC_FLOAT (node)) {
+		double expected = g_ascii_strtod (value, NULL);
+
+		match = fabs (arv_gc_float_get_value (ARV_GC_FLOAT (node), &local_error) - expected) <=
+			ARV_TOOL_APPLY_FLOAT_TOLERANCE * MAX (1.0, fabs (expected));
+	} else if (ARV_IS_GC_BOOLEAN (node)) {
+		match = arv_gc_boolean_get_value (ARV_GC_BOOLEAN (node), &local_error) == (g_strcmp0 (value, "true") == 0);
+	}
+
+	if (local_error != NULL) {
+		g_propagate_error (error, local_error);
+		return FALSE;
+	}
+
+	return match;
+}
+
+/* Sets the selector of a selected setting. The first value of each selector is saved in @selectors, for
+ * arv_tool_apply_restore_selectors(). */
+
+static gboolean
+arv_tool_apply_select (ArvGc *genicam, ArvToolApplySetting *setting, GHashTable *selectors, GError **error)
+{
+	ArvGcNode *selector;
+	GError *local_error = NULL;
+	const char *value;
+
+	selector = arv_gc_get_node (genicam, setting->selector);
+	if (!ARV_IS_GC_FEATURE_NODE (selector)) {
+		g_set_error (error, ARV_GC_ERROR, ARV_GC_ERROR_NODE_NOT_FOUND,
+			     "Selector '%s' not found", setting->selector);
+		return FALSE;
+	}
+
+	value = arv_gc_feature_node_get_value_as_string (ARV_GC_FEATURE_NODE (selector), &local_error);
+	if (local_error != NULL) {
+		g_propagate_error (error, local_error);
+		return FALSE;
+	}
+
+	if (!g_hash_table_contains (selectors, setting->selector))
+		g_hash_table_insert (selectors, setting->selector, g_strdup (value));
+
+	if (g_strcmp0 (value, setting->selector_value) == 0)
+		return TRUE;
+
+	arv_gc_feature_node_set_value_from_string (ARV_GC_FEATURE_NODE (selector), setting->selector_value, &local_error);
+	if (local_error != NULL) {
+		g_propagate_error (error, local_error);
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+/* Puts the selectors back on their value of the features member, or on their previous value */
+
+static void
+arv_tool_apply_restore_selectors (ArvGc *genicam, GPtrArray *settings, GHashTable *selectors)
+{
+	GHashTableIter iter;
+	gpointer key, saved_value;
+	guint i;
+
+	g_hash_table_iter_init (&iter, selectors);
+	while (g_hash_table_iter_next (&iter, &key, &saved_value)) {
+		const char *value = saved_value;
+
+		for (i = 0; i < settings->len; i++) {
+			ArvToolApplySetting *setting = g_ptr_array_index (settings, i);
+
+			if (setting->selector == NULL && g_strcmp0 (setting->feature, key) == 0)
+				value = setting->value;
+		}
+
+		arv_gc_feature_node_set_value_from_string (ARV_GC_FEATURE_NODE (arv_gc_get_node (genicam, key)),
+							   value, NULL);
+	}
+
+	g_hash_table_remove_all (selectors);
+}
+
+static void
+arv_tool_apply_report (ArvToolApplyDevice *apply, ArvToolApplySetting *setting, const char *message)
+{
+	if (setting->selector != NULL)
+		g_string_append_printf (apply->report, "    %s[%s=%s]: %s\n",
+					setting->feature, setting->selector, setting->selector_value, message);
+	else
+		g_string_append_printf (apply->report, "    %s: %s\n", setting->feature, message);
+}
+
+/* Writes one setting, unless it already has the requested value. Returns FALSE if the setting is still pending,
+ * because of a write error or because the feature is not available yet. */
+
+static gboolean
+arv_tool_apply_setting (ArvGc *genicam, ArvToolApplySetting *setting, GHashTable *selectors,
+			ArvToolApplyStatus *status)
+{
+	ArvGcNode *node;
+	GError *error = NULL;
+
+	g_clear_pointer (&status->message, g_free);
+
+	node = arv_gc_get_node (genicam, setting->feature);
+	if (!ARV_IS_GC_FEATURE_NODE (node) || ARV_IS_GC_CATEGORY (node) || ARV_IS_GC_COMMAND (node)) {
+		status->state = ARV_TOOL_APPLY_STATE_NOT_FOUND;
+		return TRUE;
+	}
+
+	if (setting->selector != NULL && !arv_tool_apply_select (genicam, setting, selectors, &error)) {
+		status->message = g_strdup (error->message);
+		g_clear_error (&error);
+		return FALSE;
+	}
+
+	if (!arv_gc_feature_node_is_implemented (ARV_GC_FEATURE_NODE (node), NULL) ||
+	    arv_gc_feature_node_get_actual_access_mode (ARV_GC_FEATURE_NODE (node)) == ARV_GC_ACCESS_MODE_RO) {
+		status->state = ARV_TOOL_APPLY_STATE_SKIPPED;
+		return TRUE;
+	}
+
+	if (!arv_gc_feature_node_is_available (ARV_GC_FEATURE_NODE (node), NULL)) {
+		status->message = g_strdup ("not available");
+		return FALSE;
+	}
+
+	if (arv_gc_feature_node_is_locked (ARV_GC_FEATURE_NODE (node), NULL)) {
+		status->message = g_strdup ("locked");
+		return FALSE;
+	}
+
+	if (arv_tool_apply_value_matches (ARV_GC_FEATURE_NODE (node), setting->value, NULL)) {
+		status->state = ARV_TOOL_APPLY_STATE_UNCHANGED;
+		return TRUE;
+	}
+
+	arv_gc_feature_node_set_value_from_string (ARV_GC_FEATURE_NODE (node), setting->value, &error);
+	if (error != NULL) {
+		status->message = g_strdup (error->message);
+		g_clear_error (&error);
+		return FALSE;
+	}
+
+	status->state = ARV_TOOL_APPLY_STATE_WRITTEN;
+
+	return TRUE;
+}
+
+/* Applies the settings to the device, in a single register write batch, and reads back the written features.
+ * The settings which fail are retried in the next passes, as their range or availability may depend on settings
+ * coming later in the file. */
+
+static void
+arv_tool_apply (ArvToolApplyDevice *apply, ArvDevice *device, ArvGc *genicam)
+{
+	ArvToolApplyStatus *statuses;
+	GHashTable *selectors;
+	GPtrArray *prefetched;
+	GError *error = NULL;
+	gint64 start;
+	guint n_pending;
+	guint pass;
+	guint i;
+
+	start = g_get_monotonic_time ();
+
+	/* The current values are compared with the requested ones, using the register block cache */
+	arv_gc_set_register_cache_policy (genicam, arv_option_register_cache == NULL ?
+					  ARV_REGISTER_CACHE_POLICY_ENABLE : apply->register_cache_policy);
+	arv_gc_set_range_check_policy (genicam, apply->range_check_policy);
+
+	statuses = g_new0 (ArvToolApplyStatus, apply->settings->len);
+	selectors = g_hash_table_new_full (g_str_hash, g_str_equal, NULL, g_free);
+
+	prefetched = g_ptr_array_new ();
+	for (i = 0; i < apply->settings->len; i++) {
+		ArvToolApplySetting *setting = g_ptr_array_index (apply->settings, i);
+		ArvGcNode *node = arv_gc_get_node (genicam, setting->feature);
+
+		if (setting->selector == NULL && ARV_IS_GC_FEATURE_NODE (node) &&
+		    !ARV_IS_GC_CATEGORY (node) && !ARV_IS_GC_COMMAND (node))
+			g_ptr_array_add (prefetched, node);
+	}
+	arv_gc_prefetch_features (genicam, (ArvGcFeatureNode **) prefetched->pdata, prefetched->len);
+	g_ptr_array_unref (prefetched);
+
+	if (device != NULL)
+		arv_device_begin_batch (device);
+
+	n_pending = apply->settings->len;
+	for (pass = 0; pass < ARV_TOOL_APPLY_N_PASSES_MAX && n_pending > 0; pass++) {
+		guint n_done = 0;
+
+		for (i = 0; i < apply->settings->len; i++)
+			if (statuses[i].state == ARV_TOOL_APPLY_STATE_PENDING &&
+			    arv_tool_apply_setting (genicam, g_ptr_array_index (apply->settings, i), selectors,
+						    &statuses[i]))
+				n_done++;
+
+		n_pending -= n_done;
+		if (n_done == 0)
+			break;
+	}
+
+	arv_tool_apply_restore_selectors (genicam, apply->settings, selectors);
+
+	if (device != NULL && !arv_device_commit_batch (device, &apply->n_registers, &error))
+		g_propagate_prefixed_error (&apply->error, error, "Register write failed: ");
+
+	apply->apply_time_s = (g_get_monotonic_time () - start) / 1000000.0;
+
+	for (i = 0; i < apply->settings->len; i++) {
+		ArvToolApplySetting *setting = g_ptr_array_index (apply->settings, i);
+
+		switch (statuses[i].state) {
+			case ARV_TOOL_APPLY_STATE_WRITTEN:
+				apply->n_written++;
+				break;
+			case ARV_TOOL_APPLY_STATE_UNCHANGED:
+				apply->n_unchanged++;
+				break;
+			case ARV_TOOL_APPLY_STATE_SKIPPED:
+				apply->n_skipped++;
+				break;
+			case ARV_TOOL_APPLY_STATE_NOT_FOUND:
+				apply->n_failures++;
+				arv_tool_apply_report (apply, setting, "not found");
+				break;
+			case ARV_TOOL_APPLY_STATE_PENDING:
+				apply->n_failures++;
+				arv_tool_apply_report (apply, setting, statuses[i].message);
+				break;
+		}
+	}
+
+	if (apply->error == NULL) {
+		start = g_get_monotonic_time ();
+
+		/* The written features are read back from the device */
+		arv_gc_set_register_cache_policy (genicam, ARV_REGISTER_CACHE_POLICY_DISABLE);
+
+		for (i = 0; i < apply->settings->len; i++) {
+			ArvToolApplySetting *setting = g_ptr_array_index (apply->settings, i);
+			ArvGcFeatureNode *node;
+
+			if (statuses[i].state != ARV_TOOL_APPLY_STATE_WRITTEN)
+				continue;
+
+			node = ARV_GC_FEATURE_NODE (arv_gc_get_node (genicam, setting->feature));
+
+			if ((setting->selector == NULL || arv_tool_apply_select (genicam, setting, selectors, &error)) &&
+			    arv_tool_apply_value_matches (node, setting->value, &error))
+				continue;
+
+			apply->n_failures++;
+
+			if (error != NULL) {
+				arv_tool_apply_report (apply, setting, error->message);
+				g_clear_error (&error);
+			} else {
+				char *message;
+
+				message = g_strdup_printf ("read back as %s instead of %s",
+							   arv_gc_feature_node_get_value_as_string (node, NULL),
+							   setting->value);
+				arv_tool_apply_report (apply, setting, message);
+				g_free (message);
+			}
+		}
+
+		arv_tool_apply_restore_selectors (genicam, apply->settings, selectors);
+
+		apply->verify_time_s = (g_get_monotonic_time () - start) / 1000000.0;
+	}
+
+	for (i = 0; i < apply->settings->len; i++)
+		g_free (statuses[i].message);
+	g_free (statuses);
+	g_hash_table_unref (selectors);
+}
+
+static gpointer
+arv_tool_apply_thread (gpointer data)
+{
+	ArvToolApplyDevice *apply = data;
+	ArvDevice *device;
+	gint64 start;
+
+	start = g_get_monotonic_time ();
+
+	device = arv_open_device (apply->device_id, &apply->error);
+
+	apply->open_time_s = (g_get_monotonic_time () - start) / 1000000.0;
+
+	if (ARV_IS_DEVICE (device)) {
+		apply->is_open = TRUE;
+		arv_tool_apply (apply, device, arv_device_get_genicam (device));
+		g_object_unref (device);
+	}
+
+	return NULL;
+}
+
+/* Prints the timings and the failures of the apply command, and returns TRUE if the device is configured */
+
+static gboolean
+arv_tool_apply_print_report (ArvToolApplyDevice *apply)
+{
+	gboolean success;
+
+	if (apply->device_id != NULL)
+		printf ("%s: ", apply->device_id);
+
+	if (!apply->is_open) {
+		printf ("open failed after %.3f s: %s\n", apply->open_time_s,
+			apply->error != NULL ? apply->error->message : "unknown error");
+		return FALSE;
+	}
+
+	success = apply->error == NULL && apply->n_failures == 0;
+
+	if (apply->device_id != NULL)
+		printf ("open %.3f s, ", apply->open_time_s);
+	printf ("apply %.3f s, verify %.3f s, %u features written in %u registers, %u unchanged, %u skipped: %s\n",
+		apply->apply_time_s, apply->verify_time_s, apply->n_written, apply->n_registers,
+		apply->n_unchanged, apply->n_skipped, success ? "OK" : "FAILED");
+
+	if (apply->error != NULL)
+		printf ("    %s\n", apply->error->message);
+	printf ("%s", apply->report->str);
+
+	return success;
+}
+
+static void
+arv_tool_apply_device_clear (ArvToolApplyDevice *apply)
+{
+	g_string_free (apply->report, TRUE);
+	g_clear_error (&apply->error);
+}
+
+/* Opens all the devices concurrently, one thread per device, and applies the settings to them */
+
+static int
+arv_tool_apply_all (const char *filename,
+		    ArvRegisterCachePolicy register_cache_policy,
+		    ArvRangeCheckPolicy range_check_policy)
+{
+	ArvToolApplyDevice *applies;
+	GPtrArray *settings;
+	GThread **threads;
+	GError *error = NULL;
+	gint64 start;
+	guint n_devices;
+	guint n_configured = 0;
+	guint i;
+
+	settings = arv_tool_apply_load (filename, &error);
+	if (settings == NULL) {
+		fprintf (stderr, "%s\n", error->message);
+		g_clear_error (&error);
+		return EXIT_FAILURE;
+	}
+
+	start = g_get_monotonic_time ();
+
+	arv_update_device_list ();
+	n_devices = arv_get_n_devices ();
+
+	if (n_devices == 0) {
+		fprintf (stderr, "No device found\n");
+		g_ptr_array_unref (settings);
+		return EXIT_FAILURE;
+	}
+
+	applies = g_new0 (ArvToolApplyDevice, n_devices);
+	threads = g_new0 (GThread *, n_devices);
+
+	for (i = 0; i < n_devices; i++) {
+		applies[i].device_id = arv_get_device_id (i);
+		applies[i].settings = settings;
+		applies[i].register_cache_policy = register_cache_policy;
+		applies[i].range_check_policy = range_check_policy;
+		applies[i].report = g_string_new (NULL);
+		threads[i] = g_thread_new ("arv_tool_apply", arv_tool_apply_thread, &applies[i]);
+	}
+
+	for (i = 0; i < n_devices; i++)
+		g_thread_join (threads[i]);
+
+	for (i = 0; i < n_devices; i++) {
+		if (arv_tool_apply_print_report (&applies[i]))
+			n_configured++;
+		arv_tool_apply_device_clear (&applies[i]);
+	}
+
+	printf ("%u of %u devices configured in %.3f s\n", n_configured, n_devices,
+		(g_get_monotonic_time () - start) / 1000000.0);
+
+	g_free (threads);
+	g_free (applies);
+	g_ptr_array_unref (settings);
+
+	return n_configured == n_devices ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static void
+arv_tool_execute_command (int argc, char **argv, ArvDevice *device, ArvGc *genicam,
+			  ArvRegisterSnapshot *snapshot,
 			  ArvRegisterCachePolicy register_cache_policy,
 			  ArvRangeCheckPolicy range_check_policy)
 {
-	ArvGc *genicam;
+	ArvRegisterSnapshot *recorder = NULL;
 	const char *command = argv[1];
 	gint64 start;
 
-	if (device == NULL || argc < 2)
+	if (genicam == NULL || argc < 2)
 		return;
 
-	arv_device_set_register_cache_policy (device, register_cache_policy);
-	arv_device_set_range_check_policy (device, range_check_policy);
+	arv_gc_set_register_cache_policy (genicam, register_cache_policy);
+	arv_gc_set_range_check_policy (genicam, range_check_policy);
 
-	genicam = arv_device_get_genicam (device);
+	if (device != NULL && arv_option_record != NULL) {
+		const char *xml;
+		size_t size;
+
+		recorder = arv_register_snapshot_new ();
+		xml = arv_device_get_genicam_xml (device, &size);
+		arv_register_snapshot_set_genicam_xml (recorder, xml, size);
+		arv_gc_set_register_recorder (genicam, recorder);
+	}
 
 	start = g_get_monotonic_time ();
 
@@ -235,7 +1559,9 @@ arv_tool_execute_command (int argc, char **argv, ArvDevice *device,
 		const char *xml;
 		size_t size;
 
-		xml = arv_device_get_genicam_xml (device, &size);
+		xml = device != NULL ?
+			arv_device_get_genicam_xml (device, &size) :
+			arv_register_snapshot_get_genicam_xml (snapshot, &size);
 		if (xml != NULL)
 			printf ("%*s\n", (int) size, xml);
 	} else if (g_strcmp0 (command, "features") == 0) {
@@ -271,7 +1597,7 @@ arv_tool_execute_command (int argc, char **argv, ArvDevice *device,
 			char **tokens;
 
 			tokens = g_strsplit (argv[i], "=", 2);
-			feature = arv_device_get_feature (device, tokens[0]);
+			feature = arv_gc_get_node (genicam, tokens[0]);
 			if (ARV_IS_GC_FEATURE_NODE (feature)) {
 				if (ARV_IS_GC_COMMAND (feature)) {
 					arv_gc_command_execute (ARV_GC_COMMAND (feature), NULL);
@@ -369,7 +1695,9 @@ arv_tool_execute_command (int argc, char **argv, ArvDevice *device,
 					}
 				}
 			} else {
-				if (g_strrstr (tokens[0], "R[") == tokens[0]) {
+				if (g_strrstr (tokens[0], "R[") == tokens[0] && device == NULL) {
+					printf ("%s: register access requires a device\n", tokens[0]);
+				} else if (g_strrstr (tokens[0], "R[") == tokens[0]) {
 					guint32 value;
 					guint32 address;
 
@@ -391,12 +1719,161 @@ arv_tool_execute_command (int argc, char **argv, ArvDevice *device,
 			}
 			g_strfreev (tokens);
 		}
+	} else if (g_strcmp0 (command, "profile") == 0) {
+		arv_tool_profile_features (genicam, argc - 2, &argv[2]);
+	} else if (g_strcmp0 (command, "bench-control") == 0) {
+		if (device != NULL)
+			arv_tool_bench_control (device, argc - 2, &argv[2]);
+		else
+			printf ("bench-control requires a device\n");
+	} else if (g_strcmp0 (command, "apply") == 0) {
+		GPtrArray *settings;
+		GError *error = NULL;
+
+		settings = argc > 2 ? arv_tool_apply_load (argv[2], &error) : NULL;
+		if (settings != NULL) {
+			ArvToolApplyDevice apply = {0};
+
+			apply.settings = settings;
+			apply.register_cache_policy = register_cache_policy;
+			apply.range_check_policy = range_check_policy;
+			apply.is_open = TRUE;
+			apply.report = g_string_new (NULL);
+
+			arv_tool_apply (&apply, device, genicam);
+			arv_tool_apply_print_report (&apply);
+
+			arv_tool_apply_device_clear (&apply);
+			g_ptr_array_unref (settings);
+		} else if (error != NULL) {
+			printf ("%s\n", error->message);
+			g_clear_error (&error);
+		} else {
+			printf ("apply requires a file\n");
+		}
+	} else if (g_strcmp0 (command, "dump") == 0) {
+		/* The coalesced register reads go through the register block cache */
+		if (arv_option_register_cache == NULL)
+			arv_gc_set_register_cache_policy (genicam, ARV_REGISTER_CACHE_POLICY_ENABLE);
+		arv_tool_dump_features (genicam);
 	} else {
 		printf ("Unknown command\n");
 	}
 
 	if (arv_option_show_time)
 		printf ("Executed in %g s\n", (g_get_monotonic_time () - start) / 1000000.0);
+
+	if (recorder != NULL) {
+		GError *error = NULL;
+
+		arv_gc_set_register_recorder (genicam, NULL);
+		if (!arv_register_snapshot_save (recorder, arv_option_record, &error)) {
+			fprintf (stderr, "Failed to save the register snapshot: %s\n", error->message);
+			g_clear_error (&error);
+		}
+		g_object_unref (recorder);
+	}
+}
+
+static int
+arv_tool_execute_offline_command (int argc, char **argv,
+				  ArvRegisterCachePolicy register_cache_policy,
+				  ArvRangeCheckPolicy range_check_policy)
+{
+	ArvRegisterSnapshot *snapshot;
+	ArvGc *genicam;
+	GError *error = NULL;
+	const char *xml;
+	size_t size;
+
+	snapshot = arv_register_snapshot_new_from_file (arv_option_snapshot, &error);
+	if (snapshot == NULL) {
+		fprintf (stderr, "%s\n", error->message);
+		g_clear_error (&error);
+		return EXIT_FAILURE;
+	}
+
+	xml = arv_register_snapshot_get_genicam_xml (snapshot, &size);
+	if (xml == NULL) {
+		fprintf (stderr, "No Genicam data in '%s'\n", arv_option_snapshot);
+		g_object_unref (snapshot);
+		return EXIT_FAILURE;
+	}
+
+	genicam = arv_gc_new (NULL, xml, size);
+	arv_gc_set_register_snapshot (genicam, snapshot);
+
+	arv_tool_execute_command (argc, argv, NULL, genicam, snapshot, register_cache_policy, range_check_policy);
+
+	g_object_unref (genicam);
+	g_object_unref (snapshot);
+
+	return EXIT_SUCCESS;
+}
+
+static int
+arv_tool_decode_frames (int argc, char **argv)
+{
+	int status = EXIT_SUCCESS;
+	int i;
+
+	for (i = 2; i < argc; i++) {
+		ArvFrameLogRecord *records;
+		GError *error = NULL;
+		guint64 n_dropped = 0;
+		guint n_records;
+		char *string;
+
+		records = arv_frame_log_load (argv[i], &n_records, &n_dropped, &error);
+		if (records == NULL) {
+			fprintf (stderr, "%s\n", error->message);
+			g_clear_error (&error);
+			status = EXIT_FAILURE;
+			continue;
+		}
+
+		if (argc > 3)
+			printf ("%s:\n", argv[i]);
+		string = arv_frame_log_records_to_string (records, n_records);
+		printf ("%s", string);
+		if (n_dropped > 0)
+			printf ("%" G_GUINT64_FORMAT " frames not logged, the log was full\n", n_dropped);
+		g_free (string);
+		g_free (records);
+	}
+
+	return status;
+}
+
+static int
+arv_tool_decode_events (int argc, char **argv)
+{
+	int status = EXIT_SUCCESS;
+	int i;
+
+	for (i = 2; i < argc; i++) {
+		ArvEventRecord *records;
+		GError *error = NULL;
+		guint n_records;
+		char *string;
+
+		records = arv_event_ring_load (argv[i], &n_records, &error);
+		if (records == NULL) {
+			fprintf (stderr, "%s\n", error->message);
+			g_clear_error (&error);
+			status = EXIT_FAILURE;
+			continue;
+		}
+
+		if (argc > 3)
+			printf ("%s:\n", argv[i]);
+		string = arv_event_ring_records_to_string (records, n_records);
+		printf ("%s", string);
+		g_free (string);
+		g_free (records);
+	}
+
+	return status;
 }
 
 int
@@ -459,6 +1936,34 @@ main (int argc, char **argv)
 		return EXIT_FAILURE;
 	}
 
+	if (argc >= 2 && g_strcmp0 (argv[1], "events") == 0)
+		return arv_tool_decode_events (argc, argv);
+	if (argc >= 2 && g_strcmp0 (argv[1], "frames") == 0)
+		return arv_tool_decode_frames (argc, argv);
+
+	if (arv_option_all) {
+		int status;
+
+		if (argc < 3 || g_strcmp0 (argv[1], "apply") != 0) {
+			printf ("--all is only supported by the apply command\n");
+			return EXIT_FAILURE;
+		}
+
+		status = arv_tool_apply_all (argv[2], register_cache_policy, range_check_policy);
+
+		arv_shutdown ();
+
+		return status;
+	}
+
+	if (arv_option_snapshot != NULL) {
+		if (argc < 2) {
+			printf ("A command is required with --snapshot\n");
+			return EXIT_FAILURE;
+		}
+		return arv_tool_execute_offline_command (argc, argv, register_cache_policy, range_check_policy);
+	}
+
 	device_id = arv_option_device_address != NULL ? arv_option_device_address : arv_option_device_name;
 	if (device_id != NULL) {
 		GError *error = NULL;
@@ -468,7 +1973,7 @@ main (int argc, char **argv)
 			if (argc < 2) {
 				printf ("%s\n", device_id);
 			} else {
-				arv_tool_execute_command (argc, argv, device,
+				arv_tool_execute_command (argc, argv, device, arv_device_get_genicam (device), NULL,
 							  register_cache_policy, range_check_policy);
 			}
 			g_object_unref (device);
@@ -495,8 +2000,8 @@ main (int argc, char **argv)
 					device = arv_open_device (device_id, &error);
 
 					if (ARV_IS_DEVICE (device)) {
-						arv_tool_execute_command (argc, argv, device,
-									  register_cache_policy, range_check_policy);
+						arv_tool_execute_command (argc, argv, device, arv_device_get_genicam (device),
+									  NULL, register_cache_policy, range_check_policy);
 
 						g_object_unref (device);
 					} else {
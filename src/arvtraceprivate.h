@@ -0,0 +1,59 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2019 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel@gnome.org>
+ */
+
+#ifndef ARV_TRACE_PRIVATE_H
+#define ARV_TRACE_PRIVATE_H
+
+#if !defined (ARV_H_INSIDE) && !defined (ARAVIS_COMPILATION)
+#error "Only <arv.h> can be included directly."
+#endif
+
+#include <arvfeatures.h>
+
+/* Static tracepoints of the stream data path, in the "aravis" provider. With the usdt option, they are systemtap SDT
+ * probes, which are a single nop until a tracer (bpftrace, perf, systemtap) attaches to them, for example:
+ *
+ *   bpftrace -e 'usdt:/usr/lib/libaravis-0.8.so:aravis:frame_closed { @[arg1] = count (); }'
+ *
+ * Without it, they are compiled out. All the times are monotonic times in µs. */
+
+#if ARAVIS_HAS_USDT
+
+#include <sys/sdt.h>
+
+#define ARV_TRACE_LEADER_RECEIVED(frame_id,time_us)		DTRACE_PROBE2 (aravis, leader_received, frame_id, time_us)
+#define ARV_TRACE_FIRST_RESEND(frame_id,first_packet,time_us)	DTRACE_PROBE3 (aravis, first_resend, frame_id, first_packet, time_us)
+#define ARV_TRACE_FRAME_CLOSED(frame_id,status,time_us)		DTRACE_PROBE3 (aravis, frame_closed, frame_id, status, time_us)
+#define ARV_TRACE_BUFFER_PUSHED(frame_id,time_us)		DTRACE_PROBE2 (aravis, buffer_pushed, frame_id, time_us)
+#define ARV_TRACE_BUFFER_POPPED(frame_id,time_us)		DTRACE_PROBE2 (aravis, buffer_popped, frame_id, time_us)
+
+#else
+
+#define ARV_TRACE_LEADER_RECEIVED(frame_id,time_us)
+#define ARV_TRACE_FIRST_RESEND(frame_id,first_packet,time_us)
+#define ARV_TRACE_FRAME_CLOSED(frame_id,status,time_us)
+#define ARV_TRACE_BUFFER_PUSHED(frame_id,time_us)
+#define ARV_TRACE_BUFFER_POPPED(frame_id,time_us)
+
+#endif
+
+#endif
@@ -80,6 +80,8 @@ typedef struct _ArvInterface 		ArvInterface;
 typedef struct _ArvDevice 		ArvDevice;
 typedef struct _ArvStream 		ArvStream;
 typedef struct _ArvChunkParser		ArvChunkParser;
+typedef struct _ArvChunkPlan		ArvChunkPlan;
+typedef struct _ArvBufferAllocator	ArvBufferAllocator;
 
 typedef struct _ArvGvInterface 		ArvGvInterface;
 typedef struct _ArvGvDevice 		ArvGvDevice;
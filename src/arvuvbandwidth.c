@@ -0,0 +1,266 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2025 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel@gnome.org>
+ */
+
+/*
+ * SECTION: arvuvbandwidth
+ * @short_description: Bandwidth allocation between the USB3Vision devices of a bus
+ *
+ * The open USB3Vision devices are grouped by the USB bus they are connected to. When a bandwidth budget is given
+ * for a bus using arv_uv_set_bus_bandwidth(), it is divided between the devices of this bus proportionally to
+ * their weight, and each share is programmed in the DeviceLinkThroughputLimit feature of the device. The shares are
+ * computed again each time a device of the bus is opened or closed, or when a weight or the budget changes.
+ */
+
+#include <arvuvbandwidthprivate.h>
+#include <arvdevice.h>
+#include <arvdebugprivate.h>
+
+typedef struct {
+	guint bus_number;
+	guint bandwidth;
+	guint64 n_frame_losses;
+	GSList *devices;
+} ArvUvBus;
+
+static GMutex arv_uv_bandwidth_mutex;
+static GSList *arv_uv_buses = NULL;
+
+static ArvUvBus *
+_find_bus (guint bus_number, gboolean create)
+{
+	ArvUvBus *bus;
+	GSList *iter;
+
+	for (iter = arv_uv_buses; iter != NULL; iter = iter->next) {
+		bus = iter->data;
+		if (bus->bus_number == bus_number)
+			return bus;
+	}
+
+	if (!create)
+		return NULL;
+
+	bus = g_new0 (ArvUvBus, 1);
+	bus->bus_number = bus_number;
+	arv_uv_buses = g_slist_prepend (arv_uv_buses, bus);
+
+	return bus;
+}
+
+/* Must be called with the registry mutex held. The devices of the list can not be finalized meanwhile, as they leave
+ * the registry before releasing their resources. */
+
+static void
+_allocate (ArvUvBus *bus)
+{
+	GSList *iter;
+	double total_weight = 0.0;
+
+	if (bus->bandwidth == 0)
+		return;
+
+	for (iter = bus->devices; iter != NULL; iter = iter->next)
+		total_weight += arv_uv_device_get_bandwidth_weight (iter->data);
+
+	if (total_weight <= 0.0)
+		return;
+
+	for (iter = bus->devices; iter != NULL; iter = iter->next) {
+		ArvDevice *device = iter->data;
+		GError *error = NULL;
+		double weight = arv_uv_device_get_bandwidth_weight (iter->data);
+		gint64 share, min, max;
+
+		if (weight <= 0.0 ||
+		    !arv_device_is_feature_available (device, "DeviceLinkThroughputLimit", NULL))
+			continue;
+
+		share = (gint64) ((double) bus->bandwidth * weight / total_weight);
+
+		arv_device_get_integer_feature_bounds (device, "DeviceLinkThroughputLimit", &min, &max, &error);
+		if (error == NULL) {
+			share = CLAMP (share, min, max);
+			arv_device_set_integer_feature_value (device, "DeviceLinkThroughputLimit", share, &error);
+		}
+		if (error == NULL &&
+		    arv_device_is_feature_available (device, "DeviceLinkThroughputLimitMode", NULL))
+			arv_device_set_integer_feature_value (device, "DeviceLinkThroughputLimitMode", 1, &error);
+
+		if (error != NULL) {
+			arv_warning_device ("[UvBandwidth::allocate] Failed to set bandwidth of device on bus %u: %s",
+					    bus->bus_number, error->message);
+			g_clear_error (&error);
+		} else
+			arv_info_device ("[UvBandwidth::allocate] Bus %u: share %" G_GINT64_FORMAT " (weight %g/%g)",
+					 bus->bus_number, share, weight, total_weight);
+	}
+}
+
+void
+arv_uv_bandwidth_add_device (ArvUvDevice *uv_device)
+{
+	ArvUvBus *bus;
+	guint bus_number;
+
+	bus_number = arv_uv_device_get_bus_number (uv_device);
+	if (bus_number == 0)
+		return;
+
+	g_mutex_lock (&arv_uv_bandwidth_mutex);
+
+	bus = _find_bus (bus_number, TRUE);
+	bus->devices = g_slist_append (bus->devices, uv_device);
+	_allocate (bus);
+
+	g_mutex_unlock (&arv_uv_bandwidth_mutex);
+}
+
+void
+arv_uv_bandwidth_remove_device (ArvUvDevice *uv_device)
+{
+	ArvUvBus *bus;
+
+	g_mutex_lock (&arv_uv_bandwidth_mutex);
+
+	bus = _find_bus (arv_uv_device_get_bus_number (uv_device), FALSE);
+	if (bus != NULL && g_slist_find (bus->devices, uv_device) != NULL) {
+		bus->devices = g_slist_remove (bus->devices, uv_device);
+		_allocate (bus);
+	}
+
+	g_mutex_unlock (&arv_uv_bandwidth_mutex);
+}
+
+void
+arv_uv_bandwidth_update_device (ArvUvDevice *uv_device)
+{
+	ArvUvBus *bus;
+
+	g_mutex_lock (&arv_uv_bandwidth_mutex);
+
+	bus = _find_bus (arv_uv_device_get_bus_number (uv_device), FALSE);
+	if (bus != NULL && g_slist_find (bus->devices, uv_device) != NULL)
+		_allocate (bus);
+
+	g_mutex_unlock (&arv_uv_bandwidth_mutex);
+}
+
+void
+arv_uv_bandwidth_report_frame_loss (ArvUvDevice *uv_device)
+{
+	ArvUvBus *bus;
+	guint bus_number;
+
+	bus_number = arv_uv_device_get_bus_number (uv_device);
+	if (bus_number == 0)
+		return;
+
+	g_mutex_lock (&arv_uv_bandwidth_mutex);
+
+	bus = _find_bus (bus_number, TRUE);
+	bus->n_frame_losses++;
+
+	g_mutex_unlock (&arv_uv_bandwidth_mutex);
+}
+
+/**
+ * arv_uv_set_bus_bandwidth:
+ * @bus_number: a USB bus number, as returned by arv_uv_device_get_bus_number()
+ * @bandwidth: total bandwidth of the bus, in the unit of the DeviceLinkThroughputLimit feature, 0 to disable the
+ * allocation
+ *
+ * Sets the bandwidth budget shared by the USB3Vision devices of a bus. The budget is divided between the open
+ * devices of the bus proportionally to their weight, see arv_uv_device_set_bandwidth_weight(), and each share is
+ * written in the DeviceLinkThroughputLimit feature of the device, clamped to the feature bounds. Devices without
+ * this feature are ignored. When the allocation is disabled, the limits already programmed are left untouched.
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_uv_set_bus_bandwidth (guint bus_number, guint bandwidth)
+{
+	ArvUvBus *bus;
+
+	g_return_if_fail (bus_number > 0);
+
+	g_mutex_lock (&arv_uv_bandwidth_mutex);
+
+	bus = _find_bus (bus_number, TRUE);
+	bus->bandwidth = bandwidth;
+	_allocate (bus);
+
+	g_mutex_unlock (&arv_uv_bandwidth_mutex);
+}
+
+/**
+ * arv_uv_get_bus_bandwidth:
+ * @bus_number: a USB bus number
+ *
+ * Returns: the bandwidth budget of the bus, 0 if the allocation is disabled
+ *
+ * Since: 0.8.11
+ */
+
+guint
+arv_uv_get_bus_bandwidth (guint bus_number)
+{
+	ArvUvBus *bus;
+	guint bandwidth = 0;
+
+	g_mutex_lock (&arv_uv_bandwidth_mutex);
+
+	bus = _find_bus (bus_number, FALSE);
+	if (bus != NULL)
+		bandwidth = bus->bandwidth;
+
+	g_mutex_unlock (&arv_uv_bandwidth_mutex);
+
+	return bandwidth;
+}
+
+/**
+ * arv_uv_get_bus_n_frame_losses:
+ * @bus_number: a USB bus number
+ *
+ * Returns: the number of frames lost by the streams of all the devices connected to this bus, since the start of the
+ * process. A growing count is a hint of an oversubscribed bus.
+ *
+ * Since: 0.8.11
+ */
+
+guint64
+arv_uv_get_bus_n_frame_losses (guint bus_number)
+{
+	ArvUvBus *bus;
+	guint64 n_frame_losses = 0;
+
+	g_mutex_lock (&arv_uv_bandwidth_mutex);
+
+	bus = _find_bus (bus_number, FALSE);
+	if (bus != NULL)
+		n_frame_losses = bus->n_frame_losses;
+
+	g_mutex_unlock (&arv_uv_bandwidth_mutex);
+
+	return n_frame_losses;
+}
@@ -0,0 +1,41 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2025 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel@gnome.org>
+ */
+
+#ifndef ARV_UV_BANDWIDTH_PRIVATE_H
+#define ARV_UV_BANDWIDTH_PRIVATE_H
+
+#if !defined (ARV_H_INSIDE) && !defined (ARAVIS_COMPILATION)
+#error "Only <arv.h> can be included directly."
+#endif
+
+#include <arvuvdevice.h>
+
+G_BEGIN_DECLS
+
+void		arv_uv_bandwidth_add_device		(ArvUvDevice *uv_device);
+void		arv_uv_bandwidth_remove_device		(ArvUvDevice *uv_device);
+void		arv_uv_bandwidth_update_device		(ArvUvDevice *uv_device);
+void		arv_uv_bandwidth_report_frame_loss	(ArvUvDevice *uv_device);
+
+G_END_DECLS
+
+#endif
@@ -103,6 +103,93 @@ arv_uvcp_packet_new_write_memory_cmd (guint64 address, guint32 size, guint16 pac
 	return (ArvUvcpPacket *) packet;
 }
 
+/**
+ * arv_uvcp_packet_new_event_cmd: (skip)
+ * @event_id: event id
+ * @timestamp: device timestamp of the event
+ * @data: (allow-none): event data
+ * @data_size: size of @data, in bytes
+ * @packet_id: packet id
+ * @packet_size: (out): packet size, in bytes
+ * Return value: (transfer full): a new #ArvUvcpPacket
+ *
+ * Create a uvcp packet for an event command, as sent by the device on the event endpoint.
+ */
+
+ArvUvcpPacket *
+arv_uvcp_packet_new_event_cmd (guint16 event_id, guint64 timestamp, const void *data, size_t data_size,
+			       guint16 packet_id, size_t *packet_size)
+{
+	ArvUvcpEventCmd *packet;
+
+	g_return_val_if_fail (packet_size != NULL, NULL);
+	g_return_val_if_fail (data != NULL || data_size == 0, NULL);
+
+	*packet_size = sizeof (ArvUvcpEventCmd) + data_size;
+
+	packet = g_malloc (*packet_size);
+
+	packet->header.magic = GUINT32_TO_LE (ARV_UVCP_MAGIC);
+	packet->header.flags = 0;
+	packet->header.command = GUINT16_TO_LE (ARV_UVCP_COMMAND_EVENT_CMD);
+	packet->header.size = GUINT16_TO_LE (sizeof (ArvUvcpEventCmdInfos) + data_size);
+	packet->header.id = GUINT16_TO_LE (packet_id);
+	packet->infos.unknown = 0;
+	packet->infos.event_id = GUINT16_TO_LE (event_id);
+	packet->infos.timestamp = GUINT64_TO_LE (timestamp);
+
+	if (data_size > 0)
+		memcpy (((char *) packet) + sizeof (ArvUvcpEventCmd), data, data_size);
+
+	return (ArvUvcpPacket *) packet;
+}
+
+/**
+ * arv_uvcp_packet_get_event: (skip)
+ * @packet: an event command
+ * @packet_size: received size, in bytes
+ * @event_id: (out): event id
+ * @timestamp: (out): device timestamp of the event
+ * @data: (out) (allow-none): event data, %NULL if the event has no data
+ * @data_size: (out) (allow-none): size of @data, in bytes
+ *
+ * Decodes the event command received on the event endpoint.
+ *
+ * Return value: %TRUE if @packet is a valid event command.
+ */
+
+gboolean
+arv_uvcp_packet_get_event (const ArvUvcpPacket *packet, size_t packet_size,
+			   guint16 *event_id, guint64 *timestamp, const void **data, size_t *data_size)
+{
+	const ArvUvcpEventCmd *event;
+	size_t size;
+
+	g_return_val_if_fail (packet != NULL, FALSE);
+
+	if (packet_size < sizeof (ArvUvcpEventCmd) ||
+	    GUINT32_FROM_LE (packet->header.magic) != ARV_UVCP_MAGIC ||
+	    arv_uvcp_packet_get_command (packet) != ARV_UVCP_COMMAND_EVENT_CMD)
+		return FALSE;
+
+	size = GUINT16_FROM_LE (packet->header.size);
+	if (size < sizeof (ArvUvcpEventCmdInfos) || sizeof (ArvUvcpHeader) + size > packet_size)
+		return FALSE;
+
+	event = (const ArvUvcpEventCmd *) packet;
+
+	if (event_id != NULL)
+		*event_id = GUINT16_FROM_LE (event->infos.event_id);
+	if (timestamp != NULL)
+		*timestamp = GUINT64_FROM_LE (event->infos.timestamp);
+	if (data != NULL)
+		*data = size > sizeof (ArvUvcpEventCmdInfos) ? ((const char *) packet) + sizeof (ArvUvcpEventCmd) : NULL;
+	if (data_size != NULL)
+		*data_size = size - sizeof (ArvUvcpEventCmdInfos);
+
+	return TRUE;
+}
+
 static const char *
 arv_enum_to_string (GType type,
 		    guint enum_value)
@@ -200,6 +287,16 @@ arv_uvcp_packet_to_string (const ArvUvcpPacket *packet)
 							G_GINT64_MODIFIER "x)\n", value, value);
 				break;
 			}
+		case ARV_UVCP_COMMAND_EVENT_CMD:
+			{
+				ArvUvcpEventCmd *cmd_packet = (void *) packet;
+
+				value = GUINT16_FROM_LE (cmd_packet->infos.event_id);
+				g_string_append_printf (string, "event id     = 0x%04" G_GINT64_MODIFIER "x\n", value);
+				value = GUINT64_FROM_LE (cmd_packet->infos.timestamp);
+				g_string_append_printf (string, "timestamp    = %10" G_GINT64_MODIFIER "u\n", value);
+				break;
+			}
 	}
 
 	packet_size = sizeof (ArvUvcpHeader) + GUINT16_FROM_LE (packet->header.size);
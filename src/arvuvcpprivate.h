@@ -73,6 +73,12 @@ G_BEGIN_DECLS
 #define ARV_SBRM_CURRENT_SPEED			0x0040
 #define ARV_SBRM_RESERVED			0x0044
 
+#define ARV_EIRM_CONTROL			0x0000
+#define ARV_EIRM_MAX_EVENT_TRANSFER_LENGTH	0x0004
+#define ARV_EIRM_EVENT_TEST_CONTROL		0x0008
+
+#define ARV_EIRM_CONTROL_ENABLE			0x00000001
+
 #define ARV_SIRM_INFO				0x0000
 #define ARV_SIRM_CONTROL			0x0004
 #define ARV_SIRM_REQ_PAYLOAD_SIZE		0x0008
@@ -153,6 +159,7 @@ typedef enum {
  * @ARV_UVCP_COMMAND_WRITE_MEMORY_ACK: write memory acknowledge
  * @ARV_UVCP_COMMAND_PENDING_ACK: pending command acknowledge
  * @ARV_UVCP_COMMAND_EVENT_CMD: event command
+ * @ARV_UVCP_COMMAND_EVENT_ACK: event acknowledge
  */
 
 typedef enum {
@@ -224,6 +231,17 @@ typedef struct {
 	ArvUvcpPendingAckInfos infos;
 } ArvUvcpPendingAck;
 
+typedef struct {
+	guint16 unknown;	/* Listed as reserved */
+	guint16 event_id;
+	guint64 timestamp;
+} ArvUvcpEventCmdInfos;
+
+typedef struct {
+	ArvUvcpHeader header;
+	ArvUvcpEventCmdInfos infos;
+} ArvUvcpEventCmd;
+
 /**
  * ArvUvcpPacket:
  * @header: packet header
@@ -244,11 +262,8 @@ typedef struct {
 	guint32 schema;
 	guint64 address;
 	guint64 size;
-	guint64 unknown3;
-	guint64 unknown4;
-	guint64 unknown5;
-	guint64 unknown6;
-	guint64 unknown7;
+	guint8 sha1_hash[20];
+	guint8 reserved[20];
 } ArvUvcpManifestEntry;
 
 #pragma pack(pop)
@@ -281,6 +296,12 @@ ArvUvcpPacket * 	arv_uvcp_packet_new_read_memory_cmd 	(guint64 address, guint32
 								 guint16 packet_id, size_t *packet_size);
 ArvUvcpPacket * 	arv_uvcp_packet_new_write_memory_cmd	(guint64 address, guint32 size,
 								 guint16 packet_id, size_t *packet_size);
+ArvUvcpPacket *		arv_uvcp_packet_new_event_cmd		(guint16 event_id, guint64 timestamp,
+								 const void *data, size_t data_size,
+								 guint16 packet_id, size_t *packet_size);
+gboolean		arv_uvcp_packet_get_event		(const ArvUvcpPacket *packet, size_t packet_size,
+								 guint16 *event_id, guint64 *timestamp,
+								 const void **data, size_t *data_size);
 char * 			arv_uvcp_packet_to_string 		(const ArvUvcpPacket *packet);
 void 			arv_uvcp_packet_debug 			(const ArvUvcpPacket *packet, ArvDebugLevel level);
 const char * 		arv_uvcp_status_to_string 		(ArvUvcpStatus value);
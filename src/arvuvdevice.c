@@ -29,24 +29,61 @@
 #include <arvuvdeviceprivate.h>
 #include <arvuvinterfaceprivate.h>
 #include <arvuvcpprivate.h>
+#include <arvuvfaketransportprivate.h>
+#include <arvuvbandwidthprivate.h>
 #include <arvgc.h>
 #include <arvdebug.h>
 #include <libusb.h>
 #include <string.h>
 #include <arvstr.h>
 #include <arvzip.h>
+#include <arvgenicamcacheprivate.h>
 #include <arvmisc.h>
+#include <arvrealtimeprivate.h>
 
 enum
 {
 	PROP_0,
 	PROP_UV_DEVICE_VENDOR,
 	PROP_UV_DEVICE_PRODUCT,
-	PROP_UV_DEVICE_SERIAL_NUMBER
+	PROP_UV_DEVICE_SERIAL_NUMBER,
+	PROP_UV_DEVICE_FAKE_TRANSPORT
 };
 
 #define ARV_UV_DEVICE_N_TRIES_MAX	5
 
+/* Delay between two device lookups during a reconnection */
+#define ARV_UV_DEVICE_RECONNECT_POLL_DELAY_US	100000
+
+#define ARV_UV_DEVICE_CONTROL_PIPELINE_DEPTH_DEFAULT	4
+#define ARV_UV_DEVICE_CONTROL_PIPELINE_DEPTH_MAX	16
+
+#define ARV_UV_DEVICE_N_EVENT_TRANSFERS		4
+#define ARV_UV_DEVICE_EVENT_TRANSFER_SIZE_MAX	1024
+/* Wake up period of the event thread, for checking the cancellation */
+#define ARV_UV_DEVICE_EVENT_POLL_TIMEOUT_MS	100
+
+enum {
+	ARV_UV_DEVICE_SIGNAL_EVENT,
+	ARV_UV_DEVICE_SIGNAL_LAST
+} ArvUvDeviceSignals;
+
+static guint arv_uv_device_signals[ARV_UV_DEVICE_SIGNAL_LAST] = {0};
+
+typedef struct {
+	ArvUvDevice *uv_device;
+
+	struct libusb_transfer *transfers[ARV_UV_DEVICE_N_EVENT_TRANSFERS];
+	guint8 *buffers[ARV_UV_DEVICE_N_EVENT_TRANSFERS];
+	size_t transfer_size;
+
+	guint64 eirm_offset;
+
+	/* Accessed from the callbacks, which may run in any thread handling the libusb events */
+	gint n_submitted;
+	gint cancelled;
+} ArvUvDeviceEventData;
+
 typedef struct {
 	char *vendor;
 	char *product;
@@ -62,14 +99,37 @@ typedef struct {
 
 	guint16 packet_id;
 
+	/* Maximum number of read commands in flight, 1 for one command at a time */
+	guint control_pipeline_depth;
+
 	guint timeout_ms;
 	guint cmd_packet_size_max;
 	guint ack_packet_size_max;
 	guint control_interface;
 	guint data_interface;
+	guint event_interface;
         guint8 control_endpoint;
         guint8 data_endpoint;
+	guint8 event_endpoint;
+	gboolean has_event_interface;
 	gboolean disconnected;
+
+	guint64 sbrm_offset;
+
+	GThread *event_thread;
+	ArvUvDeviceEventData *event_data;
+
+	ArvUvUsbMode usb_mode;
+
+	double bandwidth_weight;
+	gboolean is_bandwidth_managed;
+
+	/* Streams created by the device, suspended during a reconnection */
+	GMutex streams_mutex;
+	GSList *streams;
+
+	/* In-process simulator standing for the USB device, for tests and benchmarks */
+	ArvUvFakeTransport *fake_transport;
 } ArvUvDevicePrivate;
 
 struct _ArvUvDevice {
@@ -86,6 +146,19 @@ G_DEFINE_TYPE_WITH_CODE (ArvUvDevice, arv_uv_device, ARV_TYPE_DEVICE, G_ADD_PRIV
 
 /* ArvUvDevice implementation */
 
+static guint8
+_get_endpoint (ArvUvDevicePrivate *priv, ArvUvEndpointType endpoint_type)
+{
+	switch (endpoint_type) {
+		case ARV_UV_ENDPOINT_CONTROL:
+			return priv->control_endpoint;
+		case ARV_UV_ENDPOINT_EVENT:
+			return priv->event_endpoint;
+		default:
+			return priv->data_endpoint;
+	}
+}
+
 gboolean
 arv_uv_device_bulk_transfer (ArvUvDevice *uv_device, ArvUvEndpointType endpoint_type, unsigned char endpoint_flags, void *data,
 			     size_t size, size_t *transferred_size, guint32 timeout_ms, GError **error)
@@ -106,8 +179,12 @@ arv_uv_device_bulk_transfer (ArvUvDevice *uv_device, ArvUvEndpointType endpoint_
 		return FALSE;
 	}
 
+	if (priv->fake_transport != NULL)
+		return arv_uv_fake_transport_bulk_transfer (priv->fake_transport, endpoint_type, endpoint_flags,
+							    data, size, transferred_size,
+							    timeout_ms > 0 ? timeout_ms : priv->timeout_ms, error);
 
-	endpoint = (endpoint_type == ARV_UV_ENDPOINT_CONTROL) ? priv->control_endpoint : priv->data_endpoint;
+	endpoint = _get_endpoint (priv, endpoint_type);
 	result = libusb_bulk_transfer (priv->usb_device, endpoint | endpoint_flags, data, size, &transferred,
 				       timeout_ms > 0 ? timeout_ms : priv->timeout_ms);
 
@@ -128,10 +205,432 @@ arv_uv_device_bulk_transfer (ArvUvDevice *uv_device, ArvUvEndpointType endpoint_
 	return success;
 }
 
+void
+arv_uv_device_fill_bulk_transfer (struct libusb_transfer *transfer, ArvUvDevice *uv_device,
+				  ArvUvEndpointType endpoint_type, unsigned char endpoint_flags,
+				  void *data, size_t size,
+				  libusb_transfer_cb_fn callback, void *callback_data,
+				  unsigned int timeout_ms)
+{
+	ArvUvDevicePrivate *priv = arv_uv_device_get_instance_private (uv_device);
+	guint8 endpoint;
+
+	g_return_if_fail (transfer != NULL);
+	g_return_if_fail (ARV_IS_UV_DEVICE (uv_device));
+
+	endpoint = _get_endpoint (priv, endpoint_type);
+
+	libusb_fill_bulk_transfer (transfer, priv->usb_device, endpoint | endpoint_flags, data, size,
+				   callback, callback_data, timeout_ms);
+}
+
+/* Processes the completion of the asynchronous transfers, the callbacks are called from the calling thread */
+
+void
+arv_uv_device_handle_events (ArvUvDevice *uv_device, guint timeout_ms)
+{
+	ArvUvDevicePrivate *priv = arv_uv_device_get_instance_private (uv_device);
+	struct timeval timeout;
+
+	g_return_if_fail (ARV_IS_UV_DEVICE (uv_device));
+
+	timeout.tv_sec = timeout_ms / 1000;
+	timeout.tv_usec = (timeout_ms % 1000) * 1000;
+
+	libusb_handle_events_timeout_completed (priv->usb, &timeout, NULL);
+}
+
+/**
+ * arv_uv_device_set_usb_mode:
+ * @uv_device: a #ArvUvDevice
+ * @usb_mode: a #ArvUvUsbMode option
+ *
+ * Sets the USB transfer mode used by the streams, it must be set before the stream creation.
+ * In #ARV_UV_USB_MODE_ASYNC mode, the bulk transfers of the current and the next buffers are queued in advance,
+ * keeping the bus busy. Simulated devices only support the #ARV_UV_USB_MODE_SYNC mode.
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_uv_device_set_usb_mode (ArvUvDevice *uv_device, ArvUvUsbMode usb_mode)
+{
+	ArvUvDevicePrivate *priv = arv_uv_device_get_instance_private (uv_device);
+
+	g_return_if_fail (ARV_IS_UV_DEVICE (uv_device));
+
+	if (priv->fake_transport != NULL && usb_mode != ARV_UV_USB_MODE_SYNC) {
+		arv_warning_device ("[UvDevice::set_usb_mode] Simulated device only supports the sync mode");
+		return;
+	}
+
+	priv->usb_mode = usb_mode;
+}
+
+/**
+ * arv_uv_device_get_usb_mode:
+ * @uv_device: a #ArvUvDevice
+ *
+ * Returns: the USB transfer mode used by the streams
+ *
+ * Since: 0.8.11
+ */
+
+ArvUvUsbMode
+arv_uv_device_get_usb_mode (ArvUvDevice *uv_device)
+{
+	ArvUvDevicePrivate *priv = arv_uv_device_get_instance_private (uv_device);
+
+	g_return_val_if_fail (ARV_IS_UV_DEVICE (uv_device), ARV_UV_USB_MODE_DEFAULT);
+
+	return priv->usb_mode;
+}
+
+/**
+ * arv_uv_device_set_control_pipeline_depth:
+ * @uv_device: a #ArvUvDevice
+ * @depth: maximum number of read commands in flight
+ *
+ * Sets the maximum number of read commands sent to the device before the reception of their acknowledges, for the
+ * reads larger than the maximum acknowledge size, like the GenICam data download at device creation. The acknowledges
+ * are matched to their command by packet id. A @depth of 1 sends one command at a time. The pipelining is
+ * automatically disabled if the device fails to answer pipelined commands, the failed blocks being read again one
+ * command at a time. Writes are always sent one command at a time.
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_uv_device_set_control_pipeline_depth (ArvUvDevice *uv_device, guint depth)
+{
+	ArvUvDevicePrivate *priv = arv_uv_device_get_instance_private (uv_device);
+
+	g_return_if_fail (ARV_IS_UV_DEVICE (uv_device));
+
+	priv->control_pipeline_depth = CLAMP (depth, 1, ARV_UV_DEVICE_CONTROL_PIPELINE_DEPTH_MAX);
+}
+
+/**
+ * arv_uv_device_get_control_pipeline_depth:
+ * @uv_device: a #ArvUvDevice
+ *
+ * Returns: the maximum number of read commands in flight, 1 if the pipelining is disabled
+ *
+ * Since: 0.8.11
+ */
+
+guint
+arv_uv_device_get_control_pipeline_depth (ArvUvDevice *uv_device)
+{
+	ArvUvDevicePrivate *priv = arv_uv_device_get_instance_private (uv_device);
+
+	g_return_val_if_fail (ARV_IS_UV_DEVICE (uv_device), 1);
+
+	return priv->control_pipeline_depth;
+}
+
+/**
+ * arv_uv_device_get_bus_number:
+ * @uv_device: a #ArvUvDevice
+ *
+ * Returns: the number of the USB bus the device is connected to, 0 if unknown
+ *
+ * Since: 0.8.11
+ */
+
+guint
+arv_uv_device_get_bus_number (ArvUvDevice *uv_device)
+{
+	ArvUvDevicePrivate *priv = arv_uv_device_get_instance_private (uv_device);
+
+	g_return_val_if_fail (ARV_IS_UV_DEVICE (uv_device), 0);
+
+	if (priv->usb_device == NULL)
+		return 0;
+
+	return libusb_get_bus_number (libusb_get_device (priv->usb_device));
+}
+
+/**
+ * arv_uv_device_set_bandwidth_weight:
+ * @uv_device: a #ArvUvDevice
+ * @weight: relative share of the bus bandwidth, 0 to leave the device out of the allocation
+ *
+ * Sets the weight of the device in the division of the bandwidth of its USB bus, when a budget was set with
+ * arv_uv_set_bus_bandwidth(). The bandwidth of the devices of the bus is allocated again immediately.
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_uv_device_set_bandwidth_weight (ArvUvDevice *uv_device, double weight)
+{
+	ArvUvDevicePrivate *priv = arv_uv_device_get_instance_private (uv_device);
+
+	g_return_if_fail (ARV_IS_UV_DEVICE (uv_device));
+	g_return_if_fail (weight >= 0.0);
+
+	priv->bandwidth_weight = weight;
+
+	if (priv->is_bandwidth_managed)
+		arv_uv_bandwidth_update_device (uv_device);
+}
+
+/**
+ * arv_uv_device_get_bandwidth_weight:
+ * @uv_device: a #ArvUvDevice
+ *
+ * Returns: the weight of the device in the division of the bandwidth of its USB bus
+ *
+ * Since: 0.8.11
+ */
+
+double
+arv_uv_device_get_bandwidth_weight (ArvUvDevice *uv_device)
+{
+	ArvUvDevicePrivate *priv = arv_uv_device_get_instance_private (uv_device);
+
+	g_return_val_if_fail (ARV_IS_UV_DEVICE (uv_device), 0.0);
+
+	return priv->bandwidth_weight;
+}
+
+static void LIBUSB_CALL
+_event_transfer_cb (struct libusb_transfer *transfer)
+{
+	ArvUvDeviceEventData *event_data = transfer->user_data;
+
+	if (transfer->status == LIBUSB_TRANSFER_COMPLETED) {
+		const ArvUvcpPacket *packet = (const ArvUvcpPacket *) transfer->buffer;
+		const void *data;
+		size_t data_size;
+		guint64 timestamp;
+		guint16 event_id;
+
+		if (arv_uvcp_packet_get_event (packet, transfer->actual_length, &event_id, &timestamp,
+					       &data, &data_size)) {
+			GBytes *bytes = data != NULL ? g_bytes_new (data, data_size) : NULL;
+
+			arv_uvcp_packet_debug (packet, ARV_DEBUG_LEVEL_DEBUG);
+			arv_debug_device ("[UvDevice::event_thread] Event 0x%04x, timestamp %" G_GUINT64_FORMAT,
+					  event_id, timestamp);
+
+			g_signal_emit (event_data->uv_device, arv_uv_device_signals[ARV_UV_DEVICE_SIGNAL_EVENT], 0,
+				       event_id, 0xffff, (guint64) 0, timestamp, bytes);
+
+			if (bytes != NULL)
+				g_bytes_unref (bytes);
+		} else
+			arv_debug_device ("[UvDevice::event_thread] Invalid packet on the event endpoint");
+	} else if (transfer->status != LIBUSB_TRANSFER_CANCELLED)
+		arv_info_device ("[UvDevice::event_thread] Event transfer error (%d)", transfer->status);
+
+	if ((transfer->status == LIBUSB_TRANSFER_COMPLETED || transfer->status == LIBUSB_TRANSFER_TIMED_OUT) &&
+	    !g_atomic_int_get (&event_data->cancelled) &&
+	    libusb_submit_transfer (transfer) == LIBUSB_SUCCESS)
+		return;
+
+	g_atomic_int_add (&event_data->n_submitted, -1);
+}
+
+static void *
+arv_uv_device_event_thread (void *data)
+{
+	ArvUvDeviceEventData *event_data = data;
+	gint auxiliary_generation = 0;
+	unsigned i;
+
+	arv_apply_internal_thread_scheduling (ARV_INTERNAL_THREAD_EVENT);
+
+	while (g_atomic_int_get (&event_data->n_submitted) > 0) {
+		arv_device_update_auxiliary_thread_placement (ARV_DEVICE (event_data->uv_device),
+							      &auxiliary_generation);
+
+		/* Also catches the transfers resubmitted by a callback during the cancellation */
+		if (g_atomic_int_get (&event_data->cancelled))
+			for (i = 0; i < ARV_UV_DEVICE_N_EVENT_TRANSFERS; i++)
+				libusb_cancel_transfer (event_data->transfers[i]);
+
+		arv_uv_device_handle_events (event_data->uv_device, ARV_UV_DEVICE_EVENT_POLL_TIMEOUT_MS);
+	}
+
+	return NULL;
+}
+
+static void
+_event_data_free (ArvUvDeviceEventData *event_data)
+{
+	unsigned i;
+
+	for (i = 0; i < ARV_UV_DEVICE_N_EVENT_TRANSFERS; i++) {
+		libusb_free_transfer (event_data->transfers[i]);
+		g_free (event_data->buffers[i]);
+	}
+
+	g_free (event_data);
+}
+
+/**
+ * arv_uv_device_enable_events:
+ * @uv_device: a #ArvUvDevice
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Enables the USB3 Vision event interface of the device, and starts a thread keeping several asynchronous transfers
+ * queued on the event endpoint. Each received event is emitted right away through the #ArvUvDevice::event signal,
+ * with its device timestamp, like the GigE Vision message channel events of arv_gv_device_enable_events(). The
+ * events themselves must still be enabled using the device features, usually EventSelector and EventNotification.
+ *
+ * Returns: %TRUE if the event interface is enabled.
+ *
+ * Since: 0.8.11
+ */
+
+gboolean
+arv_uv_device_enable_events (ArvUvDevice *uv_device, GError **error)
+{
+	ArvUvDevicePrivate *priv = arv_uv_device_get_instance_private (uv_device);
+	ArvUvDeviceEventData *event_data;
+	guint32 max_transfer_length = 0;
+	guint64 eirm_offset = 0;
+	unsigned i;
+	int result;
+
+	g_return_val_if_fail (ARV_IS_UV_DEVICE (uv_device), FALSE);
+
+	if (priv->event_thread != NULL)
+		return TRUE;
+
+	if (priv->usb_device == NULL || !priv->has_event_interface) {
+		g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_PROTOCOL_ERROR,
+			     "[UvDevice::enable_events] Device has no event interface");
+		return FALSE;
+	}
+
+	if (!arv_device_read_memory (ARV_DEVICE (uv_device), priv->sbrm_offset + ARV_SBRM_EIRM_ADDRESS,
+				     sizeof (eirm_offset), &eirm_offset, error))
+		return FALSE;
+
+	if (eirm_offset == 0) {
+		g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_PROTOCOL_ERROR,
+			     "[UvDevice::enable_events] Device has no event interface register map");
+		return FALSE;
+	}
+
+	if (!arv_device_read_memory (ARV_DEVICE (uv_device), eirm_offset + ARV_EIRM_MAX_EVENT_TRANSFER_LENGTH,
+				     sizeof (max_transfer_length), &max_transfer_length, error))
+		return FALSE;
+
+	result = libusb_claim_interface (priv->usb_device, priv->event_interface);
+	if (result != 0) {
+		g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_PROTOCOL_ERROR,
+			     "[UvDevice::enable_events] Failed to claim event interface: %s",
+			     libusb_error_name (result));
+		return FALSE;
+	}
+
+	event_data = g_new0 (ArvUvDeviceEventData, 1);
+	event_data->uv_device = uv_device;
+	event_data->eirm_offset = eirm_offset;
+	event_data->transfer_size = max_transfer_length > 0 ?
+		CLAMP (max_transfer_length, sizeof (ArvUvcpEventCmd), ARV_UV_DEVICE_EVENT_TRANSFER_SIZE_MAX) :
+		ARV_UV_DEVICE_EVENT_TRANSFER_SIZE_MAX;
+
+	if (!arv_device_write_register (ARV_DEVICE (uv_device), eirm_offset + ARV_EIRM_CONTROL,
+					ARV_EIRM_CONTROL_ENABLE, error)) {
+		g_free (event_data);
+		libusb_release_interface (priv->usb_device, priv->event_interface);
+		return FALSE;
+	}
+
+	for (i = 0; i < ARV_UV_DEVICE_N_EVENT_TRANSFERS; i++) {
+		event_data->transfers[i] = libusb_alloc_transfer (0);
+		event_data->buffers[i] = g_malloc (event_data->transfer_size);
+		arv_uv_device_fill_bulk_transfer (event_data->transfers[i], uv_device,
+						  ARV_UV_ENDPOINT_EVENT, LIBUSB_ENDPOINT_IN,
+						  event_data->buffers[i], event_data->transfer_size,
+						  _event_transfer_cb, event_data, 0);
+		if (libusb_submit_transfer (event_data->transfers[i]) == LIBUSB_SUCCESS)
+			g_atomic_int_inc (&event_data->n_submitted);
+	}
+
+	if (g_atomic_int_get (&event_data->n_submitted) == 0) {
+		g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_TRANSFER_ERROR,
+			     "[UvDevice::enable_events] Failed to submit event transfers");
+		arv_device_write_register (ARV_DEVICE (uv_device), eirm_offset + ARV_EIRM_CONTROL, 0, NULL);
+		_event_data_free (event_data);
+		libusb_release_interface (priv->usb_device, priv->event_interface);
+		return FALSE;
+	}
+
+	arv_info_device ("[UvDevice::enable_events] %d event transfers of %" G_GSIZE_FORMAT " bytes",
+			 g_atomic_int_get (&event_data->n_submitted), event_data->transfer_size);
+
+	priv->event_data = event_data;
+	priv->event_thread = g_thread_new ("arv_uv_event", arv_uv_device_event_thread, event_data);
+
+	return TRUE;
+}
+
+/**
+ * arv_uv_device_disable_events:
+ * @uv_device: a #ArvUvDevice
+ *
+ * Disables the event interface enabled by arv_uv_device_enable_events().
+ *
+ * Since: 0.8.11
+ */
+
+void
+arv_uv_device_disable_events (ArvUvDevice *uv_device)
+{
+	ArvUvDevicePrivate *priv = arv_uv_device_get_instance_private (uv_device);
+	ArvUvDeviceEventData *event_data;
+
+	g_return_if_fail (ARV_IS_UV_DEVICE (uv_device));
+
+	if (priv->event_thread == NULL)
+		return;
+
+	event_data = priv->event_data;
+
+	arv_device_write_register (ARV_DEVICE (uv_device), event_data->eirm_offset + ARV_EIRM_CONTROL, 0, NULL);
+
+	g_atomic_int_set (&event_data->cancelled, TRUE);
+	g_thread_join (priv->event_thread);
+	_event_data_free (event_data);
+
+	libusb_release_interface (priv->usb_device, priv->event_interface);
+
+	priv->event_data = NULL;
+	priv->event_thread = NULL;
+}
+
+static void
+_stream_finalized_cb (gpointer data, GObject *stream)
+{
+	ArvUvDevicePrivate *priv = arv_uv_device_get_instance_private (ARV_UV_DEVICE (data));
+
+	g_mutex_lock (&priv->streams_mutex);
+	priv->streams = g_slist_remove (priv->streams, stream);
+	g_mutex_unlock (&priv->streams_mutex);
+}
+
 static ArvStream *
 arv_uv_device_create_stream (ArvDevice *device, ArvStreamCallback callback, void *user_data, GError **error)
 {
-	return arv_uv_stream_new (ARV_UV_DEVICE (device), callback, user_data, error);
+	ArvUvDevicePrivate *priv = arv_uv_device_get_instance_private (ARV_UV_DEVICE (device));
+	ArvStream *stream;
+
+	stream = arv_uv_stream_new (ARV_UV_DEVICE (device), callback, user_data, error);
+	if (stream != NULL) {
+		g_mutex_lock (&priv->streams_mutex);
+		priv->streams = g_slist_prepend (priv->streams, stream);
+		g_mutex_unlock (&priv->streams_mutex);
+
+		g_object_weak_ref (G_OBJECT (stream), _stream_finalized_cb, device);
+	}
+
+	return stream;
 }
 
 static gboolean
@@ -329,6 +828,159 @@ _send_cmd_and_receive_ack (ArvUvDevice *uv_device, ArvUvcpCommand command,
 	return success;
 }
 
+typedef struct {
+	guint block;
+	guint16 packet_id;
+	gint64 timeout_stop_ms;
+	gboolean pending;
+} ArvUvControlRequest;
+
+/* Reads or writes the blocks of a memory area with up to control_pipeline_depth memory commands in flight, the
+ * acknowledges being matched to the commands by packet id. Returns the number of blocks transferred from the start of
+ * the area, the remaining ones being left to the one command at a time path after a failure. */
+
+static guint
+_transfer_memory_pipelined (ArvUvDevice *uv_device, ArvUvcpCommand command,
+			    guint64 address, guint32 size, void *buffer, guint data_size_max)
+{
+	ArvUvDevicePrivate *priv = arv_uv_device_get_instance_private (uv_device);
+	ArvUvControlRequest requests[ARV_UV_DEVICE_CONTROL_PIPELINE_DEPTH_MAX];
+	ArvUvcpPacket *ack_packet;
+	GError *local_error = NULL;
+	size_t ack_size;
+	guint n_blocks;
+	guint depth;
+	guint n_sent = 0;
+	guint n_done = 0;
+
+	n_blocks = (size + data_size_max - 1) / data_size_max;
+	depth = MIN (priv->control_pipeline_depth, ARV_UV_DEVICE_CONTROL_PIPELINE_DEPTH_MAX);
+	ack_size = command == ARV_UVCP_COMMAND_READ_MEMORY_CMD ?
+		arv_uvcp_packet_get_read_memory_ack_size (data_size_max) :
+		arv_uvcp_packet_get_write_memory_ack_size ();
+	ack_packet = g_malloc (ack_size);
+
+	while (n_done < n_blocks) {
+		ArvUvControlRequest *request = NULL;
+		ArvUvcpCommand ack_command;
+		ArvUvcpStatus status;
+		size_t transferred;
+		gint64 time_ms;
+		guint16 packet_id;
+		guint block_size;
+		guint i;
+
+		/* Fill the window, the request of a block being at index block % depth */
+		while (n_sent < n_blocks && n_sent - n_done < depth) {
+			ArvUvcpPacket *packet;
+			size_t packet_size;
+			gboolean success;
+
+			block_size = MIN (data_size_max, size - n_sent * data_size_max);
+			if (command == ARV_UVCP_COMMAND_READ_MEMORY_CMD) {
+				packet = arv_uvcp_packet_new_read_memory_cmd (address + n_sent * data_size_max,
+									      block_size, 0, &packet_size);
+			} else {
+				packet = arv_uvcp_packet_new_write_memory_cmd (address + n_sent * data_size_max,
+									       block_size, 0, &packet_size);
+				memcpy (arv_uvcp_packet_get_write_memory_cmd_data (packet),
+					((char *) buffer) + n_sent * data_size_max, block_size);
+			}
+
+			priv->packet_id = arv_uvcp_next_packet_id (priv->packet_id);
+			arv_uvcp_packet_set_packet_id (packet, priv->packet_id);
+
+			arv_uvcp_packet_debug (packet, ARV_DEBUG_LEVEL_DEBUG);
+
+			success = arv_uv_device_bulk_transfer (uv_device, ARV_UV_ENDPOINT_CONTROL, LIBUSB_ENDPOINT_OUT,
+							       packet, packet_size, NULL, 0, &local_error);
+			arv_uvcp_packet_free (packet);
+
+			if (!success) {
+				arv_info_device ("[UvDevice::transfer_memory_pipelined] Command sending error: %s",
+						 local_error != NULL ? local_error->message : "unknown");
+				g_clear_error (&local_error);
+				goto out;
+			}
+
+			requests[n_sent % depth].block = n_sent;
+			requests[n_sent % depth].packet_id = priv->packet_id;
+			requests[n_sent % depth].timeout_stop_ms = g_get_monotonic_time () / 1000 + priv->timeout_ms;
+			requests[n_sent % depth].pending = TRUE;
+
+			n_sent++;
+		}
+
+		/* The oldest request gives the acknowledge timeout */
+		time_ms = g_get_monotonic_time () / 1000;
+		if (requests[n_done % depth].timeout_stop_ms <= time_ms) {
+			arv_info_device ("[UvDevice::transfer_memory_pipelined] Acknowledge timeout");
+			goto out;
+		}
+
+		if (!arv_uv_device_bulk_transfer (uv_device, ARV_UV_ENDPOINT_CONTROL, LIBUSB_ENDPOINT_IN,
+						  ack_packet, ack_size, &transferred,
+						  requests[n_done % depth].timeout_stop_ms - time_ms, &local_error)) {
+			arv_info_device ("[UvDevice::transfer_memory_pipelined] Ack reception error: %s",
+					 local_error != NULL ? local_error->message : "unknown");
+			g_clear_error (&local_error);
+			goto out;
+		}
+
+		if (transferred < sizeof (ArvUvcpHeader))
+			continue;
+
+		arv_uvcp_packet_debug (ack_packet, ARV_DEBUG_LEVEL_DEBUG);
+
+		status = arv_uvcp_packet_get_status (ack_packet);
+		ack_command = arv_uvcp_packet_get_command (ack_packet);
+		packet_id = arv_uvcp_packet_get_packet_id (ack_packet);
+
+		for (i = n_done; i < n_sent && request == NULL; i++)
+			if (requests[i % depth].pending && requests[i % depth].packet_id == packet_id)
+				request = &requests[i % depth];
+
+		/* Late answer to a previous command */
+		if (request == NULL)
+			continue;
+
+		if (ack_command == ARV_UVCP_COMMAND_PENDING_ACK) {
+			request->timeout_stop_ms = g_get_monotonic_time () / 1000 +
+				arv_uvcp_packet_get_pending_ack_timeout (ack_packet);
+			continue;
+		}
+
+		block_size = MIN (data_size_max, size - request->block * data_size_max);
+
+		if (command == ARV_UVCP_COMMAND_READ_MEMORY_CMD) {
+			if (ack_command != ARV_UVCP_COMMAND_READ_MEMORY_ACK ||
+			    status != ARV_UVCP_STATUS_SUCCESS ||
+			    transferred < arv_uvcp_packet_get_read_memory_ack_size (block_size)) {
+				arv_info_device ("[UvDevice::transfer_memory_pipelined] Unexpected answer (0x%04x)",
+						 status);
+				goto out;
+			}
+
+			memcpy (((char *) buffer) + request->block * data_size_max,
+				arv_uvcp_packet_get_read_memory_ack_data (ack_packet), block_size);
+		} else if (ack_command != ARV_UVCP_COMMAND_WRITE_MEMORY_ACK ||
+			   status != ARV_UVCP_STATUS_SUCCESS) {
+			arv_info_device ("[UvDevice::transfer_memory_pipelined] Unexpected answer (0x%04x)", status);
+			goto out;
+		}
+
+		request->pending = FALSE;
+
+		while (n_done < n_sent && !requests[n_done % depth].pending)
+			n_done++;
+	}
+
+out:
+	g_free (ack_packet);
+
+	return n_done;
+}
+
 static gboolean
 arv_uv_device_read_memory (ArvDevice *device, guint64 address, guint32 size, void *buffer, GError **error)
 {
@@ -337,10 +989,21 @@ arv_uv_device_read_memory (ArvDevice *device, guint64 address, guint32 size, voi
 	int i;
 	gint32 block_size;
 	guint data_size_max;
+	guint n_read = 0;
 
 	data_size_max = priv->ack_packet_size_max - sizeof (ArvUvcpHeader);
 
-	for (i = 0; i < (size + data_size_max - 1) / data_size_max; i++) {
+	if (priv->control_pipeline_depth > 1 && size > data_size_max) {
+		n_read = _transfer_memory_pipelined (uv_device, ARV_UVCP_COMMAND_READ_MEMORY_CMD,
+						     address, size, buffer, data_size_max);
+		if (n_read < (size + data_size_max - 1) / data_size_max) {
+			arv_info_device ("[UvDevice::read_memory] Pipelined read failed, "
+					 "fall back to one command at a time");
+			priv->control_pipeline_depth = 1;
+		}
+	}
+
+	for (i = n_read; i < (size + data_size_max - 1) / data_size_max; i++) {
 		block_size = MIN (data_size_max, size - i * data_size_max);
 		if (!_send_cmd_and_receive_ack (uv_device, ARV_UVCP_COMMAND_READ_MEMORY_CMD,
 						address + i * data_size_max,
@@ -359,10 +1022,22 @@ arv_uv_device_write_memory (ArvDevice *device, guint64 address, guint32 size, vo
 	int i;
 	gint32 block_size;
 	guint data_size_max;
+	guint n_written = 0;
+
+	/* The written data travels in the command packets */
+	data_size_max = priv->cmd_packet_size_max - sizeof (ArvUvcpWriteMemoryCmd);
+
+	if (priv->control_pipeline_depth > 1 && size > data_size_max) {
+		n_written = _transfer_memory_pipelined (uv_device, ARV_UVCP_COMMAND_WRITE_MEMORY_CMD,
+							address, size, buffer, data_size_max);
+		if (n_written < (size + data_size_max - 1) / data_size_max) {
+			arv_info_device ("[UvDevice::write_memory] Pipelined write failed, "
+					 "fall back to one command at a time");
+			priv->control_pipeline_depth = 1;
+		}
+	}
 
-	data_size_max = priv->ack_packet_size_max - sizeof (ArvUvcpHeader);
-
-	for (i = 0; i < (size + data_size_max - 1) / data_size_max; i++) {
+	for (i = n_written; i < (size + data_size_max - 1) / data_size_max; i++) {
 		block_size = MIN (data_size_max, size - i * data_size_max);
 		if (!_send_cmd_and_receive_ack (uv_device, ARV_UVCP_COMMAND_WRITE_MEMORY_CMD,
 						address + i * data_size_max,
@@ -385,6 +1060,39 @@ arv_uv_device_write_register (ArvDevice *device, guint64 address, guint32 value,
 	return arv_uv_device_write_memory (device, address, sizeof (guint32), &value, error);
 }
 
+/* Returns %NULL if the GenICam cache is disabled */
+
+static char *
+_get_genicam_cache_key (ArvDevice *device, ArvUvcpManifestEntry *entry)
+{
+	char vendor[65] = {0};
+	char model[65] = {0};
+	char version[65] = {0};
+	g_autofree char *sha1 = NULL;
+	g_autofree char *xml_id = NULL;
+	gboolean success = TRUE;
+	unsigned int i;
+
+	if (!arv_genicam_cache_is_enabled ())
+		return NULL;
+
+	success = success && arv_device_read_memory (device, ARV_ABRM_MANUFACTURER_NAME, 64, vendor, NULL);
+	success = success && arv_device_read_memory (device, ARV_ABRM_MODEL_NAME, 64, model, NULL);
+	success = success && arv_device_read_memory (device, ARV_ABRM_DEVICE_VERSION, 64, version, NULL);
+	if (!success)
+		return NULL;
+
+	sha1 = g_malloc0 (2 * sizeof (entry->sha1_hash) + 1);
+	for (i = 0; i < sizeof (entry->sha1_hash); i++)
+		g_snprintf (sha1 + 2 * i, 3, "%02x", entry->sha1_hash[i]);
+
+	xml_id = g_strdup_printf ("%u.%u.%u;0x%08x;0x%" G_GINT64_MODIFIER "x;0x%" G_GINT64_MODIFIER "x;%s",
+				  entry->file_version_major, entry->file_version_minor, entry->file_version_subminor,
+				  entry->schema, entry->address, entry->size, sha1);
+
+	return arv_genicam_cache_build_key (vendor, model, version, xml_id);
+}
+
 static gboolean
 _bootstrap (ArvUvDevice *uv_device)
 {
@@ -415,6 +1123,7 @@ _bootstrap (ArvUvDevice *uv_device)
 	GString *string;
 	void *data;
 	char manufacturer[64];
+	g_autofree char *cache_key = NULL;
 	gboolean success = TRUE;
 
 	arv_info_device ("Get genicam");
@@ -457,6 +1166,7 @@ _bootstrap (ArvUvDevice *uv_device)
 	arv_info_device ("MAX_ACK_TRANSFER =         0x%08x", max_ack_transfer);
 	arv_info_device ("SIRM_OFFSET =              0x%016" G_GINT64_MODIFIER "x", sirm_offset);
 
+	priv->sbrm_offset = offset;
 	priv->cmd_packet_size_max = MIN (priv->cmd_packet_size_max, max_cmd_transfer);
 	priv->ack_packet_size_max = MIN (priv->ack_packet_size_max, max_ack_transfer);
 
@@ -505,6 +1215,13 @@ _bootstrap (ArvUvDevice *uv_device)
 	arv_info_device ("genicam address =          0x%016" G_GINT64_MODIFIER "x", entry.address);
 	arv_info_device ("genicam size    =          0x%016" G_GINT64_MODIFIER "x", entry.size);
 
+	cache_key = _get_genicam_cache_key (device, &entry);
+	priv->genicam_xml = arv_genicam_cache_load (cache_key, &priv->genicam_xml_size);
+	if (priv->genicam_xml != NULL) {
+		priv->genicam = arv_gc_new (ARV_DEVICE (uv_device), priv->genicam_xml, priv->genicam_xml_size);
+		return TRUE;
+	}
+
 	data = g_malloc0 (entry.size);
 	success = success && arv_device_read_memory (device, entry.address, entry.size, data, NULL);
 	if (!success){
@@ -571,6 +1288,8 @@ _bootstrap (ArvUvDevice *uv_device)
 			arv_warning_device ("Unknown USB3Vision manifest schema type (%d)", schema_type);
 	}
 
+	arv_genicam_cache_store (cache_key, priv->genicam_xml, priv->genicam_xml_size);
+
 #if 0
 	arv_info_device("GENICAM\n:%s", priv->genicam_xml);
 #endif
@@ -696,6 +1415,13 @@ _open_usb_device (ArvUvDevice *uv_device, GError **error)
 								priv->control_endpoint = endpoint.bEndpointAddress & 0x0f;
 								priv->control_interface = interdesc->bInterfaceNumber;
 							}
+							if (interdesc->bInterfaceProtocol == ARV_UV_INTERFACE_EVENT_PROTOCOL &&
+							    interdesc->bNumEndpoints > 0) {
+								endpoint = interdesc->endpoint[0];
+								priv->event_endpoint = endpoint.bEndpointAddress & 0x0f;
+								priv->event_interface = interdesc->bInterfaceNumber;
+								priv->has_event_interface = TRUE;
+							}
 							if (interdesc->bInterfaceProtocol == ARV_UV_INTERFACE_DATA_PROTOCOL) {
 								endpoint = interdesc->endpoint[0];
 								priv->data_endpoint = endpoint.bEndpointAddress & 0x0f;
@@ -747,6 +1473,31 @@ arv_uv_device_new (const char *vendor, const char *product, const char *serial_n
 			       NULL);
 }
 
+/**
+ * arv_uv_device_new_fake: (skip)
+ * @transport: (transfer full): a fake USB3Vision transport
+ * @error: a #GError placeholder, %NULL to ignore
+ *
+ * Creates a device backed by an in-process simulator instead of a USB device. The control and data bulk
+ * transfers are served by @transport, which allows to test and benchmark the USB3Vision stream without
+ * hardware.
+ *
+ * Returns: a newly created #ArvDevice
+ */
+
+ArvDevice *
+arv_uv_device_new_fake (ArvUvFakeTransport *transport, GError **error)
+{
+	g_return_val_if_fail (transport != NULL, NULL);
+
+	return g_initable_new (ARV_TYPE_UV_DEVICE, NULL, error,
+			       "vendor", "Aravis",
+			       "product", "FakeUV",
+			       "serial-number", "UV0001",
+			       "fake-transport", transport,
+			       NULL);
+}
+
 static void
 arv_uv_device_constructed (GObject *object)
 {
@@ -759,10 +1510,21 @@ arv_uv_device_constructed (GObject *object)
 	arv_info_device ("[UvDevice::new] Product = %s", priv->product);
 	arv_info_device ("[UvDevice::new] S/N     = %s", priv->serial_number);
 
-	libusb_init (&priv->usb);
 	priv->packet_id = 65300; /* Start near the end of the circular counter */
 	priv->timeout_ms = 32;
 
+	if (priv->fake_transport != NULL) {
+		arv_info_device ("[UvDevice::new] Using fake transport");
+
+		if (!_bootstrap (uv_device) || !ARV_IS_GC (priv->genicam))
+			arv_device_take_init_error (ARV_DEVICE (uv_device),
+						    g_error_new (ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_PROTOCOL_ERROR,
+								 "Failed to bootstrap fake USB device"));
+		return;
+	}
+
+	libusb_init (&priv->usb);
+
 	if (!_open_usb_device (uv_device, &error)) {
 		arv_device_take_init_error (ARV_DEVICE (uv_device), error);
                 return;
@@ -811,6 +1573,149 @@ arv_uv_device_constructed (GObject *object)
         }
 
 	reset_endpoint (priv->usb_device, priv->data_endpoint, LIBUSB_ENDPOINT_IN);
+
+	arv_uv_bandwidth_add_device (uv_device);
+	priv->is_bandwidth_managed = TRUE;
+}
+
+/* Reads again the control channel parameters of a reconnected device */
+
+static gboolean
+_read_control_parameters (ArvUvDevice *uv_device)
+{
+	ArvUvDevicePrivate *priv = arv_uv_device_get_instance_private (uv_device);
+	ArvDevice *device = ARV_DEVICE (uv_device);
+	guint64 offset;
+	guint32 response_time;
+	guint32 max_cmd_transfer;
+	guint32 max_ack_transfer;
+	gboolean success = TRUE;
+
+	success = success && arv_device_read_memory (device, ARV_ABRM_SBRM_ADDRESS, sizeof (guint64), &offset, NULL);
+	success = success && arv_device_read_memory (device, ARV_ABRM_MAX_DEVICE_RESPONSE_TIME, sizeof (guint32), &response_time, NULL);
+	success = success && arv_device_read_memory (device, offset + ARV_SBRM_MAX_CMD_TRANSFER, sizeof (guint32), &max_cmd_transfer, NULL);
+	success = success && arv_device_read_memory (device, offset + ARV_SBRM_MAX_ACK_TRANSFER, sizeof (guint32), &max_ack_transfer, NULL);
+	if (!success)
+		return FALSE;
+
+	priv->timeout_ms = MAX (ARV_UVCP_DEFAULT_RESPONSE_TIME_MS, response_time);
+	priv->sbrm_offset = offset;
+	priv->cmd_packet_size_max = MIN (65536 + sizeof (ArvUvcpHeader), max_cmd_transfer);
+	priv->ack_packet_size_max = MIN (65536 + sizeof (ArvUvcpHeader), max_ack_transfer);
+
+	return TRUE;
+}
+
+/* Closes the USB device handle, waits for the device with the same vendor, product and serial number to come back,
+ * replays the configuration and restarts the streams, which keep their buffers. */
+
+static gboolean
+arv_uv_device_reconnect (ArvDevice *device, guint timeout_ms, GError **error)
+{
+	ArvUvDevice *uv_device = ARV_UV_DEVICE (device);
+	ArvUvDevicePrivate *priv = arv_uv_device_get_instance_private (uv_device);
+	GSList *streams;
+	GSList *suspended_streams = NULL;
+	GSList *iter;
+	GError *local_error = NULL;
+	gboolean events_enabled;
+	gint64 end_time_us;
+	int result;
+
+	if (priv->fake_transport != NULL) {
+		arv_device_journal_replay (device);
+		return TRUE;
+	}
+
+	if (priv->usb == NULL) {
+		g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_NOT_CONNECTED,
+			     "Device was not successfully initialized");
+		return FALSE;
+	}
+
+	g_mutex_lock (&priv->streams_mutex);
+	streams = g_slist_copy_deep (priv->streams, (GCopyFunc) g_object_ref, NULL);
+	g_mutex_unlock (&priv->streams_mutex);
+
+	for (iter = streams; iter != NULL; iter = iter->next)
+		if (arv_uv_stream_suspend (iter->data))
+			suspended_streams = g_slist_prepend (suspended_streams, iter->data);
+
+	events_enabled = priv->event_thread != NULL;
+	arv_uv_device_disable_events (uv_device);
+
+	if (priv->is_bandwidth_managed) {
+		arv_uv_bandwidth_remove_device (uv_device);
+		priv->is_bandwidth_managed = FALSE;
+	}
+
+	if (priv->usb_device != NULL) {
+		libusb_release_interface (priv->usb_device, priv->control_interface);
+		libusb_release_interface (priv->usb_device, priv->data_interface);
+		libusb_close (priv->usb_device);
+		priv->usb_device = NULL;
+	}
+
+	end_time_us = g_get_monotonic_time () + (gint64) timeout_ms * 1000;
+
+	while (!_open_usb_device (uv_device, NULL) && g_get_monotonic_time () < end_time_us)
+		g_usleep (ARV_UV_DEVICE_RECONNECT_POLL_DELAY_US);
+
+	if (priv->usb_device == NULL) {
+		local_error = g_error_new (ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_TIMEOUT,
+					   "USB device '%s-%s-%s' not found within %u ms",
+					   priv->vendor, priv->product, priv->serial_number, timeout_ms);
+		goto out;
+	}
+
+	result = libusb_claim_interface (priv->usb_device, priv->control_interface);
+	if (result == 0)
+		result = libusb_claim_interface (priv->usb_device, priv->data_interface);
+	if (result != 0) {
+		local_error = g_error_new (ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_PROTOCOL_ERROR,
+					   "Failed to claim USB interface to '%s-%s-%s': %s",
+					   priv->vendor, priv->product, priv->serial_number,
+					   libusb_error_name (result));
+		goto out;
+	}
+
+	priv->disconnected = FALSE;
+
+	if (!_read_control_parameters (uv_device)) {
+		local_error = g_error_new (ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_PROTOCOL_ERROR,
+					   "Failed to bootstrap USB device '%s-%s-%s'",
+					   priv->vendor, priv->product, priv->serial_number);
+		goto out;
+	}
+
+	reset_endpoint (priv->usb_device, priv->data_endpoint, LIBUSB_ENDPOINT_IN);
+
+	arv_uv_bandwidth_add_device (uv_device);
+	priv->is_bandwidth_managed = TRUE;
+
+	arv_device_journal_replay (device);
+
+	if (events_enabled && !arv_uv_device_enable_events (uv_device, &local_error)) {
+		arv_warning_device ("[UvDevice::reconnect] Failed to enable events: %s", local_error->message);
+		g_clear_error (&local_error);
+	}
+
+	for (iter = suspended_streams; iter != NULL; iter = iter->next)
+		arv_uv_stream_resume (iter->data);
+
+	arv_info_device ("[UvDevice::reconnect] Device '%s-%s-%s' reconnected",
+			 priv->vendor, priv->product, priv->serial_number);
+
+out:
+	g_slist_free (suspended_streams);
+	g_slist_free_full (streams, g_object_unref);
+
+	if (local_error != NULL) {
+		g_propagate_error (error, local_error);
+		return FALSE;
+	}
+
+	return TRUE;
 }
 
 static void
@@ -821,6 +1726,11 @@ arv_uv_device_init (ArvUvDevice *uv_device)
 	priv->cmd_packet_size_max = 65536 + sizeof (ArvUvcpHeader);
 	priv->ack_packet_size_max = 65536 + sizeof (ArvUvcpHeader);
 	priv->disconnected = FALSE;
+	priv->usb_mode = ARV_UV_USB_MODE_DEFAULT;
+	priv->control_pipeline_depth = ARV_UV_DEVICE_CONTROL_PIPELINE_DEPTH_DEFAULT;
+	priv->bandwidth_weight = 1.0;
+
+	g_mutex_init (&priv->streams_mutex);
 }
 
 static void
@@ -829,6 +1739,11 @@ arv_uv_device_finalize (GObject *object)
 	ArvUvDevice *uv_device = ARV_UV_DEVICE (object);
 	ArvUvDevicePrivate *priv = arv_uv_device_get_instance_private (uv_device);
 
+	if (priv->is_bandwidth_managed)
+		arv_uv_bandwidth_remove_device (uv_device);
+
+	arv_uv_device_disable_events (uv_device);
+
 	g_clear_object (&priv->genicam);
 
 	g_clear_pointer (&priv->vendor, g_free);
@@ -840,7 +1755,12 @@ arv_uv_device_finalize (GObject *object)
 		libusb_release_interface (priv->usb_device, priv->data_interface);
 		libusb_close (priv->usb_device);
 	}
-	libusb_exit (priv->usb);
+	if (priv->usb != NULL)
+		libusb_exit (priv->usb);
+	g_clear_pointer (&priv->fake_transport, arv_uv_fake_transport_free);
+
+	g_slist_free (priv->streams);
+	g_mutex_clear (&priv->streams_mutex);
 
 	G_OBJECT_CLASS (arv_uv_device_parent_class)->finalize (object);
 }
@@ -864,6 +1784,9 @@ arv_uv_device_set_property (GObject *self, guint prop_id, const GValue *value, G
 			g_free (priv->serial_number);
 			priv->serial_number = g_value_dup_string (value);
 			break;
+		case PROP_UV_DEVICE_FAKE_TRANSPORT:
+			priv->fake_transport = g_value_get_pointer (value);
+			break;
 		default:
 			G_OBJECT_WARN_INVALID_PROPERTY_ID (self, prop_id, pspec);
 			break;
@@ -887,6 +1810,34 @@ arv_uv_device_class_init (ArvUvDeviceClass *uv_device_class)
 	device_class->write_memory = arv_uv_device_write_memory;
 	device_class->read_register = arv_uv_device_read_register;
 	device_class->write_register = arv_uv_device_write_register;
+	device_class->reconnect = arv_uv_device_reconnect;
+
+	/**
+	 * ArvUvDevice::event:
+	 * @uv_device: a #ArvUvDevice
+	 * @event_id: event identifier
+	 * @stream_channel_index: always 0xffff, USB3 Vision events don't refer to a stream channel
+	 * @block_id: always 0, USB3 Vision events don't refer to a frame
+	 * @timestamp: device timestamp of the event
+	 * @data: (nullable): event data
+	 *
+	 * Signal that an event was received on the event endpoint, enabled with arv_uv_device_enable_events(). The
+	 * arguments are the ones of the #ArvGvDevice::event signal, for handling the events of both device types with
+	 * the same callback. Events are correlated with the frames by their timestamp.
+	 *
+	 * This signal is emited from the thread handling the libusb events, so please take care to shared data access
+	 * from the callback.
+	 *
+	 * Since: 0.8.11
+	 */
+
+	arv_uv_device_signals[ARV_UV_DEVICE_SIGNAL_EVENT] =
+		g_signal_new ("event",
+			      G_TYPE_FROM_CLASS (device_class),
+			      G_SIGNAL_RUN_LAST,
+			      0, NULL, NULL,
+			      NULL, G_TYPE_NONE, 5,
+			      G_TYPE_UINT, G_TYPE_UINT, G_TYPE_UINT64, G_TYPE_UINT64, G_TYPE_BYTES);
 
 	g_object_class_install_property
 		(object_class,
@@ -912,4 +1863,11 @@ arv_uv_device_class_init (ArvUvDeviceClass *uv_device_class)
 				      "USB3 device serial number",
 				      NULL,
 				      G_PARAM_WRITABLE | G_PARAM_CONSTRUCT_ONLY));
+	g_object_class_install_property
+		(object_class,
+		 PROP_UV_DEVICE_FAKE_TRANSPORT,
+		 g_param_spec_pointer ("fake-transport",
+				       "Fake transport",
+				       "In-process USB3 device simulator",
+				       G_PARAM_WRITABLE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS));
 }
@@ -38,6 +38,23 @@ G_DECLARE_FINAL_TYPE (ArvUvDevice, arv_uv_device, ARV, UV_DEVICE, ArvDevice)
 ArvDevice * 	arv_uv_device_new 			(const char *vendor, const char *product, const char *serial_number,
 							 GError **error);
 
+void		arv_uv_device_set_usb_mode		(ArvUvDevice *uv_device, ArvUvUsbMode usb_mode);
+ArvUvUsbMode	arv_uv_device_get_usb_mode		(ArvUvDevice *uv_device);
+
+void		arv_uv_device_set_control_pipeline_depth	(ArvUvDevice *uv_device, guint depth);
+guint		arv_uv_device_get_control_pipeline_depth	(ArvUvDevice *uv_device);
+
+gboolean	arv_uv_device_enable_events		(ArvUvDevice *uv_device, GError **error);
+void		arv_uv_device_disable_events		(ArvUvDevice *uv_device);
+
+guint		arv_uv_device_get_bus_number		(ArvUvDevice *uv_device);
+void		arv_uv_device_set_bandwidth_weight	(ArvUvDevice *uv_device, double weight);
+double		arv_uv_device_get_bandwidth_weight	(ArvUvDevice *uv_device);
+
+void		arv_uv_set_bus_bandwidth		(guint bus_number, guint bandwidth);
+guint		arv_uv_get_bus_bandwidth		(guint bus_number);
+guint64		arv_uv_get_bus_n_frame_losses		(guint bus_number);
+
 G_END_DECLS
 
 #endif
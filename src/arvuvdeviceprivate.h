@@ -29,19 +29,32 @@
 
 #include <arvuvdevice.h>
 #include <arvdeviceprivate.h>
+#include <libusb.h>
 
 G_BEGIN_DECLS
 
 typedef enum {
 	ARV_UV_ENDPOINT_CONTROL,
-	ARV_UV_ENDPOINT_DATA
+	ARV_UV_ENDPOINT_DATA,
+	ARV_UV_ENDPOINT_EVENT
 } ArvUvEndpointType;
 
+typedef struct _ArvUvFakeTransport ArvUvFakeTransport;
+
+ArvDevice *	arv_uv_device_new_fake			(ArvUvFakeTransport *transport, GError **error);
+
 gboolean 	arv_uv_device_bulk_transfer 		(ArvUvDevice *uv_device,
 							 ArvUvEndpointType endpoint_type, unsigned char endpoint_flags,
 							 void *data, size_t size, size_t *transferred_size,
 							 guint32 timeout_ms, GError **error);
 
+void		arv_uv_device_fill_bulk_transfer	(struct libusb_transfer *transfer, ArvUvDevice *uv_device,
+							 ArvUvEndpointType endpoint_type, unsigned char endpoint_flags,
+							 void *data, size_t size,
+							 libusb_transfer_cb_fn callback, void *callback_data,
+							 unsigned int timeout_ms);
+void		arv_uv_device_handle_events		(ArvUvDevice *uv_device, guint timeout_ms);
+
 G_END_DECLS
 
 #endif
@@ -0,0 +1,636 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2019 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel@gnome.org>
+ */
+
+/*
+ * SECTION: arvuvfaketransport
+ * @short_description: In-process USB3Vision transport simulator
+ *
+ * #ArvUvFakeTransport stands for the USB bulk endpoints of a USB3Vision device, behind
+ * arv_uv_device_bulk_transfer(). The control endpoint serves the read and write memory commands from a small
+ * bootstrap register space (ABRM, SBRM, SIRM and manifest table), and the data endpoint produces the
+ * leader, payload and trailer transfers of the stream, following the transfer sizes programmed in the SIRM by the
+ * host. It allows to exercise and benchmark the USB3Vision stream without hardware.
+ */
+
+#include <arvuvfaketransportprivate.h>
+#include <arvuvcpprivate.h>
+#include <arvuvspprivate.h>
+#include <arvdebugprivate.h>
+#include <arvmisc.h>
+#include <libusb.h>
+#include <string.h>
+
+#define ARV_UV_FAKE_TRANSPORT_SBRM_ADDRESS		0x1000
+#define ARV_UV_FAKE_TRANSPORT_SIRM_ADDRESS		0x1100
+#define ARV_UV_FAKE_TRANSPORT_MANIFEST_ADDRESS		0x1200
+#define ARV_UV_FAKE_TRANSPORT_WIDTH			0x1300
+#define ARV_UV_FAKE_TRANSPORT_HEIGHT			0x1304
+#define ARV_UV_FAKE_TRANSPORT_MEMORY_SIZE		0x2000
+#define ARV_UV_FAKE_TRANSPORT_GENICAM_ADDRESS		0x100000
+
+#define ARV_UV_FAKE_TRANSPORT_RESPONSE_TIME_MS		100
+#define ARV_UV_FAKE_TRANSPORT_MAX_TRANSFER		4096
+#define ARV_UV_FAKE_TRANSPORT_N_ACKS_MAX		8
+
+static const char arv_uv_fake_transport_genicam_xml[] =
+"<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+"<RegisterDescription ModelName=\"FakeUV\" VendorName=\"Aravis\" StandardNameSpace=\"None\"\n"
+"	SchemaMajorVersion=\"1\" SchemaMinorVersion=\"0\" SchemaSubMinorVersion=\"1\"\n"
+"	MajorVersion=\"1\" MinorVersion=\"0\" SubMinorVersion=\"0\" ToolTip=\"Fake USB3Vision device\"\n"
+"	ProductGuid=\"0\" VersionGuid=\"0\" xmlns=\"http://www.genicam.org/GenApi/Version_1_0\">\n"
+"	<Category Name=\"Root\" NameSpace=\"Standard\">\n"
+"		<pFeature>Width</pFeature>\n"
+"		<pFeature>Height</pFeature>\n"
+"		<pFeature>PayloadSize</pFeature>\n"
+"	</Category>\n"
+"	<IntReg Name=\"Width\" NameSpace=\"Standard\">\n"
+"		<Address>0x1300</Address><Length>4</Length><AccessMode>RO</AccessMode><pPort>Device</pPort>\n"
+"		<Sign>Unsigned</Sign><Endianess>LittleEndian</Endianess>\n"
+"	</IntReg>\n"
+"	<IntReg Name=\"Height\" NameSpace=\"Standard\">\n"
+"		<Address>0x1304</Address><Length>4</Length><AccessMode>RO</AccessMode><pPort>Device</pPort>\n"
+"		<Sign>Unsigned</Sign><Endianess>LittleEndian</Endianess>\n"
+"	</IntReg>\n"
+"	<IntReg Name=\"PayloadSize\" NameSpace=\"Standard\">\n"
+"		<Address>0x1108</Address><Length>8</Length><AccessMode>RO</AccessMode><pPort>Device</pPort>\n"
+"		<Sign>Unsigned</Sign><Endianess>LittleEndian</Endianess>\n"
+"	</IntReg>\n"
+"	<Port Name=\"Device\" NameSpace=\"Standard\">\n"
+"	</Port>\n"
+"</RegisterDescription>\n";
+
+typedef enum {
+	ARV_UV_FAKE_TRANSPORT_STATE_LEADER,
+	ARV_UV_FAKE_TRANSPORT_STATE_PAYLOAD,
+	ARV_UV_FAKE_TRANSPORT_STATE_TRAILER
+} ArvUvFakeTransportState;
+
+struct _ArvUvFakeTransport {
+	GMutex mutex;
+
+	guint8 memory[ARV_UV_FAKE_TRANSPORT_MEMORY_SIZE];
+
+	/* Acknowledges of the received commands not read yet on the control endpoint, in reception order */
+	guint8 acks[ARV_UV_FAKE_TRANSPORT_N_ACKS_MAX][ARV_UV_FAKE_TRANSPORT_MAX_TRANSFER];
+	size_t ack_sizes[ARV_UV_FAKE_TRANSPORT_N_ACKS_MAX];
+	guint first_ack;
+	guint n_acks;
+	/* Commands received while this number of acknowledges is pending are ignored */
+	guint command_queue_size;
+
+	guint32 width;
+	guint32 height;
+	guint32 trailer_size;
+	double frame_rate;
+	double short_transfer_ratio;
+	GRand *rand;
+
+	/* Data endpoint, only accessed from the stream thread */
+	ArvUvFakeTransportState state;
+	guint64 frame_id;
+	guint64 payload;
+	guint64 payload_offset;
+	guint32 payload_transfer_size;
+	gint64 next_frame_time_us;
+	guint n_frames;
+};
+
+static guint32
+_get_register (ArvUvFakeTransport *transport, guint32 address)
+{
+	guint32 value;
+
+	memcpy (&value, transport->memory + address, sizeof (value));
+
+	return GUINT32_FROM_LE (value);
+}
+
+static void
+_set_register (ArvUvFakeTransport *transport, guint32 address, guint32 value)
+{
+	value = GUINT32_TO_LE (value);
+	memcpy (transport->memory + address, &value, sizeof (value));
+}
+
+static void
+_set_register64 (ArvUvFakeTransport *transport, guint32 address, guint64 value)
+{
+	value = GUINT64_TO_LE (value);
+	memcpy (transport->memory + address, &value, sizeof (value));
+}
+
+static void
+_set_string (ArvUvFakeTransport *transport, guint32 address, const char *string)
+{
+	strncpy ((char *) transport->memory + address, string, 63);
+}
+
+static void
+_update_payload (ArvUvFakeTransport *transport)
+{
+	_set_register (transport, ARV_UV_FAKE_TRANSPORT_WIDTH, transport->width);
+	_set_register (transport, ARV_UV_FAKE_TRANSPORT_HEIGHT, transport->height);
+	_set_register64 (transport, ARV_UV_FAKE_TRANSPORT_SIRM_ADDRESS + ARV_SIRM_REQ_PAYLOAD_SIZE,
+			 (guint64) transport->width * transport->height);
+	_set_register (transport, ARV_UV_FAKE_TRANSPORT_SIRM_ADDRESS + ARV_SIRM_REQ_TRAILER_SIZE,
+		       transport->trailer_size);
+}
+
+/* Returns a new transport, streaming 512x512 Mono8 images as fast as possible */
+
+ArvUvFakeTransport *
+arv_uv_fake_transport_new (void)
+{
+	ArvUvFakeTransport *transport;
+	ArvUvcpManifestEntry entry = {0};
+
+	transport = g_new0 (ArvUvFakeTransport, 1);
+
+	g_mutex_init (&transport->mutex);
+
+	transport->width = ARV_UV_FAKE_TRANSPORT_WIDTH_DEFAULT;
+	transport->height = ARV_UV_FAKE_TRANSPORT_HEIGHT_DEFAULT;
+	transport->trailer_size = sizeof (ArvUvspTrailer);
+	transport->rand = g_rand_new_with_seed (0);
+	transport->state = ARV_UV_FAKE_TRANSPORT_STATE_LEADER;
+	transport->command_queue_size = ARV_UV_FAKE_TRANSPORT_N_ACKS_MAX;
+
+	_set_string (transport, ARV_ABRM_MANUFACTURER_NAME, "Aravis");
+	_set_string (transport, ARV_ABRM_MODEL_NAME, "FakeUV");
+	_set_string (transport, ARV_ABRM_DEVICE_VERSION, ARAVIS_API_VERSION);
+	_set_string (transport, ARV_ABRM_SERIAL_NUMBER, "UV0001");
+	_set_register (transport, ARV_ABRM_MAX_DEVICE_RESPONSE_TIME, ARV_UV_FAKE_TRANSPORT_RESPONSE_TIME_MS);
+	_set_register64 (transport, ARV_ABRM_MANIFEST_TABLE_ADDRESS, ARV_UV_FAKE_TRANSPORT_MANIFEST_ADDRESS);
+	_set_register64 (transport, ARV_ABRM_SBRM_ADDRESS, ARV_UV_FAKE_TRANSPORT_SBRM_ADDRESS);
+
+	_set_register (transport, ARV_UV_FAKE_TRANSPORT_SBRM_ADDRESS + ARV_SBRM_MAX_CMD_TRANSFER,
+		       ARV_UV_FAKE_TRANSPORT_MAX_TRANSFER);
+	_set_register (transport, ARV_UV_FAKE_TRANSPORT_SBRM_ADDRESS + ARV_SBRM_MAX_ACK_TRANSFER,
+		       ARV_UV_FAKE_TRANSPORT_MAX_TRANSFER);
+	_set_register (transport, ARV_UV_FAKE_TRANSPORT_SBRM_ADDRESS + ARV_SBRM_NUM_STREAM_CHANNELS, 1);
+	_set_register64 (transport, ARV_UV_FAKE_TRANSPORT_SBRM_ADDRESS + ARV_SBRM_SIRM_ADDRESS,
+			 ARV_UV_FAKE_TRANSPORT_SIRM_ADDRESS);
+
+	_set_register (transport, ARV_UV_FAKE_TRANSPORT_SIRM_ADDRESS + ARV_SIRM_REQ_LEADER_SIZE,
+		       sizeof (ArvUvspLeader));
+
+	entry.file_version_major = 1;
+	entry.schema = GUINT32_TO_LE (ARV_UVCP_SCHEMA_RAW << 10);
+	entry.address = GUINT64_TO_LE (ARV_UV_FAKE_TRANSPORT_GENICAM_ADDRESS);
+	entry.size = GUINT64_TO_LE (sizeof (arv_uv_fake_transport_genicam_xml) - 1);
+	_set_register64 (transport, ARV_UV_FAKE_TRANSPORT_MANIFEST_ADDRESS, 1);
+	memcpy (transport->memory + ARV_UV_FAKE_TRANSPORT_MANIFEST_ADDRESS + 0x08, &entry, sizeof (entry));
+
+	arv_uv_fake_transport_set_alignment (transport, ARV_UV_FAKE_TRANSPORT_ALIGNMENT_DEFAULT);
+	_update_payload (transport);
+
+	return transport;
+}
+
+void
+arv_uv_fake_transport_free (ArvUvFakeTransport *transport)
+{
+	if (transport == NULL)
+		return;
+
+	g_rand_free (transport->rand);
+	g_mutex_clear (&transport->mutex);
+	g_free (transport);
+}
+
+void
+arv_uv_fake_transport_set_region (ArvUvFakeTransport *transport, guint32 width, guint32 height)
+{
+	g_return_if_fail (transport != NULL);
+	g_return_if_fail (width > 0 && height > 0);
+
+	g_mutex_lock (&transport->mutex);
+	transport->width = width;
+	transport->height = height;
+	_update_payload (transport);
+	g_mutex_unlock (&transport->mutex);
+}
+
+/* The alignment of the host transfer sizes, a power of two */
+
+void
+arv_uv_fake_transport_set_alignment (ArvUvFakeTransport *transport, guint32 alignment)
+{
+	g_return_if_fail (transport != NULL);
+	g_return_if_fail (alignment > 0 && (alignment & (alignment - 1)) == 0);
+
+	g_mutex_lock (&transport->mutex);
+	_set_register (transport, ARV_UV_FAKE_TRANSPORT_SIRM_ADDRESS + ARV_SIRM_INFO,
+		       (guint32) g_bit_nth_lsf (alignment, -1) << ARV_SIRM_INFO_ALIGNMENT_SHIFT);
+	g_mutex_unlock (&transport->mutex);
+}
+
+/* Size of the trailer transfer, which is usually not a multiple of the alignment */
+
+void
+arv_uv_fake_transport_set_trailer_size (ArvUvFakeTransport *transport, guint32 trailer_size)
+{
+	g_return_if_fail (transport != NULL);
+
+	g_mutex_lock (&transport->mutex);
+	transport->trailer_size = MAX (trailer_size, sizeof (ArvUvspTrailer));
+	_update_payload (transport);
+	g_mutex_unlock (&transport->mutex);
+}
+
+/* 0 means as fast as possible */
+
+void
+arv_uv_fake_transport_set_frame_rate (ArvUvFakeTransport *transport, double frame_rate)
+{
+	g_return_if_fail (transport != NULL);
+
+	g_mutex_lock (&transport->mutex);
+	transport->frame_rate = MAX (frame_rate, 0.0);
+	g_mutex_unlock (&transport->mutex);
+}
+
+/* Probability for a payload transfer to end early, the remaining data coming in the following transfers */
+
+void
+arv_uv_fake_transport_set_short_transfer_ratio (ArvUvFakeTransport *transport, double ratio)
+{
+	g_return_if_fail (transport != NULL);
+
+	g_mutex_lock (&transport->mutex);
+	transport->short_transfer_ratio = CLAMP (ratio, 0.0, 1.0);
+	g_mutex_unlock (&transport->mutex);
+}
+
+/* Number of commands the device queues, 1 for a device which ignores the commands sent before the
+ * acknowledge of the previous one is read */
+
+void
+arv_uv_fake_transport_set_command_queue_size (ArvUvFakeTransport *transport, guint queue_size)
+{
+	g_return_if_fail (transport != NULL);
+
+	g_mutex_lock (&transport->mutex);
+	transport->command_queue_size = CLAMP (queue_size, 1, ARV_UV_FAKE_TRANSPORT_N_ACKS_MAX);
+	g_mutex_unlock (&transport->mutex);
+}
+
+void
+arv_uv_fake_transport_set_seed (ArvUvFakeTransport *transport, guint32 seed)
+{
+	g_return_if_fail (transport != NULL);
+
+	g_mutex_lock (&transport->mutex);
+	g_rand_set_seed (transport->rand, seed);
+	g_mutex_unlock (&transport->mutex);
+}
+
+guint64
+arv_uv_fake_transport_get_payload (ArvUvFakeTransport *transport)
+{
+	guint64 payload;
+
+	g_return_val_if_fail (transport != NULL, 0);
+
+	g_mutex_lock (&transport->mutex);
+	payload = (guint64) transport->width * transport->height;
+	g_mutex_unlock (&transport->mutex);
+
+	return payload;
+}
+
+/* Number of complete frames sent on the data endpoint */
+
+guint
+arv_uv_fake_transport_get_n_frames (ArvUvFakeTransport *transport)
+{
+	g_return_val_if_fail (transport != NULL, 0);
+
+	return g_atomic_int_get (&transport->n_frames);
+}
+
+/* Control endpoint */
+
+static ArvUvcpStatus
+_read_memory (ArvUvFakeTransport *transport, guint64 address, guint32 size, void *buffer)
+{
+	size_t genicam_size = sizeof (arv_uv_fake_transport_genicam_xml) - 1;
+
+	if (address + size <= ARV_UV_FAKE_TRANSPORT_MEMORY_SIZE) {
+		memcpy (buffer, transport->memory + address, size);
+		return ARV_UVCP_STATUS_SUCCESS;
+	}
+
+	if (address >= ARV_UV_FAKE_TRANSPORT_GENICAM_ADDRESS &&
+	    address + size <= ARV_UV_FAKE_TRANSPORT_GENICAM_ADDRESS + genicam_size) {
+		memcpy (buffer, arv_uv_fake_transport_genicam_xml + address - ARV_UV_FAKE_TRANSPORT_GENICAM_ADDRESS,
+			size);
+		return ARV_UVCP_STATUS_SUCCESS;
+	}
+
+	return ARV_UVCP_STATUS_INVALID_ADDRESS;
+}
+
+static ArvUvcpStatus
+_write_memory (ArvUvFakeTransport *transport, guint64 address, guint32 size, const void *buffer)
+{
+	if (address + size <= ARV_UV_FAKE_TRANSPORT_MEMORY_SIZE) {
+		memcpy (transport->memory + address, buffer, size);
+		return ARV_UVCP_STATUS_SUCCESS;
+	}
+
+	if (address >= ARV_UV_FAKE_TRANSPORT_GENICAM_ADDRESS)
+		return ARV_UVCP_STATUS_WRITE_PROTECT;
+
+	return ARV_UVCP_STATUS_INVALID_ADDRESS;
+}
+
+static gboolean
+_handle_command (ArvUvFakeTransport *transport, const void *data, size_t size, GError **error)
+{
+	const ArvUvcpPacket *packet = data;
+	ArvUvcpHeader *ack_header;
+	ArvUvcpStatus status;
+	ArvUvcpCommand ack_command;
+	guint16 ack_data_size;
+	guint8 *ack;
+	guint slot;
+
+	if (size < sizeof (ArvUvcpHeader) || GUINT32_FROM_LE (packet->header.magic) != ARV_UVCP_MAGIC) {
+		g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_PROTOCOL_ERROR, "Invalid command packet");
+		return FALSE;
+	}
+
+	if (transport->n_acks >= transport->command_queue_size)
+		return TRUE;
+
+	slot = (transport->first_ack + transport->n_acks) % ARV_UV_FAKE_TRANSPORT_N_ACKS_MAX;
+	ack = transport->acks[slot];
+	ack_header = (ArvUvcpHeader *) ack;
+
+	switch (arv_uvcp_packet_get_command (packet)) {
+		case ARV_UVCP_COMMAND_READ_MEMORY_CMD:
+			{
+				const ArvUvcpReadMemoryCmd *cmd = data;
+				guint16 read_size = GUINT16_FROM_LE (cmd->infos.size);
+
+				ack_command = ARV_UVCP_COMMAND_READ_MEMORY_ACK;
+				if (sizeof (ArvUvcpHeader) + read_size > ARV_UV_FAKE_TRANSPORT_MAX_TRANSFER) {
+					status = ARV_UVCP_STATUS_INVALID_PARAMETER;
+					ack_data_size = 0;
+				} else {
+					status = _read_memory (transport, GUINT64_FROM_LE (cmd->infos.address), read_size,
+							       ack + sizeof (ArvUvcpHeader));
+					ack_data_size = status == ARV_UVCP_STATUS_SUCCESS ? read_size : 0;
+				}
+			}
+			break;
+		case ARV_UVCP_COMMAND_WRITE_MEMORY_CMD:
+			{
+				const ArvUvcpWriteMemoryCmd *cmd = data;
+				ArvUvcpWriteMemoryAck *write_ack = (ArvUvcpWriteMemoryAck *) ack;
+				size_t write_size = GUINT16_FROM_LE (cmd->header.size) - sizeof (ArvUvcpWriteMemoryCmdInfos);
+
+				ack_command = ARV_UVCP_COMMAND_WRITE_MEMORY_ACK;
+				if (sizeof (ArvUvcpWriteMemoryCmd) + write_size > size)
+					status = ARV_UVCP_STATUS_INVALID_HEADER;
+				else
+					status = _write_memory (transport, GUINT64_FROM_LE (cmd->infos.address), write_size,
+								arv_uvcp_packet_get_write_memory_cmd_data (packet));
+				write_ack->infos.unknown = 0;
+				write_ack->infos.bytes_written = GUINT16_TO_LE (status == ARV_UVCP_STATUS_SUCCESS ?
+									  write_size : 0);
+				ack_data_size = sizeof (ArvUvcpWriteMemoryAckInfos);
+			}
+			break;
+		default:
+			ack_command = arv_uvcp_packet_get_command (packet) + 1;
+			status = ARV_UVCP_STATUS_NOT_IMPLEMENTED;
+			ack_data_size = 0;
+			break;
+	}
+
+	ack_header->magic = GUINT32_TO_LE (ARV_UVCP_MAGIC);
+	ack_header->status = GUINT16_TO_LE (status);
+	ack_header->command = GUINT16_TO_LE (ack_command);
+	ack_header->size = GUINT16_TO_LE (ack_data_size);
+	ack_header->id = packet->header.id;
+	transport->ack_sizes[slot] = sizeof (ArvUvcpHeader) + ack_data_size;
+	transport->n_acks++;
+
+	return TRUE;
+}
+
+static gboolean
+_control_transfer (ArvUvFakeTransport *transport, unsigned char endpoint_flags,
+		   void *data, size_t size, size_t *transferred_size, GError **error)
+{
+	gboolean success = TRUE;
+
+	g_mutex_lock (&transport->mutex);
+
+	if ((endpoint_flags & LIBUSB_ENDPOINT_IN) == 0) {
+		success = _handle_command (transport, data, size, error);
+		*transferred_size = success ? size : 0;
+	} else if (transport->n_acks > 0) {
+		*transferred_size = MIN (size, transport->ack_sizes[transport->first_ack]);
+		memcpy (data, transport->acks[transport->first_ack], *transferred_size);
+		transport->first_ack = (transport->first_ack + 1) % ARV_UV_FAKE_TRANSPORT_N_ACKS_MAX;
+		transport->n_acks--;
+	} else {
+		g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_TIMEOUT, "No pending acknowledge");
+		*transferred_size = 0;
+		success = FALSE;
+	}
+
+	g_mutex_unlock (&transport->mutex);
+
+	return success;
+}
+
+/* Data endpoint */
+
+static gboolean
+_wait_for_next_frame (ArvUvFakeTransport *transport, double frame_rate, guint32 timeout_ms, GError **error)
+{
+	gint64 time_us = g_get_monotonic_time ();
+
+	if (frame_rate <= 0.0) {
+		transport->next_frame_time_us = time_us;
+		return TRUE;
+	}
+
+	if (transport->next_frame_time_us == 0)
+		transport->next_frame_time_us = time_us;
+
+	if (transport->next_frame_time_us - time_us > (gint64) timeout_ms * 1000) {
+		g_usleep ((gint64) timeout_ms * 1000);
+		g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_TIMEOUT, "Timeout");
+		return FALSE;
+	}
+
+	if (transport->next_frame_time_us > time_us)
+		g_usleep (transport->next_frame_time_us - time_us);
+
+	/* Don't try to catch up when the host is late */
+	transport->next_frame_time_us = MAX (transport->next_frame_time_us, time_us) + 1000000.0 / frame_rate;
+
+	return TRUE;
+}
+
+static gboolean
+_data_transfer (ArvUvFakeTransport *transport, void *data, size_t size, size_t *transferred_size,
+		guint32 timeout_ms, GError **error)
+{
+	gboolean is_enabled;
+	double frame_rate;
+	double short_transfer_ratio;
+	guint32 alignment;
+
+	*transferred_size = 0;
+
+	g_mutex_lock (&transport->mutex);
+	is_enabled = (_get_register (transport, ARV_UV_FAKE_TRANSPORT_SIRM_ADDRESS + ARV_SIRM_CONTROL) &
+		      ARV_SIRM_CONTROL_STREAM_ENABLE) != 0;
+	frame_rate = transport->frame_rate;
+	short_transfer_ratio = transport->short_transfer_ratio;
+	alignment = 1 << ((_get_register (transport, ARV_UV_FAKE_TRANSPORT_SIRM_ADDRESS + ARV_SIRM_INFO) &
+			   ARV_SIRM_INFO_ALIGNMENT_MASK) >> ARV_SIRM_INFO_ALIGNMENT_SHIFT);
+	g_mutex_unlock (&transport->mutex);
+
+	if (!is_enabled) {
+		transport->state = ARV_UV_FAKE_TRANSPORT_STATE_LEADER;
+		transport->next_frame_time_us = 0;
+		g_usleep ((gint64) timeout_ms * 1000);
+		g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_TIMEOUT, "Timeout");
+		return FALSE;
+	}
+
+	switch (transport->state) {
+		case ARV_UV_FAKE_TRANSPORT_STATE_LEADER:
+			{
+				ArvUvspLeader leader = {0};
+
+				if (!_wait_for_next_frame (transport, frame_rate, timeout_ms, error))
+					return FALSE;
+
+				g_mutex_lock (&transport->mutex);
+				transport->payload = (guint64) transport->width * transport->height;
+				transport->payload_transfer_size =
+					_get_register (transport, ARV_UV_FAKE_TRANSPORT_SIRM_ADDRESS + ARV_SIRM_PAYLOAD_SIZE);
+				leader.infos.width = GUINT32_TO_LE (transport->width);
+				leader.infos.height = GUINT32_TO_LE (transport->height);
+				g_mutex_unlock (&transport->mutex);
+
+				leader.header.magic = GUINT32_TO_LE (ARV_UVSP_LEADER_MAGIC);
+				leader.header.size = GUINT16_TO_LE (sizeof (ArvUvspLeader));
+				leader.header.frame_id = GUINT64_TO_LE (transport->frame_id);
+				leader.infos.payload_type = GUINT16_TO_LE (ARV_UVSP_PAYLOAD_TYPE_IMAGE);
+				leader.infos.timestamp = GUINT64_TO_LE (g_get_real_time () * 1000LL);
+				leader.infos.pixel_format = GUINT32_TO_LE (ARV_PIXEL_FORMAT_MONO_8);
+
+				*transferred_size = MIN (size, sizeof (leader));
+				memcpy (data, &leader, *transferred_size);
+
+				transport->payload_offset = 0;
+				transport->state = transport->payload > 0 ?
+					ARV_UV_FAKE_TRANSPORT_STATE_PAYLOAD :
+					ARV_UV_FAKE_TRANSPORT_STATE_TRAILER;
+			}
+			break;
+		case ARV_UV_FAKE_TRANSPORT_STATE_PAYLOAD:
+			{
+				size_t transfer_size;
+
+				transfer_size = MIN (size, transport->payload - transport->payload_offset);
+				if (transport->payload_transfer_size > 0)
+					transfer_size = MIN (transfer_size, transport->payload_transfer_size);
+
+				if (short_transfer_ratio > 0.0 && transfer_size >= 2 * alignment &&
+				    g_rand_double (transport->rand) < short_transfer_ratio)
+					transfer_size = g_rand_int_range (transport->rand, 1, transfer_size / alignment) *
+						alignment;
+
+				/* The pixel data is the frame id, as in a static scene */
+				memset (data, transport->frame_id & 0xff, transfer_size);
+				*transferred_size = transfer_size;
+
+				transport->payload_offset += transfer_size;
+				if (transport->payload_offset >= transport->payload)
+					transport->state = ARV_UV_FAKE_TRANSPORT_STATE_TRAILER;
+			}
+			break;
+		case ARV_UV_FAKE_TRANSPORT_STATE_TRAILER:
+			{
+				ArvUvspTrailer trailer = {0};
+				size_t trailer_size;
+
+				g_mutex_lock (&transport->mutex);
+				trailer_size = transport->trailer_size;
+				g_mutex_unlock (&transport->mutex);
+
+				trailer.header.magic = GUINT32_TO_LE (ARV_UVSP_TRAILER_MAGIC);
+				trailer.header.size = GUINT16_TO_LE (sizeof (ArvUvspTrailer));
+				trailer.header.frame_id = GUINT64_TO_LE (transport->frame_id);
+				trailer.infos.payload_size = GUINT64_TO_LE (transport->payload);
+
+				*transferred_size = MIN (size, trailer_size);
+				memset (data, 0, *transferred_size);
+				memcpy (data, &trailer, MIN (*transferred_size, sizeof (trailer)));
+
+				transport->frame_id++;
+				transport->state = ARV_UV_FAKE_TRANSPORT_STATE_LEADER;
+				g_atomic_int_inc (&transport->n_frames);
+			}
+			break;
+	}
+
+	return TRUE;
+}
+
+gboolean
+arv_uv_fake_transport_bulk_transfer (ArvUvFakeTransport *transport, ArvUvEndpointType endpoint_type,
+				     unsigned char endpoint_flags, void *data, size_t size, size_t *transferred_size,
+				     guint32 timeout_ms, GError **error)
+{
+	size_t transferred = 0;
+	gboolean success;
+
+	g_return_val_if_fail (transport != NULL, FALSE);
+
+	if (endpoint_type == ARV_UV_ENDPOINT_CONTROL)
+		success = _control_transfer (transport, endpoint_flags, data, size, &transferred, error);
+	else if (endpoint_type == ARV_UV_ENDPOINT_EVENT) {
+		g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_PROTOCOL_ERROR, "No event endpoint");
+		success = FALSE;
+	} else if ((endpoint_flags & LIBUSB_ENDPOINT_IN) != 0)
+		success = _data_transfer (transport, data, size, &transferred, timeout_ms, error);
+	else {
+		g_set_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_PROTOCOL_ERROR, "Invalid data endpoint direction");
+		success = FALSE;
+	}
+
+	if (transferred_size != NULL)
+		*transferred_size = transferred;
+
+	return success;
+}
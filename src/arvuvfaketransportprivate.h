@@ -0,0 +1,66 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2019 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel@gnome.org>
+ */
+
+#ifndef ARV_UV_FAKE_TRANSPORT_PRIVATE_H
+#define ARV_UV_FAKE_TRANSPORT_PRIVATE_H
+
+#if !defined (ARV_H_INSIDE) && !defined (ARAVIS_COMPILATION)
+#error "Only <arv.h> can be included directly."
+#endif
+
+#include <arvuvdeviceprivate.h>
+
+G_BEGIN_DECLS
+
+#define ARV_UV_FAKE_TRANSPORT_WIDTH_DEFAULT	512
+#define ARV_UV_FAKE_TRANSPORT_HEIGHT_DEFAULT	512
+#define ARV_UV_FAKE_TRANSPORT_ALIGNMENT_DEFAULT	8
+
+ArvUvFakeTransport *	arv_uv_fake_transport_new			(void);
+void			arv_uv_fake_transport_free			(ArvUvFakeTransport *transport);
+
+void			arv_uv_fake_transport_set_region		(ArvUvFakeTransport *transport,
+									 guint32 width, guint32 height);
+void			arv_uv_fake_transport_set_alignment		(ArvUvFakeTransport *transport,
+									 guint32 alignment);
+void			arv_uv_fake_transport_set_trailer_size		(ArvUvFakeTransport *transport,
+									 guint32 trailer_size);
+void			arv_uv_fake_transport_set_frame_rate		(ArvUvFakeTransport *transport,
+									 double frame_rate);
+void			arv_uv_fake_transport_set_short_transfer_ratio	(ArvUvFakeTransport *transport,
+									 double ratio);
+void			arv_uv_fake_transport_set_command_queue_size	(ArvUvFakeTransport *transport,
+									 guint queue_size);
+void			arv_uv_fake_transport_set_seed			(ArvUvFakeTransport *transport,
+									 guint32 seed);
+guint64			arv_uv_fake_transport_get_payload		(ArvUvFakeTransport *transport);
+guint			arv_uv_fake_transport_get_n_frames		(ArvUvFakeTransport *transport);
+
+gboolean		arv_uv_fake_transport_bulk_transfer		(ArvUvFakeTransport *transport,
+									 ArvUvEndpointType endpoint_type,
+									 unsigned char endpoint_flags,
+									 void *data, size_t size, size_t *transferred_size,
+									 guint32 timeout_ms, GError **error);
+
+G_END_DECLS
+
+#endif
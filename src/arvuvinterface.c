@@ -46,6 +46,9 @@ typedef struct {
 	volatile gint ref_count;
 } ArvUvInterfaceDeviceInfos;
 
+/* Protects the device table, devices may be opened concurrently from several threads */
+static GMutex arv_uv_interface_devices_mutex;
+
 static ArvUvInterfaceDeviceInfos *
 arv_uv_interface_device_infos_new (const char *manufacturer,
 				   const char *product,
@@ -101,6 +104,15 @@ arv_uv_interface_device_infos_unref (ArvUvInterfaceDeviceInfos *infos)
 typedef struct {
 	GHashTable *devices;
 	libusb_context *usb;
+
+	/* With hotplug support, the device list is maintained from the libusb hotplug events, instead of a rescan
+	 * of the USB tree at each update */
+	gboolean has_hotplug;
+	libusb_hotplug_callback_handle hotplug_handle;
+	/* libusb_device -> ArvUvInterfaceDeviceInfos of the connected USB3Vision devices */
+	GHashTable *usb_devices;
+	/* Arrived devices, identified at the next update, outside of the hotplug callback */
+	GSList *arrived_usb_devices;
 } ArvUvInterfacePrivate;
 
 struct _ArvUvInterface {
@@ -152,10 +164,13 @@ printdev (libusb_device *device)
 }
 #endif
 
-static ArvInterfaceDeviceIds *
-_usb_device_to_device_ids (ArvUvInterface *uv_interface, libusb_device *device)
+/* Returns the identification of @device if it is a USB3Vision device. @is_uv_device is set to TRUE for a USB3Vision
+ * device, even if it could not be opened for the reading of its string descriptors. */
+
+static ArvUvInterfaceDeviceInfos *
+_usb_device_to_device_infos (libusb_device *device, gboolean *is_uv_device)
 {
-	ArvInterfaceDeviceIds *device_ids = NULL;
+	ArvUvInterfaceDeviceInfos *device_infos = NULL;
 	libusb_device_handle *device_handle;
 	struct libusb_device_descriptor desc;
 	struct libusb_config_descriptor *config;
@@ -165,6 +180,8 @@ _usb_device_to_device_ids (ArvUvInterface *uv_interface, libusb_device *device)
 	gboolean data_protocol_found;
 	int r, i, j;
 
+	*is_uv_device = FALSE;
+
 	r = libusb_get_device_descriptor (device, &desc);
 	if (r < 0) {
 		arv_warning_interface ("Failed to get device descriptor");
@@ -178,7 +195,8 @@ _usb_device_to_device_ids (ArvUvInterface *uv_interface, libusb_device *device)
 
 	control_protocol_found = FALSE;
 	data_protocol_found = FALSE;
-	libusb_get_config_descriptor (device, 0, &config);
+	if (libusb_get_config_descriptor (device, 0, &config) != LIBUSB_SUCCESS)
+		return NULL;
 	for (i = 0; i< (int) config->bNumInterfaces; i++) {
 		inter = &config->interface[i];
 		for (j = 0; j < inter->num_altsetting; j++) {
@@ -197,15 +215,14 @@ _usb_device_to_device_ids (ArvUvInterface *uv_interface, libusb_device *device)
 	if (!control_protocol_found || !data_protocol_found)
 		return NULL;
 
+	*is_uv_device = TRUE;
+
 	if (libusb_open (device, &device_handle) == LIBUSB_SUCCESS) {
-		ArvUvInterfaceDeviceInfos *device_infos;
 		unsigned char *manufacturer;
 		unsigned char *product;
 		unsigned char *serial_nbr;
 		int index;
 
-		device_ids = g_new0 (ArvInterfaceDeviceIds, 1);
-
 		manufacturer = g_malloc0 (256);
 		product = g_malloc0 (256);
 		serial_nbr = g_malloc0 (256);
@@ -221,18 +238,6 @@ _usb_device_to_device_ids (ArvUvInterface *uv_interface, libusb_device *device)
 			libusb_get_string_descriptor_ascii (device_handle, index, serial_nbr, 256);
 
 		device_infos = arv_uv_interface_device_infos_new ((char *) manufacturer, (char *) product, (char *) serial_nbr);
-		g_hash_table_replace (uv_interface->priv->devices, device_infos->name,
-				      arv_uv_interface_device_infos_ref (device_infos));
-		g_hash_table_replace (uv_interface->priv->devices, device_infos->full_name,
-				      arv_uv_interface_device_infos_ref (device_infos));
-		arv_uv_interface_device_infos_unref (device_infos);
-
-		device_ids->device = g_strdup (device_infos->name);
-		device_ids->physical = g_strdup ("USB3");	/* FIXME */
-		device_ids->address = g_strdup ("USB3");	/* FIXME */
-		device_ids->vendor = g_strdup (device_infos->manufacturer);
-		device_ids->model = g_strdup (device_infos->product);
-		device_ids->serial_nbr = g_strdup (device_infos->serial_nbr);
 
 		g_free (manufacturer);
 		g_free (product);
@@ -242,9 +247,45 @@ _usb_device_to_device_ids (ArvUvInterface *uv_interface, libusb_device *device)
 	} else
 		arv_warning_interface ("Failed to open USB device");
 
+	return device_infos;
+}
+
+static ArvInterfaceDeviceIds *
+_device_infos_to_device_ids (ArvUvInterfaceDeviceInfos *device_infos)
+{
+	ArvInterfaceDeviceIds *device_ids;
+
+	device_ids = g_new0 (ArvInterfaceDeviceIds, 1);
+	device_ids->device = g_strdup (device_infos->name);
+	device_ids->physical = g_strdup ("USB3");	/* FIXME */
+	device_ids->address = g_strdup ("USB3");	/* FIXME */
+	device_ids->vendor = g_strdup (device_infos->manufacturer);
+	device_ids->model = g_strdup (device_infos->product);
+	device_ids->serial_nbr = g_strdup (device_infos->serial_nbr);
+
 	return device_ids;
 }
 
+static void
+_insert_device_infos (ArvUvInterface *uv_interface, ArvUvInterfaceDeviceInfos *device_infos)
+{
+	g_hash_table_replace (uv_interface->priv->devices, device_infos->name,
+			      arv_uv_interface_device_infos_ref (device_infos));
+	g_hash_table_replace (uv_interface->priv->devices, device_infos->full_name,
+			      arv_uv_interface_device_infos_ref (device_infos));
+}
+
+static void
+_remove_device_infos (ArvUvInterface *uv_interface, ArvUvInterfaceDeviceInfos *device_infos)
+{
+	if (g_hash_table_lookup (uv_interface->priv->devices, device_infos->name) == device_infos)
+		g_hash_table_remove (uv_interface->priv->devices, device_infos->name);
+	if (g_hash_table_lookup (uv_interface->priv->devices, device_infos->full_name) == device_infos)
+		g_hash_table_remove (uv_interface->priv->devices, device_infos->full_name);
+}
+
+/* Full rescan of the USB tree, used when libusb has no hotplug support on this platform */
+
 static void
 _discover (ArvUvInterface *uv_interface,  GArray *device_ids)
 {
@@ -263,22 +304,19 @@ _discover (ArvUvInterface *uv_interface,  GArray *device_ids)
 	g_hash_table_remove_all (uv_interface->priv->devices);
 
 	for (i = 0; i < count; i++) {
-		ArvInterfaceDeviceIds *ids;
-
-		ids = _usb_device_to_device_ids (uv_interface, devices[i]);
-		if (ids != NULL) {
-		    uv_count++;
-		    if (device_ids != NULL)
-			    g_array_append_val (device_ids, ids);
-		    else {
-			    g_free (ids->device);
-			    g_free (ids->physical);
-			    g_free (ids->address);
-			    g_free (ids->vendor);
-			    g_free (ids->model);
-			    g_free (ids->serial_nbr);
-			    g_free (ids);
-		    }
+		ArvUvInterfaceDeviceInfos *device_infos;
+		gboolean is_uv_device;
+
+		device_infos = _usb_device_to_device_infos (devices[i], &is_uv_device);
+		if (device_infos != NULL) {
+			uv_count++;
+			_insert_device_infos (uv_interface, device_infos);
+			if (device_ids != NULL) {
+				ArvInterfaceDeviceIds *ids = _device_infos_to_device_ids (device_infos);
+
+				g_array_append_val (device_ids, ids);
+			}
+			arv_uv_interface_device_infos_unref (device_infos);
 		}
 	}
 
@@ -289,6 +327,72 @@ _discover (ArvUvInterface *uv_interface,  GArray *device_ids)
 	libusb_free_device_list (devices, 1);
 }
 
+/* Called from libusb_handle_events_timeout_completed() in _process_hotplug_events(), or from
+ * libusb_hotplug_register_callback() for the devices already connected. The string descriptors can not be read
+ * from the callback, arrived devices are only queued here. */
+
+static int LIBUSB_CALL
+_hotplug_cb (libusb_context *usb, libusb_device *device, libusb_hotplug_event event, void *user_data)
+{
+	ArvUvInterface *uv_interface = user_data;
+	ArvUvInterfacePrivate *priv = uv_interface->priv;
+
+	if (event == LIBUSB_HOTPLUG_EVENT_DEVICE_ARRIVED) {
+		priv->arrived_usb_devices = g_slist_prepend (priv->arrived_usb_devices, libusb_ref_device (device));
+	} else {
+		ArvUvInterfaceDeviceInfos *device_infos;
+		GSList *arrived;
+
+		arrived = g_slist_find (priv->arrived_usb_devices, device);
+		if (arrived != NULL) {
+			priv->arrived_usb_devices = g_slist_delete_link (priv->arrived_usb_devices, arrived);
+			libusb_unref_device (device);
+		}
+
+		device_infos = g_hash_table_lookup (priv->usb_devices, device);
+		if (device_infos != NULL) {
+			arv_info_interface ("[UvInterface::hotplug] %s left", device_infos->name);
+			_remove_device_infos (uv_interface, device_infos);
+			g_hash_table_remove (priv->usb_devices, device);
+		}
+	}
+
+	return 0;
+}
+
+static void
+_process_hotplug_events (ArvUvInterface *uv_interface)
+{
+	ArvUvInterfacePrivate *priv = uv_interface->priv;
+	struct timeval timeout = {0, 0};
+	GSList *arrived;
+	GSList *iter;
+
+	libusb_handle_events_timeout_completed (priv->usb, &timeout, NULL);
+
+	arrived = priv->arrived_usb_devices;
+	priv->arrived_usb_devices = NULL;
+
+	for (iter = arrived; iter != NULL; iter = iter->next) {
+		libusb_device *device = iter->data;
+		ArvUvInterfaceDeviceInfos *device_infos;
+		gboolean is_uv_device;
+
+		device_infos = _usb_device_to_device_infos (device, &is_uv_device);
+		if (device_infos != NULL) {
+			arv_info_interface ("[UvInterface::hotplug] %s arrived", device_infos->name);
+			_insert_device_infos (uv_interface, device_infos);
+			g_hash_table_replace (priv->usb_devices, device, device_infos);
+		} else if (is_uv_device) {
+			/* Not accessible yet, probably waiting for its permissions, try again at the next update */
+			priv->arrived_usb_devices = g_slist_prepend (priv->arrived_usb_devices, device);
+		} else
+			libusb_unref_device (device);
+	}
+
+	g_slist_free (arrived);
+}
+
 static void
 arv_uv_interface_update_device_list (ArvInterface *interface, GArray *device_ids)
 {
@@ -296,7 +400,24 @@ arv_uv_interface_update_device_list (ArvInterface *interface, GArray *device_ids
 
 	g_assert (device_ids->len == 0);
 
-	_discover (uv_interface, device_ids);
+	g_mutex_lock (&arv_uv_interface_devices_mutex);
+
+	if (uv_interface->priv->has_hotplug) {
+		GHashTableIter iter;
+		gpointer value;
+
+		_process_hotplug_events (uv_interface);
+
+		g_hash_table_iter_init (&iter, uv_interface->priv->usb_devices);
+		while (g_hash_table_iter_next (&iter, NULL, &value)) {
+			ArvInterfaceDeviceIds *ids = _device_infos_to_device_ids (value);
+
+			g_array_append_val (device_ids, ids);
+		}
+	} else
+		_discover (uv_interface, device_ids);
+
+	g_mutex_unlock (&arv_uv_interface_devices_mutex);
 }
 
 static ArvDevice *
@@ -304,9 +425,12 @@ _open_device (ArvInterface *interface, const char *device_id, GError **error)
 {
 	ArvUvInterface *uv_interface;
 	ArvUvInterfaceDeviceInfos *device_infos;
+	ArvDevice *device;
 
 	uv_interface = ARV_UV_INTERFACE (interface);
 
+	g_mutex_lock (&arv_uv_interface_devices_mutex);
+
 	if (device_id == NULL) {
 		GList *device_list;
 
@@ -316,10 +440,20 @@ _open_device (ArvInterface *interface, const char *device_id, GError **error)
 	} else
 		device_infos = g_hash_table_lookup (uv_interface->priv->devices, device_id);
 
+	if (device_infos != NULL)
+		arv_uv_interface_device_infos_ref (device_infos);
+
+	g_mutex_unlock (&arv_uv_interface_devices_mutex);
+
 	if (device_infos == NULL)
 		return NULL;
 
-	return arv_uv_device_new (device_infos->manufacturer, device_infos->product, device_infos->serial_nbr, error);
+	/* The device is created without the lock held, as it downloads its GenICam data */
+	device = arv_uv_device_new (device_infos->manufacturer, device_infos->product, device_infos->serial_nbr, error);
+
+	arv_uv_interface_device_infos_unref (device_infos);
+
+	return device;
 }
 
 static ArvDevice *
@@ -335,7 +469,12 @@ arv_uv_interface_open_device (ArvInterface *interface, const char *device_id, GE
 		return device;
 	}
 
-	_discover (ARV_UV_INTERFACE (interface), NULL);
+	g_mutex_lock (&arv_uv_interface_devices_mutex);
+	if (ARV_UV_INTERFACE (interface)->priv->has_hotplug)
+		_process_hotplug_events (ARV_UV_INTERFACE (interface));
+	else
+		_discover (ARV_UV_INTERFACE (interface), NULL);
+	g_mutex_unlock (&arv_uv_interface_devices_mutex);
 
 	return _open_device (interface, device_id, error);
 }
@@ -384,6 +523,21 @@ arv_uv_interface_init (ArvUvInterface *uv_interface)
 	libusb_init (&uv_interface->priv->usb);
 	uv_interface->priv->devices = g_hash_table_new_full (g_str_hash, g_str_equal, NULL,
 							     (GDestroyNotify) arv_uv_interface_device_infos_unref);
+	uv_interface->priv->usb_devices = g_hash_table_new_full (g_direct_hash, g_direct_equal,
+								 (GDestroyNotify) libusb_unref_device,
+								 (GDestroyNotify) arv_uv_interface_device_infos_unref);
+
+	uv_interface->priv->has_hotplug =
+		libusb_has_capability (LIBUSB_CAP_HAS_HOTPLUG) &&
+		libusb_hotplug_register_callback (uv_interface->priv->usb,
+						  LIBUSB_HOTPLUG_EVENT_DEVICE_ARRIVED | LIBUSB_HOTPLUG_EVENT_DEVICE_LEFT,
+						  LIBUSB_HOTPLUG_ENUMERATE,
+						  LIBUSB_HOTPLUG_MATCH_ANY, LIBUSB_HOTPLUG_MATCH_ANY,
+						  ARV_UV_INTERFACE_DEVICE_CLASS,
+						  _hotplug_cb, uv_interface,
+						  &uv_interface->priv->hotplug_handle) == LIBUSB_SUCCESS;
+
+	arv_info_interface ("[UvInterface::init] Hotplug %s", uv_interface->priv->has_hotplug ? "enabled" : "not available");
 }
 
 static void
@@ -391,6 +545,10 @@ arv_uv_interface_finalize (GObject *object)
 {
 	ArvUvInterface *uv_interface = ARV_UV_INTERFACE (object);
 
+	if (uv_interface->priv->has_hotplug)
+		libusb_hotplug_deregister_callback (uv_interface->priv->usb, uv_interface->priv->hotplug_handle);
+	g_slist_free_full (uv_interface->priv->arrived_usb_devices, (GDestroyNotify) libusb_unref_device);
+	g_hash_table_unref (uv_interface->priv->usb_devices);
 	g_hash_table_unref (uv_interface->priv->devices);
 
 	G_OBJECT_CLASS (arv_uv_interface_parent_class)->finalize (object);
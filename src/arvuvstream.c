@@ -25,22 +25,49 @@
  * @short_description: USB3Vision video stream
  */
 
+#define ARV_DEBUG_HOT_PATH
+
 #include <arvuvstreamprivate.h>
 #include <arvstreamprivate.h>
 #include <arvbufferprivate.h>
 #include <arvuvspprivate.h>
 #include <arvuvcpprivate.h>
+#include <arvuvdeviceprivate.h>
+#include <arvuvbandwidthprivate.h>
+#include <arvchecksumprivate.h>
 #include <arvdebug.h>
-#include <arvmisc.h>
+#include <arvmiscprivate.h>
+#include <arvtraceprivate.h>
 #include <libusb.h>
 #include <string.h>
 
 #define ARV_UV_STREAM_MAXIMUM_TRANSFER_SIZE	1048576
 
+/* Asynchronous mode. The usbfs default memory limit is 16 MiB for all the in flight transfers. */
+#define ARV_UV_STREAM_N_BUFFER_CONTEXTS		2
+#define ARV_UV_STREAM_MAXIMUM_BYTES_IN_FLIGHT	(8 * 1048576)
+#define ARV_UV_STREAM_EVENT_TIMEOUT_MS		100
+/* Wakeup period of the stream thread while the stream is paused */
+#define ARV_UV_STREAM_PAUSE_POLL_US		1000
+
 /* Acquisition thread */
 
+typedef struct _ArvUvStreamBufferContext ArvUvStreamBufferContext;
+
+/* Payload transfer of the transfer plan. The plan is computed once from the SIRM registers at stream start, and lists
+ * the payload transfers in the device order: payload_count transfers of payload_size bytes, the aligned part of the
+ * remainder (transfer1), and the last incomplete alignment block (transfer2). Only the transfer2 can go beyond the end
+ * of a buffer of the expected payload size, all the other ones land directly in the buffer data. */
+
+typedef struct {
+	size_t offset;
+	size_t size;
+} ArvUvStreamTransfer;
+
 typedef struct {
 	ArvStream *stream;
+	/* Owned by the stream */
+	ArvEventRing *event_ring;
 
 	ArvUvDevice *uv_device;
 	ArvStreamCallback callback;
@@ -50,13 +77,48 @@ typedef struct {
 	size_t payload_size;
 	size_t trailer_size;
 
+	ArvUvStreamTransfer *transfers;
+	guint n_transfers;
+	size_t expected_size;
+
 	gboolean cancel;
+	/* Number of pauses of the stream seen by the thread */
+	guint n_pauses;
+
+	/* Copy kernel of the payloads not received in place, refreshed at the start of each frame, NULL for memcpy */
+	ArvStreamCopyFunc copy_func;
+	void *copy_data;
+	/* Checksum of the received data, refreshed with the copy kernel */
+	gboolean checksum;
+
+	/* Asynchronous mode */
+	ArvUvUsbMode usb_mode;
+	ArvUvStreamBufferContext *contexts[ARV_UV_STREAM_N_BUFFER_CONTEXTS];
+	guint oldest_context;
+	size_t n_bytes_in_flight;
+	gboolean is_resync_needed;
+	gboolean is_underrun;
 
 	/* Statistics */
 
 	guint n_completed_buffers;
 	guint n_failures;
 	guint n_underruns;
+	guint n_size_mismatch_errors;
+	guint n_missing_trailers;
+	guint n_transfer_errors;
+
+	guint64 n_usb_transfers;
+	guint64 n_transferred_bytes;
+	/* Time spent waiting in libusb */
+	guint64 transfer_wait_time_us;
+
+	/* Received bytes per second, averaged over about one second */
+	double throughput;
+	gint64 throughput_time_us;
+	guint64 throughput_n_bytes;
+
+	ArvStatistic *statistic;
 } ArvUvStreamThreadData;
 
 typedef struct {
@@ -75,6 +137,89 @@ struct _ArvUvStreamClass {
 
 G_DEFINE_TYPE_WITH_CODE (ArvUvStream, arv_uv_stream, ARV_TYPE_STREAM, G_ADD_PRIVATE (ArvUvStream))
 
+static ArvBuffer *
+_pop_input_buffer (ArvUvStreamThreadData *thread_data)
+{
+	thread_data->copy_func = arv_stream_get_copy_function (thread_data->stream, &thread_data->copy_data);
+	thread_data->checksum = arv_stream_is_checksum_enabled (thread_data->stream);
+
+	return arv_stream_pop_input_buffer (thread_data->stream);
+}
+
+static inline void
+_copy_payload (ArvUvStreamThreadData *thread_data, void *dst, const void *src, size_t size)
+{
+	if (thread_data->copy_func != NULL)
+		thread_data->copy_func (dst, src, size, thread_data->copy_data);
+	else
+		memcpy (dst, src, size);
+}
+
+static void
+_transfer_statistics (ArvUvStreamThreadData *thread_data, size_t transferred, gint64 duration_us, gboolean is_payload)
+{
+	thread_data->n_usb_transfers++;
+	thread_data->n_transferred_bytes += transferred;
+
+	if (is_payload)
+		arv_statistic_fill (thread_data->statistic, 0, duration_us, thread_data->n_usb_transfers);
+}
+
+static void
+_buffer_done_statistics (ArvUvStreamThreadData *thread_data, ArvBuffer *buffer, gint64 leader_time_us)
+{
+	ArvFrameLog *frame_log;
+	gint64 time_us = g_get_monotonic_time ();
+
+	/* The trailer was just received, index the chunks before the consumer asks for them */
+	if (buffer->priv->status == ARV_BUFFER_STATUS_SUCCESS &&
+	    arv_buffer_payload_type_has_chunks (buffer->priv->payload_type) &&
+	    buffer->priv->data != NULL)
+		arv_buffer_build_chunk_index (buffer);
+
+	ARV_TRACE_FRAME_CLOSED (buffer->priv->frame_id, buffer->priv->status, time_us);
+	arv_event_ring_record (thread_data->event_ring, ARV_EVENT_RING_EVENT_FRAME_CLOSED, buffer->priv->frame_id, 0, buffer->priv->status);
+
+	frame_log = arv_stream_get_frame_log (thread_data->stream);
+	if (frame_log != NULL)
+		arv_frame_log_append (frame_log, buffer, 0, 0, 0);
+
+	if (buffer->priv->status == ARV_BUFFER_STATUS_SUCCESS && leader_time_us > 0)
+		arv_statistic_fill (thread_data->statistic, 1, time_us - leader_time_us, buffer->priv->frame_id);
+	else if (buffer->priv->status == ARV_BUFFER_STATUS_SIZE_MISMATCH)
+		thread_data->n_size_mismatch_errors++;
+
+	/* Losses are also accounted per USB bus, as a hint of an oversubscribed bus */
+	if (buffer->priv->status != ARV_BUFFER_STATUS_SUCCESS &&
+	    buffer->priv->status != ARV_BUFFER_STATUS_ABORTED)
+		arv_uv_bandwidth_report_frame_loss (thread_data->uv_device);
+
+	if (thread_data->throughput_time_us == 0 ||
+	    time_us - thread_data->throughput_time_us >= 1000000) {
+		if (thread_data->throughput_time_us != 0)
+			thread_data->throughput = (double) (thread_data->n_transferred_bytes -
+							    thread_data->throughput_n_bytes) * 1e6 /
+				(time_us - thread_data->throughput_time_us);
+		thread_data->throughput_time_us = time_us;
+		thread_data->throughput_n_bytes = thread_data->n_transferred_bytes;
+	}
+}
+
+/* Returns TRUE once after each pause of the stream, for the release of the open buffers */
+
+static gboolean
+_check_pause (ArvUvStreamThreadData *thread_data)
+{
+	guint n_pauses = arv_stream_get_n_pauses (thread_data->stream);
+
+	if (G_LIKELY (n_pauses == thread_data->n_pauses))
+		return FALSE;
+
+	thread_data->n_pauses = n_pauses;
+
+	return TRUE;
+}
+
 static void *
 arv_uv_stream_thread (void *data)
 {
@@ -83,30 +228,58 @@ arv_uv_stream_thread (void *data)
 	ArvBuffer *buffer = NULL;
 	void *incoming_buffer;
 	guint64 offset;
+	guint transfer_index;
 	size_t transferred;
+	gint64 leader_time_us = 0;
 
 	arv_debug_stream_thread ("Start USB3Vision stream thread");
 
+	arv_stream_apply_thread_placement (thread_data->stream);
+
 	incoming_buffer = g_malloc (ARV_UV_STREAM_MAXIMUM_TRANSFER_SIZE);
 
 	if (thread_data->callback != NULL)
 		thread_data->callback (thread_data->callback_data, ARV_STREAM_CALLBACK_TYPE_INIT, NULL);
 
 	offset = 0;
+	transfer_index = 0;
 
 	while (!g_atomic_int_get (&thread_data->cancel)) {
 		GError *error = NULL;
 		size_t size;
+		gint64 start_time_us;
+		gint64 duration_us;
 		transferred = 0;
 
+		arv_stream_update_thread_placement (thread_data->stream);
+
+		if (G_UNLIKELY (_check_pause (thread_data)) && buffer != NULL) {
+			buffer->priv->status = ARV_BUFFER_STATUS_ABORTED;
+			_buffer_done_statistics (thread_data, buffer, leader_time_us);
+			arv_stream_push_output_buffer (thread_data->stream, buffer);
+			if (thread_data->callback != NULL)
+				thread_data->callback (thread_data->callback_data,
+						       ARV_STREAM_CALLBACK_TYPE_BUFFER_DONE,
+						       buffer);
+			buffer = NULL;
+		}
+
+		/* The device buffers the data of the next acquisition until the resume */
+		if (G_UNLIKELY (arv_stream_is_paused (thread_data->stream))) {
+			g_usleep (ARV_UV_STREAM_PAUSE_POLL_US);
+			continue;
+		}
+
 		if (buffer == NULL)
 			size = ARV_UV_STREAM_MAXIMUM_TRANSFER_SIZE;
-		else {
-			if (offset < buffer->priv->size)
-				size = MIN (thread_data->payload_size, buffer->priv->size - offset);
-			else
-				size = thread_data->trailer_size;
-		}
+		else if (transfer_index < thread_data->n_transfers &&
+			 offset == thread_data->transfers[transfer_index].offset)
+			size = thread_data->transfers[transfer_index].size;
+		else if (transfer_index < thread_data->n_transfers && offset < buffer->priv->size)
+			/* Out of the plan after a short transfer */
+			size = MIN (thread_data->payload_size, buffer->priv->size - offset);
+		else
+			size = thread_data->trailer_size;
 
 		/* Avoid unnecessary memory copy by transferring data directly to the image buffer */
 		if (buffer != NULL &&
@@ -117,16 +290,23 @@ arv_uv_stream_thread (void *data)
 			packet = incoming_buffer;
 
 		arv_debug_sp ("Asking for %" G_GSIZE_FORMAT " bytes", size);
+		start_time_us = g_get_monotonic_time ();
 		arv_uv_device_bulk_transfer (thread_data->uv_device,  ARV_UV_ENDPOINT_DATA, LIBUSB_ENDPOINT_IN,
 					     packet, size, &transferred, 0, &error);
+		duration_us = g_get_monotonic_time () - start_time_us;
+		thread_data->transfer_wait_time_us += duration_us;
 
 		if (error != NULL) {
 			arv_warning_sp ("USB transfer error: %s", error->message);
+			arv_event_ring_record (thread_data->event_ring, ARV_EVENT_RING_EVENT_TRANSFER_ERROR,
+					       buffer != NULL ? buffer->priv->frame_id : 0, 0, error->code);
 			g_clear_error (&error);
+			thread_data->n_transfer_errors++;
 		} else {
 			ArvUvspPacketType packet_type;
 
 			arv_debug_sp ("Received %" G_GSIZE_FORMAT " bytes", transferred);
+			_transfer_statistics (thread_data, transferred, duration_us, buffer != NULL);
 			arv_uvsp_packet_debug (packet, ARV_DEBUG_LEVEL_DEBUG);
 
 			packet_type = arv_uvsp_packet_get_packet_type (packet);
@@ -134,19 +314,30 @@ arv_uv_stream_thread (void *data)
 				case ARV_UVSP_PACKET_TYPE_LEADER:
 					if (buffer != NULL) {
 						arv_info_stream_thread ("New leader received while a buffer is still open");
+						arv_event_ring_record (thread_data->event_ring, ARV_EVENT_RING_EVENT_MISSING_TRAILER,
+								       buffer->priv->frame_id, 0, 0);
 						buffer->priv->status = ARV_BUFFER_STATUS_MISSING_PACKETS;
+						_buffer_done_statistics (thread_data, buffer, leader_time_us);
 						arv_stream_push_output_buffer (thread_data->stream, buffer);
 						if (thread_data->callback != NULL)
 							thread_data->callback (thread_data->callback_data,
 									       ARV_STREAM_CALLBACK_TYPE_BUFFER_DONE,
 									       buffer);
 						thread_data->n_failures++;
+						thread_data->n_missing_trailers++;
 						buffer = NULL;
 					}
-					buffer = arv_stream_pop_input_buffer (thread_data->stream);
+					leader_time_us = g_get_monotonic_time ();
+					buffer = _pop_input_buffer (thread_data);
 					if (buffer != NULL) {
 						buffer->priv->system_timestamp_ns = g_get_real_time () * 1000LL;
+						buffer->priv->host_timestamp_ns = leader_time_us * 1000LL;
 						buffer->priv->status = ARV_BUFFER_STATUS_FILLING;
+						buffer->priv->ready_offset = 0;
+						buffer->priv->ready_size = 0;
+						buffer->priv->has_chunk_index = FALSE;
+						buffer->priv->has_checksum = FALSE;
+						buffer->priv->checksum = 0;
 						buffer->priv->payload_type = arv_uvsp_packet_get_buffer_payload_type (packet);
 						buffer->priv->chunk_endianness = G_LITTLE_ENDIAN;
 						if (buffer->priv->payload_type == ARV_BUFFER_PAYLOAD_TYPE_IMAGE ||
@@ -160,13 +351,20 @@ arv_uv_stream_thread (void *data)
 						}
 						buffer->priv->frame_id = arv_uvsp_packet_get_frame_id (packet);
 						buffer->priv->timestamp_ns = arv_uvsp_packet_get_timestamp (packet);
+						ARV_TRACE_LEADER_RECEIVED (buffer->priv->frame_id, leader_time_us);
+						arv_event_ring_record (thread_data->event_ring, ARV_EVENT_RING_EVENT_LEADER,
+								       buffer->priv->frame_id, 0, 0);
 						offset = 0;
+						transfer_index = 0;
 						if (thread_data->callback != NULL)
 							thread_data->callback (thread_data->callback_data,
 									       ARV_STREAM_CALLBACK_TYPE_START_BUFFER,
 									       NULL);
-					} else
+					} else {
 						thread_data->n_underruns++;
+						arv_event_ring_record (thread_data->event_ring, ARV_EVENT_RING_EVENT_UNDERRUN,
+								       arv_uvsp_packet_get_frame_id (packet), 0, 0);
+					}
 					break;
 				case ARV_UVSP_PACKET_TYPE_TRAILER:
 					if (buffer != NULL) {
@@ -182,6 +380,7 @@ arv_uv_stream_thread (void *data)
 										 offset, buffer->priv->size);
 
 							buffer->priv->status = ARV_BUFFER_STATUS_SIZE_MISMATCH;
+							_buffer_done_statistics (thread_data, buffer, leader_time_us);
 							arv_stream_push_output_buffer (thread_data->stream, buffer);
 							if (thread_data->callback != NULL)
 								thread_data->callback (thread_data->callback_data,
@@ -191,6 +390,8 @@ arv_uv_stream_thread (void *data)
 							buffer = NULL;
 						} else {
 							buffer->priv->status = ARV_BUFFER_STATUS_SUCCESS;
+							buffer->priv->has_checksum = thread_data->checksum;
+							_buffer_done_statistics (thread_data, buffer, leader_time_us);
 							arv_stream_push_output_buffer (thread_data->stream, buffer);
 							if (thread_data->callback != NULL)
 								thread_data->callback (thread_data->callback_data,
@@ -205,8 +406,16 @@ arv_uv_stream_thread (void *data)
 					if (buffer != NULL && buffer->priv->status == ARV_BUFFER_STATUS_FILLING) {
 						if (offset + transferred <= buffer->priv->size) {
 							if (packet == incoming_buffer)
-								memcpy (((char *) buffer->priv->data) + offset, packet, transferred);
+								_copy_payload (thread_data, ((char *) buffer->priv->data) + offset,
+									       packet, transferred);
+							if (thread_data->checksum)
+								buffer->priv->checksum =
+									arv_crc32c (buffer->priv->checksum,
+										    ((char *) buffer->priv->data) + offset,
+										    transferred);
 							offset += transferred;
+							transfer_index++;
+							arv_stream_update_ready_region (thread_data->stream, buffer, offset);
 						} else
 							buffer->priv->status = ARV_BUFFER_STATUS_SIZE_MISMATCH;
 					}
@@ -238,6 +447,472 @@ arv_uv_stream_thread (void *data)
 	return NULL;
 }
 
+/* Asynchronous mode. The transfers of a buffer (leader, payload and trailer) are prepared when the buffer is taken
+ * from the input queue, with the payload transfers pointing directly to the buffer data. The transfers of the
+ * current and the next buffers are submitted in advance, in the order expected from the device, and processed on
+ * completion from the stream thread, in arv_uv_device_handle_events(). */
+
+struct _ArvUvStreamBufferContext {
+	ArvUvStreamThreadData *thread_data;
+	guint index;
+
+	ArvBuffer *buffer;
+
+	/* Leader, payload and trailer transfers, in submission order */
+	struct libusb_transfer **transfers;
+	gint64 *submission_times_us;
+	guint n_transfers;
+	guint n_submitted;
+	guint n_completed;
+
+	guint8 *leader_data;
+	guint8 *trailer_data;
+	/* Used for the last planned transfer when it goes beyond the buffer end */
+	guint8 *bounce_data;
+
+	size_t received_size;
+	/* Checksum of the received data, decided on the buffer activation */
+	gboolean checksum;
+	gint64 leader_time_us;
+	gboolean is_transfer_error;
+	gboolean is_protocol_error;
+	gboolean is_cancelled;
+};
+
+static void
+_fill_buffer_from_leader (ArvBuffer *buffer, ArvUvspPacket *packet)
+{
+	buffer->priv->payload_type = arv_uvsp_packet_get_buffer_payload_type (packet);
+	buffer->priv->chunk_endianness = G_LITTLE_ENDIAN;
+	if (buffer->priv->payload_type == ARV_BUFFER_PAYLOAD_TYPE_IMAGE ||
+	    buffer->priv->payload_type == ARV_BUFFER_PAYLOAD_TYPE_EXTENDED_CHUNK_DATA) {
+		arv_uvsp_packet_get_region (packet,
+					    &buffer->priv->width,
+					    &buffer->priv->height,
+					    &buffer->priv->x_offset,
+					    &buffer->priv->y_offset);
+		buffer->priv->pixel_format = arv_uvsp_packet_get_pixel_format (packet);
+	}
+	buffer->priv->frame_id = arv_uvsp_packet_get_frame_id (packet);
+	buffer->priv->timestamp_ns = arv_uvsp_packet_get_timestamp (packet);
+}
+
+static void
+_async_release_buffer (ArvUvStreamBufferContext *context, ArvBufferStatus status)
+{
+	ArvUvStreamThreadData *thread_data = context->thread_data;
+	ArvBuffer *buffer = context->buffer;
+
+	buffer->priv->status = status;
+	_buffer_done_statistics (thread_data, buffer, context->leader_time_us);
+	arv_stream_push_output_buffer (thread_data->stream, buffer);
+	if (thread_data->callback != NULL)
+		thread_data->callback (thread_data->callback_data,
+				       ARV_STREAM_CALLBACK_TYPE_BUFFER_DONE,
+				       buffer);
+
+	if (status == ARV_BUFFER_STATUS_SUCCESS)
+		thread_data->n_completed_buffers++;
+	else if (status != ARV_BUFFER_STATUS_ABORTED)
+		thread_data->n_failures++;
+
+	context->buffer = NULL;
+}
+
+static void
+_async_complete_buffer (ArvUvStreamBufferContext *context)
+{
+	ArvUvStreamThreadData *thread_data = context->thread_data;
+	ArvBufferStatus status;
+
+	if (context->is_cancelled)
+		status = g_atomic_int_get (&thread_data->cancel) || arv_stream_is_paused (thread_data->stream) ?
+			ARV_BUFFER_STATUS_ABORTED :
+			ARV_BUFFER_STATUS_MISSING_PACKETS;
+	else if (context->is_transfer_error || context->is_protocol_error)
+		status = ARV_BUFFER_STATUS_MISSING_PACKETS;
+	else if (context->received_size != context->buffer->priv->size) {
+		arv_info_stream_thread ("Incomplete image received, dropping "
+					"(received %" G_GSIZE_FORMAT " / expected %" G_GSIZE_FORMAT ")",
+					context->received_size, context->buffer->priv->size);
+		status = ARV_BUFFER_STATUS_SIZE_MISMATCH;
+	} else {
+		status = ARV_BUFFER_STATUS_SUCCESS;
+		context->buffer->priv->has_checksum = context->checksum;
+	}
+
+	if (context->is_protocol_error)
+		thread_data->is_resync_needed = TRUE;
+
+	_async_release_buffer (context, status);
+
+	/* Transfers complete in submission order, this context was the oldest one */
+	thread_data->oldest_context = (context->index + 1) % ARV_UV_STREAM_N_BUFFER_CONTEXTS;
+}
+
+static void LIBUSB_CALL
+_async_transfer_done (struct libusb_transfer *transfer)
+{
+	ArvUvStreamBufferContext *context = transfer->user_data;
+	ArvUvStreamThreadData *thread_data = context->thread_data;
+	ArvBuffer *buffer = context->buffer;
+	guint index = context->n_completed;
+
+	thread_data->n_bytes_in_flight -= transfer->length;
+
+	if (transfer->status == LIBUSB_TRANSFER_CANCELLED) {
+		context->is_cancelled = TRUE;
+	} else if (transfer->status != LIBUSB_TRANSFER_COMPLETED) {
+		arv_warning_sp ("USB transfer error: status %d", transfer->status);
+		arv_event_ring_record (thread_data->event_ring, ARV_EVENT_RING_EVENT_TRANSFER_ERROR, buffer->priv->frame_id, index,
+				       transfer->status);
+		context->is_transfer_error = TRUE;
+		thread_data->n_transfer_errors++;
+	} else if (!context->is_transfer_error && !context->is_protocol_error && !context->is_cancelled) {
+		ArvUvspPacket *packet = (ArvUvspPacket *) transfer->buffer;
+
+		arv_debug_sp ("Received %d bytes", transfer->actual_length);
+		_transfer_statistics (thread_data, transfer->actual_length,
+				      g_get_monotonic_time () - context->submission_times_us[index], index > 0);
+
+		if (index == 0) {
+			if (arv_uvsp_packet_get_packet_type (packet) == ARV_UVSP_PACKET_TYPE_LEADER) {
+				context->leader_time_us = g_get_monotonic_time ();
+				arv_uvsp_packet_debug (packet, ARV_DEBUG_LEVEL_DEBUG);
+				_fill_buffer_from_leader (buffer, packet);
+				ARV_TRACE_LEADER_RECEIVED (buffer->priv->frame_id, context->leader_time_us);
+				arv_event_ring_record (thread_data->event_ring, ARV_EVENT_RING_EVENT_LEADER, buffer->priv->frame_id, 0, 0);
+				if (thread_data->callback != NULL)
+					thread_data->callback (thread_data->callback_data,
+							       ARV_STREAM_CALLBACK_TYPE_START_BUFFER,
+							       NULL);
+			} else {
+				arv_info_stream_thread ("Leader expected, resynchronize");
+				context->is_protocol_error = TRUE;
+			}
+		} else if (index == context->n_transfers - 1) {
+			if (arv_uvsp_packet_get_packet_type (packet) != ARV_UVSP_PACKET_TYPE_TRAILER) {
+				arv_info_stream_thread ("Trailer expected, resynchronize");
+				context->is_protocol_error = TRUE;
+				if (arv_uvsp_packet_get_packet_type (packet) == ARV_UVSP_PACKET_TYPE_LEADER) {
+					thread_data->n_missing_trailers++;
+					arv_event_ring_record (thread_data->event_ring, ARV_EVENT_RING_EVENT_MISSING_TRAILER, buffer->priv->frame_id, index, 0);
+				}
+			}
+		} else {
+			size_t size = transfer->actual_length;
+
+			if (transfer->buffer == context->bounce_data) {
+				size = MIN (size, buffer->priv->size - context->received_size);
+				_copy_payload (thread_data, buffer->priv->data + context->received_size,
+					       context->bounce_data, size);
+			}
+
+			/* Transfers complete in order, the payload is checksummed while still in the cache */
+			if (context->checksum)
+				buffer->priv->checksum = arv_crc32c (buffer->priv->checksum,
+								     buffer->priv->data + context->received_size, size);
+
+			context->received_size += size;
+
+			/* A short transfer ends the payload, the data of the following transfers are shifted */
+			if (transfer->actual_length < transfer->length && index < context->n_transfers - 2) {
+				arv_info_stream_thread ("Short payload transfer, resynchronize");
+				context->is_protocol_error = TRUE;
+			} else
+				arv_stream_update_ready_region (thread_data->stream, buffer, context->received_size);
+		}
+	}
+
+	context->n_completed++;
+
+	if (context->n_completed == context->n_transfers)
+		_async_complete_buffer (context);
+}
+
+static ArvUvStreamBufferContext *
+_async_context_new (ArvUvStreamThreadData *thread_data, guint index)
+{
+	ArvUvStreamBufferContext *context;
+	guint i;
+
+	context = g_new0 (ArvUvStreamBufferContext, 1);
+	context->thread_data = thread_data;
+	context->index = index;
+	context->n_transfers = thread_data->n_transfers + 2;
+	context->transfers = g_new0 (struct libusb_transfer *, context->n_transfers);
+	context->submission_times_us = g_new0 (gint64, context->n_transfers);
+	for (i = 0; i < context->n_transfers; i++)
+		context->transfers[i] = libusb_alloc_transfer (0);
+	context->leader_data = g_malloc (thread_data->leader_size);
+	context->trailer_data = g_malloc (thread_data->trailer_size);
+	if (thread_data->n_transfers > 0)
+		context->bounce_data = g_malloc (thread_data->transfers[thread_data->n_transfers - 1].size);
+
+	return context;
+}
+
+static void
+_async_context_free (ArvUvStreamBufferContext *context)
+{
+	guint i;
+
+	for (i = 0; i < context->n_transfers; i++)
+		libusb_free_transfer (context->transfers[i]);
+	g_free (context->transfers);
+	g_free (context->submission_times_us);
+	g_free (context->leader_data);
+	g_free (context->trailer_data);
+	g_free (context->bounce_data);
+	g_free (context);
+}
+
+static void
+_async_fill_transfer (ArvUvStreamBufferContext *context, guint index, void *data, size_t size)
+{
+	arv_uv_device_fill_bulk_transfer (context->transfers[index], context->thread_data->uv_device,
+					  ARV_UV_ENDPOINT_DATA, LIBUSB_ENDPOINT_IN, data, size,
+					  _async_transfer_done, context, 0);
+}
+
+/* Takes a buffer from the input queue and prepares its transfers */
+
+static gboolean
+_async_activate_context (ArvUvStreamBufferContext *context)
+{
+	ArvUvStreamThreadData *thread_data = context->thread_data;
+	ArvBuffer *buffer;
+	size_t minimum_size;
+	guint i;
+
+	/* Only the last transfer may use the bounce buffer */
+	minimum_size = thread_data->n_transfers > 0 ?
+		thread_data->transfers[thread_data->n_transfers - 1].offset : 0;
+
+	for (;;) {
+		buffer = _pop_input_buffer (thread_data);
+		if (buffer == NULL)
+			return FALSE;
+
+		if (buffer->priv->size >= minimum_size)
+			break;
+
+		arv_info_stream_thread ("Buffer too small for the payload transfers "
+					"(%" G_GSIZE_FORMAT " / %" G_GSIZE_FORMAT ")",
+					buffer->priv->size, thread_data->expected_size);
+		context->buffer = buffer;
+		context->leader_time_us = 0;
+		_async_release_buffer (context, ARV_BUFFER_STATUS_SIZE_MISMATCH);
+	}
+
+	buffer->priv->system_timestamp_ns = g_get_real_time () * 1000LL;
+	buffer->priv->host_timestamp_ns = g_get_monotonic_time () * 1000LL;
+	buffer->priv->status = ARV_BUFFER_STATUS_FILLING;
+	buffer->priv->ready_offset = 0;
+	buffer->priv->ready_size = 0;
+	buffer->priv->has_chunk_index = FALSE;
+	buffer->priv->has_checksum = FALSE;
+	buffer->priv->checksum = 0;
+
+	context->buffer = buffer;
+	context->checksum = thread_data->checksum;
+	context->n_submitted = 0;
+	context->n_completed = 0;
+	context->received_size = 0;
+	context->leader_time_us = 0;
+	context->is_transfer_error = FALSE;
+	context->is_protocol_error = FALSE;
+	context->is_cancelled = FALSE;
+
+	_async_fill_transfer (context, 0, context->leader_data, thread_data->leader_size);
+	for (i = 0; i < thread_data->n_transfers; i++) {
+		ArvUvStreamTransfer *planned = &thread_data->transfers[i];
+
+		if (planned->offset + planned->size <= buffer->priv->size)
+			_async_fill_transfer (context, i + 1, buffer->priv->data + planned->offset, planned->size);
+		else
+			_async_fill_transfer (context, i + 1, context->bounce_data, planned->size);
+	}
+	_async_fill_transfer (context, context->n_transfers - 1, context->trailer_data, thread_data->trailer_size);
+
+	return TRUE;
+}
+
+/* Submits the pending transfers in device order, within the in flight budget */
+
+static void
+_async_submit_transfers (ArvUvStreamThreadData *thread_data)
+{
+	guint i;
+
+	for (i = 0; i < ARV_UV_STREAM_N_BUFFER_CONTEXTS; i++) {
+		ArvUvStreamBufferContext *context;
+
+		context = thread_data->contexts[(thread_data->oldest_context + i) % ARV_UV_STREAM_N_BUFFER_CONTEXTS];
+
+		if (context->buffer == NULL) {
+			if (!_async_activate_context (context)) {
+				if (i == 0 && !thread_data->is_underrun) {
+					thread_data->n_underruns++;
+					thread_data->is_underrun = TRUE;
+					arv_event_ring_record (thread_data->event_ring, ARV_EVENT_RING_EVENT_UNDERRUN, 0, 0, 0);
+				}
+				return;
+			}
+			thread_data->is_underrun = FALSE;
+		}
+
+		while (context->n_submitted < context->n_transfers) {
+			struct libusb_transfer *transfer = context->transfers[context->n_submitted];
+			int result;
+
+			if (thread_data->n_bytes_in_flight > 0 &&
+			    thread_data->n_bytes_in_flight + transfer->length > ARV_UV_STREAM_MAXIMUM_BYTES_IN_FLIGHT)
+				return;
+
+			context->submission_times_us[context->n_submitted] = g_get_monotonic_time ();
+			result = libusb_submit_transfer (transfer);
+			if (result != LIBUSB_SUCCESS) {
+				arv_warning_sp ("USB transfer submission error: %s", libusb_error_name (result));
+				return;
+			}
+
+			thread_data->n_bytes_in_flight += transfer->length;
+			context->n_submitted++;
+		}
+	}
+}
+
+/* Cancels the submitted transfers, waits for their completion, and releases the buffers */
+
+static void
+_async_cancel_transfers (ArvUvStreamThreadData *thread_data)
+{
+	gboolean is_pending;
+	guint i, j;
+
+	for (i = 0; i < ARV_UV_STREAM_N_BUFFER_CONTEXTS; i++) {
+		ArvUvStreamBufferContext *context = thread_data->contexts[i];
+
+		if (context->buffer != NULL)
+			for (j = context->n_completed; j < context->n_submitted; j++)
+				libusb_cancel_transfer (context->transfers[j]);
+	}
+
+	do {
+		is_pending = FALSE;
+		for (i = 0; i < ARV_UV_STREAM_N_BUFFER_CONTEXTS; i++) {
+			ArvUvStreamBufferContext *context = thread_data->contexts[i];
+
+			if (context->buffer != NULL && context->n_completed < context->n_submitted)
+				is_pending = TRUE;
+		}
+		if (is_pending)
+			arv_uv_device_handle_events (thread_data->uv_device, ARV_UV_STREAM_EVENT_TIMEOUT_MS);
+	} while (is_pending);
+
+	/* Buffers with unsubmitted transfers */
+	for (i = 0; i < ARV_UV_STREAM_N_BUFFER_CONTEXTS; i++) {
+		ArvUvStreamBufferContext *context;
+
+		context = thread_data->contexts[(thread_data->oldest_context + i) % ARV_UV_STREAM_N_BUFFER_CONTEXTS];
+		if (context->buffer != NULL)
+			_async_release_buffer (context, g_atomic_int_get (&thread_data->cancel) ||
+					       arv_stream_is_paused (thread_data->stream) ?
+					       ARV_BUFFER_STATUS_ABORTED :
+					       ARV_BUFFER_STATUS_MISSING_PACKETS);
+	}
+}
+
+/* Drops the incoming data up to the next trailer, using synchronous transfers */
+
+static void
+_async_resynchronize (ArvUvStreamThreadData *thread_data, void *incoming_buffer)
+{
+	_async_cancel_transfers (thread_data);
+
+	while (!g_atomic_int_get (&thread_data->cancel)) {
+		GError *error = NULL;
+		size_t transferred = 0;
+
+		arv_uv_device_bulk_transfer (thread_data->uv_device, ARV_UV_ENDPOINT_DATA, LIBUSB_ENDPOINT_IN,
+					     incoming_buffer, ARV_UV_STREAM_MAXIMUM_TRANSFER_SIZE, &transferred, 0,
+					     &error);
+		if (error != NULL)
+			g_clear_error (&error);
+		else if (transferred > 0 &&
+			 arv_uvsp_packet_get_packet_type (incoming_buffer) == ARV_UVSP_PACKET_TYPE_TRAILER)
+			break;
+	}
+
+	thread_data->is_resync_needed = FALSE;
+}
+
+static void *
+arv_uv_stream_async_thread (void *data)
+{
+	ArvUvStreamThreadData *thread_data = data;
+	void *incoming_buffer;
+	guint i;
+
+	arv_debug_stream_thread ("Start asynchronous USB3Vision stream thread");
+
+	arv_stream_apply_thread_placement (thread_data->stream);
+
+	incoming_buffer = g_malloc (ARV_UV_STREAM_MAXIMUM_TRANSFER_SIZE);
+
+	for (i = 0; i < ARV_UV_STREAM_N_BUFFER_CONTEXTS; i++)
+		thread_data->contexts[i] = _async_context_new (thread_data, i);
+	thread_data->oldest_context = 0;
+	thread_data->n_bytes_in_flight = 0;
+	thread_data->is_resync_needed = FALSE;
+	thread_data->is_underrun = FALSE;
+
+	if (thread_data->callback != NULL)
+		thread_data->callback (thread_data->callback_data, ARV_STREAM_CALLBACK_TYPE_INIT, NULL);
+
+	while (!g_atomic_int_get (&thread_data->cancel)) {
+		gint64 start_time_us;
+
+		arv_stream_update_thread_placement (thread_data->stream);
+
+		if (G_UNLIKELY (_check_pause (thread_data))) {
+			_async_cancel_transfers (thread_data);
+			thread_data->is_resync_needed = FALSE;
+		}
+
+		if (G_UNLIKELY (arv_stream_is_paused (thread_data->stream))) {
+			g_usleep (ARV_UV_STREAM_PAUSE_POLL_US);
+			continue;
+		}
+
+		if (thread_data->is_resync_needed)
+			_async_resynchronize (thread_data, incoming_buffer);
+
+		_async_submit_transfers (thread_data);
+
+		/* Poll the input queue more often when the bus is idle */
+		start_time_us = g_get_monotonic_time ();
+		arv_uv_device_handle_events (thread_data->uv_device,
+					     thread_data->n_bytes_in_flight > 0 ? ARV_UV_STREAM_EVENT_TIMEOUT_MS : 1);
+		thread_data->transfer_wait_time_us += g_get_monotonic_time () - start_time_us;
+	}
+
+	_async_cancel_transfers (thread_data);
+
+	if (thread_data->callback != NULL)
+		thread_data->callback (thread_data->callback_data, ARV_STREAM_CALLBACK_TYPE_EXIT, NULL);
+
+	for (i = 0; i < ARV_UV_STREAM_N_BUFFER_CONTEXTS; i++)
+		g_clear_pointer (&thread_data->contexts[i], _async_context_free);
+
+	g_free (incoming_buffer);
+
+	arv_debug_stream_thread ("Stop asynchronous USB3Vision stream thread");
+
+	return NULL;
+}
+
 /* ArvUvStream implementation */
 
 static guint32
@@ -249,6 +924,38 @@ align (guint32 val, guint32 alignment)
 	return (val + (alignment - 1)) & ~(alignment - 1);
 }
 
+static void
+_plan_transfers (ArvUvStreamThreadData *thread_data, guint64 expected_size,
+		 guint32 payload_size, guint32 payload_count, guint32 transfer1_size, guint32 transfer2_size)
+{
+	size_t offset = 0;
+	guint i;
+
+	g_free (thread_data->transfers);
+
+	thread_data->n_transfers = payload_count + (transfer1_size > 0 ? 1 : 0) + (transfer2_size > 0 ? 1 : 0);
+	thread_data->transfers = g_new (ArvUvStreamTransfer, MAX (thread_data->n_transfers, 1));
+	thread_data->expected_size = expected_size;
+
+	for (i = 0; i < payload_count; i++, offset += payload_size) {
+		thread_data->transfers[i].offset = offset;
+		thread_data->transfers[i].size = payload_size;
+	}
+	if (transfer1_size > 0) {
+		thread_data->transfers[i].offset = offset;
+		thread_data->transfers[i].size = transfer1_size;
+		offset += transfer1_size;
+		i++;
+	}
+	if (transfer2_size > 0) {
+		thread_data->transfers[i].offset = offset;
+		thread_data->transfers[i].size = transfer2_size;
+	}
+
+	arv_info_stream ("Transfer plan         = %u payload transfers for %" G_GUINT64_FORMAT " bytes",
+			 thread_data->n_transfers, expected_size);
+}
+
 static void
 arv_uv_stream_start_thread (ArvStream *stream)
 {
@@ -309,10 +1016,12 @@ arv_uv_stream_start_thread (ArvStream *stream)
 		si_req_trailer_size = align (si_req_trailer_size, alignment);
 	}
 
+	/* The remainder is split between an aligned transfer landing in the buffer, and a last transfer for the
+	 * incomplete alignment block, which goes beyond the end of the buffer. */
 	si_payload_size = aligned_maximum_transfer_size;
-	si_payload_count=  si_req_payload_size / si_payload_size;
-	si_transfer1_size = align(si_req_payload_size % si_payload_size, alignment);
-	si_transfer2_size = 0;
+	si_payload_count = si_req_payload_size / si_payload_size;
+	si_transfer1_size = (si_req_payload_size % si_payload_size) / alignment * alignment;
+	si_transfer2_size = align (si_req_payload_size % si_payload_size - si_transfer1_size, alignment);
 
 	arv_device_write_memory (device, sirm_offset + ARV_SIRM_MAX_LEADER_SIZE, sizeof (si_req_leader_size), &si_req_leader_size, NULL);
 	arv_device_write_memory (device, sirm_offset + ARV_SIRM_MAX_TRAILER_SIZE, sizeof (si_req_trailer_size), &si_req_trailer_size, NULL);
@@ -336,7 +1045,17 @@ arv_uv_stream_start_thread (ArvStream *stream)
 	thread_data->trailer_size = si_req_trailer_size;
 	thread_data->cancel = FALSE;
 
-	priv->thread = g_thread_new ("arv_uv_stream", arv_uv_stream_thread, priv->thread_data);
+	_plan_transfers (thread_data, si_req_payload_size,
+			 si_payload_size, si_payload_count, si_transfer1_size, si_transfer2_size);
+
+	thread_data->usb_mode = arv_uv_device_get_usb_mode (thread_data->uv_device);
+	arv_info_stream ("USB mode              = %s",
+			 thread_data->usb_mode == ARV_UV_USB_MODE_ASYNC ? "async" : "sync");
+
+	if (thread_data->usb_mode == ARV_UV_USB_MODE_ASYNC)
+		priv->thread = g_thread_new ("arv_uv_stream", arv_uv_stream_async_thread, priv->thread_data);
+	else
+		priv->thread = g_thread_new ("arv_uv_stream", arv_uv_stream_thread, priv->thread_data);
 }
 
 static void
@@ -369,6 +1088,73 @@ arv_uv_stream_stop_thread (ArvStream *stream)
 
 }
 
+/* Stops the stream thread during a reconnection of the device, keeping the buffer queues. Returns whether the thread
+ * was running. */
+
+gboolean
+arv_uv_stream_suspend (ArvUvStream *uv_stream)
+{
+	ArvUvStreamPrivate *priv = arv_uv_stream_get_instance_private (uv_stream);
+
+	g_return_val_if_fail (ARV_IS_UV_STREAM (uv_stream), FALSE);
+
+	if (priv->thread == NULL)
+		return FALSE;
+
+	arv_uv_stream_stop_thread (ARV_STREAM (uv_stream));
+
+	return TRUE;
+}
+
+/* Restarts the stream thread after a reconnection, programming again the stream interface of the device */
+
+void
+arv_uv_stream_resume (ArvUvStream *uv_stream)
+{
+	ArvUvStreamPrivate *priv = arv_uv_stream_get_instance_private (uv_stream);
+
+	g_return_if_fail (ARV_IS_UV_STREAM (uv_stream));
+
+	if (priv->thread != NULL)
+		return;
+
+	arv_uv_stream_start_thread (ARV_STREAM (uv_stream));
+}
+
+/* Programs again the stream interface of the device when the payload size changed during a pause, restarting the
+ * stream thread for the new transfer plan */
+
+static void
+arv_uv_stream_resume_after_pause (ArvStream *stream)
+{
+	ArvUvStream *uv_stream = ARV_UV_STREAM (stream);
+	ArvUvStreamPrivate *priv = arv_uv_stream_get_instance_private (uv_stream);
+	ArvDevice *device;
+	guint64 offset;
+	guint64 sirm_offset;
+	guint64 si_req_payload_size;
+
+	if (priv->thread == NULL || priv->thread_data == NULL)
+		return;
+
+	device = ARV_DEVICE (priv->thread_data->uv_device);
+
+	if (!arv_device_read_memory (device, ARV_ABRM_SBRM_ADDRESS, sizeof (guint64), &offset, NULL) ||
+	    !arv_device_read_memory (device, offset + ARV_SBRM_SIRM_ADDRESS, sizeof (guint64), &sirm_offset, NULL) ||
+	    !arv_device_read_memory (device, sirm_offset + ARV_SIRM_REQ_PAYLOAD_SIZE, sizeof (si_req_payload_size),
+				     &si_req_payload_size, NULL))
+		return;
+
+	if (si_req_payload_size == priv->thread_data->expected_size)
+		return;
+
+	arv_info_stream ("[UvStream::resume_after_pause] Payload size changed to %" G_GUINT64_FORMAT,
+			 si_req_payload_size);
+
+	arv_uv_stream_stop_thread (stream);
+	arv_uv_stream_start_thread (stream);
+}
+
 /**
  * arv_uv_stream_new: (skip)
  * @uv_device: a #ArvUvDevice
@@ -399,6 +1185,9 @@ arv_uv_stream_constructed (GObject *object)
 
 	thread_data = g_new (ArvUvStreamThreadData, 1);
 	thread_data->stream = stream;
+	thread_data->event_ring = arv_stream_get_event_ring (stream);
+	thread_data->transfers = NULL;
+	thread_data->n_transfers = 0;
 
 	g_object_get (object,
 		      "device", &thread_data->uv_device,
@@ -409,6 +1198,32 @@ arv_uv_stream_constructed (GObject *object)
 	thread_data->n_completed_buffers = 0;
 	thread_data->n_failures = 0;
 	thread_data->n_underruns = 0;
+	thread_data->n_size_mismatch_errors = 0;
+	thread_data->n_missing_trailers = 0;
+	thread_data->n_transfer_errors = 0;
+	thread_data->n_usb_transfers = 0;
+	thread_data->n_transferred_bytes = 0;
+	thread_data->transfer_wait_time_us = 0;
+	thread_data->throughput = 0.0;
+	thread_data->throughput_time_us = 0;
+	thread_data->throughput_n_bytes = 0;
+
+	thread_data->statistic = arv_statistic_new (2, 100, 1000, 0);
+	arv_statistic_set_name (thread_data->statistic, 0, "Payload transfer time");
+	arv_statistic_set_name (thread_data->statistic, 1, "Buffer reception time");
+
+	arv_stream_declare_info (stream, "n_completed_buffers", G_TYPE_UINT, &thread_data->n_completed_buffers);
+	arv_stream_declare_info (stream, "n_failures", G_TYPE_UINT, &thread_data->n_failures);
+	arv_stream_declare_info (stream, "n_underruns", G_TYPE_UINT, &thread_data->n_underruns);
+	arv_stream_declare_info (stream, "n_size_mismatch_errors", G_TYPE_UINT, &thread_data->n_size_mismatch_errors);
+	arv_stream_declare_info (stream, "n_missing_trailers", G_TYPE_UINT, &thread_data->n_missing_trailers);
+	arv_stream_declare_info (stream, "n_transfer_errors", G_TYPE_UINT, &thread_data->n_transfer_errors);
+	arv_stream_declare_info (stream, "n_usb_transfers", G_TYPE_UINT64, &thread_data->n_usb_transfers);
+	arv_stream_declare_info (stream, "n_transferred_bytes", G_TYPE_UINT64, &thread_data->n_transferred_bytes);
+	arv_stream_declare_info (stream, "transfer_wait_time_us", G_TYPE_UINT64, &thread_data->transfer_wait_time_us);
+	arv_stream_declare_info (stream, "throughput", G_TYPE_DOUBLE, &thread_data->throughput);
+	arv_stream_declare_statistic (stream, "payload_transfer_time_us", thread_data->statistic, 0);
+	arv_stream_declare_statistic (stream, "frame_assembly_time_us", thread_data->statistic, 1);
 
 	priv->thread_data = thread_data;
 
@@ -449,6 +1264,7 @@ arv_uv_stream_finalize (GObject *object)
 
 	if (priv->thread_data != NULL) {
 		ArvUvStreamThreadData *thread_data;
+		char *statistic_string;
 
 		thread_data = priv->thread_data;
 
@@ -458,8 +1274,26 @@ arv_uv_stream_finalize (GObject *object)
 				  thread_data->n_failures);
 		arv_info_stream ("[UvStream::finalize] n_underruns            = %u",
 				  thread_data->n_underruns);
+		arv_info_stream ("[UvStream::finalize] n_size_mismatch_errors = %u",
+				  thread_data->n_size_mismatch_errors);
+		arv_info_stream ("[UvStream::finalize] n_missing_trailers     = %u",
+				  thread_data->n_missing_trailers);
+		arv_info_stream ("[UvStream::finalize] n_transfer_errors      = %u",
+				  thread_data->n_transfer_errors);
+		arv_info_stream ("[UvStream::finalize] n_usb_transfers        = %" G_GUINT64_FORMAT,
+				  thread_data->n_usb_transfers);
+		arv_info_stream ("[UvStream::finalize] n_transferred_bytes    = %" G_GUINT64_FORMAT,
+				  thread_data->n_transferred_bytes);
+		arv_info_stream ("[UvStream::finalize] transfer_wait_time_us  = %" G_GUINT64_FORMAT,
+				  thread_data->transfer_wait_time_us);
+
+		statistic_string = arv_statistic_to_string (thread_data->statistic);
+		arv_info_stream ("%s", statistic_string);
+		g_free (statistic_string);
+		arv_statistic_free (thread_data->statistic);
 
 		g_clear_object (&thread_data->uv_device);
+		g_clear_pointer (&thread_data->transfers, g_free);
 		g_clear_pointer (&priv->thread_data, g_free);
 	}
 
@@ -476,6 +1310,7 @@ arv_uv_stream_class_init (ArvUvStreamClass *uv_stream_class)
 	object_class->finalize = arv_uv_stream_finalize;
 
 	stream_class->start_thread = arv_uv_stream_start_thread;
+	stream_class->resume = arv_uv_stream_resume_after_pause;
 	stream_class->stop_thread = arv_uv_stream_stop_thread;
 	stream_class->get_statistics = arv_uv_stream_get_statistics;
 }
@@ -35,6 +35,9 @@ G_BEGIN_DECLS
 
 ArvStream * 	arv_uv_stream_new	(ArvUvDevice *uv_device, ArvStreamCallback callback, void *user_data, GError **error);
 
+gboolean	arv_uv_stream_suspend	(ArvUvStream *uv_stream);
+void		arv_uv_stream_resume	(ArvUvStream *uv_stream);
+
 G_END_DECLS
 
 #endif
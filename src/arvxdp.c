@@ -0,0 +1,320 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2019 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel@gnome.org>
+ */
+
+/*< private >
+ * SECTION: arvxdp
+ * @short_description: AF_XDP socket for GigEVision stream reception
+ *
+ * An XDP program, attached to the network interface, redirects the GVSP
+ * packets matching the stream source and destination to an AF_XDP socket,
+ * bypassing the kernel network stack. The other packets continue their way
+ * to the kernel. Packets are received into a UMEM area shared with the
+ * kernel.
+ */
+
+#define ARV_DEBUG_HOT_PATH
+
+#include <arvxdpprivate.h>
+#include <arvdebugprivate.h>
+#include <xdp/xsk.h>
+#include <bpf/bpf.h>
+#include <bpf/libbpf.h>
+#include <linux/if_link.h>
+#include <linux/if_ether.h>
+#include <linux/ip.h>
+#include <linux/udp.h>
+#include <netinet/in.h>
+#include <net/if.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <stddef.h>
+#include <string.h>
+#include <errno.h>
+
+#define ARV_XDP_N_FRAMES		4096
+#define ARV_XDP_FRAME_SIZE		XSK_UMEM__DEFAULT_FRAME_SIZE
+#define ARV_XDP_BATCH_SIZE		64
+#define ARV_XDP_N_QUEUES_MAX		64
+
+/* Ethernet, IPv4 without options and UDP headers */
+#define ARV_XDP_HEADER_SIZE		(ETH_HLEN + sizeof (struct iphdr) + sizeof (struct udphdr))
+
+struct _ArvXdpSocket {
+	unsigned interface_index;
+	guint32 xdp_flags;
+
+	int program_fd;
+	int map_fd;
+
+	void *umem_area;
+	size_t umem_size;
+	struct xsk_umem *umem;
+	struct xsk_socket *xsk;
+	struct xsk_ring_prod fill;
+	struct xsk_ring_cons completion;
+	struct xsk_ring_cons rx;
+};
+
+#define ARV_XDP_INSN(c,d,s,o,i)	((struct bpf_insn) { .code = (c), .dst_reg = (d), .src_reg = (s), .off = (o), .imm = (i) })
+
+/* Jump to the XDP_PASS return if the @size value at @offset of the packet does not match @value */
+#define ARV_XDP_CHECK(size,offset,value)										\
+	do {														\
+		insns[n++] = ARV_XDP_INSN (BPF_LDX | BPF_MEM | (size), BPF_REG_5, BPF_REG_2, (offset), 0);		\
+		pass_jumps[n_pass_jumps++] = n;										\
+		insns[n++] = ARV_XDP_INSN (BPF_JMP32 | BPF_JNE | BPF_K, BPF_REG_5, 0, 0, (gint32) (value));		\
+	} while (0)
+
+static int
+_load_program (int map_fd, guint32 source_ip, guint16 source_port, guint32 destination_ip, guint16 destination_port)
+{
+	struct bpf_insn insns[64];
+	int pass_jumps[16];
+	int n_pass_jumps = 0;
+	int n = 0;
+	int i;
+
+	/* r2 = data, r3 = data_end */
+	insns[n++] = ARV_XDP_INSN (BPF_LDX | BPF_MEM | BPF_W, BPF_REG_2, BPF_REG_1, offsetof (struct xdp_md, data), 0);
+	insns[n++] = ARV_XDP_INSN (BPF_LDX | BPF_MEM | BPF_W, BPF_REG_3, BPF_REG_1, offsetof (struct xdp_md, data_end), 0);
+
+	/* Bound check of the headers */
+	insns[n++] = ARV_XDP_INSN (BPF_ALU64 | BPF_MOV | BPF_X, BPF_REG_4, BPF_REG_2, 0, 0);
+	insns[n++] = ARV_XDP_INSN (BPF_ALU64 | BPF_ADD | BPF_K, BPF_REG_4, 0, 0, ARV_XDP_HEADER_SIZE);
+	pass_jumps[n_pass_jumps++] = n;
+	insns[n++] = ARV_XDP_INSN (BPF_JMP | BPF_JGT | BPF_X, BPF_REG_4, BPF_REG_3, 0, 0);
+
+	/* Loaded values are in network byte order */
+	ARV_XDP_CHECK (BPF_H, 12, g_htons (ETH_P_IP));
+	ARV_XDP_CHECK (BPF_B, ETH_HLEN, 0x45);
+	ARV_XDP_CHECK (BPF_B, ETH_HLEN + offsetof (struct iphdr, protocol), IPPROTO_UDP);
+	ARV_XDP_CHECK (BPF_W, ETH_HLEN + offsetof (struct iphdr, saddr), g_htonl (source_ip));
+	ARV_XDP_CHECK (BPF_W, ETH_HLEN + offsetof (struct iphdr, daddr), g_htonl (destination_ip));
+	if (source_port != 0)
+		ARV_XDP_CHECK (BPF_H, ETH_HLEN + sizeof (struct iphdr) + offsetof (struct udphdr, source),
+			       g_htons (source_port));
+	ARV_XDP_CHECK (BPF_H, ETH_HLEN + sizeof (struct iphdr) + offsetof (struct udphdr, dest),
+		       g_htons (destination_port));
+
+	/* return bpf_redirect_map (&xsks_map, ctx->rx_queue_index, XDP_PASS) */
+	insns[n++] = ARV_XDP_INSN (BPF_LDX | BPF_MEM | BPF_W, BPF_REG_2, BPF_REG_1,
+				   offsetof (struct xdp_md, rx_queue_index), 0);
+	insns[n++] = ARV_XDP_INSN (BPF_LD | BPF_IMM | BPF_DW, BPF_REG_1, BPF_PSEUDO_MAP_FD, 0, map_fd);
+	insns[n++] = ARV_XDP_INSN (0, 0, 0, 0, 0);
+	insns[n++] = ARV_XDP_INSN (BPF_ALU64 | BPF_MOV | BPF_K, BPF_REG_3, 0, 0, XDP_PASS);
+	insns[n++] = ARV_XDP_INSN (BPF_JMP | BPF_CALL, 0, 0, 0, BPF_FUNC_redirect_map);
+	insns[n++] = ARV_XDP_INSN (BPF_JMP | BPF_EXIT, 0, 0, 0, 0);
+
+	/* return XDP_PASS */
+	for (i = 0; i < n_pass_jumps; i++)
+		insns[pass_jumps[i]].off = n - (pass_jumps[i] + 1);
+	insns[n++] = ARV_XDP_INSN (BPF_ALU64 | BPF_MOV | BPF_K, BPF_REG_0, 0, 0, XDP_PASS);
+	insns[n++] = ARV_XDP_INSN (BPF_JMP | BPF_EXIT, 0, 0, 0, 0);
+
+	return bpf_prog_load (BPF_PROG_TYPE_XDP, "arv_gvsp", "GPL", insns, n, NULL);
+}
+
+ArvXdpSocket *
+arv_xdp_socket_new (unsigned interface_index, unsigned queue_id,
+		    guint32 source_ip, guint16 source_port,
+		    guint32 destination_ip, guint16 destination_port)
+{
+	ArvXdpSocket *xdp_socket;
+	struct xsk_umem_config umem_config;
+	struct xsk_socket_config socket_config;
+	char interface_name[IF_NAMESIZE];
+	guint32 fill_index;
+	unsigned i;
+
+	if (if_indextoname (interface_index, interface_name) == NULL) {
+		arv_info_stream_thread ("[XdpSocket::new] Unknown interface index %u", interface_index);
+		return NULL;
+	}
+
+	xdp_socket = g_new0 (ArvXdpSocket, 1);
+	xdp_socket->interface_index = interface_index;
+	xdp_socket->program_fd = -1;
+	xdp_socket->umem_area = MAP_FAILED;
+
+	xdp_socket->map_fd = bpf_map_create (BPF_MAP_TYPE_XSKMAP, "arv_xsks", sizeof (int), sizeof (int),
+					     ARV_XDP_N_QUEUES_MAX, NULL);
+	if (xdp_socket->map_fd < 0) {
+		arv_info_stream_thread ("[XdpSocket::new] Failed to create XSK map (%s)", strerror (errno));
+		goto error;
+	}
+
+	xdp_socket->program_fd = _load_program (xdp_socket->map_fd, source_ip, source_port,
+						destination_ip, destination_port);
+	if (xdp_socket->program_fd < 0) {
+		arv_info_stream_thread ("[XdpSocket::new] Failed to load XDP program (%s)", strerror (errno));
+		goto error;
+	}
+
+	/* Prefer native driver mode, and don't replace a program already attached by someone else */
+	xdp_socket->xdp_flags = XDP_FLAGS_UPDATE_IF_NOEXIST | XDP_FLAGS_DRV_MODE;
+	if (bpf_xdp_attach (interface_index, xdp_socket->program_fd, xdp_socket->xdp_flags, NULL) < 0) {
+		xdp_socket->xdp_flags = XDP_FLAGS_UPDATE_IF_NOEXIST | XDP_FLAGS_SKB_MODE;
+		if (bpf_xdp_attach (interface_index, xdp_socket->program_fd, xdp_socket->xdp_flags, NULL) < 0) {
+			arv_info_stream_thread ("[XdpSocket::new] Failed to attach XDP program to %s (%s)",
+						interface_name, strerror (errno));
+			xdp_socket->xdp_flags = 0;
+			goto error;
+		}
+	}
+
+	xdp_socket->umem_size = ARV_XDP_N_FRAMES * ARV_XDP_FRAME_SIZE;
+	xdp_socket->umem_area = mmap (NULL, xdp_socket->umem_size, PROT_READ | PROT_WRITE,
+				      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (xdp_socket->umem_area == MAP_FAILED) {
+		arv_info_stream_thread ("[XdpSocket::new] Failed to allocate UMEM");
+		goto error;
+	}
+
+	memset (&umem_config, 0, sizeof (umem_config));
+	umem_config.fill_size = ARV_XDP_N_FRAMES;
+	umem_config.comp_size = XSK_RING_CONS__DEFAULT_NUM_DESCS;
+	umem_config.frame_size = ARV_XDP_FRAME_SIZE;
+	umem_config.frame_headroom = 0;
+
+	if (xsk_umem__create (&xdp_socket->umem, xdp_socket->umem_area, xdp_socket->umem_size,
+			      &xdp_socket->fill, &xdp_socket->completion, &umem_config) != 0) {
+		arv_info_stream_thread ("[XdpSocket::new] Failed to register UMEM");
+		xdp_socket->umem = NULL;
+		goto error;
+	}
+
+	memset (&socket_config, 0, sizeof (socket_config));
+	socket_config.rx_size = XSK_RING_CONS__DEFAULT_NUM_DESCS;
+	socket_config.tx_size = 0;
+	socket_config.libxdp_flags = XSK_LIBXDP_FLAGS__INHIBIT_PROG_LOAD;
+	socket_config.xdp_flags = xdp_socket->xdp_flags;
+
+	if (xsk_socket__create (&xdp_socket->xsk, interface_name, queue_id, xdp_socket->umem,
+				&xdp_socket->rx, NULL, &socket_config) != 0) {
+		arv_info_stream_thread ("[XdpSocket::new] Failed to create AF_XDP socket on %s queue %u",
+					interface_name, queue_id);
+		xdp_socket->xsk = NULL;
+		goto error;
+	}
+
+	if (xsk_socket__update_xskmap (xdp_socket->xsk, xdp_socket->map_fd) != 0) {
+		arv_info_stream_thread ("[XdpSocket::new] Failed to register AF_XDP socket");
+		goto error;
+	}
+
+	/* Give all the UMEM frames to the kernel */
+	if (xsk_ring_prod__reserve (&xdp_socket->fill, ARV_XDP_N_FRAMES, &fill_index) != ARV_XDP_N_FRAMES) {
+		arv_info_stream_thread ("[XdpSocket::new] Failed to fill UMEM ring");
+		goto error;
+	}
+	for (i = 0; i < ARV_XDP_N_FRAMES; i++)
+		*xsk_ring_prod__fill_addr (&xdp_socket->fill, fill_index + i) = i * ARV_XDP_FRAME_SIZE;
+	xsk_ring_prod__submit (&xdp_socket->fill, ARV_XDP_N_FRAMES);
+
+	arv_info_stream_thread ("[XdpSocket::new] AF_XDP socket on %s queue %u (%s mode)",
+				interface_name, queue_id,
+				(xdp_socket->xdp_flags & XDP_FLAGS_DRV_MODE) != 0 ? "driver" : "generic");
+
+	return xdp_socket;
+
+error:
+	arv_xdp_socket_free (xdp_socket);
+
+	return NULL;
+}
+
+void
+arv_xdp_socket_free (ArvXdpSocket *xdp_socket)
+{
+	if (xdp_socket == NULL)
+		return;
+
+	if (xdp_socket->xsk != NULL)
+		xsk_socket__delete (xdp_socket->xsk);
+	if (xdp_socket->umem != NULL)
+		xsk_umem__delete (xdp_socket->umem);
+	if (xdp_socket->xdp_flags != 0)
+		bpf_xdp_detach (xdp_socket->interface_index, xdp_socket->xdp_flags, NULL);
+	if (xdp_socket->program_fd >= 0)
+		close (xdp_socket->program_fd);
+	if (xdp_socket->map_fd >= 0)
+		close (xdp_socket->map_fd);
+	if (xdp_socket->umem_area != MAP_FAILED)
+		munmap (xdp_socket->umem_area, xdp_socket->umem_size);
+
+	g_free (xdp_socket);
+}
+
+int
+arv_xdp_socket_get_fd (ArvXdpSocket *xdp_socket)
+{
+	g_return_val_if_fail (xdp_socket != NULL, -1);
+
+	return xsk_socket__fd (xdp_socket->xsk);
+}
+
+/* Returns the maximum IP packet size that fits in an UMEM frame */
+
+size_t
+arv_xdp_socket_get_max_ip_packet_size (ArvXdpSocket *xdp_socket)
+{
+	return ARV_XDP_FRAME_SIZE - ETH_HLEN;
+}
+
+unsigned
+arv_xdp_socket_receive (ArvXdpSocket *xdp_socket, ArvXdpPacketCallback callback, void *data)
+{
+	guint32 rx_index;
+	guint32 fill_index;
+	unsigned n_packets;
+	unsigned i;
+
+	g_return_val_if_fail (xdp_socket != NULL, 0);
+
+	n_packets = xsk_ring_cons__peek (&xdp_socket->rx, ARV_XDP_BATCH_SIZE, &rx_index);
+	if (n_packets == 0)
+		return 0;
+
+	/* The fill ring can hold all the UMEM frames, reservation can't fail */
+	while (xsk_ring_prod__reserve (&xdp_socket->fill, n_packets, &fill_index) != n_packets);
+
+	for (i = 0; i < n_packets; i++) {
+		const struct xdp_desc *descriptor = xsk_ring_cons__rx_desc (&xdp_socket->rx, rx_index + i);
+		const struct iphdr *ip;
+		size_t size;
+
+		ip = (const struct iphdr *) ((char *) xsk_umem__get_data (xdp_socket->umem_area,
+									  descriptor->addr) + ETH_HLEN);
+		size = g_ntohs (ip->tot_len) - sizeof (struct iphdr) - sizeof (struct udphdr);
+
+		if (size <= descriptor->len - ARV_XDP_HEADER_SIZE)
+			callback (data, ((const char *) ip) + sizeof (struct iphdr) + sizeof (struct udphdr), size);
+
+		*xsk_ring_prod__fill_addr (&xdp_socket->fill, fill_index + i) =
+			xsk_umem__extract_addr (descriptor->addr);
+	}
+
+	xsk_ring_prod__submit (&xdp_socket->fill, n_packets);
+	xsk_ring_cons__release (&xdp_socket->rx, n_packets);
+
+	return n_packets;
+}
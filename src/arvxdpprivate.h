@@ -0,0 +1,49 @@
+/* Aravis - Digital camera library
+ *
+ * Copyright © 2009-2019 Emmanuel Pacaud
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General
+ * Public License along with this library; if not, write to the
+ * Free Software Foundation, Inc., 51 Franklin Street, Fifth Floor,
+ * Boston, MA 02110-1301, USA.
+ *
+ * Author: Emmanuel Pacaud <emmanuel@gnome.org>
+ */
+
+#ifndef ARV_XDP_PRIVATE_H
+#define ARV_XDP_PRIVATE_H
+
+#if !defined (ARV_H_INSIDE) && !defined (ARAVIS_COMPILATION)
+#error "Only <arv.h> can be included directly."
+#endif
+
+#include <arvtypes.h>
+
+G_BEGIN_DECLS
+
+typedef struct _ArvXdpSocket ArvXdpSocket;
+
+/* Called for each received UDP payload */
+typedef void (*ArvXdpPacketCallback) (void *data, const void *payload, size_t size);
+
+ArvXdpSocket *	arv_xdp_socket_new		(unsigned interface_index, unsigned queue_id,
+						 guint32 source_ip, guint16 source_port,
+						 guint32 destination_ip, guint16 destination_port);
+void		arv_xdp_socket_free		(ArvXdpSocket *xdp_socket);
+int		arv_xdp_socket_get_fd		(ArvXdpSocket *xdp_socket);
+size_t		arv_xdp_socket_get_max_ip_packet_size	(ArvXdpSocket *xdp_socket);
+unsigned	arv_xdp_socket_receive		(ArvXdpSocket *xdp_socket, ArvXdpPacketCallback callback, void *data);
+
+G_END_DECLS
+
+#endif
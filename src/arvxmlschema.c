@@ -26,7 +26,8 @@
  * @short_description: XML Schema storage
  */
 
-#include <arvxmlschema.h>
+#include <arvxmlschemaprivate.h>
+#include <arvgenicamcacheprivate.h>
 #include <libxml/parser.h>
 #include <libxml/valid.h>
 #include <libxml/xmlschemas.h>
@@ -162,6 +163,194 @@ arv_xml_schema_new_from_path (const char *path)
 	return schema;
 }
 
+/* Validation of the GenICam data at load, on a background thread, in order to not delay the device opening. The
+ * SHA-1 of the data seen under the first sight policy are kept for the process lifetime, the successful validations
+ * being also recorded in the GenICam cache, along with the SHA-1 of the schema. */
+
+typedef struct {
+	ArvXmlSchema *schema;
+	char *schema_id;
+	char *key;
+	GBytes *xml;
+} ArvXmlSchemaGenicamValidation;
+
+static GMutex arv_xml_schema_genicam_mutex;
+static GCond arv_xml_schema_genicam_cond;
+static ArvXmlSchemaValidationPolicy arv_xml_schema_genicam_policy = ARV_XML_SCHEMA_VALIDATION_POLICY_NEVER;
+static ArvXmlSchema *arv_xml_schema_genicam_schema = NULL;
+static char *arv_xml_schema_genicam_schema_id = NULL;
+static GHashTable *arv_xml_schema_genicam_seen = NULL;
+static GThreadPool *arv_xml_schema_genicam_pool = NULL;
+static guint arv_xml_schema_genicam_n_pending = 0;
+static guint arv_xml_schema_genicam_n_validations = 0;
+
+/* A %NULL @schema disables the validation, and waits for the pending ones */
+
+void
+arv_xml_schema_set_genicam_validation (ArvXmlSchemaValidationPolicy policy, ArvXmlSchema *schema)
+{
+	GThreadPool *pool = NULL;
+
+	g_return_if_fail (schema == NULL || ARV_IS_XML_SCHEMA (schema));
+
+	if (schema != NULL && schema->priv->valid_ctxt == NULL) {
+		arv_warning_dom ("[XmlSchema::set_genicam_validation] Invalid schema, validation disabled");
+		schema = NULL;
+	}
+
+	g_mutex_lock (&arv_xml_schema_genicam_mutex);
+
+	if (schema != arv_xml_schema_genicam_schema) {
+		g_clear_object (&arv_xml_schema_genicam_schema);
+		g_clear_pointer (&arv_xml_schema_genicam_schema_id, g_free);
+		g_clear_pointer (&arv_xml_schema_genicam_seen, g_hash_table_unref);
+
+		if (schema != NULL) {
+			arv_xml_schema_genicam_schema = g_object_ref (schema);
+			arv_xml_schema_genicam_schema_id = g_compute_checksum_for_data (G_CHECKSUM_SHA1,
+											 (const guchar *) schema->priv->xsd,
+											 schema->priv->xsd_size);
+		}
+	}
+
+	arv_xml_schema_genicam_policy = schema != NULL ? policy : ARV_XML_SCHEMA_VALIDATION_POLICY_NEVER;
+
+	if (schema == NULL) {
+		pool = arv_xml_schema_genicam_pool;
+		arv_xml_schema_genicam_pool = NULL;
+	}
+
+	g_mutex_unlock (&arv_xml_schema_genicam_mutex);
+
+	/* The pending validations own a reference to their schema */
+	if (pool != NULL)
+		g_thread_pool_free (pool, FALSE, TRUE);
+}
+
+static void
+_genicam_validation_free (ArvXmlSchemaGenicamValidation *validation)
+{
+	g_object_unref (validation->schema);
+	g_free (validation->schema_id);
+	g_free (validation->key);
+	g_bytes_unref (validation->xml);
+	g_free (validation);
+}
+
+static void
+_validate_genicam (gpointer data, gpointer user_data)
+{
+	ArvXmlSchemaGenicamValidation *validation = data;
+	GError *error = NULL;
+	const void *xml;
+	gsize size;
+	int line;
+	int column;
+
+	xml = g_bytes_get_data (validation->xml, &size);
+
+	if (arv_xml_schema_validate (validation->schema, xml, size, &line, &column, &error)) {
+		arv_info_dom ("[XmlSchema::validate_genicam] Valid GenICam data '%s'", validation->key);
+		arv_genicam_cache_store_validation (validation->key, validation->schema_id);
+	} else {
+		arv_warning_dom ("[XmlSchema::validate_genicam] Invalid GenICam data '%s' at line %d, column %d: %s",
+				 validation->key, line, column, error != NULL ? error->message : "unknown error");
+		g_clear_error (&error);
+	}
+
+	_genicam_validation_free (validation);
+
+	g_mutex_lock (&arv_xml_schema_genicam_mutex);
+	arv_xml_schema_genicam_n_validations++;
+	arv_xml_schema_genicam_n_pending--;
+	g_cond_broadcast (&arv_xml_schema_genicam_cond);
+	g_mutex_unlock (&arv_xml_schema_genicam_mutex);
+}
+
+/* Schedules the validation of @xml according to the current policy, and returns immediately */
+
+void
+arv_xml_schema_validate_genicam (const void *xml, size_t size)
+{
+	ArvXmlSchemaGenicamValidation *validation;
+	ArvXmlSchemaValidationPolicy policy;
+	ArvXmlSchema *schema = NULL;
+	g_autofree char *schema_id = NULL;
+	g_autofree char *key = NULL;
+
+	if (xml == NULL || size == 0)
+		return;
+
+	g_mutex_lock (&arv_xml_schema_genicam_mutex);
+	policy = arv_xml_schema_genicam_policy;
+	if (policy != ARV_XML_SCHEMA_VALIDATION_POLICY_NEVER) {
+		schema = g_object_ref (arv_xml_schema_genicam_schema);
+		schema_id = g_strdup (arv_xml_schema_genicam_schema_id);
+	}
+	g_mutex_unlock (&arv_xml_schema_genicam_mutex);
+
+	if (schema == NULL)
+		return;
+
+	key = g_compute_checksum_for_data (G_CHECKSUM_SHA1, xml, size);
+
+	if (policy == ARV_XML_SCHEMA_VALIDATION_POLICY_FIRST_SIGHT) {
+		gboolean is_seen;
+
+		g_mutex_lock (&arv_xml_schema_genicam_mutex);
+		if (schema == arv_xml_schema_genicam_schema) {
+			if (arv_xml_schema_genicam_seen == NULL)
+				arv_xml_schema_genicam_seen = g_hash_table_new_full (g_str_hash, g_str_equal,
+										     g_free, NULL);
+			is_seen = !g_hash_table_add (arv_xml_schema_genicam_seen, g_strdup (key));
+		} else
+			is_seen = TRUE;
+		g_mutex_unlock (&arv_xml_schema_genicam_mutex);
+
+		if (is_seen || arv_genicam_cache_is_validated (key, schema_id)) {
+			arv_debug_dom ("[XmlSchema::validate_genicam] Already validated GenICam data '%s'", key);
+			g_object_unref (schema);
+			return;
+		}
+	}
+
+	validation = g_new0 (ArvXmlSchemaGenicamValidation, 1);
+	validation->schema = schema;
+	validation->schema_id = g_steal_pointer (&schema_id);
+	validation->key = g_steal_pointer (&key);
+	validation->xml = g_bytes_new (xml, size);
+
+	g_mutex_lock (&arv_xml_schema_genicam_mutex);
+	if (arv_xml_schema_genicam_pool == NULL)
+		arv_xml_schema_genicam_pool = g_thread_pool_new (_validate_genicam, NULL, 1, FALSE, NULL);
+	arv_xml_schema_genicam_n_pending++;
+	g_thread_pool_push (arv_xml_schema_genicam_pool, validation, NULL);
+	g_mutex_unlock (&arv_xml_schema_genicam_mutex);
+}
+
+void
+arv_xml_schema_wait_genicam_validations (void)
+{
+	g_mutex_lock (&arv_xml_schema_genicam_mutex);
+	while (arv_xml_schema_genicam_n_pending > 0)
+		g_cond_wait (&arv_xml_schema_genicam_cond, &arv_xml_schema_genicam_mutex);
+	g_mutex_unlock (&arv_xml_schema_genicam_mutex);
+}
+
+/* Number of completed validations, for the tests */
+
+guint
+arv_xml_schema_get_n_genicam_validations (void)
+{
+	guint n_validations;
+
+	g_mutex_lock (&arv_xml_schema_genicam_mutex);
+	n_validations = arv_xml_schema_genicam_n_validations;
+	g_mutex_unlock (&arv_xml_schema_genicam_mutex);
+
+	return n_validations;
+}
+
 static void
 arv_xml_schema_init (ArvXmlSchema *self)
 {
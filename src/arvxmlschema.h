@@ -46,6 +46,22 @@ typedef enum {
 	ARV_XML_SCHEMA_ERROR_INVALID_STRUCTURE
 } ArvXmlSchemaError;
 
+/**
+ * ArvXmlSchemaValidationPolicy:
+ * @ARV_XML_SCHEMA_VALIDATION_POLICY_NEVER: the GenICam data are not validated
+ * @ARV_XML_SCHEMA_VALIDATION_POLICY_FIRST_SIGHT: the GenICam data are validated the first time they are seen, the
+ * successful validations being recorded in the GenICam cache, if enabled
+ * @ARV_XML_SCHEMA_VALIDATION_POLICY_ALWAYS: the GenICam data are validated at each load
+ *
+ * Since: 0.8.11
+ */
+
+typedef enum {
+	ARV_XML_SCHEMA_VALIDATION_POLICY_NEVER,
+	ARV_XML_SCHEMA_VALIDATION_POLICY_FIRST_SIGHT,
+	ARV_XML_SCHEMA_VALIDATION_POLICY_ALWAYS
+} ArvXmlSchemaValidationPolicy;
+
 #define ARV_TYPE_XML_SCHEMA                  (arv_xml_schema_get_type ())
 G_DECLARE_FINAL_TYPE (ArvXmlSchema, arv_xml_schema, ARV, XML_SCHEMA, GObject)
 
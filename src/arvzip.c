@@ -30,7 +30,7 @@
  * @short_description: A simple zip extractor
  */
 
-#include <arvzip.h>
+#include <arvzipprivate.h>
 #include <arvdebugprivate.h>
 #include <string.h>
 #include <zlib.h>
@@ -271,3 +271,225 @@ arv_zip_get_file (ArvZip *zip, const char *name, size_t *size)
 
         return output_buffer;
 }
+
+#define ARV_ZIP_LOCAL_HEADER_SIZE	30
+#define ARV_ZIP_STREAM_CHUNK		16384
+
+typedef enum {
+	ARV_ZIP_STREAM_STATE_HEADER,
+	ARV_ZIP_STREAM_STATE_DATA,
+	ARV_ZIP_STREAM_STATE_DONE,
+	ARV_ZIP_STREAM_STATE_ERROR
+} ArvZipStreamState;
+
+/* Incremental extraction of the first entry of a zip archive, from its local file header. The data can be fed while
+ * the archive is read, without keeping the compressed data. */
+
+struct _ArvZipStream {
+	ArvZipStreamState state;
+
+	GByteArray *header;
+	size_t header_size;
+
+	guint16 method;
+	size_t n_stored_bytes;
+
+	z_stream zs;
+	gboolean is_inflate_initialized;
+
+	GByteArray *output;
+};
+
+ArvZipStream *
+arv_zip_stream_new (void)
+{
+	ArvZipStream *stream;
+
+	stream = g_new0 (ArvZipStream, 1);
+	stream->state = ARV_ZIP_STREAM_STATE_HEADER;
+	stream->header = g_byte_array_new ();
+	stream->header_size = ARV_ZIP_LOCAL_HEADER_SIZE;
+
+	return stream;
+}
+
+void
+arv_zip_stream_free (ArvZipStream *stream)
+{
+	if (stream == NULL)
+		return;
+
+	if (stream->is_inflate_initialized)
+		inflateEnd (&stream->zs);
+	g_byte_array_unref (stream->header);
+	if (stream->output != NULL)
+		g_byte_array_unref (stream->output);
+	g_free (stream);
+}
+
+static gboolean
+_parse_local_header (ArvZipStream *stream)
+{
+	const void *ptr = stream->header->data;
+	guint16 flags;
+	size_t uncompressed_size;
+
+	if (ARV_GUINT32_FROM_LE_PTR (ptr, 0) != 0x04034b50) {
+		arv_info_misc ("[ZipStream::feed] Magic number for file header not found (0x04034b50)");
+		return FALSE;
+	}
+
+	flags = ARV_GUINT16_FROM_LE_PTR (ptr, 6);
+	stream->method = ARV_GUINT16_FROM_LE_PTR (ptr, 8);
+	stream->n_stored_bytes = ARV_GUINT32_FROM_LE_PTR (ptr, 18);
+	uncompressed_size = ARV_GUINT32_FROM_LE_PTR (ptr, 22);
+
+	/* The sizes are only known after the data when bit 3 is set, which deflate doesn't need */
+	if ((stream->method != 0 && stream->method != 8) ||
+	    (stream->method == 0 && (flags & 0x08) != 0)) {
+		arv_info_misc ("[ZipStream::feed] Unsupported method %d (flags = 0x%04x)", stream->method, flags);
+		return FALSE;
+	}
+
+	stream->output = g_byte_array_sized_new ((flags & 0x08) == 0 ? uncompressed_size : ARV_ZIP_STREAM_CHUNK);
+	stream->header_size += ARV_GUINT16_FROM_LE_PTR (ptr, 26) + ARV_GUINT16_FROM_LE_PTR (ptr, 28);
+
+	return TRUE;
+}
+
+static size_t
+_feed_header (ArvZipStream *stream, const guint8 *data, size_t size)
+{
+	size_t n_bytes;
+
+	n_bytes = MIN (size, stream->header_size - stream->header->len);
+	g_byte_array_append (stream->header, data, n_bytes);
+
+	if (stream->header->len < stream->header_size)
+		return n_bytes;
+
+	if (stream->output == NULL) {
+		if (!_parse_local_header (stream)) {
+			stream->state = ARV_ZIP_STREAM_STATE_ERROR;
+			return n_bytes;
+		}
+		/* The file name and the extra field follow */
+		if (stream->header->len < stream->header_size)
+			return n_bytes;
+	}
+
+	if (stream->method == 8) {
+		if (inflateInit2 (&stream->zs, -MAX_WBITS) != Z_OK) {
+			stream->state = ARV_ZIP_STREAM_STATE_ERROR;
+			return n_bytes;
+		}
+		stream->is_inflate_initialized = TRUE;
+	}
+
+	stream->state = stream->method == 0 && stream->n_stored_bytes == 0 ?
+		ARV_ZIP_STREAM_STATE_DONE :
+		ARV_ZIP_STREAM_STATE_DATA;
+
+	return n_bytes;
+}
+
+static size_t
+_feed_data (ArvZipStream *stream, const guint8 *data, size_t size)
+{
+	size_t n_bytes;
+	int result;
+
+	if (stream->method == 0) {
+		n_bytes = MIN (size, stream->n_stored_bytes);
+		g_byte_array_append (stream->output, data, n_bytes);
+		stream->n_stored_bytes -= n_bytes;
+		if (stream->n_stored_bytes == 0)
+			stream->state = ARV_ZIP_STREAM_STATE_DONE;
+		return n_bytes;
+	}
+
+	stream->zs.next_in = (Bytef *) data;
+	stream->zs.avail_in = MIN (size, G_MAXUINT32);
+
+	do {
+		guint length = stream->output->len;
+
+		/* Inflate in place, the output is preallocated when the uncompressed size is known */
+		g_byte_array_set_size (stream->output, length + ARV_ZIP_STREAM_CHUNK);
+		stream->zs.next_out = stream->output->data + length;
+		stream->zs.avail_out = ARV_ZIP_STREAM_CHUNK;
+
+		result = inflate (&stream->zs, Z_NO_FLUSH);
+
+		g_byte_array_set_size (stream->output, length + ARV_ZIP_STREAM_CHUNK - stream->zs.avail_out);
+
+		if (result == Z_STREAM_END) {
+			stream->state = ARV_ZIP_STREAM_STATE_DONE;
+			break;
+		}
+		if (result != Z_OK && result != Z_BUF_ERROR) {
+			arv_warning_misc ("[ZipStream::feed] Inflate error %d", result);
+			stream->state = ARV_ZIP_STREAM_STATE_ERROR;
+			break;
+		}
+	} while (stream->zs.avail_in > 0 || stream->zs.avail_out == 0);
+
+	return (const guint8 *) stream->zs.next_in - data;
+}
+
+/* Returns %FALSE if the data can't be extracted. The data following the first entry are ignored. */
+
+gboolean
+arv_zip_stream_feed (ArvZipStream *stream, const void *data, size_t size)
+{
+	const guint8 *ptr = data;
+
+	g_return_val_if_fail (stream != NULL, FALSE);
+	g_return_val_if_fail (data != NULL || size == 0, FALSE);
+
+	while (size > 0 &&
+	       (stream->state == ARV_ZIP_STREAM_STATE_HEADER ||
+		stream->state == ARV_ZIP_STREAM_STATE_DATA)) {
+		size_t n_bytes;
+
+		if (stream->state == ARV_ZIP_STREAM_STATE_HEADER)
+			n_bytes = _feed_header (stream, ptr, size);
+		else
+			n_bytes = _feed_data (stream, ptr, size);
+
+		ptr += n_bytes;
+		size -= n_bytes;
+	}
+
+	return stream->state != ARV_ZIP_STREAM_STATE_ERROR;
+}
+
+gboolean
+arv_zip_stream_is_done (ArvZipStream *stream)
+{
+	g_return_val_if_fail (stream != NULL, FALSE);
+
+	return stream->state == ARV_ZIP_STREAM_STATE_DONE;
+}
+
+/* Returns the extracted data, or %NULL if the entry is incomplete */
+
+char *
+arv_zip_stream_steal_file (ArvZipStream *stream, size_t *size)
+{
+	char *data;
+
+	g_return_val_if_fail (stream != NULL, NULL);
+	g_return_val_if_fail (size != NULL, NULL);
+
+	*size = 0;
+
+	if (stream->state != ARV_ZIP_STREAM_STATE_DONE || stream->output == NULL)
+		return NULL;
+
+	*size = stream->output->len;
+	data = (char *) g_byte_array_free (stream->output, FALSE);
+	stream->output = NULL;
+
+	return data;
+}
@@ -0,0 +1,248 @@
+#include <glib.h>
+#include <arv.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <malloc.h>
+
+#if ARAVIS_HAS_USB
+#define ARAVIS_COMPILATION
+#include "../src/arvuvfaketransportprivate.h"
+#endif
+
+/* Steady state allocation regression test. The allocator entry points of the C library are interposed by this
+ * executable, and the allocations of all the threads are counted during the acquisition of N_FRAMES frames, after
+ * N_WARM_UP_FRAMES frames were received. Every push and pop through a GAsyncQueue allocates a list node, hence a non
+ * null budget, which also covers the fake GigE Vision camera thread, running in the same process. */
+
+#define N_BUFFERS		5
+#define N_WARM_UP_FRAMES	20
+#define N_FRAMES		100
+
+#define GV_ALLOCATIONS_PER_FRAME_MAX	8.0
+#define UV_ALLOCATIONS_PER_FRAME_MAX	4.0
+
+extern void *__libc_malloc (size_t size);
+extern void *__libc_calloc (size_t n_members, size_t size);
+extern void *__libc_realloc (void *ptr, size_t size);
+extern void *__libc_memalign (size_t alignment, size_t size);
+
+void *aligned_alloc (size_t alignment, size_t size);
+
+static gint counting = 0;
+static gint n_allocations = 0;
+
+static inline void
+_count (void)
+{
+	if (g_atomic_int_get (&counting))
+		g_atomic_int_inc (&n_allocations);
+}
+
+void *
+malloc (size_t size)
+{
+	_count ();
+	return __libc_malloc (size);
+}
+
+void *
+calloc (size_t n_members, size_t size)
+{
+	_count ();
+	return __libc_calloc (n_members, size);
+}
+
+void *
+realloc (void *ptr, size_t size)
+{
+	_count ();
+	return __libc_realloc (ptr, size);
+}
+
+void *
+memalign (size_t alignment, size_t size)
+{
+	_count ();
+	return __libc_memalign (alignment, size);
+}
+
+void *
+aligned_alloc (size_t alignment, size_t size)
+{
+	_count ();
+	return __libc_memalign (alignment, size);
+}
+
+int
+posix_memalign (void **ptr, size_t alignment, size_t size)
+{
+	void *data;
+
+	_count ();
+
+	if (alignment % sizeof (void *) != 0 || (alignment & (alignment - 1)) != 0)
+		return EINVAL;
+
+	data = __libc_memalign (alignment, size);
+	if (data == NULL && size > 0)
+		return ENOMEM;
+
+	*ptr = data;
+
+	return 0;
+}
+
+static void
+_start_counting (void)
+{
+	g_atomic_int_set (&n_allocations, 0);
+	g_atomic_int_set (&counting, 1);
+}
+
+static guint
+_stop_counting (void)
+{
+	g_atomic_int_set (&counting, 0);
+
+	return g_atomic_int_get (&n_allocations);
+}
+
+/* Returns the mean number of allocations per received frame */
+
+static double
+_measure (ArvStream *stream)
+{
+	guint n_successes = 0;
+	guint n_counted;
+	guint i;
+
+	for (i = 0; i < N_WARM_UP_FRAMES + N_FRAMES; i++) {
+		ArvBuffer *buffer;
+
+		if (i == N_WARM_UP_FRAMES)
+			_start_counting ();
+
+		buffer = arv_stream_timeout_pop_buffer (stream, 1000000);
+		g_assert (ARV_IS_BUFFER (buffer));
+
+		if (i >= N_WARM_UP_FRAMES && arv_buffer_get_status (buffer) == ARV_BUFFER_STATUS_SUCCESS)
+			n_successes++;
+
+		arv_stream_push_buffer (stream, buffer);
+	}
+
+	n_counted = _stop_counting ();
+
+	g_assert_cmpint (n_successes, ==, N_FRAMES);
+
+	g_test_message ("%u allocations for %u frames", n_counted, n_successes);
+
+	return (double) n_counted / (double) n_successes;
+}
+
+static void
+gv_test (void)
+{
+	ArvGvFakeCamera *simulator;
+	ArvCamera *camera;
+	ArvStream *stream;
+	GError *error = NULL;
+	size_t payload;
+	double n_allocations_per_frame;
+	guint i;
+
+	simulator = arv_gv_fake_camera_new ("lo", "GVAllocation");
+	g_assert (ARV_IS_GV_FAKE_CAMERA (simulator));
+
+	camera = arv_camera_new ("Aravis-GVAllocation", &error);
+	g_assert_no_error (error);
+	g_assert (ARV_IS_CAMERA (camera));
+
+	arv_camera_set_region (camera, 0, 0, 256, 256, &error);
+	g_assert_no_error (error);
+	arv_camera_set_frame_rate (camera, 200.0, &error);
+	g_assert_no_error (error);
+
+	payload = arv_camera_get_payload (camera, &error);
+	g_assert_no_error (error);
+
+	stream = arv_camera_create_stream (camera, NULL, NULL, &error);
+	g_assert_no_error (error);
+	g_assert (ARV_IS_STREAM (stream));
+
+	for (i = 0; i < N_BUFFERS; i++)
+		arv_stream_push_buffer (stream, arv_buffer_new (payload, NULL));
+
+	arv_camera_start_acquisition (camera, &error);
+	g_assert_no_error (error);
+
+	n_allocations_per_frame = _measure (stream);
+
+	arv_camera_stop_acquisition (camera, &error);
+	g_assert_no_error (error);
+
+	g_assert_cmpfloat (n_allocations_per_frame, <=, GV_ALLOCATIONS_PER_FRAME_MAX);
+
+	g_object_unref (stream);
+	g_object_unref (camera);
+	g_object_unref (simulator);
+}
+
+#if ARAVIS_HAS_USB
+
+static void
+uv_test (void)
+{
+	ArvUvFakeTransport *transport;
+	ArvDevice *device;
+	ArvStream *stream;
+	GError *error = NULL;
+	size_t payload;
+	double n_allocations_per_frame;
+	guint i;
+
+	transport = arv_uv_fake_transport_new ();
+
+	device = arv_uv_device_new_fake (transport, &error);
+	g_assert_no_error (error);
+	g_assert (ARV_IS_UV_DEVICE (device));
+
+	payload = arv_uv_fake_transport_get_payload (transport);
+
+	stream = arv_device_create_stream (device, NULL, NULL, &error);
+	g_assert_no_error (error);
+	g_assert (ARV_IS_STREAM (stream));
+
+	for (i = 0; i < N_BUFFERS; i++)
+		arv_stream_push_buffer (stream, arv_buffer_new (payload, NULL));
+
+	n_allocations_per_frame = _measure (stream);
+
+	g_assert_cmpfloat (n_allocations_per_frame, <=, UV_ALLOCATIONS_PER_FRAME_MAX);
+
+	g_object_unref (stream);
+	g_object_unref (device);
+}
+
+#endif
+
+int
+main (int argc, char *argv[])
+{
+	int result;
+
+	g_test_init (&argc, &argv, NULL);
+
+	arv_set_fake_camera_genicam_filename (GENICAM_FILENAME);
+
+	g_test_add_func ("/allocation/gv", gv_test);
+#if ARAVIS_HAS_USB
+	g_test_add_func ("/allocation/uv", uv_test);
+#endif
+
+	result = g_test_run();
+
+	arv_shutdown ();
+
+	return result;
+}
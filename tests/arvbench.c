@@ -0,0 +1,504 @@
+#include <arv.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+
+#if ARAVIS_HAS_USB
+#define ARAVIS_COMPILATION
+#include "../src/arvuvfaketransportprivate.h"
+#undef ARAVIS_COMPILATION
+#endif
+
+#define ARV_BENCH_FAKE_GV	"fake-gv"
+#define ARV_BENCH_FAKE_UV	"fake-uv"
+#define ARV_BENCH_FAKE_GV_SERIAL	"Bench"
+
+static char *arv_option_device = ARV_BENCH_FAKE_GV;
+static char *arv_option_n_buffers = "4,16";
+static char *arv_option_packet_sizes = "1500,8000";
+static char *arv_option_sockets = "packet,loop,io-uring";
+static char *arv_option_realtime = "no";
+static char *arv_option_copies = "default";
+static double arv_option_frame_rate = 0.0;
+static int arv_option_duration_s = 3;
+static gboolean arv_option_json = FALSE;
+static char *arv_option_debug_domains = NULL;
+
+static const GOptionEntry arv_option_entries[] =
+{
+	{
+		"device",				'n', 0, G_OPTION_ARG_STRING,
+		&arv_option_device,			"Camera name, " ARV_BENCH_FAKE_GV " or " ARV_BENCH_FAKE_UV,
+		NULL
+	},
+	{
+		"n-buffers",				'b', 0, G_OPTION_ARG_STRING,
+		&arv_option_n_buffers,			"Comma separated list of stream buffer counts", NULL
+	},
+	{
+		"packet-size",				'p', 0, G_OPTION_ARG_STRING,
+		&arv_option_packet_sizes,		"Comma separated list of GigEVision packet sizes", NULL
+	},
+	{
+		"socket",				's', 0, G_OPTION_ARG_STRING,
+		&arv_option_sockets,			"Comma separated list of GigEVision receive modes "
+							"(packet, loop, io-uring)", NULL
+	},
+	{
+		"realtime",				'r', 0, G_OPTION_ARG_STRING,
+		&arv_option_realtime,			"Comma separated list of stream thread priorities "
+							"(no, yes)", NULL
+	},
+	{
+		"copy",					'c', 0, G_OPTION_ARG_STRING,
+		&arv_option_copies,			"Comma separated list of payload copy kernels "
+							"(default, non-temporal)", NULL
+	},
+	{
+		"frame-rate",				'f', 0, G_OPTION_ARG_DOUBLE,
+		&arv_option_frame_rate,			"Acquisition frame rate (0 = device default)", NULL
+	},
+	{
+		"duration",				'u', 0, G_OPTION_ARG_INT,
+		&arv_option_duration_s,			"Duration of each run (s)", NULL
+	},
+	{
+		"json",					'j', 0, G_OPTION_ARG_NONE,
+		&arv_option_json,			"JSON output", NULL
+	},
+	{
+		"debug", 				'd', 0, G_OPTION_ARG_STRING,
+		&arv_option_debug_domains, 		"Debug domains", NULL
+	},
+	{ NULL }
+};
+
+typedef struct {
+	guint n_buffers;
+	guint packet_size;
+	guint socket;
+	gboolean realtime;
+	ArvStreamCopyKernel copy;
+} ArvBenchConfig;
+
+static const struct {
+	const char *name;
+	ArvGvStreamOption options;
+} arv_bench_sockets[] = {
+	{ "packet",	ARV_GV_STREAM_OPTION_NONE },
+	{ "loop",	ARV_GV_STREAM_OPTION_PACKET_SOCKET_DISABLED },
+	{ "io-uring",	ARV_GV_STREAM_OPTION_PACKET_SOCKET_DISABLED | ARV_GV_STREAM_OPTION_IO_URING_ENABLED }
+};
+
+/* Indexed by ArvStreamCopyKernel */
+static const char *arv_bench_copies[] = {
+	"default",
+	"non-temporal"
+};
+
+typedef struct {
+	double duration_s;
+	guint64 n_completed_buffers;
+	guint64 n_failures;
+	guint64 n_underruns;
+	guint64 n_bytes;
+	double cpu_s;
+	gint64 latency_us[4];		/* p50, p90, p99, max */
+	guint64 n_resent_packets;
+	guint64 n_missing_packets;
+	double allocations_per_frame;
+} ArvBenchResult;
+
+static GArray *
+_parse_list (const char *string, gboolean is_boolean)
+{
+	GArray *array = g_array_new (FALSE, FALSE, sizeof (guint));
+	char **tokens;
+	guint i;
+
+	tokens = g_strsplit (string, ",", -1);
+	for (i = 0; tokens[i] != NULL; i++) {
+		guint value;
+
+		g_strstrip (tokens[i]);
+		if (tokens[i][0] == '\0')
+			continue;
+
+		if (is_boolean)
+			value = g_strcmp0 (tokens[i], "yes") == 0 ||
+				g_strcmp0 (tokens[i], "true") == 0;
+		else
+			value = g_ascii_strtoull (tokens[i], NULL, 10);
+
+		g_array_append_val (array, value);
+	}
+	g_strfreev (tokens);
+
+	return array;
+}
+
+/* Returns the indices in arv_bench_sockets of a list of receive mode names */
+
+static GArray *
+_parse_socket_list (const char *string)
+{
+	GArray *array = g_array_new (FALSE, FALSE, sizeof (guint));
+	char **tokens;
+	guint i, j;
+
+	tokens = g_strsplit (string, ",", -1);
+	for (i = 0; tokens[i] != NULL; i++) {
+		g_strstrip (tokens[i]);
+		for (j = 0; j < G_N_ELEMENTS (arv_bench_sockets); j++)
+			if (g_strcmp0 (tokens[i], arv_bench_sockets[j].name) == 0) {
+				g_array_append_val (array, j);
+				break;
+			}
+		if (j == G_N_ELEMENTS (arv_bench_sockets) && tokens[i][0] != '\0')
+			g_printerr ("Unknown receive mode '%s'\n", tokens[i]);
+	}
+	g_strfreev (tokens);
+
+	return array;
+}
+
+/* Returns the ArvStreamCopyKernel values of a list of copy kernel names */
+
+static GArray *
+_parse_copy_list (const char *string)
+{
+	GArray *array = g_array_new (FALSE, FALSE, sizeof (guint));
+	char **tokens;
+	guint i, j;
+
+	tokens = g_strsplit (string, ",", -1);
+	for (i = 0; tokens[i] != NULL; i++) {
+		g_strstrip (tokens[i]);
+		for (j = 0; j < G_N_ELEMENTS (arv_bench_copies); j++)
+			if (g_strcmp0 (tokens[i], arv_bench_copies[j]) == 0) {
+				g_array_append_val (array, j);
+				break;
+			}
+		if (j == G_N_ELEMENTS (arv_bench_copies) && tokens[i][0] != '\0')
+			g_printerr ("Unknown copy kernel '%s'\n", tokens[i]);
+	}
+	g_strfreev (tokens);
+
+	return array;
+}
+
+static double
+_get_cpu_time_s (void)
+{
+	struct rusage usage;
+
+	getrusage (RUSAGE_SELF, &usage);
+
+	return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec +
+		1e-6 * (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec);
+}
+
+static int
+_compare_latencies (gconstpointer a, gconstpointer b)
+{
+	gint64 la = *(const gint64 *) a;
+	gint64 lb = *(const gint64 *) b;
+
+	return la < lb ? -1 : (la > lb ? 1 : 0);
+}
+
+static void
+stream_cb (void *user_data, ArvStreamCallbackType type, ArvBuffer *buffer)
+{
+	const ArvBenchConfig *config = user_data;
+
+	if (type == ARV_STREAM_CALLBACK_TYPE_INIT && config->realtime) {
+		if (!arv_make_thread_realtime (10))
+			g_printerr ("Failed to make stream thread realtime\n");
+	}
+}
+
+static gboolean
+_run (ArvCamera *camera, ArvDevice *device, const ArvBenchConfig *config, ArvBenchResult *result,
+      GError **error)
+{
+	ArvStream *stream;
+	GArray *latencies;
+	gint64 start_time_us;
+	gint64 elapsed_time_us;
+	double start_cpu_s;
+	guint64 n_avoided_allocations;
+	size_t payload;
+	guint i;
+
+	memset (result, 0, sizeof (ArvBenchResult));
+
+	if (camera != NULL) {
+		if (arv_camera_is_gv_device (camera)) {
+			arv_camera_gv_set_packet_size (camera, config->packet_size, error);
+			if (error != NULL && *error != NULL)
+				return FALSE;
+			arv_camera_gv_set_stream_options (camera, arv_bench_sockets[config->socket].options);
+		}
+		if (arv_option_frame_rate > 0.0) {
+			arv_camera_set_frame_rate (camera, arv_option_frame_rate, error);
+			if (error != NULL && *error != NULL)
+				return FALSE;
+		}
+		payload = arv_camera_get_payload (camera, error);
+		if (error != NULL && *error != NULL)
+			return FALSE;
+		stream = arv_camera_create_stream (camera, stream_cb, (void *) config, error);
+	} else {
+		payload = arv_device_get_integer_feature_value (device, "PayloadSize", error);
+		if (error != NULL && *error != NULL)
+			return FALSE;
+		stream = arv_device_create_stream (device, stream_cb, (void *) config, error);
+	}
+
+	if (!ARV_IS_STREAM (stream))
+		return FALSE;
+
+	arv_stream_set_copy_kernel (stream, config->copy);
+
+	for (i = 0; i < config->n_buffers; i++)
+		arv_stream_push_buffer (stream, arv_buffer_new (payload, NULL));
+
+	latencies = g_array_new (FALSE, FALSE, sizeof (gint64));
+
+	start_cpu_s = _get_cpu_time_s ();
+	start_time_us = g_get_monotonic_time ();
+
+	if (camera != NULL)
+		arv_camera_start_acquisition (camera, NULL);
+
+	do {
+		ArvBuffer *buffer;
+
+		buffer = arv_stream_timeout_pop_buffer (stream, 100000);
+		if (buffer != NULL) {
+			if (arv_buffer_get_status (buffer) == ARV_BUFFER_STATUS_SUCCESS) {
+				gint64 latency_us;
+
+				/* From the frame leader reception to the application */
+				latency_us = g_get_real_time () - arv_buffer_get_system_timestamp (buffer) / 1000;
+				g_array_append_val (latencies, latency_us);
+			}
+			arv_stream_push_buffer (stream, buffer);
+		}
+
+		elapsed_time_us = g_get_monotonic_time () - start_time_us;
+	} while (elapsed_time_us < (gint64) arv_option_duration_s * 1000000);
+
+	if (camera != NULL)
+		arv_camera_stop_acquisition (camera, NULL);
+
+	result->cpu_s = _get_cpu_time_s () - start_cpu_s;
+	result->duration_s = elapsed_time_us / 1e6;
+
+	arv_stream_get_statistics (stream, &result->n_completed_buffers, &result->n_failures, &result->n_underruns);
+	result->n_resent_packets = arv_stream_get_info_uint64_by_name (stream, "n_resent_packets");
+	result->n_missing_packets = arv_stream_get_info_uint64_by_name (stream, "n_missing_packets");
+
+	/* Only the GigEVision stream allocates per frame structures */
+	n_avoided_allocations = arv_stream_get_info_uint64_by_name (stream, "n_avoided_allocations");
+	if (ARV_IS_GV_STREAM (stream) && result->n_completed_buffers + result->n_failures > 0)
+		result->allocations_per_frame = (double) ((result->n_completed_buffers + result->n_failures) -
+							  MIN (n_avoided_allocations,
+							       result->n_completed_buffers + result->n_failures)) /
+			(result->n_completed_buffers + result->n_failures);
+
+	result->n_bytes = result->n_completed_buffers * payload;
+
+	if (latencies->len > 0) {
+		g_array_sort (latencies, _compare_latencies);
+		result->latency_us[0] = g_array_index (latencies, gint64, latencies->len * 50 / 100);
+		result->latency_us[1] = g_array_index (latencies, gint64, latencies->len * 90 / 100);
+		result->latency_us[2] = g_array_index (latencies, gint64, latencies->len * 99 / 100);
+		result->latency_us[3] = g_array_index (latencies, gint64, latencies->len - 1);
+	}
+
+	g_array_unref (latencies);
+	g_object_unref (stream);
+
+	return TRUE;
+}
+
+static void
+_print_result (GString *json, const ArvBenchConfig *config, const ArvBenchResult *result, gboolean is_gv)
+{
+	double frame_rate = result->duration_s > 0.0 ? result->n_completed_buffers / result->duration_s : 0.0;
+	double throughput = result->duration_s > 0.0 ? result->n_bytes / result->duration_s / 1e6 : 0.0;
+	double cpu_per_gb = result->n_bytes > 0 ? result->cpu_s / (result->n_bytes / 1e9) : 0.0;
+
+	if (json != NULL) {
+		g_string_append_printf (json,
+					"    {\n"
+					"      \"n_buffers\": %u,\n"
+					"      \"packet_size\": %u,\n"
+					"      \"socket\": \"%s\",\n"
+					"      \"realtime\": %s,\n"
+					"      \"copy\": \"%s\",\n"
+					"      \"duration_s\": %.3f,\n"
+					"      \"n_completed_buffers\": %" G_GUINT64_FORMAT ",\n"
+					"      \"n_failures\": %" G_GUINT64_FORMAT ",\n"
+					"      \"n_underruns\": %" G_GUINT64_FORMAT ",\n"
+					"      \"frame_rate\": %.2f,\n"
+					"      \"throughput_mb_s\": %.2f,\n"
+					"      \"cpu_s_per_gb\": %.3f,\n"
+					"      \"latency_us\": {\"p50\": %" G_GINT64_FORMAT ", \"p90\": %" G_GINT64_FORMAT
+					", \"p99\": %" G_GINT64_FORMAT ", \"max\": %" G_GINT64_FORMAT "},\n"
+					"      \"n_resent_packets\": %" G_GUINT64_FORMAT ",\n"
+					"      \"n_missing_packets\": %" G_GUINT64_FORMAT ",\n"
+					"      \"allocations_per_frame\": %.3f\n"
+					"    }",
+					config->n_buffers, is_gv ? config->packet_size : 0,
+					is_gv ? arv_bench_sockets[config->socket].name : "usb",
+					config->realtime ? "true" : "false",
+					arv_bench_copies[config->copy],
+					result->duration_s,
+					result->n_completed_buffers, result->n_failures, result->n_underruns,
+					frame_rate, throughput, cpu_per_gb,
+					result->latency_us[0], result->latency_us[1],
+					result->latency_us[2], result->latency_us[3],
+					result->n_resent_packets, result->n_missing_packets,
+					result->allocations_per_frame);
+		return;
+	}
+
+	g_print ("%7u %7u %-8s %-3s %-12s %8.1f %9.1f %8.3f %7" G_GINT64_FORMAT " %7" G_GINT64_FORMAT
+		 " %7" G_GINT64_FORMAT " %8" G_GINT64_FORMAT " %8" G_GUINT64_FORMAT " %6.3f\n",
+		 config->n_buffers, is_gv ? config->packet_size : 0,
+		 is_gv ? arv_bench_sockets[config->socket].name : "usb",
+		 config->realtime ? "yes" : "no",
+		 arv_bench_copies[config->copy],
+		 frame_rate, throughput, cpu_per_gb,
+		 result->latency_us[0], result->latency_us[1], result->latency_us[2], result->latency_us[3],
+		 result->n_resent_packets, result->allocations_per_frame);
+}
+
+int
+main (int argc, char **argv)
+{
+	ArvGvFakeCamera *simulator = NULL;
+	ArvCamera *camera = NULL;
+	ArvDevice *device = NULL;
+	GOptionContext *context;
+	GError *error = NULL;
+	GArray *n_buffers;
+	GArray *packet_sizes;
+	GArray *sockets;
+	GArray *realtimes;
+	GArray *copies;
+	GString *json = NULL;
+	gboolean is_gv;
+	gboolean success = TRUE;
+	guint n_runs = 0;
+	guint i, j, k, l, m;
+
+	context = g_option_context_new (NULL);
+	g_option_context_set_summary (context, "Acquisition throughput and latency benchmark. "
+				      "The stream options given as lists are swept.");
+	g_option_context_add_main_entries (context, arv_option_entries, NULL);
+
+	if (!g_option_context_parse (context, &argc, &argv, &error)) {
+		g_option_context_free (context);
+		g_printerr ("Option parsing failed: %s\n", error->message);
+		g_error_free (error);
+		return EXIT_FAILURE;
+	}
+
+	g_option_context_free (context);
+
+	arv_debug_enable (arv_option_debug_domains);
+
+	if (g_strcmp0 (arv_option_device, ARV_BENCH_FAKE_GV) == 0) {
+		simulator = arv_gv_fake_camera_new ("lo", ARV_BENCH_FAKE_GV_SERIAL);
+		if (simulator == NULL || !arv_gv_fake_camera_is_running (simulator)) {
+			g_printerr ("Failed to start the GigEVision simulator\n");
+			g_clear_object (&simulator);
+			return EXIT_FAILURE;
+		}
+		camera = arv_camera_new ("Aravis-" ARV_BENCH_FAKE_GV_SERIAL, &error);
+	} else if (g_strcmp0 (arv_option_device, ARV_BENCH_FAKE_UV) == 0) {
+#if ARAVIS_HAS_USB
+		device = arv_uv_device_new_fake (arv_uv_fake_transport_new (), &error);
+#else
+		g_set_error (&error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_NOT_FOUND, "USB support is disabled");
+#endif
+	} else
+		camera = arv_camera_new (arv_option_device, &error);
+
+	if (camera == NULL && device == NULL) {
+		g_printerr ("Device '%s' not found%s%s\n", arv_option_device,
+			    error != NULL ? ": " : "", error != NULL ? error->message : "");
+		g_clear_error (&error);
+		g_clear_object (&simulator);
+		return EXIT_FAILURE;
+	}
+
+	is_gv = camera != NULL && arv_camera_is_gv_device (camera);
+
+	n_buffers = _parse_list (arv_option_n_buffers, FALSE);
+	packet_sizes = _parse_list (is_gv ? arv_option_packet_sizes : "0", FALSE);
+	sockets = _parse_socket_list (is_gv ? arv_option_sockets : "packet");
+	realtimes = _parse_list (arv_option_realtime, TRUE);
+	copies = _parse_copy_list (arv_option_copies);
+
+	if (arv_option_json) {
+		json = g_string_new ("");
+		g_string_append_printf (json, "{\n  \"aravis_version\": \"%s\",\n  \"device\": \"%s\",\n"
+					"  \"runs\": [\n", ARAVIS_VERSION, arv_option_device);
+	} else
+		g_print ("buffers  packet socket   rt  copy         frames/s      MB/s   cpu/GB     p50     p90     p99 "
+			 "     max  resents allocs\n");
+
+	for (i = 0; i < n_buffers->len && success; i++)
+		for (j = 0; j < packet_sizes->len && success; j++)
+			for (k = 0; k < sockets->len && success; k++)
+				for (l = 0; l < realtimes->len && success; l++)
+					for (m = 0; m < copies->len && success; m++) {
+						ArvBenchConfig config;
+						ArvBenchResult result;
+
+						config.n_buffers = g_array_index (n_buffers, guint, i);
+						config.packet_size = g_array_index (packet_sizes, guint, j);
+						config.socket = g_array_index (sockets, guint, k);
+						config.realtime = g_array_index (realtimes, guint, l);
+						config.copy = g_array_index (copies, guint, m);
+
+						success = _run (camera, device, &config, &result, &error);
+						if (success) {
+							if (json != NULL && n_runs > 0)
+								g_string_append (json, ",\n");
+							_print_result (json, &config, &result, is_gv);
+							n_runs++;
+						}
+					}
+
+	if (!success) {
+		g_printerr ("Benchmark failed%s%s\n",
+			    error != NULL ? ": " : "", error != NULL ? error->message : "");
+		g_clear_error (&error);
+	}
+
+	if (json != NULL) {
+		g_string_append (json, "\n  ]\n}\n");
+		g_print ("%s", json->str);
+		g_string_free (json, TRUE);
+	}
+
+	g_array_unref (n_buffers);
+	g_array_unref (packet_sizes);
+	g_array_unref (sockets);
+	g_array_unref (realtimes);
+	g_array_unref (copies);
+
+	g_clear_object (&camera);
+	g_clear_object (&device);
+	g_clear_object (&simulator);
+
+	arv_shutdown ();
+
+	return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
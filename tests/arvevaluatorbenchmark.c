@@ -0,0 +1,68 @@
+#include <arv.h>
+#include <stdlib.h>
+
+#define N_ITERATIONS	1000000
+
+typedef struct {
+	const char *expression;
+	gboolean integer_mode;
+} BenchmarkExpression;
+
+static const BenchmarkExpression expressions[] = {
+	{"(2 + 3) * 4 - 10 / 5",			TRUE},
+	{"(X << 8) | (Y & 0xff)",			TRUE},
+	{"(X > 100) ? (X - 100) : (100 - X)",		TRUE},
+	{"X * 1000000 / (8 * 4)",			TRUE},
+	{"(X + 0.5) * 2.0 / 3.0",			FALSE},
+	{"SQRT(X * X + Y * Y) + SIN(PI / 4)",		FALSE},
+	{"(X * 1e6 / (8.0 * 4.0)) + Y * (1.0 / 3.0)",	FALSE}
+};
+
+int
+main (int argc, char **argv)
+{
+	ArvEvaluator *evaluator;
+	GError *error = NULL;
+	gint x_slot, y_slot;
+	int i, j;
+
+	evaluator = arv_evaluator_new (NULL);
+
+	x_slot = arv_evaluator_get_variable_slot (evaluator, "X");
+	y_slot = arv_evaluator_get_variable_slot (evaluator, "Y");
+
+	for (i = 0; i < G_N_ELEMENTS (expressions); i++) {
+		gint64 start_time;
+		gint64 elapsed_time;
+		double sum = 0.0;
+
+		arv_evaluator_set_expression (evaluator, expressions[i].expression);
+
+		start_time = g_get_monotonic_time ();
+
+		for (j = 0; j < N_ITERATIONS; j++) {
+			arv_evaluator_set_int64_variable_by_slot (evaluator, x_slot, j & 0x3ff);
+			arv_evaluator_set_int64_variable_by_slot (evaluator, y_slot, j >> 10);
+
+			if (expressions[i].integer_mode)
+				sum += arv_evaluator_evaluate_as_int64 (evaluator, &error);
+			else
+				sum += arv_evaluator_evaluate_as_double (evaluator, &error);
+
+			if (error != NULL) {
+				g_print ("Error in '%s': %s\n", expressions[i].expression, error->message);
+				g_clear_error (&error);
+				break;
+			}
+		}
+
+		elapsed_time = g_get_monotonic_time () - start_time;
+
+		g_print ("%-45s %8.1f ns/evaluation (sum = %g)\n", expressions[i].expression,
+			 1000.0 * (double) elapsed_time / (double) N_ITERATIONS, sum);
+	}
+
+	g_object_unref (evaluator);
+
+	return EXIT_SUCCESS;
+}
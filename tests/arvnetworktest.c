@@ -6,7 +6,7 @@
 #define _ALEN 16
 #define _ALENS "16"
 /* Put interface name at the end, it can be quite long under Windows */
-#define _LINEFMT "%5s %" _ALENS "s %" _ALENS "s %" _ALENS "s  %s\r\n"
+#define _LINEFMT "%5s %" _ALENS "s %" _ALENS "s %" _ALENS "s %6s %6s %5s  %s\r\n"
 
 int
 main (int argc, char **argv){
@@ -18,13 +18,16 @@ main (int argc, char **argv){
 		fprintf (stderr,"No network interfaces found (or enumeration failed).");
 		return 1;
 	}
-	printf(_LINEFMT,"proto","address","mask","broadcast","interface");
+	printf(_LINEFMT,"proto","address","mask","broadcast","mtu","Mb/s","numa","interface");
 
 	for (iface_iter=ifaces; iface_iter!=NULL; iface_iter=iface_iter->next){
 		ArvNetworkInterface* ani = (ArvNetworkInterface*)iface_iter->data;
 		char addr[_ALEN];
 		char netmask[_ALEN];
 		char broadaddr[_ALEN];
+		char mtu[16];
+		char speed[16];
+		char numa[16];
 		int fam = arv_network_interface_get_addr(ani)->sa_family;
 
 		if (fam==AF_INET){
@@ -37,7 +40,11 @@ main (int argc, char **argv){
 			inet_ntop (fam,
 				   &((struct sockaddr_in*)arv_network_interface_get_broadaddr(ani))->sin_addr,
 				   &broadaddr[0], _ALEN);
-			printf (_LINEFMT, "IPv4", addr, netmask, broadaddr, arv_network_interface_get_name(ani));
+			snprintf (mtu, sizeof (mtu), "%u", arv_network_interface_get_mtu (ani));
+			snprintf (speed, sizeof (speed), "%u", arv_network_interface_get_link_speed (ani));
+			snprintf (numa, sizeof (numa), "%d", arv_network_interface_get_numa_node (ani));
+			printf (_LINEFMT, "IPv4", addr, netmask, broadaddr, mtu, speed, numa,
+				arv_network_interface_get_name(ani));
 		}
 		else if (fam==AF_INET6){
 			fprintf (stderr,"%s: IPv6 not yet reported correctly", arv_network_interface_get_name(ani));
@@ -0,0 +1,163 @@
+#include <arv.h>
+#include <stdlib.h>
+
+#define ARAVIS_COMPILATION
+#include "../src/arvuvfaketransportprivate.h"
+#include "../src/arvstreamprivate.h"
+#include "../src/arvmiscprivate.h"
+
+static int arv_option_width = ARV_UV_FAKE_TRANSPORT_WIDTH_DEFAULT;
+static int arv_option_height = ARV_UV_FAKE_TRANSPORT_HEIGHT_DEFAULT;
+static int arv_option_alignment = ARV_UV_FAKE_TRANSPORT_ALIGNMENT_DEFAULT;
+static int arv_option_trailer_size = 0;
+static double arv_option_frame_rate = 0.0;
+static double arv_option_short_transfer_ratio = 0.0;
+static int arv_option_n_buffers = 16;
+static int arv_option_duration_s = 5;
+static char *arv_option_debug_domains = NULL;
+
+static const GOptionEntry arv_option_entries[] =
+{
+	{
+		"width",				'w', 0, G_OPTION_ARG_INT,
+		&arv_option_width,			"Image width", NULL
+	},
+	{
+		"height",				'h', 0, G_OPTION_ARG_INT,
+		&arv_option_height,			"Image height", NULL
+	},
+	{
+		"alignment",				'a', 0, G_OPTION_ARG_INT,
+		&arv_option_alignment,			"Transfer size alignment (power of two)", NULL
+	},
+	{
+		"trailer-size",				't', 0, G_OPTION_ARG_INT,
+		&arv_option_trailer_size,		"Trailer transfer size", NULL
+	},
+	{
+		"frame-rate",				'r', 0, G_OPTION_ARG_DOUBLE,
+		&arv_option_frame_rate,			"Frame rate (0 = as fast as possible)", NULL
+	},
+	{
+		"short-transfer-ratio",			's', 0, G_OPTION_ARG_DOUBLE,
+		&arv_option_short_transfer_ratio,	"Ratio of short payload transfers", NULL
+	},
+	{
+		"n-buffers",				'n', 0, G_OPTION_ARG_INT,
+		&arv_option_n_buffers,			"Number of stream buffers", NULL
+	},
+	{
+		"duration",				'u', 0, G_OPTION_ARG_INT,
+		&arv_option_duration_s,			"Benchmark duration (s)", NULL
+	},
+	{
+		"debug", 				'd', 0, G_OPTION_ARG_STRING,
+		&arv_option_debug_domains, 		"Debug domains", NULL
+	},
+	{ NULL }
+};
+
+int
+main (int argc, char **argv)
+{
+	ArvUvFakeTransport *transport;
+	ArvDevice *device;
+	ArvStream *stream;
+	GOptionContext *context;
+	GError *error = NULL;
+	gint64 start_time_us;
+	gint64 elapsed_time_us;
+	guint64 n_completed_buffers = 0;
+	guint64 n_failures = 0;
+	guint64 n_underruns = 0;
+	guint64 n_transfers;
+	guint64 n_bytes;
+	guint64 wait_time_us;
+	size_t payload;
+	guint i;
+
+	context = g_option_context_new (NULL);
+	g_option_context_set_summary (context, "Throughput and latency benchmark of the USB3Vision stream, "
+				      "using a simulated device.");
+	g_option_context_add_main_entries (context, arv_option_entries, NULL);
+
+	if (!g_option_context_parse (context, &argc, &argv, &error)) {
+		g_option_context_free (context);
+		g_print ("Option parsing failed: %s\n", error->message);
+		g_error_free (error);
+		return EXIT_FAILURE;
+	}
+
+	g_option_context_free (context);
+
+	arv_debug_enable (arv_option_debug_domains);
+
+	transport = arv_uv_fake_transport_new ();
+	arv_uv_fake_transport_set_region (transport, arv_option_width, arv_option_height);
+	arv_uv_fake_transport_set_alignment (transport, arv_option_alignment);
+	arv_uv_fake_transport_set_trailer_size (transport, arv_option_trailer_size);
+	arv_uv_fake_transport_set_frame_rate (transport, arv_option_frame_rate);
+	arv_uv_fake_transport_set_short_transfer_ratio (transport, arv_option_short_transfer_ratio);
+
+	payload = arv_uv_fake_transport_get_payload (transport);
+
+	device = arv_uv_device_new_fake (transport, &error);
+	if (!ARV_IS_DEVICE (device)) {
+		g_print ("Failed to create the simulated device: %s\n", error != NULL ? error->message : "");
+		g_clear_error (&error);
+		return EXIT_FAILURE;
+	}
+
+	stream = arv_device_create_stream (device, NULL, NULL, &error);
+	if (!ARV_IS_STREAM (stream)) {
+		g_print ("Failed to create the stream: %s\n", error != NULL ? error->message : "");
+		g_clear_error (&error);
+		g_object_unref (device);
+		return EXIT_FAILURE;
+	}
+
+	for (i = 0; i < arv_option_n_buffers; i++)
+		arv_stream_push_buffer (stream, arv_buffer_new (payload, NULL));
+
+	start_time_us = g_get_monotonic_time ();
+
+	do {
+		ArvBuffer *buffer;
+
+		buffer = arv_stream_timeout_pop_buffer (stream, 1000000);
+		if (buffer != NULL)
+			arv_stream_push_buffer (stream, buffer);
+
+		elapsed_time_us = g_get_monotonic_time () - start_time_us;
+	} while (elapsed_time_us < (gint64) arv_option_duration_s * 1000000);
+
+	arv_stream_get_statistics (stream, &n_completed_buffers, &n_failures, &n_underruns);
+	n_transfers = arv_stream_get_info_uint64_by_name (stream, "n_usb_transfers");
+	n_bytes = arv_stream_get_info_uint64_by_name (stream, "n_transferred_bytes");
+	wait_time_us = arv_stream_get_info_uint64_by_name (stream, "transfer_wait_time_us");
+
+	g_print ("Payload              = %" G_GSIZE_FORMAT " bytes\n", payload);
+	g_print ("Completed buffers    = %" G_GUINT64_FORMAT "\n", n_completed_buffers);
+	g_print ("Failures             = %" G_GUINT64_FORMAT "\n", n_failures);
+	g_print ("Underruns            = %" G_GUINT64_FORMAT "\n", n_underruns);
+	g_print ("Frame rate           = %.1f Hz\n", 1e6 * n_completed_buffers / elapsed_time_us);
+	g_print ("Throughput           = %.1f MB/s\n", (double) n_bytes / elapsed_time_us);
+	g_print ("Transfers per buffer = %.2f\n",
+		 n_completed_buffers > 0 ? (double) n_transfers / n_completed_buffers : 0.0);
+	g_print ("Time in transfers    = %.1f %%\n", 100.0 * wait_time_us / elapsed_time_us);
+
+	for (i = 0; i < arv_stream_get_n_statistics (stream); i++) {
+		const ArvStatistic *statistic;
+		char *string;
+
+		statistic = arv_stream_get_statistic (stream, i, NULL, NULL);
+		string = arv_statistic_to_string (statistic);
+		g_print ("%s", string);
+		g_free (string);
+	}
+
+	g_object_unref (stream);
+	g_object_unref (device);
+
+	return EXIT_SUCCESS;
+}
@@ -1,5 +1,13 @@
+#define ARAVIS_COMPILATION
+
 #include <glib.h>
 #include <arv.h>
+#include <arvbufferprivate.h>
+#include <arvbufferconvertprivate.h>
+#include <string.h>
+#ifdef __linux__
+#include <unistd.h>
+#endif
 
 static void
 simple_buffer_test (void)
@@ -113,6 +121,723 @@ allocate (void)
 	g_object_unref (buffer);
 }
 
+static void
+allocate_numa (void)
+{
+	ArvBuffer *buffer;
+	unsigned char *data;
+	size_t size;
+
+	buffer = arv_buffer_new_allocate_numa (65536, 0);
+
+	data = (unsigned char *) arv_buffer_get_data (buffer, &size);
+
+	g_assert (data != NULL);
+	g_assert (size == 65536);
+
+	memset (data, 0xff, size);
+	g_assert (data[size - 1] == 0xff);
+
+	g_object_unref (buffer);
+
+	buffer = arv_buffer_new_allocate_numa (512, -1);
+	g_assert (arv_buffer_get_data (buffer, NULL) != NULL);
+	g_object_unref (buffer);
+}
+
+static void
+allocate_full (void)
+{
+	ArvBuffer *buffer;
+	unsigned char *data;
+	size_t size;
+
+	buffer = arv_buffer_new_allocate_full (3 << 20, ARV_BUFFER_ALLOCATION_FLAGS_HUGE_PAGES, 0);
+
+	data = (unsigned char *) arv_buffer_get_data (buffer, &size);
+
+	g_assert (data != NULL);
+	g_assert (size == 3 << 20);
+	g_assert (((guintptr) data & ((2 << 20) - 1)) == 0);
+
+	memset (data, 0xff, size);
+	g_assert (data[size - 1] == 0xff);
+
+	g_object_unref (buffer);
+
+	buffer = arv_buffer_new_allocate_full (1000, ARV_BUFFER_ALLOCATION_FLAGS_NONE, 65536);
+	data = (unsigned char *) arv_buffer_get_data (buffer, &size);
+	g_assert (size == 1000);
+	g_assert (((guintptr) data & 65535) == 0);
+	memset (data, 0xff, size);
+	g_assert (arv_buffer_get_fd (buffer) == -1);
+	g_object_unref (buffer);
+
+	buffer = arv_buffer_new_allocate_full (5000, ARV_BUFFER_ALLOCATION_FLAGS_SHAREABLE, 0);
+	data = (unsigned char *) arv_buffer_get_data (buffer, &size);
+	g_assert (size == 5000);
+	memset (data, 0xa5, size);
+#ifdef __linux__
+	{
+		unsigned char value = 0;
+		int fd;
+
+		fd = arv_buffer_get_fd (buffer);
+		g_assert (fd >= 0);
+		g_assert (pread (fd, &value, 1, size - 1) == 1);
+		g_assert (value == 0xa5);
+	}
+#endif
+	g_object_unref (buffer);
+}
+
+#define CONVERT_WIDTH	37
+#define CONVERT_HEIGHT	7
+
+static void
+_pack_pixels (ArvPixelFormat pixel_format, const guint16 *pixels, guint n_pixels, guint8 *data)
+{
+	guint depth = ARV_PIXEL_FORMAT_BIT_PER_PIXEL (pixel_format);
+	guint i, j;
+
+	switch (pixel_format) {
+		case ARV_PIXEL_FORMAT_MONO_12_PACKED:
+		case ARV_PIXEL_FORMAT_BAYER_RG_12_PACKED:
+			for (i = 0; i < n_pixels; i += 2) {
+				guint16 p1 = i + 1 < n_pixels ? pixels[i + 1] : 0;
+
+				data[3 * i / 2] = pixels[i] >> 4;
+				data[3 * i / 2 + 1] = (pixels[i] & 0x0f) | ((p1 & 0x0f) << 4);
+				data[3 * i / 2 + 2] = p1 >> 4;
+			}
+			break;
+		case ARV_PIXEL_FORMAT_MONO_10_PACKED:
+		case ARV_PIXEL_FORMAT_BAYER_GB_10_PACKED:
+			for (i = 0; i < n_pixels; i += 2) {
+				guint16 p1 = i + 1 < n_pixels ? pixels[i + 1] : 0;
+
+				data[3 * i / 2] = pixels[i] >> 2;
+				data[3 * i / 2 + 1] = (pixels[i] & 0x03) | ((p1 & 0x03) << 4);
+				data[3 * i / 2 + 2] = p1 >> 2;
+			}
+			break;
+		case ARV_PIXEL_FORMAT_MONO_10:
+		case ARV_PIXEL_FORMAT_MONO_12:
+			for (i = 0; i < n_pixels; i++) {
+				data[2 * i] = pixels[i] & 0xff;
+				data[2 * i + 1] = pixels[i] >> 8;
+			}
+			break;
+		default:
+			/* p formats, lsb first bit stream */
+			memset (data, 0, (n_pixels * depth + 7) / 8);
+			for (i = 0; i < n_pixels; i++)
+				for (j = 0; j < depth; j++)
+					if (pixels[i] & (1 << j))
+						data[(i * depth + j) / 8] |= 1 << ((i * depth + j) % 8);
+			break;
+	}
+}
+
+static void
+convert (void)
+{
+	static const struct {
+		ArvPixelFormat source;
+		ArvPixelFormat target;
+		guint depth;
+		guint target_depth;
+		size_t stride;
+	} conversions[] = {
+		{ARV_PIXEL_FORMAT_MONO_12P,		ARV_PIXEL_FORMAT_MONO_16,	12, 16,	0},
+		{ARV_PIXEL_FORMAT_MONO_12P,		ARV_PIXEL_FORMAT_MONO_12,	12, 12,	128},
+		{ARV_PIXEL_FORMAT_MONO_12P,		ARV_PIXEL_FORMAT_MONO_8,	12, 8,	64},
+		{ARV_PIXEL_FORMAT_BAYER_BG_12P,		ARV_PIXEL_FORMAT_BAYER_BG_16,	12, 16,	0},
+		{ARV_PIXEL_FORMAT_MONO_12_PACKED,	ARV_PIXEL_FORMAT_MONO_12,	12, 12,	0},
+		{ARV_PIXEL_FORMAT_BAYER_RG_12_PACKED,	ARV_PIXEL_FORMAT_BAYER_RG_8,	12, 8,	0},
+		{ARV_PIXEL_FORMAT_MONO_10P,		ARV_PIXEL_FORMAT_MONO_16,	10, 16,	0},
+		{ARV_PIXEL_FORMAT_MONO_10P,		ARV_PIXEL_FORMAT_MONO_8,	10, 8,	0},
+		{ARV_PIXEL_FORMAT_MONO_10_PACKED,	ARV_PIXEL_FORMAT_MONO_10,	10, 10,	96},
+		{ARV_PIXEL_FORMAT_BAYER_GB_10_PACKED,	ARV_PIXEL_FORMAT_BAYER_GB_16,	10, 16,	0},
+		{ARV_PIXEL_FORMAT_MONO_12,		ARV_PIXEL_FORMAT_MONO_8,	12, 8,	0},
+		{ARV_PIXEL_FORMAT_MONO_10,		ARV_PIXEL_FORMAT_MONO_16,	10, 16,	0}
+	};
+	static const ArvConvertSimd simds[] = {
+		ARV_CONVERT_SIMD_NONE,
+		ARV_CONVERT_SIMD_SSE4_1,
+		ARV_CONVERT_SIMD_AVX2,
+		ARV_CONVERT_SIMD_NEON
+	};
+	guint16 pixels[CONVERT_WIDTH * CONVERT_HEIGHT];
+	guint8 output[CONVERT_HEIGHT * 128];
+	ArvConvertSimd default_simd;
+	ArvBuffer *buffer;
+	GError *error = NULL;
+	guint i, j, k, x, y;
+
+	default_simd = arv_convert_get_simd ();
+
+	buffer = arv_buffer_new (CONVERT_WIDTH * CONVERT_HEIGHT * 2, NULL);
+	buffer->priv->payload_type = ARV_BUFFER_PAYLOAD_TYPE_IMAGE;
+	buffer->priv->status = ARV_BUFFER_STATUS_SUCCESS;
+	buffer->priv->width = CONVERT_WIDTH;
+	buffer->priv->height = CONVERT_HEIGHT;
+
+	for (i = 0; i < G_N_ELEMENTS (conversions); i++) {
+		size_t stride;
+
+		for (j = 0; j < G_N_ELEMENTS (pixels); j++)
+			pixels[j] = g_random_int_range (0, 1 << conversions[i].depth);
+
+		buffer->priv->pixel_format = conversions[i].source;
+		_pack_pixels (conversions[i].source, pixels, G_N_ELEMENTS (pixels), buffer->priv->data);
+
+		stride = conversions[i].stride != 0 ? conversions[i].stride :
+			CONVERT_WIDTH * (conversions[i].target_depth > 8 ? 2 : 1);
+
+		for (k = 0; k < G_N_ELEMENTS (simds); k++) {
+			if (!arv_convert_set_simd (simds[k]))
+				continue;
+
+			memset (output, 0xaa, sizeof (output));
+
+			g_assert_true (arv_buffer_convert (buffer, conversions[i].target, output,
+							   conversions[i].stride, &error));
+			g_assert_no_error (error);
+
+			for (y = 0; y < CONVERT_HEIGHT; y++) {
+				for (x = 0; x < CONVERT_WIDTH; x++) {
+					guint16 pixel = pixels[y * CONVERT_WIDTH + x];
+
+					if (conversions[i].target_depth == 8) {
+						g_assert_cmpint (output[y * stride + x], ==,
+								 pixel >> (conversions[i].depth - 8));
+					} else {
+						guint16 value;
+
+						memcpy (&value, output + y * stride + 2 * x, 2);
+						g_assert_cmpint (value, ==,
+								 pixel << (conversions[i].target_depth -
+									   conversions[i].depth));
+					}
+				}
+
+				/* Row padding is left untouched */
+				if (stride > CONVERT_WIDTH * (conversions[i].target_depth > 8 ? 2 : 1))
+					g_assert_cmpint (output[y * stride + stride - 1], ==, 0xaa);
+			}
+		}
+	}
+
+	g_assert_true (arv_convert_set_simd (default_simd));
+
+	g_assert_false (arv_buffer_convert (buffer, ARV_PIXEL_FORMAT_BAYER_GR_8, output, 0, &error));
+	g_assert_error (error, ARV_BUFFER_ERROR, ARV_BUFFER_ERROR_UNSUPPORTED_CONVERSION);
+	g_clear_error (&error);
+
+	g_assert_false (arv_buffer_convert (buffer, ARV_PIXEL_FORMAT_MONO_16, output, 3, &error));
+	g_assert_error (error, ARV_BUFFER_ERROR, ARV_BUFFER_ERROR_INVALID_STRIDE);
+	g_clear_error (&error);
+
+	buffer->priv->status = ARV_BUFFER_STATUS_MISSING_PACKETS;
+	g_assert_false (arv_buffer_convert (buffer, ARV_PIXEL_FORMAT_MONO_16, output, 0, &error));
+	g_assert_error (error, ARV_BUFFER_ERROR, ARV_BUFFER_ERROR_INVALID_PAYLOAD);
+	g_clear_error (&error);
+
+	g_object_unref (buffer);
+}
+
+#define COLOR_WIDTH	66
+#define COLOR_HEIGHT	130
+
+static void
+convert_color (void)
+{
+	static const ArvBufferConvertFlags flags[] = {
+		ARV_BUFFER_CONVERT_FLAGS_NONE,
+		ARV_BUFFER_CONVERT_FLAGS_EDGE_AWARE,
+		ARV_BUFFER_CONVERT_FLAGS_EDGE_AWARE | ARV_BUFFER_CONVERT_FLAGS_MULTI_THREADED
+	};
+	guint16 *pixels;
+	guint8 *output;
+	guint8 *reference;
+	guint8 *yuv;
+	ArvBuffer *buffer;
+	ArvBuffer *yuv_buffer;
+	GError *error = NULL;
+	guint i, x, y;
+
+	pixels = g_new (guint16, COLOR_WIDTH * COLOR_HEIGHT);
+	output = g_new (guint8, COLOR_WIDTH * COLOR_HEIGHT * 4 + 16 * COLOR_HEIGHT);
+	reference = g_new (guint8, COLOR_WIDTH * COLOR_HEIGHT * 3);
+	yuv = g_new (guint8, COLOR_WIDTH * COLOR_HEIGHT * 2);
+
+	buffer = arv_buffer_new_image (ARV_PIXEL_FORMAT_BAYER_GB_12P, COLOR_WIDTH, COLOR_HEIGHT,
+				       COLOR_WIDTH * COLOR_HEIGHT * 2, NULL);
+
+	/* A flat red 0x800, green 0x400, blue 0x100 scene is demosaiced exactly, borders included */
+	for (y = 0; y < COLOR_HEIGHT; y++)
+		for (x = 0; x < COLOR_WIDTH; x++)
+			pixels[y * COLOR_WIDTH + x] = (x & 1) == (y & 1) ? 0x400 : ((y & 1) == 0 ? 0x100 : 0x800);
+	_pack_pixels (ARV_PIXEL_FORMAT_BAYER_GB_12P, pixels, COLOR_WIDTH * COLOR_HEIGHT, buffer->priv->data);
+
+	for (i = 0; i < G_N_ELEMENTS (flags); i++) {
+		memset (output, 0xaa, COLOR_WIDTH * COLOR_HEIGHT * 4 + 16 * COLOR_HEIGHT);
+
+		g_assert_true (arv_buffer_convert_full (buffer, ARV_PIXEL_FORMAT_BGRA_8_PACKED, output,
+							COLOR_WIDTH * 4 + 16, flags[i], &error));
+		g_assert_no_error (error);
+
+		for (y = 0; y < COLOR_HEIGHT; y++) {
+			for (x = 0; x < COLOR_WIDTH; x++) {
+				guint8 *pixel = output + y * (COLOR_WIDTH * 4 + 16) + 4 * x;
+
+				g_assert_cmpint (pixel[0], ==, 0x10);
+				g_assert_cmpint (pixel[1], ==, 0x40);
+				g_assert_cmpint (pixel[2], ==, 0x80);
+				g_assert_cmpint (pixel[3], ==, 0xff);
+			}
+			g_assert_cmpint (output[y * (COLOR_WIDTH * 4 + 16) + COLOR_WIDTH * 4], ==, 0xaa);
+		}
+	}
+
+	/* The multi-threaded conversion of a random scene matches the single-threaded one */
+	for (i = 0; i < COLOR_WIDTH * COLOR_HEIGHT; i++)
+		pixels[i] = g_random_int_range (0, 4096);
+	_pack_pixels (ARV_PIXEL_FORMAT_BAYER_GB_12P, pixels, COLOR_WIDTH * COLOR_HEIGHT, buffer->priv->data);
+
+	for (i = 0; i < G_N_ELEMENTS (flags); i++) {
+		g_assert_true (arv_buffer_convert_full (buffer, ARV_PIXEL_FORMAT_RGB_8_PACKED, reference, 0,
+							flags[i] & ~ARV_BUFFER_CONVERT_FLAGS_MULTI_THREADED, &error));
+		g_assert_true (arv_buffer_convert_full (buffer, ARV_PIXEL_FORMAT_RGB_8_PACKED, output, 0,
+							flags[i] | ARV_BUFFER_CONVERT_FLAGS_MULTI_THREADED, &error));
+		g_assert_no_error (error);
+		g_assert_true (memcmp (reference, output, COLOR_WIDTH * COLOR_HEIGHT * 3) == 0);
+	}
+
+	/* RGB to YUV 4:2:2 and back, with pixel pairs sharing their colour */
+	for (i = 0; i < COLOR_WIDTH * COLOR_HEIGHT * 3; i++)
+		reference[i] = reference[i - i % 6 + i % 3];
+
+	g_object_unref (buffer);
+	buffer = arv_buffer_new_image (ARV_PIXEL_FORMAT_RGB_8_PACKED, COLOR_WIDTH, COLOR_HEIGHT,
+				       COLOR_WIDTH * COLOR_HEIGHT * 3, reference);
+	yuv_buffer = arv_buffer_new_image (ARV_PIXEL_FORMAT_YUV_422_YUYV_PACKED, COLOR_WIDTH, COLOR_HEIGHT,
+					   COLOR_WIDTH * COLOR_HEIGHT * 2, yuv);
+
+	g_assert_true (arv_buffer_convert (buffer, ARV_PIXEL_FORMAT_YUV_422_YUYV_PACKED, yuv, 0, &error));
+	g_assert_true (arv_buffer_convert (yuv_buffer, ARV_PIXEL_FORMAT_RGB_8_PACKED, output, 0, &error));
+	g_assert_no_error (error);
+
+	for (i = 0; i < COLOR_WIDTH * COLOR_HEIGHT * 3; i++) {
+		/* Limited range quantization */
+		g_assert_cmpint (ABS (output[i] - reference[i]), <=, 4);
+	}
+
+	g_object_unref (yuv_buffer);
+	g_object_unref (buffer);
+
+	buffer = arv_buffer_new_image (ARV_PIXEL_FORMAT_RGB_8_PACKED, 3, 2, 18, NULL);
+	g_assert_false (arv_buffer_convert (buffer, ARV_PIXEL_FORMAT_YUV_422_PACKED, yuv, 0, &error));
+	g_assert_error (error, ARV_BUFFER_ERROR, ARV_BUFFER_ERROR_UNSUPPORTED_CONVERSION);
+	g_clear_error (&error);
+	g_object_unref (buffer);
+
+	g_free (yuv);
+	g_free (reference);
+	g_free (output);
+	g_free (pixels);
+}
+
+typedef struct {
+	guint n_allocs;
+	guint n_frees;
+	gboolean destroyed;
+} AllocatorCounts;
+
+static void *
+test_alloc (size_t size, void *user_data)
+{
+	((AllocatorCounts *) user_data)->n_allocs++;
+
+	return g_malloc (size);
+}
+
+static void
+test_free (void *data, size_t size, void *user_data)
+{
+	((AllocatorCounts *) user_data)->n_frees++;
+
+	g_free (data);
+}
+
+static void *
+test_map (void *data, size_t size, void *user_data)
+{
+	return (char *) data + 1;
+}
+
+static void
+test_allocator_destroy (void *user_data)
+{
+	((AllocatorCounts *) user_data)->destroyed = TRUE;
+}
+
+static void
+custom_allocator (void)
+{
+	static const ArvBufferAllocatorFuncs funcs = { test_alloc, test_free, test_map };
+	AllocatorCounts counts = {0};
+	ArvBufferAllocator *allocator;
+	ArvBuffer *buffer;
+	const void *data;
+	GError *error = NULL;
+
+	allocator = arv_buffer_allocator_new (&funcs, &counts, test_allocator_destroy);
+	g_assert (ARV_IS_BUFFER_ALLOCATOR (allocator));
+
+	buffer = arv_buffer_new_from_allocator (allocator, 1024);
+	g_assert (ARV_IS_BUFFER (buffer));
+	g_assert_cmpint (counts.n_allocs, ==, 1);
+	g_assert_cmpint (arv_buffer_allocator_get_n_allocated_bytes (allocator), ==, 1024);
+
+	data = arv_buffer_get_data (buffer, NULL);
+	g_assert (arv_buffer_get_device_data (buffer) == (const char *) data + 1);
+
+	/* Growing the buffer reallocates its data from the allocator */
+	g_assert (arv_buffer_set_size (buffer, 4096));
+	g_assert_cmpint (counts.n_allocs, ==, 2);
+	g_assert_cmpint (counts.n_frees, ==, 1);
+	g_assert_cmpint (arv_buffer_allocator_get_n_allocated_bytes (allocator), ==, 4096);
+	data = arv_buffer_get_data (buffer, NULL);
+	g_assert (arv_buffer_get_device_data (buffer) == (const char *) data + 1);
+
+	/* The buffers keep a reference on their allocator */
+	g_object_unref (allocator);
+	g_assert (!counts.destroyed);
+
+	g_object_unref (buffer);
+	g_assert_cmpint (counts.n_frees, ==, 2);
+	g_assert (counts.destroyed);
+
+	allocator = arv_buffer_allocator_new_cuda (ARV_BUFFER_ALLOCATOR_CUDA_MEMORY_MAPPED, 0, &error);
+	if (!ARAVIS_HAS_CUDA) {
+		g_assert (allocator == NULL);
+		g_assert_error (error, ARV_BUFFER_ERROR, ARV_BUFFER_ERROR_ALLOCATOR_NOT_AVAILABLE);
+	}
+	g_clear_error (&error);
+	g_clear_object (&allocator);
+
+	buffer = arv_buffer_new_allocate (16);
+	g_assert (arv_buffer_get_device_data (buffer) == NULL);
+	g_object_unref (buffer);
+}
+
+static void
+missing_ranges (void)
+{
+	ArvBuffer *buffer;
+	const ArvBufferMissingRange *ranges;
+	guint n_ranges;
+
+	buffer = arv_buffer_new_image (ARV_PIXEL_FORMAT_MONO_8, 100, 10, 1000, NULL);
+	g_assert (arv_buffer_get_missing_ranges (buffer, &n_ranges) == NULL);
+	g_assert_cmpint (n_ranges, ==, 0);
+
+	buffer->priv->status = ARV_BUFFER_STATUS_MISSING_PACKETS;
+	arv_buffer_clear_missing_ranges (buffer);
+	arv_buffer_append_missing_range (buffer, 150, 100);
+	/* Adjacent ranges are merged */
+	arv_buffer_append_missing_range (buffer, 250, 50);
+	arv_buffer_append_missing_range (buffer, 900, 100);
+
+	ranges = arv_buffer_get_missing_ranges (buffer, &n_ranges);
+	g_assert (ranges != NULL);
+	g_assert_cmpint (n_ranges, ==, 2);
+	g_assert_cmpint (ranges[0].offset, ==, 150);
+	g_assert_cmpint (ranges[0].size, ==, 150);
+	g_assert_cmpint (ranges[0].first_row, ==, 1);
+	g_assert_cmpint (ranges[0].n_rows, ==, 2);
+	g_assert_cmpint (ranges[1].offset, ==, 900);
+	g_assert_cmpint (ranges[1].first_row, ==, 9);
+	g_assert_cmpint (ranges[1].n_rows, ==, 1);
+
+	/* Only incomplete buffers have missing ranges */
+	buffer->priv->status = ARV_BUFFER_STATUS_SUCCESS;
+	g_assert (arv_buffer_get_missing_ranges (buffer, NULL) == NULL);
+
+	g_object_unref (buffer);
+}
+
+static void
+parts (void)
+{
+	ArvBuffer *buffer;
+	const guint8 *data;
+	size_t size;
+	gint x, y, width, height;
+
+	buffer = arv_buffer_new (1024, NULL);
+	g_assert_cmpint (arv_buffer_get_n_parts (buffer), ==, 0);
+	g_object_unref (buffer);
+
+	buffer = arv_buffer_new_image (ARV_PIXEL_FORMAT_MONO_8, 32, 16, 512, NULL);
+	g_assert_cmpint (arv_buffer_get_n_parts (buffer), ==, 1);
+	g_assert (arv_buffer_get_part_data (buffer, 0, &size) == arv_buffer_get_data (buffer, NULL));
+	g_assert_cmpint (size, ==, 512);
+	g_assert_cmpint (arv_buffer_get_part_data_type (buffer, 0), ==, ARV_BUFFER_PART_DATA_TYPE_2D_IMAGE);
+	g_assert_cmpint (arv_buffer_get_part_pixel_format (buffer, 0), ==, ARV_PIXEL_FORMAT_MONO_8);
+	arv_buffer_get_part_region (buffer, 0, NULL, NULL, &width, &height);
+	g_assert_cmpint (width, ==, 32);
+	g_assert_cmpint (height, ==, 16);
+	g_object_unref (buffer);
+
+	buffer = arv_buffer_new (1024, NULL);
+	buffer->priv->payload_type = ARV_BUFFER_PAYLOAD_TYPE_MULTIPART;
+	arv_buffer_set_n_parts (buffer, 2);
+	buffer->priv->parts[0].data_offset = 0;
+	buffer->priv->parts[0].size = 512;
+	buffer->priv->parts[0].data_type = ARV_BUFFER_PART_DATA_TYPE_2D_IMAGE;
+	buffer->priv->parts[0].pixel_format = ARV_PIXEL_FORMAT_MONO_8;
+	buffer->priv->parts[0].width = 32;
+	buffer->priv->parts[0].height = 16;
+	buffer->priv->parts[1].data_offset = 512;
+	buffer->priv->parts[1].size = 256;
+	buffer->priv->parts[1].data_type = ARV_BUFFER_PART_DATA_TYPE_CONFIDENCE_MAP;
+	buffer->priv->parts[1].pixel_format = ARV_PIXEL_FORMAT_MONO_8;
+	buffer->priv->parts[1].x_offset = 8;
+	buffer->priv->parts[1].y_offset = 4;
+	buffer->priv->parts[1].width = 16;
+	buffer->priv->parts[1].height = 16;
+
+	data = arv_buffer_get_data (buffer, NULL);
+
+	g_assert_cmpint (arv_buffer_get_n_parts (buffer), ==, 2);
+	g_assert (arv_buffer_get_part_data (buffer, 0, &size) == data);
+	g_assert_cmpint (size, ==, 512);
+	g_assert (arv_buffer_get_part_data (buffer, 1, &size) == data + 512);
+	g_assert_cmpint (size, ==, 256);
+	g_assert_cmpint (arv_buffer_get_part_data_type (buffer, 1), ==, ARV_BUFFER_PART_DATA_TYPE_CONFIDENCE_MAP);
+	arv_buffer_get_part_region (buffer, 1, &x, &y, &width, &height);
+	g_assert_cmpint (x, ==, 8);
+	g_assert_cmpint (y, ==, 4);
+	g_assert_cmpint (width, ==, 16);
+	g_assert_cmpint (height, ==, 16);
+
+	g_object_unref (buffer);
+}
+
+static void
+set_size (void)
+{
+	ArvBuffer *buffer;
+	const void *data;
+	char preallocated[256];
+	size_t size;
+
+	buffer = arv_buffer_new_allocate (1024);
+	data = arv_buffer_get_data (buffer, NULL);
+	g_assert_cmpint (arv_buffer_get_capacity (buffer), ==, 1024);
+
+	/* The memory is kept up to the capacity */
+	g_assert (arv_buffer_set_size (buffer, 512));
+	g_assert (arv_buffer_get_data (buffer, &size) == data);
+	g_assert_cmpint (size, ==, 512);
+	g_assert_cmpint (arv_buffer_get_capacity (buffer), ==, 1024);
+	g_assert_cmpint (arv_buffer_get_received_size (buffer), ==, 512);
+
+	g_assert (arv_buffer_set_size (buffer, 1024));
+	g_assert (arv_buffer_get_data (buffer, &size) == data);
+	g_assert_cmpint (size, ==, 1024);
+
+	g_assert (arv_buffer_set_size (buffer, 2048));
+	arv_buffer_get_data (buffer, &size);
+	g_assert_cmpint (size, ==, 2048);
+	g_assert_cmpint (arv_buffer_get_capacity (buffer), ==, 2048);
+
+	g_object_unref (buffer);
+
+	buffer = arv_buffer_new (sizeof (preallocated), preallocated);
+	g_assert (arv_buffer_set_size (buffer, 128));
+	g_assert (!arv_buffer_set_size (buffer, 512));
+	g_assert (arv_buffer_get_data (buffer, &size) == preallocated);
+	g_assert_cmpint (size, ==, 128);
+	g_object_unref (buffer);
+
+	buffer = arv_buffer_new_allocate_full (1000, ARV_BUFFER_ALLOCATION_FLAGS_NONE, 4096);
+	g_assert_cmpint (arv_buffer_get_capacity (buffer), >=, 1000);
+	g_assert (arv_buffer_set_size (buffer, arv_buffer_get_capacity (buffer)));
+	g_assert (!arv_buffer_set_size (buffer, arv_buffer_get_capacity (buffer) + 1));
+	g_object_unref (buffer);
+}
+
+static void
+data_bytes (void)
+{
+	static const struct {
+		ArvPixelFormat pixel_format;
+		gboolean has_layout;
+		guint n_channels;
+		guint bytes_per_channel;
+	} layouts[] = {
+		{ARV_PIXEL_FORMAT_MONO_8,		TRUE,	1, 1},
+		{ARV_PIXEL_FORMAT_MONO_12,		TRUE,	1, 2},
+		{ARV_PIXEL_FORMAT_BAYER_RG_8,		TRUE,	1, 1},
+		{ARV_PIXEL_FORMAT_RGB_8_PACKED,		TRUE,	3, 1},
+		{ARV_PIXEL_FORMAT_BGRA_8_PACKED,	TRUE,	4, 1},
+		{ARV_PIXEL_FORMAT_YUV_422_PACKED,	TRUE,	2, 1},
+		{ARV_PIXEL_FORMAT_MONO_12_PACKED,	FALSE,	0, 0},
+		{ARV_PIXEL_FORMAT_RGB_8_PLANAR,		FALSE,	0, 0}
+	};
+	ArvBuffer *buffer;
+	GBytes *bytes;
+	guint n_channels;
+	guint bytes_per_channel;
+	size_t stride;
+	unsigned i;
+
+	buffer = arv_buffer_new_allocate (1024);
+
+	/* The bytes keep the buffer alive, without copy */
+	bytes = arv_buffer_get_data_bytes (buffer);
+	g_assert (g_bytes_get_data (bytes, NULL) == arv_buffer_get_data (buffer, NULL));
+	g_assert_cmpint (g_bytes_get_size (bytes), ==, 1024);
+	g_assert_cmpint (G_OBJECT (buffer)->ref_count, ==, 2);
+
+	g_assert (!arv_buffer_get_image_layout (buffer, &n_channels, NULL, NULL));
+
+	buffer->priv->payload_type = ARV_BUFFER_PAYLOAD_TYPE_IMAGE;
+	buffer->priv->width = 16;
+	buffer->priv->height = 8;
+
+	for (i = 0; i < G_N_ELEMENTS (layouts); i++) {
+		buffer->priv->pixel_format = layouts[i].pixel_format;
+
+		g_assert_cmpint (arv_buffer_get_image_layout (buffer, &n_channels, &bytes_per_channel, &stride),
+				 ==, layouts[i].has_layout);
+		g_assert_cmpint (n_channels, ==, layouts[i].n_channels);
+		g_assert_cmpint (bytes_per_channel, ==, layouts[i].bytes_per_channel);
+		g_assert_cmpint (stride, ==, 16 * layouts[i].n_channels * layouts[i].bytes_per_channel);
+	}
+
+	g_object_unref (buffer);
+	g_bytes_unref (bytes);
+}
+
+static void
+image_statistics (void)
+{
+	static const struct {
+		ArvPixelFormat pixel_format;
+		guint depth;
+	} formats[] = {
+		{ARV_PIXEL_FORMAT_MONO_8,		8},
+		{ARV_PIXEL_FORMAT_MONO_12,		12},
+		{ARV_PIXEL_FORMAT_MONO_16,		16},
+		{ARV_PIXEL_FORMAT_MONO_10_PACKED,	10},
+		{ARV_PIXEL_FORMAT_BAYER_RG_12_PACKED,	12},
+		{ARV_PIXEL_FORMAT_MONO_10P,		10},
+		{ARV_PIXEL_FORMAT_MONO_12P,		12}
+	};
+	static const ArvConvertSimd simds[] = {
+		ARV_CONVERT_SIMD_NONE,
+		ARV_CONVERT_SIMD_SSE4_1,
+		ARV_CONVERT_SIMD_AVX2,
+		ARV_CONVERT_SIMD_NEON
+	};
+	static const guint subsamplings[] = {1, 2, 5};
+	guint16 pixels[CONVERT_WIDTH * CONVERT_HEIGHT];
+	guint64 histogram[64];
+	guint64 expected[64];
+	ArvImageStatistics statistics;
+	ArvConvertSimd default_simd;
+	ArvBuffer *buffer;
+	GError *error = NULL;
+	guint i, j, k, l, x, y;
+
+	default_simd = arv_convert_get_simd ();
+
+	buffer = arv_buffer_new (CONVERT_WIDTH * CONVERT_HEIGHT * 2, NULL);
+	buffer->priv->payload_type = ARV_BUFFER_PAYLOAD_TYPE_IMAGE;
+	buffer->priv->status = ARV_BUFFER_STATUS_SUCCESS;
+	buffer->priv->width = CONVERT_WIDTH;
+	buffer->priv->height = CONVERT_HEIGHT;
+
+	for (i = 0; i < G_N_ELEMENTS (formats); i++) {
+		guint max_value = (1 << formats[i].depth) - 1;
+
+		for (j = 0; j < G_N_ELEMENTS (pixels); j++)
+			pixels[j] = j % 11 == 0 ? max_value : g_random_int_range (0, max_value + 1);
+
+		buffer->priv->pixel_format = formats[i].pixel_format;
+		_pack_pixels (formats[i].pixel_format, pixels, G_N_ELEMENTS (pixels), buffer->priv->data);
+
+		for (k = 0; k < G_N_ELEMENTS (simds); k++) {
+			if (!arv_convert_set_simd (simds[k]))
+				continue;
+
+			for (l = 0; l < G_N_ELEMENTS (subsamplings); l++) {
+				guint64 n_samples = 0;
+				guint64 n_saturated = 0;
+				guint64 sum = 0;
+
+				/* Region 3,1 30x5 */
+				memset (expected, 0, sizeof (expected));
+				for (y = 1; y < 6; y += subsamplings[l]) {
+					for (x = 3; x < 33; x += subsamplings[l]) {
+						guint16 pixel = pixels[y * CONVERT_WIDTH + x];
+
+						expected[pixel >> (formats[i].depth - 6)]++;
+						sum += pixel;
+						n_saturated += pixel == max_value;
+						n_samples++;
+					}
+				}
+
+				g_assert_true (arv_buffer_compute_histogram (buffer, 3, 1, 30, 5, subsamplings[l],
+									     histogram, 64, &error));
+				g_assert_no_error (error);
+				g_assert_cmpmem (histogram, sizeof (histogram), expected, sizeof (expected));
+
+				g_assert_true (arv_buffer_compute_statistics (buffer, 3, 1, 30, 5, subsamplings[l],
+									      &statistics, &error));
+				g_assert_no_error (error);
+				g_assert_cmpint (statistics.n_samples, ==, n_samples);
+				g_assert_cmpint (statistics.depth, ==, formats[i].depth);
+				g_assert_cmpfloat_with_epsilon (statistics.mean,
+								(double) sum / n_samples / max_value, 1e-9);
+				g_assert_cmpfloat_with_epsilon (statistics.saturation_ratio,
+								(double) n_saturated / n_samples, 1e-9);
+			}
+		}
+	}
+
+	arv_convert_set_simd (default_simd);
+
+	/* Whole image, constant values */
+	buffer->priv->pixel_format = ARV_PIXEL_FORMAT_MONO_8;
+	memset (buffer->priv->data, 64, CONVERT_WIDTH * CONVERT_HEIGHT);
+
+	g_assert_true (arv_buffer_compute_statistics (buffer, 0, 0, 0, 0, 1, &statistics, &error));
+	g_assert_no_error (error);
+	g_assert_cmpint (statistics.n_samples, ==, CONVERT_WIDTH * CONVERT_HEIGHT);
+	g_assert_cmpint (statistics.histogram[64], ==, CONVERT_WIDTH * CONVERT_HEIGHT);
+	g_assert_cmpfloat (statistics.saturation_ratio, ==, 0.0);
+	g_assert_cmpfloat (arv_image_statistics_get_percentile (&statistics, 50.0), ==, 65.0 / 256.0);
+	g_assert_cmpfloat (arv_image_statistics_get_percentile (&statistics, 100.0), ==, 65.0 / 256.0);
+
+	g_assert_false (arv_buffer_compute_histogram (buffer, 30, 0, 10, 0, 1, histogram, 64, &error));
+	g_assert_error (error, ARV_BUFFER_ERROR, ARV_BUFFER_ERROR_INVALID_REGION);
+	g_clear_error (&error);
+
+	buffer->priv->status = ARV_BUFFER_STATUS_MISSING_PACKETS;
+	g_assert_false (arv_buffer_compute_statistics (buffer, 0, 0, 0, 0, 1, &statistics, &error));
+	g_assert_error (error, ARV_BUFFER_ERROR, ARV_BUFFER_ERROR_INVALID_PAYLOAD);
+	g_clear_error (&error);
+
+	g_object_unref (buffer);
+}
+
 int
 main (int argc, char *argv[])
 {
@@ -125,6 +850,16 @@ main (int argc, char *argv[])
 	g_test_add_func ("/buffer/full-buffer", full_buffer_test);
 	g_test_add_func ("/buffer/timestamp", timestamp);
 	g_test_add_func ("/buffer/allocate", allocate);
+	g_test_add_func ("/buffer/allocate-numa", allocate_numa);
+	g_test_add_func ("/buffer/allocate-full", allocate_full);
+	g_test_add_func ("/buffer/allocator", custom_allocator);
+	g_test_add_func ("/buffer/parts", parts);
+	g_test_add_func ("/buffer/missing-ranges", missing_ranges);
+	g_test_add_func ("/buffer/set-size", set_size);
+	g_test_add_func ("/buffer/data-bytes", data_bytes);
+	g_test_add_func ("/buffer/convert", convert);
+	g_test_add_func ("/buffer/convert-color", convert_color);
+	g_test_add_func ("/buffer/image-statistics", image_statistics);
 
 	result = g_test_run();
 
@@ -0,0 +1,106 @@
+#include <arv.hpp>
+
+static void
+camera_error_test (void)
+{
+	bool thrown = false;
+
+	try {
+		arv::Camera camera ("Unknown");
+	} catch (const arv::Error &error) {
+		thrown = true;
+		g_assert_true (error.domain () == ARV_DEVICE_ERROR);
+	}
+
+	g_assert_true (thrown);
+}
+
+static void
+frames_test (void)
+{
+	arv::Camera camera ("Fake_1");
+	arv::Stream stream = camera.create_stream ();
+	std::size_t payload = camera.payload ();
+	unsigned n_frames = 0;
+	gint n_input_buffers;
+	gint n_output_buffers;
+
+	g_assert_true (bool (stream));
+
+	stream.allocate_buffers (3, payload);
+
+	camera.set_acquisition_mode (ARV_ACQUISITION_MODE_CONTINUOUS);
+	camera.start_acquisition ();
+
+	for (arv::Buffer &buffer : stream.frames (std::chrono::seconds (1))) {
+		arv::ImageView<std::uint8_t> image = buffer.image<std::uint8_t> ();
+
+		g_assert_true (buffer.is_complete ());
+		g_assert_cmpint (buffer.data ().size (), ==, payload);
+		g_assert_true (buffer.pixel_format () == ARV_PIXEL_FORMAT_MONO_8);
+
+		g_assert_true (bool (image));
+		g_assert_cmpint (image.n_channels (), ==, 1);
+		g_assert_cmpint (image.width (), ==, buffer.width ());
+		g_assert_cmpint (image.row (0).size (), ==, buffer.width ());
+		g_assert_true (&image.at (0, 1) == &image.row (1)[0]);
+
+		g_assert_false (bool (buffer.image<std::uint16_t> ()));
+
+		if (++n_frames == 5)
+			break;
+	}
+
+	camera.stop_acquisition ();
+
+	g_assert_cmpint (n_frames, ==, 5);
+
+	/* Every popped buffer went back to the stream */
+	arv_stream_get_n_buffers (stream.get (), &n_input_buffers, &n_output_buffers);
+	g_assert_cmpint (n_input_buffers + n_output_buffers, ==, 3);
+}
+
+static void
+move_buffer_test (void)
+{
+	arv::Buffer buffer = arv::Buffer::allocate (16);
+	arv::Buffer moved;
+	ArvBuffer *arv_buffer;
+
+	g_assert_true (bool (buffer));
+	g_assert_cmpint (buffer.data ().size (), ==, 16);
+
+	moved = std::move (buffer);
+	g_assert_false (bool (buffer));
+	g_assert_true (bool (moved));
+
+	arv_buffer = moved.release ();
+	g_assert_false (bool (moved));
+	g_assert_true (ARV_IS_BUFFER (arv_buffer));
+
+	g_object_unref (arv_buffer);
+}
+
+int
+main (int argc, char *argv[])
+{
+	int result;
+
+	g_test_init (&argc, &argv, NULL);
+
+	arv_set_fake_camera_genicam_filename (GENICAM_FILENAME);
+
+	arv_enable_interface ("Fake");
+
+	arv_update_device_list ();
+
+	g_test_add_func ("/cpp/camera-error", camera_error_test);
+	g_test_add_func ("/cpp/frames", frames_test);
+	g_test_add_func ("/cpp/move-buffer", move_buffer_test);
+
+	result = g_test_run();
+
+	arv_shutdown ();
+
+	return result;
+}
@@ -191,6 +191,52 @@ set_int64_variable_test (void)
 	g_object_unref (evaluator);
 }
 
+static void
+variable_slot_test (void)
+{
+	ArvEvaluator *evaluator;
+	GError *error = NULL;
+	gint slot_a;
+	gint slot_b;
+	gint64 v_int64;
+	double v_double;
+
+	evaluator = arv_evaluator_new ("A*10+B");
+
+	slot_a = arv_evaluator_get_variable_slot (evaluator, "A");
+	slot_b = arv_evaluator_get_variable_slot (evaluator, "B");
+	g_assert_cmpint (slot_a, >=, 0);
+	g_assert_cmpint (slot_b, >=, 0);
+	g_assert_cmpint (slot_a, !=, slot_b);
+	g_assert_cmpint (arv_evaluator_get_variable_slot (evaluator, "A"), ==, slot_a);
+
+	/* B is not set yet */
+	arv_evaluator_set_int64_variable_by_slot (evaluator, slot_a, 2);
+	arv_evaluator_evaluate_as_int64 (evaluator, &error);
+	g_assert (error != NULL);
+	g_clear_error (&error);
+
+	arv_evaluator_set_int64_variable_by_slot (evaluator, slot_b, 3);
+	v_int64 = arv_evaluator_evaluate_as_int64 (evaluator, &error);
+	g_assert_cmpint (v_int64, ==, 23);
+	g_assert (error == NULL);
+
+	/* Setting by name and by slot address the same variable */
+	arv_evaluator_set_int64_variable (evaluator, "A", 4);
+	v_int64 = arv_evaluator_evaluate_as_int64 (evaluator, &error);
+	g_assert_cmpint (v_int64, ==, 43);
+	g_assert (error == NULL);
+
+	/* Slots survive an expression change */
+	arv_evaluator_set_expression (evaluator, "A+B/2");
+	arv_evaluator_set_double_variable_by_slot (evaluator, slot_b, 1.0);
+	v_double = arv_evaluator_evaluate_as_double (evaluator, &error);
+	g_assert_cmpfloat (v_double, ==, 4.5);
+	g_assert (error == NULL);
+
+	g_object_unref (evaluator);
+}
+
 static void
 sub_expression_test (void)
 {
@@ -267,6 +313,151 @@ constant_test (void)
 	g_object_unref (evaluator);
 }
 
+static void
+constant_folding_test (void)
+{
+	ArvEvaluator *evaluator;
+	GError *error = NULL;
+	gint64 v_int64;
+	double v_double;
+
+	evaluator = arv_evaluator_new ("(2 + 3) * X + 10 / 4");
+
+	arv_evaluator_set_int64_variable (evaluator, "X", 2);
+	v_int64 = arv_evaluator_evaluate_as_int64 (evaluator, &error);
+	g_assert_cmpint (v_int64, ==, 12);
+	g_assert (error == NULL);
+
+	v_double = arv_evaluator_evaluate_as_double (evaluator, &error);
+	g_assert_cmpfloat (v_double, ==, 12.5);
+	g_assert (error == NULL);
+
+	arv_evaluator_set_int64_variable (evaluator, "X", 3);
+	v_int64 = arv_evaluator_evaluate_as_int64 (evaluator, &error);
+	g_assert_cmpint (v_int64, ==, 17);
+	g_assert (error == NULL);
+
+	arv_evaluator_set_expression (evaluator, "X + 1 / 0");
+	arv_evaluator_evaluate_as_int64 (evaluator, &error);
+	g_assert (error != NULL);
+	g_clear_error (&error);
+
+	g_object_unref (evaluator);
+}
+
+/* Hot programs are compiled after a few evaluations, the compiled evaluations must match the interpreted ones */
+
+#define COMPILATION_N_EVALUATIONS	32
+
+static const char *compilation_expressions[] = {
+	"A*B+C",
+	"(A<<8)|B",
+	"A/B",
+	"A%B",
+	"A-B*C>=0?A:-B",
+	"(A>B)&&(B<C)||(A=C)",
+	"~A^B&C",
+	"A**2+SQRT(ABS(B))",
+	"ROUND(A/3,2)",
+	"COS(A)+FLOOR(B/2)",
+	"NEG(A)+ +C"
+};
+
+static void
+compilation_test (void)
+{
+	const struct {
+		gboolean is_double;
+		double a, b, c;
+	} values[] = {
+		{ FALSE, 3, 7, -2 },
+		{ TRUE, 3.5, 7.25, -2.0 },
+		{ FALSE, 100, 0, 5 },
+		{ TRUE, -0.5, 0.0, 1e10 }
+	};
+	guint i, j, k;
+
+	for (i = 0; i < G_N_ELEMENTS (compilation_expressions); i++) {
+		for (j = 0; j < G_N_ELEMENTS (values); j++) {
+			ArvEvaluator *evaluator;
+			GError *int64_error = NULL;
+			GError *double_error = NULL;
+			gint64 v_int64;
+			double v_double;
+
+			evaluator = arv_evaluator_new (compilation_expressions[i]);
+
+			if (values[j].is_double) {
+				arv_evaluator_set_double_variable (evaluator, "A", values[j].a);
+				arv_evaluator_set_double_variable (evaluator, "B", values[j].b);
+				arv_evaluator_set_double_variable (evaluator, "C", values[j].c);
+			} else {
+				arv_evaluator_set_int64_variable (evaluator, "A", values[j].a);
+				arv_evaluator_set_int64_variable (evaluator, "B", values[j].b);
+				arv_evaluator_set_int64_variable (evaluator, "C", values[j].c);
+			}
+
+			/* First evaluations are interpreted */
+			v_int64 = arv_evaluator_evaluate_as_int64 (evaluator, &int64_error);
+			v_double = arv_evaluator_evaluate_as_double (evaluator, &double_error);
+
+			for (k = 0; k < COMPILATION_N_EVALUATIONS; k++) {
+				GError *error = NULL;
+
+				g_assert_cmpint (arv_evaluator_evaluate_as_int64 (evaluator, &error), ==, v_int64);
+				g_assert ((error != NULL) == (int64_error != NULL));
+				g_clear_error (&error);
+
+				if (isnan (v_double))
+					g_assert (isnan (arv_evaluator_evaluate_as_double (evaluator, &error)));
+				else
+					g_assert_cmpfloat (arv_evaluator_evaluate_as_double (evaluator, &error), ==,
+							   v_double);
+				g_assert ((error != NULL) == (double_error != NULL));
+				g_clear_error (&error);
+			}
+
+			g_clear_error (&int64_error);
+			g_clear_error (&double_error);
+
+			g_object_unref (evaluator);
+		}
+	}
+}
+
+static void
+compilation_variable_test (void)
+{
+	ArvEvaluator *evaluator;
+	GError *error = NULL;
+	guint i;
+
+	evaluator = arv_evaluator_new ("A*B+C");
+
+	arv_evaluator_set_int64_variable (evaluator, "A", 2);
+	arv_evaluator_set_int64_variable (evaluator, "B", 3);
+	arv_evaluator_set_int64_variable (evaluator, "C", 1);
+	for (i = 0; i < COMPILATION_N_EVALUATIONS; i++)
+		g_assert_cmpfloat (arv_evaluator_evaluate_as_double (evaluator, NULL), ==, 7.0);
+
+	/* Variable updates and type changes are seen by the compiled program */
+	arv_evaluator_set_double_variable (evaluator, "B", 0.5);
+	g_assert_cmpfloat (arv_evaluator_evaluate_as_double (evaluator, NULL), ==, 2.0);
+	arv_evaluator_set_int64_variable (evaluator, "C", -4);
+	g_assert_cmpfloat (arv_evaluator_evaluate_as_double (evaluator, NULL), ==, -3.0);
+
+	arv_evaluator_set_expression (evaluator, "A/B");
+	for (i = 0; i < COMPILATION_N_EVALUATIONS; i++)
+		g_assert_cmpfloat (arv_evaluator_evaluate_as_double (evaluator, NULL), ==, 4.0);
+
+	arv_evaluator_set_int64_variable (evaluator, "B", 0);
+	arv_evaluator_evaluate_as_double (evaluator, &error);
+	g_assert (error != NULL);
+	g_clear_error (&error);
+
+	g_object_unref (evaluator);
+}
+
 static void
 empty_test (void)
 {
@@ -339,8 +530,12 @@ main (int argc, char *argv[])
 	g_test_add_func ("/evaluator/set-get-expression", set_get_expression_test);
 	g_test_add_func ("/evaluator/double-variable", set_double_variable_test);
 	g_test_add_func ("/evaluator/int64-variable", set_int64_variable_test);
+	g_test_add_func ("/evaluator/variable-slot", variable_slot_test);
 	g_test_add_func ("/evaluator/sub-expression", sub_expression_test);
 	g_test_add_func ("/evaluator/constant", constant_test);
+	g_test_add_func ("/evaluator/constant-folding", constant_folding_test);
+	g_test_add_func ("/evaluator/compilation", compilation_test);
+	g_test_add_func ("/evaluator/compilation-variable", compilation_variable_test);
 	g_test_add_func ("/evaluator/empty", empty_test);
 	g_test_add_func ("/evaluator/error", error_test);
 
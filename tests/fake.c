@@ -1,5 +1,13 @@
 #include <glib.h>
+#include <glib/gstdio.h>
 #include <arv.h>
+#include <string.h>
+
+#define ARAVIS_COMPILATION
+#include "../src/arvframerecorderprivate.h"
+#include "../src/arvframelogprivate.h"
+#include "../src/arvgcregisternodeprivate.h"
+#include "../src/arvbufferprivate.h"
 
 static void
 trigger_registers_test (void)
@@ -40,6 +48,176 @@ trigger_registers_test (void)
 	g_object_unref (device);
 }
 
+static void
+selector_sweep_test (void)
+{
+	ArvDevice *device;
+	ArvGc *genicam;
+	ArvGcNode *node;
+	GValue values[2] = {G_VALUE_INIT, G_VALUE_INIT};
+	GError *error = NULL;
+	const gint64 selector_values[2] = {0, 1};
+	guint64 n_reads, n_reads_before;
+	gboolean success;
+	gint64 value;
+
+	device = arv_fake_device_new ("TEST0", &error);
+	g_assert (ARV_IS_FAKE_DEVICE (device));
+	g_assert_no_error (error);
+
+	genicam = arv_device_get_genicam (device);
+	node = arv_gc_get_node (genicam, "TriggerModeRegister");
+	g_assert (ARV_IS_GC_REGISTER_NODE (node));
+
+	arv_device_set_string_feature_value (device, "TriggerSelector", "AcquisitionStart", &error);
+	g_assert_no_error (error);
+	arv_device_set_string_feature_value (device, "TriggerMode", "On", &error);
+	g_assert_no_error (error);
+	arv_device_set_string_feature_value (device, "TriggerSelector", "FrameStart", &error);
+	g_assert_no_error (error);
+	arv_device_set_string_feature_value (device, "TriggerMode", "Off", &error);
+	g_assert_no_error (error);
+
+	/* Register indexed by the selector, read in one access */
+	arv_gc_register_node_get_statistics (ARV_GC_REGISTER_NODE (node), &n_reads_before, NULL, NULL, NULL, NULL);
+	success = arv_device_read_feature_for_selectors (device, "TriggerModeRegister", "TriggerSelectorInteger",
+							 selector_values, 2, values, &error);
+	g_assert_no_error (error);
+	g_assert_true (success);
+	arv_gc_register_node_get_statistics (ARV_GC_REGISTER_NODE (node), &n_reads, NULL, NULL, NULL, NULL);
+	g_assert_cmpint (n_reads, ==, n_reads_before + 1);
+	g_assert_cmpint (g_value_get_int64 (&values[0]), ==, 0);
+	g_assert_cmpint (g_value_get_int64 (&values[1]), ==, 1);
+	g_value_unset (&values[0]);
+	g_value_unset (&values[1]);
+
+	/* Enumeration over an enumeration selector */
+	success = arv_device_read_feature_for_selectors (device, "TriggerMode", "TriggerSelector",
+							 selector_values, 2, values, &error);
+	g_assert_no_error (error);
+	g_assert_true (success);
+	g_assert_cmpstr (g_value_get_string (&values[0]), ==, "Off");
+	g_assert_cmpstr (g_value_get_string (&values[1]), ==, "On");
+	g_value_unset (&values[0]);
+	g_value_unset (&values[1]);
+
+	value = arv_device_get_integer_feature_value (device, "TriggerSelectorInteger", &error);
+	g_assert_no_error (error);
+	g_assert_cmpint (value, ==, 0);
+
+	/* Not indexed, read in a selector loop, and the selector is restored */
+	arv_device_set_string_feature_value (device, "TriggerSelector", "AcquisitionStart", &error);
+	g_assert_no_error (error);
+	success = arv_device_read_feature_for_selectors (device, "GainRaw", "TriggerSelector",
+							 selector_values, 2, values, &error);
+	g_assert_no_error (error);
+	g_assert_true (success);
+	g_assert_cmpint (g_value_get_int64 (&values[0]), ==, g_value_get_int64 (&values[1]));
+	g_value_unset (&values[0]);
+	g_value_unset (&values[1]);
+
+	value = arv_device_get_integer_feature_value (device, "TriggerSelectorInteger", &error);
+	g_assert_no_error (error);
+	g_assert_cmpint (value, ==, 1);
+
+	success = arv_device_read_feature_for_selectors (device, "Unknown", "TriggerSelector",
+							 selector_values, 2, values, &error);
+	g_assert_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_FEATURE_NOT_FOUND);
+	g_assert_false (success);
+	g_clear_error (&error);
+
+	g_object_unref (device);
+}
+
+static void
+lut_upload_test (void)
+{
+	ArvDevice *device;
+	ArvGc *genicam;
+	ArvGcNode *node;
+	GValue values[ARV_FAKE_CAMERA_LUT_SIZE] = {G_VALUE_INIT};
+	GError *error = NULL;
+	gint64 indexes[ARV_FAKE_CAMERA_LUT_SIZE];
+	gint64 lut[ARV_FAKE_CAMERA_LUT_SIZE];
+	const gint64 selector_values[2] = {0, 1};
+	const gint64 gains[2] = {3, 7};
+	guint64 n_writes, n_writes_before;
+	gboolean success;
+	guint32 raw;
+	gint64 value;
+	guint i;
+
+	device = arv_fake_device_new ("TEST0", &error);
+	g_assert (ARV_IS_FAKE_DEVICE (device));
+	g_assert_no_error (error);
+
+	genicam = arv_device_get_genicam (device);
+	node = arv_gc_get_node (genicam, "LUTValueRegister");
+	g_assert (ARV_IS_GC_REGISTER_NODE (node));
+
+	for (i = 0; i < ARV_FAKE_CAMERA_LUT_SIZE; i++) {
+		indexes[i] = i;
+		lut[i] = 4095 - 16 * i;
+	}
+
+	arv_device_set_integer_feature_value (device, "LUTIndex", 10, &error);
+	g_assert_no_error (error);
+
+	/* The whole table is written at once */
+	arv_gc_register_node_get_statistics (ARV_GC_REGISTER_NODE (node), NULL, &n_writes_before, NULL, NULL, NULL);
+	success = arv_device_set_integer_feature_for_selectors (device, "LUTValue", "LUTIndex",
+								indexes, ARV_FAKE_CAMERA_LUT_SIZE, lut, &error);
+	g_assert_no_error (error);
+	g_assert_true (success);
+	arv_gc_register_node_get_statistics (ARV_GC_REGISTER_NODE (node), NULL, &n_writes, NULL, NULL, NULL);
+	g_assert_cmpint (n_writes, ==, n_writes_before + 1);
+
+	value = arv_device_get_integer_feature_value (device, "LUTIndex", &error);
+	g_assert_no_error (error);
+	g_assert_cmpint (value, ==, 10);
+	value = arv_device_get_integer_feature_value (device, "LUTValue", &error);
+	g_assert_no_error (error);
+	g_assert_cmpint (value, ==, lut[10]);
+
+	g_assert_true (arv_device_read_memory (device, ARV_FAKE_CAMERA_REGISTER_LUT_VALUE + 4 * 255, sizeof (raw),
+					       &raw, &error));
+	g_assert_no_error (error);
+	g_assert_cmpint (GUINT32_FROM_BE (raw), ==, lut[255]);
+
+	success = arv_device_read_feature_for_selectors (device, "LUTValue", "LUTIndex",
+							 indexes, ARV_FAKE_CAMERA_LUT_SIZE, values, &error);
+	g_assert_no_error (error);
+	g_assert_true (success);
+	for (i = 0; i < ARV_FAKE_CAMERA_LUT_SIZE; i++) {
+		g_assert_cmpint (g_value_get_int64 (&values[i]), ==, lut[i]);
+		g_value_unset (&values[i]);
+	}
+
+	/* Out of range values are rejected before anything is written */
+	lut[20] = 5000;
+	success = arv_device_set_integer_feature_for_selectors (device, "LUTValue", "LUTIndex",
+								indexes, ARV_FAKE_CAMERA_LUT_SIZE, lut, &error);
+	g_assert_error (error, ARV_GC_ERROR, ARV_GC_ERROR_OUT_OF_RANGE);
+	g_assert_false (success);
+	g_clear_error (&error);
+
+	/* Not indexed, written in a selector loop, and the selector is restored */
+	arv_device_set_string_feature_value (device, "TriggerSelector", "AcquisitionStart", &error);
+	g_assert_no_error (error);
+	success = arv_device_set_integer_feature_for_selectors (device, "GainRaw", "TriggerSelector",
+								selector_values, 2, gains, &error);
+	g_assert_no_error (error);
+	g_assert_true (success);
+	value = arv_device_get_integer_feature_value (device, "GainRaw", &error);
+	g_assert_no_error (error);
+	g_assert_cmpint (value, ==, 7);
+	value = arv_device_get_integer_feature_value (device, "TriggerSelectorInteger", &error);
+	g_assert_no_error (error);
+	g_assert_cmpint (value, ==, 1);
+
+	g_object_unref (device);
+}
+
 static void
 registers_test (void)
 {
@@ -154,6 +332,59 @@ registers_test (void)
 	g_object_unref (device);
 }
 
+static void
+register_fields_test (void)
+{
+	const char *features[] = {"TestRegister", "StructEntry_0_15", "StructEntry_16_31"};
+	gint64 values[] = {0x0, 0xabcd, 0x0102};
+	const char *out_of_range_features[] = {"StructEntry_0_15", "StructEntry_15"};
+	gint64 out_of_range_values[] = {0x1234, 0xff};
+	ArvDevice *device;
+	ArvGc *genicam;
+	ArvGcNode *node;
+	ArvDomNode *struct_register;
+	GError *error = NULL;
+	guint64 n_writes;
+	guint64 n_reads;
+	gboolean success;
+
+	device = arv_fake_device_new ("TEST0", &error);
+	g_assert (ARV_IS_FAKE_DEVICE (device));
+	g_assert (error == NULL);
+
+	genicam = arv_device_get_genicam (device);
+	arv_gc_set_range_check_policy (genicam, ARV_RANGE_CHECK_POLICY_ENABLE);
+
+	node = arv_gc_get_node (genicam, "TestRegister");
+	g_assert (ARV_IS_GC_INTEGER (node));
+
+	struct_register = arv_dom_node_get_parent_node (ARV_DOM_NODE (arv_gc_get_node (genicam, "StructEntry_0_15")));
+	g_assert (ARV_IS_GC_REGISTER_NODE (struct_register));
+
+	/* The two fields are written together, with a single read-modify-write */
+	success = arv_device_set_integer_feature_values (device, G_N_ELEMENTS (features), features, values, &error);
+	g_assert (success);
+	g_assert (error == NULL);
+
+	arv_gc_register_node_get_statistics (ARV_GC_REGISTER_NODE (struct_register), &n_reads, &n_writes,
+					     NULL, NULL, NULL);
+	g_assert_cmpint (n_reads, ==, 1);
+	g_assert_cmpint (n_writes, ==, 1);
+
+	g_assert_cmpint (arv_gc_integer_get_value (ARV_GC_INTEGER (node), NULL), ==, 0xabcd0102);
+
+	/* Nothing is written if a value is out of range */
+	success = arv_device_set_integer_feature_values (device, G_N_ELEMENTS (out_of_range_features),
+							 out_of_range_features, out_of_range_values, &error);
+	g_assert (!success);
+	g_assert_error (error, ARV_GC_ERROR, ARV_GC_ERROR_OUT_OF_RANGE);
+	g_clear_error (&error);
+
+	g_assert_cmpint (arv_gc_integer_get_value (ARV_GC_INTEGER (node), NULL), ==, 0xabcd0102);
+
+	g_object_unref (device);
+}
+
 static void
 fake_device_test (void)
 {
@@ -341,6 +572,15 @@ fake_stream_test (void)
 	g_assert_cmpint (n_failures, ==, 0);
 	g_assert_cmpint (n_underruns, ==, 0);
 
+	g_assert_cmpint (arv_stream_get_n_infos (stream), >=, 3);
+	g_assert_cmpstr (arv_stream_get_info_name (stream, 0), ==, "n_completed_buffers");
+	g_assert (arv_stream_get_info_type (stream, 0) == G_TYPE_UINT64);
+	g_assert_cmpint (arv_stream_get_info_uint64 (stream, 0), ==, 1);
+	g_assert_cmpfloat (arv_stream_get_info_double (stream, 0), ==, 1.0);
+	g_assert_cmpint (arv_stream_get_info_uint64_by_name (stream, "n_failures"), ==, 0);
+	g_assert_cmpint (arv_stream_get_info_uint64_by_name (stream, "unknown"), ==, 0);
+	g_assert (arv_stream_get_info_name (stream, arv_stream_get_n_infos (stream)) == NULL);
+
 	arv_stream_get_n_buffers (stream, &n_input_buffers, &n_output_buffers);
 	g_assert_cmpint (n_input_buffers, ==, 0);
 	g_assert_cmpint (n_output_buffers, ==, 0);
@@ -351,156 +591,1201 @@ fake_stream_test (void)
 }
 
 static void
-camera_api_test (void)
+fill_mode_test (void)
+{
+	ArvFakeCamera *fake_camera;
+	ArvBuffer *buffers[ARV_FAKE_CAMERA_N_TEMPLATES + 1];
+	const void *first_data;
+	const void *last_data;
+	size_t payload;
+	size_t size;
+	gint counter = 0;
+	unsigned int i;
+
+	fake_camera = arv_fake_camera_new ("TEST0");
+	g_assert (ARV_IS_FAKE_CAMERA (fake_camera));
+
+	g_assert (arv_fake_camera_get_fill_mode (fake_camera) == ARV_FAKE_CAMERA_FILL_MODE_PATTERN);
+
+	payload = arv_fake_camera_get_payload (fake_camera);
+	for (i = 0; i < G_N_ELEMENTS (buffers); i++)
+		buffers[i] = arv_buffer_new (payload, NULL);
+
+	/* Templates are rendered once */
+	arv_fake_camera_set_fill_pattern (fake_camera, fill_pattern_cb, &counter);
+	arv_fake_camera_set_fill_mode (fake_camera, ARV_FAKE_CAMERA_FILL_MODE_TEMPLATE);
+	for (i = 0; i < 2 * ARV_FAKE_CAMERA_N_TEMPLATES; i++)
+		arv_fake_camera_fill_buffer (fake_camera, buffers[0], NULL);
+	g_assert_cmpint (counter, ==, ARV_FAKE_CAMERA_N_TEMPLATES);
+
+	/* Constant mode doesn't call the fill pattern */
+	arv_fake_camera_set_fill_mode (fake_camera, ARV_FAKE_CAMERA_FILL_MODE_CONSTANT);
+	arv_fake_camera_fill_buffer (fake_camera, buffers[0], NULL);
+	g_assert_cmpint (counter, ==, ARV_FAKE_CAMERA_N_TEMPLATES);
+	g_assert (arv_buffer_get_status (buffers[0]) == ARV_BUFFER_STATUS_SUCCESS);
+
+	/* Template frames are replayed in turn */
+	arv_fake_camera_set_fill_pattern (fake_camera, NULL, NULL);
+	arv_fake_camera_set_fill_mode (fake_camera, ARV_FAKE_CAMERA_FILL_MODE_TEMPLATE);
+	for (i = 0; i < G_N_ELEMENTS (buffers); i++)
+		arv_fake_camera_fill_buffer (fake_camera, buffers[i], NULL);
+
+	first_data = arv_buffer_get_data (buffers[0], &size);
+	g_assert_cmpint (size, ==, payload);
+	last_data = arv_buffer_get_data (buffers[ARV_FAKE_CAMERA_N_TEMPLATES], NULL);
+	g_assert (memcmp (first_data, last_data, payload) == 0);
+	g_assert (memcmp (first_data, arv_buffer_get_data (buffers[1], NULL), payload) != 0);
+	g_assert_cmpint (arv_buffer_get_frame_id (buffers[0]), !=,
+			 arv_buffer_get_frame_id (buffers[ARV_FAKE_CAMERA_N_TEMPLATES]));
+
+	for (i = 0; i < G_N_ELEMENTS (buffers); i++)
+		g_object_unref (buffers[i]);
+
+	g_object_unref (fake_camera);
+}
+
+static void
+lock_free_queues_test (void)
 {
 	ArvCamera *camera;
-	ArvPixelFormat pixel_format;
+	ArvStream *stream;
+	ArvBuffer *buffer;
 	GError *error = NULL;
-	int x, y, w, h;
-	const char *string;
-	void *ptr;
-	unsigned int n;
-	gboolean b;
-	double d;
+	gboolean lock_free_queues = FALSE;
+	gint n_input_buffers;
+	gint n_output_buffers;
+	gint payload;
+	unsigned i;
 
 	camera = arv_camera_new ("Fake_1", &error);
 	g_assert (ARV_IS_CAMERA (camera));
 	g_assert (error == NULL);
 
-	string = arv_camera_get_vendor_name (camera, &error);
+	stream = arv_camera_create_stream (camera, NULL, NULL, &error);
+	g_assert (ARV_IS_STREAM (stream));
 	g_assert (error == NULL);
-	g_assert (string != NULL);
 
-	string = arv_camera_get_model_name (camera, &error);
-	g_assert (error == NULL);
-	g_assert (string != NULL);
+	g_object_set (stream, "lock-free-queues", TRUE, NULL);
+	g_object_get (stream, "lock-free-queues", &lock_free_queues, NULL);
+	g_assert (lock_free_queues);
 
-	string = arv_camera_get_device_id (camera, &error);
-	g_assert (error == NULL);
-	g_assert (string != NULL);
+	payload = arv_camera_get_payload (camera, NULL);
+	for (i = 0; i < 3; i++)
+		arv_stream_push_buffer (stream,  arv_buffer_new (payload, NULL));
 
-	arv_camera_get_region (camera, &x, &y, &w, &h, &error);
-	g_assert (error == NULL);
-	g_assert_cmpint (x, ==, 0);
-	g_assert_cmpint (y, ==, 0);
-	g_assert_cmpint (w, ==, ARV_FAKE_CAMERA_WIDTH_DEFAULT);
-	g_assert_cmpint (h, ==, ARV_FAKE_CAMERA_HEIGHT_DEFAULT);
+	arv_stream_get_n_buffers (stream, &n_input_buffers, &n_output_buffers);
+	g_assert_cmpint (n_input_buffers + n_output_buffers, <=, 3);
 
-	arv_camera_get_sensor_size (camera, &w, &h, &error);
-	g_assert (error == NULL);
-	g_assert_cmpint (w, ==, ARV_FAKE_CAMERA_SENSOR_WIDTH);
-	g_assert_cmpint (h, ==, ARV_FAKE_CAMERA_SENSOR_HEIGHT);
+	arv_camera_set_acquisition_mode (camera, ARV_ACQUISITION_MODE_CONTINUOUS, NULL);
+	arv_camera_start_acquisition (camera, NULL);
+	for (i = 0; i < 10; i++) {
+		buffer = arv_stream_timeout_pop_buffer (stream, 1000000);
+		g_assert (ARV_IS_BUFFER (buffer));
+		arv_stream_push_buffer (stream, buffer);
+	}
+	arv_camera_stop_acquisition (camera, NULL);
 
-	arv_camera_set_region (camera, 10, 20, 30, 40, &error);
-	g_assert (error == NULL);
-	arv_camera_get_region (camera, &x, &y, &w, &h, &error);
-	g_assert (error == NULL);
-	g_assert_cmpint (x, ==, 10);
-	g_assert_cmpint (y, ==, 20);
-	g_assert_cmpint (w, ==, 30);
-	g_assert_cmpint (h, ==, 40);
+	g_clear_object (&stream);
+	g_clear_object (&camera);
+}
 
-	arv_camera_get_binning (camera, &x, &y, &error);
-	g_assert (error == NULL);
-	g_assert_cmpint (x, ==, ARV_FAKE_CAMERA_BINNING_HORIZONTAL_DEFAULT);
-	g_assert_cmpint (y, ==, ARV_FAKE_CAMERA_BINNING_VERTICAL_DEFAULT);
+static void
+pop_buffers_test (void)
+{
+	ArvCamera *camera;
+	ArvStream *stream;
+	ArvBuffer *buffers[4];
+	GError *error = NULL;
+	gint payload;
+	guint n_buffers;
+	guint n_received = 0;
+	unsigned i;
 
-	arv_camera_set_binning (camera, 2, 4, &error);
-	g_assert (error == NULL);
-	arv_camera_get_binning (camera, &x, &y, &error);
+	camera = arv_camera_new ("Fake_1", &error);
+	g_assert (ARV_IS_CAMERA (camera));
 	g_assert (error == NULL);
-	g_assert_cmpint (x, ==, 2);
-	g_assert_cmpint (y, ==, 4);
 
-	b = arv_camera_is_binning_available (camera, &error);
+	stream = arv_camera_create_stream (camera, NULL, NULL, &error);
+	g_assert (ARV_IS_STREAM (stream));
 	g_assert (error == NULL);
-	g_assert (b);
 
-	pixel_format = arv_camera_get_pixel_format (camera, &error);
-	g_assert (error == NULL);
-	g_assert_cmpint (pixel_format, ==, ARV_PIXEL_FORMAT_MONO_8);
+	payload = arv_camera_get_payload (camera, NULL);
+	for (i = 0; i < G_N_ELEMENTS (buffers); i++)
+		buffers[i] = arv_buffer_new (payload, NULL);
+	arv_stream_push_buffers (stream, buffers, G_N_ELEMENTS (buffers));
 
-	arv_camera_set_pixel_format (camera, ARV_PIXEL_FORMAT_RGB_8_PACKED, &error);
-	g_assert (error == NULL);
-	pixel_format = arv_camera_get_pixel_format (camera, &error);
-	g_assert (error == NULL);
-	g_assert_cmpint (pixel_format, ==, ARV_PIXEL_FORMAT_RGB_8_PACKED);
+	g_assert_cmpint (arv_stream_pop_buffers (stream, buffers, G_N_ELEMENTS (buffers), 0), ==, 0);
 
-	string = arv_camera_get_pixel_format_as_string (camera, &error);
-	g_assert (error == NULL);
-	g_assert_cmpstr (string, ==, "RGB8");
+	arv_camera_set_acquisition_mode (camera, ARV_ACQUISITION_MODE_CONTINUOUS, NULL);
+	arv_camera_start_acquisition (camera, NULL);
+	while (n_received < 10) {
+		n_buffers = arv_stream_pop_buffers (stream, buffers, G_N_ELEMENTS (buffers), 1000000);
+		g_assert_cmpint (n_buffers, >, 0);
+		g_assert_cmpint (n_buffers, <=, G_N_ELEMENTS (buffers));
+		for (i = 0; i < n_buffers; i++)
+			g_assert (ARV_IS_BUFFER (buffers[i]));
+		n_received += n_buffers;
+		arv_stream_push_buffers (stream, buffers, n_buffers);
+	}
+	arv_camera_stop_acquisition (camera, NULL);
 
-	arv_camera_set_pixel_format (camera, ARV_PIXEL_FORMAT_BAYER_BG_8, &error);
-	g_assert (error == NULL);
-	pixel_format = arv_camera_get_pixel_format (camera, &error);
-	g_assert (error == NULL);
-	g_assert_cmpint (pixel_format, ==, ARV_PIXEL_FORMAT_BAYER_BG_8);
+	g_clear_object (&stream);
+	g_clear_object (&camera);
+}
 
-	string = arv_camera_get_pixel_format_as_string (camera, &error);
-	g_assert (error == NULL);
-	g_assert_cmpstr (string, ==, "BayerBG8");
+static void
+mailbox_test (void)
+{
+	ArvCamera *camera;
+	ArvStream *stream;
+	ArvBuffer *buffer;
+	GError *error = NULL;
+	gint n_output_buffers;
+	gint payload;
+	unsigned i;
 
-	arv_camera_set_pixel_format (camera, ARV_PIXEL_FORMAT_BAYER_GB_8, &error);
-	g_assert (error == NULL);
-	pixel_format = arv_camera_get_pixel_format (camera, &error);
+	camera = arv_camera_new ("Fake_1", &error);
+	g_assert (ARV_IS_CAMERA (camera));
 	g_assert (error == NULL);
-	g_assert_cmpint (pixel_format, ==, ARV_PIXEL_FORMAT_BAYER_GB_8);
 
-	string = arv_camera_get_pixel_format_as_string (camera, &error);
+	stream = arv_camera_create_stream (camera, NULL, NULL, &error);
+	g_assert (ARV_IS_STREAM (stream));
 	g_assert (error == NULL);
-	g_assert_cmpstr (string, ==, "BayerGB8");
 
-	arv_camera_set_pixel_format (camera, ARV_PIXEL_FORMAT_BAYER_GR_8, &error);
-	g_assert (error == NULL);
-	pixel_format = arv_camera_get_pixel_format (camera, &error);
-	g_assert (error == NULL);
-	g_assert_cmpint (pixel_format, ==, ARV_PIXEL_FORMAT_BAYER_GR_8);
+	g_object_set (stream, "mailbox", TRUE, NULL);
 
-	string = arv_camera_get_pixel_format_as_string (camera, &error);
-	g_assert (error == NULL);
-	g_assert_cmpstr (string, ==, "BayerGR8");
+	payload = arv_camera_get_payload (camera, NULL);
+	for (i = 0; i < 3; i++)
+		arv_stream_push_buffer (stream,  arv_buffer_new (payload, NULL));
 
-	arv_camera_set_pixel_format (camera, ARV_PIXEL_FORMAT_BAYER_RG_8, &error);
-	g_assert (error == NULL);
-	pixel_format = arv_camera_get_pixel_format (camera, &error);
-	g_assert (error == NULL);
-	g_assert_cmpint (pixel_format, ==, ARV_PIXEL_FORMAT_BAYER_RG_8);
+	arv_camera_set_frame_rate (camera, 100.0, NULL);
+	arv_camera_set_acquisition_mode (camera, ARV_ACQUISITION_MODE_CONTINUOUS, NULL);
+	arv_camera_start_acquisition (camera, NULL);
 
-	string = arv_camera_get_pixel_format_as_string (camera, &error);
-	g_assert (error == NULL);
-	g_assert_cmpstr (string, ==, "BayerRG8");
+	/* Stall the consumer */
+	g_usleep (500000);
 
-	arv_camera_set_pixel_format_from_string (camera, "Mono8", &error);
-	g_assert (error == NULL);
-	pixel_format = arv_camera_get_pixel_format (camera, &error);
-	g_assert (error == NULL);
-	g_assert_cmpint (pixel_format, ==, ARV_PIXEL_FORMAT_MONO_8);
+	arv_stream_get_n_buffers (stream, NULL, &n_output_buffers);
+	g_assert_cmpint (n_output_buffers, <=, 1);
+	g_assert_cmpint (arv_stream_get_n_dropped_buffers (stream), >, 0);
 
-	ptr = arv_camera_dup_available_pixel_formats (camera, &n, &error);
-	g_assert (error == NULL);
-	g_assert (ptr != NULL);
-	g_assert_cmpint (n, ==, 7);
-	g_clear_pointer (&ptr, g_free);
+	buffer = arv_stream_timeout_pop_buffer (stream, 1000000);
+	g_assert (ARV_IS_BUFFER (buffer));
+	arv_stream_push_buffer (stream, buffer);
 
-	ptr = arv_camera_dup_available_pixel_formats_as_strings (camera, &n, &error);
-	g_assert (error == NULL);
-	g_assert (ptr != NULL);
-	g_assert_cmpint (n, ==, 7);
-	g_clear_pointer (&ptr, g_free);
+	arv_camera_stop_acquisition (camera, NULL);
 
-	ptr = arv_camera_dup_available_pixel_formats_as_display_names (camera, &n, &error);
-	g_assert (error == NULL);
-	g_assert (ptr != NULL);
-	g_assert_cmpint (n, ==, 7);
-	g_clear_pointer (&ptr, g_free);
+	g_clear_object (&stream);
+	g_clear_object (&camera);
+}
 
-	b = arv_camera_is_frame_rate_available (camera, &error);
-	g_assert (error == NULL);
-	g_assert (b);
+static void
+max_age_test (void)
+{
+	ArvCamera *camera;
+	ArvStream *stream;
+	ArvBuffer *buffer;
+	GError *error = NULL;
+	gint n_input_buffers;
+	gint n_output_buffers;
+	guint max_age;
+	gint payload;
+	unsigned i;
 
-	d = arv_camera_get_frame_rate (camera, &error);
+	camera = arv_camera_new ("Fake_1", &error);
+	g_assert (ARV_IS_CAMERA (camera));
 	g_assert (error == NULL);
-	g_assert_cmpfloat (d, ==, ARV_FAKE_CAMERA_ACQUISITION_FRAME_RATE_DEFAULT);
+
+	stream = arv_camera_create_stream (camera, NULL, NULL, &error);
+	g_assert (ARV_IS_STREAM (stream));
+	g_assert (error == NULL);
+
+	g_object_set (stream, "max-age", 30000, NULL);
+	g_object_get (stream, "max-age", &max_age, NULL);
+	g_assert_cmpuint (max_age, ==, 30000);
+
+	payload = arv_camera_get_payload (camera, NULL);
+	for (i = 0; i < 10; i++)
+		arv_stream_push_buffer (stream,  arv_buffer_new (payload, NULL));
+
+	arv_camera_set_frame_rate (camera, 100.0, NULL);
+	arv_camera_set_acquisition_mode (camera, ARV_ACQUISITION_MODE_CONTINUOUS, NULL);
+	arv_camera_start_acquisition (camera, NULL);
+
+	/* Stall the consumer, the expired buffers are recycled by the stream thread */
+	g_usleep (500000);
+
+	arv_stream_get_n_buffers (stream, &n_input_buffers, &n_output_buffers);
+	g_assert_cmpint (n_output_buffers, <, 10);
+	g_assert_cmpuint (arv_stream_get_info_uint64_by_name (stream, "n_expired_buffers"), >, 0);
+
+	buffer = arv_stream_timeout_pop_buffer (stream, 1000000);
+	g_assert (ARV_IS_BUFFER (buffer));
+	arv_stream_push_buffer (stream, buffer);
+
+	arv_camera_stop_acquisition (camera, NULL);
+	arv_stream_pause (stream);
+
+	/* All the remaining output buffers are now too old */
+	g_usleep (100000);
+
+	g_assert (arv_stream_try_pop_buffer (stream) == NULL);
+	g_assert (arv_stream_timeout_pop_buffer (stream, 10000) == NULL);
+
+	arv_stream_get_n_buffers (stream, &n_input_buffers, &n_output_buffers);
+	g_assert_cmpint (n_output_buffers, ==, 0);
+	g_assert_cmpint (n_input_buffers, ==, 10);
+
+	g_clear_object (&stream);
+	g_clear_object (&camera);
+}
+
+static void
+output_fd_test (void)
+{
+	ArvCamera *camera;
+	ArvStream *stream;
+	ArvBuffer *buffer;
+	GError *error = NULL;
+	GPollFD poll_fd;
+	gint payload;
+	unsigned i;
+
+	camera = arv_camera_new ("Fake_1", &error);
+	g_assert (ARV_IS_CAMERA (camera));
+	g_assert (error == NULL);
+
+	stream = arv_camera_create_stream (camera, NULL, NULL, &error);
+	g_assert (ARV_IS_STREAM (stream));
+	g_assert (error == NULL);
+
+	poll_fd.fd = arv_stream_get_output_fd (stream);
+	poll_fd.events = G_IO_IN;
+	g_assert_cmpint (poll_fd.fd, >=, 0);
+	g_assert_cmpint (arv_stream_get_output_fd (stream), ==, poll_fd.fd);
+
+	g_assert_cmpint (g_poll (&poll_fd, 1, 0), ==, 0);
+
+	payload = arv_camera_get_payload (camera, NULL);
+	for (i = 0; i < 3; i++)
+		arv_stream_push_buffer (stream,  arv_buffer_new (payload, NULL));
+
+	arv_camera_set_frame_rate (camera, 50.0, NULL);
+	arv_camera_set_acquisition_mode (camera, ARV_ACQUISITION_MODE_CONTINUOUS, NULL);
+	arv_camera_start_acquisition (camera, NULL);
+
+	g_assert_cmpint (g_poll (&poll_fd, 1, 1000), ==, 1);
+	g_assert (poll_fd.revents & G_IO_IN);
+
+	arv_camera_stop_acquisition (camera, NULL);
+	arv_stream_stop_thread (stream, FALSE);
+
+	while ((buffer = arv_stream_try_pop_buffer (stream)) != NULL)
+		g_object_unref (buffer);
+
+	/* Empty output queue */
+	g_assert_cmpint (g_poll (&poll_fd, 1, 0), ==, 0);
+
+	g_clear_object (&stream);
+	g_clear_object (&camera);
+}
+
+static void
+pop_spin_test (void)
+{
+	ArvCamera *camera;
+	ArvStream *stream;
+	ArvBuffer *buffer;
+	GError *error = NULL;
+	guint spin_time;
+	gint payload;
+	unsigned i;
+
+	camera = arv_camera_new ("Fake_1", &error);
+	g_assert (ARV_IS_CAMERA (camera));
+	g_assert (error == NULL);
+
+	stream = arv_camera_create_stream (camera, NULL, NULL, &error);
+	g_assert (ARV_IS_STREAM (stream));
+	g_assert (error == NULL);
+
+	g_object_set (stream, "pop-spin-time", 100000, NULL);
+	g_object_get (stream, "pop-spin-time", &spin_time, NULL);
+	g_assert_cmpint (spin_time, ==, 100000);
+
+	/* Nothing to pop, the spin is bounded by the timeout */
+	g_assert (arv_stream_timeout_pop_buffer (stream, 10000) == NULL);
+	g_assert_cmpint (arv_stream_get_info_uint64_by_name (stream, "n_pop_spin_misses"), ==, 1);
+	g_assert_cmpint (arv_stream_get_info_uint64_by_name (stream, "n_pop_spin_hits"), ==, 0);
+
+	payload = arv_camera_get_payload (camera, NULL);
+	for (i = 0; i < 3; i++)
+		arv_stream_push_buffer (stream,  arv_buffer_new (payload, NULL));
+
+	arv_camera_set_frame_rate (camera, 50.0, NULL);
+	arv_camera_set_acquisition_mode (camera, ARV_ACQUISITION_MODE_CONTINUOUS, NULL);
+	arv_camera_start_acquisition (camera, NULL);
+
+	for (i = 0; i < 5; i++) {
+		buffer = arv_stream_timeout_pop_buffer (stream, 1000000);
+		g_assert (ARV_IS_BUFFER (buffer));
+		arv_stream_push_buffer (stream, buffer);
+	}
+
+	arv_camera_stop_acquisition (camera, NULL);
+
+	g_assert_cmpint (arv_stream_get_info_uint64_by_name (stream, "n_pop_spin_hits") +
+			 arv_stream_get_info_uint64_by_name (stream, "n_pop_spin_misses"), >=, 6);
+	g_assert_cmpint (arv_stream_get_info_uint64_by_name (stream, "n_pop_spin_hits"), >, 0);
+
+	g_clear_object (&stream);
+	g_clear_object (&camera);
+}
+
+static void
+burst_test (void)
+{
+	ArvCamera *camera;
+	ArvCameraFrameSettings settings[2] = {{1000.0, 1.0}, {4000.0, -1.0}};
+	GPtrArray *buffers;
+	GError *error = NULL;
+	ArvBuffer *first_buffer;
+	guint i;
+
+	camera = arv_camera_new ("Fake_1", &error);
+	g_assert (ARV_IS_CAMERA (camera));
+	g_assert (error == NULL);
+
+	arv_camera_set_frame_rate (camera, 100.0, NULL);
+
+	buffers = arv_camera_acquire_burst (camera, 3, NULL, 1000000, &error);
+	g_assert_no_error (error);
+	g_assert (buffers != NULL);
+	g_assert_cmpint (buffers->len, ==, 3);
+	for (i = 0; i < buffers->len; i++)
+		g_assert_cmpint (arv_buffer_get_status (g_ptr_array_index (buffers, i)), ==, ARV_BUFFER_STATUS_SUCCESS);
+
+	first_buffer = g_ptr_array_index (buffers, 0);
+	arv_camera_release_burst (camera, buffers);
+
+	/* The released buffers are reused by the following burst */
+	buffers = arv_camera_acquire_burst (camera, 3, NULL, 1000000, &error);
+	g_assert_no_error (error);
+	g_assert (buffers != NULL);
+	g_assert_cmpint (buffers->len, ==, 3);
+	for (i = 0; i < buffers->len && g_ptr_array_index (buffers, i) != first_buffer; i++);
+	g_assert_cmpint (i, <, buffers->len);
+	arv_camera_release_burst (camera, buffers);
+
+	/* The fake camera has no software trigger */
+	buffers = arv_camera_acquire_burst (camera, 2, settings, 1000000, &error);
+	g_assert_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_FEATURE_NOT_FOUND);
+	g_assert (buffers == NULL);
+	g_clear_error (&error);
+
+	g_object_unref (camera);
+}
+
+static void
+_process_func (ArvBuffer *buffer, void *user_data)
+{
+	guint8 *data = (guint8 *) arv_buffer_get_data (buffer, NULL);
+
+	if (arv_buffer_get_status (buffer) == ARV_BUFFER_STATUS_SUCCESS)
+		data[0] = arv_buffer_get_frame_id (buffer) & 0xff;
+
+	g_atomic_int_inc ((gint *) user_data);
+}
+
+static void
+processing_stage_test (void)
+{
+	ArvCamera *camera;
+	ArvStream *stream;
+	ArvBuffer *buffer;
+	GError *error = NULL;
+	gint n_processed_buffers = 0;
+	gint n_buffers = 0;
+	gint64 last_frame_id = -1;
+	gint payload;
+	unsigned i;
+
+	camera = arv_camera_new ("Fake_1", &error);
+	g_assert (ARV_IS_CAMERA (camera));
+	g_assert (error == NULL);
+
+	stream = arv_camera_create_stream (camera, NULL, NULL, &error);
+	g_assert (ARV_IS_STREAM (stream));
+	g_assert (error == NULL);
+
+	arv_camera_set_pixel_format (camera, ARV_PIXEL_FORMAT_MONO_8, NULL);
+	arv_stream_set_processing_stage (stream, _process_func, &n_processed_buffers, NULL, 2,
+					 ARV_STREAM_OVERFLOW_POLICY_BLOCK);
+
+	payload = arv_camera_get_payload (camera, NULL);
+	for (i = 0; i < 5; i++)
+		arv_stream_push_buffer (stream,  arv_buffer_new (payload, NULL));
+
+	arv_camera_set_frame_rate (camera, 50.0, NULL);
+	arv_camera_set_acquisition_mode (camera, ARV_ACQUISITION_MODE_CONTINUOUS, NULL);
+	arv_camera_start_acquisition (camera, NULL);
+
+	for (i = 0; i < 10; i++) {
+		const guint8 *data;
+		guint64 frame_id;
+
+		buffer = arv_stream_timeout_pop_buffer (stream, 1000000);
+		g_assert (ARV_IS_BUFFER (buffer));
+
+		if (arv_buffer_get_status (buffer) == ARV_BUFFER_STATUS_SUCCESS) {
+			/* Buffers are delivered processed, in frame order */
+			frame_id = arv_buffer_get_frame_id (buffer);
+			g_assert_cmpint ((gint64) frame_id, >, last_frame_id);
+			last_frame_id = frame_id;
+
+			data = arv_buffer_get_data (buffer, NULL);
+			g_assert_cmpint (data[0], ==, frame_id & 0xff);
+			n_buffers++;
+		}
+
+		arv_stream_push_buffer (stream, buffer);
+	}
+
+	arv_camera_stop_acquisition (camera, NULL);
+
+	/* Removing the stage flushes it */
+	arv_stream_set_processing_stage (stream, NULL, NULL, NULL, 0, ARV_STREAM_OVERFLOW_POLICY_BLOCK);
+
+	g_assert_cmpint (n_buffers, >, 0);
+	g_assert_cmpint (g_atomic_int_get (&n_processed_buffers), >=, 10);
+
+	g_clear_object (&stream);
+	g_clear_object (&camera);
+}
+
+static void
+_tile_func (ArvBuffer *buffer, guint first_row, guint n_rows, void *user_data)
+{
+	guint8 *data = (guint8 *) arv_buffer_get_data (buffer, NULL);
+	gint width = arv_buffer_get_image_width (buffer);
+
+	/* Tag every processed row with the frame id */
+	memset (data + (size_t) first_row * width, arv_buffer_get_frame_id (buffer) & 0xff, (size_t) n_rows * width);
+
+	g_atomic_int_add ((gint *) user_data, n_rows);
+}
+
+static void
+tile_processing_test (void)
+{
+	ArvCamera *camera;
+	ArvStream *stream;
+	ArvBuffer *buffer;
+	GError *error = NULL;
+	gint n_processed_rows = 0;
+	gint n_buffers = 0;
+	gint64 last_frame_id = -1;
+	gint payload;
+	gint width = 0, height = 0;
+	unsigned i;
+
+	camera = arv_camera_new ("Fake_1", &error);
+	g_assert (ARV_IS_CAMERA (camera));
+	g_assert (error == NULL);
+
+	stream = arv_camera_create_stream (camera, NULL, NULL, &error);
+	g_assert (ARV_IS_STREAM (stream));
+	g_assert (error == NULL);
+
+	arv_camera_set_pixel_format (camera, ARV_PIXEL_FORMAT_MONO_8, NULL);
+	arv_stream_set_tile_processing (stream, _tile_func, &n_processed_rows, NULL, 4, 16, 4);
+
+	payload = arv_camera_get_payload (camera, NULL);
+	for (i = 0; i < 5; i++)
+		arv_stream_push_buffer (stream,  arv_buffer_new (payload, NULL));
+
+	arv_camera_set_frame_rate (camera, 50.0, NULL);
+	arv_camera_set_acquisition_mode (camera, ARV_ACQUISITION_MODE_CONTINUOUS, NULL);
+	arv_camera_start_acquisition (camera, NULL);
+
+	for (i = 0; i < 10; i++) {
+		const guint8 *data;
+		size_t size;
+		guint64 frame_id;
+
+		buffer = arv_stream_timeout_pop_buffer (stream, 1000000);
+		g_assert (ARV_IS_BUFFER (buffer));
+
+		if (arv_buffer_get_status (buffer) == ARV_BUFFER_STATUS_SUCCESS) {
+			/* Buffers are delivered in frame order, with all their rows processed */
+			frame_id = arv_buffer_get_frame_id (buffer);
+			g_assert_cmpint ((gint64) frame_id, >, last_frame_id);
+			last_frame_id = frame_id;
+
+			width = arv_buffer_get_image_width (buffer);
+			height = arv_buffer_get_image_height (buffer);
+			data = arv_buffer_get_data (buffer, &size);
+			g_assert_cmpint (data[0], ==, frame_id & 0xff);
+			g_assert_cmpint (data[(size_t) width * height - 1], ==, frame_id & 0xff);
+			n_buffers++;
+		}
+
+		arv_stream_push_buffer (stream, buffer);
+	}
+
+	arv_camera_stop_acquisition (camera, NULL);
+
+	/* Removing the stage flushes it */
+	arv_stream_set_tile_processing (stream, NULL, NULL, NULL, 0, 0, 0);
+
+	g_assert_cmpint (n_buffers, >, 0);
+	g_assert_cmpint (g_atomic_int_get (&n_processed_rows), >=, n_buffers * height);
+
+	g_clear_object (&stream);
+	g_clear_object (&camera);
+}
+
+static void
+metrics_exporter_test (void)
+{
+	ArvMetricsExporter *exporter;
+	ArvCamera *camera;
+	ArvStream *stream;
+	ArvBuffer *buffer;
+	GSocketClient *client;
+	GSocketConnection *connection;
+	GError *error = NULL;
+	const char *request = "GET /metrics HTTP/1.0\r\n\r\n";
+	char response[4096];
+	gsize size = 0;
+	gssize count;
+	char *metrics;
+
+	camera = arv_camera_new ("Fake_1", &error);
+	g_assert (ARV_IS_CAMERA (camera));
+	g_assert (error == NULL);
+
+	stream = arv_camera_create_stream (camera, NULL, NULL, &error);
+	g_assert (ARV_IS_STREAM (stream));
+	g_assert (error == NULL);
+
+	exporter = arv_metrics_exporter_new (0, &error);
+	g_assert (ARV_IS_METRICS_EXPORTER (exporter));
+	g_assert (error == NULL);
+	g_assert_cmpint (arv_metrics_exporter_get_port (exporter), >, 0);
+
+	arv_metrics_exporter_add_stream (exporter, "fake", stream);
+	arv_metrics_exporter_add_device (exporter, "fake", arv_camera_get_device (camera));
+
+	arv_stream_push_buffer (stream, arv_buffer_new (arv_camera_get_payload (camera, NULL), NULL));
+	arv_camera_set_acquisition_mode (camera, ARV_ACQUISITION_MODE_SINGLE_FRAME, NULL);
+	arv_camera_start_acquisition (camera, NULL);
+	buffer = arv_stream_timeout_pop_buffer (stream, 1000000);
+	g_assert (ARV_IS_BUFFER (buffer));
+	arv_camera_stop_acquisition (camera, NULL);
+
+	metrics = arv_metrics_exporter_render (exporter);
+	g_assert (strstr (metrics, "# TYPE aravis_stream_completed_buffers counter\n") != NULL);
+	g_assert (strstr (metrics, "aravis_stream_completed_buffers_total{stream=\"fake\"} 1\n") != NULL);
+	g_assert (strstr (metrics, "# TYPE aravis_stream_output_queue_dwell_time_us summary\n") != NULL);
+	g_assert (strstr (metrics, "aravis_stream_output_queue_dwell_time_us_count{stream=\"fake\"} 1\n") != NULL);
+	g_assert (g_str_has_suffix (metrics, "# EOF\n"));
+	g_free (metrics);
+
+	client = g_socket_client_new ();
+	connection = g_socket_client_connect_to_host (client, "127.0.0.1",
+						      arv_metrics_exporter_get_port (exporter), NULL, &error);
+	g_assert (G_IS_SOCKET_CONNECTION (connection));
+	g_assert (error == NULL);
+
+	g_assert (g_output_stream_write_all (g_io_stream_get_output_stream (G_IO_STREAM (connection)),
+					     request, strlen (request), NULL, NULL, NULL));
+	while (size < sizeof (response) - 1 &&
+	       (count = g_input_stream_read (g_io_stream_get_input_stream (G_IO_STREAM (connection)),
+					     response + size, sizeof (response) - 1 - size, NULL, NULL)) > 0)
+		size += count;
+	response[size] = '\0';
+
+	g_assert (g_str_has_prefix (response, "HTTP/1.0 200 OK\r\n"));
+	g_assert (strstr (response, "application/openmetrics-text") != NULL);
+	g_assert (g_str_has_suffix (response, "# EOF\n"));
+
+	g_clear_object (&connection);
+	g_clear_object (&client);
+	g_clear_object (&exporter);
+	g_clear_object (&buffer);
+	g_clear_object (&stream);
+	g_clear_object (&camera);
+}
+
+static void
+shared_stream_test (void)
+{
+#if ARAVIS_HAS_SHARED_STREAM
+	ArvStreamPublisher *publisher;
+	ArvStreamSubscriber *subscriber;
+	ArvBuffer *buffer;
+	ArvBuffer *first_buffer;
+	ArvBuffer *last_buffer;
+	GError *error = NULL;
+	const guint8 *data;
+	guint64 n_published;
+	guint64 n_dropped;
+	size_t size;
+	char *name;
+	gint x, y, width, height;
+	guint i;
+
+	name = g_strdup_printf ("test-%08x", g_random_int ());
+
+	publisher = arv_stream_publisher_new (name, 2, 4096, &error);
+	g_assert (ARV_IS_STREAM_PUBLISHER (publisher));
+	g_assert (error == NULL);
+	g_assert_cmpstr (arv_stream_publisher_get_name (publisher), ==, name);
+
+	subscriber = arv_stream_subscriber_new (name, &error);
+	g_assert (ARV_IS_STREAM_SUBSCRIBER (subscriber));
+	g_assert (error == NULL);
+	g_assert (arv_stream_subscriber_try_pop_buffer (subscriber) == NULL);
+
+	buffer = arv_buffer_new_allocate (4096);
+	data = arv_buffer_get_data (buffer, &size);
+	for (i = 0; i < size; i++)
+		((guint8 *) data)[i] = i % 251;
+
+	arv_buffer_set_frame_id (buffer, 1);
+	g_assert (arv_stream_publisher_publish (publisher, buffer));
+
+	first_buffer = arv_stream_subscriber_timeout_pop_buffer (subscriber, 1000000);
+	g_assert (ARV_IS_BUFFER (first_buffer));
+	g_assert_cmpint (arv_buffer_get_frame_id (first_buffer), ==, 1);
+	data = arv_buffer_get_data (first_buffer, &size);
+	g_assert_cmpint (size, ==, 4096);
+	g_assert_cmpint (data[1000], ==, 1000 % 251);
+
+	/* The referenced slot is not overwritten, frames 2 and 3 are replaced by the next ones in the other slot */
+	for (i = 2; i <= 4; i++) {
+		arv_buffer_set_frame_id (buffer, i);
+		g_assert (arv_stream_publisher_publish (publisher, buffer));
+	}
+
+	last_buffer = arv_stream_subscriber_try_pop_buffer (subscriber);
+	g_assert (ARV_IS_BUFFER (last_buffer));
+	g_assert_cmpint (arv_buffer_get_frame_id (last_buffer), ==, 4);
+	g_assert_cmpint (arv_buffer_get_frame_id (first_buffer), ==, 1);
+	g_assert_cmpint (arv_stream_subscriber_get_n_missed_frames (subscriber), ==, 2);
+
+	/* All slots referenced */
+	g_assert (!arv_stream_publisher_publish (publisher, buffer));
+
+	arv_stream_publisher_get_statistics (publisher, &n_published, &n_dropped);
+	g_assert_cmpint (n_published, ==, 4);
+	g_assert_cmpint (n_dropped, ==, 1);
+
+	g_object_unref (first_buffer);
+	g_object_unref (last_buffer);
+	g_object_unref (buffer);
+
+	/* The chunk byte order is published with the data, the chunk trailer being little endian */
+	buffer = arv_buffer_new_allocate (64);
+	data = arv_buffer_get_data (buffer, &size);
+	memset ((void *) data, 0, size);
+	((guint32 *) data)[12] = GUINT32_TO_LE (0x12345678);
+	((guint32 *) data)[14] = GUINT32_TO_LE (0x1234);
+	((guint32 *) data)[15] = GUINT32_TO_LE (8);
+	arv_buffer_set_status (buffer, ARV_BUFFER_STATUS_SUCCESS);
+	arv_buffer_set_payload_type (buffer, ARV_BUFFER_PAYLOAD_TYPE_CHUNK_DATA);
+	arv_buffer_set_chunk_endianness (buffer, G_LITTLE_ENDIAN);
+	g_assert (arv_stream_publisher_publish (publisher, buffer));
+	g_object_unref (buffer);
+
+	buffer = arv_stream_subscriber_try_pop_buffer (subscriber);
+	g_assert (ARV_IS_BUFFER (buffer));
+	g_assert (arv_buffer_has_chunks (buffer));
+	data = arv_buffer_get_chunk_data (buffer, 0x1234, &size);
+	g_assert (data != NULL);
+	g_assert_cmpint (size, ==, 8);
+	g_assert_cmpint (GUINT32_FROM_LE (((const guint32 *) data)[0]), ==, 0x12345678);
+	g_object_unref (buffer);
+
+	/* The parts of a multipart payload are published with the data */
+	buffer = arv_buffer_new_allocate (1024);
+	buffer->priv->status = ARV_BUFFER_STATUS_SUCCESS;
+	buffer->priv->payload_type = ARV_BUFFER_PAYLOAD_TYPE_MULTIPART;
+	arv_buffer_set_n_parts (buffer, 2);
+	buffer->priv->parts[0].data_offset = 0;
+	buffer->priv->parts[0].size = 512;
+	buffer->priv->parts[0].data_type = ARV_BUFFER_PART_DATA_TYPE_2D_IMAGE;
+	buffer->priv->parts[0].pixel_format = ARV_PIXEL_FORMAT_MONO_8;
+	buffer->priv->parts[0].width = 32;
+	buffer->priv->parts[0].height = 16;
+	buffer->priv->parts[1].data_offset = 512;
+	buffer->priv->parts[1].size = 256;
+	buffer->priv->parts[1].data_type = ARV_BUFFER_PART_DATA_TYPE_CONFIDENCE_MAP;
+	buffer->priv->parts[1].pixel_format = ARV_PIXEL_FORMAT_MONO_8;
+	buffer->priv->parts[1].x_offset = 8;
+	buffer->priv->parts[1].y_offset = 4;
+	buffer->priv->parts[1].width = 16;
+	buffer->priv->parts[1].height = 16;
+	g_assert (arv_stream_publisher_publish (publisher, buffer));
+	g_object_unref (buffer);
+
+	buffer = arv_stream_subscriber_try_pop_buffer (subscriber);
+	g_assert (ARV_IS_BUFFER (buffer));
+	g_assert_cmpint (arv_buffer_get_n_parts (buffer), ==, 2);
+	g_assert (arv_buffer_get_part_data (buffer, 1, &size) == (const guint8 *) arv_buffer_get_data (buffer, NULL) + 512);
+	g_assert_cmpint (size, ==, 256);
+	g_assert_cmpint (arv_buffer_get_part_data_type (buffer, 1), ==, ARV_BUFFER_PART_DATA_TYPE_CONFIDENCE_MAP);
+	arv_buffer_get_part_region (buffer, 1, &x, &y, &width, &height);
+	g_assert_cmpint (x, ==, 8);
+	g_assert_cmpint (y, ==, 4);
+	g_assert_cmpint (width, ==, 16);
+	g_assert_cmpint (height, ==, 16);
+	g_object_unref (buffer);
+
+	g_clear_object (&publisher);
+	g_assert (arv_stream_subscriber_is_closed (subscriber));
+	g_assert (arv_stream_subscriber_timeout_pop_buffer (subscriber, 1000000) == NULL);
+
+	g_object_unref (subscriber);
+	g_free (name);
+#endif
+}
+
+static void
+buffer_pool_test (void)
+{
+	ArvCamera *camera;
+	ArvStream *stream;
+	ArvBuffer *buffer;
+	GError *error = NULL;
+	guint pool_size = 0;
+	guint high_water_mark = 0;
+	size_t size;
+	unsigned i;
+
+	camera = arv_camera_new ("Fake_1", &error);
+	g_assert (ARV_IS_CAMERA (camera));
+	g_assert (error == NULL);
+
+	stream = arv_camera_create_stream (camera, NULL, NULL, &error);
+	g_assert (ARV_IS_STREAM (stream));
+	g_assert (error == NULL);
+
+	g_object_set (stream, "pool-min-size", 2, "buffer-pool", TRUE, NULL);
+	g_object_get (stream, "pool-size", &pool_size, NULL);
+	g_assert_cmpint (pool_size, ==, 2);
+
+	arv_camera_set_acquisition_mode (camera, ARV_ACQUISITION_MODE_CONTINUOUS, NULL);
+	arv_camera_start_acquisition (camera, NULL);
+	for (i = 0; i < 10; i++) {
+		buffer = arv_stream_timeout_pop_buffer (stream, 1000000);
+		g_assert (ARV_IS_BUFFER (buffer));
+		g_assert_cmpint (arv_buffer_get_status (buffer), ==, ARV_BUFFER_STATUS_SUCCESS);
+		arv_stream_push_buffer (stream, buffer);
+	}
+	arv_camera_stop_acquisition (camera, NULL);
+
+	g_object_get (stream, "pool-size", &pool_size, "pool-high-water-mark", &high_water_mark, NULL);
+	g_assert_cmpint (pool_size, >=, 2);
+	g_assert_cmpint (high_water_mark, >, 0);
+	g_assert_cmpint (high_water_mark, <=, pool_size);
+
+	/* A smaller payload reuses the pool buffer allocations */
+	arv_camera_set_region (camera, 0, 0, 256, 256, NULL);
+
+	arv_camera_start_acquisition (camera, NULL);
+	buffer = arv_stream_timeout_pop_buffer (stream, 1000000);
+	arv_camera_stop_acquisition (camera, NULL);
+
+	g_assert (ARV_IS_BUFFER (buffer));
+	g_assert_cmpint (arv_buffer_get_status (buffer), ==, ARV_BUFFER_STATUS_SUCCESS);
+	arv_buffer_get_data (buffer, &size);
+	g_assert_cmpint (size, ==, arv_camera_get_payload (camera, NULL));
+	g_assert_cmpint (arv_buffer_get_capacity (buffer), >, size);
+	arv_stream_push_buffer (stream, buffer);
+
+	g_clear_object (&stream);
+	g_clear_object (&camera);
+}
+
+static void
+stream_pause_test (void)
+{
+	ArvCamera *camera;
+	ArvStream *stream;
+	ArvBuffer *buffer;
+	GError *error = NULL;
+	size_t size = 0;
+	guint i;
+
+	camera = arv_camera_new ("Fake_1", &error);
+	g_assert (ARV_IS_CAMERA (camera));
+	g_assert (error == NULL);
+
+	stream = arv_camera_create_stream (camera, NULL, NULL, &error);
+	g_assert (ARV_IS_STREAM (stream));
+	g_assert (error == NULL);
+
+	g_object_set (stream, "buffer-pool", TRUE, NULL);
+
+	arv_camera_set_acquisition_mode (camera, ARV_ACQUISITION_MODE_CONTINUOUS, NULL);
+	arv_camera_start_acquisition (camera, NULL);
+	buffer = arv_stream_timeout_pop_buffer (stream, 1000000);
+	g_assert (ARV_IS_BUFFER (buffer));
+	g_assert_cmpint (arv_buffer_get_status (buffer), ==, ARV_BUFFER_STATUS_SUCCESS);
+	arv_stream_push_buffer (stream, buffer);
+	arv_camera_stop_acquisition (camera, NULL);
+
+	g_assert (!arv_stream_is_paused (stream));
+	arv_stream_pause (stream);
+	g_assert (arv_stream_is_paused (stream));
+
+	/* The stream thread and its buffers survive a change of payload while paused */
+	arv_camera_set_region (camera, 0, 0, 256, 256, NULL);
+
+	arv_stream_resume (stream);
+	g_assert (!arv_stream_is_paused (stream));
+
+	arv_camera_start_acquisition (camera, NULL);
+	for (i = 0; i < 10; i++) {
+		buffer = arv_stream_timeout_pop_buffer (stream, 1000000);
+		g_assert (ARV_IS_BUFFER (buffer));
+		if (arv_buffer_get_status (buffer) == ARV_BUFFER_STATUS_SUCCESS)
+			arv_buffer_get_data (buffer, &size);
+		arv_stream_push_buffer (stream, buffer);
+		if (size == (size_t) arv_camera_get_payload (camera, NULL))
+			break;
+	}
+	arv_camera_stop_acquisition (camera, NULL);
+
+	g_assert_cmpint (size, ==, arv_camera_get_payload (camera, NULL));
+
+	g_clear_object (&stream);
+	g_clear_object (&camera);
+}
+
+static void
+frame_recorder_test (void)
+{
+	ArvFrameRecorder *recorder;
+	ArvCamera *camera;
+	ArvStream *stream;
+	GError *error = NULL;
+	ArvFrameRecordHeader *header;
+	ArvFrameRecordEntry *entries;
+	char *filename;
+	char *contents;
+	gsize length;
+	gint payload;
+	guint64 n_frames;
+	unsigned i;
+	int fd;
+
+	fd = g_file_open_tmp ("arv-frame-record-XXXXXX", &filename, &error);
+	g_assert_no_error (error);
+	g_close (fd, NULL);
+
+	camera = arv_camera_new ("Fake_1", &error);
+	g_assert (ARV_IS_CAMERA (camera));
+	g_assert (error == NULL);
+
+	stream = arv_camera_create_stream (camera, NULL, NULL, &error);
+	g_assert (ARV_IS_STREAM (stream));
+	g_assert (error == NULL);
+
+	/* Block aligned and unaligned buffers */
+	payload = arv_camera_get_payload (camera, NULL);
+	for (i = 0; i < 4; i++)
+		arv_stream_push_buffer (stream, i % 2 == 0 ?
+					arv_buffer_new_allocate_full (payload, ARV_BUFFER_ALLOCATION_FLAGS_NONE, 4096) :
+					arv_buffer_new (payload, NULL));
+
+	recorder = arv_frame_recorder_new (stream, filename, 64 * (guint64) payload, &error);
+	g_assert (ARV_IS_FRAME_RECORDER (recorder));
+	g_assert_no_error (error);
+
+	arv_camera_set_frame_rate (camera, 100.0, NULL);
+	arv_camera_set_acquisition_mode (camera, ARV_ACQUISITION_MODE_CONTINUOUS, NULL);
+	arv_camera_start_acquisition (camera, NULL);
+
+	for (i = 0; i < 100 && arv_frame_recorder_get_n_frames (recorder) < 5; i++)
+		g_usleep (10000);
+
+	arv_camera_stop_acquisition (camera, NULL);
+
+	g_assert (arv_frame_recorder_stop (recorder, &error));
+	g_assert_no_error (error);
+
+	n_frames = arv_frame_recorder_get_n_frames (recorder);
+	g_assert_cmpint (n_frames, >=, 5);
+	g_assert_cmpint (arv_frame_recorder_get_n_written_bytes (recorder), ==, n_frames * payload);
+
+	g_assert (g_file_get_contents (filename, &contents, &length, &error));
+	g_assert_no_error (error);
+
+	header = (ArvFrameRecordHeader *) contents;
+	g_assert (memcmp (header->magic, ARV_FRAME_RECORD_MAGIC, sizeof (header->magic)) == 0);
+	g_assert_cmpint (header->block_size, ==, ARV_FRAME_RECORD_BLOCK_SIZE);
+	g_assert_cmpint (header->entry_size, ==, sizeof (ArvFrameRecordEntry));
+	g_assert_cmpint (header->n_frames, ==, n_frames);
+	g_assert_cmpint (header->index_offset + header->n_frames * sizeof (ArvFrameRecordEntry), <=, length);
+
+	entries = (ArvFrameRecordEntry *) (contents + header->index_offset);
+	for (i = 0; i < header->n_frames; i++) {
+		g_assert_cmpint (entries[i].offset % ARV_FRAME_RECORD_BLOCK_SIZE, ==, 0);
+		g_assert_cmpint (entries[i].offset + entries[i].size, <=, header->index_offset);
+		g_assert_cmpint (entries[i].size, ==, payload);
+		g_assert_cmpint (entries[i].width, >, 0);
+		g_assert_cmpint (entries[i].height, >, 0);
+		g_assert_cmpint (entries[i].pixel_format, ==, arv_camera_get_pixel_format (camera, NULL));
+		if (i > 0)
+			g_assert_cmpint (entries[i].frame_id, >, entries[i - 1].frame_id);
+	}
+
+	g_free (contents);
+
+	g_clear_object (&recorder);
+	g_clear_object (&stream);
+	g_clear_object (&camera);
+
+	g_unlink (filename);
+	g_free (filename);
+}
+
+static void
+frame_log_test (void)
+{
+	ArvFrameLogRecord *records;
+	ArvCamera *camera;
+	ArvStream *stream;
+	ArvBuffer *buffer;
+	GError *error = NULL;
+	guint64 frame_ids[6];
+	guint64 n_dropped = 0;
+	guint n_records = 0;
+	char *filename;
+	char *string;
+	gint payload;
+	unsigned i;
+	int fd;
+
+	fd = g_file_open_tmp ("arv-frame-log-XXXXXX", &filename, &error);
+	g_assert_no_error (error);
+	g_close (fd, NULL);
+
+	camera = arv_camera_new ("Fake_1", &error);
+	g_assert (ARV_IS_CAMERA (camera));
+	g_assert (error == NULL);
+
+	stream = arv_camera_create_stream (camera, NULL, NULL, &error);
+	g_assert (ARV_IS_STREAM (stream));
+	g_assert (error == NULL);
+
+	g_assert (arv_stream_open_frame_log (stream, filename, 4, &error));
+	g_assert_no_error (error);
+
+	/* The log can only be opened once */
+	g_assert (!arv_stream_open_frame_log (stream, filename, 4, &error));
+	g_assert (error != NULL);
+	g_clear_error (&error);
+
+	payload = arv_camera_get_payload (camera, NULL);
+	for (i = 0; i < 2; i++)
+		arv_stream_push_buffer (stream, arv_buffer_new (payload, NULL));
+
+	arv_camera_set_frame_rate (camera, 100.0, NULL);
+	arv_camera_set_acquisition_mode (camera, ARV_ACQUISITION_MODE_CONTINUOUS, NULL);
+	arv_camera_start_acquisition (camera, NULL);
+
+	for (i = 0; i < G_N_ELEMENTS (frame_ids); i++) {
+		buffer = arv_stream_timeout_pop_buffer (stream, 1000000);
+		g_assert (ARV_IS_BUFFER (buffer));
+		frame_ids[i] = arv_buffer_get_frame_id (buffer);
+		arv_stream_push_buffer (stream, buffer);
+	}
+
+	arv_camera_stop_acquisition (camera, NULL);
+
+	/* The log is closed, and truncated to its used size, with the stream */
+	g_clear_object (&stream);
+
+	records = arv_frame_log_load (filename, &n_records, &n_dropped, &error);
+	g_assert_no_error (error);
+	g_assert (records != NULL);
+	g_assert_cmpint (n_records, ==, 4);
+	g_assert_cmpint (n_dropped, >=, 2);
+
+	for (i = 0; i < n_records; i++) {
+		g_assert_cmpint (records[i].frame_id, ==, frame_ids[i]);
+		g_assert_cmpint (records[i].status, ==, ARV_BUFFER_STATUS_SUCCESS);
+		g_assert_cmpint (records[i].payload_type, ==, ARV_BUFFER_PAYLOAD_TYPE_IMAGE);
+		if (i > 0)
+			g_assert_cmpint (records[i].system_timestamp_ns, >=, records[i - 1].system_timestamp_ns);
+	}
+
+	string = arv_frame_log_records_to_string (records, n_records);
+	g_assert (strstr (string, "success") != NULL);
+	g_free (string);
+
+	g_free (records);
+	g_clear_object (&camera);
+
+	g_unlink (filename);
+	g_free (filename);
+}
+
+static void
+camera_api_test (void)
+{
+	ArvCamera *camera;
+	ArvPixelFormat pixel_format;
+	GError *error = NULL;
+	int x, y, w, h;
+	const char *string;
+	void *ptr;
+	unsigned int n;
+	gboolean b;
+	double d;
+
+	camera = arv_camera_new ("Fake_1", &error);
+	g_assert (ARV_IS_CAMERA (camera));
+	g_assert (error == NULL);
+
+	string = arv_camera_get_vendor_name (camera, &error);
+	g_assert (error == NULL);
+	g_assert (string != NULL);
+
+	string = arv_camera_get_model_name (camera, &error);
+	g_assert (error == NULL);
+	g_assert (string != NULL);
+
+	string = arv_camera_get_device_id (camera, &error);
+	g_assert (error == NULL);
+	g_assert (string != NULL);
+
+	arv_camera_get_region (camera, &x, &y, &w, &h, &error);
+	g_assert (error == NULL);
+	g_assert_cmpint (x, ==, 0);
+	g_assert_cmpint (y, ==, 0);
+	g_assert_cmpint (w, ==, ARV_FAKE_CAMERA_WIDTH_DEFAULT);
+	g_assert_cmpint (h, ==, ARV_FAKE_CAMERA_HEIGHT_DEFAULT);
+
+	arv_camera_get_sensor_size (camera, &w, &h, &error);
+	g_assert (error == NULL);
+	g_assert_cmpint (w, ==, ARV_FAKE_CAMERA_SENSOR_WIDTH);
+	g_assert_cmpint (h, ==, ARV_FAKE_CAMERA_SENSOR_HEIGHT);
+
+	arv_camera_set_region (camera, 10, 20, 30, 40, &error);
+	g_assert (error == NULL);
+	arv_camera_get_region (camera, &x, &y, &w, &h, &error);
+	g_assert (error == NULL);
+	g_assert_cmpint (x, ==, 10);
+	g_assert_cmpint (y, ==, 20);
+	g_assert_cmpint (w, ==, 30);
+	g_assert_cmpint (h, ==, 40);
+
+	arv_camera_get_binning (camera, &x, &y, &error);
+	g_assert (error == NULL);
+	g_assert_cmpint (x, ==, ARV_FAKE_CAMERA_BINNING_HORIZONTAL_DEFAULT);
+	g_assert_cmpint (y, ==, ARV_FAKE_CAMERA_BINNING_VERTICAL_DEFAULT);
+
+	arv_camera_set_binning (camera, 2, 4, &error);
+	g_assert (error == NULL);
+	arv_camera_get_binning (camera, &x, &y, &error);
+	g_assert (error == NULL);
+	g_assert_cmpint (x, ==, 2);
+	g_assert_cmpint (y, ==, 4);
+
+	b = arv_camera_is_binning_available (camera, &error);
+	g_assert (error == NULL);
+	g_assert (b);
+
+	pixel_format = arv_camera_get_pixel_format (camera, &error);
+	g_assert (error == NULL);
+	g_assert_cmpint (pixel_format, ==, ARV_PIXEL_FORMAT_MONO_8);
+
+	arv_camera_set_pixel_format (camera, ARV_PIXEL_FORMAT_RGB_8_PACKED, &error);
+	g_assert (error == NULL);
+	pixel_format = arv_camera_get_pixel_format (camera, &error);
+	g_assert (error == NULL);
+	g_assert_cmpint (pixel_format, ==, ARV_PIXEL_FORMAT_RGB_8_PACKED);
+
+	string = arv_camera_get_pixel_format_as_string (camera, &error);
+	g_assert (error == NULL);
+	g_assert_cmpstr (string, ==, "RGB8");
+
+	arv_camera_set_pixel_format (camera, ARV_PIXEL_FORMAT_BAYER_BG_8, &error);
+	g_assert (error == NULL);
+	pixel_format = arv_camera_get_pixel_format (camera, &error);
+	g_assert (error == NULL);
+	g_assert_cmpint (pixel_format, ==, ARV_PIXEL_FORMAT_BAYER_BG_8);
+
+	string = arv_camera_get_pixel_format_as_string (camera, &error);
+	g_assert (error == NULL);
+	g_assert_cmpstr (string, ==, "BayerBG8");
+
+	arv_camera_set_pixel_format (camera, ARV_PIXEL_FORMAT_BAYER_GB_8, &error);
+	g_assert (error == NULL);
+	pixel_format = arv_camera_get_pixel_format (camera, &error);
+	g_assert (error == NULL);
+	g_assert_cmpint (pixel_format, ==, ARV_PIXEL_FORMAT_BAYER_GB_8);
+
+	string = arv_camera_get_pixel_format_as_string (camera, &error);
+	g_assert (error == NULL);
+	g_assert_cmpstr (string, ==, "BayerGB8");
+
+	arv_camera_set_pixel_format (camera, ARV_PIXEL_FORMAT_BAYER_GR_8, &error);
+	g_assert (error == NULL);
+	pixel_format = arv_camera_get_pixel_format (camera, &error);
+	g_assert (error == NULL);
+	g_assert_cmpint (pixel_format, ==, ARV_PIXEL_FORMAT_BAYER_GR_8);
+
+	string = arv_camera_get_pixel_format_as_string (camera, &error);
+	g_assert (error == NULL);
+	g_assert_cmpstr (string, ==, "BayerGR8");
+
+	arv_camera_set_pixel_format (camera, ARV_PIXEL_FORMAT_BAYER_RG_8, &error);
+	g_assert (error == NULL);
+	pixel_format = arv_camera_get_pixel_format (camera, &error);
+	g_assert (error == NULL);
+	g_assert_cmpint (pixel_format, ==, ARV_PIXEL_FORMAT_BAYER_RG_8);
+
+	string = arv_camera_get_pixel_format_as_string (camera, &error);
+	g_assert (error == NULL);
+	g_assert_cmpstr (string, ==, "BayerRG8");
+
+	arv_camera_set_pixel_format_from_string (camera, "Mono8", &error);
+	g_assert (error == NULL);
+	pixel_format = arv_camera_get_pixel_format (camera, &error);
+	g_assert (error == NULL);
+	g_assert_cmpint (pixel_format, ==, ARV_PIXEL_FORMAT_MONO_8);
+
+	ptr = arv_camera_dup_available_pixel_formats (camera, &n, &error);
+	g_assert (error == NULL);
+	g_assert (ptr != NULL);
+	g_assert_cmpint (n, ==, 8);
+	g_clear_pointer (&ptr, g_free);
+
+	ptr = arv_camera_dup_available_pixel_formats_as_strings (camera, &n, &error);
+	g_assert (error == NULL);
+	g_assert (ptr != NULL);
+	g_assert_cmpint (n, ==, 8);
+	g_clear_pointer (&ptr, g_free);
+
+	ptr = arv_camera_dup_available_pixel_formats_as_display_names (camera, &n, &error);
+	g_assert (error == NULL);
+	g_assert (ptr != NULL);
+	g_assert_cmpint (n, ==, 8);
+	g_clear_pointer (&ptr, g_free);
+
+	b = arv_camera_is_frame_rate_available (camera, &error);
+	g_assert (error == NULL);
+	g_assert (b);
+
+	d = arv_camera_get_frame_rate (camera, &error);
+	g_assert (error == NULL);
+	g_assert_cmpfloat (d, ==, ARV_FAKE_CAMERA_ACQUISITION_FRAME_RATE_DEFAULT);
 
 	arv_camera_set_frame_rate (camera, 10.0, &error);
 	g_assert (error == NULL);
@@ -508,128 +1793,690 @@ camera_api_test (void)
 	g_assert (error == NULL);
 	g_assert_cmpfloat (d, ==, 10.0);
 
-	b = arv_camera_is_exposure_auto_available (camera, &error);
-	g_assert (error == NULL);
-	g_assert (!b);
+	b = arv_camera_is_exposure_auto_available (camera, &error);
+	g_assert (error == NULL);
+	g_assert (!b);
+
+	b = arv_camera_is_exposure_time_available (camera, &error);
+	g_assert (error == NULL);
+	g_assert (b);
+
+	/* Cached feature handles and feature names must see the same values */
+	arv_camera_set_exposure_time (camera, 2000.0, &error);
+	g_assert (error == NULL);
+	d = arv_camera_get_exposure_time (camera, &error);
+	g_assert (error == NULL);
+	g_assert_cmpfloat (d, ==, arv_camera_get_float (camera, "ExposureTimeAbs", NULL));
+
+	arv_camera_set_gain (camera, 1.0, &error);
+	g_assert (error == NULL);
+	d = arv_camera_get_gain (camera, &error);
+	g_assert (error == NULL);
+	g_assert_cmpfloat (d, ==, 1.0);
+
+	arv_camera_set_integer (camera, "Unknown", 0, &error);
+	g_assert (error != NULL);
+	g_clear_error (&error);
+
+	g_object_unref (camera);
+}
+
+static void
+set_flag (gpointer user_data, GObject *object)
+{
+	gboolean *flag = user_data;
+
+	*flag = TRUE;
+}
+
+static void
+camera_device_test (void)
+{
+	ArvDevice *device;
+	ArvDevice *camera_device;
+	ArvCamera *camera;
+	GError *error = NULL;
+	gboolean device_released = FALSE;
+
+	device = arv_fake_device_new ("TEST0", &error);
+	g_assert (ARV_IS_FAKE_DEVICE (device));
+	g_assert (error == NULL);
+
+	g_object_weak_ref (G_OBJECT (device), set_flag, &device_released);
+
+	camera = arv_camera_new_with_device (device, &error);
+	g_assert (ARV_IS_CAMERA (camera));
+	g_assert (error == NULL);
+
+	camera_device = arv_camera_get_device (camera);
+	g_assert (ARV_IS_FAKE_DEVICE (camera_device));
+	g_assert (device == camera_device);
+
+	g_assert (!device_released);
+
+	g_object_unref (device);
+	g_assert (!device_released);
+
+	g_object_unref (camera);
+	g_assert (device_released);
+
+	g_test_expect_message (G_LOG_DOMAIN,
+			       G_LOG_LEVEL_CRITICAL,
+			       "*assertion*");
+	arv_camera_new_with_device (NULL, NULL);
+	g_test_assert_expected_messages ();
+
+}
+
+static void
+set_features_from_string_test (void)
+{
+	ArvDevice *device;
+	GError *error = NULL;
+	gboolean success;
+	gint64 int_value;
+
+	device = arv_fake_device_new ("TEST0", &error);
+	g_assert (ARV_IS_FAKE_DEVICE (device));
+	g_assert (error == NULL);
+
+	success = arv_device_set_features_from_string (device, "PixelFormat=RGB8 Height=1048 AcquisitionStart", &error);
+	g_assert (success);
+	g_assert (error == NULL);
+
+	int_value = arv_device_get_integer_feature_value (device, "Height", NULL);
+	g_assert_cmpint (int_value, ==, 1048);
+
+	success = arv_device_set_features_from_string (device, "NotAFeature=NotAValue", &error);
+	g_assert (!success);
+	g_assert (error != NULL);
+	g_clear_error (&error);
+
+	success = arv_device_set_features_from_string (device, "NotAFeature", &error);
+	g_assert (!success);
+	g_assert (error != NULL);
+	g_clear_error (&error);
+
+	success = arv_device_set_features_from_string (device, "PixelFormat", &error);
+	g_assert (!success);
+	g_assert (error != NULL);
+	g_clear_error (&error);
+
+	success = arv_device_set_features_from_string (device, "PixelFormat=NotAValidEntry", &error);
+	g_assert (!success);
+	g_assert (error != NULL);
+	g_clear_error (&error);
+
+	success = arv_device_set_features_from_string (device, "StartAcquitision=Value", &error);
+	g_assert (!success);
+	g_assert (error != NULL);
+	g_clear_error (&error);
+
+	success = arv_device_set_features_from_string (device, "PixelFormat=RGB8    AcquisitionStart", &error);
+	g_assert (success);
+	g_assert (error == NULL);
+
+	success = arv_device_set_features_from_string (device, NULL, NULL);
+	g_assert (success);
+
+	g_object_unref (device);
+}
+
+typedef struct {
+	GMainLoop *loop;
+	guint n_pending;
+	gint64 width;
+	gint64 height;
+	char *pixel_format;
+	gboolean error_reported;
+} AsyncFeatureData;
+
+static void
+_async_feature_done (AsyncFeatureData *data)
+{
+	data->n_pending--;
+	if (data->n_pending == 0)
+		g_main_loop_quit (data->loop);
+}
+
+static void
+_async_set_height_cb (GObject *source_object, GAsyncResult *result, gpointer user_data)
+{
+	GError *error = NULL;
 
-	b = arv_camera_is_exposure_time_available (camera, &error);
+	g_assert (arv_device_set_integer_feature_value_finish (ARV_DEVICE (source_object), result, &error));
 	g_assert (error == NULL);
-	g_assert (b);
 
-	arv_camera_set_gain (camera, 1.0, &error);
-	g_assert (error == NULL);
-	d = arv_camera_get_gain (camera, &error);
-	g_assert (error == NULL);
-	g_assert_cmpfloat (d, ==, 1.0);
+	_async_feature_done (user_data);
+}
 
-	arv_camera_set_integer (camera, "Unknown", 0, &error);
-	g_assert (error != NULL);
+static void
+_async_get_width_cb (GObject *source_object, GAsyncResult *result, gpointer user_data)
+{
+	AsyncFeatureData *data = user_data;
+
+	data->width = arv_device_get_integer_feature_value_finish (ARV_DEVICE (source_object), result, NULL);
+
+	_async_feature_done (data);
+}
+
+static void
+_async_get_height_cb (GObject *source_object, GAsyncResult *result, gpointer user_data)
+{
+	AsyncFeatureData *data = user_data;
+
+	data->height = arv_device_get_integer_feature_value_finish (ARV_DEVICE (source_object), result, NULL);
+
+	_async_feature_done (data);
+}
+
+static void
+_async_get_unknown_cb (GObject *source_object, GAsyncResult *result, gpointer user_data)
+{
+	AsyncFeatureData *data = user_data;
+	GError *error = NULL;
+
+	arv_device_get_integer_feature_value_finish (ARV_DEVICE (source_object), result, &error);
+	data->error_reported = error != NULL;
 	g_clear_error (&error);
 
-	g_object_unref (camera);
+	_async_feature_done (data);
 }
 
 static void
-set_flag (gpointer user_data, GObject *object)
+_async_get_pixel_format_cb (GObject *source_object, GAsyncResult *result, gpointer user_data)
 {
-	gboolean *flag = user_data;
+	AsyncFeatureData *data = user_data;
 
-	*flag = TRUE;
+	data->pixel_format = arv_camera_get_string_finish (ARV_CAMERA (source_object), result, NULL);
+
+	_async_feature_done (data);
 }
 
 static void
-camera_device_test (void)
+async_feature_test (void)
 {
-	ArvDevice *device;
-	ArvDevice *camera_device;
 	ArvCamera *camera;
+	ArvDevice *device;
+	AsyncFeatureData data = {0};
 	GError *error = NULL;
-	gboolean device_released = FALSE;
 
-	device = arv_fake_device_new ("TEST0", &error);
-	g_assert (ARV_IS_FAKE_DEVICE (device));
+	camera = arv_camera_new ("Fake_1", &error);
+	g_assert (ARV_IS_CAMERA (camera));
 	g_assert (error == NULL);
 
-	g_object_weak_ref (G_OBJECT (device), set_flag, &device_released);
+	device = arv_camera_get_device (camera);
 
-	camera = arv_camera_new_with_device (device, &error);
-	g_assert (ARV_IS_CAMERA (camera));
-	g_assert (error == NULL);
+	data.loop = g_main_loop_new (NULL, FALSE);
+	data.n_pending = 5;
 
-	camera_device = arv_camera_get_device (camera);
-	g_assert (ARV_IS_FAKE_DEVICE (camera_device));
-	g_assert (device == camera_device);
+	arv_device_set_integer_feature_value_async (device, "Height", 256, NULL, _async_set_height_cb, &data);
+	arv_device_get_integer_feature_value_async (device, "Width", NULL, _async_get_width_cb, &data);
+	arv_device_get_integer_feature_value_async (device, "Height", NULL, _async_get_height_cb, &data);
+	arv_device_get_integer_feature_value_async (device, "NotAFeature", NULL, _async_get_unknown_cb, &data);
+	arv_camera_get_string_async (camera, "PixelFormat", NULL, _async_get_pixel_format_cb, &data);
 
-	g_assert (!device_released);
+	g_main_loop_run (data.loop);
 
-	g_object_unref (device);
-	g_assert (!device_released);
+	g_assert_cmpint (data.width, ==, arv_device_get_integer_feature_value (device, "Width", NULL));
+	g_assert_cmpint (data.height, ==, 256);
+	g_assert (data.error_reported);
+	g_assert_cmpstr (data.pixel_format, ==, arv_device_get_string_feature_value (device, "PixelFormat", NULL));
+
+	g_free (data.pixel_format);
+	g_main_loop_unref (data.loop);
 
 	g_object_unref (camera);
-	g_assert (device_released);
+}
 
-	g_test_expect_message (G_LOG_DOMAIN,
-			       G_LOG_LEVEL_CRITICAL,
-			       "*assertion*");
-	arv_camera_new_with_device (NULL, NULL);
-	g_test_assert_expected_messages ();
+static void
+_feature_polled_cb (ArvDevice *device, const char *feature, gpointer user_data)
+{
+	gint *n_polls = user_data;
 
+	g_atomic_int_inc (n_polls);
 }
 
 static void
-set_features_from_string_test (void)
+polled_feature_test (void)
 {
 	ArvDevice *device;
+	GValue value = G_VALUE_INIT;
 	GError *error = NULL;
+	gint n_polls = 0;
+	gint64 timestamp_us = 0;
 	gboolean success;
-	gint64 int_value;
+	int i;
 
 	device = arv_fake_device_new ("TEST0", &error);
 	g_assert (ARV_IS_FAKE_DEVICE (device));
 	g_assert (error == NULL);
 
-	success = arv_device_set_features_from_string (device, "PixelFormat=RGB8 Height=1048 AcquisitionStart", &error);
+	arv_device_set_integer_feature_value (device, "TestRegister", 321, &error);
+	g_assert (error == NULL);
+
+	g_signal_connect (device, "feature-polled::TestBoolean", G_CALLBACK (_feature_polled_cb), &n_polls);
+
+	success = arv_device_add_polled_feature (device, "TestRegister", 10, &error);
 	g_assert (success);
 	g_assert (error == NULL);
 
-	int_value = arv_device_get_integer_feature_value (device, "Height", NULL);
-	g_assert_cmpint (int_value, ==, 1048);
+	success = arv_device_add_polled_feature (device, "TestBoolean", 10, &error);
+	g_assert (success);
+	g_assert (error == NULL);
 
-	success = arv_device_set_features_from_string (device, "NotAFeature=NotAValue", &error);
+	success = arv_device_add_polled_feature (device, "NotAFeature", 10, &error);
 	g_assert (!success);
-	g_assert (error != NULL);
+	g_assert_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_FEATURE_NOT_FOUND);
 	g_clear_error (&error);
 
-	success = arv_device_set_features_from_string (device, "NotAFeature", &error);
+	/* No PollingTime in the fake camera description */
+	success = arv_device_add_polled_feature (device, "Width", 0, &error);
 	g_assert (!success);
-	g_assert (error != NULL);
+	g_assert_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_INVALID_PARAMETER);
 	g_clear_error (&error);
 
-	success = arv_device_set_features_from_string (device, "PixelFormat", &error);
-	g_assert (!success);
-	g_assert (error != NULL);
-	g_clear_error (&error);
+	for (i = 0; i < 1000 && g_atomic_int_get (&n_polls) < 2; i++)
+		g_usleep (1000);
 
-	success = arv_device_set_features_from_string (device, "PixelFormat=NotAValidEntry", &error);
-	g_assert (!success);
-	g_assert (error != NULL);
-	g_clear_error (&error);
+	g_assert_cmpint (g_atomic_int_get (&n_polls), >=, 2);
 
-	success = arv_device_set_features_from_string (device, "StartAcquitision=Value", &error);
-	g_assert (!success);
-	g_assert (error != NULL);
-	g_clear_error (&error);
+	success = arv_device_get_polled_feature_value (device, "TestRegister", &value, &timestamp_us);
+	g_assert (success);
+	g_assert (G_VALUE_HOLDS_INT64 (&value));
+	g_assert_cmpint (g_value_get_int64 (&value), ==, 321);
+	g_assert_cmpint (timestamp_us, >, 0);
+	g_value_unset (&value);
 
-	success = arv_device_set_features_from_string (device, "PixelFormat=RGB8    AcquisitionStart", &error);
+	success = arv_device_get_polled_feature_value (device, "TestBoolean", &value, NULL);
 	g_assert (success);
+	g_assert (G_VALUE_HOLDS_BOOLEAN (&value));
+	g_assert (g_value_get_boolean (&value));
+	g_value_unset (&value);
+
+	arv_device_remove_polled_feature (device, "TestRegister");
+	g_assert (!arv_device_get_polled_feature_value (device, "TestRegister", &value, NULL));
+
+	g_object_unref (device);
+}
+
+static void
+auxiliary_threads_test (void)
+{
+	ArvDevice *device;
+	GError *error = NULL;
+	gint n_polls = 0;
+	char *cpus = NULL;
+	int nice_level = 0;
+	gboolean success;
+	int i;
+
+	device = arv_fake_device_new ("TEST0", &error);
+	g_assert (ARV_IS_FAKE_DEVICE (device));
 	g_assert (error == NULL);
 
-	success = arv_device_set_features_from_string (device, NULL, NULL);
+	g_signal_connect (device, "feature-polled::TestBoolean", G_CALLBACK (_feature_polled_cb), &n_polls);
+
+	success = arv_device_add_polled_feature (device, "TestBoolean", 10, &error);
 	g_assert (success);
+	g_assert (error == NULL);
+
+	/* Applied by the running feature thread */
+	g_object_set (device, "auxiliary-cpus", "0", "auxiliary-nice-level", 5, NULL);
+
+	g_object_get (device, "auxiliary-cpus", &cpus, "auxiliary-nice-level", &nice_level, NULL);
+	g_assert_cmpstr (cpus, ==, "0");
+	g_assert_cmpint (nice_level, ==, 5);
+	g_free (cpus);
+
+	for (i = 0; i < 1000 && g_atomic_int_get (&n_polls) < 2; i++)
+		g_usleep (1000);
+
+	g_assert_cmpint (g_atomic_int_get (&n_polls), >=, 2);
 
 	g_object_unref (device);
 }
 
+typedef struct {
+	GMainLoop *loop;
+	GPtrArray *device_ids;
+	gboolean found;
+	guint n_found_before_done;
+} DeviceListData;
+
+static void
+_device_found_cb (const char *device_id, gpointer user_data)
+{
+	DeviceListData *data = user_data;
+
+	g_ptr_array_add (data->device_ids, g_strdup (device_id));
+}
+
+static void
+_device_list_updated_cb (GObject *source_object, GAsyncResult *result, gpointer user_data)
+{
+	DeviceListData *data = user_data;
+	GError *error = NULL;
+
+	data->found = arv_update_device_list_finish (result, &error);
+	g_assert (error == NULL);
+
+	data->n_found_before_done = data->device_ids->len;
+
+	g_main_loop_quit (data->loop);
+}
+
+static void
+async_device_list_test (void)
+{
+	DeviceListData data = {0};
+	gboolean fake_found = FALSE;
+	unsigned int i;
+
+	data.loop = g_main_loop_new (NULL, FALSE);
+	data.device_ids = g_ptr_array_new_with_free_func (g_free);
+
+	arv_update_device_list_async ("Fake_1", NULL, _device_found_cb, &data, _device_list_updated_cb, &data);
+
+	g_main_loop_run (data.loop);
+
+	g_assert (data.found);
+	g_assert_cmpint (data.n_found_before_done, >=, 1);
+
+	for (i = 0; i < data.device_ids->len; i++)
+		if (g_strcmp0 (g_ptr_array_index (data.device_ids, i), "Fake_1") == 0)
+			fake_found = TRUE;
+	g_assert (fake_found);
+
+	fake_found = FALSE;
+	for (i = 0; i < arv_get_n_devices (); i++)
+		if (g_strcmp0 (arv_get_device_id (i), "Fake_1") == 0)
+			fake_found = TRUE;
+	g_assert (fake_found);
+
+	g_ptr_array_unref (data.device_ids);
+	g_main_loop_unref (data.loop);
+
+	arv_update_device_list ();
+}
+
+static void
+open_devices_test (void)
+{
+	const char *device_ids[] = {"Fake_1", "Fake_1", "Fake_1", NULL};
+	const char *bad_device_ids[] = {"Fake_1", "Unknown", NULL};
+	GError *error = NULL;
+	GPtrArray *devices;
+	unsigned int i;
+
+	devices = arv_open_devices (device_ids, &error);
+	g_assert (error == NULL);
+	g_assert (devices != NULL);
+	g_assert_cmpint (devices->len, ==, 3);
+
+	for (i = 0; i < devices->len; i++)
+		g_assert (ARV_IS_FAKE_DEVICE (g_ptr_array_index (devices, i)));
+
+	g_ptr_array_unref (devices);
+
+	devices = arv_open_devices (bad_device_ids, &error);
+	g_assert_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_NOT_FOUND);
+	g_assert (devices == NULL);
+
+	g_clear_error (&error);
+}
+
+/* Stream backend using only the public backend API, producing constant frames */
+
+#define BACKEND_WIDTH		64
+#define BACKEND_HEIGHT		32
+#define BACKEND_N_BUFFERS	3
+#define BACKEND_N_FRAMES	10
+
+typedef struct {
+	ArvStream parent;
+
+	GThread *thread;
+	gint cancel;
+	guint64 frame_id;
+	guint64 n_completed_buffers;
+	guint64 n_underruns;
+} TestBackendStream;
+
+typedef struct {
+	ArvStreamClass parent_class;
+} TestBackendStreamClass;
+
+GType test_backend_stream_get_type (void);
+
+G_DEFINE_TYPE (TestBackendStream, test_backend_stream, ARV_TYPE_STREAM)
+
+static gpointer
+_backend_thread (gpointer data)
+{
+	TestBackendStream *backend = data;
+
+	while (!g_atomic_int_get (&backend->cancel)) {
+		ArvBuffer *buffer;
+		void *buffer_data;
+		size_t size;
+
+		buffer = arv_stream_pop_input_buffer (ARV_STREAM (backend));
+		if (buffer == NULL) {
+			backend->n_underruns++;
+			g_usleep (1000);
+			continue;
+		}
+
+		buffer_data = arv_buffer_start_fill (buffer, &size);
+		g_assert (buffer_data != NULL);
+
+		backend->frame_id++;
+		memset (buffer_data, backend->frame_id & 0xff, size);
+
+		arv_buffer_set_payload_type (buffer, ARV_BUFFER_PAYLOAD_TYPE_IMAGE);
+		arv_buffer_set_image_region (buffer, 0, 0, BACKEND_WIDTH, BACKEND_HEIGHT);
+		arv_buffer_set_image_pixel_format (buffer, ARV_PIXEL_FORMAT_MONO_8);
+		arv_buffer_set_frame_id (buffer, backend->frame_id);
+		arv_buffer_set_timestamp (buffer, backend->frame_id * 1000000);
+		arv_buffer_set_received_size (buffer, size);
+		arv_buffer_set_status (buffer, ARV_BUFFER_STATUS_SUCCESS);
+
+		backend->n_completed_buffers++;
+
+		arv_stream_push_output_buffer (ARV_STREAM (backend), buffer);
+	}
+
+	return NULL;
+}
+
+static void
+test_backend_stream_start_thread (ArvStream *stream)
+{
+	TestBackendStream *backend = (TestBackendStream *) stream;
+
+	g_atomic_int_set (&backend->cancel, FALSE);
+	backend->thread = g_thread_new ("test_backend", _backend_thread, backend);
+}
+
+static void
+test_backend_stream_stop_thread (ArvStream *stream)
+{
+	TestBackendStream *backend = (TestBackendStream *) stream;
+
+	if (backend->thread == NULL)
+		return;
+
+	g_atomic_int_set (&backend->cancel, TRUE);
+	g_thread_join (backend->thread);
+	backend->thread = NULL;
+}
+
+static void
+test_backend_stream_get_statistics (ArvStream *stream, guint64 *n_completed_buffers, guint64 *n_failures,
+				    guint64 *n_underruns)
+{
+	TestBackendStream *backend = (TestBackendStream *) stream;
+
+	*n_completed_buffers = backend->n_completed_buffers;
+	*n_failures = 0;
+	*n_underruns = backend->n_underruns;
+}
+
+static void
+test_backend_stream_constructed (GObject *object)
+{
+	TestBackendStream *backend = (TestBackendStream *) object;
+
+	G_OBJECT_CLASS (test_backend_stream_parent_class)->constructed (object);
+
+	arv_stream_declare_info (ARV_STREAM (object), "n_completed_buffers", G_TYPE_UINT64,
+				 &backend->n_completed_buffers);
+}
+
+static void
+test_backend_stream_finalize (GObject *object)
+{
+	test_backend_stream_stop_thread (ARV_STREAM (object));
+
+	G_OBJECT_CLASS (test_backend_stream_parent_class)->finalize (object);
+}
+
+static void
+test_backend_stream_init (TestBackendStream *backend)
+{
+}
+
+static void
+test_backend_stream_class_init (TestBackendStreamClass *backend_class)
+{
+	GObjectClass *object_class = G_OBJECT_CLASS (backend_class);
+	ArvStreamClass *stream_class = ARV_STREAM_CLASS (backend_class);
+
+	object_class->constructed = test_backend_stream_constructed;
+	object_class->finalize = test_backend_stream_finalize;
+
+	stream_class->start_thread = test_backend_stream_start_thread;
+	stream_class->stop_thread = test_backend_stream_stop_thread;
+	stream_class->get_statistics = test_backend_stream_get_statistics;
+}
+
+static void
+stream_backend_test (void)
+{
+	ArvStream *stream;
+	GError *error = NULL;
+	guint64 n_completed_buffers;
+	guint64 n_failures;
+	guint64 n_underruns;
+	unsigned int i;
+
+	stream = g_initable_new (test_backend_stream_get_type (), NULL, &error, NULL);
+	g_assert_no_error (error);
+	g_assert (ARV_IS_STREAM (stream));
+
+	for (i = 0; i < BACKEND_N_BUFFERS; i++)
+		arv_stream_push_buffer (stream, arv_buffer_new (BACKEND_WIDTH * BACKEND_HEIGHT, NULL));
+
+	arv_stream_start_thread (stream);
+
+	for (i = 0; i < BACKEND_N_FRAMES; i++) {
+		ArvBuffer *buffer;
+		const guint8 *data;
+		size_t size;
+
+		buffer = arv_stream_timeout_pop_buffer (stream, 1000000);
+		g_assert (ARV_IS_BUFFER (buffer));
+
+		g_assert_cmpint (arv_buffer_get_status (buffer), ==, ARV_BUFFER_STATUS_SUCCESS);
+		g_assert_cmpint (arv_buffer_get_payload_type (buffer), ==, ARV_BUFFER_PAYLOAD_TYPE_IMAGE);
+		g_assert_cmpint (arv_buffer_get_frame_id (buffer), ==, i + 1);
+		g_assert_cmpint (arv_buffer_get_image_width (buffer), ==, BACKEND_WIDTH);
+		g_assert_cmpint (arv_buffer_get_image_height (buffer), ==, BACKEND_HEIGHT);
+		g_assert_cmpint (arv_buffer_get_image_pixel_format (buffer), ==, ARV_PIXEL_FORMAT_MONO_8);
+		g_assert_cmpint (arv_buffer_get_received_size (buffer), ==, BACKEND_WIDTH * BACKEND_HEIGHT);
+		g_assert_cmpint (arv_buffer_get_host_timestamp (buffer), >, 0);
+		g_assert_cmpint (arv_buffer_get_system_timestamp (buffer), >, 0);
+
+		data = arv_buffer_get_data (buffer, &size);
+		g_assert_cmpint (size, ==, BACKEND_WIDTH * BACKEND_HEIGHT);
+		g_assert_cmpint (data[0], ==, (i + 1) & 0xff);
+		g_assert_cmpint (data[size - 1], ==, (i + 1) & 0xff);
+
+		arv_stream_push_buffer (stream, buffer);
+	}
+
+	arv_stream_stop_thread (stream, TRUE);
+
+	arv_stream_get_statistics (stream, &n_completed_buffers, &n_failures, &n_underruns);
+	g_assert_cmpint (n_completed_buffers, >=, BACKEND_N_FRAMES);
+	g_assert_cmpint (n_failures, ==, 0);
+	g_assert_cmpint (arv_stream_get_info_uint64_by_name (stream, "n_completed_buffers"), ==, n_completed_buffers);
+
+	g_object_unref (stream);
+}
+
+static void
+stream_group_test (void)
+{
+	ArvCamera *cameras[2];
+	ArvStream *streams[2];
+	ArvBuffer *buffers[2];
+	ArvStreamGroup *group;
+	GError *error = NULL;
+	gint payload;
+	unsigned int i, j;
+
+	for (i = 0; i < 2; i++) {
+		cameras[i] = arv_camera_new ("Fake_1", &error);
+		g_assert_no_error (error);
+		g_assert (ARV_IS_CAMERA (cameras[i]));
+
+		streams[i] = arv_camera_create_stream (cameras[i], NULL, NULL, &error);
+		g_assert_no_error (error);
+		g_assert (ARV_IS_STREAM (streams[i]));
+
+		payload = arv_camera_get_payload (cameras[i], NULL);
+		for (j = 0; j < 5; j++)
+			arv_stream_push_buffer (streams[i], arv_buffer_new (payload, NULL));
+
+		arv_camera_set_frame_rate (cameras[i], 50.0, NULL);
+		arv_camera_set_acquisition_mode (cameras[i], ARV_ACQUISITION_MODE_CONTINUOUS, NULL);
+	}
+
+	group = arv_stream_group_new (streams, 2, ARV_STREAM_GROUP_MATCH_FRAME_ID, 0);
+	g_assert (ARV_IS_STREAM_GROUP (group));
+	g_assert_cmpint (arv_stream_group_get_n_streams (group), ==, 2);
+
+	for (i = 0; i < 2; i++)
+		arv_camera_start_acquisition (cameras[i], NULL);
+
+	for (i = 0; i < 10; i++) {
+		g_assert_true (arv_stream_group_timeout_pop_frame_set (group, buffers, 1000000));
+
+		for (j = 0; j < 2; j++) {
+			g_assert (ARV_IS_BUFFER (buffers[j]));
+			g_assert_cmpint (arv_buffer_get_status (buffers[j]), ==, ARV_BUFFER_STATUS_SUCCESS);
+		}
+		g_assert_cmpint (arv_buffer_get_frame_id (buffers[0]), ==, arv_buffer_get_frame_id (buffers[1]));
+
+		arv_stream_group_push_frame_set (group, buffers);
+	}
+
+	for (i = 0; i < 2; i++)
+		arv_camera_stop_acquisition (cameras[i], NULL);
+
+	g_assert_cmpint (arv_stream_group_get_n_frame_sets (group), >=, 10);
+
+	/* The pending buffers go back to their streams */
+	g_clear_object (&group);
+
+	for (i = 0; i < 2; i++) {
+		g_clear_object (&streams[i]);
+		g_clear_object (&cameras[i]);
+	}
+}
+
 int
 main (int argc, char *argv[])
 {
@@ -644,13 +2491,39 @@ main (int argc, char *argv[])
 	arv_update_device_list ();
 
 	g_test_add_func ("/fake/trigger-registers", trigger_registers_test);
+	g_test_add_func ("/fake/selector-sweep", selector_sweep_test);
+	g_test_add_func ("/fake/lut-upload", lut_upload_test);
 	g_test_add_func ("/fake/registers", registers_test);
+	g_test_add_func ("/fake/register-fields", register_fields_test);
 	g_test_add_func ("/fake/fake-device", fake_device_test);
 	g_test_add_func ("/fake/fake-device-error", fake_device_error_test);
 	g_test_add_func ("/fake/fake-stream", fake_stream_test);
+	g_test_add_func ("/fake/fill-mode", fill_mode_test);
+	g_test_add_func ("/fake/lock-free-queues", lock_free_queues_test);
+	g_test_add_func ("/fake/pop-buffers", pop_buffers_test);
+	g_test_add_func ("/fake/mailbox", mailbox_test);
+	g_test_add_func ("/fake/max-age", max_age_test);
+	g_test_add_func ("/fake/output-fd", output_fd_test);
+	g_test_add_func ("/fake/pop-spin", pop_spin_test);
+	g_test_add_func ("/fake/burst", burst_test);
+	g_test_add_func ("/fake/tile-processing", tile_processing_test);
+	g_test_add_func ("/fake/processing-stage", processing_stage_test);
+	g_test_add_func ("/fake/buffer-pool", buffer_pool_test);
+	g_test_add_func ("/fake/stream-pause", stream_pause_test);
+	g_test_add_func ("/fake/metrics-exporter", metrics_exporter_test);
+	g_test_add_func ("/fake/shared-stream", shared_stream_test);
+	g_test_add_func ("/fake/frame-recorder", frame_recorder_test);
+	g_test_add_func ("/fake/frame-log", frame_log_test);
 	g_test_add_func ("/fake/camera-api", camera_api_test);
 	g_test_add_func ("/fake/camera-device", camera_device_test);
 	g_test_add_func ("/fake/set-features-from-string", set_features_from_string_test);
+	g_test_add_func ("/fake/async-feature", async_feature_test);
+	g_test_add_func ("/fake/polled-feature", polled_feature_test);
+	g_test_add_func ("/fake/auxiliary-threads", auxiliary_threads_test);
+	g_test_add_func ("/fake/async-device-list", async_device_list_test);
+	g_test_add_func ("/fake/open-devices", open_devices_test);
+	g_test_add_func ("/fake/stream-group", stream_group_test);
+	g_test_add_func ("/fake/stream-backend", stream_backend_test);
 
 	result = g_test_run();
 
@@ -1,6 +1,13 @@
 #include <glib.h>
 #include <arv.h>
-
+#include <glib/gstdio.h>
+#include <string.h>
+#include "../src/arvgvcpprivate.h"
+#include "../src/arvgvdeviceprivate.h"
+#include "../src/arvgvspprivate.h"
+#include "../src/arvpacketrecorderprivate.h"
+
+static ArvGvFakeCamera *simulator = NULL;
 static ArvCamera *camera = NULL;
 
 static void
@@ -63,6 +70,410 @@ register_test (void)
 	g_assert_cmpint (int_value, ==, 321);
 }
 
+static void
+register_batch_test (void)
+{
+	ArvDevice *device;
+	GError *error = NULL;
+	guint64 addresses[] = {ARV_FAKE_CAMERA_REGISTER_WIDTH, ARV_FAKE_CAMERA_REGISTER_HEIGHT,
+		ARV_FAKE_CAMERA_REGISTER_TEST};
+	const char *features[] = {"WidthRegister", "Width", "HeightRegister", "TestRegister"};
+	guint32 values[G_N_ELEMENTS (addresses)];
+	gint64 feature_values[G_N_ELEMENTS (features)];
+	guint i;
+
+	device = arv_camera_get_device (camera);
+	g_assert (ARV_IS_GV_DEVICE (device));
+
+	arv_device_set_integer_feature_value (device, "Width", 512, NULL);
+	arv_device_set_integer_feature_value (device, "Height", 256, NULL);
+
+	g_assert (arv_device_read_registers (device, G_N_ELEMENTS (addresses), addresses, values, &error));
+	g_assert (error == NULL);
+
+	for (i = 0; i < G_N_ELEMENTS (addresses); i++) {
+		guint32 value;
+
+		arv_device_read_register (device, addresses[i], &value, NULL);
+		g_assert_cmpint (values[i], ==, value);
+	}
+	g_assert_cmpint (values[0], ==, 512);
+	g_assert_cmpint (values[1], ==, 256);
+
+	g_assert (arv_device_get_integer_feature_values (device, G_N_ELEMENTS (features), features, feature_values,
+							 &error));
+	g_assert (error == NULL);
+
+	g_assert_cmpint (feature_values[0], ==, 512);
+	g_assert_cmpint (feature_values[1], ==, 512);
+	g_assert_cmpint (feature_values[2], ==, 256);
+	g_assert_cmpint (feature_values[3], ==, values[2]);
+
+	/* A second read must not return a stale prefetched value */
+	arv_device_set_integer_feature_value (device, "Width", 1024, NULL);
+	g_assert_cmpint (arv_device_get_integer_feature_value (device, "WidthRegister", NULL), ==, 1024);
+
+	arv_device_set_integer_feature_value (device, "Height", 1024, NULL);
+}
+
+static void
+write_batch_test (void)
+{
+	ArvDevice *device;
+	GError *error = NULL;
+	guint64 addresses[] = {ARV_FAKE_CAMERA_REGISTER_WIDTH, ARV_FAKE_CAMERA_REGISTER_HEIGHT};
+	guint32 values[] = {320, 240};
+	guint32 value;
+	guint n_written;
+
+	device = arv_camera_get_device (camera);
+	g_assert (ARV_IS_GV_DEVICE (device));
+
+	g_assert (arv_device_write_registers (device, G_N_ELEMENTS (addresses), addresses, values, &n_written, &error));
+	g_assert (error == NULL);
+	g_assert_cmpint (n_written, ==, 2);
+	g_assert_cmpint (arv_device_get_integer_feature_value (device, "Width", NULL), ==, 320);
+	g_assert_cmpint (arv_device_get_integer_feature_value (device, "Height", NULL), ==, 240);
+
+	arv_camera_begin_batch (camera);
+
+	arv_device_set_integer_feature_value (device, "Width", 640, NULL);
+	arv_device_set_integer_feature_value (device, "Height", 480, NULL);
+	arv_device_write_register (device, ARV_FAKE_CAMERA_REGISTER_TEST, 456, NULL);
+
+	/* Reads during the batch return the queued values */
+	arv_device_read_register (device, ARV_FAKE_CAMERA_REGISTER_WIDTH, &value, NULL);
+	g_assert_cmpint (value, ==, 640);
+	g_assert_cmpint (arv_device_get_integer_feature_value (device, "HeightRegister", NULL), ==, 480);
+
+	g_assert (arv_device_commit_batch (device, &n_written, &error));
+	g_assert (error == NULL);
+	g_assert_cmpint (n_written, ==, 3);
+
+	g_assert_cmpint (arv_device_get_integer_feature_value (device, "Width", NULL), ==, 640);
+	g_assert_cmpint (arv_device_get_integer_feature_value (device, "Height", NULL), ==, 480);
+	arv_device_read_register (device, ARV_FAKE_CAMERA_REGISTER_TEST, &value, NULL);
+	g_assert_cmpint (value, ==, 456);
+
+	arv_device_set_integer_feature_value (device, "Width", 1024, NULL);
+	arv_device_set_integer_feature_value (device, "Height", 1024, NULL);
+}
+
+static void
+read_memory_test (void)
+{
+	ArvDevice *device;
+	GError *error = NULL;
+	char *data;
+	char block[300];
+	unsigned int i;
+
+	device = arv_camera_get_device (camera);
+	g_assert (ARV_IS_GV_DEVICE (device));
+
+	/* Spans several pipelined READMEM commands */
+	data = g_malloc (10 * sizeof (block));
+	g_assert (arv_device_read_memory (device, 0, 10 * sizeof (block), data, &error));
+	g_assert (error == NULL);
+
+	for (i = 0; i < 10; i++) {
+		g_assert (arv_device_read_memory (device, i * sizeof (block), sizeof (block), block, &error));
+		g_assert (error == NULL);
+		g_assert (memcmp (data + i * sizeof (block), block, sizeof (block)) == 0);
+	}
+
+	g_free (data);
+}
+
+static void
+write_memory_test (void)
+{
+	ArvDevice *device;
+	GError *error = NULL;
+	gint64 indexes[ARV_FAKE_CAMERA_LUT_SIZE];
+	gint64 lut[ARV_FAKE_CAMERA_LUT_SIZE];
+	char *data;
+	char *readback;
+	unsigned int i;
+
+	device = arv_camera_get_device (camera);
+	g_assert (ARV_IS_GV_DEVICE (device));
+
+	/* Spans several pipelined WRITEMEM commands */
+	data = g_malloc (3000);
+	readback = g_malloc (3000);
+	for (i = 0; i < 3000; i++)
+		data[i] = i % 251;
+
+	g_assert (arv_device_write_memory (device, 0x2000, 3000, data, &error));
+	g_assert_no_error (error);
+	g_assert (arv_device_read_memory (device, 0x2000, 3000, readback, &error));
+	g_assert_no_error (error);
+	g_assert (memcmp (data, readback, 3000) == 0);
+
+	g_free (data);
+	g_free (readback);
+
+	for (i = 0; i < ARV_FAKE_CAMERA_LUT_SIZE; i++) {
+		indexes[i] = i;
+		lut[i] = i * 8;
+	}
+
+	g_assert (arv_device_set_integer_feature_for_selectors (device, "LUTValue", "LUTIndex",
+								indexes, ARV_FAKE_CAMERA_LUT_SIZE, lut, &error));
+	g_assert_no_error (error);
+
+	arv_device_set_integer_feature_value (device, "LUTIndex", 200, &error);
+	g_assert_no_error (error);
+	g_assert_cmpint (arv_device_get_integer_feature_value (device, "LUTValue", &error), ==, 1600);
+	g_assert_no_error (error);
+}
+
+static void
+genicam_cache_test (void)
+{
+	ArvCamera *cached_camera;
+	GDir *dir;
+	const char *name;
+	g_autofree char *directory = NULL;
+	GSList *filenames = NULL;
+	GSList *iter;
+	gboolean has_xml = FALSE;
+	gboolean has_snapshot = FALSE;
+	gboolean has_address = FALSE;
+	const char *xml;
+	const char *cached_xml;
+	size_t size;
+	size_t cached_size;
+	gint width, height;
+
+	directory = g_dir_make_tmp ("arv-genicam-cache-XXXXXX", NULL);
+	g_assert (directory != NULL);
+
+	arv_enable_genicam_cache (directory);
+
+	/* First connection fills the cache, second one uses it */
+	cached_camera = arv_camera_new ("Aravis-GVTest", NULL);
+	g_assert (ARV_IS_CAMERA (cached_camera));
+	g_object_unref (cached_camera);
+
+	/* The XML data, the snapshot of the DOM tree and the device address */
+	dir = g_dir_open (directory, 0, NULL);
+	g_assert (dir != NULL);
+	while ((name = g_dir_read_name (dir)) != NULL) {
+		has_xml = has_xml || g_str_has_suffix (name, ".xml");
+		has_snapshot = has_snapshot || g_str_has_suffix (name, ".arvgc");
+		has_address = has_address || g_str_has_suffix (name, ".address");
+		filenames = g_slist_prepend (filenames, g_build_filename (directory, name, NULL));
+	}
+	g_dir_close (dir);
+	g_assert (has_xml);
+	g_assert (has_snapshot);
+	g_assert (has_address);
+	g_assert_cmpint (g_slist_length (filenames), ==, 3);
+
+	cached_camera = arv_camera_new ("Aravis-GVTest", NULL);
+	g_assert (ARV_IS_CAMERA (cached_camera));
+
+	xml = arv_device_get_genicam_xml (arv_camera_get_device (camera), &size);
+	cached_xml = arv_device_get_genicam_xml (arv_camera_get_device (cached_camera), &cached_size);
+	g_assert_cmpint (size, ==, cached_size);
+	g_assert (memcmp (xml, cached_xml, size) == 0);
+	arv_camera_get_sensor_size (cached_camera, &width, &height, NULL);
+	g_assert_cmpint (width, ==, ARV_FAKE_CAMERA_SENSOR_WIDTH);
+
+	g_object_unref (cached_camera);
+
+	arv_disable_genicam_cache ();
+
+	for (iter = filenames; iter != NULL; iter = iter->next)
+		g_remove (iter->data);
+	g_slist_free_full (filenames, g_free);
+	g_rmdir (directory);
+}
+
+static gpointer
+command_window_thread (gpointer data)
+{
+	ArvDevice *device = data;
+	guint32 value;
+	int i;
+
+	for (i = 0; i < 50; i++) {
+		if (!arv_device_read_register (device, ARV_FAKE_CAMERA_REGISTER_SENSOR_WIDTH, &value, NULL) ||
+		    value != ARV_FAKE_CAMERA_SENSOR_WIDTH)
+			return GINT_TO_POINTER (FALSE);
+	}
+
+	return GINT_TO_POINTER (TRUE);
+}
+
+static void
+command_window_test (void)
+{
+	ArvDevice *device;
+	GThread *threads[4];
+	unsigned int i;
+
+	device = arv_camera_get_device (camera);
+	g_assert (ARV_IS_GV_DEVICE (device));
+
+	g_assert_cmpint (arv_gv_device_get_command_window (ARV_GV_DEVICE (device)), ==, 1);
+	arv_gv_device_set_command_window (ARV_GV_DEVICE (device), 4);
+	g_assert_cmpint (arv_gv_device_get_command_window (ARV_GV_DEVICE (device)), ==, 4);
+
+	for (i = 0; i < G_N_ELEMENTS (threads); i++)
+		threads[i] = g_thread_new ("command_window", command_window_thread, device);
+
+	for (i = 0; i < G_N_ELEMENTS (threads); i++)
+		g_assert (GPOINTER_TO_INT (g_thread_join (threads[i])));
+
+	arv_gv_device_set_command_window (ARV_GV_DEVICE (device), 1);
+}
+
+#define N_ASYNC_READ_ROUNDS	8
+
+typedef struct {
+	GMainLoop *loop;
+	guint n_pending;
+	guint n_failures;
+	gint64 width;
+	double exposure_time;
+	gboolean test_boolean;
+	char *pixel_format;
+} AsyncReadData;
+
+static void
+_async_read_done (AsyncReadData *data)
+{
+	data->n_pending--;
+	if (data->n_pending == 0)
+		g_main_loop_quit (data->loop);
+}
+
+static void
+_async_read_integer_cb (GObject *source_object, GAsyncResult *result, gpointer user_data)
+{
+	AsyncReadData *data = user_data;
+	GError *error = NULL;
+
+	if (arv_device_get_integer_feature_value_finish (ARV_DEVICE (source_object), result, &error) != data->width ||
+	    error != NULL)
+		data->n_failures++;
+	g_clear_error (&error);
+
+	_async_read_done (data);
+}
+
+static void
+_async_read_float_cb (GObject *source_object, GAsyncResult *result, gpointer user_data)
+{
+	AsyncReadData *data = user_data;
+	GError *error = NULL;
+
+	if (arv_device_get_float_feature_value_finish (ARV_DEVICE (source_object), result, &error) !=
+	    data->exposure_time || error != NULL)
+		data->n_failures++;
+	g_clear_error (&error);
+
+	_async_read_done (data);
+}
+
+static void
+_async_read_boolean_cb (GObject *source_object, GAsyncResult *result, gpointer user_data)
+{
+	AsyncReadData *data = user_data;
+	GError *error = NULL;
+
+	if (arv_device_get_boolean_feature_value_finish (ARV_DEVICE (source_object), result, &error) !=
+	    data->test_boolean || error != NULL)
+		data->n_failures++;
+	g_clear_error (&error);
+
+	_async_read_done (data);
+}
+
+static void
+_async_read_string_cb (GObject *source_object, GAsyncResult *result, gpointer user_data)
+{
+	AsyncReadData *data = user_data;
+	GError *error = NULL;
+	char *value;
+
+	value = arv_device_get_string_feature_value_finish (ARV_DEVICE (source_object), result, &error);
+	if (g_strcmp0 (value, data->pixel_format) != 0 || error != NULL)
+		data->n_failures++;
+	g_clear_error (&error);
+	g_free (value);
+
+	_async_read_done (data);
+}
+
+static void
+async_read_test (void)
+{
+	ArvDevice *device;
+	AsyncReadData data = {0};
+	unsigned int i;
+
+	device = arv_camera_get_device (camera);
+	g_assert (ARV_IS_GV_DEVICE (device));
+
+	data.width = arv_device_get_integer_feature_value (device, "Width", NULL);
+	data.exposure_time = arv_device_get_float_feature_value (device, "ExposureTimeAbs", NULL);
+	data.test_boolean = arv_device_get_boolean_feature_value (device, "TestBoolean", NULL);
+	data.pixel_format = g_strdup (arv_device_get_string_feature_value (device, "PixelFormat", NULL));
+
+	arv_gv_device_set_command_window (ARV_GV_DEVICE (device), 4);
+
+	/* Consecutive reads of all the types are run concurrently */
+	data.loop = g_main_loop_new (NULL, FALSE);
+	data.n_pending = 4 * N_ASYNC_READ_ROUNDS;
+	for (i = 0; i < N_ASYNC_READ_ROUNDS; i++) {
+		arv_device_get_integer_feature_value_async (device, "Width", NULL, _async_read_integer_cb, &data);
+		arv_device_get_float_feature_value_async (device, "ExposureTimeAbs", NULL, _async_read_float_cb, &data);
+		arv_device_get_boolean_feature_value_async (device, "TestBoolean", NULL, _async_read_boolean_cb, &data);
+		arv_device_get_string_feature_value_async (device, "PixelFormat", NULL, _async_read_string_cb, &data);
+	}
+
+	g_main_loop_run (data.loop);
+
+	g_assert_cmpint (data.n_failures, ==, 0);
+
+	arv_gv_device_set_command_window (ARV_GV_DEVICE (device), 1);
+
+	g_free (data.pixel_format);
+	g_main_loop_unref (data.loop);
+}
+
+static void
+round_trip_time_test (void)
+{
+	ArvGvDeviceCommandStatistics statistics;
+	ArvDevice *device;
+	GError *error = NULL;
+	guint32 value;
+	unsigned int i;
+
+	device = arv_camera_get_device (camera);
+	g_assert (ARV_IS_GV_DEVICE (device));
+
+	for (i = 0; i < 16; i++) {
+		arv_device_read_register (device, ARV_GVBS_HEARTBEAT_TIMEOUT_OFFSET, &value, &error);
+		g_assert_no_error (error);
+	}
+
+	arv_gv_device_get_command_statistics (ARV_GV_DEVICE (device), &statistics);
+
+	/* READREG timeouts follow the measured round trip time */
+	g_assert_cmpint (statistics.srtt_us[2], >, 0);
+	g_assert_cmpint (statistics.rto_us[2], >=, ARV_GV_DEVICE_GVCP_RTO_MIN_US);
+	g_assert_cmpint (statistics.rto_us[2], >=, statistics.srtt_us[2]);
+	g_assert_cmpint (statistics.rto_us[2], <=,
+			 ARV_GV_DEVICE_GVCP_TIMEOUT_MS_DEFAULT * 1000 * ARV_GV_DEVICE_GVCP_RTO_MAX_FACTOR);
+	g_assert_cmpstr (arv_gv_device_command_type_names[2], ==, "read_register");
+}
+
 static void
 acquisition_test (void)
 {
@@ -92,36 +503,52 @@ acquisition_test (void)
 }
 
 static void
-new_buffer_cb (ArvStream *stream, unsigned *buffer_count)
+traffic_generator_test (void)
 {
-	ArvBuffer *buffer;
+	gint64 packet_delays[] = {0, 2000};
+	unsigned i;
 
-	buffer = arv_stream_try_pop_buffer (stream);
-	if (buffer != NULL) {
-		(*buffer_count)++;
-		if (*buffer_count == 10) {
-			/* Sleep after the last buffer was received, in order
-			 * to keep a reference to stream while the main loop
-			 * ends. If the main is able to unref stream while
-			 * this signal callback is still waiting, stream will
-			 * be finalized in its stream thread contex (because
-			 * g_signal_emit holds a reference to stream), leading
-			 * to a deadlock. */
-			g_usleep (1000000);
-		}
-		arv_stream_push_buffer (stream, buffer);
+	g_object_set (simulator, "traffic-generator", TRUE, "n-stream-channels", 2, NULL);
+
+	g_assert_cmpint (arv_camera_get_integer (camera, "GevStreamChannelCount", NULL), ==, 2);
+
+	for (i = 0; i < G_N_ELEMENTS (packet_delays); i++) {
+		GError *error = NULL;
+		ArvBuffer *buffer;
+
+		arv_camera_gv_set_packet_delay (camera, packet_delays[i], &error);
+		g_assert (error == NULL);
+		g_assert_cmpint (arv_camera_gv_get_packet_delay (camera, NULL), ==, packet_delays[i]);
+
+		buffer = arv_camera_acquisition (camera, 0, &error);
+		g_assert (error == NULL);
+		g_assert (ARV_IS_BUFFER (buffer));
+		g_assert_cmpint (arv_buffer_get_status (buffer), ==, ARV_BUFFER_STATUS_SUCCESS);
+
+		g_clear_object (&buffer);
 	}
+
+	g_object_set (simulator, "traffic-generator", FALSE, "n-stream-channels", 1, NULL);
 }
 
 static void
-stream_test (void)
+network_impairment_test (void)
 {
 	ArvStream *stream;
+	ArvBuffer *buffer;
 	GError *error = NULL;
+	guint64 n_resent_packets = 0;
 	size_t payload;
-	unsigned buffer_count = 0;
+	unsigned n_completed = 0;
 	unsigned i;
 
+	g_object_set (simulator,
+		      "gvsp-lost-ratio", 0.02,
+		      "gvsp-lost-burst-length", 2,
+		      "gvsp-reorder-window", 4,
+		      "gvsp-duplicate-ratio", 0.01,
+		      NULL);
+
 	stream = arv_camera_create_stream (camera, NULL, NULL, &error);
 	g_assert (ARV_IS_STREAM (stream));
 	g_assert (error == NULL);
@@ -131,97 +558,1445 @@ stream_test (void)
 	for (i = 0; i < 5; i++)
 		arv_stream_push_buffer (stream, arv_buffer_new (payload, NULL));
 
-	g_signal_connect (stream, "new-buffer", G_CALLBACK (new_buffer_cb), &buffer_count);
-	arv_stream_set_emit_signals (stream, TRUE);
-
 	arv_camera_start_acquisition (camera, NULL);
 
-	while (buffer_count < 10)
-		g_usleep (1000);
+	for (i = 0; i < 10; i++) {
+		buffer = arv_stream_timeout_pop_buffer (stream, 1000000);
+		g_assert (ARV_IS_BUFFER (buffer));
+		if (arv_buffer_get_status (buffer) == ARV_BUFFER_STATUS_SUCCESS)
+			n_completed++;
+		arv_stream_push_buffer (stream, buffer);
+	}
 
 	arv_camera_stop_acquisition (camera, NULL);
-	/* The following will block until the signal callback returns
-	 * which avoids a race and possible deadlock.
-	 */
-	arv_stream_set_emit_signals (stream, FALSE);
+
+	/* Lost packets are recovered from the simulator frame history */
+	arv_gv_stream_get_statistics (ARV_GV_STREAM (stream), &n_resent_packets, NULL);
+	g_assert_cmpint (n_resent_packets, >, 0);
+	g_assert_cmpint (n_completed, >, 0);
 
 	g_clear_object (&stream);
 
-	/* For actually testing the deadlock condition (see comment in
-	 * new_buffer_cb), one must wait a bit before leaving this test,
-	 * because otherwise the stream thread will be killed while sleeping. */
-	g_usleep (2000000);
+	g_object_set (simulator,
+		      "gvsp-lost-ratio", 0.0,
+		      "gvsp-lost-burst-length", 1,
+		      "gvsp-reorder-window", 0,
+		      "gvsp-duplicate-ratio", 0.0,
+		      NULL);
 }
 
-#define N_BUFFERS	5
-
-static struct {
-	int width;
-	int height;
-} rois[] = { {100, 100}, {200, 200}, {300,300} };
-
 static void
-dynamic_roi_test (void)
+missing_ranges_test (void)
 {
 	ArvStream *stream;
+	ArvBuffer *buffer;
 	GError *error = NULL;
 	size_t payload;
-	unsigned buffer_count = 0;
+	unsigned n_partial = 0;
 	unsigned i, j;
 
+	g_object_set (simulator, "gvsp-lost-ratio", 0.02, NULL);
+
 	stream = arv_camera_create_stream (camera, NULL, NULL, &error);
 	g_assert (ARV_IS_STREAM (stream));
 	g_assert (error == NULL);
 
+	g_object_set (stream, "packet-resend", ARV_GV_STREAM_PACKET_RESEND_NEVER, NULL);
+
 	payload = arv_camera_get_payload (camera, NULL);
 
-	g_signal_connect (stream, "new-buffer", G_CALLBACK (new_buffer_cb), &buffer_count);
-	arv_stream_set_emit_signals (stream, TRUE);
+	for (i = 0; i < 5; i++)
+		arv_stream_push_buffer (stream, arv_buffer_new (payload, NULL));
 
-	for (j = 0; j < G_N_ELEMENTS (rois); j++) {
-		unsigned int n_deleted;
-		int height, width;
+	arv_camera_start_acquisition (camera, NULL);
 
-		n_deleted = arv_stream_stop_thread (stream, TRUE);
+	for (i = 0; i < 10; i++) {
+		const ArvBufferMissingRange *ranges;
+		guint n_ranges;
+
+		buffer = arv_stream_timeout_pop_buffer (stream, 1000000);
+		g_assert (ARV_IS_BUFFER (buffer));
+
+		ranges = arv_buffer_get_missing_ranges (buffer, &n_ranges);
+		if (arv_buffer_get_status (buffer) == ARV_BUFFER_STATUS_SUCCESS)
+			g_assert (ranges == NULL);
+
+		if (ranges != NULL) {
+			g_assert_cmpint (n_ranges, >, 0);
+			for (j = 0; j < n_ranges; j++) {
+				g_assert_cmpint (ranges[j].size, >, 0);
+				g_assert_cmpint (ranges[j].offset + ranges[j].size, <=, payload);
+				g_assert_cmpint (ranges[j].first_row + ranges[j].n_rows, <=,
+						 arv_buffer_get_image_height (buffer));
+				if (j > 0)
+					g_assert_cmpint (ranges[j].offset, >, ranges[j - 1].offset + ranges[j - 1].size);
+			}
+			n_partial++;
+		}
 
-		if (j == 0)
-			g_assert (n_deleted == 0);
-		else
-			g_assert (n_deleted == N_BUFFERS);
+		arv_stream_push_buffer (stream, buffer);
+	}
 
-		buffer_count = 0;
+	arv_camera_stop_acquisition (camera, NULL);
 
-		arv_camera_set_region (camera, 0, 0, rois[j].width , rois[j].height, NULL);
-		arv_camera_get_region (camera, NULL, NULL, &width, &height, NULL);
+	g_assert_cmpint (n_partial, >, 0);
 
-		g_assert (width == rois[j].width);
-		g_assert (height == rois[j].height);
+	g_clear_object (&stream);
 
-		payload = arv_camera_get_payload (camera, NULL);
+	g_object_set (simulator, "gvsp-lost-ratio", 0.0, NULL);
+}
 
-		for (i = 0; i < N_BUFFERS; i++)
-			arv_stream_push_buffer (stream, arv_buffer_new (payload, NULL));
+/* Crafted packets are fed to a stream through the replay of a packet record, the resend requests being counted but
+ * not sent */
 
-		arv_stream_start_thread (stream);
+#define REPLAY_PACKET_SIZE	65536
 
-		arv_camera_start_acquisition (camera, NULL);
+static ArvPacketRecorder *
+_replay_record_new (char **filename)
+{
+	ArvPacketRecorder *recorder;
+	GError *error = NULL;
+	int fd;
 
-		while (buffer_count < 10) {
-			g_usleep (10000);
-		}
+	fd = g_file_open_tmp ("arv-fakegv-replay-XXXXXX", filename, &error);
+	g_assert_no_error (error);
+	g_close (fd, NULL);
 
-		arv_camera_stop_acquisition (camera, NULL);
-	}
+	recorder = arv_packet_recorder_new (*filename, ARV_PACKET_RECORD_PROTOCOL_GVSP, 1 << 20, &error);
+	g_assert_no_error (error);
+	g_assert (recorder != NULL);
 
-	arv_stream_set_emit_signals (stream, FALSE);
+	return recorder;
+}
 
-	g_clear_object (&stream);
+static void
+_replay_record_data_block (ArvPacketRecorder *recorder, guint64 time_us, guint16 frame_id, guint32 packet_id,
+			   const guint8 *data, size_t block_size)
+{
+	char packet[REPLAY_PACKET_SIZE];
+	size_t packet_size = sizeof (packet);
+
+	/* Block n holds the bytes n - 1 of the payload, see _check_replay_data () */
+	g_assert (arv_gvsp_packet_new_data_block (frame_id, packet_id, block_size,
+						  (void *) (data + (packet_id - 1) * block_size),
+						  packet, &packet_size) != NULL);
+	g_assert (arv_packet_recorder_write (recorder, time_us, packet, packet_size));
+}
+
+static ArvStream *
+_replay_stream_new (const char *filename, size_t buffer_size, guint n_buffers)
+{
+	ArvStream *stream;
+	GError *error = NULL;
+	guint i;
+
+	stream = arv_camera_create_stream (camera, NULL, NULL, &error);
+	g_assert_no_error (error);
+	g_assert (ARV_IS_GV_STREAM (stream));
+
+	/* The replay is applied when the stream thread starts */
+	arv_stream_stop_thread (stream, TRUE);
+	g_object_set (stream, "replay-filename", filename, NULL);
+
+	for (i = 0; i < n_buffers; i++)
+		arv_stream_push_buffer (stream, arv_buffer_new (buffer_size, NULL));
+
+	return stream;
+}
+
+#define REPLAY_N_BLOCKS		10
+
+static void
+resend_coalescing_test (void)
+{
+	ArvPacketRecorder *recorder;
+	ArvStream *stream;
+	ArvBuffer *buffer;
+	char packet[REPLAY_PACKET_SIZE];
+	size_t packet_size;
+	size_t block_size;
+	guint8 *data;
+	char *filename;
+	guint i;
+
+	block_size = arv_camera_gv_get_packet_size (camera, NULL) - ARV_GVSP_PACKET_PROTOCOL_OVERHEAD;
+	data = g_malloc (REPLAY_N_BLOCKS * block_size);
+	for (i = 0; i < REPLAY_N_BLOCKS * block_size; i++)
+		data[i] = i % 251;
+
+	recorder = _replay_record_new (&filename);
+
+	/* Packets 1 to 9 lost, then every other one received after the first request, before the trailer arrives
+	 * after the resend timeout */
+	packet_size = sizeof (packet);
+	arv_gvsp_packet_new_data_leader (1, 0, 0, ARV_PIXEL_FORMAT_MONO_8, block_size, REPLAY_N_BLOCKS, 0, 0,
+					 packet, &packet_size);
+	g_assert (arv_packet_recorder_write (recorder, 0, packet, packet_size));
+	_replay_record_data_block (recorder, 0, 1, 10, data, block_size);
+	for (i = 2; i < REPLAY_N_BLOCKS; i += 2)
+		_replay_record_data_block (recorder, 1000, 1, i, data, block_size);
+	packet_size = sizeof (packet);
+	arv_gvsp_packet_new_data_trailer (1, REPLAY_N_BLOCKS + 1, packet, &packet_size);
+	g_assert (arv_packet_recorder_write (recorder, 30000, packet, packet_size));
+	for (i = 1; i < REPLAY_N_BLOCKS; i += 2)
+		_replay_record_data_block (recorder, 31000, 1, i, data, block_size);
+
+	arv_packet_recorder_free (recorder);
+
+	stream = _replay_stream_new (filename, REPLAY_N_BLOCKS * block_size, 1);
+	g_object_set (stream,
+		      "packet-timeout", 20000,
+		      "packet-request-ratio", 1.0,
+		      NULL);
+	arv_stream_start_thread (stream);
+
+	buffer = arv_stream_timeout_pop_buffer (stream, 1000000);
+	g_assert (ARV_IS_BUFFER (buffer));
+	g_assert_cmpint (arv_buffer_get_status (buffer), ==, ARV_BUFFER_STATUS_SUCCESS);
+	g_assert (memcmp (arv_buffer_get_data (buffer, NULL), data, REPLAY_N_BLOCKS * block_size) == 0);
+
+	/* 9 packets first requested, then the 5 still missing in the same range, in a single request */
+	g_assert_cmpint (arv_stream_get_info_uint64_by_name (stream, "n_resend_requests"), ==, 9 + 5);
+	g_assert_cmpint (arv_stream_get_info_uint64_by_name (stream, "n_resent_packets"), ==, 9);
+	g_assert_cmpint (arv_stream_get_info_uint64_by_name (stream, "n_resend_ratio_reached"), ==, 0);
+
+	g_object_unref (buffer);
+	g_object_unref (stream);
+
+	g_unlink (filename);
+	g_free (filename);
+	g_free (data);
+}
+
+static void
+_replay_record_multipart_block (ArvPacketRecorder *recorder, guint64 time_us, guint16 frame_id, guint32 packet_id,
+				guint part_id, guint64 offset, const guint8 *data, size_t size)
+{
+	char packet[REPLAY_PACKET_SIZE];
+	size_t packet_size = sizeof (packet);
+
+	g_assert (arv_gvsp_packet_new_multipart_block (frame_id, packet_id, part_id, offset, size,
+						       (void *) data, packet, &packet_size) != NULL);
+	g_assert (arv_packet_recorder_write (recorder, time_us, packet, packet_size));
+}
+
+static void
+multipart_reassembly_test (void)
+{
+	ArvPacketRecorder *recorder;
+	ArvGvspPacket *leader;
+	ArvStream *stream;
+	ArvBuffer *buffer;
+	char packet[REPLAY_PACKET_SIZE];
+	size_t packet_size;
+	size_t block_size;
+	size_t part_sizes[2];
+	const guint8 *part_data;
+	guint8 *data[2];
+	guint8 wrong_data = 0xff;
+	size_t size;
+	char *filename;
+	gint x, y, width, height;
+	guint i, j;
+
+	/* The multipart packet count, 6, is larger than the one of an image payload of the same size, 5 */
+	block_size = arv_camera_gv_get_packet_size (camera, NULL) - ARV_GVSP_PACKET_PROTOCOL_OVERHEAD -
+		sizeof (ArvGvspMultipart);
+	part_sizes[0] = block_size + 1;
+	part_sizes[1] = 2 * block_size - 10;
+	for (i = 0; i < 2; i++) {
+		data[i] = g_malloc (part_sizes[i]);
+		for (j = 0; j < part_sizes[i]; j++)
+			data[i][j] = (j + i * 7) % 251;
+	}
+
+	recorder = _replay_record_new (&filename);
+
+	/* Data block received before the leader, with a wrong content, cleared then requested again */
+	_replay_record_multipart_block (recorder, 0, 1, 2, 0, block_size, &wrong_data, 1);
+
+	packet_size = sizeof (packet);
+	leader = arv_gvsp_packet_new_multipart_leader (1, 0, 0, 2, packet, &packet_size);
+	g_assert (leader != NULL);
+	arv_gvsp_packet_set_part_infos (leader, 0, ARV_BUFFER_PART_DATA_TYPE_2D_IMAGE, ARV_PIXEL_FORMAT_MONO_8,
+					part_sizes[0], part_sizes[0], 1, 0, 0);
+	arv_gvsp_packet_set_part_infos (leader, 1, ARV_BUFFER_PART_DATA_TYPE_2D_IMAGE, ARV_PIXEL_FORMAT_MONO_16,
+					part_sizes[1], part_sizes[1] / 2, 1, 0, 1);
+	g_assert (arv_packet_recorder_write (recorder, 100, packet, packet_size));
+
+	/* Last block of the second part received before its first one */
+	_replay_record_multipart_block (recorder, 200, 1, 1, 0, 0, data[0], block_size);
+	_replay_record_multipart_block (recorder, 300, 1, 4, 1, block_size, data[1] + block_size, block_size - 10);
+	_replay_record_multipart_block (recorder, 400, 1, 3, 1, 0, data[1], block_size);
+
+	packet_size = sizeof (packet);
+	arv_gvsp_packet_new_data_trailer (1, 5, packet, &packet_size);
+	g_assert (arv_packet_recorder_write (recorder, 500, packet, packet_size));
+
+	_replay_record_multipart_block (recorder, 1000, 1, 2, 0, block_size, data[0] + block_size, 1);
+
+	arv_packet_recorder_free (recorder);
+
+	stream = _replay_stream_new (filename, part_sizes[0] + part_sizes[1], 1);
+	g_object_set (stream, "packet-request-ratio", 2.0, NULL);
+	arv_stream_start_thread (stream);
+
+	buffer = arv_stream_timeout_pop_buffer (stream, 1000000);
+	g_assert (ARV_IS_BUFFER (buffer));
+	g_assert_cmpint (arv_buffer_get_status (buffer), ==, ARV_BUFFER_STATUS_SUCCESS);
+	g_assert_cmpint (arv_buffer_get_payload_type (buffer), ==, ARV_BUFFER_PAYLOAD_TYPE_MULTIPART);
+	g_assert_cmpint (arv_buffer_get_frame_id (buffer), ==, 1);
+	g_assert_cmpint (arv_buffer_get_n_parts (buffer), ==, 2);
+
+	for (i = 0; i < 2; i++) {
+		part_data = arv_buffer_get_part_data (buffer, i, &size);
+		g_assert_cmpint (size, ==, part_sizes[i]);
+		g_assert (memcmp (part_data, data[i], size) == 0);
+
+		arv_buffer_get_part_region (buffer, i, &x, &y, &width, &height);
+		g_assert_cmpint (x, ==, 0);
+		g_assert_cmpint (y, ==, i);
+		g_assert_cmpint (width, ==, i == 0 ? part_sizes[0] : part_sizes[1] / 2);
+		g_assert_cmpint (height, ==, 1);
+		g_assert_cmpint (arv_buffer_get_part_pixel_format (buffer, i), ==,
+				 i == 0 ? ARV_PIXEL_FORMAT_MONO_8 : ARV_PIXEL_FORMAT_MONO_16);
+	}
+	g_assert (arv_buffer_get_part_data (buffer, 1, NULL) ==
+		  (const guint8 *) arv_buffer_get_part_data (buffer, 0, NULL) + part_sizes[0]);
+
+	g_assert_cmpint (arv_stream_get_info_uint64_by_name (stream, "n_resend_requests"), >, 0);
+	g_assert_cmpint (arv_stream_get_info_uint64_by_name (stream, "n_resent_packets"), >, 0);
+
+	g_object_unref (buffer);
+	g_object_unref (stream);
+
+	g_unlink (filename);
+	g_free (filename);
+	for (i = 0; i < 2; i++)
+		g_free (data[i]);
+}
+
+#define ALL_IN_WIDTH	32
+#define ALL_IN_HEIGHT	32
+
+static void
+all_in_test (void)
+{
+	ArvPacketRecorder *recorder;
+	ArvStream *stream;
+	ArvBuffer *buffer;
+	char packet[REPLAY_PACKET_SIZE];
+	size_t packet_size;
+	size_t size;
+	const void *buffer_data;
+	guint8 *data;
+	char *filename;
+	gint x, y, width, height;
+	guint i;
+
+	/* One more line than the buffer size for the second frame */
+	data = g_malloc (ALL_IN_WIDTH * (ALL_IN_HEIGHT + 1));
+	for (i = 0; i < ALL_IN_WIDTH * (ALL_IN_HEIGHT + 1); i++)
+		data[i] = i % 251;
+
+	recorder = _replay_record_new (&filename);
+
+	packet_size = sizeof (packet);
+	g_assert (arv_gvsp_packet_new_all_in (1, 0, 0, ARV_PIXEL_FORMAT_MONO_8, ALL_IN_WIDTH, ALL_IN_HEIGHT, 2, 3,
+					      ALL_IN_WIDTH * ALL_IN_HEIGHT, data, packet, &packet_size) != NULL);
+	g_assert (arv_packet_recorder_write (recorder, 0, packet, packet_size));
+
+	packet_size = sizeof (packet);
+	g_assert (arv_gvsp_packet_new_all_in (2, 0, 0, ARV_PIXEL_FORMAT_MONO_8, ALL_IN_WIDTH, ALL_IN_HEIGHT + 1, 0, 0,
+					      ALL_IN_WIDTH * (ALL_IN_HEIGHT + 1), data, packet, &packet_size) != NULL);
+	g_assert (arv_packet_recorder_write (recorder, 1000, packet, packet_size));
+
+	arv_packet_recorder_free (recorder);
+
+	stream = _replay_stream_new (filename, ALL_IN_WIDTH * ALL_IN_HEIGHT, 2);
+	arv_stream_start_thread (stream);
+
+	buffer = arv_stream_timeout_pop_buffer (stream, 1000000);
+	g_assert (ARV_IS_BUFFER (buffer));
+	g_assert_cmpint (arv_buffer_get_status (buffer), ==, ARV_BUFFER_STATUS_SUCCESS);
+	g_assert_cmpint (arv_buffer_get_payload_type (buffer), ==, ARV_BUFFER_PAYLOAD_TYPE_IMAGE);
+	g_assert_cmpint (arv_buffer_get_frame_id (buffer), ==, 1);
+	arv_buffer_get_image_region (buffer, &x, &y, &width, &height);
+	g_assert_cmpint (x, ==, 2);
+	g_assert_cmpint (y, ==, 3);
+	g_assert_cmpint (width, ==, ALL_IN_WIDTH);
+	g_assert_cmpint (height, ==, ALL_IN_HEIGHT);
+	g_assert_cmpint (arv_buffer_get_image_pixel_format (buffer), ==, ARV_PIXEL_FORMAT_MONO_8);
+	buffer_data = arv_buffer_get_data (buffer, &size);
+	g_assert_cmpint (size, ==, ALL_IN_WIDTH * ALL_IN_HEIGHT);
+	g_assert (memcmp (buffer_data, data, size) == 0);
+	g_object_unref (buffer);
+
+	/* The payload doesn't fit in the buffer */
+	buffer = arv_stream_timeout_pop_buffer (stream, 1000000);
+	g_assert (ARV_IS_BUFFER (buffer));
+	g_assert_cmpint (arv_buffer_get_status (buffer), ==, ARV_BUFFER_STATUS_SIZE_MISMATCH);
+	g_assert_cmpint (arv_buffer_get_frame_id (buffer), ==, 2);
+	g_object_unref (buffer);
+
+	g_object_unref (stream);
+
+	g_unlink (filename);
+	g_free (filename);
+	g_free (data);
+}
+
+static void
+farm_test (void)
+{
+	ArvGvFakeCameraFarm *farm;
+	ArvCamera *farm_camera;
+	ArvBuffer *buffer;
+	GError *error = NULL;
+
+	farm = arv_gv_fake_camera_farm_new ("lo", "127.0.1.1", 4, 2);
+	g_assert (ARV_IS_GV_FAKE_CAMERA_FARM (farm));
+	g_assert (arv_gv_fake_camera_farm_is_running (farm));
+	g_assert_cmpint (arv_gv_fake_camera_farm_get_n_cameras (farm), ==, 4);
+	g_assert (ARV_IS_GV_FAKE_CAMERA (arv_gv_fake_camera_farm_get_camera (farm, 3)));
+	g_assert (arv_gv_fake_camera_farm_get_camera (farm, 4) == NULL);
+
+	farm_camera = arv_camera_new ("127.0.1.3", &error);
+	g_assert (ARV_IS_CAMERA (farm_camera));
+	g_assert (error == NULL);
+	g_assert_cmpstr (arv_camera_get_device_serial_number (farm_camera, NULL), ==, "GVF0002");
+
+	buffer = arv_camera_acquisition (farm_camera, 0, &error);
+	g_assert (error == NULL);
+	g_assert (ARV_IS_BUFFER (buffer));
+	g_assert_cmpint (arv_buffer_get_status (buffer), ==, ARV_BUFFER_STATUS_SUCCESS);
+
+	g_clear_object (&buffer);
+	g_clear_object (&farm_camera);
+	g_clear_object (&farm);
+}
+
+static void
+control_thread_test (void)
+{
+	ArvGvDeviceCommandStatistics before;
+	ArvGvDeviceCommandStatistics after;
+	ArvGvFakeCamera *control_simulator;
+	ArvCamera *control_camera;
+	ArvDevice *device;
+	ArvBuffer *buffer;
+	GError *error = NULL;
+	gint64 start_us;
+	guint32 value;
+	unsigned int i;
+
+	control_simulator = g_object_new (ARV_TYPE_GV_FAKE_CAMERA,
+					  "interface-name", "lo",
+					  "serial-number", "GVControl",
+					  "address", "127.0.2.1",
+					  "control-thread", TRUE,
+					  "gvcp-ack-latency", 20000,
+					  "gvcp-pending-ack", TRUE,
+					  NULL);
+	g_assert (ARV_IS_GV_FAKE_CAMERA (control_simulator));
+	g_assert (arv_gv_fake_camera_is_running (control_simulator));
+
+	control_camera = arv_camera_new ("127.0.2.1", &error);
+	g_assert_no_error (error);
+	g_assert (ARV_IS_CAMERA (control_camera));
+
+	device = arv_camera_get_device (control_camera);
+	g_assert (ARV_IS_GV_DEVICE (device));
+
+	arv_gv_device_get_command_statistics (ARV_GV_DEVICE (device), &before);
+
+	start_us = g_get_monotonic_time ();
+	for (i = 0; i < 4; i++) {
+		arv_device_read_register (device, ARV_GVBS_HEARTBEAT_TIMEOUT_OFFSET, &value, &error);
+		g_assert_no_error (error);
+	}
+	g_assert_cmpint (g_get_monotonic_time () - start_us, >=, 4 * 20000);
+
+	/* The delayed acknowledges are announced */
+	arv_gv_device_get_command_statistics (ARV_GV_DEVICE (device), &after);
+	g_assert_cmpint (after.n_pending_acks - before.n_pending_acks, >=, 4);
+
+	buffer = arv_camera_acquisition (control_camera, 0, &error);
+	g_assert_no_error (error);
+	g_assert (ARV_IS_BUFFER (buffer));
+	g_assert_cmpint (arv_buffer_get_status (buffer), ==, ARV_BUFFER_STATUS_SUCCESS);
+
+	g_clear_object (&buffer);
+	g_clear_object (&control_camera);
+	g_clear_object (&control_simulator);
+}
+
+static void
+stream_options_test (void)
+{
+	struct {
+		ArvGvStreamOption options;
+		gboolean multipart;
+	} cases[] = {
+		{ARV_GV_STREAM_OPTION_PACKET_SOCKET_DISABLED, FALSE},
+		{ARV_GV_STREAM_OPTION_PACKET_SOCKET_DISABLED | ARV_GV_STREAM_OPTION_BATCH_RECEIVE_ENABLED, FALSE},
+		{ARV_GV_STREAM_OPTION_PACKET_SOCKET_DISABLED | ARV_GV_STREAM_OPTION_ZERO_COPY_ENABLED, FALSE},
+		{ARV_GV_STREAM_OPTION_PACKET_SOCKET_DISABLED | ARV_GV_STREAM_OPTION_ZERO_COPY_ENABLED, TRUE},
+		{ARV_GV_STREAM_OPTION_PACKET_SOCKET_DISABLED | ARV_GV_STREAM_OPTION_LOW_LATENCY_ENABLED, FALSE},
+		{ARV_GV_STREAM_OPTION_PACKET_SOCKET_DISABLED | ARV_GV_STREAM_OPTION_IO_URING_ENABLED, FALSE},
+		{ARV_GV_STREAM_OPTION_PACKET_SOCKET_DISABLED | ARV_GV_STREAM_OPTION_PREFETCH_ENABLED |
+		 ARV_GV_STREAM_OPTION_NON_TEMPORAL_COPY_ENABLED, FALSE},
+		{ARV_GV_STREAM_OPTION_SHARED_RECEIVER_ENABLED, FALSE}
+	};
+	unsigned i;
+
+	for (i = 0; i < G_N_ELEMENTS (cases); i++) {
+		GError *error = NULL;
+		ArvBuffer *buffer;
+
+		arv_camera_gv_set_stream_options (camera, cases[i].options);
+		g_object_set (simulator, "gvsp-multipart", cases[i].multipart, NULL);
+
+		buffer = arv_camera_acquisition (camera, 0, &error);
+		g_assert (error == NULL);
+		g_assert (ARV_IS_BUFFER (buffer));
+		g_assert_cmpint (arv_buffer_get_status (buffer), ==, ARV_BUFFER_STATUS_SUCCESS);
+		g_assert_cmpint (arv_buffer_get_payload_type (buffer), ==,
+				 cases[i].multipart ? ARV_BUFFER_PAYLOAD_TYPE_MULTIPART : ARV_BUFFER_PAYLOAD_TYPE_IMAGE);
+		if (cases[i].multipart)
+			g_assert_cmpint (arv_buffer_get_n_parts (buffer), ==, 2);
+
+		g_clear_object (&buffer);
+	}
+
+	arv_camera_gv_set_stream_options (camera, ARV_GV_STREAM_OPTION_NONE);
+	g_object_set (simulator, "gvsp-multipart", FALSE, NULL);
+}
+
+static void
+stream_channel_test (void)
+{
+	GError *error = NULL;
+	ArvStream *stream;
+	guint channel = G_MAXUINT;
+
+	stream = arv_camera_gv_create_channel_stream (camera, 0, NULL, NULL, &error);
+	g_assert (error == NULL);
+	g_assert (ARV_IS_GV_STREAM (stream));
+
+	g_object_get (stream, "channel", &channel, NULL);
+	g_assert_cmpint (channel, ==, 0);
+
+	g_clear_object (&stream);
+
+	stream = arv_camera_gv_create_channel_stream (camera, 1, NULL, NULL, &error);
+	g_assert_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_NO_STREAM_CHANNEL);
+	g_assert (stream == NULL);
+
+	g_clear_error (&error);
+}
+
+static void
+cached_packet_size_test (void)
+{
+	GError *error = NULL;
+	ArvStream *stream;
+	guint packet_size;
+	int i;
+
+	packet_size = arv_camera_gv_get_packet_size (camera, &error);
+	g_assert (error == NULL);
+
+	arv_camera_gv_set_packet_size_adjustment (camera, ARV_GV_PACKET_SIZE_ADJUSTMENT_CACHED);
+
+	for (i = 0; i < 2; i++) {
+		stream = arv_camera_create_stream (camera, NULL, NULL, &error);
+		g_assert (error == NULL);
+		g_assert (ARV_IS_GV_STREAM (stream));
+		g_clear_object (&stream);
+
+		g_assert_cmpint (arv_camera_gv_get_packet_size (camera, NULL), ==, packet_size);
+	}
+
+	arv_camera_gv_set_packet_size_adjustment (camera, ARV_GV_PACKET_SIZE_ADJUSTMENT_DEFAULT);
+}
+
+static void
+adaptive_socket_buffer_test (void)
+{
+	GError *error = NULL;
+	ArvStream *stream;
+	ArvBuffer *buffer;
+	size_t payload;
+	int i;
+
+	stream = arv_camera_create_stream (camera, NULL, NULL, &error);
+	g_assert (error == NULL);
+	g_assert (ARV_IS_GV_STREAM (stream));
+
+	g_object_set (stream,
+		      "socket-buffer", ARV_GV_STREAM_SOCKET_BUFFER_ADAPTIVE,
+		      "socket-buffer-size", 0,
+		      NULL);
+
+	payload = arv_camera_get_payload (camera, NULL);
+	for (i = 0; i < 2; i++)
+		arv_stream_push_buffer (stream, arv_buffer_new (payload, NULL));
+
+	arv_camera_start_acquisition (camera, NULL);
+	buffer = arv_stream_timeout_pop_buffer (stream, 1000000);
+	arv_camera_stop_acquisition (camera, NULL);
+
+	g_assert (ARV_IS_BUFFER (buffer));
+	g_assert_cmpint (arv_stream_get_info_uint64_by_name (stream, "socket_buffer_size"), >=, MAX (payload, 1 << 20));
+
+	g_clear_object (&buffer);
+	g_clear_object (&stream);
+}
+
+/* The regions of the first frame received without error, written by the stream thread until its end */
+
+typedef struct {
+	GArray *regions;
+	size_t buffer_size;
+	gboolean done;
+} RegionReadyData;
+
+typedef struct {
+	size_t offset;
+	size_t size;
+} RegionReadyRegion;
+
+static void
+region_ready_cb (void *user_data, ArvStreamCallbackType type, ArvBuffer *buffer)
+{
+	RegionReadyData *data = user_data;
+	RegionReadyRegion region;
+
+	if (data->done)
+		return;
+
+	switch (type) {
+		case ARV_STREAM_CALLBACK_TYPE_START_BUFFER:
+			g_array_set_size (data->regions, 0);
+			break;
+		case ARV_STREAM_CALLBACK_TYPE_REGION_READY:
+			arv_buffer_get_ready_region (buffer, &region.offset, &region.size);
+			g_array_append_val (data->regions, region);
+			break;
+		case ARV_STREAM_CALLBACK_TYPE_BUFFER_DONE:
+			if (arv_buffer_get_status (buffer) == ARV_BUFFER_STATUS_SUCCESS) {
+				arv_buffer_get_data (buffer, &data->buffer_size);
+				data->done = TRUE;
+			} else
+				g_array_set_size (data->regions, 0);
+			break;
+		default:
+			break;
+	}
+}
+
+static void
+region_ready_test (void)
+{
+	RegionReadyData data = {NULL, 0, FALSE};
+	GError *error = NULL;
+	ArvStream *stream;
+	ArvBuffer *buffer;
+	size_t granularity;
+	size_t offset = 0;
+	size_t payload;
+	unsigned i;
+
+	data.regions = g_array_new (FALSE, FALSE, sizeof (RegionReadyRegion));
+
+	stream = arv_camera_create_stream (camera, region_ready_cb, &data, &error);
+	g_assert (error == NULL);
+	g_assert (ARV_IS_GV_STREAM (stream));
+
+	/* Not a multiple of the data block size */
+	granularity = 3 * (arv_camera_gv_get_packet_size (camera, NULL) - ARV_GVSP_PACKET_PROTOCOL_OVERHEAD) + 1;
+	g_object_set (stream, "region-ready-size", (guint) granularity, NULL);
+
+	payload = arv_camera_get_payload (camera, NULL);
+	for (i = 0; i < 2; i++)
+		arv_stream_push_buffer (stream, arv_buffer_new (payload, NULL));
+
+	arv_camera_start_acquisition (camera, NULL);
+	for (i = 0; i < 10; i++) {
+		ArvBufferStatus status;
+
+		buffer = arv_stream_timeout_pop_buffer (stream, 1000000);
+		g_assert (ARV_IS_BUFFER (buffer));
+		status = arv_buffer_get_status (buffer);
+		arv_stream_push_buffer (stream, buffer);
+
+		if (status == ARV_BUFFER_STATUS_SUCCESS)
+			break;
+	}
+	arv_camera_stop_acquisition (camera, NULL);
+
+	/* Stops the stream thread */
+	g_clear_object (&stream);
+
+	g_assert (data.done);
+	g_assert_cmpint (data.buffer_size, ==, payload);
+	g_assert_cmpint (data.regions->len, >, 0);
+
+	for (i = 0; i < data.regions->len; i++) {
+		RegionReadyRegion *region = &g_array_index (data.regions, RegionReadyRegion, i);
+
+		g_assert_cmpint (region->offset, ==, offset);
+		g_assert_cmpint (region->size, >, 0);
+		if (i < data.regions->len - 1)
+			g_assert_cmpint (region->size, >=, granularity);
+		offset += region->size;
+	}
+	g_assert_cmpint (offset, ==, data.buffer_size);
+
+	g_array_unref (data.regions);
+}
+
+static void
+new_buffer_cb (ArvStream *stream, unsigned *buffer_count)
+{
+	ArvBuffer *buffer;
+
+	buffer = arv_stream_try_pop_buffer (stream);
+	if (buffer != NULL) {
+		(*buffer_count)++;
+		if (*buffer_count == 10) {
+			/* Sleep after the last buffer was received, in order
+			 * to keep a reference to stream while the main loop
+			 * ends. If the main is able to unref stream while
+			 * this signal callback is still waiting, stream will
+			 * be finalized in its stream thread contex (because
+			 * g_signal_emit holds a reference to stream), leading
+			 * to a deadlock. */
+			g_usleep (1000000);
+		}
+		arv_stream_push_buffer (stream, buffer);
+	}
+}
+
+static void
+stream_test (void)
+{
+	ArvStream *stream;
+	GError *error = NULL;
+	size_t payload;
+	guint64 n_avoided_allocations = 0;
+	unsigned buffer_count = 0;
+	unsigned i;
+
+	stream = arv_camera_create_stream (camera, NULL, NULL, &error);
+	g_assert (ARV_IS_STREAM (stream));
+	g_assert (error == NULL);
+
+	payload = arv_camera_get_payload (camera, NULL);
+
+	for (i = 0; i < 5; i++)
+		arv_stream_push_buffer (stream, arv_buffer_new (payload, NULL));
+
+	g_signal_connect (stream, "new-buffer", G_CALLBACK (new_buffer_cb), &buffer_count);
+	arv_stream_set_emit_signals (stream, TRUE);
+
+	arv_camera_start_acquisition (camera, NULL);
+
+	while (buffer_count < 10)
+		g_usleep (1000);
+
+	arv_camera_stop_acquisition (camera, NULL);
+	/* The following will block until the signal callback returns
+	 * which avoids a race and possible deadlock.
+	 */
+	arv_stream_set_emit_signals (stream, FALSE);
+
+	/* Frame structures are recycled once the first frame is closed */
+	n_avoided_allocations = arv_stream_get_info_uint64_by_name (stream, "n_avoided_allocations");
+	g_assert_cmpint (n_avoided_allocations, >, 0);
+
+	g_clear_object (&stream);
+
+	/* For actually testing the deadlock condition (see comment in
+	 * new_buffer_cb), one must wait a bit before leaving this test,
+	 * because otherwise the stream thread will be killed while sleeping. */
+	g_usleep (2000000);
+}
+
+static void
+early_completion_test (void)
+{
+	ArvStream *stream;
+	ArvBuffer *buffer;
+	GError *error = NULL;
+	size_t payload;
+	unsigned i;
+
+	stream = arv_camera_create_stream (camera, NULL, NULL, &error);
+	g_assert (ARV_IS_STREAM (stream));
+	g_assert (error == NULL);
+
+	g_object_set (stream, "early-completion", TRUE, NULL);
+
+	payload = arv_camera_get_payload (camera, NULL);
+
+	for (i = 0; i < 5; i++)
+		arv_stream_push_buffer (stream, arv_buffer_new (payload, NULL));
+
+	arv_camera_start_acquisition (camera, NULL);
+
+	for (i = 0; i < 5; i++) {
+		buffer = arv_stream_timeout_pop_buffer (stream, 1000000);
+		g_assert (ARV_IS_BUFFER (buffer));
+		g_assert_cmpint (arv_buffer_get_status (buffer), ==, ARV_BUFFER_STATUS_SUCCESS);
+		arv_stream_push_buffer (stream, buffer);
+	}
+
+	arv_camera_stop_acquisition (camera, NULL);
+
+	g_clear_object (&stream);
+}
+
+static void
+reorder_window_test (void)
+{
+	ArvStream *stream;
+	ArvBuffer *buffer;
+	GError *error = NULL;
+	guint64 last_frame_id = 0;
+	guint reorder_window;
+	size_t payload;
+	unsigned i;
+
+	g_object_set (simulator, "gvsp-reorder-window", 8, NULL);
+
+	stream = arv_camera_create_stream (camera, NULL, NULL, &error);
+	g_assert (ARV_IS_STREAM (stream));
+	g_assert (error == NULL);
+
+	g_object_set (stream, "reorder-window", 4, NULL);
+	g_object_get (stream, "reorder-window", &reorder_window, NULL);
+	g_assert_cmpint (reorder_window, ==, 4);
+
+	payload = arv_camera_get_payload (camera, NULL);
+
+	for (i = 0; i < 5; i++)
+		arv_stream_push_buffer (stream, arv_buffer_new (payload, NULL));
+
+	arv_camera_start_acquisition (camera, NULL);
+
+	for (i = 0; i < 10; i++) {
+		buffer = arv_stream_timeout_pop_buffer (stream, 1000000);
+		g_assert (ARV_IS_BUFFER (buffer));
+		g_assert_cmpint (arv_buffer_get_status (buffer), ==, ARV_BUFFER_STATUS_SUCCESS);
+		if (i > 0)
+			g_assert_cmpint (arv_buffer_get_frame_id (buffer), >, last_frame_id);
+		last_frame_id = arv_buffer_get_frame_id (buffer);
+		arv_stream_push_buffer (stream, buffer);
+	}
+
+	arv_camera_stop_acquisition (camera, NULL);
+
+	g_clear_object (&stream);
+
+	g_object_set (simulator, "gvsp-reorder-window", 0, NULL);
+}
+
+static void
+counting_copy (void *dst, const void *src, size_t size, void *user_data)
+{
+	memcpy (dst, src, size);
+	g_atomic_int_add ((gint *) user_data, size);
+}
+
+static void
+copy_destroy_cb (void *user_data)
+{
+	*(gint *) user_data = 0;
+}
+
+static void
+copy_kernel_test (void)
+{
+	ArvStream *stream;
+	ArvBuffer *buffer;
+	GError *error = NULL;
+	gint n_copied_bytes = 0;
+	size_t payload;
+	unsigned i;
+
+	stream = arv_camera_create_stream (camera, NULL, NULL, &error);
+	g_assert (ARV_IS_STREAM (stream));
+	g_assert (error == NULL);
+
+	g_assert_cmpint (arv_stream_get_copy_kernel (stream), ==, ARV_STREAM_COPY_KERNEL_DEFAULT);
+
+	/* A custom kernel needs a function */
+	arv_stream_set_copy_kernel (stream, ARV_STREAM_COPY_KERNEL_CUSTOM);
+	g_assert_cmpint (arv_stream_get_copy_kernel (stream), ==, ARV_STREAM_COPY_KERNEL_DEFAULT);
+
+	arv_stream_set_copy_function (stream, counting_copy, &n_copied_bytes, copy_destroy_cb);
+	g_assert_cmpint (arv_stream_get_copy_kernel (stream), ==, ARV_STREAM_COPY_KERNEL_CUSTOM);
+
+	payload = arv_camera_get_payload (camera, NULL);
+
+	for (i = 0; i < 5; i++)
+		arv_stream_push_buffer (stream, arv_buffer_new (payload, NULL));
+
+	arv_camera_start_acquisition (camera, NULL);
+
+	for (i = 0; i < 3; i++) {
+		buffer = arv_stream_timeout_pop_buffer (stream, 1000000);
+		g_assert (ARV_IS_BUFFER (buffer));
+		g_assert_cmpint (arv_buffer_get_status (buffer), ==, ARV_BUFFER_STATUS_SUCCESS);
+		arv_stream_push_buffer (stream, buffer);
+	}
+
+	g_assert_cmpint (g_atomic_int_get (&n_copied_bytes), >=, 3 * payload);
+
+	/* The non-temporal kernel produces the same frames */
+	arv_stream_set_copy_kernel (stream, ARV_STREAM_COPY_KERNEL_NON_TEMPORAL);
+	g_assert_cmpint (arv_stream_get_copy_kernel (stream), ==, ARV_STREAM_COPY_KERNEL_NON_TEMPORAL);
+
+	for (i = 0; i < 3; i++) {
+		buffer = arv_stream_timeout_pop_buffer (stream, 1000000);
+		g_assert (ARV_IS_BUFFER (buffer));
+		g_assert_cmpint (arv_buffer_get_status (buffer), ==, ARV_BUFFER_STATUS_SUCCESS);
+		arv_stream_push_buffer (stream, buffer);
+	}
+
+	arv_camera_stop_acquisition (camera, NULL);
+
+	g_clear_object (&stream);
+
+	/* The user data is released with the stream */
+	g_assert_cmpint (n_copied_bytes, ==, 0);
+}
+
+/* Checksums computed during the reassembly of reordered and resent packets match the ones of the final buffers */
+
+static void
+checksum_test (void)
+{
+	ArvStream *stream;
+	ArvBuffer *buffer;
+	GError *error = NULL;
+	gboolean checksum = FALSE;
+	size_t payload;
+	unsigned n_checked = 0;
+	unsigned i;
+
+	g_object_set (simulator,
+		      "gvsp-lost-ratio", 0.02,
+		      "gvsp-reorder-window", 4,
+		      NULL);
+
+	stream = arv_camera_create_stream (camera, NULL, NULL, &error);
+	g_assert (ARV_IS_STREAM (stream));
+	g_assert (error == NULL);
+
+	g_object_set (stream, "checksum", TRUE, NULL);
+	g_object_get (stream, "checksum", &checksum, NULL);
+	g_assert_true (checksum);
+
+	payload = arv_camera_get_payload (camera, NULL);
+
+	for (i = 0; i < 5; i++)
+		arv_stream_push_buffer (stream, arv_buffer_new (payload, NULL));
+
+	arv_camera_start_acquisition (camera, NULL);
+
+	for (i = 0; i < 10; i++) {
+		guint32 crc32c = 0;
+
+		buffer = arv_stream_timeout_pop_buffer (stream, 1000000);
+		g_assert (ARV_IS_BUFFER (buffer));
+		if (arv_buffer_get_status (buffer) == ARV_BUFFER_STATUS_SUCCESS) {
+			g_assert_true (arv_buffer_get_checksum (buffer, &crc32c));
+			g_assert_cmphex (crc32c, ==, arv_buffer_compute_checksum (buffer));
+			n_checked++;
+		} else
+			g_assert_false (arv_buffer_get_checksum (buffer, NULL));
+		arv_stream_push_buffer (stream, buffer);
+	}
+
+	arv_camera_stop_acquisition (camera, NULL);
+
+	g_assert_cmpint (n_checked, >, 0);
+
+	g_clear_object (&stream);
+
+	g_object_set (simulator,
+		      "gvsp-lost-ratio", 0.0,
+		      "gvsp-reorder-window", 0,
+		      NULL);
+}
+
+#define N_BUFFERS	5
+
+static struct {
+	int width;
+	int height;
+} rois[] = { {100, 100}, {200, 200}, {300,300} };
+
+static void
+dynamic_roi_test (void)
+{
+	ArvStream *stream;
+	GError *error = NULL;
+	size_t payload;
+	unsigned buffer_count = 0;
+	unsigned i, j;
+
+	stream = arv_camera_create_stream (camera, NULL, NULL, &error);
+	g_assert (ARV_IS_STREAM (stream));
+	g_assert (error == NULL);
+
+	payload = arv_camera_get_payload (camera, NULL);
+
+	g_signal_connect (stream, "new-buffer", G_CALLBACK (new_buffer_cb), &buffer_count);
+	arv_stream_set_emit_signals (stream, TRUE);
+
+	for (j = 0; j < G_N_ELEMENTS (rois); j++) {
+		unsigned int n_deleted;
+		int height, width;
+
+		n_deleted = arv_stream_stop_thread (stream, TRUE);
+
+		if (j == 0)
+			g_assert (n_deleted == 0);
+		else
+			g_assert (n_deleted == N_BUFFERS);
+
+		buffer_count = 0;
+
+		arv_camera_set_region (camera, 0, 0, rois[j].width , rois[j].height, NULL);
+		arv_camera_get_region (camera, NULL, NULL, &width, &height, NULL);
+
+		g_assert (width == rois[j].width);
+		g_assert (height == rois[j].height);
+
+		payload = arv_camera_get_payload (camera, NULL);
+
+		for (i = 0; i < N_BUFFERS; i++)
+			arv_stream_push_buffer (stream, arv_buffer_new (payload, NULL));
+
+		arv_stream_start_thread (stream);
+
+		arv_camera_start_acquisition (camera, NULL);
+
+		while (buffer_count < 10) {
+			g_usleep (10000);
+		}
+
+		arv_camera_stop_acquisition (camera, NULL);
+	}
+
+	arv_stream_set_emit_signals (stream, FALSE);
+
+	g_clear_object (&stream);
+}
+
+static void
+unpack_test (void)
+{
+	ArvStream *stream;
+	ArvBuffer *buffer;
+	ArvBuffer *unpacked = NULL;
+	GError *error = NULL;
+	size_t size;
+	void *data;
+	unsigned i;
+
+	arv_camera_set_region (camera, 0, 0, 512, 128, &error);
+	g_assert (error == NULL);
+	arv_camera_set_pixel_format (camera, ARV_PIXEL_FORMAT_MONO_12P, &error);
+	g_assert (error == NULL);
+	g_assert_cmpint (arv_camera_get_payload (camera, NULL), ==, 512 * 128 * 3 / 2);
+
+	stream = arv_camera_create_stream (camera, NULL, NULL, &error);
+	g_assert (ARV_IS_STREAM (stream));
+	g_assert (error == NULL);
+
+	g_object_set (stream, "unpack-pixel-format", ARV_PIXEL_FORMAT_MONO_16, NULL);
+
+	for (i = 0; i < 4; i++)
+		arv_stream_push_buffer (stream, arv_buffer_new (512 * 128 * 2, NULL));
+
+	arv_camera_start_acquisition (camera, &error);
+	g_assert (error == NULL);
+
+	/* The fake camera renders 16 different frames, compare an unpacked frame with the conversion of
+	 * the same packed frame */
+	for (i = 0; i < 40; i++) {
+		buffer = arv_stream_timeout_pop_buffer (stream, 1000000);
+		g_assert (ARV_IS_BUFFER (buffer));
+
+		if (arv_buffer_get_status (buffer) == ARV_BUFFER_STATUS_SUCCESS) {
+			if (unpacked == NULL) {
+				g_assert_cmpint (arv_buffer_get_image_pixel_format (buffer), ==, ARV_PIXEL_FORMAT_MONO_16);
+
+				unpacked = arv_buffer_new (512 * 128 * 2, NULL);
+				memcpy ((void *) arv_buffer_get_data (unpacked, NULL), arv_buffer_get_data (buffer, NULL),
+					512 * 128 * 2);
+				arv_buffer_set_frame_id (unpacked, arv_buffer_get_frame_id (buffer));
+
+				g_object_set (stream, "unpack-pixel-format", 0, NULL);
+			} else if (arv_buffer_get_image_pixel_format (buffer) == ARV_PIXEL_FORMAT_MONO_12P &&
+				   arv_buffer_get_frame_id (buffer) % 16 == arv_buffer_get_frame_id (unpacked) % 16) {
+				data = g_malloc (512 * 128 * 2);
+				g_assert (arv_buffer_convert (buffer, ARV_PIXEL_FORMAT_MONO_16, data, 0, &error));
+				g_assert (error == NULL);
+				g_assert (memcmp (data, arv_buffer_get_data (unpacked, &size), size) == 0);
+				g_free (data);
+
+				arv_stream_push_buffer (stream, buffer);
+				break;
+			}
+		}
+
+		arv_stream_push_buffer (stream, buffer);
+	}
+
+	g_assert_cmpint (i, <, 40);
+	g_assert_cmpint (arv_stream_get_info_uint64_by_name (stream, "n_unpacked_frames"), >=, 1);
+
+	arv_camera_stop_acquisition (camera, NULL);
+
+	g_clear_object (&unpacked);
+	g_clear_object (&stream);
+
+	arv_camera_set_pixel_format (camera, ARV_PIXEL_FORMAT_MONO_8, NULL);
+	arv_camera_set_region (camera, 0, 0, 1024, 1024, NULL);
+}
+
+#define CROP_WIDTH	32
+#define CROP_HEIGHT	11
+
+static void
+crop_test (void)
+{
+	ArvStream *stream;
+	ArvBuffer *buffer;
+	GError *error = NULL;
+	const guint8 *data;
+	gint x, y, width, height;
+	gint n_cropped_buffers = 0;
+	unsigned i, u, v;
+
+	arv_camera_set_region (camera, 0, 0, 512, 128, &error);
+	g_assert (error == NULL);
+
+	stream = arv_camera_create_stream (camera, NULL, NULL, &error);
+	g_assert (ARV_IS_STREAM (stream));
+	g_assert (error == NULL);
+
+	/* 64x32 region, one column out of 2 and one row out of 3 */
+	g_object_set (stream,
+		      "crop-x", 100, "crop-y", 10, "crop-width", 64, "crop-height", 32,
+		      "decimation-horizontal", 2, "decimation-vertical", 3,
+		      NULL);
+
+	for (i = 0; i < 4; i++)
+		arv_stream_push_buffer (stream, arv_buffer_new (CROP_WIDTH * CROP_HEIGHT, NULL));
+
+	arv_camera_start_acquisition (camera, &error);
+	g_assert (error == NULL);
+
+	for (i = 0; i < 10; i++) {
+		buffer = arv_stream_timeout_pop_buffer (stream, 1000000);
+		g_assert (ARV_IS_BUFFER (buffer));
+
+		if (arv_buffer_get_status (buffer) == ARV_BUFFER_STATUS_SUCCESS) {
+			arv_buffer_get_image_region (buffer, &x, &y, &width, &height);
+			g_assert_cmpint (x, ==, 100);
+			g_assert_cmpint (y, ==, 10);
+			g_assert_cmpint (width, ==, CROP_WIDTH);
+			g_assert_cmpint (height, ==, CROP_HEIGHT);
+
+			/* The fake camera pixels only depend on x + y, 3 columns right is 2 rows down */
+			data = arv_buffer_get_data (buffer, NULL);
+			for (v = 0; v + 2 < CROP_HEIGHT; v++)
+				for (u = 0; u + 3 < CROP_WIDTH; u++)
+					g_assert_cmpint (data[v * CROP_WIDTH + u + 3], ==, data[(v + 2) * CROP_WIDTH + u]);
+
+			n_cropped_buffers++;
+		}
+
+		arv_stream_push_buffer (stream, buffer);
+	}
+
+	g_assert_cmpint (n_cropped_buffers, >, 0);
+	g_assert_cmpint (arv_stream_get_info_uint64_by_name (stream, "n_cropped_frames"), >=, n_cropped_buffers);
+
+	arv_camera_stop_acquisition (camera, NULL);
+
+	g_clear_object (&stream);
+
+	arv_camera_set_region (camera, 0, 0, 1024, 1024, NULL);
+}
+
+static void
+control_access_test (void)
+{
+	ArvDevice *device;
+	ArvDevice *second_device;
+	GError *error = NULL;
+	gboolean success;
+
+	device = arv_camera_get_device (camera);
+	g_assert (ARV_IS_GV_DEVICE (device));
+	g_assert (arv_gv_device_is_controller (ARV_GV_DEVICE (device)));
+
+	second_device = arv_open_device ("Aravis-GVTest", &error);
+	g_assert_no_error (error);
+	g_assert (ARV_IS_GV_DEVICE (second_device));
+	g_assert (!arv_gv_device_is_controller (ARV_GV_DEVICE (second_device)));
+
+	/* Writes of a device without the control access are answered by an error acknowledge, which is how the
+	 * heartbeat detects the loss of control */
+	success = arv_device_write_register (second_device, ARV_GVBS_CONTROL_CHANNEL_PRIVILEGE_OFFSET,
+					     ARV_GVBS_CONTROL_CHANNEL_PRIVILEGE_CONTROL, &error);
+	g_assert (!success);
+	g_assert_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_PROTOCOL_ERROR);
+	g_clear_error (&error);
+
+	g_object_unref (second_device);
+
+	g_assert (arv_gv_device_is_controller (ARV_GV_DEVICE (device)));
+}
+
+static void
+configuration_test (void)
+{
+	ArvDevice *device;
+	GBytes *configuration;
+	GBytes *corrupted;
+	GError *error = NULL;
+	gboolean success;
+
+	device = arv_camera_get_device (camera);
+	g_assert (ARV_IS_GV_DEVICE (device));
+
+	arv_camera_set_integer (camera, "Width", 320, &error);
+	g_assert_no_error (error);
+	arv_camera_set_integer (camera, "Height", 200, &error);
+	g_assert_no_error (error);
+
+	configuration = arv_device_export_configuration (device);
+	g_assert (configuration != NULL);
+	g_assert_cmpint (g_bytes_get_size (configuration), >, 0);
+
+	arv_camera_set_integer (camera, "Width", 128, &error);
+	g_assert_no_error (error);
+	arv_camera_set_integer (camera, "Height", 64, &error);
+	g_assert_no_error (error);
+
+	success = arv_device_import_configuration (device, configuration, &error);
+	g_assert_no_error (error);
+	g_assert (success);
+
+	g_assert_cmpint (arv_camera_get_integer (camera, "Width", NULL), ==, 320);
+	g_assert_cmpint (arv_camera_get_integer (camera, "Height", NULL), ==, 200);
+
+	corrupted = g_bytes_new_from_bytes (configuration, 0, g_bytes_get_size (configuration) - 1);
+	success = arv_device_import_configuration (device, corrupted, &error);
+	g_assert_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_INVALID_PARAMETER);
+	g_assert (!success);
+	g_clear_error (&error);
+
+	g_bytes_unref (corrupted);
+	g_bytes_unref (configuration);
+}
+
+static void
+_set_user_output (ArvDevice *device, const char *output, gboolean value)
+{
+	GError *error = NULL;
+
+	arv_device_set_string_feature_value (device, "UserOutputSelector", output, &error);
+	g_assert_no_error (error);
+	arv_device_set_boolean_feature_value (device, "UserOutputValue", value, &error);
+	g_assert_no_error (error);
+}
+
+static gboolean
+_get_user_output (ArvDevice *device, const char *output)
+{
+	GError *error = NULL;
+	gboolean value;
+
+	arv_device_set_string_feature_value (device, "UserOutputSelector", output, &error);
+	g_assert_no_error (error);
+	value = arv_device_get_boolean_feature_value (device, "UserOutputValue", &error);
+	g_assert_no_error (error);
+
+	return value;
+}
+
+static void
+configuration_selector_test (void)
+{
+	ArvDevice *device;
+	GBytes *configuration;
+	GError *error = NULL;
+	gboolean success;
+
+	device = arv_camera_get_device (camera);
+	g_assert (ARV_IS_GV_DEVICE (device));
+
+	/* UserOutputValue is a single device register, whose meaning depends on UserOutputSelector */
+	_set_user_output (device, "UserOutput0", TRUE);
+	_set_user_output (device, "UserOutput1", FALSE);
+	_set_user_output (device, "UserOutput2", TRUE);
+	_set_user_output (device, "UserOutput0", TRUE);
+
+	configuration = arv_device_export_configuration (device);
+	g_assert (configuration != NULL);
+
+	_set_user_output (device, "UserOutput0", FALSE);
+	_set_user_output (device, "UserOutput1", TRUE);
+	_set_user_output (device, "UserOutput2", FALSE);
+
+	success = arv_device_import_configuration (device, configuration, &error);
+	g_assert_no_error (error);
+	g_assert (success);
+
+	g_assert (_get_user_output (device, "UserOutput0"));
+	g_assert (!_get_user_output (device, "UserOutput1"));
+	g_assert (_get_user_output (device, "UserOutput2"));
+
+	g_bytes_unref (configuration);
+}
+
+static void
+reconnect_test (void)
+{
+	ArvDevice *device;
+	GError *error = NULL;
+	guint32 value;
+	gboolean success;
+
+	device = arv_camera_get_device (camera);
+	g_assert (ARV_IS_GV_DEVICE (device));
+
+	arv_camera_set_integer (camera, "Width", 256, &error);
+	g_assert_no_error (error);
+
+	/* Restart the simulator, as a camera reboot would do */
+	g_object_unref (simulator);
+	simulator = arv_gv_fake_camera_new ("lo", "GVTest");
+	g_assert (ARV_IS_GV_FAKE_CAMERA (simulator));
+
+	arv_fake_camera_read_register (arv_gv_fake_camera_get_fake_camera (simulator),
+				       ARV_FAKE_CAMERA_REGISTER_WIDTH, &value);
+	g_assert_cmpint (value, ==, ARV_FAKE_CAMERA_WIDTH_DEFAULT);
+
+	success = arv_device_reconnect (device, 5000, &error);
+	g_assert_no_error (error);
+	g_assert (success);
+	g_assert (arv_gv_device_is_controller (ARV_GV_DEVICE (device)));
+
+	arv_fake_camera_read_register (arv_gv_fake_camera_get_fake_camera (simulator),
+				       ARV_FAKE_CAMERA_REGISTER_WIDTH, &value);
+	g_assert_cmpint (value, ==, 256);
+
+	g_assert_cmpint (arv_camera_get_integer (camera, "Width", NULL), ==, 256);
+}
+
+static guint
+_receive_gvsp_packets (GSocket *socket, ArvGvspPacketType *packet_type, guint32 *last_packet_id)
+{
+	char packet[2048];
+	guint n_packets = 0;
+
+	while (g_socket_condition_timed_wait (socket, G_IO_IN, 200000, NULL)) {
+		gssize size;
+
+		size = g_socket_receive (socket, packet, sizeof (packet), NULL, NULL);
+		if (size <= 0)
+			break;
+
+		*packet_type = arv_gvsp_packet_get_packet_type ((ArvGvspPacket *) packet);
+		*last_packet_id = arv_gvsp_packet_get_packet_id ((ArvGvspPacket *) packet);
+		n_packets++;
+	}
+
+	return n_packets;
+}
+
+static void
+gvsp_sender_test (void)
+{
+	ArvGvspSender *sender;
+	ArvGvspPacketType packet_type = ARV_GVSP_PACKET_TYPE_OK;
+	ArvBuffer *buffer;
+	GInetAddress *loopback;
+	GSocketAddress *address;
+	GSocketAddress *receiver_address;
+	GSocket *receiver;
+	GError *error = NULL;
+	guint64 n_sent_packets;
+	guint64 n_resent_packets;
+	guint32 last_packet_id = 0;
+
+	loopback = g_inet_address_new_loopback (G_SOCKET_FAMILY_IPV4);
+
+	receiver = g_socket_new (G_SOCKET_FAMILY_IPV4, G_SOCKET_TYPE_DATAGRAM, G_SOCKET_PROTOCOL_UDP, NULL);
+	g_assert (G_IS_SOCKET (receiver));
+	address = g_inet_socket_address_new (loopback, 0);
+	g_assert (g_socket_bind (receiver, address, FALSE, NULL));
+	g_object_unref (address);
+	receiver_address = g_socket_get_local_address (receiver, NULL);
+
+	sender = arv_gvsp_sender_new (loopback, 0, &error);
+	g_assert_no_error (error);
+	g_assert (ARV_IS_GVSP_SENDER (sender));
+	g_assert_cmpint (arv_gvsp_sender_get_local_port (sender), !=, 0);
+
+	/* 3 data blocks, plus leader and trailer */
+	buffer = arv_buffer_new (3 * (1500 - ARV_GVSP_PACKET_PROTOCOL_OVERHEAD), NULL);
+
+	g_assert (!arv_gvsp_sender_send_buffer (sender, buffer, &error));
+	g_assert (error != NULL);
+	g_clear_error (&error);
+
+	arv_gvsp_sender_set_destination (sender, receiver_address);
+	arv_gvsp_sender_set_packet_size (sender, 1500);
+	arv_gvsp_sender_set_udp_gso (sender, FALSE);
+	arv_gvsp_sender_set_history_length (sender, 2);
+	g_assert_cmpint (arv_gvsp_sender_get_packet_size (sender), ==, 1500);
+
+	g_assert (arv_gvsp_sender_send_buffer (sender, buffer, &error));
+	g_assert_no_error (error);
+	g_assert_cmpint (_receive_gvsp_packets (receiver, &packet_type, &last_packet_id), ==, 5);
+	g_assert_cmpint (last_packet_id, ==, 4);
+
+	g_assert (arv_gvsp_sender_resend_packets (sender, 0, 1, 2));
+	g_assert_cmpint (_receive_gvsp_packets (receiver, &packet_type, &last_packet_id), ==, 2);
+	g_assert_cmpint (packet_type, ==, ARV_GVSP_PACKET_TYPE_OK);
+	g_assert_cmpint (last_packet_id, ==, 2);
+
+	/* Frame not in the history */
+	g_assert (!arv_gvsp_sender_resend_packets (sender, 5, 1, 2));
+	g_assert_cmpint (_receive_gvsp_packets (receiver, &packet_type, &last_packet_id), ==, 1);
+	g_assert_cmpint (packet_type, ==, ARV_GVSP_PACKET_TYPE_PACKET_UNAVAILABLE);
+
+	arv_gvsp_sender_get_statistics (sender, &n_sent_packets, &n_resent_packets);
+	g_assert_cmpint (n_sent_packets, ==, 7);
+	g_assert_cmpint (n_resent_packets, ==, 2);
+
+	g_object_unref (sender);
+	g_object_unref (buffer);
+	g_object_unref (receiver_address);
+	g_object_unref (receiver);
+	g_object_unref (loopback);
 }
 
 int
 main (int argc, char *argv[])
 {
-	ArvGvFakeCamera *simulator;
 	int result;
 
 	g_test_init (&argc, &argv, NULL);
@@ -235,9 +2010,41 @@ main (int argc, char *argv[])
 	g_assert (ARV_IS_CAMERA (camera));
 
 	g_test_add_func ("/fakegv/device_registers", register_test);
+	g_test_add_func ("/fakegv/device_registers_batch", register_batch_test);
+	g_test_add_func ("/fakegv/device_write_batch", write_batch_test);
+	g_test_add_func ("/fakegv/device_command_window", command_window_test);
+	g_test_add_func ("/fakegv/device_async_reads", async_read_test);
+	g_test_add_func ("/fakegv/device_read_memory", read_memory_test);
+	g_test_add_func ("/fakegv/device_write_memory", write_memory_test);
+	g_test_add_func ("/fakegv/round_trip_time", round_trip_time_test);
+	g_test_add_func ("/fakegv/control_access", control_access_test);
+	g_test_add_func ("/fakegv/genicam_cache", genicam_cache_test);
 	g_test_add_func ("/fakegv/acquisition", acquisition_test);
+	g_test_add_func ("/fakegv/stream_options", stream_options_test);
+	g_test_add_func ("/fakegv/stream_channel", stream_channel_test);
+	g_test_add_func ("/fakegv/cached_packet_size", cached_packet_size_test);
+	g_test_add_func ("/fakegv/adaptive_socket_buffer", adaptive_socket_buffer_test);
+	g_test_add_func ("/fakegv/traffic_generator", traffic_generator_test);
+	g_test_add_func ("/fakegv/gvsp_sender", gvsp_sender_test);
+	g_test_add_func ("/fakegv/network_impairment", network_impairment_test);
+	g_test_add_func ("/fakegv/missing_ranges", missing_ranges_test);
+	g_test_add_func ("/fakegv/resend_coalescing", resend_coalescing_test);
+	g_test_add_func ("/fakegv/multipart_reassembly", multipart_reassembly_test);
+	g_test_add_func ("/fakegv/all_in", all_in_test);
+	g_test_add_func ("/fakegv/farm", farm_test);
+	g_test_add_func ("/fakegv/control_thread", control_thread_test);
 	g_test_add_func ("/fakegv/stream", stream_test);
+	g_test_add_func ("/fakegv/early_completion", early_completion_test);
+	g_test_add_func ("/fakegv/reorder_window", reorder_window_test);
+	g_test_add_func ("/fakegv/copy_kernel", copy_kernel_test);
+	g_test_add_func ("/fakegv/checksum", checksum_test);
 	g_test_add_func ("/fakegv/dynamic_roi", dynamic_roi_test);
+	g_test_add_func ("/fakegv/region_ready", region_ready_test);
+	g_test_add_func ("/fakegv/unpack", unpack_test);
+	g_test_add_func ("/fakegv/crop", crop_test);
+	g_test_add_func ("/fakegv/configuration", configuration_test);
+	g_test_add_func ("/fakegv/configuration_selector", configuration_selector_test);
+	g_test_add_func ("/fakegv/reconnect", reconnect_test);
 
 	result = g_test_run();
 
@@ -0,0 +1,254 @@
+#include <glib.h>
+#include <arv.h>
+#include <string.h>
+
+#define ARAVIS_COMPILATION
+#include "../src/arvuvfaketransportprivate.h"
+#include "../src/arvuvcpprivate.h"
+
+#define N_BUFFERS	5
+#define N_FRAMES	20
+
+static guint
+_acquire (ArvUvFakeTransport *transport, guint n_frames)
+{
+	ArvDevice *device;
+	ArvStream *stream;
+	GError *error = NULL;
+	size_t payload;
+	guint n_successes = 0;
+	guint i;
+
+	device = arv_uv_device_new_fake (transport, &error);
+	g_assert (ARV_IS_UV_DEVICE (device));
+	g_assert (error == NULL);
+
+	g_assert_cmpint (arv_device_get_integer_feature_value (device, "PayloadSize", NULL), ==,
+			 arv_uv_fake_transport_get_payload (transport));
+
+	payload = arv_uv_fake_transport_get_payload (transport);
+
+	stream = arv_device_create_stream (device, NULL, NULL, &error);
+	g_assert (ARV_IS_STREAM (stream));
+	g_assert (error == NULL);
+
+	for (i = 0; i < N_BUFFERS; i++)
+		arv_stream_push_buffer (stream, arv_buffer_new (payload, NULL));
+
+	for (i = 0; i < n_frames; i++) {
+		ArvBuffer *buffer;
+
+		buffer = arv_stream_timeout_pop_buffer (stream, 1000000);
+		g_assert (ARV_IS_BUFFER (buffer));
+
+		if (arv_buffer_get_status (buffer) == ARV_BUFFER_STATUS_SUCCESS) {
+			const guint8 *data;
+			size_t size;
+
+			data = arv_buffer_get_data (buffer, &size);
+			g_assert_cmpint (size, ==, payload);
+			g_assert_cmpint (data[0], ==, arv_buffer_get_frame_id (buffer) & 0xff);
+			g_assert_cmpint (data[size - 1], ==, arv_buffer_get_frame_id (buffer) & 0xff);
+			n_successes++;
+		}
+
+		arv_stream_push_buffer (stream, buffer);
+	}
+
+	g_object_unref (stream);
+	g_object_unref (device);
+
+	return n_successes;
+}
+
+static void
+stream_test (void)
+{
+	ArvUvFakeTransport *transport;
+
+	transport = arv_uv_fake_transport_new ();
+
+	g_assert_cmpint (_acquire (transport, N_FRAMES), ==, N_FRAMES);
+}
+
+static void
+misaligned_test (void)
+{
+	ArvUvFakeTransport *transport;
+
+	/* Payload and trailer sizes which are not multiples of the alignment */
+	transport = arv_uv_fake_transport_new ();
+	arv_uv_fake_transport_set_region (transport, 1001, 33);
+	arv_uv_fake_transport_set_alignment (transport, 64);
+	arv_uv_fake_transport_set_trailer_size (transport, 100);
+
+	g_assert_cmpint (_acquire (transport, N_FRAMES), ==, N_FRAMES);
+}
+
+static void
+short_transfer_test (void)
+{
+	ArvUvFakeTransport *transport;
+
+	/* The data of a short transfer comes in the following ones, the frames are still complete */
+	transport = arv_uv_fake_transport_new ();
+	arv_uv_fake_transport_set_region (transport, 2048, 1024);
+	arv_uv_fake_transport_set_alignment (transport, 512);
+	arv_uv_fake_transport_set_short_transfer_ratio (transport, 0.3);
+	arv_uv_fake_transport_set_seed (transport, 1234);
+
+	g_assert_cmpint (_acquire (transport, N_FRAMES), ==, N_FRAMES);
+}
+
+static void
+frame_rate_test (void)
+{
+	ArvUvFakeTransport *transport;
+	gint64 start_time_us;
+
+	transport = arv_uv_fake_transport_new ();
+	arv_uv_fake_transport_set_frame_rate (transport, 200.0);
+
+	start_time_us = g_get_monotonic_time ();
+	g_assert_cmpint (_acquire (transport, N_FRAMES), ==, N_FRAMES);
+	g_assert_cmpint (g_get_monotonic_time () - start_time_us, >=, (N_FRAMES - 1) * 5000);
+}
+
+static void
+control_pipeline_test (void)
+{
+	ArvUvFakeTransport *transport;
+	ArvDevice *device;
+	GError *error = NULL;
+	guint8 *pipelined;
+	guint8 *sequential;
+	size_t size = 0x2000;
+
+	transport = arv_uv_fake_transport_new ();
+
+	device = arv_uv_device_new_fake (transport, &error);
+	g_assert (ARV_IS_UV_DEVICE (device));
+	g_assert (error == NULL);
+
+	pipelined = g_malloc0 (size);
+	sequential = g_malloc0 (size);
+
+	/* Several commands in flight for a read larger than the maximum acknowledge size */
+	g_assert_cmpint (arv_uv_device_get_control_pipeline_depth (ARV_UV_DEVICE (device)), >, 1);
+	g_assert (arv_device_read_memory (device, 0, size, pipelined, &error));
+	g_assert_no_error (error);
+	g_assert_cmpint (arv_uv_device_get_control_pipeline_depth (ARV_UV_DEVICE (device)), >, 1);
+
+	arv_uv_device_set_control_pipeline_depth (ARV_UV_DEVICE (device), 1);
+	g_assert (arv_device_read_memory (device, 0, size, sequential, &error));
+	g_assert_no_error (error);
+	g_assert (memcmp (pipelined, sequential, size) == 0);
+
+	/* A device handling one command at a time disables the pipelining, without read failure */
+	arv_uv_device_set_control_pipeline_depth (ARV_UV_DEVICE (device), 4);
+	arv_uv_fake_transport_set_command_queue_size (transport, 1);
+	memset (pipelined, 0, size);
+	g_assert (arv_device_read_memory (device, 0, size, pipelined, &error));
+	g_assert_no_error (error);
+	g_assert (memcmp (pipelined, sequential, size) == 0);
+	g_assert_cmpint (arv_uv_device_get_control_pipeline_depth (ARV_UV_DEVICE (device)), ==, 1);
+
+	g_free (pipelined);
+	g_free (sequential);
+	g_object_unref (device);
+}
+
+static void
+bandwidth_test (void)
+{
+	ArvDevice *device;
+	GError *error = NULL;
+
+	device = arv_uv_device_new_fake (arv_uv_fake_transport_new (), &error);
+	g_assert (ARV_IS_UV_DEVICE (device));
+	g_assert (error == NULL);
+
+	/* A simulated device is not connected to any bus, and stays out of the allocation */
+	g_assert_cmpint (arv_uv_device_get_bus_number (ARV_UV_DEVICE (device)), ==, 0);
+	g_assert_cmpfloat (arv_uv_device_get_bandwidth_weight (ARV_UV_DEVICE (device)), ==, 1.0);
+	arv_uv_device_set_bandwidth_weight (ARV_UV_DEVICE (device), 2.0);
+	g_assert_cmpfloat (arv_uv_device_get_bandwidth_weight (ARV_UV_DEVICE (device)), ==, 2.0);
+
+	g_assert_cmpint (arv_uv_get_bus_bandwidth (1), ==, 0);
+	arv_uv_set_bus_bandwidth (1, 400);
+	g_assert_cmpint (arv_uv_get_bus_bandwidth (1), ==, 400);
+	arv_uv_set_bus_bandwidth (1, 0);
+	g_assert_cmpint (arv_uv_get_bus_bandwidth (1), ==, 0);
+
+	g_assert_cmpint (arv_uv_get_bus_n_frame_losses (1), ==, 0);
+
+	g_object_unref (device);
+}
+
+static void
+event_test (void)
+{
+	ArvUvFakeTransport *transport;
+	ArvUvcpPacket *packet;
+	ArvDevice *device;
+	GError *error = NULL;
+	const guint8 data[] = {0x01, 0x02, 0x03};
+	const void *event_data;
+	size_t event_data_size;
+	size_t packet_size;
+	guint64 timestamp;
+	guint16 event_id;
+
+	packet = arv_uvcp_packet_new_event_cmd (0x9001, G_GUINT64_CONSTANT (0x0102030405060708), NULL, 0, 12,
+						&packet_size);
+	g_assert (arv_uvcp_packet_get_event (packet, packet_size, &event_id, &timestamp, &event_data, &event_data_size));
+	g_assert_cmpint (event_id, ==, 0x9001);
+	g_assert_cmpint (timestamp, ==, G_GUINT64_CONSTANT (0x0102030405060708));
+	g_assert (event_data == NULL);
+	g_assert_cmpint (event_data_size, ==, 0);
+	g_assert (!arv_uvcp_packet_get_event (packet, packet_size - 1, NULL, NULL, NULL, NULL));
+	arv_uvcp_packet_free (packet);
+
+	packet = arv_uvcp_packet_new_event_cmd (0x9002, 42, data, sizeof (data), 13, &packet_size);
+	g_assert (arv_uvcp_packet_get_event (packet, packet_size, &event_id, &timestamp, &event_data, &event_data_size));
+	g_assert_cmpint (event_id, ==, 0x9002);
+	g_assert_cmpint (timestamp, ==, 42);
+	g_assert_cmpint (event_data_size, ==, sizeof (data));
+	g_assert (memcmp (event_data, data, sizeof (data)) == 0);
+	arv_uvcp_packet_free (packet);
+
+	/* The simulator has no event interface */
+	transport = arv_uv_fake_transport_new ();
+	device = arv_uv_device_new_fake (transport, &error);
+	g_assert (ARV_IS_UV_DEVICE (device));
+
+	g_assert (!arv_uv_device_enable_events (ARV_UV_DEVICE (device), &error));
+	g_assert_error (error, ARV_DEVICE_ERROR, ARV_DEVICE_ERROR_PROTOCOL_ERROR);
+	g_clear_error (&error);
+
+	arv_uv_device_disable_events (ARV_UV_DEVICE (device));
+
+	g_object_unref (device);
+}
+
+int
+main (int argc, char *argv[])
+{
+	int result;
+
+	g_test_init (&argc, &argv, NULL);
+
+	g_test_add_func ("/fakeuv/stream", stream_test);
+	g_test_add_func ("/fakeuv/misaligned", misaligned_test);
+	g_test_add_func ("/fakeuv/short_transfer", short_transfer_test);
+	g_test_add_func ("/fakeuv/frame_rate", frame_rate_test);
+	g_test_add_func ("/fakeuv/control_pipeline", control_pipeline_test);
+	g_test_add_func ("/fakeuv/event", event_test);
+	g_test_add_func ("/fakeuv/bandwidth", bandwidth_test);
+
+	result = g_test_run();
+
+	arv_shutdown ();
+
+	return result;
+}
@@ -1,10 +1,15 @@
 #include <glib.h>
+#include <glib/gstdio.h>
 #include <arv.h>
 #include <string.h>
 
 #define ARAVIS_COMPILATION
 #include "../src/arvbufferprivate.h"
 #include "../src/arvmiscprivate.h"
+#include "../src/arvgcprivate.h"
+#include "../src/arvgcregisternodeprivate.h"
+#include "../src/arvgcsnapshotprivate.h"
+#include "../src/arvxmlschemaprivate.h"
 
 typedef struct {
 	const char *name;
@@ -429,6 +434,81 @@ enumeration_test (void)
 	g_object_unref (device);
 }
 
+static void
+enumeration_entry_table_test (void)
+{
+	ArvDevice *device;
+	ArvGc *genicam;
+	ArvGcNode *node;
+	ArvGcNode *value_node;
+	GError *error = NULL;
+	const char *v_string;
+	unsigned int i;
+
+	static const struct {
+		gint64 value;
+		const char *entry;
+	} entries[] = {
+		{7,		"Seven"},
+		{-1,		"MinusOne"},
+		{0x1080001,	"Large"},
+		{2,		"Two"},
+		{7,		"Seven"}
+	};
+
+	device = arv_fake_device_new ("TEST0", &error);
+	g_assert (ARV_IS_FAKE_DEVICE (device));
+	g_assert_no_error (error);
+
+	genicam = arv_device_get_genicam (device);
+	g_assert (ARV_IS_GC (genicam));
+
+	node = arv_gc_get_node (genicam, "UnsortedEnumeration");
+	g_assert (ARV_IS_GC_ENUMERATION (node));
+	value_node = arv_gc_get_node (genicam, "UnsortedEnumerationValue");
+	g_assert (ARV_IS_GC_INTEGER (value_node));
+
+	for (i = 0; i < G_N_ELEMENTS (entries); i++) {
+		arv_gc_integer_set_value (ARV_GC_INTEGER (value_node), entries[i].value, &error);
+		g_assert_no_error (error);
+
+		v_string = arv_gc_enumeration_get_string_value (ARV_GC_ENUMERATION (node), &error);
+		g_assert_no_error (error);
+		g_assert_cmpstr (v_string, ==, entries[i].entry);
+
+		g_assert (arv_gc_enumeration_set_string_value (ARV_GC_ENUMERATION (node), entries[i].entry, &error));
+		g_assert_no_error (error);
+		g_assert_cmpint (arv_gc_integer_get_value (ARV_GC_INTEGER (value_node), NULL), ==, entries[i].value);
+	}
+
+	arv_gc_integer_set_value (ARV_GC_INTEGER (value_node), 3, &error);
+	g_assert_no_error (error);
+	v_string = arv_gc_enumeration_get_string_value (ARV_GC_ENUMERATION (node), &error);
+	g_assert_error (error, ARV_GC_ERROR, ARV_GC_ERROR_OUT_OF_RANGE);
+	g_assert (v_string == NULL);
+	g_clear_error (&error);
+
+	/* Entries with a pValue are evaluated on each conversion */
+	node = arv_gc_get_node (genicam, "IndirectEnumeration");
+	g_assert (ARV_IS_GC_ENUMERATION (node));
+
+	v_string = arv_gc_enumeration_get_string_value (ARV_GC_ENUMERATION (node), &error);
+	g_assert_no_error (error);
+	g_assert_cmpstr (v_string, ==, "Indirect");
+
+	arv_gc_integer_set_value (ARV_GC_INTEGER (arv_gc_get_node (genicam, "IndirectEntryValue")), 9, &error);
+	g_assert_no_error (error);
+	arv_gc_integer_set_value (ARV_GC_INTEGER (arv_gc_get_node (genicam, "IndirectEnumerationValue")), 9,
+				  &error);
+	g_assert_no_error (error);
+
+	v_string = arv_gc_enumeration_get_string_value (ARV_GC_ENUMERATION (node), &error);
+	g_assert_no_error (error);
+	g_assert_cmpstr (v_string, ==, "Indirect");
+
+	g_object_unref (device);
+}
+
 static void
 swiss_knife_test (void)
 {
@@ -478,6 +558,52 @@ swiss_knife_test (void)
 	g_object_unref (device);
 }
 
+static void
+try_get_value_test (void)
+{
+	ArvDevice *device;
+	ArvGc *genicam;
+	ArvGcNode *node;
+	GError *error = NULL;
+	const char *integers[] = {"IntSwissKnifeTest", "IntSwissKnifeTestSubAndConstant", "IntConverter", "RWInteger"};
+	const char *floats[] = {"Converter", "RWFloat"};
+	gboolean v_boolean;
+	double v_double;
+	gint64 v_int64;
+	unsigned i;
+
+	device = arv_fake_device_new ("TEST0", &error);
+	g_assert (ARV_IS_FAKE_DEVICE (device));
+	g_assert (error == NULL);
+
+	genicam = arv_device_get_genicam (device);
+	g_assert (ARV_IS_GC (genicam));
+
+	for (i = 0; i < G_N_ELEMENTS (integers); i++) {
+		node = arv_gc_get_node (genicam, integers[i]);
+		g_assert (ARV_IS_GC_INTEGER (node));
+
+		g_assert (arv_gc_integer_try_get_value (ARV_GC_INTEGER (node), &v_int64));
+		g_assert_cmpint (v_int64, ==, arv_gc_integer_get_value (ARV_GC_INTEGER (node), NULL));
+	}
+
+	for (i = 0; i < G_N_ELEMENTS (floats); i++) {
+		node = arv_gc_get_node (genicam, floats[i]);
+		g_assert (ARV_IS_GC_FLOAT (node));
+
+		g_assert (arv_gc_float_try_get_value (ARV_GC_FLOAT (node), &v_double));
+		g_assert_cmpfloat (v_double, ==, arv_gc_float_get_value (ARV_GC_FLOAT (node), NULL));
+	}
+
+	node = arv_gc_get_node (genicam, "RWBoolean");
+	g_assert (ARV_IS_GC_BOOLEAN (node));
+
+	g_assert (arv_gc_boolean_try_get_value (ARV_GC_BOOLEAN (node), &v_boolean));
+	g_assert_cmpint (v_boolean, ==, arv_gc_boolean_get_value (ARV_GC_BOOLEAN (node), NULL));
+
+	g_object_unref (device);
+}
+
 static void
 converter_test (void)
 {
@@ -962,6 +1088,46 @@ create_buffer_with_chunk_data (void)
 	return buffer;
 }
 
+static void
+event_data_test (void)
+{
+	ArvDevice *device;
+	ArvGc *genicam;
+	GError *error = NULL;
+	guint8 event_data[12] = {0x00, 0x00, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05,
+				 0x00, 0x00, 0x12, 0x34};
+	gint64 value;
+
+	device = arv_fake_device_new ("TEST0", &error);
+	g_assert (ARV_IS_FAKE_DEVICE (device));
+	g_assert (error == NULL);
+
+	genicam = arv_device_get_genicam (device);
+
+	value = arv_device_get_integer_feature_value (device, "EventTestValue", &error);
+	g_assert_error (error, ARV_GC_ERROR, ARV_GC_ERROR_EVENT_NOT_FOUND);
+	g_clear_error (&error);
+
+	/* Data of another event */
+	arv_gc_set_event_data (genicam, 0x9002, event_data, sizeof (event_data));
+
+	value = arv_device_get_integer_feature_value (device, "EventTestValue", &error);
+	g_assert_error (error, ARV_GC_ERROR, ARV_GC_ERROR_EVENT_NOT_FOUND);
+	g_clear_error (&error);
+
+	arv_gc_set_event_data (genicam, 0x9001, event_data, sizeof (event_data));
+
+	value = arv_device_get_integer_feature_value (device, "EventTestTimestamp", &error);
+	g_assert (error == NULL);
+	g_assert_cmpint (value, ==, 0x0000000102030405);
+
+	value = arv_device_get_integer_feature_value (device, "EventTestValue", &error);
+	g_assert (error == NULL);
+	g_assert_cmpint (value, ==, 0x1234);
+
+	g_object_unref (device);
+}
+
 static void
 chunk_data_test (void)
 {
@@ -978,6 +1144,7 @@ chunk_data_test (void)
 	const char *string_value;
 	size_t size;
 	size_t chunk_data_size;
+	guint64 chunk_id;
 
 	device = arv_fake_device_new ("TEST0", &error);
 	g_assert (ARV_IS_FAKE_DEVICE (device));
@@ -1013,6 +1180,15 @@ chunk_data_test (void)
 	g_assert (chunk_data == NULL);
 	g_assert_cmpint (chunk_data_size, ==, 0);
 
+	g_assert_cmpint (arv_buffer_get_n_chunks (buffer), ==, 5);
+	chunk_data = arv_buffer_get_nth_chunk_data (buffer, 0, &chunk_id, &chunk_data_size);
+	g_assert_cmpint (chunk_id, ==, 0x12345678);
+	g_assert_cmpint (chunk_data_size, ==, 8);
+	g_assert (chunk_data == arv_buffer_get_chunk_data (buffer, 0x12345678, NULL));
+	chunk_data = arv_buffer_get_nth_chunk_data (buffer, 4, &chunk_id, &chunk_data_size);
+	g_assert_cmpint (chunk_id, ==, 0x44444444);
+	g_assert (chunk_data == data);
+
 	int_value = arv_chunk_parser_get_integer_value (parser, buffer, "ChunkInt", &error);
 	g_assert_cmpint (int_value, ==, 0x11223344);
 	g_assert (error == NULL);
@@ -1046,6 +1222,60 @@ chunk_data_test (void)
 	g_object_unref (device);
 }
 
+static void
+chunk_plan_test (void)
+{
+	ArvDevice *device;
+	ArvChunkParser *parser;
+	ArvChunkPlan *plan;
+	ArvBuffer *buffer;
+	ArvChunkValue values[3];
+	GError *error = NULL;
+	const char *chunks[] = {"ChunkInt", "ChunkFloat", "ChunkBoolean", NULL};
+	const char *invalid_chunks[] = {"ChunkInt", "ChunkString", NULL};
+	gboolean success;
+	guint n_values;
+
+	device = arv_fake_device_new ("TEST0", &error);
+	g_assert (ARV_IS_FAKE_DEVICE (device));
+	g_assert (error == NULL);
+
+	parser = arv_device_create_chunk_parser (device);
+	g_assert (ARV_IS_CHUNK_PARSER (parser));
+
+	plan = arv_chunk_parser_compile_plan (parser, invalid_chunks, &error);
+	g_assert (plan == NULL);
+	g_assert (error != NULL);
+	g_clear_error (&error);
+
+	plan = arv_chunk_parser_compile_plan (parser, chunks, &error);
+	g_assert (ARV_IS_CHUNK_PLAN (plan));
+	g_assert (error == NULL);
+	g_assert_cmpint (arv_chunk_plan_get_n_chunks (plan), ==, 3);
+
+	buffer = create_buffer_with_chunk_data ();
+
+	success = arv_chunk_plan_apply (plan, buffer, values, &error);
+	g_assert (success);
+	g_assert (error == NULL);
+
+	g_assert (values[0].is_valid);
+	g_assert_cmpint (values[0].v_int64, ==, 0x11223344);
+	g_assert (values[1].is_valid);
+	g_assert_cmpfloat (values[1].v_double, ==, 1.1);
+	g_assert (values[2].is_valid);
+	g_assert_cmpint (values[2].v_int64, ==, 1);
+
+	/* Only filled by the stream thread */
+	g_assert (arv_buffer_get_chunk_values (buffer, &n_values) == NULL);
+	g_assert_cmpint (n_values, ==, 0);
+
+	g_object_unref (buffer);
+	g_object_unref (plan);
+	g_object_unref (parser);
+	g_object_unref (device);
+}
+
 static void
 visibility_test (void)
 {
@@ -1080,6 +1310,945 @@ visibility_test (void)
 	g_object_unref (device);
 }
 
+static void
+_compare_genicam (ArvGc *reference, ArvGc *genicam)
+{
+	int i;
+
+	for (i = 0; i < G_N_ELEMENTS (node_types); i++) {
+		ArvGcNode *reference_node = arv_gc_get_node (reference, node_types[i].name);
+		ArvGcNode *node = arv_gc_get_node (genicam, node_types[i].name);
+
+		g_assert (node != NULL);
+		g_assert (G_OBJECT_TYPE (reference_node) == G_OBJECT_TYPE (node));
+
+		if (node_types[i].type == G_TYPE_INT64)
+			g_assert_cmpint (arv_gc_integer_get_value (ARV_GC_INTEGER (reference_node), NULL), ==,
+					 arv_gc_integer_get_value (ARV_GC_INTEGER (node), NULL));
+	}
+
+	g_assert (arv_gc_get_node (genicam, "NotAFeature") == NULL);
+}
+
+static void
+snapshot_test (void)
+{
+	ArvDevice *device;
+	ArvGc *genicam;
+	ArvGc *snapshot_genicam;
+	GBytes *snapshot;
+	GBytes *truncated;
+	const char *xml;
+	size_t size;
+
+	device = arv_fake_device_new ("TEST0", NULL);
+	g_assert (ARV_IS_FAKE_DEVICE (device));
+
+	genicam = arv_device_get_genicam (device);
+	xml = arv_device_get_genicam_xml (device, &size);
+	g_assert (xml != NULL);
+
+	snapshot = arv_gc_snapshot_build (xml, size);
+	g_assert (snapshot != NULL);
+
+	snapshot_genicam = arv_gc_new_from_snapshot (device, snapshot);
+	g_assert (ARV_IS_GC (snapshot_genicam));
+
+	_compare_genicam (genicam, snapshot_genicam);
+
+	g_object_unref (snapshot_genicam);
+
+	truncated = g_bytes_new_from_bytes (snapshot, 0, g_bytes_get_size (snapshot) - 1);
+	g_assert (arv_gc_new_from_snapshot (device, truncated) == NULL);
+	g_bytes_unref (truncated);
+
+	g_assert (arv_gc_snapshot_build ("<RegisterDescription>", strlen ("<RegisterDescription>")) == NULL);
+
+	g_bytes_unref (snapshot);
+	g_object_unref (device);
+}
+
+static void
+lazy_loading_test (void)
+{
+	ArvDevice *device;
+	ArvDevice *lazy_device;
+
+	device = arv_fake_device_new ("TEST0", NULL);
+	g_assert (ARV_IS_FAKE_DEVICE (device));
+
+	arv_enable_genicam_lazy_loading ();
+	lazy_device = arv_fake_device_new ("TEST0", NULL);
+	arv_disable_genicam_lazy_loading ();
+	g_assert (ARV_IS_FAKE_DEVICE (lazy_device));
+
+	_compare_genicam (arv_device_get_genicam (device), arv_device_get_genicam (lazy_device));
+
+	g_object_unref (lazy_device);
+	g_object_unref (device);
+}
+
+static void
+shared_model_test (void)
+{
+	ArvDevice *device;
+	ArvDevice *other_device;
+	ArvGc *genicam;
+	ArvGc *other_genicam;
+
+	device = arv_fake_device_new ("TEST0", NULL);
+	g_assert (ARV_IS_FAKE_DEVICE (device));
+	other_device = arv_fake_device_new ("TEST0", NULL);
+	g_assert (ARV_IS_FAKE_DEVICE (other_device));
+
+	genicam = arv_device_get_genicam (device);
+	other_genicam = arv_device_get_genicam (other_device);
+	g_assert (genicam != other_genicam);
+
+	/* The nodes are per device state */
+	g_assert (arv_gc_get_node (genicam, "RWInteger") != arv_gc_get_node (other_genicam, "RWInteger"));
+
+	arv_device_set_integer_feature_value (device, "RWInteger", 2, NULL);
+	arv_device_set_integer_feature_value (other_device, "RWInteger", 4, NULL);
+	g_assert_cmpint (arv_device_get_integer_feature_value (device, "RWInteger", NULL), ==, 2);
+	g_assert_cmpint (arv_device_get_integer_feature_value (other_device, "RWInteger", NULL), ==, 4);
+
+	arv_device_set_integer_feature_value (device, "RWInteger", 1, NULL);
+	arv_device_set_integer_feature_value (other_device, "RWInteger", 1, NULL);
+	_compare_genicam (genicam, other_genicam);
+
+	/* The shared model outlives the release of the first device */
+	g_object_unref (device);
+
+	device = arv_fake_device_new ("TEST0", NULL);
+	g_assert (ARV_IS_FAKE_DEVICE (device));
+	_compare_genicam (arv_device_get_genicam (device), other_genicam);
+
+	g_object_unref (other_device);
+	g_object_unref (device);
+}
+
+#define CONCURRENT_SHARED_MODEL_N_DEVICES	8
+
+static gpointer
+_new_fake_device_thread (gpointer data)
+{
+	return arv_fake_device_new ("TEST0", NULL);
+}
+
+static void
+concurrent_shared_model_test (void)
+{
+	GThread *threads[CONCURRENT_SHARED_MODEL_N_DEVICES];
+	ArvDevice *devices[CONCURRENT_SHARED_MODEL_N_DEVICES];
+	unsigned int i;
+
+	/* The devices opened concurrently wait for the model built by the first one */
+	for (i = 0; i < CONCURRENT_SHARED_MODEL_N_DEVICES; i++)
+		threads[i] = g_thread_new ("fake_device", _new_fake_device_thread, NULL);
+	for (i = 0; i < CONCURRENT_SHARED_MODEL_N_DEVICES; i++) {
+		devices[i] = g_thread_join (threads[i]);
+		g_assert (ARV_IS_FAKE_DEVICE (devices[i]));
+	}
+
+	for (i = 1; i < CONCURRENT_SHARED_MODEL_N_DEVICES; i++)
+		_compare_genicam (arv_device_get_genicam (devices[0]), arv_device_get_genicam (devices[i]));
+
+	for (i = 0; i < CONCURRENT_SHARED_MODEL_N_DEVICES; i++)
+		g_object_unref (devices[i]);
+}
+
+static void
+formula_update_test (void)
+{
+	ArvDevice *device;
+	ArvGc *genicam;
+	ArvGcNode *node;
+	ArvDomNode *iter;
+	ArvGcPropertyNode *formula = NULL;
+	gint64 value;
+
+	device = arv_fake_device_new ("TEST0", NULL);
+	g_assert (ARV_IS_FAKE_DEVICE (device));
+
+	genicam = arv_device_get_genicam (device);
+	g_assert (ARV_IS_GC (genicam));
+
+	node = arv_gc_get_node (genicam, "IntSwissKnifeTest");
+	g_assert (ARV_IS_GC_SWISS_KNIFE (node));
+
+	for (iter = arv_dom_node_get_first_child (ARV_DOM_NODE (node));
+	     iter != NULL;
+	     iter = arv_dom_node_get_next_sibling (iter))
+		if (ARV_IS_GC_PROPERTY_NODE (iter) &&
+		    arv_gc_property_node_get_node_type (ARV_GC_PROPERTY_NODE (iter)) == ARV_GC_PROPERTY_NODE_TYPE_FORMULA)
+			formula = ARV_GC_PROPERTY_NODE (iter);
+	g_assert (ARV_IS_GC_PROPERTY_NODE (formula));
+
+	value = arv_gc_integer_get_value (ARV_GC_INTEGER (node), NULL);
+	g_assert_cmpint (value, ==, 0x1234);
+
+	/* The cached formula must follow the property changes */
+	arv_gc_property_node_set_string (formula, "0x4321", NULL);
+	value = arv_gc_integer_get_value (ARV_GC_INTEGER (node), NULL);
+	g_assert_cmpint (value, ==, 0x4321);
+
+	arv_dom_character_data_set_data (ARV_DOM_CHARACTER_DATA (arv_dom_node_get_first_child (ARV_DOM_NODE (formula))),
+					 "2 * 3");
+	value = arv_gc_integer_get_value (ARV_GC_INTEGER (node), NULL);
+	g_assert_cmpint (value, ==, 6);
+
+	g_object_unref (device);
+}
+
+static void
+child_nodes_test (void)
+{
+	ArvGcNode *category;
+	ArvDomNodeList *list;
+	ArvDomNode *children[100];
+	ArvDomNode *iter;
+	unsigned i;
+
+	category = arv_gc_category_new ();
+	list = arv_dom_node_get_child_nodes (ARV_DOM_NODE (category));
+	g_assert_cmpint (arv_dom_node_list_get_length (list), ==, 0);
+	g_assert (arv_dom_node_list_get_item (list, 0) == NULL);
+
+	for (i = 0; i < G_N_ELEMENTS (children); i++) {
+		children[i] = ARV_DOM_NODE (arv_gc_property_node_new_p_feature ());
+		arv_dom_node_append_child (ARV_DOM_NODE (category), children[i]);
+
+		/* The index is extended by the appends */
+		if (i == 10)
+			g_assert (arv_dom_node_list_get_item (list, 10) == children[10]);
+	}
+
+	g_assert_cmpint (arv_dom_node_list_get_length (list), ==, G_N_ELEMENTS (children));
+	g_assert_cmpint (arv_dom_node_get_n_children (ARV_DOM_NODE (category)), ==, G_N_ELEMENTS (children));
+	for (i = 0; i < G_N_ELEMENTS (children); i++)
+		g_assert (arv_dom_node_list_get_item (list, i) == children[i]);
+	g_assert (arv_dom_node_list_get_item (list, G_N_ELEMENTS (children)) == NULL);
+
+	/* Removals and insertions rebuild the index */
+	iter = arv_dom_node_remove_child (ARV_DOM_NODE (category), children[50]);
+	g_assert (iter == children[50]);
+	g_assert_cmpint (arv_dom_node_list_get_length (list), ==, G_N_ELEMENTS (children) - 1);
+	g_assert (arv_dom_node_list_get_item (list, 50) == children[51]);
+
+	arv_dom_node_insert_before (ARV_DOM_NODE (category), children[50], children[0]);
+	g_assert_cmpint (arv_dom_node_list_get_length (list), ==, G_N_ELEMENTS (children));
+	g_assert (arv_dom_node_list_get_item (list, 0) == children[50]);
+	g_assert (arv_dom_node_list_get_item (list, 1) == children[0]);
+	g_assert (arv_dom_node_get_nth_child (ARV_DOM_NODE (category), 51) == children[51]);
+
+	g_object_unref (category);
+}
+
+static void
+property_value_test (void)
+{
+	ArvDevice *device;
+	ArvGc *genicam;
+	ArvGcNode *node;
+	ArvDomNode *iter;
+	ArvGcPropertyNode *property = NULL;
+
+	device = arv_fake_device_new ("TEST0", NULL);
+	g_assert (ARV_IS_FAKE_DEVICE (device));
+
+	genicam = arv_device_get_genicam (device);
+	node = arv_gc_get_node (genicam, "RWInteger");
+	g_assert (ARV_IS_GC_INTEGER_NODE (node));
+
+	for (iter = arv_dom_node_get_first_child (ARV_DOM_NODE (node));
+	     iter != NULL;
+	     iter = arv_dom_node_get_next_sibling (iter)) {
+		/* Blank text between the properties is not kept */
+		g_assert (ARV_IS_GC_PROPERTY_NODE (iter));
+		if (arv_gc_property_node_get_node_type (ARV_GC_PROPERTY_NODE (iter)) == ARV_GC_PROPERTY_NODE_TYPE_VALUE)
+			property = ARV_GC_PROPERTY_NODE (iter);
+	}
+	g_assert (ARV_IS_GC_PROPERTY_NODE (property));
+
+	g_assert_cmpint (arv_gc_property_node_get_int64 (property, NULL), ==, 1);
+	g_assert_cmpfloat (arv_gc_property_node_get_double (property, NULL), ==, 1.0);
+
+	/* The parsed values must follow the changes of the data */
+	arv_gc_property_node_set_int64 (property, 3, NULL);
+	g_assert_cmpint (arv_gc_property_node_get_int64 (property, NULL), ==, 3);
+	g_assert_cmpfloat (arv_gc_property_node_get_double (property, NULL), ==, 3.0);
+
+	arv_dom_character_data_set_data (ARV_DOM_CHARACTER_DATA (arv_dom_node_get_first_child (ARV_DOM_NODE (property))),
+					 "0x10");
+	g_assert_cmpint (arv_gc_property_node_get_int64 (property, NULL), ==, 16);
+
+	g_object_unref (device);
+}
+
+static void
+invalidator_test (void)
+{
+	ArvDevice *device;
+	ArvGc *genicam;
+	ArvGcNode *invalidator;
+	ArvGcNode *invalidated;
+	ArvGcNode *chained;
+
+	device = arv_fake_device_new ("TEST0", NULL);
+	g_assert (ARV_IS_FAKE_DEVICE (device));
+
+	genicam = arv_device_get_genicam (device);
+	g_assert (ARV_IS_GC (genicam));
+
+	arv_gc_set_register_cache_policy (genicam, ARV_REGISTER_CACHE_POLICY_ENABLE);
+
+	invalidator = arv_gc_get_node (genicam, "InvalidatorRegister");
+	invalidated = arv_gc_get_node (genicam, "InvalidatedRegister");
+	chained = arv_gc_get_node (genicam, "ChainedInvalidatedRegister");
+	g_assert (ARV_IS_GC_REGISTER_NODE (invalidator));
+	g_assert (ARV_IS_GC_REGISTER_NODE (invalidated));
+	g_assert (ARV_IS_GC_REGISTER_NODE (chained));
+
+	arv_gc_integer_set_value (ARV_GC_INTEGER (invalidated), 10, NULL);
+	arv_gc_integer_set_value (ARV_GC_INTEGER (chained), 20, NULL);
+	g_assert_cmpint (arv_gc_integer_get_value (ARV_GC_INTEGER (invalidated), NULL), ==, 10);
+	g_assert_cmpint (arv_gc_integer_get_value (ARV_GC_INTEGER (chained), NULL), ==, 20);
+
+	/* Changes behind the genicam back are hidden by the cache */
+	arv_device_write_register (device, 0x3004, 11, NULL);
+	arv_device_write_register (device, 0x3008, 21, NULL);
+	g_assert_cmpint (arv_gc_integer_get_value (ARV_GC_INTEGER (invalidated), NULL), ==, 10);
+	g_assert_cmpint (arv_gc_integer_get_value (ARV_GC_INTEGER (chained), NULL), ==, 20);
+
+	/* Until an invalidator is written, which invalidates the whole dependency chain */
+	arv_gc_integer_set_value (ARV_GC_INTEGER (invalidator), 1, NULL);
+	g_assert_cmpint (arv_gc_integer_get_value (ARV_GC_INTEGER (invalidated), NULL), ==, 11);
+	g_assert_cmpint (arv_gc_integer_get_value (ARV_GC_INTEGER (chained), NULL), ==, 21);
+
+	arv_device_write_register (device, 0x3008, 22, NULL);
+	g_assert_cmpint (arv_gc_integer_get_value (ARV_GC_INTEGER (chained), NULL), ==, 21);
+
+	arv_gc_integer_set_value (ARV_GC_INTEGER (invalidated), 12, NULL);
+	g_assert_cmpint (arv_gc_integer_get_value (ARV_GC_INTEGER (chained), NULL), ==, 22);
+
+	g_object_unref (device);
+}
+
+static void
+register_block_cache_test (void)
+{
+	ArvDevice *device;
+	ArvGc *genicam;
+	ArvGcNode *node_a;
+	ArvGcNode *node_b;
+	ArvGcNode *node_c;
+	ArvGcNode *node_volatile;
+	guint64 block_address;
+
+	g_assert (arv_gc_register_cache_get_block_address (0x3104, 4, &block_address));
+	g_assert_cmpint (block_address, ==, 0x3100);
+	g_assert (arv_gc_register_cache_get_block_address (0x31fc, 4, &block_address));
+	g_assert (!arv_gc_register_cache_get_block_address (0x31fe, 4, NULL));
+	g_assert (!arv_gc_register_cache_get_block_address (0x3100, ARV_GC_REGISTER_CACHE_BLOCK_SIZE + 1, NULL));
+
+	device = arv_fake_device_new ("TEST0", NULL);
+	g_assert (ARV_IS_FAKE_DEVICE (device));
+
+	genicam = arv_device_get_genicam (device);
+	g_assert (ARV_IS_GC (genicam));
+
+	arv_gc_set_register_cache_policy (genicam, ARV_REGISTER_CACHE_POLICY_ENABLE);
+
+	node_a = arv_gc_get_node (genicam, "BlockRegisterA");
+	node_b = arv_gc_get_node (genicam, "BlockRegisterB");
+	node_c = arv_gc_get_node (genicam, "BlockRegisterC");
+	node_volatile = arv_gc_get_node (genicam, "BlockRegisterVolatile");
+	g_assert (ARV_IS_GC_REGISTER_NODE (node_a));
+	g_assert (ARV_IS_GC_REGISTER_NODE (node_b));
+	g_assert (ARV_IS_GC_REGISTER_NODE (node_c));
+	g_assert (ARV_IS_GC_REGISTER_NODE (node_volatile));
+
+	arv_device_write_register (device, 0x3100, 1, NULL);
+	arv_device_write_register (device, 0x3104, 2, NULL);
+	arv_device_write_register (device, 0x3108, 3, NULL);
+	arv_device_write_register (device, 0x310c, 4, NULL);
+
+	g_assert_cmpint (arv_gc_integer_get_value (ARV_GC_INTEGER (node_a), NULL), ==, 1);
+
+	/* The neighbouring registers were read together with the first one */
+	arv_device_write_register (device, 0x3104, 20, NULL);
+	arv_device_write_register (device, 0x3108, 30, NULL);
+	g_assert_cmpint (arv_gc_integer_get_value (ARV_GC_INTEGER (node_b), NULL), ==, 2);
+
+	/* Except the volatile ones */
+	g_assert_cmpint (arv_gc_integer_get_value (ARV_GC_INTEGER (node_volatile), NULL), ==, 30);
+
+	/* Any write flushes the block cache */
+	arv_device_write_register (device, 0x310c, 40, NULL);
+	arv_gc_integer_set_value (ARV_GC_INTEGER (node_a), 10, NULL);
+	g_assert_cmpint (arv_gc_integer_get_value (ARV_GC_INTEGER (node_c), NULL), ==, 40);
+	g_assert_cmpint (arv_gc_integer_get_value (ARV_GC_INTEGER (node_a), NULL), ==, 10);
+
+	g_object_unref (device);
+}
+
+static void
+feature_statistics_test (void)
+{
+	ArvDevice *device;
+	ArvGc *genicam;
+	ArvGcNode *node;
+	guint64 n_reads, n_writes, n_cache_hits, n_cache_misses, port_time_us;
+
+	device = arv_fake_device_new ("TEST0", NULL);
+	g_assert (ARV_IS_FAKE_DEVICE (device));
+
+	genicam = arv_device_get_genicam (device);
+	g_assert (ARV_IS_GC (genicam));
+
+	arv_gc_set_register_cache_policy (genicam, ARV_REGISTER_CACHE_POLICY_ENABLE);
+
+	node = arv_gc_get_node (genicam, "BlockRegisterA");
+	g_assert (ARV_IS_GC_REGISTER_NODE (node));
+
+	arv_gc_integer_set_value (ARV_GC_INTEGER (node), 1, NULL);
+	arv_gc_integer_get_value (ARV_GC_INTEGER (node), NULL);
+	arv_gc_integer_get_value (ARV_GC_INTEGER (node), NULL);
+
+	g_assert (arv_gc_get_feature_statistics (genicam, "BlockRegisterA", &n_reads, &n_writes,
+						 &n_cache_hits, &n_cache_misses, &port_time_us));
+	g_assert_cmpint (n_reads, ==, 2);
+	g_assert_cmpint (n_writes, ==, 1);
+	g_assert_cmpint (n_cache_hits, ==, 2);
+	g_assert_cmpint (n_cache_misses, ==, 0);
+
+	node = arv_gc_get_node (genicam, "BlockRegisterVolatile");
+	arv_gc_integer_get_value (ARV_GC_INTEGER (node), NULL);
+
+	g_assert (arv_gc_get_feature_statistics (genicam, "BlockRegisterVolatile", &n_reads, NULL,
+						 &n_cache_hits, &n_cache_misses, NULL));
+	g_assert_cmpint (n_reads, ==, 1);
+	g_assert_cmpint (n_cache_hits, ==, 0);
+	g_assert_cmpint (n_cache_misses, ==, 1);
+
+	arv_gc_reset_feature_statistics (genicam);
+
+	g_assert (arv_gc_get_feature_statistics (genicam, "BlockRegisterA", &n_reads, &n_writes,
+						 &n_cache_hits, &n_cache_misses, &port_time_us));
+	g_assert_cmpint (n_reads + n_writes + n_cache_hits + n_cache_misses + port_time_us, ==, 0);
+
+	g_assert (!arv_gc_get_feature_statistics (genicam, "RWInteger", &n_reads, NULL, NULL, NULL, NULL));
+	g_assert (!arv_gc_get_feature_statistics (genicam, "NotAFeature", &n_reads, NULL, NULL, NULL, NULL));
+	g_assert_cmpint (n_reads, ==, 0);
+
+	g_object_unref (device);
+}
+
+static void
+prefetch_features_test (void)
+{
+	ArvDevice *device;
+	ArvGc *genicam;
+	ArvGcFeatureNode *features[2];
+
+	device = arv_fake_device_new ("TEST0", NULL);
+	g_assert (ARV_IS_FAKE_DEVICE (device));
+
+	genicam = arv_device_get_genicam (device);
+	g_assert (ARV_IS_GC (genicam));
+
+	arv_gc_set_register_cache_policy (genicam, ARV_REGISTER_CACHE_POLICY_ENABLE);
+
+	features[0] = ARV_GC_FEATURE_NODE (arv_gc_get_node (genicam, "BlockRegisterA"));
+	features[1] = ARV_GC_FEATURE_NODE (arv_gc_get_node (genicam, "BlockRegisterC"));
+
+	arv_device_write_register (device, 0x3100, 1, NULL);
+	arv_device_write_register (device, 0x310c, 4, NULL);
+
+	arv_gc_prefetch_features (genicam, features, G_N_ELEMENTS (features));
+
+	/* Both values come from the prefetched block */
+	arv_device_write_register (device, 0x3100, 10, NULL);
+	arv_device_write_register (device, 0x310c, 40, NULL);
+	g_assert_cmpint (arv_gc_integer_get_value (ARV_GC_INTEGER (features[0]), NULL), ==, 1);
+	g_assert_cmpint (arv_gc_integer_get_value (ARV_GC_INTEGER (features[1]), NULL), ==, 4);
+
+	g_object_unref (device);
+}
+
+static void
+register_snapshot_test (void)
+{
+	ArvDevice *device;
+	ArvRegisterSnapshot *recorder;
+	ArvRegisterSnapshot *snapshot;
+	ArvGc *genicam;
+	ArvGc *offline_genicam;
+	GError *error = NULL;
+	const void *data;
+	const char *xml;
+	char *filename;
+	guint64 address;
+	guint32 size;
+	size_t xml_size;
+	gint64 value;
+	int fd;
+
+	device = arv_fake_device_new ("TEST0", NULL);
+	g_assert (ARV_IS_FAKE_DEVICE (device));
+
+	genicam = arv_device_get_genicam (device);
+	g_assert (ARV_IS_GC (genicam));
+
+	arv_device_write_register (device, 0x3100, 1, NULL);
+	arv_device_write_register (device, 0x310c, 4, NULL);
+
+	recorder = arv_register_snapshot_new ();
+	xml = arv_device_get_genicam_xml (device, &xml_size);
+	arv_register_snapshot_set_genicam_xml (recorder, xml, xml_size);
+	arv_gc_set_register_recorder (genicam, recorder);
+	g_assert (arv_gc_get_register_recorder (genicam) == recorder);
+
+	g_assert_cmpint (arv_gc_integer_get_value (ARV_GC_INTEGER (arv_gc_get_node (genicam, "BlockRegisterA")), NULL),
+			 ==, 1);
+	g_assert_cmpint (arv_gc_integer_get_value (ARV_GC_INTEGER (arv_gc_get_node (genicam, "BlockRegisterC")), NULL),
+			 ==, 4);
+
+	arv_gc_set_register_recorder (genicam, NULL);
+	g_object_unref (device);
+
+	/* Round trip through a file */
+	fd = g_file_open_tmp ("arv-register-snapshot-XXXXXX", &filename, &error);
+	g_assert_no_error (error);
+	g_close (fd, NULL);
+
+	g_assert (arv_register_snapshot_save (recorder, filename, &error));
+	g_assert_no_error (error);
+	g_object_unref (recorder);
+
+	snapshot = arv_register_snapshot_new_from_file (filename, &error);
+	g_assert_no_error (error);
+	g_assert (ARV_IS_REGISTER_SNAPSHOT (snapshot));
+
+	xml = arv_register_snapshot_get_genicam_xml (snapshot, &xml_size);
+	g_assert (xml != NULL);
+
+	offline_genicam = arv_gc_new (NULL, xml, xml_size);
+	arv_gc_set_register_snapshot (offline_genicam, snapshot);
+
+	value = arv_gc_integer_get_value (ARV_GC_INTEGER (arv_gc_get_node (offline_genicam, "BlockRegisterA")), &error);
+	g_assert_no_error (error);
+	g_assert_cmpint (value, ==, 1);
+	value = arv_gc_integer_get_value (ARV_GC_INTEGER (arv_gc_get_node (offline_genicam, "BlockRegisterC")), &error);
+	g_assert_no_error (error);
+	g_assert_cmpint (value, ==, 4);
+
+	/* Registers never read are not in the snapshot */
+	arv_gc_integer_get_value (ARV_GC_INTEGER (arv_gc_get_node (offline_genicam, "IntRegisterB")), &error);
+	g_assert_error (error, ARV_GC_ERROR, ARV_GC_ERROR_NOT_IN_SNAPSHOT);
+	g_clear_error (&error);
+
+	/* Writes are applied to the snapshot, and recorded */
+	arv_gc_integer_set_value (ARV_GC_INTEGER (arv_gc_get_node (offline_genicam, "BlockRegisterA")), 12, &error);
+	g_assert_no_error (error);
+	value = arv_gc_integer_get_value (ARV_GC_INTEGER (arv_gc_get_node (offline_genicam, "BlockRegisterA")), &error);
+	g_assert_no_error (error);
+	g_assert_cmpint (value, ==, 12);
+
+	g_assert_cmpint (arv_register_snapshot_get_n_writes (snapshot), ==, 1);
+	data = arv_register_snapshot_get_write (snapshot, 0, &address, &size);
+	g_assert (data != NULL);
+	g_assert_cmpint (address, ==, 0x3100);
+	g_assert_cmpint (size, ==, 4);
+	g_assert (arv_register_snapshot_get_write (snapshot, 1, NULL, NULL) == NULL);
+
+	arv_register_snapshot_clear_writes (snapshot);
+	g_assert_cmpint (arv_register_snapshot_get_n_writes (snapshot), ==, 0);
+
+	g_object_unref (offline_genicam);
+	g_object_unref (snapshot);
+
+	g_unlink (filename);
+	g_free (filename);
+}
+
+static void
+string_pool_test (void)
+{
+	ArvDevice *device;
+	ArvGc *genicam;
+	ArvGcNode *node;
+	char *name;
+
+	device = arv_fake_device_new ("TEST0", NULL);
+	g_assert (ARV_IS_FAKE_DEVICE (device));
+
+	genicam = arv_device_get_genicam (device);
+	g_assert (ARV_IS_GC (genicam));
+
+	name = g_strdup ("RWInteger");
+
+	node = arv_gc_get_node (genicam, name);
+	g_assert (ARV_IS_GC_FEATURE_NODE (node));
+	g_assert (arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (node)) != name);
+	g_assert (arv_gc_feature_node_get_name (ARV_GC_FEATURE_NODE (node)) == arv_gc_intern_string (genicam, name));
+	g_assert (arv_gc_lookup_interned_string (genicam, name) == arv_gc_intern_string (genicam, "RWInteger"));
+
+	/* Stable feature handle */
+	g_assert (arv_device_get_feature (device, name) == node);
+	g_assert (arv_gc_get_node (genicam, "RWInteger") == node);
+
+	g_assert (arv_gc_lookup_interned_string (genicam, "NotAnInternedString") == NULL);
+	g_assert (arv_gc_get_node (genicam, "NotAnInternedString") == NULL);
+
+	g_free (name);
+
+	g_object_unref (device);
+}
+
+typedef struct {
+	ArvGc *genicam;
+	gint n_errors;
+} ConcurrentReadsData;
+
+static gpointer
+concurrent_reads_thread (gpointer user_data)
+{
+	ConcurrentReadsData *data = user_data;
+	ArvGcNode *integer;
+	ArvGcNode *swiss_knife;
+	unsigned i;
+
+	integer = arv_gc_get_node (data->genicam, "RWInteger");
+	swiss_knife = arv_gc_get_node (data->genicam, "IntSwissKnifeTest");
+
+	for (i = 0; i < 1000; i++) {
+		GError *error = NULL;
+		gint64 value;
+
+		value = arv_gc_integer_get_value (ARV_GC_INTEGER (integer), &error);
+		if (error != NULL || (value != 1 && value != 2 && value != 4))
+			g_atomic_int_inc (&data->n_errors);
+		g_clear_error (&error);
+
+		value = arv_gc_integer_get_value (ARV_GC_INTEGER (swiss_knife), &error);
+		if (error != NULL || value != 0x1234)
+			g_atomic_int_inc (&data->n_errors);
+		g_clear_error (&error);
+	}
+
+	return NULL;
+}
+
+static void
+concurrent_reads_test (void)
+{
+	ConcurrentReadsData data;
+	ArvDevice *device;
+	ArvGcNode *node;
+	GError *error = NULL;
+	GThread *threads[4];
+	unsigned i;
+
+	device = arv_fake_device_new ("TEST0", &error);
+	g_assert (ARV_IS_FAKE_DEVICE (device));
+	g_assert (error == NULL);
+
+	data.genicam = arv_device_get_genicam (device);
+	data.n_errors = 0;
+	arv_gc_set_register_cache_policy (data.genicam, ARV_REGISTER_CACHE_POLICY_ENABLE);
+
+	node = arv_gc_get_node (data.genicam, "RWInteger");
+	g_assert (ARV_IS_GC_INTEGER_NODE (node));
+
+	for (i = 0; i < G_N_ELEMENTS (threads); i++)
+		threads[i] = g_thread_new ("reader", concurrent_reads_thread, &data);
+
+	/* The writes are serialized with the reads */
+	for (i = 0; i < 200; i++) {
+		arv_gc_integer_set_value (ARV_GC_INTEGER (node), i % 2 == 0 ? 2 : 4, &error);
+		g_assert (error == NULL);
+	}
+
+	for (i = 0; i < G_N_ELEMENTS (threads); i++)
+		g_thread_join (threads[i]);
+
+	g_assert_cmpint (data.n_errors, ==, 0);
+	g_assert_cmpint (arv_gc_integer_get_value (ARV_GC_INTEGER (node), NULL), ==, 4);
+
+	g_object_unref (device);
+}
+
+static guint64
+_get_n_reads (ArvGc *genicam, const char *name)
+{
+	guint64 n_reads;
+
+	arv_gc_register_node_get_statistics (ARV_GC_REGISTER_NODE (arv_gc_get_node (genicam, name)),
+					     &n_reads, NULL, NULL, NULL, NULL);
+
+	return n_reads;
+}
+
+static void
+cached_bounds_test (void)
+{
+	ArvDevice *device;
+	ArvGc *genicam;
+	ArvGcNode *node;
+	GError *error = NULL;
+	guint64 n_reads;
+	gint64 max;
+
+	device = arv_fake_device_new ("TEST0", &error);
+	g_assert (ARV_IS_FAKE_DEVICE (device));
+	g_assert (error == NULL);
+
+	genicam = arv_device_get_genicam (device);
+	arv_gc_set_register_cache_policy (genicam, ARV_REGISTER_CACHE_POLICY_ENABLE);
+
+	node = arv_gc_get_node (genicam, "Width");
+	g_assert (ARV_IS_GC_INTEGER (node));
+
+	max = arv_gc_integer_get_max (ARV_GC_INTEGER (node), &error);
+	g_assert (error == NULL);
+	g_assert_cmpint (max, ==, 2048);
+
+	/* The cached bound doesn't evaluate pMax again */
+	n_reads = _get_n_reads (genicam, "SensorWidthRegister");
+	g_assert_cmpint (arv_gc_integer_get_max (ARV_GC_INTEGER (node), NULL), ==, max);
+	g_assert_cmpint (_get_n_reads (genicam, "SensorWidthRegister"), ==, n_reads);
+
+	/* The range check uses the cached bounds too */
+	arv_gc_integer_set_value (ARV_GC_INTEGER (node), 512, &error);
+	g_assert (error == NULL);
+
+	/* Any change invalidates the cached bounds */
+	n_reads = _get_n_reads (genicam, "SensorWidthRegister");
+	g_assert_cmpint (arv_gc_integer_get_max (ARV_GC_INTEGER (node), NULL), ==, max);
+	g_assert_cmpint (_get_n_reads (genicam, "SensorWidthRegister"), ==, n_reads + 1);
+
+	n_reads = _get_n_reads (genicam, "SensorWidthRegister");
+	arv_gc_invalidate_registers (genicam);
+	g_assert_cmpint (arv_gc_integer_get_max (ARV_GC_INTEGER (node), NULL), ==, max);
+	g_assert_cmpint (_get_n_reads (genicam, "SensorWidthRegister"), ==, n_reads + 1);
+
+	/* Bounds are not cached without register cache */
+	arv_gc_set_register_cache_policy (genicam, ARV_REGISTER_CACHE_POLICY_DISABLE);
+	n_reads = _get_n_reads (genicam, "SensorWidthRegister");
+	arv_gc_integer_get_max (ARV_GC_INTEGER (node), NULL);
+	arv_gc_integer_get_max (ARV_GC_INTEGER (node), NULL);
+	g_assert_cmpint (_get_n_reads (genicam, "SensorWidthRegister"), ==, n_reads + 2);
+
+	g_object_unref (device);
+}
+
+typedef struct {
+	ArvChunkParser *parser;
+	ArvBuffer *buffer;
+	guint32 int_value;
+	gint *n_errors;
+} ChunkParserThreadData;
+
+static gpointer
+chunk_parser_thread (gpointer user_data)
+{
+	ChunkParserThreadData *data = user_data;
+	unsigned i;
+
+	for (i = 0; i < 1000; i++) {
+		GError *error = NULL;
+		gint64 value;
+
+		value = arv_chunk_parser_get_integer_value (data->parser, data->buffer, "ChunkInt", &error);
+		if (error != NULL || value != data->int_value)
+			g_atomic_int_inc (data->n_errors);
+		g_clear_error (&error);
+	}
+
+	return NULL;
+}
+
+static void
+chunk_parser_threads_test (void)
+{
+	ChunkParserThreadData data[4];
+	ArvDevice *device;
+	ArvChunkParser *parser;
+	GError *error = NULL;
+	GThread *threads[4];
+	gint n_errors = 0;
+	unsigned i;
+
+	device = arv_fake_device_new ("TEST0", &error);
+	g_assert (ARV_IS_FAKE_DEVICE (device));
+	g_assert (error == NULL);
+
+	parser = arv_device_create_chunk_parser (device);
+	g_assert (ARV_IS_CHUNK_PARSER (parser));
+
+	/* Each thread parses its own buffer, with a different ChunkInt value */
+	for (i = 0; i < G_N_ELEMENTS (threads); i++) {
+		guint32 *int_value;
+
+		data[i].parser = parser;
+		data[i].buffer = create_buffer_with_chunk_data ();
+		data[i].int_value = 0x11223344 + i;
+		data[i].n_errors = &n_errors;
+
+		int_value = (guint32 *) arv_buffer_get_chunk_data (data[i].buffer, 0x12345678, NULL);
+		g_assert (int_value != NULL);
+		*int_value = GUINT32_TO_BE (data[i].int_value);
+	}
+
+	for (i = 0; i < G_N_ELEMENTS (threads); i++)
+		threads[i] = g_thread_new ("parser", chunk_parser_thread, &data[i]);
+
+	for (i = 0; i < G_N_ELEMENTS (threads); i++)
+		g_thread_join (threads[i]);
+
+	g_assert_cmpint (n_errors, ==, 0);
+
+	for (i = 0; i < G_N_ELEMENTS (threads); i++)
+		g_object_unref (data[i].buffer);
+	g_object_unref (parser);
+	g_object_unref (device);
+}
+
+static void
+cached_enumeration_test (void)
+{
+	ArvDevice *device;
+	ArvGc *genicam;
+	ArvGcNode *node;
+	GError *error = NULL;
+	const char **strings;
+	const char **other_strings;
+	gint64 *values;
+	guint n_values;
+	guint n_other_values;
+
+	device = arv_fake_device_new ("TEST0", &error);
+	g_assert (ARV_IS_FAKE_DEVICE (device));
+	g_assert (error == NULL);
+
+	genicam = arv_device_get_genicam (device);
+	arv_gc_set_register_cache_policy (genicam, ARV_REGISTER_CACHE_POLICY_ENABLE);
+
+	node = arv_gc_get_node (genicam, "Enumeration");
+	g_assert (ARV_IS_GC_ENUMERATION (node));
+
+	/* The cached entries are the strings of the entry nodes */
+	strings = arv_gc_enumeration_dup_available_string_values (ARV_GC_ENUMERATION (node), &n_values, &error);
+	g_assert_no_error (error);
+	g_assert_cmpint (n_values, ==, 2);
+	other_strings = arv_gc_enumeration_dup_available_string_values (ARV_GC_ENUMERATION (node),
+									&n_other_values, &error);
+	g_assert_no_error (error);
+	g_assert_cmpint (n_other_values, ==, 2);
+	g_assert (strings != other_strings);
+	g_assert (strings[0] == other_strings[0]);
+	g_assert (strings[1] == other_strings[1]);
+	g_free (strings);
+	g_free (other_strings);
+
+	/* A change of a pIsAvailable node invalidates them */
+	arv_gc_integer_set_value (ARV_GC_INTEGER (arv_gc_get_node (genicam, "NotAvailable")), 1, &error);
+	g_assert_no_error (error);
+
+	values = arv_gc_enumeration_dup_available_int_values (ARV_GC_ENUMERATION (node), &n_values, &error);
+	g_assert_no_error (error);
+	g_assert_cmpint (n_values, ==, 3);
+	g_assert_cmpint (values[2], ==, 2);
+	g_free (values);
+
+	g_assert (arv_gc_enumeration_set_int_value (ARV_GC_ENUMERATION (node), 2, &error));
+	g_assert_no_error (error);
+	g_assert_cmpint (arv_gc_enumeration_get_int_value (ARV_GC_ENUMERATION (node), &error), ==, 2);
+	g_assert_no_error (error);
+
+	arv_gc_integer_set_value (ARV_GC_INTEGER (arv_gc_get_node (genicam, "NotAvailable")), 0, &error);
+	g_assert_no_error (error);
+
+	g_assert (!arv_gc_enumeration_set_int_value (ARV_GC_ENUMERATION (node), 2, &error));
+	g_assert_error (error, ARV_GC_ERROR, ARV_GC_ERROR_OUT_OF_RANGE);
+	g_clear_error (&error);
+
+	g_object_unref (device);
+}
+
+static const char schema_validation_xsd[] =
+	"<xs:schema xmlns:xs=\"http://www.w3.org/2001/XMLSchema\"\n"
+	"	targetNamespace=\"http://www.genicam.org/GenApi/Version_1_0\" elementFormDefault=\"qualified\">\n"
+	"	<xs:element name=\"RegisterDescription\">\n"
+	"		<xs:complexType>\n"
+	"			<xs:sequence>\n"
+	"				<xs:any minOccurs=\"0\" maxOccurs=\"unbounded\" processContents=\"skip\"/>\n"
+	"			</xs:sequence>\n"
+	"			<xs:anyAttribute processContents=\"skip\"/>\n"
+	"		</xs:complexType>\n"
+	"	</xs:element>\n"
+	"</xs:schema>\n";
+
+static void
+_open_fake_devices (unsigned n_devices)
+{
+	unsigned i;
+
+	for (i = 0; i < n_devices; i++) {
+		ArvDevice *device;
+
+		device = arv_fake_device_new ("TEST0", NULL);
+		g_assert (ARV_IS_FAKE_DEVICE (device));
+		g_object_unref (device);
+	}
+
+	arv_xml_schema_wait_genicam_validations ();
+}
+
+static void
+schema_validation_test (void)
+{
+	ArvXmlSchema *schema;
+	GError *error = NULL;
+	char *filename;
+	guint n_validations;
+	int fd;
+
+	fd = g_file_open_tmp ("arv-schema-XXXXXX.xsd", &filename, &error);
+	g_assert_no_error (error);
+	g_close (fd, NULL);
+	g_assert (g_file_set_contents (filename, schema_validation_xsd, -1, NULL));
+
+	schema = arv_xml_schema_new_from_path (filename);
+	g_assert (ARV_IS_XML_SCHEMA (schema));
+
+	/* No validation by default */
+	n_validations = arv_xml_schema_get_n_genicam_validations ();
+	_open_fake_devices (2);
+	g_assert_cmpint (arv_xml_schema_get_n_genicam_validations (), ==, n_validations);
+
+	/* Only the first load of the same data is validated */
+	arv_set_genicam_schema_validation (ARV_XML_SCHEMA_VALIDATION_POLICY_FIRST_SIGHT, schema);
+	_open_fake_devices (2);
+	g_assert_cmpint (arv_xml_schema_get_n_genicam_validations (), ==, n_validations + 1);
+
+	arv_set_genicam_schema_validation (ARV_XML_SCHEMA_VALIDATION_POLICY_ALWAYS, schema);
+	_open_fake_devices (2);
+	g_assert_cmpint (arv_xml_schema_get_n_genicam_validations (), ==, n_validations + 3);
+
+	arv_set_genicam_schema_validation (ARV_XML_SCHEMA_VALIDATION_POLICY_NEVER, schema);
+	_open_fake_devices (2);
+	g_assert_cmpint (arv_xml_schema_get_n_genicam_validations (), ==, n_validations + 3);
+
+	arv_set_genicam_schema_validation (ARV_XML_SCHEMA_VALIDATION_POLICY_NEVER, NULL);
+
+	g_object_unref (schema);
+	g_remove (filename);
+	g_free (filename);
+}
+
 int
 main (int argc, char *argv[])
 {
@@ -1094,15 +2263,37 @@ main (int argc, char *argv[])
 	g_test_add_func ("/genicam/boolean", boolean_test);
 	g_test_add_func ("/genicam/float", float_test);
 	g_test_add_func ("/genicam/enumeration", enumeration_test);
+	g_test_add_func ("/genicam/enumeration-entry-table", enumeration_entry_table_test);
 	g_test_add_func ("/genicam/swissknife", swiss_knife_test);
+	g_test_add_func ("/genicam/formula-update", formula_update_test);
+	g_test_add_func ("/genicam/child-nodes", child_nodes_test);
+	g_test_add_func ("/genicam/property-value", property_value_test);
+	g_test_add_func ("/genicam/invalidator", invalidator_test);
+	g_test_add_func ("/genicam/register-block-cache", register_block_cache_test);
+	g_test_add_func ("/genicam/prefetch-features", prefetch_features_test);
+	g_test_add_func ("/genicam/register-snapshot", register_snapshot_test);
+	g_test_add_func ("/genicam/feature-statistics", feature_statistics_test);
 	g_test_add_func ("/genicam/converter", converter_test);
+	g_test_add_func ("/genicam/try-get-value", try_get_value_test);
 	g_test_add_func ("/genicam/register", register_test);
 	g_test_add_func ("/genicam/string", string_test);
 	g_test_add_func ("/genicam/url", url_test);
 	g_test_add_func ("/genicam/mandatory", mandatory_test);
 	g_test_add_func ("/genicam/chunk-data", chunk_data_test);
+	g_test_add_func ("/genicam/event-data", event_data_test);
+	g_test_add_func ("/genicam/chunk-plan", chunk_plan_test);
 	g_test_add_func ("/genicam/indexed", indexed_test);
 	g_test_add_func ("/genicam/visibility", visibility_test);
+	g_test_add_func ("/genicam/snapshot", snapshot_test);
+	g_test_add_func ("/genicam/lazy-loading", lazy_loading_test);
+	g_test_add_func ("/genicam/shared-model", shared_model_test);
+	g_test_add_func ("/genicam/concurrent-shared-model", concurrent_shared_model_test);
+	g_test_add_func ("/genicam/string-pool", string_pool_test);
+	g_test_add_func ("/genicam/concurrent-reads", concurrent_reads_test);
+	g_test_add_func ("/genicam/chunk-parser-threads", chunk_parser_threads_test);
+	g_test_add_func ("/genicam/cached-bounds", cached_bounds_test);
+	g_test_add_func ("/genicam/cached-enumeration", cached_enumeration_test);
+	g_test_add_func ("/genicam/schema-validation", schema_validation_test);
 
 	result = g_test_run();
 
@@ -0,0 +1,218 @@
+#include <arv.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ARAVIS_COMPILATION
+#include "../src/arvbufferprivate.h"
+#include "../src/arvgcprivate.h"
+
+#define N_PARSE_ITERATIONS	20
+#define N_ITERATIONS		100000
+
+typedef void (*BenchmarkFunc) (gpointer data, guint iteration);
+
+static void
+_run (const char *name, guint n_iterations, BenchmarkFunc func, gpointer data)
+{
+	gint64 start_time;
+	gint64 elapsed_time;
+	guint i;
+
+	start_time = g_get_monotonic_time ();
+
+	for (i = 0; i < n_iterations; i++)
+		func (data, i);
+
+	elapsed_time = g_get_monotonic_time () - start_time;
+
+	g_print ("%-50s %12.1f ns/op\n", name, 1000.0 * (double) elapsed_time / (double) n_iterations);
+}
+
+typedef struct {
+	ArvDevice *device;
+	const char *xml;
+	size_t size;
+} ParseData;
+
+static void
+parse_func (gpointer data, guint iteration)
+{
+	ParseData *parse_data = data;
+	ArvGc *genicam;
+
+	genicam = arv_gc_new (parse_data->device, parse_data->xml, parse_data->size);
+	g_assert (ARV_IS_GC (genicam));
+	g_object_unref (genicam);
+}
+
+static const char *node_names[] = {
+	"RWFloat",
+	"IntSwissKnifeTest",
+	"Converter",
+	"IntConverter",
+	"BlockRegisterA",
+	"Enumeration"
+};
+
+static void
+get_node_func (gpointer data, guint iteration)
+{
+	g_assert (arv_gc_get_node (data, node_names[iteration % G_N_ELEMENTS (node_names)]) != NULL);
+}
+
+static void
+integer_get_func (gpointer data, guint iteration)
+{
+	arv_gc_integer_get_value (data, NULL);
+}
+
+static void
+integer_set_func (gpointer data, guint iteration)
+{
+	arv_gc_integer_set_value (data, iteration & 0xff, NULL);
+}
+
+static void
+float_get_func (gpointer data, guint iteration)
+{
+	arv_gc_float_get_value (data, NULL);
+}
+
+static void
+float_set_func (gpointer data, guint iteration)
+{
+	arv_gc_float_set_value (data, (double) (iteration & 0xff), NULL);
+}
+
+typedef struct {
+	ArvChunkParser *parser;
+	ArvBuffer *buffer;
+} ChunkData;
+
+static void
+chunk_get_integer_func (gpointer data, guint iteration)
+{
+	ChunkData *chunk_data = data;
+
+	arv_chunk_parser_get_integer_value (chunk_data->parser, chunk_data->buffer, "ChunkInt", NULL);
+}
+
+/* A buffer with an integer chunk at the end of the payload, preceded by a padding chunk */
+
+static ArvBuffer *
+_create_chunk_buffer (void)
+{
+	ArvBuffer *buffer;
+	guint32 *data;
+	size_t size = 64 + 8 + 8;
+
+	buffer = arv_buffer_new (size, NULL);
+	buffer->priv->payload_type = ARV_BUFFER_PAYLOAD_TYPE_CHUNK_DATA;
+	buffer->priv->status = ARV_BUFFER_STATUS_SUCCESS;
+	data = (guint32 *) arv_buffer_get_data (buffer, &size);
+
+	memset (data, 0, size);
+	data[14] = GUINT32_TO_BE (0x44444444);
+	data[15] = GUINT32_TO_BE (56);
+	data[16] = GUINT32_TO_BE (0x11223344);
+	data[18] = GUINT32_TO_BE (0x12345678);
+	data[19] = GUINT32_TO_BE (8);
+
+	return buffer;
+}
+
+static void
+_run_node (ArvGc *genicam, const char *name, const char *label, BenchmarkFunc func)
+{
+	ArvGcNode *node;
+
+	node = arv_gc_get_node (genicam, name);
+	if (node == NULL) {
+		g_print ("%-50s %15s\n", label, "not found");
+		return;
+	}
+
+	_run (label, N_ITERATIONS, func, node);
+}
+
+int
+main (int argc, char **argv)
+{
+	const char *filenames[] = {GENICAM_FILENAME, FAKE_GENICAM_FILENAME};
+	ArvDevice *device;
+	ArvGc *genicam;
+	ChunkData chunk_data;
+	guint i;
+
+	arv_set_fake_camera_genicam_filename (GENICAM_FILENAME);
+
+	device = arv_fake_device_new ("TEST0", NULL);
+	g_assert (ARV_IS_FAKE_DEVICE (device));
+
+	genicam = arv_device_get_genicam (device);
+
+	for (i = 0; i < G_N_ELEMENTS (filenames); i++) {
+		ParseData parse_data;
+		char *xml;
+		char *basename;
+		char *label;
+		size_t size;
+
+		if (!g_file_get_contents (filenames[i], &xml, &size, NULL)) {
+			g_print ("Failed to read %s\n", filenames[i]);
+			continue;
+		}
+
+		parse_data.device = device;
+		parse_data.xml = xml;
+		parse_data.size = size;
+
+		basename = g_path_get_basename (filenames[i]);
+
+		label = g_strdup_printf ("Parse %s", basename);
+		arv_gc_set_lazy_loading (FALSE);
+		_run (label, N_PARSE_ITERATIONS, parse_func, &parse_data);
+		g_free (label);
+
+		label = g_strdup_printf ("Lazy parse %s", basename);
+		arv_gc_set_lazy_loading (TRUE);
+		_run (label, N_PARSE_ITERATIONS, parse_func, &parse_data);
+		arv_gc_set_lazy_loading (FALSE);
+		g_free (label);
+
+		g_free (basename);
+		g_free (xml);
+	}
+
+	_run ("arv_gc_get_node", N_ITERATIONS, get_node_func, genicam);
+
+	_run_node (genicam, "IntSwissKnifeTest", "IntSwissKnife get", integer_get_func);
+	_run_node (genicam, "IntSwissKnifeTestEntity", "IntSwissKnife with entities get", integer_get_func);
+	_run_node (genicam, "Converter", "Converter get", float_get_func);
+	_run_node (genicam, "Converter", "Converter set", float_set_func);
+	_run_node (genicam, "IntConverter", "IntConverter get", integer_get_func);
+	_run_node (genicam, "IntConverter", "IntConverter set", integer_set_func);
+
+	arv_gc_set_register_cache_policy (genicam, ARV_REGISTER_CACHE_POLICY_DISABLE);
+	_run_node (genicam, "BlockRegisterA", "IntReg get (uncached)", integer_get_func);
+	_run_node (genicam, "BlockRegisterA", "IntReg set (uncached)", integer_set_func);
+
+	arv_gc_set_register_cache_policy (genicam, ARV_REGISTER_CACHE_POLICY_ENABLE);
+	_run_node (genicam, "BlockRegisterA", "IntReg get (cached)", integer_get_func);
+	_run_node (genicam, "BlockRegisterA", "IntReg set (cached)", integer_set_func);
+	_run_node (genicam, "BlockRegisterVolatile", "Volatile IntReg get (cached)", integer_get_func);
+
+	chunk_data.parser = arv_device_create_chunk_parser (device);
+	chunk_data.buffer = _create_chunk_buffer ();
+	g_assert_cmpint (arv_chunk_parser_get_integer_value (chunk_data.parser, chunk_data.buffer,
+							     "ChunkInt", NULL), ==, 0x11223344);
+	_run ("arv_chunk_parser_get_integer_value", N_ITERATIONS, chunk_get_integer_func, &chunk_data);
+
+	g_object_unref (chunk_data.buffer);
+	g_object_unref (chunk_data.parser);
+	g_object_unref (device);
+
+	arv_shutdown ();
+
+	return EXIT_SUCCESS;
+}
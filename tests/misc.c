@@ -2,7 +2,20 @@
 #include <arv.h>
 #include <arvstr.h>
 #include <string.h>
+#include <math.h>
+
+#define ARAVIS_COMPILATION
 #include "../src/arvmiscprivate.h"
+#include "../src/arvgvcpprivate.h"
+#include "../src/arvclockmodelprivate.h"
+#include "../src/arvframetimingprivate.h"
+#include "../src/arvpacketrecorderprivate.h"
+#include "../src/arveventringprivate.h"
+#include "../src/arvzipprivate.h"
+#include "../src/arvmemcopyprivate.h"
+#include "../src/arvchecksumprivate.h"
+#include "../src/arvbufferbudgetprivate.h"
+#include <glib/gstdio.h>
 
 #if !ARAVIS_CHECK_VERSION (ARAVIS_MAJOR_VERSION, ARAVIS_MINOR_VERSION, ARAVIS_MICRO_VERSION)
 #error
@@ -178,6 +191,565 @@ arv_vendor_alias_lookup_test (void)
 	g_assert (alias == vendor_b);
 }
 
+static void
+arv_statistic_percentile_test (void)
+{
+	ArvStatistic *statistic;
+	int i;
+
+	statistic = arv_statistic_new (1, 100, 10, 0);
+
+	g_assert_cmpint (arv_statistic_get_n_values (statistic, 0), ==, 0);
+	g_assert_cmpint (arv_statistic_get_percentile (statistic, 0, 50.0), ==, 0);
+
+	for (i = 1; i <= 1000; i++)
+		arv_statistic_fill (statistic, 0, i, i);
+
+	g_assert_cmpint (arv_statistic_get_n_values (statistic, 0), ==, 1000);
+	g_assert_cmpint (arv_statistic_get_min (statistic, 0), ==, 1);
+	g_assert_cmpint (arv_statistic_get_max (statistic, 0), ==, 1000);
+	g_assert_cmpint (arv_statistic_get_percentile (statistic, 0, 50.0), ==, 510);
+	g_assert_cmpint (arv_statistic_get_percentile (statistic, 0, 90.0), ==, 910);
+	g_assert_cmpint (arv_statistic_get_percentile (statistic, 0, 99.9), ==, 1000);
+	g_assert_cmpint (arv_statistic_get_percentile (statistic, 0, 0.0), ==, 10);
+
+	arv_statistic_reset (statistic);
+	g_assert_cmpint (arv_statistic_get_n_values (statistic, 0), ==, 0);
+
+	arv_statistic_free (statistic);
+}
+
+static void
+arv_gvcp_event_test (void)
+{
+	ArvGvcpPacket *packet;
+	ArvGvcpPacket *ack_packet;
+	ArvGvcpEvent event = {0};
+	ArvGvcpEvent parsed_event;
+	const guint8 data[] = {0x01, 0x02, 0x03};
+	size_t packet_size;
+	size_t offset;
+	int i;
+
+	event.event_id = 0x9001;
+	event.stream_channel_index = 0;
+	event.block_id = 0x1234;
+	event.timestamp = G_GUINT64_CONSTANT (0x0102030405060708);
+
+	for (i = 0; i < 2; i++) {
+		gboolean extended_ids = i == 1;
+
+		event.data = NULL;
+		event.data_size = 0;
+
+		packet = arv_gvcp_packet_new_event_cmd (&event, extended_ids, 12, &packet_size);
+		g_assert (packet != NULL);
+		g_assert_cmpint (arv_gvcp_packet_get_command (packet), ==, ARV_GVCP_COMMAND_EVENT_CMD);
+
+		offset = arv_gvcp_packet_get_event (packet, 0, &parsed_event);
+		g_assert_cmpint (offset, ==, packet_size - sizeof (ArvGvcpHeader));
+		g_assert_cmpint (parsed_event.event_id, ==, 0x9001);
+		g_assert_cmpint (parsed_event.block_id, ==, 0x1234);
+		g_assert_cmpint (parsed_event.timestamp, ==, G_GUINT64_CONSTANT (0x0102030405060708));
+		g_assert (parsed_event.data == NULL);
+		g_assert_cmpint (arv_gvcp_packet_get_event (packet, offset, &parsed_event), ==, 0);
+
+		ack_packet = arv_gvcp_packet_new_event_ack (packet, &packet_size);
+		g_assert_cmpint (arv_gvcp_packet_get_command (ack_packet), ==, ARV_GVCP_COMMAND_EVENT_ACK);
+		g_assert_cmpint (arv_gvcp_packet_get_packet_id (ack_packet), ==, 12);
+		arv_gvcp_packet_free (ack_packet);
+
+		arv_gvcp_packet_free (packet);
+
+		event.data = data;
+		event.data_size = sizeof (data);
+
+		packet = arv_gvcp_packet_new_event_cmd (&event, extended_ids, 13, &packet_size);
+		g_assert_cmpint (arv_gvcp_packet_get_command (packet), ==, ARV_GVCP_COMMAND_EVENT_DATA_CMD);
+
+		offset = arv_gvcp_packet_get_event (packet, 0, &parsed_event);
+		g_assert_cmpint (offset, >, 0);
+		g_assert_cmpint (parsed_event.event_id, ==, 0x9001);
+		g_assert_cmpint (parsed_event.data_size, ==, sizeof (data));
+		g_assert (memcmp (parsed_event.data, data, sizeof (data)) == 0);
+
+		ack_packet = arv_gvcp_packet_new_event_ack (packet, &packet_size);
+		g_assert_cmpint (arv_gvcp_packet_get_command (ack_packet), ==, ARV_GVCP_COMMAND_EVENT_DATA_ACK);
+		arv_gvcp_packet_free (ack_packet);
+
+		arv_gvcp_packet_free (packet);
+	}
+}
+
+static void
+arv_gvcp_action_test (void)
+{
+	ArvGvcpPacket *packet;
+	guint32 *data;
+	size_t packet_size;
+
+	packet = arv_gvcp_packet_new_action_cmd (0x12345678, 0x1, 0xffffffff, 0, FALSE, 1, &packet_size);
+	g_assert_cmpint (packet_size, ==, sizeof (ArvGvcpHeader) + 12);
+	g_assert_cmpint (arv_gvcp_packet_get_command (packet), ==, ARV_GVCP_COMMAND_ACTION_CMD);
+	g_assert_cmpint (packet->header.packet_flags, ==, 0);
+	data = (guint32 *) &packet->data;
+	g_assert_cmpint (g_ntohl (data[0]), ==, 0x12345678);
+	g_assert_cmpint (g_ntohl (data[1]), ==, 0x1);
+	g_assert_cmpint (g_ntohl (data[2]), ==, 0xffffffff);
+	arv_gvcp_packet_free (packet);
+
+	packet = arv_gvcp_packet_new_action_cmd (0x12345678, 0x1, 0x2, G_GUINT64_CONSTANT (0x0102030405060708),
+						 TRUE, 2, &packet_size);
+	g_assert_cmpint (packet_size, ==, sizeof (ArvGvcpHeader) + 20);
+	g_assert_cmpint (packet->header.packet_flags, ==,
+			 ARV_GVCP_CMD_PACKET_FLAGS_ACK_REQUIRED | ARV_GVCP_ACTION_PACKET_FLAGS_SCHEDULED);
+	g_assert_cmpint (arv_gvcp_packet_get_packet_id (packet), ==, 2);
+	data = (guint32 *) &packet->data;
+	g_assert_cmpint (g_ntohl (data[3]), ==, 0x01020304);
+	g_assert_cmpint (g_ntohl (data[4]), ==, 0x05060708);
+	arv_gvcp_packet_free (packet);
+
+	packet = arv_gvcp_packet_new_action_ack (2, &packet_size);
+	g_assert_cmpint (packet_size, ==, sizeof (ArvGvcpHeader));
+	g_assert_cmpint (arv_gvcp_packet_get_command (packet), ==, ARV_GVCP_COMMAND_ACTION_ACK);
+	g_assert_cmpint (arv_gvcp_packet_get_packet_id (packet), ==, 2);
+	arv_gvcp_packet_free (packet);
+}
+
+static void
+arv_clock_model_test (void)
+{
+	ArvClockModel *model;
+	GRand *rand;
+	guint64 device_time_ns;
+	guint64 host_time_ns;
+	gint64 error_ns;
+	int i;
+
+	model = arv_clock_model_new (ARV_CLOCK_MODEL_N_SAMPLES_DEFAULT);
+	rand = g_rand_new_with_seed (1234);
+
+	g_assert (!arv_clock_model_is_valid (model));
+
+	/* Device clock running 50 ppm faster than the host clock, frames every 10 ms, received with up to 1 ms of
+	 * random delay on top of a 100 µs latency, one frame out of ten being received without delay */
+	for (i = 0; i < 1000; i++) {
+		device_time_ns = G_GUINT64_CONSTANT (1000000000000) + i * G_GUINT64_CONSTANT (10000000);
+		host_time_ns = G_GUINT64_CONSTANT (5000000000) + i * G_GUINT64_CONSTANT (10000000) -
+			i * G_GUINT64_CONSTANT (500) + 100000 + (i % 10 == 0 ? 0 : g_rand_int_range (rand, 0, 1000000));
+
+		arv_clock_model_add_sample (model, device_time_ns, host_time_ns);
+	}
+
+	g_assert (arv_clock_model_is_valid (model));
+	g_assert_cmpint (arv_clock_model_get_n_resets (model), ==, 0);
+	g_assert_cmpfloat (fabs (arv_clock_model_get_drift_ppm (model) + 50.0), <, 1.0);
+
+	/* The conversion follows the lower envelope, the minimal latency */
+	device_time_ns = G_GUINT64_CONSTANT (1000000000000) + 1000 * G_GUINT64_CONSTANT (10000000);
+	host_time_ns = G_GUINT64_CONSTANT (5000000000) + 1000 * G_GUINT64_CONSTANT (10000000) -
+		1000 * G_GUINT64_CONSTANT (500) + 100000;
+	error_ns = (gint64) (arv_clock_model_convert (model, device_time_ns) - host_time_ns);
+	g_assert_cmpint (ABS (error_ns), <, 50000);
+
+	/* Device timestamp reset */
+	arv_clock_model_add_sample (model, 1000, host_time_ns);
+	g_assert_cmpint (arv_clock_model_get_n_resets (model), ==, 1);
+	g_assert (!arv_clock_model_is_valid (model));
+	g_assert_cmpint (arv_clock_model_convert (model, 1000), ==, host_time_ns);
+
+	g_rand_free (rand);
+	arv_clock_model_free (model);
+}
+
+static void
+arv_frame_timing_test (void)
+{
+	ArvFrameTiming *timing;
+	ArvFrameIntervalStatistics statistics;
+	GRand *rand;
+	guint64 device_time_ns;
+	guint64 host_time_ns;
+	int i;
+
+	timing = arv_frame_timing_new ();
+	rand = g_rand_new_with_seed (4321);
+
+	g_assert_false (arv_frame_timing_get_statistics (timing, ARV_FRAME_INTERVAL_SOURCE_HOST, &statistics));
+
+	/* 10 ms period on a device clock running 20 ppm slower than the host clock, received with up to 200 µs of
+	 * jitter, and 3 missing frames */
+	for (i = 0; i < 2000; i++) {
+		if (i == 500 || i == 1000 || i == 1500)
+			continue;
+
+		device_time_ns = G_GUINT64_CONSTANT (1000000000) + i * G_GUINT64_CONSTANT (10000000);
+		host_time_ns = G_GUINT64_CONSTANT (7000000000) + i * G_GUINT64_CONSTANT (10000200) +
+			g_rand_int_range (rand, 0, 200000);
+
+		arv_frame_timing_add_frame (timing, device_time_ns, host_time_ns);
+	}
+
+	g_assert_true (arv_frame_timing_get_statistics (timing, ARV_FRAME_INTERVAL_SOURCE_DEVICE, &statistics));
+	g_assert_cmpint (statistics.n_intervals, ==, 1996);
+	g_assert_cmpfloat (statistics.reference_period_us, ==, 10000.0);
+	g_assert_cmpfloat (statistics.min_us, ==, 10000.0);
+	g_assert_cmpfloat (statistics.max_us, ==, 20000.0);
+	g_assert_cmpfloat (fabs (statistics.median_us - 10000.0), <=, ARV_FRAME_TIMING_BIN_STEP_US);
+	g_assert_cmpint (statistics.n_gaps, ==, 3);
+	g_assert_cmpfloat (fabs (statistics.mean_us - 10015.03), <, 0.01);
+
+	g_assert_true (arv_frame_timing_get_statistics (timing, ARV_FRAME_INTERVAL_SOURCE_HOST, &statistics));
+	g_assert_cmpint (statistics.n_gaps, ==, 3);
+	g_assert_cmpfloat (fabs (statistics.median_us - 10000.2), <, 20.0);
+	g_assert_cmpfloat (statistics.p99_us, >, statistics.median_us);
+	g_assert_cmpfloat (statistics.p99_us, <, 10300.0);
+	g_assert_cmpfloat (statistics.standard_deviation_us, >, 50.0);
+
+	g_assert_cmpfloat (fabs (arv_frame_timing_get_clock_drift (timing) - 20.0), <, 2.0);
+
+	/* An expected period restarts the statistics */
+	arv_frame_timing_set_expected_period (timing, 5000.0);
+	g_assert_false (arv_frame_timing_get_statistics (timing, ARV_FRAME_INTERVAL_SOURCE_DEVICE, &statistics));
+
+	arv_frame_timing_add_frame (timing, 1000000000, 1000000000);
+	arv_frame_timing_add_frame (timing, 1010000000, 1010000000);
+	g_assert_true (arv_frame_timing_get_statistics (timing, ARV_FRAME_INTERVAL_SOURCE_DEVICE, &statistics));
+	g_assert_cmpint (statistics.n_intervals, ==, 1);
+	g_assert_cmpint (statistics.n_gaps, ==, 1);
+
+	/* Frames without device timestamp */
+	arv_frame_timing_reset (timing);
+	arv_frame_timing_add_frame (timing, 0, 1000000000);
+	arv_frame_timing_add_frame (timing, 0, 1005000000);
+	g_assert_false (arv_frame_timing_get_statistics (timing, ARV_FRAME_INTERVAL_SOURCE_DEVICE, &statistics));
+	g_assert_true (arv_frame_timing_get_statistics (timing, ARV_FRAME_INTERVAL_SOURCE_HOST, &statistics));
+
+	g_rand_free (rand);
+	arv_frame_timing_free (timing);
+}
+
+static void
+arv_packet_recorder_test (void)
+{
+	ArvPacketRecorder *recorder;
+	ArvPacketPlayer *player;
+	GError *error = NULL;
+	char *filename;
+	guint8 packet[100];
+	const void *data;
+	size_t size;
+	guint64 time_us;
+	guint64 n_packets;
+	guint64 n_overwritten;
+	int fd;
+	int i;
+
+	fd = g_file_open_tmp ("arv-packet-record-XXXXXX", &filename, &error);
+	g_assert_no_error (error);
+	g_close (fd, NULL);
+
+	/* Small ring, wrapped several times, with record sizes not dividing the ring size */
+	recorder = arv_packet_recorder_new (filename, ARV_PACKET_RECORD_PROTOCOL_GVSP, 4096, &error);
+	g_assert_no_error (error);
+	g_assert (recorder != NULL);
+
+	for (i = 0; i < 200; i++) {
+		memset (packet, i, sizeof (packet));
+		g_assert (arv_packet_recorder_write (recorder, 1000 + i, packet, 10 + i % 90));
+	}
+
+	g_assert (!arv_packet_recorder_write (recorder, 0, NULL, 8192));
+
+	n_overwritten = arv_packet_recorder_get_n_overwritten (recorder);
+	g_assert_cmpint (arv_packet_recorder_get_n_packets (recorder), ==, 200);
+	g_assert_cmpint (n_overwritten, >, 0);
+
+	arv_packet_recorder_free (recorder);
+
+	player = arv_packet_player_new (filename, &error);
+	g_assert_no_error (error);
+	g_assert (player != NULL);
+	g_assert_cmpint (arv_packet_player_get_protocol (player), ==, ARV_PACKET_RECORD_PROTOCOL_GVSP);
+
+	n_packets = arv_packet_player_get_n_packets (player);
+	g_assert_cmpint (n_packets + n_overwritten, ==, 200);
+
+	/* The most recent packets are kept, in order */
+	for (i = 200 - n_packets; arv_packet_player_next (player, &time_us, &data, &size); i++) {
+		g_assert_cmpint (time_us, ==, 1000 + i);
+		g_assert_cmpint (size, ==, 10 + i % 90);
+		g_assert_cmpint (((const guint8 *) data)[0], ==, i);
+		g_assert_cmpint (((const guint8 *) data)[size - 1], ==, i);
+	}
+	g_assert_cmpint (i, ==, 200);
+
+	arv_packet_player_rewind (player);
+	g_assert (arv_packet_player_next (player, &time_us, NULL, NULL));
+	g_assert_cmpint (time_us, ==, 1000 + 200 - n_packets);
+
+	arv_packet_player_free (player);
+
+	g_unlink (filename);
+	g_free (filename);
+}
+
+static void
+arv_event_ring_test (void)
+{
+	ArvEventRing *ring;
+	ArvEventRecord *records;
+	ArvEventRecord *loaded;
+	GError *error = NULL;
+	char *filename;
+	char *string;
+	guint n_records;
+	guint n_loaded;
+	int fd;
+	int i;
+
+	/* Rounded up to a power of two */
+	ring = arv_event_ring_new (12);
+
+	records = arv_event_ring_get_records (ring, &n_records);
+	g_assert_cmpint (n_records, ==, 0);
+	g_free (records);
+
+	for (i = 0; i < 40; i++)
+		arv_event_ring_record (ring, i % 2 == 0 ? ARV_EVENT_RING_EVENT_LEADER : ARV_EVENT_RING_EVENT_FRAME_CLOSED,
+				       i / 2, i, i % 2 == 0 ? 0 : ARV_BUFFER_STATUS_MISSING_PACKETS);
+
+	/* The latest records are kept, in order */
+	records = arv_event_ring_get_records (ring, &n_records);
+	g_assert_cmpint (n_records, ==, 16);
+	for (i = 0; i < 16; i++) {
+		g_assert_cmpint (records[i].sequence, ==, 24 + i + 1);
+		g_assert_cmpint (records[i].packet_id, ==, 24 + i);
+		g_assert_cmpint (records[i].frame_id, ==, (24 + i) / 2);
+	}
+	g_assert_cmpint (records[0].time_us, <=, records[15].time_us);
+
+	fd = g_file_open_tmp ("arv-event-ring-XXXXXX", &filename, &error);
+	g_assert_no_error (error);
+	g_close (fd, NULL);
+
+	g_assert (arv_event_ring_save (ring, filename, &error));
+	g_assert_no_error (error);
+
+	loaded = arv_event_ring_load (filename, &n_loaded, &error);
+	g_assert_no_error (error);
+	g_assert_cmpint (n_loaded, ==, n_records);
+	g_assert (memcmp (loaded, records, n_records * sizeof (ArvEventRecord)) == 0);
+
+	string = arv_event_ring_records_to_string (loaded, n_loaded);
+	g_assert (strstr (string, "leader") != NULL);
+	g_assert (strstr (string, "frame-closed") != NULL);
+	g_assert (strstr (string, "missing-packets") != NULL);
+	g_free (string);
+
+	g_free (loaded);
+	g_free (records);
+
+	g_assert (g_file_set_contents (filename, "ARVPKT01", 8, NULL));
+	g_assert (arv_event_ring_load (filename, &n_loaded, &error) == NULL);
+	g_assert_error (error, G_IO_ERROR, G_IO_ERROR_FAILED);
+	g_clear_error (&error);
+
+	g_unlink (filename);
+	g_free (filename);
+
+	arv_event_ring_free (ring);
+}
+
+/* Local file header of a "a.xml" entry, followed by the raw deflate data of "hello" and a fake central directory */
+static const guint8 zipped_hello[] = {
+	0x50, 0x4b, 0x03, 0x04, 0x14, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x86, 0xa6,
+	0x10, 0x36, 0x07, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00, 'a',  '.',
+	'x',  'm',  'l',  0xcb, 0x48, 0xcd, 0xc9, 0xc9, 0x07, 0x00, 0x50, 0x4b, 0x01, 0x02
+};
+
+static const guint8 stored_hello[] = {
+	0x50, 0x4b, 0x03, 0x04, 0x0a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x86, 0xa6,
+	0x10, 0x36, 0x05, 0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0xff, 0xff,
+	'h',  'e',  'l',  'l',  'o',  0x50, 0x4b, 0x01, 0x02
+};
+
+static void
+arv_zip_stream_test (void)
+{
+	ArvZipStream *stream;
+	char *data;
+	size_t size;
+	unsigned int i;
+
+	/* Whole archive at once */
+	stream = arv_zip_stream_new ();
+	g_assert (arv_zip_stream_feed (stream, zipped_hello, sizeof (zipped_hello)));
+	g_assert (arv_zip_stream_is_done (stream));
+	data = arv_zip_stream_steal_file (stream, &size);
+	g_assert_cmpint (size, ==, 5);
+	g_assert (memcmp (data, "hello", 5) == 0);
+	g_free (data);
+	arv_zip_stream_free (stream);
+
+	/* Byte by byte, as when the data arrive in small chunks */
+	stream = arv_zip_stream_new ();
+	for (i = 0; i < sizeof (stored_hello) && !arv_zip_stream_is_done (stream); i++)
+		g_assert (arv_zip_stream_feed (stream, &stored_hello[i], 1));
+	g_assert_cmpint (i, ==, sizeof (stored_hello) - 4);
+	data = arv_zip_stream_steal_file (stream, &size);
+	g_assert_cmpint (size, ==, 5);
+	g_assert (memcmp (data, "hello", 5) == 0);
+	g_free (data);
+	arv_zip_stream_free (stream);
+
+	/* Truncated entry */
+	stream = arv_zip_stream_new ();
+	g_assert (arv_zip_stream_feed (stream, zipped_hello, 38));
+	g_assert (!arv_zip_stream_is_done (stream));
+	g_assert (arv_zip_stream_steal_file (stream, &size) == NULL);
+	arv_zip_stream_free (stream);
+
+	/* Not a zip archive */
+	stream = arv_zip_stream_new ();
+	g_assert (!arv_zip_stream_feed (stream, "<RegisterDescription>", 21) ||
+		  !arv_zip_stream_feed (stream, "0123456789", 10));
+	arv_zip_stream_free (stream);
+}
+
+static void
+arv_mem_copy_test (void)
+{
+	guint8 src[4096 + 64];
+	guint8 dst[4096 + 64];
+	size_t sizes[] = {0, 1, 63, 255, 256, 1000, 4096};
+	ArvMemCopySimd simd;
+	ArvMemCopySimd default_simd;
+	unsigned int i, j, offset;
+
+	for (i = 0; i < sizeof (src); i++)
+		src[i] = i % 253;
+
+	default_simd = arv_mem_copy_get_simd ();
+
+	for (simd = ARV_MEM_COPY_SIMD_NONE; simd <= ARV_MEM_COPY_SIMD_NEON; simd++) {
+		if (!arv_mem_copy_set_simd (simd))
+			continue;
+
+		/* Unaligned destinations exercise the head and tail copies of the streaming store path */
+		for (i = 0; i < G_N_ELEMENTS (sizes); i++) {
+			for (offset = 0; offset < 64; offset += 7) {
+				memset (dst, 0xff, sizeof (dst));
+				arv_mem_copy_non_temporal (dst + offset, src + 3, sizes[i]);
+
+				for (j = 0; j < sizes[i]; j++)
+					g_assert_cmpint (dst[offset + j], ==, src[3 + j]);
+				g_assert_cmpint (dst[offset + sizes[i]], ==, 0xff);
+			}
+		}
+	}
+
+	g_assert_true (arv_mem_copy_set_simd (default_simd));
+}
+
+static void
+arv_crc32c_test (void)
+{
+	guint8 data[4096 + 7];
+	ArvChecksumSimd simd;
+	ArvChecksumSimd default_simd;
+	guint32 reference = 0;
+	unsigned int i, split;
+
+	for (i = 0; i < sizeof (data); i++)
+		data[i] = (i * 7) % 251;
+
+	default_simd = arv_checksum_get_simd ();
+
+	for (simd = ARV_CHECKSUM_SIMD_NONE; simd <= ARV_CHECKSUM_SIMD_ARM_CRC; simd++) {
+		guint32 crc;
+
+		if (!arv_checksum_set_simd (simd))
+			continue;
+
+		g_assert_cmphex (arv_crc32c (0, NULL, 0), ==, 0);
+		g_assert_cmphex (arv_crc32c (0, "123456789", 9), ==, 0xe3069283);
+
+		/* Unaligned start exercises the head and tail of the word loops */
+		crc = arv_crc32c (0, data + 3, 4096);
+		if (simd == ARV_CHECKSUM_SIMD_NONE)
+			reference = crc;
+		g_assert_cmphex (crc, ==, reference);
+
+		for (split = 0; split <= 4096; split += 1000) {
+			guint32 crc1 = arv_crc32c (0, data + 3, split);
+			guint32 crc2 = arv_crc32c (0, data + 3 + split, 4096 - split);
+
+			g_assert_cmphex (arv_crc32c (crc1, data + 3 + split, 4096 - split), ==, reference);
+			g_assert_cmphex (arv_crc32c_combine (crc1, crc2, 4096 - split), ==, reference);
+			g_assert_cmphex (arv_crc32c_combine_op (crc1, crc2, arv_crc32c_combine_gen (4096 - split)), ==,
+					 reference);
+		}
+	}
+
+	g_assert_true (arv_checksum_set_simd (default_simd));
+}
+
+static void
+arv_buffer_budget_test (void)
+{
+	ArvBufferBudgetClient *fast;
+	ArvBufferBudgetClient *slow;
+	ArvStreamBudgetStatistics statistics;
+
+	fast = arv_buffer_budget_register ();
+	slow = arv_buffer_budget_register ();
+
+	/* No limit */
+	g_assert_true (arv_buffer_budget_allows (fast, 1 << 30));
+
+	/* Same payload at 100 and 25 frames per second, the shares being 800 and 200 bytes */
+	arv_set_stream_memory_budget (1000, ARV_STREAM_BUDGET_POLICY_RECYCLE_OLDEST);
+	g_assert_cmpint (arv_buffer_budget_get_policy (), ==, ARV_STREAM_BUDGET_POLICY_RECYCLE_OLDEST);
+	arv_buffer_budget_set_rate (fast, 100, 10000.0);
+	arv_buffer_budget_set_rate (slow, 100, 40000.0);
+
+	g_assert_true (arv_buffer_budget_allows (fast, 800));
+	g_assert_false (arv_buffer_budget_allows (fast, 801));
+	g_assert_cmpint (fast->share_bytes, ==, 800);
+	arv_buffer_budget_acquire (fast, 700);
+
+	g_assert_true (arv_buffer_budget_allows (slow, 200));
+	g_assert_false (arv_buffer_budget_allows (slow, 300));
+	g_assert_cmpint (slow->share_bytes, ==, 200);
+	arv_buffer_budget_acquire (slow, 200);
+	g_assert_false (arv_buffer_budget_allows (slow, 1));
+
+	arv_buffer_budget_count (slow, ARV_BUFFER_BUDGET_EVENT_RECYCLE);
+
+	arv_get_stream_memory_budget_statistics (&statistics);
+	g_assert_cmpint (statistics.max_bytes, ==, 1000);
+	g_assert_cmpint (statistics.owned_bytes, ==, 900);
+	g_assert_cmpint (statistics.high_water_mark_bytes, >=, 900);
+	g_assert_cmpint (statistics.n_streams, ==, 2);
+	g_assert_cmpint (statistics.n_refused_allocations, ==, 3);
+	g_assert_cmpint (statistics.n_recycles, ==, 1);
+
+	arv_buffer_budget_release (fast, 700);
+	g_assert_cmpint (fast->owned_bytes, ==, 0);
+
+	/* The unregistration releases the bytes still owned, the events outlive it */
+	arv_buffer_budget_unregister (slow);
+	arv_buffer_budget_unregister (fast);
+
+	arv_get_stream_memory_budget_statistics (&statistics);
+	g_assert_cmpint (statistics.owned_bytes, ==, 0);
+	g_assert_cmpint (statistics.n_streams, ==, 0);
+	g_assert_cmpint (statistics.n_recycles, ==, 1);
+
+	arv_set_stream_memory_budget (0, ARV_STREAM_BUDGET_POLICY_DROP);
+}
+
 int
 main (int argc, char *argv[])
 {
@@ -191,6 +763,17 @@ main (int argc, char *argv[])
 	g_test_add_func ("/str/arv-str-parse-double", arv_str_parse_double_test);
 	g_test_add_func ("/str/arv-str-parse-double-list", arv_str_parse_double_list_test);
 	g_test_add_func ("/misc/arv-vendor-alias-lookup", arv_vendor_alias_lookup_test);
+	g_test_add_func ("/misc/arv-statistic-percentile", arv_statistic_percentile_test);
+	g_test_add_func ("/misc/arv-gvcp-event", arv_gvcp_event_test);
+	g_test_add_func ("/misc/arv-gvcp-action", arv_gvcp_action_test);
+	g_test_add_func ("/misc/arv-clock-model", arv_clock_model_test);
+	g_test_add_func ("/misc/arv-frame-timing", arv_frame_timing_test);
+	g_test_add_func ("/misc/arv-packet-recorder", arv_packet_recorder_test);
+	g_test_add_func ("/misc/arv-event-ring", arv_event_ring_test);
+	g_test_add_func ("/misc/arv-zip-stream", arv_zip_stream_test);
+	g_test_add_func ("/misc/arv-mem-copy", arv_mem_copy_test);
+	g_test_add_func ("/misc/arv-crc32c", arv_crc32c_test);
+	g_test_add_func ("/misc/arv-buffer-budget", arv_buffer_budget_test);
 
 	result = g_test_run();
 
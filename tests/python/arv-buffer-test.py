@@ -19,3 +19,9 @@ buffer_b = Aravis.Buffer.new_allocate (1024)
 
 print ("Buffer a refcount :        %d" %(buffer_a.__grefcount__))
 print ("Buffer b refcount :        %d" %(buffer_b.__grefcount__))
+
+# Wraps the buffer memory without copy, the GLib.Bytes keeps the buffer alive
+bytes_a = buffer_a.get_data_bytes ()
+
+print ("Bytes a size :             %d" %(bytes_a.get_size ()))
+print ("Buffer a refcount :        %d" %(buffer_a.__grefcount__))
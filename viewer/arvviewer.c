@@ -26,6 +26,7 @@
 #include <gst/video/videooverlay.h>
 #include <arv.h>
 #include <arvdebugprivate.h>
+#include <arvstreamprivate.h>
 #include <arvviewer.h>
 #include <math.h>
 #include <memory.h>
@@ -132,6 +133,11 @@ struct  _ArvViewer {
 	GstElement *appsrc;
 	GstElement *transform;
 
+	/* Reused buffers for the stride padded copies */
+	GstBufferPool *padded_buffer_pool;
+	size_t padded_buffer_size;
+	guint render_event;
+
 	guint rotation;
 	gboolean flip_vertical;
 	gboolean flip_horizontal;
@@ -173,6 +179,9 @@ struct  _ArvViewer {
 	GtkWidget *auto_exposure_toggle;
 	GtkWidget *auto_gain_toggle;
 	GtkWidget *acquisition_button;
+	GtkWidget *statistics_button;
+	GtkWidget *statistics_popover;
+	GtkWidget *statistics_label;
 
 	gulong camera_selected;
 	gulong exposure_spin_changed;
@@ -192,6 +201,12 @@ struct  _ArvViewer {
 	guint gain_update_event;
 	guint exposure_update_event;
 
+	/* Features read by the device worker thread in auto mode, instead of the update events */
+	const char *gain_polled_feature;
+	const char *exposure_polled_feature;
+	gulong gain_polled_handler;
+	gulong exposure_polled_handler;
+
 	guint status_bar_update_event;
 	gint64 last_status_bar_update_time_ms;
 	unsigned last_n_images;
@@ -200,6 +215,10 @@ struct  _ArvViewer {
 	unsigned n_bytes;
 	unsigned n_errors;
 
+	/* Previous statistics sample, for the rates */
+	guint64 last_n_resent_packets;
+	guint64 last_n_missing_packets;
+
 	gboolean auto_socket_buffer;
 	gboolean packet_resend;
 	guint packet_timeout;
@@ -269,7 +288,6 @@ arv_viewer_value_from_log (double value, double min, double max)
 typedef struct {
 	GWeakRef stream;
 	ArvBuffer* arv_buffer;
-	void *data;
 } ArvGstBufferReleaseData;
 
 static void
@@ -279,8 +297,6 @@ gst_buffer_release_cb (void *user_data)
 
 	ArvStream* stream = g_weak_ref_get (&release_data->stream);
 
-	g_free (release_data->data);
-
 	if (stream) {
 		gint n_input_buffers, n_output_buffers;
 
@@ -298,58 +314,91 @@ gst_buffer_release_cb (void *user_data)
 	g_free (release_data);
 }
 
+/* Stride padded copies are made into buffers of a pool, reused from one frame to the next */
+
+static GstBufferPool *
+get_padded_buffer_pool (ArvViewer *viewer, size_t size)
+{
+	GstStructure *config;
+
+	if (viewer->padded_buffer_pool != NULL && viewer->padded_buffer_size == size)
+		return viewer->padded_buffer_pool;
+
+	if (viewer->padded_buffer_pool != NULL) {
+		gst_buffer_pool_set_active (viewer->padded_buffer_pool, FALSE);
+		gst_object_unref (viewer->padded_buffer_pool);
+	}
+
+	viewer->padded_buffer_pool = gst_buffer_pool_new ();
+	viewer->padded_buffer_size = size;
+
+	config = gst_buffer_pool_get_config (viewer->padded_buffer_pool);
+	gst_buffer_pool_config_set_params (config, NULL, size, 2, 0);
+	gst_buffer_pool_set_config (viewer->padded_buffer_pool, config);
+	gst_buffer_pool_set_active (viewer->padded_buffer_pool, TRUE);
+
+	return viewer->padded_buffer_pool;
+}
+
 static GstBuffer *
-arv_to_gst_buffer (ArvBuffer *arv_buffer, ArvStream *stream)
+arv_to_gst_buffer (ArvViewer *viewer, ArvBuffer *arv_buffer, ArvStream *stream)
 {
 	ArvGstBufferReleaseData* release_data;
 	int arv_row_stride;
 	int width, height;
 	char *buffer_data;
 	size_t buffer_size;
-	size_t size;
-	void *data;
 
 	buffer_data = (char *) arv_buffer_get_data (arv_buffer, &buffer_size);
 	arv_buffer_get_image_region (arv_buffer, NULL, NULL, &width, &height);
 	arv_row_stride = width * ARV_PIXEL_FORMAT_BIT_PER_PIXEL (arv_buffer_get_image_pixel_format (arv_buffer)) / 8;
 
-	release_data = g_new0 (ArvGstBufferReleaseData, 1);
-
-	g_weak_ref_init (&release_data->stream, stream);
-	release_data->arv_buffer = arv_buffer;
-
 	/* Gstreamer requires row stride to be a multiple of 4 */
 	if ((arv_row_stride & 0x3) != 0) {
+		GstBuffer *buffer = NULL;
+		GstMapInfo map;
 		int gst_row_stride;
 		int i;
 
 		gst_row_stride = (arv_row_stride & ~(0x3)) + 4;
 
-		size = height * gst_row_stride;
-		data = g_malloc (size);
-
-		for (i = 0; i < height; i++)
-			memcpy (((char *) data) + i * gst_row_stride, buffer_data + i * arv_row_stride, arv_row_stride);
+		if (gst_buffer_pool_acquire_buffer (get_padded_buffer_pool (viewer, height * gst_row_stride),
+						    &buffer, NULL) == GST_FLOW_OK &&
+		    gst_buffer_map (buffer, &map, GST_MAP_WRITE)) {
+			for (i = 0; i < height; i++)
+				memcpy (map.data + i * gst_row_stride, buffer_data + i * arv_row_stride, arv_row_stride);
+			gst_buffer_unmap (buffer, &map);
+		}
 
-		release_data->data = data;
+		arv_stream_push_buffer (stream, arv_buffer);
 
-	} else {
-		data = buffer_data;
-		size = buffer_size;
+		return buffer;
 	}
 
+	release_data = g_new0 (ArvGstBufferReleaseData, 1);
+
+	g_weak_ref_init (&release_data->stream, stream);
+	release_data->arv_buffer = arv_buffer;
+
 	return gst_buffer_new_wrapped_full (GST_MEMORY_FLAG_READONLY,
-					    data, size, 0, size,
+					    buffer_data, buffer_size, 0, buffer_size,
 					    release_data, gst_buffer_release_cb);
 }
 
+/* Called at the display refresh rate. The stream is in mailbox mode, only the latest frame is waiting in the output
+ * queue, the older ones being counted as display drops by the stream. */
+
 static void
-new_buffer_cb (ArvStream *stream, ArvViewer *viewer)
+render_latest_buffer (ArvViewer *viewer)
 {
+	ArvStream *stream = viewer->stream;
 	ArvBuffer *arv_buffer;
 	gint n_input_buffers, n_output_buffers;
 
-	arv_buffer = arv_stream_pop_buffer (stream);
+	if (!ARV_IS_STREAM (stream) || viewer->appsrc == NULL)
+		return;
+
+	arv_buffer = arv_stream_try_pop_buffer (stream);
 	if (arv_buffer == NULL)
 		return;
 
@@ -357,6 +406,7 @@ new_buffer_cb (ArvStream *stream, ArvViewer *viewer)
 	arv_debug_viewer ("pop buffer (%d,%d)", n_input_buffers, n_output_buffers);
 
 	if (arv_buffer_get_status (arv_buffer) == ARV_BUFFER_STATUS_SUCCESS) {
+		GstBuffer *buffer;
 		size_t size;
 
 		arv_buffer_get_data (arv_buffer, &size);
@@ -364,10 +414,12 @@ new_buffer_cb (ArvStream *stream, ArvViewer *viewer)
 		g_clear_object( &viewer->last_buffer );
 		viewer->last_buffer = g_object_ref( arv_buffer );
 
-		gst_app_src_push_buffer (GST_APP_SRC (viewer->appsrc), arv_to_gst_buffer (arv_buffer, stream));
-
 		viewer->n_images++;
 		viewer->n_bytes += size;
+
+		buffer = arv_to_gst_buffer (viewer, arv_buffer, stream);
+		if (buffer != NULL)
+			gst_app_src_push_buffer (GST_APP_SRC (viewer->appsrc), buffer);
 	} else {
 		arv_debug_viewer ("push discarded buffer");
 		arv_stream_push_buffer (stream, arv_buffer);
@@ -375,6 +427,22 @@ new_buffer_cb (ArvStream *stream, ArvViewer *viewer)
 	}
 }
 
+static gboolean
+render_tick_cb (GtkWidget *widget, GdkFrameClock *frame_clock, gpointer user_data)
+{
+	render_latest_buffer (user_data);
+
+	return G_SOURCE_CONTINUE;
+}
+
+static gboolean
+render_timeout_cb (gpointer user_data)
+{
+	render_latest_buffer (user_data);
+
+	return G_SOURCE_CONTINUE;
+}
+
 static void
 _apply_frame_rate (GtkEntry *entry, ArvViewer *viewer, gboolean grab_focus)
 {
@@ -464,14 +532,93 @@ gain_scale_cb (GtkRange *range, ArvViewer *viewer)
 	g_signal_handler_unblock (viewer->gain_spin_button, viewer->gain_spin_changed);
 }
 
+/* Refresh interval of the gain and exposure widgets in auto mode */
+#define ARV_VIEWER_AUTO_UPDATE_INTERVAL_MS	1000
+
+static const char *exposure_polled_features[] = {"ExposureTime", "ExposureTimeAbs", NULL};
+static const char *gain_polled_features[] = {"Gain", "GainRaw", NULL};
+
+/* Polls the first available feature of @features, and connects @callback to its feature-polled signal. Returns
+ * FALSE if none of them can be polled. */
+
 static gboolean
-update_exposure_cb (void *data)
+start_polling (ArvViewer *viewer, const char **features, GCallback callback,
+	       const char **polled_feature, gulong *polled_handler)
+{
+	ArvDevice *device = arv_camera_get_device (viewer->camera);
+	unsigned int i;
+
+	for (i = 0; features[i] != NULL; i++) {
+		char *signal_name;
+
+		if (!arv_camera_is_feature_available (viewer->camera, features[i], NULL))
+			continue;
+
+		signal_name = g_strdup_printf ("feature-polled::%s", features[i]);
+		*polled_handler = g_signal_connect (device, signal_name, callback, viewer);
+		g_free (signal_name);
+
+		if (arv_device_add_polled_feature (device, features[i], ARV_VIEWER_AUTO_UPDATE_INTERVAL_MS, NULL)) {
+			*polled_feature = features[i];
+			return TRUE;
+		}
+
+		g_signal_handler_disconnect (device, *polled_handler);
+		*polled_handler = 0;
+
+		return FALSE;
+	}
+
+	return FALSE;
+}
+
+static void
+stop_polling (ArvViewer *viewer, const char **polled_feature, gulong *polled_handler)
+{
+	ArvDevice *device;
+
+	if (*polled_feature == NULL || !ARV_IS_CAMERA (viewer->camera))
+		return;
+
+	device = arv_camera_get_device (viewer->camera);
+
+	g_signal_handler_disconnect (device, *polled_handler);
+	arv_device_remove_polled_feature (device, *polled_feature);
+
+	*polled_handler = 0;
+	*polled_feature = NULL;
+}
+
+/* Retrieves the last value of a polled feature, as a double. Called from the main loop. */
+
+static gboolean
+get_polled_value (ArvViewer *viewer, const char *polled_feature, double *value)
+{
+	GValue polled_value = G_VALUE_INIT;
+	GValue double_value = G_VALUE_INIT;
+	gboolean success;
+
+	if (polled_feature == NULL || !ARV_IS_CAMERA (viewer->camera) ||
+	    !arv_device_get_polled_feature_value (arv_camera_get_device (viewer->camera), polled_feature,
+						  &polled_value, NULL))
+		return FALSE;
+
+	g_value_init (&double_value, G_TYPE_DOUBLE);
+	success = g_value_transform (&polled_value, &double_value);
+	if (success)
+		*value = g_value_get_double (&double_value);
+
+	g_value_unset (&double_value);
+	g_value_unset (&polled_value);
+
+	return success;
+}
+
+static void
+set_exposure_widgets (ArvViewer *viewer, double exposure)
 {
-	ArvViewer *viewer = data;
-	double exposure;
 	double log_exposure;
 
-	exposure = arv_camera_get_exposure_time (viewer->camera, NULL);
 	log_exposure = arv_viewer_value_to_log (exposure, viewer->exposure_min, viewer->exposure_max);
 
 	g_signal_handler_block (viewer->exposure_hscale, viewer->exposure_hscale_changed);
@@ -480,22 +627,57 @@ update_exposure_cb (void *data)
 	gtk_spin_button_set_value (GTK_SPIN_BUTTON (viewer->exposure_spin_button), exposure);
 	g_signal_handler_unblock (viewer->exposure_spin_button, viewer->exposure_spin_changed);
 	g_signal_handler_unblock (viewer->exposure_hscale, viewer->exposure_hscale_changed);
+}
+
+static gboolean
+update_exposure_cb (void *data)
+{
+	ArvViewer *viewer = data;
+
+	set_exposure_widgets (viewer, arv_camera_get_exposure_time (viewer->camera, NULL));
 
 	return TRUE;
 }
 
+static gboolean
+polled_exposure_cb (void *data)
+{
+	ArvViewer *viewer = data;
+	double exposure;
+
+	if (get_polled_value (viewer, viewer->exposure_polled_feature, &exposure))
+		set_exposure_widgets (viewer, exposure);
+
+	return FALSE;
+}
+
+/* Emitted from the device worker thread */
+
+static void
+exposure_polled_cb (ArvDevice *device, const char *feature, ArvViewer *viewer)
+{
+	g_main_context_invoke (NULL, polled_exposure_cb, viewer);
+}
+
 static void
 update_exposure_ui (ArvViewer *viewer, gboolean is_auto)
 {
-	update_exposure_cb (viewer);
+	stop_polling (viewer, &viewer->exposure_polled_feature, &viewer->exposure_polled_handler);
 
 	if (viewer->exposure_update_event > 0) {
 		g_source_remove (viewer->exposure_update_event);
 		viewer->exposure_update_event = 0;
 	}
 
-	if (is_auto)
-		viewer->exposure_update_event = g_timeout_add_seconds (1, update_exposure_cb, viewer);
+	update_exposure_cb (viewer);
+
+	/* The exposure is read by the device worker thread, falling back to a blocking read from the main loop for
+	 * the cameras without a standard exposure feature */
+	if (is_auto &&
+	    !start_polling (viewer, exposure_polled_features, G_CALLBACK (exposure_polled_cb),
+			    &viewer->exposure_polled_feature, &viewer->exposure_polled_handler))
+		viewer->exposure_update_event = g_timeout_add (ARV_VIEWER_AUTO_UPDATE_INTERVAL_MS,
+							       update_exposure_cb, viewer);
 }
 
 static void
@@ -509,37 +691,64 @@ auto_exposure_cb (GtkToggleButton *toggle, ArvViewer *viewer)
 	update_exposure_ui (viewer, is_auto);
 }
 
-static gboolean
-update_gain_cb (void *data)
+static void
+set_gain_widgets (ArvViewer *viewer, double gain)
 {
-	ArvViewer *viewer = data;
-	double gain;
-
-	gain = arv_camera_get_gain (viewer->camera, NULL);
-
 	g_signal_handler_block (viewer->gain_hscale, viewer->gain_hscale_changed);
 	g_signal_handler_block (viewer->gain_spin_button, viewer->gain_spin_changed);
 	gtk_range_set_value (GTK_RANGE (viewer->gain_hscale), gain);
 	gtk_spin_button_set_value (GTK_SPIN_BUTTON (viewer->gain_spin_button), gain);
 	g_signal_handler_unblock (viewer->gain_spin_button, viewer->gain_spin_changed);
 	g_signal_handler_unblock (viewer->gain_hscale, viewer->gain_hscale_changed);
+}
+
+static gboolean
+update_gain_cb (void *data)
+{
+	ArvViewer *viewer = data;
+
+	set_gain_widgets (viewer, arv_camera_get_gain (viewer->camera, NULL));
 
 	return TRUE;
 }
 
+static gboolean
+polled_gain_cb (void *data)
+{
+	ArvViewer *viewer = data;
+	double gain;
+
+	if (get_polled_value (viewer, viewer->gain_polled_feature, &gain))
+		set_gain_widgets (viewer, gain);
+
+	return FALSE;
+}
+
+/* Emitted from the device worker thread */
+
+static void
+gain_polled_cb (ArvDevice *device, const char *feature, ArvViewer *viewer)
+{
+	g_main_context_invoke (NULL, polled_gain_cb, viewer);
+}
+
 static void
 update_gain_ui (ArvViewer *viewer, gboolean is_auto)
 {
-	update_gain_cb (viewer);
+	stop_polling (viewer, &viewer->gain_polled_feature, &viewer->gain_polled_handler);
 
 	if (viewer->gain_update_event > 0) {
 		g_source_remove (viewer->gain_update_event);
 		viewer->gain_update_event = 0;
 	}
 
-	if (is_auto)
-		viewer->gain_update_event = g_timeout_add_seconds (1, update_gain_cb, viewer);
+	update_gain_cb (viewer);
 
+	if (is_auto &&
+	    !start_polling (viewer, gain_polled_features, G_CALLBACK (gain_polled_cb),
+			    &viewer->gain_polled_feature, &viewer->gain_polled_handler))
+		viewer->gain_update_event = g_timeout_add (ARV_VIEWER_AUTO_UPDATE_INTERVAL_MS,
+							   update_gain_cb, viewer);
 }
 
 
@@ -722,6 +931,68 @@ stream_cb (void *user_data, ArvStreamCallbackType type, ArvBuffer *buffer)
 	}
 }
 
+/* Only the already published stream statistics are read, once per second and while the panel is open */
+
+static void
+update_statistics (ArvViewer *viewer, gint64 elapsed_time_ms)
+{
+	const ArvStatistic *assembly_time = NULL;
+	GString *string;
+	guint64 n_resent_packets;
+	guint64 n_missing_packets;
+	gint n_input_buffers, n_output_buffers;
+	guint n_statistics;
+	guint histogram_id = 0;
+	guint i;
+
+	if (!ARV_IS_STREAM (viewer->stream) || !gtk_widget_get_visible (viewer->statistics_popover))
+		return;
+
+	n_resent_packets = arv_stream_get_info_uint64_by_name (viewer->stream, "n_resent_packets");
+	n_missing_packets = arv_stream_get_info_uint64_by_name (viewer->stream, "n_missing_packets");
+	arv_stream_get_n_buffers (viewer->stream, &n_input_buffers, &n_output_buffers);
+
+	string = g_string_new ("");
+
+	g_string_append_printf (string, "Resent packets:\t\t%.1f /s\n",
+				1000.0 * (n_resent_packets - viewer->last_n_resent_packets) / elapsed_time_ms);
+	g_string_append_printf (string, "Missing packets:\t%.1f /s (%" G_GUINT64_FORMAT " total)\n",
+				1000.0 * (n_missing_packets - viewer->last_n_missing_packets) / elapsed_time_ms,
+				n_missing_packets);
+	g_string_append_printf (string, "Underruns:\t\t%" G_GUINT64_FORMAT "\n",
+				arv_stream_get_info_uint64_by_name (viewer->stream, "n_underruns"));
+	g_string_append_printf (string, "Queues:\t\t\t%d input / %d output\n", n_input_buffers, n_output_buffers);
+	g_string_append_printf (string, "Receive thread CPU:\t%.1f %%\n",
+				arv_stream_get_info_double_by_name (viewer->stream, "thread_cpu_percent"));
+	g_string_append_printf (string, "Socket buffer:\t\t%" G_GUINT64_FORMAT " / %" G_GUINT64_FORMAT " kB",
+				arv_stream_get_info_uint64_by_name (viewer->stream, "socket_buffer_fill") / 1024,
+				arv_stream_get_info_uint64_by_name (viewer->stream, "socket_buffer_capacity") / 1024);
+	g_string_append_printf (string, "\nSocket drops:\t\t%" G_GUINT64_FORMAT,
+				arv_stream_get_info_uint64_by_name (viewer->stream, "n_socket_drops"));
+
+	n_statistics = arv_stream_get_n_statistics (viewer->stream);
+	for (i = 0; i < n_statistics && assembly_time == NULL; i++) {
+		const char *name;
+		const ArvStatistic *statistic;
+
+		statistic = arv_stream_get_statistic (viewer->stream, i, &name, &histogram_id);
+		if (g_strcmp0 (name, "frame_assembly_time_us") == 0)
+			assembly_time = statistic;
+	}
+
+	if (assembly_time != NULL && arv_statistic_get_n_values (assembly_time, histogram_id) > 0)
+		g_string_append_printf (string, "\nFrame assembly:\t\t%d / %d / %d µs (p50 / p90 / p99)",
+					arv_statistic_get_percentile (assembly_time, histogram_id, 50.0),
+					arv_statistic_get_percentile (assembly_time, histogram_id, 90.0),
+					arv_statistic_get_percentile (assembly_time, histogram_id, 99.0));
+
+	gtk_label_set_label (GTK_LABEL (viewer->statistics_label), string->str);
+	g_string_free (string, TRUE);
+
+	viewer->last_n_resent_packets = n_resent_packets;
+	viewer->last_n_missing_packets = n_missing_packets;
+}
+
 static gboolean
 update_status_bar_cb (void *data)
 {
@@ -732,22 +1003,30 @@ update_status_bar_cb (void *data)
 	guint n_images = viewer->n_images;
 	guint n_bytes = viewer->n_bytes;
 	guint n_errors = viewer->n_errors;
+	guint64 n_display_drops = 0;
 
 	if (elapsed_time_ms == 0)
 		return TRUE;
 
+	/* Frames replaced in the stream mailbox before the display could render them, not stream losses */
+	if (ARV_IS_STREAM (viewer->stream))
+		n_display_drops = arv_stream_get_n_dropped_buffers (viewer->stream);
+
 	text = g_strdup_printf ("%.1f fps (%.1f MB/s)",
 				1000.0 * (n_images - viewer->last_n_images) / elapsed_time_ms,
 				((n_bytes - viewer->last_n_bytes) / 1000.0) / elapsed_time_ms);
 	gtk_label_set_label (GTK_LABEL (viewer->fps_label), text);
 	g_free (text);
 
-	text = g_strdup_printf ("%u image%s / %u error%s",
+	text = g_strdup_printf ("%u image%s / %u error%s / %" G_GUINT64_FORMAT " skipped for display",
 				n_images, n_images > 0 ? "s" : "",
-				n_errors, n_errors > 0 ? "s" : "");
+				n_errors, n_errors > 0 ? "s" : "",
+				n_display_drops);
 	gtk_label_set_label (GTK_LABEL (viewer->image_label), text);
 	g_free (text);
 
+	update_statistics (viewer, elapsed_time_ms);
+
 	viewer->last_status_bar_update_time_ms = time_ms;
 	viewer->last_n_images = n_images;
 	viewer->last_n_bytes = n_bytes;
@@ -902,14 +1181,21 @@ stop_video (ArvViewer *viewer)
 	if (GST_IS_PIPELINE (viewer->pipeline))
 		gst_element_set_state (viewer->pipeline, GST_STATE_NULL);
 
-	if (ARV_IS_STREAM (viewer->stream))
-		arv_stream_set_emit_signals (viewer->stream, FALSE);
+	if (viewer->render_event > 0) {
+		g_source_remove (viewer->render_event);
+		viewer->render_event = 0;
+	}
 
 	g_clear_object (&viewer->stream);
 	g_clear_object (&viewer->pipeline);
 
 	viewer->appsrc = NULL;
 
+	if (viewer->padded_buffer_pool != NULL) {
+		gst_buffer_pool_set_active (viewer->padded_buffer_pool, FALSE);
+		g_clear_object (&viewer->padded_buffer_pool);
+	}
+
 	g_clear_object (&viewer->last_buffer);
 
 	if (ARV_IS_CAMERA (viewer->camera))
@@ -931,6 +1217,9 @@ stop_video (ArvViewer *viewer)
 		g_source_remove (viewer->gain_update_event);
 		viewer->gain_update_event = 0;
 	}
+
+	stop_polling (viewer, &viewer->exposure_polled_feature, &viewer->exposure_polled_handler);
+	stop_polling (viewer, &viewer->gain_polled_feature, &viewer->gain_polled_handler);
 }
 
 static GstBusSyncReply
@@ -996,7 +1285,7 @@ start_video (ArvViewer *viewer)
 			      NULL);
 	}
 
-	arv_stream_set_emit_signals (viewer->stream, TRUE);
+	g_object_set (viewer->stream, "mailbox", TRUE, NULL);
 	payload = arv_camera_get_payload (viewer->camera, NULL);
 	for (i = 0; i < 10; i++)
 		arv_stream_push_buffer (viewer->stream, arv_buffer_new (payload, NULL));
@@ -1064,6 +1353,7 @@ start_video (ArvViewer *viewer)
 		gtk_widget_show (video_widget);
 		g_object_set(G_OBJECT (video_widget), "force-aspect-ratio", TRUE, NULL);
 		gtk_widget_set_size_request (video_widget, 640, 480);
+		gtk_widget_add_tick_callback (video_widget, render_tick_cb, viewer, NULL);
 	} else {
 		videosink = gst_element_factory_make ("autovideosink", NULL);
 		gst_bin_add (GST_BIN (viewer->pipeline), videosink);
@@ -1100,9 +1390,13 @@ start_video (ArvViewer *viewer)
 	viewer->n_images = 0;
 	viewer->n_bytes = 0;
 	viewer->n_errors = 0;
+	viewer->last_n_resent_packets = 0;
+	viewer->last_n_missing_packets = 0;
 	viewer->status_bar_update_event = g_timeout_add_seconds (1, update_status_bar_cb, viewer);
 
-	g_signal_connect (viewer->stream, "new-buffer", G_CALLBACK (new_buffer_cb), viewer);
+	/* No frame clock without a gtk sink widget, poll at about 60 Hz */
+	if (!has_gtkglsink && !has_gtksink)
+		viewer->render_event = g_timeout_add (16, render_timeout_cb, viewer);
 
 	return TRUE;
 }
@@ -1259,6 +1553,7 @@ select_mode (ArvViewer *viewer, ArvViewerMode mode)
 	gtk_widget_set_visible (viewer->flip_horizontal_toggle, video_visibility);
 	gtk_widget_set_visible (viewer->snapshot_button, video_visibility);
 	gtk_widget_set_visible (viewer->acquisition_button, video_visibility);
+	gtk_widget_set_visible (viewer->statistics_button, video_visibility);
 
 }
 
@@ -1333,6 +1628,9 @@ activate (GApplication *application)
 	viewer->flip_vertical_toggle = GTK_WIDGET (gtk_builder_get_object (builder, "flip_vertical_togglebutton"));
 	viewer->flip_horizontal_toggle = GTK_WIDGET (gtk_builder_get_object (builder, "flip_horizontal_togglebutton"));
 	viewer->acquisition_button = GTK_WIDGET (gtk_builder_get_object (builder, "acquisition_button"));
+	viewer->statistics_button = GTK_WIDGET (gtk_builder_get_object (builder, "statistics_button"));
+	viewer->statistics_popover = GTK_WIDGET (gtk_builder_get_object (builder, "statistics_popover"));
+	viewer->statistics_label = GTK_WIDGET (gtk_builder_get_object (builder, "statistics_label"));
 
 	gtk_widget_set_no_show_all (viewer->trigger_combo_box, TRUE);
 